@@ -0,0 +1,116 @@
+#include "Utils.h"
+
+#include <Game/GameParameters.h>
+
+#include <GameCore/FloatingPoint.h>
+#include <GameCore/SysSpecifics.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <xmmintrin.h>
+
+//
+// The integration of a settling ship - as in Ship::IntegrateAndResetPointForces() -
+// with and without denormals being flushed to zero (FTZ) and read as zero (DAZ).
+//
+// With the global damp, a velocity takes tens of thousands of steps to decay through
+// the denormal range; each step starts here from velocities spread over that range,
+// as those of a ship that has come to rest.
+//
+
+static constexpr size_t Size = 100000;
+
+// Runs its scope with FTZ and DAZ enabled or disabled, restoring the previous mode at exit
+class ScopedDenormalsMode
+{
+public:
+
+    explicit ScopedDenormalsMode(bool areDenormalsFlushed)
+        : mOldControlStatus(_mm_getcsr())
+    {
+        if (areDenormalsFlushed)
+        {
+            EnableFloatingPointFlushToZero();
+            EnableFloatingPointDenormalsAreZero();
+        }
+        else
+        {
+            _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_OFF);
+            _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_OFF);
+        }
+    }
+
+    ~ScopedDenormalsMode()
+    {
+        _mm_setcsr(mOldControlStatus);
+    }
+
+private:
+
+    unsigned int const mOldControlStatus;
+};
+
+static std::vector<float> MakeSettledVelocities(size_t count)
+{
+    // All denormals, alternating in sign
+    std::vector<float> velocities;
+    velocities.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float const magnitude = FLT_MIN * static_cast<float>(i % 1000 + 1) / 1001.0f;
+        velocities.push_back((i % 2) == 0 ? magnitude : -magnitude);
+    }
+
+    return velocities;
+}
+
+static void Denormals_IntegrateSettlingPoints(benchmark::State & state)
+{
+    GameParameters const gameParameters;
+    float const dt = gameParameters.MechanicalSimulationStepTimeDuration<float>();
+    float const globalDampCoefficient = pow(
+        GameParameters::GlobalDamp,
+        12.0f / gameParameters.NumMechanicalDynamicsIterations<float>());
+
+    size_t const count = MakeSize(Size) * 2; // Two components per vector
+
+    std::vector<float> positions = MakeFloats(count);
+    std::vector<float> const settledVelocities = MakeSettledVelocities(count);
+    std::vector<float> velocities(count);
+    std::vector<float> forces(count, 0.0f);
+    std::vector<float> const integrationFactors(count, dt * dt);
+
+    // Only now, as the velocities themselves would be flushed to zero while made
+    ScopedDenormalsMode const denormalsMode(state.range(0) != 0);
+
+    for (auto _ : state)
+    {
+        // A plain copy, which doesn't touch the FPU
+        std::copy(settledVelocities.cbegin(), settledVelocities.cend(), velocities.begin());
+
+        float * const restrict positionBuffer = positions.data();
+        float * const restrict velocityBuffer = velocities.data();
+        float * const restrict forceBuffer = forces.data();
+        float const * const restrict integrationFactorBuffer = integrationFactors.data();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const deltaPos = velocityBuffer[i] * dt + forceBuffer[i] * integrationFactorBuffer[i];
+            positionBuffer[i] += deltaPos;
+            velocityBuffer[i] = deltaPos * globalDampCoefficient / dt;
+
+            forceBuffer[i] = 0.0f;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    benchmark::DoNotOptimize(positions);
+    benchmark::DoNotOptimize(velocities);
+}
+BENCHMARK(Denormals_IntegrateSettlingPoints)->ArgName("FTZ_DAZ")->Arg(0)->Arg(1);
@@ -0,0 +1,131 @@
+#include "Utils.h"
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <vector>
+
+//
+// Destroys all the springs of a graph, invoking a destroy handler for each, which
+// disconnects the spring from its endpoints - the way the ship's element containers
+// invoke the ship's handlers during cuts and explosions.
+//
+
+static constexpr size_t SpringCount = 100000;
+
+namespace {
+
+struct Handler
+{
+    std::vector<SpringEndpoints> const & Springs;
+    std::vector<int> ConnectedSpringCounts;
+
+    Handler(
+        std::vector<SpringEndpoints> const & springs,
+        size_t pointCount)
+        : Springs(springs)
+        , ConnectedSpringCounts(pointCount, 0)
+    {
+        for (auto const & spring : springs)
+        {
+            ++ConnectedSpringCounts[spring.PointAIndex];
+            ++ConnectedSpringCounts[spring.PointBIndex];
+        }
+    }
+
+    void SpringDestroyHandler(ElementIndex springIndex)
+    {
+        --ConnectedSpringCounts[Springs[springIndex].PointAIndex];
+        --ConnectedSpringCounts[Springs[springIndex].PointBIndex];
+    }
+};
+
+// The way the containers used to invoke handlers
+struct TypeErasedContainer
+{
+    std::vector<bool> IsDeleted;
+    std::function<void(ElementIndex)> DestroyHandler;
+
+    void Destroy(ElementIndex springIndex)
+    {
+        if (!!DestroyHandler)
+        {
+            DestroyHandler(springIndex);
+        }
+
+        IsDeleted[springIndex] = true;
+    }
+};
+
+// The way the containers invoke handlers now
+struct StaticallyDispatchedContainer
+{
+    std::vector<bool> IsDeleted;
+    Handler * ShipHandler;
+
+    void Destroy(ElementIndex springIndex)
+    {
+        if (nullptr != ShipHandler)
+        {
+            ShipHandler->SpringDestroyHandler(springIndex);
+        }
+
+        IsDeleted[springIndex] = true;
+    }
+};
+
+}
+
+static void ElementHandlers_SpringDestroy_StdFunction(benchmark::State & state)
+{
+    auto const size = MakeSize(SpringCount);
+
+    std::vector<vec2f> points;
+    std::vector<SpringEndpoints> springs;
+    MakeGraph(size, points, springs);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Handler handler(springs, points.size());
+        TypeErasedContainer container{
+            std::vector<bool>(springs.size(), false),
+            std::bind(&Handler::SpringDestroyHandler, &handler, std::placeholders::_1) };
+        state.ResumeTiming();
+
+        for (ElementIndex s = 0; s < springs.size(); ++s)
+        {
+            container.Destroy(s);
+        }
+
+        benchmark::DoNotOptimize(handler.ConnectedSpringCounts);
+    }
+}
+BENCHMARK(ElementHandlers_SpringDestroy_StdFunction);
+
+static void ElementHandlers_SpringDestroy_StaticDispatch(benchmark::State & state)
+{
+    auto const size = MakeSize(SpringCount);
+
+    std::vector<vec2f> points;
+    std::vector<SpringEndpoints> springs;
+    MakeGraph(size, points, springs);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Handler handler(springs, points.size());
+        StaticallyDispatchedContainer container{
+            std::vector<bool>(springs.size(), false),
+            &handler };
+        state.ResumeTiming();
+
+        for (ElementIndex s = 0; s < springs.size(); ++s)
+        {
+            container.Destroy(s);
+        }
+
+        benchmark::DoNotOptimize(handler.ConnectedSpringCounts);
+    }
+}
+BENCHMARK(ElementHandlers_SpringDestroy_StaticDispatch);
@@ -73,4 +73,52 @@ static void FastExp_FastExp(benchmark::State& state)
 
     benchmark::DoNotOptimize(results);
 }
-BENCHMARK(FastExp_FastExp);
\ No newline at end of file
+BENCHMARK(FastExp_FastExp);
+
+static void FastSin_Sin(benchmark::State& state)
+{
+    auto arguments = MakeFloats(Size);
+    std::vector<float> results(Size);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < Size; ++i)
+        {
+            results[i] = sinf(arguments[i]);
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(FastSin_Sin);
+
+static void FastSin_FastSin(benchmark::State& state)
+{
+    auto arguments = MakeFloats(Size);
+    std::vector<float> results(Size);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < Size; ++i)
+        {
+            results[i] = FastSin(arguments[i]);
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(FastSin_FastSin);
+
+static void FastSin_FastSin4(benchmark::State& state)
+{
+    auto arguments = MakeFloats(Size);
+    std::vector<float> results(Size);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < Size; i += 4)
+        {
+            _mm_storeu_ps(&(results[i]), FastSin4(_mm_loadu_ps(&(arguments[i]))));
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(FastSin_FastSin4);
@@ -0,0 +1,105 @@
+#include <GameCore/GameRandomEngine.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+static constexpr size_t Size = 10000000;
+
+static void GenerateRandomInteger_Ranlux48Base(benchmark::State& state)
+{
+    // What GameRandomEngine used to do
+    std::seed_seq seed_seq({ 1, 242, 19730528 });
+    std::ranlux48_base randomEngine(seed_seq);
+
+    std::vector<int> results;
+    results.reserve(Size);
+
+    for (auto _ : state)
+    {
+        results.clear();
+        for (size_t i = 0; i < Size; ++i)
+        {
+            std::uniform_int_distribution<int> dis(4, 9);
+            results.push_back(dis(randomEngine));
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(GenerateRandomInteger_Ranlux48Base);
+
+static void GenerateRandomInteger_GameRandomEngine(benchmark::State& state)
+{
+    GameRandomEngine randomEngine(0);
+
+    std::vector<int> results;
+    results.reserve(Size);
+
+    for (auto _ : state)
+    {
+        results.clear();
+        for (size_t i = 0; i < Size; ++i)
+        {
+            results.push_back(randomEngine.GenerateRandomInteger(4, 9));
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(GenerateRandomInteger_GameRandomEngine);
+
+static void GenerateRandomNormalizedReal_Ranlux48Base(benchmark::State& state)
+{
+    // What GameRandomEngine used to do
+    std::seed_seq seed_seq({ 1, 242, 19730528 });
+    std::ranlux48_base randomEngine(seed_seq);
+    std::uniform_real_distribution<float> randomUniformDistribution(0.0f, 1.0f);
+
+    std::vector<float> results(Size);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < Size; ++i)
+        {
+            results[i] = randomUniformDistribution(randomEngine);
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(GenerateRandomNormalizedReal_Ranlux48Base);
+
+static void GenerateRandomNormalizedReal_GameRandomEngine(benchmark::State& state)
+{
+    GameRandomEngine randomEngine(0);
+
+    std::vector<float> results(Size);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < Size; ++i)
+        {
+            results[i] = randomEngine.GenerateRandomNormalizedReal();
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(GenerateRandomNormalizedReal_GameRandomEngine);
+
+static void GenerateRandomNormalizedReals_GameRandomEngine(benchmark::State& state)
+{
+    GameRandomEngine randomEngine(0);
+
+    std::vector<float> results(Size);
+
+    for (auto _ : state)
+    {
+        randomEngine.GenerateRandomNormalizedReals(results.data(), results.size());
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+BENCHMARK(GenerateRandomNormalizedReals_GameRandomEngine);
@@ -0,0 +1,82 @@
+#include "OpenGLContext.h"
+
+#include <GameCore/GameException.h>
+
+#include <wx/app.h>
+#include <wx/init.h>
+#include <wx/window.h>
+
+#include <cassert>
+
+OpenGLContext::OpenGLContext()
+{
+    InitializeWxWidgets();
+
+    //
+    // Create dummy window
+    //
+
+    mFrame = std::make_unique<wxFrame>(
+        nullptr, // No parent
+        wxID_ANY,
+        "OpenGLContext Dummy Frame",
+        wxDefaultPosition,
+        wxSize(100, 100),
+        wxSTAY_ON_TOP);
+
+
+    //
+    // Build GL canvas
+    //
+
+    // Note: Using the wxWidgets 3.1 style does not work on OpenGL 4 drivers; it forces a 1.1.0 context
+
+    int glCanvasAttributes[] =
+    {
+        WX_GL_RGBA,
+        WX_GL_DEPTH_SIZE,      16,
+        WX_GL_STENCIL_SIZE,    1,
+        0, 0
+    };
+
+    mGLCanvas = std::make_unique<wxGLCanvas>(
+        mFrame.get(),
+        wxID_ANY,
+        glCanvasAttributes,
+        wxDefaultPosition,
+        wxSize(100, 100),
+        0L,
+        _T("Benchmark GL Canvas"));
+
+    // Take context for this canvas
+    mGLContext = std::make_unique<wxGLContext>(mGLCanvas.get());
+}
+
+OpenGLContext::~OpenGLContext()
+{
+    assert(!!mFrame);
+    mFrame->Destroy();
+}
+
+void OpenGLContext::Activate()
+{
+    mGLContext->SetCurrent(*mGLCanvas);
+}
+
+void OpenGLContext::InitializeWxWidgets()
+{
+    static bool isInitialized = false;
+    if (isInitialized)
+        return;
+
+    // Windows need an application object, even if it never runs
+    wxApp::SetInstance(new wxApp());
+
+    int argc = 0;
+    if (!wxEntryStart(argc, static_cast<wxChar **>(nullptr)))
+    {
+        throw GameException("Cannot initialize wxWidgets");
+    }
+
+    isInitialized = true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <GPUCalc/IOpenGLContext.h>
+
+#include <wx/frame.h>
+#include <wx/glcanvas.h>
+
+#include <memory>
+
+/*
+ * Implementation of the IOpenGLContext interface for an OpenGL context
+ * created with wxWidgets, on a window that is never shown; initializes
+ * wxWidgets at the first instantiation, as benchmarks have no wxApp.
+ */
+class OpenGLContext : public IOpenGLContext
+{
+public:
+
+    OpenGLContext();
+    ~OpenGLContext();
+
+public:
+
+    void Activate() override;
+
+private:
+
+    static void InitializeWxWidgets();
+
+private:
+
+    std::unique_ptr<wxFrame> mFrame;
+    std::unique_ptr<wxGLCanvas> mGLCanvas;
+    std::unique_ptr<wxGLContext> mGLContext;
+};
@@ -0,0 +1,98 @@
+#include "Utils.h"
+
+#include <Game/PointCollisions.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Physics;
+
+static constexpr size_t SampleSize = 1000000;
+
+static WorldBounds const Bounds{ -100.0f, 100.0f, -50.0f, 50.0f, 20.0f };
+
+static void MakePoints(
+    size_t count,
+    std::vector<vec2f> & positions,
+    std::vector<vec2f> & velocities)
+{
+    std::mt19937 random(42);
+
+    // A few out of bounds
+    std::uniform_real_distribution<float> positionDistribution(-110.0f, 110.0f);
+    std::uniform_real_distribution<float> velocityDistribution(-10.0f, 10.0f);
+
+    for (size_t p = 0; p < count; ++p)
+    {
+        positions.emplace_back(positionDistribution(random), positionDistribution(random) / 2.0f);
+        velocities.emplace_back(velocityDistribution(random), velocityDistribution(random));
+    }
+}
+
+static void PointCollisions_TrimForWorldBounds(benchmark::State & state, PointCollisionsImplementation implementation)
+{
+    auto const size = MakeSize(SampleSize);
+
+    std::vector<vec2f> positions;
+    std::vector<vec2f> velocities;
+    MakePoints(size, positions, velocities);
+
+    for (auto _ : state)
+    {
+        TrimPointsForWorldBounds(
+            implementation,
+            positions.data(),
+            velocities.data(),
+            size,
+            Bounds);
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK_CAPTURE(PointCollisions_TrimForWorldBounds, Scalar, PointCollisionsImplementation::Scalar);
+BENCHMARK_CAPTURE(PointCollisions_TrimForWorldBounds, SSE2, PointCollisionsImplementation::SSE2);
+
+static void PointCollisions_FindPointsBelowSeaFloor(benchmark::State & state, PointCollisionsImplementation implementation)
+{
+    auto const size = MakeSize(SampleSize);
+
+    std::vector<vec2f> positions;
+    std::vector<vec2f> velocities;
+    MakePoints(size, positions, velocities);
+
+    // About one point in a hundred below the floor
+    std::vector<float> oceanFloorHeights(size, -54.0f);
+
+    // The awake points, in an order that's not quite sequential
+    std::vector<ElementIndex> pointIndices(size);
+    for (size_t p = 0; p < size; ++p)
+        pointIndices[p] = static_cast<ElementIndex>(p);
+    for (size_t p = 0; p + 8 <= size; p += 8)
+        std::reverse(pointIndices.begin() + p, pointIndices.begin() + p + 8);
+
+    std::vector<size_t> belowPointOrdinals(size);
+
+    size_t belowPointCount = 0;
+    for (auto _ : state)
+    {
+        belowPointCount = FindPointsBelowSeaFloor(
+            implementation,
+            positions.data(),
+            oceanFloorHeights.data(),
+            pointIndices.data(),
+            size,
+            belowPointOrdinals.data());
+
+        benchmark::DoNotOptimize(belowPointCount);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.counters["BelowPoints"] = static_cast<double>(belowPointCount);
+}
+BENCHMARK_CAPTURE(PointCollisions_FindPointsBelowSeaFloor, Scalar, PointCollisionsImplementation::Scalar);
+BENCHMARK_CAPTURE(PointCollisions_FindPointsBelowSeaFloor, SSE2, PointCollisionsImplementation::SSE2);
@@ -0,0 +1,138 @@
+#include <Game/GameParameters.h>
+#include <Game/IGameEventHandler.h>
+#include <Game/MaterialDatabase.h>
+#include <Game/Physics.h>
+#include <Game/ResourceLoader.h>
+#include <Game/ShipBuilder.h>
+#include <Game/ShipDefinition.h>
+#include <Game/SpringForces.h>
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+//
+// Runs the spring forces - the loop the layout of a ship is meant for - on each of the
+// installed ships, laid out with each of the layout strategies.
+//
+// Must be run from the directory that contains the Data and Ships folders.
+//
+
+namespace {
+
+struct ShipLayoutEnvironment
+{
+    ResourceLoader ResourceLoaderInstance;
+    MaterialDatabase MaterialDatabaseInstance;
+    GameParameters GameParametersInstance;
+    Physics::World WorldInstance;
+
+    ShipLayoutEnvironment()
+        : ResourceLoaderInstance()
+        , MaterialDatabaseInstance(MaterialDatabase::Load(ResourceLoaderInstance))
+        , GameParametersInstance()
+        , WorldInstance(
+            std::make_shared<IGameEventHandler>(),
+            GameParametersInstance,
+            ResourceLoaderInstance)
+    {}
+
+    static ShipLayoutEnvironment & GetInstance()
+    {
+        static ShipLayoutEnvironment environment;
+        return environment;
+    }
+};
+
+}
+
+static void ShipLayout_SpringForces(
+    benchmark::State & state,
+    std::filesystem::path const & shipFilepath,
+    ShipLayoutStrategy shipLayoutStrategy)
+{
+    auto & environment = ShipLayoutEnvironment::GetInstance();
+
+    GameParameters gameParameters = environment.GameParametersInstance;
+    gameParameters.ShipLayout = shipLayoutStrategy;
+
+    auto shipDefinition = ShipDefinition::Load(shipFilepath);
+
+    auto ship = ShipBuilder::Create(
+        0,
+        environment.WorldInstance,
+        std::make_shared<IGameEventHandler>(),
+        shipDefinition,
+        environment.MaterialDatabaseInstance,
+        gameParameters);
+
+    auto & points = ship->GetPoints();
+    auto & springs = ship->GetSprings();
+
+    Physics::SpringForcesBuffers const buffers{
+        points.GetPositionBufferAsVec2(),
+        points.GetVelocityBufferAsVec2(),
+        points.GetForceBufferAsVec2(),
+        springs.GetEndpointsBufferAsElementIndex(),
+        springs.GetRestLengthBuffer(),
+        springs.GetCoefficientsBufferAsFloat() };
+
+    auto const implementation = Physics::GetBestSpringForcesImplementation();
+
+    for (auto _ : state)
+    {
+        Physics::CalculateSpringForces(
+            implementation,
+            buffers,
+            0,
+            static_cast<ElementIndex>(springs.GetElementCount()));
+
+        benchmark::ClobberMemory();
+    }
+
+    std::vector<ElementIndex> springIndices(springs.GetElementCount());
+    std::iota(springIndices.begin(), springIndices.end(), ElementIndex(0));
+
+    state.counters["Springs"] = static_cast<double>(springs.GetElementCount());
+    state.counters["ACMR"] = ShipBuilder::CalculateSpringACMR(springs, springIndices);
+}
+
+static bool RegisterShipLayoutBenchmarks()
+{
+    std::filesystem::path const shipsFolderPath("Ships");
+    if (!std::filesystem::is_directory(shipsFolderPath))
+        return false;
+
+    std::vector<std::pair<ShipLayoutStrategy, std::string>> const strategies{
+        { ShipLayoutStrategy::Tiling, "Tiling" },
+        { ShipLayoutStrategy::SpringsTomForsyth, "SpringsTomForsyth" },
+        { ShipLayoutStrategy::TrianglesTomForsyth, "TrianglesTomForsyth" },
+        { ShipLayoutStrategy::Idempotent, "Idempotent" }
+    };
+
+    for (auto const & entry : std::filesystem::directory_iterator(shipsFolderPath))
+    {
+        if (!entry.is_regular_file()
+            || (entry.path().extension() != ".shp" && entry.path().extension() != ".png"))
+        {
+            continue;
+        }
+
+        for (auto const & strategy : strategies)
+        {
+            benchmark::RegisterBenchmark(
+                ("ShipLayout_SpringForces/" + entry.path().stem().string() + "/" + strategy.second).c_str(),
+                ShipLayout_SpringForces,
+                entry.path(),
+                strategy.first);
+        }
+    }
+
+    return true;
+}
+
+static bool const AreShipLayoutBenchmarksRegistered = RegisterShipLayoutBenchmarks();
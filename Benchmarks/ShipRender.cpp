@@ -0,0 +1,278 @@
+#include "OpenGLContext.h"
+
+#include <Game/GameParameters.h>
+#include <Game/IGameEventHandler.h>
+#include <Game/MaterialDatabase.h>
+#include <Game/Physics.h>
+#include <Game/RenderContext.h>
+#include <Game/ResourceLoader.h>
+#include <Game/ShipBuilder.h>
+#include <Game/ShipDefinition.h>
+#include <Game/ShipDefinitionFile.h>
+#include <Game/SimulationView.h>
+
+#include <GameOpenGL/GameOpenGL.h>
+#include <GameOpenGL/GameOpenGLTimerQueries.h>
+
+#include <GameCore/GameRandomEngine.h>
+#include <GameCore/Utils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+// Renders each of the installed ships with a real render context, on an OpenGL context
+// whose window is never shown - the numbers the render path optimizations are to be
+// weighed against.
+//
+// Each iteration is a whole frame of the ship - the uploads of Ship::Render() and the
+// draws of RenderContext::RenderShipsEnd() - waited for with glFinish(), hence the wall
+// time includes the GPU's; the GPU's alone is reported as a counter, when the driver
+// supports timer queries. These are timestamps, as the render context measures the
+// world with an elapsed-time query of its own, and those may not nest. Ships are updated in between frames, outside of the timing,
+// so that their points move as in the game.
+//
+// Must be run from the directory that contains the Data, Ships, and Test Ships folders.
+//
+
+namespace {
+
+static constexpr unsigned int RandomSeed = 42;
+
+static constexpr int CanvasWidth = 1024;
+static constexpr int CanvasHeight = 768;
+
+// See ShipUpdate.cpp
+static constexpr float NominalUpdateDurationMillis = 10.0f;
+
+struct ShipRenderEnvironment
+{
+    ResourceLoader ResourceLoaderInstance;
+    MaterialDatabase MaterialDatabaseInstance;
+    GameParameters GameParametersInstance;
+    Physics::World WorldInstance;
+    std::unique_ptr<OpenGLContext> OpenGLContextInstance;
+    std::unique_ptr<Render::RenderContext> RenderContextInstance;
+
+    ShipRenderEnvironment()
+        : ResourceLoaderInstance()
+        , MaterialDatabaseInstance(MaterialDatabase::Load(ResourceLoaderInstance))
+        , GameParametersInstance(MakeGameParameters())
+        , WorldInstance(
+            std::make_shared<IGameEventHandler>(),
+            GameParametersInstance,
+            ResourceLoaderInstance)
+        , OpenGLContextInstance(MakeOpenGLContext())
+        , RenderContextInstance(
+            std::make_unique<Render::RenderContext>(
+                ResourceLoaderInstance,
+                [](float, std::string const &) {}))
+    {
+        RenderContextInstance->SetCanvasSize(CanvasWidth, CanvasHeight);
+    }
+
+    static ShipRenderEnvironment & GetInstance()
+    {
+        static ShipRenderEnvironment environment;
+        return environment;
+    }
+
+    SimulationView MakeSimulationView() const
+    {
+        return SimulationView(
+            RenderContextInstance->GetVisibleWorldLeft(),
+            RenderContextInstance->GetVisibleWorldRight(),
+            RenderContextInstance->GetVisibleWorldTop(),
+            RenderContextInstance->GetVisibleWorldBottom(),
+            false);
+    }
+
+    std::unique_ptr<Physics::Ship> CreateShip(ShipDefinition shipDefinition)
+    {
+        // Every ship starts from the same state
+        GameRandomEngine::GetInstance().Reseed(RandomSeed);
+
+        auto ship = ShipBuilder::Create(
+            0,
+            WorldInstance,
+            std::make_shared<IGameEventHandler>(),
+            shipDefinition,
+            MaterialDatabaseInstance,
+            GameParametersInstance);
+
+        RenderContextInstance->Reset();
+        RenderContextInstance->AddShip(
+            0,
+            ship->GetPointCount(),
+            shipDefinition.StructuralLayerImage.Size,
+            std::move(shipDefinition.TextureLayerImage),
+            shipDefinition.TextureOrigin);
+
+        return ship;
+    }
+
+private:
+
+    static GameParameters MakeGameParameters()
+    {
+        GameParameters gameParameters;
+
+        // Measure the uploads of the CPU's positions
+        gameParameters.DoUseGPUWaterDiffusion = false;
+        gameParameters.DoUseGPUMechanicalDynamics = false;
+
+        return gameParameters;
+    }
+
+    static std::unique_ptr<OpenGLContext> MakeOpenGLContext()
+    {
+        auto openGLContext = std::make_unique<OpenGLContext>();
+        openGLContext->Activate();
+
+        GameOpenGL::InitOpenGL();
+
+        return openGLContext;
+    }
+};
+
+}
+
+static void Ship_Render(
+    benchmark::State & state,
+    std::filesystem::path const & shipFilepath,
+    bool doUploadElements)
+{
+    auto & environment = ShipRenderEnvironment::GetInstance();
+    auto & renderContext = *(environment.RenderContextInstance);
+
+    auto ship = environment.CreateShip(ShipDefinition::Load(shipFilepath));
+
+    SimulationView const simulationView = environment.MakeSimulationView();
+
+    bool const isGPUTimed = GameOpenGLTimerQueries::IsSupported();
+    GLuint gpuTimestampQueries[2] = { 0, 0 };
+    if (isGPUTimed)
+    {
+        glGenQueries(2, gpuTimestampQueries);
+    }
+
+    double totalGPUMillis = 0.0;
+
+    float currentSimulationTime = 0.0f;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+
+        ship->Update(
+            currentSimulationTime,
+            environment.GameParametersInstance,
+            NominalUpdateDurationMillis,
+            simulationView);
+
+        currentSimulationTime += GameParameters::SimulationStepTimeDuration<float>;
+
+        if (doUploadElements)
+        {
+            ship->InvalidateRenderElements();
+        }
+
+        state.ResumeTiming();
+
+        if (isGPUTimed)
+            glQueryCounter(gpuTimestampQueries[0], GL_TIMESTAMP);
+
+        renderContext.RenderStart();
+        renderContext.RenderShipsStart();
+
+        ship->Render(
+            environment.GameParametersInstance,
+            1.0f,
+            renderContext);
+
+        renderContext.RenderShipsEnd();
+        renderContext.RenderEnd();
+
+        if (isGPUTimed)
+            glQueryCounter(gpuTimestampQueries[1], GL_TIMESTAMP);
+
+        glFinish();
+
+        if (isGPUTimed)
+        {
+            // Available right away, as we've waited for the GPU
+            GLuint64 startTimestamp;
+            glGetQueryObjectui64v(gpuTimestampQueries[0], GL_QUERY_RESULT, &startTimestamp);
+            GLuint64 endTimestamp;
+            glGetQueryObjectui64v(gpuTimestampQueries[1], GL_QUERY_RESULT, &endTimestamp);
+
+            totalGPUMillis += static_cast<double>(endTimestamp - startTimestamp) / 1000000.0;
+        }
+    }
+
+    state.counters["Points"] = static_cast<double>(ship->GetPointCount());
+
+    if (isGPUTimed)
+    {
+        state.counters["GPU ms"] = totalGPUMillis / static_cast<double>(state.iterations());
+
+        glDeleteQueries(2, gpuTimestampQueries);
+    }
+
+    // Only measured when built with ENABLE_PERF_STATS
+    auto const & perfStats = ship->GetPerfStats();
+    state.counters["Uploads ms"] = perfStats.GetAverageMillis(Physics::ShipPerfStats::Phase::Uploads);
+}
+
+static bool RegisterShipRenderBenchmarks()
+{
+    std::vector<std::filesystem::path> shipFilepaths;
+    for (std::filesystem::path const shipsFolderPath : { "Ships", "Test Ships" })
+    {
+        if (!std::filesystem::is_directory(shipsFolderPath))
+            continue;
+
+        for (auto const & entry : std::filesystem::directory_iterator(shipsFolderPath))
+        {
+            if (entry.is_regular_file()
+                && (Utils::ToLower(entry.path().extension().string()) == ".png"
+                    || ShipDefinitionFile::IsShipDefinitionFile(entry.path())))
+            {
+                shipFilepaths.push_back(entry.path());
+            }
+        }
+    }
+
+    if (shipFilepaths.empty())
+        return false;
+
+    // Register in a stable order, so that runs may be compared line by line
+    std::sort(shipFilepaths.begin(), shipFilepaths.end());
+
+    for (auto const & shipFilepath : shipFilepaths)
+    {
+        std::string const shipName = shipFilepath.stem().string();
+
+        // Points only, as at most frames
+        benchmark::RegisterBenchmark(
+            ("Ship_Render/" + shipName).c_str(),
+            Ship_Render,
+            shipFilepath,
+            false);
+
+        // Points and elements, as after a structural change
+        benchmark::RegisterBenchmark(
+            ("Ship_RenderWithElements/" + shipName).c_str(),
+            Ship_Render,
+            shipFilepath,
+            true);
+    }
+
+    return true;
+}
+
+static bool const AreShipRenderBenchmarksRegistered = RegisterShipRenderBenchmarks();
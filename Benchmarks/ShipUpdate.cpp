@@ -0,0 +1,227 @@
+#include <Game/GameParameters.h>
+#include <Game/IGameEventHandler.h>
+#include <Game/MaterialDatabase.h>
+#include <Game/Physics.h>
+#include <Game/ResourceLoader.h>
+#include <Game/ShipBuilder.h>
+#include <Game/ShipDefinition.h>
+#include <Game/ShipDefinitionFile.h>
+#include <Game/SimulationView.h>
+#include <Game/ViewModel.h>
+
+#include <GameCore/GameRandomEngine.h>
+#include <GameCore/Utils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+// Runs the real simulation on each of the installed ships - the macro benchmarks the
+// micro ones are to be weighed against.
+//
+// Ships are updated from the state they are built in, with the same random seed every
+// time. The phases of the updates are reported as counters - in milliseconds per update -
+// when built with ENABLE_PERF_STATS.
+//
+// Must be run from the directory that contains the Data, Ships, and Test Ships folders.
+//
+
+namespace {
+
+static constexpr unsigned int RandomSeed = 42;
+
+// Fed back to the ships as the average update duration, so that their number of
+// mechanical iterations - when adaptive - doesn't depend on the machine
+static constexpr float NominalUpdateDurationMillis = 10.0f;
+
+struct ShipUpdateEnvironment
+{
+    ResourceLoader ResourceLoaderInstance;
+    MaterialDatabase MaterialDatabaseInstance;
+    GameParameters GameParametersInstance;
+    Physics::World WorldInstance;
+    Render::ViewModel ViewModelInstance; // The initial view of the game, at 1024x768
+    SimulationView SimulationViewInstance;
+
+    ShipUpdateEnvironment()
+        : ResourceLoaderInstance()
+        , MaterialDatabaseInstance(MaterialDatabase::Load(ResourceLoaderInstance))
+        , GameParametersInstance(MakeGameParameters())
+        , WorldInstance(
+            std::make_shared<IGameEventHandler>(),
+            GameParametersInstance,
+            ResourceLoaderInstance)
+        , ViewModelInstance(1.0f, vec2f::zero(), 1024, 768)
+        , SimulationViewInstance(
+            ViewModelInstance.GetVisibleWorldTopLeft().x,
+            ViewModelInstance.GetVisibleWorldBottomRight().x,
+            ViewModelInstance.GetVisibleWorldTopLeft().y,
+            ViewModelInstance.GetVisibleWorldBottomRight().y,
+            false)
+    {}
+
+    static ShipUpdateEnvironment & GetInstance()
+    {
+        static ShipUpdateEnvironment environment;
+        return environment;
+    }
+
+    std::unique_ptr<Physics::Ship> CreateShip(ShipDefinition shipDefinition)
+    {
+        // Every ship starts from the same state
+        GameRandomEngine::GetInstance().Reseed(RandomSeed);
+
+        return ShipBuilder::Create(
+            0,
+            WorldInstance,
+            std::make_shared<IGameEventHandler>(),
+            shipDefinition,
+            MaterialDatabaseInstance,
+            GameParametersInstance);
+    }
+
+private:
+
+    static GameParameters MakeGameParameters()
+    {
+        GameParameters gameParameters;
+
+        // GPU calculators need an OpenGL context
+        gameParameters.DoUseGPUWaterDiffusion = false;
+        gameParameters.DoUseGPUMechanicalDynamics = false;
+
+        return gameParameters;
+    }
+};
+
+}
+
+static void ShipBuilder_Create(
+    benchmark::State & state,
+    std::filesystem::path const & shipFilepath)
+{
+    auto & environment = ShipUpdateEnvironment::GetInstance();
+
+    size_t pointCount = 0;
+    for (auto _ : state)
+    {
+        // Building consumes the definition
+        state.PauseTiming();
+        auto shipDefinition = ShipDefinition::Load(shipFilepath);
+        state.ResumeTiming();
+
+        auto ship = environment.CreateShip(std::move(shipDefinition));
+
+        pointCount = ship->GetPoints().GetElementCount();
+
+        benchmark::DoNotOptimize(ship);
+    }
+
+    state.counters["Points"] = static_cast<double>(pointCount);
+}
+
+static void Ship_Update(
+    benchmark::State & state,
+    std::filesystem::path const & shipFilepath)
+{
+    auto & environment = ShipUpdateEnvironment::GetInstance();
+
+    auto ship = environment.CreateShip(ShipDefinition::Load(shipFilepath));
+
+    float currentSimulationTime = 0.0f;
+    for (auto _ : state)
+    {
+        ship->Update(
+            currentSimulationTime,
+            environment.GameParametersInstance,
+            NominalUpdateDurationMillis,
+            environment.SimulationViewInstance);
+
+        currentSimulationTime += GameParameters::SimulationStepTimeDuration<float>;
+
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["Points"] = static_cast<double>(ship->GetPoints().GetElementCount());
+
+    // Only measured when built with ENABLE_PERF_STATS
+    auto const & perfStats = ship->GetPerfStats();
+    for (size_t p = 0; p < Physics::ShipPerfStats::PhaseCount; ++p)
+    {
+        auto const phase = static_cast<Physics::ShipPerfStats::Phase>(p);
+        state.counters[Physics::ShipPerfStats::GetPhaseName(phase)] = perfStats.GetAverageMillis(phase);
+    }
+}
+
+static void Ship_FullConnectivityVisit(
+    benchmark::State & state,
+    std::filesystem::path const & shipFilepath)
+{
+    auto & environment = ShipUpdateEnvironment::GetInstance();
+
+    auto ship = environment.CreateShip(ShipDefinition::Load(shipFilepath));
+
+    for (auto _ : state)
+    {
+        ship->ForceFullConnectivityVisit();
+
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["Points"] = static_cast<double>(ship->GetPoints().GetElementCount());
+}
+
+static bool RegisterShipUpdateBenchmarks()
+{
+    std::vector<std::filesystem::path> shipFilepaths;
+    for (std::filesystem::path const shipsFolderPath : { "Ships", "Test Ships" })
+    {
+        if (!std::filesystem::is_directory(shipsFolderPath))
+            continue;
+
+        for (auto const & entry : std::filesystem::directory_iterator(shipsFolderPath))
+        {
+            if (entry.is_regular_file()
+                && (Utils::ToLower(entry.path().extension().string()) == ".png"
+                    || ShipDefinitionFile::IsShipDefinitionFile(entry.path())))
+            {
+                shipFilepaths.push_back(entry.path());
+            }
+        }
+    }
+
+    if (shipFilepaths.empty())
+        return false;
+
+    // Register in a stable order, so that runs may be compared line by line
+    std::sort(shipFilepaths.begin(), shipFilepaths.end());
+
+    for (auto const & shipFilepath : shipFilepaths)
+    {
+        std::string const shipName = shipFilepath.stem().string();
+
+        benchmark::RegisterBenchmark(
+            ("ShipBuilder_Create/" + shipName).c_str(),
+            ShipBuilder_Create,
+            shipFilepath);
+
+        benchmark::RegisterBenchmark(
+            ("Ship_Update/" + shipName).c_str(),
+            Ship_Update,
+            shipFilepath);
+
+        benchmark::RegisterBenchmark(
+            ("Ship_FullConnectivityVisit/" + shipName).c_str(),
+            Ship_FullConnectivityVisit,
+            shipFilepath);
+    }
+
+    return true;
+}
+
+static bool const AreShipUpdateBenchmarksRegistered = RegisterShipUpdateBenchmarks();
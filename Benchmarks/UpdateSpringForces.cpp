@@ -6,10 +6,23 @@
 #define SIMDPP_ARCH_X86_SSSE3
 #include "simdpp/simd.h"
 
+#include <Game/GameParameters.h>
+#include <Game/IGameEventHandler.h>
+#include <Game/MaterialDatabase.h>
+#include <Game/Physics.h>
+#include <Game/ResourceLoader.h>
+#include <Game/ShipBuilder.h>
+#include <Game/ShipDefinition.h>
+
 #include <benchmark/benchmark.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <filesystem>
 #include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
 static constexpr size_t SampleSize = 20000000;
 
@@ -263,3 +276,270 @@ static void UpdateSpringForces_LibSimdPpAndIntrinsics(benchmark::State& state)
     benchmark::DoNotOptimize(pointsForce);
 }
 BENCHMARK(UpdateSpringForces_LibSimdPpAndIntrinsics);
+
+//
+// Layouts of the spring data, on real ships
+//
+// Compares the split layout of Springs - one stream for the endpoints, one for the
+// rest lengths, and one for the coefficients - with AoSoA layouts, in which blocks of
+// springs keep all of their data together; the split layout is also measured with 16-bit
+// endpoints, as with USE_16BIT_ELEMENT_INDICES. All layouts run the same scalar kernel,
+// so that only the layouts differ.
+//
+// Must be run from the directory that contains the Data and Ships folders.
+//
+
+namespace {
+
+struct SpringLayoutEnvironment
+{
+    ResourceLoader ResourceLoaderInstance;
+    MaterialDatabase MaterialDatabaseInstance;
+    GameParameters GameParametersInstance;
+    Physics::World WorldInstance;
+
+    SpringLayoutEnvironment()
+        : ResourceLoaderInstance()
+        , MaterialDatabaseInstance(MaterialDatabase::Load(ResourceLoaderInstance))
+        , GameParametersInstance()
+        , WorldInstance(
+            std::make_shared<IGameEventHandler>(),
+            GameParametersInstance,
+            ResourceLoaderInstance)
+    {}
+
+    static SpringLayoutEnvironment & GetInstance()
+    {
+        static SpringLayoutEnvironment environment;
+        return environment;
+    }
+};
+
+inline void ApplySpringForce(
+    ElementIndex pointAIndex,
+    ElementIndex pointBIndex,
+    float restLength,
+    float stiffnessCoefficient,
+    float dampingCoefficient,
+    vec2f const * restrict pointPositions,
+    vec2f const * restrict pointVelocities,
+    vec2f * restrict pointForces)
+{
+    vec2f const displacement = pointPositions[pointBIndex] - pointPositions[pointAIndex];
+    float const displacementLength = displacement.length();
+    vec2f const springDir = displacement.normalise(displacementLength);
+
+    vec2f const fSpringA =
+        springDir
+        * (displacementLength - restLength)
+        * stiffnessCoefficient;
+
+    vec2f const relVelocity = pointVelocities[pointBIndex] - pointVelocities[pointAIndex];
+    vec2f const fDampA =
+        springDir
+        * relVelocity.dot(springDir)
+        * dampingCoefficient;
+
+    pointForces[pointAIndex] += fSpringA + fDampA;
+    pointForces[pointBIndex] -= fSpringA + fDampA;
+}
+
+/*
+ * The layout of Springs, with endpoints of the specified width.
+ */
+template<typename TEndpointIndex>
+struct SplitSpringLayout
+{
+    using EndpointIndex = TEndpointIndex;
+
+    static std::string GetName()
+    {
+        return "Split" + std::to_string(sizeof(TEndpointIndex) * 8);
+    }
+
+    std::vector<TEndpointIndex> Endpoints; // A and B, interleaved
+    std::vector<float> RestLengths;
+    std::vector<float> Coefficients; // Stiffness and damping, interleaved
+
+    explicit SplitSpringLayout(Physics::Springs const & springs)
+        : Endpoints(springs.GetEndpointsBufferAsElementIndex(), springs.GetEndpointsBufferAsElementIndex() + springs.GetElementCount() * 2)
+        , RestLengths(springs.GetRestLengthBuffer(), springs.GetRestLengthBuffer() + springs.GetElementCount())
+        , Coefficients(springs.GetCoefficientsBufferAsFloat(), springs.GetCoefficientsBufferAsFloat() + springs.GetElementCount() * 2)
+    {}
+
+    void CalculateForces(
+        vec2f const * restrict pointPositions,
+        vec2f const * restrict pointVelocities,
+        vec2f * restrict pointForces) const
+    {
+        size_t const springCount = RestLengths.size();
+        for (size_t s = 0; s < springCount; ++s)
+        {
+            ApplySpringForce(
+                Endpoints[s * 2],
+                Endpoints[s * 2 + 1],
+                RestLengths[s],
+                Coefficients[s * 2],
+                Coefficients[s * 2 + 1],
+                pointPositions,
+                pointVelocities,
+                pointForces);
+        }
+    }
+};
+
+/*
+ * Blocks of springs, each with all of the data of its springs.
+ */
+template<size_t BlockSize>
+struct BlockedSpringLayout
+{
+    using EndpointIndex = ElementIndex;
+
+    static std::string GetName()
+    {
+        return "Blocked" + std::to_string(BlockSize);
+    }
+
+    struct alignas(64) Block
+    {
+        ElementIndex EndpointA[BlockSize];
+        ElementIndex EndpointB[BlockSize];
+        float RestLength[BlockSize];
+        float Stiffness[BlockSize];
+        float Damping[BlockSize];
+    };
+
+    std::vector<Block> Blocks;
+
+    explicit BlockedSpringLayout(Physics::Springs const & springs)
+        : Blocks((springs.GetElementCount() + BlockSize - 1) / BlockSize)
+    {
+        ElementIndex const * const endpoints = springs.GetEndpointsBufferAsElementIndex();
+        float const * const restLengths = springs.GetRestLengthBuffer();
+        float const * const coefficients = springs.GetCoefficientsBufferAsFloat();
+
+        for (size_t s = 0; s < Blocks.size() * BlockSize; ++s)
+        {
+            auto & block = Blocks[s / BlockSize];
+            size_t const lane = s % BlockSize;
+
+            if (s < springs.GetElementCount())
+            {
+                block.EndpointA[lane] = endpoints[s * 2];
+                block.EndpointB[lane] = endpoints[s * 2 + 1];
+                block.RestLength[lane] = restLengths[s];
+                block.Stiffness[lane] = coefficients[s * 2];
+                block.Damping[lane] = coefficients[s * 2 + 1];
+            }
+            else
+            {
+                // Padding: no force, as for deleted springs
+                block.EndpointA[lane] = 0;
+                block.EndpointB[lane] = 0;
+                block.RestLength[lane] = 0.0f;
+                block.Stiffness[lane] = 0.0f;
+                block.Damping[lane] = 0.0f;
+            }
+        }
+    }
+
+    void CalculateForces(
+        vec2f const * restrict pointPositions,
+        vec2f const * restrict pointVelocities,
+        vec2f * restrict pointForces) const
+    {
+        for (auto const & block : Blocks)
+        {
+            for (size_t lane = 0; lane < BlockSize; ++lane)
+            {
+                ApplySpringForce(
+                    block.EndpointA[lane],
+                    block.EndpointB[lane],
+                    block.RestLength[lane],
+                    block.Stiffness[lane],
+                    block.Damping[lane],
+                    pointPositions,
+                    pointVelocities,
+                    pointForces);
+            }
+        }
+    }
+};
+
+}
+
+template<typename TSpringLayout>
+static void UpdateSpringForces_ShipLayout(
+    benchmark::State & state,
+    std::filesystem::path const & shipFilepath)
+{
+    auto & environment = SpringLayoutEnvironment::GetInstance();
+
+    auto shipDefinition = ShipDefinition::Load(shipFilepath);
+
+    auto ship = ShipBuilder::Create(
+        0,
+        environment.WorldInstance,
+        std::make_shared<IGameEventHandler>(),
+        shipDefinition,
+        environment.MaterialDatabaseInstance,
+        environment.GameParametersInstance);
+
+    auto & points = ship->GetPoints();
+
+    if (points.GetElementCount() > std::numeric_limits<typename TSpringLayout::EndpointIndex>::max())
+    {
+        state.SkipWithError("The ship has too many points for the endpoint indices of this layout");
+        return;
+    }
+
+    TSpringLayout const springLayout(ship->GetSprings());
+
+    for (auto _ : state)
+    {
+        springLayout.CalculateForces(
+            points.GetPositionBufferAsVec2(),
+            points.GetVelocityBufferAsVec2(),
+            points.GetForceBufferAsVec2());
+
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["Springs"] = static_cast<double>(ship->GetSprings().GetElementCount());
+}
+
+template<typename TSpringLayout>
+static void RegisterSpringLayoutBenchmark(std::filesystem::path const & shipFilepath)
+{
+    benchmark::RegisterBenchmark(
+        ("UpdateSpringForces_ShipLayout/" + shipFilepath.stem().string() + "/" + TSpringLayout::GetName()).c_str(),
+        UpdateSpringForces_ShipLayout<TSpringLayout>,
+        shipFilepath);
+}
+
+static bool RegisterSpringLayoutBenchmarks()
+{
+    std::filesystem::path const shipsFolderPath("Ships");
+    if (!std::filesystem::is_directory(shipsFolderPath))
+        return false;
+
+    for (auto const & entry : std::filesystem::directory_iterator(shipsFolderPath))
+    {
+        if (!entry.is_regular_file()
+            || (entry.path().extension() != ".shp" && entry.path().extension() != ".png"))
+        {
+            continue;
+        }
+
+        RegisterSpringLayoutBenchmark<SplitSpringLayout<std::uint32_t>>(entry.path());
+        RegisterSpringLayoutBenchmark<SplitSpringLayout<std::uint16_t>>(entry.path());
+        RegisterSpringLayoutBenchmark<BlockedSpringLayout<4>>(entry.path());
+        RegisterSpringLayoutBenchmark<BlockedSpringLayout<8>>(entry.path());
+        RegisterSpringLayoutBenchmark<BlockedSpringLayout<16>>(entry.path());
+    }
+
+    return true;
+}
+
+static bool const AreSpringLayoutBenchmarksRegistered = RegisterSpringLayoutBenchmarks();
@@ -486,4 +486,42 @@ static void VectorNormalization_Vectorized_AndLength_VSizeGnostic_FullInstrinsic
     benchmark::DoNotOptimize(results);
     benchmark::DoNotOptimize(lengths);
 }
-BENCHMARK(VectorNormalization_Vectorized_AndLength_VSizeGnostic_FullInstrinsics);
\ No newline at end of file
+BENCHMARK(VectorNormalization_Vectorized_AndLength_VSizeGnostic_FullInstrinsics);
+static void VectorNormalization_Batch_AndLength(benchmark::State& state)
+{
+    auto const size = MakeSize(SampleSize);
+
+    std::vector<vec2f> points;
+    std::vector<SpringEndpoints> springs;
+    MakeGraph(size, points, springs);
+
+    std::vector<vec2f> results;
+    results.resize(size);
+
+    std::vector<float> lengths;
+    lengths.resize(size);
+
+    auto const precision = static_cast<VectorBatchPrecision>(state.range(0));
+
+    vec2f const * restrict pointData = points.data();
+    SpringEndpoints const * restrict springData = springs.data();
+    vec2f * restrict resultData = results.data();
+
+    for (auto _ : state)
+    {
+        // Gather the displacements first, and normalize them in place
+        for (size_t i = 0; i < size; ++i)
+        {
+            resultData[i] = pointData[springData[i].PointBIndex] - pointData[springData[i].PointAIndex];
+        }
+
+        BatchNormalize(results.data(), results.data(), lengths.data(), size, precision);
+    }
+
+    benchmark::DoNotOptimize(results);
+    benchmark::DoNotOptimize(lengths);
+}
+BENCHMARK(VectorNormalization_Batch_AndLength)
+    ->ArgName("Precision")
+    ->Arg(static_cast<int>(VectorBatchPrecision::Exact))
+    ->Arg(static_cast<int>(VectorBatchPrecision::Fast));
@@ -0,0 +1,172 @@
+###VERTEX
+
+#version 120
+
+#define in attribute
+#define out varying
+
+// Inputs
+in vec2 inVertexShaderInput0;
+
+void main()
+{
+    gl_Position = vec4(inVertexShaderInput0.xy, -1.0, 1.0);
+}
+
+
+###FRAGMENT
+
+#version 120
+
+#define in varying
+
+#define MAX_SPRINGS_PER_POINT 9
+
+// Input textures
+uniform sampler2D paramTextureInput0; // Point position (x,y), velocity (z,w)
+uniform sampler2D paramTextureInput1; // Point integration factor (x,y), total mass (z), water volume fill (w)
+uniform sampler2D paramTextureInput2; // Point water height (x), ocean floor height (y), wind force multiplier (z)
+uniform sampler2D paramTextureInput3; // Adjacency: other endpoint index (x), rest length (y), stiffness (z), damping (w)
+uniform sampler2D paramTextureInput4; // Ocean floor heights, four samples per pixel
+
+// Parameters
+uniform vec2 paramPointTextureSize;
+uniform vec2 paramAdjacencyTextureSize;
+uniform vec3 paramOceanFloorGeometry; // Min x, dx, sample count
+uniform vec2 paramGravity;
+uniform vec2 paramWindForce;
+uniform vec4 paramMechanicalDynamicsCoefficients; // Dt, global damp, water drag, density-adjusted water mass
+
+vec2 PointIndexToTextureCoords(float pointIndex)
+{
+    float row = floor((pointIndex + 0.5) / paramPointTextureSize.x);
+    float col = pointIndex - row * paramPointTextureSize.x;
+    return vec2(col + 0.5, row + 0.5) / paramPointTextureSize;
+}
+
+float GetOceanFloorSample(float sampleIndex)
+{
+    float pixel = floor(sampleIndex / 4.0);
+    float component = sampleIndex - pixel * 4.0;
+
+    vec4 samples = texture2D(paramTextureInput4, vec2((pixel + 0.5) / ceil(paramOceanFloorGeometry.z / 4.0), 0.5));
+
+    return dot(samples, vec4(equal(vec4(component), vec4(0.0, 1.0, 2.0, 3.0))));
+}
+
+// See OceanFloor::GetHeightAt()
+float GetOceanFloorHeightAt(float x)
+{
+    float sampleIndexF = clamp(
+        (x - paramOceanFloorGeometry.x) / paramOceanFloorGeometry.y,
+        0.0,
+        paramOceanFloorGeometry.z - 1.0);
+
+    float sampleIndexI = min(floor(sampleIndexF), paramOceanFloorGeometry.z - 2.0);
+
+    return mix(
+        GetOceanFloorSample(sampleIndexI),
+        GetOceanFloorSample(sampleIndexI + 1.0),
+        sampleIndexF - sampleIndexI);
+}
+
+void main()
+{
+    float dt = paramMechanicalDynamicsCoefficients.x;
+    float globalDampCoefficient = paramMechanicalDynamicsCoefficients.y;
+    float waterDragCoefficient = paramMechanicalDynamicsCoefficients.z;
+    float densityAdjustedWaterMass = paramMechanicalDynamicsCoefficients.w;
+
+    vec2 pointPixel = floor(gl_FragCoord.xy);
+    vec2 pointTextureCoords = (pointPixel + 0.5) / paramPointTextureSize;
+
+    vec4 pointDynamics = texture2D(paramTextureInput0, pointTextureCoords);
+    vec2 position = pointDynamics.xy;
+    vec2 velocity = pointDynamics.zw;
+
+    vec4 pointAttributes0 = texture2D(paramTextureInput1, pointTextureCoords);
+    vec4 pointAttributes1 = texture2D(paramTextureInput2, pointTextureCoords);
+
+    vec2 force = vec2(0.0);
+
+    //
+    // 1. Spring forces - see Physics::CalculateSpringForces()
+    //
+    // Each point gathers the forces of its own springs, hence each spring is
+    // evaluated twice, once by each endpoint
+    //
+
+    for (int s = 0; s < MAX_SPRINGS_PER_POINT; ++s)
+    {
+        vec2 adjacencyTextureCoords = vec2(
+            pointPixel.x * float(MAX_SPRINGS_PER_POINT) + float(s) + 0.5,
+            pointPixel.y + 0.5) / paramAdjacencyTextureSize;
+
+        vec4 adjacency = texture2D(paramTextureInput3, adjacencyTextureCoords);
+        if (adjacency.x < 0.0)
+            continue;
+
+        vec4 otherEndpointDynamics = texture2D(paramTextureInput0, PointIndexToTextureCoords(adjacency.x));
+
+        vec2 displacement = otherEndpointDynamics.xy - position;
+        float displacementLength = length(displacement);
+        vec2 springDir = displacementLength > 0.0 ? displacement / displacementLength : vec2(0.0);
+
+        // Hooke's law
+        force += springDir * (displacementLength - adjacency.y) * adjacency.z;
+
+        // Damper
+        force += springDir * dot(otherEndpointDynamics.zw - velocity, springDir) * adjacency.w;
+    }
+
+    //
+    // 2. Point forces - see Ship::ApplyPointForces()
+    //
+
+    float waterHeight = pointAttributes1.x;
+
+    // Gravity
+    force += paramGravity * pointAttributes0.z;
+
+    // Buoyancy
+    if (position.y < waterHeight)
+        force -= paramGravity * pointAttributes0.w * densityAdjustedWaterMass;
+
+    if (position.y <= waterHeight)
+    {
+        // Water drag
+        force -= velocity * waterDragCoefficient;
+    }
+    else
+    {
+        // Wind
+        force += paramWindForce * pointAttributes1.z;
+    }
+
+    //
+    // 3. Verlet integration - see Ship::IntegrateAndResetPointForces()
+    //
+
+    vec2 deltaPos = velocity * dt + force * pointAttributes0.xy;
+    position += deltaPos;
+    velocity = deltaPos * globalDampCoefficient / dt;
+
+    //
+    // 4. Collision with the sea floor - see Ship::HandleCollisionWithSeaFloor()
+    //
+
+    float floorHeight = pointAttributes1.y;
+    if (position.y < floorHeight)
+    {
+        // Move point back to where it was
+        position -= velocity * dt;
+
+        vec2 seaFloorNormal = normalize(vec2(
+            floorHeight - GetOceanFloorHeightAt(position.x + 0.01),
+            0.01));
+
+        velocity = velocity * -0.75 + seaFloorNormal * 0.5;
+    }
+
+    gl_FragColor = vec4(position, velocity);
+}
@@ -0,0 +1,184 @@
+###VERTEX
+
+#version 120
+
+#define in attribute
+#define out varying
+
+// Inputs
+in vec2 inVertexShaderInput0;
+
+void main()
+{
+    gl_Position = vec4(inVertexShaderInput0.xy, -1.0, 1.0);
+}
+
+
+###FRAGMENT
+
+#version 120
+
+#define in varying
+
+#define MAX_SPRINGS_PER_POINT 9
+
+// Input textures
+uniform sampler2D paramTextureInput0; // Point position (x,y), water (z), diffusion fraction (w)
+uniform sampler2D paramTextureInput1; // Point water velocity (x,y)
+uniform sampler2D paramTextureInput2; // Adjacency: other endpoint index (x), rest length (y), permeability (z)
+uniform sampler2D paramTextureInput3; // Point water quantity normalization factor (x)
+
+// Parameters
+uniform vec2 paramPointTextureSize;
+uniform vec2 paramAdjacencyTextureSize;
+uniform float paramGravityMagnitude;
+uniform float paramWaterCrazyness;
+
+vec2 PointIndexToTextureCoords(float pointIndex)
+{
+    float row = floor((pointIndex + 0.5) / paramPointTextureSize.x);
+    float col = pointIndex - row * paramPointTextureSize.x;
+    return vec2(col + 0.5, row + 0.5) / paramPointTextureSize;
+}
+
+// Resultant outbound scalar water velocity along a spring, from a point to
+// the other endpoint; see Ship::UpdateWaterVelocities()
+float CalculateOutboundScalarWaterVelocity(
+    vec2 springNormalizedVector,
+    float pointWater,
+    float pointY,
+    vec2 pointWaterVelocity,
+    float otherEndpointWater,
+    float otherEndpointY)
+{
+    float alphaCrazyness = 1.0 + paramWaterCrazyness * (pointWater - 1.0);
+
+    float dwy = (pointWater - otherEndpointWater) + (pointY - otherEndpointY);
+    float bernoulliVelocityAlongSpring = sign(dwy) * sqrt(2.0 * paramGravityMagnitude * abs(dwy));
+
+    return max(
+        dot(pointWaterVelocity, springNormalizedVector) + bernoulliVelocityAlongSpring * alphaCrazyness,
+        0.0);
+}
+
+void main()
+{
+    vec2 pointPixel = floor(gl_FragCoord.xy);
+    vec2 pointTextureCoords = (pointPixel + 0.5) / paramPointTextureSize;
+
+    vec4 pointAttributes0 = texture2D(paramTextureInput0, pointTextureCoords);
+    vec2 pointWaterVelocity = texture2D(paramTextureInput1, pointTextureCoords).xy;
+    float pointWaterQuantityNormalizationFactor = texture2D(paramTextureInput3, pointTextureCoords).x;
+    float pointWater = pointAttributes0.z;
+
+    float newPointWater = pointWater;
+    vec2 newPointWaterMomentum = pointWaterVelocity * pointWater;
+
+    float pointKineticEnergyLoss = 0.0;
+    float pointSplashNeighbors = 0.0;
+    float pointSplashFreeNeighbors = 0.0;
+
+    for (int s = 0; s < MAX_SPRINGS_PER_POINT; ++s)
+    {
+        vec2 adjacencyTextureCoords = vec2(
+            pointPixel.x * float(MAX_SPRINGS_PER_POINT) + float(s) + 0.5,
+            pointPixel.y + 0.5) / paramAdjacencyTextureSize;
+
+        vec4 adjacency = texture2D(paramTextureInput2, adjacencyTextureCoords);
+        if (adjacency.x < 0.0)
+            continue;
+
+        vec2 otherEndpointTextureCoords = PointIndexToTextureCoords(adjacency.x);
+        vec4 otherEndpointAttributes0 = texture2D(paramTextureInput0, otherEndpointTextureCoords);
+        vec2 otherEndpointWaterVelocity = texture2D(paramTextureInput1, otherEndpointTextureCoords).xy;
+        float otherEndpointWater = otherEndpointAttributes0.z;
+
+        vec2 springNormalizedVector = normalize(otherEndpointAttributes0.xy - pointAttributes0.xy);
+
+        //
+        // Outbound flow: from point to other endpoint
+        //
+
+        float springOutboundScalarWaterVelocity = CalculateOutboundScalarWaterVelocity(
+            springNormalizedVector,
+            pointWater,
+            pointAttributes0.y,
+            pointWaterVelocity,
+            otherEndpointWater,
+            otherEndpointAttributes0.y);
+
+        vec2 springOutboundWaterVelocity = springNormalizedVector * springOutboundScalarWaterVelocity;
+
+        float springOutboundQuantityOfWater =
+            springOutboundScalarWaterVelocity
+            / adjacency.y
+            * pointWaterQuantityNormalizationFactor;
+
+        float ma = springOutboundQuantityOfWater;
+        float va = length(springOutboundWaterVelocity);
+
+        if (adjacency.z != 0.0)
+        {
+            // Water - and momentum - move from point to other endpoint
+            newPointWater -= springOutboundQuantityOfWater;
+            newPointWaterMomentum -= pointWaterVelocity * springOutboundQuantityOfWater;
+
+            // Kinetic energy loss: splintered water colliding with whole other endpoint
+            float mb = otherEndpointWater;
+            float vb = dot(otherEndpointWaterVelocity, springNormalizedVector);
+
+            float vf = 0.0;
+            if (ma + mb != 0.0)
+                vf = (ma * va + mb * vb) / (ma + mb);
+
+            pointKineticEnergyLoss += max(0.5 * ma * (va * va - vf * vf), 0.0);
+
+            //
+            // Inbound flow: from other endpoint to point
+            //
+
+            float springInboundScalarWaterVelocity = CalculateOutboundScalarWaterVelocity(
+                -springNormalizedVector,
+                otherEndpointWater,
+                otherEndpointAttributes0.y,
+                otherEndpointWaterVelocity,
+                pointWater,
+                pointAttributes0.y);
+
+            float springInboundQuantityOfWater =
+                springInboundScalarWaterVelocity
+                / adjacency.y
+                * texture2D(paramTextureInput3, otherEndpointTextureCoords).x;
+
+            newPointWater += springInboundQuantityOfWater;
+            newPointWaterMomentum -=
+                springNormalizedVector
+                * springInboundScalarWaterVelocity
+                * springInboundQuantityOfWater;
+        }
+        else
+        {
+            // New momentum bounces back, assuming perfectly inelastic collision
+            newPointWaterMomentum -= springOutboundWaterVelocity * springOutboundQuantityOfWater;
+
+            // Kinetic energy loss: entire splintered water
+            pointKineticEnergyLoss += 0.5 * ma * va * va;
+        }
+
+        // Splash neighbors
+        float otherEndpointFreenessFactor = exp(-otherEndpointWater * 10.0);
+        pointSplashFreeNeighbors += adjacency.z * otherEndpointFreenessFactor;
+        pointSplashNeighbors += adjacency.z;
+    }
+
+    float pointWaterSplashed = 0.0;
+    if (pointSplashNeighbors != 0.0)
+    {
+        pointWaterSplashed =
+            pointKineticEnergyLoss
+            * pointSplashFreeNeighbors
+            / pointSplashNeighbors;
+    }
+
+    gl_FragColor = vec4(newPointWater, newPointWaterMomentum, pointWaterSplashed);
+}
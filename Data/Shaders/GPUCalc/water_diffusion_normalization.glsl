@@ -0,0 +1,92 @@
+###VERTEX
+
+#version 120
+
+#define in attribute
+#define out varying
+
+// Inputs
+in vec2 inVertexShaderInput0;
+
+void main()
+{
+    gl_Position = vec4(inVertexShaderInput0.xy, -1.0, 1.0);
+}
+
+
+###FRAGMENT
+
+#version 120
+
+#define in varying
+
+#define MAX_SPRINGS_PER_POINT 9
+
+// Input textures
+uniform sampler2D paramTextureInput0; // Point position (x,y), water (z), diffusion fraction (w)
+uniform sampler2D paramTextureInput1; // Point water velocity (x,y)
+uniform sampler2D paramTextureInput2; // Adjacency: other endpoint index (x), rest length (y), permeability (z)
+
+// Parameters
+uniform vec2 paramPointTextureSize;
+uniform vec2 paramAdjacencyTextureSize;
+uniform float paramGravityMagnitude;
+uniform float paramWaterCrazyness;
+
+vec2 PointIndexToTextureCoords(float pointIndex)
+{
+    float row = floor((pointIndex + 0.5) / paramPointTextureSize.x);
+    float col = pointIndex - row * paramPointTextureSize.x;
+    return vec2(col + 0.5, row + 0.5) / paramPointTextureSize;
+}
+
+void main()
+{
+    vec2 pointPixel = floor(gl_FragCoord.xy);
+    vec2 pointTextureCoords = (pointPixel + 0.5) / paramPointTextureSize;
+
+    vec4 pointAttributes0 = texture2D(paramTextureInput0, pointTextureCoords);
+    vec2 pointWaterVelocity = texture2D(paramTextureInput1, pointTextureCoords).xy;
+    float pointWater = pointAttributes0.z;
+
+    // See Ship::UpdateWaterVelocities()
+    float alphaCrazyness = 1.0 + paramWaterCrazyness * (pointWater - 1.0);
+
+    float totalOutboundWaterFlowWeight = 0.0;
+
+    for (int s = 0; s < MAX_SPRINGS_PER_POINT; ++s)
+    {
+        vec2 adjacencyTextureCoords = vec2(
+            pointPixel.x * float(MAX_SPRINGS_PER_POINT) + float(s) + 0.5,
+            pointPixel.y + 0.5) / paramAdjacencyTextureSize;
+
+        vec4 adjacency = texture2D(paramTextureInput2, adjacencyTextureCoords);
+        if (adjacency.x < 0.0)
+            continue;
+
+        vec4 otherEndpointAttributes0 = texture2D(paramTextureInput0, PointIndexToTextureCoords(adjacency.x));
+
+        vec2 springNormalizedVector = normalize(otherEndpointAttributes0.xy - pointAttributes0.xy);
+
+        // Bernoulli's velocity from point to other endpoint
+        float dwy = (pointWater - otherEndpointAttributes0.z) + (pointAttributes0.y - otherEndpointAttributes0.y);
+        float bernoulliVelocityAlongSpring = sign(dwy) * sqrt(2.0 * paramGravityMagnitude * abs(dwy));
+
+        float springOutboundScalarWaterVelocity = max(
+            dot(pointWaterVelocity, springNormalizedVector) + bernoulliVelocityAlongSpring * alphaCrazyness,
+            0.0);
+
+        totalOutboundWaterFlowWeight += springOutboundScalarWaterVelocity / adjacency.y;
+    }
+
+    float waterQuantityNormalizationFactor = 0.0;
+    if (totalOutboundWaterFlowWeight != 0.0)
+    {
+        waterQuantityNormalizationFactor =
+            pointWater
+            * pointAttributes0.w
+            / totalOutboundWaterFlowWeight;
+    }
+
+    gl_FragColor = vec4(waterQuantityNormalizationFactor, 0.0, 0.0, 0.0);
+}
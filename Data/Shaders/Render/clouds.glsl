@@ -6,19 +6,54 @@
 #define out varying
 
 //
-// Clouds' inputs are directly in NDC coordinates
+// Clouds are drawn as instances of a single quad, directly in NDC coordinates;
+// each instance carries the constants of its cloud's motion, and the vertex
+// shader animates it out of the current simulation time
 //
 
 // Inputs
-in vec4 inCloud; // Position (vec2), TextureCoordinates (vec2)
+in vec2 inCloud; // Quad corner, between (0,0) (bottom-left) and (1,1) (top-right)
+in vec4 inCloudInstance1; // OffsetX, SpeedX1, AmpX, SpeedX2
+in vec4 inCloudInstance2; // OffsetY, AmpY, SpeedY, -
+in vec4 inCloudInstance3; // OffsetScale, AmpScale, SpeedScale, -
+in vec4 inCloudInstance4; // Frame offsets from anchor: left, bottom, right, top
+in vec4 inCloudInstance5; // Texture coordinates: left, bottom, right, top
 
 // Outputs
 out vec2 texturePos;
 
+// Params
+uniform float paramCloudSpeed;
+uniform float paramCurrentSimulationTime;
+uniform vec2 paramViewportSize;
+
 void main()
 {
-    gl_Position = vec4(inCloud.xy, -1.0, 1.0);
-    texturePos = inCloud.zw;
+    float scaledSpeed = paramCurrentSimulationTime * paramCloudSpeed;
+
+    float virtualX = inCloudInstance1.x + (inCloudInstance1.y * scaledSpeed) + (inCloudInstance1.z * sin(inCloudInstance1.w * scaledSpeed));
+    float virtualY = inCloudInstance2.x + (inCloudInstance2.y * sin(inCloudInstance2.z * scaledSpeed));
+    float scale = inCloudInstance3.x + (inCloudInstance3.y * sin(inCloudInstance3.z * scaledSpeed));
+
+    //
+    // Roll coordinates into a 3.0 X 2.0 view,
+    // then take the central slice and map it into NDC ((-1,-1) X (1,1))
+    //
+
+    float mappedX = -1.0 + 2.0 * (mod(virtualX, 3.0) - 1.0);
+    float mappedY = -1.0 + 2.0 * (mod(virtualY, 2.0) - 0.5);
+
+    float aspectRatio = paramViewportSize.x / paramViewportSize.y;
+
+    vec2 frameOffset = mix(inCloudInstance4.xy, inCloudInstance4.zw, inCloud);
+
+    gl_Position = vec4(
+        mappedX + scale * frameOffset.x,
+        mappedY + scale * frameOffset.y * aspectRatio,
+        -1.0,
+        1.0);
+
+    texturePos = mix(inCloudInstance5.xy, inCloudInstance5.zw, inCloud);
 }
 
 ###FRAGMENT
@@ -0,0 +1,89 @@
+###VERTEX
+
+#version 120
+
+#define in attribute
+#define out varying
+
+// Inputs
+in vec4 inEphemeralParticle1; // startPosition, startVelocity
+in vec4 inEphemeralParticle2; // vertexOffset, textureCoordinates
+in vec4 inEphemeralParticle3; // color
+in vec4 inEphemeralParticle4; // startTime, maxLifetime, spin, ambientLightSensitivity
+
+// Outputs
+out vec2 vertexTextureCoordinates;
+out vec4 vertexColor;
+out float vertexAmbientLightIntensity;
+
+// Params
+uniform float paramAmbientLightIntensity;
+uniform float paramCurrentSimulationTime;
+uniform mat4 paramOrthoMatrix;
+
+void main()
+{
+    float elapsed = paramCurrentSimulationTime - inEphemeralParticle4.x;
+    float progress = elapsed / inEphemeralParticle4.y;
+
+    if (elapsed < 0.0 || progress >= 1.0)
+    {
+        // Not born yet, or expired: move the vertex out of the clip volume
+        gl_Position = vec4(-2.0, -2.0, -2.0, 1.0);
+        vertexTextureCoordinates = vec2(0.0, 0.0);
+        vertexColor = vec4(0.0);
+        vertexAmbientLightIntensity = 0.0;
+        return;
+    }
+
+    // Ballistic trajectory
+    vec2 centerPosition =
+        inEphemeralParticle1.xy
+        + inEphemeralParticle1.zw * elapsed
+        + 0.5 * vec2(0.0, -%GRAVITY_MAGNITUDE%) * elapsed * elapsed;
+
+    float angle = inEphemeralParticle4.z * progress;
+
+    mat2 rotationMatrix = mat2(
+        cos(angle), -sin(angle),
+        sin(angle), cos(angle));
+
+    vec2 worldPosition =
+        centerPosition
+        + rotationMatrix * inEphemeralParticle2.xy;
+
+    vertexTextureCoordinates = inEphemeralParticle2.zw;
+    vertexColor = vec4(inEphemeralParticle3.xyz, inEphemeralParticle3.w * (1.0 - progress));
+    vertexAmbientLightIntensity =
+        (1.0 - inEphemeralParticle4.w)
+        + inEphemeralParticle4.w * paramAmbientLightIntensity;
+
+    gl_Position = paramOrthoMatrix * vec4(worldPosition.xy, -1.0, 1.0);
+}
+
+###FRAGMENT
+
+#version 120
+
+#define in varying
+
+// Inputs from previous shader
+in vec2 vertexTextureCoordinates;
+in vec4 vertexColor;
+in float vertexAmbientLightIntensity;
+
+// The texture
+uniform sampler2D paramGenericTexturesAtlasTexture;
+
+void main()
+{
+    vec4 color = vertexColor;
+
+    // Negative texture coordinates mean untextured
+    if (vertexTextureCoordinates.x >= 0.0)
+        color *= texture2D(paramGenericTexturesAtlasTexture, vertexTextureCoordinates);
+
+    gl_FragColor = vec4(
+        color.xyz * vertexAmbientLightIntensity,
+        color.w);
+}
@@ -6,9 +6,11 @@
 #define out varying
 
 // Inputs
-in vec4 inGenericTexture1; // centerPosition, vertexOffset
-in vec4 inGenericTexture2; // textureCoordinates, planeId, scale
-in vec3 inGenericTexture3; // angle, alpha, ambientLightSensitivity
+in vec2 inGenericTexture1; // quadCorner
+in vec4 inGenericTexture2; // centerPosition, planeId, scale
+in vec4 inGenericTexture3; // frameLeftX, frameBottomY, frameRightX, frameTopY
+in vec4 inGenericTexture4; // textureCoordinatesBottomLeft, textureCoordinatesTopRight
+in vec3 inGenericTexture5; // angle, alpha, ambientLightSensitivity
 
 // Outputs
 out vec2 vertexTextureCoordinates;
@@ -21,22 +23,24 @@ uniform mat4 paramOrthoMatrix;
 
 void main()
 {
-    vertexTextureCoordinates = inGenericTexture2.xy; 
-    vertexAlpha = inGenericTexture3.y;
+    vertexTextureCoordinates = mix(inGenericTexture4.xy, inGenericTexture4.zw, inGenericTexture1);
+    vertexAlpha = inGenericTexture5.y;
     vertexAmbientLightIntensity = 
-        (1.0 - inGenericTexture3.z)
-	    + inGenericTexture3.z * paramAmbientLightIntensity;
+        (1.0 - inGenericTexture5.z)
+	    + inGenericTexture5.z * paramAmbientLightIntensity;
 
     float scale = inGenericTexture2.w;
-    float angle = inGenericTexture3.x;
+    float angle = inGenericTexture5.x;
 
     mat2 rotationMatrix = mat2(
         cos(angle), -sin(angle),
         sin(angle), cos(angle));
 
+    vec2 vertexOffset = mix(inGenericTexture3.xy, inGenericTexture3.zw, inGenericTexture1);
+
     vec2 worldPosition = 
-        inGenericTexture1.xy 
-        + rotationMatrix * inGenericTexture1.zw * scale;
+        inGenericTexture2.xy 
+        + rotationMatrix * vertexOffset * scale;
 
     gl_Position = paramOrthoMatrix * vec4(worldPosition.xy, inGenericTexture2.z, 1.0);
 }
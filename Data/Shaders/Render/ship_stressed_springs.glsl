@@ -6,8 +6,8 @@
 #define out varying
 
 // Inputs
-in vec4 inShipPointAttributeGroup1; // Position, TextureCoordinates
-in vec4 inShipPointAttributeGroup2; // Light, Water, PlaneId, Decay
+in vec2 inShipPointAttributeGroup1; // Position
+in vec4 inShipPointAttributeGroup3; // TextureCoordinates, PlaneId, Decay
 
 // Outputs        
 out vec2 vertexTextureCoords;
@@ -18,7 +18,7 @@ uniform mat4 paramOrthoMatrix;
 void main()
 {
     vertexTextureCoords = inShipPointAttributeGroup1.xy; 
-    gl_Position = paramOrthoMatrix * vec4(inShipPointAttributeGroup1.xy, inShipPointAttributeGroup2.z, 1.0);
+    gl_Position = paramOrthoMatrix * vec4(inShipPointAttributeGroup1.xy, inShipPointAttributeGroup3.z, 1.0);
 }
 
 ###FRAGMENT
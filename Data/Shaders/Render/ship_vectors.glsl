@@ -6,14 +6,27 @@
 #define out varying
 
 // Inputs
-in vec3 inVectorArrow; // Position
+in vec3 inVectorArrow1; // StemFraction, HeadOffsetAlong, HeadOffsetAcross
+in vec2 inVectorArrow2; // Position (per-instance)
+in float inVectorArrow3; // PlaneId (per-instance)
+in vec2 inVectorArrow4; // Vector (per-instance)
 
 // Params
 uniform mat4 paramOrthoMatrix;
+uniform float paramVectorLengthAdjustment;
 
 void main()
 {
-    gl_Position = paramOrthoMatrix * vec4(inVectorArrow.xyz, 1.0);
+    float vectorLength = length(inVectorArrow4);
+    vec2 vectorDirection = vectorLength > 0.0 ? inVectorArrow4 / vectorLength : vec2(0.0);
+
+    vec2 worldPosition = 
+        inVectorArrow2
+        + inVectorArrow4 * paramVectorLengthAdjustment * inVectorArrow1.x
+        + vectorDirection * inVectorArrow1.y
+        + vec2(-vectorDirection.y, vectorDirection.x) * inVectorArrow1.z;
+
+    gl_Position = paramOrthoMatrix * vec4(worldPosition.xy, inVectorArrow3, 1.0);
 }
 
 ###FRAGMENT
@@ -21,6 +21,9 @@ EventTickerPanel::EventTickerPanel(wxWindow* parent)
     , mCurrentTickerText(TickerTextSize, ' ')
     , mFutureTickerText()
     , mCurrentCharStep(TickerFontSize)
+    , mCurrentNonBlankCharCount(0)
+    , mIsDirty(true)
+    , mLastRefreshTimestamp()
 {
     SetMinSize(wxSize(-1, 1 + TickerFontSize + 1));
     SetMaxSize(wxSize(-1, 1 + TickerFontSize + 1));
@@ -46,6 +49,8 @@ EventTickerPanel::~EventTickerPanel()
 
 void EventTickerPanel::Update()
 {
+    bool const wasBlank = (0 == mCurrentNonBlankCharCount);
+
     mCurrentCharStep += TickerCharStep;
     if (mCurrentCharStep >= TickerFontSize)
     {
@@ -53,11 +58,20 @@ void EventTickerPanel::Update()
 
         // Pop first char
         assert(TickerTextSize == mCurrentTickerText.size());
+        if (mCurrentTickerText.front() != ' ')
+        {
+            assert(mCurrentNonBlankCharCount > 0);
+            --mCurrentNonBlankCharCount;
+        }
+
         mCurrentTickerText.erase(mCurrentTickerText.begin());
 
         // Add last char
         if (!mFutureTickerText.empty())
         {
+            if (mFutureTickerText.front() != ' ')
+                ++mCurrentNonBlankCharCount;
+
             mCurrentTickerText.push_back(mFutureTickerText.front());
             mFutureTickerText.erase(mFutureTickerText.begin());
         }
@@ -67,10 +81,24 @@ void EventTickerPanel::Update()
         }
     }
 
-    // Rendering costs ~2%, hence let's do it only when needed!
-    if (this->IsShown())
+    // Scrolling blanks doesn't change anything
+    if (!wasBlank || 0 != mCurrentNonBlankCharCount)
     {
-        Refresh();
+        mIsDirty = true;
+    }
+
+    // Rendering costs ~2%, hence let's do it only when needed, and not more
+    // often than we can notice
+    if (mIsDirty && this->IsShown())
+    {
+        auto const now = std::chrono::steady_clock::now();
+        if (now - mLastRefreshTimestamp >= MinRefreshInterval)
+        {
+            Refresh();
+
+            mIsDirty = false;
+            mLastRefreshTimestamp = now;
+        }
     }
 }
 
@@ -80,6 +108,8 @@ void EventTickerPanel::OnGameReset()
 {
     mCurrentTickerText = std::string(TickerTextSize, ' ');
     mFutureTickerText.clear();
+    mCurrentNonBlankCharCount = 0;
+    mIsDirty = true;
 }
 
 void EventTickerPanel::OnShipLoaded(
@@ -9,6 +9,7 @@
 
 #include <wx/wx.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -109,4 +110,15 @@ private:
 
     // The fraction of a character we're currently scrolled by
     unsigned int mCurrentCharStep;
+
+    // The number of non-blank characters in the current text; when zero,
+    // scrolling doesn't change what's shown
+    size_t mCurrentNonBlankCharCount;
+
+    // Whether what's shown has changed since the last refresh
+    bool mIsDirty;
+
+    // We scroll at every update, but repaint at most at this rate
+    static constexpr std::chrono::milliseconds MinRefreshInterval = std::chrono::milliseconds(66); // ~15Hz
+    std::chrono::steady_clock::time_point mLastRefreshTimestamp;
 };
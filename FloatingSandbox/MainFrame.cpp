@@ -5,35 +5,50 @@
  ***************************************************************************************/
 #include "MainFrame.h"
 
+#include "OpenGLContext.h"
 #include "ShipDescriptionDialog.h"
 #include "SplashScreenDialog.h"
+#include "StandardSystemPaths.h"
 #include "StartupTipDialog.h"
 #include "Version.h"
 
 #include <Game/ImageFileTools.h>
+#include <Game/ShipDefinition.h>
+#include <Game/ShipLibraryIndex.h>
+#include <Game/ShipPreviewDirectoryCache.h>
+
+#include <GPUCalc/GPUCalculatorFactory.h>
 
 #include <GameOpenGL/GameOpenGL.h>
 
 #include <GameCore/GameException.h>
 #include <GameCore/Log.h>
+#include <GameCore/TaskThreadPool.h>
 #include <GameCore/Utils.h>
 
+#include <wx/display.h>
 #include <wx/intl.h>
 #include <wx/msgdlg.h>
 #include <wx/panel.h>
+#include <wx/progdlg.h>
 #include <wx/settings.h>
 #include <wx/sizer.h>
 #include <wx/string.h>
 #include <wx/tooltip.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <ctime>
+#include <future>
 #include <iomanip>
 #include <map>
 #include <sstream>
 #include <thread>
 
+// The name of the shared memory that the telemetry is exported into
+static std::string const TelemetrySharedMemoryName = "FloatingSandboxTelemetry";
+
 const long ID_MAIN_CANVAS = wxNewId();
 
 const long ID_LOAD_SHIP_MENUITEM = wxNewId();
@@ -74,6 +89,13 @@ const long ID_SHOW_EVENT_TICKER_MENUITEM = wxNewId();
 const long ID_SHOW_PROBE_PANEL_MENUITEM = wxNewId();
 const long ID_SHOW_STATUS_TEXT_MENUITEM = wxNewId();
 const long ID_SHOW_EXTENDED_STATUS_TEXT_MENUITEM = wxNewId();
+const long ID_RUN_SIMULATION_THREAD_MENUITEM = wxNewId();
+const long ID_RUN_RENDER_THREAD_MENUITEM = wxNewId();
+const long ID_EXPORT_TELEMETRY_MENUITEM = wxNewId();
+const long ID_AUTOTUNE_MENUITEM = wxNewId();
+const long ID_ZERO_FRAMES_IN_FLIGHT_MENUITEM = wxNewId();
+const long ID_ONE_FRAME_IN_FLIGHT_MENUITEM = wxNewId();
+const long ID_TWO_FRAMES_IN_FLIGHT_MENUITEM = wxNewId();
 const long ID_FULL_SCREEN_MENUITEM = wxNewId();
 const long ID_NORMAL_SCREEN_MENUITEM = wxNewId();
 const long ID_MUTE_MENUITEM = wxNewId();
@@ -99,6 +121,8 @@ MainFrame::MainFrame(wxApp * mainApp)
     , mCurrentRCBombCount(0u)
     , mCurrentAntiMatterBombCount(0u)
     , mIsShiftKeyDown(false)
+    , mDisplayFramePeriod(std::chrono::milliseconds(16))
+    , mLastUserInteractionTimestamp(std::chrono::steady_clock::now())
 {
     Create(
         nullptr,
@@ -184,12 +208,25 @@ MainFrame::MainFrame(wxApp * mainApp)
     try
     {
         GameOpenGL::InitOpenGL();
+
+        GameOpenGL::SetProgramBinaryCacheFolderPath(
+            StandardSystemPaths::GetInstance().GetUserSettingsGameFolderPath() / "ShaderCache");
     }
     catch (std::exception const & e)
     {
         throw std::runtime_error("Error during OpenGL initialization: " + std::string(e.what()));
     }
 
+    // The GPU calculators get their own context on the main canvas, sharing its objects
+    // with the main context so that ships may be rendered straight from their results
+    GPUCalculatorFactory::GetInstance().Initialize(
+        [this]() -> std::unique_ptr<IOpenGLContext>
+        {
+            assert(!!mMainGLCanvas && !!mMainGLCanvasContext);
+            return std::make_unique<OpenGLContext>(*mMainGLCanvas, *mMainGLCanvasContext);
+        },
+        ResourceLoader::GetGPUCalcShadersRootPath());
+
 
     //
     // Build menu
@@ -384,6 +421,43 @@ MainFrame::MainFrame(wxApp * mainApp)
     mShowExtendedStatusTextMenuItem->Check(StartWithExtendedStatusText);
     Connect(ID_SHOW_EXTENDED_STATUS_TEXT_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnShowExtendedStatusTextMenuItemSelected);
 
+    mRunSimulationThreadMenuItem = new wxMenuItem(optionsMenu, ID_RUN_SIMULATION_THREAD_MENUITEM, _("Run Simulation on Separate Thread"), wxEmptyString, wxITEM_CHECK);
+    optionsMenu->Append(mRunSimulationThreadMenuItem);
+    mRunSimulationThreadMenuItem->Check(false);
+    Connect(ID_RUN_SIMULATION_THREAD_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnRunSimulationThreadMenuItemSelected);
+
+    mRunRenderThreadMenuItem = new wxMenuItem(optionsMenu, ID_RUN_RENDER_THREAD_MENUITEM, _("Run Rendering on Separate Thread"), wxEmptyString, wxITEM_CHECK);
+    optionsMenu->Append(mRunRenderThreadMenuItem);
+    mRunRenderThreadMenuItem->Check(false);
+    Connect(ID_RUN_RENDER_THREAD_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnRunRenderThreadMenuItemSelected);
+
+    wxMenu * framesInFlightMenu = new wxMenu();
+
+    wxMenuItem * zeroFramesInFlightMenuItem = new wxMenuItem(framesInFlightMenu, ID_ZERO_FRAMES_IN_FLIGHT_MENUITEM, _("None (Lowest Latency)"), wxEmptyString, wxITEM_RADIO);
+    framesInFlightMenu->Append(zeroFramesInFlightMenuItem);
+    Connect(ID_ZERO_FRAMES_IN_FLIGHT_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnFramesInFlightMenuItemSelected);
+
+    wxMenuItem * oneFrameInFlightMenuItem = new wxMenuItem(framesInFlightMenu, ID_ONE_FRAME_IN_FLIGHT_MENUITEM, _("One"), wxEmptyString, wxITEM_RADIO);
+    framesInFlightMenu->Append(oneFrameInFlightMenuItem);
+    Connect(ID_ONE_FRAME_IN_FLIGHT_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnFramesInFlightMenuItemSelected);
+
+    wxMenuItem * twoFramesInFlightMenuItem = new wxMenuItem(framesInFlightMenu, ID_TWO_FRAMES_IN_FLIGHT_MENUITEM, _("Two (Highest Throughput)"), wxEmptyString, wxITEM_RADIO);
+    framesInFlightMenu->Append(twoFramesInFlightMenuItem);
+    Connect(ID_TWO_FRAMES_IN_FLIGHT_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnFramesInFlightMenuItemSelected);
+
+    oneFrameInFlightMenuItem->Check(true);
+
+    optionsMenu->AppendSubMenu(framesInFlightMenu, _("Frames in Flight"));
+
+    mExportTelemetryMenuItem = new wxMenuItem(optionsMenu, ID_EXPORT_TELEMETRY_MENUITEM, _("Export Telemetry"), wxEmptyString, wxITEM_CHECK);
+    optionsMenu->Append(mExportTelemetryMenuItem);
+    mExportTelemetryMenuItem->Check(false);
+    Connect(ID_EXPORT_TELEMETRY_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnExportTelemetryMenuItemSelected);
+
+    wxMenuItem * autotuneMenuItem = new wxMenuItem(optionsMenu, ID_AUTOTUNE_MENUITEM, _("Autotune Performance..."), wxEmptyString, wxITEM_NORMAL);
+    optionsMenu->Append(autotuneMenuItem);
+    Connect(ID_AUTOTUNE_MENUITEM, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&MainFrame::OnAutotuneMenuItemSelected);
+
     optionsMenu->Append(new wxMenuItem(optionsMenu, wxID_SEPARATOR));
 
     mFullScreenMenuItem = new wxMenuItem(optionsMenu, ID_FULL_SCREEN_MENUITEM, _("Full Screen\tF11"), wxEmptyString, wxITEM_NORMAL);
@@ -520,6 +594,25 @@ void MainFrame::OnPostInitializeTrigger(wxTimerEvent & /*event*/)
     // Create Game controller
     //
 
+    ShipDefinition::SetCookedShipCacheFolderPath(
+        StandardSystemPaths::GetInstance().GetUserSettingsGameFolderPath() / "ShipCache");
+
+    ShipPreviewDirectoryCache::SetCacheFolderPath(
+        StandardSystemPaths::GetInstance().GetUserSettingsGameFolderPath() / "PreviewCache");
+
+    ShipLibraryIndex::SetIndexFilePath(
+        StandardSystemPaths::GetInstance().GetUserSettingsGameFolderPath() / "PreviewCache" / "Library.bin");
+
+    // Load the definition of the initial ship - which only needs the cooked ship cache -
+    // while we create the controllers; we add it to the world once these are ready
+    auto const defaultShipFilePath = mResourceLoader->GetDefaultShipDefinitionFilePath();
+    std::future<ShipDefinition> defaultShipDefinition = std::async(
+        std::launch::async,
+        [defaultShipFilePath]()
+        {
+            return ShipDefinition::Load(defaultShipFilePath);
+        });
+
     try
     {
         mGameController = GameController::Create(
@@ -528,6 +621,10 @@ void MainFrame::OnPostInitializeTrigger(wxTimerEvent & /*event*/)
             [this]()
             {
                 assert(!!mMainGLCanvas);
+
+                // The GPU calculators may have taken over during the simulation step
+                mMainGLCanvasContext->SetCurrent(*mMainGLCanvas);
+
                 mMainGLCanvas->SwapBuffers();
             },
             mResourceLoader,
@@ -582,6 +679,19 @@ void MainFrame::OnPostInitializeTrigger(wxTimerEvent & /*event*/)
 
     mUIPreferences = std::make_shared<UIPreferences>();
 
+    // Apply the settings found for this machine, if we've looked for them already
+    auto const autotuneConfiguration = mUIPreferences->GetAutotuneConfiguration();
+    if (!!autotuneConfiguration)
+        ApplyAutotuneConfiguration(*autotuneConfiguration);
+    else
+        TaskThreadPool::GetInstance().SetParallelism(mUIPreferences->GetSimulationThreadCount());
+
+    if (mUIPreferences->GetExportTelemetry())
+    {
+        mExportTelemetryMenuItem->Check(true);
+        StartTelemetry();
+    }
+
 
     //
     // Create Tool controller
@@ -624,11 +734,11 @@ void MainFrame::OnPostInitializeTrigger(wxTimerEvent & /*event*/)
     // Load initial ship
     //
 
-    auto defaultShipFilePath = mResourceLoader->GetDefaultShipDefinitionFilePath();
-
     try
     {
-        mGameController->AddShip(defaultShipFilePath);
+        mGameController->AddShip(
+            defaultShipDefinition.get(),
+            defaultShipFilePath);
     }
     catch (std::exception const & e)
     {
@@ -677,6 +787,15 @@ void MainFrame::OnPostInitializeTrigger(wxTimerEvent & /*event*/)
 
 void MainFrame::OnPostInitializeTrigger2(wxTimerEvent & /*event*/)
 {
+    //
+    // Find the best settings for this machine, the first time we run on it
+    //
+
+    if (!mUIPreferences->GetAutotuneConfiguration())
+    {
+        RunAutotune();
+    }
+
     //
     // Show startup tip
     //
@@ -729,6 +848,8 @@ void MainFrame::OnPaint(wxPaintEvent & event)
 
 void MainFrame::OnKeyDown(wxKeyEvent & event)
 {
+    OnUserInteraction();
+
     if (event.GetKeyCode() == WXK_LEFT)
     {
         // Left
@@ -774,9 +895,7 @@ void MainFrame::OnKeyDown(wxKeyEvent & event)
 
 void MainFrame::OnGameTimerTrigger(wxTimerEvent & /*event*/)
 {
-    // Note: on my laptop I can't get beyond 64 frames per second, hence I'm not
-    // setting a delay here
-    mGameTimer->Start(0, true);
+    auto const frameStartTimestamp = std::chrono::steady_clock::now();
 
     // Update SHIFT key state
     if (wxGetKeyState(WXK_SHIFT))
@@ -827,6 +946,11 @@ void MainFrame::OnGameTimerTrigger(wxTimerEvent & /*event*/)
 
         return;
     }
+
+    // Re-arm for the next frame
+    mGameTimer->Start(
+        CalculateGameTimerDelay(std::chrono::steady_clock::now() - frameStartTimestamp),
+        true);
 }
 
 void MainFrame::OnLowFrequencyTimerTrigger(wxTimerEvent & /*event*/)
@@ -859,28 +983,36 @@ void MainFrame::OnShipFileChosen(fsShipFileChosenEvent & event)
 
     ResetState();
 
-    assert(!!mGameController);
-    try
-    {
-        auto shipMetadata = mGameController->ResetAndLoadShip(event.GetShipFilepath());
+    //
+    // The ship is loaded in the background, while the current one keeps going,
+    // and it takes over at the end of the load
+    //
 
-        // Open description, if a description exists and the user allows
-        if (!!shipMetadata.Description
-            && mUIPreferences->GetShowShipDescriptionsAtShipLoad())
+    assert(!!mGameController);
+    mGameController->ResetAndLoadShipAsync(
+        event.GetShipFilepath(),
+        ProgressCallback(),
+        [this](std::optional<ShipMetadata> const & shipMetadata, std::string const & errorMessage)
         {
-            ShipDescriptionDialog shipDescriptionDialog(
-                this,
-                shipMetadata,
-                true,
-                mUIPreferences);
+            if (!shipMetadata)
+            {
+                OnError(errorMessage, false);
+                return;
+            }
 
-            shipDescriptionDialog.ShowModal();
-        }
-    }
-    catch (std::exception const & ex)
-    {
-        OnError(ex.what(), false);
-    }
+            // Open description, if a description exists and the user allows
+            if (!!shipMetadata->Description
+                && mUIPreferences->GetShowShipDescriptionsAtShipLoad())
+            {
+                ShipDescriptionDialog shipDescriptionDialog(
+                    this,
+                    *shipMetadata,
+                    true,
+                    mUIPreferences);
+
+                shipDescriptionDialog.ShowModal();
+            }
+        });
 }
 
 //
@@ -899,6 +1031,8 @@ void MainFrame::OnMainGLCanvasResize(wxSizeEvent & event)
 
 void MainFrame::OnMainGLCanvasLeftDown(wxMouseEvent & /*event*/)
 {
+    OnUserInteraction();
+
     assert(!!mToolController);
     mToolController->OnLeftMouseDown();
 
@@ -917,6 +1051,8 @@ void MainFrame::OnMainGLCanvasLeftUp(wxMouseEvent & /*event*/)
 
 void MainFrame::OnMainGLCanvasRightDown(wxMouseEvent & /*event*/)
 {
+    OnUserInteraction();
+
     assert(!!mToolController);
     mToolController->OnRightMouseDown();
 
@@ -935,12 +1071,16 @@ void MainFrame::OnMainGLCanvasRightUp(wxMouseEvent & /*event*/)
 
 void MainFrame::OnMainGLCanvasMouseMove(wxMouseEvent& event)
 {
+    OnUserInteraction();
+
     assert(!!mToolController);
     mToolController->OnMouseMove(event.GetX(), event.GetY());
 }
 
 void MainFrame::OnMainGLCanvasMouseWheel(wxMouseEvent& event)
 {
+    OnUserInteraction();
+
     assert(!!mGameController);
 
     mGameController->AdjustZoom(powf(1.002f, event.GetWheelRotation()));
@@ -1333,6 +1473,82 @@ void MainFrame::OnShowExtendedStatusTextMenuItemSelected(wxCommandEvent & /*even
     mGameController->SetExtendedStatusTextEnabled(mShowExtendedStatusTextMenuItem->IsChecked());
 }
 
+void MainFrame::OnRunSimulationThreadMenuItemSelected(wxCommandEvent & /*event*/)
+{
+    assert(!!mGameController);
+
+    if (mRunSimulationThreadMenuItem->IsChecked())
+        mGameController->StartSimulationThread();
+    else
+        mGameController->StopSimulationThread();
+}
+
+void MainFrame::OnRunRenderThreadMenuItemSelected(wxCommandEvent & /*event*/)
+{
+    assert(!!mGameController);
+
+    if (mRunRenderThreadMenuItem->IsChecked())
+    {
+        mGameController->StartRenderThread(
+            [this]()
+            {
+                assert(!!mMainGLCanvas);
+
+                mMainGLCanvasContext->SetCurrent(*mMainGLCanvas);
+            },
+            []()
+            {
+                // wxWidgets has no way of releasing a context
+#ifdef _WIN32
+                wglMakeCurrent(NULL, NULL);
+#else
+                glXMakeCurrent(glXGetCurrentDisplay(), None, NULL);
+#endif
+            });
+    }
+    else
+    {
+        mGameController->StopRenderThread();
+    }
+}
+
+void MainFrame::OnExportTelemetryMenuItemSelected(wxCommandEvent & /*event*/)
+{
+    assert(!!mGameController);
+    assert(!!mUIPreferences);
+
+    mUIPreferences->SetExportTelemetry(mExportTelemetryMenuItem->IsChecked());
+
+    if (mExportTelemetryMenuItem->IsChecked())
+        StartTelemetry();
+    else
+        mGameController->StopTelemetry();
+}
+
+void MainFrame::OnAutotuneMenuItemSelected(wxCommandEvent & /*event*/)
+{
+    assert(!!mGameController);
+
+    mGameTimer->Stop();
+    mLowFrequencyTimer->Stop();
+
+    RunAutotune();
+
+    StartTimers();
+}
+
+void MainFrame::OnFramesInFlightMenuItemSelected(wxCommandEvent & event)
+{
+    assert(!!mGameController);
+
+    if (event.GetId() == ID_ZERO_FRAMES_IN_FLIGHT_MENUITEM)
+        mGameController->SetMaxFramesInFlight(0);
+    else if (event.GetId() == ID_ONE_FRAME_IN_FLIGHT_MENUITEM)
+        mGameController->SetMaxFramesInFlight(1);
+    else
+        mGameController->SetMaxFramesInFlight(2);
+}
+
 void MainFrame::OnFullScreenMenuItemSelected(wxCommandEvent & /*event*/)
 {
     mFullScreenMenuItem->Enable(false);
@@ -1461,8 +1677,159 @@ void MainFrame::OnError(
     }
 }
 
+void MainFrame::StartTelemetry()
+{
+    assert(!!mGameController);
+
+    try
+    {
+        mGameController->StartTelemetry(TelemetrySharedMemoryName);
+    }
+    catch (std::exception const & e)
+    {
+        mExportTelemetryMenuItem->Check(false);
+
+        wxMessageBox("Cannot export telemetry: " + std::string(e.what()), wxT("Error"), wxICON_ERROR);
+    }
+}
+
+void MainFrame::RunAutotune()
+{
+    assert(!!mGameController);
+    assert(!!mUIPreferences);
+
+    std::optional<AutotuneResult> result;
+
+    {
+        wxProgressDialog progressDialog(
+            _("Autotune"),
+            _("Finding the best settings for this computer..."),
+            1000,
+            this,
+            wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME);
+
+        try
+        {
+            result.emplace(mGameController->RunAutotune(
+                [&progressDialog, this](float progress, std::string const & message)
+                {
+                    progressDialog.Update(static_cast<int>(std::min(progress, 1.0f) * 999.0f), message);
+                    this->mMainApp->Yield();
+                }));
+        }
+        catch (std::exception const & e)
+        {
+            wxMessageBox("Cannot autotune: " + std::string(e.what()), wxT("Error"), wxICON_ERROR);
+            return;
+        }
+    }
+
+    assert(!!result);
+
+    ApplyAutotuneConfiguration(result->Configuration);
+    mUIPreferences->SetAutotuneConfiguration(result->Configuration);
+
+    //
+    // Tell the user what we've found
+    //
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(0);
+
+    ss << "Settings: " << result->Configuration.ToString() << "." << std::endl
+        << "The default ship runs at " << result->StepsPerSecond << " steps per second";
+
+    if (!result->IsRealTime)
+    {
+        ss << ", which is not enough to run in real time; ships will move in slow motion.";
+    }
+    else
+    {
+        ss << ".";
+    }
+
+    if (!!result->TargetShip)
+    {
+        ss << std::endl << std::endl
+            << "\"" << result->TargetShip->ShipName << "\" runs at " << result->TargetShip->StepsPerSecond << " steps per second";
+
+        if (!result->TargetShip->IsRealTime)
+        {
+            ss << ", which is not enough to run in real time; consider a smaller ship.";
+        }
+        else
+        {
+            ss << ".";
+        }
+    }
+
+    wxMessageBox(
+        ss.str(),
+        wxT("Autotune"),
+        (!result->IsRealTime || (!!result->TargetShip && !result->TargetShip->IsRealTime)) ? wxICON_WARNING : wxICON_INFORMATION);
+}
+
+void MainFrame::ApplyAutotuneConfiguration(AutotuneConfiguration const & configuration)
+{
+    assert(!!mGameController);
+
+    TaskThreadPool::GetInstance().SetParallelism(configuration.SimulationThreadCount);
+
+    mGameController->SetDoFusePointDynamics(configuration.DoFusePointDynamics);
+    mGameController->SetDoSolveSpringsAsConstraints(configuration.DoSolveSpringsAsConstraints);
+    mGameController->SetDoUseGPUMechanicalDynamics(configuration.DoUseGPUMechanicalDynamics);
+    mGameController->SetNumMechanicalDynamicsIterationsAdjustment(configuration.NumMechanicalDynamicsIterationsAdjustment);
+}
+
 void MainFrame::StartTimers()
 {
+    //
+    // Pace frames at the refresh rate of the display we're on
+    //
+
+    int displayIndex = wxDisplay::GetFromWindow(this);
+    if (displayIndex == wxNOT_FOUND)
+        displayIndex = 0;
+
+    int const refreshRate = wxDisplay(static_cast<unsigned int>(displayIndex)).GetCurrentMode().refresh;
+    mDisplayFramePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(1.0f / static_cast<float>(refreshRate > 0 ? refreshRate : 60)));
+
+    LogMessage("Pacing frames at ", refreshRate, "Hz");
+
+    // Idle-priority work fits in what's left of the frame
+    assert(!!mGameController);
+    mGameController->SetFramePeriod(mDisplayFramePeriod);
+
     mGameTimer->Start(0, true);
     mLowFrequencyTimer->Start(1000, false);
+}
+
+int MainFrame::CalculateGameTimerDelay(std::chrono::steady_clock::duration frameDuration) const
+{
+    //
+    // We sleep for what is left of the display's frame period, rather than spinning
+    // on the timer: when we're vsync-bound the buffer swap has already taken up the
+    // period, and otherwise there's no point in rendering frames that won't be shown.
+    //
+    // While paused - with nothing loading and the user idle for a while - we only need
+    // to keep the screen alive, hence we render a few frames per second.
+    //
+
+    static constexpr auto PausedFramePeriod = std::chrono::milliseconds(100);
+    static constexpr auto UserIdleTimeout = std::chrono::seconds(1);
+
+    auto framePeriod = mDisplayFramePeriod;
+
+    if (mPauseMenuItem->IsChecked()
+        && !mGameController->IsLoadingShip()
+        && std::chrono::steady_clock::now() - mLastUserInteractionTimestamp > UserIdleTimeout)
+    {
+        framePeriod = PausedFramePeriod;
+    }
+
+    if (frameDuration >= framePeriod)
+        return 0;
+
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(framePeriod - frameDuration).count());
 }
\ No newline at end of file
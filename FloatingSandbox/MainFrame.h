@@ -78,6 +78,9 @@ private:
     wxMenuItem * mShowProbePanelMenuItem;
     wxMenuItem * mShowStatusTextMenuItem;
     wxMenuItem * mShowExtendedStatusTextMenuItem;
+    wxMenuItem * mRunSimulationThreadMenuItem;
+    wxMenuItem * mRunRenderThreadMenuItem;
+    wxMenuItem * mExportTelemetryMenuItem;
     wxMenuItem * mFullScreenMenuItem;
     wxMenuItem * mNormalScreenMenuItem;
     wxMenuItem * mMuteMenuItem;
@@ -166,6 +169,11 @@ private:
     void OnShowProbePanelMenuItemSelected(wxCommandEvent& event);
     void OnShowStatusTextMenuItemSelected(wxCommandEvent& event);
     void OnShowExtendedStatusTextMenuItemSelected(wxCommandEvent& event);
+    void OnRunSimulationThreadMenuItemSelected(wxCommandEvent& event);
+    void OnRunRenderThreadMenuItemSelected(wxCommandEvent& event);
+    void OnFramesInFlightMenuItemSelected(wxCommandEvent& event);
+    void OnExportTelemetryMenuItemSelected(wxCommandEvent& event);
+    void OnAutotuneMenuItemSelected(wxCommandEvent& event);
     void OnFullScreenMenuItemSelected(wxCommandEvent& event);
     void OnNormalScreenMenuItemSelected(wxCommandEvent& event);
     void OnMuteMenuItemSelected(wxCommandEvent& event);
@@ -255,7 +263,17 @@ private:
     void OnError(
         std::string const & message,
         bool die);
+    void StartTelemetry();
     void StartTimers();
+    void RunAutotune();
+    void ApplyAutotuneConfiguration(AutotuneConfiguration const & configuration);
+
+    void OnUserInteraction()
+    {
+        mLastUserInteractionTimestamp = std::chrono::steady_clock::now();
+    }
+
+    int CalculateGameTimerDelay(std::chrono::steady_clock::duration frameDuration) const;
 
 private:
 
@@ -281,4 +299,8 @@ private:
     size_t mCurrentRCBombCount;
     size_t mCurrentAntiMatterBombCount;
     bool mIsShiftKeyDown;
+
+    // Frame pacing
+    std::chrono::steady_clock::duration mDisplayFramePeriod;
+    std::chrono::steady_clock::time_point mLastUserInteractionTimestamp;
 };
@@ -5,7 +5,15 @@
 ***************************************************************************************/
 #include "OpenGLContext.h"
 
+OpenGLContext::OpenGLContext(
+    wxGLCanvas & canvas,
+    wxGLContext const & shareContext)
+    : mCanvas(canvas)
+    , mGLContext(std::make_unique<wxGLContext>(&canvas, &shareContext))
+{
+}
+
 void OpenGLContext::Activate()
 {
-    // TODO
-}
\ No newline at end of file
+    mGLContext->SetCurrent(mCanvas);
+}
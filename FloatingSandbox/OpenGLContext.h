@@ -7,16 +7,32 @@
 
 #include <GPUCalc/IOpenGLContext.h>
 
+#include <wx/glcanvas.h>
+
+#include <memory>
+
 /*
  * Implementation of the IOpenGLContext interface for an OpenGL context
  * created with wxWidgets.
+ *
+ * The context is created on the main canvas, and shares its objects - buffers
+ * and textures - with the main canvas' context, so that the render context may
+ * use the results of the GPU calculators as they are.
  */
 class OpenGLContext : public IOpenGLContext
 {
 public:
 
+    OpenGLContext(
+        wxGLCanvas & canvas,
+        wxGLContext const & shareContext);
 
 public:
 
     void Activate() override;
-};
\ No newline at end of file
+
+private:
+
+    wxGLCanvas & mCanvas;
+    std::unique_ptr<wxGLContext> mGLContext;
+};
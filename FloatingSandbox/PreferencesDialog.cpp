@@ -5,6 +5,8 @@
  ***************************************************************************************/
 #include "PreferencesDialog.h"
 
+#include <GameCore/TaskThreadPool.h>
+
 #include <wx/gbsizer.h>
 #include <wx/stattext.h>
 
@@ -99,6 +101,16 @@ void PreferencesDialog::OnShowShipDescriptionAtShipLoadCheckBoxClicked(wxCommand
     mUIPreferences->SetShowShipDescriptionsAtShipLoad(mShowShipDescriptionAtShipLoadCheckBox->GetValue());
 }
 
+void PreferencesDialog::OnSimulationThreadCountSpinCtrlChanged(wxSpinEvent & /*event*/)
+{
+    assert(!!mUIPreferences);
+
+    size_t const simulationThreadCount = static_cast<size_t>(mSimulationThreadCountSpinCtrl->GetValue());
+    mUIPreferences->SetSimulationThreadCount(simulationThreadCount);
+
+    TaskThreadPool::GetInstance().SetParallelism(simulationThreadCount);
+}
+
 void PreferencesDialog::OnOkButton(wxCommandEvent & /*event*/)
 {
     // Close ourselves
@@ -178,6 +190,39 @@ void PreferencesDialog::PopulateMainPanel(wxPanel * panel)
         Border);
 
 
+    //
+    // Row 4
+    //
+
+    wxBoxSizer* simulationThreadCountSizer = new wxBoxSizer(wxHORIZONTAL);
+
+    wxStaticText * simulationThreadCountStaticText = new wxStaticText(panel, wxID_ANY, "Simulation threads (0 for one per core):", wxDefaultPosition, wxDefaultSize, 0);
+    simulationThreadCountSizer->Add(simulationThreadCountStaticText, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, Border);
+
+    mSimulationThreadCountSpinCtrl = new wxSpinCtrl(
+        panel,
+        wxID_ANY,
+        wxEmptyString,
+        wxDefaultPosition,
+        wxSize(75, -1),
+        wxSP_ARROW_KEYS | wxALIGN_CENTRE_HORIZONTAL,
+        0,
+        static_cast<int>(2 * TaskThreadPool::CalculateDefaultParallelism()),
+        0);
+    mSimulationThreadCountSpinCtrl->SetToolTip("Sets the number of threads that the simulation is spread across. Changes take effect immediately.");
+
+    mSimulationThreadCountSpinCtrl->Bind(wxEVT_SPINCTRL, &PreferencesDialog::OnSimulationThreadCountSpinCtrlChanged, this);
+
+    simulationThreadCountSizer->Add(mSimulationThreadCountSpinCtrl, 0, wxALIGN_CENTER_VERTICAL, 0);
+
+    gridSizer->Add(
+        simulationThreadCountSizer,
+        wxGBPosition(4, 0),
+        wxGBSpan(1, 4), // Take entire row
+        wxALL,
+        Border);
+
+
     // Finalize panel
 
     panel->SetSizerAndFit(gridSizer);
@@ -191,4 +236,6 @@ void PreferencesDialog::ReadSettings()
 
     mShowTipOnStartupCheckBox->SetValue(mUIPreferences->GetShowStartupTip());
     mShowShipDescriptionAtShipLoadCheckBox->SetValue(mUIPreferences->GetShowShipDescriptionsAtShipLoad());
+
+    mSimulationThreadCountSpinCtrl->SetValue(static_cast<int>(mUIPreferences->GetSimulationThreadCount()));
 }
\ No newline at end of file
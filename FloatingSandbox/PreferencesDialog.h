@@ -8,6 +8,7 @@
 #include "UIPreferences.h"
 
 #include <wx/filepicker.h>
+#include <wx/spinctrl.h>
 #include <wx/wx.h>
 
 #include <memory>
@@ -29,6 +30,7 @@ private:
     void OnScreenshotDirPickerChanged(wxCommandEvent & event);
     void OnShowTipOnStartupCheckBoxClicked(wxCommandEvent & event);
     void OnShowShipDescriptionAtShipLoadCheckBoxClicked(wxCommandEvent & event);
+    void OnSimulationThreadCountSpinCtrlChanged(wxSpinEvent & event);
 
     void OnOkButton(wxCommandEvent & event);
 
@@ -44,6 +46,7 @@ private:
     wxDirPickerCtrl * mScreenshotDirPickerCtrl;
     wxCheckBox * mShowTipOnStartupCheckBox;
     wxCheckBox * mShowShipDescriptionAtShipLoadCheckBox;
+    wxSpinCtrl * mSimulationThreadCountSpinCtrl;
 
     // Buttons
     wxButton * mOkButton;
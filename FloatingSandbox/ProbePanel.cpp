@@ -19,6 +19,7 @@ ProbePanel::ProbePanel(wxWindow* parent)
         wxDefaultPosition,
         wxDefaultSize,
         wxBORDER_SIMPLE | wxCLIP_CHILDREN)
+    , mLastRefreshTimestamp()
 {
     SetDoubleBuffered(true);
 
@@ -34,6 +35,11 @@ ProbePanel::ProbePanel(wxWindow* parent)
     mFrameRateProbe = AddScalarTimeSeriesProbe("Frame Rate", 200);
     mURRatioProbe = AddScalarTimeSeriesProbe("U/R Ratio", 200);
 
+    mUpdateTimeP99Probe = AddScalarTimeSeriesProbe("Update P99 (ms)", 200);
+    mRenderTimeP99Probe = AddScalarTimeSeriesProbe("Render P99 (ms)", 200);
+    mSwapTimeP99Probe = AddScalarTimeSeriesProbe("Swap P99 (ms)", 200);
+    mInputLatencyP99Probe = AddScalarTimeSeriesProbe("Input Latency P99 (ms)", 200);
+
     mWaterTakenProbe = AddScalarTimeSeriesProbe("Water Inflow", 120);
     mWaterSplashProbe = AddScalarTimeSeriesProbe("Water Splash", 200);
 
@@ -53,21 +59,32 @@ ProbePanel::~ProbePanel()
 void ProbePanel::Update()
 {
     //
-    // Update all probes
+    // Update all probes - each repainting only if it has got new samples -
+    // at a capped rate
     //
 
-    if (IsActive())
+    if (!IsActive())
+        return;
+
+    auto const now = std::chrono::steady_clock::now();
+    if (now - mLastRefreshTimestamp < MinRefreshInterval)
+        return;
+
+    mLastRefreshTimestamp = now;
+
+    mFrameRateProbe->Update();
+    mURRatioProbe->Update();
+    mUpdateTimeP99Probe->Update();
+    mRenderTimeP99Probe->Update();
+    mSwapTimeP99Probe->Update();
+    mInputLatencyP99Probe->Update();
+    mWaterTakenProbe->Update();
+    mWaterSplashProbe->Update();
+    mWindSpeedProbe->Update();
+
+    for (auto const & p : mCustomProbes)
     {
-        mFrameRateProbe->Update();
-        mURRatioProbe->Update();
-        mWaterTakenProbe->Update();
-        mWaterSplashProbe->Update();
-        mWindSpeedProbe->Update();
-
-        for (auto const & p : mCustomProbes)
-        {
-            p.second->Update();
-        }
+        p.second->Update();
     }
 }
 
@@ -96,6 +113,10 @@ void ProbePanel::OnGameReset()
 {
     mFrameRateProbe->Reset();
     mURRatioProbe->Reset();
+    mUpdateTimeP99Probe->Reset();
+    mRenderTimeP99Probe->Reset();
+    mSwapTimeP99Probe->Reset();
+    mInputLatencyP99Probe->Reset();
     mWaterTakenProbe->Reset();
     mWaterSplashProbe->Reset();
     mWindSpeedProbe->Reset();
@@ -151,4 +172,13 @@ void ProbePanel::OnUpdateToRenderRatioUpdated(
     float immediateURRatio)
 {
     mURRatioProbe->RegisterSample(immediateURRatio);
+}
+
+void ProbePanel::OnFrameTimeStatisticsUpdated(
+    FrameTimeStatistics const & frameTimeStatistics)
+{
+    mUpdateTimeP99Probe->RegisterSample(frameTimeStatistics.Update.P99);
+    mRenderTimeP99Probe->RegisterSample(frameTimeStatistics.Render.P99);
+    mSwapTimeP99Probe->RegisterSample(frameTimeStatistics.Swap.P99);
+    mInputLatencyP99Probe->RegisterSample(frameTimeStatistics.InputLatency.P99);
 }
\ No newline at end of file
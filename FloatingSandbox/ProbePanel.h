@@ -12,6 +12,7 @@
 #include <wx/sizer.h>
 #include <wx/wx.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -56,6 +57,9 @@ public:
     virtual void OnUpdateToRenderRatioUpdated(
         float immediateURRatio) override;
 
+    virtual void OnFrameTimeStatisticsUpdated(
+        FrameTimeStatistics const & frameTimeStatistics) override;
+
 private:
 
     bool IsActive() const
@@ -77,8 +81,16 @@ private:
 
     std::unique_ptr<ScalarTimeSeriesProbeControl> mFrameRateProbe;
     std::unique_ptr<ScalarTimeSeriesProbeControl> mURRatioProbe;
+    std::unique_ptr<ScalarTimeSeriesProbeControl> mUpdateTimeP99Probe;
+    std::unique_ptr<ScalarTimeSeriesProbeControl> mRenderTimeP99Probe;
+    std::unique_ptr<ScalarTimeSeriesProbeControl> mSwapTimeP99Probe;
+    std::unique_ptr<ScalarTimeSeriesProbeControl> mInputLatencyP99Probe;
     std::unique_ptr<ScalarTimeSeriesProbeControl> mWaterTakenProbe;
     std::unique_ptr<ScalarTimeSeriesProbeControl> mWaterSplashProbe;
     std::unique_ptr<ScalarTimeSeriesProbeControl> mWindSpeedProbe;
     std::unordered_map<std::string, std::unique_ptr<ScalarTimeSeriesProbeControl>> mCustomProbes;
+
+    // Probes collect samples at every event, but repaint at most at this rate
+    static constexpr std::chrono::milliseconds MinRefreshInterval = std::chrono::milliseconds(66); // ~15Hz
+    std::chrono::steady_clock::time_point mLastRefreshTimestamp;
 };
@@ -29,6 +29,7 @@ ScalarTimeSeriesProbeControl::ScalarTimeSeriesProbeControl(
     , mBufferedDCBitmap()
     , mTimeSeriesPen(wxColor("BLACK"), 2, wxPENSTYLE_SOLID)
     , mGridPen(wxColor(0xa0, 0xa0, 0xa0), 1, wxPENSTYLE_SOLID)
+    , mIsDirty(true)
 {
     SetMinSize(wxSize(width, Height));
     SetMaxSize(wxSize(width, Height));
@@ -59,11 +60,18 @@ void ScalarTimeSeriesProbeControl::RegisterSample(float value)
     mSamples.emplace(
         [](float) {},
         value);
+
+    mIsDirty = true;
 }
 
 void ScalarTimeSeriesProbeControl::Update()
 {
-    Refresh();
+    if (mIsDirty)
+    {
+        Refresh();
+
+        mIsDirty = false;
+    }
 }
 
 void ScalarTimeSeriesProbeControl::Reset()
@@ -74,6 +82,8 @@ void ScalarTimeSeriesProbeControl::Reset()
     mMinValue = std::numeric_limits<float>::max();
 
     mGridValueSize = 0.0f;
+
+    mIsDirty = true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
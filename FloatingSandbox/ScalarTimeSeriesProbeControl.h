@@ -23,6 +23,9 @@ public:
 
     void RegisterSample(float value);
 
+    /*
+     * Repaints the probe, if it has changed since the last update.
+     */
     void Update();
 
     void Reset();
@@ -50,4 +53,7 @@ private:
     float mGridValueSize;
 
     CircularList<float, 200> mSamples;
+
+    // Whether the samples have changed since the last repaint
+    bool mIsDirty;
 };
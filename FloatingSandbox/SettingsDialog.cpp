@@ -321,6 +321,12 @@ void SettingsDialog::OnSeeShipThroughOceanCheckBoxClick(wxCommandEvent & /*event
     mApplyButton->Enable(true);
 }
 
+void SettingsDialog::OnAdaptiveWorldResolutionCheckBoxClick(wxCommandEvent & /*event*/)
+{
+    // Remember we're dirty now
+    mApplyButton->Enable(true);
+}
+
 void SettingsDialog::OnTextureLandRenderModeRadioButtonClick(wxCommandEvent & /*event*/)
 {
     ReconciliateLandRenderModeSettings();
@@ -1457,6 +1463,70 @@ void SettingsDialog::PopulateRenderingPanel(wxPanel * panel)
             CellBorder);
     }
 
+    // Resolution
+    {
+        wxStaticBox * resolutionBox = new wxStaticBox(panel, wxID_ANY, _("Resolution"));
+
+        wxBoxSizer * resolutionBoxSizer1 = new wxBoxSizer(wxVERTICAL);
+        resolutionBoxSizer1->AddSpacer(StaticBoxTopMargin);
+
+        {
+            wxGridBagSizer * resolutionSizer = new wxGridBagSizer(0, 0);
+
+            // World Resolution
+            {
+                mWorldResolutionSlider = std::make_unique<SliderControl>(
+                    resolutionBox,
+                    SliderWidth,
+                    SliderHeight,
+                    "World Resolution",
+                    "Adjusts the resolution at which the world is drawn, relative to the screen's; lower resolutions are faster to draw on slower graphics cards. When adaptive, this is the highest resolution used.",
+                    mGameController->GetWorldRenderScale(),
+                    [this](float /*value*/)
+                    {
+                        // Remember we're dirty now
+                        this->mApplyButton->Enable(true);
+                    },
+                    std::make_unique<LinearSliderCore>(
+                        mGameController->GetMinWorldRenderScale(),
+                        mGameController->GetMaxWorldRenderScale()));
+
+                resolutionSizer->Add(
+                    mWorldResolutionSlider.get(),
+                    wxGBPosition(0, 0),
+                    wxGBSpan(1, 1),
+                    wxALL,
+                    CellBorder);
+            }
+
+            // Adaptive World Resolution
+            {
+                mAdaptiveWorldResolutionCheckBox = new wxCheckBox(resolutionBox, wxID_ANY,
+                    _("Adaptive"), wxDefaultPosition, wxDefaultSize);
+                mAdaptiveWorldResolutionCheckBox->SetToolTip("Lowers the resolution of the world automatically whenever the graphics card takes too long to draw it.");
+                mAdaptiveWorldResolutionCheckBox->Bind(wxEVT_COMMAND_CHECKBOX_CLICKED, &SettingsDialog::OnAdaptiveWorldResolutionCheckBoxClick, this);
+
+                resolutionSizer->Add(
+                    mAdaptiveWorldResolutionCheckBox,
+                    wxGBPosition(1, 0),
+                    wxGBSpan(1, 1),
+                    wxALL,
+                    CellBorder);
+            }
+
+            resolutionBoxSizer1->Add(resolutionSizer, 0, wxALL, StaticBoxInsetMargin);
+        }
+
+        resolutionBox->SetSizerAndFit(resolutionBoxSizer1);
+
+        gridSizer->Add(
+            resolutionBox,
+            wxGBPosition(1, 3),
+            wxGBSpan(1, 1),
+            wxALL,
+            CellBorder);
+    }
+
 
     // Finalize panel
 
@@ -1811,6 +1881,10 @@ void SettingsDialog::ReadSettings()
 
     mWaterContrastSlider->SetValue(mGameController->GetWaterContrast());
 
+    mWorldResolutionSlider->SetValue(mGameController->GetWorldRenderScale());
+
+    mAdaptiveWorldResolutionCheckBox->SetValue(mGameController->GetDoAdaptWorldRenderScale());
+
     // Sound
 
     mEffectsVolumeSlider->SetValue(mSoundController->GetMasterEffectsVolume());
@@ -2083,6 +2157,11 @@ void SettingsDialog::ApplySettings()
     mGameController->SetWaterContrast(
         mWaterContrastSlider->GetValue());
 
+    mGameController->SetWorldRenderScale(
+        mWorldResolutionSlider->GetValue());
+
+    mGameController->SetDoAdaptWorldRenderScale(mAdaptiveWorldResolutionCheckBox->IsChecked());
+
     // Sound
 
     mSoundController->SetMasterEffectsVolume(
@@ -49,6 +49,7 @@ private:
     void OnFlatOceanRenderModeRadioButtonClick(wxCommandEvent & event);
     void OnFlatOceanColorChanged(wxColourPickerEvent & event);
     void OnSeeShipThroughOceanCheckBoxClick(wxCommandEvent & event);
+    void OnAdaptiveWorldResolutionCheckBoxClick(wxCommandEvent & event);
 
     void OnTextureLandRenderModeRadioButtonClick(wxCommandEvent & event);
     void OnFlatLandRenderModeRadioButtonClick(wxCommandEvent & event);
@@ -133,6 +134,8 @@ private:
     wxRadioButton * mStructureShipRenderModeRadioButton;
     wxCheckBox* mShowStressCheckBox;
     std::unique_ptr<SliderControl> mWaterContrastSlider;
+    std::unique_ptr<SliderControl> mWorldResolutionSlider;
+    wxCheckBox * mAdaptiveWorldResolutionCheckBox;
 
     // Sound
     std::unique_ptr<SliderControl> mEffectsVolumeSlider;
@@ -12,6 +12,7 @@
 #include <wx/sizer.h>
 
 constexpr int MinDirCtrlWidth = 260;
+constexpr size_t MaxSearchResults = 500;
 
 ShipLoadDialog::ShipLoadDialog(
     wxWindow * parent,
@@ -19,6 +20,8 @@ ShipLoadDialog::ShipLoadDialog(
     ResourceLoader const & resourceLoader)
 	: mParent(parent)
     , mUIPreferences(std::move(uiPreferences))
+    , mShipLibraryIndex(ImageSize(ShipPreviewControl::ImageWidth, ShipPreviewControl::ImageHeight))
+    , mSearchResults()
 {
 	Create(
 		mParent,
@@ -83,6 +86,29 @@ ShipLoadDialog::ShipLoadDialog(
 
 
 
+    //
+    // Search results - only shown while searching
+    //
+
+    mSearchResultsListCtrl = new wxListCtrl(
+        this,
+        wxID_ANY,
+        wxDefaultPosition,
+        wxSize(-1, 160),
+        wxLC_REPORT | wxLC_SINGLE_SEL);
+
+    mSearchResultsListCtrl->AppendColumn("Name", wxLIST_FORMAT_LEFT, 220);
+    mSearchResultsListCtrl->AppendColumn("Author", wxLIST_FORMAT_LEFT, 140);
+    mSearchResultsListCtrl->AppendColumn("Size", wxLIST_FORMAT_RIGHT, 80);
+    mSearchResultsListCtrl->AppendColumn("Directory", wxLIST_FORMAT_LEFT, 300);
+    mSearchResultsListCtrl->Bind(wxEVT_LIST_ITEM_SELECTED, &ShipLoadDialog::OnSearchResultSelected, this);
+    mSearchResultsListCtrl->Bind(wxEVT_LIST_ITEM_ACTIVATED, &ShipLoadDialog::OnSearchResultActivated, this);
+    mSearchResultsListCtrl->Hide();
+
+    vSizer->Add(mSearchResultsListCtrl, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
+
+
+
     //
     // Recent directories combo and home button
     //
@@ -126,6 +152,19 @@ ShipLoadDialog::ShipLoadDialog(
 
     vSizer2->Add(hComboSizer, 0, wxEXPAND);
 
+    vSizer2->AddSpacer(6);
+
+    // Search
+
+    wxStaticText * searchLabel = new wxStaticText(this, wxID_ANY, "Search all recent directories:");
+    vSizer2->Add(searchLabel, 0, wxALIGN_LEFT);
+
+    mSearchCtrl = new wxSearchCtrl(this, wxID_ANY, wxEmptyString);
+    mSearchCtrl->ShowCancelButton(true);
+    mSearchCtrl->Bind(wxEVT_TEXT, &ShipLoadDialog::OnSearchTextChanged, this);
+    mSearchCtrl->Bind(wxEVT_SEARCHCTRL_CANCEL_BTN, &ShipLoadDialog::OnSearchTextChanged, this);
+    vSizer2->Add(mSearchCtrl, 0, wxEXPAND);
+
     hSizer2->Add(vSizer2, 1, 0);
 
     hSizer2->AddSpacer(10);
@@ -225,6 +264,14 @@ void ShipLoadDialog::Open()
 
         mShipPreviewPanel->OnOpen();
 
+        // Bring the library up to date with the recent directories, re-searching as it changes
+        mShipLibraryIndex.StartRefresh(
+            mUIPreferences->GetShipLoadDirectories(),
+            [this]()
+            {
+                CallAfter(&ShipLoadDialog::RunSearch);
+            });
+
         auto selectedPath = mDirCtrl->GetPath();
         if (!selectedPath.IsEmpty())
             mShipPreviewPanel->SetDirectory(std::filesystem::path(selectedPath.ToStdString()));
@@ -279,6 +326,36 @@ void ShipLoadDialog::OnHomeDirButtonClicked(wxCommandEvent & /*event*/)
     mDirCtrl->SetPath(mRecentDirectoriesComboBox->GetValue()); // Will send its own event
 }
 
+void ShipLoadDialog::OnSearchTextChanged(wxCommandEvent & event)
+{
+    if (event.GetEventType() == wxEVT_SEARCHCTRL_CANCEL_BTN)
+        mSearchCtrl->Clear(); // Will send its own event
+    else
+        RunSearch();
+}
+
+void ShipLoadDialog::OnSearchResultSelected(wxListEvent & event)
+{
+    auto const resultIndex = static_cast<size_t>(event.GetIndex());
+    assert(resultIndex < mSearchResults.size());
+
+    // Store selection; the index does not know about descriptions
+    mSelectedShipMetadata.reset();
+    mSelectedShipFilepath = mSearchResults[resultIndex].ShipFilepath;
+
+    // Enable buttons
+    mInfoButton->Enable(false);
+    mLoadButton->Enable(true);
+}
+
+void ShipLoadDialog::OnSearchResultActivated(wxListEvent & event)
+{
+    auto const resultIndex = static_cast<size_t>(event.GetIndex());
+    assert(resultIndex < mSearchResults.size());
+
+    OnShipFileChosen(mSearchResults[resultIndex].ShipFilepath);
+}
+
 void ShipLoadDialog::OnInfoButtonClicked(wxCommandEvent & /*event*/)
 {
     assert(!!mSelectedShipMetadata);
@@ -355,6 +432,8 @@ void ShipLoadDialog::OnShipFileChosen(std::filesystem::path shipFilepath)
 
 void ShipLoadDialog::Close()
 {
+    mShipLibraryIndex.StopRefresh();
+
     mShipPreviewPanel->OnClose();
 
     // We just hide ourselves, so we can re-show ourselves again
@@ -373,4 +452,54 @@ void ShipLoadDialog::RepopulateRecentDirectoriesComboBox()
             mRecentDirectoriesComboBox->Append(dir.string());
         }
     }
-}
\ No newline at end of file
+}
+
+void ShipLoadDialog::RunSearch()
+{
+    std::string const query = mSearchCtrl->GetValue().ToStdString();
+
+    bool const wasShown = mSearchResultsListCtrl->IsShown();
+    bool const isShown = (query.find_first_not_of(' ') != std::string::npos);
+
+    // Forget a selection we're about to lose
+    if (wasShown
+        && mSearchResultsListCtrl->GetSelectedItemCount() > 0)
+    {
+        mSelectedShipMetadata.reset();
+        mSelectedShipFilepath.reset();
+
+        mInfoButton->Enable(false);
+        mLoadButton->Enable(false);
+    }
+
+    mSearchResultsListCtrl->Freeze();
+
+    mSearchResultsListCtrl->DeleteAllItems();
+
+    if (isShown)
+    {
+        mSearchResults = mShipLibraryIndex.Search(query, MaxSearchResults);
+
+        for (size_t r = 0; r < mSearchResults.size(); ++r)
+        {
+            auto const & entry = mSearchResults[r];
+
+            long const item = mSearchResultsListCtrl->InsertItem(static_cast<long>(r), entry.ShipName);
+            mSearchResultsListCtrl->SetItem(item, 1, entry.Author.value_or(""));
+            mSearchResultsListCtrl->SetItem(item, 2, std::to_string(entry.StructureSize.Width) + " x " + std::to_string(entry.StructureSize.Height));
+            mSearchResultsListCtrl->SetItem(item, 3, entry.ShipFilepath.parent_path().string());
+        }
+    }
+    else
+    {
+        mSearchResults.clear();
+    }
+
+    mSearchResultsListCtrl->Thaw();
+
+    if (isShown != wasShown)
+    {
+        mSearchResultsListCtrl->Show(isShown);
+        Layout();
+    }
+}
@@ -9,15 +9,19 @@
 #include "UIPreferences.h"
 
 #include <Game/ResourceLoader.h>
+#include <Game/ShipLibraryIndex.h>
 
 #include <wx/combobox.h>
 #include <wx/dialog.h>
 #include <wx/dirctrl.h>
+#include <wx/listctrl.h>
+#include <wx/srchctrl.h>
 
 #include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 class ShipLoadDialog : public wxDialog
 {
@@ -39,6 +43,9 @@ private:
     void OnShipFileChosen(fsShipFileChosenEvent & event);
     void OnRecentDirectorySelected(wxCommandEvent & event);
     void OnHomeDirButtonClicked(wxCommandEvent & event);
+    void OnSearchTextChanged(wxCommandEvent & event);
+    void OnSearchResultSelected(wxListEvent & event);
+    void OnSearchResultActivated(wxListEvent & event);
     void OnInfoButtonClicked(wxCommandEvent & event);
     void OnLoadButton(wxCommandEvent & event);
     void OnCancelButton(wxCommandEvent & event);
@@ -51,6 +58,7 @@ private:
 
     void Close();
     void RepopulateRecentDirectoriesComboBox();
+    void RunSearch();
 
 private:
 
@@ -60,6 +68,8 @@ private:
     wxGenericDirCtrl * mDirCtrl;
     ShipPreviewPanel * mShipPreviewPanel;
     wxComboBox * mRecentDirectoriesComboBox;
+    wxSearchCtrl * mSearchCtrl;
+    wxListCtrl * mSearchResultsListCtrl;
     wxButton * mInfoButton;
     wxButton * mLoadButton;
 
@@ -67,4 +77,8 @@ private:
 
     std::optional<ShipMetadata> mSelectedShipMetadata;
     std::optional<std::filesystem::path> mSelectedShipFilepath;
+
+    // All the ships in the recent directories, refreshed while we're open
+    ShipLibraryIndex mShipLibraryIndex;
+    std::vector<ShipLibraryIndex::Entry> mSearchResults;
 };
@@ -6,10 +6,15 @@
 #include "ShipPreviewPanel.h"
 
 #include <Game/ImageFileTools.h>
-#include <Game/ShipDefinitionFile.h>
+#include <Game/ShipLibraryIndex.h>
+#include <Game/ShipPreviewDirectoryCache.h>
 
+#include <GameCore/FloatingPoint.h>
 #include <GameCore/GameException.h>
 #include <GameCore/Log.h>
+#include <GameCore/TraceLog.h>
+
+#include <algorithm>
 
 wxDEFINE_EVENT(fsEVT_DIR_SCANNED, fsDirScannedEvent);
 wxDEFINE_EVENT(fsEVT_DIR_SCAN_ERROR, fsDirScanErrorEvent);
@@ -37,6 +42,7 @@ ShipPreviewPanel::ShipPreviewPanel(
     , mCurrentlyCompletedDirectory()
     // Preview Thread
     , mPreviewThread()
+    , mVisiblePreviewStartIndex(0)
     , mPanelToThreadMessage()
     , mPanelToThreadMessageMutex()
     , mPanelToThreadMessageLock(mPanelToThreadMessageMutex, std::defer_lock)
@@ -159,6 +165,8 @@ void ShipPreviewPanel::OnResized(wxSizeEvent & event)
 
             Thaw();
         }
+
+        UpdateVisiblePreviewStartIndex();
     }
 
     event.Skip();
@@ -269,12 +277,18 @@ void ShipPreviewPanel::OnPreviewReady(fsPreviewReadyEvent & event)
 {
     assert(event.GetShipIndex() < mPreviewControls.size());
     mPreviewControls[event.GetShipIndex()]->SetPreviewContent(*(event.GetShipPreview()));
+
+    // Keep the workers focused on what the user is looking at
+    UpdateVisiblePreviewStartIndex();
 }
 
 void ShipPreviewPanel::OnPreviewError(fsPreviewErrorEvent & event)
 {
     assert(event.GetShipIndex() < mPreviewControls.size());
     mPreviewControls[event.GetShipIndex()]->SetPreviewContent(mErrorImage, event.GetErrorMessage(), "");
+
+    // Keep the workers focused on what the user is looking at
+    UpdateVisiblePreviewStartIndex();
 }
 
 void ShipPreviewPanel::OnDirPreviewComplete(fsDirPreviewCompleteEvent & event)
@@ -312,6 +326,27 @@ int ShipPreviewPanel::CalculateTileColumns()
     return nCols;
 }
 
+void ShipPreviewPanel::UpdateVisiblePreviewStartIndex()
+{
+    if (mPreviewControls.empty() || nullptr == mPreviewPanelSizer)
+        return;
+
+    int const rowHeight = mPreviewControls[0]->GetSize().GetHeight();
+    if (rowHeight <= 0)
+        return;
+
+    int xUnit, yUnit;
+    GetScrollPixelsPerUnit(&xUnit, &yUnit);
+
+    int viewStartX, viewStartY;
+    GetViewStart(&viewStartX, &viewStartY);
+
+    size_t const firstVisibleRow = static_cast<size_t>(std::max(viewStartY * yUnit, 0) / rowHeight);
+    size_t const firstVisibleIndex = firstVisibleRow * static_cast<size_t>(std::max(mPreviewPanelSizer->GetCols(), 1));
+
+    mVisiblePreviewStartIndex = std::min(firstVisibleIndex, mPreviewControls.size() - 1);
+}
+
 void ShipPreviewPanel::ShutdownPreviewThread()
 {
     mPanelToThreadMessageLock.lock();
@@ -331,6 +366,11 @@ void ShipPreviewPanel::RunPreviewThread()
 {
     LogMessage("PreviewThread::Enter");
 
+    TraceLog::GetInstance().SetCurrentThreadName("Ship Preview");
+
+    // Previews are built by the same code as ships are
+    InitializeSimulationThreadFloatingPoint();
+
     std::unique_lock<std::mutex> messageThreadLock(mPanelToThreadMessageMutex, std::defer_lock);
 
     while (true)
@@ -420,8 +460,7 @@ void ShipPreviewPanel::ScanDirectory(std::filesystem::path const & directoryPath
             auto const entryFilepath = entryIt.path();
             try
             {
-                if (std::filesystem::is_regular_file(entryFilepath)
-                    && (entryFilepath.extension().string() == ".png" || ShipDefinitionFile::IsShipDefinitionFile(entryFilepath)))
+                if (ShipLibraryIndex::IsShipFile(entryFilepath))
                 {
                     shipFilepaths.push_back(entryFilepath);
                 }
@@ -442,6 +481,9 @@ void ShipPreviewPanel::ScanDirectory(std::filesystem::path const & directoryPath
             return a.filename().string() < b.filename().string();
         });
 
+    // Start from the top
+    mVisiblePreviewStartIndex = 0;
+
     // Notify
     QueueEvent(
         new fsDirScannedEvent(
@@ -459,46 +501,132 @@ void ShipPreviewPanel::ScanDirectory(std::filesystem::path const & directoryPath
     //
     // Process all files and create previews
     //
+    // Previews are extracted by a bounded pool of workers (this thread included),
+    // each claiming the first unclaimed ship at or after the first visible one;
+    // on interruption, the workers stop claiming ships and the ones not claimed
+    // yet are simply abandoned
+    //
 
-    for (size_t iShip = 0; iShip < shipFilepaths.size(); ++iShip)
-    {
-        // Check whether we have been interrupted
-        if (!!mPanelToThreadMessage)
-            return;
+    ImageSize const maxPreviewSize(ShipPreviewControl::ImageWidth, ShipPreviewControl::ImageHeight);
 
-        try
+    // Previews of ships that haven't changed since our last visit come from here
+    auto previewCache = ShipPreviewDirectoryCache::Load(directoryPath, maxPreviewSize);
+
+    std::vector<bool> isShipClaimed(shipFilepaths.size(), false);
+    size_t unclaimedShipCount = shipFilepaths.size();
+    std::mutex claimMutex;
+
+    auto const previewWorker = [&]()
+    {
+        for (size_t iPreview = 0; ; ++iPreview)
         {
-            // Load preview
-            auto shipPreview = ShipPreview::Load(
-                shipFilepaths[iShip],
-                ImageSize(ShipPreviewControl::ImageWidth, ShipPreviewControl::ImageHeight));
-
-            // Fire event
-            QueueEvent(
-                new fsPreviewReadyEvent(
-                    fsEVT_PREVIEW_READY,
-                    this->GetId(),
-                    iShip,
-                    std::make_shared<ShipPreview>(std::move(shipPreview))));
-
-            if (isSingleCore && (3 == iShip % 4))
+            // Check whether we have been interrupted
+            if (!!mPanelToThreadMessage)
+                return;
+
+            //
+            // Claim next ship
+            //
+
+            size_t iShip;
+
             {
-                // Give the main thread time to process this
-                std::this_thread::yield();
+                std::lock_guard<std::mutex> lock(claimMutex);
+
+                if (unclaimedShipCount == 0)
+                    return;
+
+                size_t const startIndex = std::min(mVisiblePreviewStartIndex.load(), shipFilepaths.size() - 1);
+
+                iShip = startIndex;
+                while (isShipClaimed[iShip])
+                {
+                    iShip = (iShip + 1) % shipFilepaths.size();
+                }
+
+                isShipClaimed[iShip] = true;
+                --unclaimedShipCount;
+            }
+
+            try
+            {
+                TRACE_SCOPE("LoadShipPreview", "preview");
+
+                // Load preview
+                auto shipPreview = previewCache.TryGet(shipFilepaths[iShip]);
+                if (!shipPreview)
+                {
+                    shipPreview.emplace(
+                        ShipPreview::Load(
+                            shipFilepaths[iShip],
+                            maxPreviewSize));
+
+                    previewCache.Put(shipFilepaths[iShip], *shipPreview);
+                }
+
+                // Fire event
+                QueueEvent(
+                    new fsPreviewReadyEvent(
+                        fsEVT_PREVIEW_READY,
+                        this->GetId(),
+                        iShip,
+                        std::make_shared<ShipPreview>(std::move(*shipPreview))));
+
+                if (isSingleCore && (3 == iPreview % 4))
+                {
+                    // Give the main thread time to process this
+                    std::this_thread::yield();
+                }
+            }
+            catch (std::exception const & ex)
+            {
+                // Fire error event
+                QueueEvent(
+                    new fsPreviewErrorEvent(
+                        fsEVT_PREVIEW_ERROR,
+                        this->GetId(),
+                        iShip,
+                        ex.what()));
             }
         }
-        catch (std::exception const & ex)
-        {
-            // Fire error event
-            QueueEvent(
-                new fsPreviewErrorEvent(
-                    fsEVT_PREVIEW_ERROR,
-                    this->GetId(),
-                    iShip,
-                    ex.what()));
-        }
+    };
+
+    // Leave one core to the UI
+    unsigned int const workerCount = std::clamp(
+        std::thread::hardware_concurrency(),
+        2u,
+        MaxPreviewWorkers + 1) - 1;
+
+    std::vector<std::thread> additionalWorkers;
+    for (unsigned int w = 1; w < workerCount && w < shipFilepaths.size(); ++w)
+    {
+        additionalWorkers.emplace_back(
+            [&previewWorker]()
+            {
+                TraceLog::GetInstance().SetCurrentThreadName("Ship Preview Worker");
+
+                InitializeSimulationThreadFloatingPoint();
+
+                previewWorker();
+            });
+    }
+
+    previewWorker();
+
+    // Wait for all workers, so that no preview event of this directory
+    // may be fired after we're done with it
+    for (auto & worker : additionalWorkers)
+    {
+        worker.join();
     }
 
+    // Remember what we've got so far, even if interrupted
+    previewCache.Save();
+
+    // Check whether we have been interrupted
+    if (!!mPanelToThreadMessage)
+        return;
+
 
     //
     // Fire completion event
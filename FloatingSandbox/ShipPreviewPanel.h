@@ -14,6 +14,7 @@
 
 #include <wx/wx.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <filesystem>
 #include <memory>
@@ -229,7 +230,8 @@ wxDECLARE_EVENT(fsEVT_DIR_PREVIEW_COMPLETE, fsDirPreviewCompleteEvent);
 /*
  * This panel populates itself with previews of all ships found in a directory.
  * The search for ships and extraction of previews is done by a separate thread,
- * so to not interfere with the UI message pump.
+ * so to not interfere with the UI message pump; previews are then extracted by a
+ * small pool of workers, starting from the ones currently visible.
  */
 class ShipPreviewPanel : public wxScrolled<wxPanel>
 {
@@ -239,6 +241,8 @@ public:
     static constexpr int MinPreviewWidth = ShipPreviewControl::Width + 2 * MinPreviewHGap;
     static constexpr int PreviewVGap = 8;
 
+    static constexpr unsigned int MaxPreviewWorkers = 4;
+
 public:
 
     ShipPreviewPanel(
@@ -271,6 +275,7 @@ private:
 private:
 
     int CalculateTileColumns();
+    void UpdateVisiblePreviewStartIndex();
     void ShutdownPreviewThread();
 
 private:
@@ -300,6 +305,10 @@ private:
     void RunPreviewThread();
     void ScanDirectory(std::filesystem::path const & directoryPath);
 
+    // The index of the first preview visible in the panel; previews
+    // are extracted starting from this one
+    std::atomic<size_t> mVisiblePreviewStartIndex;
+
 
     //
     // Panel-to-Thread communication
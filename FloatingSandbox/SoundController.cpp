@@ -9,11 +9,13 @@
 
 #include <GameCore/GameException.h>
 #include <GameCore/Log.h>
+#include <GameCore/ResourceArchive.h>
 
 #include <algorithm>
 #include <cassert>
 #include <limits>
 #include <regex>
+#include <tuple>
 
 constexpr float RepairVolume = 40.0f;
 constexpr float SawVolume = 50.0f;
@@ -49,7 +51,7 @@ SoundController::SoundController(
     , mDslUOneShotMultipleChoiceSounds()
     , mUOneShotMultipleChoiceSounds()
     , mOneShotMultipleChoiceSounds()
-    , mCurrentlyPlayingOneShotSounds()
+    , mOneShotVoicePools()
     // Continuous sounds
     , mSawedMetalSound(SawedInertiaDuration)
     , mSawedWoodSound(SawedInertiaDuration)
@@ -72,12 +74,28 @@ SoundController::SoundController(
         mMasterMusicVolume,
         mMasterMusicMuted,
         std::chrono::seconds(4))
+    // Sound loading
+    , mSoundLoadingMutex()
+    , mSoundNamesToLoad()
+    , mLoadedSounds()
+    , mSoundLoadingThreads()
 {
     //
     // Initialize Music
     //
 
-    if (!mSinkingMusic.openFromFile(mResourceLoader->GetMusicFilepath("sinking_ship").string()))
+    // Packed music is streamed straight from the archive's mapping, which outlives us
+    auto const sinkingMusicFilepath = mResourceLoader->GetMusicFilepath("sinking_ship");
+    std::error_code ec;
+    auto const packedSinkingMusic = std::filesystem::exists(sinkingMusicFilepath, ec)
+        ? std::nullopt
+        : ResourceArchive::FindMounted(sinkingMusicFilepath);
+
+    bool const isSinkingMusicOpen = !!packedSinkingMusic
+        ? mSinkingMusic.openFromMemory(packedSinkingMusic->Data, packedSinkingMusic->Size)
+        : mSinkingMusic.openFromFile(sinkingMusicFilepath.string());
+
+    if (!isSinkingMusicOpen)
     {
         throw GameException("Cannot load \"sinking_ship\" music");
     }
@@ -86,360 +104,78 @@ SoundController::SoundController(
 
 
     //
-    // Initialize Sounds
+    // Initialize one-shot voices
     //
 
-    auto soundNames = mResourceLoader->GetSoundNames();
-    for (size_t i = 0; i < soundNames.size(); ++i)
+    for (size_t t = 0; t <= static_cast<size_t>(SoundType::_Last); ++t)
     {
-        std::string const & soundName = soundNames[i];
-
-        // Notify progress
-        progressCallback(static_cast<float>(i + 1) / static_cast<float>(soundNames.size()), "Loading sounds...");
-
-
-        //
-        // Load sound buffer
-        //
-
-        std::unique_ptr<sf::SoundBuffer> soundBuffer = std::make_unique<sf::SoundBuffer>();
-        if (!soundBuffer->loadFromFile(mResourceLoader->GetSoundFilepath(soundName).string()))
-        {
-            throw GameException("Cannot load sound \"" + soundName + "\"");
-        }
-
-
-
-        //
-        // Parse filename
-        //
-
-        std::regex soundTypeRegex(R"(([^_]+)(?:_.+)?)");
-        std::smatch soundTypeMatch;
-        if (!std::regex_match(soundName, soundTypeMatch, soundTypeRegex))
-        {
-            throw GameException("Sound filename \"" + soundName + "\" is not recognized");
-        }
-
-        assert(soundTypeMatch.size() == 1 + 1);
-        SoundType soundType = StrToSoundType(soundTypeMatch[1].str());
-        if (soundType == SoundType::Saw)
-        {
-            std::regex sawRegex(R"(([^_]+)(?:_(underwater))?)");
-            std::smatch uMatch;
-            if (!std::regex_match(soundName, uMatch, sawRegex))
-            {
-                throw GameException("Saw sound filename \"" + soundName + "\" is not recognized");
-            }
-
-            if (uMatch[2].matched)
-            {
-                assert(uMatch[2].str() == "underwater");
-                mSawUnderwaterSound.Initialize(
-                    std::move(soundBuffer),
-                    SawVolume,
-                    mMasterToolsVolume,
-                    mMasterToolsMuted);
-            }
-            else
-            {
-                mSawAbovewaterSound.Initialize(
-                    std::move(soundBuffer),
-                    SawVolume,
-                    mMasterToolsVolume,
-                    mMasterToolsMuted);
-            }
-        }
-        else if (soundType == SoundType::Draw)
-        {
-            mDrawSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterToolsVolume,
-                mMasterToolsMuted);
-        }
-        else if (soundType == SoundType::Sawed)
-        {
-            std::regex mRegex(R"(([^_]+)_([^_]+))");
-            std::smatch mMatch;
-            if (!std::regex_match(soundName, mMatch, mRegex))
-            {
-                throw GameException("M sound filename \"" + soundName + "\" is not recognized");
-            }
-
-            assert(mMatch.size() == 1 + 2);
-
-            // Parse SoundElementType
-            StructuralMaterial::MaterialSoundType materialSound = StructuralMaterial::StrToMaterialSoundType(mMatch[2].str());
-
-            if (StructuralMaterial::MaterialSoundType::Metal == materialSound)
-            {
-                mSawedMetalSound.Initialize(
-                    std::move(soundBuffer),
-                    mMasterEffectsVolume,
-                    mMasterEffectsMuted);
-            }
-            else
-            {
-                mSawedWoodSound.Initialize(
-                    std::move(soundBuffer),
-                    mMasterEffectsVolume,
-                    mMasterEffectsMuted);
-            }
-        }
-        else if (soundType == SoundType::Swirl)
-        {
-            mSwirlSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterToolsVolume,
-                mMasterToolsMuted);
-        }
-        else if (soundType == SoundType::AirBubbles)
-        {
-            mAirBubblesSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterToolsVolume,
-                mMasterToolsMuted);
-        }
-        else if (soundType == SoundType::FloodHose)
-        {
-            mFloodHoseSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterToolsVolume,
-                mMasterToolsMuted);
-        }
-        else if (soundType == SoundType::RepairStructure)
-        {
-            mRepairStructureSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterToolsVolume,
-                mMasterToolsMuted);
-        }
-        else if (soundType == SoundType::WaterRush)
-        {
-            mWaterRushSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterEffectsVolume,
-                mMasterEffectsMuted);
-        }
-        else if (soundType == SoundType::WaterSplash)
-        {
-            mWaterSplashSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterEffectsVolume,
-                mMasterEffectsMuted);
-        }
-        else if (soundType == SoundType::Wind)
-        {
-            mWindSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterEffectsVolume,
-                mMasterEffectsMuted);
-        }
-        else if (soundType == SoundType::TimerBombSlowFuse)
-        {
-            mTimerBombSlowFuseSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterEffectsVolume,
-                mMasterEffectsMuted);
-        }
-        else if (soundType == SoundType::TimerBombFastFuse)
-        {
-            mTimerBombFastFuseSound.Initialize(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterEffectsVolume,
-                mMasterEffectsMuted);
-        }
-        else if (soundType == SoundType::Break || soundType == SoundType::Destroy || soundType == SoundType::Stress
-                || soundType == SoundType::RepairSpring || soundType == SoundType::RepairTriangle)
-        {
-            //
-            // MSU sound
-            //
-
-            std::regex msuRegex(R"(([^_]+)_([^_]+)_([^_]+)_(?:(underwater)_)?\d+)");
-            std::smatch msuMatch;
-            if (!std::regex_match(soundName, msuMatch, msuRegex))
-            {
-                throw GameException("MSU sound filename \"" + soundName + "\" is not recognized");
-            }
-
-            assert(msuMatch.size() == 1 + 4);
-
-            // 1. Parse MaterialSoundType
-            StructuralMaterial::MaterialSoundType materialSound = StructuralMaterial::StrToMaterialSoundType(msuMatch[2].str());
-
-            // 2. Parse Size
-            SizeType sizeType = StrToSizeType(msuMatch[3].str());
-
-            // 3. Parse Underwater
-            bool isUnderwater;
-            if (msuMatch[4].matched)
-            {
-                assert(msuMatch[4].str() == "underwater");
-                isUnderwater = true;
-            }
-            else
-            {
-                isUnderwater = false;
-            }
-
-
-            //
-            // Store sound buffer
-            //
-
-            mMSUOneShotMultipleChoiceSounds[std::make_tuple(soundType, materialSound, sizeType, isUnderwater)]
-                .SoundBuffers.emplace_back(std::move(soundBuffer));
-        }
-        else if (soundType == SoundType::LightFlicker)
-        {
-            //
-            // DslU sound
-            //
-
-            std::regex dsluRegex(R"(([^_]+)_([^_]+)_(?:(underwater)_)?\d+)");
-            std::smatch dsluMatch;
-            if (!std::regex_match(soundName, dsluMatch, dsluRegex))
-            {
-                throw GameException("DslU sound filename \"" + soundName + "\" is not recognized");
-            }
-
-            assert(dsluMatch.size() >= 1 + 2 && dsluMatch.size() <= 1 + 3);
-
-            // 1. Parse Duration
-            DurationShortLongType durationType = StrToDurationShortLongType(dsluMatch[2].str());
-
-            // 2. Parse Underwater
-            bool isUnderwater;
-            if (dsluMatch[3].matched)
-            {
-                assert(dsluMatch[3].str() == "underwater");
-                isUnderwater = true;
-            }
-            else
-            {
-                isUnderwater = false;
-            }
-
-
-            //
-            // Store sound buffer
-            //
-
-            mDslUOneShotMultipleChoiceSounds[std::make_tuple(soundType, durationType, isUnderwater)]
-                .SoundBuffers.emplace_back(std::move(soundBuffer));
-        }
-        else if (soundType == SoundType::Wave
-                || soundType == SoundType::WindGust
-                || soundType == SoundType::AntiMatterBombPreImplosion
-                || soundType == SoundType::AntiMatterBombImplosion
-                || soundType == SoundType::Snapshot
-                || soundType == SoundType::TerrainAdjust
-                || soundType == SoundType::Scrub)
-        {
-            //
-            // - one-shot sound
-            //
-
-            std::regex sRegex(R"(([^_]+)_\d+)");
-            std::smatch sMatch;
-            if (!std::regex_match(soundName, sMatch, sRegex))
-            {
-                throw GameException("- sound filename \"" + soundName + "\" is not recognized");
-            }
-
-            assert(sMatch.size() == 1 + 1);
-
-            //
-            // Store sound buffer
-            //
-
-            mOneShotMultipleChoiceSounds[std::make_tuple(soundType)]
-                .SoundBuffers.emplace_back(std::move(soundBuffer));
-        }
-        else if (soundType == SoundType::AntiMatterBombContained)
-        {
-            //
-            // - continuous sound
-            //
-
-            std::regex sRegex(R"(([^_]+)_\d+)");
-            std::smatch sMatch;
-            if (!std::regex_match(soundName, sMatch, sRegex))
-            {
-                throw GameException("- sound filename \"" + soundName + "\" is not recognized");
-            }
+        mOneShotVoicePools.emplace_back(static_cast<SoundType>(t));
+    }
 
-            assert(sMatch.size() == 1 + 1);
 
-            //
-            // Initialize continuous sound
-            //
+    //
+    // Start loading sounds
+    //
+    // Decoding all of our sounds takes a while, hence we do it on a few worker threads
+    // while the game is already running; each sound is installed - and becomes playable -
+    // at the first Update() after it's been loaded. The first alternative of each sound
+    // is loaded before all of the other alternatives, so that all sounds are playable
+    // as early as possible.
+    //
 
-            mAntiMatterBombContainedSounds.AddAlternative(
-                std::move(soundBuffer),
-                100.0f,
-                mMasterEffectsVolume,
-                mMasterEffectsMuted);
-        }
+    auto const getAlternativeOrdinal = [](std::string const & soundName)
+    {
+        std::regex alternativeRegex(R"(.+_(\d+))");
+        std::smatch alternativeMatch;
+        if (std::regex_match(soundName, alternativeMatch, alternativeRegex))
+            return std::stoi(alternativeMatch[1].str());
         else
-        {
-            //
-            // U sound
-            //
-
-            std::regex uRegex(R"(([^_]+)_(?:(underwater)_)?\d+)");
-            std::smatch uMatch;
-            if (!std::regex_match(soundName, uMatch, uRegex))
-            {
-                throw GameException("U sound filename \"" + soundName + "\" is not recognized");
-            }
-
-            assert(uMatch.size() == 1 + 2);
+            return 0;
+    };
 
-            // 1. Parse Underwater
-            bool isUnderwater;
-            if (uMatch[2].matched)
-            {
-                assert(uMatch[2].str() == "underwater");
-                isUnderwater = true;
-            }
-            else
-            {
-                isUnderwater = false;
-            }
+    std::vector<std::pair<int, std::string>> soundNamesToLoad;
+    for (std::string const & soundName : mResourceLoader->GetSoundNames())
+    {
+        soundNamesToLoad.emplace_back(getAlternativeOrdinal(soundName), soundName);
+    }
 
+    std::sort(soundNamesToLoad.begin(), soundNamesToLoad.end());
 
-            //
-            // Store sound buffer
-            //
+    for (auto const & entry : soundNamesToLoad)
+    {
+        mSoundNamesToLoad.push_back(entry.second);
+    }
 
-            mUOneShotMultipleChoiceSounds[std::make_tuple(soundType, isUnderwater)]
-                .SoundBuffers.emplace_back(std::move(soundBuffer));
-        }
+    unsigned int const soundLoadingThreadCount = std::clamp(std::thread::hardware_concurrency() / 2u, 1u, 4u);
+    for (unsigned int t = 0; t < soundLoadingThreadCount; ++t)
+    {
+        mSoundLoadingThreads.emplace_back(&SoundController::SoundLoadingThreadLoop, this);
     }
+
+    progressCallback(1.0f, "Loading sounds...");
 }
 
 SoundController::~SoundController()
 {
+    // Stop loading sounds
+    {
+        std::lock_guard<std::mutex> lock(mSoundLoadingMutex);
+        mSoundNamesToLoad.clear();
+    }
+
+    for (auto & thread : mSoundLoadingThreads)
+    {
+        thread.join();
+    }
+
     Reset();
 }
 
 void SoundController::SetPaused(bool isPaused)
 {
-    for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+    for (auto const & voicePool : mOneShotVoicePools)
     {
-        for (auto & playingSound : playingSoundIt.second)
+        for (auto & playingSound : voicePool.Voices)
         {
             if (isPaused)
             {
@@ -486,15 +222,15 @@ void SoundController::SetMasterEffectsVolume(float volume)
 {
     mMasterEffectsVolume = volume;
 
-    for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+    for (auto const & voicePool : mOneShotVoicePools)
     {
-        if (playingSoundIt.first != SoundType::Draw
-            && playingSoundIt.first != SoundType::Saw
-            && playingSoundIt.first != SoundType::Swirl
-            && playingSoundIt.first != SoundType::AirBubbles
-            && playingSoundIt.first != SoundType::FloodHose)
+        if (voicePool.Type != SoundType::Draw
+            && voicePool.Type != SoundType::Saw
+            && voicePool.Type != SoundType::Swirl
+            && voicePool.Type != SoundType::AirBubbles
+            && voicePool.Type != SoundType::FloodHose)
         {
-            for (auto & playingSound : playingSoundIt.second)
+            for (auto & playingSound : voicePool.Voices)
             {
                 playingSound.Sound->setMasterVolume(mMasterEffectsVolume);
             }
@@ -516,15 +252,15 @@ void SoundController::SetMasterEffectsMuted(bool isMuted)
 {
     mMasterEffectsMuted = isMuted;
 
-    for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+    for (auto const & voicePool : mOneShotVoicePools)
     {
-        if (playingSoundIt.first != SoundType::Draw
-            && playingSoundIt.first != SoundType::Saw
-            && playingSoundIt.first != SoundType::Swirl
-            && playingSoundIt.first != SoundType::AirBubbles
-            && playingSoundIt.first != SoundType::FloodHose)
+        if (voicePool.Type != SoundType::Draw
+            && voicePool.Type != SoundType::Saw
+            && voicePool.Type != SoundType::Swirl
+            && voicePool.Type != SoundType::AirBubbles
+            && voicePool.Type != SoundType::FloodHose)
         {
-            for (auto & playingSound : playingSoundIt.second)
+            for (auto & playingSound : voicePool.Voices)
             {
                 playingSound.Sound->setMuted(mMasterEffectsMuted);
             }
@@ -548,15 +284,15 @@ void SoundController::SetMasterToolsVolume(float volume)
 {
     mMasterToolsVolume = volume;
 
-    for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+    for (auto const & voicePool : mOneShotVoicePools)
     {
-        if (playingSoundIt.first == SoundType::Draw
-            || playingSoundIt.first == SoundType::Saw
-            || playingSoundIt.first == SoundType::Swirl
-            || playingSoundIt.first == SoundType::AirBubbles
-            || playingSoundIt.first == SoundType::FloodHose)
+        if (voicePool.Type == SoundType::Draw
+            || voicePool.Type == SoundType::Saw
+            || voicePool.Type == SoundType::Swirl
+            || voicePool.Type == SoundType::AirBubbles
+            || voicePool.Type == SoundType::FloodHose)
         {
-            for (auto & playingSound : playingSoundIt.second)
+            for (auto & playingSound : voicePool.Voices)
             {
                 playingSound.Sound->setMasterVolume(mMasterToolsVolume);
             }
@@ -576,15 +312,15 @@ void SoundController::SetMasterToolsMuted(bool isMuted)
 {
     mMasterToolsMuted = isMuted;
 
-    for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+    for (auto const & voicePool : mOneShotVoicePools)
     {
-        if (playingSoundIt.first == SoundType::Draw
-            || playingSoundIt.first == SoundType::Saw
-            || playingSoundIt.first == SoundType::Swirl
-            || playingSoundIt.first == SoundType::AirBubbles
-            || playingSoundIt.first == SoundType::FloodHose)
+        if (voicePool.Type == SoundType::Draw
+            || voicePool.Type == SoundType::Saw
+            || voicePool.Type == SoundType::Swirl
+            || voicePool.Type == SoundType::AirBubbles
+            || voicePool.Type == SoundType::FloodHose)
         {
-            for (auto & playingSound : playingSoundIt.second)
+            for (auto & playingSound : voicePool.Voices)
             {
                 playingSound.Sound->setMuted(mMasterToolsMuted);
             }
@@ -622,9 +358,9 @@ void SoundController::SetPlayBreakSounds(bool playBreakSounds)
 
     if (!mPlayBreakSounds)
     {
-        for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+        for (auto const & voicePool : mOneShotVoicePools)
         {
-            for (auto & playingSound : playingSoundIt.second)
+            for (auto & playingSound : voicePool.Voices)
             {
                 if (SoundType::Break == playingSound.Type)
                 {
@@ -641,9 +377,9 @@ void SoundController::SetPlayStressSounds(bool playStressSounds)
 
     if (!mPlayStressSounds)
     {
-        for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+        for (auto const & voicePool : mOneShotVoicePools)
         {
-            for (auto & playingSound : playingSoundIt.second)
+            for (auto & playingSound : voicePool.Voices)
             {
                 if (SoundType::Stress == playingSound.Type)
                 {
@@ -662,9 +398,9 @@ void SoundController::SetPlayWindSound(bool playWindSound)
     {
         mWindSound.SetMuted(true);
 
-        for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+        for (auto const & voicePool : mOneShotVoicePools)
         {
-            for (auto & playingSound : playingSoundIt.second)
+            for (auto & playingSound : voicePool.Voices)
             {
                 if (SoundType::WindGust == playingSound.Type)
                 {
@@ -795,6 +531,8 @@ void SoundController::PlaySnapshotSound()
 
 void SoundController::Update()
 {
+    InstallLoadedSounds();
+
     mSinkingMusic.update();
 
     // Silence the sawed sounds - this will be a nop in case
@@ -813,9 +551,9 @@ void SoundController::Reset()
     // Stop and clear all sounds
     //
 
-    for (auto const & playingSoundIt : mCurrentlyPlayingOneShotSounds)
+    for (auto const & voicePool : mOneShotVoicePools)
     {
-        for (auto & playingSound : playingSoundIt.second)
+        for (auto & playingSound : voicePool.Voices)
         {
             assert(!!playingSound.Sound);
             if (sf::Sound::Status::Playing == playingSound.Sound->getStatus())
@@ -825,8 +563,6 @@ void SoundController::Reset()
         }
     }
 
-    mCurrentlyPlayingOneShotSounds.clear();
-
     mSawedMetalSound.Reset();
     mSawedWoodSound.Reset();
     mSawAbovewaterSound.Reset();
@@ -1473,6 +1209,7 @@ void SoundController::ChooseAndPlayOneShotMultipleChoiceSound(
 
     PlayOneShotSound(
         soundType,
+        sound,
         chosenSoundBuffer,
         volume,
         isInterruptible);
@@ -1480,134 +1217,488 @@ void SoundController::ChooseAndPlayOneShotMultipleChoiceSound(
 
 void SoundController::PlayOneShotSound(
     SoundType soundType,
+    OneShotMultipleChoiceSound const & group,
     sf::SoundBuffer * soundBuffer,
     float volume,
     bool isInterruptible)
 {
     assert(nullptr != soundBuffer);
 
-    //
-    // Make sure there isn't already a sound with this sound buffer that started
-    // playing too recently;
-    // if there is, adjust its volume
-    //
-
-    auto & thisTypeCurrentlyPlayingSounds = mCurrentlyPlayingOneShotSounds[soundType];
+    auto & voicePool = mOneShotVoicePools[static_cast<size_t>(soundType)];
+    assert(voicePool.Type == soundType);
 
     auto const now = GameWallClock::GetInstance().Now();
     auto const minDeltaTimeSoundForType = GetMinDeltaTimeSoundForType(soundType);
 
-    for (auto & playingSound : thisTypeCurrentlyPlayingSounds)
-    {
-        assert(!!playingSound.Sound);
-        if (playingSound.Sound->getBuffer() == soundBuffer
-            && std::chrono::duration_cast<std::chrono::milliseconds>(now - playingSound.StartedTimestamp) < minDeltaTimeSoundForType)
-        {
-            playingSound.Sound->addVolume(volume);
-            return;
-        }
-    }
-
-
     //
-    // Make sure there's room for this sound
+    // Visit the voices - at most a few tens - once, looking for:
+    // - A voice that started playing this same sound too recently; if there is one,
+    //   we make it louder rather than starting another one, hence bursts of the same
+    //   event collapse into a single voice
+    // - A free voice
+    // - The voice to steal otherwise: an interruptible one if any, the quietest one
+    //   among those, and the oldest among the quietest
     //
 
-    auto const maxPlayingSoundsForThisType = GetMaxPlayingSoundsForType(soundType);
+    PlayingSound * freeVoice = nullptr;
+    PlayingSound * voiceToSteal = nullptr;
 
-    if (thisTypeCurrentlyPlayingSounds.size() >= maxPlayingSoundsForThisType)
+    for (auto & voice : voicePool.Voices)
     {
-        ScavengeStoppedSounds(thisTypeCurrentlyPlayingSounds);
+        assert(!!voice.Sound);
 
-        if (thisTypeCurrentlyPlayingSounds.size() >= maxPlayingSoundsForThisType)
+        if (sf::Sound::Status::Stopped == voice.Sound->getStatus())
         {
-            // Need to stop the (expendable) sound that's been playing for the longest
-            ScavengeOldestSound(thisTypeCurrentlyPlayingSounds);
-        }
-    }
+            if (nullptr == freeVoice)
+                freeVoice = &voice;
 
-    assert(thisTypeCurrentlyPlayingSounds.size() < maxPlayingSoundsForThisType);
+            continue;
+        }
 
+        if (voice.Group == &group
+            && std::chrono::duration_cast<std::chrono::milliseconds>(now - voice.StartedTimestamp) < minDeltaTimeSoundForType)
+        {
+            voice.Sound->addVolume(volume);
+            return;
+        }
 
+        if (nullptr == voiceToSteal
+            || std::make_tuple(!voice.IsInterruptible, voice.Sound->getVolume(), voice.StartedTimestamp)
+                < std::make_tuple(!voiceToSteal->IsInterruptible, voiceToSteal->Sound->getVolume(), voiceToSteal->StartedTimestamp))
+        {
+            voiceToSteal = &voice;
+        }
+    }
 
     //
-    // Create and play sound
+    // Choose the voice and play the sound
     //
 
-    std::unique_ptr<GameSound> sound = std::make_unique<GameSound>(
-        *soundBuffer,
+    PlayingSound * voice;
+    if (nullptr != freeVoice)
+    {
+        voice = freeVoice;
+    }
+    else if (voicePool.Voices.size() < GetMaxPlayingSoundsForType(soundType))
+    {
+        // Create a new voice; this never reallocates, as the pool has reserved
+        // room for all of its voices
+        voicePool.Voices.emplace_back(
+            soundType,
+            std::make_unique<GameSound>(
+                *soundBuffer,
+                volume,
+                mMasterEffectsVolume,
+                mMasterEffectsMuted),
+            nullptr,
+            now,
+            isInterruptible);
+
+        voice = &(voicePool.Voices.back());
+    }
+    else
+    {
+        assert(nullptr != voiceToSteal);
+        voice = voiceToSteal;
+        voice->Sound->stop();
+    }
+
+    voice->Sound->setBuffer(*soundBuffer);
+    voice->Sound->setVolumes(
         volume,
         mMasterEffectsVolume,
         mMasterEffectsMuted);
+    voice->Group = &group;
+    voice->StartedTimestamp = now;
+    voice->IsInterruptible = isInterruptible;
 
-    sound->play();
-
-    thisTypeCurrentlyPlayingSounds.emplace_back(
-        soundType,
-        std::move(sound),
-        now,
-        isInterruptible);
+    voice->Sound->play();
 }
 
-void SoundController::ScavengeStoppedSounds(std::vector<PlayingSound> & playingSounds)
+void SoundController::SoundLoadingThreadLoop()
 {
-    for (auto it = playingSounds.begin(); it != playingSounds.end(); /*incremented in loop*/)
+    while (true)
     {
-        assert(!!it->Sound);
-        if (sf::Sound::Status::Stopped == it->Sound->getStatus())
+        std::string soundName;
+
         {
-            // Scavenge
-            it = playingSounds.erase(it);
+            std::lock_guard<std::mutex> lock(mSoundLoadingMutex);
+
+            if (mSoundNamesToLoad.empty())
+                break;
+
+            soundName = std::move(mSoundNamesToLoad.front());
+            mSoundNamesToLoad.pop_front();
         }
-        else
+
+        auto const soundFilepath = mResourceLoader->GetSoundFilepath(soundName);
+        std::error_code ec;
+        auto const packedSound = std::filesystem::exists(soundFilepath, ec)
+            ? std::nullopt
+            : ResourceArchive::FindMounted(soundFilepath);
+
+        std::unique_ptr<sf::SoundBuffer> soundBuffer = std::make_unique<sf::SoundBuffer>();
+        bool const isSoundLoaded = !!packedSound
+            ? soundBuffer->loadFromMemory(packedSound->Data, packedSound->Size)
+            : soundBuffer->loadFromFile(soundFilepath.string());
+
+        if (!isSoundLoaded)
+        {
+            // Surfaced at the next Update()
+            soundBuffer.reset();
+        }
+
         {
-            ++it;
+            std::lock_guard<std::mutex> lock(mSoundLoadingMutex);
+
+            mLoadedSounds.emplace_back(std::move(soundName), std::move(soundBuffer));
         }
     }
 }
 
-void SoundController::ScavengeOldestSound(std::vector<PlayingSound> & playingSounds)
+void SoundController::InstallLoadedSounds()
 {
-    assert(!playingSounds.empty());
+    std::vector<std::pair<std::string, std::unique_ptr<sf::SoundBuffer>>> loadedSounds;
+
+    {
+        std::lock_guard<std::mutex> lock(mSoundLoadingMutex);
+
+        if (mLoadedSounds.empty())
+            return;
+
+        loadedSounds.swap(mLoadedSounds);
+    }
 
+    for (auto & loadedSound : loadedSounds)
+    {
+        if (!loadedSound.second)
+        {
+            throw GameException("Cannot load sound \"" + loadedSound.first + "\"");
+        }
+
+        InstallSound(loadedSound.first, std::move(loadedSound.second));
+    }
+}
+
+void SoundController::InstallSound(
+    std::string const & soundName,
+    std::unique_ptr<sf::SoundBuffer> soundBuffer)
+{
     //
-    // Two choices, in order of priority:
-    // 1) Interruptible
-    // 2) Non interruptible
+    // Parse filename
     //
 
-    size_t iOldestInterruptibleSound = std::numeric_limits<size_t>::max();
-    auto oldestInterruptibleSoundStartTimestamp = GameWallClock::time_point::max();
-    size_t iOldestNonInterruptibleSound = std::numeric_limits<size_t>::max();
-    auto oldestNonInterruptibleSoundStartTimestamp = GameWallClock::time_point::max();
-    for (size_t i = 0; i < playingSounds.size(); ++i)
+    std::regex soundTypeRegex(R"(([^_]+)(?:_.+)?)");
+    std::smatch soundTypeMatch;
+    if (!std::regex_match(soundName, soundTypeMatch, soundTypeRegex))
+    {
+        throw GameException("Sound filename \"" + soundName + "\" is not recognized");
+    }
+
+    assert(soundTypeMatch.size() == 1 + 1);
+    SoundType soundType = StrToSoundType(soundTypeMatch[1].str());
+    if (soundType == SoundType::Saw)
     {
-        if (playingSounds[i].StartedTimestamp < oldestNonInterruptibleSoundStartTimestamp)
+        std::regex sawRegex(R"(([^_]+)(?:_(underwater))?)");
+        std::smatch uMatch;
+        if (!std::regex_match(soundName, uMatch, sawRegex))
         {
-            iOldestNonInterruptibleSound = i;
-            oldestNonInterruptibleSoundStartTimestamp = playingSounds[i].StartedTimestamp;
+            throw GameException("Saw sound filename \"" + soundName + "\" is not recognized");
         }
 
-        if (playingSounds[i].StartedTimestamp < oldestInterruptibleSoundStartTimestamp
-            && playingSounds[i].IsInterruptible)
+        if (uMatch[2].matched)
         {
-            iOldestInterruptibleSound = i;
-            oldestInterruptibleSoundStartTimestamp = playingSounds[i].StartedTimestamp;
+            assert(uMatch[2].str() == "underwater");
+            mSawUnderwaterSound.Initialize(
+                std::move(soundBuffer),
+                SawVolume,
+                mMasterToolsVolume,
+                mMasterToolsMuted);
+        }
+        else
+        {
+            mSawAbovewaterSound.Initialize(
+                std::move(soundBuffer),
+                SawVolume,
+                mMasterToolsVolume,
+                mMasterToolsMuted);
         }
     }
+    else if (soundType == SoundType::Draw)
+    {
+        mDrawSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterToolsVolume,
+            mMasterToolsMuted);
+    }
+    else if (soundType == SoundType::Sawed)
+    {
+        std::regex mRegex(R"(([^_]+)_([^_]+))");
+        std::smatch mMatch;
+        if (!std::regex_match(soundName, mMatch, mRegex))
+        {
+            throw GameException("M sound filename \"" + soundName + "\" is not recognized");
+        }
 
-    size_t iSoundToStop;
-    if (oldestInterruptibleSoundStartTimestamp != GameWallClock::time_point::max())
+        assert(mMatch.size() == 1 + 2);
+
+        // Parse SoundElementType
+        StructuralMaterial::MaterialSoundType materialSound = StructuralMaterial::StrToMaterialSoundType(mMatch[2].str());
+
+        if (StructuralMaterial::MaterialSoundType::Metal == materialSound)
+        {
+            mSawedMetalSound.Initialize(
+                std::move(soundBuffer),
+                mMasterEffectsVolume,
+                mMasterEffectsMuted);
+        }
+        else
+        {
+            mSawedWoodSound.Initialize(
+                std::move(soundBuffer),
+                mMasterEffectsVolume,
+                mMasterEffectsMuted);
+        }
+    }
+    else if (soundType == SoundType::Swirl)
     {
-        iSoundToStop = iOldestInterruptibleSound;
+        mSwirlSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterToolsVolume,
+            mMasterToolsMuted);
     }
-    else
+    else if (soundType == SoundType::AirBubbles)
+    {
+        mAirBubblesSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterToolsVolume,
+            mMasterToolsMuted);
+    }
+    else if (soundType == SoundType::FloodHose)
+    {
+        mFloodHoseSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterToolsVolume,
+            mMasterToolsMuted);
+    }
+    else if (soundType == SoundType::RepairStructure)
+    {
+        mRepairStructureSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterToolsVolume,
+            mMasterToolsMuted);
+    }
+    else if (soundType == SoundType::WaterRush)
+    {
+        mWaterRushSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterEffectsVolume,
+            mMasterEffectsMuted);
+    }
+    else if (soundType == SoundType::WaterSplash)
+    {
+        mWaterSplashSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterEffectsVolume,
+            mMasterEffectsMuted);
+    }
+    else if (soundType == SoundType::Wind)
     {
-        assert((oldestNonInterruptibleSoundStartTimestamp != GameWallClock::time_point::max()));
-        iSoundToStop = iOldestNonInterruptibleSound;
+        mWindSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterEffectsVolume,
+            mMasterEffectsMuted);
+    }
+    else if (soundType == SoundType::TimerBombSlowFuse)
+    {
+        mTimerBombSlowFuseSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterEffectsVolume,
+            mMasterEffectsMuted);
+    }
+    else if (soundType == SoundType::TimerBombFastFuse)
+    {
+        mTimerBombFastFuseSound.Initialize(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterEffectsVolume,
+            mMasterEffectsMuted);
     }
+    else if (soundType == SoundType::Break || soundType == SoundType::Destroy || soundType == SoundType::Stress
+            || soundType == SoundType::RepairSpring || soundType == SoundType::RepairTriangle)
+    {
+        //
+        // MSU sound
+        //
+
+        std::regex msuRegex(R"(([^_]+)_([^_]+)_([^_]+)_(?:(underwater)_)?\d+)");
+        std::smatch msuMatch;
+        if (!std::regex_match(soundName, msuMatch, msuRegex))
+        {
+            throw GameException("MSU sound filename \"" + soundName + "\" is not recognized");
+        }
+
+        assert(msuMatch.size() == 1 + 4);
+
+        // 1. Parse MaterialSoundType
+        StructuralMaterial::MaterialSoundType materialSound = StructuralMaterial::StrToMaterialSoundType(msuMatch[2].str());
+
+        // 2. Parse Size
+        SizeType sizeType = StrToSizeType(msuMatch[3].str());
+
+        // 3. Parse Underwater
+        bool isUnderwater;
+        if (msuMatch[4].matched)
+        {
+            assert(msuMatch[4].str() == "underwater");
+            isUnderwater = true;
+        }
+        else
+        {
+            isUnderwater = false;
+        }
+
 
-    assert(!!playingSounds[iSoundToStop].Sound);
-    playingSounds[iSoundToStop].Sound->stop();
-    playingSounds.erase(playingSounds.begin() + iSoundToStop);
-}
\ No newline at end of file
+        //
+        // Store sound buffer
+        //
+
+        mMSUOneShotMultipleChoiceSounds[std::make_tuple(soundType, materialSound, sizeType, isUnderwater)]
+            .SoundBuffers.emplace_back(std::move(soundBuffer));
+    }
+    else if (soundType == SoundType::LightFlicker)
+    {
+        //
+        // DslU sound
+        //
+
+        std::regex dsluRegex(R"(([^_]+)_([^_]+)_(?:(underwater)_)?\d+)");
+        std::smatch dsluMatch;
+        if (!std::regex_match(soundName, dsluMatch, dsluRegex))
+        {
+            throw GameException("DslU sound filename \"" + soundName + "\" is not recognized");
+        }
+
+        assert(dsluMatch.size() >= 1 + 2 && dsluMatch.size() <= 1 + 3);
+
+        // 1. Parse Duration
+        DurationShortLongType durationType = StrToDurationShortLongType(dsluMatch[2].str());
+
+        // 2. Parse Underwater
+        bool isUnderwater;
+        if (dsluMatch[3].matched)
+        {
+            assert(dsluMatch[3].str() == "underwater");
+            isUnderwater = true;
+        }
+        else
+        {
+            isUnderwater = false;
+        }
+
+
+        //
+        // Store sound buffer
+        //
+
+        mDslUOneShotMultipleChoiceSounds[std::make_tuple(soundType, durationType, isUnderwater)]
+            .SoundBuffers.emplace_back(std::move(soundBuffer));
+    }
+    else if (soundType == SoundType::Wave
+            || soundType == SoundType::WindGust
+            || soundType == SoundType::AntiMatterBombPreImplosion
+            || soundType == SoundType::AntiMatterBombImplosion
+            || soundType == SoundType::Snapshot
+            || soundType == SoundType::TerrainAdjust
+            || soundType == SoundType::Scrub)
+    {
+        //
+        // - one-shot sound
+        //
+
+        std::regex sRegex(R"(([^_]+)_\d+)");
+        std::smatch sMatch;
+        if (!std::regex_match(soundName, sMatch, sRegex))
+        {
+            throw GameException("- sound filename \"" + soundName + "\" is not recognized");
+        }
+
+        assert(sMatch.size() == 1 + 1);
+
+        //
+        // Store sound buffer
+        //
+
+        mOneShotMultipleChoiceSounds[std::make_tuple(soundType)]
+            .SoundBuffers.emplace_back(std::move(soundBuffer));
+    }
+    else if (soundType == SoundType::AntiMatterBombContained)
+    {
+        //
+        // - continuous sound
+        //
+
+        std::regex sRegex(R"(([^_]+)_\d+)");
+        std::smatch sMatch;
+        if (!std::regex_match(soundName, sMatch, sRegex))
+        {
+            throw GameException("- sound filename \"" + soundName + "\" is not recognized");
+        }
+
+        assert(sMatch.size() == 1 + 1);
+
+        //
+        // Initialize continuous sound
+        //
+
+        mAntiMatterBombContainedSounds.AddAlternative(
+            std::move(soundBuffer),
+            100.0f,
+            mMasterEffectsVolume,
+            mMasterEffectsMuted);
+    }
+    else
+    {
+        //
+        // U sound
+        //
+
+        std::regex uRegex(R"(([^_]+)_(?:(underwater)_)?\d+)");
+        std::smatch uMatch;
+        if (!std::regex_match(soundName, uMatch, uRegex))
+        {
+            throw GameException("U sound filename \"" + soundName + "\" is not recognized");
+        }
+
+        assert(uMatch.size() == 1 + 2);
+
+        // 1. Parse Underwater
+        bool isUnderwater;
+        if (uMatch[2].matched)
+        {
+            assert(uMatch[2].str() == "underwater");
+            isUnderwater = true;
+        }
+        else
+        {
+            isUnderwater = false;
+        }
+
+
+        //
+        // Store sound buffer
+        //
+
+        mUOneShotMultipleChoiceSounds[std::make_tuple(soundType, isUnderwater)]
+            .SoundBuffers.emplace_back(std::move(soundBuffer));
+    }
+}
@@ -21,11 +21,14 @@
 
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <utility>
 #include <vector>
 
 class SoundController : public IGameEventHandler
@@ -255,28 +258,60 @@ public:
 
 private:
 
+    /*
+     * A voice for one-shot sounds; once created, a voice is reused for all the sounds
+     * of its type, as creating sounds is expensive.
+     */
     struct PlayingSound
     {
         SoundType Type;
         std::unique_ptr<GameSound> Sound;
+        OneShotMultipleChoiceSound const * Group; // The sound whose alternative is being played
         GameWallClock::time_point StartedTimestamp;
         bool IsInterruptible;
 
         PlayingSound(
             SoundType type,
             std::unique_ptr<GameSound> sound,
+            OneShotMultipleChoiceSound const * group,
             GameWallClock::time_point startedTimestamp,
             bool isInterruptible)
             : Type(type)
             , Sound(std::move(sound))
+            , Group(group)
             , StartedTimestamp(startedTimestamp)
             , IsInterruptible(isInterruptible)
         {
         }
     };
 
+    /*
+     * The voices of a type of one-shot sounds; the voices are created as needed, up to
+     * the maximum for the type, and never destroyed.
+     */
+    struct OneShotVoicePool
+    {
+        SoundType Type;
+        std::vector<PlayingSound> Voices;
+
+        OneShotVoicePool(SoundType type)
+            : Type(type)
+            , Voices()
+        {
+            Voices.reserve(GetMaxPlayingSoundsForType(type));
+        }
+    };
+
 private:
 
+    void SoundLoadingThreadLoop();
+
+    void InstallLoadedSounds();
+
+    void InstallSound(
+        std::string const & soundName,
+        std::unique_ptr<sf::SoundBuffer> soundBuffer);
+
     void PlayMSUOneShotMultipleChoiceSound(
         SoundType soundType,
         StructuralMaterial::MaterialSoundType materialSound,
@@ -311,14 +346,11 @@ private:
 
     void PlayOneShotSound(
         SoundType soundType,
+        OneShotMultipleChoiceSound const & group,
         sf::SoundBuffer * soundBuffer,
         float volume,
         bool isInterruptible);
 
-    void ScavengeStoppedSounds(std::vector<PlayingSound> & playingSounds);
-
-    void ScavengeOldestSound(std::vector<PlayingSound> & playingSounds);
-
 private:
 
     std::shared_ptr<ResourceLoader> mResourceLoader;
@@ -401,7 +433,8 @@ private:
         std::tuple<SoundType>,
         OneShotMultipleChoiceSound> mOneShotMultipleChoiceSounds;
 
-    std::unordered_map<SoundType, std::vector<PlayingSound>> mCurrentlyPlayingOneShotSounds;
+    // Indexed by sound type
+    std::vector<OneShotVoicePool> mOneShotVoicePools;
 
     //
     // Continuous sounds
@@ -431,4 +464,17 @@ private:
     //
 
     GameMusic mSinkingMusic;
+
+    //
+    // Sound loading
+    //
+    // The loading threads pop the names of the sounds to load, and push the loaded
+    // sounds - or nullptr when they couldn't load them - for the main thread to
+    // install them
+    //
+
+    std::mutex mSoundLoadingMutex;
+    std::deque<std::string> mSoundNamesToLoad;
+    std::vector<std::pair<std::string, std::unique_ptr<sf::SoundBuffer>>> mLoadedSounds;
+    std::vector<std::thread> mSoundLoadingThreads;
 };
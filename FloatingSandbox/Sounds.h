@@ -58,7 +58,9 @@ enum class SoundType
     Snapshot,
     TerrainAdjust,
     Scrub,
-    RepairStructure
+    RepairStructure,
+
+    _Last = RepairStructure
 };
 
 SoundType StrToSoundType(std::string const & str);
@@ -108,6 +110,11 @@ public:
         }
     }
 
+    float getVolume() const
+    {
+        return mVolume;
+    }
+
     void addVolume(float volume)
     {
         mVolume += volume;
@@ -136,6 +136,9 @@ void ContinuousTool::Update(InputState const & inputState)
         mPreviousMousePosition = inputState.MousePosition;
         mPreviousTimestamp = now;
 
+        // Track how long it takes for this to show up
+        mGameController->NotifyInputEvent();
+
         // Apply current tool
         ApplyTool(
             mCumulatedTime,
@@ -687,18 +687,11 @@ public:
                 mIsUnderwater = isUnderwater;
             }
 
-            // Update down cursor
-            ++mDownCursorCounter;
-            mCurrentCursor = (mDownCursorCounter % 2) ? mDownCursor2.get() : mDownCursor1.get();
-            ShowCurrentCursor();
-        }
-    }
-
-    virtual void OnMouseMove(InputState const & inputState) override
-    {
-        if (inputState.IsLeftMouseDown)
-        {
-            if (!!mPreviousMousePos)
+            // Saw through the whole path since the previous update at once - high-polling
+            // mice may generate several moves per step, each of which would otherwise
+            // have its own saw interaction
+            if (!!mPreviousMousePos
+                && *mPreviousMousePos != inputState.MousePosition)
             {
                 mGameController->SawThrough(
                     *mPreviousMousePos,
@@ -707,9 +700,16 @@ public:
 
             // Remember the next previous mouse position
             mPreviousMousePos = inputState.MousePosition;
+
+            // Update down cursor
+            ++mDownCursorCounter;
+            mCurrentCursor = (mDownCursorCounter % 2) ? mDownCursor2.get() : mDownCursor1.get();
+            ShowCurrentCursor();
         }
     }
 
+    virtual void OnMouseMove(InputState const & /*inputState*/) override {}
+
     virtual void OnLeftMouseDown(InputState const & inputState) override
     {
         // Initialize state
@@ -28,6 +28,12 @@ UIPreferences::UIPreferences()
     mShowStartupTip = true;
     mShowShipDescriptionsAtShipLoad = true;
 
+    mSimulationThreadCount = 0;
+
+    mExportTelemetry = false;
+
+    mAutotuneConfiguration.reset();
+
 
     //
     // Load preferences
@@ -40,7 +46,7 @@ UIPreferences::UIPreferences()
 
         if (preferencesRootValue.is<picojson::object>())
         {
-            auto preferencesRootObject = preferencesRootValue.get<picojson::object>();
+            auto const & preferencesRootObject = preferencesRootValue.get<picojson::object>();
 
             //
             // Ship load directories
@@ -50,7 +56,7 @@ UIPreferences::UIPreferences()
             if (shipLoadDirectoriesIt != preferencesRootObject.end()
                 && shipLoadDirectoriesIt->second.is<picojson::array>())
             {
-                auto shipLoadDirectories = shipLoadDirectoriesIt->second.get<picojson::array>();
+                auto const & shipLoadDirectories = shipLoadDirectoriesIt->second.get<picojson::array>();
                 for (auto shipLoadDirectory : shipLoadDirectories)
                 {
                     if (shipLoadDirectory.is<std::string>())
@@ -103,6 +109,61 @@ UIPreferences::UIPreferences()
             {
                 mShowShipDescriptionsAtShipLoad = showShipDescriptionAtShipLoadIt->second.get<bool>();
             }
+
+            //
+            // Simulation thread count
+            //
+
+            auto simulationThreadCountIt = preferencesRootObject.find("simulation_thread_count");
+            if (simulationThreadCountIt != preferencesRootObject.end()
+                && simulationThreadCountIt->second.is<int64_t>()
+                && simulationThreadCountIt->second.get<int64_t>() >= 0)
+            {
+                mSimulationThreadCount = static_cast<size_t>(simulationThreadCountIt->second.get<int64_t>());
+            }
+
+            //
+            // Export telemetry
+            //
+
+            auto exportTelemetryIt = preferencesRootObject.find("export_telemetry");
+            if (exportTelemetryIt != preferencesRootObject.end()
+                && exportTelemetryIt->second.is<bool>())
+            {
+                mExportTelemetry = exportTelemetryIt->second.get<bool>();
+            }
+
+            //
+            // Autotune configuration
+            //
+
+            auto autotuneConfigurationIt = preferencesRootObject.find("autotune_configuration");
+            if (autotuneConfigurationIt != preferencesRootObject.end()
+                && autotuneConfigurationIt->second.is<picojson::object>())
+            {
+                auto const & autotuneConfigurationObject = autotuneConfigurationIt->second.get<picojson::object>();
+
+                auto const fusePointDynamicsIt = autotuneConfigurationObject.find("fuse_point_dynamics");
+                auto const solveSpringsAsConstraintsIt = autotuneConfigurationObject.find("solve_springs_as_constraints");
+                auto const useGPUMechanicalDynamicsIt = autotuneConfigurationObject.find("use_gpu_mechanical_dynamics");
+                auto const iterationsAdjustmentIt = autotuneConfigurationObject.find("mechanical_dynamics_iterations_adjustment");
+
+                if (fusePointDynamicsIt != autotuneConfigurationObject.end() && fusePointDynamicsIt->second.is<bool>()
+                    && solveSpringsAsConstraintsIt != autotuneConfigurationObject.end() && solveSpringsAsConstraintsIt->second.is<bool>()
+                    && useGPUMechanicalDynamicsIt != autotuneConfigurationObject.end() && useGPUMechanicalDynamicsIt->second.is<bool>()
+                    && iterationsAdjustmentIt != autotuneConfigurationObject.end() && iterationsAdjustmentIt->second.is<double>())
+                {
+                    mAutotuneConfiguration.emplace(
+                        mSimulationThreadCount,
+                        fusePointDynamicsIt->second.get<bool>(),
+                        solveSpringsAsConstraintsIt->second.get<bool>(),
+                        useGPUMechanicalDynamicsIt->second.get<bool>(),
+                        std::clamp(
+                            static_cast<float>(iterationsAdjustmentIt->second.get<double>()),
+                            GameParameters::MinNumMechanicalDynamicsIterationsAdjustment,
+                            GameParameters::MaxNumMechanicalDynamicsIterationsAdjustment));
+                }
+            }
         }
     }
     catch (...)
@@ -141,6 +202,24 @@ UIPreferences::~UIPreferences()
         // Add show ship descriptions at ship load
         preferencesRootObject["show_ship_descriptions_at_ship_load"] = picojson::value(mShowShipDescriptionsAtShipLoad);
 
+        // Add simulation thread count
+        preferencesRootObject["simulation_thread_count"] = picojson::value(static_cast<int64_t>(mSimulationThreadCount));
+
+        // Add export telemetry
+        preferencesRootObject["export_telemetry"] = picojson::value(mExportTelemetry);
+
+        // Add autotune configuration
+        if (!!mAutotuneConfiguration)
+        {
+            picojson::object autotuneConfigurationObject;
+            autotuneConfigurationObject["fuse_point_dynamics"] = picojson::value(mAutotuneConfiguration->DoFusePointDynamics);
+            autotuneConfigurationObject["solve_springs_as_constraints"] = picojson::value(mAutotuneConfiguration->DoSolveSpringsAsConstraints);
+            autotuneConfigurationObject["use_gpu_mechanical_dynamics"] = picojson::value(mAutotuneConfiguration->DoUseGPUMechanicalDynamics);
+            autotuneConfigurationObject["mechanical_dynamics_iterations_adjustment"] = picojson::value(static_cast<double>(mAutotuneConfiguration->NumMechanicalDynamicsIterationsAdjustment));
+
+            preferencesRootObject["autotune_configuration"] = picojson::value(autotuneConfigurationObject);
+        }
+
         // Save
         Utils::SaveJSONFile(
             picojson::value(preferencesRootObject),
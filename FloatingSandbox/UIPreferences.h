@@ -5,9 +5,13 @@
 ***************************************************************************************/
 #pragma once
 
+#include <Game/PerformanceAutotuner.h>
+
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <filesystem>
+#include <optional>
 #include <vector>
 
 /*
@@ -82,6 +86,52 @@ public:
         mShowShipDescriptionsAtShipLoad = value;
     }
 
+    /*
+     * The number of threads that the simulation runs on; zero for one per core.
+     */
+    size_t GetSimulationThreadCount() const
+    {
+        return mSimulationThreadCount;
+    }
+
+    void SetSimulationThreadCount(size_t value)
+    {
+        mSimulationThreadCount = value;
+    }
+
+    /*
+     * Whether the stats of each frame are published in shared memory, for external tools.
+     */
+    bool GetExportTelemetry() const
+    {
+        return mExportTelemetry;
+    }
+
+    void SetExportTelemetry(bool value)
+    {
+        mExportTelemetry = value;
+    }
+
+    /*
+     * The settings chosen by the last autotune, if any; its thread count is
+     * the simulation thread count.
+     */
+    std::optional<AutotuneConfiguration> GetAutotuneConfiguration() const
+    {
+        if (!mAutotuneConfiguration)
+            return std::nullopt;
+
+        AutotuneConfiguration configuration = *mAutotuneConfiguration;
+        configuration.SimulationThreadCount = mSimulationThreadCount;
+        return configuration;
+    }
+
+    void SetAutotuneConfiguration(AutotuneConfiguration const & value)
+    {
+        mAutotuneConfiguration = value;
+        mSimulationThreadCount = value.SimulationThreadCount;
+    }
+
 private:
 
     std::vector<std::filesystem::path> mShipLoadDirectories;
@@ -90,4 +140,10 @@ private:
 
     bool mShowStartupTip;
     bool mShowShipDescriptionsAtShipLoad;
+
+    size_t mSimulationThreadCount;
+
+    bool mExportTelemetry;
+
+    std::optional<AutotuneConfiguration> mAutotuneConfiguration;
 };
@@ -10,12 +10,12 @@
 #include <GameCore/Log.h>
 
 AddGPUCalculator::AddGPUCalculator(
-    std::unique_ptr<IOpenGLContext> openGLContext,
-    std::filesystem::path const & shadersRootDirectory,
+    std::shared_ptr<IOpenGLContext> openGLContext,
+    std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
     size_t dataPoints)
     : GPUCalculator(
         std::move(openGLContext),
-        shadersRootDirectory)
+        std::move(shaderManager))
     , mDataPoints(dataPoints)
     , mFrameSize(0, 0) // Temporary
 {
@@ -67,8 +67,7 @@ AddGPUCalculator::AddGPUCalculator(
     this->ActivateOpenGLContext();
 
     // Set viewport size
-    glViewport(0, 0, mFrameSize.Width, mFrameSize.Height);
-    CheckOpenGLError();
+    SetViewportSize(mFrameSize);
 
     // Set polygon mode
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -93,45 +92,14 @@ AddGPUCalculator::AddGPUCalculator(
     // Prepare input texture 0
     //
 
-    glActiveTexture(GL_TEXTURE0);
-    CheckOpenGLError();
-
-    GLuint tmpTexture;
-    glGenTextures(1, &tmpTexture);
-    mInputTextures[0] = tmpTexture;
-
-    glBindTexture(GL_TEXTURE_2D, *mInputTextures[0]);
-    CheckOpenGLError();
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, mFrameSize.Width, mFrameSize.Height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    CheckOpenGLError();
-
-    // Make sure we don't do any fancy filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    CheckOpenGLError();
+    mInputTextures[0] = CreateFloatTexture(GL_TEXTURE0, mFrameSize);
 
 
     //
     // Prepare input texture 1
     //
 
-    glActiveTexture(GL_TEXTURE1);
-    CheckOpenGLError();
-
-    glGenTextures(1, &tmpTexture);
-    mInputTextures[1] = tmpTexture;
-
-    glBindTexture(GL_TEXTURE_2D, *mInputTextures[1]);
-    CheckOpenGLError();
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, mFrameSize.Width, mFrameSize.Height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    CheckOpenGLError();
-
-    // Make sure we don't do any fancy filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    CheckOpenGLError();
+    mInputTextures[1] = CreateFloatTexture(GL_TEXTURE1, mFrameSize);
 
 
 
@@ -229,17 +197,29 @@ void AddGPUCalculator::Run(
     vec2f const * a,
     vec2f const * b,
     vec2f * result)
+{
+    Upload(a, b);
+
+    Dispatch();
+
+    Readback(result);
+}
+
+void AddGPUCalculator::Upload(
+    vec2f const * a,
+    vec2f const * b)
 {
     assert(nullptr != a);
     assert(nullptr != b);
-    assert(nullptr != result);
 
-    this->ActivateOpenGLContext();
+    BindState();
 
     //
     // Upload input 0
     //
 
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput0>();
+
     glBindTexture(GL_TEXTURE_2D, *mInputTextures[0]);
 
    if (mWholeRows > 0)
@@ -272,6 +252,8 @@ void AddGPUCalculator::Run(
     // Upload input 1
     //
 
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput1>();
+
     glBindTexture(GL_TEXTURE_2D, *mInputTextures[1]);
 
     if (mWholeRows > 0)
@@ -299,19 +281,27 @@ void AddGPUCalculator::Run(
 
         CheckOpenGLError();
     }
+}
 
+void AddGPUCalculator::Dispatch()
+{
+    BindState();
 
-    //
-    // Draw
-    //
+    // The inputs are on the texture units we've uploaded them to
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput0>();
+    glBindTexture(GL_TEXTURE_2D, *mInputTextures[0]);
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput1>();
+    glBindTexture(GL_TEXTURE_2D, *mInputTextures[1]);
 
     glDrawArrays(GL_TRIANGLES, 0, 6);
     CheckOpenGLError();
+}
 
+void AddGPUCalculator::Readback(vec2f * result)
+{
+    assert(nullptr != result);
 
-    //
-    // Read
-    //
+    BindState();
 
     if (mWholeRows > 0)
     {
@@ -336,4 +326,15 @@ void AddGPUCalculator::Run(
     }
 
     glFlush();
+}
+
+void AddGPUCalculator::BindState()
+{
+    this->ActivateOpenGLContext();
+
+    // The context is shared with other calculators
+    glBindFramebuffer(GL_FRAMEBUFFER, *mFramebuffer);
+    CheckOpenGLError();
+
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::Add>();
 }
\ No newline at end of file
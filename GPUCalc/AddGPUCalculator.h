@@ -9,12 +9,12 @@
 
 #include <GameCore/Vectors.h>
 
-#include <filesystem>
 
 /*
  * Simple calculator that adds two arrays of vec2's.
  *
- * For test purposes.
+ * For test purposes; the phases of a run may also be invoked one by one, so that
+ * they may be measured on their own.
  */
 class AddGPUCalculator : public GPUCalculator
 {
@@ -25,13 +25,26 @@ public:
         vec2f const * b,
         vec2f * result);
 
+    void Upload(
+        vec2f const * a,
+        vec2f const * b);
+
+    void Dispatch();
+
+    void Readback(vec2f * result);
+
+    ImageSize const & GetFrameSize() const
+    {
+        return mFrameSize;
+    }
+
 private:
 
     friend class GPUCalculatorFactory;
 
     AddGPUCalculator(
-        std::unique_ptr<IOpenGLContext> openGLContext,
-        std::filesystem::path const & shadersRootDirectory,
+        std::shared_ptr<IOpenGLContext> openGLContext,
+        std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
         size_t dataPoints);
 
     ImageSize CalculateRequiredFrameSize(size_t dataPoints)
@@ -65,6 +78,8 @@ private:
         }
     }
 
+    void BindState();
+
 private:
 
     size_t const mDataPoints;
@@ -0,0 +1,159 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-15
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "AsyncPixelReadback.h"
+
+#include <GameCore/GameException.h>
+
+#include <cassert>
+#include <cstring>
+
+AsyncPixelReadback::AsyncPixelReadback(ImageSize const & size)
+    : mSize(size)
+    , mSlots()
+    , mNextSlot(0)
+    , mPendingCount(0)
+{
+    for (Slot & slot : mSlots)
+    {
+        GLuint tmpGLuint;
+        glGenBuffers(1, &tmpGLuint);
+        slot.PixelBuffer = tmpGLuint;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, *slot.PixelBuffer);
+        CheckOpenGLError();
+
+        glBufferData(
+            GL_PIXEL_PACK_BUFFER,
+            static_cast<size_t>(mSize.Width) * static_cast<size_t>(mSize.Height) * sizeof(vec4f),
+            nullptr,
+            GL_STREAM_READ);
+        CheckOpenGLError();
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+AsyncPixelReadback::~AsyncPixelReadback()
+{
+    for (Slot & slot : mSlots)
+    {
+        DeleteFence(slot.Fence);
+    }
+}
+
+void AsyncPixelReadback::Start()
+{
+    Slot & slot = mSlots[mNextSlot];
+
+    // Discard whatever was pending in this slot
+    DeleteFence(slot.Fence);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, *slot.PixelBuffer);
+    CheckOpenGLError();
+
+    glReadPixels(
+        0, 0,
+        mSize.Width, mSize.Height,
+        GL_RGBA, GL_FLOAT,
+        (void*)0);
+    CheckOpenGLError();
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (NULL != glFenceSync)
+    {
+        slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // Make sure the transfer gets going while we're busy with something else
+    glFlush();
+
+    mNextSlot = (mNextSlot + 1) % mSlots.size();
+    if (mPendingCount < mSlots.size())
+        ++mPendingCount;
+}
+
+bool AsyncPixelReadback::AreResultsReady() const
+{
+    if (mPendingCount == 0)
+        return false;
+
+    GLsync const fence = mSlots[GetOldestPendingSlot()].Fence;
+    if (NULL == fence)
+    {
+        // Can't tell, assume the best
+        return true;
+    }
+
+    GLenum const result = glClientWaitSync(fence, 0, 0);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+bool AsyncPixelReadback::Retrieve(
+    vec4f * destination,
+    size_t pixelCount)
+{
+    assert(pixelCount <= static_cast<size_t>(mSize.Width) * static_cast<size_t>(mSize.Height));
+
+    if (mPendingCount == 0)
+        return false;
+
+    Slot & slot = mSlots[GetOldestPendingSlot()];
+
+    //
+    // Wait for the transfer to complete; mapping would block anyway, but this
+    // way we don't keep the driver's lock while waiting
+    //
+
+    if (NULL != slot.Fence)
+    {
+        while (true)
+        {
+            GLenum const result = glClientWaitSync(slot.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+                break;
+
+            if (result == GL_WAIT_FAILED)
+                throw GameException("Cannot wait for the GPU readback to complete");
+
+            // Timeout expired, keep waiting
+        }
+
+        DeleteFence(slot.Fence);
+    }
+
+    //
+    // Copy
+    //
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, *slot.PixelBuffer);
+    CheckOpenGLError();
+
+    void const * mappedBuffer = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (nullptr == mappedBuffer)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        throw GameException("Cannot map the GPU readback buffer");
+    }
+
+    std::memcpy(destination, mappedBuffer, pixelCount * sizeof(vec4f));
+
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    --mPendingCount;
+
+    return true;
+}
+
+void AsyncPixelReadback::DeleteFence(GLsync & fence)
+{
+    if (NULL != fence)
+    {
+        glDeleteSync(fence);
+        fence = NULL;
+    }
+}
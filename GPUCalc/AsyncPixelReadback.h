@@ -0,0 +1,87 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-15
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameOpenGL/GameOpenGL.h>
+
+#include <GameCore/ImageSize.h>
+#include <GameCore/Vectors.h>
+
+#include <array>
+
+/*
+ * Reads back RGBA32F framebuffers asynchronously, via two pixel buffers: Start()
+ * only queues the transfer, and its results are retrieved by a later Retrieve() -
+ * typically one frame later, by when the GPU is done with them.
+ *
+ * Each transfer is fenced, when the driver supports it, so that we may tell whether
+ * retrieving its results would block. Up to two transfers may be pending; starting
+ * a third one discards the oldest.
+ *
+ * Must be used with the context active that it was created with.
+ */
+class AsyncPixelReadback
+{
+public:
+
+    explicit AsyncPixelReadback(ImageSize const & size);
+
+    ~AsyncPixelReadback();
+
+    AsyncPixelReadback(AsyncPixelReadback const &) = delete;
+    AsyncPixelReadback & operator=(AsyncPixelReadback const &) = delete;
+
+    /*
+     * Starts reading back the whole framebuffer currently bound; returns immediately.
+     */
+    void Start();
+
+    bool HasPendingResults() const
+    {
+        return mPendingCount > 0;
+    }
+
+    /*
+     * Tells whether the oldest pending results may be retrieved without blocking.
+     */
+    bool AreResultsReady() const;
+
+    /*
+     * Copies the first pixels of the oldest pending results, waiting for the GPU
+     * if needed; returns false if there are no pending results.
+     */
+    bool Retrieve(
+        vec4f * destination,
+        size_t pixelCount);
+
+private:
+
+    size_t GetOldestPendingSlot() const
+    {
+        return (mNextSlot + mSlots.size() - mPendingCount) % mSlots.size();
+    }
+
+    static void DeleteFence(GLsync & fence);
+
+private:
+
+    struct Slot
+    {
+        GameOpenGLVBO PixelBuffer;
+        GLsync Fence; // NULL when not supported
+
+        Slot()
+            : PixelBuffer()
+            , Fence(NULL)
+        {}
+    };
+
+    ImageSize const mSize;
+
+    std::array<Slot, 2> mSlots;
+    size_t mNextSlot;
+    size_t mPendingCount;
+};
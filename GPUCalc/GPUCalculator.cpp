@@ -8,17 +8,29 @@
 #include <algorithm>
 
 GPUCalculator::GPUCalculator(
-    std::unique_ptr<IOpenGLContext> openGLContext,
-    std::filesystem::path const & shadersRootDirectory)
+    std::shared_ptr<IOpenGLContext> openGLContext,
+    std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager)
     : mOpenGLContext(std::move(openGLContext))
+    , mShaderManager(std::move(shaderManager))
+    , mVAO()
+    , mViewportSize(0, 0)
 {
-    ActivateOpenGLContext();
+    assert(!!mOpenGLContext);
+    assert(!!mShaderManager);
+
+    mOpenGLContext->Activate();
 
     //
-    // Initialize shader manager
+    // Create our VAO and leave it bound, so that it captures the vertex
+    // attributes that the calculator sets up next
     //
 
-    mShaderManager = ShaderManager<GPUCalcShaderManagerTraits>::CreateInstance(shadersRootDirectory);
+    GLuint tmpGLuint;
+    glGenVertexArrays(1, &tmpGLuint);
+    mVAO = tmpGLuint;
+
+    glBindVertexArray(*mVAO);
+    CheckOpenGLError();
 }
 
 ImageSize GPUCalculator::CalculateRequiredRenderBufferSize(size_t pixels)
@@ -41,6 +53,52 @@ ImageSize GPUCalculator::CalculateRequiredRenderBufferSize(size_t pixels)
     }
 }
 
+GameOpenGLTexture GPUCalculator::CreateFloatTexture(
+    GLenum textureUnit,
+    ImageSize const & size)
+{
+    glActiveTexture(textureUnit);
+    CheckOpenGLError();
+
+    GLuint tmpGLuint;
+    glGenTextures(1, &tmpGLuint);
+    GameOpenGLTexture texture(tmpGLuint);
+
+    glBindTexture(GL_TEXTURE_2D, *texture);
+    CheckOpenGLError();
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, size.Width, size.Height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    CheckOpenGLError();
+
+    // Make sure we don't do any fancy filtering
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    CheckOpenGLError();
+
+    return texture;
+}
+
+void GPUCalculator::UploadFloatTexture(
+    GLuint texture,
+    ImageSize const & size,
+    vec4f const * data)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+    CheckOpenGLError();
+
+    glTexSubImage2D(
+        GL_TEXTURE_2D,
+        0,                              // Level
+        0, 0,                           // X offset, Y offset
+        size.Width, size.Height,        // Width, Height
+        GL_RGBA, GL_FLOAT,
+        data);
+
+    CheckOpenGLError();
+}
+
 ImageSize GPUCalculator::CalculateRequiredTextureSize(size_t pixels)
 {
     assert(GameOpenGL::MaxTextureSize > 0);
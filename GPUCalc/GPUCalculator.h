@@ -8,33 +8,74 @@
 #include "IOpenGLContext.h"
 #include "ShaderTraits.h"
 
+#include <GameOpenGL/GameOpenGL.h>
 #include <GameOpenGL/ShaderManager.h>
 
 #include <GameCore/ImageSize.h>
+#include <GameCore/Vectors.h>
 
 #include <cassert>
-#include <filesystem>
 #include <memory>
 
 /*
  * Base class of task-specific calculators that perform calculations on the GPU.
+ *
+ * All calculators share the same OpenGL context and shader manager, hence a calculator
+ * may not rely on any state left in the context by its own previous calls - other
+ * than the state captured by its vertex array and its viewport, which are re-established
+ * at each activation - and must bind its own framebuffers, programs, and textures.
  */
 class GPUCalculator
 {
 protected:
 
     GPUCalculator(
-        std::unique_ptr<IOpenGLContext> openGLContext,
-        std::filesystem::path const & shadersRootDirectory);
+        std::shared_ptr<IOpenGLContext> openGLContext,
+        std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager);
 
     static ImageSize CalculateRequiredRenderBufferSize(size_t pixels);
     static ImageSize CalculateRequiredTextureSize(size_t pixels);
 
+    /*
+     * Creates a persistent RGBA32F texture on the specified texture unit, sampled
+     * with neither filtering nor wrapping.
+     */
+    static GameOpenGLTexture CreateFloatTexture(
+        GLenum textureUnit,
+        ImageSize const & size);
+
+    /*
+     * Uploads the whole texture, which must be bound to the active texture unit.
+     */
+    static void UploadFloatTexture(
+        GLuint texture,
+        ImageSize const & size,
+        vec4f const * data);
+
     void ActivateOpenGLContext()
     {
         assert(!!mOpenGLContext);
 
         mOpenGLContext->Activate();
+
+        glBindVertexArray(*mVAO);
+
+        if (mViewportSize.Width > 0)
+        {
+            glViewport(0, 0, mViewportSize.Width, mViewportSize.Height);
+        }
+    }
+
+    /*
+     * Sets the viewport of this calculator, which is then re-established at each
+     * activation of the context.
+     */
+    void SetViewportSize(ImageSize const & viewportSize)
+    {
+        mViewportSize = viewportSize;
+
+        glViewport(0, 0, mViewportSize.Width, mViewportSize.Height);
+        CheckOpenGLError();
     }
 
     ShaderManager<GPUCalcShaderManagerTraits> & GetShaderManager()
@@ -44,7 +85,12 @@ protected:
 
 private:
 
-    std::unique_ptr<IOpenGLContext> const mOpenGLContext;
+    std::shared_ptr<IOpenGLContext> const mOpenGLContext;
+
+    std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> const mShaderManager;
+
+    // Captures the vertex attributes set up by the calculator
+    GameOpenGLVAO mVAO;
 
-    std::unique_ptr<ShaderManager<GPUCalcShaderManagerTraits>> mShaderManager;
-};
\ No newline at end of file
+    ImageSize mViewportSize;
+};
@@ -20,28 +20,65 @@ void GPUCalculatorFactory::Initialize(
 
 std::unique_ptr<PixelCoordsGPUCalculator> GPUCalculatorFactory::CreatePixelCoordsCalculator(size_t dataPoints)
 {
-    CheckInitialized();
+    EnsureSharedContext();
 
     return std::unique_ptr<PixelCoordsGPUCalculator>(
         new PixelCoordsGPUCalculator(
-            mOpenGLContextFactory(),
-            mShadersRootDirectory,
+            mSharedOpenGLContext,
+            mSharedShaderManager,
             dataPoints));
 }
 
 std::unique_ptr<AddGPUCalculator> GPUCalculatorFactory::CreateAddCalculator(size_t dataPoints)
 {
-    CheckInitialized();
+    EnsureSharedContext();
 
     return std::unique_ptr<AddGPUCalculator>(
         new AddGPUCalculator(
-            mOpenGLContextFactory(),
-            mShadersRootDirectory,
+            mSharedOpenGLContext,
+            mSharedShaderManager,
             dataPoints));
 }
 
-void GPUCalculatorFactory::CheckInitialized()
+std::unique_ptr<WaterDiffusionGPUCalculator> GPUCalculatorFactory::CreateWaterDiffusionCalculator(size_t pointCount)
+{
+    EnsureSharedContext();
+
+    return std::unique_ptr<WaterDiffusionGPUCalculator>(
+        new WaterDiffusionGPUCalculator(
+            mSharedOpenGLContext,
+            mSharedShaderManager,
+            pointCount));
+}
+
+std::unique_ptr<MechanicalDynamicsGPUCalculator> GPUCalculatorFactory::CreateMechanicalDynamicsCalculator(
+    size_t pointCount,
+    size_t oceanFloorSampleCount)
+{
+    EnsureSharedContext();
+
+    return std::unique_ptr<MechanicalDynamicsGPUCalculator>(
+        new MechanicalDynamicsGPUCalculator(
+            mSharedOpenGLContext,
+            mSharedShaderManager,
+            pointCount,
+            oceanFloorSampleCount));
+}
+
+void GPUCalculatorFactory::EnsureSharedContext()
 {
     if (!mOpenGLContextFactory)
         throw GameException("GPU Calculator Factory's OpenGL Context Factory has not been initialized");
+
+    if (!mSharedOpenGLContext)
+    {
+        auto openGLContext = std::shared_ptr<IOpenGLContext>(mOpenGLContextFactory());
+
+        openGLContext->Activate();
+
+        mSharedShaderManager = std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>>(
+            ShaderManager<GPUCalcShaderManagerTraits>::CreateInstance(mShadersRootDirectory));
+
+        mSharedOpenGLContext = std::move(openGLContext);
+    }
 }
\ No newline at end of file
@@ -10,13 +10,21 @@
 #include "ShaderTraits.h"
 
 #include "AddGPUCalculator.h"
+#include "MechanicalDynamicsGPUCalculator.h"
 #include "PixelCoordsGPUCalculator.h"
+#include "WaterDiffusionGPUCalculator.h"
 
 #include <cassert>
 #include <filesystem>
 #include <functional>
 #include <memory>
 
+/*
+ * Creates GPU calculators, all sharing the same OpenGL context - hence the
+ * same programs - which is created with the first calculator.
+ *
+ * Calculators may then only be used by the thread that created the first of them.
+ */
 class GPUCalculatorFactory
 {
 public:
@@ -36,13 +44,29 @@ public:
 
     std::unique_ptr<AddGPUCalculator> CreateAddCalculator(size_t dataPoints);
 
+    std::unique_ptr<WaterDiffusionGPUCalculator> CreateWaterDiffusionCalculator(size_t pointCount);
+
+    std::unique_ptr<MechanicalDynamicsGPUCalculator> CreateMechanicalDynamicsCalculator(
+        size_t pointCount,
+        size_t oceanFloorSampleCount);
+
+    bool IsInitialized() const
+    {
+        return !!mOpenGLContextFactory;
+    }
+
 private:
 
     GPUCalculatorFactory()
     {}
 
-    void CheckInitialized();
+    void EnsureSharedContext();
 
     std::function<std::unique_ptr<IOpenGLContext>()> mOpenGLContextFactory;
     std::filesystem::path mShadersRootDirectory;
+
+    // The context and the shader manager shared by all calculators, created
+    // with the first calculator
+    std::shared_ptr<IOpenGLContext> mSharedOpenGLContext;
+    std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> mSharedShaderManager;
 };
\ No newline at end of file
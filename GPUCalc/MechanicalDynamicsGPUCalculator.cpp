@@ -0,0 +1,345 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-16
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "MechanicalDynamicsGPUCalculator.h"
+
+#include <GameOpenGL/GameOpenGL.h>
+
+#include <GameCore/GameException.h>
+#include <GameCore/Log.h>
+
+#include <algorithm>
+
+MechanicalDynamicsGPUCalculator::MechanicalDynamicsGPUCalculator(
+    std::shared_ptr<IOpenGLContext> openGLContext,
+    std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
+    size_t pointCount,
+    size_t oceanFloorSampleCount)
+    : GPUCalculator(
+        std::move(openGLContext),
+        std::move(shaderManager))
+    , mPointCount(pointCount)
+    , mOceanFloorSampleCount(oceanFloorSampleCount)
+    , mPointFrameSize(0, 0) // Temporary
+    , mAdjacencyTextureSize(0, 0) // Temporary
+    , mOceanFloorTextureSize(0, 0) // Temporary
+    , mPaddedPointCount(0) // Temporary
+    , mPointDynamicsBuffer()
+    , mPointAttributes0Buffer()
+    , mPointAttributes1Buffer()
+    , mAdjacencyBuffer()
+    , mOceanFloorBuffer()
+    , mPointDynamics()
+    , mPointDynamicsReadback()
+    , mPositionBuffer()
+    , mPositionBufferWriteFence(NULL)
+{
+    assert(pointCount > 0);
+    assert(oceanFloorSampleCount > 1);
+
+    GLuint tmpGLuint;
+
+    //
+    // Calculate geometry of buffers
+    //
+    // Same as the water diffusion: each point is one pixel of the point textures and of
+    // the framebuffers, and MaxSpringsPerPoint consecutive pixels of the adjacency texture,
+    // on the same row. The ocean floor is a single row, with four samples per pixel.
+    //
+
+    assert(GameOpenGL::MaxViewportWidth > 0 && GameOpenGL::MaxViewportHeight > 0);
+    assert(GameOpenGL::MaxTextureSize > 0);
+    assert(GameOpenGL::MaxRenderbufferSize > 0);
+
+    int const maxWidth = std::min(
+        std::min(GameOpenGL::MaxViewportWidth, GameOpenGL::MaxRenderbufferSize),
+        GameOpenGL::MaxTextureSize / static_cast<int>(MaxSpringsPerPoint));
+
+    int const width = std::min(maxWidth, static_cast<int>(pointCount));
+    int const height = (static_cast<int>(pointCount) + width - 1) / width;
+    if (height > GameOpenGL::MaxViewportHeight
+        || height > GameOpenGL::MaxTextureSize
+        || height > GameOpenGL::MaxRenderbufferSize)
+    {
+        throw GameException("Too many points for the GPU mechanical dynamics");
+    }
+
+    int const oceanFloorWidth = static_cast<int>((oceanFloorSampleCount + 3) / 4);
+    if (oceanFloorWidth > GameOpenGL::MaxTextureSize)
+    {
+        throw GameException("Too many ocean floor samples for the GPU mechanical dynamics");
+    }
+
+    mPointFrameSize = ImageSize(width, height);
+    mAdjacencyTextureSize = ImageSize(width * static_cast<int>(MaxSpringsPerPoint), height);
+    mOceanFloorTextureSize = ImageSize(oceanFloorWidth, 1);
+    mPaddedPointCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+
+    LogMessage(
+        "MechanicalDynamicsGPUCalculator: PointFrameSize=", mPointFrameSize.Width, "x", mPointFrameSize.Height,
+        ", AdjacencyTextureSize=", mAdjacencyTextureSize.Width, "x", mAdjacencyTextureSize.Height);
+
+
+    //
+    // Allocate staging buffers; padding points are frozen - their integration
+    // factor is zero - and have no springs
+    //
+
+    mPointDynamicsBuffer.reset(new vec4f[mPaddedPointCount]);
+    std::fill(mPointDynamicsBuffer.get(), mPointDynamicsBuffer.get() + mPaddedPointCount, vec4f::zero());
+
+    mPointAttributes0Buffer.reset(new vec4f[mPaddedPointCount]);
+    std::fill(mPointAttributes0Buffer.get(), mPointAttributes0Buffer.get() + mPaddedPointCount, vec4f::zero());
+
+    mPointAttributes1Buffer.reset(new vec4f[mPaddedPointCount]);
+    std::fill(mPointAttributes1Buffer.get(), mPointAttributes1Buffer.get() + mPaddedPointCount, vec4f::zero());
+
+    mAdjacencyBuffer.reset(new vec4f[mPaddedPointCount * MaxSpringsPerPoint]);
+    std::fill(
+        mAdjacencyBuffer.get(),
+        mAdjacencyBuffer.get() + mPaddedPointCount * MaxSpringsPerPoint,
+        vec4f(-1.0f, 1.0f, 0.0f, 0.0f));
+
+    mOceanFloorBuffer.reset(new vec4f[mOceanFloorTextureSize.Width]);
+    std::fill(mOceanFloorBuffer.get(), mOceanFloorBuffer.get() + mOceanFloorTextureSize.Width, vec4f::zero());
+
+
+    //
+    // Initialize this context
+    //
+
+    this->ActivateOpenGLContext();
+
+    // Set viewport size
+    SetViewportSize(mPointFrameSize);
+
+    // Set polygon mode
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    // Disable stenciling, blend, and depth test
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_STENCIL_TEST);
+
+
+    //
+    // Initialize program
+    //
+
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::MechanicalDynamics>();
+    GetShaderManager().SetTextureParameters<GPUCalcProgramType::MechanicalDynamics>();
+
+
+    //
+    // Prepare textures and framebuffers
+    //
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput0>();
+    mPointDynamics = std::make_unique<PingPongFramebuffer>(mPointFrameSize);
+
+    mPointAttributes0Texture = CreateFloatTexture(GL_TEXTURE1, mPointFrameSize);
+    mPointAttributes1Texture = CreateFloatTexture(GL_TEXTURE2, mPointFrameSize);
+    mAdjacencyTexture = CreateFloatTexture(GL_TEXTURE3, mAdjacencyTextureSize);
+    mOceanFloorTexture = CreateFloatTexture(GL_TEXTURE4, mOceanFloorTextureSize);
+
+    // The readback reads from the source framebuffer, i.e. the output of the last iteration
+    mPointDynamicsReadback = std::make_unique<AsyncPixelReadback>(mPointFrameSize);
+
+    // The positions for rendering, copied from the same framebuffer
+    glGenBuffers(1, &tmpGLuint);
+    mPositionBuffer = tmpGLuint;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, *mPositionBuffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, mPaddedPointCount * sizeof(vec2f), nullptr, GL_STREAM_COPY);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    CheckOpenGLError();
+
+
+    //
+    // Create VBO and populate it with whole NDC world
+    //
+
+    glGenBuffers(1, &tmpGLuint);
+    mVertexVBO = tmpGLuint;
+
+    // Bind VBO
+    glBindBuffer(GL_ARRAY_BUFFER, *mVertexVBO);
+    CheckOpenGLError();
+
+    // Initialize buffer; the program calculates its texture coordinates
+    // from the fragment coordinates
+    static vec2f quadVertices[6] = {
+        {-1.0f, -1.0f},
+        {-1.0f, 1.0f},
+        {1.0f, -1.0f},
+        {-1.0f, 1.0f},
+        {1.0f, -1.0f},
+        {1.0f, 1.0f}
+    };
+
+    // Upload buffer
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        2 * sizeof(float) * 6,
+        quadVertices,
+        GL_STATIC_DRAW);
+
+    // Describe vertex attribute
+    glVertexAttribPointer(
+        static_cast<GLuint>(GPUCalcVertexAttributeType::VertexShaderInput0),
+        2,
+        GL_FLOAT,
+        GL_FALSE,
+        2 * sizeof(float),
+        (void*)0);
+
+    // Enable vertex attribute
+    glEnableVertexAttribArray(static_cast<GLuint>(GPUCalcVertexAttributeType::VertexShaderInput0));
+}
+
+MechanicalDynamicsGPUCalculator::~MechanicalDynamicsGPUCalculator()
+{
+    if (NULL != mPositionBufferWriteFence)
+    {
+        this->ActivateOpenGLContext();
+
+        glDeleteSync(mPositionBufferWriteFence);
+    }
+}
+
+void MechanicalDynamicsGPUCalculator::Run(
+    int iterations,
+    Constants const & constants,
+    float oceanFloorMinX,
+    float oceanFloorDx,
+    bool doUploadPointDynamics,
+    bool doReadBackPointDynamics)
+{
+    assert(iterations > 0);
+
+    this->ActivateOpenGLContext();
+
+    //
+    // Upload everything - the point dynamics only if they're not the results of
+    // the previous run
+    //
+
+    if (doUploadPointDynamics)
+    {
+        GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput0>();
+        mPointDynamics->UploadSource(mPointDynamicsBuffer.get());
+    }
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput1>();
+    UploadFloatTexture(*mPointAttributes0Texture, mPointFrameSize, mPointAttributes0Buffer.get());
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput2>();
+    UploadFloatTexture(*mPointAttributes1Texture, mPointFrameSize, mPointAttributes1Buffer.get());
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput3>();
+    UploadFloatTexture(*mAdjacencyTexture, mAdjacencyTextureSize, mAdjacencyBuffer.get());
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput4>();
+    UploadFloatTexture(*mOceanFloorTexture, mOceanFloorTextureSize, mOceanFloorBuffer.get());
+
+
+    //
+    // Set parameters
+    //
+
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::MechanicalDynamics>();
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::MechanicalDynamics, GPUCalcProgramParameterType::PointTextureSize>(
+        static_cast<float>(mPointFrameSize.Width),
+        static_cast<float>(mPointFrameSize.Height));
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::MechanicalDynamics, GPUCalcProgramParameterType::AdjacencyTextureSize>(
+        static_cast<float>(mAdjacencyTextureSize.Width),
+        static_cast<float>(mAdjacencyTextureSize.Height));
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::MechanicalDynamics, GPUCalcProgramParameterType::OceanFloorGeometry>(
+        oceanFloorMinX,
+        oceanFloorDx,
+        static_cast<float>(mOceanFloorSampleCount));
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::MechanicalDynamics, GPUCalcProgramParameterType::Gravity>(
+        constants.Gravity.x,
+        constants.Gravity.y);
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::MechanicalDynamics, GPUCalcProgramParameterType::WindForce>(
+        constants.WindForce.x,
+        constants.WindForce.y);
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::MechanicalDynamics, GPUCalcProgramParameterType::MechanicalDynamicsCoefficients>(
+        constants.DeltaTime,
+        constants.GlobalDampCoefficient,
+        constants.WaterDragCoefficient,
+        constants.DensityAdjustedWaterMass);
+
+
+    //
+    // Iterate, each iteration sampling the output of the previous one
+    //
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput0>();
+
+    for (int iter = 0; iter < iterations; ++iter)
+    {
+        mPointDynamics->Bind();
+
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        CheckOpenGLError();
+
+        mPointDynamics->Swap();
+    }
+
+
+    //
+    // Copy the positions into the position buffer; the copy never leaves the GPU
+    //
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mPointDynamics->GetSourceFramebuffer());
+    CheckOpenGLError();
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, *mPositionBuffer);
+    glReadPixels(0, 0, mPointFrameSize.Width, mPointFrameSize.Height, GL_RG, GL_FLOAT, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    CheckOpenGLError();
+
+    // Other contexts only see our writes once they're complete
+    if (nullptr != glFenceSync)
+    {
+        if (NULL != mPositionBufferWriteFence)
+            glDeleteSync(mPositionBufferWriteFence);
+
+        mPositionBufferWriteFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        // Make sure the fence gets to the GPU before anyone waits for it
+        glFlush();
+    }
+    else
+    {
+        glFinish();
+    }
+
+    //
+    // Read back, if requested; the rest of the step needs the results right away,
+    // hence we wait
+    //
+
+    if (doReadBackPointDynamics)
+    {
+        ReadBackPointDynamics();
+    }
+}
+
+void MechanicalDynamicsGPUCalculator::ReadBackPointDynamics()
+{
+    this->ActivateOpenGLContext();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mPointDynamics->GetSourceFramebuffer());
+    CheckOpenGLError();
+
+    mPointDynamicsReadback->Start();
+
+    bool const hasResults = mPointDynamicsReadback->Retrieve(mPointDynamicsBuffer.get(), mPointCount);
+    assert(hasResults);
+    (void)hasResults;
+}
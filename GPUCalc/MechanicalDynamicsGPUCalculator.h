@@ -0,0 +1,177 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-16
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "AsyncPixelReadback.h"
+#include "GPUCalculator.h"
+#include "PingPongFramebuffer.h"
+
+#include <GameCore/Vectors.h>
+
+#include <memory>
+
+/*
+ * Calculator that runs all the mechanical dynamics iterations of a ship's step: spring
+ * forces, point forces, Verlet integration, and collisions with the sea floor.
+ *
+ * The caller populates the point dynamics, the point attributes, the adjacency, and
+ * the ocean floor, and then invokes Run(); at the end of the run the point dynamics
+ * buffer holds the new positions and velocities.
+ *
+ * Each iteration is a single pass over the points, in which each point gathers the
+ * forces of its own springs; the point dynamics ping-pong between two textures from
+ * one iteration to the next.
+ *
+ * The point dynamics may also stay on the GPU from one run to the next, in which case
+ * they are neither uploaded nor read back; after each run the positions are anyway
+ * copied - on the GPU - into a buffer object that rendering may source them from.
+ */
+class MechanicalDynamicsGPUCalculator : public GPUCalculator
+{
+public:
+
+    // The number of adjacency slots of each point
+    static constexpr size_t MaxSpringsPerPoint = 9;
+
+    struct Constants
+    {
+        vec2f Gravity;
+        vec2f WindForce;
+        float DeltaTime; // Of a single iteration
+        float GlobalDampCoefficient; // Of a single iteration
+        float WaterDragCoefficient;
+        float DensityAdjustedWaterMass;
+    };
+
+    size_t GetPointCount() const
+    {
+        return mPointCount;
+    }
+
+    size_t GetOceanFloorSampleCount() const
+    {
+        return mOceanFloorSampleCount;
+    }
+
+    /*
+     * Per point: position (x, y) and velocity (z, w); receives the results of Run().
+     */
+    vec4f * GetPointDynamicsBuffer()
+    {
+        return mPointDynamicsBuffer.get();
+    }
+
+    /*
+     * Per point: integration factor (x, y), total mass (z), and water volume fill (w).
+     */
+    vec4f * GetPointAttributes0Buffer()
+    {
+        return mPointAttributes0Buffer.get();
+    }
+
+    /*
+     * Per point: water height (x), ocean floor height (y) - the lowest float when collisions
+     * need no checking - and wind receptivity times the wind field multiplier (z); (w) is unused.
+     */
+    vec4f * GetPointAttributes1Buffer()
+    {
+        return mPointAttributes1Buffer.get();
+    }
+
+    /*
+     * Per point, MaxSpringsPerPoint slots: index of the other endpoint (x), or -1 when
+     * the slot is empty; spring's rest length (y); spring's stiffness (z) and damping (w)
+     * coefficients.
+     */
+    vec4f * GetAdjacencyBuffer()
+    {
+        return mAdjacencyBuffer.get();
+    }
+
+    /*
+     * The height of the ocean floor at (minX + i * dx), for each sample i; interpolated
+     * linearly in between.
+     */
+    float * GetOceanFloorBuffer()
+    {
+        // Four samples per texel
+        return reinterpret_cast<float *>(mOceanFloorBuffer.get());
+    }
+
+    /*
+     * When doUploadPointDynamics is false, the run continues from the point dynamics
+     * of the previous run rather than from the point dynamics buffer, which the caller
+     * needs not populate; when doReadBackPointDynamics is false, the point dynamics
+     * buffer is left as it is.
+     */
+    void Run(
+        int iterations,
+        Constants const & constants,
+        float oceanFloorMinX,
+        float oceanFloorDx,
+        bool doUploadPointDynamics,
+        bool doReadBackPointDynamics);
+
+    /*
+     * Reads back the results of the last run into the point dynamics buffer, waiting
+     * for the GPU.
+     */
+    void ReadBackPointDynamics();
+
+    /*
+     * The buffer object holding the positions - one vec2f per point - as of the last run;
+     * it may be used by any context that shares objects with ours, once it has waited
+     * - on the GPU - for the write fence, if any.
+     */
+    GLuint GetPositionBuffer() const
+    {
+        return *mPositionBuffer;
+    }
+
+    GLsync GetPositionBufferWriteFence() const
+    {
+        return mPositionBufferWriteFence;
+    }
+
+    ~MechanicalDynamicsGPUCalculator();
+
+private:
+
+    friend class GPUCalculatorFactory;
+
+    MechanicalDynamicsGPUCalculator(
+        std::shared_ptr<IOpenGLContext> openGLContext,
+        std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
+        size_t pointCount,
+        size_t oceanFloorSampleCount);
+
+private:
+
+    size_t const mPointCount;
+    size_t const mOceanFloorSampleCount;
+
+    ImageSize mPointFrameSize;
+    ImageSize mAdjacencyTextureSize;
+    ImageSize mOceanFloorTextureSize;
+    size_t mPaddedPointCount;
+
+    std::unique_ptr<vec4f[]> mPointDynamicsBuffer;
+    std::unique_ptr<vec4f[]> mPointAttributes0Buffer;
+    std::unique_ptr<vec4f[]> mPointAttributes1Buffer;
+    std::unique_ptr<vec4f[]> mAdjacencyBuffer;
+    std::unique_ptr<vec4f[]> mOceanFloorBuffer;
+
+    GameOpenGLVBO mVertexVBO;
+    std::unique_ptr<PingPongFramebuffer> mPointDynamics;
+    GameOpenGLTexture mPointAttributes0Texture;
+    GameOpenGLTexture mPointAttributes1Texture;
+    GameOpenGLTexture mAdjacencyTexture;
+    GameOpenGLTexture mOceanFloorTexture;
+    std::unique_ptr<AsyncPixelReadback> mPointDynamicsReadback;
+
+    GameOpenGLVBO mPositionBuffer;
+    GLsync mPositionBufferWriteFence; // NULL when not supported
+};
@@ -0,0 +1,85 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-15
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "PingPongFramebuffer.h"
+
+#include <GameCore/GameException.h>
+
+PingPongFramebuffer::PingPongFramebuffer(ImageSize const & size)
+    : mSize(size)
+    , mTextures()
+    , mFramebuffers()
+    , mSourceIndex(0)
+{
+    for (size_t i = 0; i < 2; ++i)
+    {
+        GLuint tmpGLuint;
+
+        //
+        // Texture
+        //
+
+        glGenTextures(1, &tmpGLuint);
+        mTextures[i] = tmpGLuint;
+
+        glBindTexture(GL_TEXTURE_2D, *mTextures[i]);
+        CheckOpenGLError();
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, mSize.Width, mSize.Height, 0, GL_RGBA, GL_FLOAT, nullptr);
+        CheckOpenGLError();
+
+        // Make sure we don't do any fancy filtering
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        CheckOpenGLError();
+
+        //
+        // Framebuffer
+        //
+
+        glGenFramebuffers(1, &tmpGLuint);
+        mFramebuffers[i] = tmpGLuint;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, *mFramebuffers[i]);
+        CheckOpenGLError();
+
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, *mTextures[i], 0);
+        CheckOpenGLError();
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            throw GameException("Ping-pong framebuffer is not complete");
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void PingPongFramebuffer::Bind() const
+{
+    glBindTexture(GL_TEXTURE_2D, GetSourceTexture());
+    CheckOpenGLError();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, GetTargetFramebuffer());
+    CheckOpenGLError();
+}
+
+void PingPongFramebuffer::UploadSource(vec4f const * data)
+{
+    glBindTexture(GL_TEXTURE_2D, GetSourceTexture());
+    CheckOpenGLError();
+
+    glTexSubImage2D(
+        GL_TEXTURE_2D,
+        0,                              // Level
+        0, 0,                           // X offset, Y offset
+        mSize.Width, mSize.Height,      // Width, Height
+        GL_RGBA, GL_FLOAT,
+        data);
+
+    CheckOpenGLError();
+}
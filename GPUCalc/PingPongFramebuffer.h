@@ -0,0 +1,83 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-15
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameOpenGL/GameOpenGL.h>
+
+#include <GameCore/ImageSize.h>
+#include <GameCore/Vectors.h>
+
+#include <array>
+
+/*
+ * A pair of persistent RGBA32F textures, each the color attachment of its own
+ * framebuffer, for kernels that iterate over their own output: each iteration
+ * samples the source texture and renders into the target framebuffer, and then
+ * Swap()'s them, so that the output of an iteration is the input of the next.
+ *
+ * Must be used with the context active that it was created with.
+ */
+class PingPongFramebuffer
+{
+public:
+
+    explicit PingPongFramebuffer(ImageSize const & size);
+
+    ImageSize const & GetSize() const
+    {
+        return mSize;
+    }
+
+    /*
+     * The texture holding the output of the last iteration - or the initial contents.
+     */
+    GLuint GetSourceTexture() const
+    {
+        return *mTextures[mSourceIndex];
+    }
+
+    /*
+     * The framebuffer rendering into the source texture, for reading back the output
+     * of the last iteration.
+     */
+    GLuint GetSourceFramebuffer() const
+    {
+        return *mFramebuffers[mSourceIndex];
+    }
+
+    /*
+     * The framebuffer rendering into the texture that is not the source.
+     */
+    GLuint GetTargetFramebuffer() const
+    {
+        return *mFramebuffers[1 - mSourceIndex];
+    }
+
+    /*
+     * Binds the source texture to the active texture unit and the target
+     * framebuffer.
+     */
+    void Bind() const;
+
+    /*
+     * Uploads the initial contents into the source texture, via the active texture unit.
+     */
+    void UploadSource(vec4f const * data);
+
+    void Swap()
+    {
+        mSourceIndex = 1 - mSourceIndex;
+    }
+
+private:
+
+    ImageSize const mSize;
+
+    std::array<GameOpenGLTexture, 2> mTextures;
+    std::array<GameOpenGLFramebuffer, 2> mFramebuffers;
+
+    size_t mSourceIndex;
+};
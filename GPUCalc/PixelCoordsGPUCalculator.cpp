@@ -10,12 +10,12 @@
 #include <GameCore/Log.h>
 
 PixelCoordsGPUCalculator::PixelCoordsGPUCalculator(
-    std::unique_ptr<IOpenGLContext> openGLContext,
-    std::filesystem::path const & shadersRootDirectory,
+    std::shared_ptr<IOpenGLContext> openGLContext,
+    std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
     size_t dataPoints)
     : GPUCalculator(
         std::move(openGLContext),
-        shadersRootDirectory)
+        std::move(shaderManager))
     , mDataPoints(dataPoints)
     , mFrameSize(CalculateRequiredRenderBufferSize(dataPoints))
 {
@@ -31,8 +31,7 @@ PixelCoordsGPUCalculator::PixelCoordsGPUCalculator(
     this->ActivateOpenGLContext();
 
     // Set viewport size
-    glViewport(0, 0, mFrameSize.Width, mFrameSize.Height);
-    CheckOpenGLError();
+    SetViewportSize(mFrameSize);
 
     // Set polygon mode
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -141,6 +140,12 @@ void PixelCoordsGPUCalculator::Run(vec4f * result)
 
     this->ActivateOpenGLContext();
 
+    // The context is shared with other calculators
+    glBindFramebuffer(GL_FRAMEBUFFER, *mFramebuffer);
+    CheckOpenGLError();
+
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::PixelCoords>();
+
     //
     // Draw
     //
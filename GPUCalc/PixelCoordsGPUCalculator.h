@@ -9,7 +9,6 @@
 
 #include <GameCore/Vectors.h>
 
-#include <filesystem>
 
 /*
  * Simple calculator that outputs the fragment coordinates passed to the fragment shader.
@@ -32,8 +31,8 @@ private:
     friend class GPUCalculatorFactory;
 
     PixelCoordsGPUCalculator(
-        std::unique_ptr<IOpenGLContext> openGLContext,
-        std::filesystem::path const & shadersRootDirectory,
+        std::shared_ptr<IOpenGLContext> openGLContext,
+        std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
         size_t dataPoints);
 
 private:
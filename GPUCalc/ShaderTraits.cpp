@@ -17,6 +17,12 @@ GPUCalcProgramType ShaderFilenameToGPUCalcProgramType(std::string const & str)
         return GPUCalcProgramType::PixelCoords;
     else if (lstr == "add")
         return GPUCalcProgramType::Add;
+    else if (lstr == "water_diffusion_normalization")
+        return GPUCalcProgramType::WaterDiffusionNormalization;
+    else if (lstr == "water_diffusion")
+        return GPUCalcProgramType::WaterDiffusion;
+    else if (lstr == "mechanical_dynamics")
+        return GPUCalcProgramType::MechanicalDynamics;
     else
         throw GameException("Unrecognized program \"" + str + "\"");
 }
@@ -29,6 +35,12 @@ std::string GPUCalcProgramTypeToStr(GPUCalcProgramType program)
             return "PixelCoords";
         case GPUCalcProgramType::Add:
             return "Add";
+        case GPUCalcProgramType::WaterDiffusionNormalization:
+            return "WaterDiffusionNormalization";
+        case GPUCalcProgramType::WaterDiffusion:
+            return "WaterDiffusion";
+        case GPUCalcProgramType::MechanicalDynamics:
+            return "MechanicalDynamics";
         default:
             assert(false);
             throw GameException("Unsupported GPUCalcProgramType");
@@ -41,6 +53,28 @@ GPUCalcProgramParameterType StrToGPUCalcProgramParameterType(std::string const &
         return GPUCalcProgramParameterType::TextureInput0;
     else if (str == "TextureInput1")
         return GPUCalcProgramParameterType::TextureInput1;
+    else if (str == "TextureInput2")
+        return GPUCalcProgramParameterType::TextureInput2;
+    else if (str == "TextureInput3")
+        return GPUCalcProgramParameterType::TextureInput3;
+    else if (str == "TextureInput4")
+        return GPUCalcProgramParameterType::TextureInput4;
+    else if (str == "AdjacencyTextureSize")
+        return GPUCalcProgramParameterType::AdjacencyTextureSize;
+    else if (str == "Gravity")
+        return GPUCalcProgramParameterType::Gravity;
+    else if (str == "GravityMagnitude")
+        return GPUCalcProgramParameterType::GravityMagnitude;
+    else if (str == "MechanicalDynamicsCoefficients")
+        return GPUCalcProgramParameterType::MechanicalDynamicsCoefficients;
+    else if (str == "OceanFloorGeometry")
+        return GPUCalcProgramParameterType::OceanFloorGeometry;
+    else if (str == "PointTextureSize")
+        return GPUCalcProgramParameterType::PointTextureSize;
+    else if (str == "WaterCrazyness")
+        return GPUCalcProgramParameterType::WaterCrazyness;
+    else if (str == "WindForce")
+        return GPUCalcProgramParameterType::WindForce;
     else
         throw GameException("Unrecognized program parameter \"" + str + "\"");
 }
@@ -53,6 +87,28 @@ std::string GPUCalcProgramParameterTypeToStr(GPUCalcProgramParameterType program
             return "TextureInput0";
         case GPUCalcProgramParameterType::TextureInput1:
             return "TextureInput1";
+        case GPUCalcProgramParameterType::TextureInput2:
+            return "TextureInput2";
+        case GPUCalcProgramParameterType::TextureInput3:
+            return "TextureInput3";
+        case GPUCalcProgramParameterType::TextureInput4:
+            return "TextureInput4";
+        case GPUCalcProgramParameterType::AdjacencyTextureSize:
+            return "AdjacencyTextureSize";
+        case GPUCalcProgramParameterType::Gravity:
+            return "Gravity";
+        case GPUCalcProgramParameterType::GravityMagnitude:
+            return "GravityMagnitude";
+        case GPUCalcProgramParameterType::MechanicalDynamicsCoefficients:
+            return "MechanicalDynamicsCoefficients";
+        case GPUCalcProgramParameterType::OceanFloorGeometry:
+            return "OceanFloorGeometry";
+        case GPUCalcProgramParameterType::PointTextureSize:
+            return "PointTextureSize";
+        case GPUCalcProgramParameterType::WaterCrazyness:
+            return "WaterCrazyness";
+        case GPUCalcProgramParameterType::WindForce:
+            return "WindForce";
         default:
             assert(false);
             throw GameException("Unsupported GPUCalcProgramParameterType");
@@ -14,8 +14,11 @@ enum class GPUCalcProgramType
 {
     PixelCoords = 0,
     Add = 1,
+    WaterDiffusionNormalization = 2,
+    WaterDiffusion = 3,
+    MechanicalDynamics = 4,
 
-    _Last = Add
+    _Last = MechanicalDynamics
 };
 
 GPUCalcProgramType ShaderFilenameToGPUCalcProgramType(std::string const & str);
@@ -27,9 +30,22 @@ enum class GPUCalcProgramParameterType : uint8_t
     // Textures
     TextureInput0,                  // 0
     TextureInput1,                  // 1
+    TextureInput2,                  // 2
+    TextureInput3,                  // 3
+    TextureInput4,                  // 4
+
+    // Other parameters
+    AdjacencyTextureSize,
+    Gravity,
+    GravityMagnitude,
+    MechanicalDynamicsCoefficients,
+    OceanFloorGeometry,
+    PointTextureSize,
+    WaterCrazyness,
+    WindForce,
 
     _FirstTexture = TextureInput0,
-    _LastTexture = TextureInput1
+    _LastTexture = TextureInput4
 };
 
 GPUCalcProgramParameterType StrToGPUCalcProgramParameterType(std::string const & str);
@@ -0,0 +1,347 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-20
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "WaterDiffusionGPUCalculator.h"
+
+#include <GameOpenGL/GameOpenGL.h>
+
+#include <GameCore/GameException.h>
+#include <GameCore/Log.h>
+
+#include <algorithm>
+
+WaterDiffusionGPUCalculator::WaterDiffusionGPUCalculator(
+    std::shared_ptr<IOpenGLContext> openGLContext,
+    std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
+    size_t pointCount)
+    : GPUCalculator(
+        std::move(openGLContext),
+        std::move(shaderManager))
+    , mPointCount(pointCount)
+    , mPointFrameSize(0, 0) // Temporary
+    , mAdjacencyTextureSize(0, 0) // Temporary
+    , mPaddedPointCount(0) // Temporary
+    , mPointAttributes0Buffer()
+    , mPointAttributes1Buffer()
+    , mAdjacencyBuffer()
+    , mResultsBuffer()
+    , mResultsReadback()
+    , mIsAdjacencyUploaded(false)
+{
+    assert(pointCount > 0);
+
+    GLuint tmpGLuint;
+
+    //
+    // Calculate geometry of buffers
+    //
+    // Each point is one pixel of the point textures and of the render buffers, and
+    // MaxSpringsPerPoint consecutive pixels of the adjacency texture - on the same row.
+    // In this way, the linear index of a point's adjacency slot is simply
+    // (point index * MaxSpringsPerPoint + slot).
+    //
+
+    assert(GameOpenGL::MaxViewportWidth > 0 && GameOpenGL::MaxViewportHeight > 0);
+    assert(GameOpenGL::MaxTextureSize > 0);
+    assert(GameOpenGL::MaxRenderbufferSize > 0);
+
+    int const maxWidth = std::min(
+        std::min(GameOpenGL::MaxViewportWidth, GameOpenGL::MaxRenderbufferSize),
+        GameOpenGL::MaxTextureSize / static_cast<int>(MaxSpringsPerPoint));
+
+    int const width = std::min(maxWidth, static_cast<int>(pointCount));
+    int const height = (static_cast<int>(pointCount) + width - 1) / width;
+    if (height > GameOpenGL::MaxViewportHeight
+        || height > GameOpenGL::MaxTextureSize
+        || height > GameOpenGL::MaxRenderbufferSize)
+    {
+        throw GameException("Too many points for the GPU water diffusion");
+    }
+
+    mPointFrameSize = ImageSize(width, height);
+    mAdjacencyTextureSize = ImageSize(width * static_cast<int>(MaxSpringsPerPoint), height);
+    mPaddedPointCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+
+    LogMessage(
+        "WaterDiffusionGPUCalculator: PointFrameSize=", mPointFrameSize.Width, "x", mPointFrameSize.Height,
+        ", AdjacencyTextureSize=", mAdjacencyTextureSize.Width, "x", mAdjacencyTextureSize.Height);
+
+
+    //
+    // Allocate staging buffers; padding points are dry and have no springs
+    //
+
+    mPointAttributes0Buffer.reset(new vec4f[mPaddedPointCount]);
+    std::fill(mPointAttributes0Buffer.get(), mPointAttributes0Buffer.get() + mPaddedPointCount, vec4f::zero());
+
+    mPointAttributes1Buffer.reset(new vec4f[mPaddedPointCount]);
+    std::fill(mPointAttributes1Buffer.get(), mPointAttributes1Buffer.get() + mPaddedPointCount, vec4f::zero());
+
+    mAdjacencyBuffer.reset(new vec4f[mPaddedPointCount * MaxSpringsPerPoint]);
+    std::fill(
+        mAdjacencyBuffer.get(),
+        mAdjacencyBuffer.get() + mPaddedPointCount * MaxSpringsPerPoint,
+        vec4f(-1.0f, 1.0f, 0.0f, 0.0f));
+
+    mResultsBuffer.reset(new vec4f[mPointCount]);
+
+
+    //
+    // Initialize this context
+    //
+
+    this->ActivateOpenGLContext();
+
+    // Set viewport size
+    SetViewportSize(mPointFrameSize);
+
+    // Set polygon mode
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    // Disable stenciling, blend, and depth test
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_STENCIL_TEST);
+
+
+    //
+    // Initialize programs
+    //
+
+    // The sizes are set at each run, as the programs are shared with the
+    // calculators of the other ships
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::WaterDiffusionNormalization>();
+    GetShaderManager().SetTextureParameters<GPUCalcProgramType::WaterDiffusionNormalization>();
+
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::WaterDiffusion>();
+    GetShaderManager().SetTextureParameters<GPUCalcProgramType::WaterDiffusion>();
+
+
+    //
+    // Prepare textures
+    //
+
+    mPointAttributes0Texture = CreateFloatTexture(GL_TEXTURE0, mPointFrameSize);
+    mPointAttributes1Texture = CreateFloatTexture(GL_TEXTURE1, mPointFrameSize);
+    mAdjacencyTexture = CreateFloatTexture(GL_TEXTURE2, mAdjacencyTextureSize);
+    mNormalizationFactorsTexture = CreateFloatTexture(GL_TEXTURE3, mPointFrameSize);
+
+
+    //
+    // Create framebuffer for the normalization factors, rendering into the texture
+    //
+
+    glGenFramebuffers(1, &tmpGLuint);
+    mNormalizationFactorsFramebuffer = tmpGLuint;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, *mNormalizationFactorsFramebuffer);
+    CheckOpenGLError();
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, *mNormalizationFactorsTexture, 0);
+    CheckOpenGLError();
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        throw GameException("Normalization factors framebuffer is not complete");
+    }
+
+
+    //
+    // Create framebuffer for the results, rendering into a render buffer
+    //
+
+    glGenFramebuffers(1, &tmpGLuint);
+    mResultsFramebuffer = tmpGLuint;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, *mResultsFramebuffer);
+    CheckOpenGLError();
+
+    glGenRenderbuffers(1, &tmpGLuint);
+    mResultsRenderbuffer = tmpGLuint;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, *mResultsRenderbuffer);
+    CheckOpenGLError();
+
+    // Allocate render buffer with 32-bit float RGBA format
+    glRenderbufferStorage(
+        GL_RENDERBUFFER,
+        GL_RGBA32F,
+        mPointFrameSize.Width,
+        mPointFrameSize.Height);
+    CheckOpenGLError();
+
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, *mResultsRenderbuffer);
+    CheckOpenGLError();
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        throw GameException("Results framebuffer is not complete");
+    }
+
+
+    //
+    // Create the readback of the results
+    //
+
+    mResultsReadback = std::make_unique<AsyncPixelReadback>(mPointFrameSize);
+
+
+    //
+    // Create VBO and populate it with whole NDC world
+    //
+
+    glGenBuffers(1, &tmpGLuint);
+    mVertexVBO = tmpGLuint;
+
+    // Bind VBO
+    glBindBuffer(GL_ARRAY_BUFFER, *mVertexVBO);
+    CheckOpenGLError();
+
+    // Initialize buffer; both programs calculate their texture coordinates
+    // from the fragment coordinates
+    static vec2f quadVertices[6] = {
+        {-1.0f, -1.0f},
+        {-1.0f, 1.0f},
+        {1.0f, -1.0f},
+        {-1.0f, 1.0f},
+        {1.0f, -1.0f},
+        {1.0f, 1.0f}
+    };
+
+    // Upload buffer
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        2 * sizeof(float) * 6,
+        quadVertices,
+        GL_STATIC_DRAW);
+
+    // Describe vertex attribute
+    glVertexAttribPointer(
+        static_cast<GLuint>(GPUCalcVertexAttributeType::VertexShaderInput0),
+        2,
+        GL_FLOAT,
+        GL_FALSE,
+        2 * sizeof(float),
+        (void*)0);
+
+    // Enable vertex attribute
+    glEnableVertexAttribArray(static_cast<GLuint>(GPUCalcVertexAttributeType::VertexShaderInput0));
+}
+
+void WaterDiffusionGPUCalculator::UploadAdjacency()
+{
+    this->ActivateOpenGLContext();
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput2>();
+
+    UploadFloatTexture(
+        *mAdjacencyTexture,
+        mAdjacencyTextureSize,
+        mAdjacencyBuffer.get());
+
+    mIsAdjacencyUploaded = true;
+}
+
+void WaterDiffusionGPUCalculator::Run(
+    float gravityMagnitude,
+    float waterCrazyness)
+{
+    assert(mIsAdjacencyUploaded);
+
+    this->ActivateOpenGLContext();
+
+    //
+    // Upload point attributes
+    //
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput0>();
+
+    UploadFloatTexture(
+        *mPointAttributes0Texture,
+        mPointFrameSize,
+        mPointAttributes0Buffer.get());
+
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput1>();
+
+    UploadFloatTexture(
+        *mPointAttributes1Texture,
+        mPointFrameSize,
+        mPointAttributes1Buffer.get());
+
+    // Other calculators may have used these units in the meantime
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput2>();
+    glBindTexture(GL_TEXTURE_2D, *mAdjacencyTexture);
+    GetShaderManager().ActivateTexture<GPUCalcProgramParameterType::TextureInput3>();
+    glBindTexture(GL_TEXTURE_2D, *mNormalizationFactorsTexture);
+    CheckOpenGLError();
+
+
+    //
+    // Pass 1: normalization factors
+    //
+    // The normalization factors texture is also bound to unit 3, which is only sampled
+    // by the second pass
+    //
+
+    glBindFramebuffer(GL_FRAMEBUFFER, *mNormalizationFactorsFramebuffer);
+    CheckOpenGLError();
+
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::WaterDiffusionNormalization>();
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusionNormalization, GPUCalcProgramParameterType::PointTextureSize>(
+        static_cast<float>(mPointFrameSize.Width),
+        static_cast<float>(mPointFrameSize.Height));
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusionNormalization, GPUCalcProgramParameterType::AdjacencyTextureSize>(
+        static_cast<float>(mAdjacencyTextureSize.Width),
+        static_cast<float>(mAdjacencyTextureSize.Height));
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusionNormalization, GPUCalcProgramParameterType::GravityMagnitude>(
+        gravityMagnitude);
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusionNormalization, GPUCalcProgramParameterType::WaterCrazyness>(
+        waterCrazyness);
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    CheckOpenGLError();
+
+
+    //
+    // Pass 2: water and momenta
+    //
+
+    glBindFramebuffer(GL_FRAMEBUFFER, *mResultsFramebuffer);
+    CheckOpenGLError();
+
+    GetShaderManager().ActivateProgram<GPUCalcProgramType::WaterDiffusion>();
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusion, GPUCalcProgramParameterType::PointTextureSize>(
+        static_cast<float>(mPointFrameSize.Width),
+        static_cast<float>(mPointFrameSize.Height));
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusion, GPUCalcProgramParameterType::AdjacencyTextureSize>(
+        static_cast<float>(mAdjacencyTextureSize.Width),
+        static_cast<float>(mAdjacencyTextureSize.Height));
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusion, GPUCalcProgramParameterType::GravityMagnitude>(
+        gravityMagnitude);
+    GetShaderManager().SetProgramParameter<GPUCalcProgramType::WaterDiffusion, GPUCalcProgramParameterType::WaterCrazyness>(
+        waterCrazyness);
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    CheckOpenGLError();
+
+
+    //
+    // Start reading back; this returns immediately, and the transfer completes
+    // while the CPU is busy with the rest of the simulation
+    //
+
+    mResultsReadback->Start();
+}
+
+bool WaterDiffusionGPUCalculator::RetrieveResults()
+{
+    if (!mResultsReadback->HasPendingResults())
+        return false;
+
+    this->ActivateOpenGLContext();
+
+    return mResultsReadback->Retrieve(mResultsBuffer.get(), mPointCount);
+}
@@ -0,0 +1,116 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-20
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "AsyncPixelReadback.h"
+#include "GPUCalculator.h"
+
+#include <GameCore/Vectors.h>
+
+#include <memory>
+
+/*
+ * Calculator that runs one step of the momentum-based water diffusion of a ship.
+ *
+ * The caller populates the point attributes and the adjacency - the latter only when
+ * the ship's structure changes - and then invokes Run(); the results of a run are
+ * read back asynchronously, and are only retrieved at the following RetrieveResults(),
+ * which the caller is expected to invoke one simulation step later.
+ */
+class WaterDiffusionGPUCalculator : public GPUCalculator
+{
+public:
+
+    // The number of adjacency slots of each point
+    static constexpr size_t MaxSpringsPerPoint = 9;
+
+    size_t GetPointCount() const
+    {
+        return mPointCount;
+    }
+
+    /*
+     * Per point: position (x, y), water (z), and fraction of water that diffuses
+     * during this step (w).
+     */
+    vec4f * GetPointAttributes0Buffer()
+    {
+        return mPointAttributes0Buffer.get();
+    }
+
+    /*
+     * Per point: water velocity (x, y); (z, w) are unused.
+     */
+    vec4f * GetPointAttributes1Buffer()
+    {
+        return mPointAttributes1Buffer.get();
+    }
+
+    /*
+     * Per point, MaxSpringsPerPoint slots: index of the other endpoint (x), or -1 when
+     * the slot is empty; spring's rest length (y); spring's water permeability (z);
+     * (w) is unused.
+     */
+    vec4f * GetAdjacencyBuffer()
+    {
+        return mAdjacencyBuffer.get();
+    }
+
+    void UploadAdjacency();
+
+    void Run(
+        float gravityMagnitude,
+        float waterCrazyness);
+
+    /*
+     * Retrieves the results of the last run into the results buffer, if there's
+     * been a run since the last retrieval, returning false otherwise.
+     */
+    bool RetrieveResults();
+
+    /*
+     * Per point: new water (x), new water momentum (y, z), and water splashed at
+     * the point (w).
+     */
+    vec4f const * GetResultsBuffer() const
+    {
+        return mResultsBuffer.get();
+    }
+
+private:
+
+    friend class GPUCalculatorFactory;
+
+    WaterDiffusionGPUCalculator(
+        std::shared_ptr<IOpenGLContext> openGLContext,
+        std::shared_ptr<ShaderManager<GPUCalcShaderManagerTraits>> shaderManager,
+        size_t pointCount);
+
+private:
+
+    size_t const mPointCount;
+
+    ImageSize mPointFrameSize;
+    ImageSize mAdjacencyTextureSize;
+    size_t mPaddedPointCount;
+
+    std::unique_ptr<vec4f[]> mPointAttributes0Buffer;
+    std::unique_ptr<vec4f[]> mPointAttributes1Buffer;
+    std::unique_ptr<vec4f[]> mAdjacencyBuffer;
+    std::unique_ptr<vec4f[]> mResultsBuffer;
+
+    GameOpenGLVBO mVertexVBO;
+    GameOpenGLTexture mPointAttributes0Texture;
+    GameOpenGLTexture mPointAttributes1Texture;
+    GameOpenGLTexture mAdjacencyTexture;
+    GameOpenGLTexture mNormalizationFactorsTexture;
+    GameOpenGLFramebuffer mNormalizationFactorsFramebuffer;
+    GameOpenGLFramebuffer mResultsFramebuffer;
+    GameOpenGLRenderbuffer mResultsRenderbuffer;
+    std::unique_ptr<AsyncPixelReadback> mResultsReadback;
+
+    bool mIsAdjacencyUploaded;
+};
@@ -5,8 +5,14 @@
  ***************************************************************************************/
 #include "AddTest.h"
 
+#include "BenchmarkReport.h"
+
 #include <GPUCalc/GPUCalculatorFactory.h>
 
+#include <GameCore/SysSpecifics.h>
+
+#include <algorithm>
+#include <chrono>
 #include <vector>
 
 void AddTest::InternalRun()
@@ -61,4 +67,137 @@ void AddTest::InternalRun()
     }
 
     LogMessage("MaxDelta=", maxDelta);
-}
\ No newline at end of file
+}
+void AddBenchmark::InternalRun()
+{
+    // The width at which the calculator splits its frame into rows, in data points
+    int const maxWidth = std::min(
+        std::min(GameOpenGL::MaxViewportWidth, GameOpenGL::MaxTextureSize),
+        GameOpenGL::MaxRenderbufferSize);
+    size_t const rowDataPoints = static_cast<size_t>(maxWidth) * 2;
+
+    std::vector<size_t> dataPointCounts = {
+        1024,
+        16384,
+        65536,
+        262144,
+        1048576,
+        4194304,
+        rowDataPoints,
+        rowDataPoints * 3 + 2
+    };
+
+    std::sort(dataPointCounts.begin(), dataPointCounts.end());
+    dataPointCounts.erase(std::unique(dataPointCounts.begin(), dataPointCounts.end()), dataPointCounts.end());
+
+    BenchmarkReport::LogHeader();
+
+    for (size_t dataPoints : dataPointCounts)
+    {
+        RunSize(dataPoints);
+    }
+}
+
+void AddBenchmark::RunSize(size_t dataPoints)
+{
+    static constexpr size_t Repetitions = 20;
+
+    auto calculator = GPUCalculatorFactory::GetInstance().CreateAddCalculator(dataPoints);
+
+    //
+    // Create inputs and outputs
+    //
+
+    size_t const roundedUpDataPoints = dataPoints + ((dataPoints % 2) ? 1 : 0);
+
+    std::vector<vec2f> a(roundedUpDataPoints, vec2f::zero());
+    std::vector<vec2f> b(roundedUpDataPoints, vec2f::zero());
+
+    for (size_t i = 0; i < dataPoints; ++i)
+    {
+        a[i] = vec2f(static_cast<float>(i % 1000), 1.0f);
+        b[i] = vec2f(2.0f, static_cast<float>(i % 100));
+    }
+
+    std::vector<vec2f> results(roundedUpDataPoints, vec2f::zero());
+
+    //
+    // Warm up, and make sure we're measuring something that works
+    //
+
+    calculator->Run(a.data(), b.data(), results.data());
+
+    TEST_VERIFY_FLOAT_EQ(results[0].x, (a[0] + b[0]).x);
+    TEST_VERIFY_FLOAT_EQ(results[dataPoints - 1].x, (a[dataPoints - 1] + b[dataPoints - 1]).x);
+    TEST_VERIFY_FLOAT_EQ(results[dataPoints - 1].y, (a[dataPoints - 1] + b[dataPoints - 1]).y);
+
+    //
+    // GPU, one phase at a time; we wait for the GPU at the end of each phase,
+    // hence these are latencies
+    //
+
+    BenchmarkSamples uploadSamples;
+    BenchmarkSamples dispatchSamples;
+    BenchmarkSamples readbackSamples;
+    BenchmarkSamples roundTripSamples;
+
+    for (size_t r = 0; r < Repetitions; ++r)
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+
+        calculator->Upload(a.data(), b.data());
+        glFinish();
+
+        auto const uploadEndTime = std::chrono::steady_clock::now();
+
+        calculator->Dispatch();
+        glFinish();
+
+        auto const dispatchEndTime = std::chrono::steady_clock::now();
+
+        calculator->Readback(results.data());
+
+        auto const endTime = std::chrono::steady_clock::now();
+
+        uploadSamples.Add(uploadEndTime - startTime);
+        dispatchSamples.Add(dispatchEndTime - uploadEndTime);
+        readbackSamples.Add(endTime - dispatchEndTime);
+        roundTripSamples.Add(endTime - startTime);
+    }
+
+    //
+    // CPU
+    //
+
+    BenchmarkSamples cpuSamples;
+
+    for (size_t r = 0; r < Repetitions; ++r)
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+
+        vec2f const * const restrict aData = a.data();
+        vec2f const * const restrict bData = b.data();
+        vec2f * const restrict resultsData = results.data();
+        for (size_t i = 0; i < dataPoints; ++i)
+        {
+            resultsData[i] = aData[i] + bData[i];
+        }
+
+        cpuSamples.Add(std::chrono::steady_clock::now() - startTime);
+    }
+
+    TEST_VERIFY_FLOAT_EQ(results[dataPoints - 1].x, (a[dataPoints - 1] + b[dataPoints - 1]).x);
+
+    //
+    // Report
+    //
+
+    ImageSize const & frameSize = calculator->GetFrameSize();
+    LogMessage("AddBenchmark: ", dataPoints, " points, frame ", frameSize.Width, "x", frameSize.Height);
+
+    BenchmarkReport::LogTransfer("Add", dataPoints, "upload", uploadSamples, 2 * dataPoints * sizeof(vec2f));
+    BenchmarkReport::LogCalculation("Add", dataPoints, "dispatch", dispatchSamples);
+    BenchmarkReport::LogTransfer("Add", dataPoints, "readback", readbackSamples, dataPoints * sizeof(vec2f));
+    BenchmarkReport::LogCalculation("Add", dataPoints, "gpu_round_trip", roundTripSamples);
+    BenchmarkReport::LogCalculation("Add", dataPoints, "cpu", cpuSamples);
+}
@@ -26,3 +26,28 @@ private:
 
     size_t const mDataPoints;
 };
+
+/*
+ * Measures the latency and the throughput of each phase of the add calculator - upload,
+ * dispatch, and readback - across data sizes, together with the same calculation on the
+ * CPU, and logs the results as CSV.
+ *
+ * The sizes include a whole row and a few rows and a bit of the frame, so that the
+ * splitting of the transfers into whole rows and remainder is measured as well.
+ */
+class AddBenchmark : public TestCase
+{
+public:
+
+    AddBenchmark()
+        : TestCase("AddBenchmark")
+    {}
+
+protected:
+
+    virtual void InternalRun() override;
+
+private:
+
+    void RunSize(size_t dataPoints);
+};
@@ -0,0 +1,122 @@
+/***************************************************************************************
+ * Original Author:     Gabriele Giuseppini
+ * Created:             2019-06-18
+ * Copyright:           Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#pragma once
+
+#include <GameCore/Log.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <vector>
+
+static constexpr char BenchmarkCsvPrefix[] = "BENCHMARK_CSV: ";
+
+/*
+ * The timings of a number of repetitions of the same phase.
+ */
+class BenchmarkSamples
+{
+public:
+
+    void Add(std::chrono::steady_clock::duration duration)
+    {
+        mMilliseconds.push_back(std::chrono::duration<float, std::milli>(duration).count());
+    }
+
+    float GetMedianMilliseconds() const
+    {
+        assert(!mMilliseconds.empty());
+
+        std::vector<float> sorted = mMilliseconds;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[sorted.size() / 2];
+    }
+
+    float GetMinMilliseconds() const
+    {
+        assert(!mMilliseconds.empty());
+
+        return *std::min_element(mMilliseconds.cbegin(), mMilliseconds.cend());
+    }
+
+private:
+
+    std::vector<float> mMilliseconds;
+};
+
+/*
+ * Logs benchmark results as CSV lines - recognizable by their prefix - so that the
+ * log of a run may be pasted into a spreadsheet, or parsed, as it is.
+ *
+ * The throughput is in the unit that makes sense for the phase: MB/s for transfers,
+ * and Mpoints/s for calculations.
+ */
+class BenchmarkReport
+{
+public:
+
+    static void LogHeader()
+    {
+        LogMessage(BenchmarkCsvPrefix, "benchmark,points,phase,median_ms,min_ms,throughput,throughput_unit");
+    }
+
+    static void LogTransfer(
+        std::string const & benchmark,
+        size_t points,
+        std::string const & phase,
+        BenchmarkSamples const & samples,
+        size_t bytes)
+    {
+        float const medianMs = samples.GetMedianMilliseconds();
+
+        LogResult(
+            benchmark,
+            points,
+            phase,
+            samples,
+            static_cast<float>(bytes) / (1024.0f * 1024.0f) / (medianMs / 1000.0f),
+            "MB/s");
+    }
+
+    static void LogCalculation(
+        std::string const & benchmark,
+        size_t points,
+        std::string const & phase,
+        BenchmarkSamples const & samples)
+    {
+        float const medianMs = samples.GetMedianMilliseconds();
+
+        LogResult(
+            benchmark,
+            points,
+            phase,
+            samples,
+            static_cast<float>(points) / 1000000.0f / (medianMs / 1000.0f),
+            "Mpoints/s");
+    }
+
+private:
+
+    static void LogResult(
+        std::string const & benchmark,
+        size_t points,
+        std::string const & phase,
+        BenchmarkSamples const & samples,
+        float throughput,
+        char const * throughputUnit)
+    {
+        LogMessage(
+            BenchmarkCsvPrefix,
+            benchmark, ",",
+            points, ",",
+            phase, ",",
+            samples.GetMedianMilliseconds(), ",",
+            samples.GetMinMilliseconds(), ",",
+            throughput, ",",
+            throughputUnit);
+    }
+};
@@ -65,12 +65,9 @@ bool MainApp::OnInit()
     // Initialize floating point handling
     //
 
-    // Avoid denormal numbers for very small quantities
-    EnableFloatingPointFlushToZero();
-
-#ifdef FLOATING_POINT_CHECKS
-    EnableFloatingPointExceptions();
-#endif
+    // Avoid denormal numbers for very small quantities; the other threads running
+    // simulation code do the same on their own
+    InitializeSimulationThreadFloatingPoint();
 
 
     //
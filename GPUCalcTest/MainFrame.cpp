@@ -9,8 +9,10 @@
 #include "TestRun.h"
 
 #include "AddTest.h"
+#include "MechanicalDynamicsTest.h"
 #include "OpenGLInitTest.h"
 #include "PixelCoordsTest.h"
+#include "WaterDiffusionTest.h"
 
 #include <GPUCalc/GPUCalculatorFactory.h>
 
@@ -107,6 +109,66 @@ MainFrame::MainFrame(wxApp * mainApp)
         });
     buttonCol1Sizer->Add(Add65536TestButton, 1, wxEXPAND);
 
+    auto addBenchmarkButton = new wxButton(this, wxID_ANY, "Run Add Benchmark");
+    addBenchmarkButton->SetMaxSize(wxSize(-1, 20));
+    addBenchmarkButton->Bind(
+        wxEVT_BUTTON,
+        [this](wxEvent & /*event*/)
+        {
+            this->RunAddBenchmark();
+        });
+    buttonCol1Sizer->Add(addBenchmarkButton, 1, wxEXPAND);
+
+    auto waterDiffusion25TestButton = new wxButton(this, wxID_ANY, "Run WaterDiffusion(25) Test");
+    waterDiffusion25TestButton->SetMaxSize(wxSize(-1, 20));
+    waterDiffusion25TestButton->Bind(
+        wxEVT_BUTTON,
+        [this](wxEvent & /*event*/)
+        {
+            this->RunWaterDiffusionTest(25);
+        });
+    buttonCol1Sizer->Add(waterDiffusion25TestButton, 1, wxEXPAND);
+
+    auto waterDiffusion65536TestButton = new wxButton(this, wxID_ANY, "Run WaterDiffusion(65536) Test");
+    waterDiffusion65536TestButton->SetMaxSize(wxSize(-1, 20));
+    waterDiffusion65536TestButton->Bind(
+        wxEVT_BUTTON,
+        [this](wxEvent & /*event*/)
+        {
+            this->RunWaterDiffusionTest(65536);
+        });
+    buttonCol1Sizer->Add(waterDiffusion65536TestButton, 1, wxEXPAND);
+
+    auto mechanicalDynamics25TestButton = new wxButton(this, wxID_ANY, "Run MechanicalDynamics(25) Test");
+    mechanicalDynamics25TestButton->SetMaxSize(wxSize(-1, 20));
+    mechanicalDynamics25TestButton->Bind(
+        wxEVT_BUTTON,
+        [this](wxEvent & /*event*/)
+        {
+            this->RunMechanicalDynamicsTest(25);
+        });
+    buttonCol1Sizer->Add(mechanicalDynamics25TestButton, 1, wxEXPAND);
+
+    auto mechanicalDynamics65536TestButton = new wxButton(this, wxID_ANY, "Run MechanicalDynamics(65536) Test");
+    mechanicalDynamics65536TestButton->SetMaxSize(wxSize(-1, 20));
+    mechanicalDynamics65536TestButton->Bind(
+        wxEVT_BUTTON,
+        [this](wxEvent & /*event*/)
+        {
+            this->RunMechanicalDynamicsTest(65536);
+        });
+    buttonCol1Sizer->Add(mechanicalDynamics65536TestButton, 1, wxEXPAND);
+
+    auto mechanicalDynamicsBenchmarkButton = new wxButton(this, wxID_ANY, "Run MechanicalDynamics(262144) Benchmark");
+    mechanicalDynamicsBenchmarkButton->SetMaxSize(wxSize(-1, 20));
+    mechanicalDynamicsBenchmarkButton->Bind(
+        wxEVT_BUTTON,
+        [this](wxEvent & /*event*/)
+        {
+            this->RunMechanicalDynamicsBenchmark(262144);
+        });
+    buttonCol1Sizer->Add(mechanicalDynamicsBenchmarkButton, 1, wxEXPAND);
+
     auto allTestsButton = new wxButton(this, wxID_ANY, "Run All Tests");
     allTestsButton->SetMaxSize(wxSize(-1, 20));
     allTestsButton->Bind(
@@ -176,11 +238,15 @@ MainFrame::MainFrame(wxApp * mainApp)
     SetSizerAndFit(mMainFrameSizer);
 
 
-    // Register log listener
+    // Register log listener; messages come from the logger's thread
     Logger::Instance.RegisterListener(
         [this](std::string const & message)
         {
-            this->OnLogMessage(message);
+            this->CallAfter(
+                [this, message]()
+                {
+                    this->OnLogMessage(message);
+                });
         });
 
 
@@ -335,6 +401,46 @@ void MainFrame::RunAddTest(size_t dataPoints)
     test.Run();
 }
 
+void MainFrame::RunAddBenchmark()
+{
+    ClearLog();
+
+    ScopedTestRun testRun;
+
+    AddBenchmark test;
+    test.Run();
+}
+
+void MainFrame::RunWaterDiffusionTest(size_t pointCount)
+{
+    ClearLog();
+
+    ScopedTestRun testRun;
+
+    WaterDiffusionTest test(pointCount);
+    test.Run();
+}
+
+void MainFrame::RunMechanicalDynamicsTest(size_t pointCount)
+{
+    ClearLog();
+
+    ScopedTestRun testRun;
+
+    MechanicalDynamicsTest test(pointCount);
+    test.Run();
+}
+
+void MainFrame::RunMechanicalDynamicsBenchmark(size_t pointCount)
+{
+    ClearLog();
+
+    ScopedTestRun testRun;
+
+    MechanicalDynamicsBenchmark test(pointCount);
+    test.Run();
+}
+
 void MainFrame::RunAllTests()
 {
     ClearLog();
@@ -366,5 +472,25 @@ void MainFrame::RunAllTests()
         test.Run();
     }
 
+    {
+        WaterDiffusionTest test(25);
+        test.Run();
+    }
+
+    {
+        WaterDiffusionTest test(65536);
+        test.Run();
+    }
+
+    {
+        MechanicalDynamicsTest test(25);
+        test.Run();
+    }
+
+    {
+        MechanicalDynamicsTest test(65536);
+        test.Run();
+    }
+
     // TODO: all other tests
 }
\ No newline at end of file
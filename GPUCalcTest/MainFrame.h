@@ -61,6 +61,10 @@ private:
     void RunOpenGLTest();
     void RunPixelCoordsTest(size_t dataPoints);
     void RunAddTest(size_t dataPoints);
+    void RunAddBenchmark();
+    void RunWaterDiffusionTest(size_t pointCount);
+    void RunMechanicalDynamicsTest(size_t pointCount);
+    void RunMechanicalDynamicsBenchmark(size_t pointCount);
     void RunAllTests();
 
 private:
@@ -0,0 +1,387 @@
+/***************************************************************************************
+ * Original Author:     Gabriele Giuseppini
+ * Created:             2019-06-16
+ * Copyright:           Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#include "MechanicalDynamicsTest.h"
+
+#include "BenchmarkReport.h"
+
+#include <GPUCalc/GPUCalculatorFactory.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+size_t constexpr OceanFloorSampleCount = 2049;
+float constexpr OceanFloorMinX = -512.0f;
+float constexpr OceanFloorDx = 0.5f;
+
+int constexpr Iterations = 24;
+
+float constexpr PointMass = 1000.0f;
+float constexpr DeltaTime = 0.02f / static_cast<float>(Iterations);
+
+MechanicalDynamicsGPUCalculator::Constants MakeConstants()
+{
+    MechanicalDynamicsGPUCalculator::Constants constants;
+    constants.Gravity = vec2f(0.0f, -9.80f);
+    constants.WindForce = vec2f(30.0f, 0.0f);
+    constants.DeltaTime = DeltaTime;
+    constants.GlobalDampCoefficient = std::pow(0.9996f, 12.0f / static_cast<float>(Iterations));
+    constants.WaterDragCoefficient = 0.020f;
+    constants.DensityAdjustedWaterMass = 1000.0f;
+
+    return constants;
+}
+
+float GetOceanFloorHeightAt(
+    float const * oceanFloor,
+    float x)
+{
+    float const sampleIndexF = std::clamp(
+        (x - OceanFloorMinX) / OceanFloorDx,
+        0.0f,
+        static_cast<float>(OceanFloorSampleCount - 1));
+
+    float const sampleIndexI = std::min(std::floor(sampleIndexF), static_cast<float>(OceanFloorSampleCount - 2));
+    size_t const i = static_cast<size_t>(sampleIndexI);
+
+    return oceanFloor[i] + (oceanFloor[i + 1] - oceanFloor[i]) * (sampleIndexF - sampleIndexI);
+}
+
+/*
+ * Populates the calculator with a grid of points, each connected to its horizontal,
+ * vertical, and diagonal neighbors, hanging across the water surface and - for the
+ * larger grids - reaching into the sea floor.
+ */
+void PopulateGrid(MechanicalDynamicsGPUCalculator & calculator)
+{
+    size_t const pointCount = calculator.GetPointCount();
+    size_t const gridWidth = std::min(pointCount, size_t(256));
+
+    //
+    // Ocean floor
+    //
+
+    float * oceanFloor = calculator.GetOceanFloorBuffer();
+    for (size_t s = 0; s < OceanFloorSampleCount; ++s)
+    {
+        float const x = OceanFloorMinX + static_cast<float>(s) * OceanFloorDx;
+        oceanFloor[s] = -100.0f + 4.0f * std::sin(x * 0.1f);
+    }
+
+    //
+    // Points
+    //
+
+    vec4f * pointDynamics = calculator.GetPointDynamicsBuffer();
+    vec4f * pointAttributes0 = calculator.GetPointAttributes0Buffer();
+    vec4f * pointAttributes1 = calculator.GetPointAttributes1Buffer();
+
+    float const integrationFactor = DeltaTime * DeltaTime / PointMass;
+
+    for (size_t p = 0; p < pointCount; ++p)
+    {
+        // Slightly off the rest lengths, so that springs have some work to do
+        vec2f const position(
+            static_cast<float>(p % gridWidth) - static_cast<float>(gridWidth / 2) + static_cast<float>(p % 5) * 0.05f,
+            5.0f - static_cast<float>(p / gridWidth) * 0.98f);
+
+        pointDynamics[p] = vec4f(
+            position.x,
+            position.y,
+            static_cast<float>(p % 3) - 1.0f,
+            0.0f);
+
+        pointAttributes0[p] = vec4f(
+            integrationFactor,
+            integrationFactor,
+            PointMass,
+            (p % 7) / 7.0f);
+
+        pointAttributes1[p] = vec4f(
+            0.0f,
+            GetOceanFloorHeightAt(oceanFloor, position.x),
+            (p % 2 == 0) ? 1.0f : 0.5f,
+            0.0f);
+    }
+
+    //
+    // Springs
+    //
+
+    float const stiffness = 0.0125f * PointMass / (DeltaTime * DeltaTime);
+    float const damping = 0.03f * PointMass / DeltaTime;
+
+    vec4f * adjacency = calculator.GetAdjacencyBuffer();
+
+    auto const connect =
+        [&](size_t p, size_t slot, size_t other, float restLength)
+        {
+            adjacency[p * MechanicalDynamicsGPUCalculator::MaxSpringsPerPoint + slot] = vec4f(
+                static_cast<float>(other),
+                restLength,
+                stiffness,
+                damping);
+        };
+
+    float const diagonalRestLength = std::sqrt(2.0f);
+
+    for (size_t p = 0; p < pointCount; ++p)
+    {
+        size_t const col = p % gridWidth;
+        bool const hasLeft = col > 0;
+        bool const hasRight = col < gridWidth - 1 && p + 1 < pointCount;
+        bool const hasUp = p >= gridWidth;
+        bool const hasDown = p + gridWidth < pointCount;
+
+        if (hasLeft)
+            connect(p, 0, p - 1, 1.0f);
+        if (hasRight)
+            connect(p, 1, p + 1, 1.0f);
+        if (hasUp)
+            connect(p, 2, p - gridWidth, 1.0f);
+        if (hasDown)
+            connect(p, 3, p + gridWidth, 1.0f);
+        if (hasUp && hasLeft)
+            connect(p, 4, p - gridWidth - 1, diagonalRestLength);
+        if (hasUp && col < gridWidth - 1)
+            connect(p, 5, p - gridWidth + 1, diagonalRestLength);
+        if (hasDown && hasLeft)
+            connect(p, 6, p + gridWidth - 1, diagonalRestLength);
+        if (hasDown && hasRight && p + gridWidth + 1 < pointCount)
+            connect(p, 7, p + gridWidth + 1, diagonalRestLength);
+    }
+}
+
+/*
+ * The same step as the GPU's, the way the ship does it: springs scatter their forces
+ * onto their endpoints, and points are then integrated.
+ */
+void RunOnCPU(
+    MechanicalDynamicsGPUCalculator & calculator,
+    MechanicalDynamicsGPUCalculator::Constants const & constants,
+    std::vector<vec2f> & positions,
+    std::vector<vec2f> & velocities)
+{
+    size_t const pointCount = calculator.GetPointCount();
+
+    vec4f const * pointAttributes0 = calculator.GetPointAttributes0Buffer();
+    vec4f const * pointAttributes1 = calculator.GetPointAttributes1Buffer();
+    vec4f const * adjacency = calculator.GetAdjacencyBuffer();
+    float const * oceanFloor = calculator.GetOceanFloorBuffer();
+
+    std::vector<vec2f> forces(pointCount);
+
+    for (int iter = 0; iter < Iterations; ++iter)
+    {
+        std::fill(forces.begin(), forces.end(), vec2f::zero());
+
+        // Spring forces, each spring once
+        for (size_t p = 0; p < pointCount; ++p)
+        {
+            for (size_t s = 0; s < MechanicalDynamicsGPUCalculator::MaxSpringsPerPoint; ++s)
+            {
+                vec4f const & a = adjacency[p * MechanicalDynamicsGPUCalculator::MaxSpringsPerPoint + s];
+                if (a.x < 0.0f || static_cast<size_t>(a.x) < p)
+                    continue;
+
+                size_t const other = static_cast<size_t>(a.x);
+
+                vec2f const displacement = positions[other] - positions[p];
+                float const displacementLength = displacement.length();
+                vec2f const springDir = displacement.normalise(displacementLength);
+
+                vec2f const fSpring = springDir * (displacementLength - a.y) * a.z;
+                vec2f const fDamp = springDir * (velocities[other] - velocities[p]).dot(springDir) * a.w;
+
+                forces[p] += fSpring + fDamp;
+                forces[other] -= fSpring + fDamp;
+            }
+        }
+
+        for (size_t p = 0; p < pointCount; ++p)
+        {
+            // Point forces
+            forces[p] += constants.Gravity * pointAttributes0[p].z;
+
+            if (positions[p].y < pointAttributes1[p].x)
+                forces[p] -= constants.Gravity * pointAttributes0[p].w * constants.DensityAdjustedWaterMass;
+
+            if (positions[p].y <= pointAttributes1[p].x)
+                forces[p] += velocities[p] * (-constants.WaterDragCoefficient);
+            else
+                forces[p] += constants.WindForce * pointAttributes1[p].z;
+
+            // Integration
+            vec2f const deltaPos =
+                velocities[p] * constants.DeltaTime
+                + vec2f(forces[p].x * pointAttributes0[p].x, forces[p].y * pointAttributes0[p].y);
+
+            positions[p] += deltaPos;
+            velocities[p] = deltaPos * constants.GlobalDampCoefficient / constants.DeltaTime;
+
+            // Sea floor
+            float const floorHeight = pointAttributes1[p].y;
+            if (positions[p].y < floorHeight)
+            {
+                positions[p] -= velocities[p] * constants.DeltaTime;
+
+                vec2f const seaFloorNormal = vec2f(
+                    floorHeight - GetOceanFloorHeightAt(oceanFloor, positions[p].x + 0.01f),
+                    0.01f).normalise();
+
+                velocities[p] = velocities[p] * -0.75f + seaFloorNormal * 0.5f;
+            }
+        }
+    }
+}
+
+bool IsClose(float gpu, float cpu, float tolerance)
+{
+    return std::abs(gpu - cpu) <= tolerance * std::max(1.0f, std::abs(cpu));
+}
+
+}
+
+void MechanicalDynamicsTest::InternalRun()
+{
+    auto calculator = GPUCalculatorFactory::GetInstance().CreateMechanicalDynamicsCalculator(
+        mPointCount,
+        OceanFloorSampleCount);
+
+    PopulateGrid(*calculator);
+
+    //
+    // Run on the CPU first, as the GPU overwrites the dynamics
+    //
+
+    auto const constants = MakeConstants();
+
+    std::vector<vec2f> cpuPositions(mPointCount);
+    std::vector<vec2f> cpuVelocities(mPointCount);
+    for (size_t p = 0; p < mPointCount; ++p)
+    {
+        vec4f const & dynamics = calculator->GetPointDynamicsBuffer()[p];
+        cpuPositions[p] = vec2f(dynamics.x, dynamics.y);
+        cpuVelocities[p] = vec2f(dynamics.z, dynamics.w);
+    }
+
+    RunOnCPU(*calculator, constants, cpuPositions, cpuVelocities);
+
+    //
+    // Run on the GPU
+    //
+
+    calculator->Run(Iterations, constants, OceanFloorMinX, OceanFloorDx, true, true);
+
+    vec4f const * results = calculator->GetPointDynamicsBuffer();
+
+    //
+    // Verify; the GPU gathers the forces in a different order, hence
+    // results only match modulo rounding
+    //
+
+    LogBuffer("results", results, mPointCount);
+
+    size_t mismatchCount = 0;
+    for (size_t p = 0; p < mPointCount; ++p)
+    {
+        TEST_VERIFY(std::isfinite(results[p].x) && std::isfinite(results[p].y));
+        TEST_VERIFY(std::isfinite(results[p].z) && std::isfinite(results[p].w));
+
+        if (!IsClose(results[p].x, cpuPositions[p].x, 0.0001f)
+            || !IsClose(results[p].y, cpuPositions[p].y, 0.0001f)
+            || !IsClose(results[p].z, cpuVelocities[p].x, 0.01f)
+            || !IsClose(results[p].w, cpuVelocities[p].y, 0.01f))
+        {
+            if (mismatchCount < 5)
+            {
+                LogMessage("Mismatch at ", p, ": GPU=", results[p],
+                    " CPU=", cpuPositions[p], ", ", cpuVelocities[p]);
+            }
+
+            ++mismatchCount;
+        }
+    }
+
+    TEST_VERIFY_EQ(mismatchCount, size_t(0));
+
+    //
+    // Verify the positions for rendering, which must be the same as the read-back ones
+    //
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, calculator->GetPositionBuffer());
+    vec2f const * positions = static_cast<vec2f const *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    TEST_VERIFY(nullptr != positions);
+
+    if (nullptr != positions)
+    {
+        for (size_t p = 0; p < mPointCount; ++p)
+        {
+            TEST_VERIFY(positions[p] == vec2f(results[p].x, results[p].y));
+        }
+
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void MechanicalDynamicsBenchmark::InternalRun()
+{
+    auto calculator = GPUCalculatorFactory::GetInstance().CreateMechanicalDynamicsCalculator(
+        mPointCount,
+        OceanFloorSampleCount);
+
+    PopulateGrid(*calculator);
+
+    auto const constants = MakeConstants();
+
+    // Warm up
+    calculator->Run(Iterations, constants, OceanFloorMinX, OceanFloorDx, true, true);
+
+    size_t constexpr Steps = 100;
+
+    BenchmarkReport::LogHeader();
+
+    // Once with the round trip through the CPU at each step, and once with the
+    // point dynamics staying on the GPU
+    for (bool const isRoundTrip : { true, false })
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+
+        for (size_t s = 0; s < Steps; ++s)
+        {
+            calculator->Run(Iterations, constants, OceanFloorMinX, OceanFloorDx, isRoundTrip, isRoundTrip);
+        }
+
+        if (!isRoundTrip)
+        {
+            // Wait for the GPU to be done
+            calculator->ReadBackPointDynamics();
+        }
+
+        auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime);
+
+        float const millisecondsPerStep = static_cast<float>(elapsed.count()) / 1000.0f / static_cast<float>(Steps);
+
+        LogMessage(
+            "MechanicalDynamicsBenchmark: ", mPointCount, " points, ", Iterations, " iterations, ",
+            isRoundTrip ? "round trip" : "GPU-resident", ": ",
+            millisecondsPerStep, "ms/step, ",
+            static_cast<float>(mPointCount) * static_cast<float>(Iterations) / (millisecondsPerStep * 1000.0f), " Mpoint-iterations/s");
+
+        BenchmarkSamples stepSamples;
+        stepSamples.Add(elapsed / Steps);
+        BenchmarkReport::LogCalculation("MechanicalDynamics", mPointCount, isRoundTrip ? "step_round_trip" : "step_gpu_resident", stepSamples);
+
+        TEST_VERIFY(std::isfinite(calculator->GetPointDynamicsBuffer()[0].x));
+    }
+}
@@ -0,0 +1,52 @@
+/***************************************************************************************
+ * Original Author:     Gabriele Giuseppini
+ * Created:             2019-06-16
+ * Copyright:           Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#pragma once
+
+#include "TestCase.h"
+
+#include <string>
+
+/*
+ * Verifies the GPU mechanical dynamics against a CPU implementation of the same step.
+ */
+class MechanicalDynamicsTest : public TestCase
+{
+public:
+
+    MechanicalDynamicsTest(size_t pointCount)
+        : TestCase("MechanicalDynamics " + std::to_string(pointCount))
+        , mPointCount(pointCount)
+    {}
+
+protected:
+
+    virtual void InternalRun() override;
+
+private:
+
+    size_t const mPointCount;
+};
+
+/*
+ * Measures the throughput of the GPU mechanical dynamics, uploads and readback included.
+ */
+class MechanicalDynamicsBenchmark : public TestCase
+{
+public:
+
+    MechanicalDynamicsBenchmark(size_t pointCount)
+        : TestCase("MechanicalDynamicsBenchmark " + std::to_string(pointCount))
+        , mPointCount(pointCount)
+    {}
+
+protected:
+
+    virtual void InternalRun() override;
+
+private:
+
+    size_t const mPointCount;
+};
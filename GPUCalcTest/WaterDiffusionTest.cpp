@@ -0,0 +1,105 @@
+/***************************************************************************************
+ * Original Author:     Gabriele Giuseppini
+ * Created:             2019-01-20
+ * Copyright:           Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#include "WaterDiffusionTest.h"
+
+#include <GPUCalc/GPUCalculatorFactory.h>
+
+#include <algorithm>
+#include <cmath>
+
+void WaterDiffusionTest::InternalRun()
+{
+    auto calculator = GPUCalculatorFactory::GetInstance().CreateWaterDiffusionCalculator(mPointCount);
+
+    //
+    // Create a grid of points, each connected to its horizontal and vertical
+    // neighbors, with the springs of every seventh point impermeable
+    //
+
+    size_t const gridWidth = 10;
+
+    vec4f * pointAttributes0 = calculator->GetPointAttributes0Buffer();
+    vec4f * pointAttributes1 = calculator->GetPointAttributes1Buffer();
+    vec4f * adjacency = calculator->GetAdjacencyBuffer();
+
+    float totalWater = 0.0f;
+    for (size_t p = 0; p < mPointCount; ++p)
+    {
+        float const water = static_cast<float>(p % 13) / 6.0f;
+
+        pointAttributes0[p] = vec4f(
+            static_cast<float>(p % gridWidth),
+            static_cast<float>(p / gridWidth),
+            water,
+            0.5f);
+
+        pointAttributes1[p] = vec4f(
+            static_cast<float>(p % 3) - 1.0f,
+            0.0f,
+            0.0f,
+            0.0f);
+
+        totalWater += water;
+    }
+
+    auto const connect =
+        [&](size_t p, size_t slot, size_t other)
+        {
+            float const permeability = (p % 7 == 0 || other % 7 == 0) ? 0.0f : 1.0f;
+            adjacency[p * WaterDiffusionGPUCalculator::MaxSpringsPerPoint + slot] = vec4f(
+                static_cast<float>(other),
+                1.0f,
+                permeability,
+                0.0f);
+        };
+
+    for (size_t p = 0; p < mPointCount; ++p)
+    {
+        if (p % gridWidth > 0)
+            connect(p, 0, p - 1);
+        if (p % gridWidth < gridWidth - 1 && p + 1 < mPointCount)
+            connect(p, 1, p + 1);
+        if (p >= gridWidth)
+            connect(p, 2, p - gridWidth);
+        if (p + gridWidth < mPointCount)
+            connect(p, 3, p + gridWidth);
+    }
+
+    calculator->UploadAdjacency();
+
+    //
+    // Run
+    //
+
+    TEST_VERIFY(!calculator->RetrieveResults());
+
+    calculator->Run(9.80f, 1.0f);
+
+    TEST_VERIFY(calculator->RetrieveResults());
+
+    vec4f const * results = calculator->GetResultsBuffer();
+
+    //
+    // Verify
+    //
+
+    LogBuffer("results", results, mPointCount);
+
+    float newTotalWater = 0.0f;
+    for (size_t p = 0; p < mPointCount; ++p)
+    {
+        TEST_VERIFY(results[p].x >= -0.0001f);
+        TEST_VERIFY(std::isfinite(results[p].y) && std::isfinite(results[p].z));
+        TEST_VERIFY(results[p].w >= 0.0f);
+
+        newTotalWater += results[p].x;
+    }
+
+    LogMessage("TotalWater=", totalWater, ", NewTotalWater=", newTotalWater);
+
+    // Water is conserved
+    TEST_VERIFY(std::abs(newTotalWater - totalWater) <= 0.0001f * std::max(totalWater, 1.0f));
+}
@@ -0,0 +1,28 @@
+/***************************************************************************************
+ * Original Author:     Gabriele Giuseppini
+ * Created:             2019-01-20
+ * Copyright:           Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#pragma once
+
+#include "TestCase.h"
+
+#include <string>
+
+class WaterDiffusionTest : public TestCase
+{
+public:
+
+    WaterDiffusionTest(size_t pointCount)
+        : TestCase("WaterDiffusion " + std::to_string(pointCount))
+        , mPointCount(pointCount)
+    {}
+
+protected:
+
+    virtual void InternalRun() override;
+
+private:
+
+    size_t const mPointCount;
+};
@@ -43,6 +43,11 @@ void Bombs::Update(
 
 void Bombs::OnPointDetached(ElementIndex pointElementIndex)
 {
+    // Detaches happen by the thousands while a ship breaks up, and
+    // most of the time there are no bombs at all
+    if (mCurrentBombs.empty())
+        return;
+
     auto squareNeighborhoodRadius = GameParameters::BombNeighborhoodRadius * GameParameters::BombNeighborhoodRadius;
 
     auto neighborhoodCenter = mShipPoints.GetPosition(pointElementIndex);
@@ -61,18 +66,32 @@ void Bombs::OnPointDetached(ElementIndex pointElementIndex)
 
 void Bombs::OnSpringDestroyed(ElementIndex springElementIndex)
 {
+    // See OnPointDetached()
+    if (mCurrentBombs.empty())
+        return;
+
     auto squareNeighborhoodRadius = GameParameters::BombNeighborhoodRadius * GameParameters::BombNeighborhoodRadius;
 
     auto neighborhoodCenter = mShipSprings.GetMidpointPosition(springElementIndex, mShipPoints);
 
+    // The spring tells us already whether there's a bomb attached to it, hence we
+    // only look for the bomb to detach in the rare case that there is one
+    bool isBombAttached = mShipSprings.IsBombAttached(springElementIndex);
+
     for (auto & bomb : mCurrentBombs)
     {
         // Check if the bomb is attached to this spring
-        auto bombSpring = bomb->GetAttachedSpringIndex();
-        if (!!bombSpring && *bombSpring == springElementIndex)
+        if (isBombAttached)
         {
-            // Detach bomb
-            bomb->DetachIfAttached();
+            auto bombSpring = bomb->GetAttachedSpringIndex();
+            if (!!bombSpring && *bombSpring == springElementIndex)
+            {
+                // Detach bomb
+                bomb->DetachIfAttached();
+
+                // There's at most one bomb per spring
+                isBombAttached = false;
+            }
         }
 
         // Check if the bomb is within the neighborhood of the disturbed center
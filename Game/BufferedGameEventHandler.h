@@ -0,0 +1,395 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-08
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "IGameEventHandler.h"
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/*
+ * A game event handler that sits in front of another handler, and either forwards
+ * events to it straight away or, while buffering, records them and forwards them
+ * all - in their original order - at the next flush.
+ *
+ * Allows entities that are updated concurrently to fire events without racing for
+ * the downstream handler, while keeping the order in which the latter gets the events
+ * independent from the order in which the entities' updates happen to run.
+ */
+class BufferedGameEventHandler : public IGameEventHandler
+{
+public:
+
+    explicit BufferedGameEventHandler(std::shared_ptr<IGameEventHandler> downstreamHandler)
+        : mDownstreamHandler(std::move(downstreamHandler))
+        , mIsBuffering(false)
+        , mBufferedEvents()
+    {
+        assert(!!mDownstreamHandler);
+    }
+
+    /*
+     * Starts recording events rather than forwarding them.
+     */
+    void BeginBuffering()
+    {
+        mIsBuffering = true;
+    }
+
+    /*
+     * Forwards all recorded events and goes back to forwarding events straight away.
+     */
+    void Flush()
+    {
+        for (auto const & event : mBufferedEvents)
+        {
+            event(*mDownstreamHandler);
+        }
+
+        mBufferedEvents.clear();
+        mIsBuffering = false;
+    }
+
+public:
+
+    virtual void OnGameReset() override
+    {
+        Dispatch(
+            [](IGameEventHandler & handler)
+            {
+                handler.OnGameReset();
+            });
+    }
+
+    virtual void OnShipLoaded(
+        unsigned int id,
+        std::string const & name,
+        std::optional<std::string> const & author) override
+    {
+        Dispatch(
+            [id, name, author](IGameEventHandler & handler)
+            {
+                handler.OnShipLoaded(id, name, author);
+            });
+    }
+
+    virtual void OnDestroy(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [&structuralMaterial, isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnDestroy(structuralMaterial, isUnderwater, size);
+            });
+    }
+
+    virtual void OnSpringRepaired(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [&structuralMaterial, isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnSpringRepaired(structuralMaterial, isUnderwater, size);
+            });
+    }
+
+    virtual void OnTriangleRepaired(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [&structuralMaterial, isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnTriangleRepaired(structuralMaterial, isUnderwater, size);
+            });
+    }
+
+    virtual void OnSawed(
+        bool isMetal,
+        unsigned int size) override
+    {
+        Dispatch(
+            [isMetal, size](IGameEventHandler & handler)
+            {
+                handler.OnSawed(isMetal, size);
+            });
+    }
+
+    virtual void OnPinToggled(
+        bool isPinned,
+        bool isUnderwater) override
+    {
+        Dispatch(
+            [isPinned, isUnderwater](IGameEventHandler & handler)
+            {
+                handler.OnPinToggled(isPinned, isUnderwater);
+            });
+    }
+
+    virtual void OnStress(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [&structuralMaterial, isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnStress(structuralMaterial, isUnderwater, size);
+            });
+    }
+
+    virtual void OnBreak(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [&structuralMaterial, isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnBreak(structuralMaterial, isUnderwater, size);
+            });
+    }
+
+    virtual void OnSinkingBegin(ShipId shipId) override
+    {
+        Dispatch(
+            [shipId](IGameEventHandler & handler)
+            {
+                handler.OnSinkingBegin(shipId);
+            });
+    }
+
+    virtual void OnSinkingEnd(ShipId shipId) override
+    {
+        Dispatch(
+            [shipId](IGameEventHandler & handler)
+            {
+                handler.OnSinkingEnd(shipId);
+            });
+    }
+
+    virtual void OnLightFlicker(
+        DurationShortLongType duration,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [duration, isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnLightFlicker(duration, isUnderwater, size);
+            });
+    }
+
+    virtual void OnWaterTaken(float waterTaken) override
+    {
+        Dispatch(
+            [waterTaken](IGameEventHandler & handler)
+            {
+                handler.OnWaterTaken(waterTaken);
+            });
+    }
+
+    virtual void OnWaterSplashed(float waterSplashed) override
+    {
+        Dispatch(
+            [waterSplashed](IGameEventHandler & handler)
+            {
+                handler.OnWaterSplashed(waterSplashed);
+            });
+    }
+
+    virtual void OnWindSpeedUpdated(
+        float const zeroSpeedMagnitude,
+        float const baseSpeedMagnitude,
+        float const preMaxSpeedMagnitude,
+        float const maxSpeedMagnitude,
+        vec2f const & windSpeed) override
+    {
+        Dispatch(
+            [zeroSpeedMagnitude, baseSpeedMagnitude, preMaxSpeedMagnitude, maxSpeedMagnitude, windSpeed](IGameEventHandler & handler)
+            {
+                handler.OnWindSpeedUpdated(zeroSpeedMagnitude, baseSpeedMagnitude, preMaxSpeedMagnitude, maxSpeedMagnitude, windSpeed);
+            });
+    }
+
+    virtual void OnCustomProbe(
+        std::string const & name,
+        float value) override
+    {
+        Dispatch(
+            [name, value](IGameEventHandler & handler)
+            {
+                handler.OnCustomProbe(name, value);
+            });
+    }
+
+    virtual void OnFrameRateUpdated(
+        float immediateFps,
+        float averageFps) override
+    {
+        Dispatch(
+            [immediateFps, averageFps](IGameEventHandler & handler)
+            {
+                handler.OnFrameRateUpdated(immediateFps, averageFps);
+            });
+    }
+
+    virtual void OnUpdateToRenderRatioUpdated(
+        float immediateURRatio) override
+    {
+        Dispatch(
+            [immediateURRatio](IGameEventHandler & handler)
+            {
+                handler.OnUpdateToRenderRatioUpdated(immediateURRatio);
+            });
+    }
+
+    virtual void OnFrameTimeStatisticsUpdated(
+        FrameTimeStatistics const & frameTimeStatistics) override
+    {
+        Dispatch(
+            [frameTimeStatistics](IGameEventHandler & handler)
+            {
+                handler.OnFrameTimeStatisticsUpdated(frameTimeStatistics);
+            });
+    }
+
+    //
+    // Bombs
+    //
+
+    virtual void OnBombPlaced(
+        ObjectId bombId,
+        BombType bombType,
+        bool isUnderwater) override
+    {
+        Dispatch(
+            [bombId, bombType, isUnderwater](IGameEventHandler & handler)
+            {
+                handler.OnBombPlaced(bombId, bombType, isUnderwater);
+            });
+    }
+
+    virtual void OnBombRemoved(
+        ObjectId bombId,
+        BombType bombType,
+        std::optional<bool> isUnderwater) override
+    {
+        Dispatch(
+            [bombId, bombType, isUnderwater](IGameEventHandler & handler)
+            {
+                handler.OnBombRemoved(bombId, bombType, isUnderwater);
+            });
+    }
+
+    virtual void OnBombExplosion(
+        BombType bombType,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [bombType, isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnBombExplosion(bombType, isUnderwater, size);
+            });
+    }
+
+    virtual void OnRCBombPing(
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnRCBombPing(isUnderwater, size);
+            });
+    }
+
+    virtual void OnTimerBombFuse(
+        ObjectId bombId,
+        std::optional<bool> isFast) override
+    {
+        Dispatch(
+            [bombId, isFast](IGameEventHandler & handler)
+            {
+                handler.OnTimerBombFuse(bombId, isFast);
+            });
+    }
+
+    virtual void OnTimerBombDefused(
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Dispatch(
+            [isUnderwater, size](IGameEventHandler & handler)
+            {
+                handler.OnTimerBombDefused(isUnderwater, size);
+            });
+    }
+
+    virtual void OnAntiMatterBombContained(
+        ObjectId bombId,
+        bool isContained) override
+    {
+        Dispatch(
+            [bombId, isContained](IGameEventHandler & handler)
+            {
+                handler.OnAntiMatterBombContained(bombId, isContained);
+            });
+    }
+
+    virtual void OnAntiMatterBombPreImploding() override
+    {
+        Dispatch(
+            [](IGameEventHandler & handler)
+            {
+                handler.OnAntiMatterBombPreImploding();
+            });
+    }
+
+    virtual void OnAntiMatterBombImploding() override
+    {
+        Dispatch(
+            [](IGameEventHandler & handler)
+            {
+                handler.OnAntiMatterBombImploding();
+            });
+    }
+
+private:
+
+    using BufferedEvent = std::function<void(IGameEventHandler &)>;
+
+    template<typename TEvent>
+    void Dispatch(TEvent && event)
+    {
+        if (mIsBuffering)
+        {
+            mBufferedEvents.emplace_back(std::forward<TEvent>(event));
+        }
+        else
+        {
+            event(*mDownstreamHandler);
+        }
+    }
+
+private:
+
+    std::shared_ptr<IGameEventHandler> const mDownstreamHandler;
+
+    bool mIsBuffering;
+
+    std::vector<BufferedEvent> mBufferedEvents;
+};
@@ -8,7 +8,6 @@
 #include "GameParameters.h"
 #include "RenderContext.h"
 
-#include <memory>
 #include <vector>
 
 namespace Physics
@@ -21,6 +20,9 @@ public:
 
     Clouds()
         : mClouds()
+        , mCurrentSimulationTime(0.0f)
+        , mCurrentCloudSpeed(0.0f)
+        , mIsDirty(false)
     {}
 
     void Update(
@@ -29,24 +31,59 @@ public:
 
     void Upload(Render::RenderContext & renderContext) const
     {
-        renderContext.UploadCloudsStart(mClouds.size());
-
-        for (auto const & cloud : mClouds)
+        // The clouds only change when their number changes, as their
+        // motion is calculated by the GPU
+        if (mIsDirty)
         {
-            renderContext.UploadCloud(
-                cloud->GetX(),
-                cloud->GetY(),
-                cloud->GetScale());
+            renderContext.UploadCloudsStart(mClouds.size());
+
+            for (auto const & cloud : mClouds)
+            {
+                renderContext.UploadCloud(
+                    cloud.OffsetX,
+                    cloud.SpeedX1,
+                    cloud.AmpX,
+                    cloud.SpeedX2,
+                    cloud.OffsetY,
+                    cloud.AmpY,
+                    cloud.SpeedY,
+                    cloud.OffsetScale,
+                    cloud.AmpScale,
+                    cloud.SpeedScale);
+            }
+
+            renderContext.UploadCloudsEnd();
+
+            mIsDirty = false;
         }
 
-        renderContext.UploadCloudsEnd();
+        renderContext.UploadCloudsAnimation(
+            mCurrentSimulationTime,
+            mCurrentCloudSpeed);
     }
 
 private:
 
+    /*
+     * The constants of the motion of a cloud: at any moment in time t, with s = t * cloudSpeed:
+     *  x = OffsetX + SpeedX1 * s + AmpX * sin(SpeedX2 * s)
+     *  y = OffsetY + AmpY * sin(SpeedY * s)
+     *  scale = OffsetScale + AmpScale * sin(SpeedScale * s)
+     */
     struct Cloud
     {
-    public:
+        float OffsetX;
+        float SpeedX1;
+        float AmpX;
+        float SpeedX2;
+
+        float OffsetY;
+        float AmpY;
+        float SpeedY;
+
+        float OffsetScale;
+        float AmpScale;
+        float SpeedScale;
 
         Cloud(
             float offsetX,
@@ -59,69 +96,26 @@ private:
             float offsetScale,
             float ampScale,
             float speedScale)
-            : mX(0.0f)
-            , mY(0.0f)
-            , mScale(0.0f)
-            , mOffsetX(offsetX)
-            , mSpeedX1(speedX1)
-            , mAmpX(ampX)
-            , mSpeedX2(speedX2)
-            , mOffsetY(offsetY)
-            , mAmpY(ampY)
-            , mSpeedY(speedY)
-            , mOffsetScale(offsetScale)
-            , mAmpScale(ampScale)
-            , mSpeedScale(speedScale)
+            : OffsetX(offsetX)
+            , SpeedX1(speedX1)
+            , AmpX(ampX)
+            , SpeedX2(speedX2)
+            , OffsetY(offsetY)
+            , AmpY(ampY)
+            , SpeedY(speedY)
+            , OffsetScale(offsetScale)
+            , AmpScale(ampScale)
+            , SpeedScale(speedScale)
         {
         }
+    };
 
-        inline void Update(
-            float currentSimulationTime,
-            float cloudSpeed)
-        {
-            float const scaledSpeed = currentSimulationTime * cloudSpeed;
-
-            mX = mOffsetX + (mSpeedX1 * scaledSpeed) + (mAmpX * sinf(mSpeedX2 * scaledSpeed));
-            mY = mOffsetY + (mAmpY * sinf(mSpeedY * scaledSpeed));
-            mScale = mOffsetScale + (mAmpScale * sinf(mSpeedScale * scaledSpeed));
-        }
-
-        inline float GetX() const
-        {
-            return mX;
-        }
-
-        inline float GetY() const
-        {
-            return mY;
-        }
-
-        inline float GetScale() const
-        {
-            return mScale;
-        }
-
-    private:
-
-        float mX;
-        float mY;
-        float mScale;
-
-        float const mOffsetX;
-        float const mSpeedX1;
-        float const mAmpX;
-        float const mSpeedX2;
-
-        float const mOffsetY;
-        float const mAmpY;
-        float const mSpeedY;
+    std::vector<Cloud> mClouds;
 
-        float const mOffsetScale;
-        float const mAmpScale;
-        float const mSpeedScale;
-    };
+    float mCurrentSimulationTime;
+    float mCurrentCloudSpeed;
 
-    std::vector<std::unique_ptr<Cloud>> mClouds;
+    mutable bool mIsDirty;
 };
 
 }
@@ -42,6 +42,7 @@ void ElectricalElements::Add(
         case ElectricalMaterial::ElectricalElementType::Lamp:
         {
             mLamps.emplace_back(static_cast<ElementIndex>(mElementStateBuffer.GetCurrentPopulatedSize()));
+            mActiveLamps.emplace_back(mLamps.back());
             mElementStateBuffer.emplace_back(
                 ElementState::LampState(
                     electricalMaterial.IsSelfPowered,
@@ -59,7 +60,11 @@ void ElectricalElements::Destroy(ElementIndex electricalElementIndex)
     assert(!IsDeleted(electricalElementIndex));
 
     // Zero out our current
-    mAvailableCurrentBuffer[electricalElementIndex] = 0.0f;
+    if (mAvailableCurrentBuffer[electricalElementIndex] != 0.0f)
+    {
+        mAvailableCurrentBuffer[electricalElementIndex] = 0.0f;
+        mIsLampLightDirty = true;
+    }
 
     // Note: no need to remove self from connected electrical elements, as Ship's PointDestroyHandler,
     // which is the caller of this Destroy(), has already destroyed the point's springs, hence
@@ -67,9 +72,9 @@ void ElectricalElements::Destroy(ElementIndex electricalElementIndex)
     assert(GetConnectedElectricalElements(electricalElementIndex).empty());
 
     // Invoke destroy handler
-    if (!!mDestroyHandler)
+    if (nullptr != mShipHandler)
     {
-        mDestroyHandler(electricalElementIndex);
+        mShipHandler->ElectricalElementDestroyHandler(electricalElementIndex);
     }
 
     // Flag ourselves as deleted
@@ -83,25 +88,75 @@ void ElectricalElements::Update(
     GameParameters const & gameParameters)
 {
     //
-    // Visit all lamps and run their state machine
+    // Decide which lamps need their state machine to run: the steady ones - lit or
+    // unpowered - only react to a change of the circuit, or - when lit and wet - to
+    // a wet failure
     //
 
-    for (auto iLamp : Lamps())
+    if (currentConnectivityVisitSequenceNumber != mLastLampsConnectivityVisitSequenceNumber)
+    {
+        // The circuit has changed, hence all lamps might have to react
+        mActiveLamps.clear();
+        for (auto iLamp : Lamps())
+        {
+            if (!mIsDeletedBuffer[iLamp])
+                mActiveLamps.push_back(iLamp);
+        }
+
+        mLastLampsConnectivityVisitSequenceNumber = currentConnectivityVisitSequenceNumber;
+    }
+    else if (currentWallclockTime >= mNextLitLampsSweepTimePoint)
+    {
+        // Time to check lit lamps for wet failures; lit lamps are never
+        // in the active list already
+        for (auto iLamp : Lamps())
+        {
+            if (!mIsDeletedBuffer[iLamp]
+                && ElementState::LampState::StateType::LightOn == mElementStateBuffer[iLamp].Lamp.State
+                && points.IsWet(GetPointIndex(iLamp), LampWetFailureWaterThreshold))
+            {
+                mActiveLamps.push_back(iLamp);
+            }
+        }
+
+        mNextLitLampsSweepTimePoint = currentWallclockTime + ElementState::LampState::WetFailureCheckInterval;
+    }
+
+    //
+    // Run the state machine of the active lamps, keeping those that remain active
+    //
+
+    size_t activeLampCount = 0;
+    for (auto iLamp : mActiveLamps)
     {
         if (!mIsDeletedBuffer[iLamp])
         {
+            float const previousAvailableCurrent = mAvailableCurrentBuffer[iLamp];
+
             RunLampStateMachine(
                 iLamp,
                 currentWallclockTime,
                 currentConnectivityVisitSequenceNumber,
                 points,
                 gameParameters);
+
+            if (mAvailableCurrentBuffer[iLamp] != previousAvailableCurrent)
+            {
+                mIsLampLightDirty = true;
+            }
+
+            if (IsLampActive(iLamp, currentConnectivityVisitSequenceNumber))
+            {
+                mActiveLamps[activeLampCount++] = iLamp;
+            }
         }
         else
         {
             assert(0.0f == mAvailableCurrentBuffer[iLamp]);
         }
     }
+
+    mActiveLamps.resize(activeLampCount);
 }
 
 void ElectricalElements::RunLampStateMachine(
@@ -129,7 +184,7 @@ void ElectricalElements::RunLampStateMachine(
             {
                 mAvailableCurrentBuffer[elementLampIndex] = 1.f;
                 lamp.State = ElementState::LampState::StateType::LightOn;
-                lamp.NextWetFailureCheckTimePoint = currentWallclockTime + std::chrono::seconds(1);
+                lamp.NextWetFailureCheckTimePoint = currentWallclockTime + ElementState::LampState::WetFailureCheckInterval;
             }
             else
             {
@@ -328,10 +383,27 @@ bool ElectricalElements::CheckWetFailureTime(
             < lamp.WetFailureRateCdf;
 
         // Schedule next check
-        lamp.NextWetFailureCheckTimePoint = currentWallclockTime + std::chrono::seconds(1);
+        lamp.NextWetFailureCheckTimePoint = currentWallclockTime + ElementState::LampState::WetFailureCheckInterval;
     }
 
     return isFailure;
 }
 
+void ElectricalElements::ReportMemory(MemoryReport & report) const
+{
+    report.Add("IsDeleted", mIsDeletedBuffer);
+    report.Add("PointIndex", mPointIndexBuffer);
+    report.Add("Type", mTypeBuffer);
+    report.Add("Luminiscence", mLuminiscenceBuffer);
+    report.Add("LightColor", mLightColorBuffer);
+    report.Add("LightSpread", mLightSpreadBuffer);
+    report.Add("ConnectedElectricalElements", mConnectedElectricalElementsBuffer);
+    report.Add("ElementState", mElementStateBuffer);
+    report.Add("AvailableCurrent", mAvailableCurrentBuffer);
+    report.Add("CurrentConnectivityVisitSequenceNumber", mCurrentConnectivityVisitSequenceNumberBuffer);
+    report.Add("Generators", mGenerators);
+    report.Add("Lamps", mLamps);
+    report.Add("ActiveLamps", mActiveLamps);
+}
+
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <GameCore/Buffer.h>
 #include <GameCore/ElementContainer.h>
 #include <GameCore/GameWallClock.h>
+#include <GameCore/MemoryReport.h>
 
 #include <cassert>
 #include <chrono>
@@ -26,7 +27,6 @@ class ElectricalElements : public ElementContainer
 {
 public:
 
-    using DestroyHandler = std::function<void(ElementIndex)>;
 
 public:
 
@@ -53,14 +53,23 @@ public:
         //////////////////////////////////
         , mParentWorld(parentWorld)
         , mGameEventHandler(std::move(gameEventHandler))
-        , mDestroyHandler()
+        , mShipHandler(nullptr)
         , mGenerators()
         , mLamps()
+        , mActiveLamps()
+        , mLastLampsConnectivityVisitSequenceNumber()
+        , mNextLitLampsSweepTimePoint()
+        , mIsLampLightDirty(true)
     {
     }
 
     ElectricalElements(ElectricalElements && other) = default;
 
+    /*
+     * Adds the buffers of the electrical elements to the report.
+     */
+    void ReportMemory(MemoryReport & report) const;
+
     /*
      * Returns an iterator for the generator elements only.
      */
@@ -78,7 +87,8 @@ public:
     }
 
     /*
-     * Sets a (single) handler that is invoked whenever an electrical element is destroyed.
+     * Sets the (single) ship whose handler is invoked whenever an electrical element is destroyed;
+     * the handler is invoked directly, rather than through a type-erased callback.
      *
      * The handler is invoked right before the electrical element is marked as deleted. However,
      * other elements connected to the soon-to-be-deleted electrical element might already have been
@@ -87,12 +97,12 @@ public:
      * The handler is not re-entrant: destroying other electrical elements from it is not supported
      * and leads to undefined behavior.
      *
-     * Setting more than one handler is not supported and leads to undefined behavior.
+     * Setting more than one ship is not supported and leads to undefined behavior.
      */
-    void RegisterDestroyHandler(DestroyHandler destroyHandler)
+    void RegisterShipHandler(Ship * shipHandler)
     {
-        assert(!mDestroyHandler);
-        mDestroyHandler = std::move(destroyHandler);
+        assert(nullptr == mShipHandler);
+        mShipHandler = shipHandler;
     }
 
     void Add(
@@ -152,6 +162,20 @@ public:
         return mLightSpreadBuffer[electricalElementIndex];
     }
 
+    /*
+     * Whether the current available to any lamp has changed - because of the circuit,
+     * of flickering, or of the lamp's destruction - since the last ClearLampLightDirty().
+     */
+    bool IsLampLightDirty() const
+    {
+        return mIsLampLightDirty;
+    }
+
+    void ClearLampLightDirty()
+    {
+        mIsLampLightDirty = false;
+    }
+
     //
     // Connected elements
     //
@@ -236,6 +260,7 @@ private:
                 LightOff
             };
 
+            static constexpr auto WetFailureCheckInterval = 1s;
             static constexpr auto FlickerStartInterval = 100ms;
             static constexpr auto FlickerAInterval = 150ms;
             static constexpr auto FlickerBInterval = 100ms;
@@ -287,6 +312,43 @@ private:
         ElementState::LampState & lamp,
         GameWallClock::time_point currentWallclockTime);
 
+    inline bool IsLampPowered(
+        ElementIndex elementLampIndex,
+        SequenceNumber currentConnectivityVisitSequenceNumber) const
+    {
+        return currentConnectivityVisitSequenceNumber == mCurrentConnectivityVisitSequenceNumberBuffer[elementLampIndex]
+            || mElementStateBuffer[elementLampIndex].Lamp.IsSelfPowered;
+    }
+
+    /*
+     * Whether the lamp's state machine might transition without the circuit changing,
+     * other than because of a wet failure.
+     */
+    inline bool IsLampActive(
+        ElementIndex elementLampIndex,
+        SequenceNumber currentConnectivityVisitSequenceNumber) const
+    {
+        switch (mElementStateBuffer[elementLampIndex].Lamp.State)
+        {
+            case ElementState::LampState::StateType::LightOn:
+            {
+                // Watched by the lit lamps sweep
+                return false;
+            }
+
+            case ElementState::LampState::StateType::LightOff:
+            {
+                // Powered off lamps wait for the water to go away
+                return IsLampPowered(elementLampIndex, currentConnectivityVisitSequenceNumber);
+            }
+
+            default:
+            {
+                return true;
+            }
+        }
+    }
+
 private:
 
     //////////////////////////////////////////////////////////
@@ -326,12 +388,22 @@ private:
     World & mParentWorld;
     std::shared_ptr<IGameEventHandler> const mGameEventHandler;
 
-    // The handler registered for electrical element deletions
-    DestroyHandler mDestroyHandler;
+    // The ship registered for electrical element deletions
+    Ship * mShipHandler;
 
     // Indices of specific types in this container - just a shortcut
     std::vector<ElementIndex> mGenerators;
     std::vector<ElementIndex> mLamps;
+
+    // The lamps whose state machine we run at each step; all lamps are run
+    // whenever the circuit changes, and lit lamps are only swept periodically
+    // for wet failures, which are only checked that often anyway
+    std::vector<ElementIndex> mActiveLamps;
+    SequenceNumber mLastLampsConnectivityVisitSequenceNumber;
+    GameWallClock::time_point mNextLitLampsSweepTimePoint;
+
+    // Set when the current available to any lamp has changed since the flag was last cleared
+    bool mIsLampLightDirty;
 };
 
 }
@@ -6,6 +6,7 @@
 #include "Font.h"
 
 #include <GameCore/GameException.h>
+#include <GameCore/ResourceArchive.h>
 
 #include <cassert>
 #include <cstring>
@@ -91,17 +92,32 @@ Font Font::Load(std::filesystem::path const & filepath)
     // Read file
     //
 
-    std::error_code ec;
-    size_t const fileSize = std::filesystem::file_size(filepath, ec);
-    if (!!ec)
+    std::ifstream inputFile(filepath.string(), std::ios::binary | std::ios::in);
+    std::istream file(inputFile.rdbuf());
+
+    size_t fileSize;
+    std::unique_ptr<ResourceArchive::EntryStreamBuffer> archiveStreamBuffer;
+    if (inputFile.is_open())
     {
-        throw GameException("Cannot open file \"" + filepath.string() + "\"");
+        std::error_code ec;
+        fileSize = std::filesystem::file_size(filepath, ec);
+        if (!!ec)
+        {
+            throw GameException("Cannot open file \"" + filepath.string() + "\"");
+        }
     }
-
-    std::ifstream file(filepath.string(), std::ios::binary | std::ios::in);
-    if (!file.is_open())
+    else
     {
-        throw GameException("Cannot open file \"" + filepath.string() + "\"");
+        // Not loose, maybe it's packed
+        auto const archiveEntry = ResourceArchive::FindMounted(filepath);
+        if (!archiveEntry)
+        {
+            throw GameException("Cannot open file \"" + filepath.string() + "\"");
+        }
+
+        fileSize = archiveEntry->Size;
+        archiveStreamBuffer = std::make_unique<ResourceArchive::EntryStreamBuffer>(*archiveEntry);
+        file.rdbuf(archiveStreamBuffer.get());
     }
 
     static constexpr size_t HeaderSize = 276;
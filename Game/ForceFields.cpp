@@ -6,11 +6,22 @@
 #include "Physics.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace Physics {
 
+//
+// The fields that act on all points run branch-free over the whole buffers, so that the
+// compiler may vectorize them; normalise() yields zero at the center, and so do these
+// kernels, as there the displacement itself is zero
+//
+
+static constexpr float MinDisplacementLength = std::numeric_limits<float>::min();
+
 void DrawForceField::Apply(
     Points & points,
+    std::vector<ElementIndex> const & /*candidatePointIndices*/,
     float /*currentSimulationTime*/,
     GameParameters const & /*gameParameters*/) const
 {
@@ -18,17 +29,28 @@ void DrawForceField::Apply(
     // F = ForceStrength/sqrt(distance), along radius
     //
 
-    for (auto pointIndex : points)
+    vec2f const * restrict positionBuffer = points.GetPositionBufferAsVec2();
+    vec2f * restrict forceBuffer = points.GetForceBufferAsVec2();
+
+    size_t const count = points.GetElementCount();
+    for (size_t i = 0; i < count; ++i)
     {
-        vec2f displacement = (mCenterPosition - points.GetPosition(pointIndex));
-        float forceMagnitude = mStrength / sqrtf(0.1f + displacement.length());
+        float const dx = mCenterPosition.x - positionBuffer[i].x;
+        float const dy = mCenterPosition.y - positionBuffer[i].y;
+        float const displacementLength = std::sqrt(dx * dx + dy * dy);
 
-        points.GetForce(pointIndex) += displacement.normalise() * forceMagnitude;
+        float const forceFactor =
+            mStrength
+            / (std::sqrt(0.1f + displacementLength) * std::max(displacementLength, MinDisplacementLength));
+
+        forceBuffer[i].x += dx * forceFactor;
+        forceBuffer[i].y += dy * forceFactor;
     }
 }
 
 void SwirlForceField::Apply(
     Points & points,
+    std::vector<ElementIndex> const & /*candidatePointIndices*/,
     float /*currentSimulationTime*/,
     GameParameters const & /*gameParameters*/) const
 {
@@ -36,18 +58,26 @@ void SwirlForceField::Apply(
     // F = ForceStrength*radius/sqrt(distance), perpendicular to radius
     //
 
-    for (auto pointIndex : points)
+    vec2f const * restrict positionBuffer = points.GetPositionBufferAsVec2();
+    vec2f * restrict forceBuffer = points.GetForceBufferAsVec2();
+
+    size_t const count = points.GetElementCount();
+    for (size_t i = 0; i < count; ++i)
     {
-        vec2f displacement = (mCenterPosition - points.GetPosition(pointIndex));
-        float const displacementLength = displacement.length();
-        float forceMagnitude = mStrength / sqrtf(0.1f + displacementLength);
+        float const dx = mCenterPosition.x - positionBuffer[i].x;
+        float const dy = mCenterPosition.y - positionBuffer[i].y;
+        float const displacementLength = std::sqrt(dx * dx + dy * dy);
+
+        float const forceMagnitude = mStrength / std::sqrt(0.1f + displacementLength);
 
-        points.GetForce(pointIndex) += vec2f(-displacement.y, displacement.x) * forceMagnitude;
+        forceBuffer[i].x += -dy * forceMagnitude;
+        forceBuffer[i].y += dx * forceMagnitude;
     }
 }
 
 void BlastForceField::Apply(
     Points & points,
+    std::vector<ElementIndex> const & candidatePointIndices,
     float currentSimulationTime,
     GameParameters const & gameParameters) const
 {
@@ -65,8 +95,11 @@ void BlastForceField::Apply(
     ElementIndex closestPointIndex = NoneElementIndex;
 
     // Visit all (non-ephemeral) points (ephemerals would be blown immediately away otherwise)
-    for (auto pointIndex : points.NonEphemeralPoints())
+    for (auto pointIndex : candidatePointIndices)
     {
+        if (Points::EphemeralType::None != points.GetEphemeralType(pointIndex))
+            continue;
+
         vec2f pointRadius = points.GetPosition(pointIndex) - mCenterPosition;
         float squarePointDistance = pointRadius.squareLength();
         if (squarePointDistance < squareBlastRadius)
@@ -114,10 +147,11 @@ void BlastForceField::Apply(
 
 void RadialSpaceWarpForceField::Apply(
     Points & points,
+    std::vector<ElementIndex> const & candidatePointIndices,
     float /*currentSimulationTime*/,
     GameParameters const & /*gameParameters*/) const
 {
-    for (auto pointIndex : points)
+    for (auto pointIndex : candidatePointIndices)
     {
         vec2f const pointRadius = points.GetPosition(pointIndex) - mCenterPosition;
         float const pointDistanceFromRadius = pointRadius.length() - mRadius;
@@ -138,37 +172,49 @@ void RadialSpaceWarpForceField::Apply(
 
 void ImplosionForceField::Apply(
     Points & points,
+    std::vector<ElementIndex> const & /*candidatePointIndices*/,
     float /*currentSimulationTime*/,
     GameParameters const & /*gameParameters*/) const
 {
-    for (auto pointIndex : points)
+    vec2f const * restrict positionBuffer = points.GetPositionBufferAsVec2();
+    float const * restrict totalMassBuffer = points.GetTotalMassBufferAsFloat();
+    vec2f * restrict forceBuffer = points.GetForceBufferAsVec2();
+
+    size_t const count = points.GetElementCount();
+    for (size_t i = 0; i < count; ++i)
     {
-        vec2f displacement = (mCenterPosition - points.GetPosition(pointIndex));
-        float const displacementLength = displacement.length();
-        vec2f normalizedDisplacement = displacement.normalise(displacementLength);
+        float const dx = mCenterPosition.x - positionBuffer[i].x;
+        float const dy = mCenterPosition.y - positionBuffer[i].y;
+        float const displacementLength = std::sqrt(dx * dx + dy * dy);
+
+        float const inverseDisplacementLength = 1.0f / std::max(displacementLength, MinDisplacementLength);
+        float const normalizedDx = dx * inverseDisplacementLength;
+        float const normalizedDy = dy * inverseDisplacementLength;
 
         // Make final acceleration somewhat independent from mass
-        float const massNormalization = points.GetTotalMass(pointIndex) / 50.0f;
+        float const massNormalization = totalMassBuffer[i] / 50.0f;
 
         // Angular (constant)
-        points.GetForce(pointIndex) +=
-            vec2f(-normalizedDisplacement.y, normalizedDisplacement.x)
-            * mStrength
+        float const angularMagnitude =
+            mStrength
             * massNormalization
             / 10.0f; // Magic number
 
         // Radial (stronger when closer)
-        points.GetForce(pointIndex) +=
-            normalizedDisplacement
-            * mStrength
-            / (0.2f + sqrt(displacementLength))
+        float const radialMagnitude =
+            mStrength
+            / (0.2f + std::sqrt(displacementLength))
             * massNormalization
             * 10.0f; // Magic number
+
+        forceBuffer[i].x += -normalizedDy * angularMagnitude + normalizedDx * radialMagnitude;
+        forceBuffer[i].y += normalizedDx * angularMagnitude + normalizedDy * radialMagnitude;
     }
 }
 
 void RadialExplosionForceField::Apply(
     Points & points,
+    std::vector<ElementIndex> const & /*candidatePointIndices*/,
     float /*currentSimulationTime*/,
     GameParameters const & /*gameParameters*/) const
 {
@@ -176,12 +222,22 @@ void RadialExplosionForceField::Apply(
     // F = ForceStrength/sqrt(distance), along radius
     //
 
-    for (auto pointIndex : points)
+    vec2f const * restrict positionBuffer = points.GetPositionBufferAsVec2();
+    vec2f * restrict forceBuffer = points.GetForceBufferAsVec2();
+
+    size_t const count = points.GetElementCount();
+    for (size_t i = 0; i < count; ++i)
     {
-        vec2f displacement = (points.GetPosition(pointIndex) - mCenterPosition);
-        float forceMagnitude = mStrength / sqrtf(0.1f + displacement.length());
+        float const dx = positionBuffer[i].x - mCenterPosition.x;
+        float const dy = positionBuffer[i].y - mCenterPosition.y;
+        float const displacementLength = std::sqrt(dx * dx + dy * dy);
+
+        float const forceFactor =
+            mStrength
+            / (std::sqrt(0.1f + displacementLength) * std::max(displacementLength, MinDisplacementLength));
 
-        points.GetForce(pointIndex) += displacement.normalise() * forceMagnitude;
+        forceBuffer[i].x += dx * forceFactor;
+        forceBuffer[i].y += dy * forceFactor;
     }
 }
 
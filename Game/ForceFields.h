@@ -8,11 +8,96 @@
 #include "GameParameters.h"
 #include "Physics.h"
 
+#include <GameCore/GameTypes.h>
 #include <GameCore/Vectors.h>
 
+#include <cmath>
+#include <optional>
+#include <vector>
+
 namespace Physics
 {
 
+/*
+ * The parameters of a force field whose force at a point only depends on the point's position
+ * and mass, so that point kernels may evaluate it inline, while already visiting the point,
+ * rather than having the field walk all points in Apply().
+ */
+struct PackedForceField
+{
+    enum class FieldType
+    {
+        Draw,
+        Swirl,
+        RadialSpaceWarp,
+        Implosion,
+        RadialExplosion
+    };
+
+    FieldType Type;
+    vec2f CenterPosition;
+    float Strength;
+    float Radius; // RadialSpaceWarp only
+    float RadiusThickness; // RadialSpaceWarp only
+
+    // Equivalent to the field's Apply() on a single point
+    inline vec2f CalculateForce(
+        vec2f const & position,
+        float totalMass) const
+    {
+        switch (Type)
+        {
+            case FieldType::Draw:
+            {
+                vec2f const displacement = CenterPosition - position;
+                float const displacementLength = displacement.length();
+                return displacement.normalise(displacementLength) * (Strength / std::sqrt(0.1f + displacementLength));
+            }
+
+            case FieldType::Swirl:
+            {
+                vec2f const displacement = CenterPosition - position;
+                return vec2f(-displacement.y, displacement.x) * (Strength / std::sqrt(0.1f + displacement.length()));
+            }
+
+            case FieldType::RadialSpaceWarp:
+            {
+                vec2f const pointRadius = position - CenterPosition;
+                float const pointRadiusLength = pointRadius.length();
+                float const pointDistanceFromRadius = pointRadiusLength - Radius;
+                float const absolutePointDistanceFromRadius = std::abs(pointDistanceFromRadius);
+                if (absolutePointDistanceFromRadius > RadiusThickness)
+                    return vec2f::zero();
+
+                float const direction = pointDistanceFromRadius >= 0.0f ? 1.0f : -1.0f;
+                return pointRadius.normalise(pointRadiusLength)
+                    * (Strength * (1.0f - absolutePointDistanceFromRadius / RadiusThickness) * direction);
+            }
+
+            case FieldType::Implosion:
+            {
+                vec2f const displacement = CenterPosition - position;
+                float const displacementLength = displacement.length();
+                vec2f const normalizedDisplacement = displacement.normalise(displacementLength);
+                float const massNormalization = totalMass / 50.0f;
+
+                return
+                    vec2f(-normalizedDisplacement.y, normalizedDisplacement.x) * (Strength * massNormalization / 10.0f)
+                    + normalizedDisplacement * (Strength / (0.2f + std::sqrt(displacementLength)) * massNormalization * 10.0f);
+            }
+
+            case FieldType::RadialExplosion:
+            {
+                vec2f const displacement = position - CenterPosition;
+                float const displacementLength = displacement.length();
+                return displacement.normalise(displacementLength) * (Strength / std::sqrt(0.1f + displacementLength));
+            }
+        }
+
+        return vec2f::zero();
+    }
+};
+
 /*
  * This class represents an abstract force field that works on points.
  */
@@ -23,10 +108,46 @@ public:
     virtual ~ForceField()
     {}
 
+    vec2f const & GetCenterPosition() const
+    {
+        return mCenterPosition;
+    }
+
+    /*
+     * The radius of the circle around the center outside of which the field has no effect;
+     * fields that act on all points have none.
+     */
+    virtual std::optional<float> GetEffectiveRadius() const
+    {
+        return std::nullopt;
+    }
+
+    /*
+     * The field's parameters for evaluating it inline, for fields that can be.
+     */
+    virtual std::optional<PackedForceField> Pack() const
+    {
+        return std::nullopt;
+    }
+
+    /*
+     * Applies the field. Fields with an effective radius only visit the candidate points,
+     * which are guaranteed to include all the points within the radius; the other fields
+     * visit all points and ignore the candidates.
+     */
     virtual void Apply(
         Points & points,
+        std::vector<ElementIndex> const & candidatePointIndices,
         float currentSimulationTime,
         GameParameters const & gameParameters) const = 0;
+
+protected:
+
+    ForceField(vec2f const & centerPosition)
+        : mCenterPosition(centerPosition)
+    {}
+
+    vec2f const mCenterPosition;
 };
 
 /*
@@ -39,18 +160,23 @@ public:
     DrawForceField(
         vec2f const & centerPosition,
         float strength)
-        : mCenterPosition(centerPosition)
+        : ForceField(centerPosition)
         , mStrength(strength)
     {}
 
+    virtual std::optional<PackedForceField> Pack() const override
+    {
+        return PackedForceField{ PackedForceField::FieldType::Draw, mCenterPosition, mStrength, 0.0f, 0.0f };
+    }
+
     virtual void Apply(
         Points & points,
+        std::vector<ElementIndex> const & candidatePointIndices,
         float currentSimulationTime,
         GameParameters const & gameParameters) const override;
 
 private:
 
-    vec2f const mCenterPosition;
     float const mStrength;
 };
 
@@ -64,18 +190,23 @@ public:
     SwirlForceField(
         vec2f const & centerPosition,
         float strength)
-        : mCenterPosition(centerPosition)
+        : ForceField(centerPosition)
         , mStrength(strength)
     {}
 
+    virtual std::optional<PackedForceField> Pack() const override
+    {
+        return PackedForceField{ PackedForceField::FieldType::Swirl, mCenterPosition, mStrength, 0.0f, 0.0f };
+    }
+
     virtual void Apply(
         Points & points,
+        std::vector<ElementIndex> const & candidatePointIndices,
         float currentSimulationTime,
         GameParameters const & gameParameters) const override;
 
 private:
 
-    vec2f const mCenterPosition;
     float const mStrength;
 };
 
@@ -91,20 +222,25 @@ public:
         float blastRadius,
         float strength,
         bool detachPoint)
-        : mCenterPosition(centerPosition)
+        : ForceField(centerPosition)
         , mBlastRadius(blastRadius)
         , mStrength(strength)
         , mDetachPoint(detachPoint)
     {}
 
+    virtual std::optional<float> GetEffectiveRadius() const override
+    {
+        return mBlastRadius;
+    }
+
     virtual void Apply(
         Points & points,
+        std::vector<ElementIndex> const & candidatePointIndices,
         float currentSimulationTime,
         GameParameters const & gameParameters) const override;
 
 private:
 
-    vec2f const mCenterPosition;
     float const mBlastRadius;
     float const mStrength;
     bool const mDetachPoint;
@@ -122,20 +258,30 @@ public:
         float radius,
         float radiusThickness,
         float strength)
-        : mCenterPosition(centerPosition)
+        : ForceField(centerPosition)
         , mRadius(radius)
         , mRadiusThickness(radiusThickness)
         , mStrength(strength)
     {}
 
+    virtual std::optional<float> GetEffectiveRadius() const override
+    {
+        return mRadius + mRadiusThickness;
+    }
+
+    virtual std::optional<PackedForceField> Pack() const override
+    {
+        return PackedForceField{ PackedForceField::FieldType::RadialSpaceWarp, mCenterPosition, mStrength, mRadius, mRadiusThickness };
+    }
+
     virtual void Apply(
         Points & points,
+        std::vector<ElementIndex> const & candidatePointIndices,
         float currentSimulationTime,
         GameParameters const & gameParameters) const override;
 
 private:
 
-    vec2f const mCenterPosition;
     float const mRadius;
     float const mRadiusThickness;
     float const mStrength;
@@ -152,18 +298,23 @@ public:
     ImplosionForceField(
         vec2f const & centerPosition,
         float strength)
-        : mCenterPosition(centerPosition)
+        : ForceField(centerPosition)
         , mStrength(strength)
     {}
 
+    virtual std::optional<PackedForceField> Pack() const override
+    {
+        return PackedForceField{ PackedForceField::FieldType::Implosion, mCenterPosition, mStrength, 0.0f, 0.0f };
+    }
+
     virtual void Apply(
         Points & points,
+        std::vector<ElementIndex> const & candidatePointIndices,
         float currentSimulationTime,
         GameParameters const & gameParameters) const override;
 
 private:
 
-    vec2f const mCenterPosition;
     float const mStrength;
 };
 
@@ -177,18 +328,23 @@ public:
     RadialExplosionForceField(
         vec2f const & centerPosition,
         float strength)
-        : mCenterPosition(centerPosition)
+        : ForceField(centerPosition)
         , mStrength(strength)
     {}
 
+    virtual std::optional<PackedForceField> Pack() const override
+    {
+        return PackedForceField{ PackedForceField::FieldType::RadialExplosion, mCenterPosition, mStrength, 0.0f, 0.0f };
+    }
+
     virtual void Apply(
         Points & points,
+        std::vector<ElementIndex> const & candidatePointIndices,
         float currentSimulationTime,
         GameParameters const & gameParameters) const override;
 
 private:
 
-    vec2f const mCenterPosition;
     float const mStrength;
 };
 
@@ -0,0 +1,149 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-05-04
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "FrameRecorder.h"
+
+#include "ImageFileTools.h"
+
+#include <GameCore/GameException.h>
+#include <GameCore/Log.h>
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/Utils.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+FrameRecorder::FrameRecorder(
+    std::filesystem::path const & outputPath,
+    int fps)
+    : mOutputPath(outputPath)
+    , mFps(fps)
+    , mIsY4m(Utils::CaseInsensitiveEquals(outputPath.extension().string(), ".y4m"))
+    , mY4mStream()
+    , mY4mFrameSize(0, 0)
+    , mY4mPlanesBuffer()
+    , mWrittenFrameCount(0)
+{
+    assert(fps > 0);
+
+    if (mIsY4m)
+    {
+        if (mOutputPath.has_parent_path())
+            std::filesystem::create_directories(mOutputPath.parent_path());
+
+        mY4mStream = std::make_unique<std::ofstream>(mOutputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!mY4mStream->is_open())
+        {
+            throw GameException("Cannot open recording file \"" + mOutputPath.string() + "\"");
+        }
+    }
+    else
+    {
+        std::filesystem::create_directories(mOutputPath);
+    }
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    LogMessage("FrameRecorder: written ", mWrittenFrameCount, " frames to \"", mOutputPath.string(), "\"");
+}
+
+void FrameRecorder::WriteFrame(RgbImageData const & frame)
+{
+    bool const hasWritten = mIsY4m
+        ? WriteY4mFrame(frame)
+        : WritePngFrame(frame);
+
+    if (hasWritten)
+        ++mWrittenFrameCount;
+}
+
+bool FrameRecorder::WritePngFrame(RgbImageData const & frame)
+{
+    std::stringstream ssFilename;
+    ssFilename << "frame_" << std::setfill('0') << std::setw(6) << mWrittenFrameCount << ".png";
+
+    ImageFileTools::SaveImage(
+        mOutputPath / ssFilename.str(),
+        frame);
+
+    return true;
+}
+
+bool FrameRecorder::WriteY4mFrame(RgbImageData const & frame)
+{
+    assert(!!mY4mStream);
+
+    if (0 == mWrittenFrameCount)
+    {
+        //
+        // Write stream header; we use 4:4:4 so that frames need no chroma subsampling
+        //
+
+        mY4mFrameSize = frame.Size;
+
+        *mY4mStream
+            << "YUV4MPEG2"
+            << " W" << mY4mFrameSize.Width
+            << " H" << mY4mFrameSize.Height
+            << " F" << mFps << ":1"
+            << " Ip A1:1 C444\n";
+
+        mY4mPlanesBuffer.resize(3 * static_cast<size_t>(mY4mFrameSize.Width) * static_cast<size_t>(mY4mFrameSize.Height));
+    }
+    else if (frame.Size != mY4mFrameSize)
+    {
+        // A stream has one size only; the canvas must have been resized while recording
+        LogMessage("WARNING: FrameRecorder: dropping frame, as its size differs from the stream's");
+        return false;
+    }
+
+    //
+    // Convert RGB to full-range BT.601 YUV planes; frames are read with their origin at the
+    // bottom-left, while Y4M wants the top row first
+    //
+
+    int const width = mY4mFrameSize.Width;
+    int const height = mY4mFrameSize.Height;
+    size_t const planeSize = static_cast<size_t>(width) * static_cast<size_t>(height);
+
+    uint8_t * restrict const yPlane = mY4mPlanesBuffer.data();
+    uint8_t * restrict const uPlane = yPlane + planeSize;
+    uint8_t * restrict const vPlane = uPlane + planeSize;
+
+    auto const toByte = [](float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+    };
+
+    for (int y = 0; y < height; ++y)
+    {
+        rgbColor const * restrict const srcRow = &(frame.Data[static_cast<size_t>(height - 1 - y) * width]);
+        size_t const dstRowStart = static_cast<size_t>(y) * width;
+
+        for (int x = 0; x < width; ++x)
+        {
+            float const r = static_cast<float>(srcRow[x].r);
+            float const g = static_cast<float>(srcRow[x].g);
+            float const b = static_cast<float>(srcRow[x].b);
+
+            yPlane[dstRowStart + x] = toByte(0.299f * r + 0.587f * g + 0.114f * b);
+            uPlane[dstRowStart + x] = toByte(-0.168736f * r - 0.331264f * g + 0.5f * b + 128.0f);
+            vPlane[dstRowStart + x] = toByte(0.5f * r - 0.418688f * g - 0.081312f * b + 128.0f);
+        }
+    }
+
+    *mY4mStream << "FRAME\n";
+    mY4mStream->write(reinterpret_cast<char const *>(mY4mPlanesBuffer.data()), mY4mPlanesBuffer.size());
+
+    if (!mY4mStream->good())
+    {
+        throw GameException("Cannot write to recording file \"" + mOutputPath.string() + "\"");
+    }
+
+    return true;
+}
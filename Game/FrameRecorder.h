@@ -0,0 +1,56 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-05-04
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameCore/ImageData.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+/*
+ * Writes recorded frames to disk, either as a sequence of PNG files in a folder,
+ * or - when the output path has the .y4m extension - as a single raw YUV4MPEG2 stream.
+ *
+ * Frames are written synchronously; this class is meant to be run on a background thread.
+ */
+class FrameRecorder
+{
+public:
+
+    FrameRecorder(
+        std::filesystem::path const & outputPath,
+        int fps);
+
+    ~FrameRecorder();
+
+    void WriteFrame(RgbImageData const & frame);
+
+    size_t GetWrittenFrameCount() const
+    {
+        return mWrittenFrameCount;
+    }
+
+private:
+
+    bool WritePngFrame(RgbImageData const & frame);
+
+    bool WriteY4mFrame(RgbImageData const & frame);
+
+private:
+
+    std::filesystem::path const mOutputPath;
+    int const mFps;
+    bool const mIsY4m;
+
+    // Y4M state; the size of the stream is the size of its first frame
+    std::unique_ptr<std::ofstream> mY4mStream;
+    ImageSize mY4mFrameSize;
+    std::vector<uint8_t> mY4mPlanesBuffer;
+
+    size_t mWrittenFrameCount;
+};
@@ -5,9 +5,24 @@
 ***************************************************************************************/
 #include "GameController.h"
 
+#include <GPUCalc/GPUCalculatorFactory.h>
+
+#include <GameCore/BinaryFileTools.h>
+#include <GameCore/BulkStorageRecycler.h>
+#include <GameCore/FloatingPoint.h>
+#include <GameCore/GameException.h>
 #include <GameCore/GameMath.h>
+#include <GameCore/GameRandomEngine.h>
 #include <GameCore/Log.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <tuple>
+
 std::unique_ptr<GameController> GameController::Create(
     bool isStatusTextEnabled,
     bool isExtendedStatusTextEnabled,
@@ -19,7 +34,7 @@ std::unique_ptr<GameController> GameController::Create(
     MaterialDatabase materialDatabase = MaterialDatabase::Load(*resourceLoader);
 
     // Create game dispatcher
-    std::unique_ptr<GameEventDispatcher> gameEventDispatcher = std::make_unique<GameEventDispatcher>();
+    std::unique_ptr<GameEventDispatcher> gameEventDispatcher = std::make_unique<GameEventDispatcher>(materialDatabase.GetStructuralMaterialCount());
 
     // Create render context
     std::unique_ptr<Render::RenderContext> renderContext = std::make_unique<Render::RenderContext>(
@@ -48,6 +63,22 @@ std::unique_ptr<GameController> GameController::Create(
             resourceLoader));
 }
 
+GameController::~GameController()
+{
+    // Loading threads use our material database
+    CancelShipLoad();
+    for (auto & shipLoad : mCancelledShipLoads)
+    {
+        shipLoad->Thread.join();
+    }
+
+    StopSimulationThread();
+    StopScreenshotThread();
+
+    if (mSnapshotWriterThread.joinable())
+        mSnapshotWriterThread.join();
+}
+
 void GameController::RegisterGameEventHandler(IGameEventHandler * gameEventHandler)
 {
     assert(!!mGameEventDispatcher);
@@ -56,11 +87,11 @@ void GameController::RegisterGameEventHandler(IGameEventHandler * gameEventHandl
 
 ShipMetadata GameController::ResetAndLoadShip(std::filesystem::path const & shipDefinitionFilepath)
 {
+    // This load supersedes any asynchronous one
+    CancelShipLoad();
+
     // Create a new world
-    auto newWorld = std::make_unique<Physics::World>(
-        mGameEventDispatcher,
-        mGameParameters,
-        *mResourceLoader);
+    auto newWorld = MakeWorld();
 
     // Load ship definition
     auto shipDefinition = ShipDefinition::Load(shipDefinitionFilepath);
@@ -93,14 +124,27 @@ ShipMetadata GameController::AddShip(std::filesystem::path const & shipDefinitio
     // Load ship definition
     auto shipDefinition = ShipDefinition::Load(shipDefinitionFilepath);
 
+    return AddShip(
+        std::move(shipDefinition),
+        shipDefinitionFilepath);
+}
+
+ShipMetadata GameController::AddShip(
+    ShipDefinition shipDefinition,
+    std::filesystem::path const & shipDefinitionFilepath)
+{
     // Save metadata
     ShipMetadata shipMetadata(shipDefinition.Metadata);
 
     // Load ship into current world
-    ShipId shipId = mWorld->AddShip(
-        shipDefinition,
-        mMaterialDatabase,
-        mGameParameters);
+    ShipId shipId = RunWorldQuery(
+        [this, &shipDefinition](Physics::World & world, GameParameters const & gameParameters)
+        {
+            return world.AddShip(
+                shipDefinition,
+                mMaterialDatabase,
+                gameParameters);
+        });
 
     //
     // No errors, so we may continue
@@ -116,11 +160,11 @@ ShipMetadata GameController::AddShip(std::filesystem::path const & shipDefinitio
 
 void GameController::ReloadLastShip()
 {
+    // This load supersedes any asynchronous one
+    CancelShipLoad();
+
     // Create a new world
-    auto newWorld = std::make_unique<Physics::World>(
-        mGameEventDispatcher,
-        mGameParameters,
-        *mResourceLoader);
+    auto newWorld = MakeWorld();
 
     // Load ship definition
 
@@ -149,272 +193,1092 @@ void GameController::ReloadLastShip()
         shipId);
 }
 
+void GameController::ResetAndLoadShipAsync(
+    std::filesystem::path const & shipDefinitionFilepath,
+    ProgressCallback progressCallback,
+    ShipLoadCompletionCallback completionCallback)
+{
+    CancelShipLoad();
+
+    // Create the new world here, as creating it fires world events
+    mShipLoad = std::make_unique<ShipLoad>(
+        shipDefinitionFilepath,
+        std::move(progressCallback),
+        std::move(completionCallback),
+        MakeWorld());
+
+    //
+    // The loading thread only touches the new world - whose ship fires its events into
+    // its own buffer, until the world is ours - and the state of the load
+    //
+
+    mShipLoad->Thread = std::thread(
+        [this, shipLoad = mShipLoad.get(), gameParameters = mGameParameters]()
+        {
+            // Builds - and thus runs the first calculations of - the ship
+            InitializeSimulationThreadFloatingPoint();
+
+            auto const reportProgress = [shipLoad](float progress, std::string const & message)
+            {
+                std::lock_guard<std::mutex> lock(shipLoad->Mutex);
+                shipLoad->PendingProgress.emplace(progress, message);
+            };
+
+            try
+            {
+                reportProgress(0.5f, "Loading ship...");
+
+                auto shipDefinition = ShipDefinition::Load(shipLoad->ShipDefinitionFilepath);
+
+                if (!shipLoad->IsCancelled)
+                {
+                    reportProgress(1.0f, "Building ship...");
+
+                    ShipId const shipId = shipLoad->NewWorld->AddShip(
+                        shipDefinition,
+                        mMaterialDatabase,
+                        gameParameters);
+
+                    std::lock_guard<std::mutex> lock(shipLoad->Mutex);
+                    shipLoad->LoadedShipDefinition.emplace(std::move(shipDefinition));
+                    shipLoad->LoadedShipId = shipId;
+                }
+            }
+            catch (std::exception const & ex)
+            {
+                std::lock_guard<std::mutex> lock(shipLoad->Mutex);
+                shipLoad->ErrorMessage = ex.what();
+            }
+
+            std::lock_guard<std::mutex> lock(shipLoad->Mutex);
+            shipLoad->IsCompleted = true;
+        });
+}
+
+void GameController::CancelShipLoad()
+{
+    if (!mShipLoad)
+        return;
+
+    // Don't wait for the thread, it'll be reaped at a later iteration
+    mShipLoad->IsCancelled = true;
+    mCancelledShipLoads.push_back(std::move(mShipLoad));
+}
+
 RgbImageData GameController::TakeScreenshot()
 {
     return mRenderContext->TakeScreenshot();
 }
 
-void GameController::RunGameIteration()
+void GameController::StartScreenshotBurst(
+    size_t frameCount,
+    ScreenshotHandler screenshotHandler)
 {
-    ///////////////////////////////////////////////////////////
-    // Update simulation
-    ///////////////////////////////////////////////////////////
-
-    // Make sure we're not paused
-    if (!mIsPaused && !mIsMoveToolEngaged)
-    {
-        auto const startTime = std::chrono::steady_clock::now();
+    mScreenshotBurstRemainingFrameCount = frameCount;
+    mScreenshotBurstHandler = std::move(screenshotHandler);
 
-        InternalUpdate();
+    EnsureScreenshotThreadRunning();
+}
 
-        auto const endTime = std::chrono::steady_clock::now();
-        mTotalUpdateDuration += endTime - startTime;
+void GameController::StartRecording(
+    std::filesystem::path const & outputPath,
+    int fps)
+{
+    if (fps <= 0)
+    {
+        throw GameException("The recording frame rate must be positive");
     }
 
+    // Stop the recording in progress, if any
+    StopRecording();
 
-    ///////////////////////////////////////////////////////////
-    // Render
-    ///////////////////////////////////////////////////////////
+    mFrameRecorder = std::make_shared<FrameRecorder>(outputPath, fps);
+    mRecordingFramePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(1.0f / static_cast<float>(fps)));
+    mNextRecordingFrameTimestamp = std::chrono::steady_clock::now();
+    mDroppedScreenshotCount = 0;
 
-    //
-    // Initialize render stats, if needed
-    //
+    EnsureScreenshotThreadRunning();
+}
 
-    if (mRenderStatsOriginTimestampReal == std::chrono::steady_clock::time_point::min())
-    {
-        assert(mRenderStatsLastTimestampReal == std::chrono::steady_clock::time_point::min());
+void GameController::StopRecording()
+{
+    if (!mFrameRecorder)
+        return;
 
-        std::chrono::steady_clock::time_point nowReal = std::chrono::steady_clock::now();
-        mRenderStatsOriginTimestampReal = nowReal;
-        mRenderStatsLastTimestampReal = nowReal;
+    LogMessage("GameController::StopRecording(): dropped ", mDroppedScreenshotCount, " frames");
 
-        mTotalFrameCount = 0u;
-        mLastFrameCount = 0u;
+    // The frames still queued keep the recorder alive until they're written
+    mFrameRecorder.reset();
+}
 
-        // In order to start from zero at first render, take global origin here
-        mOriginTimestampGame = nowReal;
+void GameController::SaveShipPerfStats(std::filesystem::path const & outputFilepath) const
+{
+    auto const shipPerfStats = RunWorldQuery(
+        [](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            return world.GetShipPerfStats();
+        });
 
-        // Render initial status text
-        PublishStats(nowReal);
+    std::ofstream outputFile(outputFilepath, std::ios::out | std::ios::trunc);
+    if (!outputFile.is_open())
+    {
+        throw GameException("Cannot open file \"" + outputFilepath.string() + "\" for writing");
     }
 
+    outputFile << "Phase,TotalMillis,AverageMillis" << std::endl;
 
-    //
-    // Render
-    //
+    for (size_t p = 0; p < Physics::ShipPerfStats::PhaseCount; ++p)
+    {
+        auto const phase = static_cast<Physics::ShipPerfStats::Phase>(p);
 
-    auto const startTime = std::chrono::steady_clock::now();
+        outputFile
+            << Physics::ShipPerfStats::GetPhaseName(phase)
+            << "," << std::chrono::duration<float, std::milli>(shipPerfStats[phase]).count()
+            << "," << shipPerfStats.GetAverageMillis(phase)
+            << std::endl;
+    }
 
-    // Flip the (previous) back buffer onto the screen
-    mSwapRenderBuffersFunction();
+    outputFile << "Updates," << shipPerfStats.UpdateCount << "," << std::endl;
+}
 
-    // Render
-    InternalRender();
+MemoryReport GameController::GetMemoryReport() const
+{
+    MemoryReport memoryReport = RunWorldQuery(
+        [](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            MemoryReport worldMemoryReport;
 
-    auto const endTime = std::chrono::steady_clock::now();
-    mTotalRenderDuration += endTime - startTime;
+            worldMemoryReport.PushSection("CPU");
+            world.ReportMemory(worldMemoryReport);
+            worldMemoryReport.PopSection();
 
+            return worldMemoryReport;
+        });
 
-    //
-    // Update stats
-    //
+    memoryReport.PushSection("CPU");
+    memoryReport.Add("RecycledStorage", BulkStorageRecycler::GetInstance().GetRetainedByteSize());
+    memoryReport.PopSection();
 
-    ++mTotalFrameCount;
-    ++mLastFrameCount;
+    mRenderContext->ReportMemory(memoryReport);
+
+    return memoryReport;
 }
 
-void GameController::LowFrequencyUpdate()
+void GameController::SaveMemoryReport(std::filesystem::path const & outputFilepath) const
 {
-    std::chrono::steady_clock::time_point nowReal = std::chrono::steady_clock::now();
+    auto const memoryReport = GetMemoryReport();
 
-    if (mSkippedFirstStatPublishes >= 1)
+    std::ofstream outputFile(outputFilepath, std::ios::out | std::ios::trunc);
+    if (!outputFile.is_open())
     {
-        //
-        // Publish stats
-        //
-
-
-        PublishStats(nowReal);
-
-        //
-        // Reset stats
-        //
-
-        mLastFrameCount = 0u;
-        mLastTotalUpdateDuration = mTotalUpdateDuration;
-        mLastTotalRenderDuration = mTotalRenderDuration;
+        throw GameException("Cannot open file \"" + outputFilepath.string() + "\" for writing");
     }
-    else
-    {
-        //
-        // Skip the first few publish as rates are too polluted
-        //
 
-        mTotalFrameCount = 0u;
-        mLastFrameCount = 0u;
-        mRenderStatsOriginTimestampReal = nowReal;
+    outputFile << "Buffer,Bytes" << std::endl;
 
-        ++mSkippedFirstStatPublishes;
+    for (auto const & entry : memoryReport.GetEntries())
+    {
+        outputFile << entry.Path << "," << entry.ByteSize << std::endl;
     }
 
-    mRenderStatsLastTimestampReal = nowReal;
+    outputFile << "CPU," << memoryReport.GetTotalByteSize("CPU") << std::endl;
+    outputFile << "GPU," << memoryReport.GetTotalByteSize("GPU") << std::endl;
 }
 
-void GameController::Update()
-{
-    InternalUpdate();
+namespace /* anonymous */ {
+
+    // Bump whenever the layout of the snapshot changes
+    static constexpr char WorldSnapshotMagic[4] = { 'F', 'S', 'W', 'S' };
+    static constexpr std::uint32_t WorldSnapshotVersion = 1;
 }
 
-void GameController::Render()
+void GameController::SaveWorldSnapshot(std::filesystem::path const & outputFilepath)
 {
-    InternalRender();
-}
+    if (mLastShipLoadedFilepath.empty())
+    {
+        throw GameException("No ship has been loaded yet");
+    }
 
-/////////////////////////////////////////////////////////////
-// Interactions
-/////////////////////////////////////////////////////////////
+    //
+    // Serialize in memory, in between simulation steps
+    //
 
-void GameController::SetPaused(bool isPaused)
-{
-    mIsPaused = isPaused;
-}
+    auto stream = std::make_shared<std::ostringstream>(std::ios::binary | std::ios::out);
 
-void GameController::SetMoveToolEngaged(bool isEngaged)
-{
-    mIsMoveToolEngaged = isEngaged;
-}
+    stream->write(WorldSnapshotMagic, sizeof(WorldSnapshotMagic));
+    BinaryFileTools::Write<std::uint32_t>(*stream, WorldSnapshotVersion);
+    BinaryFileTools::WriteString(*stream, mLastShipLoadedFilepath.u8string());
 
-void GameController::SetStatusTextEnabled(bool isEnabled)
-{
-    assert(!!mTextLayer);
-    mTextLayer->SetStatusTextEnabled(isEnabled);
-}
+    RunWorldQuery(
+        [&stream](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            world.SaveState(*stream);
+        });
 
-void GameController::SetExtendedStatusTextEnabled(bool isEnabled)
-{
-    assert(!!mTextLayer);
-    mTextLayer->SetExtendedStatusTextEnabled(isEnabled);
-}
+    //
+    // Write to disk in the background
+    //
 
-void GameController::MoveBy(
-    ShipId shipId,
-    vec2f const & screenOffset)
-{
-    vec2f const worldOffset = mRenderContext->ScreenOffsetToWorldOffset(screenOffset);
+    if (mSnapshotWriterThread.joinable())
+        mSnapshotWriterThread.join();
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->MoveBy(
-        shipId,
-        worldOffset,
-        mGameParameters);
+    mSnapshotWriterThread = std::thread(
+        [stream, outputFilepath]()
+        {
+            std::ofstream file(outputFilepath.string(), std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!file.is_open())
+            {
+                LogMessage("ERROR: GameController::SaveWorldSnapshot(): cannot open file \"", outputFilepath.string(), "\" for writing");
+                return;
+            }
+
+            std::string const & data = stream->str();
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file.good())
+            {
+                LogMessage("ERROR: GameController::SaveWorldSnapshot(): error writing file \"", outputFilepath.string(), "\"");
+                return;
+            }
+
+            LogMessage("GameController::SaveWorldSnapshot(): saved ", data.size(), " bytes");
+        });
 }
 
-void GameController::RotateBy(
-    ShipId shipId,
-    float screenDeltaY,
-    vec2f const & screenCenter)
+ShipMetadata GameController::RestoreWorldSnapshot(std::filesystem::path const & snapshotFilepath)
 {
-    float const angle =
-        2.0f * Pi<float>
-        / static_cast<float>(mRenderContext->GetCanvasHeight())
-        * screenDeltaY;
+    // The previous snapshot might be the one we're asked to restore
+    if (mSnapshotWriterThread.joinable())
+        mSnapshotWriterThread.join();
 
-    vec2f const worldCenter = mRenderContext->ScreenToWorld(screenCenter);
+    std::ifstream file(snapshotFilepath.string(), std::ios::binary | std::ios::in);
+    if (!file.is_open())
+    {
+        throw GameException("Cannot open file \"" + snapshotFilepath.string() + "\"");
+    }
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->RotateBy(
-        shipId,
-        angle,
-        worldCenter,
-        mGameParameters);
-}
+    // Read it all at once, so that we may parse it from memory
+    std::istringstream stream(
+        std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()),
+        std::ios::binary | std::ios::in);
 
-void GameController::DestroyAt(
-    vec2f const & screenCoordinates,
-    float radiusMultiplier)
-{
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    char magic[sizeof(WorldSnapshotMagic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream.good() || 0 != std::memcmp(magic, WorldSnapshotMagic, sizeof(magic)))
+    {
+        throw GameException("File \"" + snapshotFilepath.string() + "\" is not a world snapshot");
+    }
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->DestroyAt(
-        worldCoordinates,
-        radiusMultiplier,
-        mGameParameters);
-}
+    if (BinaryFileTools::Read<std::uint32_t>(stream) != WorldSnapshotVersion)
+    {
+        throw GameException("File \"" + snapshotFilepath.string() + "\" is a world snapshot of an unsupported version");
+    }
 
-void GameController::RepairAt(
-    vec2f const & screenCoordinates,
-    float radiusMultiplier)
-{
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    auto const shipDefinitionFilepath = std::filesystem::u8path(BinaryFileTools::ReadString(stream));
+    if (!stream.good())
+    {
+        throw GameException("World snapshot \"" + snapshotFilepath.string() + "\" is truncated");
+    }
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->RepairAt(
-        worldCoordinates,
-        radiusMultiplier,
-        mGameParameters);
-}
+    ShipMetadata shipMetadata = ResetAndLoadShip(shipDefinitionFilepath);
 
-void GameController::SawThrough(
-    vec2f const & startScreenCoordinates,
-    vec2f const & endScreenCoordinates)
-{
-    vec2f const startWorldCoordinates = mRenderContext->ScreenToWorld(startScreenCoordinates);
-    vec2f const endWorldCoordinates = mRenderContext->ScreenToWorld(endScreenCoordinates);
+    RunWorldQuery(
+        [&stream](Physics::World & world, GameParameters const & gameParameters)
+        {
+            world.LoadState(stream, gameParameters);
+        });
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->SawThrough(
-        startWorldCoordinates,
-        endWorldCoordinates,
-        mGameParameters);
+    mIsWorldDirtyForRendering = true;
+
+    return shipMetadata;
 }
 
-void GameController::DrawTo(
-    vec2f const & screenCoordinates,
-    float strengthMultiplier)
+void GameController::StartTracing()
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    if (IsTracing())
+    {
+        throw GameException("A trace is already being collected");
+    }
 
-    float strength = 2000.0f * strengthMultiplier;
+    // We're invoked on the thread that runs the game iterations
+    TraceLog::GetInstance().SetCurrentThreadName("Main");
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->DrawTo(
-        worldCoordinates,
-        strength,
-        mGameParameters);
+    TraceLog::GetInstance().Start();
 }
 
-void GameController::SwirlAt(
-    vec2f const & screenCoordinates,
-    float strengthMultiplier)
+void GameController::StopTracing(std::filesystem::path const & outputFilepath)
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
-
-    float strength = 30.0f * strengthMultiplier;
+    if (!IsTracing())
+    {
+        throw GameException("No trace is being collected");
+    }
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->SwirlAt(
-        worldCoordinates,
-        strength,
-        mGameParameters);
+    TraceLog::GetInstance().Stop(outputFilepath);
 }
 
-void GameController::TogglePinAt(vec2f const & screenCoordinates)
+ShipMetadata GameController::StartReplayRecording(
+    std::filesystem::path const & shipDefinitionFilepath,
+    unsigned int randomSeed)
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    if (IsRecordingReplay())
+    {
+        throw GameException("A replay is already being recorded");
+    }
+
+    // We need the world to ourselves while we reset it
+    bool const wasSimulationThreadRunning = IsSimulationThreadRunning();
+    StopSimulationThread();
+
+    // Make the session reproducible from here
+    GameRandomEngine::GetInstance().Reseed(randomSeed);
+    GameWallClock::GetInstance().SetManual(true);
+
+    try
+    {
+        ShipMetadata shipMetadata = ResetAndLoadShip(shipDefinitionFilepath);
+
+        {
+            std::lock_guard<std::mutex> lock(mReplayRecordingMutex);
+
+            mReplayRecording = std::make_unique<ReplayLog>(
+                shipDefinitionFilepath,
+                randomSeed,
+                ImageSize(mRenderContext->GetCanvasWidth(), mRenderContext->GetCanvasHeight()));
+
+            // Record the initial state
+            mReplayRecording->GameParametersSnapshots.push_back(mGameParameters);
+            mReplayRecording->Events.push_back(ReplayLog::Event::MakeGameParameters(0, 0));
+            mLastRecordedGameParameters = mGameParameters;
+
+            mLastRecordedCameraWorldPosition = mRenderContext->GetCameraWorldPosition();
+            mLastRecordedZoom = mRenderContext->GetZoom();
+            mReplayRecording->Events.push_back(
+                ReplayLog::Event::MakeView(0, mLastRecordedCameraWorldPosition, mLastRecordedZoom));
+        }
+
+        if (wasSimulationThreadRunning)
+            StartSimulationThread();
+
+        return shipMetadata;
+    }
+    catch (...)
+    {
+        GameWallClock::GetInstance().SetManual(false);
+
+        if (wasSimulationThreadRunning)
+            StartSimulationThread();
+
+        throw;
+    }
+}
+
+void GameController::StopReplayRecording(std::filesystem::path const & outputFilepath)
+{
+    std::unique_ptr<ReplayLog> replayLog;
+
+    {
+        std::lock_guard<std::mutex> lock(mReplayRecordingMutex);
+        replayLog = std::move(mReplayRecording);
+    }
+
+    if (!replayLog)
+        return;
+
+    GameWallClock::GetInstance().SetManual(false);
+
+    replayLog->Save(outputFilepath);
+
+    LogMessage("GameController::StopReplayRecording(): recorded ", replayLog->StepCount, " steps and ",
+        replayLog->Events.size(), " events");
+}
+
+ReplayStatistics GameController::RunReplay(
+    std::filesystem::path const & replayLogFilepath,
+    ProgressCallback const & progressCallback)
+{
+    if (IsRecordingReplay())
+    {
+        throw GameException("Cannot run a replay while recording one");
+    }
+
+    ReplayLog const replayLog = ReplayLog::Load(replayLogFilepath);
+
+    if (replayLog.GameParametersSnapshots.empty())
+    {
+        throw GameException("Replay log \"" + replayLogFilepath.string() + "\" has no game parameters");
+    }
+
+    // We run the steps ourselves
+    bool const wasSimulationThreadRunning = IsSimulationThreadRunning();
+    StopSimulationThread();
+
+    GameParameters const originalGameParameters = mGameParameters;
+
+    // Reproduce the state the recording started from
+    GameRandomEngine::GetInstance().Reseed(replayLog.RandomSeed);
+    GameWallClock::GetInstance().SetManual(true);
+
+    ReplayStatistics statistics;
+
+    try
+    {
+        mGameParameters = replayLog.GameParametersSnapshots[0];
+
+        ResetAndLoadShip(replayLog.ShipDefinitionFilepath);
+
+        if (mRenderContext->GetCanvasWidth() != replayLog.CanvasSize.Width
+            || mRenderContext->GetCanvasHeight() != replayLog.CanvasSize.Height)
+        {
+            LogMessage("WARNING: GameController::RunReplay(): the canvas size differs from the recorded one (",
+                replayLog.CanvasSize.Width, "x", replayLog.CanvasSize.Height, "), the replay might diverge");
+        }
+
+        auto const stepDuration = std::chrono::duration_cast<GameWallClock::duration>(
+            std::chrono::duration<float>(GameParameters::SimulationStepTimeDuration<float>));
+
+        size_t iEvent = 0;
+        for (std::uint64_t step = 0; step < replayLog.StepCount; ++step)
+        {
+            // Apply the inputs of this step
+            for (; iEvent < replayLog.Events.size() && replayLog.Events[iEvent].Step == step; ++iEvent)
+            {
+                auto const & event = replayLog.Events[iEvent];
+                switch (event.Type)
+                {
+                    case ReplayLog::Event::EventType::GameParameters:
+                    {
+                        if (event.GameParametersIndex >= replayLog.GameParametersSnapshots.size())
+                        {
+                            throw GameException("Replay log \"" + replayLogFilepath.string() + "\" is corrupted");
+                        }
+
+                        mGameParameters = replayLog.GameParametersSnapshots[event.GameParametersIndex];
+                        break;
+                    }
+
+                    case ReplayLog::Event::EventType::View:
+                    {
+                        mTargetCameraPosition = mCurrentCameraPosition = mRenderContext->SetCameraWorldPosition(event.CameraWorldPosition);
+                        mTargetZoom = mCurrentZoom = mRenderContext->SetZoom(event.Zoom);
+                        break;
+                    }
+
+                    case ReplayLog::Event::EventType::Command:
+                    {
+                        event.Command.Apply(*mWorld, mGameParameters);
+                        break;
+                    }
+                }
+            }
+
+            auto const startTime = std::chrono::steady_clock::now();
+
+            UpdateWorld(mGameParameters);
+
+            auto const updateDuration = std::chrono::steady_clock::now() - startTime;
+
+            ++statistics.StepCount;
+            statistics.TotalUpdateDuration += updateDuration;
+            statistics.MinUpdateDuration = std::min(statistics.MinUpdateDuration, updateDuration);
+            statistics.MaxUpdateDuration = std::max(statistics.MaxUpdateDuration, updateDuration);
+
+            GameWallClock::GetInstance().Advance(stepDuration);
+
+            // Don't let the events pile up
+            mWorldGameEventChannel->Drain();
+            mGameEventDispatcher->Flush();
+
+            if (!!progressCallback && (step % 64) == 0)
+            {
+                progressCallback(
+                    static_cast<float>(step) / static_cast<float>(replayLog.StepCount),
+                    "Replaying...");
+            }
+        }
+    }
+    catch (...)
+    {
+        mGameParameters = originalGameParameters;
+        GameWallClock::GetInstance().SetManual(false);
+
+        if (wasSimulationThreadRunning)
+            StartSimulationThread();
+
+        throw;
+    }
+
+    mGameParameters = originalGameParameters;
+    GameWallClock::GetInstance().SetManual(false);
+
+    if (wasSimulationThreadRunning)
+        StartSimulationThread();
+
+    LogMessage("GameController::RunReplay(): ", statistics.StepCount, " steps, avg ",
+        statistics.GetAverageUpdateDurationMillis(), "ms");
+
+    return statistics;
+}
+
+AutotuneResult GameController::RunAutotune(ProgressCallback const & progressCallback)
+{
+    if (IsRecordingReplay())
+    {
+        throw GameException("Cannot autotune while recording a replay");
+    }
+
+    // We run the steps ourselves
+    bool const wasSimulationThreadRunning = IsSimulationThreadRunning();
+    StopSimulationThread();
+
+    // The GPU calculators need the OpenGL context, which the render thread would own
+    bool const isGPUAvailable =
+        GPUCalculatorFactory::GetInstance().IsInitialized()
+        && !IsRenderThreadRunning();
+
+    std::filesystem::path const defaultShipFilepath = mResourceLoader->GetDefaultShipDefinitionFilePath();
+
+    std::optional<std::filesystem::path> targetShipFilepath;
+    if (!mLastShipLoadedFilepath.empty() && mLastShipLoadedFilepath != defaultShipFilepath)
+        targetShipFilepath = mLastShipLoadedFilepath;
+
+    GameWallClock::GetInstance().SetManual(true);
+
+    try
+    {
+        auto result = PerformanceAutotuner::Run(
+            defaultShipFilepath,
+            targetShipFilepath,
+            mGameParameters,
+            isGPUAvailable,
+            mMaterialDatabase,
+            *mResourceLoader,
+            progressCallback);
+
+        GameWallClock::GetInstance().SetManual(false);
+
+        if (wasSimulationThreadRunning)
+            StartSimulationThread();
+
+        LogMessage("GameController::RunAutotune(): ", result.Configuration.ToString(), ", ",
+            result.StepsPerSecond, " steps/s");
+
+        return result;
+    }
+    catch (...)
+    {
+        GameWallClock::GetInstance().SetManual(false);
+
+        if (wasSimulationThreadRunning)
+            StartSimulationThread();
+
+        throw;
+    }
+}
+
+void GameController::RunGameIteration()
+{
+    TRACE_SCOPE("GameIteration", "frame");
+
+    auto const frameStartTimestamp = std::chrono::steady_clock::now();
+
+    ///////////////////////////////////////////////////////////
+    // Progress asynchronous ship loads
+    ///////////////////////////////////////////////////////////
+
+    UpdateShipLoad();
+
+    ///////////////////////////////////////////////////////////
+    // Update simulation
+    ///////////////////////////////////////////////////////////
+
+    if (IsSimulationThreadRunning())
+    {
+        //
+        // The simulation runs on its own thread; hand it our current parameters -
+        // which it picks up at its next step - and, in between two of its steps,
+        // our current state, and take its events and stats
+        //
+
+        PublishSimulationGameParameters();
+
+        {
+            std::lock_guard<std::mutex> lock(mWorldMutex);
+
+            mIsSimulationPaused = (mIsPaused || mIsMoveToolEngaged);
+
+            mTotalUpdateDuration += mSimulationUpdateDuration;
+            mUpdateFrameTimes.RegisterSample(
+                std::chrono::duration<float, std::milli>(mSimulationUpdateDuration).count());
+            mSimulationUpdateDuration = std::chrono::steady_clock::duration::zero();
+        }
+
+        // Forward the events fired by the simulation so far, without waiting for its step
+        mWorldGameEventChannel->Drain();
+
+        // Update text layer
+        mTextLayer->Update();
+
+        // Flush events
+        mGameEventDispatcher->Flush();
+    }
+    else if (!mIsPaused && !mIsMoveToolEngaged) // Make sure we're not paused
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+
+        InternalUpdate();
+
+        auto const endTime = std::chrono::steady_clock::now();
+        mTotalUpdateDuration += endTime - startTime;
+        mUpdateFrameTimes.RegisterSample(
+            std::chrono::duration<float, std::milli>(endTime - startTime).count());
+    }
+
+
+    ///////////////////////////////////////////////////////////
+    // Render
+    ///////////////////////////////////////////////////////////
+
+    //
+    // Initialize render stats, if needed
+    //
+
+    if (mRenderStatsOriginTimestampReal == std::chrono::steady_clock::time_point::min())
+    {
+        assert(mRenderStatsLastTimestampReal == std::chrono::steady_clock::time_point::min());
+
+        std::chrono::steady_clock::time_point nowReal = std::chrono::steady_clock::now();
+        mRenderStatsOriginTimestampReal = nowReal;
+        mRenderStatsLastTimestampReal = nowReal;
+
+        mTotalFrameCount = 0u;
+        mLastFrameCount = 0u;
+
+        // In order to start from zero at first render, take global origin here
+        mOriginTimestampGame = nowReal;
+
+        // Render initial status text
+        PublishStats(nowReal);
+    }
+
+
+    //
+    // Render
+    //
+    // While paused, we only render when something that is rendered has changed; otherwise
+    // the last frame - once swapped in - stays on the screen
+    //
+
+    bool const doRender =
+        !mIsPaused
+        || mIsMoveToolEngaged
+        || mIsWorldDirtyForRendering
+        || mRenderContext->IsSceneDirty()
+        || mTextLayer->IsDirty()
+        || mCurrentZoom != mTargetZoom
+        || mCurrentCameraPosition != mTargetCameraPosition
+        || !mPendingScreenshotHandlers.empty()
+        || mScreenshotBurstRemainingFrameCount > 0
+        || !!mFrameRecorder;
+
+    auto const startTime = std::chrono::steady_clock::now();
+
+    // Flip the (previous) back buffer onto the screen
+    if (mHasUnpresentedFrame)
+    {
+        PresentFrame();
+    }
+
+    // Take the input latency of the frame the render thread has presented meanwhile, if any
+    if (IsRenderThreadRunning())
+    {
+        float const inputLatencyMillis = mRenderThreadInputLatencyMillis.exchange(-1.0f);
+        if (inputLatencyMillis >= 0.0f)
+        {
+            mInputLatencyFrameTimes.RegisterSample(inputLatencyMillis);
+        }
+    }
+
+    if (!doRender)
+    {
+        RunIdleTasks(frameStartTimestamp);
+
+        return;
+    }
+
+    // Render
+    auto const startRenderTime = std::chrono::steady_clock::now();
+
+    InternalRender();
+
+    auto const endTime = std::chrono::steady_clock::now();
+    mTotalRenderDuration += endTime - startTime;
+    mRenderFrameTimes.RegisterSample(
+        std::chrono::duration<float, std::milli>(endTime - startRenderTime).count());
+
+
+    //
+    // Update stats
+    //
+
+    ++mTotalFrameCount;
+    ++mLastFrameCount;
+
+    if (!!mTelemetryRing)
+    {
+        PublishTelemetry();
+    }
+
+    //
+    // Run idle-priority work in what's left of the frame
+    //
+
+    RunIdleTasks(frameStartTimestamp);
+}
+
+void GameController::LowFrequencyUpdate()
+{
+    std::chrono::steady_clock::time_point nowReal = std::chrono::steady_clock::now();
+
+    if (mSkippedFirstStatPublishes >= 1)
+    {
+        //
+        // Publish stats
+        //
+
+
+        PublishStats(nowReal);
+
+        //
+        // Reset stats
+        //
+
+        mLastFrameCount = 0u;
+        mLastTotalUpdateDuration = mTotalUpdateDuration;
+        mLastTotalRenderDuration = mTotalRenderDuration;
+        mLastShipPerfStats = mTotalShipPerfStats;
+    }
+    else
+    {
+        //
+        // Skip the first few publish as rates are too polluted
+        //
+
+        mTotalFrameCount = 0u;
+        mLastFrameCount = 0u;
+        mRenderStatsOriginTimestampReal = nowReal;
+
+        ++mSkippedFirstStatPublishes;
+    }
+
+    mRenderStatsLastTimestampReal = nowReal;
+
+    // Let go of the storage of old worlds that no new world has taken over
+    if (!mIdleTaskScheduler.IsPosted("TrimRecycledStorage"))
+    {
+        mIdleTaskScheduler.Post(
+            "TrimRecycledStorage",
+            []()
+            {
+                BulkStorageRecycler::GetInstance().Trim();
+            },
+            MaxTrimRecycledStorageDelay);
+    }
+}
+
+void GameController::Update()
+{
+    InternalUpdate();
+
+    mIsWorldDirtyForRendering = true;
+}
+
+void GameController::Render()
+{
+    InternalRender();
+}
+
+void GameController::StartSimulationThread()
+{
+    if (IsSimulationThreadRunning())
+        return;
+
+    PublishSimulationGameParameters();
+    mIsSimulationPaused = (mIsPaused || mIsMoveToolEngaged);
+    mSimulationUpdateDuration = std::chrono::steady_clock::duration::zero();
+
+    mIsSimulationThreadStopping = false;
+    mSimulationThread = std::thread(&GameController::SimulationThreadLoop, this);
+}
+
+GameParameters GameController::MakeSimulationThreadGameParameters(GameParameters const & gameParameters)
+{
+    GameParameters simulationGameParameters = gameParameters;
+
+    // The GPU calculators live in OpenGL contexts of the main thread
+    simulationGameParameters.DoUseGPUMechanicalDynamics = false;
+    simulationGameParameters.DoUseGPUWaterDiffusion = false;
+
+    return simulationGameParameters;
+}
+
+void GameController::StartRenderThread(
+    std::function<void()> makeContextCurrentFunction,
+    std::function<void()> releaseContextFunction)
+{
+    if (IsRenderThreadRunning())
+        return;
+
+    // From now on it's the render thread that presents frames
+    if (mHasUnpresentedFrame)
+    {
+        PresentFrame();
+    }
+
+    mRenderContext->StartRenderThread(
+        std::move(makeContextCurrentFunction),
+        std::move(releaseContextFunction));
+}
+
+void GameController::StopRenderThread()
+{
+    // The last frame has been presented by the render thread
+    mRenderContext->StopRenderThread();
+}
+
+void GameController::SetMaxFramesInFlight(size_t maxFramesInFlight)
+{
+    assert(maxFramesInFlight <= 2);
+
+    mRenderContext->SetMaxFramesInFlight(maxFramesInFlight);
+
+    // From now on frames are presented right away
+    if (maxFramesInFlight == 0 && mHasUnpresentedFrame)
+    {
+        PresentFrame();
+    }
+}
+
+void GameController::StartTelemetry(std::string const & sharedMemoryName)
+{
+    if (!!mTelemetryRing)
+        return;
+
+    // About a minute's worth of frames
+    static constexpr size_t TelemetryRecordCount = 4096;
+
+    mTelemetryRing = TelemetryRing::CreateShared(sharedMemoryName, TelemetryRecordCount);
+
+    mTelemetryFrameIndex = 0;
+    mTelemetryOriginTimestamp = std::chrono::steady_clock::now();
+    mTelemetryLastShipPerfStats = RunWorldQuery(
+        [](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            return world.GetShipPerfStats();
+        });
+
+    auto const memoryReport = GetMemoryReport();
+    mTelemetryCpuMemoryBytes = memoryReport.GetTotalByteSize("CPU");
+    mTelemetryGpuMemoryBytes = memoryReport.GetTotalByteSize("GPU");
+}
+
+void GameController::StopTelemetry()
+{
+    mTelemetryRing.reset();
+}
+
+void GameController::StopSimulationThread()
+{
+    if (!IsSimulationThreadRunning())
+        return;
+
+    mIsSimulationThreadStopping = true;
+    mSimulationThread.join();
+
+    // Run the interactions that didn't make it to the last step, and
+    // forward everything that happened since the last iteration
+    RunPendingWorldCommands(mGameParameters);
+    mWorldGameEventChannel->FlushOverflow();
+    mWorldGameEventChannel->Drain();
+    mGameEventDispatcher->Flush();
+}
+
+/////////////////////////////////////////////////////////////
+// Interactions
+/////////////////////////////////////////////////////////////
+
+void GameController::NotifyInputEvent()
+{
+    // Latency is measured from the earliest input
+    if (!mPendingInputTimestamp)
+        mPendingInputTimestamp = std::chrono::steady_clock::now();
+}
+
+void GameController::SetPaused(bool isPaused)
+{
+    mIsPaused = isPaused;
+}
+
+void GameController::SetMoveToolEngaged(bool isEngaged)
+{
+    mIsMoveToolEngaged = isEngaged;
+}
+
+void GameController::SetStatusTextEnabled(bool isEnabled)
+{
+    assert(!!mTextLayer);
+    mTextLayer->SetStatusTextEnabled(isEnabled);
+}
+
+void GameController::SetExtendedStatusTextEnabled(bool isEnabled)
+{
+    assert(!!mTextLayer);
+    mTextLayer->SetExtendedStatusTextEnabled(isEnabled);
+}
+
+void GameController::MoveBy(
+    ShipId shipId,
+    vec2f const & screenOffset)
+{
+    vec2f const worldOffset = mRenderContext->ScreenOffsetToWorldOffset(screenOffset);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::MoveBy,
+            shipId,
+            worldOffset,
+            vec2f::zero(),
+            0.0f));
+}
+
+void GameController::RotateBy(
+    ShipId shipId,
+    float screenDeltaY,
+    vec2f const & screenCenter)
+{
+    float const angle =
+        2.0f * Pi<float>
+        / static_cast<float>(mRenderContext->GetCanvasHeight())
+        * screenDeltaY;
+
+    vec2f const worldCenter = mRenderContext->ScreenToWorld(screenCenter);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::RotateBy,
+            shipId,
+            worldCenter,
+            vec2f::zero(),
+            angle));
+}
+
+void GameController::DestroyAt(
+    vec2f const & screenCoordinates,
+    float radiusMultiplier)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::DestroyAt,
+            worldCoordinates,
+            vec2f::zero(),
+            radiusMultiplier));
+}
+
+void GameController::RepairAt(
+    vec2f const & screenCoordinates,
+    float radiusMultiplier)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::RepairAt,
+            worldCoordinates,
+            vec2f::zero(),
+            radiusMultiplier));
+}
+
+void GameController::SawThrough(
+    vec2f const & startScreenCoordinates,
+    vec2f const & endScreenCoordinates)
+{
+    vec2f const startWorldCoordinates = mRenderContext->ScreenToWorld(startScreenCoordinates);
+    vec2f const endWorldCoordinates = mRenderContext->ScreenToWorld(endScreenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::SawThrough,
+            startWorldCoordinates,
+            endWorldCoordinates));
+}
+
+void GameController::DrawTo(
+    vec2f const & screenCoordinates,
+    float strengthMultiplier)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    float strength = 2000.0f * strengthMultiplier;
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::DrawTo,
+            worldCoordinates,
+            vec2f::zero(),
+            strength));
+}
+
+void GameController::SwirlAt(
+    vec2f const & screenCoordinates,
+    float strengthMultiplier)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    float strength = 30.0f * strengthMultiplier;
 
     // Apply action
-    assert(!!mWorld);
-    mWorld->TogglePinAt(
-        worldCoordinates,
-        mGameParameters);
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::SwirlAt,
+            worldCoordinates,
+            vec2f::zero(),
+            strength));
+}
+
+void GameController::DisplaceOceanSurfaceAt(
+    vec2f const & screenCoordinates,
+    float strengthMultiplier)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Push down when below the surface, up when above
+    float const displacement = 0.5f * strengthMultiplier;
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::DisplaceOceanSurfaceAt,
+            worldCoordinates,
+            vec2f::zero(),
+            displacement));
+}
+
+void GameController::TogglePinAt(vec2f const & screenCoordinates)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::TogglePinAt,
+            worldCoordinates));
 }
 
 bool GameController::InjectBubblesAt(vec2f const & screenCoordinates)
@@ -422,10 +1286,10 @@ bool GameController::InjectBubblesAt(vec2f const & screenCoordinates)
     vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
 
     // Apply action
-    assert(!!mWorld);
-    return mWorld->InjectBubblesAt(
-        worldCoordinates,
-        mGameParameters);
+    return RunInteractionQuery(
+        ReplayCommand(
+            ReplayCommand::CommandType::InjectBubblesAt,
+            worldCoordinates));
 }
 
 bool GameController::FloodAt(
@@ -434,201 +1298,680 @@ bool GameController::FloodAt(
 {
     vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
 
-    // Apply action
-    assert(!!mWorld);
-    return mWorld->FloodAt(
-        worldCoordinates,
-        waterQuantityMultiplier,
-        mGameParameters);
+    // Apply action
+    return RunInteractionQuery(
+        ReplayCommand(
+            ReplayCommand::CommandType::FloodAt,
+            worldCoordinates,
+            vec2f::zero(),
+            waterQuantityMultiplier));
+}
+
+void GameController::ToggleAntiMatterBombAt(vec2f const & screenCoordinates)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::ToggleAntiMatterBombAt,
+            worldCoordinates));
+}
+
+void GameController::ToggleImpactBombAt(vec2f const & screenCoordinates)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::ToggleImpactBombAt,
+            worldCoordinates));
+}
+
+void GameController::ToggleRCBombAt(vec2f const & screenCoordinates)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::ToggleRCBombAt,
+            worldCoordinates));
+}
+
+void GameController::ToggleTimerBombAt(vec2f const & screenCoordinates)
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::ToggleTimerBombAt,
+            worldCoordinates));
+}
+
+void GameController::DetonateRCBombs()
+{
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::DetonateRCBombs));
+}
+
+void GameController::DetonateAntiMatterBombs()
+{
+    // Apply action
+    RunInteraction(
+        ReplayCommand(
+            ReplayCommand::CommandType::DetonateAntiMatterBombs));
+}
+
+bool GameController::AdjustOceanFloorTo(vec2f const & startScreenCoordinates, vec2f const & endScreenCoordinates)
+{
+    vec2f const startWorldCoordinates = mRenderContext->ScreenToWorld(startScreenCoordinates);
+    vec2f const endWorldCoordinates = mRenderContext->ScreenToWorld(endScreenCoordinates);
+
+    return RunInteractionQuery(
+        ReplayCommand(
+            ReplayCommand::CommandType::AdjustOceanFloorTo,
+            startWorldCoordinates,
+            endWorldCoordinates));
+}
+
+bool GameController::ScrubThrough(
+    vec2f const & startScreenCoordinates,
+    vec2f const & endScreenCoordinates)
+{
+    vec2f const startWorldCoordinates = mRenderContext->ScreenToWorld(startScreenCoordinates);
+    vec2f const endWorldCoordinates = mRenderContext->ScreenToWorld(endScreenCoordinates);
+
+    // Apply action
+    return RunInteractionQuery(
+        ReplayCommand(
+            ReplayCommand::CommandType::ScrubThrough,
+            startWorldCoordinates,
+            endWorldCoordinates));
+}
+
+std::optional<ObjectId> GameController::GetNearestPointAt(vec2f const & screenCoordinates) const
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    return RunWorldQuery(
+        [worldCoordinates](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            return world.GetNearestPointAt(
+                worldCoordinates,
+                1.0f);
+        });
+}
+
+void GameController::QueryNearestPointAt(vec2f const & screenCoordinates) const
+{
+    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+
+    RunWorldQuery(
+        [worldCoordinates](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            world.QueryNearestPointAt(
+                worldCoordinates,
+                1.0f);
+        });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void GameController::InternalUpdate()
+{
+    // Update world
+    UpdateWorld(mGameParameters);
+
+    // Forward the events fired by the world
+    mWorldGameEventChannel->Drain();
+
+    // Update text layer
+    mTextLayer->Update();
+
+    // Flush events
+    mGameEventDispatcher->Flush();
+}
+
+void GameController::UpdateWorld(GameParameters const & gameParameters)
+{
+    assert(!!mWorld);
+
+    TRACE_SCOPE("UpdateWorld", "simulation");
+
+    RecordReplayStepInputs(gameParameters);
+
+    auto const startTime = std::chrono::steady_clock::now();
+
+    mWorld->Update(
+        gameParameters,
+        mUpdateDurationMillisRunningAverage.GetCurrentAverage(),
+        mRenderContext->GetSimulationView());
+
+    auto const endTime = std::chrono::steady_clock::now();
+    mUpdateDurationMillisRunningAverage.Update(
+        std::chrono::duration<float, std::milli>(endTime - startTime).count());
+
+    // Move the events that didn't fit into the channel during the step, if any
+    mWorldGameEventChannel->FlushOverflow();
+
+    EndReplayStep();
+}
+
+void GameController::InternalRender()
+{
+    TRACE_SCOPE("Render", "frame");
+
+    //
+    // Retrieve the screenshots we've started at the previous frames, if any
+    //
+
+    RetrievePendingScreenshots();
+
+
+    //
+    // This frame is the first to show the effects of the input received so far
+    //
+
+    if (!!mPendingInputTimestamp)
+    {
+        if (!mRenderedInputTimestamp)
+            mRenderedInputTimestamp = mPendingInputTimestamp;
+
+        mPendingInputTimestamp.reset();
+    }
+
+
+    //
+    // Do zoom smoothing
+    //
+
+    if (mCurrentZoom != mTargetZoom)
+    {
+        SmoothToTarget(
+            mCurrentZoom,
+            mStartingZoom,
+            mTargetZoom,
+            mStartZoomTimestamp);
+
+        mRenderContext->SetZoom(mCurrentZoom);
+    }
+
+
+    //
+    // Do camera smoothing
+    //
+
+    if (mCurrentCameraPosition != mTargetCameraPosition)
+    {
+        SmoothToTarget(
+            mCurrentCameraPosition.x,
+            mStartingCameraPosition.x,
+            mTargetCameraPosition.x,
+            mStartCameraPositionTimestamp);
+
+        SmoothToTarget(
+            mCurrentCameraPosition.y,
+            mStartingCameraPosition.y,
+            mTargetCameraPosition.y,
+            mStartCameraPositionTimestamp);
+
+        mRenderContext->SetCameraWorldPosition(mCurrentCameraPosition);
+    }
+
+
+    //
+    // Start rendering
+    //
+
+    mRenderContext->RenderStart();
+
+
+    //
+    // Render world
+    //
+
+    RunWorldQuery(
+        [this](Physics::World & world, GameParameters const & gameParameters)
+        {
+            world.Render(
+                gameParameters,
+                CalculateRenderInterpolationFactor(),
+                *mRenderContext);
+        });
+
+
+    //
+    // Render text layer
+    //
+
+    assert(!!mTextLayer);
+    mTextLayer->Render(*mRenderContext);
+
+
+    //
+    // Finish rendering
+    //
+
+    mRenderContext->RenderEnd();
+
+    mIsWorldDirtyForRendering = false;
+
+
+    //
+    // Capture this frame, if we're in a screenshot burst
+    //
+
+    if (mScreenshotBurstRemainingFrameCount > 0)
+    {
+        StartScreenshot(mScreenshotBurstHandler);
+
+        --mScreenshotBurstRemainingFrameCount;
+    }
+
+
+    //
+    // Capture this frame, if we're recording and it's time for the next frame
+    //
+
+    if (!!mFrameRecorder)
+    {
+        auto const now = std::chrono::steady_clock::now();
+        if (now >= mNextRecordingFrameTimestamp)
+        {
+            StartScreenshot(
+                [frameRecorder = mFrameRecorder](RgbImageData && frame)
+                {
+                    frameRecorder->WriteFrame(frame);
+                });
+
+            // Don't try to catch up with the frames we've missed
+            mNextRecordingFrameTimestamp = std::max(
+                mNextRecordingFrameTimestamp + mRecordingFramePeriod,
+                now);
+        }
+    }
+
+
+    //
+    // Hand the frame over for presentation
+    //
+
+    if (IsRenderThreadRunning())
+    {
+        // The render thread presents the frame as soon as it's done replaying it
+        mRenderContext->SubmitFrame(
+            [this, inputTimestamp = mRenderedInputTimestamp]()
+            {
+                mSwapRenderBuffersFunction();
+
+                if (!!inputTimestamp)
+                {
+                    mRenderThreadInputLatencyMillis = std::chrono::duration<float, std::milli>(
+                        std::chrono::steady_clock::now() - *inputTimestamp).count();
+                }
+            });
+
+        mRenderedInputTimestamp.reset();
+    }
+    else
+    {
+        mHasUnpresentedFrame = true;
+
+        // Unless we may keep frames in flight, present the frame right away; otherwise,
+        // we'll present it at the next iteration
+        if (mRenderContext->GetMaxFramesInFlight() == 0)
+        {
+            PresentFrame();
+        }
+    }
+}
+
+void GameController::PresentFrame()
+{
+    TRACE_SCOPE("SwapBuffers", "frame");
+
+    assert(mHasUnpresentedFrame);
+
+    auto const startTime = std::chrono::steady_clock::now();
+
+    mSwapRenderBuffersFunction();
+
+    mHasUnpresentedFrame = false;
+
+    auto const endTime = std::chrono::steady_clock::now();
+
+    mSwapFrameTimes.RegisterSample(
+        std::chrono::duration<float, std::milli>(endTime - startTime).count());
+
+    if (!!mRenderedInputTimestamp)
+    {
+        mInputLatencyFrameTimes.RegisterSample(
+            std::chrono::duration<float, std::milli>(endTime - *mRenderedInputTimestamp).count());
+
+        mRenderedInputTimestamp.reset();
+    }
 }
 
-void GameController::ToggleAntiMatterBombAt(vec2f const & screenCoordinates)
+void GameController::StartScreenshot(ScreenshotHandler screenshotHandler)
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    mRenderContext->StartScreenshot();
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->ToggleAntiMatterBombAt(
-        worldCoordinates,
-        mGameParameters);
+    mPendingScreenshotHandlers.emplace_back(std::move(screenshotHandler));
 }
 
-void GameController::ToggleImpactBombAt(vec2f const & screenCoordinates)
+void GameController::RetrievePendingScreenshots()
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    while (mRenderContext->HasPendingScreenshots())
+    {
+        assert(!mPendingScreenshotHandlers.empty());
+        auto screenshotHandler = std::move(mPendingScreenshotHandlers.front());
+        mPendingScreenshotHandlers.pop_front();
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->ToggleImpactBombAt(
-        worldCoordinates,
-        mGameParameters);
+        size_t queuedScreenshotCount;
+        {
+            std::lock_guard<std::mutex> lock(mScreenshotQueueMutex);
+            queuedScreenshotCount = mScreenshotQueue.size();
+        }
+
+        if (queuedScreenshotCount >= MaxQueuedScreenshots)
+        {
+            // The screenshot thread is falling behind; drop this one, without even reading it back
+            mRenderContext->DiscardScreenshot();
+            ++mDroppedScreenshotCount;
+            continue;
+        }
+
+        auto screenshot = mRenderContext->RetrieveScreenshot();
+        assert(screenshot.has_value());
+
+        {
+            std::lock_guard<std::mutex> lock(mScreenshotQueueMutex);
+            mScreenshotQueue.emplace_back(std::move(screenshotHandler), std::move(*screenshot));
+        }
+
+        mScreenshotQueueCondition.notify_one();
+    }
+
+    assert(mPendingScreenshotHandlers.empty());
 }
 
-void GameController::ToggleRCBombAt(vec2f const & screenCoordinates)
+void GameController::EnsureScreenshotThreadRunning()
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
-
-    // Apply action
-    assert(!!mWorld);
-    mWorld->ToggleRCBombAt(
-        worldCoordinates,
-        mGameParameters);
+    if (!mScreenshotThread.joinable())
+    {
+        mIsScreenshotThreadStopping = false;
+        mScreenshotThread = std::thread(&GameController::ScreenshotThreadLoop, this);
+    }
 }
 
-void GameController::ToggleTimerBombAt(vec2f const & screenCoordinates)
+void GameController::ScreenshotThreadLoop()
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    while (true)
+    {
+        std::optional<std::pair<ScreenshotHandler, RgbImageData>> screenshot;
 
-    // Apply action
-    assert(!!mWorld);
-    mWorld->ToggleTimerBombAt(
-        worldCoordinates,
-        mGameParameters);
+        {
+            std::unique_lock<std::mutex> lock(mScreenshotQueueMutex);
+
+            mScreenshotQueueCondition.wait(
+                lock,
+                [this]()
+                {
+                    return mIsScreenshotThreadStopping || !mScreenshotQueue.empty();
+                });
+
+            // Drain the queue before stopping
+            if (mScreenshotQueue.empty())
+                break;
+
+            screenshot.emplace(std::move(mScreenshotQueue.front()));
+            mScreenshotQueue.pop_front();
+        }
+
+        try
+        {
+            screenshot->first(std::move(screenshot->second));
+        }
+        catch (std::exception const & ex)
+        {
+            LogMessage("ERROR: GameController::ScreenshotThreadLoop(): cannot handle screenshot: ", ex.what());
+        }
+    }
 }
 
-void GameController::DetonateRCBombs()
+void GameController::StopScreenshotThread()
 {
-    // Apply action
-    assert(!!mWorld);
-    mWorld->DetonateRCBombs();
+    if (!mScreenshotThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mScreenshotQueueMutex);
+        mIsScreenshotThreadStopping = true;
+    }
+
+    mScreenshotQueueCondition.notify_one();
+
+    mScreenshotThread.join();
 }
 
-void GameController::DetonateAntiMatterBombs()
+void GameController::SimulationThreadLoop()
 {
-    // Apply action
-    assert(!!mWorld);
-    mWorld->DetonateAntiMatterBombs();
+    // The max number of steps we try to catch up with after falling behind
+    static constexpr int MaxCatchUpSteps = 4;
+
+    auto const stepDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(GameParameters::SimulationStepTimeDuration<float>));
+
+    auto nextStepTime = std::chrono::steady_clock::now();
+
+    TraceLog::GetInstance().SetCurrentThreadName("Simulation");
+
+    InitializeSimulationThreadFloatingPoint();
+
+    while (!mIsSimulationThreadStopping)
+    {
+        std::this_thread::sleep_until(nextStepTime);
+
+        // Pick up the latest parameters, if they've changed; the snapshot
+        // stays the same for the whole step
+        mSimulationGameParameters.PickUp();
+        GameParameters const & gameParameters = mSimulationGameParameters.GetCurrent();
+
+        {
+            std::lock_guard<std::mutex> lock(mWorldMutex);
+
+            RunPendingWorldCommands(gameParameters);
+
+            if (!mIsSimulationPaused)
+            {
+                auto const startTime = std::chrono::steady_clock::now();
+
+                try
+                {
+                    UpdateWorld(gameParameters);
+                }
+                catch (std::exception const & ex)
+                {
+                    LogMessage("Error updating simulation: ", ex.what());
+                }
+
+                auto const endTime = std::chrono::steady_clock::now();
+                mSimulationUpdateDuration += endTime - startTime;
+                mLastSimulationStepTimestamp = endTime;
+            }
+        }
+
+        nextStepTime += stepDuration;
+
+        // Give up on catching up if we're way too late
+        auto const now = std::chrono::steady_clock::now();
+        if (now - nextStepTime > MaxCatchUpSteps * stepDuration)
+            nextStepTime = now;
+    }
 }
 
-bool GameController::AdjustOceanFloorTo(vec2f const & startScreenCoordinates, vec2f const & endScreenCoordinates)
+void GameController::PublishSimulationGameParameters()
 {
-    vec2f const startWorldCoordinates = mRenderContext->ScreenToWorld(startScreenCoordinates);
-    vec2f const endWorldCoordinates = mRenderContext->ScreenToWorld(endScreenCoordinates);
+    GameParameters const simulationGameParameters = MakeSimulationThreadGameParameters(mGameParameters);
 
-    assert(!!mWorld);
-    return mWorld->AdjustOceanFloorTo(
-        startWorldCoordinates.x,
-        startWorldCoordinates.y,
-        endWorldCoordinates.x,
-        endWorldCoordinates.y);
+    // Only publish when something has changed, so that generations mark actual changes
+    if (0 != std::memcmp(&simulationGameParameters, &mLastPublishedSimulationGameParameters, sizeof(GameParameters)))
+    {
+        mSimulationGameParameters.Publish(simulationGameParameters);
+        mLastPublishedSimulationGameParameters = simulationGameParameters;
+    }
 }
 
-bool GameController::ScrubThrough(
-    vec2f const & startScreenCoordinates,
-    vec2f const & endScreenCoordinates)
+float GameController::CalculateRenderInterpolationFactor() const
 {
-    vec2f const startWorldCoordinates = mRenderContext->ScreenToWorld(startScreenCoordinates);
-    vec2f const endWorldCoordinates = mRenderContext->ScreenToWorld(endScreenCoordinates);
+    //
+    // When the simulation runs on its own thread we render somewhere in between
+    // two of its steps; we then render the state at the same fraction of the way
+    // between the last two simulation steps, i.e. one step behind, so that motion
+    // stays smooth regardless of the two rates.
+    //
+    // Invoked with the world mutex held.
+    //
 
-    // Apply action
-    assert(!!mWorld);
-    return mWorld->ScrubThrough(
-        startWorldCoordinates,
-        endWorldCoordinates,
-        mGameParameters);
+    if (!IsSimulationThreadRunning()
+        || !mGameParameters.DoInterpolateRenderPositions
+        || mIsSimulationPaused)
+    {
+        return 1.0f;
+    }
+
+    float const elapsedSinceLastStep = std::chrono::duration<float>(
+        std::chrono::steady_clock::now() - mLastSimulationStepTimestamp).count();
+
+    return std::min(
+        1.0f,
+        elapsedSinceLastStep / GameParameters::SimulationStepTimeDuration<float>);
 }
 
-std::optional<ObjectId> GameController::GetNearestPointAt(vec2f const & screenCoordinates) const
+void GameController::RunPendingWorldCommands(GameParameters const & gameParameters)
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    std::vector<WorldCommand> commands;
+
+    {
+        std::lock_guard<std::mutex> lock(mPendingWorldCommandsMutex);
+        commands.swap(mPendingWorldCommands);
+    }
 
     assert(!!mWorld);
-    return mWorld->GetNearestPointAt(worldCoordinates, 1.0f);
+    for (auto const & command : commands)
+    {
+        command(*mWorld, gameParameters);
+    }
 }
 
-void GameController::QueryNearestPointAt(vec2f const & screenCoordinates) const
+void GameController::RunInteraction(ReplayCommand const & command)
 {
-    vec2f const worldCoordinates = mRenderContext->ScreenToWorld(screenCoordinates);
+    RunWorldCommand(
+        [this, command](Physics::World & world, GameParameters const & gameParameters)
+        {
+            RecordReplayCommand(command, gameParameters);
 
-    assert(!!mWorld);
-    mWorld->QueryNearestPointAt(worldCoordinates, 1.0f);
+            command.Apply(world, gameParameters);
+        });
 }
 
-////////////////////////////////////////////////////////////////////////////////////////
-
-void GameController::InternalUpdate()
+bool GameController::RunInteractionQuery(ReplayCommand const & command)
 {
-    // Update world
-    assert(!!mWorld);
-    mWorld->Update(
-        mGameParameters,
-        *mRenderContext);
+    mIsWorldDirtyForRendering = true;
 
-    // Update text layer
-    mTextLayer->Update();
+    return RunWorldQuery(
+        [this, &command](Physics::World & world, GameParameters const & gameParameters)
+        {
+            RecordReplayCommand(command, gameParameters);
 
-    // Flush events
-    mGameEventDispatcher->Flush();
+            return command.Apply(world, gameParameters);
+        });
 }
 
-void GameController::InternalRender()
+void GameController::RecordReplayCommand(
+    ReplayCommand const & command,
+    GameParameters const & gameParameters)
 {
-    //
-    // Do zoom smoothing
-    //
+    std::lock_guard<std::mutex> lock(mReplayRecordingMutex);
 
-    if (mCurrentZoom != mTargetZoom)
-    {
-        SmoothToTarget(
-            mCurrentZoom,
-            mStartingZoom,
-            mTargetZoom,
-            mStartZoomTimestamp);
+    if (!mReplayRecording)
+        return;
 
-        mRenderContext->SetZoom(mCurrentZoom);
-    }
+    // The command has to be replayed with the same parameters
+    RecordReplayGameParameters(gameParameters);
 
+    mReplayRecording->Events.push_back(
+        ReplayLog::Event::MakeCommand(mReplayRecording->StepCount, command));
+}
 
-    //
-    // Do camera smoothing
-    //
+void GameController::RecordReplayStepInputs(GameParameters const & gameParameters)
+{
+    std::lock_guard<std::mutex> lock(mReplayRecordingMutex);
 
-    if (mCurrentCameraPosition != mTargetCameraPosition)
-    {
-        SmoothToTarget(
-            mCurrentCameraPosition.x,
-            mStartingCameraPosition.x,
-            mTargetCameraPosition.x,
-            mStartCameraPositionTimestamp);
+    if (!mReplayRecording)
+        return;
 
-        SmoothToTarget(
-            mCurrentCameraPosition.y,
-            mStartingCameraPosition.y,
-            mTargetCameraPosition.y,
-            mStartCameraPositionTimestamp);
+    RecordReplayGameParameters(gameParameters);
+    RecordReplayView();
+}
 
-        mRenderContext->SetCameraWorldPosition(mCurrentCameraPosition);
-    }
+void GameController::EndReplayStep()
+{
+    std::lock_guard<std::mutex> lock(mReplayRecordingMutex);
 
+    if (!mReplayRecording)
+        return;
 
-    //
-    // Start rendering
-    //
+    ++(mReplayRecording->StepCount);
 
-    mRenderContext->RenderStart();
+    // Time moves in steps while recording
+    GameWallClock::GetInstance().Advance(
+        std::chrono::duration_cast<GameWallClock::duration>(
+            std::chrono::duration<float>(GameParameters::SimulationStepTimeDuration<float>)));
+}
 
+void GameController::RecordReplayGameParameters(GameParameters const & gameParameters)
+{
+    assert(!!mReplayRecording);
 
-    //
-    // Render world
-    //
+    if (0 == std::memcmp(&gameParameters, &mLastRecordedGameParameters, sizeof(GameParameters)))
+        return;
 
-    assert(!!mWorld);
-    mWorld->Render(mGameParameters, *mRenderContext);
+    mReplayRecording->GameParametersSnapshots.push_back(gameParameters);
+    mReplayRecording->Events.push_back(
+        ReplayLog::Event::MakeGameParameters(
+            mReplayRecording->StepCount,
+            mReplayRecording->GameParametersSnapshots.size() - 1));
 
+    mLastRecordedGameParameters = gameParameters;
+}
 
-    //
-    // Render text layer
-    //
+void GameController::RecordReplayView()
+{
+    assert(!!mReplayRecording);
 
-    assert(!!mTextLayer);
-    mTextLayer->Render(*mRenderContext);
+    vec2f const cameraWorldPosition = mRenderContext->GetCameraWorldPosition();
+    float const zoom = mRenderContext->GetZoom();
 
+    if (cameraWorldPosition == mLastRecordedCameraWorldPosition
+        && zoom == mLastRecordedZoom)
+    {
+        return;
+    }
 
-    //
-    // Finish rendering
-    //
+    mReplayRecording->Events.push_back(
+        ReplayLog::Event::MakeView(
+            mReplayRecording->StepCount,
+            cameraWorldPosition,
+            zoom));
 
-    mRenderContext->RenderEnd();
+    mLastRecordedCameraWorldPosition = cameraWorldPosition;
+    mLastRecordedZoom = zoom;
 }
 
 void GameController::SmoothToTarget(
@@ -658,17 +2001,133 @@ void GameController::SmoothToTarget(
     }
 }
 
+void GameController::UpdateShipLoad()
+{
+    //
+    // Reap cancelled loads whose threads have quit
+    //
+
+    for (auto it = mCancelledShipLoads.begin(); it != mCancelledShipLoads.end(); )
+    {
+        bool isCompleted;
+        {
+            std::lock_guard<std::mutex> lock((*it)->Mutex);
+            isCompleted = (*it)->IsCompleted;
+        }
+
+        if (isCompleted)
+        {
+            (*it)->Thread.join();
+            it = mCancelledShipLoads.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (!mShipLoad)
+        return;
+
+    //
+    // Report progress
+    //
+
+    std::optional<std::pair<float, std::string>> progress;
+    bool isCompleted;
+    {
+        std::lock_guard<std::mutex> lock(mShipLoad->Mutex);
+        progress = std::move(mShipLoad->PendingProgress);
+        mShipLoad->PendingProgress.reset();
+        isCompleted = mShipLoad->IsCompleted;
+    }
+
+    if (!!progress && !!mShipLoad->OnProgress)
+    {
+        mShipLoad->OnProgress(progress->first, progress->second);
+    }
+
+    if (!isCompleted)
+        return;
+
+    //
+    // The load has completed: swap the new world in, as the synchronous load does
+    //
+
+    mShipLoad->Thread.join();
+    std::unique_ptr<ShipLoad> shipLoad = std::move(mShipLoad);
+
+    if (!shipLoad->LoadedShipDefinition)
+    {
+        assert(!shipLoad->ErrorMessage.empty());
+        shipLoad->OnCompletion(std::nullopt, shipLoad->ErrorMessage);
+        return;
+    }
+
+    ShipMetadata shipMetadata(shipLoad->LoadedShipDefinition->Metadata);
+
+    try
+    {
+        Reset(std::move(shipLoad->NewWorld));
+
+        OnShipAdded(
+            std::move(*(shipLoad->LoadedShipDefinition)),
+            shipLoad->ShipDefinitionFilepath,
+            shipLoad->LoadedShipId);
+    }
+    catch (std::exception const & ex)
+    {
+        shipLoad->OnCompletion(std::nullopt, ex.what());
+        return;
+    }
+
+    shipLoad->OnCompletion(shipMetadata, std::string());
+}
+
+std::unique_ptr<Physics::World> GameController::MakeWorld()
+{
+    // Creating a world fires events, which must not race with those of the simulation thread
+    std::unique_lock<std::mutex> lock(mWorldMutex, std::defer_lock);
+    if (IsSimulationThreadRunning())
+        lock.lock();
+
+    return std::make_unique<Physics::World>(
+        mWorldGameEventChannel,
+        mGameParameters,
+        *mResourceLoader);
+}
+
 void GameController::Reset(std::unique_ptr<Physics::World> newWorld)
 {
+    mIsWorldDirtyForRendering = true;
+
     // Reset world
     assert(!!mWorld);
-    mWorld = std::move(newWorld);
+    {
+        std::unique_lock<std::mutex> lock(mWorldMutex, std::defer_lock);
+        if (IsSimulationThreadRunning())
+            lock.lock();
+
+        // The old world's storage is kept for the next world, e.g. for when this ship is reloaded
+        BulkStorageRecycler::GetInstance().BeginCapture();
+        mWorld = std::move(newWorld);
+        BulkStorageRecycler::GetInstance().EndCapture();
+
+        // The new world's ships start measuring from scratch
+        mTotalShipPerfStats.Reset();
+        mLastShipPerfStats.Reset();
+
+        // Forget about the interactions with the old world
+        std::lock_guard<std::mutex> commandsLock(mPendingWorldCommandsMutex);
+        mPendingWorldCommands.clear();
+    }
 
     // Reset rendering engine
     assert(!!mRenderContext);
     mRenderContext->Reset();
 
-    // Notify
+    // Notify, after the events of the old world
+    mWorldGameEventChannel->Drain();
     mGameEventDispatcher->OnGameReset();
 }
 
@@ -677,10 +2136,13 @@ void GameController::OnShipAdded(
     std::filesystem::path const & shipDefinitionFilepath,
     ShipId shipId)
 {
+    mIsWorldDirtyForRendering = true;
+
     // Add ship to rendering engine
     mRenderContext->AddShip(
         shipId,
         mWorld->GetShipPointCount(shipId),
+        shipDefinition.StructuralLayerImage.Size,
         std::move(shipDefinition.TextureLayerImage),
         shipDefinition.TextureOrigin);
 
@@ -735,6 +2197,40 @@ void GameController::PublishStats(std::chrono::steady_clock::time_point nowReal)
     assert(!!mGameEventDispatcher);
     mGameEventDispatcher->OnUpdateToRenderRatioUpdated(lastURRatio);
 
+    // Publish frame time percentiles
+    FrameTimeStatistics frameTimeStatistics;
+    frameTimeStatistics.Update = mUpdateFrameTimes.GetPercentiles();
+    frameTimeStatistics.Render = mRenderFrameTimes.GetPercentiles();
+    frameTimeStatistics.Swap = mSwapFrameTimes.GetPercentiles();
+    frameTimeStatistics.InputLatency = mInputLatencyFrameTimes.GetPercentiles();
+    mGameEventDispatcher->OnFrameTimeStatisticsUpdated(frameTimeStatistics);
+
+    // Publish ship statistics
+    auto const shipStatistics = RunWorldQuery(
+        [](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            return world.GetShipStatistics();
+        });
+
+    mGameEventDispatcher->OnCustomProbe("Ship Water", shipStatistics.TotalWater);
+
+    // Publish memory footprint
+    auto const memoryReport = GetMemoryReport();
+    mGameEventDispatcher->OnCustomProbe("Ship CPU MB", static_cast<float>(memoryReport.GetTotalByteSize("CPU")) / (1024.0f * 1024.0f));
+    mGameEventDispatcher->OnCustomProbe("Ship GPU MB", static_cast<float>(memoryReport.GetTotalByteSize("GPU")) / (1024.0f * 1024.0f));
+
+    mTelemetryCpuMemoryBytes = memoryReport.GetTotalByteSize("CPU");
+    mTelemetryGpuMemoryBytes = memoryReport.GetTotalByteSize("GPU");
+
+    // Calculate the ship update phases since the last publish
+    mTotalShipPerfStats = RunWorldQuery(
+        [](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            return world.GetShipPerfStats();
+        });
+
+    auto const lastShipPerfStats = mTotalShipPerfStats - mLastShipPerfStats;
+
     // Update status text
     assert(!!mTextLayer);
     mTextLayer->SetStatusText(
@@ -746,5 +2242,88 @@ void GameController::PublishStats(std::chrono::steady_clock::time_point nowReal)
         mRenderContext->GetCameraWorldPosition(),
         totalURRatio,
         lastURRatio,
-        mRenderContext->GetStatistics());
+        mRenderContext->GetStatistics(),
+        shipStatistics,
+        lastShipPerfStats);
+}
+
+void GameController::PublishTelemetry()
+{
+    static_assert(Physics::ShipPerfStats::PhaseCount <= TelemetryRecord::MaxPhaseCount);
+
+    assert(!!mTelemetryRing);
+
+    TelemetryRecord record;
+    std::memset(&record, 0, sizeof(record));
+
+    record.FrameIndex = mTelemetryFrameIndex++;
+    record.TimestampMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - mTelemetryOriginTimestamp).count());
+
+    record.UpdateMillis = mUpdateFrameTimes.GetLastSample();
+    record.RenderMillis = mRenderFrameTimes.GetLastSample();
+    record.SwapMillis = mSwapFrameTimes.GetLastSample();
+
+    auto const [shipCount, shipStatistics, shipPerfStats] = RunWorldQuery(
+        [](Physics::World & world, GameParameters const & /*gameParameters*/)
+        {
+            return std::make_tuple(
+                world.GetShipCount(),
+                world.GetShipStatistics(),
+                world.GetShipPerfStats());
+        });
+
+    // The ship update phases since the last record; ships that have gone
+    // away take their durations with them
+    auto const frameShipPerfStats = shipPerfStats - mTelemetryLastShipPerfStats;
+    mTelemetryLastShipPerfStats = shipPerfStats;
+
+    record.PhaseCount = static_cast<uint32_t>(Physics::ShipPerfStats::PhaseCount);
+    for (size_t p = 0; p < Physics::ShipPerfStats::PhaseCount; ++p)
+    {
+        record.PhaseMillis[p] = std::max(
+            std::chrono::duration<float, std::milli>(frameShipPerfStats.Durations[p]).count(),
+            0.0f);
+    }
+
+    record.ShipCount = static_cast<uint32_t>(shipCount);
+    record.PointCount = static_cast<uint32_t>(shipStatistics.PointCount);
+    record.SpringCount = static_cast<uint32_t>(shipStatistics.SpringCount);
+    record.EphemeralParticleCount = static_cast<uint32_t>(shipStatistics.EphemeralParticleCount);
+    record.SinkingShipCount = static_cast<uint32_t>(shipStatistics.SinkingShipCount);
+    record.TotalWater = shipStatistics.TotalWater;
+
+    record.CpuMemoryBytes = mTelemetryCpuMemoryBytes;
+    record.GpuMemoryBytes = mTelemetryGpuMemoryBytes;
+
+    mTelemetryRing->Write(record);
+}
+
+void GameController::RunIdleTasks(std::chrono::steady_clock::time_point frameStartTimestamp)
+{
+    //
+    // Ship maintenance; only when the world is updated on this thread - as otherwise
+    // it's the simulation thread's time that maintenance would take - and not while
+    // recording a replay, as when maintenance runs would change how the replay goes
+    //
+
+    if (!IsSimulationThreadRunning()
+        && !IsRecordingReplay()
+        && !mIdleTaskScheduler.IsPosted("ShipMaintenance")
+        && mWorld->HasPendingMaintenance(mGameParameters))
+    {
+        mIdleTaskScheduler.Post(
+            "ShipMaintenance",
+            [this]()
+            {
+                // The simulation thread might have been started meanwhile
+                if (!IsSimulationThreadRunning())
+                    mWorld->RunMaintenance(mGameParameters);
+            },
+            MaxShipMaintenanceDelay);
+    }
+
+    mIdleTaskScheduler.RunPendingTasks(
+        frameStartTimestamp
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(mFramePeriod * IdleTaskFramePeriodFraction));
 }
\ No newline at end of file
@@ -5,28 +5,48 @@
 ***************************************************************************************/
 #pragma once
 
+#include "FrameRecorder.h"
+#include "GameEventChannel.h"
 #include "GameEventDispatcher.h"
 #include "GameParameters.h"
+#include "IdleTaskScheduler.h"
 #include "MaterialDatabase.h"
+#include "PerformanceAutotuner.h"
 #include "Physics.h"
 #include "RenderContext.h"
+#include "ReplayLog.h"
 #include "ResourceLoader.h"
 #include "ShipMetadata.h"
 #include "TextLayer.h"
 
 #include <GameCore/Colors.h>
+#include <GameCore/FrameTimeHistogram.h>
 #include <GameCore/GameTypes.h>
 #include <GameCore/GameWallClock.h>
 #include <GameCore/ImageData.h>
+#include <GameCore/MemoryReport.h>
 #include <GameCore/ProgressCallback.h>
+#include <GameCore/RunningAverage.h>
+#include <GameCore/SnapshotExchange.h>
+#include <GameCore/TelemetryRing.h>
+#include <GameCore/TraceLog.h>
 #include <GameCore/Vectors.h>
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /*
  * This class is responsible for managing the game, from its lifetime to the user
@@ -43,6 +63,8 @@ public:
         std::shared_ptr<ResourceLoader> resourceLoader,
         ProgressCallback const & progressCallback);
 
+    ~GameController();
+
     std::shared_ptr<IGameEventHandler> GetGameEventHandler()
     {
         assert(!!mGameEventDispatcher);
@@ -53,21 +75,264 @@ public:
 
     ShipMetadata ResetAndLoadShip(std::filesystem::path const & shipDefinitionFilepath);
     ShipMetadata AddShip(std::filesystem::path const & shipDefinitionFilepath);
+
+    /*
+     * Adds a ship whose definition has already been loaded - e.g. on another thread while
+     * the rest of the game was being initialized - from the specified file.
+     */
+    ShipMetadata AddShip(
+        ShipDefinition shipDefinition,
+        std::filesystem::path const & shipDefinitionFilepath);
     void ReloadLastShip();
 
+    // Invoked with the metadata of the loaded ship, or with the error that failed the load
+    using ShipLoadCompletionCallback = std::function<void(
+        std::optional<ShipMetadata> const & shipMetadata,
+        std::string const & errorMessage)>;
+
+    /*
+     * Loads the specified ship into a new world - as ResetAndLoadShip() does - but on a loading
+     * thread, while the game keeps running. The new world replaces the current one at the
+     * beginning of the first game iteration after the load has completed.
+     *
+     * Both callbacks are always invoked from within RunGameIteration(); the progress callback
+     * may be empty.
+     *
+     * Starting a load while another is in progress cancels the latter.
+     */
+    void ResetAndLoadShipAsync(
+        std::filesystem::path const & shipDefinitionFilepath,
+        ProgressCallback progressCallback,
+        ShipLoadCompletionCallback completionCallback);
+
+    /*
+     * Abandons the ship load in progress, if any; its callbacks won't be invoked anymore,
+     * and the loading thread quits at the end of the loading step it's in.
+     */
+    void CancelShipLoad();
+
+    bool IsLoadingShip() const
+    {
+        return !!mShipLoad;
+    }
+
     RgbImageData TakeScreenshot();
 
+    using ScreenshotHandler = std::function<void(RgbImageData && screenshot)>;
+
+    /*
+     * Captures the next frameCount rendered frames without ever blocking the game loop:
+     * each frame is read back asynchronously, and then handed to the specified handler
+     * on the screenshot thread, where it may be encoded and saved at leisure.
+     *
+     * Starting a burst while another is running replaces the latter.
+     */
+    void StartScreenshotBurst(
+        size_t frameCount,
+        ScreenshotHandler screenshotHandler);
+
+    bool IsScreenshotBurstRunning() const
+    {
+        return mScreenshotBurstRemainingFrameCount > 0;
+    }
+
+    /*
+     * Records frames at the specified rate until StopRecording() is invoked, via the same
+     * asynchronous pipeline as screenshot bursts; frames are written on the screenshot thread,
+     * either as a PNG sequence into the specified folder, or - when the path has the .y4m
+     * extension - as a raw YUV4MPEG2 stream.
+     *
+     * Frames are dropped rather than queued when the screenshot thread falls behind.
+     */
+    void StartRecording(
+        std::filesystem::path const & outputPath,
+        int fps);
+
+    void StopRecording();
+
+    bool IsRecording() const
+    {
+        return !!mFrameRecorder;
+    }
+
+    /*
+     * Resets the random engine with the specified seed, loads the specified ship, and
+     * from then on records all the inputs to the simulation - interactions, game parameters,
+     * and view changes - until StopReplayRecording() is invoked.
+     *
+     * While recording, the game wall clock advances by exactly one simulation step per step,
+     * so that the recording may be replayed step by step by RunReplay().
+     */
+    ShipMetadata StartReplayRecording(
+        std::filesystem::path const & shipDefinitionFilepath,
+        unsigned int randomSeed);
+
+    void StopReplayRecording(std::filesystem::path const & outputFilepath);
+
+    bool IsRecordingReplay() const
+    {
+        return !!mReplayRecording;
+    }
+
+    /*
+     * Saves, as CSV, how long the phases of the ship updates have taken since the
+     * current world was created; all zeroes unless built with ENABLE_PERF_STATS.
+     */
+    void SaveShipPerfStats(std::filesystem::path const & outputFilepath) const;
+
+    /*
+     * Accounts for the memory held by the ships, on the CPU - under "CPU/Ship <id>" - and on
+     * the GPU - under "GPU/Ship <id>".
+     */
+    MemoryReport GetMemoryReport() const;
+
+    /*
+     * Saves, as CSV, the bytes held by each buffer of the ships.
+     */
+    void SaveMemoryReport(std::filesystem::path const & outputFilepath) const;
+
+    /*
+     * Saves a binary snapshot of the dynamic state of the world - positions, velocities,
+     * water, decay, broken springs and triangles, simulation time, and random engines; the
+     * file is written on a background thread, so that the game does not stall on the disk.
+     *
+     * Electrical elements, bombs, pinned points, and the environment - ocean surface, wind,
+     * clouds - are not part of the snapshot.
+     */
+    void SaveWorldSnapshot(std::filesystem::path const & outputFilepath);
+
+    /*
+     * Reloads the ship of the snapshot into a new world, and brings the new world
+     * to the state of the snapshot.
+     */
+    ShipMetadata RestoreWorldSnapshot(std::filesystem::path const & snapshotFilepath);
+
+    /*
+     * Collects the timings of the frames - on the CPU of all threads, and on the GPU
+     * where supported - until StopTracing() is invoked, which saves them as a Chrome
+     * trace; only collected when built with ENABLE_PERF_STATS.
+     */
+    void StartTracing();
+
+    void StopTracing(std::filesystem::path const & outputFilepath);
+
+    bool IsTracing() const
+    {
+        return TraceLog::GetInstance().IsTracing();
+    }
+
+    /*
+     * Re-executes the specified recording back-to-back, without rendering, and returns
+     * how long the simulation took. The world is left as it is at the end of the replay.
+     *
+     * Note that the simulation adapts some of its iteration counts to the last update
+     * durations, hence replays are exact only as long as those stay in the same ballpark.
+     */
+    ReplayStatistics RunReplay(
+        std::filesystem::path const & replayLogFilepath,
+        ProgressCallback const & progressCallback);
+
+    /*
+     * Finds the fastest stable settings for this machine on the default ship - see
+     * PerformanceAutotuner - and tells how the last loaded ship fares with them, when
+     * different. The settings are only returned, not applied; the world is left alone.
+     */
+    AutotuneResult RunAutotune(ProgressCallback const & progressCallback);
+
     void RunGameIteration();
     void LowFrequencyUpdate();
 
+    /*
+     * The period at which RunGameIteration() is invoked, which idle-priority work is
+     * budgeted against.
+     */
+    void SetFramePeriod(std::chrono::steady_clock::duration framePeriod)
+    {
+        mFramePeriod = framePeriod;
+    }
+
     void Update();
     void Render();
 
+    /*
+     * Starts running the simulation on a dedicated thread, at the fixed simulation
+     * step rate; from then on RunGameIteration only renders, in between simulation steps.
+     *
+     * While the simulation thread runs, interactions that return nothing are queued
+     * and run by the simulation thread right before its next step, while interactions
+     * that return something are run right away, in between simulation steps.
+     */
+    void StartSimulationThread();
+    void StopSimulationThread();
+
+    static GameParameters MakeSimulationThreadGameParameters(GameParameters const & gameParameters);
+
+    bool IsSimulationThreadRunning() const
+    {
+        return mSimulationThread.joinable();
+    }
+
+    /*
+     * Moves all rendering work onto a dedicated thread, which takes over the OpenGL context
+     * - made current with the first function and released with the second one, both of
+     * which are invoked on either thread - and which also presents the frames.
+     *
+     * From then on each frame is recorded and handed over to the render thread, and
+     * RunGameIteration prepares the next frame while the render thread replays the
+     * previous one.
+     */
+    void StartRenderThread(
+        std::function<void()> makeContextCurrentFunction,
+        std::function<void()> releaseContextFunction);
+
+    void StopRenderThread();
+
+    bool IsRenderThreadRunning() const
+    {
+        return mRenderContext->IsRenderThreadRunning();
+    }
+
+    /*
+     * How many frames may be on their way to the screen while we go on with the next one:
+     * - 0: a frame is presented as soon as it's rendered, after the GPU has completed it;
+     *   the lowest latency;
+     * - 1: a frame is presented at the next iteration, so that the GPU renders it while we
+     *   update; the default;
+     * - 2: as 1, and the GPU may also still be busy with the frame before; the highest
+     *   throughput.
+     * The render thread presents its frames as soon as it's done with them, though.
+     */
+    size_t GetMaxFramesInFlight() const
+    {
+        return mRenderContext->GetMaxFramesInFlight();
+    }
+
+    void SetMaxFramesInFlight(size_t maxFramesInFlight);
+
+    /*
+     * Publishes the stats of each frame into a ring in shared memory with the specified
+     * name, for external tools to read; see TelemetryRing for its layout.
+     */
+    void StartTelemetry(std::string const & sharedMemoryName);
+
+    void StopTelemetry();
+
+    bool IsTelemetryRunning() const
+    {
+        return !!mTelemetryRing;
+    }
+
 
     //
     // Interactions
     //
 
+    /*
+     * Tells us that the user has just acted on the world; the time until the first frame
+     * rendered from then on is presented is tracked as the input latency.
+     */
+    void NotifyInputEvent();
+
     void SetPaused(bool isPaused);
     void SetMoveToolEngaged(bool isEngaged);
     void SetStatusTextEnabled(bool isEnabled);
@@ -80,6 +345,7 @@ public:
     void SawThrough(vec2f const & startScreenCoordinates, vec2f const & endScreenCoordinates);
     void DrawTo(vec2f const & screenCoordinates, float strengthMultiplier);
     void SwirlAt(vec2f const & screenCoordinates, float strengthMultiplier);
+    void DisplaceOceanSurfaceAt(vec2f const & screenCoordinates, float strengthMultiplier);
     void TogglePinAt(vec2f const & screenCoordinates);
     bool InjectBubblesAt(vec2f const & screenCoordinates);
     bool FloodAt(vec2f const & screenCoordinates, float waterQuantityMultiplier);
@@ -157,7 +423,13 @@ public:
 
     inline bool IsUnderwater(vec2f const & screenCoordinates) const
     {
-        return mWorld->IsUnderwater(ScreenToWorld(screenCoordinates));
+        vec2f const worldCoordinates = ScreenToWorld(screenCoordinates);
+
+        return RunWorldQuery(
+            [worldCoordinates](Physics::World & world, GameParameters const & /*gameParameters*/)
+            {
+                return world.IsUnderwater(worldCoordinates);
+            });
     }
 
     //
@@ -169,6 +441,19 @@ public:
     float GetMinNumMechanicalDynamicsIterationsAdjustment() const { return GameParameters::MinNumMechanicalDynamicsIterationsAdjustment; }
     float GetMaxNumMechanicalDynamicsIterationsAdjustment() const { return GameParameters::MaxNumMechanicalDynamicsIterationsAdjustment; }
 
+    bool GetDoAdaptMechanicalDynamicsIterations() const { return mGameParameters.DoAdaptMechanicalDynamicsIterations; }
+    void SetDoAdaptMechanicalDynamicsIterations(bool value) { mGameParameters.DoAdaptMechanicalDynamicsIterations = value; }
+
+    float GetMinAdaptiveNumMechanicalDynamicsIterationsAdjustment() const { return mGameParameters.MinAdaptiveNumMechanicalDynamicsIterationsAdjustment; }
+    void SetMinAdaptiveNumMechanicalDynamicsIterationsAdjustment(float value) { mGameParameters.MinAdaptiveNumMechanicalDynamicsIterationsAdjustment = value; }
+    float GetMaxAdaptiveNumMechanicalDynamicsIterationsAdjustment() const { return mGameParameters.MaxAdaptiveNumMechanicalDynamicsIterationsAdjustment; }
+    void SetMaxAdaptiveNumMechanicalDynamicsIterationsAdjustment(float value) { mGameParameters.MaxAdaptiveNumMechanicalDynamicsIterationsAdjustment = value; }
+
+    float GetTargetUpdateDurationMillis() const { return mGameParameters.TargetUpdateDurationMillis; }
+    void SetTargetUpdateDurationMillis(float value) { mGameParameters.TargetUpdateDurationMillis = value; }
+    float GetMinTargetUpdateDurationMillis() const { return GameParameters::MinTargetUpdateDurationMillis; }
+    float GetMaxTargetUpdateDurationMillis() const { return GameParameters::MaxTargetUpdateDurationMillis; }
+
     float GetSpringStiffnessAdjustment() const { return mGameParameters.SpringStiffnessAdjustment; }
     void SetSpringStiffnessAdjustment(float value) { mGameParameters.SpringStiffnessAdjustment = value; }
     float GetMinSpringStiffnessAdjustment() const { return GameParameters::MinSpringStiffnessAdjustment; }
@@ -189,6 +474,39 @@ public:
     float GetMinRotAcceler8r() const { return GameParameters::MinRotAcceler8r; }
     float GetMaxRotAcceler8r() const { return GameParameters::MaxRotAcceler8r; }
 
+    bool GetDoParallelizeSpringForces() const { return mGameParameters.DoParallelizeSpringForces; }
+    void SetDoParallelizeSpringForces(bool value) { mGameParameters.DoParallelizeSpringForces = value; }
+
+    bool GetDoParallelizeShipUpdates() const { return mGameParameters.DoParallelizeShipUpdates; }
+    void SetDoParallelizeShipUpdates(bool value) { mGameParameters.DoParallelizeShipUpdates = value; }
+
+    KernelVerificationMode GetKernelVerification() const { return mGameParameters.KernelVerification; }
+    void SetKernelVerification(KernelVerificationMode value) { mGameParameters.KernelVerification = value; }
+
+    bool GetDoInterpolateRenderPositions() const { return mGameParameters.DoInterpolateRenderPositions; }
+    void SetDoInterpolateRenderPositions(bool value) { mGameParameters.DoInterpolateRenderPositions = value; }
+
+    bool GetDoFusePointDynamics() const { return mGameParameters.DoFusePointDynamics; }
+    void SetDoFusePointDynamics(bool value) { mGameParameters.DoFusePointDynamics = value; }
+
+    bool GetDoSleepQuiescentIslands() const { return mGameParameters.DoSleepQuiescentIslands; }
+    void SetDoSleepQuiescentIslands(bool value) { mGameParameters.DoSleepQuiescentIslands = value; }
+
+    bool GetDoSortSpringsSpatially() const { return mGameParameters.DoSortSpringsSpatially; }
+    void SetDoSortSpringsSpatially(bool value) { mGameParameters.DoSortSpringsSpatially = value; }
+
+    bool GetDoSolveSpringsAsConstraints() const { return mGameParameters.DoSolveSpringsAsConstraints; }
+    void SetDoSolveSpringsAsConstraints(bool value) { mGameParameters.DoSolveSpringsAsConstraints = value; }
+
+    bool GetDoUseGPUMechanicalDynamics() const { return mGameParameters.DoUseGPUMechanicalDynamics; }
+    void SetDoUseGPUMechanicalDynamics(bool value) { mGameParameters.DoUseGPUMechanicalDynamics = value; }
+
+    ShipLayoutStrategy GetShipLayout() const { return mGameParameters.ShipLayout; }
+    void SetShipLayout(ShipLayoutStrategy value) { mGameParameters.ShipLayout = value; }
+
+    bool GetDoSnapOffPaletteStructuralColors() const { return mGameParameters.DoSnapOffPaletteStructuralColors; }
+    void SetDoSnapOffPaletteStructuralColors(bool value) { mGameParameters.DoSnapOffPaletteStructuralColors = value; }
+
     float GetWaterDensityAdjustment() const { return mGameParameters.WaterDensityAdjustment; }
     void SetWaterDensityAdjustment(float value) { mGameParameters.WaterDensityAdjustment = value; }
     float GetMinWaterDensityAdjustment() const { return GameParameters::MinWaterDensityAdjustment; }
@@ -209,6 +527,17 @@ public:
     float GetMinWaterCrazyness() const { return GameParameters::MinWaterCrazyness; }
     float GetMaxWaterCrazyness() const { return GameParameters::MaxWaterCrazyness; }
 
+    bool GetDoLowFrequencyWaterDynamics() const { return mGameParameters.DoLowFrequencyWaterDynamics; }
+    void SetDoLowFrequencyWaterDynamics(bool value) { mGameParameters.DoLowFrequencyWaterDynamics = value; }
+
+    unsigned int GetLowFrequencyWaterDynamicsPeriod() const { return mGameParameters.LowFrequencyWaterDynamicsPeriod; }
+    void SetLowFrequencyWaterDynamicsPeriod(unsigned int value) { mGameParameters.LowFrequencyWaterDynamicsPeriod = value; }
+    unsigned int GetMinLowFrequencyWaterDynamicsPeriod() const { return GameParameters::MinLowFrequencyWaterDynamicsPeriod; }
+    unsigned int GetMaxLowFrequencyWaterDynamicsPeriod() const { return GameParameters::MaxLowFrequencyWaterDynamicsPeriod; }
+
+    bool GetDoUseGPUWaterDiffusion() const { return mGameParameters.DoUseGPUWaterDiffusion; }
+    void SetDoUseGPUWaterDiffusion(bool value) { mGameParameters.DoUseGPUWaterDiffusion = value; }
+
     float GetWaterDiffusionSpeedAdjustment() const { return mGameParameters.WaterDiffusionSpeedAdjustment; }
     void SetWaterDiffusionSpeedAdjustment(float value) { mGameParameters.WaterDiffusionSpeedAdjustment = value; }
     float GetMinWaterDiffusionSpeedAdjustment() const { return GameParameters::MinWaterDiffusionSpeedAdjustment; }
@@ -219,6 +548,17 @@ public:
     float GetMinWaveHeight() const { return GameParameters::MinWaveHeight; }
     float GetMaxWaveHeight() const { return GameParameters::MaxWaveHeight; }
 
+    size_t GetWaterSurfaceSamplesCount() const { return mGameParameters.WaterSurfaceSamplesCount; }
+    void SetWaterSurfaceSamplesCount(size_t value) { mGameParameters.WaterSurfaceSamplesCount = value; }
+    size_t GetMinWaterSurfaceSamplesCount() const { return GameParameters::MinWaterSurfaceSamplesCount; }
+    size_t GetMaxWaterSurfaceSamplesCount() const { return GameParameters::MaxWaterSurfaceSamplesCount; }
+
+    bool GetDoSimulateInteractiveWaves() const { return mGameParameters.DoSimulateInteractiveWaves; }
+    void SetDoSimulateInteractiveWaves(bool value) { mGameParameters.DoSimulateInteractiveWaves = value; }
+
+    bool GetDoHandleShipCollisions() const { return mGameParameters.DoHandleShipCollisions; }
+    void SetDoHandleShipCollisions(bool value) { mGameParameters.DoHandleShipCollisions = value; }
+
     bool GetDoModulateWind() const { return mGameParameters.DoModulateWind; }
     void SetDoModulateWind(bool value) { mGameParameters.DoModulateWind = value; }
 
@@ -232,6 +572,11 @@ public:
     float GetMinWindSpeedMaxFactor() const { return GameParameters::MinWindSpeedMaxFactor; }
     float GetMaxWindSpeedMaxFactor() const { return GameParameters::MaxWindSpeedMaxFactor; }
 
+    float GetWindSpatialVariation() const { return mGameParameters.WindSpatialVariation; }
+    void SetWindSpatialVariation(float value) { mGameParameters.WindSpatialVariation = value; }
+    float GetMinWindSpatialVariation() const { return GameParameters::MinWindSpatialVariation; }
+    float GetMaxWindSpatialVariation() const { return GameParameters::MaxWindSpatialVariation; }
+
     float GetSeaDepth() const { return mGameParameters.SeaDepth; }
     void SetSeaDepth(float value) { mGameParameters.SeaDepth = value; }
     float GetMinSeaDepth() const { return GameParameters::MinSeaDepth; }
@@ -282,9 +627,15 @@ public:
     float GetMinLightSpreadAdjustment() const { return GameParameters::MinLightSpreadAdjustment; }
     float GetMaxLightSpreadAdjustment() const { return GameParameters::MaxLightSpreadAdjustment; }
 
+    bool GetDoRenderLampLightOnGPU() const { return mGameParameters.DoRenderLampLightOnGPU; }
+    void SetDoRenderLampLightOnGPU(bool value) { mGameParameters.DoRenderLampLightOnGPU = value; }
+
     bool GetUltraViolentMode() const { return mGameParameters.IsUltraViolentMode; }
     void SetUltraViolentMode(bool value) { mGameParameters.IsUltraViolentMode = value; }
 
+    bool GetDoSimulateEphemeralParticlesOnGPU() const { return mGameParameters.DoSimulateEphemeralParticlesOnGPU; }
+    void SetDoSimulateEphemeralParticlesOnGPU(bool value) { mGameParameters.DoSimulateEphemeralParticlesOnGPU = value; }
+
     bool GetDoGenerateDebris() const { return mGameParameters.DoGenerateDebris; }
     void SetDoGenerateDebris(bool value) { mGameParameters.DoGenerateDebris = value; }
 
@@ -323,6 +674,14 @@ public:
     bool GetShowShipThroughOcean() const { return mRenderContext->GetShowShipThroughOcean(); }
     void SetShowShipThroughOcean(bool value) { mRenderContext->SetShowShipThroughOcean(value); }
 
+    float GetWorldRenderScale() const { return mRenderContext->GetWorldRenderScale(); }
+    void SetWorldRenderScale(float value) { mRenderContext->SetWorldRenderScale(value); }
+    float GetMinWorldRenderScale() const { return Render::RenderContext::MinWorldRenderScale; }
+    float GetMaxWorldRenderScale() const { return Render::RenderContext::MaxWorldRenderScale; }
+
+    bool GetDoAdaptWorldRenderScale() const { return mRenderContext->GetDoAdaptWorldRenderScale(); }
+    void SetDoAdaptWorldRenderScale(bool value) { mRenderContext->SetDoAdaptWorldRenderScale(value); }
+
     float GetWaterLevelOfDetail() const { return mRenderContext->GetWaterLevelOfDetail(); }
     void SetWaterLevelOfDetail(float value) { mRenderContext->SetWaterLevelOfDetail(value); }
     float GetMinWaterLevelOfDetail() const { return Render::RenderContext::MinWaterLevelOfDetail; }
@@ -371,17 +730,57 @@ private:
         , mLastShipLoadedFilepath()
         , mIsPaused(false)
         , mIsMoveToolEngaged(false)
+        , mIsWorldDirtyForRendering(true)
+        , mHasUnpresentedFrame(false)
+        , mPendingInputTimestamp()
+        , mRenderedInputTimestamp()
+        , mRenderThreadInputLatencyMillis(-1.0f)
         // Doers
         , mRenderContext(std::move(renderContext))
         , mSwapRenderBuffersFunction(std::move(swapRenderBuffersFunction))
         , mGameEventDispatcher(std::move(gameEventDispatcher))
+        , mWorldGameEventChannel(std::make_shared<GameEventChannel>(mGameEventDispatcher))
         , mResourceLoader(std::move(resourceLoader))
         , mTextLayer(std::move(textLayer))
         , mWorld(new Physics::World(
-            mGameEventDispatcher,
+            mWorldGameEventChannel,
             mGameParameters,
             *mResourceLoader))
         , mMaterialDatabase(std::move(materialDatabase))
+        // Simulation thread
+        , mSimulationThread()
+        , mIsSimulationThreadStopping(false)
+        , mWorldMutex()
+        , mSimulationGameParameters(MakeSimulationThreadGameParameters(mGameParameters))
+        , mLastPublishedSimulationGameParameters(MakeSimulationThreadGameParameters(mGameParameters))
+        , mIsSimulationPaused(false)
+        , mSimulationUpdateDuration(std::chrono::steady_clock::duration::zero())
+        , mLastSimulationStepTimestamp()
+        , mPendingWorldCommands()
+        , mPendingWorldCommandsMutex()
+        // Screenshots
+        , mScreenshotBurstRemainingFrameCount(0)
+        , mScreenshotBurstHandler()
+        , mFrameRecorder()
+        , mRecordingFramePeriod(std::chrono::steady_clock::duration::zero())
+        , mNextRecordingFrameTimestamp()
+        , mPendingScreenshotHandlers()
+        , mDroppedScreenshotCount(0)
+        , mScreenshotThread()
+        , mScreenshotQueue()
+        , mScreenshotQueueMutex()
+        , mScreenshotQueueCondition()
+        , mIsScreenshotThreadStopping(false)
+        , mSnapshotWriterThread()
+        // Ship loads
+        , mShipLoad()
+        , mCancelledShipLoads()
+        // Replays
+        , mReplayRecording()
+        , mReplayRecordingMutex()
+        , mLastRecordedGameParameters()
+        , mLastRecordedCameraWorldPosition(vec2f::zero())
+        , mLastRecordedZoom(0.0f)
          // Smoothing
         , mCurrentZoom(mRenderContext->GetZoom())
         , mTargetZoom(mCurrentZoom)
@@ -400,14 +799,112 @@ private:
         , mLastTotalUpdateDuration(std::chrono::steady_clock::duration::zero())
         , mTotalRenderDuration(std::chrono::steady_clock::duration::zero())
         , mLastTotalRenderDuration(std::chrono::steady_clock::duration::zero())
+        , mUpdateDurationMillisRunningAverage()
+        , mUpdateFrameTimes()
+        , mRenderFrameTimes()
+        , mSwapFrameTimes()
+        , mInputLatencyFrameTimes()
+        , mTotalShipPerfStats()
+        , mLastShipPerfStats()
         , mOriginTimestampGame(GameWallClock::time_point::min())
         , mSkippedFirstStatPublishes(0)
+        // Telemetry
+        , mTelemetryRing()
+        , mTelemetryFrameIndex(0)
+        , mTelemetryOriginTimestamp()
+        , mTelemetryLastShipPerfStats()
+        , mTelemetryCpuMemoryBytes(0)
+        , mTelemetryGpuMemoryBytes(0)
+        // Idle-priority work
+        , mIdleTaskScheduler()
+        , mFramePeriod(std::chrono::milliseconds(16))
     {
     }
 
     void InternalUpdate();
 
+    void UpdateWorld(GameParameters const & gameParameters);
+
     void InternalRender();
+    void PresentFrame();
+
+    void SimulationThreadLoop();
+    void PublishSimulationGameParameters();
+
+    void StartScreenshot(ScreenshotHandler screenshotHandler);
+
+    void RetrievePendingScreenshots();
+
+    void EnsureScreenshotThreadRunning();
+
+    void ScreenshotThreadLoop();
+
+    void StopScreenshotThread();
+
+    void UpdateShipLoad();
+
+    using WorldCommand = std::function<void(Physics::World &, GameParameters const &)>;
+
+    /*
+     * Runs the specified command against the world, either right away or - when the
+     * simulation thread is running - right before the next simulation step.
+     */
+    template<typename TCommand>
+    void RunWorldCommand(TCommand && command)
+    {
+        assert(!!mWorld);
+
+        mIsWorldDirtyForRendering = true;
+
+        if (IsSimulationThreadRunning())
+        {
+            std::lock_guard<std::mutex> lock(mPendingWorldCommandsMutex);
+
+            mPendingWorldCommands.emplace_back(std::forward<TCommand>(command));
+        }
+        else
+        {
+            command(*mWorld, mGameParameters);
+        }
+    }
+
+    void RunPendingWorldCommands(GameParameters const & gameParameters);
+
+    /*
+     * Runs the specified interaction as a world command, recording it first when we're
+     * recording a replay.
+     */
+    void RunInteraction(ReplayCommand const & command);
+
+    // As RunInteraction(), but as a world query
+    bool RunInteractionQuery(ReplayCommand const & command);
+
+    // Invoked with the world mutex held, when the simulation thread is running
+    void RecordReplayCommand(ReplayCommand const & command, GameParameters const & gameParameters);
+    void RecordReplayStepInputs(GameParameters const & gameParameters);
+    void EndReplayStep();
+
+    // Invoked with the replay recording mutex held
+    void RecordReplayGameParameters(GameParameters const & gameParameters);
+    void RecordReplayView();
+
+    float CalculateRenderInterpolationFactor() const;
+
+    /*
+     * Runs the specified query against the world right away, in between simulation
+     * steps when the simulation thread is running, and returns its result.
+     */
+    template<typename TQuery>
+    std::invoke_result_t<TQuery, Physics::World &, GameParameters const &> RunWorldQuery(TQuery && query) const
+    {
+        assert(!!mWorld);
+
+        std::unique_lock<std::mutex> lock(mWorldMutex, std::defer_lock);
+        if (IsSimulationThreadRunning())
+            lock.lock();
+
+        return query(*mWorld, mGameParameters);
+    }
 
     static void SmoothToTarget(
         float & currentValue,
@@ -415,6 +912,8 @@ private:
         float targetValue,
         std::chrono::steady_clock::time_point startingTime);
 
+    std::unique_ptr<Physics::World> MakeWorld();
+
     void Reset(std::unique_ptr<Physics::World> newWorld);
 
     void OnShipAdded(
@@ -423,6 +922,9 @@ private:
         ShipId shipId);
 
     void PublishStats(std::chrono::steady_clock::time_point nowReal);
+    void PublishTelemetry();
+
+    void RunIdleTasks(std::chrono::steady_clock::time_point frameStartTimestamp);
 
 private:
 
@@ -435,6 +937,22 @@ private:
     bool mIsPaused;
     bool mIsMoveToolEngaged;
 
+    // Whether the world may have changed since the last render, other than by
+    // updates; only tracked to skip renders while paused
+    bool mIsWorldDirtyForRendering;
+
+    // Whether the back buffer holds a frame that has not been swapped in yet
+    bool mHasUnpresentedFrame;
+
+    // The time of the earliest input that has not been rendered yet, and of the earliest
+    // input rendered into the last frame, until it's presented
+    std::optional<std::chrono::steady_clock::time_point> mPendingInputTimestamp;
+    std::optional<std::chrono::steady_clock::time_point> mRenderedInputTimestamp;
+
+    // The input latency of the last frame presented by the render thread, until we
+    // register it; negative when there's none
+    std::atomic<float> mRenderThreadInputLatencyMillis;
+
 
     //
     // The doers
@@ -443,6 +961,7 @@ private:
     std::unique_ptr<Render::RenderContext> mRenderContext;
     std::function<void()> const mSwapRenderBuffersFunction;
     std::shared_ptr<GameEventDispatcher> mGameEventDispatcher;
+    std::shared_ptr<GameEventChannel> mWorldGameEventChannel; // In front of the dispatcher; drained by us once per iteration
     std::shared_ptr<ResourceLoader> mResourceLoader;
     std::shared_ptr<TextLayer> mTextLayer;
 
@@ -454,6 +973,124 @@ private:
     MaterialDatabase mMaterialDatabase;
 
 
+    //
+    // The simulation thread
+    //
+
+    std::thread mSimulationThread;
+    std::atomic<bool> mIsSimulationThreadStopping;
+
+    // Held by the simulation thread while stepping, and by everyone else
+    // while accessing the world when the simulation thread is running
+    mutable std::mutex mWorldMutex;
+
+    // The parameters that the simulation thread runs with; we publish a snapshot whenever
+    // ours change, and the simulation thread picks up the latest one at the start of each
+    // step, holding on to it - untouched - for the whole step
+    SnapshotExchange<GameParameters> mSimulationGameParameters;
+    GameParameters mLastPublishedSimulationGameParameters;
+
+    // The state that the simulation thread runs with; guarded by the world mutex
+    bool mIsSimulationPaused;
+    std::chrono::steady_clock::duration mSimulationUpdateDuration;
+    std::chrono::steady_clock::time_point mLastSimulationStepTimestamp;
+
+    // The interactions waiting for the next simulation step
+    std::vector<WorldCommand> mPendingWorldCommands;
+    std::mutex mPendingWorldCommandsMutex;
+
+
+    //
+    // Screenshot bursts
+    //
+
+    size_t mScreenshotBurstRemainingFrameCount;
+    ScreenshotHandler mScreenshotBurstHandler;
+
+    std::shared_ptr<FrameRecorder> mFrameRecorder; // Shared with the recorded frames still queued
+    std::chrono::steady_clock::duration mRecordingFramePeriod;
+    std::chrono::steady_clock::time_point mNextRecordingFrameTimestamp;
+
+    // The handlers of the screenshots being read back, in the order they were started
+    std::deque<ScreenshotHandler> mPendingScreenshotHandlers;
+
+    // Beyond this many screenshots waiting for the screenshot thread, we drop new ones
+    static constexpr size_t MaxQueuedScreenshots = 8;
+    size_t mDroppedScreenshotCount;
+
+    // The screenshot thread, which hands the retrieved screenshots to their handlers
+    std::thread mScreenshotThread;
+    std::deque<std::pair<ScreenshotHandler, RgbImageData>> mScreenshotQueue;
+    std::mutex mScreenshotQueueMutex; // Guards the queue and the stopping flag
+    std::condition_variable mScreenshotQueueCondition;
+    bool mIsScreenshotThreadStopping;
+
+    // The thread writing the last world snapshot to disk, if any
+    std::thread mSnapshotWriterThread;
+
+
+    //
+    // Asynchronous ship loads
+    //
+
+    struct ShipLoad
+    {
+        std::filesystem::path const ShipDefinitionFilepath;
+        ProgressCallback const OnProgress;
+        ShipLoadCompletionCallback const OnCompletion;
+
+        std::thread Thread;
+        std::atomic<bool> IsCancelled;
+
+        // Guards the state below, which the loading thread fills in
+        std::mutex Mutex;
+        std::optional<std::pair<float, std::string>> PendingProgress;
+        bool IsCompleted;
+        std::unique_ptr<Physics::World> NewWorld;
+        std::optional<ShipDefinition> LoadedShipDefinition;
+        ShipId LoadedShipId;
+        std::string ErrorMessage;
+
+        ShipLoad(
+            std::filesystem::path const & shipDefinitionFilepath,
+            ProgressCallback onProgress,
+            ShipLoadCompletionCallback onCompletion,
+            std::unique_ptr<Physics::World> newWorld)
+            : ShipDefinitionFilepath(shipDefinitionFilepath)
+            , OnProgress(std::move(onProgress))
+            , OnCompletion(std::move(onCompletion))
+            , Thread()
+            , IsCancelled(false)
+            , Mutex()
+            , PendingProgress()
+            , IsCompleted(false)
+            , NewWorld(std::move(newWorld))
+            , LoadedShipDefinition()
+            , LoadedShipId(0)
+            , ErrorMessage()
+        {}
+    };
+
+    // The load in progress, if any
+    std::unique_ptr<ShipLoad> mShipLoad;
+
+    // The cancelled loads whose threads haven't quit yet
+    std::vector<std::unique_ptr<ShipLoad>> mCancelledShipLoads;
+
+
+    //
+    // Replay recording
+    //
+
+    std::unique_ptr<ReplayLog> mReplayRecording;
+    std::mutex mReplayRecordingMutex; // Guards the recording against the simulation thread
+
+    // What we've recorded last, so that we only record changes
+    GameParameters mLastRecordedGameParameters;
+    vec2f mLastRecordedCameraWorldPosition;
+    float mLastRecordedZoom;
+
+
     //
     // The current render parameters that we're smoothing to
     //
@@ -483,6 +1120,50 @@ private:
     std::chrono::steady_clock::duration mLastTotalUpdateDuration;
     std::chrono::steady_clock::duration mTotalRenderDuration;
     std::chrono::steady_clock::duration mLastTotalRenderDuration;
+    RunningAverage<16> mUpdateDurationMillisRunningAverage; // Of the world only, fed back to it
+
+    // The durations of the phases of the last frames, for their percentiles
+    static constexpr size_t FrameTimeWindowSize = 300;
+    FrameTimeHistogram<FrameTimeWindowSize> mUpdateFrameTimes;
+    FrameTimeHistogram<FrameTimeWindowSize> mRenderFrameTimes;
+    FrameTimeHistogram<FrameTimeWindowSize> mSwapFrameTimes;
+    FrameTimeHistogram<FrameTimeWindowSize> mInputLatencyFrameTimes;
+
+    Physics::ShipPerfStats mTotalShipPerfStats; // As of the last publish
+    Physics::ShipPerfStats mLastShipPerfStats;
     GameWallClock::time_point mOriginTimestampGame;
     int mSkippedFirstStatPublishes;
+
+
+    //
+    // Telemetry
+    //
+
+    // Set while the telemetry runs
+    std::unique_ptr<TelemetryRing> mTelemetryRing;
+
+    uint64_t mTelemetryFrameIndex;
+    std::chrono::steady_clock::time_point mTelemetryOriginTimestamp;
+    Physics::ShipPerfStats mTelemetryLastShipPerfStats; // As of the last record
+
+    // As of the last stats publish, as memory reports are too expensive for each frame
+    uint64_t mTelemetryCpuMemoryBytes;
+    uint64_t mTelemetryGpuMemoryBytes;
+
+
+    //
+    // Idle-priority work
+    //
+
+    // Idle tasks may run until this fraction of the frame period, leaving the rest to the
+    // rest of the frame - the UI, the sound, and the buffer swap
+    static constexpr float IdleTaskFramePeriodFraction = 0.75f;
+
+    // Ships do their maintenance themselves after a while, hence it's no use waiting longer than this
+    static constexpr std::chrono::milliseconds MaxShipMaintenanceDelay = std::chrono::milliseconds(1000);
+
+    static constexpr std::chrono::milliseconds MaxTrimRecycledStorageDelay = std::chrono::milliseconds(5000);
+
+    IdleTaskScheduler mIdleTaskScheduler;
+    std::chrono::steady_clock::duration mFramePeriod;
 };
@@ -0,0 +1,707 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-29
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "IGameEventHandler.h"
+
+#include <GameCore/FrameTimeHistogram.h>
+#include <GameCore/GameTypes.h>
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/Vectors.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * A game event handler that records events into a fixed-size ring of compact records,
+ * and forwards them - in their original order - to another handler when drained.
+ *
+ * The ring is single-producer/single-consumer and lock-free: the simulation fires events
+ * into it on its own thread, while the UI thread drains it once per frame, dispatching
+ * the events to the downstream handler there. Producers on different threads must be
+ * serialized externally; the drain never waits for them.
+ *
+ * When the ring is full, events spill into an overflow queue private to the producer,
+ * which moves them into the ring - ahead of any newer event - as soon as there's room
+ * again, or at the latest at the next FlushOverflow(). Events are thus never lost, and
+ * the producer never waits for the consumer.
+ */
+class GameEventChannel : public IGameEventHandler
+{
+public:
+
+    static constexpr size_t Capacity = 4096; // Must be a power of two
+
+    explicit GameEventChannel(std::shared_ptr<IGameEventHandler> downstreamHandler)
+        : mDownstreamHandler(std::move(downstreamHandler))
+        , mRecords(Capacity)
+        , mTexts(Capacity)
+        , mProducerIndex(0)
+        , mOverflowEvents()
+        , mConsumerIndex(0)
+    {
+        assert(!!mDownstreamHandler);
+    }
+
+    //
+    // Producer side
+    //
+
+    /*
+     * Moves as many overflown events as there's room for into the ring; invoked
+     * by the producer once in a while, e.g. at the end of each simulation step.
+     * Returns true when no overflown events are left.
+     */
+    bool FlushOverflow()
+    {
+        size_t iOverflow = 0;
+        for (; iOverflow < mOverflowEvents.size(); ++iOverflow)
+        {
+            if (!TryPush(mOverflowEvents[iOverflow].Record, std::move(mOverflowEvents[iOverflow].Texts)))
+                break;
+        }
+
+        mOverflowEvents.erase(mOverflowEvents.begin(), mOverflowEvents.begin() + iOverflow);
+
+        return mOverflowEvents.empty();
+    }
+
+    //
+    // Consumer side
+    //
+
+    /*
+     * Forwards all the events published so far.
+     */
+    void Drain()
+    {
+        size_t const producerIndex = mProducerIndex.load(std::memory_order_acquire);
+        size_t consumerIndex = mConsumerIndex.load(std::memory_order_relaxed);
+
+        for (; consumerIndex != producerIndex; ++consumerIndex)
+        {
+            size_t const slot = consumerIndex & (Capacity - 1);
+            Dispatch(mRecords[slot], mTexts[slot]);
+        }
+
+        mConsumerIndex.store(consumerIndex, std::memory_order_release);
+    }
+
+public:
+
+    virtual void OnGameReset() override
+    {
+        Push(MakeRecord(EventType::GameReset));
+    }
+
+    virtual void OnShipLoaded(
+        unsigned int id,
+        std::string const & name,
+        std::optional<std::string> const & author) override
+    {
+        EventRecord record = MakeRecord(EventType::ShipLoaded);
+        record.Generic.Size = id;
+        record.Generic.OptionalFlag = author.has_value() ? 1 : -1;
+
+        Push(record, EventTexts{ name, author.value_or(std::string()) });
+    }
+
+    virtual void OnDestroy(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Push(MakeMaterialRecord(EventType::Destroy, structuralMaterial, isUnderwater, size));
+    }
+
+    virtual void OnSpringRepaired(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Push(MakeMaterialRecord(EventType::SpringRepaired, structuralMaterial, isUnderwater, size));
+    }
+
+    virtual void OnTriangleRepaired(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Push(MakeMaterialRecord(EventType::TriangleRepaired, structuralMaterial, isUnderwater, size));
+    }
+
+    virtual void OnSawed(
+        bool isMetal,
+        unsigned int size) override
+    {
+        EventRecord record = MakeRecord(EventType::Sawed);
+        record.Generic.Flag1 = isMetal;
+        record.Generic.Size = size;
+
+        Push(record);
+    }
+
+    virtual void OnPinToggled(
+        bool isPinned,
+        bool isUnderwater) override
+    {
+        EventRecord record = MakeRecord(EventType::PinToggled);
+        record.Generic.Flag1 = isPinned;
+        record.Generic.Flag2 = isUnderwater;
+
+        Push(record);
+    }
+
+    virtual void OnStress(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Push(MakeMaterialRecord(EventType::Stress, structuralMaterial, isUnderwater, size));
+    }
+
+    virtual void OnBreak(
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        Push(MakeMaterialRecord(EventType::Break, structuralMaterial, isUnderwater, size));
+    }
+
+    virtual void OnSinkingBegin(ShipId shipId) override
+    {
+        EventRecord record = MakeRecord(EventType::SinkingBegin);
+        record.Generic.Ship = shipId;
+
+        Push(record);
+    }
+
+    virtual void OnSinkingEnd(ShipId shipId) override
+    {
+        EventRecord record = MakeRecord(EventType::SinkingEnd);
+        record.Generic.Ship = shipId;
+
+        Push(record);
+    }
+
+    virtual void OnLightFlicker(
+        DurationShortLongType duration,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        EventRecord record = MakeRecord(EventType::LightFlicker);
+        record.Generic.Enum = static_cast<std::uint8_t>(duration);
+        record.Generic.Flag1 = isUnderwater;
+        record.Generic.Size = size;
+
+        Push(record);
+    }
+
+    virtual void OnWaterTaken(float waterTaken) override
+    {
+        EventRecord record = MakeRecord(EventType::WaterTaken);
+        record.Floats.Values[0] = waterTaken;
+
+        Push(record);
+    }
+
+    virtual void OnWaterSplashed(float waterSplashed) override
+    {
+        EventRecord record = MakeRecord(EventType::WaterSplashed);
+        record.Floats.Values[0] = waterSplashed;
+
+        Push(record);
+    }
+
+    virtual void OnWindSpeedUpdated(
+        float const zeroSpeedMagnitude,
+        float const baseSpeedMagnitude,
+        float const preMaxSpeedMagnitude,
+        float const maxSpeedMagnitude,
+        vec2f const & windSpeed) override
+    {
+        EventRecord record = MakeRecord(EventType::WindSpeedUpdated);
+        record.Floats.Values[0] = zeroSpeedMagnitude;
+        record.Floats.Values[1] = baseSpeedMagnitude;
+        record.Floats.Values[2] = preMaxSpeedMagnitude;
+        record.Floats.Values[3] = maxSpeedMagnitude;
+        record.Floats.Vector = windSpeed;
+
+        Push(record);
+    }
+
+    virtual void OnCustomProbe(
+        std::string const & name,
+        float value) override
+    {
+        EventRecord record = MakeRecord(EventType::CustomProbe);
+        record.Floats.Values[0] = value;
+
+        Push(record, EventTexts{ name, std::string() });
+    }
+
+    virtual void OnFrameRateUpdated(
+        float immediateFps,
+        float averageFps) override
+    {
+        EventRecord record = MakeRecord(EventType::FrameRateUpdated);
+        record.Floats.Values[0] = immediateFps;
+        record.Floats.Values[1] = averageFps;
+
+        Push(record);
+    }
+
+    virtual void OnUpdateToRenderRatioUpdated(
+        float immediateURRatio) override
+    {
+        EventRecord record = MakeRecord(EventType::UpdateToRenderRatioUpdated);
+        record.Floats.Values[0] = immediateURRatio;
+
+        Push(record);
+    }
+
+    virtual void OnFrameTimeStatisticsUpdated(
+        FrameTimeStatistics const & frameTimeStatistics) override
+    {
+        EventRecord record = MakeRecord(EventType::FrameTimeStatisticsUpdated);
+        record.FrameTimes = frameTimeStatistics;
+
+        Push(record);
+    }
+
+    //
+    // Bombs
+    //
+
+    virtual void OnBombPlaced(
+        ObjectId bombId,
+        BombType bombType,
+        bool isUnderwater) override
+    {
+        EventRecord record = MakeBombRecord(EventType::BombPlaced, bombId);
+        record.Generic.Enum = static_cast<std::uint8_t>(bombType);
+        record.Generic.Flag1 = isUnderwater;
+
+        Push(record);
+    }
+
+    virtual void OnBombRemoved(
+        ObjectId bombId,
+        BombType bombType,
+        std::optional<bool> isUnderwater) override
+    {
+        EventRecord record = MakeBombRecord(EventType::BombRemoved, bombId);
+        record.Generic.Enum = static_cast<std::uint8_t>(bombType);
+        record.Generic.OptionalFlag = EncodeOptionalFlag(isUnderwater);
+
+        Push(record);
+    }
+
+    virtual void OnBombExplosion(
+        BombType bombType,
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        EventRecord record = MakeRecord(EventType::BombExplosion);
+        record.Generic.Enum = static_cast<std::uint8_t>(bombType);
+        record.Generic.Flag1 = isUnderwater;
+        record.Generic.Size = size;
+
+        Push(record);
+    }
+
+    virtual void OnRCBombPing(
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        EventRecord record = MakeRecord(EventType::RCBombPing);
+        record.Generic.Flag1 = isUnderwater;
+        record.Generic.Size = size;
+
+        Push(record);
+    }
+
+    virtual void OnTimerBombFuse(
+        ObjectId bombId,
+        std::optional<bool> isFast) override
+    {
+        EventRecord record = MakeBombRecord(EventType::TimerBombFuse, bombId);
+        record.Generic.OptionalFlag = EncodeOptionalFlag(isFast);
+
+        Push(record);
+    }
+
+    virtual void OnTimerBombDefused(
+        bool isUnderwater,
+        unsigned int size) override
+    {
+        EventRecord record = MakeRecord(EventType::TimerBombDefused);
+        record.Generic.Flag1 = isUnderwater;
+        record.Generic.Size = size;
+
+        Push(record);
+    }
+
+    virtual void OnAntiMatterBombContained(
+        ObjectId bombId,
+        bool isContained) override
+    {
+        EventRecord record = MakeBombRecord(EventType::AntiMatterBombContained, bombId);
+        record.Generic.Flag1 = isContained;
+
+        Push(record);
+    }
+
+    virtual void OnAntiMatterBombPreImploding() override
+    {
+        Push(MakeRecord(EventType::AntiMatterBombPreImploding));
+    }
+
+    virtual void OnAntiMatterBombImploding() override
+    {
+        Push(MakeRecord(EventType::AntiMatterBombImploding));
+    }
+
+private:
+
+    enum class EventType : std::uint8_t
+    {
+        GameReset,
+        ShipLoaded,
+        Destroy,
+        SpringRepaired,
+        TriangleRepaired,
+        Sawed,
+        PinToggled,
+        Stress,
+        Break,
+        SinkingBegin,
+        SinkingEnd,
+        LightFlicker,
+        WaterTaken,
+        WaterSplashed,
+        WindSpeedUpdated,
+        CustomProbe,
+        FrameRateUpdated,
+        UpdateToRenderRatioUpdated,
+        FrameTimeStatisticsUpdated,
+        BombPlaced,
+        BombRemoved,
+        BombExplosion,
+        RCBombPing,
+        TimerBombFuse,
+        TimerBombDefused,
+        AntiMatterBombContained,
+        AntiMatterBombPreImploding,
+        AntiMatterBombImploding
+    };
+
+    struct MaterialPayload
+    {
+        StructuralMaterial const * Material;
+        unsigned int Size;
+        bool IsUnderwater;
+    };
+
+    struct GenericPayload
+    {
+        unsigned int Size;
+        ShipId Ship;
+        ObjectId::LocalObjectId LocalObject;
+        bool Flag1;
+        bool Flag2;
+        std::int8_t OptionalFlag; // -1: none, 0: false, 1: true
+        std::uint8_t Enum;
+    };
+
+    struct FloatsPayload
+    {
+        float Values[4];
+        vec2f Vector;
+    };
+
+    /*
+     * A fixed-size, trivially-copyable record of an event.
+     */
+    struct EventRecord
+    {
+        EventType Type;
+
+        union
+        {
+            MaterialPayload Material;
+            GenericPayload Generic;
+            FloatsPayload Floats;
+            FrameTimeStatistics FrameTimes;
+        };
+
+        explicit EventRecord(EventType type = EventType::GameReset)
+            : Type(type)
+            , Generic()
+        {}
+    };
+
+    static_assert(std::is_trivially_copyable_v<EventRecord>);
+
+    /*
+     * The few events that carry strings keep them out of the records, in a parallel
+     * ring of strings that are only touched for those events.
+     */
+    struct EventTexts
+    {
+        std::string Text1;
+        std::string Text2;
+    };
+
+    struct OverflowEvent
+    {
+        EventRecord Record;
+        std::optional<EventTexts> Texts;
+    };
+
+    static EventRecord MakeRecord(EventType type)
+    {
+        return EventRecord(type);
+    }
+
+    static EventRecord MakeMaterialRecord(
+        EventType type,
+        StructuralMaterial const & structuralMaterial,
+        bool isUnderwater,
+        unsigned int size)
+    {
+        EventRecord record(type);
+        record.Material = MaterialPayload{ &structuralMaterial, size, isUnderwater };
+
+        return record;
+    }
+
+    static EventRecord MakeBombRecord(
+        EventType type,
+        ObjectId bombId)
+    {
+        EventRecord record(type);
+        record.Generic.Ship = bombId.GetShipId();
+        record.Generic.LocalObject = bombId.GetLocalObjectId();
+
+        return record;
+    }
+
+    static std::int8_t EncodeOptionalFlag(std::optional<bool> const & flag)
+    {
+        return flag.has_value() ? (*flag ? 1 : 0) : -1;
+    }
+
+    static std::optional<bool> DecodeOptionalFlag(std::int8_t flag)
+    {
+        return flag < 0 ? std::nullopt : std::optional<bool>(flag > 0);
+    }
+
+    void Push(
+        EventRecord const & record,
+        std::optional<EventTexts> && texts = std::nullopt)
+    {
+        // Keep the order: as long as there are overflown events, newer ones queue up behind them
+        if (!mOverflowEvents.empty())
+        {
+            FlushOverflow();
+        }
+
+        if (!mOverflowEvents.empty() || !TryPush(record, std::move(texts)))
+        {
+            mOverflowEvents.push_back(OverflowEvent{ record, std::move(texts) });
+        }
+    }
+
+    bool TryPush(
+        EventRecord const & record,
+        std::optional<EventTexts> && texts)
+    {
+        size_t const producerIndex = mProducerIndex.load(std::memory_order_relaxed);
+        if (producerIndex - mConsumerIndex.load(std::memory_order_acquire) == Capacity)
+        {
+            // Full
+            return false;
+        }
+
+        size_t const slot = producerIndex & (Capacity - 1);
+        mRecords[slot] = record;
+        if (texts.has_value())
+        {
+            mTexts[slot] = std::move(*texts);
+        }
+
+        mProducerIndex.store(producerIndex + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    void Dispatch(
+        EventRecord const & record,
+        EventTexts const & texts)
+    {
+        IGameEventHandler & handler = *mDownstreamHandler;
+
+        switch (record.Type)
+        {
+            case EventType::GameReset:
+                handler.OnGameReset();
+                break;
+
+            case EventType::ShipLoaded:
+                handler.OnShipLoaded(
+                    record.Generic.Size,
+                    texts.Text1,
+                    record.Generic.OptionalFlag > 0 ? std::optional<std::string>(texts.Text2) : std::nullopt);
+                break;
+
+            case EventType::Destroy:
+                handler.OnDestroy(*record.Material.Material, record.Material.IsUnderwater, record.Material.Size);
+                break;
+
+            case EventType::SpringRepaired:
+                handler.OnSpringRepaired(*record.Material.Material, record.Material.IsUnderwater, record.Material.Size);
+                break;
+
+            case EventType::TriangleRepaired:
+                handler.OnTriangleRepaired(*record.Material.Material, record.Material.IsUnderwater, record.Material.Size);
+                break;
+
+            case EventType::Sawed:
+                handler.OnSawed(record.Generic.Flag1, record.Generic.Size);
+                break;
+
+            case EventType::PinToggled:
+                handler.OnPinToggled(record.Generic.Flag1, record.Generic.Flag2);
+                break;
+
+            case EventType::Stress:
+                handler.OnStress(*record.Material.Material, record.Material.IsUnderwater, record.Material.Size);
+                break;
+
+            case EventType::Break:
+                handler.OnBreak(*record.Material.Material, record.Material.IsUnderwater, record.Material.Size);
+                break;
+
+            case EventType::SinkingBegin:
+                handler.OnSinkingBegin(record.Generic.Ship);
+                break;
+
+            case EventType::SinkingEnd:
+                handler.OnSinkingEnd(record.Generic.Ship);
+                break;
+
+            case EventType::LightFlicker:
+                handler.OnLightFlicker(
+                    static_cast<DurationShortLongType>(record.Generic.Enum),
+                    record.Generic.Flag1,
+                    record.Generic.Size);
+                break;
+
+            case EventType::WaterTaken:
+                handler.OnWaterTaken(record.Floats.Values[0]);
+                break;
+
+            case EventType::WaterSplashed:
+                handler.OnWaterSplashed(record.Floats.Values[0]);
+                break;
+
+            case EventType::WindSpeedUpdated:
+                handler.OnWindSpeedUpdated(
+                    record.Floats.Values[0],
+                    record.Floats.Values[1],
+                    record.Floats.Values[2],
+                    record.Floats.Values[3],
+                    record.Floats.Vector);
+                break;
+
+            case EventType::CustomProbe:
+                handler.OnCustomProbe(texts.Text1, record.Floats.Values[0]);
+                break;
+
+            case EventType::FrameRateUpdated:
+                handler.OnFrameRateUpdated(record.Floats.Values[0], record.Floats.Values[1]);
+                break;
+
+            case EventType::UpdateToRenderRatioUpdated:
+                handler.OnUpdateToRenderRatioUpdated(record.Floats.Values[0]);
+                break;
+
+            case EventType::FrameTimeStatisticsUpdated:
+                handler.OnFrameTimeStatisticsUpdated(record.FrameTimes);
+                break;
+
+            case EventType::BombPlaced:
+                handler.OnBombPlaced(
+                    ObjectId(record.Generic.Ship, record.Generic.LocalObject),
+                    static_cast<BombType>(record.Generic.Enum),
+                    record.Generic.Flag1);
+                break;
+
+            case EventType::BombRemoved:
+                handler.OnBombRemoved(
+                    ObjectId(record.Generic.Ship, record.Generic.LocalObject),
+                    static_cast<BombType>(record.Generic.Enum),
+                    DecodeOptionalFlag(record.Generic.OptionalFlag));
+                break;
+
+            case EventType::BombExplosion:
+                handler.OnBombExplosion(
+                    static_cast<BombType>(record.Generic.Enum),
+                    record.Generic.Flag1,
+                    record.Generic.Size);
+                break;
+
+            case EventType::RCBombPing:
+                handler.OnRCBombPing(record.Generic.Flag1, record.Generic.Size);
+                break;
+
+            case EventType::TimerBombFuse:
+                handler.OnTimerBombFuse(
+                    ObjectId(record.Generic.Ship, record.Generic.LocalObject),
+                    DecodeOptionalFlag(record.Generic.OptionalFlag));
+                break;
+
+            case EventType::TimerBombDefused:
+                handler.OnTimerBombDefused(record.Generic.Flag1, record.Generic.Size);
+                break;
+
+            case EventType::AntiMatterBombContained:
+                handler.OnAntiMatterBombContained(
+                    ObjectId(record.Generic.Ship, record.Generic.LocalObject),
+                    record.Generic.Flag1);
+                break;
+
+            case EventType::AntiMatterBombPreImploding:
+                handler.OnAntiMatterBombPreImploding();
+                break;
+
+            case EventType::AntiMatterBombImploding:
+                handler.OnAntiMatterBombImploding();
+                break;
+        }
+    }
+
+private:
+
+    std::shared_ptr<IGameEventHandler> const mDownstreamHandler;
+
+    std::vector<EventRecord> mRecords;
+    std::vector<EventTexts> mTexts;
+
+    // Written by the producer
+    alignas(CacheLineSize) std::atomic<size_t> mProducerIndex;
+    std::vector<OverflowEvent> mOverflowEvents;
+
+    // Written by the consumer
+    alignas(CacheLineSize) std::atomic<size_t> mConsumerIndex;
+};
@@ -7,27 +7,27 @@
 
 #include "IGameEventHandler.h"
 
-#include <GameCore/TupleKeys.h>
-
 #include <algorithm>
+#include <cassert>
 #include <optional>
+#include <tuple>
 #include <vector>
 
 class GameEventDispatcher : public IGameEventHandler
 {
 public:
 
-    GameEventDispatcher()
-        : mSpringRepairedEvents()
-        , mTriangleRepairedEvents()
-        , mStressEvents()
-        , mBreakEvents()
+    GameEventDispatcher(size_t structuralMaterialCount)
+        : mSpringRepairedEvents(structuralMaterialCount * 2)
+        , mTriangleRepairedEvents(structuralMaterialCount * 2)
+        , mStressEvents(structuralMaterialCount * 2)
+        , mBreakEvents(structuralMaterialCount * 2)
         , mSinkingBeginEvents()
         , mSinkingEndEvents()
-        , mLightFlickerEvents()
-        , mBombExplosionEvents()
-        , mRCBombPingEvents()
-        , mTimerBombDefusedEvents()
+        , mLightFlickerEvents(DurationShortLongTypeCount * 2)
+        , mBombExplosionEvents(BombTypeCount * 2)
+        , mRCBombPingEvents(2)
+        , mTimerBombDefusedEvents(2)
         , mSinks()
     {
     }
@@ -72,7 +72,10 @@ public:
         bool isUnderwater,
         unsigned int size) override
     {
-        mSpringRepairedEvents[std::make_tuple(&structuralMaterial, isUnderwater)] += size;
+        mSpringRepairedEvents.Add(
+            structuralMaterial.Ordinal * 2 + (isUnderwater ? 1 : 0),
+            std::make_tuple(&structuralMaterial, isUnderwater),
+            size);
     }
 
     virtual void OnTriangleRepaired(
@@ -80,7 +83,10 @@ public:
         bool isUnderwater,
         unsigned int size) override
     {
-        mTriangleRepairedEvents[std::make_tuple(&structuralMaterial, isUnderwater)] += size;
+        mTriangleRepairedEvents.Add(
+            structuralMaterial.Ordinal * 2 + (isUnderwater ? 1 : 0),
+            std::make_tuple(&structuralMaterial, isUnderwater),
+            size);
     }
 
     virtual void OnSawed(
@@ -110,7 +116,10 @@ public:
         bool isUnderwater,
         unsigned int size) override
     {
-        mStressEvents[std::make_tuple(&structuralMaterial, isUnderwater)] += size;
+        mStressEvents.Add(
+            structuralMaterial.Ordinal * 2 + (isUnderwater ? 1 : 0),
+            std::make_tuple(&structuralMaterial, isUnderwater),
+            size);
     }
 
     virtual void OnBreak(
@@ -118,7 +127,10 @@ public:
         bool isUnderwater,
         unsigned int size) override
     {
-        mBreakEvents[std::make_tuple(&structuralMaterial, isUnderwater)] += size;
+        mBreakEvents.Add(
+            structuralMaterial.Ordinal * 2 + (isUnderwater ? 1 : 0),
+            std::make_tuple(&structuralMaterial, isUnderwater),
+            size);
     }
 
     virtual void OnSinkingBegin(ShipId shipId) override
@@ -142,7 +154,10 @@ public:
         bool isUnderwater,
         unsigned int size) override
     {
-        mLightFlickerEvents[std::make_tuple(duration, isUnderwater)] += size;
+        mLightFlickerEvents.Add(
+            static_cast<size_t>(duration) * 2 + (isUnderwater ? 1 : 0),
+            std::make_tuple(duration, isUnderwater),
+            size);
     }
 
     virtual void OnWaterTaken(float waterTaken) override
@@ -219,6 +234,17 @@ public:
         }
     }
 
+    virtual void OnFrameTimeStatisticsUpdated(
+        FrameTimeStatistics const & frameTimeStatistics) override
+    {
+        // No need to aggregate this one
+        for (auto sink : mSinks)
+        {
+            sink->OnFrameTimeStatisticsUpdated(
+                frameTimeStatistics);
+        }
+    }
+
     //
     // Bombs
     //
@@ -258,14 +284,20 @@ public:
         bool isUnderwater,
         unsigned int size) override
     {
-        mBombExplosionEvents[std::make_tuple(bombType, isUnderwater)] += size;
+        mBombExplosionEvents.Add(
+            static_cast<size_t>(bombType) * 2 + (isUnderwater ? 1 : 0),
+            std::make_tuple(bombType, isUnderwater),
+            size);
     }
 
     virtual void OnRCBombPing(
         bool isUnderwater,
         unsigned int size) override
     {
-        mRCBombPingEvents[std::make_tuple(isUnderwater)] += size;
+        mRCBombPingEvents.Add(
+            isUnderwater ? 1 : 0,
+            std::make_tuple(isUnderwater),
+            size);
     }
 
     virtual void OnTimerBombFuse(
@@ -285,7 +317,10 @@ public:
         bool isUnderwater,
         unsigned int size) override
     {
-        mTimerBombDefusedEvents[std::make_tuple(isUnderwater)] += size;
+        mTimerBombDefusedEvents.Add(
+            isUnderwater ? 1 : 0,
+            std::make_tuple(isUnderwater),
+            size);
     }
 
     virtual void OnAntiMatterBombContained(
@@ -329,25 +364,29 @@ public:
         // Publish aggregations
         for (IGameEventHandler * sink : mSinks)
         {
-            for (auto const & entry : mSpringRepairedEvents)
-            {
-                sink->OnSpringRepaired(*(std::get<0>(entry.first)), std::get<1>(entry.first), entry.second);
-            }
-
-            for (auto const & entry : mTriangleRepairedEvents)
-            {
-                sink->OnTriangleRepaired(*(std::get<0>(entry.first)), std::get<1>(entry.first), entry.second);
-            }
-
-            for (auto const & entry : mStressEvents)
-            {
-                sink->OnStress(*(std::get<0>(entry.first)), std::get<1>(entry.first), entry.second);
-            }
-
-            for (auto const & entry : mBreakEvents)
-            {
-                sink->OnBreak(*(std::get<0>(entry.first)), std::get<1>(entry.first), entry.second);
-            }
+            mSpringRepairedEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnSpringRepaired(*(std::get<0>(key)), std::get<1>(key), size);
+                });
+
+            mTriangleRepairedEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnTriangleRepaired(*(std::get<0>(key)), std::get<1>(key), size);
+                });
+
+            mStressEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnStress(*(std::get<0>(key)), std::get<1>(key), size);
+                });
+
+            mBreakEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnBreak(*(std::get<0>(key)), std::get<1>(key), size);
+                });
 
             for (auto const & shipId : mSinkingBeginEvents)
             {
@@ -359,25 +398,29 @@ public:
                 sink->OnSinkingEnd(shipId);
             }
 
-            for (auto const & entry : mLightFlickerEvents)
-            {
-                sink->OnLightFlicker(std::get<0>(entry.first), std::get<1>(entry.first), entry.second);
-            }
-
-            for (auto const & entry : mBombExplosionEvents)
-            {
-                sink->OnBombExplosion(std::get<0>(entry.first), std::get<1>(entry.first), entry.second);
-            }
-
-            for (auto const & entry : mRCBombPingEvents)
-            {
-                sink->OnRCBombPing(std::get<0>(entry.first), entry.second);
-            }
-
-            for (auto const & entry : mTimerBombDefusedEvents)
-            {
-                sink->OnTimerBombDefused(std::get<0>(entry.first), entry.second);
-            }
+            mLightFlickerEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnLightFlicker(std::get<0>(key), std::get<1>(key), size);
+                });
+
+            mBombExplosionEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnBombExplosion(std::get<0>(key), std::get<1>(key), size);
+                });
+
+            mRCBombPingEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnRCBombPing(std::get<0>(key), size);
+                });
+
+            mTimerBombDefusedEvents.Visit(
+                [sink](auto const & key, unsigned int size)
+                {
+                    sink->OnTimerBombDefused(std::get<0>(key), size);
+                });
         }
 
         // Clear collections
@@ -391,7 +434,6 @@ public:
         mBombExplosionEvents.clear();
         mRCBombPingEvents.clear();
         mTimerBombDefusedEvents.clear();
-        mTimerBombDefusedEvents.clear();
     }
 
     void RegisterSink(IGameEventHandler * sink)
@@ -401,17 +443,95 @@ public:
 
 private:
 
-    // The current events being aggregated
-    unordered_tuple_map<std::tuple<StructuralMaterial const *, bool>, unsigned int> mSpringRepairedEvents;
-    unordered_tuple_map<std::tuple<StructuralMaterial const *, bool>, unsigned int> mTriangleRepairedEvents;
-    unordered_tuple_map<std::tuple<StructuralMaterial const *, bool>, unsigned int> mStressEvents;
-    unordered_tuple_map<std::tuple<StructuralMaterial const *, bool>, unsigned int> mBreakEvents;
+    static constexpr size_t DurationShortLongTypeCount = static_cast<size_t>(DurationShortLongType::Long) + 1;
+    static constexpr size_t BombTypeCount = static_cast<size_t>(BombType::TimerBomb) + 1;
+
+    /*
+     * Sums up the sizes of the events with the same key, in a slot per key; the slots
+     * are allocated once and for all, and flushing only visits the slots touched since
+     * the last clear - hence aggregating allocates nothing.
+     */
+    template<typename TKey>
+    class EventAggregation
+    {
+    public:
+
+        explicit EventAggregation(size_t slotCount)
+            : mSlots(slotCount)
+            , mTouchedSlotIndices()
+        {
+            mTouchedSlotIndices.reserve(slotCount);
+        }
+
+        void Add(
+            size_t slotIndex,
+            TKey const & key,
+            unsigned int size)
+        {
+            assert(slotIndex < mSlots.size());
+
+            Slot & slot = mSlots[slotIndex];
+            if (!slot.IsTouched)
+            {
+                slot.Key = key;
+                slot.IsTouched = true;
+                mTouchedSlotIndices.push_back(slotIndex);
+            }
+
+            slot.Size += size;
+        }
+
+        template<typename TVisitor>
+        void Visit(TVisitor && visitor) const
+        {
+            for (size_t slotIndex : mTouchedSlotIndices)
+            {
+                visitor(mSlots[slotIndex].Key, mSlots[slotIndex].Size);
+            }
+        }
+
+        void clear()
+        {
+            for (size_t slotIndex : mTouchedSlotIndices)
+            {
+                mSlots[slotIndex].Size = 0;
+                mSlots[slotIndex].IsTouched = false;
+            }
+
+            mTouchedSlotIndices.clear();
+        }
+
+    private:
+
+        struct Slot
+        {
+            TKey Key;
+            unsigned int Size;
+            bool IsTouched;
+
+            Slot()
+                : Key()
+                , Size(0)
+                , IsTouched(false)
+            {}
+        };
+
+        std::vector<Slot> mSlots;
+        std::vector<size_t> mTouchedSlotIndices;
+    };
+
+    // The current events being aggregated; the slots of the material events are
+    // indexed by material ordinal and underwater-ness
+    EventAggregation<std::tuple<StructuralMaterial const *, bool>> mSpringRepairedEvents;
+    EventAggregation<std::tuple<StructuralMaterial const *, bool>> mTriangleRepairedEvents;
+    EventAggregation<std::tuple<StructuralMaterial const *, bool>> mStressEvents;
+    EventAggregation<std::tuple<StructuralMaterial const *, bool>> mBreakEvents;
     std::vector<ShipId> mSinkingBeginEvents;
     std::vector<ShipId> mSinkingEndEvents;
-    unordered_tuple_map<std::tuple<DurationShortLongType, bool>, unsigned int> mLightFlickerEvents;
-    unordered_tuple_map<std::tuple<BombType, bool>, unsigned int> mBombExplosionEvents;
-    unordered_tuple_map<std::tuple<bool>, unsigned int> mRCBombPingEvents;
-    unordered_tuple_map<std::tuple<bool>, unsigned int> mTimerBombDefusedEvents;
+    EventAggregation<std::tuple<DurationShortLongType, bool>> mLightFlickerEvents;
+    EventAggregation<std::tuple<BombType, bool>> mBombExplosionEvents;
+    EventAggregation<std::tuple<bool>> mRCBombPingEvents;
+    EventAggregation<std::tuple<bool>> mTimerBombDefusedEvents;
 
     // The registered sinks
     std::vector<IGameEventHandler *> mSinks;
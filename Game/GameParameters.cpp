@@ -8,17 +8,36 @@
 GameParameters::GameParameters()
 // Dynamics
     : NumMechanicalDynamicsIterationsAdjustment(1.0f)
+    , DoAdaptMechanicalDynamicsIterations(false)
+    , MinAdaptiveNumMechanicalDynamicsIterationsAdjustment(0.5f)
+    , MaxAdaptiveNumMechanicalDynamicsIterationsAdjustment(2.0f)
+    , TargetUpdateDurationMillis(8.0f)
     , SpringStiffnessAdjustment(1.0f)
     , SpringDampingAdjustment(1.0f)
     , SpringStrengthAdjustment(1.0f)
     , RotAcceler8r(1.0f)
+    , DoParallelizeSpringForces(true)
+    , DoParallelizeShipUpdates(true)
+    , KernelVerification(KernelVerificationMode::None)
+    , DoInterpolateRenderPositions(true)
+    , DoFusePointDynamics(true)
+    , DoSleepQuiescentIslands(true)
+    , DoSortSpringsSpatially(false)
+    , DoSolveSpringsAsConstraints(false)
+    , DoUseGPUMechanicalDynamics(false)
+    , ShipLayout(ShipLayoutStrategy::Tiling)
+    , DoSnapOffPaletteStructuralColors(false)
     // Water
     , WaterDensityAdjustment(1.0f)
     , WaterDragAdjustment(1.0f)
     , WaterIntakeAdjustment(1.0f)
     , WaterDiffusionSpeedAdjustment(1.0f)
     , WaterCrazyness(1.0f)
+    , DoLowFrequencyWaterDynamics(true)
+    , LowFrequencyWaterDynamicsPeriod(4)
+    , DoUseGPUWaterDiffusion(false)
     // Ephemeral particles
+    , DoSimulateEphemeralParticlesOnGPU(false)
     , DoGenerateDebris(true)
     , DoGenerateSparkles(true)
     , DoGenerateAirBubbles(true)
@@ -27,13 +46,18 @@ GameParameters::GameParameters()
     , WindSpeedBase(-20.0f)
     , WindSpeedMaxFactor(2.5f)
     , WindGustFrequencyAdjustment(1.0f)
+    , WindSpatialVariation(0.0f)
     // Misc
     , WaveHeight(2.5f)
+    , WaterSurfaceSamplesCount(8192)
+    , DoSimulateInteractiveWaves(false)
+    , DoHandleShipCollisions(false)
     , SeaDepth(300.0f)
     , OceanFloorBumpiness(1.0f)
     , OceanFloorDetailAmplification(10.0f)
     , LuminiscenceAdjustment(1.0f)
     , LightSpreadAdjustment(1.0f)
+    , DoRenderLampLightOnGPU(false)
     , NumberOfStars(1536)
     , NumberOfClouds(48)
     // Interactions
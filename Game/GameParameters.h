@@ -8,6 +8,7 @@
 #include <GameCore/GameTypes.h>
 #include <GameCore/Vectors.h>
 
+#include <algorithm>
 #include <chrono>
 
 /*
@@ -96,6 +97,19 @@ struct GameParameters
             * NumMechanicalDynamicsIterationsAdjustment);
     }
 
+    // When set, each ship chooses its own number of mechanical iterations at
+    // each step, between the min and max adjustments below, based on how strained
+    // its springs are and on how the duration of the last updates compares with
+    // the target update duration; the NumMechanicalDynamicsIterationsAdjustment
+    // parameter is then ignored
+    bool DoAdaptMechanicalDynamicsIterations;
+    float MinAdaptiveNumMechanicalDynamicsIterationsAdjustment;
+    float MaxAdaptiveNumMechanicalDynamicsIterationsAdjustment;
+
+    float TargetUpdateDurationMillis;
+    static constexpr float MinTargetUpdateDurationMillis = 1.0f;
+    static constexpr float MaxTargetUpdateDurationMillis = 50.0f;
+
     float SpringStiffnessAdjustment;
     static constexpr float MinSpringStiffnessAdjustment = 0.001f;
     static constexpr float MaxSpringStiffnessAdjustment = 2.4f;
@@ -114,6 +128,62 @@ struct GameParameters
     static constexpr float MinRotAcceler8r = 0.0f;
     static constexpr float MaxRotAcceler8r = 1000.0f;
 
+    // When set, spring forces are calculated on multiple threads;
+    // only large ships benefit from this
+    bool DoParallelizeSpringForces;
+
+    // When set, and when there are multiple ships, ships are updated
+    // concurrently
+    bool DoParallelizeShipUpdates;
+
+    // The phase whose optimized kernel is also run against its reference implementation,
+    // reporting the divergence between the two as a custom probe; for debugging only,
+    // as it more than doubles the cost of the phase
+    KernelVerificationMode KernelVerification;
+
+    // When set, and when the simulation runs at a different rate than rendering,
+    // the rendered ship positions are interpolated between the last two simulation steps
+    bool DoInterpolateRenderPositions;
+
+    // When set, the per-point passes of each mechanical iteration - integration,
+    // sea floor collisions, and point forces - are fused into a single pass;
+    // when not set, the legacy sequence of passes is run
+    bool DoFusePointDynamics;
+
+    // When set, islands of the ship that have been resting on the sea floor for a while
+    // are put to sleep, and skipped by the dynamics until something wakes them up
+    bool DoSleepQuiescentIslands;
+
+    // When set, after a ship's structure changes its springs get re-sorted by their
+    // location in space, and the spring forces visit them in that order
+    bool DoSortSpringsSpatially;
+
+    // When set, springs are solved as (XPBD) distance constraints rather than as forces,
+    // over a fraction of the mechanical iterations - as substeps - which yields the same
+    // stiffness at a fraction of the cost; the GPU mechanical dynamics is then not used
+    bool DoSolveSpringsAsConstraints;
+    static constexpr int NumMechanicalDynamicsIterationsPerSpringConstraintsSubstep = 4;
+
+    template <typename T>
+    inline T NumSpringConstraintsSubsteps() const
+    {
+        return static_cast<T>(std::max(
+            NumMechanicalDynamicsIterations<int>() / NumMechanicalDynamicsIterationsPerSpringConstraintsSubstep,
+            1));
+    }
+
+    // When set, large ships run their mechanical dynamics on the GPU - when a GPU
+    // calculator is available - unless force fields or sleeping islands are about
+    bool DoUseGPUMechanicalDynamics;
+
+    // How the elements of ships get laid out in memory when ships are loaded
+    ShipLayoutStrategy ShipLayout;
+
+    // When set, the pixels of ships' structural layers whose colors are not those of
+    // any material get the material with the nearest color - or nothing, when white
+    // is nearer - rather than being ignored
+    bool DoSnapOffPaletteStructuralColors;
+
     // Water
 
     float WaterDensityAdjustment;
@@ -140,10 +210,27 @@ struct GameParameters
     static constexpr float MinWaterCrazyness = 0.0f;
     static constexpr float MaxWaterCrazyness = 2.0f;
 
+    // When set, ships that are out of view and are not taking water quickly run the
+    // water dynamics only once every LowFrequencyWaterDynamicsPeriod steps, with a
+    // correspondingly longer time step
+    bool DoLowFrequencyWaterDynamics;
+    unsigned int LowFrequencyWaterDynamicsPeriod;
+    static constexpr unsigned int MinLowFrequencyWaterDynamicsPeriod = 2;
+    static constexpr unsigned int MaxLowFrequencyWaterDynamicsPeriod = 10;
+
+    // When set, large ships diffuse water on the GPU - when a GPU calculator
+    // is available - with the results lagging one water dynamics step behind
+    bool DoUseGPUWaterDiffusion;
+
     // Ephemeral particles
 
     static constexpr ElementCount MaxEphemeralParticles = 4096;
 
+    // When set, debris and sparkles are spawned as records that are simulated and
+    // rendered entirely by the GPU, which can then afford many more of them
+    bool DoSimulateEphemeralParticlesOnGPU;
+    static constexpr ElementCount MaxGPUEphemeralParticles = MaxEphemeralParticles * 10;
+
     bool DoGenerateDebris;
     static constexpr size_t MinDebrisParticlesPerEvent = 4;
     static constexpr size_t MaxDebrisParticlesPerEvent = 9;
@@ -185,12 +272,28 @@ struct GameParameters
     static constexpr float MinWindGustFrequencyAdjustment = 0.1f;
     static constexpr float MaxWindGustFrequencyAdjustment = 10.0f;
 
+    float WindSpatialVariation; // Fraction of the wind speed that varies along the gust fronts travelling across the world
+    static constexpr float MinWindSpatialVariation = 0.0f;
+    static constexpr float MaxWindSpatialVariation = 1.0f;
+
     // Misc
 
     float WaveHeight;
     static constexpr float MinWaveHeight = 0.0f;
     static constexpr float MaxWaveHeight = 30.0f;
 
+    // The number of samples of the water surface over the whole world width;
+    // fewer samples make the surface cheaper to evaluate, and coarser
+    size_t WaterSurfaceSamplesCount;
+    static constexpr size_t MinWaterSurfaceSamplesCount = 1024;
+    static constexpr size_t MaxWaterSurfaceSamplesCount = 32768;
+
+    // When set, bombs, ship impacts and tools make waves that travel along the water surface
+    bool DoSimulateInteractiveWaves;
+
+    // When set, ships - and the pieces they break into - collide with each other
+    bool DoHandleShipCollisions;
+
     float SeaDepth;
     static constexpr float MinSeaDepth = 20.0f;
     static constexpr float MaxSeaDepth = 10000.0f;
@@ -211,6 +314,10 @@ struct GameParameters
     static constexpr float MinLightSpreadAdjustment = 0.0f;
     static constexpr float MaxLightSpreadAdjustment = 5.0f;
 
+    // When set, the ship shaders light each pixel from the list of lamps, rather than
+    // lamp light being diffused to points on the CPU; needs float textures
+    bool DoRenderLampLightOnGPU;
+
     size_t NumberOfStars;
     static constexpr size_t MinNumberOfStars = 0;
     static constexpr size_t MaxNumberOfStars = 10000;
@@ -261,9 +368,14 @@ struct GameParameters
     // Limits
     //
 
+    // World positions are absolute floats, both in the simulation and in the vertex
+    // buffers; within 8192m of the origin these keep a resolution of 1/2048m, which
+    // is what spring lengths and per-step displacements can afford to lose
     static constexpr float MaxWorldWidth = 10000.0f;
     static constexpr float HalfMaxWorldWidth = MaxWorldWidth / 2.0f;
 
+    static_assert(HalfMaxWorldWidth <= 8192.0f);
+
     static constexpr float MaxWorldHeight = 40000.0f;
     static constexpr float HalfMaxWorldHeight = MaxWorldHeight / 2.0f;
 
@@ -278,9 +390,6 @@ struct GameParameters
 
     static constexpr size_t MaxTrianglesPerPoint = 8u;
 
-
-private:
-
     //
     // The basis number of iterations we run in the mechanical dynamics update for
     // each simulation step.
@@ -7,6 +7,7 @@
 
 #include "Materials.h"
 
+#include <GameCore/FrameTimeHistogram.h>
 #include <GameCore/GameTypes.h>
 
 #include <optional>
@@ -150,6 +151,12 @@ public:
         // Default-implemented
     }
 
+    virtual void OnFrameTimeStatisticsUpdated(
+        FrameTimeStatistics const & /*frameTimeStatistics*/)
+    {
+        // Default-implemented
+    }
+
     //
     // Bombs
     //
@@ -0,0 +1,85 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-10
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "IdleTaskScheduler.h"
+
+#include <GameCore/TraceLog.h>
+
+#include <algorithm>
+#include <cstring>
+
+void IdleTaskScheduler::Post(
+    char const * name,
+    std::function<void()> task,
+    clock::duration maxDelay)
+{
+    mPendingTasks.emplace_back(
+        name,
+        std::move(task),
+        clock::now() + maxDelay);
+}
+
+bool IdleTaskScheduler::IsPosted(char const * name) const
+{
+    return std::any_of(
+        mPendingTasks.cbegin(),
+        mPendingTasks.cend(),
+        [name](PendingTask const & pendingTask)
+        {
+            return 0 == std::strcmp(pendingTask.Name, name);
+        });
+}
+
+void IdleTaskScheduler::RunPendingTasks(clock::time_point deadline)
+{
+    // Tasks posted by the tasks we run wait for the next frame
+    size_t pendingTaskCount = mPendingTasks.size();
+
+    for (size_t t = 0; t < pendingTaskCount; )
+    {
+        auto const now = clock::now();
+
+        auto & pendingTask = mPendingTasks[t];
+
+        auto const estimateIt = mEstimatedDurations.find(pendingTask.Name);
+        clock::duration const estimatedDuration = (estimateIt != mEstimatedDurations.end())
+            ? estimateIt->second
+            : clock::duration::zero();
+
+        bool const isOverdue = (now >= pendingTask.OverdueTimestamp);
+
+        if (!isOverdue && now + estimatedDuration > deadline)
+        {
+            // Let it wait, and see whether any of the next ones fits
+            ++t;
+            continue;
+        }
+
+        //
+        // Run it
+        //
+
+        PendingTask runningTask = std::move(pendingTask);
+        mPendingTasks.erase(mPendingTasks.begin() + t);
+        --pendingTaskCount;
+
+        {
+            TRACE_SCOPE(runningTask.Name, "idle");
+
+            runningTask.Task();
+        }
+
+        clock::duration const duration = clock::now() - now;
+
+        clock::duration & estimate = mEstimatedDurations[runningTask.Name];
+        estimate = std::max(
+            duration,
+            std::chrono::duration_cast<clock::duration>(estimate * EstimateDecay));
+
+        ++mRunTaskCount;
+        if (isOverdue)
+            ++mOverdueTaskCount;
+    }
+}
@@ -0,0 +1,110 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-10
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+
+/*
+ * Runs idle-priority tasks - work that may wait, such as maintenance that only makes the
+ * simulation faster - in what is left of each frame after the update and the render, so
+ * that background work makes progress without making frames any longer.
+ *
+ * Tasks run in the order they have been posted, each as long as its estimated duration
+ * fits in the time left; the estimate is the longest recent duration of the tasks with
+ * the same name. A task that doesn't fit is skipped in favor of the ones after it, but
+ * only until it has waited for its maximum delay: from then on it runs at the first
+ * opportunity, regardless of the time left.
+ *
+ * Not thread-safe: tasks are posted and run on the main thread.
+ */
+class IdleTaskScheduler
+{
+public:
+
+    using clock = std::chrono::steady_clock;
+
+    // Estimates decay by this factor each time a task runs, so that one-off long runs are eventually forgotten
+    static constexpr float EstimateDecay = 0.9f;
+
+    IdleTaskScheduler()
+        : mPendingTasks()
+        , mEstimatedDurations()
+        , mRunTaskCount(0)
+        , mOverdueTaskCount(0)
+    {}
+
+    /*
+     * Queues a task; the name must be a string literal.
+     */
+    void Post(
+        char const * name,
+        std::function<void()> task,
+        clock::duration maxDelay);
+
+    bool IsPosted(char const * name) const;
+
+    /*
+     * Runs the pending tasks that fit before the deadline, and the overdue ones.
+     */
+    void RunPendingTasks(clock::time_point deadline);
+
+    /*
+     * Drops all the pending tasks.
+     */
+    void Clear()
+    {
+        mPendingTasks.clear();
+    }
+
+    size_t GetPendingTaskCount() const
+    {
+        return mPendingTasks.size();
+    }
+
+    /*
+     * The number of tasks run so far, and how many of them were run past their maximum delay.
+     */
+    size_t GetRunTaskCount() const
+    {
+        return mRunTaskCount;
+    }
+
+    size_t GetOverdueTaskCount() const
+    {
+        return mOverdueTaskCount;
+    }
+
+private:
+
+    struct PendingTask
+    {
+        char const * Name;
+        std::function<void()> Task;
+        clock::time_point OverdueTimestamp;
+
+        PendingTask(
+            char const * name,
+            std::function<void()> task,
+            clock::time_point overdueTimestamp)
+            : Name(name)
+            , Task(std::move(task))
+            , OverdueTimestamp(overdueTimestamp)
+        {}
+    };
+
+    std::deque<PendingTask> mPendingTasks;
+
+    // Task name -> estimated duration
+    std::map<std::string, clock::duration> mEstimatedDurations;
+
+    size_t mRunTaskCount;
+    size_t mOverdueTaskCount;
+};
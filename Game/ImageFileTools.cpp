@@ -6,19 +6,38 @@
 #include "ImageFileTools.h"
 
 #include <GameCore/GameException.h>
+#include <GameCore/ResourceArchive.h>
 
 #include <IL/il.h>
 #include <IL/ilu.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
+#include <fstream>
+#include <limits>
 #include <regex>
+#include <vector>
+
+std::mutex ImageFileTools::mDevILMutex;
 
 bool ImageFileTools::mIsInitialized = false;
 
 ImageSize ImageFileTools::GetImageSize(std::filesystem::path const & filepath)
 {
+    //
+    // Try the header first, sparing a decode
+    //
+
+    auto const pngImageSize = TryGetPngImageSize(filepath);
+    if (!!pngImageSize)
+    {
+        return *pngImageSize;
+    }
+
+    std::lock_guard<std::mutex> lock(mDevILMutex);
+
     CheckInitialized();
 
     ILuint imghandle;
@@ -31,9 +50,20 @@ ImageSize ImageFileTools::GetImageSize(std::filesystem::path const & filepath)
 
     std::string filepathStr = filepath.string();
     ILconst_string ilFilename(filepathStr.c_str());
-    if (!ilLoadImage(ilFilename))
+
+    std::error_code ec;
+    auto const archiveEntry = std::filesystem::exists(filepath, ec)
+        ? std::nullopt
+        : ResourceArchive::FindMounted(filepath);
+
+    bool const isLoaded = !!archiveEntry
+        ? ilLoadL(ilTypeFromExt(ilFilename), archiveEntry->Data, static_cast<ILuint>(archiveEntry->Size))
+        : ilLoadImage(ilFilename);
+
+    if (!isLoaded)
     {
         ILint devilError = ilGetError();
+        ilDeleteImage(imghandle);
         std::string devilErrorMessage(iluErrorString(devilError));
         throw GameException("Could not load image \"" + filepathStr + "\": " + devilErrorMessage);
     }
@@ -177,6 +207,61 @@ void ImageFileTools::SaveImage(
 ////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+std::optional<ImageSize> ImageFileTools::TryGetPngImageSize(std::filesystem::path const & filepath)
+{
+    //
+    // A PNG starts with its signature, immediately followed by the IHDR chunk:
+    // length (4), type (4), width (4, big-endian), height (4, big-endian), ...
+    //
+
+    static constexpr unsigned char PngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+    unsigned char header[24];
+
+    std::ifstream file(filepath.string(), std::ios::binary | std::ios::in);
+    if (file.is_open())
+    {
+        file.read(reinterpret_cast<char *>(header), sizeof(header));
+        if (!file.good())
+            return std::nullopt;
+    }
+    else
+    {
+        auto const archiveEntry = ResourceArchive::FindMounted(filepath);
+        if (!archiveEntry || archiveEntry->Size < sizeof(header))
+            return std::nullopt;
+
+        std::memcpy(header, archiveEntry->Data, sizeof(header));
+    }
+
+    if (0 != std::memcmp(header, PngSignature, sizeof(PngSignature))
+        || 0 != std::memcmp(header + 12, "IHDR", 4))
+    {
+        return std::nullopt;
+    }
+
+    auto const readBigEndian = [&header](size_t offset) -> std::uint32_t
+    {
+        return (static_cast<std::uint32_t>(header[offset]) << 24)
+            | (static_cast<std::uint32_t>(header[offset + 1]) << 16)
+            | (static_cast<std::uint32_t>(header[offset + 2]) << 8)
+            | static_cast<std::uint32_t>(header[offset + 3]);
+    };
+
+    std::uint32_t const width = readBigEndian(16);
+    std::uint32_t const height = readBigEndian(20);
+
+    // Leave anything odd to DevIL
+    if (width == 0 || height == 0
+        || width > static_cast<std::uint32_t>(std::numeric_limits<int>::max())
+        || height > static_cast<std::uint32_t>(std::numeric_limits<int>::max()))
+    {
+        return std::nullopt;
+    }
+
+    return ImageSize(static_cast<int>(width), static_cast<int>(height));
+}
+
 void ImageFileTools::CheckInitialized()
 {
     if (!mIsInitialized)
@@ -196,6 +281,48 @@ ImageData<TColor> ImageFileTools::InternalLoadImage(
     int targetOrigin,
     std::optional<ResizeInfo> resizeInfo)
 {
+    std::string filepathStr = filepath.string();
+
+    //
+    // Read the file before taking the lock, so that concurrent loads at least
+    // overlap their I/O - DevIL itself may only be used by one thread at a time;
+    // packed files are decoded straight from the archive's mapping
+    //
+
+    std::vector<char> fileBytes;
+    void const * imageBytes;
+    size_t imageByteSize;
+
+    {
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        if (file.is_open())
+        {
+            fileBytes.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(fileBytes.data(), fileBytes.size());
+            if (!file)
+            {
+                throw GameException("Could not load image \"" + filepathStr + "\": the file could not be read");
+            }
+
+            imageBytes = fileBytes.data();
+            imageByteSize = fileBytes.size();
+        }
+        else
+        {
+            auto const archiveEntry = ResourceArchive::FindMounted(filepath);
+            if (!archiveEntry)
+            {
+                throw GameException("Could not load image \"" + filepathStr + "\": the file could not be opened");
+            }
+
+            imageBytes = archiveEntry->Data;
+            imageByteSize = archiveEntry->Size;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mDevILMutex);
+
     CheckInitialized();
 
     //
@@ -206,15 +333,19 @@ ImageData<TColor> ImageFileTools::InternalLoadImage(
     ilGenImages(1, &imghandle);
     ilBindImage(imghandle);
 
-    std::string filepathStr = filepath.string();
     ILconst_string ilFilename(filepathStr.c_str());
-    if (!ilLoadImage(ilFilename))
+    if (!ilLoadL(ilTypeFromExt(ilFilename), imageBytes, static_cast<ILuint>(imageByteSize)))
     {
         ILint devilError = ilGetError();
+        ilDeleteImage(imghandle);
         std::string devilErrorMessage(iluErrorString(devilError));
         throw GameException("Could not load image \"" + filepathStr + "\": " + devilErrorMessage);
     }
 
+    // DevIL has decoded it, so the encoded bytes may go before the conversions below
+    // allocate more copies
+    std::vector<char>().swap(fileBytes);
+
     //
     // Check if we need to convert it
     //
@@ -226,16 +357,14 @@ ImageData<TColor> ImageFileTools::InternalLoadImage(
         if (!ilConvertImage(targetFormat, IL_UNSIGNED_BYTE))
         {
             ILint devilError = ilGetError();
+            ilDeleteImage(imghandle);
             std::string devilErrorMessage(iluErrorString(devilError));
             throw GameException("Could not convert image \"" + filepathStr + "\": " + devilErrorMessage);
         }
     }
 
-    int imageOrigin = ilGetInteger(IL_IMAGE_ORIGIN);
-    if (targetOrigin != imageOrigin)
-    {
-        iluFlipImage();
-    }
+    // Flipping, if needed, happens while copying the data out
+    bool const doFlip = (targetOrigin != ilGetInteger(IL_IMAGE_ORIGIN));
 
 
     //
@@ -264,6 +393,7 @@ ImageData<TColor> ImageFileTools::InternalLoadImage(
         if (!iluScale(newImageSize.Width, newImageSize.Height, depth))
         {
             ILint devilError = ilGetError();
+            ilDeleteImage(imghandle);
             std::string devilErrorMessage(iluErrorString(devilError));
             throw GameException("Could not resize image: " + devilErrorMessage);
         }
@@ -278,7 +408,21 @@ ImageData<TColor> ImageFileTools::InternalLoadImage(
 
     ILubyte const * imageData = ilGetData();
     auto data = std::make_unique<TColor[]>(imageSize.Width * imageSize.Height);
-    std::memcpy(static_cast<void*>(data.get()), imageData, imageSize.Width * imageSize.Height * bpp);
+    if (!doFlip)
+    {
+        std::memcpy(static_cast<void*>(data.get()), imageData, imageSize.Width * imageSize.Height * bpp);
+    }
+    else
+    {
+        size_t const rowSize = static_cast<size_t>(imageSize.Width) * bpp;
+        for (int y = 0; y < imageSize.Height; ++y)
+        {
+            std::memcpy(
+                static_cast<void*>(data.get() + (imageSize.Height - 1 - y) * imageSize.Width),
+                imageData + y * rowSize,
+                rowSize);
+        }
+    }
 
 
     //
@@ -301,6 +445,8 @@ void ImageFileTools::InternalSaveImage(
     int format,
     std::filesystem::path filepath)
 {
+    std::lock_guard<std::mutex> lock(mDevILMutex);
+
     CheckInitialized();
 
     ILuint imghandle;
@@ -9,6 +9,7 @@
 
 #include <filesystem>
 #include <functional>
+#include <mutex>
 #include <optional>
 
 class ImageFileTools
@@ -36,6 +37,8 @@ private:
 
     static void CheckInitialized();
 
+    static std::optional<ImageSize> TryGetPngImageSize(std::filesystem::path const & filepath);
+
     struct ResizeInfo
     {
         std::function<ImageSize(ImageSize const &)> ResizeHandler;
@@ -65,5 +68,9 @@ private:
 
 private:
 
+    // DevIL keeps global state (e.g. the bound image), hence all of our
+    // DevIL calls are serialized, allowing for concurrent callers
+    static std::mutex mDevILMutex;
+
     static bool mIsInitialized;
 };
@@ -10,14 +10,18 @@
 
 #include <GameCore/Colors.h>
 #include <GameCore/GameException.h>
+#include <GameCore/NearestColorLookup.h>
 #include <GameCore/Utils.h>
 
 #include <picojson.h>
 
+#include <array>
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <optional>
+#include <vector>
 
 class MaterialDatabase
 {
@@ -31,6 +35,60 @@ private:
 
     static constexpr auto RopeUniqueMaterialIndex = static_cast<size_t>(StructuralMaterial::MaterialUniqueType::Rope);
 
+    /*
+     * A flat lookup of materials by color key, indexed by the 24 bits of the key itself:
+     * the red and green components select a page of 256 materials, and the blue component
+     * selects the material within the page. Pages are only allocated for the red-green
+     * combinations that have at least one material; all the others share an empty page.
+     *
+     * Lookups cost two array indexings, regardless of the number of materials, which
+     * matters when looking up each pixel of a ship's layers.
+     */
+    template<typename TMaterial>
+    class ColorKeyLookupTable
+    {
+    public:
+
+        ColorKeyLookupTable()
+            : mPageIndices(256 * 256, 0)
+            , mPages(1) // The empty page
+        {
+            mPages[0].fill(nullptr);
+        }
+
+        TMaterial const * Get(ColorKey const & colorKey) const
+        {
+            return mPages[mPageIndices[MakePageIndicesIndex(colorKey)]][colorKey.b];
+        }
+
+        void Set(
+            ColorKey const & colorKey,
+            TMaterial const * material)
+        {
+            uint16_t & pageIndex = mPageIndices[MakePageIndicesIndex(colorKey)];
+            if (pageIndex == 0)
+            {
+                assert(mPages.size() <= std::numeric_limits<uint16_t>::max());
+
+                pageIndex = static_cast<uint16_t>(mPages.size());
+                mPages.emplace_back();
+                mPages.back().fill(nullptr);
+            }
+
+            mPages[pageIndex][colorKey.b] = material;
+        }
+
+    private:
+
+        static size_t MakePageIndicesIndex(ColorKey const & colorKey)
+        {
+            return (static_cast<size_t>(colorKey.r) << 8) | static_cast<size_t>(colorKey.g);
+        }
+
+        std::vector<uint16_t> mPageIndices;
+        std::vector<std::array<TMaterial const *, 256>> mPages;
+    };
+
 public:
 
     static MaterialDatabase Load(ResourceLoader const & resourceLoader)
@@ -56,7 +114,7 @@ public:
             throw GameException("Structural materials definition is not a JSON array");
         }
 
-        picojson::array structuralMaterialsRootArray = structuralMaterialsRoot.get<picojson::array>();
+        picojson::array const & structuralMaterialsRootArray = structuralMaterialsRoot.get<picojson::array>();
         for (auto const & materialElem : structuralMaterialsRootArray)
         {
             if (!materialElem.is<picojson::object>())
@@ -69,7 +127,9 @@ public:
             ColorKey colorKey = Utils::Hex2RgbColor(
                 Utils::GetMandatoryJsonMember<std::string>(materialObject, "color_key"));
 
-            StructuralMaterial material = StructuralMaterial::Create(materialObject);
+            StructuralMaterial material = StructuralMaterial::Create(
+                materialObject,
+                structuralMaterialsMap.size());
 
             // Make sure there are no dupes
             if (structuralMaterialsMap.count(colorKey) != 0)
@@ -133,7 +193,7 @@ public:
             throw GameException("Electrical materials definition is not a JSON array");
         }
 
-        picojson::array electricalMaterialsRootArray = electricalMaterialsRoot.get<picojson::array>();
+        picojson::array const & electricalMaterialsRootArray = electricalMaterialsRoot.get<picojson::array>();
         for (auto const & materialElem : electricalMaterialsRootArray)
         {
             if (!materialElem.is<picojson::object>())
@@ -168,21 +228,18 @@ public:
 
     StructuralMaterial const * FindStructuralMaterial(ColorKey const & colorKey) const
     {
-        auto srchIt = mStructuralMaterialMap.find(colorKey);
-        if (srchIt != mStructuralMaterialMap.end())
-        {
-            return &(srchIt->second);
-        }
-
-        // Check whether it's a rope endpoint
-        if (colorKey.r == mUniqueStructuralMaterials[RopeUniqueMaterialIndex].first.r
-            && ((colorKey.g & 0xF0) == (mUniqueStructuralMaterials[RopeUniqueMaterialIndex].first.g & 0xF0)))
-        {
-            return mUniqueStructuralMaterials[RopeUniqueMaterialIndex].second;
-        }
+        // Rope endpoints are in the lookup as well
+        return mStructuralMaterialLookup.Get(colorKey);
+    }
 
-        // No luck
-        return nullptr;
+    /*
+     * Finds the structural material whose color key is nearest to the specified color,
+     * or nullptr when the background - white - is nearer than any material. Rope
+     * endpoints are never found, as nearness doesn't make a rope.
+     */
+    StructuralMaterial const * FindNearestStructuralMaterial(rgbColor const & color) const
+    {
+        return mNearestStructuralMaterialLookup.Find(color);
     }
 
     auto const & GetStructuralMaterials() const
@@ -190,16 +247,17 @@ public:
         return mStructuralMaterialMap;
     }
 
-    ElectricalMaterial const * FindElectricalMaterial(ColorKey const & colorKey) const
+    /*
+     * Gets the number of structural materials, i.e. one more than the largest of their ordinals.
+     */
+    size_t GetStructuralMaterialCount() const
     {
-        auto srchIt = mElectricalMaterialMap.find(colorKey);
-        if (srchIt != mElectricalMaterialMap.end())
-        {
-            return &(srchIt->second);
-        }
+        return mStructuralMaterialMap.size();
+    }
 
-        // No luck
-        return nullptr;
+    ElectricalMaterial const * FindElectricalMaterial(ColorKey const & colorKey) const
+    {
+        return mElectricalMaterialLookup.Get(colorKey);
     }
 
     StructuralMaterial const & GetUniqueStructuralMaterial(StructuralMaterial::MaterialUniqueType uniqueType) const
@@ -229,10 +287,65 @@ private:
         : mStructuralMaterialMap(std::move(structuralMaterialMap))
         , mElectricalMaterialMap(std::move(electricalMaterialMap))
         , mUniqueStructuralMaterials(uniqueStructuralMaterials)
+        , mStructuralMaterialLookup()
+        , mElectricalMaterialLookup()
+        , mNearestStructuralMaterialLookup(MakeNearestStructuralMaterialPalette(mStructuralMaterialMap))
     {
+        //
+        // Populate lookups; the materials are owned by the maps, whose nodes
+        // never move
+        //
+
+        // Rope endpoints: any color with the rope's red and the rope's green
+        // high nibble; the Load() checks guarantee no other material clashes
+        // with these
+        auto const & ropeEntry = mUniqueStructuralMaterials[RopeUniqueMaterialIndex];
+        for (int g = (ropeEntry.first.g & 0xF0); g <= (ropeEntry.first.g | 0x0F); ++g)
+        {
+            for (int b = 0; b <= 0xFF; ++b)
+            {
+                mStructuralMaterialLookup.Set(
+                    ColorKey(ropeEntry.first.r, static_cast<uint8_t>(g), static_cast<uint8_t>(b)),
+                    ropeEntry.second);
+            }
+        }
+
+        for (auto const & entry : mStructuralMaterialMap)
+        {
+            mStructuralMaterialLookup.Set(entry.first, &(entry.second));
+        }
+
+        for (auto const & entry : mElectricalMaterialMap)
+        {
+            mElectricalMaterialLookup.Set(entry.first, &(entry.second));
+        }
+    }
+
+    static std::vector<std::pair<rgbColor, StructuralMaterial const *>> MakeNearestStructuralMaterialPalette(
+        std::map<ColorKey, StructuralMaterial> const & structuralMaterialMap)
+    {
+        std::vector<std::pair<rgbColor, StructuralMaterial const *>> palette;
+
+        for (auto const & entry : structuralMaterialMap)
+        {
+            if (!entry.second.IsUniqueType(StructuralMaterial::MaterialUniqueType::Rope))
+            {
+                palette.emplace_back(entry.first, &(entry.second));
+            }
+        }
+
+        // The background
+        palette.emplace_back(rgbColor(0xff, 0xff, 0xff), nullptr);
+
+        return palette;
     }
 
     std::map<ColorKey, StructuralMaterial> mStructuralMaterialMap;
     std::map<ColorKey, ElectricalMaterial> mElectricalMaterialMap;
     UniqueMaterialsArray mUniqueStructuralMaterials;
+
+    ColorKeyLookupTable<StructuralMaterial> mStructuralMaterialLookup;
+    ColorKeyLookupTable<ElectricalMaterial> mElectricalMaterialLookup;
+
+    NearestColorLookup<StructuralMaterial const *> mNearestStructuralMaterialLookup;
 };
@@ -7,7 +7,9 @@
 
 #include <GameCore/Utils.h>
 
-StructuralMaterial StructuralMaterial::Create(picojson::object const & structuralMaterialJson)
+StructuralMaterial StructuralMaterial::Create(
+    picojson::object const & structuralMaterialJson,
+    size_t ordinal)
 {
     std::string name = Utils::GetMandatoryJsonMember<std::string>(structuralMaterialJson, "name");
 
@@ -15,7 +17,7 @@ StructuralMaterial StructuralMaterial::Create(picojson::object const & structura
     {
         float strength = Utils::GetMandatoryJsonMember<float>(structuralMaterialJson, "strength");
 
-        picojson::object massJson = Utils::GetMandatoryJsonObject(structuralMaterialJson, "mass");
+        picojson::object const & massJson = Utils::GetMandatoryJsonObject(structuralMaterialJson, "mass");
         float mass = Utils::GetMandatoryJsonMember<float>(massJson, "nominal_mass")
             * Utils::GetMandatoryJsonMember<float>(massJson, "density");
 
@@ -60,7 +62,8 @@ StructuralMaterial StructuralMaterial::Create(picojson::object const & structura
             windReceptivity,
             rustReceptivity,
             uniqueType,
-            materialSound);
+            materialSound,
+            ordinal);
     }
     catch (GameException const & ex)
     {
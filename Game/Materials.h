@@ -52,9 +52,15 @@ struct StructuralMaterial
 
     std::optional<MaterialSoundType> MaterialSound;
 
+    // The dense index of this material among all the structural materials,
+    // assigned at load
+    size_t Ordinal;
+
 public:
 
-    static StructuralMaterial Create(picojson::object const & structuralMaterialJson);
+    static StructuralMaterial Create(
+        picojson::object const & structuralMaterialJson,
+        size_t ordinal);
 
     static MaterialSoundType StrToMaterialSoundType(std::string const & str);
 
@@ -77,7 +83,8 @@ public:
         float windReceptivity,
         float rustReceptivity,
         std::optional<MaterialUniqueType> uniqueType,
-        std::optional<MaterialSoundType> materialSound)
+        std::optional<MaterialSoundType> materialSound,
+        size_t ordinal)
         : Name(name)
         , Strength(strength)
         , Mass(mass)
@@ -92,6 +99,7 @@ public:
         , RustReceptivity(rustReceptivity)
         , UniqueType(uniqueType)
         , MaterialSound(materialSound)
+        , Ordinal(ordinal)
     {}
 };
 
@@ -5,6 +5,10 @@
 ***************************************************************************************/
 #include "Physics.h"
 
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
 namespace Physics {
 
 // Bump map bitmaps smaller than this width are resized up (interpolating) to this width
@@ -39,9 +43,21 @@ namespace /* anonymous */ {
 OceanFloor::OceanFloor(ResourceLoader & resourceLoader)
     : mSamples(new Sample[SamplesCount + 1])
     , mBumpMapSamples(new float[SamplesCount + 1])
+    , mMaxHeightMip(new float[2 * SamplesCount - 1])
     , mCurrentSeaDepth(std::numeric_limits<float>::lowest())
     , mCurrentOceanFloorBumpiness(std::numeric_limits<float>::lowest())
     , mCurrentOceanFloorDetailAmplification(std::numeric_limits<float>::lowest())
+    , mIsDirtyForRendering(true)
+    , mLastUploadedVisibleWorldLeft(0.0f)
+    , mLastUploadedVisibleWorldRight(0.0f)
+    , mLastUploadedVisibleWorldBottom(0.0f)
+    , mDirtySamplesFirst(SamplesCount)
+    , mDirtySamplesLast(-1)
+    , mIsLastUploadOneSegmentPerSample(false)
+    , mLastUploadedFirstSampleIndex(0)
+    , mLastUploadedFirstX(0.0f)
+    , mLastUploadedSliceDx(0.0f)
+    , mLastUploadedSliceCount(0)
 {
     //
     // Initialize bump map
@@ -98,34 +114,44 @@ void OceanFloor::Update(GameParameters const & gameParameters)
         float const oceanFloorBumpiness = gameParameters.OceanFloorBumpiness;
         float const oceanFloorDetailAmplification = gameParameters.OceanFloorDetailAmplification;
 
-        // sample index = 0
-        float previousSampleValue;
-        {
-            previousSampleValue =
-                -seaDepth
-                + 0.0f
-                + mBumpMapSamples[0] * oceanFloorDetailAmplification;
+        // Calulate samples = world y of ocean floor at the sample's x,
+        // four at a time
+        static_assert((SamplesCount % 4) == 0);
+
+        __m128 const dx = _mm_set1_ps(Dx);
+        __m128 const minusSeaDepth = _mm_set1_ps(-seaDepth);
+        __m128 const bumpiness = _mm_set1_ps(oceanFloorBumpiness);
+        __m128 const detailAmplification = _mm_set1_ps(oceanFloorDetailAmplification);
+
+        alignas(16) float sampleValues[4];
 
-            mSamples[0].SampleValue = previousSampleValue;
+        for (int64_t i = 0; i < SamplesCount; i += 4)
+        {
+            __m128 const x = _mm_mul_ps(
+                _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(static_cast<int32_t>(i)), _mm_set_epi32(3, 2, 1, 0))),
+                dx);
+
+            __m128 const c1 = _mm_mul_ps(FastSin4(_mm_mul_ps(x, _mm_set1_ps(BumpFrequency1))), _mm_set1_ps(10.0f));
+            __m128 const c2 = _mm_mul_ps(FastSin4(_mm_mul_ps(x, _mm_set1_ps(BumpFrequency2))), _mm_set1_ps(6.0f));
+            __m128 const c3 = _mm_mul_ps(FastSin4(_mm_mul_ps(x, _mm_set1_ps(BumpFrequency3))), _mm_set1_ps(45.0f));
+
+            __m128 const sampleValue = _mm_add_ps(
+                _mm_add_ps(
+                    minusSeaDepth,
+                    _mm_mul_ps(_mm_sub_ps(_mm_add_ps(c1, c2), c3), bumpiness)),
+                _mm_mul_ps(_mm_loadu_ps(&(mBumpMapSamples[i])), detailAmplification));
+
+            _mm_store_ps(sampleValues, sampleValue);
+
+            mSamples[i + 0].SampleValue = sampleValues[0];
+            mSamples[i + 1].SampleValue = sampleValues[1];
+            mSamples[i + 2].SampleValue = sampleValues[2];
+            mSamples[i + 3].SampleValue = sampleValues[3];
         }
 
-        // Calulate samples = world y of ocean floor at the sample's x
-        // sample index = 1...SamplesCount-1
-        float x = Dx;
-        for (int64_t i = 1; i < SamplesCount; i++, x += Dx)
+        for (int64_t i = 1; i < SamplesCount; ++i)
         {
-            float const c1 = sinf(x * BumpFrequency1) * 10.f;
-            float const c2 = sinf(x * BumpFrequency2) * 6.f;
-            float const c3 = sinf(x * BumpFrequency3) * 45.f;
-            float const sampleValue =
-                -seaDepth
-                + (c1 + c2 - c3) * oceanFloorBumpiness
-                + mBumpMapSamples[i] * oceanFloorDetailAmplification;
-
-            mSamples[i].SampleValue = sampleValue;
-            mSamples[i - 1].SampleValuePlusOneMinusSampleValue = sampleValue - previousSampleValue;
-
-            previousSampleValue = sampleValue;
+            mSamples[i - 1].SampleValuePlusOneMinusSampleValue = mSamples[i].SampleValue - mSamples[i - 1].SampleValue;
         }
 
         // Populate last delta (extra sample has same value as this sample)
@@ -135,6 +161,10 @@ void OceanFloor::Update(GameParameters const & gameParameters)
         mSamples[SamplesCount].SampleValue = mSamples[SamplesCount - 1].SampleValue;
         mSamples[SamplesCount].SampleValuePlusOneMinusSampleValue = 0.0f; // Never used
 
+        UpdateMaxHeightMip(0, SamplesCount - 1);
+
+        mIsDirtyForRendering = true;
+
         // Remember current game parameters
         mCurrentSeaDepth = gameParameters.SeaDepth;
         mCurrentOceanFloorBumpiness = gameParameters.OceanFloorBumpiness;
@@ -146,17 +176,52 @@ void OceanFloor::Upload(
     GameParameters const & /*gameParameters*/,
     Render::RenderContext & renderContext) const
 {
+    //
+    // The land stays in its VBO between uploads, hence we only re-tessellate it
+    // when the floor or the visible world have changed since the last upload;
+    // when instead only some samples have been adjusted, we only re-upload the
+    // segments over those
+    //
+
+    float const visibleWorldLeft = renderContext.GetVisibleWorldLeft();
+    float const visibleWorldRight = renderContext.GetVisibleWorldRight();
+    float const visibleWorldBottom = renderContext.GetVisibleWorldBottom();
+
+    if (!mIsDirtyForRendering
+        && visibleWorldLeft == mLastUploadedVisibleWorldLeft
+        && visibleWorldRight == mLastUploadedVisibleWorldRight
+        && visibleWorldBottom == mLastUploadedVisibleWorldBottom)
+    {
+        if (mDirtySamplesFirst <= mDirtySamplesLast)
+        {
+            UploadDirtySamples(renderContext);
+
+            mDirtySamplesFirst = SamplesCount;
+            mDirtySamplesLast = -1;
+        }
+
+        return;
+    }
+
+    mIsDirtyForRendering = false;
+    mLastUploadedVisibleWorldLeft = visibleWorldLeft;
+    mLastUploadedVisibleWorldRight = visibleWorldRight;
+    mLastUploadedVisibleWorldBottom = visibleWorldBottom;
+
+    mDirtySamplesFirst = SamplesCount;
+    mDirtySamplesLast = -1;
+
     //
     // We want to upload at most RenderSlices slices
     //
 
     // Find index of leftmost sample, and its corresponding world X
-    auto sampleIndex = FastTruncateInt64((renderContext.GetVisibleWorldLeft() + GameParameters::HalfMaxWorldWidth) / Dx);
+    auto sampleIndex = FastTruncateInt64((visibleWorldLeft + GameParameters::HalfMaxWorldWidth) / Dx);
     float sampleIndexX = -GameParameters::HalfMaxWorldWidth + (Dx * sampleIndex);
 
     // Calculate number of samples required to cover screen from leftmost sample
     // up to the visible world right (included)
-    float const coverageWidth = renderContext.GetVisibleWorldRight() - sampleIndexX;
+    float const coverageWidth = visibleWorldRight - sampleIndexX;
     auto const numberOfSamplesToRender = static_cast<int64_t>(ceil(coverageWidth / Dx));
 
     if (numberOfSamplesToRender >= RenderSlices<int64_t>)
@@ -171,13 +236,21 @@ void OceanFloor::Upload(
         float const sliceDx = coverageWidth / RenderSlices<float>;
 
         // We do one extra iteration as the number of slices is the number of quads, and the last vertical
-        // quad side must be at the end of the width
-        for (int64_t s = 0; s <= RenderSlices<int64_t>; ++s, sampleIndexX += sliceDx)
+        // quad side must be at the end of the width; the x's are not accumulated, so that a partial
+        // re-upload lands on the very same x's
+        for (int64_t s = 0; s <= RenderSlices<int64_t>; ++s)
         {
+            float const x = sampleIndexX + sliceDx * static_cast<float>(s);
+
             renderContext.UploadLand(
-                sampleIndexX,
-                GetFloorHeightAt(sampleIndexX));
+                x,
+                GetFloorHeightAt(x));
         }
+
+        mIsLastUploadOneSegmentPerSample = false;
+        mLastUploadedFirstX = sampleIndexX;
+        mLastUploadedSliceDx = sliceDx;
+        mLastUploadedSliceCount = RenderSlices<int64_t>;
     }
     else
     {
@@ -191,17 +264,81 @@ void OceanFloor::Upload(
 
         // We do one extra iteration as the number of slices is the number of quads, and the last vertical
         // quad side must be at the end of the width
-        for (std::int64_t s = 0; s <= numberOfSamplesToRender; ++s, sampleIndexX += Dx)
+        for (std::int64_t s = 0; s <= numberOfSamplesToRender; ++s)
         {
             renderContext.UploadLand(
-                sampleIndexX,
+                sampleIndexX + Dx * static_cast<float>(s),
                 mSamples[s + sampleIndex].SampleValue);
         }
+
+        mIsLastUploadOneSegmentPerSample = true;
+        mLastUploadedFirstSampleIndex = sampleIndex;
+        mLastUploadedFirstX = sampleIndexX;
+        mLastUploadedSliceDx = Dx;
+        mLastUploadedSliceCount = numberOfSamplesToRender;
     }
 
     renderContext.UploadLandEnd();
 }
 
+void OceanFloor::UploadDirtySamples(Render::RenderContext & renderContext) const
+{
+    assert(mDirtySamplesFirst <= mDirtySamplesLast);
+
+    //
+    // Find the range of land segments affected by the dirty samples
+    //
+
+    int64_t firstSegment;
+    int64_t lastSegment;
+
+    if (mIsLastUploadOneSegmentPerSample)
+    {
+        // Each segment is at one sample
+        firstSegment = mDirtySamplesFirst - mLastUploadedFirstSampleIndex;
+        lastSegment = mDirtySamplesLast - mLastUploadedFirstSampleIndex;
+    }
+    else
+    {
+        // Each segment is interpolated between the two samples around it, hence it's
+        // affected by the dirty samples as well as by the one before them, whose delta
+        // has changed
+        float const dirtyLeftX = -GameParameters::HalfMaxWorldWidth + Dx * static_cast<float>(mDirtySamplesFirst - 1);
+        float const dirtyRightX = -GameParameters::HalfMaxWorldWidth + Dx * static_cast<float>(mDirtySamplesLast + 1);
+
+        firstSegment = static_cast<int64_t>(std::floor((dirtyLeftX - mLastUploadedFirstX) / mLastUploadedSliceDx));
+        lastSegment = static_cast<int64_t>(std::ceil((dirtyRightX - mLastUploadedFirstX) / mLastUploadedSliceDx));
+    }
+
+    firstSegment = std::max(firstSegment, int64_t(0));
+    lastSegment = std::min(lastSegment, mLastUploadedSliceCount);
+
+    if (firstSegment > lastSegment)
+    {
+        // Not visible
+        return;
+    }
+
+    //
+    // Re-upload these segments
+    //
+
+    renderContext.UploadLandRangeStart(static_cast<size_t>(firstSegment));
+
+    for (int64_t s = firstSegment; s <= lastSegment; ++s)
+    {
+        float const x = mLastUploadedFirstX + mLastUploadedSliceDx * static_cast<float>(s);
+
+        renderContext.UploadLandRange(
+            x,
+            mIsLastUploadOneSegmentPerSample
+                ? mSamples[s + mLastUploadedFirstSampleIndex].SampleValue
+                : GetFloorHeightAt(x));
+    }
+
+    renderContext.UploadLandRangeEnd();
+}
+
 bool OceanFloor::AdjustTo(
     float x1,
     float targetY1,
@@ -246,7 +383,8 @@ bool OceanFloor::AdjustTo(
 
     bool hasAdjusted = false;
     float x = leftX;
-    for (int64_t s = sampleIndex; x <= rightX; ++s, x += Dx)
+    int64_t s = sampleIndex;
+    for (; x <= rightX; ++s, x += Dx)
     {
         // Update sample value
         float newSampleValue = leftTargetY + slopeY * (x - leftX);
@@ -262,7 +400,158 @@ bool OceanFloor::AdjustTo(
             mSamples[s].SampleValuePlusOneMinusSampleValue = mSamples[s + 1].SampleValue - newSampleValue;
     }
 
+    // Update the mip for the segments touching the adjusted samples
+    if (s > sampleIndex)
+    {
+        UpdateMaxHeightMip(
+            std::max(sampleIndex - 1, int64_t(0)),
+            std::min(s - 1, SamplesCount - 1));
+
+        // Remember the samples to re-upload
+        mDirtySamplesFirst = std::min(mDirtySamplesFirst, sampleIndex);
+        mDirtySamplesLast = std::max(mDirtySamplesLast, s - 1);
+    }
+
     return hasAdjusted;
 }
 
-}
\ No newline at end of file
+
+void OceanFloor::GetFloorHeightsAt(
+    vec2f const * restrict positions,
+    float * restrict heights,
+    size_t count) const
+{
+    //
+    // Four points at a time: the sample indices and the interpolation
+    // are vectorized, while the samples are fetched one by one
+    //
+
+    __m128 const halfMaxWorldWidth = _mm_set1_ps(GameParameters::HalfMaxWorldWidth);
+    __m128 const dx = _mm_set1_ps(Dx);
+
+    alignas(16) int32_t sampleIndices[4];
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // x0 y0 x1 y1, x2 y2 x3 y3
+        __m128 const positions01 = _mm_loadu_ps(reinterpret_cast<float const *>(positions + i));
+        __m128 const positions23 = _mm_loadu_ps(reinterpret_cast<float const *>(positions + i + 2));
+        __m128 const x = _mm_shuffle_ps(positions01, positions23, _MM_SHUFFLE(2, 0, 2, 0));
+
+        // Fractional index in the sample array
+        __m128 const sampleIndexF = _mm_div_ps(_mm_add_ps(x, halfMaxWorldWidth), dx);
+
+        // Integral part
+        __m128i const sampleIndexI = _mm_cvttps_epi32(sampleIndexF);
+
+        // Fractional part within sample index and the next sample index
+        __m128 const sampleIndexDx = _mm_sub_ps(sampleIndexF, _mm_cvtepi32_ps(sampleIndexI));
+
+        _mm_store_si128(reinterpret_cast<__m128i *>(sampleIndices), sampleIndexI);
+
+        assert(sampleIndices[0] >= 0 && sampleIndices[0] <= SamplesCount);
+        assert(sampleIndices[1] >= 0 && sampleIndices[1] <= SamplesCount);
+        assert(sampleIndices[2] >= 0 && sampleIndices[2] <= SamplesCount);
+        assert(sampleIndices[3] >= 0 && sampleIndices[3] <= SamplesCount);
+
+        __m128 const sampleValue = _mm_set_ps(
+            mSamples[sampleIndices[3]].SampleValue,
+            mSamples[sampleIndices[2]].SampleValue,
+            mSamples[sampleIndices[1]].SampleValue,
+            mSamples[sampleIndices[0]].SampleValue);
+
+        __m128 const sampleValuePlusOneMinusSampleValue = _mm_set_ps(
+            mSamples[sampleIndices[3]].SampleValuePlusOneMinusSampleValue,
+            mSamples[sampleIndices[2]].SampleValuePlusOneMinusSampleValue,
+            mSamples[sampleIndices[1]].SampleValuePlusOneMinusSampleValue,
+            mSamples[sampleIndices[0]].SampleValuePlusOneMinusSampleValue);
+
+        _mm_storeu_ps(
+            heights + i,
+            _mm_add_ps(sampleValue, _mm_mul_ps(sampleValuePlusOneMinusSampleValue, sampleIndexDx)));
+    }
+
+    // Remainder
+    for (; i < count; ++i)
+    {
+        heights[i] = GetFloorHeightAt(positions[i].x);
+    }
+}
+
+float OceanFloor::GetMaxFloorHeightIn(
+    float left,
+    float right) const
+{
+    assert(left <= right);
+
+    // Segments at the two ends, inclusive
+    int64_t l = std::clamp(
+        FastTruncateInt64((left + GameParameters::HalfMaxWorldWidth) / Dx),
+        int64_t(0),
+        SamplesCount - 1);
+
+    int64_t r = std::clamp(
+        FastTruncateInt64((right + GameParameters::HalfMaxWorldWidth) / Dx),
+        int64_t(0),
+        SamplesCount - 1);
+
+    //
+    // Climb the mip, taking at each level the cells at the ends of the range
+    // that are not covered by a parent within the range
+    //
+
+    float maxHeight = std::numeric_limits<float>::lowest();
+
+    int64_t levelStart = 0;
+    int64_t levelSize = SamplesCount;
+    while (l <= r)
+    {
+        if ((l & 1) != 0)
+            maxHeight = std::max(maxHeight, mMaxHeightMip[levelStart + l++]);
+
+        if ((r & 1) == 0)
+            maxHeight = std::max(maxHeight, mMaxHeightMip[levelStart + r--]);
+
+        l >>= 1;
+        r >>= 1;
+        levelStart += levelSize;
+        levelSize >>= 1;
+    }
+
+    return maxHeight;
+}
+
+void OceanFloor::UpdateMaxHeightMip(
+    int64_t firstSegment,
+    int64_t lastSegment)
+{
+    assert(firstSegment >= 0 && firstSegment <= lastSegment && lastSegment < SamplesCount);
+
+    // Level 0: the floor is linear within a segment, hence its max is at either end
+    for (int64_t i = firstSegment; i <= lastSegment; ++i)
+    {
+        mMaxHeightMip[i] = std::max(mSamples[i].SampleValue, mSamples[i + 1].SampleValue);
+    }
+
+    // Levels above
+    int64_t levelStart = 0;
+    for (int64_t levelSize = SamplesCount; levelSize > 1; levelSize >>= 1)
+    {
+        int64_t const parentLevelStart = levelStart + levelSize;
+
+        firstSegment >>= 1;
+        lastSegment >>= 1;
+
+        for (int64_t i = firstSegment; i <= lastSegment; ++i)
+        {
+            mMaxHeightMip[parentLevelStart + i] = std::max(
+                mMaxHeightMip[levelStart + 2 * i],
+                mMaxHeightMip[levelStart + 2 * i + 1]);
+        }
+
+        levelStart = parentLevelStart;
+    }
+}
+
+}
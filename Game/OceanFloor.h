@@ -12,6 +12,8 @@
 #include "ResourceLoader.h"
 
 #include <GameCore/GameMath.h>
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/Vectors.h>
 
 #include <memory>
 
@@ -60,6 +62,31 @@ public:
             + mSamples[sampleIndexI].SampleValuePlusOneMinusSampleValue * sampleIndexDx;
     }
 
+    /*
+     * Batch version of GetFloorHeightAt(), sampling the floor height at the x
+     * of each of the specified positions.
+     */
+    void GetFloorHeightsAt(
+        vec2f const * restrict positions,
+        float * restrict heights,
+        size_t count) const;
+
+    /*
+     * Returns the highest the floor gets between the two specified x's,
+     * in (at most) a couple of lookups for each level of the max mip.
+     */
+    float GetMaxFloorHeightIn(
+        float left,
+        float right) const;
+
+private:
+
+    void UpdateMaxHeightMip(
+        int64_t firstSegment,
+        int64_t lastSegment);
+
+    void UploadDirtySamples(Render::RenderContext & renderContext) const;
+
 private:
 
     // The number of samples for the entire world width;
@@ -69,6 +96,9 @@ private:
     // The x step of the samples
     static constexpr float Dx = GameParameters::MaxWorldWidth / static_cast<float>(SamplesCount);
 
+    // The mip needs each level to halve evenly
+    static_assert((SamplesCount & (SamplesCount - 1)) == 0);
+
     // What we store for each sample
     struct Sample
     {
@@ -83,10 +113,36 @@ private:
     // between -H/2 and H/2
     std::unique_ptr<float[]> const mBumpMapSamples;
 
+    // The max mip of the floor: level 0 has the max of each segment between
+    // two samples, and each level above has the max of two cells of the level
+    // below; levels are stored one after the other, the topmost one last
+    std::unique_ptr<float[]> mMaxHeightMip;
+
     // The game parameters for which we're current
     float mCurrentSeaDepth;
     float mCurrentOceanFloorBumpiness;
     float mCurrentOceanFloorDetailAmplification;
+
+    // The state for which we've last uploaded the land; the land is only
+    // re-tessellated when either the whole floor or the visible world change
+    bool mutable mIsDirtyForRendering;
+    float mutable mLastUploadedVisibleWorldLeft;
+    float mutable mLastUploadedVisibleWorldRight;
+    float mutable mLastUploadedVisibleWorldBottom;
+
+    // The range of samples adjusted since the last upload - empty when first > last;
+    // only the land segments over this range get re-uploaded
+    int64_t mutable mDirtySamplesFirst;
+    int64_t mutable mDirtySamplesLast;
+
+    // How the land was tessellated at the last upload: either one segment per
+    // sample starting at the first sample, or slices of equal width starting at
+    // the first x
+    bool mutable mIsLastUploadOneSegmentPerSample;
+    int64_t mutable mLastUploadedFirstSampleIndex;
+    float mutable mLastUploadedFirstX;
+    float mutable mLastUploadedSliceDx;
+    int64_t mutable mLastUploadedSliceCount;
 };
 
 }
@@ -0,0 +1,203 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-03-02
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "ParticleRenderContext.h"
+
+#include <algorithm>
+
+namespace Render {
+
+ParticleRenderContext::ParticleRenderContext(
+    ShaderManager<ShaderManagerTraits> & shaderManager,
+    TextureAtlasMetadata const & genericTextureAtlasMetadata,
+    ViewModel const & viewModel,
+    float ambientLightIntensity)
+    : mShaderManager(shaderManager)
+    , mGenericTextureAtlasMetadata(genericTextureAtlasMetadata)
+    , mViewModel(viewModel)
+    , mPendingVertexBuffer()
+    , mParticleVBO()
+    , mParticleElementVBO()
+    , mParticleVAO()
+    , mNextParticleSlot(0)
+    , mParticleSlotsInUse(0)
+{
+    GLuint tmpGLuint;
+
+    //
+    // Initialize buffers
+    //
+
+    GLuint vbos[2];
+    glGenBuffers(2, vbos);
+    mParticleVBO = vbos[0];
+    mParticleElementVBO = vbos[1];
+
+    // Allocate the whole ring buffer once
+    glBindBuffer(GL_ARRAY_BUFFER, *mParticleVBO);
+    glBufferData(GL_ARRAY_BUFFER, MaxParticles * 4 * sizeof(ParticleVertex), nullptr, GL_DYNAMIC_DRAW);
+    CheckOpenGLError();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The element buffer never changes - two triangles per particle quad
+    {
+        std::vector<uint32_t> elementBuffer;
+        elementBuffer.reserve(MaxParticles * 6);
+        for (uint32_t p = 0; p < static_cast<uint32_t>(MaxParticles); ++p)
+        {
+            uint32_t const v = p * 4;
+
+            elementBuffer.push_back(v + 0);
+            elementBuffer.push_back(v + 1);
+            elementBuffer.push_back(v + 2);
+
+            elementBuffer.push_back(v + 1);
+            elementBuffer.push_back(v + 2);
+            elementBuffer.push_back(v + 3);
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mParticleElementVBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, elementBuffer.size() * sizeof(uint32_t), elementBuffer.data(), GL_STATIC_DRAW);
+        CheckOpenGLError();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+
+    //
+    // Initialize VAO
+    //
+
+    {
+        glGenVertexArrays(1, &tmpGLuint);
+        mParticleVAO = tmpGLuint;
+
+        glBindVertexArray(*mParticleVAO);
+        CheckOpenGLError();
+
+        // Describe vertex attributes
+        glBindBuffer(GL_ARRAY_BUFFER, *mParticleVBO);
+        static_assert(sizeof(ParticleVertex) == (4 + 4 + 4 + 4) * sizeof(float));
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::EphemeralParticle1));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::EphemeralParticle1), 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)0);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::EphemeralParticle2));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::EphemeralParticle2), 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)((4) * sizeof(float)));
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::EphemeralParticle3));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::EphemeralParticle3), 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)((4 + 4) * sizeof(float)));
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::EphemeralParticle4));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::EphemeralParticle4), 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)((4 + 4 + 4) * sizeof(float)));
+        CheckOpenGLError();
+
+        // Intel drivers lose the element buffer association, hence we bind it before drawing
+        ////glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mParticleElementVBO);
+
+        glBindVertexArray(0);
+    }
+
+
+    //
+    // Set parameters
+    //
+
+    mShaderManager.ActivateProgram<ProgramType::EphemeralParticles>();
+    mShaderManager.SetTextureParameters<ProgramType::EphemeralParticles>();
+
+    OnViewModelUpdated();
+
+    SetAmbientLightIntensity(ambientLightIntensity);
+}
+
+void ParticleRenderContext::Reset()
+{
+    mPendingVertexBuffer.clear();
+    mNextParticleSlot = 0;
+    mParticleSlotsInUse = 0;
+}
+
+void ParticleRenderContext::OnViewModelUpdated()
+{
+    constexpr float ZFar = 1000.0f;
+    constexpr float ZNear = 1.0f;
+
+    ViewModel::ProjectionMatrix globalOrthoMatrix;
+    mViewModel.CalculateGlobalOrthoMatrix(ZFar, ZNear, globalOrthoMatrix);
+
+    mShaderManager.ActivateProgram<ProgramType::EphemeralParticles>();
+    mShaderManager.SetProgramParameter<ProgramType::EphemeralParticles, ProgramParameterType::OrthoMatrix>(
+        globalOrthoMatrix);
+}
+
+void ParticleRenderContext::SetAmbientLightIntensity(float ambientLightIntensity)
+{
+    mShaderManager.ActivateProgram<ProgramType::EphemeralParticles>();
+    mShaderManager.SetProgramParameter<ProgramType::EphemeralParticles, ProgramParameterType::AmbientLightIntensity>(
+        ambientLightIntensity);
+}
+
+void ParticleRenderContext::Render(float currentSimulationTime)
+{
+    UploadPendingParticles();
+
+    if (mParticleSlotsInUse == 0)
+        return;
+
+    glBindVertexArray(*mParticleVAO);
+
+    // Intel bug: cannot associate with VAO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mParticleElementVBO);
+
+    mShaderManager.ActivateProgram<ProgramType::EphemeralParticles>();
+    mShaderManager.SetProgramParameter<ProgramType::EphemeralParticles, ProgramParameterType::CurrentSimulationTime>(
+        currentSimulationTime);
+
+    // Expired and unborn particles are culled by the vertex shader
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mParticleSlotsInUse * 6), GL_UNSIGNED_INT, (GLvoid *)0);
+
+    glBindVertexArray(0);
+}
+
+void ParticleRenderContext::UploadPendingParticles()
+{
+    assert((mPendingVertexBuffer.size() % 4) == 0);
+
+    size_t particleCount = mPendingVertexBuffer.size() / 4;
+    if (particleCount == 0)
+        return;
+
+    ParticleVertex const * pendingVertices = mPendingVertexBuffer.data();
+
+    // More particles than the ring buffer can hold would overwrite each other
+    if (particleCount > MaxParticles)
+    {
+        pendingVertices += (particleCount - MaxParticles) * 4;
+        particleCount = MaxParticles;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, *mParticleVBO);
+
+    // Upload in at most two ranges, wrapping around the end of the ring buffer
+    while (particleCount > 0)
+    {
+        size_t const rangeParticleCount = std::min(particleCount, MaxParticles - mNextParticleSlot);
+
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            mNextParticleSlot * 4 * sizeof(ParticleVertex),
+            rangeParticleCount * 4 * sizeof(ParticleVertex),
+            pendingVertices);
+        CheckOpenGLError();
+
+        pendingVertices += rangeParticleCount * 4;
+        particleCount -= rangeParticleCount;
+
+        mNextParticleSlot = (mNextParticleSlot + rangeParticleCount) % MaxParticles;
+        mParticleSlotsInUse = std::max(mParticleSlotsInUse, mNextParticleSlot == 0 ? MaxParticles : mNextParticleSlot);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    mPendingVertexBuffer.clear();
+}
+
+}
@@ -0,0 +1,204 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-03-02
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "GameParameters.h"
+#include "RenderCore.h"
+#include "TextureAtlas.h"
+#include "ViewModel.h"
+
+#include <GameOpenGL/GameOpenGL.h>
+#include <GameOpenGL/ShaderManager.h>
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/Vectors.h>
+
+#include <cassert>
+#include <vector>
+
+namespace Render {
+
+/*
+ * Renders the ephemeral particles that are simulated entirely on the GPU.
+ *
+ * Each particle follows a ballistic trajectory and lives for a lifetime that is
+ * known at its birth, hence the client only uploads a spawn record for each
+ * particle, and the vertex shader calculates its state at each frame out of the
+ * current simulation time. Particles live in a ring buffer, so that new particles
+ * overwrite the oldest ones once the buffer is full.
+ */
+class ParticleRenderContext
+{
+public:
+
+    // The number of particles that fit in the ring buffer
+    static constexpr size_t MaxParticles = GameParameters::MaxGPUEphemeralParticles;
+
+    ParticleRenderContext(
+        ShaderManager<ShaderManagerTraits> & shaderManager,
+        TextureAtlasMetadata const & genericTextureAtlasMetadata,
+        ViewModel const & viewModel,
+        float ambientLightIntensity);
+
+    void Reset();
+
+    void OnViewModelUpdated();
+
+    void SetAmbientLightIntensity(float ambientLightIntensity);
+
+    inline void UploadDebris(
+        vec2f const & position,
+        vec2f const & velocity,
+        vec4f const & color,
+        float startTime,
+        float maxLifetime)
+    {
+        static constexpr float HalfSize = DebrisSize / 2.0f;
+
+        // No texture
+        vec2f const noTextureCoordinates(-1.0f, -1.0f);
+
+        UploadParticle(
+            position,
+            velocity,
+            vec2f(-HalfSize, -HalfSize), vec2f(HalfSize, HalfSize),
+            noTextureCoordinates, noTextureCoordinates,
+            color,
+            startTime,
+            maxLifetime,
+            0.0f, // Spin
+            1.0f); // Ambient light sensitivity
+    }
+
+    inline void UploadSparkle(
+        vec2f const & position,
+        vec2f const & velocity,
+        TextureFrameId const & textureFrameId,
+        float startTime,
+        float maxLifetime)
+    {
+        TextureAtlasFrameMetadata const & frame = mGenericTextureAtlasMetadata.GetFrameMetadata(textureFrameId);
+
+        UploadParticle(
+            position,
+            velocity,
+            vec2f(-frame.FrameMetadata.AnchorWorldX, -frame.FrameMetadata.AnchorWorldY),
+            vec2f(frame.FrameMetadata.WorldWidth - frame.FrameMetadata.AnchorWorldX, frame.FrameMetadata.WorldHeight - frame.FrameMetadata.AnchorWorldY),
+            frame.TextureCoordinatesBottomLeft,
+            frame.TextureCoordinatesTopRight,
+            vec4f(1.0f, 1.0f, 1.0f, 1.0f),
+            startTime,
+            maxLifetime,
+            4.0f, // Spin, as the CPU sparkles
+            frame.FrameMetadata.HasOwnAmbientLight ? 0.0f : 1.0f);
+    }
+
+    void Render(float currentSimulationTime);
+
+private:
+
+    // The side of the debris quads, matching the size of the points of the ships
+    static constexpr float DebrisSize = 0.3f;
+
+    // Each particle is a quad of four vertices
+    struct ParticleVertex
+    {
+        vec2f startPosition;
+        vec2f startVelocity;
+        vec2f vertexOffset;
+        vec2f textureCoordinates;
+        vec4f color;
+        float startTime;
+        float maxLifetime;
+        float spin;
+        float ambientLightSensitivity;
+
+        ParticleVertex(
+            vec2f const & _startPosition,
+            vec2f const & _startVelocity,
+            vec2f const & _vertexOffset,
+            vec2f const & _textureCoordinates,
+            vec4f const & _color,
+            float _startTime,
+            float _maxLifetime,
+            float _spin,
+            float _ambientLightSensitivity)
+            : startPosition(_startPosition)
+            , startVelocity(_startVelocity)
+            , vertexOffset(_vertexOffset)
+            , textureCoordinates(_textureCoordinates)
+            , color(_color)
+            , startTime(_startTime)
+            , maxLifetime(_maxLifetime)
+            , spin(_spin)
+            , ambientLightSensitivity(_ambientLightSensitivity)
+        {}
+    };
+
+    inline void UploadParticle(
+        vec2f const & position,
+        vec2f const & velocity,
+        vec2f const & bottomLeftOffset,
+        vec2f const & topRightOffset,
+        vec2f const & bottomLeftTextureCoordinates,
+        vec2f const & topRightTextureCoordinates,
+        vec4f const & color,
+        float startTime,
+        float maxLifetime,
+        float spin,
+        float ambientLightSensitivity)
+    {
+        // Bottom-left
+        mPendingVertexBuffer.emplace_back(
+            position, velocity,
+            bottomLeftOffset,
+            bottomLeftTextureCoordinates,
+            color, startTime, maxLifetime, spin, ambientLightSensitivity);
+
+        // Top-left
+        mPendingVertexBuffer.emplace_back(
+            position, velocity,
+            vec2f(bottomLeftOffset.x, topRightOffset.y),
+            vec2f(bottomLeftTextureCoordinates.x, topRightTextureCoordinates.y),
+            color, startTime, maxLifetime, spin, ambientLightSensitivity);
+
+        // Bottom-right
+        mPendingVertexBuffer.emplace_back(
+            position, velocity,
+            vec2f(topRightOffset.x, bottomLeftOffset.y),
+            vec2f(topRightTextureCoordinates.x, bottomLeftTextureCoordinates.y),
+            color, startTime, maxLifetime, spin, ambientLightSensitivity);
+
+        // Top-right
+        mPendingVertexBuffer.emplace_back(
+            position, velocity,
+            topRightOffset,
+            topRightTextureCoordinates,
+            color, startTime, maxLifetime, spin, ambientLightSensitivity);
+    }
+
+    void UploadPendingParticles();
+
+private:
+
+    ShaderManager<ShaderManagerTraits> & mShaderManager;
+    TextureAtlasMetadata const & mGenericTextureAtlasMetadata;
+    ViewModel const & mViewModel;
+
+    // The vertices of the particles spawned since the last render
+    std::vector<ParticleVertex> mPendingVertexBuffer;
+
+    GameOpenGLVBO mParticleVBO;
+    GameOpenGLVBO mParticleElementVBO;
+    GameOpenGLVAO mParticleVAO;
+
+    // The ring buffer slot of the next particle, and the number of
+    // slots that have ever been written to
+    size_t mNextParticleSlot;
+    size_t mParticleSlotsInUse;
+};
+
+}
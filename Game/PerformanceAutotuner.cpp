@@ -0,0 +1,356 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-08
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "PerformanceAutotuner.h"
+
+#include "IGameEventHandler.h"
+#include "Physics.h"
+#include "ShipDefinition.h"
+#include "SimulationView.h"
+#include "ViewModel.h"
+
+#include <GameCore/GameRandomEngine.h>
+#include <GameCore/GameWallClock.h>
+#include <GameCore/Log.h>
+#include <GameCore/TaskThreadPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace /* anonymous */ {
+
+    static constexpr unsigned int RandomSeed = 42;
+
+    // Let the ship settle in the water before measuring
+    static constexpr size_t WarmupStepCount = 50;
+    static constexpr size_t MeasuredStepCount = 200;
+
+    // As in the SimulationRunner, so that the iterations don't depend on the machine
+    static constexpr float NominalUpdateDurationMillis = 10.0f;
+
+    // How many more springs than the reference run a stable run may break
+    static constexpr size_t MinBrokenSpringTolerance = 8;
+
+    // The fractions of the starting mechanical iterations we may go down to
+    static constexpr float IterationsAdjustmentFractions[] = { 0.75f, 0.5f };
+
+    class AutotuneEventHandler final : public IGameEventHandler
+    {
+    public:
+
+        size_t BrokenSpringCount = 0;
+        bool HasSunk = false;
+
+        void OnBreak(
+            StructuralMaterial const & /*structuralMaterial*/,
+            bool /*isUnderwater*/,
+            unsigned int size) override
+        {
+            BrokenSpringCount += size;
+        }
+
+        void OnSinkingBegin(ShipId /*shipId*/) override
+        {
+            HasSunk = true;
+        }
+    };
+}
+
+void AutotuneConfiguration::ApplyTo(GameParameters & gameParameters) const
+{
+    gameParameters.DoFusePointDynamics = DoFusePointDynamics;
+    gameParameters.DoSolveSpringsAsConstraints = DoSolveSpringsAsConstraints;
+    gameParameters.DoUseGPUMechanicalDynamics = DoUseGPUMechanicalDynamics;
+    gameParameters.NumMechanicalDynamicsIterationsAdjustment = NumMechanicalDynamicsIterationsAdjustment;
+}
+
+std::string AutotuneConfiguration::ToString() const
+{
+    std::stringstream ss;
+
+    ss << (DoUseGPUMechanicalDynamics ? "GPU" : "CPU")
+        << (DoFusePointDynamics ? ", fused points" : ", legacy points")
+        << (DoSolveSpringsAsConstraints ? ", spring constraints" : ", spring forces")
+        << ", " << SimulationThreadCount << " thread(s)"
+        << ", iterations x" << NumMechanicalDynamicsIterationsAdjustment;
+
+    return ss.str();
+}
+
+AutotuneResult PerformanceAutotuner::Run(
+    std::filesystem::path const & shipDefinitionFilepath,
+    std::optional<std::filesystem::path> const & targetShipDefinitionFilepath,
+    GameParameters const & gameParameters,
+    bool isGPUAvailable,
+    MaterialDatabase const & materialDatabase,
+    ResourceLoader & resourceLoader,
+    ProgressCallback const & progressCallback)
+{
+    size_t const originalParallelism = TaskThreadPool::GetInstance().GetParallelism();
+    size_t const coreCount = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1));
+    float const startIterationsAdjustment = gameParameters.NumMechanicalDynamicsIterationsAdjustment;
+
+    std::vector<AutotuneMeasurement> allMeasurements;
+    std::optional<size_t> referenceBrokenSpringCount;
+
+    auto const measure = [&](AutotuneConfiguration const & configuration)
+    {
+        TaskThreadPool::GetInstance().SetParallelism(configuration.SimulationThreadCount);
+
+        auto const shipRun = RunShip(
+            shipDefinitionFilepath,
+            configuration,
+            gameParameters,
+            materialDatabase,
+            resourceLoader);
+
+        // The first run - the legacy kernels - is the reference for stability
+        if (!referenceBrokenSpringCount)
+            referenceBrokenSpringCount = shipRun.BrokenSpringCount;
+
+        bool const isStable =
+            !shipRun.HasSunk
+            && shipRun.BrokenSpringCount <= *referenceBrokenSpringCount + std::max(*referenceBrokenSpringCount / 10, MinBrokenSpringTolerance);
+
+        LogMessage("PerformanceAutotuner: ", configuration.ToString(), ": ", shipRun.StepsPerSecond, " steps/s",
+            isStable ? "" : " (unstable)");
+
+        allMeasurements.emplace_back(configuration, shipRun.StepsPerSecond, isStable);
+
+        return allMeasurements.back();
+    };
+
+    auto const pick = [](std::vector<AutotuneMeasurement> const & measurements) -> AutotuneMeasurement const &
+    {
+        // The first measurement of each round is the cheapest fallback
+        auto const best = PickFastestStable(measurements, MinRelativeGain);
+        return measurements[best.value_or(0)];
+    };
+
+    try
+    {
+        //
+        // 1. Kernels
+        //
+
+        std::vector<AutotuneMeasurement> kernelMeasurements;
+
+        for (bool const doSolveSpringsAsConstraints : { false, true })
+        {
+            for (bool const doFusePointDynamics : { false, true })
+            {
+                if (progressCallback)
+                    progressCallback(static_cast<float>(kernelMeasurements.size() + 1) / 12.0f, "Measuring kernels...");
+
+                kernelMeasurements.push_back(
+                    measure(AutotuneConfiguration(coreCount, doFusePointDynamics, doSolveSpringsAsConstraints, false, startIterationsAdjustment)));
+            }
+        }
+
+        if (isGPUAvailable)
+        {
+            // The GPU only runs spring forces
+            for (bool const doFusePointDynamics : { false, true })
+            {
+                if (progressCallback)
+                    progressCallback(static_cast<float>(kernelMeasurements.size() + 1) / 12.0f, "Measuring kernels...");
+
+                kernelMeasurements.push_back(
+                    measure(AutotuneConfiguration(coreCount, doFusePointDynamics, false, true, startIterationsAdjustment)));
+            }
+        }
+
+        AutotuneMeasurement best = pick(kernelMeasurements);
+
+        //
+        // 2. Threads
+        //
+
+        std::vector<AutotuneMeasurement> threadMeasurements;
+
+        for (size_t threadCount = 1; ; threadCount = std::min(threadCount * 2, coreCount))
+        {
+            if (progressCallback)
+                progressCallback(0.5f + static_cast<float>(threadMeasurements.size() + 1) / 16.0f, "Measuring threads...");
+
+            AutotuneConfiguration configuration = best.Configuration;
+            configuration.SimulationThreadCount = threadCount;
+
+            if (threadCount == coreCount)
+            {
+                // Measured already
+                threadMeasurements.push_back(best);
+                break;
+            }
+
+            threadMeasurements.push_back(measure(configuration));
+        }
+
+        best = pick(threadMeasurements);
+
+        //
+        // 3. Iterations
+        //
+
+        float const realTimeStepsPerSecond = GetRealTimeStepsPerSecond();
+
+        if (best.StepsPerSecond < realTimeStepsPerSecond)
+        {
+            for (float const fraction : IterationsAdjustmentFractions)
+            {
+                if (progressCallback)
+                    progressCallback(0.875f, "Measuring iterations...");
+
+                AutotuneConfiguration configuration = best.Configuration;
+                configuration.NumMechanicalDynamicsIterationsAdjustment = std::max(
+                    startIterationsAdjustment * fraction,
+                    GameParameters::MinNumMechanicalDynamicsIterationsAdjustment);
+
+                auto const measurement = measure(configuration);
+                if (!measurement.IsStable)
+                    break;
+
+                // Go on with the fastest we've got, even if it's still not real time
+                best = measurement;
+
+                if (measurement.StepsPerSecond >= realTimeStepsPerSecond)
+                    break;
+            }
+        }
+
+        AutotuneResult result(
+            best.Configuration,
+            best.StepsPerSecond,
+            best.StepsPerSecond >= realTimeStepsPerSecond);
+
+        result.Measurements = std::move(allMeasurements);
+
+        //
+        // Target ship
+        //
+
+        if (targetShipDefinitionFilepath)
+        {
+            if (progressCallback)
+                progressCallback(1.0f, "Measuring target ship...");
+
+            TaskThreadPool::GetInstance().SetParallelism(best.Configuration.SimulationThreadCount);
+
+            auto const shipRun = RunShip(
+                *targetShipDefinitionFilepath,
+                best.Configuration,
+                gameParameters,
+                materialDatabase,
+                resourceLoader);
+
+            result.TargetShip = AutotuneResult::TargetShipResult{
+                shipRun.ShipName,
+                shipRun.StepsPerSecond,
+                shipRun.StepsPerSecond >= realTimeStepsPerSecond };
+        }
+
+        TaskThreadPool::GetInstance().SetParallelism(originalParallelism);
+
+        return result;
+    }
+    catch (...)
+    {
+        TaskThreadPool::GetInstance().SetParallelism(originalParallelism);
+
+        throw;
+    }
+}
+
+std::optional<size_t> PerformanceAutotuner::PickFastestStable(
+    std::vector<AutotuneMeasurement> const & measurements,
+    float minRelativeGain)
+{
+    std::optional<size_t> best;
+
+    for (size_t m = 0; m < measurements.size(); ++m)
+    {
+        if (!measurements[m].IsStable)
+            continue;
+
+        if (!best
+            || measurements[m].StepsPerSecond > measurements[*best].StepsPerSecond * (1.0f + minRelativeGain))
+        {
+            best = m;
+        }
+    }
+
+    return best;
+}
+
+PerformanceAutotuner::ShipRun PerformanceAutotuner::RunShip(
+    std::filesystem::path const & shipDefinitionFilepath,
+    AutotuneConfiguration const & configuration,
+    GameParameters const & gameParameters,
+    MaterialDatabase const & materialDatabase,
+    ResourceLoader & resourceLoader)
+{
+    GameParameters runGameParameters = gameParameters;
+    configuration.ApplyTo(runGameParameters);
+
+    // Measure exactly the iterations we've been asked for
+    runGameParameters.DoAdaptMechanicalDynamicsIterations = false;
+
+    auto const stepDuration = std::chrono::duration_cast<GameWallClock::duration>(
+        std::chrono::duration<float>(GameParameters::SimulationStepTimeDuration<float>));
+
+    // The view the simulation is run with: the initial view of the game, at 1024x768
+    Render::ViewModel const viewModel(1.0f, vec2f::zero(), 1024, 768);
+    SimulationView const simulationView(
+        viewModel.GetVisibleWorldTopLeft().x,
+        viewModel.GetVisibleWorldBottomRight().x,
+        viewModel.GetVisibleWorldTopLeft().y,
+        viewModel.GetVisibleWorldBottomRight().y,
+        false);
+
+    // Every run starts from the same state
+    GameRandomEngine::GetInstance().Reseed(RandomSeed);
+
+    auto eventHandler = std::make_shared<AutotuneEventHandler>();
+
+    Physics::World world(
+        eventHandler,
+        runGameParameters,
+        resourceLoader);
+
+    auto shipDefinition = ShipDefinition::Load(shipDefinitionFilepath);
+
+    world.AddShip(
+        shipDefinition,
+        materialDatabase,
+        runGameParameters);
+
+    std::chrono::steady_clock::duration measuredDuration = std::chrono::steady_clock::duration::zero();
+
+    for (size_t step = 0; step < WarmupStepCount + MeasuredStepCount; ++step)
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+
+        world.Update(
+            runGameParameters,
+            NominalUpdateDurationMillis,
+            simulationView);
+
+        if (step >= WarmupStepCount)
+            measuredDuration += std::chrono::steady_clock::now() - startTime;
+
+        GameWallClock::GetInstance().Advance(stepDuration);
+    }
+
+    float const measuredSeconds = std::chrono::duration<float>(measuredDuration).count();
+
+    return ShipRun{
+        shipDefinition.Metadata.ShipName,
+        measuredSeconds > 0.0f ? static_cast<float>(MeasuredStepCount) / measuredSeconds : 0.0f,
+        eventHandler->BrokenSpringCount,
+        eventHandler->HasSunk };
+}
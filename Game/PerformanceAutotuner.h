@@ -0,0 +1,168 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-08
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "GameParameters.h"
+#include "MaterialDatabase.h"
+#include "ResourceLoader.h"
+
+#include <GameCore/ProgressCallback.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+/*
+ * The settings that the autotuner chooses among.
+ */
+struct AutotuneConfiguration
+{
+    // Zero for one per core
+    size_t SimulationThreadCount;
+
+    bool DoFusePointDynamics;
+    bool DoSolveSpringsAsConstraints;
+    bool DoUseGPUMechanicalDynamics;
+    float NumMechanicalDynamicsIterationsAdjustment;
+
+    AutotuneConfiguration(
+        size_t simulationThreadCount,
+        bool doFusePointDynamics,
+        bool doSolveSpringsAsConstraints,
+        bool doUseGPUMechanicalDynamics,
+        float numMechanicalDynamicsIterationsAdjustment)
+        : SimulationThreadCount(simulationThreadCount)
+        , DoFusePointDynamics(doFusePointDynamics)
+        , DoSolveSpringsAsConstraints(doSolveSpringsAsConstraints)
+        , DoUseGPUMechanicalDynamics(doUseGPUMechanicalDynamics)
+        , NumMechanicalDynamicsIterationsAdjustment(numMechanicalDynamicsIterationsAdjustment)
+    {}
+
+    void ApplyTo(GameParameters & gameParameters) const;
+
+    std::string ToString() const;
+};
+
+/*
+ * How a configuration fared on a ship.
+ */
+struct AutotuneMeasurement
+{
+    AutotuneConfiguration Configuration;
+    float StepsPerSecond;
+
+    // Whether the ship, left alone, neither broke more than the reference run did nor sank
+    bool IsStable;
+
+    AutotuneMeasurement(
+        AutotuneConfiguration const & configuration,
+        float stepsPerSecond,
+        bool isStable)
+        : Configuration(configuration)
+        , StepsPerSecond(stepsPerSecond)
+        , IsStable(isStable)
+    {}
+};
+
+struct AutotuneResult
+{
+    AutotuneConfiguration Configuration;
+    float StepsPerSecond;
+    bool IsRealTime;
+
+    // All the measurements taken, in the order they were taken
+    std::vector<AutotuneMeasurement> Measurements;
+
+    // How the chosen configuration fares on the target ship, if one was specified
+    struct TargetShipResult
+    {
+        std::string ShipName;
+        float StepsPerSecond;
+        bool IsRealTime;
+    };
+
+    std::optional<TargetShipResult> TargetShip;
+
+    AutotuneResult(
+        AutotuneConfiguration const & configuration,
+        float stepsPerSecond,
+        bool isRealTime)
+        : Configuration(configuration)
+        , StepsPerSecond(stepsPerSecond)
+        , IsRealTime(isRealTime)
+        , Measurements()
+        , TargetShip()
+    {}
+};
+
+/*
+ * Finds the fastest stable settings for this machine by running a ship - without
+ * rendering, as the SimulationRunner does - under each candidate configuration, in
+ * three rounds:
+ *  1. Kernels: legacy vs fused point dynamics, spring forces vs spring constraints, and -
+ *     when available - CPU vs GPU mechanical dynamics, on all cores;
+ *  2. Threads: the best kernels on 1, 2, 4, ... cores;
+ *  3. Iterations: when the best so far doesn't run in real time, fewer mechanical
+ *     iterations, down to half of the starting ones; bodies get softer, hence only as
+ *     few as needed.
+ *
+ * Each ship runs in its own world, with the game wall clock advancing by exactly one
+ * simulation step per step; the caller is responsible for the clock being manual, and
+ * for nothing else using the task thread pool meanwhile, whose parallelism is changed
+ * while measuring and restored at the end.
+ */
+class PerformanceAutotuner
+{
+public:
+
+    // The simulation must be at least this much faster than real time, leaving time to the rest of the frame
+    static constexpr float RealTimeHeadroom = 1.25f;
+
+    // More threads - or a different kernel - must be at least this much faster to be preferred
+    static constexpr float MinRelativeGain = 0.05f;
+
+    static float GetRealTimeStepsPerSecond()
+    {
+        return RealTimeHeadroom / GameParameters::SimulationStepTimeDuration<float>;
+    }
+
+    static AutotuneResult Run(
+        std::filesystem::path const & shipDefinitionFilepath,
+        std::optional<std::filesystem::path> const & targetShipDefinitionFilepath,
+        GameParameters const & gameParameters,
+        bool isGPUAvailable,
+        MaterialDatabase const & materialDatabase,
+        ResourceLoader & resourceLoader,
+        ProgressCallback const & progressCallback);
+
+    /*
+     * Returns the index of the fastest stable measurement, preferring earlier ones - which
+     * are assumed to be cheaper - unless a later one is faster by at least the specified
+     * relative gain.
+     */
+    static std::optional<size_t> PickFastestStable(
+        std::vector<AutotuneMeasurement> const & measurements,
+        float minRelativeGain);
+
+private:
+
+    struct ShipRun
+    {
+        std::string ShipName;
+        float StepsPerSecond;
+        size_t BrokenSpringCount;
+        bool HasSunk;
+    };
+
+    static ShipRun RunShip(
+        std::filesystem::path const & shipDefinitionFilepath,
+        AutotuneConfiguration const & configuration,
+        GameParameters const & gameParameters,
+        MaterialDatabase const & materialDatabase,
+        ResourceLoader & resourceLoader);
+};
@@ -0,0 +1,266 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-20
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "PointCollisions.h"
+
+#include <GameCore/Log.h>
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define POINT_COLLISIONS_X86_64
+#endif
+
+#ifdef POINT_COLLISIONS_X86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+namespace Physics {
+
+namespace /* anonymous */ {
+
+//
+// Scalar
+//
+
+inline void TrimPointForWorldBoundsScalar(
+    vec2f & position,
+    vec2f & velocity,
+    WorldBounds const & bounds)
+{
+    // Selects rather than branches
+
+    float const x = position.x;
+    float const y = position.y;
+
+    velocity.x =
+        (x < bounds.Left) ? std::min(-velocity.x, bounds.MaxBounceVelocity)
+        : (x > bounds.Right) ? std::max(-velocity.x, -bounds.MaxBounceVelocity)
+        : velocity.x;
+
+    velocity.y =
+        (y < bounds.Bottom) ? std::min(-velocity.y, bounds.MaxBounceVelocity)
+        : (y > bounds.Top) ? std::max(-velocity.y, -bounds.MaxBounceVelocity)
+        : velocity.y;
+
+    position.x = std::min(std::max(x, bounds.Left), bounds.Right);
+    position.y = std::min(std::max(y, bounds.Bottom), bounds.Top);
+}
+
+void TrimPointsForWorldBoundsScalar(
+    vec2f * restrict positions,
+    vec2f * restrict velocities,
+    size_t startPoint,
+    size_t endPoint,
+    WorldBounds const & bounds)
+{
+    for (size_t p = startPoint; p < endPoint; ++p)
+    {
+        TrimPointForWorldBoundsScalar(positions[p], velocities[p], bounds);
+    }
+}
+
+size_t FindPointsBelowSeaFloorScalar(
+    vec2f const * restrict positions,
+    float const * restrict oceanFloorHeights,
+    ElementIndex const * restrict pointIndices,
+    size_t startOrdinal,
+    size_t endOrdinal,
+    size_t * restrict belowPointOrdinals)
+{
+    size_t belowPointCount = 0;
+
+    for (size_t i = startOrdinal; i < endOrdinal; ++i)
+    {
+        ElementIndex const pointIndex = pointIndices[i];
+
+        // Branch-free append
+        belowPointOrdinals[belowPointCount] = i;
+        belowPointCount += (positions[pointIndex].y < oceanFloorHeights[pointIndex]) ? 1 : 0;
+    }
+
+    return belowPointCount;
+}
+
+#ifdef POINT_COLLISIONS_X86_64
+
+//
+// SSE2
+//
+
+void TrimPointsForWorldBoundsSSE2(
+    vec2f * restrict positions,
+    vec2f * restrict velocities,
+    size_t pointCount,
+    WorldBounds const & bounds)
+{
+    // Two points per register, as x0,y0,x1,y1
+    __m128 const low = _mm_setr_ps(bounds.Left, bounds.Bottom, bounds.Left, bounds.Bottom);
+    __m128 const high = _mm_setr_ps(bounds.Right, bounds.Top, bounds.Right, bounds.Top);
+    __m128 const maxBounceVelocity = _mm_set1_ps(bounds.MaxBounceVelocity);
+    __m128 const minBounceVelocity = _mm_set1_ps(-bounds.MaxBounceVelocity);
+    __m128 const signMask = _mm_set1_ps(-0.0f);
+
+    float * restrict const positionData = reinterpret_cast<float *>(positions);
+    float * restrict const velocityData = reinterpret_cast<float *>(velocities);
+
+    size_t const vectorizedPointCount = pointCount - (pointCount % 2);
+
+    for (size_t p = 0; p < vectorizedPointCount; p += 2)
+    {
+        __m128 const position = _mm_loadu_ps(positionData + p * 2);
+        __m128 const velocity = _mm_loadu_ps(velocityData + p * 2);
+
+        __m128 const isBelowLow = _mm_cmplt_ps(position, low);
+        __m128 const isAboveHigh = _mm_cmpgt_ps(position, high);
+
+        __m128 const negatedVelocity = _mm_xor_ps(velocity, signMask);
+
+        // Same precedence as the scalar kernel: below low, else above high, else unchanged;
+        // note that _mm_min_ps(a, b) is (a < b ? a : b) while std::min(b, a) is (a < b ? a : b),
+        // hence the swapped operands give the same results as std::min and std::max - NaNs
+        // included
+        __m128 newVelocity = _mm_or_ps(
+            _mm_and_ps(isAboveHigh, _mm_max_ps(minBounceVelocity, negatedVelocity)),
+            _mm_andnot_ps(isAboveHigh, velocity));
+        newVelocity = _mm_or_ps(
+            _mm_and_ps(isBelowLow, _mm_min_ps(maxBounceVelocity, negatedVelocity)),
+            _mm_andnot_ps(isBelowLow, newVelocity));
+
+        __m128 const newPosition = _mm_min_ps(high, _mm_max_ps(low, position));
+
+        _mm_storeu_ps(positionData + p * 2, newPosition);
+        _mm_storeu_ps(velocityData + p * 2, newVelocity);
+    }
+
+    TrimPointsForWorldBoundsScalar(positions, velocities, vectorizedPointCount, pointCount, bounds);
+}
+
+size_t FindPointsBelowSeaFloorSSE2(
+    vec2f const * restrict positions,
+    float const * restrict oceanFloorHeights,
+    ElementIndex const * restrict pointIndices,
+    size_t pointCount,
+    size_t * restrict belowPointOrdinals)
+{
+    size_t belowPointCount = 0;
+
+    size_t const vectorizedPointCount = pointCount - (pointCount % 4);
+
+    for (size_t i = 0; i < vectorizedPointCount; i += 4)
+    {
+        ElementIndex const p0 = pointIndices[i];
+        ElementIndex const p1 = pointIndices[i + 1];
+        ElementIndex const p2 = pointIndices[i + 2];
+        ElementIndex const p3 = pointIndices[i + 3];
+
+        // Gather
+        __m128 const y = _mm_setr_ps(positions[p0].y, positions[p1].y, positions[p2].y, positions[p3].y);
+        __m128 const floorHeight = _mm_setr_ps(oceanFloorHeights[p0], oceanFloorHeights[p1], oceanFloorHeights[p2], oceanFloorHeights[p3]);
+
+        int belowMask = _mm_movemask_ps(_mm_cmplt_ps(y, floorHeight));
+
+        // Points below the floor are few, hence most groups end here
+        while (belowMask != 0)
+        {
+            int lane = 0;
+            while ((belowMask & (1 << lane)) == 0)
+                ++lane;
+
+            belowPointOrdinals[belowPointCount++] = i + static_cast<size_t>(lane);
+
+            belowMask &= ~(1 << lane);
+        }
+    }
+
+    belowPointCount += FindPointsBelowSeaFloorScalar(
+        positions,
+        oceanFloorHeights,
+        pointIndices,
+        vectorizedPointCount,
+        pointCount,
+        belowPointOrdinals + belowPointCount);
+
+    return belowPointCount;
+}
+
+#endif
+
+}
+
+PointCollisionsImplementation GetBestPointCollisionsImplementation()
+{
+    static PointCollisionsImplementation const BestImplementation = []()
+    {
+#ifdef POINT_COLLISIONS_X86_64
+        // SSE2 is part of x86-64
+        auto const implementation = PointCollisionsImplementation::SSE2;
+#else
+        auto const implementation = PointCollisionsImplementation::Scalar;
+#endif
+
+        LogMessage("PointCollisions: using implementation ", static_cast<int>(implementation));
+
+        return implementation;
+    }();
+
+    return BestImplementation;
+}
+
+void TrimPointsForWorldBounds(
+    PointCollisionsImplementation implementation,
+    vec2f * restrict positions,
+    vec2f * restrict velocities,
+    size_t pointCount,
+    WorldBounds const & bounds)
+{
+    switch (implementation)
+    {
+#ifdef POINT_COLLISIONS_X86_64
+        case PointCollisionsImplementation::SSE2:
+        {
+            TrimPointsForWorldBoundsSSE2(positions, velocities, pointCount, bounds);
+            return;
+        }
+#endif
+
+        default:
+        {
+            TrimPointsForWorldBoundsScalar(positions, velocities, 0, pointCount, bounds);
+            return;
+        }
+    }
+}
+
+size_t FindPointsBelowSeaFloor(
+    PointCollisionsImplementation implementation,
+    vec2f const * restrict positions,
+    float const * restrict oceanFloorHeights,
+    ElementIndex const * restrict pointIndices,
+    size_t pointCount,
+    size_t * restrict belowPointOrdinals)
+{
+    switch (implementation)
+    {
+#ifdef POINT_COLLISIONS_X86_64
+        case PointCollisionsImplementation::SSE2:
+        {
+            return FindPointsBelowSeaFloorSSE2(positions, oceanFloorHeights, pointIndices, pointCount, belowPointOrdinals);
+        }
+#endif
+
+        default:
+        {
+            return FindPointsBelowSeaFloorScalar(positions, oceanFloorHeights, pointIndices, 0, pointCount, belowPointOrdinals);
+        }
+    }
+}
+
+}
@@ -0,0 +1,73 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-20
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/Vectors.h>
+
+#include <cstddef>
+
+namespace Physics
+{
+
+/*
+ * The kernels that keep points within the world: trimming them to the world's bounds,
+ * and finding those that went below the sea floor.
+ *
+ * All kernels produce exactly the same results as the scalar kernel.
+ */
+
+enum class PointCollisionsImplementation
+{
+    Scalar,
+    SSE2    // 2 points at a time when trimming, 4 when finding
+};
+
+/*
+ * The world's bounds, and the velocity at which points bounce back from them.
+ */
+struct WorldBounds
+{
+    float Left;
+    float Right;
+    float Bottom;
+    float Top;
+
+    float MaxBounceVelocity;
+};
+
+/*
+ * Gets the fastest implementation supported by the CPU we're running on.
+ */
+PointCollisionsImplementation GetBestPointCollisionsImplementation();
+
+/*
+ * Moves the points that are out of bounds back onto the bounds, bouncing their velocity
+ * back, bounded.
+ */
+void TrimPointsForWorldBounds(
+    PointCollisionsImplementation implementation,
+    vec2f * restrict positions,
+    vec2f * restrict velocities,
+    size_t pointCount,
+    WorldBounds const & bounds);
+
+/*
+ * Finds the points in the specified list of point indices that are below the sea floor,
+ * storing their ordinals in the list - in list order - and returning their number.
+ *
+ * Ocean floor heights are indexed by point index.
+ */
+size_t FindPointsBelowSeaFloor(
+    PointCollisionsImplementation implementation,
+    vec2f const * restrict positions,
+    float const * restrict oceanFloorHeights,
+    ElementIndex const * restrict pointIndices,
+    size_t pointCount,
+    size_t * restrict belowPointOrdinals);
+
+}
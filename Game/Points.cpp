@@ -5,12 +5,25 @@
 ***************************************************************************************/
 #include "Physics.h"
 
+#include <GameCore/BinaryFileTools.h>
 #include <GameCore/GameRandomEngine.h>
 #include <GameCore/Log.h>
 
 #include <cmath>
 #include <limits>
 
+#if defined(_M_X64) || defined(__x86_64__)
+#define POINTS_X86_64
+#endif
+
+#ifdef POINTS_X86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
 namespace Physics {
 
 void Points::Add(
@@ -29,6 +42,7 @@ void Points::Add(
     mIsRopeBuffer.emplace_back(isRope);
 
     mPositionBuffer.emplace_back(position);
+    mPreviousPositionBuffer.emplace_back(position);
     mVelocityBuffer.emplace_back(vec2f::zero());
     mForceBuffer.emplace_back(vec2f::zero());
     mMassBuffer.emplace_back(structuralMaterial.Mass);
@@ -47,10 +61,11 @@ void Points::Add(
     mWaterDiffusionSpeedBuffer.emplace_back(structuralMaterial.WaterDiffusionSpeed);
 
     mWaterBuffer.emplace_back(0.0f);
+    mNewWaterBuffer.emplace_back(0.0f);
     mWaterVelocityBuffer.emplace_back(vec2f::zero());
     mWaterMomentumBuffer.emplace_back(vec2f::zero());
     mCumulatedIntakenWater.emplace_back(0.0f);
-    mIsLeakingBuffer.emplace_back(isLeaking);
+    mIsLeakingBuffer.emplace_back(false);
     if (isLeaking)
         SetLeaking(pointIndex);
     mFactoryIsLeakingBuffer.emplace_back(isLeaking);
@@ -77,6 +92,10 @@ void Points::Add(
     mConnectedTrianglesBuffer.emplace_back();
     mFactoryConnectedTrianglesBuffer.emplace_back();
 
+    // Orphaned until its springs get connected
+    mOrphanedPointSlotBuffer.emplace_back(NoneElementIndex);
+    AddOrphanedPoint(pointIndex);
+
     mConnectedComponentIdBuffer.emplace_back(NoneConnectedComponentId);
     mPlaneIdBuffer.emplace_back(NonePlaneId);
     mPlaneIdFloatBuffer.emplace_back(0.0f);
@@ -88,6 +107,37 @@ void Points::Add(
     mTextureCoordinatesBuffer.emplace_back(textureCoordinates);
 }
 
+void Points::RebuildAdjacency()
+{
+    mAdjacency.Offsets.clear();
+    mAdjacency.OwnedEnds.clear();
+    mAdjacency.OtherEndpointIndices.clear();
+    mAdjacency.SpringIndices.clear();
+
+    mAdjacency.Offsets.reserve(mShipPointCount + 1);
+    mAdjacency.OwnedEnds.reserve(mShipPointCount);
+
+    for (ElementIndex pointIndex = 0; pointIndex < mShipPointCount; ++pointIndex)
+    {
+        auto const & connectedSprings = mConnectedSpringsBuffer[pointIndex];
+
+        ElementIndex const offset = static_cast<ElementIndex>(mAdjacency.SpringIndices.size());
+
+        mAdjacency.Offsets.push_back(offset);
+        mAdjacency.OwnedEnds.push_back(offset + static_cast<ElementIndex>(connectedSprings.OwnedConnectedSpringsCount));
+
+        for (auto const & cs : connectedSprings.ConnectedSprings)
+        {
+            mAdjacency.OtherEndpointIndices.push_back(cs.OtherEndpointIndex);
+            mAdjacency.SpringIndices.push_back(cs.SpringIndex);
+        }
+    }
+
+    mAdjacency.Offsets.push_back(static_cast<ElementIndex>(mAdjacency.SpringIndices.size()));
+
+    mIsAdjacencyDirty = false;
+}
+
 void Points::CreateEphemeralParticleAirBubble(
     vec2f const & position,
     float initialSize,
@@ -107,10 +157,12 @@ void Points::CreateEphemeralParticleAirBubble(
     //
 
     mPositionBuffer[pointIndex] = position;
+    mPreviousPositionBuffer[pointIndex] = position;
     mVelocityBuffer[pointIndex] = vec2f::zero();
     mForceBuffer[pointIndex] = vec2f::zero();
     mMassBuffer[pointIndex] = structuralMaterial.Mass;
     mDecayBuffer[pointIndex] = 1.0f;
+    mDecayBufferDirtyRange.Add(pointIndex);
     mIntegrationFactorTimeCoefficientBuffer[pointIndex] = CalculateIntegrationFactorTimeCoefficient(mCurrentNumMechanicalDynamicsIterations);
     mMaterialsBuffer[pointIndex] = Materials(&structuralMaterial, nullptr);
 
@@ -121,6 +173,8 @@ void Points::CreateEphemeralParticleAirBubble(
     mWaterBuffer[pointIndex] = 0.0f;
     assert(false == mIsLeakingBuffer[pointIndex]);
 
+    UpdateTotalMass(pointIndex);
+
     mLightBuffer[pointIndex] = 0.0f;
 
     mWindReceptivityBuffer[pointIndex] = 0.0f;
@@ -139,117 +193,202 @@ void Points::CreateEphemeralParticleAirBubble(
     mConnectedComponentIdBuffer[pointIndex] = NoneConnectedComponentId;
     mPlaneIdBuffer[pointIndex] = planeId;
     mPlaneIdFloatBuffer[pointIndex] = static_cast<float>(planeId);
-    mIsPlaneIdBufferEphemeralDirty = true;
+    mPlaneIdBufferDirtyRange.Add(pointIndex);
 
     assert(false == mIsPinnedBuffer[pointIndex]);
 
     mColorBuffer[pointIndex] = structuralMaterial.RenderColor;
+    mColorBufferDirtyRange.Add(pointIndex);
 }
 
-void Points::CreateEphemeralParticleDebris(
+void Points::CreateEphemeralParticlesDebris(
+    size_t count,
     vec2f const & position,
-    vec2f const & velocity,
+    vec2f const * velocities,
+    float const * maxLifetimes,
     StructuralMaterial const & structuralMaterial,
     float currentSimulationTime,
-    std::chrono::milliseconds maxLifetime,
     PlaneId planeId)
 {
-    // Get a free slot (or steal one)
-    auto pointIndex = FindFreeEphemeralParticle(currentSimulationTime, true);
-    assert(NoneElementIndex != pointIndex);
-
-    //
-    // Store attributes
-    //
+    assert(count <= MaxEphemeralParticleBatchSize);
 
-    mPositionBuffer[pointIndex] = position;
-    mVelocityBuffer[pointIndex] = velocity;
-    mForceBuffer[pointIndex] = vec2f::zero();
-    mMassBuffer[pointIndex] = structuralMaterial.Mass;
-    mDecayBuffer[pointIndex] = 1.0f;
-    mIntegrationFactorTimeCoefficientBuffer[pointIndex] = CalculateIntegrationFactorTimeCoefficient(mCurrentNumMechanicalDynamicsIterations);
-    mMaterialsBuffer[pointIndex] = Materials(&structuralMaterial, nullptr);
-
-    mWaterVolumeFillBuffer[pointIndex] = 0.0f; // No buoyancy
-    mWaterIntakeBuffer[pointIndex] = structuralMaterial.WaterIntake;
-    mWaterRestitutionBuffer[pointIndex] = 1.0f - structuralMaterial.WaterRetention;
-    mWaterDiffusionSpeedBuffer[pointIndex] = structuralMaterial.WaterDiffusionSpeed;
-    mWaterBuffer[pointIndex] = 0.0f;
-    assert(false == mIsLeakingBuffer[pointIndex]);
-
-    mLightBuffer[pointIndex] = 0.0f;
-
-    mWindReceptivityBuffer[pointIndex] = 3.0f;
-
-    mRustReceptivityBuffer[pointIndex] = 0.0f;
-
-    mEphemeralTypeBuffer[pointIndex] = EphemeralType::Debris;
-    mEphemeralStartTimeBuffer[pointIndex] = currentSimulationTime;
-    mEphemeralMaxLifetimeBuffer[pointIndex] = std::chrono::duration_cast<std::chrono::duration<float>>(maxLifetime).count();
-    mEphemeralStateBuffer[pointIndex] = EphemeralState::DebrisState();
+    if (mCurrentDoSimulateEphemeralParticlesOnGPU)
+    {
+        // Just leave spawn records for the GPU
+        for (size_t i = 0; i < count; ++i)
+        {
+            mPendingGPUEphemeralParticles.emplace_back(
+                EphemeralType::Debris,
+                position,
+                velocities[i],
+                structuralMaterial.RenderColor,
+                0,
+                currentSimulationTime,
+                maxLifetimes[i]);
+        }
 
-    mConnectedComponentIdBuffer[pointIndex] = NoneConnectedComponentId;
-    mPlaneIdBuffer[pointIndex] = planeId;
-    mPlaneIdFloatBuffer[pointIndex] = static_cast<float>(planeId);
-    mIsPlaneIdBufferEphemeralDirty = true;
+        return;
+    }
 
-    assert(false == mIsPinnedBuffer[pointIndex]);
+    // Get free slots (or steal them)
+    ElementIndex pointIndices[MaxEphemeralParticleBatchSize];
+    count = FindFreeEphemeralParticles(count, true, pointIndices);
+
+    auto const dirtyRange = CreateEphemeralParticles(
+        count,
+        pointIndices,
+        position,
+        velocities,
+        maxLifetimes,
+        structuralMaterial,
+        currentSimulationTime,
+        planeId,
+        EphemeralType::Debris);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        mEphemeralStateBuffer[pointIndices[i]] = EphemeralState::DebrisState();
+        mColorBuffer[pointIndices[i]] = structuralMaterial.RenderColor;
+    }
 
-    mColorBuffer[pointIndex] = structuralMaterial.RenderColor;
+    mColorBufferDirtyRange.Add(dirtyRange.GetStart(), dirtyRange.GetEnd());
 
     // Remember that ephemeral points are dirty now
     mAreEphemeralPointsDirty = true;
 }
 
-void Points::CreateEphemeralParticleSparkle(
+void Points::CreateEphemeralParticlesSparkle(
+    size_t count,
     vec2f const & position,
-    vec2f const & velocity,
+    vec2f const * velocities,
+    float const * maxLifetimes,
+    TextureFrameIndex const * textureFrameIndices,
     StructuralMaterial const & structuralMaterial,
     float currentSimulationTime,
-    std::chrono::milliseconds maxLifetime,
     PlaneId planeId)
 {
-    // Get a free slot (or steal one)
-    auto pointIndex = FindFreeEphemeralParticle(currentSimulationTime, true);
-    assert(NoneElementIndex != pointIndex);
+    assert(count <= MaxEphemeralParticleBatchSize);
+
+    if (mCurrentDoSimulateEphemeralParticlesOnGPU)
+    {
+        // Just leave spawn records for the GPU
+        for (size_t i = 0; i < count; ++i)
+        {
+            mPendingGPUEphemeralParticles.emplace_back(
+                EphemeralType::Sparkle,
+                position,
+                velocities[i],
+                vec4f(1.0f, 1.0f, 1.0f, 1.0f),
+                textureFrameIndices[i],
+                currentSimulationTime,
+                maxLifetimes[i]);
+        }
+
+        return;
+    }
+
+    // Get free slots (or steal them)
+    ElementIndex pointIndices[MaxEphemeralParticleBatchSize];
+    count = FindFreeEphemeralParticles(count, true, pointIndices);
+
+    CreateEphemeralParticles(
+        count,
+        pointIndices,
+        position,
+        velocities,
+        maxLifetimes,
+        structuralMaterial,
+        currentSimulationTime,
+        planeId,
+        EphemeralType::Sparkle);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        mEphemeralStateBuffer[pointIndices[i]] = EphemeralState::SparkleState(textureFrameIndices[i]);
+    }
+}
 
+DirtyElementRange Points::CreateEphemeralParticles(
+    size_t count,
+    ElementIndex const * pointIndices,
+    vec2f const & position,
+    vec2f const * velocities,
+    float const * maxLifetimes,
+    StructuralMaterial const & structuralMaterial,
+    float currentSimulationTime,
+    PlaneId planeId,
+    EphemeralType ephemeralType)
+{
     //
-    // Store attributes
+    // Store attributes, one buffer at a time; all particles share everything
+    // but their velocity and lifetime
     //
 
-    mPositionBuffer[pointIndex] = position;
-    mVelocityBuffer[pointIndex] = velocity;
-    mForceBuffer[pointIndex] = vec2f::zero();
-    mMassBuffer[pointIndex] = structuralMaterial.Mass;
-    mDecayBuffer[pointIndex] = 1.0f;
-    mIntegrationFactorTimeCoefficientBuffer[pointIndex] = CalculateIntegrationFactorTimeCoefficient(mCurrentNumMechanicalDynamicsIterations);
-    mMaterialsBuffer[pointIndex] = Materials(&structuralMaterial, nullptr);
+    DirtyElementRange dirtyRange;
 
-    mWaterVolumeFillBuffer[pointIndex] = 0.0f; // No buoyancy
-    mWaterIntakeBuffer[pointIndex] = structuralMaterial.WaterIntake;
-    mWaterRestitutionBuffer[pointIndex] = 1.0f - structuralMaterial.WaterRetention;
-    mWaterDiffusionSpeedBuffer[pointIndex] = structuralMaterial.WaterDiffusionSpeed;
-    mWaterBuffer[pointIndex] = 0.0f;
-    assert(false == mIsLeakingBuffer[pointIndex]);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto const p = pointIndices[i];
 
-    mLightBuffer[pointIndex] = 0.0f;
+        mPositionBuffer[p] = position;
+        mPreviousPositionBuffer[p] = position;
+        mVelocityBuffer[p] = velocities[i];
+        mForceBuffer[p] = vec2f::zero();
 
-    mWindReceptivityBuffer[pointIndex] = 3.0f;
+        dirtyRange.Add(p);
+    }
 
-    mRustReceptivityBuffer[pointIndex] = 0.0f;
+    // No water, hence the total mass is just the mass
+    float const integrationFactorTimeCoefficient = CalculateIntegrationFactorTimeCoefficient(mCurrentNumMechanicalDynamicsIterations);
+    float const integrationFactor = integrationFactorTimeCoefficient / structuralMaterial.Mass;
 
-    mEphemeralTypeBuffer[pointIndex] = EphemeralType::Sparkle;
-    mEphemeralStartTimeBuffer[pointIndex] = currentSimulationTime;
-    mEphemeralMaxLifetimeBuffer[pointIndex] = std::chrono::duration_cast<std::chrono::duration<float>>(maxLifetime).count();
-    mEphemeralStateBuffer[pointIndex] = EphemeralState::SparkleState(
-        GameRandomEngine::GetInstance().Choose<TextureFrameIndex>(2));
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto const p = pointIndices[i];
+
+        mMassBuffer[p] = structuralMaterial.Mass;
+        mDecayBuffer[p] = 1.0f;
+        mIntegrationFactorTimeCoefficientBuffer[p] = integrationFactorTimeCoefficient;
+        mTotalMassBuffer[p] = structuralMaterial.Mass;
+        mIntegrationFactorBuffer[p] = vec2f(integrationFactor, integrationFactor);
+        mMaterialsBuffer[p] = Materials(&structuralMaterial, nullptr);
+    }
 
-    mConnectedComponentIdBuffer[pointIndex] = NoneConnectedComponentId;
-    mPlaneIdBuffer[pointIndex] = planeId;
-    mPlaneIdFloatBuffer[pointIndex] = static_cast<float>(planeId);
-    mIsPlaneIdBufferEphemeralDirty = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto const p = pointIndices[i];
+
+        mWaterVolumeFillBuffer[p] = 0.0f; // No buoyancy
+        mWaterIntakeBuffer[p] = structuralMaterial.WaterIntake;
+        mWaterRestitutionBuffer[p] = 1.0f - structuralMaterial.WaterRetention;
+        mWaterDiffusionSpeedBuffer[p] = structuralMaterial.WaterDiffusionSpeed;
+        mWaterBuffer[p] = 0.0f;
+        assert(false == mIsLeakingBuffer[p]);
+
+        mLightBuffer[p] = 0.0f;
+        mWindReceptivityBuffer[p] = 3.0f;
+        mRustReceptivityBuffer[p] = 0.0f;
+    }
 
-    assert(false == mIsPinnedBuffer[pointIndex]);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto const p = pointIndices[i];
+
+        mEphemeralTypeBuffer[p] = ephemeralType;
+        mEphemeralStartTimeBuffer[p] = currentSimulationTime;
+        mEphemeralMaxLifetimeBuffer[p] = maxLifetimes[i];
+
+        mConnectedComponentIdBuffer[p] = NoneConnectedComponentId;
+        mPlaneIdBuffer[p] = planeId;
+        mPlaneIdFloatBuffer[p] = static_cast<float>(planeId);
+
+        assert(false == mIsPinnedBuffer[p]);
+    }
+
+    mDecayBufferDirtyRange.Add(dirtyRange.GetStart(), dirtyRange.GetEnd());
+    mPlaneIdBufferDirtyRange.Add(dirtyRange.GetStart(), dirtyRange.GetEnd());
+
+    return dirtyRange;
 }
 
 void Points::Detach(
@@ -260,9 +399,9 @@ void Points::Detach(
     GameParameters const & gameParameters)
 {
     // Invoke detach handler
-    if (!!mDetachHandler)
+    if (nullptr != mShipHandler)
     {
-        mDetachHandler(
+        mShipHandler->PointDetachHandler(
             pointElementIndex,
             !!(detachOptions & Points::DetachOptions::GenerateDebris),
             currentSimulationTime,
@@ -280,9 +419,9 @@ void Points::DestroyEphemeralParticle(
     ElementIndex pointElementIndex)
 {
     // Invoke handler
-    if (!!mEphemeralParticleDestroyHandler)
+    if (nullptr != mShipHandler)
     {
-        mEphemeralParticleDestroyHandler(pointElementIndex);
+        mShipHandler->EphemeralParticleDestroyHandler(pointElementIndex);
     }
 
     // Fire destroy event
@@ -308,15 +447,24 @@ void Points::UpdateGameParameters(GameParameters const & gameParameters)
 
         // Remember the new values
         mCurrentNumMechanicalDynamicsIterations = numMechanicalDynamicsIterations;
+
+        // Integration factors need to be re-calculated
+        mAreTotalMassesDirty = true;
     }
+
+    mCurrentDoSimulateEphemeralParticlesOnGPU = gameParameters.DoSimulateEphemeralParticlesOnGPU;
 }
 
 void Points::UpdateEphemeralParticles(
     float currentSimulationTime,
     GameParameters const & /*gameParameters*/)
 {
-    for (ElementIndex pointIndex : this->EphemeralPoints())
+    // Visit the live particles only; we go backwards, as expiring a particle
+    // fills its place with the last live particle, which we've visited already
+    for (size_t l = mLiveEphemeralParticles.size(); l > 0; --l)
     {
+        ElementIndex const pointIndex = mLiveEphemeralParticles[l - 1];
+
         auto const ephemeralType = GetEphemeralType(pointIndex);
         if (EphemeralType::None != ephemeralType)
         {
@@ -396,6 +544,7 @@ void Points::UpdateEphemeralParticles(
                             0.0f);
 
                         mColorBuffer[pointIndex].w = alpha;
+                        mColorBufferDirtyRange.Add(pointIndex);
                     }
 
                     break;
@@ -442,6 +591,8 @@ void Points::Query(ElementIndex pointElementIndex) const
 
 void Points::UploadAttributes(
     ShipId shipId,
+    float renderInterpolationFactor,
+    Render::ShipPointPositionBuffer const * positionBuffer,
     Render::RenderContext & renderContext) const
 {
     // Upload immutable attributes, if we haven't uploaded them yet
@@ -454,25 +605,16 @@ void Points::UploadAttributes(
         mIsTextureCoordinatesBufferDirty = false;
     }
 
-    // Upload colors, if dirty
-    if (mIsWholeColorBufferDirty)
+    // Upload colors, only for the range that has changed
+    if (!mColorBufferDirtyRange.IsEmpty())
     {
         renderContext.UploadShipPointColors(
             shipId,
-            mColorBuffer.data(),
-            0,
-            mAllPointCount);
+            &(mColorBuffer.data()[mColorBufferDirtyRange.GetStart()]),
+            mColorBufferDirtyRange.GetStart(),
+            mColorBufferDirtyRange.GetCount());
 
-        mIsWholeColorBufferDirty = false;
-    }
-    else
-    {
-        // Only upload ephemeral particle portion
-        renderContext.UploadShipPointColors(
-            shipId,
-            &(mColorBuffer.data()[mShipPointCount]),
-            mShipPointCount,
-            mEphemeralPointCount);
+        mColorBufferDirtyRange.Clear();
     }
 
     //
@@ -481,61 +623,70 @@ void Points::UploadAttributes(
 
     renderContext.UploadShipPointMutableAttributesStart(shipId);
 
-    renderContext.UploadShipPointMutableAttributes(
-        shipId,
-        mPositionBuffer.data(),
-        mLightBuffer.data(),
-        mWaterBuffer.data());
-
-    if (mIsPlaneIdBufferNonEphemeralDirty)
+    if (nullptr != positionBuffer)
     {
-        if (mIsPlaneIdBufferEphemeralDirty)
-        {
-            // Whole
+        // Comes from a simulation running on the main thread, hence there's nothing to interpolate
+        assert(renderInterpolationFactor == 1.0f);
 
-            renderContext.UploadShipPointMutableAttributesPlaneId(
-                shipId,
-                mPlaneIdFloatBuffer.data(),
-                0,
-                mAllPointCount);
+        renderContext.UploadShipPointMutableAttributes(
+            shipId,
+            *positionBuffer,
+            mPositionBuffer.data(),
+            mLightBuffer.data(),
+            mWaterBuffer.data());
+    }
+    else if (renderInterpolationFactor < 1.0f)
+    {
+        // Interpolate between the previous and the current positions
+        auto interpolatedPositionBuffer = mVec2fBufferAllocator.Allocate();
+        vec2f * restrict const interpolatedPositions = interpolatedPositionBuffer->data();
+        vec2f const * restrict const previousPositions = mPreviousPositionBuffer.data();
+        vec2f const * restrict const positions = mPositionBuffer.data();
 
-            mIsPlaneIdBufferEphemeralDirty = false;
-        }
-        else
+        for (size_t i = 0; i < mBufferElementCount; ++i)
         {
-            // Just non-ephemeral portion
-
-            renderContext.UploadShipPointMutableAttributesPlaneId(
-                shipId,
-                mPlaneIdFloatBuffer.data(),
-                0,
-                mShipPointCount);
+            interpolatedPositions[i] =
+                previousPositions[i]
+                + (positions[i] - previousPositions[i]) * renderInterpolationFactor;
         }
 
-        mIsPlaneIdBufferNonEphemeralDirty = false;
+        renderContext.UploadShipPointMutableAttributes(
+            shipId,
+            interpolatedPositions,
+            mLightBuffer.data(),
+            mWaterBuffer.data());
     }
-    else if (mIsPlaneIdBufferEphemeralDirty)
+    else
     {
-        // Just ephemeral portion
+        renderContext.UploadShipPointMutableAttributes(
+            shipId,
+            mPositionBuffer.data(),
+            mLightBuffer.data(),
+            mWaterBuffer.data());
+    }
+
+    // Upload plane IDs and decay, only for the ranges that have changed
 
+    if (!mPlaneIdBufferDirtyRange.IsEmpty())
+    {
         renderContext.UploadShipPointMutableAttributesPlaneId(
             shipId,
-            &(mPlaneIdFloatBuffer.data()[mShipPointCount]),
-            mShipPointCount,
-            mEphemeralPointCount);
+            &(mPlaneIdFloatBuffer.data()[mPlaneIdBufferDirtyRange.GetStart()]),
+            mPlaneIdBufferDirtyRange.GetStart(),
+            mPlaneIdBufferDirtyRange.GetCount());
 
-        mIsPlaneIdBufferEphemeralDirty = false;
+        mPlaneIdBufferDirtyRange.Clear();
     }
 
-    if (mIsDecayBufferDirty)
+    if (!mDecayBufferDirtyRange.IsEmpty())
     {
         renderContext.UploadShipPointMutableAttributesDecay(
             shipId,
-            mDecayBuffer.data(),
-            0,
-            mAllPointCount);
+            &(mDecayBuffer.data()[mDecayBufferDirtyRange.GetStart()]),
+            mDecayBufferDirtyRange.GetStart(),
+            mDecayBufferDirtyRange.GetCount());
 
-        mIsDecayBufferDirty = false;
+        mDecayBufferDirtyRange.Clear();
     }
 
     renderContext.UploadShipPointMutableAttributesEnd(shipId);
@@ -545,18 +696,24 @@ void Points::UploadNonEphemeralPointElements(
     ShipId shipId,
     Render::RenderContext & renderContext) const
 {
-    bool doUploadAllPoints = (DebugShipRenderMode::Points == renderContext.GetDebugShipRenderMode());
-
-    for (ElementIndex pointIndex : NonEphemeralPoints())
+    if (DebugShipRenderMode::Points == renderContext.GetDebugShipRenderMode())
     {
-        if (doUploadAllPoints
-            || mConnectedSpringsBuffer[pointIndex].ConnectedSprings.empty()) // orphaned
+        // Upload all points
+        for (ElementIndex pointIndex : NonEphemeralPoints())
         {
             renderContext.UploadShipElementPoint(
                 shipId,
                 pointIndex);
         }
     }
+    else
+    {
+        // Upload the orphaned points, all at once
+        renderContext.UploadShipElementPoints(
+            shipId,
+            mOrphanedPoints.data(),
+            mOrphanedPoints.size());
+    }
 }
 
 void Points::UploadVectors(
@@ -570,8 +727,6 @@ void Points::UploadVectors(
         renderContext.UploadShipVectors(
             shipId,
             mElementCount,
-            mPositionBuffer.data(),
-            mPlaneIdFloatBuffer.data(),
             mVelocityBuffer.data(),
             0.25f,
             VectorColor);
@@ -581,8 +736,6 @@ void Points::UploadVectors(
         renderContext.UploadShipVectors(
             shipId,
             mElementCount,
-            mPositionBuffer.data(),
-            mPlaneIdFloatBuffer.data(),
             mForceRenderBuffer.data(),
             0.0005f,
             VectorColor);
@@ -592,8 +745,6 @@ void Points::UploadVectors(
         renderContext.UploadShipVectors(
             shipId,
             mElementCount,
-            mPositionBuffer.data(),
-            mPlaneIdFloatBuffer.data(),
             mWaterVelocityBuffer.data(),
             1.0f,
             VectorColor);
@@ -603,8 +754,6 @@ void Points::UploadVectors(
         renderContext.UploadShipVectors(
             shipId,
             mElementCount,
-            mPositionBuffer.data(),
-            mPlaneIdFloatBuffer.data(),
             mWaterMomentumBuffer.data(),
             0.4f,
             VectorColor);
@@ -624,7 +773,7 @@ void Points::UploadEphemeralParticles(
         renderContext.UploadShipElementEphemeralPointsStart(shipId);
     }
 
-    for (ElementIndex pointIndex : this->EphemeralPoints())
+    for (ElementIndex pointIndex : mLiveEphemeralParticles)
     {
         switch (GetEphemeralType(pointIndex))
         {
@@ -684,6 +833,37 @@ void Points::UploadEphemeralParticles(
 
         mAreEphemeralPointsDirty = false;
     }
+
+    UploadPendingGPUEphemeralParticles(renderContext);
+}
+
+void Points::UploadPendingGPUEphemeralParticles(Render::RenderContext & renderContext) const
+{
+    for (auto const & particle : mPendingGPUEphemeralParticles)
+    {
+        if (particle.Type == EphemeralType::Debris)
+        {
+            renderContext.UploadEphemeralParticleDebris(
+                particle.Position,
+                particle.Velocity,
+                particle.Color,
+                particle.StartTime,
+                particle.MaxLifetime);
+        }
+        else
+        {
+            assert(particle.Type == EphemeralType::Sparkle);
+
+            renderContext.UploadEphemeralParticleSparkle(
+                particle.Position,
+                particle.Velocity,
+                TextureFrameId(TextureGroupType::SawSparkle, particle.FrameIndex),
+                particle.StartTime,
+                particle.MaxLifetime);
+        }
+    }
+
+    mPendingGPUEphemeralParticles.clear();
 }
 
 void Points::AugmentStructuralMass(
@@ -695,6 +875,8 @@ void Points::AugmentStructuralMass(
 
     mMassBuffer[pointElementIndex] = GetStructuralMaterial(pointElementIndex).Mass + offset;
 
+    UpdateTotalMass(pointElementIndex);
+
     // Notify all connected springs
     for (auto connectedSpring : mConnectedSpringsBuffer[pointElementIndex].ConnectedSprings)
     {
@@ -712,20 +894,74 @@ void Points::UpdateTotalMasses(GameParameters const & gameParameters)
 
     float const densityAdjustedWaterMass = GameParameters::WaterMass * gameParameters.WaterDensityAdjustment;
 
-    for (ElementIndex i : *this)
+    if (!mAreTotalMassesDirty
+        && mWaterBufferGeneration == mTotalMassesWaterBufferGeneration
+        && densityAdjustedWaterMass == mTotalMassesDensityAdjustedWaterMass)
     {
-        float const totalMass =
-            mMassBuffer[i]
-            + std::min(GetWater(i), GetWaterVolumeFill(i)) * densityAdjustedWaterMass;
+        // Nothing has changed since we've last updated - as it's the case
+        // with dry ships - and mass changes update their points right away
+        return;
+    }
+
+    float const * const restrict massBuffer = mMassBuffer.data();
+    float const * const restrict waterBuffer = mWaterBuffer.data();
+    float const * const restrict waterVolumeFillBuffer = mWaterVolumeFillBuffer.data();
+    float const * const restrict integrationFactorTimeCoefficientBuffer = mIntegrationFactorTimeCoefficientBuffer.data();
+    float * const restrict totalMassBuffer = mTotalMassBuffer.data();
+    float * const restrict integrationFactorBuffer = reinterpret_cast<float *>(mIntegrationFactorBuffer.data());
+
+    // Buffers are padded to the vectorization count, and padding
+    // elements have a non-zero mass
+    ElementCount const count = GetBufferElementCount();
+
+#ifdef POINTS_X86_64
+
+    static_assert((VectorizationWordSize % 4) == 0);
+    assert((count % 4) == 0);
 
-        assert(totalMass > 0.0f);
+    __m128 const densityAdjustedWaterMass_4 = _mm_set1_ps(densityAdjustedWaterMass);
+    __m128 const one_4 = _mm_set1_ps(1.0f);
 
-        mTotalMassBuffer[i] = totalMass;
+    for (ElementIndex i = 0; i < count; i += 4)
+    {
+        __m128 const totalMass_4 = _mm_add_ps(
+            _mm_load_ps(massBuffer + i),
+            _mm_mul_ps(
+                _mm_min_ps(_mm_load_ps(waterBuffer + i), _mm_load_ps(waterVolumeFillBuffer + i)),
+                densityAdjustedWaterMass_4));
+
+        _mm_store_ps(totalMassBuffer + i, totalMass_4);
+
+        // One division for both components
+        __m128 const integrationFactor_4 = _mm_mul_ps(
+            _mm_load_ps(integrationFactorTimeCoefficientBuffer + i),
+            _mm_div_ps(one_4, totalMass_4));
+
+        _mm_store_ps(integrationFactorBuffer + i * 2, _mm_unpacklo_ps(integrationFactor_4, integrationFactor_4));
+        _mm_store_ps(integrationFactorBuffer + i * 2 + 4, _mm_unpackhi_ps(integrationFactor_4, integrationFactor_4));
+    }
+
+#else
+
+    for (ElementIndex i = 0; i < count; ++i)
+    {
+        float const totalMass =
+            massBuffer[i]
+            + std::min(waterBuffer[i], waterVolumeFillBuffer[i]) * densityAdjustedWaterMass;
 
-        mIntegrationFactorBuffer[i] = vec2f(
-            mIntegrationFactorTimeCoefficientBuffer[i] / totalMass,
-            mIntegrationFactorTimeCoefficientBuffer[i] / totalMass);
+        totalMassBuffer[i] = totalMass;
+
+        float const integrationFactor = integrationFactorTimeCoefficientBuffer[i] * (1.0f / totalMass);
+        integrationFactorBuffer[i * 2] = integrationFactor;
+        integrationFactorBuffer[i * 2 + 1] = integrationFactor;
     }
+
+#endif
+
+    // Remember what we're current with
+    mTotalMassesWaterBufferGeneration = mWaterBufferGeneration;
+    mTotalMassesDensityAdjustedWaterMass = densityAdjustedWaterMass;
+    mAreTotalMassesDirty = false;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -735,70 +971,207 @@ ElementIndex Points::FindFreeEphemeralParticle(
     bool force)
 {
     //
-    // Search for the firt free ephemeral particle; if a free one is not found, reuse the
-    // oldest particle
+    // Take the lowest free ephemeral particle; if there are no free ones, reuse
+    // the oldest particle
     //
 
-    ElementIndex oldestParticle = NoneElementIndex;
-    float oldestParticleLifetime = 0.0f;
+    if (!mFreeEphemeralParticles.empty())
+    {
+        std::pop_heap(mFreeEphemeralParticles.begin(), mFreeEphemeralParticles.end(), std::greater<ElementIndex>());
+        ElementIndex const p = mFreeEphemeralParticles.back();
+        mFreeEphemeralParticles.pop_back();
 
-    assert(mFreeEphemeralParticleSearchStartIndex >= mShipPointCount
-        && mFreeEphemeralParticleSearchStartIndex < mAllPointCount);
+        assert(EphemeralType::None == GetEphemeralType(p));
 
-    for (ElementIndex p = mFreeEphemeralParticleSearchStartIndex; ; /*incremented in loop*/)
-    {
-        if (EphemeralType::None == GetEphemeralType(p))
-        {
-            // Found!
+        // Make it live
+        assert(NoneElementIndex == mLiveEphemeralParticlePositions[p - mShipPointCount]);
+        mLiveEphemeralParticlePositions[p - mShipPointCount] = static_cast<ElementIndex>(mLiveEphemeralParticles.size());
+        mLiveEphemeralParticles.push_back(p);
 
-            // Remember to start after this one next time
-            mFreeEphemeralParticleSearchStartIndex = p + 1;
-            if (mFreeEphemeralParticleSearchStartIndex >= mAllPointCount)
-                mFreeEphemeralParticleSearchStartIndex = mShipPointCount;
+        return p;
+    }
 
-            return p;
-        }
+    //
+    // No luck
+    //
+
+    if (!force)
+        return NoneElementIndex;
+
+
+    //
+    // Steal the oldest - which is still live, hence it stays where it is
+    //
+
+    ElementIndex oldestParticle = NoneElementIndex;
+    float oldestParticleLifetime = 0.0f;
 
-        // Check whether it's the oldest
+    for (ElementIndex p : mLiveEphemeralParticles)
+    {
         auto lifetime = currentSimulationTime - mEphemeralStartTimeBuffer[p];
         if (lifetime >= oldestParticleLifetime)
         {
             oldestParticle = p;
             oldestParticleLifetime = lifetime;
         }
+    }
 
-        // Advance
-        ++p;
-        if (p >= mAllPointCount)
-            p = mShipPointCount;
+    assert(NoneElementIndex != oldestParticle);
 
-        if (p == mFreeEphemeralParticleSearchStartIndex)
-        {
-            // Went around
-            break;
-        }
-    }
+    return oldestParticle;
+}
 
+size_t Points::FindFreeEphemeralParticles(
+    size_t count,
+    bool force,
+    ElementIndex * pointIndices)
+{
     //
-    // No luck
+    // Take the lowest free ephemeral particles first
     //
 
-    if (!force)
-        return NoneElementIndex;
+    size_t foundCount = 0;
+
+    for (; foundCount < count && !mFreeEphemeralParticles.empty(); ++foundCount)
+    {
+        std::pop_heap(mFreeEphemeralParticles.begin(), mFreeEphemeralParticles.end(), std::greater<ElementIndex>());
+        ElementIndex const p = mFreeEphemeralParticles.back();
+        mFreeEphemeralParticles.pop_back();
+
+        assert(EphemeralType::None == GetEphemeralType(p));
+
+        // Make it live
+        assert(NoneElementIndex == mLiveEphemeralParticlePositions[p - mShipPointCount]);
+        mLiveEphemeralParticlePositions[p - mShipPointCount] = static_cast<ElementIndex>(mLiveEphemeralParticles.size());
+        mLiveEphemeralParticles.push_back(p);
+
+        pointIndices[foundCount] = p;
+    }
 
+    if (foundCount == count || !force)
+        return foundCount;
 
     //
-    // Steal the oldest
+    // Steal the oldest of the particles that were live already - all at once, with a
+    // single pass over them; the ones we've just taken are at the end of the live list
     //
 
-    assert(NoneElementIndex != oldestParticle);
+    size_t const stealableCount = mLiveEphemeralParticles.size() - foundCount;
+    size_t const stealCount = std::min(count - foundCount, stealableCount);
+    if (stealCount == 0)
+        return foundCount;
 
-    // Remember to start after this one next time
-    mFreeEphemeralParticleSearchStartIndex = oldestParticle + 1;
-    if (mFreeEphemeralParticleSearchStartIndex >= mAllPointCount)
-        mFreeEphemeralParticleSearchStartIndex = mShipPointCount;
+    std::vector<std::pair<float, ElementIndex>> & candidates = mEphemeralParticleStealCandidates;
+    candidates.clear();
+    for (size_t l = 0; l < stealableCount; ++l)
+    {
+        ElementIndex const p = mLiveEphemeralParticles[l];
+        candidates.emplace_back(mEphemeralStartTimeBuffer[p], p);
+    }
 
-    return oldestParticle;
+    // Oldest = earliest start
+    std::nth_element(
+        candidates.begin(),
+        candidates.begin() + (stealCount - 1),
+        candidates.end());
+
+    for (size_t s = 0; s < stealCount; ++s)
+    {
+        pointIndices[foundCount++] = candidates[s].second;
+    }
+
+    return foundCount;
+}
+
+void Points::ReportMemory(MemoryReport & report) const
+{
+    report.Add("Materials", mMaterialsBuffer);
+    report.Add("IsRope", mIsRopeBuffer);
+    report.Add("Position", mPositionBuffer);
+    report.Add("PreviousPosition", mPreviousPositionBuffer);
+    report.Add("Velocity", mVelocityBuffer);
+    report.Add("Force", mForceBuffer);
+    report.Add("Mass", mMassBuffer);
+    report.Add("Decay", mDecayBuffer);
+    report.Add("IntegrationFactorTimeCoefficient", mIntegrationFactorTimeCoefficientBuffer);
+    report.Add("TotalMass", mTotalMassBuffer);
+    report.Add("IntegrationFactor", mIntegrationFactorBuffer);
+    report.Add("ForceRender", mForceRenderBuffer);
+    report.Add("IsHull", mIsHullBuffer);
+    report.Add("WaterVolumeFill", mWaterVolumeFillBuffer);
+    report.Add("WaterIntake", mWaterIntakeBuffer);
+    report.Add("WaterRestitution", mWaterRestitutionBuffer);
+    report.Add("WaterDiffusionSpeed", mWaterDiffusionSpeedBuffer);
+    report.Add("Water", mWaterBuffer);
+    report.Add("NewWater", mNewWaterBuffer);
+    report.Add("WaterVelocity", mWaterVelocityBuffer);
+    report.Add("WaterMomentum", mWaterMomentumBuffer);
+    report.Add("CumulatedIntakenWater", mCumulatedIntakenWater);
+    report.Add("IsLeaking", mIsLeakingBuffer);
+    report.Add("FactoryIsLeaking", mFactoryIsLeakingBuffer);
+    report.Add("LeakingPoints", mLeakingPoints);
+    report.Add("ElectricalElement", mElectricalElementBuffer);
+    report.Add("Light", mLightBuffer);
+    report.Add("WindReceptivity", mWindReceptivityBuffer);
+    report.Add("RustReceptivity", mRustReceptivityBuffer);
+    report.Add("EphemeralType", mEphemeralTypeBuffer);
+    report.Add("EphemeralStartTime", mEphemeralStartTimeBuffer);
+    report.Add("EphemeralMaxLifetime", mEphemeralMaxLifetimeBuffer);
+    report.Add("EphemeralState", mEphemeralStateBuffer);
+    report.Add("ConnectedSprings", mConnectedSpringsBuffer);
+    report.Add("FactoryConnectedSprings", mFactoryConnectedSpringsBuffer);
+    report.Add("ConnectedTriangles", mConnectedTrianglesBuffer);
+    report.Add("FactoryConnectedTriangles", mFactoryConnectedTrianglesBuffer);
+    report.Add("OrphanedPointSlot", mOrphanedPointSlotBuffer);
+    report.Add("OrphanedPoints", mOrphanedPoints);
+    report.Add("ConnectedComponentId", mConnectedComponentIdBuffer);
+    report.Add("PlaneId", mPlaneIdBuffer);
+    report.Add("PlaneIdFloat", mPlaneIdFloatBuffer);
+    report.Add("CurrentConnectivityVisitSequenceNumber", mCurrentConnectivityVisitSequenceNumberBuffer);
+    report.Add("IsPinned", mIsPinnedBuffer);
+    report.Add("Color", mColorBuffer);
+    report.Add("TextureCoordinates", mTextureCoordinatesBuffer);
+    report.Add("Vec2fWorkBuffers", mVec2fBufferAllocator);
+    report.Add("FreeEphemeralParticles", mFreeEphemeralParticles);
+    report.Add("LiveEphemeralParticles", mLiveEphemeralParticles);
+    report.Add("LiveEphemeralParticlePositions", mLiveEphemeralParticlePositions);
+}
+
+void Points::SaveState(std::ostream & stream) const
+{
+    BinaryFileTools::WriteArray(stream, mPositionBuffer.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mPreviousPositionBuffer.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mVelocityBuffer.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mDecayBuffer.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mWaterBuffer.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mWaterVelocityBuffer.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mWaterMomentumBuffer.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mCumulatedIntakenWater.data(), mShipPointCount);
+    BinaryFileTools::WriteArray(stream, mIsLeakingBuffer.data(), mShipPointCount);
+}
+
+void Points::LoadState(std::istream & stream)
+{
+    BinaryFileTools::ReadArray(stream, mPositionBuffer.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mPreviousPositionBuffer.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mVelocityBuffer.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mDecayBuffer.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mWaterBuffer.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mWaterVelocityBuffer.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mWaterMomentumBuffer.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mCumulatedIntakenWater.data(), mShipPointCount);
+    BinaryFileTools::ReadArray(stream, mIsLeakingBuffer.data(), mShipPointCount);
+
+    // Rebuild the leaking points, sorted
+    mLeakingPoints.clear();
+    for (auto p : NonEphemeralPoints())
+    {
+        if (mIsLeakingBuffer[p])
+            mLeakingPoints.push_back(p);
+    }
+
+    MarkWaterBufferAsDirty();
+    MarkDecayBufferAsDirty(0, static_cast<ElementIndex>(mShipPointCount));
 }
 
 }
\ No newline at end of file
@@ -10,20 +10,28 @@
 #include "Materials.h"
 #include "RenderContext.h"
 
+#include <GameCore/AABB.h>
 #include <GameCore/Buffer.h>
 #include <GameCore/BufferAllocator.h>
+#include <GameCore/BufferBlock.h>
 #include <GameCore/ElementContainer.h>
 #include <GameCore/ElementIndexRangeIterator.h>
 #include <GameCore/EnumFlags.h>
 #include <GameCore/FixedSizeVector.h>
 #include <GameCore/GameRandomEngine.h>
 #include <GameCore/GameTypes.h>
+#include <GameCore/MemoryReport.h>
 #include <GameCore/Vectors.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <functional>
+#include <istream>
+#include <ostream>
+#include <utility>
 #include <vector>
 
 namespace Physics
@@ -39,15 +47,6 @@ public:
         GenerateDebris = 1
     };
 
-    using DetachHandler = std::function<void(
-        ElementIndex,
-        bool /*generateDebris*/,
-        float /*currentSimulationTime*/,
-        GameParameters const &)>;
-
-    using EphemeralParticleDestroyHandler = std::function<void(
-        ElementIndex)>;
-
     enum class EphemeralType
     {
         None,
@@ -162,6 +161,20 @@ private:
     /*
      * The metadata of all the springs connected to a point.
      */
+    /*
+     * The connected springs of all non-ephemeral points, laid out contiguously: the
+     * connected springs of point p are at [Offsets[p], Offsets[p + 1]) of the other
+     * endpoint and spring index arrays, in the same order as in the point's connected
+     * springs - hence with the springs owned by the point first, up to OwnedEnds[p].
+     */
+    struct Adjacency
+    {
+        std::vector<ElementIndex> Offsets;
+        std::vector<ElementIndex> OwnedEnds;
+        std::vector<ElementIndex> OtherEndpointIndices;
+        std::vector<ElementIndex> SpringIndices;
+    };
+
     struct ConnectedSpringsVector
     {
         FixedSizeVector<ConnectedSpring, GameParameters::MaxSpringsPerPoint> ConnectedSprings;
@@ -177,37 +190,53 @@ private:
             ElementIndex otherEndpointElementIndex,
             bool isAtOwner)
         {
-            // Add so that all springs owned by this point come first
+            ConnectedSprings.emplace_back(springElementIndex, otherEndpointElementIndex);
+
+            // Keep all springs owned by this point first, by swapping the new spring
+            // with the first non-owned one - the order within each of the two groups
+            // is irrelevant, hence we never have to shift the whole vector
             if (isAtOwner)
             {
-                ConnectedSprings.emplace_front(springElementIndex, otherEndpointElementIndex);
+                std::swap(
+                    ConnectedSprings[OwnedConnectedSpringsCount],
+                    ConnectedSprings.back());
+
                 ++OwnedConnectedSpringsCount;
             }
-            else
-            {
-                ConnectedSprings.emplace_back(springElementIndex, otherEndpointElementIndex);
-            }
         }
 
         inline void DisconnectSpring(
             ElementIndex springElementIndex,
             bool isAtOwner)
         {
-            bool found = ConnectedSprings.erase_first(
-                [springElementIndex](ConnectedSpring const & c)
-                {
-                    return c.SpringIndex == springElementIndex;
-                });
+            size_t s = 0;
+            while (s < ConnectedSprings.size() && ConnectedSprings[s].SpringIndex != springElementIndex)
+            {
+                ++s;
+            }
 
-            assert(found);
-            (void)found;
+            assert(s < ConnectedSprings.size());
 
-            // Update count of owned springs, if this spring is owned
             if (isAtOwner)
             {
+                // Fill the hole with the last owned spring, and the hole of the latter
+                // with the last non-owned spring
                 assert(OwnedConnectedSpringsCount > 0);
+                assert(s < OwnedConnectedSpringsCount);
+
                 --OwnedConnectedSpringsCount;
+
+                ConnectedSprings[s] = ConnectedSprings[OwnedConnectedSpringsCount];
+                ConnectedSprings[OwnedConnectedSpringsCount] = ConnectedSprings.back();
+            }
+            else
+            {
+                assert(s >= OwnedConnectedSpringsCount);
+
+                ConnectedSprings[s] = ConnectedSprings.back();
             }
+
+            ConnectedSprings.pop_back();
         }
     };
 
@@ -294,28 +323,35 @@ public:
         , mMaterialsBuffer(mBufferElementCount, shipPointCount, Materials(nullptr, nullptr))
         , mIsRopeBuffer(mBufferElementCount, shipPointCount, false)
         // Mechanical dynamics
-        , mPositionBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
-        , mVelocityBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
-        , mForceBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
+        , mMechanicalDynamicsBufferBlock(
+            4 * BufferBlock::GetRequiredSize<vec2f>(mBufferElementCount) // Position, Velocity, Force, IntegrationFactor
+            + 2 * BufferBlock::GetRequiredSize<float>(mBufferElementCount)) // TotalMass, WaterVolumeFill
+        , mPositionBuffer(mBufferElementCount, shipPointCount, vec2f::zero(), mMechanicalDynamicsBufferBlock)
+        , mPreviousPositionBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
+        , mVelocityBuffer(mBufferElementCount, shipPointCount, vec2f::zero(), mMechanicalDynamicsBufferBlock)
+        , mForceBuffer(mBufferElementCount, shipPointCount, vec2f::zero(), mMechanicalDynamicsBufferBlock)
         , mMassBuffer(mBufferElementCount, shipPointCount, 1.0f)
         , mDecayBuffer(mBufferElementCount, shipPointCount, 1.0f)
-        , mIsDecayBufferDirty(true)
+        , mDecayBufferDirtyRange(0, shipPointCount + GameParameters::MaxEphemeralParticles)
         , mIntegrationFactorTimeCoefficientBuffer(mBufferElementCount, shipPointCount, 0.0f)
-        , mTotalMassBuffer(mBufferElementCount, shipPointCount, 1.0f)
-        , mIntegrationFactorBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
+        , mTotalMassBuffer(mBufferElementCount, shipPointCount, 1.0f, mMechanicalDynamicsBufferBlock)
+        , mIntegrationFactorBuffer(mBufferElementCount, shipPointCount, vec2f::zero(), mMechanicalDynamicsBufferBlock)
         , mForceRenderBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
         // Water dynamics
         , mIsHullBuffer(mBufferElementCount, shipPointCount, false)
-        , mWaterVolumeFillBuffer(mBufferElementCount, shipPointCount, 0.0f)
+        , mWaterVolumeFillBuffer(mBufferElementCount, shipPointCount, 0.0f, mMechanicalDynamicsBufferBlock)
         , mWaterIntakeBuffer(mBufferElementCount, shipPointCount, 0.0f)
         , mWaterRestitutionBuffer(mBufferElementCount, shipPointCount, 0.0f)
         , mWaterDiffusionSpeedBuffer(mBufferElementCount, shipPointCount, 0.0f)
         , mWaterBuffer(mBufferElementCount, shipPointCount, 0.0f)
+        , mWaterBufferGeneration(0)
+        , mNewWaterBuffer(mBufferElementCount, shipPointCount, 0.0f)
         , mWaterVelocityBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
         , mWaterMomentumBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
         , mCumulatedIntakenWater(mBufferElementCount, shipPointCount, 0.0f)
         , mIsLeakingBuffer(mBufferElementCount, shipPointCount, false)
         , mFactoryIsLeakingBuffer(mBufferElementCount, shipPointCount, false)
+        , mLeakingPoints()
         // Electrical dynamics
         , mElectricalElementBuffer(mBufferElementCount, shipPointCount, NoneElementIndex)
         , mLightBuffer(mBufferElementCount, shipPointCount, 0.0f)
@@ -333,18 +369,21 @@ public:
         , mFactoryConnectedSpringsBuffer(mBufferElementCount, shipPointCount, ConnectedSpringsVector())
         , mConnectedTrianglesBuffer(mBufferElementCount, shipPointCount, ConnectedTrianglesVector())
         , mFactoryConnectedTrianglesBuffer(mBufferElementCount, shipPointCount, ConnectedTrianglesVector())
+        , mAdjacency()
+        , mIsAdjacencyDirty(true)
+        , mOrphanedPointSlotBuffer(mBufferElementCount, shipPointCount, NoneElementIndex)
+        , mOrphanedPoints()
         // Connected component and plane ID
         , mConnectedComponentIdBuffer(mBufferElementCount, shipPointCount, NoneConnectedComponentId)
         , mPlaneIdBuffer(mBufferElementCount, shipPointCount, NonePlaneId)
         , mPlaneIdFloatBuffer(mBufferElementCount, shipPointCount, 0.0)
-        , mIsPlaneIdBufferNonEphemeralDirty(true)
-        , mIsPlaneIdBufferEphemeralDirty(true)
+        , mPlaneIdBufferDirtyRange(0, shipPointCount + GameParameters::MaxEphemeralParticles)
         , mCurrentConnectivityVisitSequenceNumberBuffer(mBufferElementCount, shipPointCount, SequenceNumber())
         // Pinning
         , mIsPinnedBuffer(mBufferElementCount, shipPointCount, false)
         // Immutable render attributes
         , mColorBuffer(mBufferElementCount, shipPointCount, vec4f::zero())
-        , mIsWholeColorBufferDirty(true)
+        , mColorBufferDirtyRange(0, shipPointCount + GameParameters::MaxEphemeralParticles)
         , mTextureCoordinatesBuffer(mBufferElementCount, shipPointCount, vec2f::zero())
         , mIsTextureCoordinatesBufferDirty(true)
         //////////////////////////////////
@@ -355,18 +394,45 @@ public:
         , mAllPointCount(mShipPointCount + mEphemeralPointCount)
         , mParentWorld(parentWorld)
         , mGameEventHandler(std::move(gameEventHandler))
-        , mDetachHandler()
-        , mEphemeralParticleDestroyHandler()
+        , mShipHandler(nullptr)
         , mCurrentNumMechanicalDynamicsIterations(gameParameters.NumMechanicalDynamicsIterations<float>())
-        , mFloatBufferAllocator(mBufferElementCount)
+        , mCurrentDoSimulateEphemeralParticlesOnGPU(gameParameters.DoSimulateEphemeralParticlesOnGPU)
+        , mTotalMassesWaterBufferGeneration(0)
+        , mTotalMassesDensityAdjustedWaterMass(0.0f)
+        , mAreTotalMassesDirty(true)
         , mVec2fBufferAllocator(mBufferElementCount)
-        , mFreeEphemeralParticleSearchStartIndex(mShipPointCount)
+        , mFreeEphemeralParticles()
+        , mLiveEphemeralParticles()
+        , mLiveEphemeralParticlePositions(mEphemeralPointCount, NoneElementIndex)
         , mAreEphemeralPointsDirty(false)
+        , mPendingGPUEphemeralParticles()
+        , mEphemeralParticleStealCandidates()
     {
+        // All ephemeral particles start free - in ascending order, which is already a min-heap
+        mFreeEphemeralParticles.reserve(mEphemeralPointCount);
+        for (ElementIndex p = static_cast<ElementIndex>(mShipPointCount); p < mAllPointCount; ++p)
+        {
+            mFreeEphemeralParticles.push_back(p);
+        }
+
+        mLiveEphemeralParticles.reserve(mEphemeralPointCount);
+        mEphemeralParticleStealCandidates.reserve(mEphemeralPointCount);
     }
 
     Points(Points && other) = default;
 
+    /*
+     * Adds the buffers of the points to the report.
+     */
+    void ReportMemory(MemoryReport & report) const;
+
+    /*
+     * Writes - and reads back - the dynamic state of the ship points, for world snapshots;
+     * the ephemeral particles are not part of it.
+     */
+    void SaveState(std::ostream & stream) const;
+    void LoadState(std::istream & stream);
+
     /*
      * Returns an iterator for the non-ephemeral (ship) points only.
      */
@@ -396,6 +462,30 @@ public:
         return ElementIndexRangeIterator(mShipPointCount, mAllPointCount);
     }
 
+    /*
+     * Returns the ephemeral points that are currently live, in no particular order.
+     */
+    inline auto const & LiveEphemeralPoints() const
+    {
+        return mLiveEphemeralParticles;
+    }
+
+    /*
+     * Extends the specified box so that it also covers all of the ephemeral points that are currently live.
+     */
+    void ExtendAABBWithLiveEphemeralPoints(Geometry::AABB & aabb) const
+    {
+        for (ElementIndex const pointIndex : mLiveEphemeralParticles)
+        {
+            vec2f const & position = GetPosition(pointIndex);
+
+            aabb.BottomLeft.x = std::min(aabb.BottomLeft.x, position.x);
+            aabb.BottomLeft.y = std::min(aabb.BottomLeft.y, position.y);
+            aabb.TopRight.x = std::max(aabb.TopRight.x, position.x);
+            aabb.TopRight.y = std::max(aabb.TopRight.y, position.y);
+        }
+    }
+
     /*
      * Returns a flag indicating whether the point is active in the world.
      *
@@ -413,37 +503,27 @@ public:
     }
 
     /*
-     * Sets a (single) handler that is invoked whenever a point is detached.
+     * Sets the (single) ship whose handlers are invoked whenever a point is detached
+     * and whenever an ephemeral particle is destroyed; the handlers are invoked directly,
+     * rather than through type-erased callbacks, as they sit on the hot paths of cuts
+     * and explosions.
      *
-     * The handler is invoked right before the point is modified for the detachment. However,
-     * other elements connected to the soon-to-be-detached point might already have been
-     * deleted.
+     * The detach handler is invoked right before the point is modified for the detachment.
+     * However, other elements connected to the soon-to-be-detached point might already have
+     * been deleted.
      *
-     * The handler is not re-entrant: detaching other points from it is not supported
-     * and leads to undefined behavior.
+     * The ephemeral particle destroy handler is invoked right before the particle is modified
+     * for the destroy.
      *
-     * Setting more than one handler is not supported and leads to undefined behavior.
-     */
-    void RegisterDetachHandler(DetachHandler detachHandler)
-    {
-        assert(!mDetachHandler);
-        mDetachHandler = std::move(detachHandler);
-    }
-
-    /*
-     * Sets a (single) handler that is invoked whenever an ephemeral particle is destroyed.
-     *
-     * The handler is invoked right before the particle is modified for the destroy.
+     * The handlers are not re-entrant: detaching other points, or destroying other ephemeral
+     * particles, from them is not supported and leads to undefined behavior.
      *
-     * The handler is not re-entrant: destroying other ephemeral particles from it is not supported
-     * and leads to undefined behavior.
-     *
-     * Setting more than one handler is not supported and leads to undefined behavior.
+     * Setting more than one ship is not supported and leads to undefined behavior.
      */
-    void RegisterEphemeralParticleDestroyHandler(EphemeralParticleDestroyHandler ephemeralParticleDestroyHandler)
+    void RegisterShipHandler(Ship * shipHandler)
     {
-        assert(!mEphemeralParticleDestroyHandler);
-        mEphemeralParticleDestroyHandler = std::move(ephemeralParticleDestroyHandler);
+        assert(nullptr == mShipHandler);
+        mShipHandler = shipHandler;
     }
 
     void Add(
@@ -465,20 +545,39 @@ public:
         float currentSimulationTime,
         PlaneId planeId);
 
-    void CreateEphemeralParticleDebris(
+    // The most particles that may be created at once, i.e. by a single event
+    static constexpr size_t MaxEphemeralParticleBatchSize = std::max(
+        GameParameters::MaxDebrisParticlesPerEvent,
+        GameParameters::MaxSparkleParticlesPerEvent);
+
+    /*
+     * Creates a batch of debris particles, all at the same position; velocities and
+     * lifetimes - in seconds - are one per particle.
+     *
+     * The slots are taken at once - the lowest free ones, and then the oldest particles -
+     * and the attributes are written one buffer at a time, each buffer's dirty range
+     * growing once for the whole batch.
+     */
+    void CreateEphemeralParticlesDebris(
+        size_t count,
         vec2f const & position,
-        vec2f const & velocity,
+        vec2f const * velocities,
+        float const * maxLifetimes,
         StructuralMaterial const & structuralMaterial,
         float currentSimulationTime,
-        std::chrono::milliseconds maxLifetime,
         PlaneId planeId);
 
-    void CreateEphemeralParticleSparkle(
+    /*
+     * As CreateEphemeralParticlesDebris(), with a texture frame per particle.
+     */
+    void CreateEphemeralParticlesSparkle(
+        size_t count,
         vec2f const & position,
-        vec2f const & velocity,
+        vec2f const * velocities,
+        float const * maxLifetimes,
+        TextureFrameIndex const * textureFrameIndices,
         StructuralMaterial const & structuralMaterial,
         float currentSimulationTime,
-        std::chrono::milliseconds maxLifetime,
         PlaneId planeId);
 
     void DestroyEphemeralParticle(
@@ -503,8 +602,18 @@ public:
     // Render
     //
 
+    /*
+     * The render interpolation factor determines where - between the positions as of the
+     * previous simulation step and the current positions - the uploaded positions lie;
+     * 1.0 uploads the current positions as they are.
+     *
+     * When a position buffer is specified, the positions of the points it covers are
+     * taken from it - the CPU ones being stale - and are not interpolated.
+     */
     void UploadAttributes(
         ShipId shipId,
+        float renderInterpolationFactor,
+        Render::ShipPointPositionBuffer const * positionBuffer,
         Render::RenderContext & renderContext) const;
 
     void UploadNonEphemeralPointElements(
@@ -524,6 +633,13 @@ public:
         ShipId shipId,
         Render::RenderContext & renderContext) const;
 
+    /*
+     * Hands the particles spawned since the last upload over to the GPU; invoked
+     * by UploadEphemeralParticles(), and on its own when the ship is out of view,
+     * as those particles live independently of the ship once spawned.
+     */
+    void UploadPendingGPUEphemeralParticles(Render::RenderContext & renderContext) const;
+
 public:
 
     //
@@ -571,6 +687,20 @@ public:
         return reinterpret_cast<float *>(mPositionBuffer.data());
     }
 
+    /*
+     * Remembers the current positions as the previous positions, for render
+     * interpolation; invoked at the start of each simulation step.
+     */
+    void SavePreviousPositions()
+    {
+        mPreviousPositionBuffer.copy_from(mPositionBuffer);
+    }
+
+    vec2f const & GetPreviousPosition(ElementIndex pointElementIndex) const
+    {
+        return mPreviousPositionBuffer[pointElementIndex];
+    }
+
     vec2f const & GetVelocity(ElementIndex pointElementIndex) const
     {
         return mVelocityBuffer[pointElementIndex];
@@ -615,6 +745,11 @@ public:
         mForceBuffer[pointElementIndex] += force;
     }
 
+    vec2f * restrict GetForceBufferAsVec2()
+    {
+        return mForceBuffer.data();
+    }
+
     float * restrict GetForceBufferAsFloat()
     {
         return reinterpret_cast<float *>(mForceBuffer.data());
@@ -645,11 +780,20 @@ public:
         float value)
     {
         mDecayBuffer[pointElementIndex] = value;
+        mDecayBufferDirtyRange.Add(pointElementIndex);
     }
 
-    void MarkDecayBufferAsDirty()
+    float * restrict GetDecayBufferAsFloat()
     {
-        mIsDecayBufferDirty = true;
+        return mDecayBuffer.data();
+    }
+
+    // For bulk changes made via the buffer
+    void MarkDecayBufferAsDirty(
+        ElementIndex startPointIndex,
+        ElementIndex endPointIndex)
+    {
+        mDecayBufferDirtyRange.Add(startPointIndex, endPointIndex);
     }
 
     /*
@@ -664,6 +808,11 @@ public:
         return mTotalMassBuffer[pointElementIndex];
     }
 
+    float * restrict GetTotalMassBufferAsFloat()
+    {
+        return mTotalMassBuffer.data();
+    }
+
     /*
      * The integration factor is the quantity which, when multiplied with the force on the point,
      * yields the change in position that occurs during a time interval equal to the dynamics simulation step.
@@ -671,11 +820,21 @@ public:
      * Only valid after a call to UpdateTotalMasses() and when
      * neither water quantities nor masses have changed since then.
      */
+    vec2f const & GetIntegrationFactor(ElementIndex pointElementIndex) const
+    {
+        return mIntegrationFactorBuffer[pointElementIndex];
+    }
+
     float * restrict GetIntegrationFactorBufferAsFloat()
     {
         return reinterpret_cast<float *>(mIntegrationFactorBuffer.data());
     }
 
+    /*
+     * Re-calculates total masses and integration factors; a no-op when neither the water
+     * nor the water density have changed since the last call, as changes to the
+     * masses of individual points update those points right away.
+     */
     void UpdateTotalMasses(GameParameters const & gameParameters);
 
     // Changes the point's dynamics so that it freezes in place
@@ -685,6 +844,8 @@ public:
         // Zero-out integration factor time coefficient and velocity, freezing point
         mIntegrationFactorTimeCoefficientBuffer[pointElementIndex] = 0.0f;
         mVelocityBuffer[pointElementIndex] = vec2f(0.0f, 0.0f);
+
+        UpdateTotalMass(pointElementIndex);
     }
 
     // Changes the point's dynamics so that the point reacts again to forces
@@ -692,6 +853,8 @@ public:
     {
         // Re-populate its integration factor time coefficient, thawing point
         mIntegrationFactorTimeCoefficientBuffer[pointElementIndex] = CalculateIntegrationFactorTimeCoefficient(mCurrentNumMechanicalDynamicsIterations);
+
+        UpdateTotalMass(pointElementIndex);
     }
 
     //
@@ -728,13 +891,21 @@ public:
         return mWaterBuffer.data();
     }
 
+    // For bulk changes made via the buffer
+    void MarkWaterBufferAsDirty()
+    {
+        ++mWaterBufferGeneration;
+    }
+
     float GetWater(ElementIndex pointElementIndex) const
     {
         return mWaterBuffer[pointElementIndex];
     }
 
+    // Assumes the water is going to be changed
     float & GetWater(ElementIndex pointElementIndex)
     {
+        ++mWaterBufferGeneration;
         return mWaterBuffer[pointElementIndex];
     }
 
@@ -745,17 +916,20 @@ public:
         return mWaterBuffer[pointElementIndex] > threshold;
     }
 
-    std::shared_ptr<Buffer<float>> MakeWaterBufferCopy()
+    /*
+     * The buffer receiving the water calculated by the water diffusion; the diffusion
+     * is responsible for its contents, which become the current water at the next
+     * SwapWaterBuffers().
+     */
+    float * restrict GetNewWaterBufferAsFloat()
     {
-        auto waterBufferCopy = mFloatBufferAllocator.Allocate();
-        waterBufferCopy->copy_from(mWaterBuffer);
-
-        return waterBufferCopy;
+        return mNewWaterBuffer.data();
     }
 
-    void UpdateWaterBuffer(std::shared_ptr<Buffer<float>> newWaterBuffer)
+    void SwapWaterBuffers()
     {
-        mWaterBuffer.copy_from(*newWaterBuffer);
+        mWaterBuffer.swap(mNewWaterBuffer);
+        ++mWaterBufferGeneration;
     }
 
     vec2f * restrict GetWaterVelocityBufferAsVec2()
@@ -772,13 +946,13 @@ public:
         return mWaterMomentumBuffer.data();
     }
 
-    void UpdateWaterMomentaFromVelocities()
+    void UpdateWaterMomentaFromVelocities(std::vector<ElementIndex> const & pointIndices)
     {
         float * const restrict waterBuffer = mWaterBuffer.data();
         vec2f * const restrict waterVelocityBuffer = mWaterVelocityBuffer.data();
         vec2f * restrict waterMomentumBuffer = mWaterMomentumBuffer.data();
 
-        for (ElementIndex p = 0; p < mBufferElementCount; ++p)
+        for (ElementIndex p : pointIndices)
         {
             waterMomentumBuffer[p] =
                 waterVelocityBuffer[p]
@@ -786,13 +960,13 @@ public:
         }
     }
 
-    void UpdateWaterVelocitiesFromMomenta()
+    void UpdateWaterVelocitiesFromMomenta(std::vector<ElementIndex> const & pointIndices)
     {
         float * const restrict waterBuffer = mWaterBuffer.data();
         vec2f * restrict waterVelocityBuffer = mWaterVelocityBuffer.data();
         vec2f * const restrict waterMomentumBuffer = mWaterMomentumBuffer.data();
 
-        for (ElementIndex p = 0; p < mBufferElementCount; ++p)
+        for (ElementIndex p : pointIndices)
         {
             if (waterBuffer[p] != 0.0f)
             {
@@ -823,8 +997,23 @@ public:
         return mIsLeakingBuffer[pointElementIndex];
     }
 
+    /*
+     * The indices of all the leaking points, sorted.
+     */
+    std::vector<ElementIndex> const & GetLeakingPoints() const
+    {
+        return mLeakingPoints;
+    }
+
     void SetLeaking(ElementIndex pointElementIndex)
     {
+        if (!mIsLeakingBuffer[pointElementIndex])
+        {
+            mLeakingPoints.insert(
+                std::lower_bound(mLeakingPoints.begin(), mLeakingPoints.end(), pointElementIndex),
+                pointElementIndex);
+        }
+
         mIsLeakingBuffer[pointElementIndex] = true;
 
         // Randomize the initial water intaken, so that air bubbles won't come out all at the same moment
@@ -835,6 +1024,13 @@ public:
 
     void RestoreFactoryIsLeaking(ElementIndex pointElementIndex)
     {
+        if (mIsLeakingBuffer[pointElementIndex] && !mFactoryIsLeakingBuffer[pointElementIndex])
+        {
+            auto const it = std::lower_bound(mLeakingPoints.begin(), mLeakingPoints.end(), pointElementIndex);
+            assert(it != mLeakingPoints.end() && *it == pointElementIndex);
+            mLeakingPoints.erase(it);
+        }
+
         mIsLeakingBuffer[pointElementIndex] = mFactoryIsLeakingBuffer[pointElementIndex];
     }
 
@@ -847,6 +1043,11 @@ public:
         return mElectricalElementBuffer[pointElementIndex];
     }
 
+    float * restrict GetLightBufferAsFloat()
+    {
+        return mLightBuffer.data();
+    }
+
     float GetLight(ElementIndex pointElementIndex) const
     {
         return mLightBuffer[pointElementIndex];
@@ -875,6 +1076,11 @@ public:
         return mRustReceptivityBuffer[pointElementIndex];
     }
 
+    float const * restrict GetRustReceptivityBufferAsFloat() const
+    {
+        return mRustReceptivityBuffer.data();
+    }
+
     //
     // Ephemeral Particles
     //
@@ -905,10 +1111,15 @@ public:
                 return cs.SpringIndex == springElementIndex;
             }));
 
+        if (mConnectedSpringsBuffer[pointElementIndex].ConnectedSprings.empty())
+            RemoveOrphanedPoint(pointElementIndex);
+
         mConnectedSpringsBuffer[pointElementIndex].ConnectSpring(
             springElementIndex,
             otherEndpointElementIndex,
             isAtOwner);
+
+        mIsAdjacencyDirty = true;
     }
 
     void DisconnectSpring(
@@ -919,8 +1130,30 @@ public:
         mConnectedSpringsBuffer[pointElementIndex].DisconnectSpring(
             springElementIndex,
             isAtOwner);
+
+        if (mConnectedSpringsBuffer[pointElementIndex].ConnectedSprings.empty())
+            AddOrphanedPoint(pointElementIndex);
+
+        mIsAdjacencyDirty = true;
+    }
+
+    /*
+     * Gets the connected springs of all non-ephemeral points in compressed sparse row
+     * layout, rebuilding it first if springs have been connected or disconnected since
+     * it was last built.
+     */
+    Adjacency const & GetAdjacency()
+    {
+        if (mIsAdjacencyDirty)
+        {
+            RebuildAdjacency();
+        }
+
+        return mAdjacency;
     }
 
+    void RebuildAdjacency();
+
     auto const & GetFactoryConnectedSprings(ElementIndex pointElementIndex) const
     {
         return mFactoryConnectedSpringsBuffer[pointElementIndex];
@@ -1032,11 +1265,12 @@ public:
     {
         mPlaneIdBuffer[pointElementIndex] = planeId;
         mPlaneIdFloatBuffer[pointElementIndex] = planeIdFloat;
+        mPlaneIdBufferDirtyRange.Add(pointElementIndex);
     }
 
     void MarkPlaneIdBufferNonEphemeralAsDirty()
     {
-        mIsPlaneIdBufferNonEphemeralDirty = true;
+        mPlaneIdBufferDirtyRange.Add(0, mShipPointCount);
     }
 
     SequenceNumber GetCurrentConnectivityVisitSequenceNumber(ElementIndex pointElementIndex) const
@@ -1091,38 +1325,64 @@ public:
     // Mostly for debugging
     void MarkColorBufferAsDirty()
     {
-        mIsWholeColorBufferDirty = true;
+        mColorBufferDirtyRange.Add(0, mAllPointCount);
     }
 
+private:
 
-    //
-    // Temporary buffer
-    //
-
-    std::shared_ptr<Buffer<float>> AllocateWorkBufferFloat()
+    static inline float CalculateIntegrationFactorTimeCoefficient(float numMechanicalDynamicsIterations)
     {
-        return mFloatBufferAllocator.Allocate();
+        return GameParameters::MechanicalSimulationStepTimeDuration<float>(numMechanicalDynamicsIterations)
+            * GameParameters::MechanicalSimulationStepTimeDuration<float>(numMechanicalDynamicsIterations);
     }
 
-    std::shared_ptr<Buffer<vec2f>> AllocateWorkBufferVec2f()
+    // Brings a single point's total mass up-to-date with the current water density,
+    // after a change to its mass or time coefficient
+    inline void UpdateTotalMass(ElementIndex pointElementIndex)
     {
-        return mVec2fBufferAllocator.Allocate();
-    }
+        float const totalMass =
+            mMassBuffer[pointElementIndex]
+            + std::min(mWaterBuffer[pointElementIndex], mWaterVolumeFillBuffer[pointElementIndex]) * mTotalMassesDensityAdjustedWaterMass;
 
-private:
+        assert(totalMass > 0.0f);
 
-    static inline float CalculateIntegrationFactorTimeCoefficient(float numMechanicalDynamicsIterations)
-    {
-        return GameParameters::MechanicalSimulationStepTimeDuration<float>(numMechanicalDynamicsIterations)
-            * GameParameters::MechanicalSimulationStepTimeDuration<float>(numMechanicalDynamicsIterations);
+        mTotalMassBuffer[pointElementIndex] = totalMass;
+
+        float const integrationFactor = mIntegrationFactorTimeCoefficientBuffer[pointElementIndex] / totalMass;
+        mIntegrationFactorBuffer[pointElementIndex] = vec2f(integrationFactor, integrationFactor);
     }
 
     ElementIndex FindFreeEphemeralParticle(
         float currentSimulationTime,
         bool force);
 
+    /*
+     * Returns the number of slots found, which is less than the requested count
+     * only when not forced.
+     */
+    size_t FindFreeEphemeralParticles(
+        size_t count,
+        bool force,
+        ElementIndex * pointIndices);
+
+    /*
+     * Writes the attributes shared by debris and sparkles; returns the range of the particles.
+     */
+    DirtyElementRange CreateEphemeralParticles(
+        size_t count,
+        ElementIndex const * pointIndices,
+        vec2f const & position,
+        vec2f const * velocities,
+        float const * maxLifetimes,
+        StructuralMaterial const & structuralMaterial,
+        float currentSimulationTime,
+        PlaneId planeId,
+        EphemeralType ephemeralType);
+
     inline void ExpireEphemeralParticle(ElementIndex pointElementIndex)
     {
+        assert(EphemeralType::None != mEphemeralTypeBuffer[pointElementIndex]);
+
         // Freeze the particle (just to prevent drifting)
         Freeze(pointElementIndex);
 
@@ -1130,6 +1390,42 @@ private:
         // - Being rendered
         // - Being updated
         mEphemeralTypeBuffer[pointElementIndex] = EphemeralType::None;
+
+        // Move the particle from the live particles to the free ones, filling its
+        // place among the live particles with the last of them
+        ElementIndex const livePosition = mLiveEphemeralParticlePositions[pointElementIndex - mShipPointCount];
+        assert(livePosition < mLiveEphemeralParticles.size());
+
+        ElementIndex const lastLiveParticle = mLiveEphemeralParticles.back();
+        mLiveEphemeralParticles[livePosition] = lastLiveParticle;
+        mLiveEphemeralParticlePositions[lastLiveParticle - mShipPointCount] = livePosition;
+        mLiveEphemeralParticles.pop_back();
+
+        mLiveEphemeralParticlePositions[pointElementIndex - mShipPointCount] = NoneElementIndex;
+        mFreeEphemeralParticles.push_back(pointElementIndex);
+        std::push_heap(mFreeEphemeralParticles.begin(), mFreeEphemeralParticles.end(), std::greater<ElementIndex>());
+    }
+
+    inline void AddOrphanedPoint(ElementIndex pointElementIndex)
+    {
+        assert(NoneElementIndex == mOrphanedPointSlotBuffer[pointElementIndex]);
+
+        mOrphanedPointSlotBuffer[pointElementIndex] = static_cast<ElementIndex>(mOrphanedPoints.size());
+        mOrphanedPoints.push_back(pointElementIndex);
+    }
+
+    inline void RemoveOrphanedPoint(ElementIndex pointElementIndex)
+    {
+        assert(NoneElementIndex != mOrphanedPointSlotBuffer[pointElementIndex]);
+
+        // Move the last orphaned point into this point's slot
+        ElementIndex const slot = mOrphanedPointSlotBuffer[pointElementIndex];
+        ElementIndex const lastPointElementIndex = mOrphanedPoints.back();
+        mOrphanedPoints[slot] = lastPointElementIndex;
+        mOrphanedPointSlotBuffer[lastPointElementIndex] = slot;
+        mOrphanedPoints.pop_back();
+
+        mOrphanedPointSlotBuffer[pointElementIndex] = NoneElementIndex;
     }
 
 private:
@@ -1146,12 +1442,16 @@ private:
     // Dynamics
     //
 
+    // The buffers walked by the point forces and the integration, kept together
+    BufferBlock mMechanicalDynamicsBufferBlock;
+
     Buffer<vec2f> mPositionBuffer;
+    Buffer<vec2f> mPreviousPositionBuffer; // As of the start of the current simulation step; for render interpolation
     Buffer<vec2f> mVelocityBuffer;
     Buffer<vec2f> mForceBuffer;
     Buffer<float> mMassBuffer; // Structural + Offset
     Buffer<float> mDecayBuffer; // 1.0 -> 0.0 (completely decayed)
-    mutable bool mIsDecayBufferDirty;
+    DirtyElementRange mutable mDecayBufferDirtyRange; // Since last render upload
     Buffer<float> mIntegrationFactorTimeCoefficientBuffer; // dt^2 or zero when the point is frozen
 
     // Continuously-Calculated values
@@ -1172,6 +1472,11 @@ private:
     // Height of a 1m2 column of water which provides a pressure equivalent to the pressure at
     // this point. Quantity of water is max(water, 1.0)
     Buffer<float> mWaterBuffer;
+    std::uint64_t mWaterBufferGeneration; // Bumped at each change
+
+    // The water calculated by the water diffusion, swapped with the water
+    // at the end of the diffusion
+    Buffer<float> mNewWaterBuffer;
 
     // Total velocity of the water at this point
     Buffer<vec2f> mWaterVelocityBuffer;
@@ -1187,6 +1492,9 @@ private:
     Buffer<bool> mIsLeakingBuffer;
     Buffer<bool> mFactoryIsLeakingBuffer;
 
+    // The indices of the points that are leaking, sorted
+    std::vector<ElementIndex> mLeakingPoints;
+
     //
     // Electrical dynamics
     //
@@ -1227,6 +1535,16 @@ private:
     Buffer<ConnectedTrianglesVector> mConnectedTrianglesBuffer;
     Buffer<ConnectedTrianglesVector> mFactoryConnectedTrianglesBuffer;
 
+    // The connected springs in compressed sparse row layout, rebuilt lazily
+    Adjacency mAdjacency;
+    bool mIsAdjacencyDirty;
+
+    // The non-ephemeral points without connected springs, in no particular order, as
+    // rendered in the default render mode; kept up-to-date as springs are connected
+    // and disconnected, via the position of each orphaned point in there
+    Buffer<ElementIndex> mOrphanedPointSlotBuffer;
+    std::vector<ElementIndex> mOrphanedPoints;
+
     //
     // Connectivity
     //
@@ -1234,8 +1552,7 @@ private:
     Buffer<ConnectedComponentId> mConnectedComponentIdBuffer;
     Buffer<PlaneId> mPlaneIdBuffer;
     Buffer<float> mPlaneIdFloatBuffer;
-    bool mutable mIsPlaneIdBufferNonEphemeralDirty;
-    bool mutable mIsPlaneIdBufferEphemeralDirty;
+    DirtyElementRange mutable mPlaneIdBufferDirtyRange; // Since last render upload
     Buffer<SequenceNumber> mCurrentConnectivityVisitSequenceNumberBuffer;
 
     //
@@ -1249,7 +1566,7 @@ private:
     //
 
     Buffer<vec4f> mColorBuffer;
-    bool mutable mIsWholeColorBufferDirty;  // Whether or not is dirty since last render upload
+    DirtyElementRange mutable mColorBufferDirtyRange; // Since last render upload
     Buffer<vec2f> mTextureCoordinatesBuffer;
     bool mutable mIsTextureCoordinatesBufferDirty; // Whether or not is dirty since last render upload
 
@@ -1270,29 +1587,72 @@ private:
     World & mParentWorld;
     std::shared_ptr<IGameEventHandler> const mGameEventHandler;
 
-    // The handler registered for point detachments
-    DetachHandler mDetachHandler;
-
-    // The handler registered for ephemeral particle destroy's
-    EphemeralParticleDestroyHandler mEphemeralParticleDestroyHandler;
+    // The ship registered for point detachments and ephemeral particle destroy's
+    Ship * mShipHandler;
 
     // The game parameter values that we are current with; changes
     // in the values of these parameters will trigger a re-calculation
     // of pre-calculated coefficients
     float mCurrentNumMechanicalDynamicsIterations;
+    bool mCurrentDoSimulateEphemeralParticlesOnGPU;
+
+    // What the total masses are current with
+    std::uint64_t mTotalMassesWaterBufferGeneration;
+    float mTotalMassesDensityAdjustedWaterMass;
+    bool mAreTotalMassesDirty; // Regardless of water
+
+    // Allocator for the work buffers of uploads, which happen outside of the simulation step
+    mutable BufferAllocator<vec2f> mVec2fBufferAllocator;
 
-    // Allocators for work buffers
-    BufferAllocator<float> mFloatBufferAllocator;
-    BufferAllocator<vec2f> mVec2fBufferAllocator;
+    // The ephemeral particles that are free, as a min-heap: the lowest ones are handed out
+    // first, which packs the live particles at the start of the ephemeral range, and so
+    // keeps the dirty ranges of their attributes - colors, plane IDs, decay - short
+    std::vector<ElementIndex> mFreeEphemeralParticles;
 
-    // The index at which to start searching for free ephemeral particles
-    // (just an optimization over restarting from zero each time)
-    ElementIndex mFreeEphemeralParticleSearchStartIndex;
+    // The ephemeral particles that are live, in no particular order, and the
+    // position of each ephemeral particle in there (NoneElementIndex when free)
+    std::vector<ElementIndex> mLiveEphemeralParticles;
+    std::vector<ElementIndex> mLiveEphemeralParticlePositions;
 
     // Flag remembering whether the set of ephemeral points is dirty
     // (i.e. whether there are more or less points than previously
     // reported to the rendering engine)
     bool mutable mAreEphemeralPointsDirty;
+
+    // The spawn records of the ephemeral particles simulated on the GPU,
+    // waiting for the next upload
+    struct GPUEphemeralParticle
+    {
+        EphemeralType Type;
+        vec2f Position;
+        vec2f Velocity;
+        vec4f Color;
+        TextureFrameIndex FrameIndex;
+        float StartTime;
+        float MaxLifetime;
+
+        GPUEphemeralParticle(
+            EphemeralType type,
+            vec2f const & position,
+            vec2f const & velocity,
+            vec4f const & color,
+            TextureFrameIndex frameIndex,
+            float startTime,
+            float maxLifetime)
+            : Type(type)
+            , Position(position)
+            , Velocity(velocity)
+            , Color(color)
+            , FrameIndex(frameIndex)
+            , StartTime(startTime)
+            , MaxLifetime(maxLifetime)
+        {}
+    };
+
+    std::vector<GPUEphemeralParticle> mutable mPendingGPUEphemeralParticles;
+
+    // Scratch for stealing particles: start time, particle
+    std::vector<std::pair<float, ElementIndex>> mEphemeralParticleStealCandidates;
 };
 
 }
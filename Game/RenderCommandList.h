@@ -0,0 +1,85 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-30
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameCore/WorkBufferArena.h>
+
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace Render {
+
+/*
+ * The OpenGL work of a frame, recorded on one thread and replayed - in the order it was
+ * recorded - on the thread that owns the OpenGL context.
+ *
+ * The commands may refer to data blocks owned by the list, which hold copies of the
+ * data that the recording thread may change after recording; blocks stay valid until
+ * the list is cleared. The memory of both commands and blocks is kept across clears,
+ * so that a list recorded anew at each frame soon stops allocating.
+ */
+class RenderCommandList
+{
+public:
+
+    RenderCommandList()
+        : mCommands()
+        , mBlockArena()
+    {}
+
+    RenderCommandList(RenderCommandList const &) = delete;
+    RenderCommandList & operator=(RenderCommandList const &) = delete;
+
+    template<typename TCommand>
+    void Record(TCommand && command)
+    {
+        mCommands.emplace_back(std::forward<TCommand>(command));
+    }
+
+    /*
+     * Copies the specified elements into a block owned by this list, returning the copy.
+     */
+    template<typename TElement>
+    TElement const * CopyBlock(
+        TElement const * elements,
+        size_t elementCount)
+    {
+        static_assert(std::is_trivially_copyable_v<TElement>);
+
+        TElement * const block = mBlockArena.Allocate<TElement>(elementCount);
+        std::memcpy(block, elements, elementCount * sizeof(TElement));
+
+        return block;
+    }
+
+    bool IsEmpty() const
+    {
+        return mCommands.empty();
+    }
+
+    void Replay()
+    {
+        for (auto const & command : mCommands)
+        {
+            command();
+        }
+    }
+
+    void Clear()
+    {
+        mCommands.clear();
+        mBlockArena.Reset();
+    }
+
+private:
+
+    std::vector<std::function<void()>> mCommands;
+    WorkBufferArena mBlockArena;
+};
+
+}
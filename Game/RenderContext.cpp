@@ -7,8 +7,12 @@
 
 #include <GameCore/GameException.h>
 #include <GameCore/Log.h>
+#include <GameCore/ResourceArchive.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <filesystem>
 
 namespace Render {
 
@@ -18,10 +22,14 @@ RenderContext::RenderContext(
     // Buffers
     : mStarVertexBuffer()
     , mStarVBO()
-    , mCloudQuadBuffer()
-    , mCloudVBO()
+    , mCloudInstanceBuffer()
+    , mCloudInstanceCount(0)
+    , mCloudInstanceVBO()
+    , mCloudQuadVBO()
     , mLandSegmentBuffer()
     , mLandSegmentBufferAllocatedSize(0u)
+    , mLandSegmentRangeBuffer()
+    , mLandSegmentRangeFirstSegment(0u)
     , mLandVBO()
     , mOceanSegmentBuffer()
     , mOceanSegmentBufferAllocatedSize(0u)
@@ -30,6 +38,10 @@ RenderContext::RenderContext(
     , mCrossOfLightVBO()
     , mWorldBorderVertexBuffer()
     , mWorldBorderVBO()
+    , mScreenshotPixelBuffers()
+    , mScreenshotSizes{ ImageSize::Zero(), ImageSize::Zero() }
+    , mNextScreenshotPixelBuffer(0)
+    , mPendingScreenshotCount(0)
     // VAOs
     , mStarVAO()
     , mCloudVAO()
@@ -41,6 +53,7 @@ RenderContext::RenderContext(
     , mCloudTextureAtlasOpenGLHandle()
     , mCloudTextureAtlasMetadata()
     // Ships
+    , mShipBufferRecycler()
     , mShips()
     , mGenericTextureAtlasOpenGLHandle()
     , mGenericTextureAtlasMetadata()
@@ -51,6 +64,9 @@ RenderContext::RenderContext(
     , mShaderManager()
     , mTextureRenderManager()
     , mTextRenderContext()
+    , mParticleRenderContext()
+    , mGPUTimerQueries()
+    , mWorldGPUTimer()
     // Render parameters
     , mViewModel(1.0f, vec2f::zero(), 100, 100)
     , mFlatSkyColor(0x87, 0xce, 0xfa) // (cornflower blue)
@@ -70,8 +86,24 @@ RenderContext::RenderContext(
     , mVectorFieldRenderMode(VectorFieldRenderMode::None)
     , mVectorFieldLengthMultiplier(1.0f)
     , mShowStressedSprings(false)
+    , mWorldRenderScale(1.0f)
+    , mDoAdaptWorldRenderScale(false)
+    , mIsSceneDirty(true)
+    , mStreamingShipTextureCount(0)
+    // Dynamic resolution
+    , mCurrentWorldRenderScale(1.0f)
+    , mWorldFramebuffer()
+    , mWorldColorRenderbuffer()
+    , mWorldDepthStencilRenderbuffer()
+    , mWorldFramebufferSize(0, 0)
+    , mIsWorldRenderedOffscreen(false)
     // Statistics
     , mRenderStatistics()
+    // Frames in flight
+    , mMaxFramesInFlight(1)
+    , mFrameFences()
+    // Render thread
+    , mRenderThread()
 {
     static constexpr float GenericTextureProgressSteps = 10.0f;
     static constexpr float CloudTextureProgressSteps = 4.0f;
@@ -132,36 +164,45 @@ RenderContext::RenderContext(
     // Create texture render manager
     mTextureRenderManager = std::make_unique<TextureRenderManager>();
 
+    // Create GPU timers, used when tracing
+    mGPUTimerQueries = std::make_unique<GameOpenGLTimerQueries>();
+
+    // Create world GPU timer, used for the adaptive render scale
+    mWorldGPUTimer = std::make_unique<GameOpenGLElapsedTimer>();
+
 
 
     //
     // Create generic texture atlas
     //
-    // Atlas-ize all textures EXCEPT the following:
-    // - Land, Ocean: we need these to be wrapping
-    // - Clouds: we keep these in a separate atlas, we have to rebind anyway
-    // - WorldBorder
+    // We use the atlas baked offline by ShipTools, as long as it's not older than
+    // the texture database; otherwise, we build it from the individual textures.
+    // A packed atlas is as recent as the packed texture database, but not as a
+    // loose one
     //
 
     mShaderManager->ActivateTexture<ProgramParameterType::GenericTexturesAtlasTexture>();
 
-    TextureAtlasBuilder genericTextureAtlasBuilder;
-    for (auto const & group : textureDatabase.GetGroups())
-    {
-        if (TextureGroupType::Land != group.Group
-            && TextureGroupType::Ocean != group.Group
-            && TextureGroupType::Cloud != group.Group
-            && TextureGroupType::WorldBorder != group.Group)
-        {
-            genericTextureAtlasBuilder.Add(group);
-        }
-    }
-
-    TextureAtlas genericTextureAtlas = genericTextureAtlasBuilder.BuildAtlas(
-        [&progressCallback](float progress, std::string const &)
-        {
-            progressCallback((3.0f + progress * GenericTextureProgressSteps) / TotalProgressSteps, "Loading textures...");
-        });
+    auto const bakedGenericTextureAtlasFilePath = resourceLoader.GetBakedGenericTextureAtlasFilePath();
+    auto const textureDatabaseFilePath = resourceLoader.GetTexturesFilePath() / "textures.json";
+
+    std::error_code ec;
+    bool const isBakedGenericTextureAtlasUpToDate = std::filesystem::exists(bakedGenericTextureAtlasFilePath, ec)
+        ? (std::filesystem::last_write_time(bakedGenericTextureAtlasFilePath, ec)
+            >= std::filesystem::last_write_time(textureDatabaseFilePath, ec)
+            && !ec)
+        : (!!ResourceArchive::FindMounted(bakedGenericTextureAtlasFilePath)
+            && !std::filesystem::exists(textureDatabaseFilePath, ec));
+
+    TextureAtlas genericTextureAtlas = isBakedGenericTextureAtlasUpToDate
+        ? TextureAtlas::Deserialize(bakedGenericTextureAtlasFilePath)
+        : TextureAtlasBuilder::BuildGenericTextureAtlas(
+            textureDatabase,
+            TextureAtlasBuilder::AtlasOptions(),
+            [&progressCallback](float progress, std::string const &)
+            {
+                progressCallback((3.0f + progress * GenericTextureProgressSteps) / TotalProgressSteps, "Loading textures...");
+            });
 
     LogMessage("Generic texture atlas size: ", genericTextureAtlas.AtlasData.Size.Width, "x", genericTextureAtlas.AtlasData.Size.Height);
 
@@ -195,19 +236,44 @@ RenderContext::RenderContext(
     mShaderManager->ActivateProgram<ProgramType::ShipGenericTextures>();
     mShaderManager->SetTextureParameters<ProgramType::ShipGenericTextures>();
 
+    // Initialize the GPU particles
+    mParticleRenderContext = std::make_unique<ParticleRenderContext>(
+        *mShaderManager,
+        *mGenericTextureAtlasMetadata,
+        mViewModel,
+        mAmbientLightIntensity);
+
 
     //
     // Initialize buffers
     //
 
-    GLuint vbos[6];
-    glGenBuffers(6, vbos);
+    GLuint vbos[7];
+    glGenBuffers(7, vbos);
     mStarVBO = vbos[0];
-    mCloudVBO = vbos[1];
-    mLandVBO = vbos[2];
-    mOceanVBO = vbos[3];
-    mCrossOfLightVBO = vbos[4];
-    mWorldBorderVBO = vbos[5];
+    mCloudInstanceVBO = vbos[1];
+    mCloudQuadVBO = vbos[2];
+    mLandVBO = vbos[3];
+    mOceanVBO = vbos[4];
+    mCrossOfLightVBO = vbos[5];
+    mWorldBorderVBO = vbos[6];
+
+    // The cloud quad never changes - two triangles between (0,0) and (1,1)
+    {
+        static float const CloudQuadVertices[] = {
+            0.0f, 1.0f,     // Top-left
+            0.0f, 0.0f,     // Bottom-left
+            1.0f, 1.0f,     // Top-right
+            0.0f, 0.0f,     // Bottom-left
+            1.0f, 1.0f,     // Top-right
+            1.0f, 0.0f      // Bottom-right
+        };
+
+        glBindBuffer(GL_ARRAY_BUFFER, *mCloudQuadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(CloudQuadVertices), CloudQuadVertices, GL_STATIC_DRAW);
+        CheckOpenGLError();
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
 
 
     //
@@ -239,10 +305,22 @@ RenderContext::RenderContext(
     glBindVertexArray(*mCloudVAO);
     CheckOpenGLError();
 
-    // Describe vertex attributes
-    glBindBuffer(GL_ARRAY_BUFFER, *mCloudVBO);
+    // Describe vertex attributes: the quad corner advances with each vertex...
+    glBindBuffer(GL_ARRAY_BUFFER, *mCloudQuadVBO);
     glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::Cloud));
-    glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::Cloud), 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::Cloud), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    CheckOpenGLError();
+
+    // ...while the cloud constants advance with each instance
+    glBindBuffer(GL_ARRAY_BUFFER, *mCloudInstanceVBO);
+    static_assert(sizeof(CloudInstance) == (4 + 4 + 4 + 4 + 4) * sizeof(float));
+    for (GLuint i = 0; i < 5; ++i)
+    {
+        GLuint const attributeIndex = static_cast<GLuint>(VertexAttributeType::CloudInstance1) + i;
+        glEnableVertexAttribArray(attributeIndex);
+        glVertexAttribPointer(attributeIndex, 4, GL_FLOAT, GL_FALSE, sizeof(CloudInstance), (void*)(i * 4 * sizeof(float)));
+        glVertexAttribDivisor(attributeIndex, 1);
+    }
     CheckOpenGLError();
 
     glBindVertexArray(0);
@@ -336,6 +414,7 @@ RenderContext::RenderContext(
     cloudAtlasBuilder.Add(textureDatabase.GetGroup(TextureGroupType::Cloud));
 
     TextureAtlas cloudTextureAtlas = cloudAtlasBuilder.BuildAtlas(
+        TextureAtlasBuilder::AtlasOptions(),
         [&progressCallback](float progress, std::string const &)
         {
             progressCallback((3.0f + GenericTextureProgressSteps + progress * CloudTextureProgressSteps) / TotalProgressSteps, "Loading textures...");
@@ -506,64 +585,135 @@ RenderContext::RenderContext(
 
 RenderContext::~RenderContext()
 {
+    // Take back the context, as our OpenGL objects are deleted on this thread
+    StopRenderThread();
+
+    for (GLsync fence : mFrameFences)
+    {
+        glDeleteSync(fence);
+    }
+
     glUseProgram(0u);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
+void RenderContext::StartRenderThread(
+    std::function<void()> makeContextCurrentFunction,
+    std::function<void()> releaseContextFunction)
+{
+    if (!!mRenderThread)
+        return;
+
+    // Make sure that nothing issued so far on this thread is left behind
+    glFinish();
+
+    mRenderThread = std::make_unique<RenderThread>(
+        std::move(makeContextCurrentFunction),
+        std::move(releaseContextFunction));
+}
+
+void RenderContext::StopRenderThread()
+{
+    if (!mRenderThread)
+        return;
+
+    // Replay whatever's been recorded, and get the context back
+    mRenderThread.reset();
+}
+
+void RenderContext::SubmitFrame(std::function<void()> presentFunction)
+{
+    assert(!!mRenderThread);
+
+    mRenderThread->GetRecordingCommandList().Record(std::move(presentFunction));
+
+    mRenderThread->Flush();
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
 void RenderContext::Reset()
 {
-    // Clear ships
-    mShips.clear();
+    WaitForRenderThreadIdle();
+
+    mIsSceneDirty = true;
+
+    // Clear ships - together with their OpenGL objects, but for the VBOs that the
+    // ships of the new world may take over; those nobody took over since the
+    // previous reset are let go of now
+    RunGLSync(
+        [this]()
+        {
+            mShipBufferRecycler.Clear();
+            mShips.clear();
+        });
+
+    mStreamingShipTextureCount = 0;
+
+    // Clear GPU particles
+    mParticleRenderContext->Reset();
 }
 
 void RenderContext::AddShip(
     ShipId shipId,
     size_t pointCount,
+    ImageSize shipStructureSize,
     RgbaImageData texture,
     ShipDefinition::TextureOriginType textureOrigin)
 {
+    WaitForRenderThreadIdle();
+
+    mIsSceneDirty = true;
+
     assert(shipId == mShips.size());
 
-    size_t const newShipCount = mShips.size() + 1;
+    // The ship creates its OpenGL objects right away
+    RunGLSync(
+        [&]()
+        {
+            size_t const newShipCount = mShips.size() + 1;
+
+            // Tell all ships that there's a new ship
+            for (auto & ship : mShips)
+            {
+                ship->SetShipCount(newShipCount);
+            }
+
+            // Add the ship
+            mShips.emplace_back(
+                new ShipRenderContext(
+                    shipId,
+                    newShipCount,
+                    pointCount,
+                    shipStructureSize,
+                    std::move(texture),
+                    textureOrigin,
+                    *mShaderManager,
+                    mShipBufferRecycler,
+                    mGenericTextureAtlasOpenGLHandle,
+                    *mGenericTextureAtlasMetadata,
+                    mRenderStatistics,
+                    mViewModel,
+                    mAmbientLightIntensity,
+                    CalculateWaterColor(),
+                    mWaterContrast,
+                    mWaterLevelOfDetail,
+                    mShipRenderMode,
+                    mDebugShipRenderMode,
+                    mVectorFieldRenderMode,
+                    mShowStressedSprings));
+        });
 
-    // Tell all ships that there's a new ship
-    for (auto & ship : mShips)
+    // The ship's texture is streamed in at each frame from now on
+    if (mShips.back()->IsStreamingShipTexture())
     {
-        ship->SetShipCount(newShipCount);
+        ++mStreamingShipTextureCount;
     }
-
-    // Add the ship
-    mShips.emplace_back(
-        new ShipRenderContext(
-            shipId,
-            newShipCount,
-            pointCount,
-            std::move(texture),
-            textureOrigin,
-            *mShaderManager,
-            mGenericTextureAtlasOpenGLHandle,
-            *mGenericTextureAtlasMetadata,
-            mRenderStatistics,
-            mViewModel,
-            mAmbientLightIntensity,
-            CalculateWaterColor(),
-            mWaterContrast,
-            mWaterLevelOfDetail,
-            mShipRenderMode,
-            mDebugShipRenderMode,
-            mVectorFieldRenderMode,
-            mShowStressedSprings));
 }
 
 RgbImageData RenderContext::TakeScreenshot()
 {
-    //
-    // Flush draw calls
-    //
-
-    glFinish();
-
     //
     // Allocate buffer
     //
@@ -573,52 +723,195 @@ RgbImageData RenderContext::TakeScreenshot()
 
     auto pixelBuffer = std::make_unique<rgbColor[]>(canvasWidth * canvasHeight);
 
-    //
-    // Read pixels
-    //
+    RunGLSync(
+        [&]()
+        {
+            //
+            // Flush draw calls
+            //
 
-    // Alignment is byte
-    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    CheckOpenGLError();
+            glFinish();
 
-    // Read the front buffer
-    glReadBuffer(GL_FRONT);
-    CheckOpenGLError();
+            //
+            // Read pixels
+            //
 
-    // Read
-    glReadPixels(0, 0, canvasWidth, canvasHeight, GL_RGB, GL_UNSIGNED_BYTE, pixelBuffer.get());
-    CheckOpenGLError();
+            // Alignment is byte
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            CheckOpenGLError();
+
+            // Read the front buffer
+            glReadBuffer(GL_FRONT);
+            CheckOpenGLError();
+
+            // Read
+            glReadPixels(0, 0, canvasWidth, canvasHeight, GL_RGB, GL_UNSIGNED_BYTE, pixelBuffer.get());
+            CheckOpenGLError();
+        });
 
     return RgbImageData(
         ImageSize(canvasWidth, canvasHeight),
         std::move(pixelBuffer));
 }
 
+void RenderContext::StartScreenshot()
+{
+    // Make room for this screenshot, if we've already got as many pending as we have buffers
+    if (mPendingScreenshotCount == ScreenshotPixelBufferCount)
+    {
+        LogMessage("WARNING: RenderContext::StartScreenshot(): no free pixel buffers, dropping oldest screenshot");
+
+        DiscardScreenshot();
+    }
+
+    assert(mPendingScreenshotCount < ScreenshotPixelBufferCount);
+
+    ImageSize const screenshotSize(mViewModel.GetCanvasWidth(), mViewModel.GetCanvasHeight());
+
+    RunGL(
+        [this, pixelBufferIndex = mNextScreenshotPixelBuffer, screenshotSize]()
+        {
+            auto & pixelBuffer = mScreenshotPixelBuffers[pixelBufferIndex];
+            if (!pixelBuffer)
+            {
+                GLuint tmpGLuint;
+                glGenBuffers(1, &tmpGLuint);
+                pixelBuffer = tmpGLuint;
+            }
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, *pixelBuffer);
+            CheckOpenGLError();
+
+            // Orphan the previous storage, in case the canvas has been resized
+            glBufferData(
+                GL_PIXEL_PACK_BUFFER,
+                screenshotSize.Width * screenshotSize.Height * sizeof(rgbColor),
+                nullptr,
+                GL_STREAM_READ);
+            CheckOpenGLError();
+
+            // Alignment is byte
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            CheckOpenGLError();
+
+            // Read the frame we've just rendered, before it gets swapped
+            glReadBuffer(GL_BACK);
+            CheckOpenGLError();
+
+            // Start the transfer; this returns immediately
+            glReadPixels(0, 0, screenshotSize.Width, screenshotSize.Height, GL_RGB, GL_UNSIGNED_BYTE, (void*)0);
+            CheckOpenGLError();
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        });
+
+    mScreenshotSizes[mNextScreenshotPixelBuffer] = screenshotSize;
+    mNextScreenshotPixelBuffer = (mNextScreenshotPixelBuffer + 1) % ScreenshotPixelBufferCount;
+    ++mPendingScreenshotCount;
+}
+
+void RenderContext::DiscardScreenshot()
+{
+    if (mPendingScreenshotCount > 0)
+        --mPendingScreenshotCount;
+}
+
+std::optional<RgbImageData> RenderContext::RetrieveScreenshot()
+{
+    if (mPendingScreenshotCount == 0)
+        return std::nullopt;
+
+    size_t const oldestPixelBuffer =
+        (mNextScreenshotPixelBuffer + ScreenshotPixelBufferCount - mPendingScreenshotCount) % ScreenshotPixelBufferCount;
+
+    --mPendingScreenshotCount;
+
+    ImageSize const screenshotSize = mScreenshotSizes[oldestPixelBuffer];
+
+    size_t const pixelCount = static_cast<size_t>(screenshotSize.Width * screenshotSize.Height);
+    auto pixelBuffer = std::make_unique<rgbColor[]>(pixelCount);
+
+    RunGLSync(
+        [&]()
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, *(mScreenshotPixelBuffers[oldestPixelBuffer]));
+            CheckOpenGLError();
+
+            // The transfer was started at an earlier frame, hence this is not expected to wait for long
+            void const * mappedBuffer = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+            if (nullptr == mappedBuffer)
+            {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                throw GameException("Cannot map the screenshot pixel buffer");
+            }
+
+            std::memcpy(pixelBuffer.get(), mappedBuffer, pixelCount * sizeof(rgbColor));
+
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        });
+
+    return RgbImageData(
+        screenshotSize,
+        std::move(pixelBuffer));
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 
 void RenderContext::RenderStart()
 {
-    // Set polygon mode
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-    // Clear canvas - and stencil buffer
-    vec3f const clearColor = mFlatSkyColor.toVec3f() * mAmbientLightIntensity;
-    glClearColor(clearColor.x, clearColor.y, clearColor.z, 1.0f);
-    glClearStencil(0x00);
-    glStencilMask(0xFF);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    // Wait for the previous frame to be done with the buffers that we're about to re-populate
+    WaitForRenderThreadIdle();
 
-    if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    RunGL(
+        [this]()
+        {
+            // Trace the GPU timings of previous frames
+            mGPUTimerQueries->CollectResults();
+            mGPUTimerQueries->BeginScope("Frame");
+
+            // Choose where to render the world into
+            UpdateCurrentWorldRenderScale();
+            mIsWorldRenderedOffscreen = false;
+            if (mCurrentWorldRenderScale < 1.0f)
+            {
+                ImageSize const worldRenderSize(
+                    std::max(1, static_cast<int>(std::round(static_cast<float>(mViewModel.GetCanvasWidth()) * mCurrentWorldRenderScale))),
+                    std::max(1, static_cast<int>(std::round(static_cast<float>(mViewModel.GetCanvasHeight()) * mCurrentWorldRenderScale))));
+
+                if (PrepareWorldFramebuffer(worldRenderSize))
+                {
+                    glBindFramebuffer(GL_FRAMEBUFFER, *mWorldFramebuffer);
+                    glViewport(0, 0, worldRenderSize.Width, worldRenderSize.Height);
+
+                    mIsWorldRenderedOffscreen = true;
+                }
+            }
+
+            mWorldGPUTimer->Begin();
+
+            // Set polygon mode
+            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+            // Clear canvas - and stencil buffer
+            vec3f const clearColor = mFlatSkyColor.toVec3f() * mAmbientLightIntensity;
+            glClearColor(clearColor.x, clearColor.y, clearColor.z, 1.0f);
+            glClearStencil(0x00);
+            glStencilMask(0xFF);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+            if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
+                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+            // Communicate start to child contextes
+            mTextRenderContext->RenderStart();
+
+            // Reset stats
+            mRenderStatistics.Reset();
+        });
 
     // Reset crosses of light, they are uploaded as needed
     mCrossOfLightVertexBuffer.clear();
-
-    // Communicate start to child contextes
-    mTextRenderContext->RenderStart();
-
-    // Reset stats
-    mRenderStatistics.Reset();
 }
 
 void RenderContext::RenderSkyStart()
@@ -634,10 +927,14 @@ void RenderContext::UploadStarsStart(size_t starCount)
     if (starCount != mStarVertexBuffer.max_size())
     {
         // Reallocate GPU buffer
-        glBindBuffer(GL_ARRAY_BUFFER, *mStarVBO);
-        glBufferData(GL_ARRAY_BUFFER, starCount * sizeof(StarVertex), nullptr, GL_STATIC_DRAW);
-        CheckOpenGLError();
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        RunGL(
+            [this, starCount]()
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, *mStarVBO);
+                glBufferData(GL_ARRAY_BUFFER, starCount * sizeof(StarVertex), nullptr, GL_STATIC_DRAW);
+                CheckOpenGLError();
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            });
 
         // Reallocate CPU buffer
         mStarVertexBuffer.reset(starCount);
@@ -654,132 +951,144 @@ void RenderContext::UploadStarsEnd()
     // Upload star vertex buffer
     //
 
-    glBindBuffer(GL_ARRAY_BUFFER, *mStarVBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, mStarVertexBuffer.size() * sizeof(StarVertex), mStarVertexBuffer.data());
-    CheckOpenGLError();
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    RunGL(
+        [this]()
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, *mStarVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, mStarVertexBuffer.size() * sizeof(StarVertex), mStarVertexBuffer.data());
+            CheckOpenGLError();
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        });
 }
 
 void RenderContext::UploadCloudsStart(size_t cloudCount)
 {
-    if (cloudCount > 0)
-    {
-        //
-        // Prepare cloud quad buffer
-        //
+    mCloudInstanceBuffer.clear();
+    mCloudInstanceBuffer.reserve(cloudCount);
+}
 
-        glBindBuffer(GL_ARRAY_BUFFER, *mCloudVBO);
+void RenderContext::UploadCloudsEnd()
+{
+    //
+    // Upload cloud instance buffer
+    //
 
-        glBufferData(GL_ARRAY_BUFFER, cloudCount * sizeof(CloudQuad), nullptr, GL_STREAM_DRAW);
-        CheckOpenGLError();
+    RunGL(
+        [this]()
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, *mCloudInstanceVBO);
 
-        mCloudQuadBuffer.map(cloudCount);
+            glBufferData(GL_ARRAY_BUFFER, mCloudInstanceBuffer.size() * sizeof(CloudInstance), mCloudInstanceBuffer.data(), GL_STATIC_DRAW);
+            CheckOpenGLError();
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-    }
-    else
-    {
-        mCloudQuadBuffer.reset();
-    }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            mCloudInstanceCount = mCloudInstanceBuffer.size();
+        });
 }
 
-void RenderContext::UploadCloudsEnd()
+void RenderContext::UploadCloudsAnimation(
+    float currentSimulationTime,
+    float cloudSpeed)
 {
-    if (mCloudQuadBuffer.size() > 0)
-    {
-        //
-        // Upload cloud quad buffer
-        //
-
-        glBindBuffer(GL_ARRAY_BUFFER, *mCloudVBO);
+    RunGL(
+        [this, currentSimulationTime, cloudSpeed]()
+        {
+            mShaderManager->ActivateProgram<ProgramType::Clouds>();
 
-        mCloudQuadBuffer.unmap();
+            mShaderManager->SetProgramParameter<ProgramType::Clouds, ProgramParameterType::CurrentSimulationTime>(
+                currentSimulationTime);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-    }
+            mShaderManager->SetProgramParameter<ProgramType::Clouds, ProgramParameterType::CloudSpeed>(
+                cloudSpeed);
+        });
 }
 
 void RenderContext::RenderSkyEnd()
 {
-    ////////////////////////////////////////////////////
-    // Draw ocean stencil
-    ////////////////////////////////////////////////////
+    RunGL(
+        [this]()
+        {
+            ////////////////////////////////////////////////////
+            // Draw ocean stencil
+            ////////////////////////////////////////////////////
 
-    // Enable stencil test
-    glEnable(GL_STENCIL_TEST);
+            // Enable stencil test
+            glEnable(GL_STENCIL_TEST);
 
-    // Disable writing to the color buffer
-    glColorMask(false, false, false, false);
+            // Disable writing to the color buffer
+            glColorMask(false, false, false, false);
 
-    // Write all one's to stencil buffer
-    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-    glStencilFunc(GL_ALWAYS, 1, 0xFF);
-    glStencilMask(0xFF);
+            // Write all one's to stencil buffer
+            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+            glStencilFunc(GL_ALWAYS, 1, 0xFF);
+            glStencilMask(0xFF);
 
-    //
-    // Draw ocean
-    //
+            //
+            // Draw ocean
+            //
 
-    glBindVertexArray(*mOceanVAO);
+            glBindVertexArray(*mOceanVAO);
 
-    // Use matte ocean program
-    mShaderManager->ActivateProgram<ProgramType::MatteOcean>();
+            // Use matte ocean program
+            mShaderManager->ActivateProgram<ProgramType::MatteOcean>();
 
-    // Make sure polygons are filled in any case
-    if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+            // Make sure polygons are filled in any case
+            if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
+                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(2 * mOceanSegmentBuffer.size()));
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(2 * mOceanSegmentBuffer.size()));
 
-    // Don't write anything to stencil buffer now
-    glStencilMask(0x00);
+            // Don't write anything to stencil buffer now
+            glStencilMask(0x00);
 
-    // Re-enable writing to the color buffer
-    glColorMask(true, true, true, true);
+            // Re-enable writing to the color buffer
+            glColorMask(true, true, true, true);
 
-    // Reset wireframe mode, if enabled
-    if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+            // Reset wireframe mode, if enabled
+            if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
+                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-    // Enable stenciling - now only draw where there are no 1's
-    glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
+            // Enable stenciling - now only draw where there are no 1's
+            glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
 
-    ////////////////////////////////////////////////////
-    // Draw stars with stencil test
-    ////////////////////////////////////////////////////
+            ////////////////////////////////////////////////////
+            // Draw stars with stencil test
+            ////////////////////////////////////////////////////
 
-    glBindVertexArray(*mStarVAO);
+            glBindVertexArray(*mStarVAO);
 
-    mShaderManager->ActivateProgram<ProgramType::Stars>();
+            mShaderManager->ActivateProgram<ProgramType::Stars>();
 
-    glPointSize(0.5f);
+            glPointSize(0.5f);
 
-    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(mStarVertexBuffer.size()));
-    CheckOpenGLError();
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(mStarVertexBuffer.size()));
+            CheckOpenGLError();
 
-    ////////////////////////////////////////////////////
-    // Draw clouds with stencil test
-    ////////////////////////////////////////////////////
+            ////////////////////////////////////////////////////
+            // Draw clouds with stencil test
+            ////////////////////////////////////////////////////
 
-    if (mCloudQuadBuffer.size() > 0)
-    {
-        glBindVertexArray(*mCloudVAO);
+            if (mCloudInstanceCount > 0)
+            {
+                glBindVertexArray(*mCloudVAO);
 
-        mShaderManager->ActivateProgram<ProgramType::Clouds>();
+                mShaderManager->ActivateProgram<ProgramType::Clouds>();
 
-        if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
-            glLineWidth(0.1f);
+                if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
+                    glLineWidth(0.1f);
 
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(6 * mCloudQuadBuffer.size()));
-        CheckOpenGLError();
-    }
+                glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(mCloudInstanceCount));
+                CheckOpenGLError();
+            }
 
-    ////////////////////////////////////////////////////
+            ////////////////////////////////////////////////////
 
-    glBindVertexArray(0);
+            glBindVertexArray(0);
 
-    // Disable stencil test
-    glDisable(GL_STENCIL_TEST);
+            // Disable stencil test
+            glDisable(GL_STENCIL_TEST);
+        });
 }
 
 void RenderContext::UploadLandStart(size_t slices)
@@ -788,19 +1097,36 @@ void RenderContext::UploadLandStart(size_t slices)
     // Prepare land segment buffer
     //
 
-    glBindBuffer(GL_ARRAY_BUFFER, *mLandVBO);
+    RunGL(
+        [this, slices]()
+        {
+            if (slices + 1 != mLandSegmentBufferAllocatedSize)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, *mLandVBO);
 
-    if (slices + 1 != mLandSegmentBufferAllocatedSize)
-    {
-        glBufferData(GL_ARRAY_BUFFER, (slices + 1) * sizeof(LandSegment), nullptr, GL_STREAM_DRAW);
-        CheckOpenGLError();
+                // Land is only re-uploaded when it or the view change, and drawn at each frame
+                glBufferData(GL_ARRAY_BUFFER, (slices + 1) * sizeof(LandSegment), nullptr, GL_DYNAMIC_DRAW);
+                CheckOpenGLError();
 
-        mLandSegmentBufferAllocatedSize = slices + 1;
-    }
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    mLandSegmentBuffer.map(slices + 1);
+                mLandSegmentBufferAllocatedSize = slices + 1;
+            }
+        });
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!mRenderThread)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, *mLandVBO);
+
+        mLandSegmentBuffer.map(slices + 1);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+    {
+        // The buffer may only be mapped on the render thread
+        mLandSegmentBuffer.map_staged(slices + 1);
+    }
 }
 
 void RenderContext::UploadLandEnd()
@@ -809,38 +1135,95 @@ void RenderContext::UploadLandEnd()
     // Upload land segment buffer
     //
 
-    glBindBuffer(GL_ARRAY_BUFFER, *mLandVBO);
+    if (!mLandSegmentBuffer.is_staged())
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, *mLandVBO);
 
-    mLandSegmentBuffer.unmap();
+        mLandSegmentBuffer.unmap();
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+    {
+        mLandSegmentBuffer.unmap();
+
+        RunGL(
+            [this]()
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, *mLandVBO);
+
+                mLandSegmentBuffer.upload_staged();
+
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            });
+    }
 }
 
-void RenderContext::RenderLand()
+void RenderContext::UploadLandRangeStart(size_t firstSegment)
 {
-    glBindVertexArray(*mLandVAO);
+    assert(firstSegment < mLandSegmentBuffer.size());
 
-    switch (mLandRenderMode)
-    {
-        case LandRenderMode::Flat:
+    mLandSegmentRangeBuffer.clear();
+    mLandSegmentRangeFirstSegment = firstSegment;
+}
+
+void RenderContext::UploadLandRangeEnd()
+{
+    //
+    // Upload just the range over the land segments uploaded last
+    //
+
+    if (mLandSegmentRangeBuffer.empty())
+        return;
+
+    RunGL(
+        [this,
+        firstSegment = mLandSegmentRangeFirstSegment,
+        segmentCount = mLandSegmentRangeBuffer.size(),
+        segments = CopyForRenderThread(mLandSegmentRangeBuffer.data(), mLandSegmentRangeBuffer.size())]()
         {
-            mShaderManager->ActivateProgram<ProgramType::LandFlat>();
-            break;
-        }
+            glBindBuffer(GL_ARRAY_BUFFER, *mLandVBO);
+
+            glBufferSubData(
+                GL_ARRAY_BUFFER,
+                firstSegment * sizeof(LandSegment),
+                segmentCount * sizeof(LandSegment),
+                segments);
+            CheckOpenGLError();
+
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        });
+}
 
-        case LandRenderMode::Texture:
+void RenderContext::RenderLand()
+{
+    RunGL(
+        [this]()
         {
-            mShaderManager->ActivateProgram<ProgramType::LandTexture>();
-            break;
-        }
-    }
+            glBindVertexArray(*mLandVAO);
 
-    if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
-        glLineWidth(0.1f);
+            switch (mLandRenderMode)
+            {
+                case LandRenderMode::Flat:
+                {
+                    mShaderManager->ActivateProgram<ProgramType::LandFlat>();
+                    break;
+                }
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(2 * mLandSegmentBuffer.size()));
+                case LandRenderMode::Texture:
+                {
+                    mShaderManager->ActivateProgram<ProgramType::LandTexture>();
+                    break;
+                }
+            }
 
-    glBindVertexArray(0);
+            if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
+                glLineWidth(0.1f);
+
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(2 * mLandSegmentBuffer.size()));
+
+            glBindVertexArray(0);
+        });
 }
 
 void RenderContext::UploadOceanStart(size_t slices)
@@ -849,19 +1232,35 @@ void RenderContext::UploadOceanStart(size_t slices)
     // Prepare ocean segment buffer
     //
 
-    glBindBuffer(GL_ARRAY_BUFFER, *mOceanVBO);
+    RunGL(
+        [this, slices]()
+        {
+            if (slices + 1 != mOceanSegmentBufferAllocatedSize)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, *mOceanVBO);
 
-    if (slices + 1 != mOceanSegmentBufferAllocatedSize)
-    {
-        glBufferData(GL_ARRAY_BUFFER, (slices + 1) * sizeof(OceanSegment), nullptr, GL_STREAM_DRAW);
-        CheckOpenGLError();
+                glBufferData(GL_ARRAY_BUFFER, (slices + 1) * sizeof(OceanSegment), nullptr, GL_STREAM_DRAW);
+                CheckOpenGLError();
 
-        mOceanSegmentBufferAllocatedSize = slices + 1;
-    }
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+                mOceanSegmentBufferAllocatedSize = slices + 1;
+            }
+        });
 
-    mOceanSegmentBuffer.map(slices + 1);
+    if (!mRenderThread)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, *mOceanVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        mOceanSegmentBuffer.map(slices + 1);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+    {
+        // The buffer may only be mapped on the render thread
+        mOceanSegmentBuffer.map_staged(slices + 1);
+    }
 }
 
 void RenderContext::UploadOceanEnd()
@@ -870,77 +1269,226 @@ void RenderContext::UploadOceanEnd()
     // Upload ocean segment buffer
     //
 
-    glBindBuffer(GL_ARRAY_BUFFER, *mOceanVBO);
+    if (!mOceanSegmentBuffer.is_staged())
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, *mOceanVBO);
 
-    mOceanSegmentBuffer.unmap();
+        mOceanSegmentBuffer.unmap();
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+    {
+        mOceanSegmentBuffer.unmap();
+
+        RunGL(
+            [this]()
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, *mOceanVBO);
+
+                mOceanSegmentBuffer.upload_staged();
+
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            });
+    }
 }
 
 void RenderContext::RenderOcean()
 {
-    glBindVertexArray(*mOceanVAO);
-
-    switch (mOceanRenderMode)
-    {
-        case OceanRenderMode::Depth:
+    RunGL(
+        [this]()
         {
-            mShaderManager->ActivateProgram<ProgramType::OceanDepth>();
-            break;
-        }
+            glBindVertexArray(*mOceanVAO);
+
+            switch (mOceanRenderMode)
+            {
+                case OceanRenderMode::Depth:
+                {
+                    mShaderManager->ActivateProgram<ProgramType::OceanDepth>();
+                    break;
+                }
+
+                case OceanRenderMode::Flat:
+                {
+                    mShaderManager->ActivateProgram<ProgramType::OceanFlat>();
+                    break;
+                }
+
+                case OceanRenderMode::Texture:
+                {
+                    mShaderManager->ActivateProgram<ProgramType::OceanTexture>();
+                    break;
+                }
+            }
+
+            if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
+                glLineWidth(0.1f);
+
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(2 * mOceanSegmentBuffer.size()));
+
+            glBindVertexArray(0);
+        });
+}
 
-        case OceanRenderMode::Flat:
+void RenderContext::RenderShipsStart()
+{
+    RunGL(
+        []()
         {
-            mShaderManager->ActivateProgram<ProgramType::OceanFlat>();
-            break;
-        }
+            // Enable depth test, required by ships
+            glEnable(GL_DEPTH_TEST);
+        });
+}
 
-        case OceanRenderMode::Texture:
+void RenderContext::RenderShipsEnd()
+{
+    RunGL(
+        [this]()
         {
-            mShaderManager->ActivateProgram<ProgramType::OceanTexture>();
-            break;
-        }
-    }
+            //
+            // Stream in the next slices of the textures of the ships that have just been added
+            //
 
-    if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
-        glLineWidth(0.1f);
+            if (mStreamingShipTextureCount.load(std::memory_order_relaxed) > 0)
+            {
+                ScopedGPUTimer const gpuTimer(*mGPUTimerQueries, "ShipTextureStreaming");
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(2 * mOceanSegmentBuffer.size()));
+                size_t streamingShipTextureCount = 0;
+                for (auto & ship : mShips)
+                {
+                    if (ship->StreamShipTexture())
+                        ++streamingShipTextureCount;
+                }
 
-    glBindVertexArray(0);
-}
+                mStreamingShipTextureCount.store(streamingShipTextureCount, std::memory_order_relaxed);
+            }
 
-void RenderContext::RenderShipsStart()
-{
-    // Enable depth test, required by ships
-    glEnable(GL_DEPTH_TEST);
+            //
+            // Draw one element type at a time across all ships, so that each program
+            // is activated once per element type; the depth test keeps each ship in its
+            // own Z segment
+            //
+
+            {
+                ScopedGPUTimer const gpuTimer(*mGPUTimerQueries, "ShipTriangles");
+
+                for (auto & ship : mShips)
+                    ship->RenderTriangles();
+            }
+
+            {
+                ScopedGPUTimer const gpuTimer(*mGPUTimerQueries, "ShipRopes");
+
+                for (auto & ship : mShips)
+                    ship->RenderRopes();
+            }
+
+            {
+                ScopedGPUTimer const gpuTimer(*mGPUTimerQueries, "ShipSprings");
+
+                for (auto & ship : mShips)
+                    ship->RenderSprings();
+            }
+
+            {
+                ScopedGPUTimer const gpuTimer(*mGPUTimerQueries, "ShipStressedSprings");
+
+                for (auto & ship : mShips)
+                    ship->RenderStressedSprings();
+            }
+
+            {
+                ScopedGPUTimer const gpuTimer(*mGPUTimerQueries, "ShipPoints");
+
+                for (auto & ship : mShips)
+                    ship->RenderPoints();
+            }
+
+            {
+                ScopedGPUTimer const gpuTimer(*mGPUTimerQueries, "ShipGenerics");
+
+                for (auto & ship : mShips)
+                    ship->RenderEnd();
+            }
+
+            // Disable depth test
+            glDisable(GL_DEPTH_TEST);
+        });
 }
 
-void RenderContext::RenderShipsEnd()
+void RenderContext::RenderEnd()
 {
-    // Disable depth test
-    glDisable(GL_DEPTH_TEST);
+    RunGL(
+        [this]()
+        {
+            // Render crosses of light
+            if (!mCrossOfLightVertexBuffer.empty())
+            {
+                RenderCrossesOfLight();
+            }
+
+            // Render world end
+            RenderWorldBorder();
+
+            mWorldGPUTimer->End();
+
+            // Upscale the world onto the canvas, under the text
+            if (mIsWorldRenderedOffscreen)
+            {
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, *mWorldFramebuffer);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+                glBlitFramebuffer(
+                    0, 0, mWorldFramebufferSize.Width, mWorldFramebufferSize.Height,
+                    0, 0, mViewModel.GetCanvasWidth(), mViewModel.GetCanvasHeight(),
+                    GL_COLOR_BUFFER_BIT,
+                    GL_LINEAR);
+
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glViewport(0, 0, mViewModel.GetCanvasWidth(), mViewModel.GetCanvasHeight());
+            }
+
+            // Communicate end to child contextes
+            mTextRenderContext->RenderEnd();
+
+            mGPUTimerQueries->EndScope();
+
+            // Surface any error of this frame, as in release builds we don't check each call
+            CheckOpenGLFrameError();
+
+            // Flush all pending commands (but not the GPU buffer)
+            GameOpenGL::Flush();
+
+            // Don't let the GPU lag behind by more frames than we're allowed to
+            FenceFrame();
+        });
+
+    mIsSceneDirty = false;
 }
 
-void RenderContext::RenderEnd()
+////////////////////////////////////////////////////////////////////////////////////
+
+void RenderContext::FenceFrame()
 {
-    // Render crosses of light
-    if (!mCrossOfLightVertexBuffer.empty())
+    if (NULL == glFenceSync)
     {
-        RenderCrossesOfLight();
+        // Can't tell when frames complete, leave it to the driver
+        return;
     }
 
-    // Render world end
-    RenderWorldBorder();
+    mFrameFences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
 
-    // Communicate end to child contextes
-    mTextRenderContext->RenderEnd();
+    while (mFrameFences.size() > mMaxFramesInFlight)
+    {
+        // Wait for the oldest frame; we don't wait forever though, as a lost
+        // frame is better than a hung game
+        static constexpr GLuint64 FrameTimeoutNanoseconds = 1000000000ull;
 
-    // Flush all pending commands (but not the GPU buffer)
-    GameOpenGL::Flush();
-}
+        glClientWaitSync(mFrameFences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, FrameTimeoutNanoseconds);
 
-////////////////////////////////////////////////////////////////////////////////////
+        glDeleteSync(mFrameFences.front());
+        mFrameFences.pop_front();
+    }
+}
 
 void RenderContext::RenderCrossesOfLight()
 {
@@ -992,6 +1540,97 @@ void RenderContext::RenderWorldBorder()
 
 ////////////////////////////////////////////////////////////////////////////////////
 
+void RenderContext::UpdateCurrentWorldRenderScale()
+{
+    if (!mDoAdaptWorldRenderScale || !GameOpenGLElapsedTimer::IsSupported())
+    {
+        mCurrentWorldRenderScale = mWorldRenderScale;
+        return;
+    }
+
+    auto const worldGPUMillis = mWorldGPUTimer->CollectLatestMillis();
+    if (!worldGPUMillis)
+        return;
+
+    // What we aim to spend on the world, leaving room for the rest of a 60fps frame
+    static constexpr float TargetWorldGPUMillis = 8.0f;
+
+    // The scales we move along, one at a time, so that there's some hysteresis and
+    // so that we're not re-allocating the framebuffer at each frame
+    static constexpr float ScaleStep = 0.05f;
+
+    // The cost goes with the area, i.e. with the square of the scale
+    float const targetScale =
+        mCurrentWorldRenderScale
+        * std::sqrt(TargetWorldGPUMillis / std::max(*worldGPUMillis, 0.01f));
+
+    if (targetScale < mCurrentWorldRenderScale - ScaleStep)
+        mCurrentWorldRenderScale -= ScaleStep;
+    else if (targetScale > mCurrentWorldRenderScale + ScaleStep)
+        mCurrentWorldRenderScale += ScaleStep;
+
+    mCurrentWorldRenderScale = std::clamp(mCurrentWorldRenderScale, MinWorldRenderScale, mWorldRenderScale);
+}
+
+bool RenderContext::PrepareWorldFramebuffer(ImageSize const & size)
+{
+    if (nullptr == glBlitFramebuffer)
+    {
+        // Not supported
+        return false;
+    }
+
+    if (!!mWorldFramebuffer && mWorldFramebufferSize == size)
+    {
+        return true;
+    }
+
+    if (!mWorldFramebuffer)
+    {
+        GLuint tmpGLuint;
+
+        glGenFramebuffers(1, &tmpGLuint);
+        mWorldFramebuffer = tmpGLuint;
+
+        glGenRenderbuffers(1, &tmpGLuint);
+        mWorldColorRenderbuffer = tmpGLuint;
+
+        glGenRenderbuffers(1, &tmpGLuint);
+        mWorldDepthStencilRenderbuffer = tmpGLuint;
+    }
+
+    glBindRenderbuffer(GL_RENDERBUFFER, *mWorldColorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size.Width, size.Height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, *mWorldDepthStencilRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size.Width, size.Height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, *mWorldFramebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, *mWorldColorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, *mWorldDepthStencilRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, *mWorldDepthStencilRenderbuffer);
+
+    GLenum const framebufferStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (GL_FRAMEBUFFER_COMPLETE != framebufferStatus)
+    {
+        LogMessage("WARNING: RenderContext::PrepareWorldFramebuffer(): the framebuffer is incomplete (", framebufferStatus, "), rendering at the canvas resolution");
+
+        // Don't try again
+        mWorldRenderScale = 1.0f;
+        mCurrentWorldRenderScale = 1.0f;
+        return false;
+    }
+
+    mWorldFramebufferSize = size;
+
+    return true;
+}
+
 void RenderContext::OnViewModelUpdated()
 {
     //
@@ -1036,6 +1675,8 @@ void RenderContext::OnViewModelUpdated()
     mShaderManager->SetProgramParameter<ProgramType::WorldBorder, ProgramParameterType::OrthoMatrix>(
         globalOrthoMatrix);
 
+    mParticleRenderContext->OnViewModelUpdated();
+
     //
     // Update canvas size
     //
@@ -1045,6 +1686,11 @@ void RenderContext::OnViewModelUpdated()
         static_cast<float>(mViewModel.GetCanvasWidth()),
         static_cast<float>(mViewModel.GetCanvasHeight()));
 
+    mShaderManager->ActivateProgram<ProgramType::Clouds>();
+    mShaderManager->SetProgramParameter<ProgramType::Clouds, ProgramParameterType::ViewportSize>(
+        static_cast<float>(mViewModel.GetCanvasWidth()),
+        static_cast<float>(mViewModel.GetCanvasHeight()));
+
     //
     // Update all ships
     //
@@ -1103,6 +1749,9 @@ void RenderContext::OnAmbientLightIntensityUpdated()
         ship->SetAmbientLightIntensity(mAmbientLightIntensity);
     }
 
+    // Update GPU particles
+    mParticleRenderContext->SetAmbientLightIntensity(mAmbientLightIntensity);
+
     // Update text context
     mTextRenderContext->UpdateAmbientLightIntensity(mAmbientLightIntensity);
 }
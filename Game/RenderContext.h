@@ -5,17 +5,22 @@
 ***************************************************************************************/
 #pragma once
 
+#include "ParticleRenderContext.h"
 #include "RenderCore.h"
+#include "RenderThread.h"
 #include "ResourceLoader.h"
 #include "ShipDefinition.h"
 #include "ShipRenderContext.h"
+#include "SimulationView.h"
 #include "TextRenderContext.h"
 #include "TextureAtlas.h"
 #include "TextureRenderManager.h"
 #include "ViewModel.h"
 
 #include <GameOpenGL/GameOpenGL.h>
+#include <GameOpenGL/GameOpenGLBufferRecycler.h>
 #include <GameOpenGL/GameOpenGLMappedBuffer.h>
+#include <GameOpenGL/GameOpenGLTimerQueries.h>
 #include <GameOpenGL/ShaderManager.h>
 
 #include <Game/GameParameters.h>
@@ -28,9 +33,14 @@
 #include <GameCore/SysSpecifics.h>
 #include <GameCore/Vectors.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -64,9 +74,13 @@ public:
 
     float SetZoom(float zoom)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         auto const newZoom = mViewModel.SetZoom(zoom);
 
-        OnViewModelUpdated();
+        RunGL([this]() { OnViewModelUpdated(); });
 
         return newZoom;
     }
@@ -83,9 +97,13 @@ public:
 
     vec2f SetCameraWorldPosition(vec2f const & pos)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         auto const newCameraWorldPosition = mViewModel.SetCameraWorldPosition(pos);
 
-        OnViewModelUpdated();
+        RunGL([this]() { OnViewModelUpdated(); });
 
         return newCameraWorldPosition;
     }
@@ -102,13 +120,21 @@ public:
 
     void SetCanvasSize(int width, int height)
     {
-        mViewModel.SetCanvasSize(width, height);
+        WaitForRenderThreadIdle();
 
-        glViewport(0, 0, mViewModel.GetCanvasWidth(), mViewModel.GetCanvasHeight());
+        mIsSceneDirty = true;
+
+        mViewModel.SetCanvasSize(width, height);
 
         mTextRenderContext->UpdateCanvasSize(mViewModel.GetCanvasWidth(), mViewModel.GetCanvasHeight());
 
-        OnViewModelUpdated();
+        RunGL(
+            [this]()
+            {
+                glViewport(0, 0, mViewModel.GetCanvasWidth(), mViewModel.GetCanvasHeight());
+
+                OnViewModelUpdated();
+            });
     }
 
     float GetVisibleWorldWidth() const
@@ -141,6 +167,34 @@ public:
         return mViewModel.GetVisibleWorldBottomRight().y;
     }
 
+    SimulationView GetSimulationView() const
+    {
+        return SimulationView(
+            GetVisibleWorldLeft(),
+            GetVisibleWorldRight(),
+            GetVisibleWorldTop(),
+            GetVisibleWorldBottom(),
+            mVectorFieldRenderMode == VectorFieldRenderMode::PointForce);
+    }
+
+    /*
+     * Adds the buffers and textures of the ships to the report; to be invoked at
+     * the root of the report.
+     */
+    void ReportMemory(MemoryReport & report) const
+    {
+        WaitForRenderThreadIdle();
+
+        for (auto const & ship : mShips)
+        {
+            ship->ReportMemory(report);
+        }
+
+        report.PushSection("GPU");
+        report.Add("RecycledShipVBOs", mShipBufferRecycler.GetRetainedByteSize());
+        report.PopSection();
+    }
+
     //
 
     rgbColor const & GetFlatSkyColor() const
@@ -150,6 +204,10 @@ public:
 
     void SetFlatSkyColor(rgbColor const & color)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mFlatSkyColor = color;
 
         // No need to notify anyone
@@ -162,9 +220,13 @@ public:
 
     void SetAmbientLightIntensity(float intensity)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mAmbientLightIntensity = intensity;
 
-        OnAmbientLightIntensityUpdated();
+        RunGL([this]() { OnAmbientLightIntensityUpdated(); });
     }
 
     float GetOceanTransparency() const
@@ -174,9 +236,13 @@ public:
 
     void SetOceanTransparency(float transparency)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mOceanTransparency = transparency;
 
-        OnOceanTransparencyUpdated();
+        RunGL([this]() { OnOceanTransparencyUpdated(); });
     }
 
     bool GetShowShipThroughOcean() const
@@ -186,9 +252,52 @@ public:
 
     void SetShowShipThroughOcean(bool showShipThroughOcean)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mShowShipThroughOcean = showShipThroughOcean;
     }
 
+    /*
+     * The resolution at which the world is rendered, relative to the canvas; below 1.0 the
+     * world is rendered offscreen and upscaled onto the canvas, while text is always rendered
+     * at the resolution of the canvas. When adaptive, this is the highest scale used, and
+     * the actual one follows how long the GPU takes to render the world.
+     */
+    static constexpr float MinWorldRenderScale = 0.5f;
+    static constexpr float MaxWorldRenderScale = 1.0f;
+
+    float GetWorldRenderScale() const
+    {
+        return mWorldRenderScale;
+    }
+
+    void SetWorldRenderScale(float worldRenderScale)
+    {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
+        mWorldRenderScale = std::clamp(worldRenderScale, MinWorldRenderScale, MaxWorldRenderScale);
+        mCurrentWorldRenderScale = mWorldRenderScale;
+    }
+
+    bool GetDoAdaptWorldRenderScale() const
+    {
+        return mDoAdaptWorldRenderScale;
+    }
+
+    void SetDoAdaptWorldRenderScale(bool doAdaptWorldRenderScale)
+    {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
+        mDoAdaptWorldRenderScale = doAdaptWorldRenderScale;
+        mCurrentWorldRenderScale = mWorldRenderScale;
+    }
+
     OceanRenderMode GetOceanRenderMode() const
     {
         return mOceanRenderMode;
@@ -196,9 +305,13 @@ public:
 
     void SetOceanRenderMode(OceanRenderMode oceanRenderMode)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mOceanRenderMode = oceanRenderMode;
 
-        OnOceanRenderParametersUpdated();
+        RunGL([this]() { OnOceanRenderParametersUpdated(); });
     }
 
     rgbColor const & GetDepthOceanColorStart() const
@@ -208,9 +321,13 @@ public:
 
     void SetDepthOceanColorStart(rgbColor const & color)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mDepthOceanColorStart = color;
 
-        OnOceanRenderParametersUpdated();
+        RunGL([this]() { OnOceanRenderParametersUpdated(); });
     }
 
     rgbColor const & GetDepthOceanColorEnd() const
@@ -220,9 +337,13 @@ public:
 
     void SetDepthOceanColorEnd(rgbColor const & color)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mDepthOceanColorEnd = color;
 
-        OnOceanRenderParametersUpdated();
+        RunGL([this]() { OnOceanRenderParametersUpdated(); });
     }
 
     rgbColor const & GetFlatOceanColor() const
@@ -232,9 +353,13 @@ public:
 
     void SetFlatOceanColor(rgbColor const & color)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mFlatOceanColor = color;
 
-        OnOceanRenderParametersUpdated();
+        RunGL([this]() { OnOceanRenderParametersUpdated(); });
     }
 
     LandRenderMode GetLandRenderMode() const
@@ -244,9 +369,13 @@ public:
 
     void SetLandRenderMode(LandRenderMode landRenderMode)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mLandRenderMode = landRenderMode;
 
-        OnLandRenderParametersUpdated();
+        RunGL([this]() { OnLandRenderParametersUpdated(); });
     }
 
     rgbColor const & GetFlatLandColor() const
@@ -256,9 +385,13 @@ public:
 
     void SetFlatLandColor(rgbColor const & color)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mFlatLandColor = color;
 
-        OnLandRenderParametersUpdated();
+        RunGL([this]() { OnLandRenderParametersUpdated(); });
     }
 
     float GetWaterContrast() const
@@ -268,9 +401,13 @@ public:
 
     void SetWaterContrast(float contrast)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mWaterContrast = contrast;
 
-        OnWaterContrastUpdated();
+        RunGL([this]() { OnWaterContrastUpdated(); });
     }
 
     float GetWaterLevelOfDetail() const
@@ -280,9 +417,13 @@ public:
 
     void SetWaterLevelOfDetail(float levelOfDetail)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mWaterLevelOfDetail = levelOfDetail;
 
-        OnWaterLevelOfDetailUpdated();
+        RunGL([this]() { OnWaterLevelOfDetailUpdated(); });
     }
 
     static constexpr float MinWaterLevelOfDetail = 0.0f;
@@ -299,9 +440,13 @@ public:
 
     void SetShipRenderMode(ShipRenderMode shipRenderMode)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mShipRenderMode = shipRenderMode;
 
-        OnShipRenderModeUpdated();
+        RunGL([this]() { OnShipRenderModeUpdated(); });
     }
 
     DebugShipRenderMode GetDebugShipRenderMode() const
@@ -311,9 +456,13 @@ public:
 
     void SetDebugShipRenderMode(DebugShipRenderMode debugShipRenderMode)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mDebugShipRenderMode = debugShipRenderMode;
 
-        OnDebugShipRenderModeUpdated();
+        RunGL([this]() { OnDebugShipRenderModeUpdated(); });
     }
 
 
@@ -324,9 +473,13 @@ public:
 
     void SetVectorFieldRenderMode(VectorFieldRenderMode vectorFieldRenderMode)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mVectorFieldRenderMode = vectorFieldRenderMode;
 
-        OnVectorFieldRenderModeUpdated();
+        RunGL([this]() { OnVectorFieldRenderModeUpdated(); });
     }
 
     float GetVectorFieldLengthMultiplier() const
@@ -336,6 +489,10 @@ public:
 
     void SetVectorFieldLengthMultiplier(float vectorFieldLengthMultiplier)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mVectorFieldLengthMultiplier = vectorFieldLengthMultiplier;
     }
 
@@ -346,9 +503,13 @@ public:
 
     void SetShowStressedSprings(bool showStressedSprings)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         mShowStressedSprings = showStressedSprings;
 
-        OnShowStressedSpringsUpdated();
+        RunGL([this]() { OnShowStressedSpringsUpdated(); });
     }
 
     //
@@ -369,11 +530,76 @@ public:
     // Statistics
     //
 
+    /*
+     * With the render thread, these are the statistics of the last frame that the render
+     * thread has replayed.
+     */
     RenderStatistics const & GetStatistics() const
     {
+        WaitForRenderThreadIdle();
+
         return mRenderStatistics;
     }
 
+    /*
+     * Whether any of the render parameters, the view, the ships, or the text have changed
+     * since the end of the last render - or a ship's texture is still being streamed in;
+     * the contents of the ships' buffers are not tracked.
+     */
+    bool IsSceneDirty() const
+    {
+        return mIsSceneDirty
+            || mStreamingShipTextureCount.load(std::memory_order_relaxed) > 0;
+    }
+
+public:
+
+    /*
+     * Moves all OpenGL work onto a dedicated thread, which takes over the OpenGL context
+     * - made current with the first function, and released with the second one - until
+     * the thread is stopped.
+     *
+     * While the render thread runs, a frame - from RenderStart() to SubmitFrame() - is
+     * recorded into a command list, together with copies of the data that the caller
+     * owns, and the render thread replays it while the next frame gets prepared. State
+     * changes in between frames wait for the render thread to be done with the frame
+     * being replayed, and their OpenGL work is recorded into the next frame.
+     */
+    void StartRenderThread(
+        std::function<void()> makeContextCurrentFunction,
+        std::function<void()> releaseContextFunction);
+
+    void StopRenderThread();
+
+    bool IsRenderThreadRunning() const
+    {
+        return !!mRenderThread;
+    }
+
+    /*
+     * Hands the frame recorded so far over to the render thread, which replays it
+     * and then presents it with the specified function. Only valid while the render
+     * thread runs.
+     */
+    void SubmitFrame(std::function<void()> presentFunction);
+
+    /*
+     * The maximum number of frames that the GPU may still be busy rendering once a frame
+     * has been recorded - or, with the render thread, replayed. Zero makes each frame
+     * complete on the GPU before we move on, trading throughput for latency.
+     */
+    size_t GetMaxFramesInFlight() const
+    {
+        return mMaxFramesInFlight;
+    }
+
+    void SetMaxFramesInFlight(size_t maxFramesInFlight)
+    {
+        WaitForRenderThreadIdle();
+
+        mMaxFramesInFlight = maxFramesInFlight;
+    }
+
 public:
 
     void Reset();
@@ -381,11 +607,35 @@ public:
     void AddShip(
         ShipId shipId,
         size_t pointCount,
+        ImageSize shipStructureSize,
         RgbaImageData texture,
         ShipDefinition::TextureOriginType textureOrigin);
 
     RgbImageData TakeScreenshot();
 
+    /*
+     * Starts reading back the frame just rendered into a pixel buffer, without waiting
+     * for the GPU; the screenshot is then retrieved with RetrieveScreenshot(), at
+     * one of the following frames.
+     */
+    void StartScreenshot();
+
+    /*
+     * Retrieves the oldest of the screenshots started with StartScreenshot(), if any.
+     */
+    std::optional<RgbImageData> RetrieveScreenshot();
+
+    /*
+     * Forgets the oldest of the screenshots started with StartScreenshot(), if any,
+     * without reading it back.
+     */
+    void DiscardScreenshot();
+
+    bool HasPendingScreenshots() const
+    {
+        return mPendingScreenshotCount > 0;
+    }
+
 public:
 
     void RenderStart();
@@ -414,85 +664,65 @@ public:
     void UploadStarsEnd();
 
 
+    /*
+     * Clouds are animated by the GPU, hence they only need to be uploaded
+     * when they change.
+     */
     void UploadCloudsStart(size_t cloudCount);
 
     inline void UploadCloud(
-        float virtualX,
-        float virtualY,
-        float scale)
-    {
-        //
-        // We use Normalized Device Coordinates here
-        //
-
-        //
-        // Roll coordinates into a 3.0 X 2.0 view,
-        // then take the central slice and map it into NDC ((-1,-1) X (1,1))
-        //
-
-        float rolledX = std::fmod(virtualX, 3.0f);
-        if (rolledX < 0.0f)
-            rolledX += 3.0f;
-        float mappedX = -1.0f + 2.0f * (rolledX - 1.0f);
-
-        float rolledY = std::fmod(virtualY, 2.0f);
-        if (rolledY < 0.0f)
-            rolledY += 2.0f;
-        float mappedY = -1.0f + 2.0f * (rolledY - 0.5f);
-
-
-        //
-        // Populate quad in buffer
-        //
-
-        size_t const cloudTextureIndex = mCloudQuadBuffer.size() % mCloudTextureAtlasMetadata->GetFrameMetadata().size();
+        float offsetX,
+        float speedX1,
+        float ampX,
+        float speedX2,
+        float offsetY,
+        float ampY,
+        float speedY,
+        float offsetScale,
+        float ampScale,
+        float speedScale)
+    {
+        size_t const cloudTextureIndex = mCloudInstanceBuffer.size() % mCloudTextureAtlasMetadata->GetFrameMetadata().size();
 
         auto cloudAtlasFrameMetadata = mCloudTextureAtlasMetadata->GetFrameMetadata(
             TextureGroupType::Cloud,
             static_cast<TextureFrameIndex>(cloudTextureIndex));
 
-        float const aspectRatio = static_cast<float>(mViewModel.GetCanvasWidth()) / static_cast<float>(mViewModel.GetCanvasHeight());
-
-        float leftX = mappedX - scale * cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldX;
-        float rightX = mappedX + scale * (cloudAtlasFrameMetadata.FrameMetadata.WorldWidth - cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldX);
-        float topY = mappedY + scale * (cloudAtlasFrameMetadata.FrameMetadata.WorldHeight - cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldY) * aspectRatio;
-        float bottomY = mappedY - scale * cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldY * aspectRatio;
-
-        CloudQuad & cloudQuad = mCloudQuadBuffer.emplace_back();
+        CloudInstance & cloudInstance = mCloudInstanceBuffer.emplace_back();
 
-        cloudQuad.ndcXTopLeft1 = leftX;
-        cloudQuad.ndcYTopLeft1 = topY;
-        cloudQuad.ndcTextureXTopLeft1 = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.x;
-        cloudQuad.ndcTextureYTopLeft1 = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.y;
+        cloudInstance.offsetX = offsetX;
+        cloudInstance.speedX1 = speedX1;
+        cloudInstance.ampX = ampX;
+        cloudInstance.speedX2 = speedX2;
 
-        cloudQuad.ndcXBottomLeft1 = leftX;
-        cloudQuad.ndcYBottomLeft1 = bottomY;
-        cloudQuad.ndcTextureXBottomLeft1 = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.x;
-        cloudQuad.ndcTextureYBottomLeft1 = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.y;
+        cloudInstance.offsetY = offsetY;
+        cloudInstance.ampY = ampY;
+        cloudInstance.speedY = speedY;
+        cloudInstance._padding1 = 0.0f;
 
-        cloudQuad.ndcXTopRight1 = rightX;
-        cloudQuad.ndcYTopRight1 = topY;
-        cloudQuad.ndcTextureXTopRight1 = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.x;
-        cloudQuad.ndcTextureYTopRight1 = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.y;
+        cloudInstance.offsetScale = offsetScale;
+        cloudInstance.ampScale = ampScale;
+        cloudInstance.speedScale = speedScale;
+        cloudInstance._padding2 = 0.0f;
 
-        cloudQuad.ndcXBottomLeft2 = leftX;
-        cloudQuad.ndcYBottomLeft2 = bottomY;
-        cloudQuad.ndcTextureXBottomLeft2 = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.x;
-        cloudQuad.ndcTextureYBottomLeft2 = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.y;
+        cloudInstance.frameOffsetLeft = -cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldX;
+        cloudInstance.frameOffsetBottom = -cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldY;
+        cloudInstance.frameOffsetRight = cloudAtlasFrameMetadata.FrameMetadata.WorldWidth - cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldX;
+        cloudInstance.frameOffsetTop = cloudAtlasFrameMetadata.FrameMetadata.WorldHeight - cloudAtlasFrameMetadata.FrameMetadata.AnchorWorldY;
 
-        cloudQuad.ndcXTopRight2 = rightX;
-        cloudQuad.ndcYTopRight2 = topY;
-        cloudQuad.ndcTextureXTopRight2 = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.x;
-        cloudQuad.ndcTextureYTopRight2 = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.y;
-
-        cloudQuad.ndcXBottomRight2 = rightX;
-        cloudQuad.ndcYBottomRight2 = bottomY;
-        cloudQuad.ndcTextureXBottomRight2 = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.x;
-        cloudQuad.ndcTextureYBottomRight2 = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.y;
+        cloudInstance.textureXLeft = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.x;
+        cloudInstance.textureYBottom = cloudAtlasFrameMetadata.TextureCoordinatesBottomLeft.y;
+        cloudInstance.textureXRight = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.x;
+        cloudInstance.textureYTop = cloudAtlasFrameMetadata.TextureCoordinatesTopRight.y;
     }
 
     void UploadCloudsEnd();
 
+    // Called at each frame, drives the animation of the clouds
+    void UploadCloudsAnimation(
+        float currentSimulationTime,
+        float cloudSpeed);
+
 
     void RenderSkyEnd();
 
@@ -507,24 +737,39 @@ public:
         float x,
         float yLand)
     {
-        float const yVisibleWorldBottom = mViewModel.GetVisibleWorldBottomRight().y;
-
         //
         // Store Land element
         //
 
-        LandSegment & landSegment = mLandSegmentBuffer.emplace_back();
-
-        landSegment.x1 = x;
-        landSegment.y1 = yLand;
-        landSegment.x2 = x;
-        // If land is invisible (below), then keep both points at same height, or else interpolated lines
-        // will have a slope varying with the y of the visible world bottom
-        landSegment.y2 = yLand >= yVisibleWorldBottom ? yVisibleWorldBottom : yLand;
+        PopulateLandSegment(
+            mLandSegmentBuffer.emplace_back(),
+            x,
+            yLand);
    }
 
     void UploadLandEnd();
 
+    /*
+     * Re-uploads a range of the land segments uploaded last, starting at the specified
+     * segment, and keeping all the others; only valid as long as the visible world has
+     * not changed since the last full land upload.
+     */
+    void UploadLandRangeStart(size_t firstSegment);
+
+    inline void UploadLandRange(
+        float x,
+        float yLand)
+    {
+        assert(mLandSegmentRangeFirstSegment + mLandSegmentRangeBuffer.size() < mLandSegmentBuffer.size());
+
+        PopulateLandSegment(
+            mLandSegmentRangeBuffer.emplace_back(),
+            x,
+            yLand);
+    }
+
+    void UploadLandRangeEnd();
+
     void RenderLand();
 
 
@@ -646,11 +891,30 @@ public:
 
     void RenderShipStart(
         ShipId shipId,
-        PlaneId maxMaxPlaneId)
+        PlaneId maxMaxPlaneId,
+        bool isLowDetail)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->RenderStart(maxMaxPlaneId);
+        bool const isViewModelOutdated = mShips[shipId]->RenderStart(
+            maxMaxPlaneId,
+            isLowDetail);
+
+        if (isViewModelOutdated)
+        {
+            RunGL(
+                [ship = mShips[shipId].get()]()
+                {
+                    ship->OnViewModelUpdated();
+                });
+        }
+    }
+
+    void RenderShipCulled(ShipId shipId)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        mShips[shipId]->RenderCulled();
     }
 
     //
@@ -681,10 +945,45 @@ public:
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadPointMutableAttributes(
-            position,
-            light,
-            water);
+        size_t const pointCount = mShips[shipId]->GetPointCount();
+
+        RunGL(
+            [ship = mShips[shipId].get(),
+            position = CopyForRenderThread(position, pointCount),
+            light = CopyForRenderThread(light, pointCount),
+            water = CopyForRenderThread(water, pointCount)]()
+            {
+                ship->UploadPointMutableAttributes(
+                    position,
+                    light,
+                    water);
+            });
+    }
+
+    void UploadShipPointMutableAttributes(
+        ShipId shipId,
+        ShipPointPositionBuffer const & positionBuffer,
+        vec2f const * position,
+        float const * light,
+        float const * water)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        size_t const pointCount = mShips[shipId]->GetPointCount();
+
+        RunGL(
+            [ship = mShips[shipId].get(),
+            positionBuffer,
+            position = CopyForRenderThread(position, pointCount),
+            light = CopyForRenderThread(light, pointCount),
+            water = CopyForRenderThread(water, pointCount)]()
+            {
+                ship->UploadPointMutableAttributes(
+                    positionBuffer,
+                    position,
+                    light,
+                    water);
+            });
     }
 
     void UploadShipPointMutableAttributesPlaneId(
@@ -719,7 +1018,11 @@ public:
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadPointMutableAttributesEnd();
+        RunGL(
+            [ship = mShips[shipId].get()]()
+            {
+                ship->UploadPointMutableAttributesEnd();
+            });
     }
 
     void UploadShipPointColors(
@@ -730,10 +1033,14 @@ public:
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadPointColors(
-            color,
-            startDst,
-            count);
+        RunGL(
+            [ship = mShips[shipId].get(), color = CopyForRenderThread(color, count), startDst, count]()
+            {
+                ship->UploadPointColors(
+                    color,
+                    startDst,
+                    count);
+            });
     }
 
     //
@@ -749,17 +1056,29 @@ public:
 
     inline void UploadShipElementPoint(
         ShipId shipId,
-        int shipPointIndex)
+        ElementIndex shipPointIndex)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
         mShips[shipId]->UploadElementPoint(shipPointIndex);
     }
 
+    inline void UploadShipElementPoints(
+        ShipId shipId,
+        ElementIndex const * shipPointIndices,
+        size_t pointCount)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        mShips[shipId]->UploadElementPoints(
+            shipPointIndices,
+            pointCount);
+    }
+
     inline void UploadShipElementSpring(
         ShipId shipId,
-        int shipPointIndex1,
-        int shipPointIndex2)
+        ElementIndex shipPointIndex1,
+        ElementIndex shipPointIndex2)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
@@ -768,10 +1087,22 @@ public:
             shipPointIndex2);
     }
 
+    inline void UploadShipElementSprings(
+        ShipId shipId,
+        ElementIndex const * shipPointIndexPairs,
+        size_t springCount)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        mShips[shipId]->UploadElementSprings(
+            shipPointIndexPairs,
+            springCount);
+    }
+
     inline void UploadShipElementRope(
         ShipId shipId,
-        int shipPointIndex1,
-        int shipPointIndex2)
+        ElementIndex shipPointIndex1,
+        ElementIndex shipPointIndex2)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
@@ -780,21 +1111,33 @@ public:
             shipPointIndex2);
     }
 
+    inline void UploadShipElementRopes(
+        ShipId shipId,
+        ElementIndex const * shipPointIndexPairs,
+        size_t ropeCount)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        mShips[shipId]->UploadElementRopes(
+            shipPointIndexPairs,
+            ropeCount);
+    }
+
     inline void UploadShipElementTrianglesStart(
         ShipId shipId,
-        size_t trianglesCount)
+        size_t triangleCount)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadElementTrianglesStart(trianglesCount);
+        mShips[shipId]->UploadElementTrianglesStart(triangleCount);
     }
 
     inline void UploadShipElementTriangle(
         ShipId shipId,
         size_t triangleIndex,
-        int shipPointIndex1,
-        int shipPointIndex2,
-        int shipPointIndex3)
+        ElementIndex shipPointIndex1,
+        ElementIndex shipPointIndex2,
+        ElementIndex shipPointIndex3)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
@@ -819,7 +1162,11 @@ public:
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadElementsEnd(doFinalizeEphemeralPoints);
+        RunGL(
+            [ship = mShips[shipId].get(), doFinalizeEphemeralPoints]()
+            {
+                ship->UploadElementsEnd(doFinalizeEphemeralPoints);
+            });
     }
 
     //
@@ -835,8 +1182,8 @@ public:
 
     inline void UploadShipElementStressedSpring(
         ShipId shipId,
-        int shipPointIndex1,
-        int shipPointIndex2)
+        ElementIndex shipPointIndex1,
+        ElementIndex shipPointIndex2)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
@@ -849,7 +1196,11 @@ public:
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadElementStressedSpringsEnd();
+        RunGL(
+            [ship = mShips[shipId].get()]()
+            {
+                ship->UploadElementStressedSpringsEnd();
+            });
     }
 
     //
@@ -925,7 +1276,7 @@ public:
 
     inline void UploadShipElementEphemeralPoint(
         ShipId shipId,
-        int pointIndex)
+        ElementIndex pointIndex)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
@@ -937,7 +1288,52 @@ public:
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadElementEphemeralPointsEnd();
+        RunGL(
+            [ship = mShips[shipId].get()]()
+            {
+                ship->UploadElementEphemeralPointsEnd();
+            });
+    }
+
+
+    //
+    // Lamps
+    //
+
+    void UploadShipLampsStart(
+        ShipId shipId,
+        size_t lampCount)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        mShips[shipId]->UploadLampsStart(lampCount);
+    }
+
+    inline void UploadShipLamp(
+        ShipId shipId,
+        vec2f const & position,
+        float light,
+        float lightExponent,
+        float planeId)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        mShips[shipId]->UploadLamp(
+            position,
+            light,
+            lightExponent,
+            planeId);
+    }
+
+    void UploadShipLampsEnd(ShipId shipId)
+    {
+        assert(shipId >= 0 && shipId < mShips.size());
+
+        RunGL(
+            [ship = mShips[shipId].get()]()
+            {
+                ship->UploadLampsEnd();
+            });
     }
 
 
@@ -948,32 +1344,76 @@ public:
     void UploadShipVectors(
         ShipId shipId,
         size_t count,
-        vec2f const * position,
-        float const * planeId,
         vec2f const * vector,
         float lengthAdjustment,
         vec4f const & color)
     {
         assert(shipId >= 0 && shipId < mShips.size());
 
-        mShips[shipId]->UploadVectors(
+        RunGL(
+            [ship = mShips[shipId].get(),
             count,
-            position,
-            planeId,
-            vector,
-            lengthAdjustment * mVectorFieldLengthMultiplier,
-            color);
+            vector = CopyForRenderThread(vector, count),
+            lengthAdjustment = lengthAdjustment * mVectorFieldLengthMultiplier,
+            color]()
+            {
+                ship->UploadVectors(
+                    count,
+                    vector,
+                    lengthAdjustment,
+                    color);
+            });
     }
 
-    void RenderShipEnd(ShipId shipId)
-    {
-        assert(shipId >= 0 && shipId < mShips.size());
+    // Draws all of the ships, once they've all uploaded their elements
+    void RenderShipsEnd();
+
 
-        mShips[shipId]->RenderEnd();
+    //
+    // GPU ephemeral particles
+    //
+
+    inline void UploadEphemeralParticleDebris(
+        vec2f const & position,
+        vec2f const & velocity,
+        vec4f const & color,
+        float startTime,
+        float maxLifetime)
+    {
+        assert(!!mParticleRenderContext);
+        mParticleRenderContext->UploadDebris(
+            position,
+            velocity,
+            color,
+            startTime,
+            maxLifetime);
     }
 
+    inline void UploadEphemeralParticleSparkle(
+        vec2f const & position,
+        vec2f const & velocity,
+        TextureFrameId const & textureFrameId,
+        float startTime,
+        float maxLifetime)
+    {
+        assert(!!mParticleRenderContext);
+        mParticleRenderContext->UploadSparkle(
+            position,
+            velocity,
+            textureFrameId,
+            startTime,
+            maxLifetime);
+    }
 
-    void RenderShipsEnd();
+    void RenderEphemeralParticles(float currentSimulationTime)
+    {
+        assert(!!mParticleRenderContext);
+        RunGL(
+            [this, currentSimulationTime]()
+            {
+                mParticleRenderContext->Render(currentSimulationTime);
+            });
+    }
 
 
 
@@ -987,6 +1427,10 @@ public:
         float alpha,
         FontType font)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         assert(!!mTextRenderContext);
         return mTextRenderContext->AddText(
             textLines,
@@ -1000,6 +1444,10 @@ public:
         std::vector<std::string> const & textLines,
         float alpha)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         assert(!!mTextRenderContext);
         mTextRenderContext->UpdateText(
             textHandle,
@@ -1009,6 +1457,10 @@ public:
 
     void ClearText(RenderedTextHandle textHandle)
     {
+        WaitForRenderThreadIdle();
+
+        mIsSceneDirty = true;
+
         assert(!!mTextRenderContext);
         mTextRenderContext->ClearText(textHandle);
     }
@@ -1025,6 +1477,11 @@ private:
     void RenderCrossesOfLight();
     void RenderWorldBorder();
 
+    void FenceFrame();
+
+    void UpdateCurrentWorldRenderScale();
+    bool PrepareWorldFramebuffer(ImageSize const & size);
+
     void OnViewModelUpdated();
     void OnAmbientLightIntensityUpdated();
     void OnOceanTransparencyUpdated();
@@ -1040,6 +1497,53 @@ private:
     void UpdateWorldBorder();
     vec4f CalculateWaterColor() const;
 
+    /*
+     * Runs the specified OpenGL work right away, or - when the render thread runs -
+     * records it into the frame being recorded.
+     */
+    template<typename TCommand>
+    void RunGL(TCommand && command)
+    {
+        if (!!mRenderThread)
+            mRenderThread->GetRecordingCommandList().Record(std::forward<TCommand>(command));
+        else
+            command();
+    }
+
+    /*
+     * Runs the specified OpenGL work right away, on the render thread if it runs, after
+     * all of the work recorded so far.
+     */
+    template<typename TCommand>
+    void RunGLSync(TCommand && command)
+    {
+        if (!!mRenderThread)
+            mRenderThread->RunSync(std::forward<TCommand>(command));
+        else
+            command();
+    }
+
+    /*
+     * Makes data that we don't own safe to be used by recorded OpenGL work, copying it
+     * into the frame being recorded when the render thread runs.
+     */
+    template<typename TElement>
+    TElement const * CopyForRenderThread(
+        TElement const * elements,
+        size_t elementCount)
+    {
+        if (!!mRenderThread)
+            return mRenderThread->GetRecordingCommandList().CopyBlock(elements, elementCount);
+        else
+            return elements;
+    }
+
+    void WaitForRenderThreadIdle() const
+    {
+        if (!!mRenderThread)
+            mRenderThread->WaitForIdle();
+    }
+
 private:
 
     //
@@ -1064,38 +1568,33 @@ private:
         {}
     };
 
-    // Two triangles
-    struct CloudQuad
-    {
-        float ndcXTopLeft1;
-        float ndcYTopLeft1;
-        float ndcTextureXTopLeft1;
-        float ndcTextureYTopLeft1;
-
-        float ndcXBottomLeft1;
-        float ndcYBottomLeft1;
-        float ndcTextureXBottomLeft1;
-        float ndcTextureYBottomLeft1;
-
-        float ndcXTopRight1;
-        float ndcYTopRight1;
-        float ndcTextureXTopRight1;
-        float ndcTextureYTopRight1;
-
-        float ndcXBottomLeft2;
-        float ndcYBottomLeft2;
-        float ndcTextureXBottomLeft2;
-        float ndcTextureYBottomLeft2;
-
-        float ndcXTopRight2;
-        float ndcYTopRight2;
-        float ndcTextureXTopRight2;
-        float ndcTextureYTopRight2;
-
-        float ndcXBottomRight2;
-        float ndcYBottomRight2;
-        float ndcTextureXBottomRight2;
-        float ndcTextureYBottomRight2;
+    // The constants of the motion of a cloud, drawn as one instance of the cloud quad
+    struct CloudInstance
+    {
+        float offsetX;
+        float speedX1;
+        float ampX;
+        float speedX2;
+
+        float offsetY;
+        float ampY;
+        float speedY;
+        float _padding1;
+
+        float offsetScale;
+        float ampScale;
+        float speedScale;
+        float _padding2;
+
+        float frameOffsetLeft;
+        float frameOffsetBottom;
+        float frameOffsetRight;
+        float frameOffsetTop;
+
+        float textureXLeft;
+        float textureYBottom;
+        float textureXRight;
+        float textureYTop;
     };
 
     struct LandSegment
@@ -1106,6 +1605,21 @@ private:
         float y2;
     };
 
+    inline void PopulateLandSegment(
+        LandSegment & landSegment,
+        float x,
+        float yLand) const
+    {
+        float const yVisibleWorldBottom = mViewModel.GetVisibleWorldBottomRight().y;
+
+        landSegment.x1 = x;
+        landSegment.y1 = yLand;
+        landSegment.x2 = x;
+        // If land is invisible (below), then keep both points at same height, or else interpolated lines
+        // will have a slope varying with the y of the visible world bottom
+        landSegment.y2 = yLand >= yVisibleWorldBottom ? yVisibleWorldBottom : yLand;
+    }
+
     struct OceanSegment
     {
         float x1;
@@ -1161,11 +1675,15 @@ private:
     BoundedVector<StarVertex> mStarVertexBuffer;
     GameOpenGLVBO mStarVBO;
 
-    GameOpenGLMappedBuffer<CloudQuad, GL_ARRAY_BUFFER> mCloudQuadBuffer;
-    GameOpenGLVBO mCloudVBO;
+    std::vector<CloudInstance> mCloudInstanceBuffer;
+    size_t mCloudInstanceCount;
+    GameOpenGLVBO mCloudInstanceVBO;
+    GameOpenGLVBO mCloudQuadVBO;
 
     GameOpenGLMappedBuffer<LandSegment, GL_ARRAY_BUFFER> mLandSegmentBuffer;
     size_t mLandSegmentBufferAllocatedSize;
+    std::vector<LandSegment> mLandSegmentRangeBuffer;
+    size_t mLandSegmentRangeFirstSegment;
     GameOpenGLVBO mLandVBO;
 
     GameOpenGLMappedBuffer<OceanSegment, GL_ARRAY_BUFFER> mOceanSegmentBuffer;
@@ -1178,6 +1696,13 @@ private:
     std::vector<WorldBorderVertex> mWorldBorderVertexBuffer;
     GameOpenGLVBO mWorldBorderVBO;
 
+    // The ring of pixel buffers for the screenshots being read back asynchronously
+    static constexpr size_t ScreenshotPixelBufferCount = 2;
+    std::array<GameOpenGLVBO, ScreenshotPixelBufferCount> mScreenshotPixelBuffers;
+    std::array<ImageSize, ScreenshotPixelBufferCount> mScreenshotSizes;
+    size_t mNextScreenshotPixelBuffer;
+    size_t mPendingScreenshotCount;
+
     //
     // VAOs
     //
@@ -1200,6 +1725,9 @@ private:
     // Ships
     //
 
+    // The VBOs of the ships of the previous world, for the ships of the next one; outlives the ships
+    GameOpenGLBufferRecycler mShipBufferRecycler;
+
     std::vector<std::unique_ptr<ShipRenderContext>> mShips;
 
     GameOpenGLTexture mGenericTextureAtlasOpenGLHandle;
@@ -1221,6 +1749,9 @@ private:
     std::unique_ptr<ShaderManager<ShaderManagerTraits>> mShaderManager;
     std::unique_ptr<TextureRenderManager> mTextureRenderManager;
     std::unique_ptr<TextRenderContext> mTextRenderContext;
+    std::unique_ptr<ParticleRenderContext> mParticleRenderContext;
+    std::unique_ptr<GameOpenGLTimerQueries> mGPUTimerQueries;
+    std::unique_ptr<GameOpenGLElapsedTimer> mWorldGPUTimer;
 
     //
     // The current render parameters
@@ -1245,12 +1776,50 @@ private:
     VectorFieldRenderMode mVectorFieldRenderMode;
     float mVectorFieldLengthMultiplier;
     bool mShowStressedSprings;
+    float mWorldRenderScale;
+    bool mDoAdaptWorldRenderScale;
+
+    bool mIsSceneDirty;
+
+    // Written by the render thread as ship textures finish streaming in
+    std::atomic<size_t> mStreamingShipTextureCount;
+
+    //
+    // Dynamic resolution
+    //
+
+    // The scale of this frame's world, which differs from the setting when adaptive
+    float mCurrentWorldRenderScale;
+
+    // The offscreen framebuffer the world is rendered into, when at a lower resolution
+    GameOpenGLFramebuffer mWorldFramebuffer;
+    GameOpenGLRenderbuffer mWorldColorRenderbuffer;
+    GameOpenGLRenderbuffer mWorldDepthStencilRenderbuffer;
+    ImageSize mWorldFramebufferSize;
+    bool mIsWorldRenderedOffscreen;
 
     //
     // Statistics
     //
 
     RenderStatistics mRenderStatistics;
+
+    //
+    // Frames in flight
+    //
+
+    size_t mMaxFramesInFlight;
+
+    // The fences at the end of the frames the GPU may still be rendering, oldest first;
+    // only touched by the thread owning the context
+    std::deque<GLsync> mFrameFences;
+
+    //
+    // Render thread
+    //
+
+    // Set when the render thread runs
+    std::unique_ptr<RenderThread> mRenderThread;
 };
 
 }
\ No newline at end of file
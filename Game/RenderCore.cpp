@@ -19,6 +19,8 @@ ProgramType ShaderFilenameToProgramType(std::string const & str)
         return ProgramType::Clouds;
     else if (lstr == "cross_of_light")
         return ProgramType::CrossOfLight;
+    else if (lstr == "ephemeral_particles")
+        return ProgramType::EphemeralParticles;
     else if (lstr == "land_flat")
         return ProgramType::LandFlat;
     else if (lstr == "land_texture")
@@ -69,6 +71,8 @@ std::string ProgramTypeToStr(ProgramType program)
         return "Clouds";
     case ProgramType::CrossOfLight:
         return "CrossOfLight";
+    case ProgramType::EphemeralParticles:
+        return "EphemeralParticles";
     case ProgramType::LandFlat:
         return "LandFlat";
     case ProgramType::LandTexture:
@@ -117,6 +121,12 @@ ProgramParameterType StrToProgramParameterType(std::string const & str)
 {
     if (str == "AmbientLightIntensity")
         return ProgramParameterType::AmbientLightIntensity;
+    else if (str == "CloudSpeed")
+        return ProgramParameterType::CloudSpeed;
+    else if (str == "CurrentSimulationTime")
+        return ProgramParameterType::CurrentSimulationTime;
+    else if (str == "LampCount")
+        return ProgramParameterType::LampCount;
     else if (str == "LandFlatColor")
         return ProgramParameterType::LandFlatColor;
     else if (str == "MatteColor")
@@ -135,6 +145,8 @@ ProgramParameterType StrToProgramParameterType(std::string const & str)
         return ProgramParameterType::StarTransparency;
     else if (str == "TextureScaling")
         return ProgramParameterType::TextureScaling;
+    else if (str == "VectorLengthAdjustment")
+        return ProgramParameterType::VectorLengthAdjustment;
     else if (str == "ViewportSize")
         return ProgramParameterType::ViewportSize;
     else if (str == "WaterColor")
@@ -156,6 +168,8 @@ ProgramParameterType StrToProgramParameterType(std::string const & str)
         return ProgramParameterType::OceanTexture;
     else if (str == "WorldBorderTexture")
         return ProgramParameterType::WorldBorderTexture;
+    else if (str == "ShipLampsTexture")
+        return ProgramParameterType::ShipLampsTexture;
     else
         throw GameException("Unrecognized program parameter \"" + str + "\"");
 }
@@ -166,6 +180,12 @@ std::string ProgramParameterTypeToStr(ProgramParameterType programParameter)
     {
     case ProgramParameterType::AmbientLightIntensity:
         return "AmbientLightIntensity";
+    case ProgramParameterType::CloudSpeed:
+        return "CloudSpeed";
+    case ProgramParameterType::CurrentSimulationTime:
+        return "CurrentSimulationTime";
+    case ProgramParameterType::LampCount:
+        return "LampCount";
     case ProgramParameterType::LandFlatColor:
         return "LandFlatColor";
     case ProgramParameterType::MatteColor:
@@ -184,6 +204,8 @@ std::string ProgramParameterTypeToStr(ProgramParameterType programParameter)
         return "StarTransparency";
     case ProgramParameterType::TextureScaling:
         return "TextureScaling";
+    case ProgramParameterType::VectorLengthAdjustment:
+        return "VectorLengthAdjustment";
     case ProgramParameterType::ViewportSize:
         return "ViewportSize";
     case ProgramParameterType::WaterColor:
@@ -205,6 +227,8 @@ std::string ProgramParameterTypeToStr(ProgramParameterType programParameter)
         return "OceanTexture";
     case ProgramParameterType::WorldBorderTexture:
         return "WorldBorderTexture";
+    case ProgramParameterType::ShipLampsTexture:
+        return "ShipLampsTexture";
     default:
         assert(false);
         throw GameException("Unsupported ProgramParameterType");
@@ -218,6 +242,16 @@ VertexAttributeType StrToVertexAttributeType(std::string const & str)
         return VertexAttributeType::Star;
     else if (Utils::CaseInsensitiveEquals(str, "Cloud"))
         return VertexAttributeType::Cloud;
+    else if (Utils::CaseInsensitiveEquals(str, "CloudInstance1"))
+        return VertexAttributeType::CloudInstance1;
+    else if (Utils::CaseInsensitiveEquals(str, "CloudInstance2"))
+        return VertexAttributeType::CloudInstance2;
+    else if (Utils::CaseInsensitiveEquals(str, "CloudInstance3"))
+        return VertexAttributeType::CloudInstance3;
+    else if (Utils::CaseInsensitiveEquals(str, "CloudInstance4"))
+        return VertexAttributeType::CloudInstance4;
+    else if (Utils::CaseInsensitiveEquals(str, "CloudInstance5"))
+        return VertexAttributeType::CloudInstance5;
     else if (Utils::CaseInsensitiveEquals(str, "Land"))
         return VertexAttributeType::Land;
     else if (Utils::CaseInsensitiveEquals(str, "Ocean"))
@@ -228,21 +262,43 @@ VertexAttributeType StrToVertexAttributeType(std::string const & str)
         return VertexAttributeType::CrossOfLight2;
     else if (Utils::CaseInsensitiveEquals(str, "WorldBorder"))
         return VertexAttributeType::WorldBorder;
+    else if (Utils::CaseInsensitiveEquals(str, "EphemeralParticle1"))
+        return VertexAttributeType::EphemeralParticle1;
+    else if (Utils::CaseInsensitiveEquals(str, "EphemeralParticle2"))
+        return VertexAttributeType::EphemeralParticle2;
+    else if (Utils::CaseInsensitiveEquals(str, "EphemeralParticle3"))
+        return VertexAttributeType::EphemeralParticle3;
+    else if (Utils::CaseInsensitiveEquals(str, "EphemeralParticle4"))
+        return VertexAttributeType::EphemeralParticle4;
     // Ship
     else if (Utils::CaseInsensitiveEquals(str, "ShipPointAttributeGroup1"))
         return VertexAttributeType::ShipPointAttributeGroup1;
-    else if (Utils::CaseInsensitiveEquals(str, "ShipPointAttributeGroup2"))
-        return VertexAttributeType::ShipPointAttributeGroup2;
+    else if (Utils::CaseInsensitiveEquals(str, "ShipPointLight"))
+        return VertexAttributeType::ShipPointLight;
     else if (Utils::CaseInsensitiveEquals(str, "ShipPointColor"))
         return VertexAttributeType::ShipPointColor;
+    else if (Utils::CaseInsensitiveEquals(str, "ShipPointAttributeGroup3"))
+        return VertexAttributeType::ShipPointAttributeGroup3;
+    else if (Utils::CaseInsensitiveEquals(str, "ShipPointWater"))
+        return VertexAttributeType::ShipPointWater;
     else if (Utils::CaseInsensitiveEquals(str, "GenericTexture1"))
         return VertexAttributeType::GenericTexture1;
     else if (Utils::CaseInsensitiveEquals(str, "GenericTexture2"))
         return VertexAttributeType::GenericTexture2;
     else if (Utils::CaseInsensitiveEquals(str, "GenericTexture3"))
         return VertexAttributeType::GenericTexture3;
-    else if (Utils::CaseInsensitiveEquals(str, "VectorArrow"))
-        return VertexAttributeType::VectorArrow;
+    else if (Utils::CaseInsensitiveEquals(str, "GenericTexture4"))
+        return VertexAttributeType::GenericTexture4;
+    else if (Utils::CaseInsensitiveEquals(str, "GenericTexture5"))
+        return VertexAttributeType::GenericTexture5;
+    else if (Utils::CaseInsensitiveEquals(str, "VectorArrow1"))
+        return VertexAttributeType::VectorArrow1;
+    else if (Utils::CaseInsensitiveEquals(str, "VectorArrow2"))
+        return VertexAttributeType::VectorArrow2;
+    else if (Utils::CaseInsensitiveEquals(str, "VectorArrow3"))
+        return VertexAttributeType::VectorArrow3;
+    else if (Utils::CaseInsensitiveEquals(str, "VectorArrow4"))
+        return VertexAttributeType::VectorArrow4;
     // Text
     else if (Utils::CaseInsensitiveEquals(str, "Text1"))
         return VertexAttributeType::Text1;
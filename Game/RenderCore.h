@@ -27,6 +27,7 @@ enum class ProgramType
 {
     Clouds = 0,
     CrossOfLight,
+    EphemeralParticles,
     LandFlat,
     LandTexture,
     MatteOcean,
@@ -57,6 +58,9 @@ std::string ProgramTypeToStr(ProgramType program);
 enum class ProgramParameterType : uint8_t
 {
     AmbientLightIntensity = 0,
+    CloudSpeed,
+    CurrentSimulationTime,
+    LampCount,
     LandFlatColor,
     MatteColor,
     OceanTransparency,
@@ -66,6 +70,7 @@ enum class ProgramParameterType : uint8_t
     OrthoMatrix,
     StarTransparency,
     TextureScaling,
+    VectorLengthAdjustment,
     ViewportSize,
     WaterColor,
     WaterContrast,
@@ -78,9 +83,10 @@ enum class ProgramParameterType : uint8_t
     LandTexture,                    // 3
     OceanTexture,                   // 4
     WorldBorderTexture,                // 5
+    ShipLampsTexture,               // 6
 
     _FirstTexture = SharedTexture,
-    _LastTexture = WorldBorderTexture
+    _LastTexture = ShipLampsTexture
 };
 
 ProgramParameterType StrToProgramParameterType(std::string const & str);
@@ -98,7 +104,12 @@ enum class VertexAttributeType : GLuint
 
     Star = 0,
 
-    Cloud = 0,
+    Cloud = 0,                  // Quad corner
+    CloudInstance1 = 1,         // OffsetX, SpeedX1, AmpX, SpeedX2
+    CloudInstance2 = 2,         // OffsetY, AmpY, SpeedY
+    CloudInstance3 = 3,         // OffsetScale, AmpScale, SpeedScale
+    CloudInstance4 = 4,         // Frame offsets
+    CloudInstance5 = 5,         // Texture coordinates
 
     Land = 0,
 
@@ -109,19 +120,31 @@ enum class VertexAttributeType : GLuint
 
     WorldBorder = 0,
 
+    EphemeralParticle1 = 0,     // StartPosition, StartVelocity
+    EphemeralParticle2 = 1,     // VertexOffset, TextureCoordinates
+    EphemeralParticle3 = 2,     // Color
+    EphemeralParticle4 = 3,     // StartTime, MaxLifetime, Spin, AmbientLightSensitivity
+
     //
     // Ship
     //
 
-    ShipPointAttributeGroup1 = 0,   // Position, TextureCoordinates
-    ShipPointAttributeGroup2 = 1,   // Light, Water, PlaneId, Decay
-    ShipPointColor = 2,
+    ShipPointAttributeGroup1 = 0,   // Position
+    ShipPointLight = 1,
+    ShipPointColor = 2,             // RGBA8
+    ShipPointAttributeGroup3 = 3,   // TextureCoordinates, PlaneId, Decay
+    ShipPointWater = 4,
 
-    GenericTexture1 = 0,
-    GenericTexture2 = 1,
-    GenericTexture3 = 2,
+    GenericTexture1 = 0,    // QuadCorner
+    GenericTexture2 = 1,    // CenterPosition, PlaneId, Scale (per-instance)
+    GenericTexture3 = 2,    // FrameLeftX, FrameBottomY, FrameRightX, FrameTopY (per-instance)
+    GenericTexture4 = 3,    // TextureCoordinatesBottomLeft, TextureCoordinatesTopRight (per-instance)
+    GenericTexture5 = 4,    // Angle, Alpha, AmbientLightSensitivity (per-instance)
 
-    VectorArrow = 0,
+    VectorArrow1 = 0,   // StemFraction, HeadOffsetAlong, HeadOffsetAcross
+    VectorArrow2 = 1,   // Position (per-instance)
+    VectorArrow3 = 2,   // PlaneId (per-instance)
+    VectorArrow4 = 3,   // Vector (per-instance)
 
     //
     // Text
@@ -179,6 +202,32 @@ struct TextQuadVertex
 #pragma pack(pop)
 
 
+//
+// Ship points
+//
+
+/*
+ * A buffer object holding the positions - one vec2f each - of the first points of a
+ * ship, as written by the GPU in another, sharing context; positions are then copied
+ * into the ship's vertex buffer without ever going through the CPU.
+ */
+struct ShipPointPositionBuffer
+{
+    GLuint Buffer;
+    GLsync WriteFence; // NULL when the writes are known to be complete
+    size_t PointCount;
+
+    ShipPointPositionBuffer(
+        GLuint buffer,
+        GLsync writeFence,
+        size_t pointCount)
+        : Buffer(buffer)
+        , WriteFence(writeFence)
+        , PointCount(pointCount)
+    {}
+};
+
+
 //
 // Statistics
 //
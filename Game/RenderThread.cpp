@@ -0,0 +1,166 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-30
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "RenderThread.h"
+
+#include <GameCore/TraceLog.h>
+
+#include <cassert>
+#include <utility>
+
+namespace Render {
+
+RenderThread::RenderThread(
+    std::function<void()> makeContextCurrentFunction,
+    std::function<void()> releaseContextFunction)
+    : mMakeContextCurrentFunction(std::move(makeContextCurrentFunction))
+    , mReleaseContextFunction(std::move(releaseContextFunction))
+    , mCommandLists()
+    , mRecordingCommandList(&(mCommandLists[0]))
+    , mSubmittedCommandList(nullptr)
+    , mReplayException()
+    , mIsStopping(false)
+    , mMutex()
+    , mCondition()
+    , mThread()
+{
+    // A context may only be current on one thread at a time
+    mReleaseContextFunction();
+
+    mThread = std::thread(&RenderThread::ThreadLoop, this);
+}
+
+RenderThread::~RenderThread()
+{
+    // Replay whatever has been recorded so far
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mIsStopping = true;
+    }
+
+    mCondition.notify_all();
+
+    mThread.join();
+
+    // Take back the context
+    mMakeContextCurrentFunction();
+}
+
+void RenderThread::Flush()
+{
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        // Wait for the render thread to be done with the other list
+        mCondition.wait(
+            lock,
+            [this]()
+            {
+                return nullptr == mSubmittedCommandList;
+            });
+
+        mSubmittedCommandList = mRecordingCommandList;
+    }
+
+    mCondition.notify_all();
+
+    mRecordingCommandList = (mRecordingCommandList == &(mCommandLists[0]))
+        ? &(mCommandLists[1])
+        : &(mCommandLists[0]);
+
+    assert(mRecordingCommandList->IsEmpty());
+}
+
+void RenderThread::WaitForIdle()
+{
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        mCondition.wait(
+            lock,
+            [this]()
+            {
+                return nullptr == mSubmittedCommandList;
+            });
+    }
+
+    RethrowReplayException();
+}
+
+void RenderThread::ThreadLoop()
+{
+    TraceLog::GetInstance().SetCurrentThreadName("Render");
+
+    mMakeContextCurrentFunction();
+
+    while (true)
+    {
+        RenderCommandList * commandList;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+
+            mCondition.wait(
+                lock,
+                [this]()
+                {
+                    return mIsStopping || nullptr != mSubmittedCommandList;
+                });
+
+            if (nullptr == mSubmittedCommandList)
+            {
+                // Stopping, and nothing left to replay
+                break;
+            }
+
+            commandList = mSubmittedCommandList;
+        }
+
+        try
+        {
+            commandList->Replay();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            if (!mReplayException)
+                mReplayException = std::current_exception();
+        }
+
+        commandList->Clear();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            mSubmittedCommandList = nullptr;
+        }
+
+        mCondition.notify_all();
+    }
+
+    mReleaseContextFunction();
+}
+
+void RenderThread::RethrowReplayException()
+{
+    std::exception_ptr replayException;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::swap(replayException, mReplayException);
+    }
+
+    if (!!replayException)
+    {
+        std::rethrow_exception(replayException);
+    }
+}
+
+}
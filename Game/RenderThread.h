@@ -0,0 +1,106 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-30
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "RenderCommandList.h"
+
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Render {
+
+/*
+ * A thread that owns the OpenGL context and replays the command lists recorded by
+ * another thread - the "recording" thread, i.e. the thread that creates this object.
+ *
+ * There are two command lists: while the render thread replays one, the recording
+ * thread records into the other one. Flushing hands the list being recorded over to
+ * the render thread, after waiting for it to be done with the previous one.
+ *
+ * At construction the OpenGL context is taken away from the recording thread and made
+ * current on the render thread; at destruction, it's given back.
+ *
+ * Exceptions thrown while replaying are re-thrown on the recording thread, at the first
+ * wait after they've happened.
+ */
+class RenderThread
+{
+public:
+
+    RenderThread(
+        std::function<void()> makeContextCurrentFunction,
+        std::function<void()> releaseContextFunction);
+
+    ~RenderThread();
+
+    RenderThread(RenderThread const &) = delete;
+    RenderThread & operator=(RenderThread const &) = delete;
+
+    /*
+     * The list to record into; only valid until the next flush.
+     */
+    RenderCommandList & GetRecordingCommandList()
+    {
+        return *mRecordingCommandList;
+    }
+
+    /*
+     * Hands the commands recorded so far over to the render thread, without waiting for
+     * them to be replayed.
+     */
+    void Flush();
+
+    /*
+     * Waits until the render thread has replayed all the commands flushed so far; from
+     * then on, and until the next flush, the render thread doesn't touch any state.
+     */
+    void WaitForIdle();
+
+    /*
+     * Runs the specified command on the render thread, after all the commands recorded
+     * so far, and waits for it to complete.
+     */
+    template<typename TCommand>
+    void RunSync(TCommand && command)
+    {
+        mRecordingCommandList->Record(std::forward<TCommand>(command));
+
+        Flush();
+        WaitForIdle();
+    }
+
+private:
+
+    void ThreadLoop();
+
+    void RethrowReplayException();
+
+private:
+
+    std::function<void()> const mMakeContextCurrentFunction;
+    std::function<void()> const mReleaseContextFunction;
+
+    std::array<RenderCommandList, 2> mCommandLists;
+
+    // Only touched by the recording thread
+    RenderCommandList * mRecordingCommandList;
+
+    // The list being replayed, if any; guarded by the mutex
+    RenderCommandList * mSubmittedCommandList;
+    std::exception_ptr mReplayException;
+    bool mIsStopping;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+
+    std::thread mThread;
+};
+
+}
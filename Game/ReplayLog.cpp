@@ -0,0 +1,349 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-09
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "ReplayLog.h"
+
+#include <GameCore/BinaryFileTools.h>
+#include <GameCore/GameException.h>
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace /* anonymous */ {
+
+    // Bump whenever the layout of the file changes
+    static constexpr char ReplayLogMagic[4] = { 'F', 'S', 'R', 'L' };
+    static constexpr std::uint32_t ReplayLogVersion = 1;
+
+    static_assert(std::is_trivially_copyable_v<GameParameters>, "Game parameters are stored as they are in memory");
+}
+
+bool ReplayCommand::Apply(
+    Physics::World & world,
+    GameParameters const & gameParameters) const
+{
+    switch (Type)
+    {
+        case CommandType::MoveBy:
+        {
+            world.MoveBy(Ship, Position1, gameParameters);
+            return true;
+        }
+
+        case CommandType::RotateBy:
+        {
+            world.RotateBy(Ship, Value, Position1, gameParameters);
+            return true;
+        }
+
+        case CommandType::DestroyAt:
+        {
+            world.DestroyAt(Position1, Value, gameParameters);
+            return true;
+        }
+
+        case CommandType::RepairAt:
+        {
+            world.RepairAt(Position1, Value, gameParameters);
+            return true;
+        }
+
+        case CommandType::SawThrough:
+        {
+            world.SawThrough(Position1, Position2, gameParameters);
+            return true;
+        }
+
+        case CommandType::DrawTo:
+        {
+            world.DrawTo(Position1, Value, gameParameters);
+            return true;
+        }
+
+        case CommandType::SwirlAt:
+        {
+            world.SwirlAt(Position1, Value, gameParameters);
+            return true;
+        }
+
+        case CommandType::DisplaceOceanSurfaceAt:
+        {
+            // Push down when below the surface, up when above
+            world.DisplaceOceanSurfaceAt(
+                Position1.x,
+                world.IsUnderwater(Position1) ? -Value : Value);
+            return true;
+        }
+
+        case CommandType::TogglePinAt:
+        {
+            world.TogglePinAt(Position1, gameParameters);
+            return true;
+        }
+
+        case CommandType::InjectBubblesAt:
+        {
+            return world.InjectBubblesAt(Position1, gameParameters);
+        }
+
+        case CommandType::FloodAt:
+        {
+            return world.FloodAt(Position1, Value, gameParameters);
+        }
+
+        case CommandType::ToggleAntiMatterBombAt:
+        {
+            world.ToggleAntiMatterBombAt(Position1, gameParameters);
+            return true;
+        }
+
+        case CommandType::ToggleImpactBombAt:
+        {
+            world.ToggleImpactBombAt(Position1, gameParameters);
+            return true;
+        }
+
+        case CommandType::ToggleRCBombAt:
+        {
+            world.ToggleRCBombAt(Position1, gameParameters);
+            return true;
+        }
+
+        case CommandType::ToggleTimerBombAt:
+        {
+            world.ToggleTimerBombAt(Position1, gameParameters);
+            return true;
+        }
+
+        case CommandType::DetonateRCBombs:
+        {
+            world.DetonateRCBombs();
+            return true;
+        }
+
+        case CommandType::DetonateAntiMatterBombs:
+        {
+            world.DetonateAntiMatterBombs();
+            return true;
+        }
+
+        case CommandType::AdjustOceanFloorTo:
+        {
+            return world.AdjustOceanFloorTo(
+                Position1.x,
+                Position1.y,
+                Position2.x,
+                Position2.y);
+        }
+
+        case CommandType::ScrubThrough:
+        {
+            return world.ScrubThrough(Position1, Position2, gameParameters);
+        }
+    }
+
+    assert(false);
+    return false;
+}
+
+ReplayLog ReplayLog::Load(std::filesystem::path const & filepath)
+{
+    std::ifstream file(filepath.string(), std::ios::binary | std::ios::in);
+    if (!file.is_open())
+    {
+        throw GameException("Cannot open file \"" + filepath.string() + "\"");
+    }
+
+    //
+    // Header
+    //
+
+    char magic[sizeof(ReplayLogMagic)];
+    file.read(magic, sizeof(magic));
+    if (!file.good() || 0 != std::memcmp(magic, ReplayLogMagic, sizeof(magic)))
+    {
+        throw GameException("File \"" + filepath.string() + "\" is not a replay log");
+    }
+
+    if (BinaryFileTools::Read<std::uint32_t>(file) != ReplayLogVersion)
+    {
+        throw GameException("File \"" + filepath.string() + "\" is a replay log of an unsupported version");
+    }
+
+    if (BinaryFileTools::Read<std::uint32_t>(file) != sizeof(GameParameters))
+    {
+        throw GameException("Replay log \"" + filepath.string() + "\" was recorded by an incompatible build");
+    }
+
+    std::string const shipDefinitionFilepath = BinaryFileTools::ReadString(file);
+    unsigned int const randomSeed = BinaryFileTools::Read<std::uint32_t>(file);
+    int const canvasWidth = BinaryFileTools::Read<std::int32_t>(file);
+    int const canvasHeight = BinaryFileTools::Read<std::int32_t>(file);
+
+    ReplayLog replayLog(
+        std::filesystem::u8path(shipDefinitionFilepath),
+        randomSeed,
+        ImageSize(canvasWidth, canvasHeight));
+
+    replayLog.StepCount = BinaryFileTools::Read<std::uint64_t>(file);
+
+    //
+    // Game parameters
+    //
+
+    std::uint32_t const gameParametersCount = BinaryFileTools::Read<std::uint32_t>(file);
+    for (std::uint32_t g = 0; g < gameParametersCount && file.good(); ++g)
+    {
+        replayLog.GameParametersSnapshots.push_back(BinaryFileTools::Read<GameParameters>(file));
+    }
+
+    //
+    // Events
+    //
+
+    std::uint32_t const eventCount = BinaryFileTools::Read<std::uint32_t>(file);
+    for (std::uint32_t e = 0; e < eventCount && file.good(); ++e)
+    {
+        std::uint64_t const step = BinaryFileTools::Read<std::uint64_t>(file);
+        auto const eventType = static_cast<Event::EventType>(BinaryFileTools::Read<std::uint8_t>(file));
+
+        switch (eventType)
+        {
+            case Event::EventType::GameParameters:
+            {
+                size_t const gameParametersIndex = BinaryFileTools::Read<std::uint32_t>(file);
+                if (gameParametersIndex >= replayLog.GameParametersSnapshots.size())
+                {
+                    throw GameException("Replay log \"" + filepath.string() + "\" is corrupted");
+                }
+
+                replayLog.Events.push_back(Event::MakeGameParameters(step, gameParametersIndex));
+
+                break;
+            }
+
+            case Event::EventType::View:
+            {
+                vec2f const cameraWorldPosition = BinaryFileTools::Read<vec2f>(file);
+                float const zoom = BinaryFileTools::Read<float>(file);
+
+                replayLog.Events.push_back(Event::MakeView(step, cameraWorldPosition, zoom));
+
+                break;
+            }
+
+            case Event::EventType::Command:
+            {
+                auto const commandType = static_cast<ReplayCommand::CommandType>(BinaryFileTools::Read<std::uint8_t>(file));
+                ShipId const ship = BinaryFileTools::Read<ShipId>(file);
+                vec2f const position1 = BinaryFileTools::Read<vec2f>(file);
+                vec2f const position2 = BinaryFileTools::Read<vec2f>(file);
+                float const value = BinaryFileTools::Read<float>(file);
+
+                if (commandType > ReplayCommand::CommandType::ScrubThrough)
+                {
+                    throw GameException("Replay log \"" + filepath.string() + "\" is corrupted");
+                }
+
+                replayLog.Events.push_back(
+                    Event::MakeCommand(
+                        step,
+                        ReplayCommand(commandType, ship, position1, position2, value)));
+
+                break;
+            }
+
+            default:
+            {
+                throw GameException("Replay log \"" + filepath.string() + "\" is corrupted");
+            }
+        }
+    }
+
+    if (!file.good())
+    {
+        throw GameException("Replay log \"" + filepath.string() + "\" is truncated");
+    }
+
+    return replayLog;
+}
+
+void ReplayLog::Save(std::filesystem::path const & filepath) const
+{
+    std::ofstream file(filepath.string(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw GameException("Cannot open file \"" + filepath.string() + "\" for writing");
+    }
+
+    //
+    // Header
+    //
+
+    file.write(ReplayLogMagic, sizeof(ReplayLogMagic));
+    BinaryFileTools::Write<std::uint32_t>(file, ReplayLogVersion);
+    BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(sizeof(GameParameters)));
+
+    BinaryFileTools::WriteString(file, ShipDefinitionFilepath.u8string());
+    BinaryFileTools::Write<std::uint32_t>(file, RandomSeed);
+    BinaryFileTools::Write<std::int32_t>(file, CanvasSize.Width);
+    BinaryFileTools::Write<std::int32_t>(file, CanvasSize.Height);
+
+    BinaryFileTools::Write<std::uint64_t>(file, StepCount);
+
+    //
+    // Game parameters
+    //
+
+    BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(GameParametersSnapshots.size()));
+    for (auto const & gameParameters : GameParametersSnapshots)
+    {
+        BinaryFileTools::Write<GameParameters>(file, gameParameters);
+    }
+
+    //
+    // Events
+    //
+
+    BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(Events.size()));
+    for (auto const & event : Events)
+    {
+        BinaryFileTools::Write<std::uint64_t>(file, event.Step);
+        BinaryFileTools::Write<std::uint8_t>(file, static_cast<std::uint8_t>(event.Type));
+
+        switch (event.Type)
+        {
+            case Event::EventType::GameParameters:
+            {
+                BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(event.GameParametersIndex));
+                break;
+            }
+
+            case Event::EventType::View:
+            {
+                BinaryFileTools::Write<vec2f>(file, event.CameraWorldPosition);
+                BinaryFileTools::Write<float>(file, event.Zoom);
+                break;
+            }
+
+            case Event::EventType::Command:
+            {
+                BinaryFileTools::Write<std::uint8_t>(file, static_cast<std::uint8_t>(event.Command.Type));
+                BinaryFileTools::Write<ShipId>(file, event.Command.Ship);
+                BinaryFileTools::Write<vec2f>(file, event.Command.Position1);
+                BinaryFileTools::Write<vec2f>(file, event.Command.Position2);
+                BinaryFileTools::Write<float>(file, event.Command.Value);
+                break;
+            }
+        }
+    }
+
+    if (!file.good())
+    {
+        throw GameException("Error writing file \"" + filepath.string() + "\"");
+    }
+}
@@ -0,0 +1,210 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-09
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "GameParameters.h"
+#include "Physics.h"
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/ImageSize.h>
+#include <GameCore/Vectors.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/*
+ * One world-side interaction, in world coordinates - i.e. after all the screen-to-world
+ * conversions and strength scalings made by the game controller - so that it may be
+ * re-executed regardless of the camera.
+ */
+struct ReplayCommand
+{
+    enum class CommandType : std::uint8_t
+    {
+        MoveBy,
+        RotateBy,
+        DestroyAt,
+        RepairAt,
+        SawThrough,
+        DrawTo,
+        SwirlAt,
+        DisplaceOceanSurfaceAt,
+        TogglePinAt,
+        InjectBubblesAt,
+        FloodAt,
+        ToggleAntiMatterBombAt,
+        ToggleImpactBombAt,
+        ToggleRCBombAt,
+        ToggleTimerBombAt,
+        DetonateRCBombs,
+        DetonateAntiMatterBombs,
+        AdjustOceanFloorTo,
+        ScrubThrough
+    };
+
+    CommandType Type;
+    ShipId Ship;
+    vec2f Position1;
+    vec2f Position2;
+    float Value;
+
+    ReplayCommand(
+        CommandType type,
+        ShipId ship,
+        vec2f const & position1,
+        vec2f const & position2,
+        float value)
+        : Type(type)
+        , Ship(ship)
+        , Position1(position1)
+        , Position2(position2)
+        , Value(value)
+    {}
+
+    ReplayCommand(
+        CommandType type,
+        vec2f const & position1 = vec2f::zero(),
+        vec2f const & position2 = vec2f::zero(),
+        float value = 0.0f)
+        : ReplayCommand(type, NoneShip, position1, position2, value)
+    {}
+
+    /*
+     * Runs the command against the world; returns whether the command
+     * had any effect, for the commands that tell.
+     */
+    bool Apply(
+        Physics::World & world,
+        GameParameters const & gameParameters) const;
+};
+
+/*
+ * A recording of a session, from the load of a ship onwards, which may be re-executed
+ * step by step to reproduce the session exactly - e.g. to compare the performance of
+ * different builds.
+ *
+ * Game parameters are stored as they are in memory, hence a log may only be replayed
+ * by builds with the same GameParameters layout.
+ */
+struct ReplayLog
+{
+    struct Event
+    {
+        enum class EventType : std::uint8_t
+        {
+            GameParameters,
+            View,
+            Command
+        };
+
+        // The number of simulation steps that had run when this event happened
+        std::uint64_t Step;
+
+        EventType Type;
+
+        // GameParameters
+        size_t GameParametersIndex;
+
+        // View
+        vec2f CameraWorldPosition;
+        float Zoom;
+
+        // Command
+        ReplayCommand Command;
+
+        static Event MakeGameParameters(std::uint64_t step, size_t gameParametersIndex)
+        {
+            return Event(step, EventType::GameParameters, gameParametersIndex, vec2f::zero(), 0.0f, ReplayCommand(ReplayCommand::CommandType::DetonateRCBombs));
+        }
+
+        static Event MakeView(std::uint64_t step, vec2f const & cameraWorldPosition, float zoom)
+        {
+            return Event(step, EventType::View, 0, cameraWorldPosition, zoom, ReplayCommand(ReplayCommand::CommandType::DetonateRCBombs));
+        }
+
+        static Event MakeCommand(std::uint64_t step, ReplayCommand const & command)
+        {
+            return Event(step, EventType::Command, 0, vec2f::zero(), 0.0f, command);
+        }
+
+    private:
+
+        Event(
+            std::uint64_t step,
+            EventType type,
+            size_t gameParametersIndex,
+            vec2f const & cameraWorldPosition,
+            float zoom,
+            ReplayCommand const & command)
+            : Step(step)
+            , Type(type)
+            , GameParametersIndex(gameParametersIndex)
+            , CameraWorldPosition(cameraWorldPosition)
+            , Zoom(zoom)
+            , Command(command)
+        {}
+    };
+
+    std::filesystem::path ShipDefinitionFilepath;
+
+    // The seed the random engine was reset with before loading the ship
+    unsigned int RandomSeed;
+
+    // The visible world depends on the canvas too, and some of the simulation depends on the former
+    ImageSize CanvasSize;
+
+    std::vector<GameParameters> GameParametersSnapshots;
+
+    // In the order in which they happened
+    std::vector<Event> Events;
+
+    // The number of simulation steps run in total
+    std::uint64_t StepCount;
+
+    ReplayLog(
+        std::filesystem::path shipDefinitionFilepath,
+        unsigned int randomSeed,
+        ImageSize canvasSize)
+        : ShipDefinitionFilepath(std::move(shipDefinitionFilepath))
+        , RandomSeed(randomSeed)
+        , CanvasSize(canvasSize)
+        , GameParametersSnapshots()
+        , Events()
+        , StepCount(0)
+    {}
+
+    static ReplayLog Load(std::filesystem::path const & filepath);
+
+    void Save(std::filesystem::path const & filepath) const;
+};
+
+/*
+ * What we've measured while replaying a log.
+ */
+struct ReplayStatistics
+{
+    std::uint64_t StepCount;
+    std::chrono::steady_clock::duration TotalUpdateDuration;
+    std::chrono::steady_clock::duration MinUpdateDuration;
+    std::chrono::steady_clock::duration MaxUpdateDuration;
+
+    ReplayStatistics()
+        : StepCount(0)
+        , TotalUpdateDuration(0)
+        , MinUpdateDuration(std::chrono::steady_clock::duration::max())
+        , MaxUpdateDuration(0)
+    {}
+
+    float GetAverageUpdateDurationMillis() const
+    {
+        if (StepCount == 0)
+            return 0.0f;
+
+        return std::chrono::duration<float, std::milli>(TotalUpdateDuration).count() / static_cast<float>(StepCount);
+    }
+};
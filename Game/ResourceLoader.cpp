@@ -5,10 +5,51 @@
 ***************************************************************************************/
 #include "ResourceLoader.h"
 
+#include <GameCore/GameException.h>
+#include <GameCore/Log.h>
+#include <GameCore/ResourceArchive.h>
+
+#include <mutex>
+
 ResourceLoader::ResourceLoader()
 {
-    // Nothing special, for now.
-    // We'll be busy though when Resource Packs are implemented.
+    //
+    // Mount the packed resources, if they've been packed; the loose files
+    // still override whatever is in the archive
+    //
+
+    static std::once_flag mountOnceFlag;
+    std::call_once(
+        mountOnceFlag,
+        []()
+        {
+            auto const archiveFilePath = GetResourceArchiveFilePath();
+
+            std::error_code ec;
+            if (std::filesystem::is_regular_file(archiveFilePath, ec))
+            {
+                try
+                {
+                    ResourceArchive::Mount(
+                        ResourceArchive::Open(archiveFilePath),
+                        GetDataRootPath());
+                }
+                catch (GameException const & ex)
+                {
+                    LogMessage("ResourceLoader: ignoring resource archive: ", ex.what());
+                }
+            }
+        });
+}
+
+std::filesystem::path ResourceLoader::GetDataRootPath()
+{
+    return std::filesystem::path("Data");
+}
+
+std::filesystem::path ResourceLoader::GetResourceArchiveFilePath()
+{
+    return GetDataRootPath().concat(ResourceArchive::FileExtension);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -40,6 +81,11 @@ std::filesystem::path ResourceLoader::GetTexturesFilePath() const
     return std::filesystem::path("Data") / "Textures";
 }
 
+std::filesystem::path ResourceLoader::GetBakedGenericTextureAtlasFilePath() const
+{
+    return GetTexturesFilePath() / "generic_texture_atlas.bin";
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 // Fonts
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -48,12 +94,11 @@ std::vector<std::filesystem::path> ResourceLoader::GetFontPaths() const
 {
     std::vector<std::filesystem::path> filepaths;
 
-    for (auto const & entryIt : std::filesystem::directory_iterator(std::filesystem::path("Data") / "Fonts"))
+    for (auto const & filepath : ResourceArchive::ListDirectory(std::filesystem::path("Data") / "Fonts"))
     {
-        if (std::filesystem::is_regular_file(entryIt.path())
-            && entryIt.path().extension().string() == ".bff")
+        if (filepath.extension().string() == ".bff")
         {
-            filepaths.push_back(entryIt.path());
+            filepaths.push_back(filepath);
         }
     }
 
@@ -86,12 +131,11 @@ std::filesystem::path ResourceLoader::GetMusicFilepath(std::string const & music
 std::vector<std::string> ResourceLoader::GetSoundNames() const
 {
     std::vector<std::string> filenames;
-    for (auto const & entryIt : std::filesystem::directory_iterator(std::filesystem::path("Data") / "Sounds"))
+    for (auto const & filepath : ResourceArchive::ListDirectory(std::filesystem::path("Data") / "Sounds"))
     {
-        if (std::filesystem::is_regular_file(entryIt.path())
-            && entryIt.path().extension().string() == ".flac")
+        if (filepath.extension().string() == ".flac")
         {
-            filenames.push_back(entryIt.path().stem().string());
+            filenames.push_back(filepath.stem().string());
         }
     }
 
@@ -17,6 +17,15 @@ public:
 
 public:
 
+    //
+    // Packed resources
+    //
+
+    static std::filesystem::path GetDataRootPath();
+
+    static std::filesystem::path GetResourceArchiveFilePath();
+
+
     //
     // Ships
     //
@@ -32,6 +41,8 @@ public:
 
     std::filesystem::path GetTexturesFilePath() const;
 
+    std::filesystem::path GetBakedGenericTextureAtlasFilePath() const;
+
 
     //
     // Fonts
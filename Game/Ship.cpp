@@ -4,19 +4,31 @@
  * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
  ***************************************************************************************/
 #include "Physics.h"
+#include "PointCollisions.h"
+#include "ShipBuilder.h"
 
+#include <GPUCalc/GPUCalculatorFactory.h>
+
+#include <GameOpenGL/GameOpenGL.h>
+
+#include <GameCore/BinaryFileTools.h>
 #include <GameCore/GameDebug.h>
+#include <GameCore/GameException.h>
 #include <GameCore/GameMath.h>
 #include <GameCore/GameRandomEngine.h>
 #include <GameCore/Log.h>
+#include <GameCore/TaskThreadPool.h>
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstring>
 #include <limits>
+#include <numeric>
 #include <queue>
 #include <set>
+#include <string>
 
 //
 // Frequencies of low-frequency steps
@@ -25,8 +37,187 @@
 static constexpr int LowFrequencyPeriod = 50; // Number of simulation steps
 
 static constexpr int UpdateSinkingFrequency = 12;
-static constexpr int RotPointsFrequency = 25;
-static constexpr int DecaySpringsFrequency = 50;
+static constexpr int RemoveInactiveWaterPointsFrequency = 37;
+static constexpr int UpdateWaterDynamicsPeriodFrequency = 5;
+static constexpr int SortSpringsSpatiallyFrequency = 43;
+static constexpr int UpdateLiveSpringsFrequency = 29;
+
+// Maintenance that may be run at idle time is only run by the ship itself once it's been
+// pending for this many steps - and then at its own low-frequency step
+static constexpr std::uint32_t MaxMaintenanceDelay = 2 * LowFrequencyPeriod;
+
+//
+// Low-frequency water dynamics
+//
+
+// Ships taking in more water than this per step run the water dynamics at full rate
+static constexpr float MaxLowFrequencyWaterTakenPerStep = 0.5f;
+
+//
+// Sinking detection
+//
+
+// We only count a point as wet if its water is above this threshold
+static constexpr float WetPointWaterThreshold = 0.5f;
+
+//
+// GPU mechanical dynamics
+//
+
+// Smaller ships run their mechanical dynamics on the CPU, as the cost of the transfers would
+// outweigh the gain
+static constexpr size_t MinPointsForGPUMechanicalDynamics = 4096;
+
+// The ocean floor as uploaded to the GPU, sampled as finely as the ocean floor itself
+static constexpr size_t GPUOceanFloorSampleCount = 2048 + 1;
+static constexpr float GPUOceanFloorDx = GameParameters::MaxWorldWidth / static_cast<float>(GPUOceanFloorSampleCount - 1);
+
+// When we can render straight from the GPU's positions, we only read the point dynamics
+// back - for interactions, events, and the checks that run on the CPU - once every so many steps
+static constexpr uint64_t GPUMechanicalDynamicsReadBackInterval = 4;
+
+//
+// GPU water diffusion
+//
+
+// Smaller ships diffuse water on the CPU, as the cost of the transfers would outweigh the gain
+static constexpr size_t MinPointsForGPUWaterDiffusion = 4096;
+
+//
+// Parallelism thresholds
+//
+
+static constexpr size_t MinSpringsForParallelSpringForces = 8192;
+static constexpr size_t MinSpringsPerParallelSpringForcesTask = 1024;
+
+//
+// Spatial spring order
+//
+
+// The side of the square cells springs are bucketed into when sorting them spatially
+static constexpr float SpatialSpringSortCellSize = 4.0f;
+
+//
+// Live springs
+//
+
+// Springs are visited through the list of live springs - rather than all of them, deleted
+// ones contributing nothing - only once at least this fraction of them has been deleted,
+// as below that the indirection costs more than the deleted springs
+static constexpr float MinDeletedSpringFractionForLiveSprings = 0.25f;
+
+//
+// Island sleeping thresholds
+//
+
+// Islands whose points are all slower than this may fall asleep; high enough
+// to tolerate the jitter of points resting on the sea floor
+static constexpr float MaxSleepingIslandPointSpeed = 1.0f;
+
+// Islands whose points' water is all slower than this may fall asleep
+static constexpr float MaxSleepingIslandWaterSpeed = 0.5f;
+
+// Islands fall asleep only when at least one of their points is closer than this
+// to the sea floor
+static constexpr float MaxSleepingIslandDistanceFromSeaFloor = 1.0f;
+
+// The number of consecutive quiescent steps after which an island falls asleep
+static constexpr uint32_t QuiescentStepsBeforeSleeping = 150;
+
+//
+// Adaptive mechanical iterations
+//
+
+// Ships whose springs are all strained less than this fraction of their strength
+// run with the min number of iterations...
+static constexpr float MinAdaptiveIterationsStrainRatio = 0.1f;
+
+// ...while ships with at least one spring strained more than this fraction of its
+// strength run with the max number of iterations
+static constexpr float MaxAdaptiveIterationsStrainRatio = 0.5f;
+
+// The number of consecutive steps after which a ship may drop one iteration; ships
+// that need more iterations get them right away
+static constexpr uint32_t StepsBeforeAdaptiveIterationsDecrease = 10;
+
+//
+// Interactive waves
+//
+
+// Points hitting the water faster than this push the water surface down
+static constexpr float MinOceanSurfaceImpactSpeed = 5.0f;
+
+// The displacement of the water surface for each m/s of an impacting point
+static constexpr float OceanSurfaceImpactDisplacementPerSpeed = 0.002f;
+
+// The displacement of the water surface at the center of a bomb blast
+static constexpr float OceanSurfaceBlastDisplacement = 3.0f;
+
+//
+// Sea floor collision culling
+//
+
+// Ships skip the collisions with the sea floor during a step when the lowest their
+// points may get - given their current velocities - is higher than the floor under
+// them by at least this margin, which absorbs the accelerations during the step
+static constexpr float SeaFloorCollisionCullingMargin = 10.0f;
+
+//
+// Force fields
+//
+
+// Force fields with a radius visit the points that are within this margin of
+// the radius at the beginning of the step, as points keep moving during the step
+static constexpr float ForceFieldCandidateMargin = 2.0f;
+
+//
+// Bounds
+//
+
+// An inverted box, which the first point extended into it takes over
+static Geometry::AABB const EmptyAABB(
+    std::numeric_limits<float>::max(),
+    std::numeric_limits<float>::lowest(),
+    std::numeric_limits<float>::lowest(),
+    std::numeric_limits<float>::max());
+
+// The slack around a ship's points that still counts as the ship, for the view culling;
+// covers what's drawn beyond points - the textures of bombs and pinned points - and
+// the interpolation of positions between simulation steps
+static constexpr float RenderCullingMargin = 10.0f;
+
+// The on-screen size (in pixels) under which a ship is only drawn with its triangles
+static constexpr float LowDetailRenderMaxScreenSize = 8.0f;
+
+//
+// Electrical
+//
+
+// Generators wetter than this do not power their circuits
+static constexpr float MaxDryGeneratorWater = 0.3f;
+
+//
+// Light diffusion
+//
+
+// Lamp light below this does not visibly light a point; each lamp only lights
+// the points within the radius at which its light falls to this
+static constexpr float MinVisibleLampLight = 0.005f;
+
+// Ships with at least this many lamps bucket their points into a grid, so that
+// each lamp only visits the cells within its radius
+static constexpr size_t MinLampsForLightGrid = 8;
+
+// The min side of the grid's square cells; cells get larger when the ship spreads
+// out, so that the grid never has more cells than points
+static constexpr float MinLightGridCellSize = 4.0f;
+
+// The light of the last diffusion is reused for as long as no lamp changes and no
+// point moves farther than this from where it was at that diffusion
+static constexpr float MaxLightCachePointDisplacement = 0.1f;
+
+// The exponent the shaders use for lamps without spread, which only light their own point
+static constexpr float PointLampLightExponent = 16.0f;
 
 
 namespace Physics {
@@ -49,7 +240,8 @@ Ship::Ship(
     Points && points,
     Springs && springs,
     Triangles && triangles,
-    ElectricalElements && electricalElements)
+    ElectricalElements && electricalElements,
+    ShipProxyLattice && proxyLattice)
     : mId(id)
     , mParentWorld(parentWorld)
     , mGameEventHandler(std::move(gameEventHandler))
@@ -62,10 +254,20 @@ Ship::Ship(
     , mCurrentConnectivityVisitSequenceNumber()
     , mMaxMaxPlaneId(0)
     , mCurrentElectricalVisitSequenceNumber()
+    , mIsElectricalConnectivityDirty(true)
+    , mAreGeneratorsWet(mElectricalElements.Generators().size(), false)
     , mIsStructureDirty(true)
+    , mAreElementsDirtyForRendering(false)
     , mLastDebugShipRenderMode()
-    , mPlaneTriangleIndicesToRender()
+    , mAreStressedSpringsUploaded(false)
+    , mConnectedComponents()
+    , mConnectivityBrokenSpringEndpoints()
+    , mIsFullConnectivityVisitNeeded(true)
+    , mConnectivityVisitSides()
     , mIsSinking(false)
+    , mStatistics()
+    , mPerfStats()
+    , mWorkBufferArena()
     , mWaterSplashedRunningAverage()
     , mPinnedPoints(
         mParentWorld,
@@ -81,30 +283,373 @@ Ship::Ship(
         mPoints,
         mSprings)
     , mCurrentForceFields()
+    , mForceFieldCandidatePointIndices()
+    , mPackedForceFields()
+    , mPendingOceanSurfaceDisplacements()
+    , mSpringForcesImplementation(GetBestSpringForcesImplementation())
+    , mParallelSpringForceTasks()
+    , mKernelVerificationBuffer()
+    , mKernelVerificationMaxDivergence(0.0f)
+    , mSpringConstraintsSubstep()
+    , mParallelSpringConstraintTasks()
+    , mRopeChains()
+    , mRopeChainSprings()
+    , mRopeChainPoints()
+    , mMaxRopeChainSpringCount(0)
+    , mSpatiallySortedSprings()
+    , mAreSpatiallySortedSpringsDirty(true)
+    , mSpatiallySortedSpringsDirtyStepCount(0)
+    , mLiveSprings()
+    , mAreLiveSpringsDirty(false)
+    , mLiveSpringsDirtyStepCount(0)
+    , mIsFrontierSpring(mSprings.GetBufferElementCount(), false)
+    , mPointFrontierSpringCounts(mPoints.GetBufferElementCount(), 0)
+    , mFrontierPoints()
+    , mFrontierPointPositions(mPoints.GetBufferElementCount(), NoneElementIndex)
+    , mIslandSleepStates()
+    , mHasSleepingIslands(false)
+    , mAwakePoints()
+    , mAwakeNonEphemeralPointCount(0)
+    , mAwakeSprings()
+    , mIslandPointOffsets()
+    , mIslandPointIndices()
+    , mIslandSpringOffsets()
+    , mIslandSpringIndices()
+    , mWaterActivePoints()
+    , mIsWaterActivePoint(mPoints.GetBufferElementCount(), false)
+    , mAreWaterActivePointsUnsorted(false)
+    , mWaterDynamicsPeriod(1)
+    , mLastWaterTakenPerStep(0.0f)
+    , mMechanicalDynamicsGPUCalculator()
+    , mIsMechanicalDynamicsGPUCalculatorUnavailable(false)
+    , mGPUMechanicalDynamicsStepCount(0)
+    , mAreGPUPointDynamicsAhead(false)
+    , mWaterDiffusionGPUCalculator()
+    , mIsWaterDiffusionGPUCalculatorUnavailable(false)
+    , mIsWaterDiffusionGPUAdjacencyDirty(true)
+    , mLightGridCellOffsets()
+    , mLightGridPointIndices()
+    , mLightGridOrigin(vec2f::zero())
+    , mLightGridCellSize(MinLightGridCellSize)
+    , mLightGridWidth(0)
+    , mLightGridHeight(0)
+    , mInteractionGridCellOffsets()
+    , mInteractionGridPointIndices()
+    , mInteractionGridOrigin(vec2f::zero())
+    , mInteractionGridCellSize(0.0f)
+    , mInteractionGridWidth(0)
+    , mInteractionGridHeight(0)
+    , mIsInteractionGridCurrent(false)
+    , mInteractionGridSpringCellOffsets()
+    , mInteractionGridSpringIndices()
+    , mAreInteractionGridSpringsCurrent(false)
+    , mNearestPointCandidates()
+    , mLightPointPositions()
+    , mLightLuminiscenceAdjustment(0.0f)
+    , mLightSpreadAdjustment(0.0f)
+    , mIsLightDirty(true)
+    , mAdaptiveNumMechanicalDynamicsIterations(0)
+    , mAdaptiveNumMechanicalDynamicsIterationsDecreaseStepCount(0)
+    , mAABB(EmptyAABB)
+    , mConnectedComponentAABBs()
+    , mCollisionComponentTriangleOffsets()
+    , mCollisionComponentTriangleIndices()
+    , mAreCollisionComponentBucketsCurrent(false)
+    , mCollisionGridCellOffsets()
+    , mCollisionGridTriangleIndices()
+    , mProxyLattice(std::move(proxyLattice))
 {
-    mPlaneTriangleIndicesToRender.reserve(mTriangles.GetElementCount());
-
     // Set handlers
-    mPoints.RegisterDetachHandler(std::bind(&Ship::PointDetachHandler, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
-    mPoints.RegisterEphemeralParticleDestroyHandler(std::bind(&Ship::EphemeralParticleDestroyHandler, this, std::placeholders::_1));
-    mSprings.RegisterDestroyHandler(std::bind(&Ship::SpringDestroyHandler, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    mSprings.RegisterRestoreHandler(std::bind(&Ship::SpringRestoreHandler, this, std::placeholders::_1, std::placeholders::_2));
-    mTriangles.RegisterDestroyHandler(std::bind(&Ship::TriangleDestroyHandler, this, std::placeholders::_1));
-    mTriangles.RegisterRestoreHandler(std::bind(&Ship::TriangleRestoreHandler, this, std::placeholders::_1));
-    mElectricalElements.RegisterDestroyHandler(std::bind(&Ship::ElectricalElementDestroyHandler, this, std::placeholders::_1));
+    mPoints.RegisterShipHandler(this);
+    mSprings.RegisterShipHandler(this);
+    mTriangles.RegisterShipHandler(this);
+    mElectricalElements.RegisterShipHandler(this);
 
     // Do a first connectivity pass (for the first Update)
     RunConnectivityVisit();
+
+    BuildRopeChains();
+
+    InitializeFrontier();
 }
 
 Ship::~Ship()
 {
 }
 
+Geometry::AABB Ship::CalculateAABB() const
+{
+    Geometry::AABB box(
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::max());
+
+    auto const extendTo = [&](ElementIndex pointIndex)
+    {
+        vec2f const & position = mPoints.GetPosition(pointIndex);
+
+        box.BottomLeft.x = std::min(box.BottomLeft.x, position.x);
+        box.BottomLeft.y = std::min(box.BottomLeft.y, position.y);
+        box.TopRight.x = std::max(box.TopRight.x, position.x);
+        box.TopRight.y = std::max(box.TopRight.y, position.y);
+    };
+
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+        extendTo(pointIndex);
+
+    for (auto pointIndex : mPoints.LiveEphemeralPoints())
+        extendTo(pointIndex);
+
+    return box;
+}
+
+void Ship::FlushOceanSurfaceDisplacements()
+{
+    for (auto const & displacement : mPendingOceanSurfaceDisplacements)
+    {
+        mParentWorld.DisplaceOceanSurfaceAt(
+            displacement.first,
+            displacement.second);
+    }
+
+    mPendingOceanSurfaceDisplacements.clear();
+}
+
+ShipStatistics Ship::GetStatistics() const
+{
+    ShipStatistics statistics = mStatistics;
+
+    statistics.PointCount = mPoints.GetShipPointCount();
+    statistics.SpringCount = mSprings.GetElementCount();
+    statistics.EphemeralParticleCount = mPoints.LiveEphemeralPoints().size();
+    statistics.SinkingShipCount = mIsSinking ? 1 : 0;
+
+    return statistics;
+}
+
+void Ship::ReportMemory(MemoryReport & report) const
+{
+    report.PushSection("Ship " + std::to_string(mId));
+
+    report.PushSection("Points");
+    mPoints.ReportMemory(report);
+    report.PopSection();
+
+    report.PushSection("Springs");
+    mSprings.ReportMemory(report);
+    report.PopSection();
+
+    report.PushSection("Triangles");
+    mTriangles.ReportMemory(report);
+    report.PopSection();
+
+    report.PushSection("ElectricalElements");
+    mElectricalElements.ReportMemory(report);
+    report.PopSection();
+
+    report.PushSection("ProxyLattice");
+    mProxyLattice.ReportMemory(report);
+    report.PopSection();
+
+    report.Add("AreGeneratorsWet", mAreGeneratorsWet);
+    report.Add("ConnectedComponents", mConnectedComponents);
+    report.Add("ConnectivityBrokenSpringEndpoints", mConnectivityBrokenSpringEndpoints);
+    report.Add("PackedForceFields", mPackedForceFields);
+    report.Add("PendingOceanSurfaceDisplacements", mPendingOceanSurfaceDisplacements);
+    report.Add("SpatiallySortedSprings", mSpatiallySortedSprings);
+    report.Add("LiveSprings", mLiveSprings);
+    report.Add("IsFrontierSpring", mIsFrontierSpring);
+    report.Add("PointFrontierSpringCounts", mPointFrontierSpringCounts);
+    report.Add("FrontierPoints", mFrontierPoints);
+    report.Add("FrontierPointPositions", mFrontierPointPositions);
+    report.Add("IslandSleepStates", mIslandSleepStates);
+    report.Add("AwakePoints", mAwakePoints);
+    report.Add("AwakeSprings", mAwakeSprings);
+    report.Add("IslandPointOffsets", mIslandPointOffsets);
+    report.Add("IslandPointIndices", mIslandPointIndices);
+    report.Add("IslandSpringOffsets", mIslandSpringOffsets);
+    report.Add("IslandSpringIndices", mIslandSpringIndices);
+    report.Add("WaterActivePoints", mWaterActivePoints);
+    report.Add("IsWaterActivePoint", mIsWaterActivePoint);
+    report.Add("LightGridCellOffsets", mLightGridCellOffsets);
+    report.Add("LightGridPointIndices", mLightGridPointIndices);
+    report.Add("InteractionGridCellOffsets", mInteractionGridCellOffsets);
+    report.Add("InteractionGridPointIndices", mInteractionGridPointIndices);
+    report.Add("InteractionGridSpringCellOffsets", mInteractionGridSpringCellOffsets);
+    report.Add("InteractionGridSpringIndices", mInteractionGridSpringIndices);
+    report.Add("LightPointPositions", mLightPointPositions);
+    report.Add("KernelVerificationBuffer", mKernelVerificationBuffer);
+    report.Add("ConnectedComponentAABBs", mConnectedComponentAABBs);
+    report.Add("CollisionComponentTriangleOffsets", mCollisionComponentTriangleOffsets);
+    report.Add("CollisionComponentTriangleIndices", mCollisionComponentTriangleIndices);
+    report.Add("CollisionGridCellOffsets", mCollisionGridCellOffsets);
+    report.Add("CollisionGridTriangleIndices", mCollisionGridTriangleIndices);
+    report.Add("WorkBufferArena", mWorkBufferArena.GetByteSize());
+
+    size_t forceFieldCandidatePointIndicesByteSize = 0;
+    for (auto const & candidatePointIndices : mForceFieldCandidatePointIndices)
+        forceFieldCandidatePointIndicesByteSize += candidatePointIndices.capacity() * sizeof(ElementIndex);
+    report.Add("ForceFieldCandidatePointIndices", forceFieldCandidatePointIndicesByteSize);
+
+    report.PopSection();
+}
+
+void Ship::SaveState(std::ostream & stream) const
+{
+    BinaryFileTools::Write<std::uint32_t>(stream, static_cast<std::uint32_t>(mPoints.GetShipPointCount()));
+    BinaryFileTools::Write<std::uint32_t>(stream, static_cast<std::uint32_t>(mSprings.GetElementCount()));
+    BinaryFileTools::Write<std::uint32_t>(stream, static_cast<std::uint32_t>(mTriangles.GetElementCount()));
+
+    for (auto s : mSprings)
+        BinaryFileTools::Write<std::uint8_t>(stream, mSprings.IsDeleted(s) ? 1 : 0);
+
+    for (auto t : mTriangles)
+        BinaryFileTools::Write<std::uint8_t>(stream, mTriangles.IsDeleted(t) ? 1 : 0);
+
+    mPoints.SaveState(stream);
+}
+
+void Ship::LoadState(
+    std::istream & stream,
+    GameParameters const & gameParameters)
+{
+    auto const pointCount = BinaryFileTools::Read<std::uint32_t>(stream);
+    auto const springCount = BinaryFileTools::Read<std::uint32_t>(stream);
+    auto const triangleCount = BinaryFileTools::Read<std::uint32_t>(stream);
+    if (!stream.good()
+        || pointCount != mPoints.GetShipPointCount()
+        || springCount != mSprings.GetElementCount()
+        || triangleCount != mTriangles.GetElementCount())
+    {
+        throw GameException("The snapshot does not match the structure of ship " + std::to_string(mId));
+    }
+
+    //
+    // Break what was broken; the ship is fresh, hence everything is intact
+    //
+
+    std::vector<std::uint8_t> isDeleted(springCount);
+    BinaryFileTools::ReadArray(stream, isDeleted.data(), isDeleted.size());
+    for (auto s : mSprings)
+    {
+        if (isDeleted[s] != 0 && !mSprings.IsDeleted(s))
+        {
+            mSprings.Destroy(
+                s,
+                Springs::DestroyOptions::DoNotFireBreakEvent
+                | Springs::DestroyOptions::DestroyOnlyConnectedTriangle,
+                gameParameters,
+                mPoints);
+        }
+    }
+
+    isDeleted.resize(triangleCount);
+    BinaryFileTools::ReadArray(stream, isDeleted.data(), isDeleted.size());
+    for (auto t : mTriangles)
+    {
+        if (isDeleted[t] != 0 && !mTriangles.IsDeleted(t))
+        {
+            mTriangles.Destroy(t);
+        }
+    }
+
+    mPoints.LoadState(stream);
+
+    if (!stream.good())
+    {
+        throw GameException("The snapshot of ship " + std::to_string(mId) + " is truncated");
+    }
+
+    //
+    // Re-derive the state that follows from the points
+    //
+
+    for (auto p : mPoints.NonEphemeralPoints())
+    {
+        if (mPoints.GetWater(p) > 0.0f)
+            ActivateWaterPoint(p);
+    }
+
+    WakeUpAllIslands();
+}
+
 void Ship::Update(
     float currentSimulationTime,
     GameParameters const & gameParameters,
-    Render::RenderContext const & renderContext)
+    float averageUpdateDurationMillis,
+    SimulationView const & simulationView)
+{
+    if (gameParameters.DoAdaptMechanicalDynamicsIterations)
+    {
+        // Run this step with our own number of mechanical iterations; Points and Springs
+        // pick it up as if it were a parameter change, hence we change it sparingly
+        GameParameters adaptedGameParameters = gameParameters;
+        adaptedGameParameters.NumMechanicalDynamicsIterationsAdjustment = CalculateAdaptiveNumMechanicalDynamicsIterationsAdjustment(
+            gameParameters,
+            averageUpdateDurationMillis);
+
+        InternalUpdate(
+            currentSimulationTime,
+            adaptedGameParameters,
+            simulationView);
+    }
+    else
+    {
+        mAdaptiveNumMechanicalDynamicsIterations = 0;
+
+        InternalUpdate(
+            currentSimulationTime,
+            gameParameters,
+            simulationView);
+    }
+
+    if (gameParameters.KernelVerification != KernelVerificationMode::None)
+    {
+        PublishKernelVerification(gameParameters);
+    }
+
+    // Nothing handed out by the arena outlives the step
+    mWorkBufferArena.Reset();
+
+    ++(mPerfStats.UpdateCount);
+}
+
+void Ship::PublishKernelVerification(GameParameters const & gameParameters)
+{
+    char const * phaseName = "";
+    switch (gameParameters.KernelVerification)
+    {
+        case KernelVerificationMode::SpringForces:
+        {
+            phaseName = "Spring Forces";
+            break;
+        }
+
+        case KernelVerificationMode::LightDiffusion:
+        {
+            phaseName = "Light Diffusion";
+            break;
+        }
+
+        case KernelVerificationMode::None:
+        {
+            assert(false);
+            break;
+        }
+    }
+
+    mGameEventHandler->OnCustomProbe(
+        "Ship " + std::to_string(mId) + " " + phaseName + " Divergence",
+        mKernelVerificationMaxDivergence);
+
+    mKernelVerificationMaxDivergence = 0.0f;
+}
+
+void Ship::InternalUpdate(
+    float currentSimulationTime,
+    GameParameters const & gameParameters,
+    SimulationView const & simulationView)
 {
     // Get the current wall clock time
     auto const currentWallClockTime = GameWallClock::GetInstance().Now();
@@ -116,6 +661,12 @@ void Ship::Update(
     VerifyInvariants();
 #endif
 
+    //
+    // Remember where points are before this step, for render interpolation
+    //
+
+    mPoints.SavePreviousPositions();
+
     //
     // Process eventual parameter changes
     //
@@ -124,42 +675,77 @@ void Ship::Update(
         gameParameters);
 
     mSprings.UpdateGameParameters(
-        gameParameters,
-        mPoints);
+        gameParameters);
 
     //
-    // Rot points
+    // Wake up all islands if we can't trust them to be asleep anymore
     //
 
-    if (mCurrentSimulationSequenceNumber.IsStepOf(RotPointsFrequency - 1, LowFrequencyPeriod))
+    if (mIsStructureDirty || !gameParameters.DoSleepQuiescentIslands)
     {
-        RotPoints(
-            currentSimulationTime,
-            gameParameters);
+        WakeUpAllIslands();
     }
 
+    //
+    // Rot points and decay springs - each step takes care of its own slice
+    // of them, so that all of them are visited once per low-frequency period
+    //
+
+    RotPoints(
+        currentSimulationTime,
+        gameParameters);
+
+    DecaySprings(
+        currentSimulationTime,
+        gameParameters);
+
+
 
     //
-    // Decay springs
+    // Sort springs spatially, if the ship's structure has changed since
+    // the last time we've sorted them - and nobody has done it for us at
+    // idle time for a while
     //
 
-    if (mCurrentSimulationSequenceNumber.IsStepOf(DecaySpringsFrequency - 1, LowFrequencyPeriod))
+    if (gameParameters.DoSortSpringsSpatially)
     {
-        DecaySprings(
-            currentSimulationTime,
-            gameParameters);
+        if (mAreSpatiallySortedSpringsDirty
+            && ++mSpatiallySortedSpringsDirtyStepCount >= MaxMaintenanceDelay
+            && mCurrentSimulationSequenceNumber.IsStepOf(SortSpringsSpatiallyFrequency - 1, LowFrequencyPeriod))
+        {
+            UpdateSpatiallySortedSprings();
+        }
+    }
+    else if (!mSpatiallySortedSprings.empty())
+    {
+        mSpatiallySortedSprings.clear();
+        mAreSpatiallySortedSpringsDirty = true;
     }
 
+    //
+    // Catch up with the springs destroyed since the last time we've listed the live ones,
+    // unless that has been done for us at idle time
+    //
 
+    if (mAreLiveSpringsDirty
+        && ++mLiveSpringsDirtyStepCount >= MaxMaintenanceDelay
+        && mCurrentSimulationSequenceNumber.IsStepOf(UpdateLiveSpringsFrequency - 1, LowFrequencyPeriod))
+    {
+        UpdateLiveSprings();
+    }
 
     //
     // Update mechanical dynamics
     //
 
-    UpdateMechanicalDynamics(
-        currentSimulationTime,
-        gameParameters,
-        renderContext);
+    {
+        SHIP_PERF_SCOPE(mPerfStats, MechanicalDynamics);
+
+        UpdateMechanicalDynamics(
+            currentSimulationTime,
+            gameParameters,
+            simulationView);
+    }
 
 
     //
@@ -188,72 +774,194 @@ void Ship::Update(
     // (which would flag our structure as dirty)
     //
 
-    mSprings.UpdateStrains(
-        gameParameters,
-        mPoints);
+    {
+        SHIP_PERF_SCOPE(mPerfStats, Strains);
+
+        mSprings.UpdateStrains(
+            gameParameters,
+            mPoints);
+    }
 
 
 
     //
-    // Update water dynamics
+    // Update water dynamics - possibly at a lower frequency, staggered
+    // among ships
     //
 
-    UpdateWaterDynamics(
-        currentSimulationTime,
-        gameParameters);
+    UpdateWaterDynamicsPeriod(
+        gameParameters,
+        simulationView);
+
+    if (mCurrentSimulationSequenceNumber.IsStepOf(mId % mWaterDynamicsPeriod, mWaterDynamicsPeriod))
+    {
+        UpdateWaterDynamics(
+            currentSimulationTime,
+            gameParameters,
+            static_cast<float>(mWaterDynamicsPeriod));
+    }
 
 
     //
-    // Update electrical dynamics
+    // Run sink/unsink detection
     //
 
-    UpdateElectricalDynamics(
-        currentWallClockTime,
-        gameParameters);
+    if (mCurrentSimulationSequenceNumber.IsStepOf(UpdateSinkingFrequency - 1, LowFrequencyPeriod))
+    {
+        UpdateSinking();
+    }
 
 
     //
-    // Update ephemeral particles
+    // Put to sleep islands that have been quiescent for a while
     //
 
-    UpdateEphemeralParticles(
-        currentSimulationTime,
-        gameParameters);
+    UpdateIslandSleeping(gameParameters);
 
-#ifdef _DEBUG
-    VerifyInvariants();
-#endif
-}
 
-void Ship::Render(
-    GameParameters const & /*gameParameters*/,
-    Render::RenderContext & renderContext)
-{
     //
-    // Run connectivity visit, if there have been any deletions
+    // Update electrical dynamics
     //
 
-    if (mIsStructureDirty)
     {
-        RunConnectivityVisit();
+        SHIP_PERF_SCOPE(mPerfStats, Electrical);
+
+        UpdateElectricalDynamics(
+            currentWallClockTime,
+            gameParameters);
     }
 
 
     //
-    // Initialize render
+    // Update ephemeral particles
+    //
+
+    {
+        SHIP_PERF_SCOPE(mPerfStats, EphemeralParticles);
+
+        UpdateEphemeralParticles(
+            currentSimulationTime,
+            gameParameters);
+    }
+
+
+    // Points have moved, hence the ship collisions that run once all ships have
+    // been updated, and the interactions that run until the next update, need
+    // to bucket them anew
+    mAreCollisionComponentBucketsCurrent = false;
+    mIsInteractionGridCurrent = false;
+
+
+    //
+    // Fire the spring events accumulated during this step - including
+    // those of the interactions that took place since the previous step
+    //
+
+    mSprings.FlushEvents();
+
+#ifdef _DEBUG
+    VerifyInvariants();
+#endif
+}
+
+void Ship::Render(
+    GameParameters const & gameParameters,
+    float renderInterpolationFactor,
+    Render::RenderContext & renderContext)
+{
+    //
+    // Run connectivity visit, if there have been any deletions
+    //
+
+    if (mIsStructureDirty)
+    {
+        SHIP_PERF_SCOPE(mPerfStats, ConnectivityVisit);
+
+        RunConnectivityVisit();
+    }
+
+    SHIP_PERF_SCOPE(mPerfStats, Uploads);
+
+
+    //
+    // Cull the ship if it's entirely out of view
+    //
+
+    Geometry::AABB renderAABB = mAABB;
+    mPoints.ExtendAABBWithLiveEphemeralPoints(renderAABB);
+
+    if (renderAABB.TopRight.x + RenderCullingMargin < renderContext.GetVisibleWorldLeft()
+        || renderAABB.BottomLeft.x - RenderCullingMargin > renderContext.GetVisibleWorldRight()
+        || renderAABB.BottomLeft.y - RenderCullingMargin > renderContext.GetVisibleWorldTop()
+        || renderAABB.TopRight.y + RenderCullingMargin < renderContext.GetVisibleWorldBottom())
+    {
+        renderContext.RenderShipCulled(mId);
+
+        // Particles live on their own once spawned, hence they still go
+        mPoints.UploadPendingGPUEphemeralParticles(renderContext);
+
+        // Remember to upload the elements we've just visited once we're back in view
+        mAreElementsDirtyForRendering |= mIsStructureDirty;
+        mIsStructureDirty = false;
+
+        return;
+    }
+
+    bool const areElementsDirty = mIsStructureDirty || mAreElementsDirtyForRendering;
+
+
+    //
+    // Initialize render
     //
 
+    float const screenSize =
+        std::max(renderAABB.GetWidth(), renderAABB.GetHeight())
+        * static_cast<float>(renderContext.GetCanvasHeight())
+        / renderContext.GetVisibleWorldHeight();
+
     renderContext.RenderShipStart(
         mId,
-        mMaxMaxPlaneId);
+        mMaxMaxPlaneId,
+        screenSize < LowDetailRenderMaxScreenSize);
 
 
     //
     // Upload points's attributes
     //
 
-    mPoints.UploadAttributes(
-        mId,
+    if (mAreGPUPointDynamicsAhead)
+    {
+        // The positions on the CPU are stale; render the GPU's own, which are in a
+        // context that shares its objects with the render context
+        assert(!!mMechanicalDynamicsGPUCalculator);
+
+        Render::ShipPointPositionBuffer const positionBuffer(
+            mMechanicalDynamicsGPUCalculator->GetPositionBuffer(),
+            mMechanicalDynamicsGPUCalculator->GetPositionBufferWriteFence(),
+            mMechanicalDynamicsGPUCalculator->GetPointCount());
+
+        mPoints.UploadAttributes(
+            mId,
+            renderInterpolationFactor,
+            &positionBuffer,
+            renderContext);
+    }
+    else
+    {
+        mPoints.UploadAttributes(
+            mId,
+            renderInterpolationFactor,
+            nullptr,
+            renderContext);
+    }
+
+
+    //
+    // Upload lamps
+    //
+
+    UploadLamps(
+        gameParameters,
         renderContext);
 
 
@@ -261,7 +969,7 @@ void Ship::Render(
     // Upload elements, if needed
     //
 
-    if (mIsStructureDirty
+    if (areElementsDirty
         || !mLastDebugShipRenderMode
         || *mLastDebugShipRenderMode != renderContext.GetDebugShipRenderMode())
     {
@@ -286,24 +994,13 @@ void Ship::Render(
 
         //
         // Upload triangles, but only if structure is dirty
-        // (we can't upload more frequently as mPlaneTriangleIndicesToRender is a one-time use)
         //
 
-        if (mIsStructureDirty)
+        if (areElementsDirty)
         {
-            assert(mPlaneTriangleIndicesToRender.size() >= 1);
-
-            renderContext.UploadShipElementTrianglesStart(
-                mId,
-                mPlaneTriangleIndicesToRender.back());
-
             mTriangles.UploadElements(
-                mPlaneTriangleIndicesToRender,
                 mId,
-                mPoints,
                 renderContext);
-
-            renderContext.UploadShipElementTrianglesEnd(mId);
         }
 
         renderContext.UploadShipElementsEnd(
@@ -315,20 +1012,28 @@ void Ship::Render(
     //
     // Upload stressed springs
     //
-    // We do this regardless of whether or not elements are dirty,
-    // as the set of stressed springs is bound to change from frame to frame
+    // We do this regardless of whether or not elements are dirty, but only
+    // when the set of stressed springs has changed since the last upload,
+    // or when they've just been turned on or off
     //
 
-    renderContext.UploadShipElementStressedSpringsStart(mId);
-
-    if (renderContext.GetShowStressedSprings())
+    bool const showStressedSprings = renderContext.GetShowStressedSprings();
+    if (showStressedSprings != mAreStressedSpringsUploaded
+        || (showStressedSprings && mSprings.IsStressedSpringSetDirty()))
     {
-        mSprings.UploadStressedSpringElements(
-            mId,
-            renderContext);
-    }
+        renderContext.UploadShipElementStressedSpringsStart(mId);
+
+        if (showStressedSprings)
+        {
+            mSprings.UploadStressedSpringElements(
+                mId,
+                renderContext);
+        }
 
-    renderContext.UploadShipElementStressedSpringsEnd(mId);
+        renderContext.UploadShipElementStressedSpringsEnd(mId);
+
+        mAreStressedSpringsUploaded = showStressedSprings;
+    }
 
 
     //
@@ -367,18 +1072,12 @@ void Ship::Render(
         renderContext);
 
 
-    //
-    // Finalize render
-    //
-
-    renderContext.RenderShipEnd(mId);
-
-
     //
     // Reset render state
     //
 
     mIsStructureDirty = false;
+    mAreElementsDirtyForRendering = false;
     mLastDebugShipRenderMode = renderContext.GetDebugShipRenderMode();
 }
 
@@ -391,10 +1090,71 @@ void Ship::Render(
 // Mechanical Dynamics
 ///////////////////////////////////////////////////////////////////////////////////
 
+float Ship::CalculateAdaptiveNumMechanicalDynamicsIterationsAdjustment(
+    GameParameters const & gameParameters,
+    float averageUpdateDurationMillis)
+{
+    float const minNumIterations = std::max(
+        1.0f,
+        std::floor(static_cast<float>(GameParameters::BasisNumMechanicalDynamicsIterations) * gameParameters.MinAdaptiveNumMechanicalDynamicsIterationsAdjustment));
+
+    float const maxNumIterations = std::max(
+        minNumIterations,
+        std::floor(static_cast<float>(GameParameters::BasisNumMechanicalDynamicsIterations) * gameParameters.MaxAdaptiveNumMechanicalDynamicsIterationsAdjustment));
+
+    //
+    // The more strained the ship, the more iterations it gets; when the last updates
+    // took longer than the target, the extra iterations are scaled back, so that calm
+    // ships stay at the minimum while the budget goes to ships that are breaking apart
+    //
+
+    float const strainFactor = std::min(
+        1.0f,
+        std::max(0.0f, mSprings.GetMaxStrainRatio() - MinAdaptiveIterationsStrainRatio)
+        / (MaxAdaptiveIterationsStrainRatio - MinAdaptiveIterationsStrainRatio));
+
+    float const budgetFactor = (averageUpdateDurationMillis > gameParameters.TargetUpdateDurationMillis)
+        ? gameParameters.TargetUpdateDurationMillis / averageUpdateDurationMillis
+        : 1.0f;
+
+    size_t const targetNumIterations = static_cast<size_t>(
+        minNumIterations
+        + std::round((maxNumIterations - minNumIterations) * strainFactor * budgetFactor));
+
+    //
+    // Go up right away, but come down one iteration at a time; this keeps
+    // the coefficients that depend on the number of iterations from being
+    // re-calculated at each step
+    //
+
+    if (targetNumIterations > mAdaptiveNumMechanicalDynamicsIterations)
+    {
+        mAdaptiveNumMechanicalDynamicsIterations = targetNumIterations;
+        mAdaptiveNumMechanicalDynamicsIterationsDecreaseStepCount = 0;
+    }
+    else if (targetNumIterations < mAdaptiveNumMechanicalDynamicsIterations)
+    {
+        ++mAdaptiveNumMechanicalDynamicsIterationsDecreaseStepCount;
+        if (mAdaptiveNumMechanicalDynamicsIterationsDecreaseStepCount >= StepsBeforeAdaptiveIterationsDecrease)
+        {
+            --mAdaptiveNumMechanicalDynamicsIterations;
+            mAdaptiveNumMechanicalDynamicsIterationsDecreaseStepCount = 0;
+        }
+    }
+    else
+    {
+        mAdaptiveNumMechanicalDynamicsIterationsDecreaseStepCount = 0;
+    }
+
+    // Exact in floating point for all iteration counts we may come up with
+    return static_cast<float>(mAdaptiveNumMechanicalDynamicsIterations)
+        / static_cast<float>(GameParameters::BasisNumMechanicalDynamicsIterations);
+}
+
 void Ship::UpdateMechanicalDynamics(
     float currentSimulationTime,
     GameParameters const & gameParameters,
-    Render::RenderContext const & renderContext)
+    SimulationView const & simulationView)
 {
     //
     // 1. Recalculate total masses and everything else that derives from them, once and for all
@@ -402,243 +1162,1362 @@ void Ship::UpdateMechanicalDynamics(
 
     mPoints.UpdateTotalMasses(gameParameters);
 
+    // Force fields may affect any point
+    if (!mCurrentForceFields.empty())
+    {
+        WakeUpAllIslands();
+    }
+
+    // Catch up with the ephemeral particles born and expired since the last update
+    UpdateAwakeEphemeralPoints();
+
     //
-    // 2. Run iterations
+    // 2. Sample water and ocean floor heights - and the wind field - at all (live) points, once and for all
+    //
+    // The water surface, the ocean floor, and the wind only change once per step, and points
+    // don't move far enough during a step for the heights to change noticeably
     //
 
-    int const numMechanicalDynamicsIterations = gameParameters.NumMechanicalDynamicsIterations<int>();
+    float * const waterHeightBuffer = mWorkBufferArena.Allocate<float>(mPoints.GetBufferElementCount());
+    mParentWorld.GetWaterHeightsAt(
+        mPoints.GetPositionBufferAsVec2(),
+        waterHeightBuffer,
+        mPoints.GetShipPointCount());
 
-    for (int iter = 0; iter < numMechanicalDynamicsIterations; ++iter)
+    // Ships well above the sea floor cannot collide with it during this step; force
+    // fields may impart any velocity, hence we never cull while they're active
+    bool const doHandleCollisionsWithSeaFloor =
+        !mCurrentForceFields.empty()
+        || IsCloseToSeaFloor();
+
+    float * const oceanFloorHeightBuffer = mWorkBufferArena.Allocate<float>(mPoints.GetBufferElementCount());
+    if (doHandleCollisionsWithSeaFloor)
     {
-        // Apply force fields - if we have any
-        for (auto const & forceField : mCurrentForceFields)
-        {
-            forceField->Apply(
-                mPoints,
-                currentSimulationTime,
-                gameParameters);
-        }
+        mParentWorld.GetOceanFloorHeightsAt(
+            mPoints.GetPositionBufferAsVec2(),
+            oceanFloorHeightBuffer,
+            mPoints.GetShipPointCount());
+    }
+
+    // The wind field, if the wind varies along the world
+    float * windForceMultiplierBuffer = nullptr;
+    if (mParentWorld.HasWindField())
+    {
+        windForceMultiplierBuffer = mWorkBufferArena.Allocate<float>(mPoints.GetBufferElementCount());
+        mParentWorld.GetWindForceMultipliersAt(
+            mPoints.GetPositionBufferAsVec2(),
+            windForceMultiplierBuffer,
+            mPoints.GetShipPointCount());
+    }
 
-        // Update point forces
-        UpdatePointForces(gameParameters);
+    for (auto pointIndex : mPoints.LiveEphemeralPoints())
+    {
+        float const x = mPoints.GetPosition(pointIndex).x;
+        waterHeightBuffer[pointIndex] = mParentWorld.GetWaterHeightAt(x);
 
-        // Update springs forces
-        UpdateSpringForces(gameParameters);
+        if (nullptr != windForceMultiplierBuffer)
+            windForceMultiplierBuffer[pointIndex] = mParentWorld.GetWindForceMultiplierAt(x);
 
-        // Check whether we need to save the last force buffer before we zero it out
-        if (iter == numMechanicalDynamicsIterations - 1
-            && VectorFieldRenderMode::PointForce == renderContext.GetVectorFieldRenderMode())
-        {
-            mPoints.CopyForceBufferToForceRenderBuffer();
-        }
+        if (doHandleCollisionsWithSeaFloor)
+            oceanFloorHeightBuffer[pointIndex] = mParentWorld.GetOceanFloorHeightAt(x);
+    }
 
-        // Integrate and reset forces to zero
-        IntegrateAndResetPointForces(gameParameters);
+    float const * const waterHeights = waterHeightBuffer;
+    float const * const windForceMultipliers = windForceMultiplierBuffer;
+    float const * const oceanFloorHeights = oceanFloorHeightBuffer;
 
-        // Handle collisions with sea floor
-        HandleCollisionsWithSeaFloor(gameParameters);
+    // The force fields whose force only depends on the point itself are packed, for the point
+    // forces to evaluate them all in their own pass over the points - however many bombs
+    // went off together
+    mPackedForceFields.clear();
+    std::vector<size_t> unpackedForceFieldIndices;
+    for (size_t f = 0; f < mCurrentForceFields.size(); ++f)
+    {
+        std::optional<PackedForceField> const packedForceField = mCurrentForceFields[f]->Pack();
+        if (packedForceField)
+            mPackedForceFields.push_back(*packedForceField);
+        else
+            unpackedForceFieldIndices.push_back(f);
     }
 
-    // Consume force fields
-    mCurrentForceFields.clear();
-}
+    // The points that the unpacked force fields with a radius may reach during this step,
+    // once and for all
+    mForceFieldCandidatePointIndices.resize(mCurrentForceFields.size());
+    for (size_t f : unpackedForceFieldIndices)
+    {
+        auto & candidatePointIndices = mForceFieldCandidatePointIndices[f];
+        candidatePointIndices.clear();
 
-void Ship::UpdatePointForces(GameParameters const & gameParameters)
-{
-    float const densityAdjustedWaterMass = GameParameters::WaterMass * gameParameters.WaterDensityAdjustment;
+        auto const effectiveRadius = mCurrentForceFields[f]->GetEffectiveRadius();
+        if (effectiveRadius)
+        {
+            vec2f const & center = mCurrentForceFields[f]->GetCenterPosition();
+            float const candidateRadius = *effectiveRadius + ForceFieldCandidateMargin;
+            float const squareCandidateRadius = candidateRadius * candidateRadius;
 
-    // Calculate wind force:
-    //  Km/h -> Newton: F = 1/2 rho v**2 A
-    float constexpr VelocityConversionFactor = 1000.0f / 3600.0f;
-    vec2f const windForce =
-        mParentWorld.GetCurrentWindSpeed().square()
-        * (VelocityConversionFactor * VelocityConversionFactor)
-        * 0.5f
-        * GameParameters::AirMass;
+            VisitInteractionGridPointsIn(
+                Geometry::AABB(center.x - candidateRadius, center.x + candidateRadius, center.y + candidateRadius, center.y - candidateRadius),
+                [&](ElementIndex pointIndex)
+                {
+                    if ((mPoints.GetPosition(pointIndex) - center).squareLength() <= squareCandidateRadius)
+                        candidatePointIndices.push_back(pointIndex);
+                });
+        }
+    }
 
-    // Underwater points feel this amount of water drag
     //
-    // The higher the value, the more viscous the water looks when a body moves through it
-    float const waterDragCoefficient =
-        GameParameters::WaterDragLinearCoefficient
-        * gameParameters.WaterDragAdjustment;
+    // 3. Run iterations
+    //
 
-    for (auto pointIndex : mPoints)
+    int const numMechanicalDynamicsIterations = gameParameters.NumMechanicalDynamicsIterations<int>();
+
+    if (gameParameters.DoSolveSpringsAsConstraints)
     {
-        // Get height of water at this point
-        float const waterHeightAtThisPoint = mParentWorld.GetWaterHeightAt(mPoints.GetPosition(pointIndex).x);
+        // The GPU might have run the last steps
+        CatchUpWithGPUMechanicalDynamics();
 
+        RunSpringConstraintsSubsteps(
+            currentSimulationTime,
+            unpackedForceFieldIndices,
+            doHandleCollisionsWithSeaFloor,
+            waterHeights,
+            windForceMultipliers,
+            oceanFloorHeights,
+            simulationView,
+            gameParameters);
+    }
+    else if (IsGPUMechanicalDynamicsAvailable(gameParameters, simulationView))
+    {
         //
-        // 1. Add gravity and buoyancy
+        // All iterations at once on the GPU; there are no force fields, hence the point
+        // forces only depend on data that doesn't change during the step
         //
 
-        mPoints.GetForce(pointIndex) +=
-            gameParameters.Gravity
-            * mPoints.GetTotalMass(pointIndex);
-
-        if (mPoints.GetPosition(pointIndex).y < waterHeightAtThisPoint)
-        {
-            //
-            // Apply upward push of water mass (i.e. buoyancy!)
-            //
-
-            mPoints.GetForce(pointIndex) -=
-                gameParameters.Gravity
-                * mPoints.GetWaterVolumeFill(pointIndex)
-                * densityAdjustedWaterMass;
-        }
-
+        SHIP_PERF_SCOPE(mPerfStats, Integration);
 
+        RunGPUMechanicalDynamics(
+            doHandleCollisionsWithSeaFloor,
+            waterHeights,
+            windForceMultipliers,
+            oceanFloorHeights,
+            gameParameters);
+    }
+    else if (gameParameters.DoFusePointDynamics)
+    {
         //
-        // 2. Apply water drag
+        // Each iteration makes a single pass over the points after the spring forces: the pass integrates
+        // each point, handles its collision with the sea floor, and calculates its point forces for the
+        // next iteration, all while the point is still in cache.
         //
-        // FUTURE: should replace with directional water drag, which acts on frontier points only,
-        // proportional to angle between velocity and normal to surface at this point;
-        // this would ensure that masses would also have a horizontal velocity component when sinking,
-        // providing a "gliding" effect
+        // This is equivalent to the legacy sequence, as the point forces only depend on the point itself.
         //
-        // 3. Apply wind force
+        // The same goes for the packed force fields, which are evaluated with the point forces;
+        // the others are still applied on their own at the beginning of each iteration
         //
 
-        if (mPoints.GetPosition(pointIndex).y <= waterHeightAtThisPoint)
-        {
-            //
-            // Note: we would have liked to use the square law:
-            //
-            //  Drag force = -C * (|V|^2*Vn)
-            //
-            // But when V >= m / (C * dt), the drag force overcomes the current velocity
-            // and thus it accelerates it, resulting in an unstable system.
-            //
-            // With a linear law, we know that the force will never accelerate the current velocity
-            // as long as m > (C * dt) / 2 (~=0.0002), which is a mass we won't have in our system (air is 1.2754).
-            //
+        PointForcesConstants pointForcesConstants = CalculatePointForcesConstants(gameParameters);
+        pointForcesConstants.ForceFields = mPackedForceFields.data();
+        pointForcesConstants.ForceFieldCount = mPackedForceFields.size();
 
-            // Square law:
-            ////mPoints.GetForce(pointIndex) +=
-            ////    mPoints.GetVelocity(pointIndex).square()
-            ////    * (-waterDragCoefficient);
+        // Point forces for the first iteration
+        {
+            SHIP_PERF_SCOPE(mPerfStats, PointForces);
 
-            // Linear law:
-            mPoints.GetForce(pointIndex) +=
-                mPoints.GetVelocity(pointIndex)
-                * (-waterDragCoefficient);
+            UpdatePointForces(waterHeights, windForceMultipliers, gameParameters);
         }
-        else
+
+        for (int iter = 0; iter < numMechanicalDynamicsIterations; ++iter)
         {
-            // Wind force
-            //
-            // Note: should be based on relative velocity, but we simplify here for performance reasons
-            mPoints.GetForce(pointIndex) +=
-                windForce
-                * mPoints.GetWindReceptivity(pointIndex);
+            // Apply the force fields that we couldn't pack - if we have any
+            for (size_t f : unpackedForceFieldIndices)
+            {
+                mCurrentForceFields[f]->Apply(
+                    mPoints,
+                    mForceFieldCandidatePointIndices[f],
+                    currentSimulationTime,
+                    gameParameters);
+            }
+
+            // Update springs forces; the last iteration also stores the spring lengths,
+            // for the strain check
+            {
+                SHIP_PERF_SCOPE(mPerfStats, SpringForces);
+
+                UpdateSpringForces(
+                    iter == numMechanicalDynamicsIterations - 1,
+                    gameParameters);
+            }
+
+            // Check whether we need to save the last force buffer before we zero it out
+            if (iter == numMechanicalDynamicsIterations - 1
+                && simulationView.DoCapturePointForces)
+            {
+                mPoints.CopyForceBufferToForceRenderBuffer();
+            }
+
+            // Integrate, reset forces, handle collisions with sea floor, and - unless this is
+            // the last iteration - calculate the point forces for the next iteration; the
+            // last iteration also calculates the bounds of the awake components, as the
+            // sleeping ones haven't moved
+            bool const isLastIteration = (iter == numMechanicalDynamicsIterations - 1);
+
+            if (isLastIteration)
+                BeginAABBsUpdate(false);
+
+            {
+                SHIP_PERF_SCOPE(mPerfStats, Integration);
+
+                IntegrateAndUpdatePointForces(
+                    !isLastIteration,
+                    doHandleCollisionsWithSeaFloor,
+                    isLastIteration,
+                    waterHeights,
+                    windForceMultipliers,
+                    oceanFloorHeights,
+                    pointForcesConstants,
+                    gameParameters);
+            }
+
+            if (isLastIteration)
+                EndAABBsUpdate();
         }
     }
-}
-
-void Ship::UpdateSpringForces(GameParameters const & /*gameParameters*/)
-{
-    for (auto springIndex : mSprings)
+    else
     {
-        auto const pointAIndex = mSprings.GetEndpointAIndex(springIndex);
-        auto const pointBIndex = mSprings.GetEndpointBIndex(springIndex);
+        for (int iter = 0; iter < numMechanicalDynamicsIterations; ++iter)
+        {
+            // Apply the force fields that we couldn't pack - if we have any
+            for (size_t f : unpackedForceFieldIndices)
+            {
+                mCurrentForceFields[f]->Apply(
+                    mPoints,
+                    mForceFieldCandidatePointIndices[f],
+                    currentSimulationTime,
+                    gameParameters);
+            }
 
-        // No need to check whether the spring is deleted, as a deleted spring
-        // has zero coefficients
+            // Update point forces, including the packed force fields
+            {
+                SHIP_PERF_SCOPE(mPerfStats, PointForces);
 
-        vec2f const displacement = mPoints.GetPosition(pointBIndex) - mPoints.GetPosition(pointAIndex);
-        float const displacementLength = displacement.length();
-        vec2f const springDir = displacement.normalise(displacementLength);
+                UpdatePointForces(waterHeights, windForceMultipliers, gameParameters);
+            }
 
-        //
-        // 1. Hooke's law
-        //
+            // Update springs forces; the last iteration also stores the spring lengths,
+            // for the strain check
+            {
+                SHIP_PERF_SCOPE(mPerfStats, SpringForces);
 
-        // Calculate spring force on point A
-        vec2f const fSpringA =
-            springDir
-            * (displacementLength - mSprings.GetRestLength(springIndex))
-            * mSprings.GetStiffnessCoefficient(springIndex);
+                UpdateSpringForces(
+                    iter == numMechanicalDynamicsIterations - 1,
+                    gameParameters);
+            }
 
+            // Check whether we need to save the last force buffer before we zero it out
+            if (iter == numMechanicalDynamicsIterations - 1
+                && simulationView.DoCapturePointForces)
+            {
+                mPoints.CopyForceBufferToForceRenderBuffer();
+            }
 
-        //
-        // 2. Damper forces
-        //
-        // Damp the velocities of the two points, as if the points were also connected by a damper
-        // along the same direction as the spring
-        //
+            // Integrate and reset forces to zero; the last iteration also calculates
+            // the bounds, of all components as all points are integrated
+            bool const isLastIteration = (iter == numMechanicalDynamicsIterations - 1);
 
-        // Calculate damp force on point A
-        vec2f const relVelocity = mPoints.GetVelocity(pointBIndex) - mPoints.GetVelocity(pointAIndex);
-        vec2f const fDampA =
-            springDir
-            * relVelocity.dot(springDir)
-            * mSprings.GetDampingCoefficient(springIndex);
+            if (isLastIteration)
+                BeginAABBsUpdate(true);
 
+            {
+                SHIP_PERF_SCOPE(mPerfStats, Integration);
 
-        //
-        // Apply forces
-        //
+                IntegrateAndResetPointForces(isLastIteration, gameParameters);
+            }
 
-        mPoints.GetForce(pointAIndex) += fSpringA + fDampA;
-        mPoints.GetForce(pointBIndex) -= fSpringA + fDampA;
-    }
-}
+            if (isLastIteration)
+                EndAABBsUpdate();
 
-void Ship::IntegrateAndResetPointForces(GameParameters const & gameParameters)
-{
-    float const dt = gameParameters.MechanicalSimulationStepTimeDuration<float>();
+            // Handle collisions with sea floor
+            if (doHandleCollisionsWithSeaFloor)
+            {
+                SHIP_PERF_SCOPE(mPerfStats, SeaFloorCollisions);
+
+                HandleCollisionsWithSeaFloor(oceanFloorHeights, gameParameters.MechanicalSimulationStepTimeDuration<float>());
+            }
+        }
+    }
 
-    // Global damp - lowers velocity uniformly, damping oscillations originating between gravity and buoyancy
-    //
-    // Considering that:
-    //
-    //  v1 = d*v0
-    //  v2 = d*v1 =(d^2)*v0
-    //  ...
-    //  vN = (d^N)*v0
     //
-    // ...the more the number of iterations, the more damped the initial velocity would be.
-    // We want damping to be independent from the number of iterations though, so we need to find the value
-    // d such that after N iterations the damping is the same as our reference value, which is based on
-    // 12 (basis) iterations. For example, double the number of iterations requires square root (1/2) of
-    // this value.
+    // 4. Push the water surface where points hit it
     //
 
-    float const globalDampCoefficient = pow(
-        GameParameters::GlobalDamp,
-        12.0f / gameParameters.NumMechanicalDynamicsIterations<float>());
+    if (gameParameters.DoSimulateInteractiveWaves)
+    {
+        GenerateOceanSurfaceImpacts(waterHeights, gameParameters);
+    }
 
-    //
+    // Consume force fields
+    mCurrentForceFields.clear();
+}
+
+void Ship::UpdatePointForces(
+    float const * restrict waterHeights,
+    float const * restrict windForceMultipliers,
+    GameParameters const & gameParameters)
+{
+    PointForcesConstants constants = CalculatePointForcesConstants(gameParameters);
+    constants.ForceFields = mPackedForceFields.data();
+    constants.ForceFieldCount = mPackedForceFields.size();
+
+    // Pick the kernel that does not branch on what is not there
+    if (windForceMultipliers != nullptr)
+    {
+        if (constants.ForceFieldCount > 0)
+            UpdatePointForcesKernel<true, true>(waterHeights, windForceMultipliers, constants, gameParameters);
+        else
+            UpdatePointForcesKernel<true, false>(waterHeights, windForceMultipliers, constants, gameParameters);
+    }
+    else
+    {
+        if (constants.ForceFieldCount > 0)
+            UpdatePointForcesKernel<false, true>(waterHeights, windForceMultipliers, constants, gameParameters);
+        else
+            UpdatePointForcesKernel<false, false>(waterHeights, windForceMultipliers, constants, gameParameters);
+    }
+}
+
+template<bool HasWindForceMultipliers, bool HasForceFields>
+void Ship::UpdatePointForcesKernel(
+    float const * restrict waterHeights,
+    float const * restrict windForceMultipliers,
+    PointForcesConstants const & constants,
+    GameParameters const & gameParameters)
+{
+    for (auto pointIndex : mAwakePoints)
+    {
+        ApplyPointForces<HasForceFields>(
+            pointIndex,
+            waterHeights[pointIndex],
+            HasWindForceMultipliers ? windForceMultipliers[pointIndex] : 1.0f,
+            constants,
+            gameParameters);
+    }
+}
+
+Ship::PointForcesConstants Ship::CalculatePointForcesConstants(GameParameters const & gameParameters) const
+{
+    PointForcesConstants constants;
+
+    constants.DensityAdjustedWaterMass = GameParameters::WaterMass * gameParameters.WaterDensityAdjustment;
+
+    // Calculate wind force:
+    //  Km/h -> Newton: F = 1/2 rho v**2 A
+    float constexpr VelocityConversionFactor = 1000.0f / 3600.0f;
+    constants.WindForce =
+        mParentWorld.GetCurrentWindSpeed().square()
+        * (VelocityConversionFactor * VelocityConversionFactor)
+        * 0.5f
+        * GameParameters::AirMass;
+
+    // Underwater points feel this amount of water drag
+    //
+    // The higher the value, the more viscous the water looks when a body moves through it
+    constants.WaterDragCoefficient =
+        GameParameters::WaterDragLinearCoefficient
+        * gameParameters.WaterDragAdjustment;
+
+    // Force fields are applied on their own, unless the caller packs them
+    constants.ForceFields = nullptr;
+    constants.ForceFieldCount = 0;
+
+    return constants;
+}
+
+template<bool HasForceFields>
+inline void Ship::ApplyPointForces(
+    ElementIndex pointIndex,
+    float waterHeightAtThisPoint,
+    float windForceMultiplierAtThisPoint,
+    PointForcesConstants const & constants,
+    GameParameters const & gameParameters)
+{
+    //
+    // 1. Add gravity and buoyancy
+    //
+
+    mPoints.GetForce(pointIndex) +=
+        gameParameters.Gravity
+        * mPoints.GetTotalMass(pointIndex);
+
+    if (mPoints.GetPosition(pointIndex).y < waterHeightAtThisPoint)
+    {
+        //
+        // Apply upward push of water mass (i.e. buoyancy!)
+        //
+
+        mPoints.GetForce(pointIndex) -=
+            gameParameters.Gravity
+            * mPoints.GetWaterVolumeFill(pointIndex)
+            * constants.DensityAdjustedWaterMass;
+    }
+
+
+    //
+    // 2. Apply water drag
+    //
+    // FUTURE: should replace with directional water drag, which acts on frontier points only
+    // (see GetFrontierPoints()),
+    // proportional to angle between velocity and normal to surface at this point;
+    // this would ensure that masses would also have a horizontal velocity component when sinking,
+    // providing a "gliding" effect
+    //
+    // 3. Apply wind force
+    //
+
+    if (mPoints.GetPosition(pointIndex).y <= waterHeightAtThisPoint)
+    {
+        //
+        // Note: we would have liked to use the square law:
+        //
+        //  Drag force = -C * (|V|^2*Vn)
+        //
+        // But when V >= m / (C * dt), the drag force overcomes the current velocity
+        // and thus it accelerates it, resulting in an unstable system.
+        //
+        // With a linear law, we know that the force will never accelerate the current velocity
+        // as long as m > (C * dt) / 2 (~=0.0002), which is a mass we won't have in our system (air is 1.2754).
+        //
+
+        // Square law:
+        ////mPoints.GetForce(pointIndex) +=
+        ////    mPoints.GetVelocity(pointIndex).square()
+        ////    * (-constants.WaterDragCoefficient);
+
+        // Linear law:
+        mPoints.GetForce(pointIndex) +=
+            mPoints.GetVelocity(pointIndex)
+            * (-constants.WaterDragCoefficient);
+    }
+    else
+    {
+        // Wind force
+        //
+        // Note: should be based on relative velocity, but we simplify here for performance reasons
+        mPoints.GetForce(pointIndex) +=
+            constants.WindForce
+            * (mPoints.GetWindReceptivity(pointIndex) * windForceMultiplierAtThisPoint);
+    }
+
+    //
+    // 4. Apply packed force fields
+    //
+
+    if constexpr (HasForceFields)
+    {
+        for (size_t f = 0; f < constants.ForceFieldCount; ++f)
+        {
+            mPoints.GetForce(pointIndex) += constants.ForceFields[f].CalculateForce(
+                mPoints.GetPosition(pointIndex),
+                mPoints.GetTotalMass(pointIndex));
+        }
+    }
+}
+
+void Ship::UpdateSpringForces(
+    bool doStoreSpringLengths,
+    GameParameters const & gameParameters)
+{
+    bool const doVerify = (gameParameters.KernelVerification == KernelVerificationMode::SpringForces);
+    if (doVerify)
+    {
+        // Snapshot the forces the kernel is about to accumulate into
+        vec2f const * const forceBuffer = mPoints.GetForceBufferAsVec2();
+        mKernelVerificationBuffer.assign(
+            reinterpret_cast<float const *>(forceBuffer),
+            reinterpret_cast<float const *>(forceBuffer + mPoints.GetBufferElementCount()));
+    }
+
+    if (mHasSleepingIslands)
+    {
+        // Only springs of awake islands
+        CalculateIndexedSpringForces(
+            mSpringForcesImplementation,
+            MakeSpringForcesBuffers(doStoreSpringLengths),
+            mAwakeSprings.data(),
+            mAwakeSprings.size());
+    }
+    else if (gameParameters.DoParallelizeSpringForces
+        && mSprings.GetElementCount() >= MinSpringsForParallelSpringForces
+        && TaskThreadPool::GetInstance().GetParallelism() > 1)
+    {
+        UpdateSpringForcesParallel();
+    }
+    else if (!mSpatiallySortedSprings.empty())
+    {
+        CalculateIndexedSpringForces(
+            mSpringForcesImplementation,
+            MakeSpringForcesBuffers(doStoreSpringLengths),
+            mSpatiallySortedSprings.data(),
+            mSpatiallySortedSprings.size());
+    }
+    else if (!mLiveSprings.empty())
+    {
+        CalculateIndexedSpringForces(
+            mSpringForcesImplementation,
+            MakeSpringForcesBuffers(doStoreSpringLengths),
+            mLiveSprings.data(),
+            mLiveSprings.size());
+    }
+    else
+    {
+        CalculateSpringForces(
+            mSpringForcesImplementation,
+            MakeSpringForcesBuffers(doStoreSpringLengths),
+            0,
+            static_cast<ElementIndex>(mSprings.GetElementCount()));
+    }
+
+    if (doVerify)
+    {
+        VerifySpringForces();
+    }
+}
+
+void Ship::VerifySpringForces()
+{
+    //
+    // The reference is the scalar kernel, visiting the same springs serially
+    //
+
+    vec2f * const referenceForces = reinterpret_cast<vec2f *>(mKernelVerificationBuffer.data());
+
+    SpringForcesBuffers referenceBuffers = MakeSpringForcesBuffers(false);
+    referenceBuffers.PointForces = referenceForces;
+
+    if (mHasSleepingIslands)
+    {
+        CalculateIndexedSpringForces(
+            SpringForcesImplementation::Scalar,
+            referenceBuffers,
+            mAwakeSprings.data(),
+            mAwakeSprings.size());
+    }
+    else
+    {
+        CalculateSpringForces(
+            SpringForcesImplementation::Scalar,
+            referenceBuffers,
+            0,
+            static_cast<ElementIndex>(mSprings.GetElementCount()));
+    }
+
+    vec2f const * const optimizedForces = mPoints.GetForceBufferAsVec2();
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+    {
+        mKernelVerificationMaxDivergence = std::max(
+            mKernelVerificationMaxDivergence,
+            (optimizedForces[pointIndex] - referenceForces[pointIndex]).length());
+    }
+}
+
+void Ship::UpdateSpringForcesParallel()
+{
+    //
+    // Re-partition springs, if springs have been destroyed or restored
+    // since the last time we've partitioned them
+    //
+
+    UpdateParallelForceBatches();
+
+    if (mParallelSpringForceTasks.empty())
+    {
+        //
+        // Split each batch into tasks
+        //
+
+        size_t const parallelism = TaskThreadPool::GetInstance().GetParallelism();
+
+        // Buffers never move, hence tasks may hold on to them; as the tasks serve all
+        // iterations, they always store the spring lengths
+        SpringForcesBuffers const buffers = MakeSpringForcesBuffers(true);
+
+        for (size_t b = 0; b < mSprings.GetParallelForceBatchCount(); ++b)
+        {
+            ElementIndex const * const batchBegin = mSprings.GetParallelForceBatchBegin(b);
+            size_t const batchSize = mSprings.GetParallelForceBatchEnd(b) - batchBegin;
+
+            size_t const taskCount = std::max(
+                std::min(parallelism, batchSize / MinSpringsPerParallelSpringForcesTask),
+                size_t(1));
+
+            mParallelSpringForceTasks.emplace_back();
+            auto & batchTasks = mParallelSpringForceTasks.back();
+
+            for (size_t t = 0; t < taskCount; ++t)
+            {
+                ElementIndex const * const taskBegin = batchBegin + batchSize * t / taskCount;
+                ElementIndex const * const taskEnd = batchBegin + batchSize * (t + 1) / taskCount;
+
+                batchTasks.emplace_back(
+                    [implementation = mSpringForcesImplementation, buffers, taskBegin, taskEnd]()
+                    {
+                        CalculateIndexedSpringForces(
+                            implementation,
+                            buffers,
+                            taskBegin,
+                            static_cast<size_t>(taskEnd - taskBegin));
+                    });
+            }
+        }
+    }
+
+    //
+    // Run all batches, one after the other
+    //
+    // Each point gets at most one contribution from each batch, and batches
+    // are always run in the same order; hence, the resulting forces do not
+    // depend on the number of threads nor on how tasks get scheduled
+    //
+
+    for (auto const & batchTasks : mParallelSpringForceTasks)
+    {
+        TaskThreadPool::GetInstance().Run(batchTasks);
+    }
+}
+
+SpringForcesBuffers Ship::MakeSpringForcesBuffers(bool doStoreSpringLengths)
+{
+    return SpringForcesBuffers{
+        mPoints.GetPositionBufferAsVec2(),
+        mPoints.GetVelocityBufferAsVec2(),
+        mPoints.GetForceBufferAsVec2(),
+        mSprings.GetEndpointsBufferAsElementIndex(),
+        mSprings.GetRestLengthBuffer(),
+        mSprings.GetCoefficientsBufferAsFloat(),
+        doStoreSpringLengths ? mSprings.GetLengthBuffer() : nullptr };
+}
+
+void Ship::UpdateParallelForceBatches()
+{
+    if (mSprings.AreParallelForceBatchesDirty())
+    {
+        mSprings.UpdateParallelForceBatches(mPoints);
+
+        // Tasks refer to the old batches
+        mParallelSpringForceTasks.clear();
+        mParallelSpringConstraintTasks.clear();
+    }
+}
+
+void Ship::RunSpringConstraintsSubsteps(
+    float currentSimulationTime,
+    std::vector<size_t> const & unpackedForceFieldIndices,
+    bool doHandleCollisionsWithSeaFloor,
+    float const * restrict waterHeights,
+    float const * restrict windForceMultipliers,
+    float const * restrict oceanFloorHeights,
+    SimulationView const & simulationView,
+    GameParameters const & gameParameters)
+{
+    //
+    // Each substep integrates the points with their point forces alone, then moves them
+    // as the springs - solved as constraints - want, and finally takes the velocities from
+    // how much the points have moved.
+    //
+    // The spring coefficients are those of the full number of iterations, hence the
+    // springs are at least as stiff as with the iterations, at a fraction of them
+    //
+
+    int const numSubsteps = gameParameters.NumSpringConstraintsSubsteps<int>();
+    float const dt = GameParameters::SimulationStepTimeDuration<float> / static_cast<float>(numSubsteps);
+
+    // See IntegrateAndResetPointForces()
+    float const globalDampCoefficient = pow(
+        GameParameters::GlobalDamp,
+        12.0f / static_cast<float>(numSubsteps));
+
+    size_t const shipPointComponentCount = mPoints.GetShipPointCount() * 2; // Two components per vector
+
+    //
+    // Inverse masses, once and for all: the integration factors are the time coefficients
+    // - the squared dt of an iteration, or zero for frozen points - over the total masses
+    //
+
+    float * const restrict inverseMassBuffer = mWorkBufferArena.Allocate<float>(mPoints.GetBufferElementCount());
+
+    {
+        float const iterationDt = gameParameters.MechanicalSimulationStepTimeDuration<float>();
+        float const inverseIterationDtSquared = 1.0f / (iterationDt * iterationDt);
+
+        vec2f const * const restrict integrationFactorBuffer = reinterpret_cast<vec2f const *>(mPoints.GetIntegrationFactorBufferAsFloat());
+        for (ElementIndex p = 0; p < mPoints.GetBufferElementCount(); ++p)
+        {
+            inverseMassBuffer[p] = integrationFactorBuffer[p].x * inverseIterationDtSquared;
+        }
+    }
+
+    float * const restrict positionBuffer = mPoints.GetPositionBufferAsFloat();
+    float * const restrict velocityBuffer = mPoints.GetVelocityBufferAsFloat();
+    float * const restrict forceBuffer = mPoints.GetForceBufferAsFloat();
+    float * const restrict previousPositionBuffer = mWorkBufferArena.Allocate<float>(mPoints.GetBufferElementCount() * 2);
+    float * const ropeChainWorkBuffer = mWorkBufferArena.Allocate<float>(mMaxRopeChainSpringCount * 4);
+
+    for (int substep = 0; substep < numSubsteps; ++substep)
+    {
+        bool const isLastSubstep = (substep == numSubsteps - 1);
+
+        // Apply the force fields that we couldn't pack - if we have any
+        for (size_t f : unpackedForceFieldIndices)
+        {
+            mCurrentForceFields[f]->Apply(
+                mPoints,
+                mForceFieldCandidatePointIndices[f],
+                currentSimulationTime,
+                gameParameters);
+        }
+
+        // Update point forces, including the packed force fields
+        {
+            SHIP_PERF_SCOPE(mPerfStats, PointForces);
+
+            UpdatePointForces(waterHeights, windForceMultipliers, gameParameters);
+        }
+
+        if (isLastSubstep && simulationView.DoCapturePointForces)
+        {
+            mPoints.CopyForceBufferToForceRenderBuffer();
+        }
+
+        //
+        // Integrate point forces - ephemeral points too, which have no springs - and reset them
+        //
+
+        {
+            SHIP_PERF_SCOPE(mPerfStats, Integration);
+
+            auto const integrate =
+                [&](size_t i)
+                {
+                    previousPositionBuffer[i] = positionBuffer[i];
+                    velocityBuffer[i] += forceBuffer[i] * inverseMassBuffer[i / 2] * dt;
+                    positionBuffer[i] += velocityBuffer[i] * dt;
+
+                    forceBuffer[i] = 0.0f;
+                };
+
+            for (size_t i = 0; i < shipPointComponentCount; ++i)
+            {
+                integrate(i);
+            }
+
+            for (auto pointIndex : mPoints.LiveEphemeralPoints())
+            {
+                integrate(pointIndex * 2);
+                integrate(pointIndex * 2 + 1);
+            }
+        }
+
+        //
+        // Solve springs; the last substep also stores the spring lengths, for the strain check
+        //
+
+        {
+            SHIP_PERF_SCOPE(mPerfStats, SpringForces);
+
+            mSpringConstraintsSubstep.Buffers = SpringConstraintsBuffers{
+                mPoints.GetPositionBufferAsVec2(),
+                reinterpret_cast<vec2f const *>(previousPositionBuffer),
+                inverseMassBuffer,
+                mSprings.GetEndpointsBufferAsElementIndex(),
+                mSprings.GetRestLengthBuffer(),
+                mSprings.GetCoefficientsBufferAsFloat(),
+                isLastSubstep ? mSprings.GetLengthBuffer() : nullptr };
+
+            mSpringConstraintsSubstep.Dt = dt;
+
+            SolveSpringConstraints(gameParameters);
+
+            // Ropes then get their chains solved as a whole, which Gauss-Seidel would need
+            // as many passes as they're long for
+            for (auto const & ropeChain : mRopeChains)
+            {
+                SolveSpringConstraintChain(
+                    mSpringConstraintsSubstep.Buffers,
+                    dt,
+                    mRopeChainSprings.data() + ropeChain.SpringsStart,
+                    mRopeChainPoints.data() + ropeChain.PointsStart,
+                    ropeChain.SpringCount,
+                    ropeChainWorkBuffer);
+            }
+        }
+
+        //
+        // Velocities from the actual displacements
+        //
+
+        {
+            SHIP_PERF_SCOPE(mPerfStats, Integration);
+
+            auto const updateVelocity =
+                [&](size_t i)
+                {
+                    velocityBuffer[i] = (positionBuffer[i] - previousPositionBuffer[i]) * globalDampCoefficient / dt;
+                };
+
+            for (size_t i = 0; i < shipPointComponentCount; ++i)
+            {
+                updateVelocity(i);
+            }
+
+            for (auto pointIndex : mPoints.LiveEphemeralPoints())
+            {
+                updateVelocity(pointIndex * 2);
+                updateVelocity(pointIndex * 2 + 1);
+            }
+        }
+
+        // Handle collisions with sea floor
+        if (doHandleCollisionsWithSeaFloor)
+        {
+            SHIP_PERF_SCOPE(mPerfStats, SeaFloorCollisions);
+
+            HandleCollisionsWithSeaFloor(oceanFloorHeights, dt);
+        }
+    }
+
+    //
+    // Bounds, of all components as all points are integrated
+    //
+
+    BeginAABBsUpdate(true);
+
+    for (ElementIndex p = 0; p < mPoints.GetShipPointCount(); ++p)
+    {
+        ExtendAABBs(p);
+    }
+
+    EndAABBsUpdate();
+}
+
+void Ship::BuildRopeChains()
+{
+    //
+    // Chains run between points that don't have exactly two rope springs - i.e. the
+    // endpoints of ropes, whether attached or not, and the junctions of ropes - through
+    // points that do
+    //
+
+    auto const getRopeSpringCount =
+        [this](ElementIndex pointIndex)
+        {
+            size_t count = 0;
+            for (auto const & cs : mPoints.GetConnectedSprings(pointIndex).ConnectedSprings)
+            {
+                if (mSprings.IsRope(cs.SpringIndex))
+                    ++count;
+            }
+
+            return count;
+        };
+
+    std::vector<bool> isSpringVisited(mSprings.GetElementCount(), false);
+
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+    {
+        size_t const ropeSpringCount = getRopeSpringCount(pointIndex);
+        if (ropeSpringCount == 0 || ropeSpringCount == 2)
+            continue;
+
+        for (auto const & startSpring : mPoints.GetConnectedSprings(pointIndex).ConnectedSprings)
+        {
+            if (!mSprings.IsRope(startSpring.SpringIndex) || isSpringVisited[startSpring.SpringIndex])
+                continue;
+
+            RopeChain chain{ mRopeChainSprings.size(), mRopeChainPoints.size(), 0 };
+
+            mRopeChainPoints.push_back(pointIndex);
+
+            ElementIndex springIndex = startSpring.SpringIndex;
+            ElementIndex nextPointIndex = startSpring.OtherEndpointIndex;
+            while (true)
+            {
+                isSpringVisited[springIndex] = true;
+                mRopeChainSprings.push_back(springIndex);
+                mRopeChainPoints.push_back(nextPointIndex);
+                ++chain.SpringCount;
+
+                if (getRopeSpringCount(nextPointIndex) != 2)
+                    break;
+
+                // Continue with the other rope spring of this point
+                ElementIndex otherSpringIndex = NoneElementIndex;
+                ElementIndex otherPointIndex = NoneElementIndex;
+                for (auto const & cs : mPoints.GetConnectedSprings(nextPointIndex).ConnectedSprings)
+                {
+                    if (cs.SpringIndex != springIndex && mSprings.IsRope(cs.SpringIndex))
+                    {
+                        otherSpringIndex = cs.SpringIndex;
+                        otherPointIndex = cs.OtherEndpointIndex;
+                    }
+                }
+
+                assert(otherSpringIndex != NoneElementIndex);
+                if (isSpringVisited[otherSpringIndex])
+                    break;
+
+                springIndex = otherSpringIndex;
+                nextPointIndex = otherPointIndex;
+            }
+
+            if (chain.SpringCount > 1)
+            {
+                mRopeChains.push_back(chain);
+                mMaxRopeChainSpringCount = std::max(mMaxRopeChainSpringCount, chain.SpringCount);
+            }
+            else
+            {
+                // Nothing to gain from solving a single spring as a chain
+                mRopeChainSprings.resize(chain.SpringsStart);
+                mRopeChainPoints.resize(chain.PointsStart);
+            }
+        }
+    }
+}
+
+void Ship::SolveSpringConstraints(GameParameters const & gameParameters)
+{
+    if (gameParameters.DoParallelizeSpringForces
+        && mSprings.GetElementCount() >= MinSpringsForParallelSpringForces
+        && TaskThreadPool::GetInstance().GetParallelism() > 1)
+    {
+        SolveSpringConstraintsParallel();
+    }
+    else if (!mSpatiallySortedSprings.empty())
+    {
+        SolveIndexedSpringConstraints(
+            mSpringConstraintsSubstep.Buffers,
+            mSpringConstraintsSubstep.Dt,
+            mSpatiallySortedSprings.data(),
+            mSpatiallySortedSprings.size());
+    }
+    else if (!mLiveSprings.empty())
+    {
+        SolveIndexedSpringConstraints(
+            mSpringConstraintsSubstep.Buffers,
+            mSpringConstraintsSubstep.Dt,
+            mLiveSprings.data(),
+            mLiveSprings.size());
+    }
+    else
+    {
+        Physics::SolveSpringConstraints(
+            mSpringConstraintsSubstep.Buffers,
+            mSpringConstraintsSubstep.Dt,
+            0,
+            static_cast<ElementIndex>(mSprings.GetElementCount()));
+    }
+}
+
+void Ship::SolveSpringConstraintsParallel()
+{
+    UpdateParallelForceBatches();
+
+    if (mParallelSpringConstraintTasks.empty())
+    {
+        //
+        // Split each batch into tasks, as for the spring forces; the tasks take the buffers
+        // and the dt of the current substep when they run, as the previous positions live
+        // in the work buffers of the step
+        //
+
+        size_t const parallelism = TaskThreadPool::GetInstance().GetParallelism();
+
+        for (size_t b = 0; b < mSprings.GetParallelForceBatchCount(); ++b)
+        {
+            ElementIndex const * const batchBegin = mSprings.GetParallelForceBatchBegin(b);
+            size_t const batchSize = mSprings.GetParallelForceBatchEnd(b) - batchBegin;
+
+            size_t const taskCount = std::max(
+                std::min(parallelism, batchSize / MinSpringsPerParallelSpringForcesTask),
+                size_t(1));
+
+            mParallelSpringConstraintTasks.emplace_back();
+            auto & batchTasks = mParallelSpringConstraintTasks.back();
+
+            for (size_t t = 0; t < taskCount; ++t)
+            {
+                ElementIndex const * const taskBegin = batchBegin + batchSize * t / taskCount;
+                ElementIndex const * const taskEnd = batchBegin + batchSize * (t + 1) / taskCount;
+
+                batchTasks.emplace_back(
+                    [substep = &mSpringConstraintsSubstep, taskBegin, taskEnd]()
+                    {
+                        SolveIndexedSpringConstraints(
+                            substep->Buffers,
+                            substep->Dt,
+                            taskBegin,
+                            static_cast<size_t>(taskEnd - taskBegin));
+                    });
+            }
+        }
+    }
+
+    //
+    // Run all batches, one after the other: springs within a batch share no endpoints,
+    // hence this is a Gauss-Seidel in the order of the batches, whose results do not
+    // depend on the number of threads nor on how tasks get scheduled
+    //
+
+    for (auto const & batchTasks : mParallelSpringConstraintTasks)
+    {
+        TaskThreadPool::GetInstance().Run(batchTasks);
+    }
+}
+
+void Ship::UpdateSpatiallySortedSprings()
+{
+    //
+    // Bucket the springs' midpoints into square cells, and sort the springs
+    // along the Morton curve of their cells - so that springs close in space,
+    // and thus their endpoints, are visited close in time
+    //
+
+    vec2f minPosition(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+    {
+        minPosition.x = std::min(minPosition.x, mPoints.GetPosition(pointIndex).x);
+        minPosition.y = std::min(minPosition.y, mPoints.GetPosition(pointIndex).y);
+    }
+
+    auto const interleave = [](uint32_t v) -> uint64_t
+    {
+        uint64_t x = v;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x << 2)) & 0x3333333333333333ull;
+        x = (x | (x << 1)) & 0x5555555555555555ull;
+        return x;
+    };
+
+    std::vector<std::pair<uint64_t, ElementIndex>> springKeys;
+    springKeys.reserve(mSprings.GetElementCount());
+    std::vector<ElementIndex> indexOrderSprings;
+    indexOrderSprings.reserve(mSprings.GetElementCount());
+
+    for (auto springIndex : mSprings)
+    {
+        if (!mSprings.IsDeleted(springIndex))
+        {
+            vec2f const midpoint =
+                (mPoints.GetPosition(mSprings.GetEndpointAIndex(springIndex))
+                 + mPoints.GetPosition(mSprings.GetEndpointBIndex(springIndex))) / 2.0f
+                - minPosition;
+
+            uint32_t const cellX = static_cast<uint32_t>(std::max(midpoint.x / SpatialSpringSortCellSize, 0.0f));
+            uint32_t const cellY = static_cast<uint32_t>(std::max(midpoint.y / SpatialSpringSortCellSize, 0.0f));
+
+            springKeys.emplace_back(interleave(cellX) | (interleave(cellY) << 1), springIndex);
+            indexOrderSprings.push_back(springIndex);
+        }
+    }
+
+    // Springs in the same cell keep their index order
+    std::sort(springKeys.begin(), springKeys.end());
+
+    std::vector<ElementIndex> sortedSprings;
+    sortedSprings.reserve(springKeys.size());
+    for (auto const & springKey : springKeys)
+    {
+        sortedSprings.push_back(springKey.second);
+    }
+
+    //
+    // Only adopt the spatial order if it's friendlier to the cache than the index order
+    //
+
+    float const indexOrderACMR = ShipBuilder::CalculateSpringACMR(mSprings, indexOrderSprings);
+    float const spatialOrderACMR = ShipBuilder::CalculateSpringACMR(mSprings, sortedSprings);
+
+    LogMessage("Ship ", mId, ": spring ACMR: index order=", indexOrderACMR, ", spatial order=", spatialOrderACMR);
+
+    if (spatialOrderACMR < indexOrderACMR)
+    {
+        mSpatiallySortedSprings = std::move(sortedSprings);
+    }
+    else
+    {
+        mSpatiallySortedSprings.clear();
+    }
+
+    mAreSpatiallySortedSpringsDirty = false;
+    mSpatiallySortedSpringsDirtyStepCount = 0;
+}
+
+void Ship::RunMaintenance(GameParameters const & gameParameters)
+{
+    // One piece at a time, the most overdue first
+    bool const isSortPending = mAreSpatiallySortedSpringsDirty && gameParameters.DoSortSpringsSpatially;
+
+    if (isSortPending
+        && (!mAreLiveSpringsDirty || mSpatiallySortedSpringsDirtyStepCount >= mLiveSpringsDirtyStepCount))
+    {
+        UpdateSpatiallySortedSprings();
+    }
+    else if (mAreLiveSpringsDirty)
+    {
+        UpdateLiveSprings();
+    }
+}
+
+void Ship::UpdateLiveSprings()
+{
+    mLiveSprings.clear();
+
+    for (auto springIndex : mSprings)
+    {
+        if (!mSprings.IsDeleted(springIndex))
+        {
+            mLiveSprings.push_back(springIndex);
+        }
+    }
+
+    size_t const deletedSpringCount = mSprings.GetElementCount() - mLiveSprings.size();
+    if (static_cast<float>(deletedSpringCount) < MinDeletedSpringFractionForLiveSprings * static_cast<float>(mSprings.GetElementCount()))
+    {
+        // Not worth it yet
+        mLiveSprings.clear();
+    }
+
+    mAreLiveSpringsDirty = false;
+    mLiveSpringsDirtyStepCount = 0;
+}
+
+void Ship::InitializeFrontier()
+{
+    for (auto springIndex : mSprings)
+    {
+        UpdateFrontierSpring(springIndex, mSprings.IsDeleted(springIndex));
+    }
+}
+
+void Ship::UpdateFrontierSpring(
+    ElementIndex springElementIndex,
+    bool isSpringDeleted)
+{
+    bool const isFrontierSpring =
+        !isSpringDeleted
+        && mSprings.GetSuperTriangles(springElementIndex).size() < 2;
+
+    if (isFrontierSpring == mIsFrontierSpring[springElementIndex])
+        return;
+
+    mIsFrontierSpring[springElementIndex] = isFrontierSpring;
+
+    for (ElementIndex const pointIndex : { mSprings.GetEndpointAIndex(springElementIndex), mSprings.GetEndpointBIndex(springElementIndex) })
+    {
+        if (isFrontierSpring)
+        {
+            if (mPointFrontierSpringCounts[pointIndex]++ == 0)
+            {
+                mFrontierPointPositions[pointIndex] = static_cast<ElementIndex>(mFrontierPoints.size());
+                mFrontierPoints.push_back(pointIndex);
+            }
+        }
+        else
+        {
+            assert(mPointFrontierSpringCounts[pointIndex] > 0);
+
+            if (--mPointFrontierSpringCounts[pointIndex] == 0)
+            {
+                // Move the last point into this one's place
+                ElementIndex const position = mFrontierPointPositions[pointIndex];
+                assert(position < mFrontierPoints.size() && mFrontierPoints[position] == pointIndex);
+
+                mFrontierPoints[position] = mFrontierPoints.back();
+                mFrontierPointPositions[mFrontierPoints[position]] = position;
+                mFrontierPoints.pop_back();
+
+                mFrontierPointPositions[pointIndex] = NoneElementIndex;
+            }
+        }
+    }
+}
+
+void Ship::IntegrateAndResetPointForces(
+    bool doUpdateAABBs,
+    GameParameters const & gameParameters)
+{
+    float const dt = gameParameters.MechanicalSimulationStepTimeDuration<float>();
+
+    // Global damp - lowers velocity uniformly, damping oscillations originating between gravity and buoyancy
+    //
+    // Considering that:
+    //
+    //  v1 = d*v0
+    //  v2 = d*v1 =(d^2)*v0
+    //  ...
+    //  vN = (d^N)*v0
+    //
+    // ...the more the number of iterations, the more damped the initial velocity would be.
+    // We want damping to be independent from the number of iterations though, so we need to find the value
+    // d such that after N iterations the damping is the same as our reference value, which is based on
+    // 12 (basis) iterations. For example, double the number of iterations requires square root (1/2) of
+    // this value.
+    //
+
+    float const globalDampCoefficient = pow(
+        GameParameters::GlobalDamp,
+        12.0f / gameParameters.NumMechanicalDynamicsIterations<float>());
+
+    //
     // Take the four buffers that we need as restrict pointers, so that the compiler
     // can better see it should parallelize this loop as much as possible
     //
-    // This loop is compiled with single-precision packet SSE instructions on MSVC 17,
-    // integrating two points at each iteration
+    // This loop is compiled with single-precision packet SSE instructions on MSVC 17,
+    // integrating two points at each iteration
+    //
+
+    float * restrict positionBuffer = mPoints.GetPositionBufferAsFloat();
+    float * restrict velocityBuffer = mPoints.GetVelocityBufferAsFloat();
+    float * restrict forceBuffer = mPoints.GetForceBufferAsFloat();
+    float * restrict integrationFactorBuffer = mPoints.GetIntegrationFactorBufferAsFloat();
+
+    if (!doUpdateAABBs)
+    {
+        size_t const count = mPoints.GetShipPointCount() * 2; // Two components per vector
+        for (size_t i = 0; i < count; ++i)
+        {
+            //
+            // Verlet integration (fourth order, with velocity being first order)
+            //
+
+            float const deltaPos = velocityBuffer[i] * dt + forceBuffer[i] * integrationFactorBuffer[i];
+            positionBuffer[i] += deltaPos;
+            velocityBuffer[i] = deltaPos * globalDampCoefficient / dt;
+
+            // Zero out force now that we've integrated it
+            forceBuffer[i] = 0.0f;
+        }
+    }
+    else
+    {
+        //
+        // Same as above, but point by point, so to extend the bounds with each point
+        // while it's in cache
+        //
+
+        size_t const count = mPoints.GetShipPointCount();
+        for (size_t p = 0; p < count; ++p)
+        {
+            for (size_t i = p * 2; i < p * 2 + 2; ++i)
+            {
+                float const deltaPos = velocityBuffer[i] * dt + forceBuffer[i] * integrationFactorBuffer[i];
+                positionBuffer[i] += deltaPos;
+                velocityBuffer[i] = deltaPos * globalDampCoefficient / dt;
+
+                forceBuffer[i] = 0.0f;
+            }
+
+            ExtendAABBs(static_cast<ElementIndex>(p));
+        }
+    }
+
+    //
+    // Ephemeral points: only the live ones, the others are frozen anyway
     //
 
-    float * restrict positionBuffer = mPoints.GetPositionBufferAsFloat();
-    float * restrict velocityBuffer = mPoints.GetVelocityBufferAsFloat();
-    float * restrict forceBuffer = mPoints.GetForceBufferAsFloat();
-    float * restrict integrationFactorBuffer = mPoints.GetIntegrationFactorBufferAsFloat();
+    for (auto pointIndex : mPoints.LiveEphemeralPoints())
+    {
+        for (size_t i = pointIndex * 2; i < pointIndex * 2 + 2; ++i)
+        {
+            float const deltaPos = velocityBuffer[i] * dt + forceBuffer[i] * integrationFactorBuffer[i];
+            positionBuffer[i] += deltaPos;
+            velocityBuffer[i] = deltaPos * globalDampCoefficient / dt;
+
+            forceBuffer[i] = 0.0f;
+        }
+    }
+}
 
-    size_t const count = mPoints.GetBufferElementCount() * 2; // Two components per vector
-    for (size_t i = 0; i < count; ++i)
+void Ship::BeginAABBsUpdate(bool doUpdateAllComponents)
+{
+    if (mConnectedComponentAABBs.size() != mConnectedComponents.size())
     {
-        //
-        // Verlet integration (fourth order, with velocity being first order)
-        //
+        // Components have changed since the last update; they're all awake then
+        mConnectedComponentAABBs.assign(mConnectedComponents.size(), EmptyAABB);
+        return;
+    }
 
-        float const deltaPos = velocityBuffer[i] * dt + forceBuffer[i] * integrationFactorBuffer[i];
-        positionBuffer[i] += deltaPos;
-        velocityBuffer[i] = deltaPos * globalDampCoefficient / dt;
+    assert(mIslandSleepStates.size() == mConnectedComponentAABBs.size());
 
-        // Zero out force now that we've integrated it
-        forceBuffer[i] = 0.0f;
+    for (size_t c = 0; c < mConnectedComponentAABBs.size(); ++c)
+    {
+        if (doUpdateAllComponents || !mIslandSleepStates[c].IsSleeping)
+        {
+            mConnectedComponentAABBs[c] = EmptyAABB;
+        }
+    }
+}
+
+inline void Ship::ExtendAABBs(ElementIndex pointIndex)
+{
+    // Ephemeral particles have no component
+    ConnectedComponentId const componentId = mPoints.GetConnectedComponentId(pointIndex);
+    if (componentId >= mConnectedComponentAABBs.size())
+        return;
+
+    vec2f const & position = mPoints.GetPosition(pointIndex);
+    Geometry::AABB & box = mConnectedComponentAABBs[componentId];
+
+    box.BottomLeft.x = std::min(box.BottomLeft.x, position.x);
+    box.BottomLeft.y = std::min(box.BottomLeft.y, position.y);
+    box.TopRight.x = std::max(box.TopRight.x, position.x);
+    box.TopRight.y = std::max(box.TopRight.y, position.y);
+}
+
+void Ship::EndAABBsUpdate()
+{
+    // Inverted boxes leave the union as it is
+    mAABB = EmptyAABB;
+    for (auto const & box : mConnectedComponentAABBs)
+    {
+        mAABB.ExtendTo(box);
+    }
+}
+
+bool Ship::IsCloseToSeaFloor() const
+{
+    //
+    // Find the horizontal span of the awake points and the lowest they may get
+    // during the step at their current velocities, and compare it with the
+    // highest the floor gets in that span
+    //
+
+    if (mAwakePoints.empty())
+        return false;
+
+    float constexpr StepDuration = GameParameters::SimulationStepTimeDuration<float>;
+
+    float left = std::numeric_limits<float>::max();
+    float right = std::numeric_limits<float>::lowest();
+    float bottom = std::numeric_limits<float>::max();
+
+    for (auto pointIndex : mAwakePoints)
+    {
+        vec2f const & position = mPoints.GetPosition(pointIndex);
+        float const vy = mPoints.GetVelocity(pointIndex).y;
+
+        left = std::min(left, position.x);
+        right = std::max(right, position.x);
+        bottom = std::min(bottom, position.y + std::min(vy, 0.0f) * StepDuration);
     }
+
+    return bottom - SeaFloorCollisionCullingMargin <= mParentWorld.GetMaxOceanFloorHeightIn(left, right);
 }
 
-void Ship::HandleCollisionsWithSeaFloor(GameParameters const & gameParameters)
+void Ship::HandleCollisionsWithSeaFloor(
+    float const * restrict oceanFloorHeights,
+    float dt)
 {
     //
     // We handle collisions really simplistically: we move back points to where they were
@@ -658,37 +2537,460 @@ void Ship::HandleCollisionsWithSeaFloor(GameParameters const & gameParameters)
     // Hence we're gonna stick with this simple algorithm.
     //
 
+    // Find the - few - points that are below the sea floor first, with a vectorized
+    // gather-and-compare, and then only visit those
+    size_t * const belowPointOrdinals = mWorkBufferArena.Allocate<size_t>(mAwakePoints.size());
+    size_t const belowPointCount = FindPointsBelowSeaFloor(
+        GetBestPointCollisionsImplementation(),
+        mPoints.GetPositionBufferAsVec2(),
+        oceanFloorHeights,
+        mAwakePoints.data(),
+        mAwakePoints.size(),
+        belowPointOrdinals);
+
+    for (size_t b = 0; b < belowPointCount; ++b)
+    {
+        ElementIndex const pointIndex = mAwakePoints[belowPointOrdinals[b]];
+        HandleCollisionWithSeaFloor(pointIndex, oceanFloorHeights[pointIndex], dt);
+    }
+}
+
+inline void Ship::HandleCollisionWithSeaFloor(
+    ElementIndex pointIndex,
+    float floorheight,
+    float dt)
+{
     // The fraction of velocity that bounces back (we model inelastic bounces)
     static constexpr float VelocityBounceFraction = -0.75f;
 
+    // Check if point is now below the sea floor
+    if (mPoints.GetPosition(pointIndex).y < floorheight)
+    {
+        // Move point back to where it was
+        mPoints.GetPosition(pointIndex) -= mPoints.GetVelocity(pointIndex) * dt;
+
+        //
+        // Calculate new velocity
+        //
+        // Colliding points are few, hence we sample the floor's slope right here
+        //
+
+        vec2f seaFloorNormal = vec2f(
+            floorheight - mParentWorld.GetOceanFloorHeightAt(mPoints.GetPosition(pointIndex).x + 0.01f),
+            0.01f).normalise();
+
+        vec2f newVelocity =
+            (mPoints.GetVelocity(pointIndex) * VelocityBounceFraction) // Bounce velocity (naively), with some inelastic absorption
+            + (seaFloorNormal * 0.5f); // Add a small normal component, so to have some non-infinite friction
+
+        mPoints.SetVelocity(pointIndex, newVelocity);
+    }
+}
+
+template<size_t ... KernelIndices>
+constexpr std::array<Ship::IntegrateAndUpdatePointForcesKernelPtr, sizeof...(KernelIndices)> Ship::MakeIntegrateAndUpdatePointForcesKernels(
+    std::index_sequence<KernelIndices...>)
+{
+    return { {
+        &Ship::IntegrateAndUpdatePointForcesKernel<
+            (KernelIndices & 1) != 0,
+            (KernelIndices & 2) != 0,
+            (KernelIndices & 4) != 0,
+            (KernelIndices & 8) != 0,
+            (KernelIndices & 16) != 0>... } };
+}
+
+void Ship::IntegrateAndUpdatePointForces(
+    bool doUpdatePointForces,
+    bool doHandleCollisionsWithSeaFloor,
+    bool doUpdateAABBs,
+    float const * restrict waterHeights,
+    float const * restrict windForceMultipliers,
+    float const * restrict oceanFloorHeights,
+    PointForcesConstants const & pointForcesConstants,
+    GameParameters const & gameParameters)
+{
+    static constexpr auto Kernels = MakeIntegrateAndUpdatePointForcesKernels(std::make_index_sequence<32>());
+
+    size_t const kernelIndex =
+        (doUpdatePointForces ? 1 : 0)
+        | (doHandleCollisionsWithSeaFloor ? 2 : 0)
+        | (doUpdateAABBs ? 4 : 0)
+        | (windForceMultipliers != nullptr ? 8 : 0)
+        | (pointForcesConstants.ForceFieldCount > 0 ? 16 : 0);
+
+    (this->*Kernels[kernelIndex])(
+        waterHeights,
+        windForceMultipliers,
+        oceanFloorHeights,
+        pointForcesConstants,
+        gameParameters);
+}
+
+template<
+    bool DoUpdatePointForces,
+    bool DoHandleCollisionsWithSeaFloor,
+    bool DoUpdateAABBs,
+    bool HasWindForceMultipliers,
+    bool HasForceFields>
+void Ship::IntegrateAndUpdatePointForcesKernel(
+    float const * restrict waterHeights,
+    float const * restrict windForceMultipliers,
+    float const * restrict oceanFloorHeights,
+    PointForcesConstants const & pointForcesConstants,
+    GameParameters const & gameParameters)
+{
     float const dt = gameParameters.MechanicalSimulationStepTimeDuration<float>();
 
-    for (auto pointIndex : mPoints)
+    // See IntegrateAndResetPointForces()
+    float const globalDampCoefficient = pow(
+        GameParameters::GlobalDamp,
+        12.0f / gameParameters.NumMechanicalDynamicsIterations<float>());
+
+    for (auto pointIndex : mAwakePoints)
     {
-        // Check if point is now below the sea floor
-        float const floorheight = mParentWorld.GetOceanFloorHeightAt(mPoints.GetPosition(pointIndex).x);
-        if (mPoints.GetPosition(pointIndex).y < floorheight)
+        //
+        // 1. Verlet integration (fourth order, with velocity being first order)
+        //
+
+        vec2f & force = mPoints.GetForce(pointIndex);
+        vec2f const & integrationFactor = mPoints.GetIntegrationFactor(pointIndex);
+
+        vec2f const deltaPos =
+            mPoints.GetVelocity(pointIndex) * dt
+            + vec2f(force.x * integrationFactor.x, force.y * integrationFactor.y);
+
+        mPoints.GetPosition(pointIndex) += deltaPos;
+        mPoints.SetVelocity(pointIndex, deltaPos * globalDampCoefficient / dt);
+
+        // Zero out force now that we've integrated it
+        force = vec2f::zero();
+
+        //
+        // 2. Handle collision with sea floor
+        //
+
+        if constexpr (DoHandleCollisionsWithSeaFloor)
         {
-            // Move point back to where it was
-            mPoints.GetPosition(pointIndex) -= mPoints.GetVelocity(pointIndex) * dt;
+            HandleCollisionWithSeaFloor(pointIndex, oceanFloorHeights[pointIndex], dt);
+        }
 
-            //
-            // Calculate new velocity
-            //
+        //
+        // 3. Extend bounds with the final position
+        //
+
+        if constexpr (DoUpdateAABBs)
+        {
+            ExtendAABBs(pointIndex);
+        }
+
+        //
+        // 4. Calculate point forces for the next iteration
+        //
+
+        if constexpr (DoUpdatePointForces)
+        {
+            ApplyPointForces<HasForceFields>(
+                pointIndex,
+                waterHeights[pointIndex],
+                HasWindForceMultipliers ? windForceMultipliers[pointIndex] : 1.0f,
+                pointForcesConstants,
+                gameParameters);
+        }
+    }
+}
+
+bool Ship::IsGPUMechanicalDynamicsAvailable(
+    GameParameters const & gameParameters,
+    SimulationView const & simulationView)
+{
+    if (!gameParameters.DoUseGPUMechanicalDynamics
+        || mIsMechanicalDynamicsGPUCalculatorUnavailable
+        || mPoints.GetShipPointCount() < MinPointsForGPUMechanicalDynamics)
+    {
+        CatchUpWithGPUMechanicalDynamics();
+
+        mMechanicalDynamicsGPUCalculator.reset();
+
+        return false;
+    }
+
+    // The GPU knows nothing of force fields and of sleeping islands, and doesn't
+    // give back the point forces; these steps run on the CPU
+    if (!mCurrentForceFields.empty()
+        || mHasSleepingIslands
+        || simulationView.DoCapturePointForces)
+    {
+        CatchUpWithGPUMechanicalDynamics();
+
+        return false;
+    }
+
+    if (!mMechanicalDynamicsGPUCalculator)
+    {
+        if (!GPUCalculatorFactory::GetInstance().IsInitialized())
+        {
+            mIsMechanicalDynamicsGPUCalculatorUnavailable = true;
+            return false;
+        }
+
+        try
+        {
+            mMechanicalDynamicsGPUCalculator = GPUCalculatorFactory::GetInstance().CreateMechanicalDynamicsCalculator(
+                mPoints.GetShipPointCount(),
+                GPUOceanFloorSampleCount);
+        }
+        catch (GameException const & ex)
+        {
+            LogMessage("Ship ", mId, ": cannot run the mechanical dynamics on the GPU, falling back to the CPU: ", ex.what());
+
+            mIsMechanicalDynamicsGPUCalculatorUnavailable = true;
+            return false;
+        }
+    }
 
-            vec2f seaFloorNormal = vec2f(
-                floorheight - mParentWorld.GetOceanFloorHeightAt(mPoints.GetPosition(pointIndex).x + 0.01f),
-                0.01f).normalise();
+    return true;
+}
+
+void Ship::RunGPUMechanicalDynamics(
+    bool doHandleCollisionsWithSeaFloor,
+    float const * restrict waterHeights,
+    float const * restrict windForceMultipliers,
+    float const * restrict oceanFloorHeights,
+    GameParameters const & gameParameters)
+{
+    assert(!!mMechanicalDynamicsGPUCalculator);
+
+    static_assert(MechanicalDynamicsGPUCalculator::MaxSpringsPerPoint == GameParameters::MaxSpringsPerPoint);
+
+    size_t const pointCount = mMechanicalDynamicsGPUCalculator->GetPointCount();
+    int const numMechanicalDynamicsIterations = gameParameters.NumMechanicalDynamicsIterations<int>();
+
+    float const dt = gameParameters.MechanicalSimulationStepTimeDuration<float>();
+
+    // See IntegrateAndResetPointForces()
+    float const globalDampCoefficient = pow(
+        GameParameters::GlobalDamp,
+        12.0f / gameParameters.NumMechanicalDynamicsIterations<float>());
+
+    PointForcesConstants const pointForcesConstants = CalculatePointForcesConstants(gameParameters);
+
+    //
+    // Decide about the transfers of the point dynamics: unless rendering can't do without
+    // our positions on the CPU, the point dynamics stay on the GPU in between read-backs,
+    // and the step after a read-back starts again from the CPU's, which may have been
+    // changed by interactions in the meantime
+    //
+
+    bool const doUploadPointDynamics = !mAreGPUPointDynamicsAhead;
+
+    ++mGPUMechanicalDynamicsStepCount;
+
+    bool const doReadBackPointDynamics =
+        (nullptr == glCopyBufferSubData)
+        || (nullptr != glFenceSync && nullptr == glWaitSync)
+        || (mGPUMechanicalDynamicsStepCount % GPUMechanicalDynamicsReadBackInterval) == 0;
+
+    //
+    // Populate points
+    //
+
+    vec4f * restrict pointDynamicsBufferData = mMechanicalDynamicsGPUCalculator->GetPointDynamicsBuffer();
+    vec4f * restrict pointAttributes0BufferData = mMechanicalDynamicsGPUCalculator->GetPointAttributes0Buffer();
+    vec4f * restrict pointAttributes1BufferData = mMechanicalDynamicsGPUCalculator->GetPointAttributes1Buffer();
+
+    if (doUploadPointDynamics)
+    {
+        for (ElementIndex pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+        {
+            vec2f const & position = mPoints.GetPosition(pointIndex);
+            vec2f const & velocity = mPoints.GetVelocity(pointIndex);
+
+            pointDynamicsBufferData[pointIndex] = vec4f(
+                position.x,
+                position.y,
+                velocity.x,
+                velocity.y);
+        }
+    }
+
+    for (ElementIndex pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+    {
+        vec2f const & integrationFactor = mPoints.GetIntegrationFactor(pointIndex);
+
+        pointAttributes0BufferData[pointIndex] = vec4f(
+            integrationFactor.x,
+            integrationFactor.y,
+            mPoints.GetTotalMass(pointIndex),
+            mPoints.GetWaterVolumeFill(pointIndex));
+
+        pointAttributes1BufferData[pointIndex] = vec4f(
+            waterHeights[pointIndex],
+            doHandleCollisionsWithSeaFloor ? oceanFloorHeights[pointIndex] : std::numeric_limits<float>::lowest(),
+            mPoints.GetWindReceptivity(pointIndex) * (windForceMultipliers != nullptr ? windForceMultipliers[pointIndex] : 1.0f),
+            0.0f);
+    }
+
+    //
+    // Populate adjacency; the springs' coefficients follow their decay and the
+    // game parameters, hence we do this at each step
+    //
+
+    vec4f * restrict adjacencyBufferData = mMechanicalDynamicsGPUCalculator->GetAdjacencyBuffer();
+
+    for (ElementIndex pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+    {
+        auto const & connectedSprings = mPoints.GetConnectedSprings(pointIndex).ConnectedSprings;
+
+        size_t s = 0;
+        for (; s < connectedSprings.size(); ++s)
+        {
+            auto const & cs = connectedSprings[s];
+
+            adjacencyBufferData[pointIndex * GameParameters::MaxSpringsPerPoint + s] = vec4f(
+                static_cast<float>(cs.OtherEndpointIndex),
+                mSprings.GetRestLength(cs.SpringIndex),
+                mSprings.GetStiffnessCoefficient(cs.SpringIndex),
+                mSprings.GetDampingCoefficient(cs.SpringIndex));
+        }
+
+        for (; s < GameParameters::MaxSpringsPerPoint; ++s)
+        {
+            adjacencyBufferData[pointIndex * GameParameters::MaxSpringsPerPoint + s] = vec4f(-1.0f, 1.0f, 0.0f, 0.0f);
+        }
+    }
+
+    //
+    // Populate ocean floor, which may be changed by the user
+    //
+
+    if (doHandleCollisionsWithSeaFloor)
+    {
+        float * restrict oceanFloorBufferData = mMechanicalDynamicsGPUCalculator->GetOceanFloorBuffer();
+
+        for (size_t s = 0; s < GPUOceanFloorSampleCount; ++s)
+        {
+            oceanFloorBufferData[s] = mParentWorld.GetOceanFloorHeightAt(
+                -GameParameters::HalfMaxWorldWidth + static_cast<float>(s) * GPUOceanFloorDx);
+        }
+    }
+
+    //
+    // Run
+    //
+
+    MechanicalDynamicsGPUCalculator::Constants constants;
+    constants.Gravity = gameParameters.Gravity;
+    constants.WindForce = pointForcesConstants.WindForce;
+    constants.DeltaTime = dt;
+    constants.GlobalDampCoefficient = globalDampCoefficient;
+    constants.WaterDragCoefficient = pointForcesConstants.WaterDragCoefficient;
+    constants.DensityAdjustedWaterMass = pointForcesConstants.DensityAdjustedWaterMass;
+
+    mMechanicalDynamicsGPUCalculator->Run(
+        numMechanicalDynamicsIterations,
+        constants,
+        -GameParameters::HalfMaxWorldWidth,
+        GPUOceanFloorDx,
+        doUploadPointDynamics,
+        doReadBackPointDynamics);
+
+    if (doReadBackPointDynamics)
+    {
+        TakeGPUMechanicalDynamicsResults();
+
+        mAreGPUPointDynamicsAhead = false;
+    }
+    else
+    {
+        // Until the next read-back, the CPU works with the positions as of the last one
+        mAreGPUPointDynamicsAhead = true;
+    }
+
+    //
+    // Ephemeral points on the CPU, which have no springs
+    //
+
+    for (auto pointIndex : mPoints.LiveEphemeralPoints())
+    {
+        for (int iter = 0; iter < numMechanicalDynamicsIterations; ++iter)
+        {
+            // The GPU runs without force fields
+            ApplyPointForces<false>(
+                pointIndex,
+                waterHeights[pointIndex],
+                windForceMultipliers != nullptr ? windForceMultipliers[pointIndex] : 1.0f,
+                pointForcesConstants,
+                gameParameters);
+
+            vec2f & force = mPoints.GetForce(pointIndex);
+            vec2f const & integrationFactor = mPoints.GetIntegrationFactor(pointIndex);
+
+            vec2f const deltaPos =
+                mPoints.GetVelocity(pointIndex) * dt
+                + vec2f(force.x * integrationFactor.x, force.y * integrationFactor.y);
 
-            vec2f newVelocity =
-                (mPoints.GetVelocity(pointIndex) * VelocityBounceFraction) // Bounce velocity (naively), with some inelastic absorption
-                + (seaFloorNormal * 0.5f); // Add a small normal component, so to have some non-infinite friction
+            mPoints.GetPosition(pointIndex) += deltaPos;
+            mPoints.SetVelocity(pointIndex, deltaPos * globalDampCoefficient / dt);
 
-            mPoints.SetVelocity(pointIndex, newVelocity);
+            force = vec2f::zero();
+
+            if (doHandleCollisionsWithSeaFloor)
+            {
+                HandleCollisionWithSeaFloor(pointIndex, oceanFloorHeights[pointIndex], dt);
+            }
         }
     }
 }
 
+void Ship::CatchUpWithGPUMechanicalDynamics()
+{
+    if (mAreGPUPointDynamicsAhead)
+    {
+        assert(!!mMechanicalDynamicsGPUCalculator);
+
+        mMechanicalDynamicsGPUCalculator->ReadBackPointDynamics();
+
+        TakeGPUMechanicalDynamicsResults();
+
+        mAreGPUPointDynamicsAhead = false;
+    }
+}
+
+void Ship::TakeGPUMechanicalDynamicsResults()
+{
+    assert(!!mMechanicalDynamicsGPUCalculator);
+
+    size_t const pointCount = mMechanicalDynamicsGPUCalculator->GetPointCount();
+    vec4f const * restrict pointDynamicsBufferData = mMechanicalDynamicsGPUCalculator->GetPointDynamicsBuffer();
+
+    //
+    // Take back the results, and extend the bounds with them
+    //
+
+    BeginAABBsUpdate(true);
+
+    for (ElementIndex pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+    {
+        vec4f const & dynamics = pointDynamicsBufferData[pointIndex];
+
+        mPoints.GetPosition(pointIndex) = vec2f(dynamics.x, dynamics.y);
+        mPoints.SetVelocity(pointIndex, vec2f(dynamics.z, dynamics.w));
+
+        ExtendAABBs(pointIndex);
+    }
+
+    EndAABBsUpdate();
+
+    // The lengths of the springs, for the strain check
+    float * restrict springLengthBufferData = mSprings.GetLengthBuffer();
+    for (auto springIndex : mSprings)
+    {
+        springLengthBufferData[springIndex] =
+            (mPoints.GetPosition(mSprings.GetEndpointBIndex(springIndex)) - mPoints.GetPosition(mSprings.GetEndpointAIndex(springIndex))).length();
+    }
+}
+
 void Ship::TrimForWorldBounds(
     float /*currentSimulationTime*/,
     GameParameters const & /*gameParameters*/)
@@ -701,187 +3003,306 @@ void Ship::TrimForWorldBounds(
     float constexpr MaxWorldTop = GameParameters::MaxWorldHeight;
     float constexpr MaxWorldBottom = -GameParameters::MaxWorldHeight;
 
-    for (auto pointIndex : mPoints)
+    // Trimming is harmless on dead ephemeral points and on the padding, hence we trim
+    // the whole buffers
+    TrimPointsForWorldBounds(
+        GetBestPointCollisionsImplementation(),
+        mPoints.GetPositionBufferAsVec2(),
+        mPoints.GetVelocityBufferAsVec2(),
+        mPoints.GetBufferElementCount(),
+        WorldBounds{ MaxWorldLeft, MaxWorldRight, MaxWorldBottom, MaxWorldTop, MaxBounceVelocity });
+}
+
+void Ship::GenerateOceanSurfaceImpacts(
+    float const * restrict waterHeights,
+    GameParameters const & /*gameParameters*/)
+{
+    // Only the awake structural points may have moved
+    for (size_t a = 0; a < mAwakeNonEphemeralPointCount; ++a)
     {
-        auto & pos = mPoints.GetPosition(pointIndex);
+        ElementIndex const pointIndex = mAwakePoints[a];
 
-        if (pos.x < MaxWorldLeft)
+        float const verticalVelocity = mPoints.GetVelocity(pointIndex).y;
+        if (verticalVelocity < -MinOceanSurfaceImpactSpeed
+            && mPoints.GetPosition(pointIndex).y < waterHeights[pointIndex]
+            && mPoints.GetPreviousPosition(pointIndex).y >= waterHeights[pointIndex])
         {
-            pos.x = MaxWorldLeft;
-
-            // Bounce bounded
-            mPoints.GetVelocity(pointIndex).x = std::min(-mPoints.GetVelocity(pointIndex).x, MaxBounceVelocity);
+            // This point entered the water during this step
+            mPendingOceanSurfaceDisplacements.emplace_back(
+                mPoints.GetPosition(pointIndex).x,
+                verticalVelocity * OceanSurfaceImpactDisplacementPerSpeed);
         }
-        else if (pos.x > MaxWorldRight)
-        {
-            pos.x = MaxWorldRight;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// Water Dynamics
+///////////////////////////////////////////////////////////////////////////////////
+
+void Ship::UpdateWaterDynamicsPeriod(
+    GameParameters const & gameParameters,
+    SimulationView const & simulationView)
+{
+    if (!gameParameters.DoLowFrequencyWaterDynamics
+        || mLastWaterTakenPerStep > MaxLowFrequencyWaterTakenPerStep)
+    {
+        // Full rate, right away
+        mWaterDynamicsPeriod = 1;
+        return;
+    }
+
+    if (!mCurrentSimulationSequenceNumber.IsStepOf(UpdateWaterDynamicsPeriodFrequency - 1, LowFrequencyPeriod))
+    {
+        // Not time to re-evaluate yet
+        return;
+    }
+
+    //
+    // Ships in view run at full rate
+    //
 
-            // Bounce bounded
-            mPoints.GetVelocity(pointIndex).x = std::max(-mPoints.GetVelocity(pointIndex).x, -MaxBounceVelocity);
-        }
+    vec2f minPosition(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    vec2f maxPosition(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+    {
+        vec2f const & position = mPoints.GetPosition(pointIndex);
+        minPosition.x = std::min(minPosition.x, position.x);
+        minPosition.y = std::min(minPosition.y, position.y);
+        maxPosition.x = std::max(maxPosition.x, position.x);
+        maxPosition.y = std::max(maxPosition.y, position.y);
+    }
 
-        if (pos.y > MaxWorldTop)
-        {
-            pos.y = MaxWorldTop;
+    float const visibleWorldBottom = std::min(simulationView.VisibleWorldBottom, simulationView.VisibleWorldTop);
+    float const visibleWorldTop = std::max(simulationView.VisibleWorldBottom, simulationView.VisibleWorldTop);
 
-            // Bounce bounded
-            mPoints.GetVelocity(pointIndex).y = std::max(-mPoints.GetVelocity(pointIndex).y, -MaxBounceVelocity);
-        }
-        else if (pos.y < MaxWorldBottom)
-        {
-            pos.y = MaxWorldBottom;
+    bool const isInView =
+        maxPosition.x >= simulationView.VisibleWorldLeft
+        && minPosition.x <= simulationView.VisibleWorldRight
+        && maxPosition.y >= visibleWorldBottom
+        && minPosition.y <= visibleWorldTop;
 
-            // Bounce bounded
-            mPoints.GetVelocity(pointIndex).y = std::min(-mPoints.GetVelocity(pointIndex).y, MaxBounceVelocity);
-        }
-    }
+    mWaterDynamicsPeriod = isInView
+        ? 1
+        : std::max(static_cast<std::uint32_t>(gameParameters.LowFrequencyWaterDynamicsPeriod), std::uint32_t(1));
 }
 
-///////////////////////////////////////////////////////////////////////////////////
-// Water Dynamics
-///////////////////////////////////////////////////////////////////////////////////
-
 void Ship::UpdateWaterDynamics(
     float currentSimulationTime,
-    GameParameters const & gameParameters)
+    GameParameters const & gameParameters,
+    float stepMultiplier)
 {
+    bool const doUseGPUWaterDiffusion = IsGPUWaterDiffusionAvailable(gameParameters);
+
+    float waterSplashedInStep = 0.f;
+
+    if (doUseGPUWaterDiffusion)
+    {
+        //
+        // Collect the water diffused on the GPU at the previous run; the inflow below
+        // then works on top of the diffused water, as it would on the CPU
+        //
+
+        ApplyGPUWaterDiffusionResults(waterSplashedInStep);
+    }
+
     //
     // Update intake of water
     //
 
     float waterTakenInStep = 0.f;
 
-    UpdateWaterInflow(
-        currentSimulationTime,
-        gameParameters,
-        waterTakenInStep);
-
-    // Notify
-    mGameEventHandler->OnWaterTaken(waterTakenInStep);
-
+    {
+        SHIP_PERF_SCOPE(mPerfStats, WaterInflow);
 
-    //
-    // Diffuse water
-    //
+        UpdateWaterInflow(
+            currentSimulationTime,
+            gameParameters,
+            stepMultiplier,
+            waterTakenInStep);
+    }
 
-    float waterSplashedInStep = 0.f;
-    UpdateWaterVelocities(gameParameters, waterSplashedInStep);
+    // Remember how quickly we're taking water
+    mLastWaterTakenPerStep = waterTakenInStep / stepMultiplier;
 
-    // Notify
-    mGameEventHandler->OnWaterSplashed(waterSplashedInStep);
+    // Notify - per step, as if we ran at full rate
+    mGameEventHandler->OnWaterTaken(mLastWaterTakenPerStep);
 
 
     //
-    // Run sink/unsink detection
+    // Diffuse water
     //
 
-    if (mCurrentSimulationSequenceNumber.IsStepOf(UpdateSinkingFrequency - 1, LowFrequencyPeriod))
+    if (doUseGPUWaterDiffusion)
     {
-        UpdateSinking();
+        SHIP_PERF_SCOPE(mPerfStats, WaterVelocities);
+
+        // Results are collected at the next run
+        RunGPUWaterDiffusion(gameParameters, stepMultiplier);
+    }
+    else
+    {
+        SHIP_PERF_SCOPE(mPerfStats, WaterVelocities);
+
+        UpdateWaterVelocities(gameParameters, stepMultiplier, waterSplashedInStep);
     }
+
+    // Notify
+    mGameEventHandler->OnWaterSplashed(waterSplashedInStep);
 }
 
 void Ship::UpdateWaterInflow(
     float currentSimulationTime,
     GameParameters const & gameParameters,
+    float stepMultiplier,
     float & waterTaken)
 {
     //
     // Intake/outtake water into/from all the leaking nodes that are underwater
     //
 
-    for (auto pointIndex : mPoints)
+    auto const & leakingPoints = mPoints.GetLeakingPoints();
+    size_t const leakingPointCount = leakingPoints.size();
+
+    //
+    // 1) Calculate the external water height at each leaking point
+    //
+
+    float * restrict externalWaterHeightBufferData = mWorkBufferArena.Allocate<float>(leakingPointCount);
+
+    size_t submergedLeakingPointCount = 0;
+
+    for (size_t l = 0; l < leakingPointCount; ++l)
     {
-        if (mPoints.IsLeaking(pointIndex))
-        {
-            //
-            // 1) Calculate velocity of incoming water, based off Bernoulli's equation applied to point:
-            //  v**2/2 + p/density = c (assuming y of incoming water does not change along the intake)
-            //      With: p = pressure of water at point = d*wh*g (d = water density, wh = water height in point)
-            //
-            // Considering that at equilibrium we have v=0 and p=external_pressure,
-            // then c=external_pressure/density;
-            // external_pressure is height_of_water_at_y*g*density, then c=height_of_water_at_y*g;
-            // hence, the velocity of water incoming at point p, when the "water height" in the point is already
-            // wh and the external water pressure is d*height_of_water_at_y*g, is:
-            //  v = +/- sqrt(2*g*|height_of_water_at_y-wh|)
-            //
+        vec2f const & position = mPoints.GetPosition(leakingPoints[l]);
 
-            float const externalWaterHeight = std::max(
-                mParentWorld.GetWaterHeightAt(mPoints.GetPosition(pointIndex).x)
-                    + 0.1f // Magic number to force flotsam to take some water in and eventually sink
-                    - mPoints.GetPosition(pointIndex).y,
-                0.0f);
+        float const waterHeight = mParentWorld.GetWaterHeightAt(position.x);
 
-            float const internalWaterHeight = mPoints.GetWater(pointIndex);
+        externalWaterHeightBufferData[l] = std::max(
+            waterHeight
+                + 0.1f // Magic number to force flotsam to take some water in and eventually sink
+                - position.y,
+            0.0f);
 
-            float incomingWaterVelocity;
-            if (externalWaterHeight >= internalWaterHeight)
-            {
-                // Incoming water
-                incomingWaterVelocity = sqrtf(2.0f * GameParameters::GravityMagnitude * (externalWaterHeight - internalWaterHeight));
-            }
-            else
-            {
-                // Outgoing water
-                incomingWaterVelocity = - sqrtf(2.0f * GameParameters::GravityMagnitude * (internalWaterHeight - externalWaterHeight));
-            }
+        if (position.y < waterHeight)
+            ++submergedLeakingPointCount;
+    }
 
-            //
-            // 2) In/Outtake water according to velocity:
-            // - During dt, we move a volume of water Vw equal to A*v*dt; the equivalent change in water
-            //   height is thus Vw/A, i.e. v*dt
-            //
+    mStatistics.LeakingPointCount = leakingPointCount;
+    mStatistics.SubmergedLeakingPointCount = submergedLeakingPointCount;
 
-            float newWater =
-                incomingWaterVelocity
-                * GameParameters::SimulationStepTimeDuration<float>
-                * mPoints.GetWaterIntake(pointIndex)
-                * gameParameters.WaterIntakeAdjustment;
+    //
+    // 2) Calculate the water taken in at each leaking point; this is branch-free, so to
+    //    allow for vectorization
+    //
 
-            if (newWater < 0.0f)
-            {
-                // Outgoing water
+    float * restrict newWaterBufferData = mWorkBufferArena.Allocate<float>(leakingPointCount);
 
-                // Make sure we don't over-drain the point
-                newWater = -std::min(-newWater, mPoints.GetWater(pointIndex));
+    float const * restrict waterBufferData = mPoints.GetWaterBufferAsFloat();
+    float const waterIntakeFactor =
+        GameParameters::SimulationStepTimeDuration<float>
+        * stepMultiplier
+        * gameParameters.WaterIntakeAdjustment;
 
-                // Honor the water retention of this material
-                newWater *= mPoints.GetWaterRestitution(pointIndex);
-            }
+    for (size_t l = 0; l < leakingPointCount; ++l)
+    {
+        ElementIndex const pointIndex = leakingPoints[l];
 
-            // Adjust water
-            mPoints.GetWater(pointIndex) += newWater;
+        //
+        // Calculate velocity of incoming water, based off Bernoulli's equation applied to point:
+        //  v**2/2 + p/density = c (assuming y of incoming water does not change along the intake)
+        //      With: p = pressure of water at point = d*wh*g (d = water density, wh = water height in point)
+        //
+        // Considering that at equilibrium we have v=0 and p=external_pressure,
+        // then c=external_pressure/density;
+        // external_pressure is height_of_water_at_y*g*density, then c=height_of_water_at_y*g;
+        // hence, the velocity of water incoming at point p, when the "water height" in the point is already
+        // wh and the external water pressure is d*height_of_water_at_y*g, is:
+        //  v = +/- sqrt(2*g*|height_of_water_at_y-wh|)
+        //
 
-            // Adjust total cumulated intaken water at this point
-            mPoints.GetCumulatedIntakenWater(pointIndex) += newWater;
+        float const internalWaterHeight = waterBufferData[pointIndex];
+        float const dh = externalWaterHeightBufferData[l] - internalWaterHeight;
 
-            // Check if it's time to produce air bubbles
-            if (mPoints.GetCumulatedIntakenWater(pointIndex) > gameParameters.CumulatedIntakenWaterThresholdForAirBubbles)
-            {
-                // Generate air bubbles - but not on ropes as that looks awful
-                if (gameParameters.DoGenerateAirBubbles
-                    && !mPoints.IsRope(pointIndex))
-                {
-                    GenerateAirBubbles(
-                        mPoints.GetPosition(pointIndex),
-                        currentSimulationTime,
-                        mPoints.GetPlaneId(pointIndex),
-                        gameParameters);
-                }
+        // Positive for incoming water, negative for outgoing water
+        float const incomingWaterVelocity = std::copysign(
+            sqrtf(2.0f * GameParameters::GravityMagnitude * std::abs(dh)),
+            dh);
+
+        //
+        // In/Outtake water according to velocity:
+        // - During dt, we move a volume of water Vw equal to A*v*dt; the equivalent change in water
+        //   height is thus Vw/A, i.e. v*dt
+        //
+
+        float const newWater =
+            incomingWaterVelocity
+            * waterIntakeFactor
+            * mPoints.GetWaterIntake(pointIndex);
+
+        // Outgoing water: make sure we don't over-drain the point, and honor the
+        // water retention of this material
+        float const outgoingWater =
+            -std::min(-newWater, internalWaterHeight)
+            * mPoints.GetWaterRestitution(pointIndex);
+
+        newWaterBufferData[l] = (newWater < 0.0f) ? outgoingWater : newWater;
+    }
+
+    //
+    // 3) Adjust water at each leaking point
+    //
+
+    for (size_t l = 0; l < leakingPointCount; ++l)
+    {
+        ElementIndex const pointIndex = leakingPoints[l];
+
+        // Skip sleeping islands
+        if (mHasSleepingIslands
+            && mIslandSleepStates[mPoints.GetConnectedComponentId(pointIndex)].IsSleeping)
+        {
+            continue;
+        }
+
+        float const newWater = newWaterBufferData[l];
+
+        // Adjust water
+        mPoints.GetWater(pointIndex) += newWater;
+
+        // Make sure the water diffusion visits this point
+        if (newWater > 0.0f)
+        {
+            ActivateWaterPoint(pointIndex);
+        }
 
-                // Consume all cumulated water
-                mPoints.GetCumulatedIntakenWater(pointIndex) = 0.0f;
+        // Adjust total cumulated intaken water at this point
+        mPoints.GetCumulatedIntakenWater(pointIndex) += newWater;
+
+        // Check if it's time to produce air bubbles
+        if (mPoints.GetCumulatedIntakenWater(pointIndex) > gameParameters.CumulatedIntakenWaterThresholdForAirBubbles)
+        {
+            // Generate air bubbles - but not on ropes as that looks awful
+            if (gameParameters.DoGenerateAirBubbles
+                && !mPoints.IsRope(pointIndex))
+            {
+                GenerateAirBubbles(
+                    mPoints.GetPosition(pointIndex),
+                    currentSimulationTime,
+                    mPoints.GetPlaneId(pointIndex),
+                    gameParameters);
             }
 
-            // Adjust total water taken during step
-            waterTaken += newWater;
+            // Consume all cumulated water
+            mPoints.GetCumulatedIntakenWater(pointIndex) = 0.0f;
         }
+
+        // Adjust total water taken during step
+        waterTaken += newWater;
     }
 }
 
 void Ship::UpdateWaterVelocities(
     GameParameters const & gameParameters,
+    float stepMultiplier,
     float & waterSplashed)
 {
     //
@@ -891,13 +3312,25 @@ void Ship::UpdateWaterVelocities(
     // Implementation of https://gabrielegiuseppini.wordpress.com/2018/09/08/momentum-based-simulation-of-water-flooding-2d-spaces/
     //
 
+    // Visit active points in index order
+    if (mAreWaterActivePointsUnsorted)
+    {
+        std::sort(mWaterActivePoints.begin(), mWaterActivePoints.end());
+        mAreWaterActivePointsUnsorted = false;
+    }
+
     // Calculate water momenta
-    mPoints.UpdateWaterMomentaFromVelocities();
+    mPoints.UpdateWaterMomentaFromVelocities(mWaterActivePoints);
 
-    // Source and result water buffers
+    // Source and result water buffers; the result buffer is only initialized for the
+    // active points, as all other points are dry - and zero - in both buffers
     float * restrict oldPointWaterBufferData = mPoints.GetWaterBufferAsFloat();
-    auto newPointWaterBuffer = mPoints.MakeWaterBufferCopy();
-    float * restrict newPointWaterBufferData = newPointWaterBuffer->data();
+    float * restrict newPointWaterBufferData = mPoints.GetNewWaterBufferAsFloat();
+    for (auto pointIndex : mWaterActivePoints)
+    {
+        newPointWaterBufferData[pointIndex] = oldPointWaterBufferData[pointIndex];
+    }
+
     vec2f * restrict oldPointWaterVelocityBufferData = mPoints.GetWaterVelocityBufferAsVec2();
     vec2f * restrict newPointWaterMomentumBufferData = mPoints.GetWaterMomentumBufferAsVec2f();
 
@@ -912,26 +3345,72 @@ void Ship::UpdateWaterVelocities(
     // Resultant water velocities along each spring
     std::array<vec2f, GameParameters::MaxSpringsPerPoint> springOutboundWaterVelocities;
 
+    // Per-point gathers of the quantities of each spring, oriented from the point
+    // being visited: normalized spring vector, gravity potential difference,
+    // water of the other endpoint, and rest length
+    std::array<vec2f, GameParameters::MaxSpringsPerPoint> springNormalizedVectors;
+    std::array<float, GameParameters::MaxSpringsPerPoint> springDys;
+    std::array<float, GameParameters::MaxSpringsPerPoint> springOtherEndpointWaters;
+    std::array<float, GameParameters::MaxSpringsPerPoint> springRestLengths;
+
+    //
+    // Precalculate spring geometry, once per spring rather than once per endpoint:
+    // normalized spring vector and gravity potential difference, both oriented
+    // from endpoint A to endpoint B.
     //
-    // Precalculate point "freeness factors", i.e. how much each point's
-    // quantity of water "suppresses" splashes from adjacent kinetic energy losses
+    // We only need the springs of active points; each spring is calculated at its
+    // owner - endpoint A - unless the owner is not active
     //
 
-    auto pointFreenessFactorBuffer = mPoints.AllocateWorkBufferFloat();
-    float * restrict pointFreenessFactorBufferData = pointFreenessFactorBuffer->data();
-    for (auto pointIndex : mPoints)
+    vec2f const * restrict pointPositionBufferData = mPoints.GetPositionBufferAsVec2();
+
+    vec2f * restrict springNormalizedVectorBufferData = mWorkBufferArena.Allocate<vec2f>(mSprings.GetBufferElementCount());
+    float * restrict springDyBufferData = mWorkBufferArena.Allocate<float>(mSprings.GetBufferElementCount());
+
+    auto const calculateSpringGeometry =
+        [&](ElementIndex springIndex)
+        {
+            vec2f const & pointAPosition = pointPositionBufferData[mSprings.GetEndpointAIndex(springIndex)];
+            vec2f const & pointBPosition = pointPositionBufferData[mSprings.GetEndpointBIndex(springIndex)];
+
+            springNormalizedVectorBufferData[springIndex] = (pointBPosition - pointAPosition).normalise();
+            springDyBufferData[springIndex] = pointAPosition.y - pointBPosition.y;
+        };
+
+    // Walk the springs in the points' compressed adjacency
+    auto const & adjacency = mPoints.GetAdjacency();
+    ElementIndex const * restrict adjacencyOffsets = adjacency.Offsets.data();
+    ElementIndex const * restrict adjacencyOwnedEnds = adjacency.OwnedEnds.data();
+    ElementIndex const * restrict adjacencyOtherEndpointIndices = adjacency.OtherEndpointIndices.data();
+    ElementIndex const * restrict adjacencySpringIndices = adjacency.SpringIndices.data();
+
+    for (auto pointIndex : mWaterActivePoints)
     {
-        pointFreenessFactorBufferData[pointIndex] =
-            FastExp(-oldPointWaterBufferData[pointIndex] * 10.0f);
+        for (ElementIndex a = adjacencyOffsets[pointIndex]; a < adjacencyOffsets[pointIndex + 1]; ++a)
+        {
+            if (a < adjacencyOwnedEnds[pointIndex]
+                || !mIsWaterActivePoint[adjacencyOtherEndpointIndices[a]])
+            {
+                calculateSpringGeometry(adjacencySpringIndices[a]);
+            }
+        }
     }
 
 
     //
-    // Visit all points and move water and its momenta
+    // Visit all active points and move water and its momenta
+    //
+    // Water never moves between islands, hence we may skip sleeping islands
     //
 
-    for (auto pointIndex : mPoints)
+    for (auto pointIndex : mWaterActivePoints)
     {
+        if (mHasSleepingIslands
+            && mIslandSleepStates[mPoints.GetConnectedComponentId(pointIndex)].IsSleeping)
+        {
+            continue;
+        }
+
         //
         // 1) Calculate water momenta along all springs
         //
@@ -955,18 +3434,42 @@ void Ship::UpdateWaterVelocities(
 
         totalOutboundWaterFlowWeight = 0.0f;
 
-        size_t const connectedSpringCount = mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size();
+        ElementIndex const adjacencyOffset = adjacencyOffsets[pointIndex];
+        size_t const connectedSpringCount = adjacencyOffsets[pointIndex + 1] - adjacencyOffset;
+        size_t const ownedConnectedSpringCount = adjacencyOwnedEnds[pointIndex] - adjacencyOffset;
+
+        //
+        // Gather the quantities of all springs; springs owned by the point come first, and
+        // the point is their endpoint A, hence their precalculated geometry is already
+        // oriented from the point
+        //
+
         for (size_t s = 0; s < connectedSpringCount; ++s)
         {
-            auto const & cs = mPoints.GetConnectedSprings(pointIndex).ConnectedSprings[s];
+            ElementIndex const springIndex = adjacencySpringIndices[adjacencyOffset + s];
+            ElementIndex const otherEndpointIndex = adjacencyOtherEndpointIndices[adjacencyOffset + s];
+
+            float const orientation = (s < ownedConnectedSpringCount) ? 1.0f : -1.0f;
+
+            springNormalizedVectors[s] = springNormalizedVectorBufferData[springIndex] * orientation;
+            springDys[s] = springDyBufferData[springIndex] * orientation;
+            springOtherEndpointWaters[s] = oldPointWaterBufferData[otherEndpointIndex];
+            springRestLengths[s] = mSprings.GetRestLength(springIndex);
+        }
+
+        //
+        // Calculate, without any indirection
+        //
 
-            // Normalized spring vector, oriented point -> other endpoint
-            vec2f const springNormalizedVector = (mPoints.GetPosition(cs.OtherEndpointIndex) - mPoints.GetPosition(pointIndex)).normalise();
+        float const pointWater = oldPointWaterBufferData[pointIndex];
+        vec2f const pointWaterVelocity = oldPointWaterVelocityBufferData[pointIndex];
 
+        for (size_t s = 0; s < connectedSpringCount; ++s)
+        {
             // Component of the point's own water velocity along the spring
             float const pointWaterVelocityAlongSpring =
-                oldPointWaterVelocityBufferData[pointIndex]
-                .dot(springNormalizedVector);
+                pointWaterVelocity
+                .dot(springNormalizedVectors[s]);
 
             //
             // Calulate Bernoulli's velocity gained along this spring, from this point to
@@ -974,25 +3477,17 @@ void Ship::UpdateWaterVelocities(
             //
 
             // Pressure difference (positive implies point -> other endpoint flow)
-            float const dw = oldPointWaterBufferData[pointIndex] - oldPointWaterBufferData[cs.OtherEndpointIndex];
+            float const dw = pointWater - springOtherEndpointWaters[s];
 
             // Gravity potential difference (positive implies point -> other endpoint flow)
-            float const dy = mPoints.GetPosition(pointIndex).y - mPoints.GetPosition(cs.OtherEndpointIndex).y;
+            float const dy = springDys[s];
 
             // Calculate gained water velocity along this spring, from point to other endpoint
-            // (Bernoulli, 1738)
-            float bernoulliVelocityAlongSpring;
+            // (Bernoulli, 1738); positive when it goes from point to other endpoint
             float const dwy = dw + dy;
-            if (dwy >= 0.0f)
-            {
-                // Gained velocity goes from point to other endpoint
-                bernoulliVelocityAlongSpring = sqrtf(2.0f * GameParameters::GravityMagnitude * dwy);
-            }
-            else
-            {
-                // Gained velocity goes from other endpoint to point
-                bernoulliVelocityAlongSpring = -sqrtf(2.0f * GameParameters::GravityMagnitude * -dwy);
-            }
+            float const bernoulliVelocityAlongSpring = std::copysign(
+                sqrtf(2.0f * GameParameters::GravityMagnitude * std::abs(dwy)),
+                dwy);
 
             // Resultant scalar velocity along spring; outbound only, as
             // if this were inbound it wouldn't result in any movement of the point's
@@ -1007,26 +3502,34 @@ void Ship::UpdateWaterVelocities(
             // diagonalsprings
             springOutboundWaterFlowWeights[s] =
                 springOutboundScalarWaterVelocity
-                / mSprings.GetRestLength(cs.SpringIndex);
+                / springRestLengths[s];
 
             // Resultant outbound velocity along spring
             springOutboundWaterVelocities[s] =
-                springNormalizedVector
+                springNormalizedVectors[s]
                 * springOutboundScalarWaterVelocity;
 
             // Update total outbound flow weight
             totalOutboundWaterFlowWeight += springOutboundWaterFlowWeights[s];
+        }
 
+        //
+        // Update splash neighbors counts
+        //
 
-            //
-            // Update splash neighbors counts
-            //
+        for (size_t s = 0; s < connectedSpringCount; ++s)
+        {
+            ElementIndex const springIndex = adjacencySpringIndices[adjacencyOffset + s];
+
+            // The other endpoint's "freeness factor", i.e. how much its quantity
+            // of water "suppresses" splashes from adjacent kinetic energy losses
+            float const otherEndpointFreenessFactor = FastExp(-springOtherEndpointWaters[s] * 10.0f);
 
             pointSplashFreeNeighbors +=
-                mSprings.GetWaterPermeability(cs.SpringIndex)
-                * pointFreenessFactorBufferData[cs.OtherEndpointIndex];
+                mSprings.GetWaterPermeability(springIndex)
+                * otherEndpointFreenessFactor;
 
-            pointSplashNeighbors += mSprings.GetWaterPermeability(cs.SpringIndex);
+            pointSplashNeighbors += mSprings.GetWaterPermeability(springIndex);
         }
 
 
@@ -1043,10 +3546,17 @@ void Ship::UpdateWaterVelocities(
         float waterQuantityNormalizationFactor = 0.0f;
         if (totalOutboundWaterFlowWeight != 0.0f)
         {
+            // The fraction of the point's water that moves during this step; when running
+            // at a lower frequency, we never move more water than the point has
+            float const waterDiffusionFraction = std::min(
+                mPoints.GetWaterDiffusionSpeed(pointIndex)
+                * gameParameters.WaterDiffusionSpeedAdjustment
+                * stepMultiplier,
+                1.0f);
+
             waterQuantityNormalizationFactor =
                 oldPointWaterBufferData[pointIndex]
-                * mPoints.GetWaterDiffusionSpeed(pointIndex)
-                * gameParameters.WaterDiffusionSpeedAdjustment
+                * waterDiffusionFraction
                 / totalOutboundWaterFlowWeight;
         }
 
@@ -1058,7 +3568,8 @@ void Ship::UpdateWaterVelocities(
 
         for (size_t s = 0; s < connectedSpringCount; ++s)
         {
-            auto const & cs = mPoints.GetConnectedSprings(pointIndex).ConnectedSprings[s];
+            ElementIndex const springIndex = adjacencySpringIndices[adjacencyOffset + s];
+            ElementIndex const otherEndpointIndex = adjacencyOtherEndpointIndices[adjacencyOffset + s];
 
             // Calculate quantity of water directed outwards
             float const springOutboundQuantityOfWater =
@@ -1067,7 +3578,7 @@ void Ship::UpdateWaterVelocities(
 
             assert(springOutboundQuantityOfWater >= 0.0f);
 
-            if (mSprings.GetWaterPermeability(cs.SpringIndex) != 0.0f)
+            if (mSprings.GetWaterPermeability(springIndex) != 0.0f)
             {
                 //
                 // Water - and momentum - move from point to endpoint
@@ -1075,7 +3586,7 @@ void Ship::UpdateWaterVelocities(
 
                 // Move water quantity
                 newPointWaterBufferData[pointIndex] -= springOutboundQuantityOfWater;
-                newPointWaterBufferData[cs.OtherEndpointIndex] += springOutboundQuantityOfWater;
+                newPointWaterBufferData[otherEndpointIndex] += springOutboundQuantityOfWater;
 
                 // Remove "old momentum" (old velocity) from point
                 newPointWaterMomentumBufferData[pointIndex] -=
@@ -1083,7 +3594,7 @@ void Ship::UpdateWaterVelocities(
                     * springOutboundQuantityOfWater;
 
                 // Add "new momentum" (old velocity + velocity gained) to other endpoint
-                newPointWaterMomentumBufferData[cs.OtherEndpointIndex] +=
+                newPointWaterMomentumBufferData[otherEndpointIndex] +=
                     springOutboundWaterVelocities[s]
                     * springOutboundQuantityOfWater;
 
@@ -1093,13 +3604,10 @@ void Ship::UpdateWaterVelocities(
                 // splintered water colliding with whole other endpoint
                 //
 
-                // FUTURE: get rid of this re-calculation once we pre-calculate all spring normalized vectors
-                vec2f const springNormalizedVector = (mPoints.GetPosition(cs.OtherEndpointIndex) - mPoints.GetPosition(pointIndex)).normalise();
-
                 float ma = springOutboundQuantityOfWater;
                 float va = springOutboundWaterVelocities[s].length();
-                float mb = oldPointWaterBufferData[cs.OtherEndpointIndex];
-                float vb = oldPointWaterVelocityBufferData[cs.OtherEndpointIndex].dot(springNormalizedVector);
+                float mb = springOtherEndpointWaters[s];
+                float vb = oldPointWaterVelocityBufferData[otherEndpointIndex].dot(springNormalizedVectors[s]);
 
                 float vf = 0.0f;
                 if (ma + mb != 0.0f)
@@ -1118,7 +3626,7 @@ void Ship::UpdateWaterVelocities(
             else
             {
                 // Deleted springs are removed from points' connected springs
-                assert(!mSprings.IsDeleted(cs.SpringIndex));
+                assert(!mSprings.IsDeleted(springIndex));
 
                 //
                 // New momentum (old velocity + velocity gained) bounces back
@@ -1168,34 +3676,329 @@ void Ship::UpdateWaterVelocities(
 
 
     //
-    // Average kinetic energy loss
+    // Average kinetic energy loss
+    //
+
+    waterSplashed = mWaterSplashedRunningAverage.Update(waterSplashed);
+
+
+
+    //
+    // Move result values back to point, transforming momenta into velocities
+    //
+
+    if (!mWaterActivePoints.empty())
+    {
+        // Without active points both buffers are all dry, and swapping them
+        // would only have the total masses re-calculated
+        mPoints.SwapWaterBuffers();
+    }
+
+    mPoints.UpdateWaterVelocitiesFromMomenta(mWaterActivePoints);
+
+    //
+    // Update active points with the points that have just become wet
+    //
+
+    UpdateWaterActivePoints(
+        mCurrentSimulationSequenceNumber.IsStepOf(RemoveInactiveWaterPointsFrequency - 1, LowFrequencyPeriod));
+}
+
+bool Ship::IsGPUWaterDiffusionAvailable(GameParameters const & gameParameters)
+{
+    if (!gameParameters.DoUseGPUWaterDiffusion
+        || mIsWaterDiffusionGPUCalculatorUnavailable
+        || mPoints.GetShipPointCount() < MinPointsForGPUWaterDiffusion)
+    {
+        if (!!mWaterDiffusionGPUCalculator)
+        {
+            // Back to the CPU; the results of the last run are lost, which is
+            // equivalent to skipping the diffusion for one step
+            mWaterDiffusionGPUCalculator.reset();
+        }
+
+        return false;
+    }
+
+    if (!mWaterDiffusionGPUCalculator)
+    {
+        if (!GPUCalculatorFactory::GetInstance().IsInitialized())
+        {
+            mIsWaterDiffusionGPUCalculatorUnavailable = true;
+            return false;
+        }
+
+        try
+        {
+            mWaterDiffusionGPUCalculator = GPUCalculatorFactory::GetInstance().CreateWaterDiffusionCalculator(
+                mPoints.GetShipPointCount());
+        }
+        catch (GameException const & ex)
+        {
+            LogMessage("Ship ", mId, ": cannot diffuse water on the GPU, falling back to the CPU: ", ex.what());
+
+            mIsWaterDiffusionGPUCalculatorUnavailable = true;
+            return false;
+        }
+
+        mIsWaterDiffusionGPUAdjacencyDirty = true;
+    }
+
+    return true;
+}
+
+void Ship::ApplyGPUWaterDiffusionResults(float & waterSplashed)
+{
+    assert(!!mWaterDiffusionGPUCalculator);
+
+    size_t const pointCount = mWaterDiffusionGPUCalculator->GetPointCount();
+
+    if (!mWaterDiffusionGPUCalculator->RetrieveResults())
+    {
+        // First run
+        return;
+    }
+
+    vec4f const * restrict resultsBufferData = mWaterDiffusionGPUCalculator->GetResultsBuffer();
+
+    //
+    // Move results back to points; we apply the changes brought by the diffusion rather
+    // than the results themselves, so to preserve the changes made to the water
+    // - e.g. by tools - while the GPU was at work.
+    //
+    // Points that have just become wet join the active points, so that - as on the CPU -
+    // all points that are not active are dry
+    //
+
+    vec4f const * restrict uploadedPointAttributes0BufferData = mWaterDiffusionGPUCalculator->GetPointAttributes0Buffer();
+    vec4f const * restrict uploadedPointAttributes1BufferData = mWaterDiffusionGPUCalculator->GetPointAttributes1Buffer();
+
+    float * restrict pointWaterBufferData = mPoints.GetWaterBufferAsFloat();
+    vec2f const * restrict pointWaterVelocityBufferData = mPoints.GetWaterVelocityBufferAsVec2();
+    vec2f * restrict pointWaterMomentumBufferData = mPoints.GetWaterMomentumBufferAsVec2f();
+
+    for (ElementIndex pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+    {
+        vec4f const & result = resultsBufferData[pointIndex];
+
+        float const uploadedWater = uploadedPointAttributes0BufferData[pointIndex].z;
+        vec2f const uploadedWaterMomentum = vec2f(
+            uploadedPointAttributes1BufferData[pointIndex].x,
+            uploadedPointAttributes1BufferData[pointIndex].y) * uploadedWater;
+
+        float const newWater = pointWaterBufferData[pointIndex] + (result.x - uploadedWater);
+
+        if (newWater > 0.0f || mIsWaterActivePoint[pointIndex])
+        {
+            if (!mIsWaterActivePoint[pointIndex])
+            {
+                ActivateWaterPoint(pointIndex);
+            }
+
+            pointWaterMomentumBufferData[pointIndex] =
+                pointWaterVelocityBufferData[pointIndex] * pointWaterBufferData[pointIndex]
+                + (vec2f(result.y, result.z) - uploadedWaterMomentum);
+
+            pointWaterBufferData[pointIndex] = std::max(newWater, 0.0f);
+        }
+
+        waterSplashed += result.w;
+    }
+
+    mPoints.MarkWaterBufferAsDirty();
+    mPoints.UpdateWaterVelocitiesFromMomenta(mWaterActivePoints);
+
+    // Average kinetic energy loss
+    waterSplashed = mWaterSplashedRunningAverage.Update(waterSplashed);
+
+    UpdateWaterActivePoints(
+        mCurrentSimulationSequenceNumber.IsStepOf(RemoveInactiveWaterPointsFrequency - 1, LowFrequencyPeriod));
+}
+
+void Ship::RunGPUWaterDiffusion(
+    GameParameters const & gameParameters,
+    float stepMultiplier)
+{
+    assert(!!mWaterDiffusionGPUCalculator);
+
+    static_assert(WaterDiffusionGPUCalculator::MaxSpringsPerPoint == GameParameters::MaxSpringsPerPoint);
+
+    size_t const pointCount = mWaterDiffusionGPUCalculator->GetPointCount();
+
+    //
+    // Upload adjacency, if the springs have changed
+    //
+
+    if (mIsWaterDiffusionGPUAdjacencyDirty)
+    {
+        vec4f * restrict adjacencyBufferData = mWaterDiffusionGPUCalculator->GetAdjacencyBuffer();
+
+        for (ElementIndex pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+        {
+            auto const & connectedSprings = mPoints.GetConnectedSprings(pointIndex).ConnectedSprings;
+
+            size_t s = 0;
+            for (; s < connectedSprings.size(); ++s)
+            {
+                auto const & cs = connectedSprings[s];
+
+                adjacencyBufferData[pointIndex * GameParameters::MaxSpringsPerPoint + s] = vec4f(
+                    static_cast<float>(cs.OtherEndpointIndex),
+                    mSprings.GetRestLength(cs.SpringIndex),
+                    mSprings.GetWaterPermeability(cs.SpringIndex),
+                    0.0f);
+            }
+
+            for (; s < GameParameters::MaxSpringsPerPoint; ++s)
+            {
+                adjacencyBufferData[pointIndex * GameParameters::MaxSpringsPerPoint + s] = vec4f(-1.0f, 1.0f, 0.0f, 0.0f);
+            }
+        }
+
+        mWaterDiffusionGPUCalculator->UploadAdjacency();
+
+        mIsWaterDiffusionGPUAdjacencyDirty = false;
+    }
+
+    //
+    // Populate point attributes
     //
 
-    waterSplashed = mWaterSplashedRunningAverage.Update(waterSplashed);
+    vec4f * restrict pointAttributes0BufferData = mWaterDiffusionGPUCalculator->GetPointAttributes0Buffer();
+    vec4f * restrict pointAttributes1BufferData = mWaterDiffusionGPUCalculator->GetPointAttributes1Buffer();
 
+    vec2f const * restrict pointPositionBufferData = mPoints.GetPositionBufferAsVec2();
+    float const * restrict pointWaterBufferData = mPoints.GetWaterBufferAsFloat();
+    vec2f const * restrict pointWaterVelocityBufferData = mPoints.GetWaterVelocityBufferAsVec2();
 
+    float const waterDiffusionFractionFactor =
+        gameParameters.WaterDiffusionSpeedAdjustment
+        * stepMultiplier;
+
+    for (ElementIndex pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+    {
+        pointAttributes0BufferData[pointIndex] = vec4f(
+            pointPositionBufferData[pointIndex].x,
+            pointPositionBufferData[pointIndex].y,
+            pointWaterBufferData[pointIndex],
+            std::min(mPoints.GetWaterDiffusionSpeed(pointIndex) * waterDiffusionFractionFactor, 1.0f));
+
+        pointAttributes1BufferData[pointIndex] = vec4f(
+            pointWaterVelocityBufferData[pointIndex].x,
+            pointWaterVelocityBufferData[pointIndex].y,
+            0.0f,
+            0.0f);
+    }
 
     //
-    // Move result values back to point, transforming momenta into velocities
+    // Run
     //
 
-    mPoints.UpdateWaterBuffer(std::move(newPointWaterBuffer));
-    mPoints.UpdateWaterVelocitiesFromMomenta();
+    mWaterDiffusionGPUCalculator->Run(
+        GameParameters::GravityMagnitude,
+        gameParameters.WaterCrazyness);
 }
 
-void Ship::UpdateSinking()
+void Ship::ActivateWaterPoint(ElementIndex pointElementIndex)
 {
-    //
-    // Calculate total number of wet points
-    //
+    assert(!mPoints.IsEphemeral(pointElementIndex));
+
+    auto const activate =
+        [this](ElementIndex pointIndex)
+        {
+            if (!mIsWaterActivePoint[pointIndex])
+            {
+                mIsWaterActivePoint[pointIndex] = true;
+                mWaterActivePoints.push_back(pointIndex);
+                mAreWaterActivePointsUnsorted = true;
+            }
+        };
+
+    activate(pointElementIndex);
+
+    for (auto const & cs : mPoints.GetConnectedSprings(pointElementIndex).ConnectedSprings)
+    {
+        activate(cs.OtherEndpointIndex);
+    }
+}
+
+void Ship::UpdateWaterActivePoints(bool doRemoveInactivePoints)
+{
+    float const * restrict waterBufferData = mPoints.GetWaterBufferAsFloat();
 
+    // Activate the neighbors of all wet points; these get appended, and they're
+    // all neighbors of wet points, hence there's no need to visit them.
+    //
+    // As all points that are not active are dry, this is also where we accumulate
+    // the ship's water totals
+    float totalWater = 0.0f;
     size_t wetPointCount = 0;
 
-    for (auto p : mPoints.NonEphemeralPoints())
+    size_t const activePointsCount = mWaterActivePoints.size();
+    for (size_t i = 0; i < activePointsCount; ++i)
+    {
+        float const water = waterBufferData[mWaterActivePoints[i]];
+        if (water > 0.0f)
+        {
+            ActivateWaterPoint(mWaterActivePoints[i]);
+
+            totalWater += water;
+            if (water >= WetPointWaterThreshold)
+                ++wetPointCount;
+        }
+    }
+
+    mStatistics.TotalWater = totalWater;
+    mStatistics.WetPointCount = wetPointCount;
+
+    if (doRemoveInactivePoints)
     {
-        if (mPoints.GetWater(p) >= 0.5f) // Magic number - we only count a point as wet if its water is above this threshold
-            ++wetPointCount;
+        float * restrict newWaterBufferData = mPoints.GetNewWaterBufferAsFloat();
+        vec2f * restrict waterMomentumBufferData = mPoints.GetWaterMomentumBufferAsVec2f();
+
+        // Remove the dry points that have no wet neighbors
+        auto const isInactive =
+            [this, waterBufferData](ElementIndex pointIndex)
+            {
+                if (waterBufferData[pointIndex] > 0.0f)
+                    return false;
+
+                for (auto const & cs : mPoints.GetConnectedSprings(pointIndex).ConnectedSprings)
+                {
+                    if (waterBufferData[cs.OtherEndpointIndex] > 0.0f)
+                        return false;
+                }
+
+                return true;
+            };
+
+        auto const newEnd = std::remove_if(
+            mWaterActivePoints.begin(),
+            mWaterActivePoints.end(),
+            [this, &isInactive, newWaterBufferData, waterMomentumBufferData](ElementIndex pointIndex)
+            {
+                if (isInactive(pointIndex))
+                {
+                    mIsWaterActivePoint[pointIndex] = false;
+
+                    // Inactive points must be dry in both water buffers, and have no momentum
+                    newWaterBufferData[pointIndex] = 0.0f;
+                    waterMomentumBufferData[pointIndex] = vec2f::zero();
+
+                    return true;
+                }
+
+                return false;
+            });
+
+        mWaterActivePoints.erase(newEnd, mWaterActivePoints.end());
     }
+}
+
+void Ship::UpdateSinking()
+{
+    // The number of wet points is accumulated by the water dynamics
+    size_t const wetPointCount = mStatistics.WetPointCount;
 
     if (!mIsSinking)
     {
@@ -1225,10 +4028,38 @@ void Ship::UpdateElectricalDynamics(
     GameWallClock::time_point currentWallclockTime,
     GameParameters const & gameParameters)
 {
-    // Generate a new visit sequence number
-    ++mCurrentElectricalVisitSequenceNumber;
+    //
+    // Generators that got wet or dry switch their circuits off or on
+    //
+
+    auto const & generators = mElectricalElements.Generators();
+    for (size_t g = 0; g < generators.size(); ++g)
+    {
+        bool const isWet =
+            !mElectricalElements.IsDeleted(generators[g])
+            && mPoints.IsWet(mElectricalElements.GetPointIndex(generators[g]), MaxDryGeneratorWater);
+
+        if (isWet != mAreGeneratorsWet[g])
+        {
+            mAreGeneratorsWet[g] = isWet;
+            mIsElectricalConnectivityDirty = true;
+        }
+    }
 
-    UpdateElectricalConnectivity(mCurrentElectricalVisitSequenceNumber); // Invoked regardless of dirty elements, as generators might become wet
+    //
+    // Re-visit the electrical graph only if it might have changed; lamps keep
+    // comparing themselves against the sequence number of the last visit
+    //
+
+    if (mIsElectricalConnectivityDirty)
+    {
+        // Generate a new visit sequence number
+        ++mCurrentElectricalVisitSequenceNumber;
+
+        UpdateElectricalConnectivity(mCurrentElectricalVisitSequenceNumber);
+
+        mIsElectricalConnectivityDirty = false;
+    }
 
     mElectricalElements.Update(
         currentWallclockTime,
@@ -1236,7 +4067,11 @@ void Ship::UpdateElectricalDynamics(
         mPoints,
         gameParameters);
 
-    DiffuseLight(gameParameters);
+    {
+        SHIP_PERF_SCOPE(mPerfStats, Light);
+
+        DiffuseLight(gameParameters);
+    }
 }
 
 void Ship::UpdateElectricalConnectivity(SequenceNumber currentVisitSequenceNumber)
@@ -1262,7 +4097,7 @@ void Ship::UpdateElectricalConnectivity(SequenceNumber currentVisitSequenceNumbe
                     currentVisitSequenceNumber);
 
                 // Check if dry enough
-                if (!mPoints.IsWet(mElectricalElements.GetPointIndex(generatorIndex), 0.3f))
+                if (!mPoints.IsWet(mElectricalElements.GetPointIndex(generatorIndex), MaxDryGeneratorWater))
                 {
                     // Add generator to queue
                     assert(electricalElementsToVisit.empty());
@@ -1303,31 +4138,91 @@ void Ship::DiffuseLight(GameParameters const & gameParameters)
 {
     //
     // Diffuse light from each lamp to all points on the same or lower plane ID,
-    // inverse-proportionally to the nth power of the distance, where n is the spread
+    // inverse-proportionally to the nth power of the distance, where n is the spread;
+    // each lamp only visits the points within the radius at which its light is still visible
     //
 
-    // Zero-out light at all points first
+    if (gameParameters.DoRenderLampLightOnGPU)
+    {
+        // The shaders light the ship from the lamps themselves
+        ZeroLight();
+
+        mIsLightDirty = true;
+
+        return;
+    }
+
+    if (CanReuseLight(gameParameters))
+    {
+        return;
+    }
+
+    // With many lamps it pays to bucket the points, so that lamps may skip the
+    // points out of their radius without visiting them
+    bool const useLightGrid = mElectricalElements.Lamps().size() >= MinLampsForLightGrid;
+    if (useLightGrid)
+    {
+        UpdateLightGrid();
+    }
+
+    if (gameParameters.KernelVerification == KernelVerificationMode::LightDiffusion)
+    {
+        //
+        // Diffuse light once by visiting all points, as the reference, and once more
+        // as we would otherwise, keeping the latter
+        //
+
+        DiffuseLightFromLamps(false, gameParameters);
+
+        float const * const lightBuffer = mPoints.GetLightBufferAsFloat();
+        mKernelVerificationBuffer.assign(
+            lightBuffer,
+            lightBuffer + mPoints.GetBufferElementCount());
+
+        DiffuseLightFromLamps(useLightGrid, gameParameters);
+
+        for (auto pointIndex : mPoints)
+        {
+            mKernelVerificationMaxDivergence = std::max(
+                mKernelVerificationMaxDivergence,
+                std::abs(lightBuffer[pointIndex] - mKernelVerificationBuffer[pointIndex]));
+        }
+    }
+    else
+    {
+        DiffuseLightFromLamps(useLightGrid, gameParameters);
+    }
+
+    //
+    // Remember what this light was diffused from
+    //
+
+    mLightPointPositions.resize(mPoints.GetElementCount());
     for (auto pointIndex : mPoints)
     {
-        // Zero its light
-        mPoints.GetLight(pointIndex) = 0.0f;
+        mLightPointPositions[pointIndex] = mPoints.GetPosition(pointIndex);
     }
 
+    mLightLuminiscenceAdjustment = gameParameters.LuminiscenceAdjustment;
+    mLightSpreadAdjustment = gameParameters.LightSpreadAdjustment;
+    mIsLightDirty = false;
+    mElectricalElements.ClearLampLightDirty();
+}
+
+void Ship::DiffuseLightFromLamps(
+    bool useLightGrid,
+    GameParameters const & gameParameters)
+{
+    // Zero-out light at all points first
+    ZeroLight();
+
     // Go through all lamps;
     // can safely visit deleted lamps as their current will always be zero
     for (auto lampIndex : mElectricalElements.Lamps())
     {
         auto const lampPointIndex = mElectricalElements.GetPointIndex(lampIndex);
 
-        float const effectiveLampLight =
-            gameParameters.LuminiscenceAdjustment >= 1.0f
-            ?   FastPow(
-                    mElectricalElements.GetAvailableCurrent(lampIndex)
-                    * mElectricalElements.GetLuminiscence(lampIndex),
-                    1.0f / gameParameters.LuminiscenceAdjustment)
-            :   mElectricalElements.GetAvailableCurrent(lampIndex)
-                * mElectricalElements.GetLuminiscence(lampIndex)
-                * gameParameters.LuminiscenceAdjustment;
+        float const effectiveLampLight = CalculateEffectiveLampLight(lampIndex, gameParameters);
 
         float const lampLightSpread = mElectricalElements.GetLightSpread(lampIndex);
         if (lampLightSpread == 0.0f)
@@ -1341,33 +4236,250 @@ void Ship::DiffuseLight(GameParameters const & gameParameters)
             // Spread light to all the points in the same or lower plane ID
             //
 
-            float const effectiveExponent =
-                (1.0f / lampLightSpread)
-                * gameParameters.LightSpreadAdjustment
-                / 2.0f; // We piggyback on the power to avoid taking a sqrt for distance
+            float const effectiveExponent = CalculateEffectiveLampLightExponent(lampLightSpread, gameParameters);
+
+            // The square distance at which the light falls to MinVisibleLampLight,
+            // i.e. the solution of L / (1 + d2^e) = MinVisibleLampLight; infinite
+            // when the light doesn't fall with distance at all
+            float const squareRadius = effectiveLampLight > MinVisibleLampLight
+                ? std::pow(effectiveLampLight / MinVisibleLampLight - 1.0f, 1.0f / effectiveExponent)
+                : 0.0f;
 
             vec2f const & lampPosition = mPoints.GetPosition(lampPointIndex);
             PlaneId const lampPlaneId = mPoints.GetPlaneId(lampPointIndex);
 
-            for (auto pointIndex : mPoints)
-            {
-                if (mPoints.GetPlaneId(pointIndex) <= lampPlaneId)
+            auto const diffuseLightToPoint =
+                [&](ElementIndex pointIndex)
                 {
-                    float const squareDistance = (mPoints.GetPosition(pointIndex) - lampPosition).squareLength();
+                    if (mPoints.GetPlaneId(pointIndex) <= lampPlaneId)
+                    {
+                        float const squareDistance = (mPoints.GetPosition(pointIndex) - lampPosition).squareLength();
+                        if (squareDistance <= squareRadius)
+                        {
+                            float const newLight =
+                                effectiveLampLight
+                                / (1.0f + FastPow(squareDistance, effectiveExponent));
+
+                            mPoints.GetLight(pointIndex) = std::max(
+                                mPoints.GetLight(pointIndex),
+                                newLight);
+                        }
+                    }
+                };
+
+            if (useLightGrid)
+            {
+                //
+                // Visit the cells that overlap the lamp's radius
+                //
 
-                    float const newLight =
-                        effectiveLampLight
-                        / (1.0f + FastPow(squareDistance, effectiveExponent));
+                float const radius = std::sqrt(squareRadius);
 
-                    mPoints.GetLight(pointIndex) = std::max(
-                        mPoints.GetLight(pointIndex),
-                        newLight);
+                // Clamped as floats, as the radius might be infinite
+                size_t const cellXStart = static_cast<size_t>(std::max((lampPosition.x - radius - mLightGridOrigin.x) / mLightGridCellSize, 0.0f));
+                size_t const cellXEnd = static_cast<size_t>(std::min((lampPosition.x + radius - mLightGridOrigin.x) / mLightGridCellSize, static_cast<float>(mLightGridWidth - 1)));
+                size_t const cellYStart = static_cast<size_t>(std::max((lampPosition.y - radius - mLightGridOrigin.y) / mLightGridCellSize, 0.0f));
+                size_t const cellYEnd = static_cast<size_t>(std::min((lampPosition.y + radius - mLightGridOrigin.y) / mLightGridCellSize, static_cast<float>(mLightGridHeight - 1)));
+
+                for (size_t cellY = cellYStart; cellY <= cellYEnd; ++cellY)
+                {
+                    for (size_t cellX = cellXStart; cellX <= cellXEnd; ++cellX)
+                    {
+                        size_t const cellIndex = cellY * mLightGridWidth + cellX;
+
+                        for (ElementIndex i = mLightGridCellOffsets[cellIndex]; i < mLightGridCellOffsets[cellIndex + 1]; ++i)
+                        {
+                            diffuseLightToPoint(mLightGridPointIndices[i]);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                for (auto pointIndex : mPoints)
+                {
+                    diffuseLightToPoint(pointIndex);
                 }
             }
         }
     }
 }
 
+void Ship::UploadLamps(
+    GameParameters const & gameParameters,
+    Render::RenderContext & renderContext)
+{
+    if (!gameParameters.DoRenderLampLightOnGPU)
+    {
+        // Lamps have been diffused already on the CPU
+        renderContext.UploadShipLampsStart(mId, 0);
+        renderContext.UploadShipLampsEnd(mId);
+        return;
+    }
+
+    renderContext.UploadShipLampsStart(mId, mElectricalElements.Lamps().size());
+
+    for (auto lampIndex : mElectricalElements.Lamps())
+    {
+        if (mElectricalElements.IsDeleted(lampIndex))
+            continue;
+
+        float const effectiveLampLight = CalculateEffectiveLampLight(lampIndex, gameParameters);
+        if (effectiveLampLight <= 0.0f)
+            continue;
+
+        auto const lampPointIndex = mElectricalElements.GetPointIndex(lampIndex);
+
+        float const lampLightSpread = mElectricalElements.GetLightSpread(lampIndex);
+
+        renderContext.UploadShipLamp(
+            mId,
+            mPoints.GetPosition(lampPointIndex),
+            effectiveLampLight,
+            lampLightSpread == 0.0f
+                ? PointLampLightExponent
+                : CalculateEffectiveLampLightExponent(lampLightSpread, gameParameters),
+            static_cast<float>(mPoints.GetPlaneId(lampPointIndex)));
+    }
+
+    renderContext.UploadShipLampsEnd(mId);
+}
+
+float Ship::CalculateEffectiveLampLight(
+    ElementIndex lampIndex,
+    GameParameters const & gameParameters) const
+{
+    return gameParameters.LuminiscenceAdjustment >= 1.0f
+        ?   FastPow(
+                mElectricalElements.GetAvailableCurrent(lampIndex)
+                * mElectricalElements.GetLuminiscence(lampIndex),
+                1.0f / gameParameters.LuminiscenceAdjustment)
+        :   mElectricalElements.GetAvailableCurrent(lampIndex)
+            * mElectricalElements.GetLuminiscence(lampIndex)
+            * gameParameters.LuminiscenceAdjustment;
+}
+
+float Ship::CalculateEffectiveLampLightExponent(
+    float lampLightSpread,
+    GameParameters const & gameParameters)
+{
+    assert(lampLightSpread != 0.0f);
+
+    return (1.0f / lampLightSpread)
+        * gameParameters.LightSpreadAdjustment
+        / 2.0f; // We piggyback on the power to avoid taking a sqrt for distance
+}
+
+bool Ship::CanReuseLight(GameParameters const & gameParameters) const
+{
+    if (mIsLightDirty
+        || mElectricalElements.IsLampLightDirty()
+        || gameParameters.LuminiscenceAdjustment != mLightLuminiscenceAdjustment
+        || gameParameters.LightSpreadAdjustment != mLightSpreadAdjustment
+        || mLightPointPositions.size() != mPoints.GetElementCount())
+    {
+        return false;
+    }
+
+    float constexpr MaxSquareDisplacement = MaxLightCachePointDisplacement * MaxLightCachePointDisplacement;
+
+    for (auto pointIndex : mPoints)
+    {
+        if ((mPoints.GetPosition(pointIndex) - mLightPointPositions[pointIndex]).squareLength() > MaxSquareDisplacement)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Ship::ZeroLight()
+{
+    float * restrict const lightBuffer = mPoints.GetLightBufferAsFloat();
+
+    mPoints.ForEachBlock<VectorizationWordSize>(
+        [lightBuffer](ElementIndex blockStart)
+        {
+            for (ElementIndex p = blockStart; p < blockStart + VectorizationWordSize; ++p)
+            {
+                lightBuffer[p] = 0.0f;
+            }
+        });
+}
+
+void Ship::UpdateLightGrid()
+{
+    //
+    // Size the grid on the points' bounding box
+    //
+
+    vec2f minPosition(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    vec2f maxPosition(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    for (auto pointIndex : mPoints)
+    {
+        vec2f const & position = mPoints.GetPosition(pointIndex);
+        minPosition.x = std::min(minPosition.x, position.x);
+        minPosition.y = std::min(minPosition.y, position.y);
+        maxPosition.x = std::max(maxPosition.x, position.x);
+        maxPosition.y = std::max(maxPosition.y, position.y);
+    }
+
+    vec2f const extent = maxPosition - minPosition;
+
+    // About as many cells as points at most, also when the points are spread along a line
+    float const pointCount = static_cast<float>(mPoints.GetElementCount());
+    mLightGridOrigin = minPosition;
+    mLightGridCellSize = std::max({
+        MinLightGridCellSize,
+        std::sqrt(extent.x * extent.y / pointCount),
+        std::max(extent.x, extent.y) / pointCount });
+    mLightGridWidth = static_cast<size_t>(extent.x / mLightGridCellSize) + 1;
+    mLightGridHeight = static_cast<size_t>(extent.y / mLightGridCellSize) + 1;
+
+    //
+    // Bucket the points - a counting sort, which keeps them in index order within each cell
+    //
+
+    auto const getCellIndex =
+        [this](ElementIndex pointIndex) -> size_t
+        {
+            vec2f const gridPosition = (mPoints.GetPosition(pointIndex) - mLightGridOrigin) / mLightGridCellSize;
+
+            size_t const cellX = std::min(static_cast<size_t>(gridPosition.x), mLightGridWidth - 1);
+            size_t const cellY = std::min(static_cast<size_t>(gridPosition.y), mLightGridHeight - 1);
+
+            return cellY * mLightGridWidth + cellX;
+        };
+
+    mLightGridCellOffsets.assign(mLightGridWidth * mLightGridHeight + 1, 0);
+
+    for (auto pointIndex : mPoints)
+    {
+        ++mLightGridCellOffsets[getCellIndex(pointIndex) + 1];
+    }
+
+    for (size_t c = 1; c < mLightGridCellOffsets.size(); ++c)
+    {
+        mLightGridCellOffsets[c] += mLightGridCellOffsets[c - 1];
+    }
+
+    mLightGridPointIndices.resize(mPoints.GetElementCount());
+
+    // Use the cells' start offsets as insertion cursors, and then shift them back
+    for (auto pointIndex : mPoints)
+    {
+        mLightGridPointIndices[mLightGridCellOffsets[getCellIndex(pointIndex)]++] = pointIndex;
+    }
+
+    for (size_t c = mLightGridCellOffsets.size() - 1; c > 0; --c)
+    {
+        mLightGridCellOffsets[c] = mLightGridCellOffsets[c - 1];
+    }
+
+    mLightGridCellOffsets[0] = 0;
+}
+
 void Ship::UpdateEphemeralParticles(
     float currentSimulationTime,
     GameParameters const & gameParameters)
@@ -1391,45 +4503,160 @@ void Ship::RotPoints(
         ? 1.0f - powf(1e-10f, gameParameters.RotAcceler8r / 30000.0f)   // Accel=1 => this many steps to total decay
         : 0.0f;
 
-    // Higher rot increment for leaking points - they are directly in contact
-    // with water after all!
-    float const leakingAlphaIncrement = alphaIncrement * 3.0f;
+    // Higher rot increment for leaking points - they are directly in contact
+    // with water after all!
+    float const leakingAlphaIncrement = alphaIncrement * 3.0f;
+
+    // Process this step's slice of all points - including ephemerals
+    auto const [startPointIndex, endPointIndex] = GetLowFrequencySlice(mPoints.GetElementCount());
+
+    float * restrict const decayBuffer = mPoints.GetDecayBufferAsFloat();
+    float const * restrict const waterBuffer = mPoints.GetWaterBufferAsFloat();
+    float const * restrict const rustReceptivityBuffer = mPoints.GetRustReceptivityBufferAsFloat();
+
+    for (ElementIndex p = startPointIndex; p < endPointIndex; ++p)
+    {
+        // Points that don't rust don't need to know whether they're underwater
+        if (rustReceptivityBuffer[p] == 0.0f)
+            continue;
+
+        float const waterEquivalent =
+            std::min(waterBuffer[p], 1.0f)
+            + (mParentWorld.IsUnderwater(mPoints.GetPosition(p)) ? 0.2f : 0.0f); // Also rust a bit underwater points, even hull ones
+
+        float const beta =
+            waterEquivalent
+            * (mPoints.IsLeaking(p) ? leakingAlphaIncrement : alphaIncrement)
+            * rustReceptivityBuffer[p];
+
+        decayBuffer[p] *= (1.0f - beta);
+    }
+
+    // Remember that this slice of the decay buffer is dirty
+    mPoints.MarkDecayBufferAsDirty(startPointIndex, endPointIndex);
+}
+
+void Ship::DecaySprings(
+    float /*currentSimulationTime*/,
+    GameParameters const & /*gameParameters*/)
+{
+    // Update strength of the materials of this step's slice of all springs
+    auto const [startSpringIndex, endSpringIndex] = GetLowFrequencySlice(mSprings.GetElementCount());
+
+    for (ElementIndex s = startSpringIndex; s < endSpringIndex; ++s)
+    {
+        // Take average decay of two endpoints
+        float const springDecay =
+            (mPoints.GetDecay(mSprings.GetEndpointAIndex(s)) + mPoints.GetDecay(mSprings.GetEndpointBIndex(s)))
+            / 2.0f;
+
+        // Adjust spring's strength
+        mSprings.SetStrength(
+            s,
+            mSprings.GetMaterialStrength(s) * springDecay);
+    }
+}
+
+std::pair<ElementIndex, ElementIndex> Ship::GetLowFrequencySlice(ElementCount elementCount) const
+{
+    std::uint32_t const step = mCurrentSimulationSequenceNumber.GetStepOf(LowFrequencyPeriod);
+
+    return std::make_pair(
+        static_cast<ElementIndex>(static_cast<std::uint64_t>(elementCount) * step / LowFrequencyPeriod),
+        static_cast<ElementIndex>(static_cast<std::uint64_t>(elementCount) * (step + 1) / LowFrequencyPeriod));
+}
+
+void Ship::UpdateIslandSleeping(GameParameters const & gameParameters)
+{
+    //
+    // An island - i.e. a connected component - falls asleep after it has been quiescent
+    // for a number of consecutive steps; an island is quiescent when it's entirely underwater,
+    // it rests on the sea floor, and neither its points nor its water are moving much.
+    //
+    // Sleeping islands are skipped by the mechanical and water dynamics, until something
+    // happens that might wake them up (structural changes, force fields, interactions, explosions).
+    //
+
+    if (!gameParameters.DoSleepQuiescentIslands
+        || mIsStructureDirty) // Connected component IDs are stale
+    {
+        return;
+    }
+
+    for (auto & islandSleepState : mIslandSleepStates)
+    {
+        islandSleepState.IsQuiescentInStep = true;
+        islandSleepState.IsOnSeaFloorInStep = false;
+    }
+
+    float constexpr MaxSleepingIslandPointSquareSpeed = MaxSleepingIslandPointSpeed * MaxSleepingIslandPointSpeed;
+    float constexpr MaxSleepingIslandWaterSquareSpeed = MaxSleepingIslandWaterSpeed * MaxSleepingIslandWaterSpeed;
 
-    // Process all points - including ephemerals
-    for (auto p : mPoints)
+    vec2f const * restrict waterVelocityBuffer = mPoints.GetWaterVelocityBufferAsVec2();
+
+    for (auto pointIndex : mAwakePoints)
     {
-        float const waterEquivalent =
-            std::min(mPoints.GetWater(p), 1.0f)
-            + (mParentWorld.IsUnderwater(mPoints.GetPosition(p)) ? 0.2f : 0.0f); // Also rust a bit underwater points, even hull ones
+        // Ephemeral points come last, and don't belong to islands
+        if (mPoints.IsEphemeral(pointIndex))
+            break;
 
-        float const beta =
-            waterEquivalent
-            * (mPoints.IsLeaking(p) ? leakingAlphaIncrement : alphaIncrement)
-            * mPoints.GetRustReceptivity(p);
+        assert(mPoints.GetConnectedComponentId(pointIndex) < mIslandSleepStates.size());
+        auto & islandSleepState = mIslandSleepStates[mPoints.GetConnectedComponentId(pointIndex)];
 
-        mPoints.SetDecay(p, mPoints.GetDecay(p) * (1.0f - beta));
+        if (!islandSleepState.IsQuiescentInStep)
+            continue;
+
+        vec2f const & position = mPoints.GetPosition(pointIndex);
+
+        if (mPoints.GetVelocity(pointIndex).squareLength() > MaxSleepingIslandPointSquareSpeed
+            || waterVelocityBuffer[pointIndex].squareLength() > MaxSleepingIslandWaterSquareSpeed
+            || !mParentWorld.IsUnderwater(position))
+        {
+            islandSleepState.IsQuiescentInStep = false;
+        }
+        else if (position.y < mParentWorld.GetOceanFloorHeightAt(position.x) + MaxSleepingIslandDistanceFromSeaFloor)
+        {
+            islandSleepState.IsOnSeaFloorInStep = true;
+        }
     }
 
-    // Remember that the decay buffer is dirty
-    mPoints.MarkDecayBufferAsDirty();
-}
+    bool haveIslandsFallenAsleep = false;
 
-void Ship::DecaySprings(
-    float /*currentSimulationTime*/,
-    GameParameters const & /*gameParameters*/)
-{
-    // Update strength of all materials
-    for (auto s : mSprings)
+    for (size_t c = 0; c < mIslandSleepStates.size(); ++c)
     {
-        // Take average decay of two endpoints
-        float const springDecay =
-            (mPoints.GetDecay(mSprings.GetEndpointAIndex(s)) + mPoints.GetDecay(mSprings.GetEndpointBIndex(s)))
-            / 2.0f;
+        auto & islandSleepState = mIslandSleepStates[c];
 
-        // Adjust spring's strength
-        mSprings.SetStrength(
-            s,
-            mSprings.GetMaterialStrength(s) * springDecay);
+        if (!islandSleepState.IsSleeping)
+        {
+            if (islandSleepState.IsQuiescentInStep && islandSleepState.IsOnSeaFloorInStep)
+            {
+                ++islandSleepState.QuiescentStepCount;
+
+                if (islandSleepState.QuiescentStepCount >= QuiescentStepsBeforeSleeping)
+                {
+                    islandSleepState.IsSleeping = true;
+                    haveIslandsFallenAsleep = true;
+
+                    // Stop the island's points, so that integrating them - with
+                    // zero forces - leaves them where they are
+                    for (ElementIndex p = mIslandPointOffsets[c]; p < mIslandPointOffsets[c + 1]; ++p)
+                    {
+                        mPoints.SetVelocity(mIslandPointIndices[p], vec2f::zero());
+                    }
+                }
+            }
+            else
+            {
+                islandSleepState.QuiescentStepCount = 0;
+            }
+        }
+    }
+
+    if (haveIslandsFallenAsleep)
+    {
+        mHasSleepingIslands = true;
+
+        UpdateAwakeElements();
     }
 }
 
@@ -1439,7 +4666,38 @@ void Ship::DecaySprings(
 
 //#define RENDER_FLOOD_DISTANCE
 
+void Ship::ForceFullConnectivityVisit()
+{
+    mIsFullConnectivityVisitNeeded = true;
+
+    RunConnectivityVisit();
+}
+
 void Ship::RunConnectivityVisit()
+{
+    if (mIsFullConnectivityVisitNeeded)
+    {
+        RunFullConnectivityVisit();
+    }
+    else
+    {
+        RunIncrementalConnectivityVisit();
+    }
+
+    mConnectivityBrokenSpringEndpoints.clear();
+    mIsFullConnectivityVisitNeeded = false;
+
+    // Connected components have changed, hence start over with all islands awake
+    UpdateIslands();
+    mIslandSleepStates.assign(mConnectedComponents.size(), IslandSleepState());
+    mHasSleepingIslands = false;
+    UpdateAwakeElements();
+
+    // Plane IDs might have changed, and lamps only light points on their plane or lower
+    mIsLightDirty = true;
+}
+
+void Ship::RunFullConnectivityVisit()
 {
     //
     //
@@ -1456,8 +4714,8 @@ void Ship::RunConnectivityVisit()
     //
     // At the end of a visit *ALL* (non-ephemeral) points will have a Plane ID.
     //
-    // We also piggyback the visit to create the array containing the counts of triangles in each plane,
-    // so that we can later upload triangles in {PlaneID, Tessellation Order} order.
+    // Plane IDs only end up in the depth of the points, hence the visit has no bearing on the
+    // order in which triangles are uploaded.
     //
 
     // Generate a new visit sequence number
@@ -1475,10 +4733,11 @@ void Ship::RunConnectivityVisit()
     // have to propagate out
     std::queue<ElementIndex> pointsToPropagateFrom;
 
-    // Reset per-plane triangle indices
-    size_t totalPlaneTrianglesCount = 0;
-    mPlaneTriangleIndicesToRender.clear();
-    mPlaneTriangleIndicesToRender.push_back(totalPlaneTrianglesCount); // First plane starts at zero, and we have zero triangles
+    // Reset connected components
+    mConnectedComponents.clear();
+
+    // Walk the springs in the points' compressed adjacency
+    auto const & adjacency = mPoints.GetAdjacency();
 
     // Visit all non-ephemeral points
     for (auto pointIndex : mPoints.NonEphemeralPointsReverse())
@@ -1523,30 +4782,30 @@ void Ship::RunConnectivityVisit()
 #endif
 
                 // Visit all its non-visited connected points
-                for (auto const & cs : mPoints.GetConnectedSprings(currentPointIndex).ConnectedSprings)
+                for (ElementIndex a = adjacency.Offsets[currentPointIndex]; a < adjacency.Offsets[currentPointIndex + 1]; ++a)
                 {
-                    if (visitSequenceNumber != mPoints.GetCurrentConnectivityVisitSequenceNumber(cs.OtherEndpointIndex))
+                    ElementIndex const otherEndpointIndex = adjacency.OtherEndpointIndices[a];
+
+                    if (visitSequenceNumber != mPoints.GetCurrentConnectivityVisitSequenceNumber(otherEndpointIndex))
                     {
                         //
                         // Visit point
                         //
 
-                        mPoints.SetPlaneId(cs.OtherEndpointIndex, currentPlaneId, currentPlaneIdFloat);
-                        mPoints.SetConnectedComponentId(cs.OtherEndpointIndex, static_cast<ConnectedComponentId>(currentPlaneId));
-                        mPoints.SetCurrentConnectivityVisitSequenceNumber(cs.OtherEndpointIndex, visitSequenceNumber);
+                        mPoints.SetPlaneId(otherEndpointIndex, currentPlaneId, currentPlaneIdFloat);
+                        mPoints.SetConnectedComponentId(otherEndpointIndex, static_cast<ConnectedComponentId>(currentPlaneId));
+                        mPoints.SetCurrentConnectivityVisitSequenceNumber(otherEndpointIndex, visitSequenceNumber);
 
                         // Add point to queue
-                        pointsToPropagateFrom.push(cs.OtherEndpointIndex);
+                        pointsToPropagateFrom.push(otherEndpointIndex);
                     }
                 }
-
-                // Update count of triangles with this points's triangles
-                totalPlaneTrianglesCount += mPoints.GetConnectedOwnedTrianglesCount(currentPointIndex);
             }
 
-            // Remember the starting index of the triangles in the next plane
-            assert(mPlaneTriangleIndicesToRender.size() == static_cast<size_t>(currentPlaneId + 1));
-            mPlaneTriangleIndicesToRender.push_back(totalPlaneTrianglesCount);
+            // Remember the component; we're visiting points in reverse order, hence
+            // this flood's seed point is the component's highest point index
+            assert(mConnectedComponents.size() == static_cast<size_t>(currentPlaneId));
+            mConnectedComponents.emplace_back(pointIndex);
 
             //
             // Flood completed
@@ -1570,6 +4829,301 @@ void Ship::RunConnectivityVisit()
     mPoints.MarkPlaneIdBufferNonEphemeralAsDirty();
 }
 
+void Ship::RunIncrementalConnectivityVisit()
+{
+    //
+    // Springs may only have been destroyed since the last visit, hence connected components
+    // may only have been split. We only re-visit the components containing the endpoints of
+    // the destroyed springs, and carve out of them the parts that are no longer connected.
+    //
+    // We then re-order the components as the full visit would have - i.e. in descending order
+    // of their highest point index - so that plane IDs are exactly those that a full
+    // visit would have assigned.
+    //
+
+    bool hasAnyComponentBeenSplit = false;
+
+    for (auto const & brokenSpringEndpoints : mConnectivityBrokenSpringEndpoints)
+    {
+        if (SplitConnectedComponent(brokenSpringEndpoints.first, brokenSpringEndpoints.second))
+        {
+            hasAnyComponentBeenSplit = true;
+        }
+    }
+
+    if (hasAnyComponentBeenSplit)
+    {
+        //
+        // Re-order components
+        //
+
+        std::vector<ConnectedComponentId> sortedComponentIds(mConnectedComponents.size());
+        std::iota(sortedComponentIds.begin(), sortedComponentIds.end(), ConnectedComponentId(0));
+        std::sort(
+            sortedComponentIds.begin(),
+            sortedComponentIds.end(),
+            [this](ConnectedComponentId a, ConnectedComponentId b)
+            {
+                return mConnectedComponents[a].MaxPointIndex > mConnectedComponents[b].MaxPointIndex;
+            });
+
+        std::vector<ConnectedComponentId> newComponentIds(mConnectedComponents.size());
+        bool isOrderUnchanged = true;
+        for (size_t c = 0; c < sortedComponentIds.size(); ++c)
+        {
+            newComponentIds[sortedComponentIds[c]] = static_cast<ConnectedComponentId>(c);
+            isOrderUnchanged &= (sortedComponentIds[c] == c);
+        }
+
+        if (!isOrderUnchanged)
+        {
+            // Re-assign plane and connected component IDs
+            for (auto pointIndex : mPoints.NonEphemeralPoints())
+            {
+                auto const newComponentId = newComponentIds[mPoints.GetConnectedComponentId(pointIndex)];
+
+                mPoints.SetPlaneId(pointIndex, static_cast<PlaneId>(newComponentId), static_cast<float>(newComponentId));
+                mPoints.SetConnectedComponentId(pointIndex, newComponentId);
+            }
+
+            std::vector<ConnectedComponent> sortedConnectedComponents;
+            sortedConnectedComponents.reserve(mConnectedComponents.size());
+            for (auto componentId : sortedComponentIds)
+            {
+                sortedConnectedComponents.push_back(mConnectedComponents[componentId]);
+            }
+
+            mConnectedComponents = std::move(sortedConnectedComponents);
+        }
+
+        // Remember max plane ID ever - the plane IDs that changed are tracked by the points
+        assert(!mConnectedComponents.empty());
+        mMaxMaxPlaneId = std::max(mMaxMaxPlaneId, static_cast<PlaneId>(mConnectedComponents.size() - 1));
+    }
+}
+
+bool Ship::SplitConnectedComponent(
+    ElementIndex pointAIndex,
+    ElementIndex pointBIndex)
+{
+    //
+    // Floods from both endpoints at the same time, one point at a time from each side;
+    // as soon as one flood reaches a point of the other, the endpoints are still connected.
+    // If instead one flood runs out of points first, then that flood's points are no longer
+    // connected to the rest of the component and become a new component.
+    //
+    // Interleaving the floods makes the cost proportional to the size of the smaller
+    // side, which is typically tiny (e.g. a single detached point).
+    //
+
+    auto const componentId = mPoints.GetConnectedComponentId(pointAIndex);
+    if (componentId != mPoints.GetConnectedComponentId(pointBIndex)
+        || pointAIndex == pointBIndex)
+    {
+        // Split already by an earlier spring
+        return false;
+    }
+
+    assert(componentId < mConnectedComponents.size());
+
+    std::array<ElementIndex, 2> const startPointIndices{ pointAIndex, pointBIndex };
+    for (size_t s = 0; s < 2; ++s)
+    {
+        auto & side = mConnectivityVisitSides[s];
+
+        side.VisitSequenceNumber = ++mCurrentConnectivityVisitSequenceNumber;
+        side.Points.clear();
+        side.Points.push_back(startPointIndices[s]);
+        side.Head = 0;
+
+        mPoints.SetCurrentConnectivityVisitSequenceNumber(startPointIndices[s], side.VisitSequenceNumber);
+    }
+
+    while (true)
+    {
+        for (size_t s = 0; s < 2; ++s)
+        {
+            auto & side = mConnectivityVisitSides[s];
+            auto & otherSide = mConnectivityVisitSides[1 - s];
+
+            if (side.Head == side.Points.size())
+            {
+                //
+                // This side is complete and disconnected from the other side: carve it out
+                // into a new component
+                //
+
+                auto const newComponentId = static_cast<ConnectedComponentId>(mConnectedComponents.size());
+                float const newPlaneIdFloat = static_cast<float>(newComponentId);
+
+                ElementIndex newComponentMaxPointIndex = 0;
+
+                for (auto pointIndex : side.Points)
+                {
+                    mPoints.SetPlaneId(pointIndex, static_cast<PlaneId>(newComponentId), newPlaneIdFloat);
+                    mPoints.SetConnectedComponentId(pointIndex, newComponentId);
+
+                    newComponentMaxPointIndex = std::max(newComponentMaxPointIndex, pointIndex);
+                }
+
+                auto & oldComponent = mConnectedComponents[componentId];
+
+                if (newComponentMaxPointIndex == oldComponent.MaxPointIndex)
+                {
+                    // The old component has lost its highest point, hence we need
+                    // to complete the flood of its remaining points to find the new one
+                    ElementIndex oldComponentMaxPointIndex = 0;
+
+                    while (otherSide.Head < otherSide.Points.size())
+                    {
+                        auto const currentPointIndex = otherSide.Points[otherSide.Head++];
+
+                        oldComponentMaxPointIndex = std::max(oldComponentMaxPointIndex, currentPointIndex);
+
+                        for (auto const & cs : mPoints.GetConnectedSprings(currentPointIndex).ConnectedSprings)
+                        {
+                            if (otherSide.VisitSequenceNumber != mPoints.GetCurrentConnectivityVisitSequenceNumber(cs.OtherEndpointIndex))
+                            {
+                                mPoints.SetCurrentConnectivityVisitSequenceNumber(cs.OtherEndpointIndex, otherSide.VisitSequenceNumber);
+                                otherSide.Points.push_back(cs.OtherEndpointIndex);
+                            }
+                        }
+                    }
+
+                    oldComponent.MaxPointIndex = oldComponentMaxPointIndex;
+                }
+
+                mConnectedComponents.emplace_back(newComponentMaxPointIndex);
+
+                return true;
+            }
+
+            auto const currentPointIndex = side.Points[side.Head++];
+
+            for (auto const & cs : mPoints.GetConnectedSprings(currentPointIndex).ConnectedSprings)
+            {
+                auto const otherEndpointVisitSequenceNumber = mPoints.GetCurrentConnectivityVisitSequenceNumber(cs.OtherEndpointIndex);
+
+                if (otherEndpointVisitSequenceNumber == otherSide.VisitSequenceNumber)
+                {
+                    // The floods have met, hence the endpoints are still connected
+                    return false;
+                }
+
+                if (otherEndpointVisitSequenceNumber != side.VisitSequenceNumber)
+                {
+                    mPoints.SetCurrentConnectivityVisitSequenceNumber(cs.OtherEndpointIndex, side.VisitSequenceNumber);
+                    side.Points.push_back(cs.OtherEndpointIndex);
+                }
+            }
+        }
+    }
+}
+
+void Ship::WakeUpAllIslands()
+{
+    for (auto & islandSleepState : mIslandSleepStates)
+    {
+        islandSleepState.QuiescentStepCount = 0;
+        islandSleepState.IsSleeping = false;
+    }
+
+    if (mHasSleepingIslands)
+    {
+        mHasSleepingIslands = false;
+
+        UpdateAwakeElements();
+    }
+}
+
+void Ship::UpdateAwakeElements()
+{
+    mAwakePoints.clear();
+
+    if (!mHasSleepingIslands)
+    {
+        for (auto pointIndex : mPoints.NonEphemeralPoints())
+        {
+            mAwakePoints.push_back(pointIndex);
+        }
+    }
+    else
+    {
+        // Take the points of the awake islands, in index order within each island
+        assert(mIslandSleepStates.size() + 1 == mIslandPointOffsets.size());
+        for (size_t c = 0; c < mIslandSleepStates.size(); ++c)
+        {
+            if (!mIslandSleepStates[c].IsSleeping)
+            {
+                mAwakePoints.insert(
+                    mAwakePoints.end(),
+                    mIslandPointIndices.cbegin() + mIslandPointOffsets[c],
+                    mIslandPointIndices.cbegin() + mIslandPointOffsets[c + 1]);
+            }
+        }
+    }
+
+    mAwakeNonEphemeralPointCount = mAwakePoints.size();
+
+    // Ephemeral points are always awake
+    UpdateAwakeEphemeralPoints();
+
+    // Awake springs are only needed when there are sleeping islands
+    mAwakeSprings.clear();
+
+    if (mHasSleepingIslands)
+    {
+        assert(mIslandSleepStates.size() + 1 == mIslandSpringOffsets.size());
+        for (size_t c = 0; c < mIslandSleepStates.size(); ++c)
+        {
+            if (!mIslandSleepStates[c].IsSleeping)
+            {
+                // Springs deleted since the last connectivity visit are still in the island
+                for (ElementIndex s = mIslandSpringOffsets[c]; s < mIslandSpringOffsets[c + 1]; ++s)
+                {
+                    if (!mSprings.IsDeleted(mIslandSpringIndices[s]))
+                        mAwakeSprings.push_back(mIslandSpringIndices[s]);
+                }
+            }
+        }
+    }
+}
+
+void Ship::UpdateIslands()
+{
+    BucketByConnectedComponent(
+        mPoints.NonEphemeralPoints(),
+        [this](ElementIndex pointIndex)
+        {
+            return mPoints.GetConnectedComponentId(pointIndex);
+        },
+        mConnectedComponents.size(),
+        mIslandPointOffsets,
+        mIslandPointIndices);
+
+    BucketByConnectedComponent(
+        mSprings,
+        [this](ElementIndex springIndex)
+        {
+            return mSprings.IsDeleted(springIndex)
+                ? NoneConnectedComponentId
+                : mPoints.GetConnectedComponentId(mSprings.GetEndpointAIndex(springIndex));
+        },
+        mConnectedComponents.size(),
+        mIslandSpringOffsets,
+        mIslandSpringIndices);
+}
+
+void Ship::UpdateAwakeEphemeralPoints()
+{
+    mAwakePoints.resize(mAwakeNonEphemeralPointCount);
+
+    mAwakePoints.insert(
+        mAwakePoints.end(),
+        mPoints.LiveEphemeralPoints().begin(),
+        mPoints.LiveEphemeralPoints().end());
+}
+
 void Ship::DestroyConnectedTriangles(ElementIndex pointElementIndex)
 {
     //
@@ -1734,6 +5288,9 @@ void Ship::SpringDestroyHandler(
 
     mSprings.ClearSuperTriangles(springElementIndex);
 
+    // The spring leaves the frontier
+    UpdateFrontierSpring(springElementIndex, true);
+
 
     /////////////////////////////////////////////////
 
@@ -1787,12 +5344,27 @@ void Ship::SpringDestroyHandler(
             mElectricalElements.RemoveConnectedElectricalElement(
                 electricalElementBIndex,
                 electricalElementAIndex);
+
+            // The circuit is now broken
+            mIsElectricalConnectivityDirty = true;
         }
     }
 
     // Notify bombs
     mBombs.OnSpringDestroyed(springElementIndex);
 
+    // Remember the endpoints might now be disconnected
+    mConnectivityBrokenSpringEndpoints.emplace_back(pointAIndex, pointBIndex);
+
+    // The GPU water diffusion needs the new adjacency
+    mIsWaterDiffusionGPUAdjacencyDirty = true;
+
+    // The springs need to be sorted again
+    mAreSpatiallySortedSpringsDirty = true;
+
+    // The live springs now include a deleted one, which is harmless until we catch up
+    mAreLiveSpringsDirty = true;
+
     // Remember our structure is now dirty
     mIsStructureDirty = true;
 }
@@ -1808,6 +5380,9 @@ void Ship::SpringRestoreHandler(
     // Restore factory supertriangles
     mSprings.RestoreFactorySuperTriangles(springElementIndex);
 
+    // The spring joins the frontier, until triangles cover it
+    UpdateFrontierSpring(springElementIndex, false);
+
     //
     // Add self to others
     //
@@ -1828,6 +5403,32 @@ void Ship::SpringRestoreHandler(
         mParentWorld.IsUnderwater(mPoints.GetPosition(mSprings.GetEndpointAIndex(springElementIndex))),
         1);
 
+    // Components might have been joined, which only a full visit can tell; a spring
+    // restored within a single component - the common case while repairing - cannot
+    // join anything though, and the ongoing incremental splits walk the live springs
+    if (mPoints.GetConnectedComponentId(mSprings.GetEndpointAIndex(springElementIndex))
+        != mPoints.GetConnectedComponentId(mSprings.GetEndpointBIndex(springElementIndex)))
+    {
+        mIsFullConnectivityVisitNeeded = true;
+    }
+
+    // The GPU water diffusion needs the new adjacency
+    mIsWaterDiffusionGPUAdjacencyDirty = true;
+
+    // The spatial order is missing the restored spring
+    mAreSpatiallySortedSpringsDirty = true;
+    mSpatiallySortedSprings.clear();
+
+    // Likewise the live springs
+    mAreLiveSpringsDirty = true;
+    mLiveSprings.clear();
+
+    // The endpoints might now be neighbors of wet points
+    if (mPoints.IsWet(mSprings.GetEndpointAIndex(springElementIndex), 0.0f))
+        ActivateWaterPoint(mSprings.GetEndpointAIndex(springElementIndex));
+    if (mPoints.IsWet(mSprings.GetEndpointBIndex(springElementIndex), 0.0f))
+        ActivateWaterPoint(mSprings.GetEndpointBIndex(springElementIndex));
+
     // Remember our structure is now dirty
     mIsStructureDirty = true;
 }
@@ -1842,6 +5443,9 @@ void Ship::TriangleDestroyHandler(ElementIndex triangleElementIndex)
     for (ElementIndex subSpringIndex : mTriangles.GetSubSprings(triangleElementIndex))
     {
         mSprings.RemoveSuperTriangle(subSpringIndex, triangleElementIndex);
+
+        // The sub spring might now be exposed
+        UpdateFrontierSpring(subSpringIndex, false);
     }
 
     // Disconnect triangle from its endpoints
@@ -1884,6 +5488,9 @@ void Ship::TriangleRestoreHandler(ElementIndex triangleElementIndex)
     for (ElementIndex subSpringIndex : mTriangles.GetSubSprings(triangleElementIndex))
     {
         mSprings.AddSuperTriangle(subSpringIndex, triangleElementIndex);
+
+        // The sub spring might now be covered
+        UpdateFrontierSpring(subSpringIndex, false);
     }
 
     // Fire event - using point A's properties (quite arbitrarily)
@@ -1898,6 +5505,9 @@ void Ship::TriangleRestoreHandler(ElementIndex triangleElementIndex)
 
 void Ship::ElectricalElementDestroyHandler(ElementIndex /*electricalElementIndex*/)
 {
+    // The circuit is now broken
+    mIsElectricalConnectivityDirty = true;
+
     // Remember our structure is now dirty
     mIsStructureDirty = true;
 }
@@ -1933,27 +5543,37 @@ void Ship::GenerateDebris(
         auto const debrisParticleCount = GameRandomEngine::GetInstance().GenerateRandomInteger(
             GameParameters::MinDebrisParticlesPerEvent, GameParameters::MaxDebrisParticlesPerEvent);
 
+        // Draw all the randoms we need at once: velocity magnitude, velocity angle, lifetime
+        float randoms[GameParameters::MaxDebrisParticlesPerEvent * 3];
+        GameRandomEngine::GetInstance().GenerateRandomNormalizedReals(randoms, debrisParticleCount * 3);
+
+        vec2f velocities[GameParameters::MaxDebrisParticlesPerEvent];
+        float maxLifetimes[GameParameters::MaxDebrisParticlesPerEvent];
+
+        float constexpr MinLifetime = std::chrono::duration<float>(GameParameters::MinDebrisParticlesLifetime).count();
+        float constexpr MaxLifetime = std::chrono::duration<float>(GameParameters::MaxDebrisParticlesLifetime).count();
+
         for (size_t d = 0; d < debrisParticleCount; ++d)
         {
             // Choose velocity
-            vec2f const velocity = GameRandomEngine::GetInstance().GenerateRandomRadialVector(
-                GameParameters::MinDebrisParticlesVelocity,
-                GameParameters::MaxDebrisParticlesVelocity);
+            velocities[d] = vec2f::fromPolar(
+                GameParameters::MinDebrisParticlesVelocity
+                + randoms[d * 3] * (GameParameters::MaxDebrisParticlesVelocity - GameParameters::MinDebrisParticlesVelocity),
+                randoms[d * 3 + 1] * 2.0f * Pi<float>);
 
             // Choose a lifetime
-            std::chrono::milliseconds const maxLifetime = std::chrono::milliseconds(
-                GameRandomEngine::GetInstance().GenerateRandomInteger(
-                    GameParameters::MinDebrisParticlesLifetime.count(),
-                    GameParameters::MaxDebrisParticlesLifetime.count()));
-
-            mPoints.CreateEphemeralParticleDebris(
-                mPoints.GetPosition(pointElementIndex),
-                velocity,
-                mPoints.GetStructuralMaterial(pointElementIndex),
-                currentSimulationTime,
-                maxLifetime,
-                mPoints.GetPlaneId(pointElementIndex));
+            maxLifetimes[d] = MinLifetime + randoms[d * 3 + 2] * (MaxLifetime - MinLifetime);
         }
+
+        // Create them all at once
+        mPoints.CreateEphemeralParticlesDebris(
+            debrisParticleCount,
+            mPoints.GetPosition(pointElementIndex),
+            velocities,
+            maxLifetimes,
+            mPoints.GetStructuralMaterial(pointElementIndex),
+            currentSimulationTime,
+            mPoints.GetPlaneId(pointElementIndex));
     }
 }
 
@@ -1989,32 +5609,48 @@ void Ship::GenerateSparkles(
         // Create particles
         //
 
+        // Draw all the randoms we need at once: velocity magnitude, velocity angle, butterfly side, lifetime, texture frame
+        float randoms[GameParameters::MaxSparkleParticlesPerEvent * 5];
+        GameRandomEngine::GetInstance().GenerateRandomNormalizedReals(randoms, sparkleParticleCount * 5);
+
+        vec2f velocities[GameParameters::MaxSparkleParticlesPerEvent];
+        float maxLifetimes[GameParameters::MaxSparkleParticlesPerEvent];
+        TextureFrameIndex textureFrameIndices[GameParameters::MaxSparkleParticlesPerEvent];
+
+        float constexpr MinLifetime = std::chrono::duration<float>(GameParameters::MinSparkleParticlesLifetime).count();
+        float constexpr MaxLifetime = std::chrono::duration<float>(GameParameters::MaxSparkleParticlesLifetime).count();
+
         for (size_t d = 0; d < sparkleParticleCount; ++d)
         {
             // Velocity magnitude
-            float const velocityMagnitude = GameRandomEngine::GetInstance().GenerateRandomReal(
-                GameParameters::MinSparkleParticlesVelocity, GameParameters::MaxSparkleParticlesVelocity);
+            float const velocityMagnitude =
+                GameParameters::MinSparkleParticlesVelocity
+                + randoms[d * 5] * (GameParameters::MaxSparkleParticlesVelocity - GameParameters::MinSparkleParticlesVelocity);
 
             // Velocity angle: butterfly perpendicular to *direction of sawing*, not spring
             float const velocityAngle =
-                GameRandomEngine::GetInstance().GenerateRandomReal(startAngle, endAngle)
-                + (GameRandomEngine::GetInstance().Choose(2) == 0 ? Pi<float> : 0.0f);
+                startAngle + randoms[d * 5 + 1] * (endAngle - startAngle)
+                + (randoms[d * 5 + 2] < 0.5f ? Pi<float> : 0.0f);
+
+            velocities[d] = vec2f::fromPolar(velocityMagnitude, velocityAngle);
 
             // Choose a lifetime
-            std::chrono::milliseconds const maxLifetime = std::chrono::milliseconds(
-                GameRandomEngine::GetInstance().GenerateRandomInteger(
-                    GameParameters::MinSparkleParticlesLifetime.count(),
-                    GameParameters::MaxSparkleParticlesLifetime.count()));
-
-            // Create sparkle
-            mPoints.CreateEphemeralParticleSparkle(
-                mSprings.GetMidpointPosition(springElementIndex, mPoints),
-                vec2f::fromPolar(velocityMagnitude, velocityAngle),
-                mSprings.GetBaseStructuralMaterial(springElementIndex),
-                currentSimulationTime,
-                maxLifetime,
-                mSprings.GetPlaneId(springElementIndex, mPoints));
+            maxLifetimes[d] = MinLifetime + randoms[d * 5 + 3] * (MaxLifetime - MinLifetime);
+
+            // Choose one of the two frames
+            textureFrameIndices[d] = randoms[d * 5 + 4] < 0.5f ? 0 : 1;
         }
+
+        // Create them all at once
+        mPoints.CreateEphemeralParticlesSparkle(
+            sparkleParticleCount,
+            mSprings.GetMidpointPosition(springElementIndex, mPoints),
+            velocities,
+            maxLifetimes,
+            textureFrameIndices,
+            mSprings.GetBaseStructuralMaterial(springElementIndex),
+            currentSimulationTime,
+            mSprings.GetPlaneId(springElementIndex, mPoints));
     }
 }
 
@@ -2041,6 +5677,19 @@ void Ship::DoBombExplosion(
             blastRadius,
             strength,
             sequenceProgress == 0.0f));
+
+    // Push the water surface down, if the blast reaches it
+    if (gameParameters.DoSimulateInteractiveWaves
+        && sequenceProgress == 0.0f)
+    {
+        float const distanceFromSurface = std::abs(blastPosition.y - mParentWorld.GetWaterHeightAt(blastPosition.x));
+        if (distanceFromSurface < gameParameters.BombBlastRadius)
+        {
+            mPendingOceanSurfaceDisplacements.emplace_back(
+                blastPosition.x,
+                -OceanSurfaceBlastDisplacement * (1.0f - distanceFromSurface / gameParameters.BombBlastRadius));
+        }
+    }
 }
 
 void Ship::DoAntiMatterBombPreimplosion(
@@ -2166,6 +5815,33 @@ void Ship::VerifyInvariants()
         }
     }
 
+
+    //
+    // Frontier
+    //
+
+    std::vector<std::uint8_t> pointFrontierSpringCounts(mPoints.GetBufferElementCount(), 0);
+
+    for (auto s : mSprings)
+    {
+        bool const isFrontierSpring = !mSprings.IsDeleted(s) && mSprings.GetSuperTriangles(s).size() < 2;
+        Verify(mIsFrontierSpring[s] == isFrontierSpring);
+
+        if (isFrontierSpring)
+        {
+            ++pointFrontierSpringCounts[mSprings.GetEndpointAIndex(s)];
+            ++pointFrontierSpringCounts[mSprings.GetEndpointBIndex(s)];
+        }
+    }
+
+    Verify(pointFrontierSpringCounts == mPointFrontierSpringCounts);
+
+    for (ElementIndex f = 0; f < mFrontierPoints.size(); ++f)
+    {
+        Verify(mPointFrontierSpringCounts[mFrontierPoints[f]] > 0);
+        Verify(mFrontierPointPositions[mFrontierPoints[f]] == f);
+    }
+
     for (auto t : mTriangles)
     {
         Verify(mTriangles.GetSubSprings(t).size() <= 4);
@@ -10,13 +10,31 @@
 #include "Physics.h"
 #include "RenderContext.h"
 #include "ShipDefinition.h"
+#include "ShipPerfStats.h"
+#include "ShipProxyLattice.h"
+#include "ShipStatistics.h"
+#include "SimulationView.h"
+#include "SpringConstraints.h"
+#include "SpringForces.h"
 
+#include <GPUCalc/MechanicalDynamicsGPUCalculator.h>
+#include <GPUCalc/WaterDiffusionGPUCalculator.h>
+
+#include <GameCore/AABB.h>
 #include <GameCore/GameTypes.h>
+#include <GameCore/MemoryReport.h>
 #include <GameCore/RunningAverage.h>
+#include <GameCore/TaskThreadPool.h>
 #include <GameCore/Vectors.h>
+#include <GameCore/WorkBufferArena.h>
 
+#include <algorithm>
+#include <array>
+#include <istream>
 #include <memory>
 #include <optional>
+#include <ostream>
+#include <utility>
 #include <vector>
 
 namespace Physics
@@ -35,7 +53,8 @@ public:
         Points && points,
         Springs && springs,
         Triangles && triangles,
-        ElectricalElements && electricalElements);
+        ElectricalElements && electricalElements,
+        ShipProxyLattice && proxyLattice);
 
     ~Ship();
 
@@ -58,13 +77,128 @@ public:
     auto const & GetElectricalElements() const { return mElectricalElements; }
     auto & GetElectricalElements() { return mElectricalElements; }
 
+    ShipStatistics GetStatistics() const;
+
+    ShipPerfStats const & GetPerfStats() const { return mPerfStats; }
+
+    /*
+     * Visits the connectivity of the whole ship right away, as after its creation;
+     * the visit otherwise runs - incrementally, when needed - at render time.
+     */
+    void ForceFullConnectivityVisit();
+
+    /*
+     * Makes the next render upload all the elements, as after a structural change.
+     */
+    void InvalidateRenderElements()
+    {
+        mAreElementsDirtyForRendering = true;
+    }
+
+    /*
+     * Adds the buffers of the ship - and of its elements - to the report, under
+     * a section for the ship.
+     */
+    void ReportMemory(MemoryReport & report) const;
+
+    /*
+     * Whether the ship has maintenance pending - work that only makes the simulation
+     * faster, such as re-sorting springs spatially - which may be run at idle time.
+     *
+     * Maintenance that is not run at idle time is run by the ship itself, once it has
+     * been pending for a while.
+     */
+    bool HasPendingMaintenance(GameParameters const & gameParameters) const
+    {
+        return (mAreSpatiallySortedSpringsDirty && gameParameters.DoSortSpringsSpatially)
+            || mAreLiveSpringsDirty;
+    }
+
+    /*
+     * Runs one piece of the pending maintenance, if any.
+     */
+    void RunMaintenance(GameParameters const & gameParameters);
+
+    /*
+     * Writes the dynamic state of the ship, for world snapshots; the state may only be
+     * loaded back into a ship freshly built from the same definition.
+     */
+    void SaveState(std::ostream & stream) const;
+    void LoadState(
+        std::istream & stream,
+        GameParameters const & gameParameters);
+
+    /*
+     * Applies to the ocean surface the displacements caused by this ship since the last flush;
+     * the ship cannot apply them itself as ships may be updated in parallel.
+     */
+    void FlushOceanSurfaceDisplacements();
+
+    /*
+     * Calculates the bounding box of the ship's points, including its live ephemeral particles.
+     */
+    Geometry::AABB CalculateAABB() const;
+
+    /*
+     * The bounding box of the ship's structural points - i.e. excluding ephemeral particles -
+     * as of the last integration, and kept up-to-date by the tools moving the ship; inverted
+     * when the ship has no points. Cheaper than CalculateAABB(), as it's a byproduct of
+     * the integration.
+     */
+    Geometry::AABB const & GetAABB() const
+    {
+        return mAABB;
+    }
+
+    /*
+     * The bounding boxes of the connected components, indexed by connected component ID;
+     * maintained as GetAABB() is, and inverted for components without points.
+     */
+    std::vector<Geometry::AABB> const & GetConnectedComponentAABBs() const
+    {
+        return mConnectedComponentAABBs;
+    }
+
+    /*
+     * The points at the exposed boundary of the structure, i.e. the endpoints of the springs
+     * that are not covered by triangles on both sides, in no particular order; maintained
+     * incrementally as springs and triangles are destroyed and restored.
+     */
+    std::vector<ElementIndex> const & GetFrontierPoints() const
+    {
+        return mFrontierPoints;
+    }
+
+    /*
+     * The coarse stand-in for the ship's structure, made when the ship was built.
+     */
+    ShipProxyLattice const & GetProxyLattice() const
+    {
+        return mProxyLattice;
+    }
+
+    /*
+     * Resolves the penetrations of the points of one of our connected components into the
+     * triangles of a connected component of another ship - or of another one of our own
+     * components - within the specified region, i.e. the overlap of their bounding boxes.
+     *
+     * Ships may not be updating while this runs, as it moves the points of both ships.
+     */
+    void CollideWith(
+        ConnectedComponentId connectedComponentId,
+        Ship & otherShip,
+        ConnectedComponentId otherConnectedComponentId,
+        Geometry::AABB const & region);
+
     void Update(
         float currentSimulationTime,
         GameParameters const & gameParameters,
-        Render::RenderContext const & renderContext);
+        float averageUpdateDurationMillis,
+        SimulationView const & simulationView);
 
     void Render(
         GameParameters const & gameParameters,
+        float renderInterpolationFactor,
         Render::RenderContext & renderContext);
 
 public:
@@ -157,6 +291,20 @@ public:
         vec2f const & targetPos,
         float radius) const;
 
+private:
+
+    ElementIndex FindNearestPointAt(
+        vec2f const & targetPos,
+        float radius) const;
+
+    bool AreNearestPointCandidatesCurrent(
+        vec2f const & targetPos,
+        float radius) const;
+
+    void GatherNearestPointCandidates(
+        vec2f const & targetPos,
+        float radius) const;
+
 public:
 
     /////////////////////////////////////////////////////////////////////////
@@ -168,37 +316,262 @@ public:
     void UpdateMechanicalDynamics(
         float currentSimulationTime,
         GameParameters const & gameParameters,
-        Render::RenderContext const & renderContext);
+        SimulationView const & simulationView);
+
+    // The wind force multipliers are null when the wind does not vary along the world
+    void UpdatePointForces(
+        float const * restrict waterHeights,
+        float const * restrict windForceMultipliers,
+        GameParameters const & gameParameters);
+
+    struct PointForcesConstants
+    {
+        float DensityAdjustedWaterMass;
+        vec2f WindForce;
+        float WaterDragCoefficient;
+
+        // The force fields to evaluate together with the other point forces
+        PackedForceField const * ForceFields;
+        size_t ForceFieldCount;
+    };
+
+    PointForcesConstants CalculatePointForcesConstants(GameParameters const & gameParameters) const;
+
+    template<bool HasWindForceMultipliers, bool HasForceFields>
+    void UpdatePointForcesKernel(
+        float const * restrict waterHeights,
+        float const * restrict windForceMultipliers,
+        PointForcesConstants const & constants,
+        GameParameters const & gameParameters);
+
+    template<bool HasForceFields>
+    inline void ApplyPointForces(
+        ElementIndex pointIndex,
+        float waterHeightAtThisPoint,
+        float windForceMultiplierAtThisPoint,
+        PointForcesConstants const & constants,
+        GameParameters const & gameParameters);
+
+    void UpdateSpringForces(
+        bool doStoreSpringLengths,
+        GameParameters const & gameParameters);
+
+    void UpdateSpringForcesParallel();
+
+    // Runs the reference spring forces kernel on the snapshot of the point forces taken
+    // before the optimized kernel ran, and compares the results
+    void VerifySpringForces();
 
-    void UpdatePointForces(GameParameters const & gameParameters);
+    SpringForcesBuffers MakeSpringForcesBuffers(bool doStoreSpringLengths);
 
-    void UpdateSpringForces(GameParameters const & gameParameters);
+    // Re-partitions springs into parallel force batches, if they're dirty
+    void UpdateParallelForceBatches();
 
-    void IntegrateAndResetPointForces(GameParameters const & gameParameters);
+    // Alternative to the iterations of spring forces and integration; see DoSolveSpringsAsConstraints
+    void RunSpringConstraintsSubsteps(
+        float currentSimulationTime,
+        std::vector<size_t> const & unpackedForceFieldIndices,
+        bool doHandleCollisionsWithSeaFloor,
+        float const * restrict waterHeights,
+        float const * restrict windForceMultipliers,
+        float const * restrict oceanFloorHeights,
+        SimulationView const & simulationView,
+        GameParameters const & gameParameters);
+
+    void SolveSpringConstraints(GameParameters const & gameParameters);
+
+    void SolveSpringConstraintsParallel();
+
+    // Finds the chains of rope springs, once and for all
+    void BuildRopeChains();
+
+    void UpdateSpatiallySortedSprings();
+
+    void UpdateLiveSprings();
+
+    void InitializeFrontier();
+
+    // Brings the frontier up-to-date with the spring's super-triangles
+    void UpdateFrontierSpring(
+        ElementIndex springElementIndex,
+        bool isSpringDeleted);
+
+    void IntegrateAndResetPointForces(
+        bool doUpdateAABBs,
+        GameParameters const & gameParameters);
+
+    // Tells whether any awake point may reach the sea floor during this step
+    bool IsCloseToSeaFloor() const;
+
+    void HandleCollisionsWithSeaFloor(
+        float const * restrict oceanFloorHeights,
+        float dt);
+
+    inline void HandleCollisionWithSeaFloor(
+        ElementIndex pointIndex,
+        float floorheight,
+        float dt);
+
+    // Fused alternative to IntegrateAndResetPointForces() + HandleCollisionsWithSeaFloor()
+    // + - optionally - UpdatePointForces() for the next iteration, in a single pass
+    void IntegrateAndUpdatePointForces(
+        bool doUpdatePointForces,
+        bool doHandleCollisionsWithSeaFloor,
+        bool doUpdateAABBs,
+        float const * restrict waterHeights,
+        float const * restrict windForceMultipliers,
+        float const * restrict oceanFloorHeights,
+        PointForcesConstants const & pointForcesConstants,
+        GameParameters const & gameParameters);
 
-    void HandleCollisionsWithSeaFloor(GameParameters const & gameParameters);
+    // The specializations of IntegrateAndUpdatePointForces() for each combination of
+    // its flags, so that its loop does not branch on them; indexed by the flags' bits
+    template<
+        bool DoUpdatePointForces,
+        bool DoHandleCollisionsWithSeaFloor,
+        bool DoUpdateAABBs,
+        bool HasWindForceMultipliers,
+        bool HasForceFields>
+    void IntegrateAndUpdatePointForcesKernel(
+        float const * restrict waterHeights,
+        float const * restrict windForceMultipliers,
+        float const * restrict oceanFloorHeights,
+        PointForcesConstants const & pointForcesConstants,
+        GameParameters const & gameParameters);
+
+    using IntegrateAndUpdatePointForcesKernelPtr = void (Ship::*)(
+        float const * restrict,
+        float const * restrict,
+        float const * restrict,
+        PointForcesConstants const &,
+        GameParameters const &);
+
+    template<size_t ... KernelIndices>
+    static constexpr std::array<IntegrateAndUpdatePointForcesKernelPtr, sizeof...(KernelIndices)> MakeIntegrateAndUpdatePointForcesKernels(
+        std::index_sequence<KernelIndices...>);
+
+    // Tells whether this step's iterations may run on the GPU, creating the calculator
+    // the first time
+    bool IsGPUMechanicalDynamicsAvailable(
+        GameParameters const & gameParameters,
+        SimulationView const & simulationView);
+
+    // Alternative to all of the iterations, running them on the GPU for the ship points,
+    // and on the CPU for the ephemeral ones
+    void RunGPUMechanicalDynamics(
+        bool doHandleCollisionsWithSeaFloor,
+        float const * restrict waterHeights,
+        float const * restrict windForceMultipliers,
+        float const * restrict oceanFloorHeights,
+        GameParameters const & gameParameters);
+
+    // Reads back the GPU's point dynamics if the CPU's are stale, so that the CPU
+    // may take over
+    void CatchUpWithGPUMechanicalDynamics();
+
+    // Copies the GPU's point dynamics into the points, and updates what depends on them
+    void TakeGPUMechanicalDynamicsResults();
 
     void TrimForWorldBounds(
         float currentSimulationTime,
         GameParameters const & gameParameters);
 
+    // Buckets the points for the queries of the interactions, if they have moved since
+    // the last time
+    void UpdateInteractionGrid() const;
+
+    // Buckets the springs into the interaction grid's cells, if the points have moved
+    // since the last time
+    void UpdateInteractionGridSprings() const;
+
+    // Invokes the visitor with each point of those in the grid cells covering the region;
+    // it's up to the visitor to check the point's actual position
+    template<typename TVisitor>
+    inline void VisitInteractionGridPointsIn(
+        Geometry::AABB const & region,
+        TVisitor && visitor) const
+    {
+        UpdateInteractionGrid();
+
+        vec2f const gridBottomLeft = (region.BottomLeft - mInteractionGridOrigin) / mInteractionGridCellSize;
+        vec2f const gridTopRight = (region.TopRight - mInteractionGridOrigin) / mInteractionGridCellSize;
+
+        // Regions outside of the grid have no points
+        if (gridTopRight.x < 0.0f || gridTopRight.y < 0.0f
+            || gridBottomLeft.x >= static_cast<float>(mInteractionGridWidth)
+            || gridBottomLeft.y >= static_cast<float>(mInteractionGridHeight))
+        {
+            return;
+        }
+
+        size_t const cellX1 = static_cast<size_t>(std::max(gridBottomLeft.x, 0.0f));
+        size_t const cellX2 = std::min(static_cast<size_t>(gridTopRight.x), mInteractionGridWidth - 1);
+        size_t const cellY1 = static_cast<size_t>(std::max(gridBottomLeft.y, 0.0f));
+        size_t const cellY2 = std::min(static_cast<size_t>(gridTopRight.y), mInteractionGridHeight - 1);
+
+        for (size_t cellY = cellY1; cellY <= cellY2; ++cellY)
+        {
+            for (size_t cellX = cellX1; cellX <= cellX2; ++cellX)
+            {
+                size_t const cellIndex = cellY * mInteractionGridWidth + cellX;
+                for (ElementIndex i = mInteractionGridCellOffsets[cellIndex]; i < mInteractionGridCellOffsets[cellIndex + 1]; ++i)
+                {
+                    visitor(mInteractionGridPointIndices[i]);
+                }
+            }
+        }
+    }
+
+    // Resets the bounding boxes of the components about to be integrated - all of them,
+    // or just the awake ones - for the integration to extend them with each point
+    void BeginAABBsUpdate(bool doUpdateAllComponents);
+
+    inline void ExtendAABBs(ElementIndex pointIndex);
+
+    void EndAABBsUpdate();
+
+    void UpdateCollisionComponentBuckets();
+
+    void GenerateOceanSurfaceImpacts(
+        float const * restrict waterHeights,
+        GameParameters const & gameParameters);
+
     // Water
 
+    void UpdateWaterDynamicsPeriod(
+        GameParameters const & gameParameters,
+        SimulationView const & simulationView);
+
     void UpdateWaterDynamics(
         float currentSimulationTime,
-        GameParameters const & gameParameters);
+        GameParameters const & gameParameters,
+        float stepMultiplier);
 
     void UpdateWaterInflow(
         float currentSimulationTime,
         GameParameters const & gameParameters,
+        float stepMultiplier,
         float & waterTaken);
 
     void UpdateWaterVelocities(
         GameParameters const & gameParameters,
+        float stepMultiplier,
         float & waterSplashed);
 
+    bool IsGPUWaterDiffusionAvailable(GameParameters const & gameParameters);
+
+    void ApplyGPUWaterDiffusionResults(float & waterSplashed);
+
+    void RunGPUWaterDiffusion(
+        GameParameters const & gameParameters,
+        float stepMultiplier);
+
     void UpdateSinking();
 
+    void ActivateWaterPoint(ElementIndex pointElementIndex);
+
+    void UpdateWaterActivePoints(bool doRemoveInactivePoints);
+
     // Electrical
 
     void UpdateElectricalDynamics(
@@ -209,6 +582,30 @@ public:
 
     void DiffuseLight(GameParameters const & gameParameters);
 
+    void DiffuseLightFromLamps(
+        bool useLightGrid,
+        GameParameters const & gameParameters);
+
+    void PublishKernelVerification(GameParameters const & gameParameters);
+
+    void ZeroLight();
+
+    void UpdateLightGrid();
+
+    bool CanReuseLight(GameParameters const & gameParameters) const;
+
+    void UploadLamps(
+        GameParameters const & gameParameters,
+        Render::RenderContext & renderContext);
+
+    float CalculateEffectiveLampLight(
+        ElementIndex lampIndex,
+        GameParameters const & gameParameters) const;
+
+    static float CalculateEffectiveLampLightExponent(
+        float lampLightSpread,
+        GameParameters const & gameParameters);
+
     // Ephemeral particles
 
     void UpdateEphemeralParticles(
@@ -225,16 +622,96 @@ public:
         float currentSimulationTime,
         GameParameters const & gameParameters);
 
+    // The [start, end) range of elements for the current step to visit, out of all the
+    // elements that a low-frequency pass spreads over its period
+    std::pair<ElementIndex, ElementIndex> GetLowFrequencySlice(ElementCount elementCount) const;
+
+    void UpdateIslandSleeping(GameParameters const & gameParameters);
+
 private:
 
+    void InternalUpdate(
+        float currentSimulationTime,
+        GameParameters const & gameParameters,
+        SimulationView const & simulationView);
+
+    float CalculateAdaptiveNumMechanicalDynamicsIterationsAdjustment(
+        GameParameters const & gameParameters,
+        float averageUpdateDurationMillis);
+
     void RunConnectivityVisit();
 
+    void RunFullConnectivityVisit();
+
+    void RunIncrementalConnectivityVisit();
+
+    bool SplitConnectedComponent(
+        ElementIndex pointAIndex,
+        ElementIndex pointBIndex);
+
+    void WakeUpAllIslands();
+
+    void UpdateAwakeElements();
+
+    void UpdateAwakeEphemeralPoints();
+
+    void UpdateIslands();
+
+    // Buckets the elements by connected component - a counting sort, as for the light grid:
+    // the elements of component c end up at [offsets[c], offsets[c+1]) in indices, and
+    // elements with no (valid) component are left out
+    template<typename TElements, typename TGetComponentId>
+    static void BucketByConnectedComponent(
+        TElements const & elements,
+        TGetComponentId && getComponentId,
+        size_t componentCount,
+        std::vector<ElementIndex> & offsets,
+        std::vector<ElementIndex> & indices)
+    {
+        offsets.assign(componentCount + 1, 0);
+
+        for (auto elementIndex : elements)
+        {
+            ConnectedComponentId const componentId = getComponentId(elementIndex);
+            if (componentId < componentCount)
+                ++offsets[componentId + 1];
+        }
+
+        for (size_t c = 1; c < offsets.size(); ++c)
+        {
+            offsets[c] += offsets[c - 1];
+        }
+
+        indices.resize(offsets[componentCount]);
+
+        // Use the buckets' start offsets as insertion cursors, and then shift them back
+        for (auto elementIndex : elements)
+        {
+            ConnectedComponentId const componentId = getComponentId(elementIndex);
+            if (componentId < componentCount)
+                indices[offsets[componentId]++] = elementIndex;
+        }
+
+        for (size_t c = offsets.size() - 1; c > 0; --c)
+        {
+            offsets[c] = offsets[c - 1];
+        }
+
+        offsets[0] = 0;
+    }
+
     void DestroyConnectedTriangles(ElementIndex pointElementIndex);
 
     void DestroyConnectedTriangles(
         ElementIndex pointAElementIndex,
         ElementIndex pointBElementIndex);
 
+    // The element containers invoke the handlers below directly
+    friend class Points;
+    friend class Springs;
+    friend class Triangles;
+    friend class ElectricalElements;
+
     void PointDetachHandler(
         ElementIndex pointElementIndex,
         bool generateDebris,
@@ -334,23 +811,81 @@ private:
     // The current electrical connectivity visit sequence number
     SequenceNumber mCurrentElectricalVisitSequenceNumber;
 
+    // Set when the electrical connectivity might have changed since the last
+    // electrical connectivity visit
+    bool mIsElectricalConnectivityDirty;
+
+    // Whether each generator was wet at the last electrical update, indexed like the generators
+    std::vector<bool> mAreGeneratorsWet;
+
     // Flag remembering whether the structure of the ship (i.e. the connectivity between elements)
     // has changed since the last step.
     // When this flag is set, we'll re-detect connected components and planes, and re-upload elements
     // to the rendering context
     bool mIsStructureDirty;
 
+    // Flag remembering whether the structure has changed while the ship was out of view, in which
+    // case the elements - connectivity-visited already - are uploaded when the ship gets back in view
+    bool mAreElementsDirtyForRendering;
+
     // The debug ship render mode that was in effect the last time we've uploaded elements;
     // used to detect changes and eventually re-upload
     std::optional<DebugShipRenderMode> mLastDebugShipRenderMode;
 
-    // Initial indices of the triangles for each plane ID;
-    // last extra element contains total number of triangles
-    std::vector<size_t> mPlaneTriangleIndicesToRender;
+    // Whether the stressed springs were shown the last time we've uploaded them
+    bool mAreStressedSpringsUploaded;
+
+    //
+    // Incremental connectivity
+    //
+
+    // A connected component as of the last connectivity visit
+    struct ConnectedComponent
+    {
+        // The highest index among the points of the component; a full visit finds
+        // components - and assigns plane IDs - in descending order of this
+        ElementIndex MaxPointIndex;
+
+        explicit ConnectedComponent(ElementIndex maxPointIndex)
+            : MaxPointIndex(maxPointIndex)
+        {}
+    };
+
+    // The connected components, indexed by connected component ID (== plane ID)
+    std::vector<ConnectedComponent> mConnectedComponents;
+
+    // The endpoints of the springs destroyed since the last connectivity visit; the
+    // next visit only re-visits the components these belong to
+    std::vector<std::pair<ElementIndex, ElementIndex>> mConnectivityBrokenSpringEndpoints;
+
+    // Set when connectivity might have changed in ways that the incremental visit
+    // can't deal with - i.e. springs being restored and components being joined
+    bool mIsFullConnectivityVisitNeeded;
+
+    // Work buffers of the incremental visit, one per side of a broken spring;
+    // the points of each side, which are also the queue of the points to
+    // propagate from, starting at the head
+    struct ConnectivityVisitSide
+    {
+        std::vector<ElementIndex> Points;
+        size_t Head;
+        SequenceNumber VisitSequenceNumber;
+    };
+
+    std::array<ConnectivityVisitSide, 2> mConnectivityVisitSides;
 
     // Sinking detection
     bool mIsSinking;
 
+    // Totals accumulated by the water dynamics
+    ShipStatistics mStatistics;
+
+    // Time spent in the phases of our updates
+    ShipPerfStats mPerfStats;
+
+    // The transient buffers of the current step, all given back at its end
+    WorkBufferArena mWorkBufferArena;
+
     // Water splashes
     RunningAverage<30> mWaterSplashedRunningAverage;
 
@@ -362,6 +897,331 @@ private:
 
     // Force fields to apply at next iteration
     std::vector<std::unique_ptr<ForceField>> mCurrentForceFields;
+
+    // The points that each of the current force fields may reach, for the fields with
+    // a radius; indexed as the fields
+    std::vector<std::vector<ElementIndex>> mForceFieldCandidatePointIndices;
+
+    // The current force fields that the point forces evaluate inline
+    std::vector<PackedForceField> mPackedForceFields;
+
+    // The (x, displacement) pairs with which this ship pushed on the ocean surface
+    // since the last flush
+    std::vector<std::pair<float, float>> mPendingOceanSurfaceDisplacements;
+
+    // The implementation of the spring forces kernel for this CPU
+    SpringForcesImplementation const mSpringForcesImplementation;
+
+    // The tasks for calculating spring forces in parallel, one vector of tasks
+    // for each of the springs' parallel force batches; cleared whenever the batches
+    // are re-calculated
+    std::vector<std::vector<TaskThreadPool::Task>> mParallelSpringForceTasks;
+
+    // The snapshot on which the reference implementation of the kernel being verified
+    // runs, and the largest divergence of the optimized kernel since we last reported it
+    std::vector<float> mKernelVerificationBuffer;
+    float mKernelVerificationMaxDivergence;
+
+    // The buffers and the duration of the current spring constraints substep, which
+    // the tasks for solving spring constraints in parallel read from when they run
+    struct SpringConstraintsSubstep
+    {
+        SpringConstraintsBuffers Buffers;
+        float Dt;
+    };
+
+    SpringConstraintsSubstep mSpringConstraintsSubstep;
+
+    // The tasks for solving spring constraints in parallel, as for the spring forces
+    std::vector<std::vector<TaskThreadPool::Task>> mParallelSpringConstraintTasks;
+
+    // The ropes, as chains of springs whose constraints get solved at once; the springs
+    // and the points of all chains are stored one chain after the other. As deleted springs
+    // have zero coefficients, and points are never removed, chains never change
+    struct RopeChain
+    {
+        size_t SpringsStart;
+        size_t PointsStart;
+        size_t SpringCount;
+    };
+
+    std::vector<RopeChain> mRopeChains;
+    std::vector<ElementIndex> mRopeChainSprings;
+    std::vector<ElementIndex> mRopeChainPoints;
+    size_t mMaxRopeChainSpringCount;
+
+    //
+    // Spatial spring order
+    //
+
+    // The (non-deleted) springs sorted by their location in space; when not empty,
+    // the spring forces visit springs in this order rather than in index order
+    std::vector<ElementIndex> mSpatiallySortedSprings;
+
+    // Set when the springs have changed since they were last sorted, and for how many steps
+    bool mAreSpatiallySortedSpringsDirty;
+    std::uint32_t mSpatiallySortedSpringsDirtyStepCount;
+
+    //
+    // Live springs
+    //
+
+    // The non-deleted springs in index order, once enough springs have been deleted -
+    // empty otherwise; when not empty, and springs are not sorted spatially, the spring
+    // forces and constraints visit these rather than all springs
+    std::vector<ElementIndex> mLiveSprings;
+
+    // Set when springs have been destroyed or restored since the live ones were last listed, and for how many steps
+    bool mAreLiveSpringsDirty;
+    std::uint32_t mLiveSpringsDirtyStepCount;
+
+    //
+    // Frontier
+    //
+
+    // Whether each spring is a frontier spring, i.e. a non-deleted spring with less than
+    // two super-triangles, indexed by spring
+    std::vector<bool> mIsFrontierSpring;
+
+    // The number of frontier springs connected to each point, indexed by point
+    std::vector<std::uint8_t> mPointFrontierSpringCounts;
+
+    // The points with at least one frontier spring, and the position of each point in
+    // there - or NoneElementIndex - indexed by point, for removing points in constant time
+    std::vector<ElementIndex> mFrontierPoints;
+    std::vector<ElementIndex> mFrontierPointPositions;
+
+    //
+    // Island sleeping
+    //
+
+    struct IslandSleepState
+    {
+        // The number of consecutive steps during which the island has been quiescent
+        uint32_t QuiescentStepCount;
+
+        bool IsSleeping;
+
+        // Scratch state of the last sleeping evaluation
+        bool IsQuiescentInStep;
+        bool IsOnSeaFloorInStep;
+
+        IslandSleepState()
+            : QuiescentStepCount(0)
+            , IsSleeping(false)
+            , IsQuiescentInStep(false)
+            , IsOnSeaFloorInStep(false)
+        {}
+    };
+
+    // The sleep state of each island, indexed by connected component ID
+    std::vector<IslandSleepState> mIslandSleepStates;
+
+    // Whether there's at least one sleeping island
+    bool mHasSleepingIslands;
+
+    // The (non-ephemeral) points of all awake islands, followed by the live ephemeral
+    // points as of the last mechanical dynamics update; the dynamics only visit these points
+    std::vector<ElementIndex> mAwakePoints;
+    size_t mAwakeNonEphemeralPointCount;
+
+    // The springs of all awake islands; only populated when there are sleeping islands
+    std::vector<ElementIndex> mAwakeSprings;
+
+    // The (non-ephemeral) points and the (non-deleted) springs of each island, as of the
+    // last connectivity visit: the points of island c are at [mIslandPointOffsets[c], mIslandPointOffsets[c+1])
+    // in mIslandPointIndices, and likewise for springs - which belong to the island of their
+    // endpoint A. This way islands may be woken up, put to sleep, and collided on their own,
+    // in time proportional to their size rather than to the ship's
+    std::vector<ElementIndex> mIslandPointOffsets;
+    std::vector<ElementIndex> mIslandPointIndices;
+    std::vector<ElementIndex> mIslandSpringOffsets;
+    std::vector<ElementIndex> mIslandSpringIndices;
+
+    //
+    // Water active points
+    //
+
+    // The (non-ephemeral) points that are wet or have a wet neighbor; the water diffusion
+    // only visits these points, as dry points surrounded by dry points don't move any water
+    std::vector<ElementIndex> mWaterActivePoints;
+
+    // Whether each point is in the active points, indexed by point
+    std::vector<bool> mIsWaterActivePoint;
+
+    // Whether points have been added to the active points since they were last sorted;
+    // the diffusion visits points in index order
+    bool mAreWaterActivePointsUnsorted;
+
+    //
+    // Low-frequency water dynamics
+    //
+
+    // The number of steps between two consecutive runs of the water dynamics;
+    // one when running at full rate
+    std::uint32_t mWaterDynamicsPeriod;
+
+    // The water taken in at the last run of the water dynamics, per step
+    float mLastWaterTakenPerStep;
+
+    //
+    // GPU mechanical dynamics
+    //
+
+    // Created lazily, the first time we run the mechanical dynamics on the GPU
+    std::unique_ptr<MechanicalDynamicsGPUCalculator> mMechanicalDynamicsGPUCalculator;
+
+    // Set once we've failed to create the calculator, so that we don't try again
+    bool mIsMechanicalDynamicsGPUCalculatorUnavailable;
+
+    // The steps run so far on the GPU, for timing the read-backs
+    uint64_t mGPUMechanicalDynamicsStepCount;
+
+    // Set when the GPU holds newer point dynamics than the CPU, which are then only
+    // rendered from the GPU
+    bool mAreGPUPointDynamicsAhead;
+
+    //
+    // GPU water diffusion
+    //
+
+    // Created lazily, the first time we diffuse water on the GPU
+    std::unique_ptr<WaterDiffusionGPUCalculator> mWaterDiffusionGPUCalculator;
+
+    // Set once we've failed to create the calculator, so that we don't try again
+    bool mIsWaterDiffusionGPUCalculatorUnavailable;
+
+    // Set when the springs have changed since the adjacency was last uploaded
+    bool mIsWaterDiffusionGPUAdjacencyDirty;
+
+    //
+    // Light grid
+    //
+
+    // The points bucketed into the cells of a uniform grid, rebuilt at each light
+    // diffusion: the points of cell c are at [mLightGridCellOffsets[c], mLightGridCellOffsets[c+1])
+    // in mLightGridPointIndices
+    std::vector<ElementIndex> mLightGridCellOffsets;
+    std::vector<ElementIndex> mLightGridPointIndices;
+
+    // The position of the grid's bottom-left corner, its cells' side, and its size in cells
+    vec2f mLightGridOrigin;
+    float mLightGridCellSize;
+    size_t mLightGridWidth;
+    size_t mLightGridHeight;
+
+    //
+    // Interaction grid
+    //
+
+    // The non-ephemeral and live ephemeral points bucketed into the cells of a uniform grid,
+    // laid out as the light grid, for the interactions' queries; built on the first query
+    // after the points have moved, hence never while no tool is in use
+    mutable std::vector<ElementIndex> mInteractionGridCellOffsets;
+    mutable std::vector<ElementIndex> mInteractionGridPointIndices;
+
+    mutable vec2f mInteractionGridOrigin;
+    mutable float mInteractionGridCellSize;
+    mutable size_t mInteractionGridWidth;
+    mutable size_t mInteractionGridHeight;
+
+    mutable bool mIsInteractionGridCurrent;
+
+    // The springs bucketed into the cells of the interaction grid, also laid out as the light
+    // grid; a spring is in all the cells its bounding box touches. Built on the first saw
+    // after the interaction grid
+    mutable std::vector<ElementIndex> mInteractionGridSpringCellOffsets;
+    mutable std::vector<ElementIndex> mInteractionGridSpringIndices;
+
+    mutable bool mAreInteractionGridSpringsCurrent;
+
+    // The points around the position of the last nearest-point query, together with their
+    // positions at that time; the queries of hovering tools at about the same position
+    // are answered from these alone - rather than from the interaction grid, which would
+    // be rebuilt at each step - until the cursor, the ship, or any of them moves beyond
+    // a tolerance
+    struct NearestPointCandidates
+    {
+        vec2f TargetPosition;
+        float Radius;
+        Geometry::AABB ShipAABB;
+        std::vector<ElementIndex> PointIndices;
+        std::vector<vec2f> PointPositions;
+        bool IsValid;
+
+        NearestPointCandidates()
+            : TargetPosition(vec2f::zero())
+            , Radius(0.0f)
+            , ShipAABB(0.0f, 0.0f, 0.0f, 0.0f)
+            , PointIndices()
+            , PointPositions()
+            , IsValid(false)
+        {}
+    };
+
+    mutable NearestPointCandidates mNearestPointCandidates;
+
+    //
+    // Light cache
+    //
+
+    // The positions of all points at the last light diffusion, indexed by point
+    std::vector<vec2f> mLightPointPositions;
+
+    // The light adjustments at the last light diffusion
+    float mLightLuminiscenceAdjustment;
+    float mLightSpreadAdjustment;
+
+    // Set when the light of the last diffusion may not be reused
+    bool mIsLightDirty;
+
+    //
+    // Adaptive mechanical iterations
+    //
+
+    // The number of mechanical iterations we're currently running with;
+    // zero when we're not adapting
+    size_t mAdaptiveNumMechanicalDynamicsIterations;
+
+    // The number of consecutive steps during which we could have run
+    // with fewer iterations
+    uint32_t mAdaptiveNumMechanicalDynamicsIterationsDecreaseStepCount;
+
+    //
+    // Bounds
+    //
+
+    // The bounding box of the structural points, i.e. the union of the boxes of the
+    // connected components
+    Geometry::AABB mAABB;
+
+    // The bounding boxes of the connected components, indexed by connected component ID;
+    // the boxes of sleeping islands are left as they were when the islands fell asleep
+    std::vector<Geometry::AABB> mConnectedComponentAABBs;
+
+    //
+    // Ship collisions
+    //
+
+    // The triangles bucketed by connected component: the triangles of component c are at
+    // [mCollisionComponentTriangleOffsets[c], mCollisionComponentTriangleOffsets[c+1]) in
+    // mCollisionComponentTriangleIndices; built on demand, at most once per step. The
+    // points are those of the islands
+    std::vector<ElementIndex> mCollisionComponentTriangleOffsets;
+    std::vector<ElementIndex> mCollisionComponentTriangleIndices;
+    bool mAreCollisionComponentBucketsCurrent;
+
+    // The triangles of the other component bucketed into the cells of a uniform grid
+    // over the collision region, rebuilt at each collision; cells are laid out as in the
+    // light grid, and a triangle is in all the cells its bounding box touches
+    std::vector<ElementIndex> mCollisionGridCellOffsets;
+    std::vector<ElementIndex> mCollisionGridTriangleIndices;
+
+    //
+    // Proxy lattice
+    //
+
+    ShipProxyLattice const mProxyLattice;
 };
 
 }
\ No newline at end of file
@@ -9,23 +9,36 @@
 
 #include <GameCore/ImageTools.h>
 #include <GameCore/Log.h>
+#include <GameCore/TaskThreadPool.h>
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <iterator>
 #include <limits>
-#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
 using namespace Physics;
 
+// The minimum number of structural layer pixels that are worth a band of their own
+// when visiting the structural layer in parallel
+static constexpr size_t MinPixelsPerParallelBand = 64 * 1024;
+
+static size_t CalculateParallelBandCount(size_t pixelCount)
+{
+    return std::max(
+        std::min(TaskThreadPool::GetInstance().GetParallelism(), pixelCount / MinPixelsPerParallelBand),
+        size_t(1));
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 std::unique_ptr<Ship> ShipBuilder::Create(
     ShipId shipId,
     World & parentWorld,
     std::shared_ptr<IGameEventHandler> gameEventHandler,
-    ShipDefinition const & shipDefinition,
+    ShipDefinition & shipDefinition,
     MaterialDatabase const & materialDatabase,
     GameParameters const & gameParameters)
 {
@@ -53,65 +66,190 @@ std::unique_ptr<Ship> ShipBuilder::Create(
     // - Identify rope endpoints on structural layer, and create RopeSegment's for them
     //
 
-    // Matrix of points - we allocate 2 extra dummy rows and cols to avoid checking for boundaries
-    std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> pointIndexMatrix(new std::unique_ptr<std::optional<ElementIndex>[]>[structureWidth + 2]);
-    for (int c = 0; c < structureWidth + 2; ++c)
+    // Matrix of points - with 2 extra dummy rows and cols to avoid checking for boundaries
+    PointIndexMatrix pointIndexMatrix(structureWidth, structureHeight);
+
+    //
+    // We visit the columns in bands that run in parallel; points are numbered in column order
+    // across all bands, exactly as if we visited all columns serially, and the bands are then
+    // merged in that same order
+    //
+
+    struct RopeEndpoint
+    {
+        MaterialDatabase::ColorKey ColorKey;
+        ElementIndex PointIndex;
+        int X;
+        int Y;
+    };
+
+    struct StructuralLayerBand
     {
-        pointIndexMatrix[c] = std::unique_ptr<std::optional<ElementIndex>[]>(new std::optional<ElementIndex>[structureHeight + 2]);
+        int StartX;
+        int EndX;
+        ElementCount StartPointIndex;
+        std::vector<PointInfo> PointInfos;
+        std::vector<RopeEndpoint> RopeEndpoints;
+    };
+
+    size_t const structuralLayerBandCount = CalculateParallelBandCount(
+        static_cast<size_t>(structureWidth) * static_cast<size_t>(structureHeight));
+
+    std::vector<StructuralLayerBand> structuralLayerBands;
+    for (size_t b = 0; b < structuralLayerBandCount; ++b)
+    {
+        structuralLayerBands.push_back({
+            static_cast<int>(structureWidth * b / structuralLayerBandCount),
+            static_cast<int>(structureWidth * (b + 1) / structuralLayerBandCount),
+            0,
+            {},
+            {} });
     }
 
-    // Visit all columns
-    for (int x = 0; x < structureWidth; ++x)
+    bool const doSnapOffPaletteColors = gameParameters.DoSnapOffPaletteStructuralColors;
+
+    auto const getStructuralMaterial = [&](int x, int y)
     {
-        // From bottom to top
-        for (int y = 0; y < structureHeight; ++y)
+        MaterialDatabase::ColorKey const & colorKey =
+            shipDefinition.StructuralLayerImage.Data[x + (structureHeight - y - 1) * structureWidth];
+
+        StructuralMaterial const * structuralMaterial = materialDatabase.FindStructuralMaterial(colorKey);
+        if (nullptr == structuralMaterial && doSnapOffPaletteColors)
         {
-            MaterialDatabase::ColorKey colorKey = shipDefinition.StructuralLayerImage.Data[x + (structureHeight - y - 1) * structureWidth];
-            StructuralMaterial const * structuralMaterial = materialDatabase.FindStructuralMaterial(colorKey);
-            if (nullptr != structuralMaterial)
+            structuralMaterial = materialDatabase.FindNearestStructuralMaterial(colorKey);
+        }
+
+        return structuralMaterial;
+    };
+
+    std::vector<TaskThreadPool::Task> structuralLayerTasks;
+
+    // 1. Count the points in each band, so that each band knows the index of its first point
+
+    for (size_t b = 0; b < structuralLayerBandCount; ++b)
+    {
+        structuralLayerTasks.emplace_back(
+            [&structuralLayerBands, &getStructuralMaterial, structureHeight, b]()
             {
-                //
-                // Make a point
-                //
+                StructuralLayerBand & band = structuralLayerBands[b];
 
-                ElementIndex const pointIndex = static_cast<ElementIndex>(pointInfos.size());
+                ElementCount pointCount = 0;
+                for (int x = band.StartX; x < band.EndX; ++x)
+                {
+                    for (int y = 0; y < structureHeight; ++y)
+                    {
+                        if (nullptr != getStructuralMaterial(x, y))
+                            ++pointCount;
+                    }
+                }
 
-                pointIndexMatrix[x + 1][y + 1] = static_cast<ElementIndex>(pointIndex);
+                // Temporarily park the count here
+                band.StartPointIndex = pointCount;
+            });
+    }
 
-                pointInfos.emplace_back(
-                    vec2f(
-                        static_cast<float>(x) - halfWidth,
-                        static_cast<float>(y))
-                    + shipDefinition.Metadata.Offset,
-                    MakeTextureCoordinates(x, y, shipDefinition.StructuralLayerImage.Size),
-                    structuralMaterial->RenderColor,
-                    *structuralMaterial,
-                    structuralMaterial->IsUniqueType(StructuralMaterial::MaterialUniqueType::Rope));
+    TaskThreadPool::GetInstance().Run(structuralLayerTasks);
 
-                //
-                // Check if it's a (custom) rope endpoint
-                //
+    ElementCount structuralPointCount = 0;
+    for (auto & band : structuralLayerBands)
+    {
+        ElementCount const bandPointCount = band.StartPointIndex;
+        band.StartPointIndex = structuralPointCount;
+        structuralPointCount += bandPointCount;
+    }
+
+    // Check now, before point indices get stored anywhere
+    CheckElementCount(structuralPointCount + GameParameters::MaxEphemeralParticles, "points");
+
+    // 2. Make the points of each band
 
-                if (structuralMaterial->IsUniqueType(StructuralMaterial::MaterialUniqueType::Rope)
-                    && !materialDatabase.IsUniqueStructuralMaterialColorKey(StructuralMaterial::MaterialUniqueType::Rope, colorKey))
+    structuralLayerTasks.clear();
+    for (size_t b = 0; b < structuralLayerBandCount; ++b)
+    {
+        structuralLayerTasks.emplace_back(
+            [&, b]()
+            {
+                StructuralLayerBand & band = structuralLayerBands[b];
+
+                ElementIndex pointIndex = static_cast<ElementIndex>(band.StartPointIndex);
+
+                // Visit all columns of the band
+                for (int x = band.StartX; x < band.EndX; ++x)
                 {
-                    // Store in RopeSegments, using the color key as the color of the rope
-                    RopeSegment & ropeSegment = ropeSegments[colorKey];
-                    if (!ropeSegment.SetEndpoint(pointIndex, colorKey))
+                    // From bottom to top
+                    for (int y = 0; y < structureHeight; ++y)
                     {
-                        throw GameException(
-                            std::string("More than two \"" + Utils::RgbColor2Hex(colorKey) + "\" rope endpoints found at (")
-                            + std::to_string(x) + "," + std::to_string(structureHeight - y - 1) + ")");
+                        StructuralMaterial const * structuralMaterial = getStructuralMaterial(x, y);
+                        if (nullptr != structuralMaterial)
+                        {
+                            //
+                            // Make a point
+                            //
+
+                            pointIndexMatrix.Set(x + 1, y + 1, pointIndex);
+
+                            band.PointInfos.emplace_back(
+                                vec2f(
+                                    static_cast<float>(x) - halfWidth,
+                                    static_cast<float>(y))
+                                + shipDefinition.Metadata.Offset,
+                                MakeTextureCoordinates(x, y, shipDefinition.StructuralLayerImage.Size),
+                                structuralMaterial->RenderColor,
+                                *structuralMaterial,
+                                structuralMaterial->IsUniqueType(StructuralMaterial::MaterialUniqueType::Rope));
+
+                            //
+                            // Check if it's a (custom) rope endpoint
+                            //
+
+                            MaterialDatabase::ColorKey const colorKey = shipDefinition.StructuralLayerImage.Data[x + (structureHeight - y - 1) * structureWidth];
+                            if (structuralMaterial->IsUniqueType(StructuralMaterial::MaterialUniqueType::Rope)
+                                && !materialDatabase.IsUniqueStructuralMaterialColorKey(StructuralMaterial::MaterialUniqueType::Rope, colorKey))
+                            {
+                                band.RopeEndpoints.push_back({ colorKey, pointIndex, x, y });
+                            }
+
+                            ++pointIndex;
+                        }
+                        else
+                        {
+                            // Just ignore this pixel
+                        }
                     }
                 }
-            }
-            else
+            });
+    }
+
+    TaskThreadPool::GetInstance().Run(structuralLayerTasks);
+
+    // 3. Merge the bands, in column order
+
+    pointInfos.reserve(structuralPointCount);
+
+    for (auto & band : structuralLayerBands)
+    {
+        assert(band.StartPointIndex == pointInfos.size());
+
+        for (auto & pointInfo : band.PointInfos)
+        {
+            pointInfos.emplace_back(std::move(pointInfo));
+        }
+
+        for (auto const & ropeEndpoint : band.RopeEndpoints)
+        {
+            // Store in RopeSegments, using the color key as the color of the rope
+            RopeSegment & ropeSegment = ropeSegments[ropeEndpoint.ColorKey];
+            if (!ropeSegment.SetEndpoint(ropeEndpoint.PointIndex, ropeEndpoint.ColorKey))
             {
-                // Just ignore this pixel
+                throw GameException(
+                    std::string("More than two \"" + Utils::RgbColor2Hex(ropeEndpoint.ColorKey) + "\" rope endpoints found at (")
+                    + std::to_string(ropeEndpoint.X) + "," + std::to_string(structureHeight - ropeEndpoint.Y - 1) + ")");
             }
         }
     }
 
+    structuralLayerBands.clear();
+
 
     //
     // Process the rope layer - if any - and append rope endpoints
@@ -133,6 +271,9 @@ std::unique_ptr<Ship> ShipBuilder::Create(
             pointIndexMatrix,
             materialDatabase,
             shipDefinition.Metadata.Offset);
+
+        // Done with it
+        shipDefinition.RopesLayerImage.reset();
     }
 
 
@@ -155,6 +296,9 @@ std::unique_ptr<Ship> ShipBuilder::Create(
             true,
             pointIndexMatrix,
             materialDatabase);
+
+        // Done with it
+        shipDefinition.ElectricalLayerImage.reset();
     }
     else
     {
@@ -167,6 +311,10 @@ std::unique_ptr<Ship> ShipBuilder::Create(
             materialDatabase);
     }
 
+    // We're done with the pixels of the structural layer - from now on we only need its size;
+    // on large ships, this is a good part of what the element infos below are about to take
+    shipDefinition.StructuralLayerImage.Data.reset();
+
 
     //
     // Process all identified rope endpoints and:
@@ -202,38 +350,101 @@ std::unique_ptr<Ship> ShipBuilder::Create(
 
 
     //
-    // Optimize order of SpringInfo's to minimize cache misses
+    // Optimize order of SpringInfo's and TriangleInfo's to minimize cache misses,
+    // and then reorder points to improve data locality when visiting springs
     //
 
-    float originalSpringACMR = CalculateACMR(springInfos);
+    float const originalSpringACMR = CalculateACMR(springInfos);
+    float const originalTriangleACMR = CalculateACMR(triangleInfos);
 
-    // Tiling algorithm
-    springInfos = ReorderSpringsOptimally_Tiling<2>(
-        springInfos,
-        pointIndexMatrix,
-        shipDefinition.StructuralLayerImage.Size,
-        pointInfos);
+    auto const layoutStartTime = std::chrono::steady_clock::now();
+
+    std::vector<ElementIndex> pointIndexRemap;
+
+    switch (gameParameters.ShipLayout)
+    {
+        case ShipLayoutStrategy::Tiling:
+        {
+            springInfos = ReorderSpringsOptimally_Tiling<2>(
+                springInfos,
+                pointIndexMatrix,
+                shipDefinition.StructuralLayerImage.Size,
+                pointInfos);
+
+            // Note: we don't optimize triangles, as tests indicate that performance gets (marginally) worse,
+            // and at the same time, it makes sense to use the natural order of the triangles as it ensures
+            // that higher elements in the ship cover lower elements when they are semi-detached
+
+            pointInfos = ReorderPointsOptimally_FollowingSprings(
+                pointInfos,
+                springInfos,
+                pointIndexRemap);
+
+            break;
+        }
+
+        case ShipLayoutStrategy::SpringsTomForsyth:
+        {
+            springInfos = ReorderSpringsOptimally_TomForsyth(
+                springInfos,
+                pointInfos.size());
+
+            pointInfos = ReorderPointsOptimally_FollowingSprings(
+                pointInfos,
+                springInfos,
+                pointIndexRemap);
 
-    float optimizedSpringACMR = CalculateACMR(springInfos);
+            break;
+        }
+
+        case ShipLayoutStrategy::TrianglesTomForsyth:
+        {
+            springInfos = ReorderSpringsOptimally_Tiling<2>(
+                springInfos,
+                pointIndexMatrix,
+                shipDefinition.StructuralLayerImage.Size,
+                pointInfos);
+
+            triangleInfos = ReorderTrianglesSpringsOptimally_TomForsyth(
+                triangleInfos,
+                pointInfos.size());
+
+            pointInfos = ReorderPointsOptimally_FollowingSprings(
+                pointInfos,
+                springInfos,
+                pointIndexRemap);
+
+            break;
+        }
+
+        case ShipLayoutStrategy::Idempotent:
+        {
+            pointInfos = ReorderPointsOptimally_Idempotent(
+                pointInfos,
+                pointIndexRemap);
 
-    LogMessage("Spring ACMR: original=", originalSpringACMR, ", optimized=", optimizedSpringACMR);
+            break;
+        }
+    }
+
+    auto const layoutEndTime = std::chrono::steady_clock::now();
 
+    float const optimizedSpringACMR = CalculateACMR(springInfos);
+    float const optimizedTriangleACMR = CalculateACMR(triangleInfos);
 
-    // Note: we don't optimize triangles, as tests indicate that performance gets (marginally) worse,
-    // and at the same time, it makes sense to use the natural order of the triangles as it ensures
-    // that higher elements in the ship cover lower elements when they are semi-detached
+    LogMessage("Ship layout ", static_cast<int>(gameParameters.ShipLayout),
+        ": spring ACMR: original=", originalSpringACMR, ", optimized=", optimizedSpringACMR,
+        "; triangle ACMR: original=", originalTriangleACMR, ", optimized=", optimizedTriangleACMR,
+        "; time=", std::chrono::duration_cast<std::chrono::microseconds>(layoutEndTime - layoutStartTime).count(), "us");
 
 
     //
-    // Now reorder points to improve data locality when visiting springs
+    // Check that everything fits our element indices
     //
 
-    std::vector<ElementIndex> pointIndexRemap;
-
-    pointInfos = ReorderPointsOptimally_FollowingSprings(
-        pointInfos,
-        springInfos,
-        pointIndexRemap);
+    CheckElementCount(pointInfos.size() + GameParameters::MaxEphemeralParticles, "points");
+    CheckElementCount(springInfos.size(), "springs");
+    CheckElementCount(triangleInfos.size(), "triangles");
 
 
     //
@@ -263,6 +474,7 @@ std::unique_ptr<Ship> ShipBuilder::Create(
     //
 
     ConnectSpringsAndTriangles(
+        pointInfos.size(),
         springInfos,
         triangleInfos);
 
@@ -279,6 +491,9 @@ std::unique_ptr<Ship> ShipBuilder::Create(
         gameEventHandler,
         gameParameters);
 
+    // Now that all springs are connected, lay out the points' adjacency
+    points.RebuildAdjacency();
+
 
     //
     // Create Triangles for all (filtered out) TriangleInfo's
@@ -300,13 +515,22 @@ std::unique_ptr<Ship> ShipBuilder::Create(
         gameEventHandler);
 
 
+    //
+    // Create the coarse proxy lattice
+    //
+
+    ShipProxyLattice proxyLattice = CreateProxyLattice(
+        points,
+        springs);
+
+
     //
     // We're done!
     //
 
     LogMessage("Created ship: W=", shipDefinition.StructuralLayerImage.Size.Width, ", H=", shipDefinition.StructuralLayerImage.Size.Height, ", ",
         points.GetShipPointCount(), " points, ", springs.GetElementCount(), " springs, ", triangles.GetElementCount(), " triangles, ",
-        electricalElements.GetElementCount(), " electrical elements.");
+        electricalElements.GetElementCount(), " electrical elements, ", proxyLattice.GetProxyPoints().size(), " proxy points.");
 
     return std::make_unique<Ship>(
         shipId,
@@ -316,7 +540,8 @@ std::unique_ptr<Ship> ShipBuilder::Create(
         std::move(points),
         std::move(springs),
         std::move(triangles),
-        std::move(electricalElements));
+        std::move(electricalElements),
+        std::move(proxyLattice));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -327,7 +552,7 @@ void ShipBuilder::AppendRopeEndpoints(
     RgbImageData const & ropeLayerImage,
     std::map<MaterialDatabase::ColorKey, RopeSegment> & ropeSegments,
     std::vector<PointInfo> & pointInfos1,
-    std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> & pointIndexMatrix,
+    PointIndexMatrix & pointIndexMatrix,
     MaterialDatabase const & materialDatabase,
     vec2f const & shipOffset)
 {
@@ -350,7 +575,7 @@ void ShipBuilder::AppendRopeEndpoints(
             {
                 // Check whether we have a structural point here
                 ElementIndex pointIndex;
-                if (!pointIndexMatrix[x + 1][y + 1])
+                if (!pointIndexMatrix.HasPoint(x + 1, y + 1))
                 {
                     // Make a point
                     pointIndex = static_cast<ElementIndex>(pointInfos1.size());
@@ -364,11 +589,11 @@ void ShipBuilder::AppendRopeEndpoints(
                         materialDatabase.GetUniqueStructuralMaterial(StructuralMaterial::MaterialUniqueType::Rope),
                         true);
 
-                    pointIndexMatrix[x + 1][y + 1] = pointIndex;
+                    pointIndexMatrix.Set(x + 1, y + 1, pointIndex);
                 }
                 else
                 {
-                    pointIndex = *(pointIndexMatrix[x + 1][y + 1]);
+                    pointIndex = pointIndexMatrix.Get(x + 1, y + 1);
                 }
 
                 // Make sure we don't have a rope already with an endpoint here
@@ -405,7 +630,7 @@ void ShipBuilder::DecoratePointsWithElectricalMaterials(
     RgbImageData const & layerImage,
     std::vector<PointInfo> & pointInfos1,
     bool isDedicatedElectricalLayer,
-    std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> const & pointIndexMatrix,
+    PointIndexMatrix const & pointIndexMatrix,
     MaterialDatabase const & materialDatabase)
 {
     int const width = layerImage.Size.Width;
@@ -441,7 +666,7 @@ void ShipBuilder::DecoratePointsWithElectricalMaterials(
             else
             {
                 // Make sure we have a structural point here
-                if (!pointIndexMatrix[x + 1][y + 1])
+                if (!pointIndexMatrix.HasPoint(x + 1, y + 1))
                 {
                     throw GameException(
                         std::string("The electrical layer image specifies an electrical material at (")
@@ -450,7 +675,7 @@ void ShipBuilder::DecoratePointsWithElectricalMaterials(
                 }
 
                 // Store electrical material
-                auto const pointIndex = *(pointIndexMatrix[x + 1][y + 1]);
+                auto const pointIndex = pointIndexMatrix.Get(x + 1, y + 1);
                 assert(nullptr == pointInfos1[pointIndex].ElectricalMtl);
                 pointInfos1[pointIndex].ElectricalMtl = electricalMaterial;
             }
@@ -601,7 +826,7 @@ void ShipBuilder::AppendRopes(
 }
 
 void ShipBuilder::CreateShipElementInfos(
-    std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> const & pointIndexMatrix,
+    PointIndexMatrix const & pointIndexMatrix,
     ImageSize const & structureImageSize,
     std::vector<PointInfo> & pointInfos1,
     std::vector<SpringInfo> & springInfos1,
@@ -609,11 +834,87 @@ void ShipBuilder::CreateShipElementInfos(
     size_t & leakingPointsCount)
 {
     //
-    // Visit point matrix and:
+    // Visit the point matrix in bands of rows that run in parallel - rows are independent
+    // of each other - and merge the elements of the bands in row order, so that elements
+    // are numbered exactly as if we visited all rows serially
+    //
+
+    struct ElementsBand
+    {
+        std::vector<SpringInfo> SpringInfos;
+        std::vector<TriangleInfo> TriangleInfos;
+        size_t LeakingPointsCount;
+    };
+
+    size_t const bandCount = CalculateParallelBandCount(
+        static_cast<size_t>(structureImageSize.Width) * static_cast<size_t>(structureImageSize.Height));
+
+    std::vector<ElementsBand> bands(bandCount);
+
+    std::vector<TaskThreadPool::Task> tasks;
+    for (size_t b = 0; b < bandCount; ++b)
+    {
+        tasks.emplace_back(
+            [&, b]()
+            {
+                // Rows are 1-based in the point matrix
+                CreateShipElementInfos(
+                    pointIndexMatrix,
+                    structureImageSize,
+                    1 + static_cast<int>(structureImageSize.Height * b / bandCount),
+                    1 + static_cast<int>(structureImageSize.Height * (b + 1) / bandCount),
+                    pointInfos1,
+                    bands[b].SpringInfos,
+                    bands[b].TriangleInfos,
+                    bands[b].LeakingPointsCount);
+            });
+    }
+
+    TaskThreadPool::GetInstance().Run(tasks);
+
+    leakingPointsCount = 0;
+
+    for (auto & band : bands)
+    {
+        for (auto & springInfo : band.SpringInfos)
+        {
+            ElementIndex const springIndex = static_cast<ElementIndex>(springInfos1.size());
+
+            // Add the spring to its endpoints
+            pointInfos1[springInfo.PointAIndex1].AddConnectedSpring(springIndex);
+            pointInfos1[springInfo.PointBIndex1].AddConnectedSpring(springIndex);
+
+            springInfos1.emplace_back(std::move(springInfo));
+        }
+
+        triangleInfos1.insert(
+            triangleInfos1.end(),
+            std::make_move_iterator(band.TriangleInfos.begin()),
+            std::make_move_iterator(band.TriangleInfos.end()));
+
+        leakingPointsCount += band.LeakingPointsCount;
+    }
+}
+
+void ShipBuilder::CreateShipElementInfos(
+    PointIndexMatrix const & pointIndexMatrix,
+    ImageSize const & structureImageSize,
+    int startY,
+    int endY,
+    std::vector<PointInfo> & pointInfos1,
+    std::vector<SpringInfo> & springInfos1,
+    std::vector<TriangleInfo> & triangleInfos1,
+    size_t & leakingPointsCount)
+{
+    //
+    // Visit the specified rows of the point matrix and:
     //  - Set non-fully-surrounded PointInfos as "leaking"
     //  - Detect springs and create SpringInfo's for them (additional to ropes)
     //  - Do tessellation and create TriangleInfo's
     //
+    // Springs are not added to their endpoints here, as endpoints may belong
+    // to the rows of other, concurrent visits
+    //
 
     // Initialize count of leaking points
     leakingPointsCount = 0;
@@ -631,20 +932,20 @@ void ShipBuilder::CreateShipElementInfos(
     };
 
     // From bottom to top
-    for (int y = 1; y <= structureImageSize.Height; ++y)
+    for (int y = startY; y < endY; ++y)
     {
         // We're starting a new row, so we're not in a ship now
         bool isInShip = false;
 
         for (int x = 1; x <= structureImageSize.Width; ++x)
         {
-            if (!!pointIndexMatrix[x][y])
+            if (pointIndexMatrix.HasPoint(x, y))
             {
                 //
                 // A point exists at these coordinates
                 //
 
-                ElementIndex pointIndex = *pointIndexMatrix[x][y];
+                ElementIndex pointIndex = pointIndexMatrix.Get(x, y);
 
                 // If a non-hull node has empty space on one of its four sides, it is leaking.
                 // Check if a is leaking; a is leaking if:
@@ -652,10 +953,10 @@ void ShipBuilder::CreateShipElementInfos(
                 // - there is at least a hole at E, S, W, N
                 if (!pointInfos1[pointIndex].StructuralMtl.IsHull)
                 {
-                    if (!pointIndexMatrix[x + 1][y]
-                        || !pointIndexMatrix[x][y + 1]
-                        || !pointIndexMatrix[x - 1][y]
-                        || !pointIndexMatrix[x][y - 1])
+                    if (!pointIndexMatrix.HasPoint(x + 1, y)
+                        || !pointIndexMatrix.HasPoint(x, y + 1)
+                        || !pointIndexMatrix.HasPoint(x - 1, y)
+                        || !pointIndexMatrix.HasPoint(x, y - 1))
                     {
                         pointInfos1[pointIndex].IsLeaking = true;
                         ++leakingPointsCount;
@@ -674,7 +975,7 @@ void ShipBuilder::CreateShipElementInfos(
                     int adjx1 = x + Directions[i][0];
                     int adjy1 = y + Directions[i][1];
 
-                    if (!!pointIndexMatrix[adjx1][adjy1])
+                    if (pointIndexMatrix.HasPoint(adjx1, adjy1))
                     {
                         // This point is adjacent to the first point at one of E, SE, S, SW
 
@@ -682,9 +983,7 @@ void ShipBuilder::CreateShipElementInfos(
                         // Create SpringInfo
                         //
 
-                        ElementIndex const otherEndpointIndex = *pointIndexMatrix[adjx1][adjy1];
-
-                        ElementIndex const springIndex = static_cast<ElementIndex>(springInfos1.size());
+                        ElementIndex const otherEndpointIndex = pointIndexMatrix.Get(adjx1, adjy1);
 
                         springInfos1.emplace_back(
                             pointIndex,
@@ -692,10 +991,6 @@ void ShipBuilder::CreateShipElementInfos(
                             otherEndpointIndex,
                             (i + 4) % 8);
 
-                        // Add the spring to its endpoints
-                        pointInfos1[pointIndex].AddConnectedSpring(springIndex);
-                        pointInfos1[otherEndpointIndex].AddConnectedSpring(springIndex);
-
 
                         //
                         // Check if a triangle exists
@@ -708,7 +1003,7 @@ void ShipBuilder::CreateShipElementInfos(
                         int adjx2 = x + Directions[i + 1][0];
                         int adjy2 = y + Directions[i + 1][1];
                         if ((!isInShip || i < 2)
-                            && !!pointIndexMatrix[adjx2][adjy2])
+                            && pointIndexMatrix.HasPoint(adjx2, adjy2))
                         {
                             // This point is adjacent to the first point at one of SE, S, SW, W
 
@@ -721,7 +1016,7 @@ void ShipBuilder::CreateShipElementInfos(
                                     {
                                         pointIndex,
                                         otherEndpointIndex,
-                                        *pointIndexMatrix[adjx2][adjy2]
+                                        pointIndexMatrix.Get(adjx2, adjy2)
                                     }));
                         }
 
@@ -731,11 +1026,11 @@ void ShipBuilder::CreateShipElementInfos(
                         // We do this so that we can forget the entire W side for inner points and yet ensure
                         // full coverage of the area
                         if (i == 0
-                            && !pointIndexMatrix[x + Directions[1][0]][y + Directions[1][1]]
-                            && !!pointIndexMatrix[x + Directions[2][0]][y + Directions[2][1]])
+                            && !pointIndexMatrix.HasPoint(x + Directions[1][0], y + Directions[1][1])
+                            && pointIndexMatrix.HasPoint(x + Directions[2][0], y + Directions[2][1]))
                         {
                             // If we're here, the point at E exists
-                            assert(!!pointIndexMatrix[x + Directions[0][0]][y + Directions[0][1]]);
+                            assert(pointIndexMatrix.HasPoint(x + Directions[0][0], y + Directions[0][1]));
 
                             //
                             // Create TriangleInfo
@@ -745,8 +1040,8 @@ void ShipBuilder::CreateShipElementInfos(
                                 std::array<ElementIndex, 3>(
                                     {
                                         pointIndex,
-                                        *pointIndexMatrix[x + Directions[0][0]][y + Directions[0][1]],
-                                        *pointIndexMatrix[x + Directions[2][0]][y + Directions[2][1]]
+                                        pointIndexMatrix.Get(x + Directions[0][0], y + Directions[0][1]),
+                                        pointIndexMatrix.Get(x + Directions[2][0], y + Directions[2][1])
                                     }));
                         }
                     }
@@ -771,7 +1066,7 @@ void ShipBuilder::CreateShipElementInfos(
 template <int BlockSize>
 std::vector<ShipBuilder::SpringInfo> ShipBuilder::ReorderSpringsOptimally_Tiling(
     std::vector<SpringInfo> const & springInfos1,
-    std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> const & pointIndexMatrix,
+    PointIndexMatrix const & pointIndexMatrix,
     ImageSize const & structureImageSize,
     std::vector<PointInfo> const & pointInfos1)
 {
@@ -795,9 +1090,9 @@ std::vector<ShipBuilder::SpringInfo> ShipBuilder::ReorderSpringsOptimally_Tiling
             {
                 for (int x2 = 0; x2 < BlockSize && x + x2 <= structureImageSize.Width; ++x2)
                 {
-                    if (!!pointIndexMatrix[x + x2][y + y2])
+                    if (pointIndexMatrix.HasPoint(x + x2, y + y2))
                     {
-                        ElementIndex pointIndex = *(pointIndexMatrix[x + x2][y + y2]);
+                        ElementIndex pointIndex = pointIndexMatrix.Get(x + x2, y + y2);
 
                         // Add all springs connected to this point
                         for (auto connectedSpringIndex : pointInfos1[pointIndex].ConnectedSprings1)
@@ -990,50 +1285,53 @@ std::vector<ShipBuilder::TriangleInfo> ShipBuilder::FilterOutRedundantTriangles(
 }
 
 void ShipBuilder::ConnectSpringsAndTriangles(
+    size_t pointCount,
     std::vector<SpringInfo> & springInfos2,
     std::vector<TriangleInfo> & triangleInfos2)
 {
     //
-    // 1. Build Edge -> Spring table
+    // 1. Build Point -> Springs table, with the springs of each point contiguous and
+    //    in spring order; as springs only connect a point to its (at most) eight
+    //    neighbors, plus a rope or two, an edge is found by scanning the few springs
+    //    of one of its endpoints
     //
 
-    struct Edge
+    std::vector<ElementIndex> pointSpringsStart(pointCount + 1, 0);
+    for (auto const & springInfo : springInfos2)
     {
-        ElementIndex Endpoint1Index;
-        ElementIndex Endpoint2Index;
+        ++pointSpringsStart[springInfo.PointAIndex1 + 1];
+        ++pointSpringsStart[springInfo.PointBIndex1 + 1];
+    }
 
-        Edge(
-            ElementIndex endpoint1Index,
-            ElementIndex endpoint2Index)
-            : Endpoint1Index(std::min(endpoint1Index, endpoint2Index))
-            , Endpoint2Index(std::max(endpoint1Index, endpoint2Index))
-        {}
+    for (size_t p = 1; p <= pointCount; ++p)
+    {
+        pointSpringsStart[p] += pointSpringsStart[p - 1];
+    }
 
-        bool operator==(Edge const & other) const
+    std::vector<ElementIndex> pointSprings(pointSpringsStart[pointCount]);
+    {
+        std::vector<ElementIndex> pointSpringsEnd(pointSpringsStart.cbegin(), pointSpringsStart.cend() - 1);
+        for (ElementIndex s = 0; s < springInfos2.size(); ++s)
         {
-            return this->Endpoint1Index == other.Endpoint1Index
-                && this->Endpoint2Index == other.Endpoint2Index;
+            pointSprings[pointSpringsEnd[springInfos2[s].PointAIndex1]++] = s;
+            pointSprings[pointSpringsEnd[springInfos2[s].PointBIndex1]++] = s;
         }
+    }
 
-        struct Hasher
+    auto const findSpring = [&](ElementIndex endpoint1Index, ElementIndex endpoint2Index) -> ElementIndex
+    {
+        for (ElementIndex i = pointSpringsStart[endpoint1Index]; i < pointSpringsStart[endpoint1Index + 1]; ++i)
         {
-            size_t operator()(Edge const & edge) const
+            ElementIndex const s = pointSprings[i];
+            if (springInfos2[s].PointAIndex1 == endpoint2Index
+                || springInfos2[s].PointBIndex1 == endpoint2Index)
             {
-                return edge.Endpoint1Index * 23
-                    + edge.Endpoint2Index;
+                return s;
             }
-        };
-    };
-
-    std::unordered_map<Edge, ElementIndex, Edge::Hasher> pointToSpringMap;
+        }
 
-    for (ElementIndex s = 0; s < springInfos2.size(); ++s)
-    {
-        pointToSpringMap.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(springInfos2[s].PointAIndex1, springInfos2[s].PointBIndex1),
-            std::forward_as_tuple(s));
-    }
+        return NoneElementIndex;
+    };
 
 
     //
@@ -1052,10 +1350,8 @@ void ShipBuilder::ConnectSpringsAndTriangles(
                 : triangleInfos2[t].PointIndices1[0];
 
             // Lookup spring for this edge
-            auto const springIt = pointToSpringMap.find({ endpointIndex, nextEndpointIndex });
-            assert(springIt != pointToSpringMap.end());
-
-            ElementIndex const springIndex = springIt->second;
+            ElementIndex const springIndex = findSpring(endpointIndex, nextEndpointIndex);
+            assert(springIndex != NoneElementIndex);
 
             // Tell this spring that it has an extra super triangle
             springInfos2[springIndex].SuperTriangles2.push_back(t);
@@ -1128,21 +1424,21 @@ void ShipBuilder::ConnectSpringsAndTriangles(
             // See if there's a B-C spring
             //
 
-            auto const traverseSpringIt = pointToSpringMap.find({ endpoint1Index, endpoint2Index });
-            if (traverseSpringIt != pointToSpringMap.end())
+            ElementIndex const traverseSpringIndex = findSpring(endpoint1Index, endpoint2Index);
+            if (traverseSpringIndex != NoneElementIndex)
             {
                 // We have a traverse spring
 
-                assert(0 == springInfos2[traverseSpringIt->second].SuperTriangles2.size());
+                assert(0 == springInfos2[traverseSpringIndex].SuperTriangles2.size());
 
                 // Tell the traverse spring that it has these super triangles
-                springInfos2[traverseSpringIt->second].SuperTriangles2.push_back(springInfos2[s].SuperTriangles2[0]);
-                springInfos2[traverseSpringIt->second].SuperTriangles2.push_back(springInfos2[s].SuperTriangles2[1]);
-                assert(springInfos2[traverseSpringIt->second].SuperTriangles2.size() == 2);
+                springInfos2[traverseSpringIndex].SuperTriangles2.push_back(springInfos2[s].SuperTriangles2[0]);
+                springInfos2[traverseSpringIndex].SuperTriangles2.push_back(springInfos2[s].SuperTriangles2[1]);
+                assert(springInfos2[traverseSpringIndex].SuperTriangles2.size() == 2);
 
                 // Tell the triangles about this new sub spring of theirs
-                triangle1.SubSprings2.push_back(traverseSpringIt->second);
-                triangle2.SubSprings2.push_back(traverseSpringIt->second);
+                triangle1.SubSprings2.push_back(traverseSpringIndex);
+                triangle2.SubSprings2.push_back(traverseSpringIndex);
             }
         }
     }
@@ -1201,6 +1497,9 @@ Physics::Springs ShipBuilder::CreateSprings(
             false); // Not owner
     }
 
+    // Partition springs for the parallel calculation of spring forces
+    springs.UpdateParallelForceBatches(points);
+
     return springs;
 }
 
@@ -1229,6 +1528,44 @@ Physics::Triangles ShipBuilder::CreateTriangles(
     return triangles;
 }
 
+ShipProxyLattice ShipBuilder::CreateProxyLattice(
+    Physics::Points const & points,
+    Physics::Springs const & springs)
+{
+    std::vector<vec2f> pointRestPositions;
+    std::vector<float> pointMasses;
+    std::vector<float> pointWaterVolumeFills;
+    pointRestPositions.reserve(points.GetShipPointCount());
+    pointMasses.reserve(points.GetShipPointCount());
+    pointWaterVolumeFills.reserve(points.GetShipPointCount());
+
+    for (auto pointIndex : points.NonEphemeralPoints())
+    {
+        pointRestPositions.push_back(points.GetPosition(pointIndex));
+        pointMasses.push_back(points.GetAugmentedStructuralMass(pointIndex));
+        pointWaterVolumeFills.push_back(points.GetWaterVolumeFill(pointIndex));
+    }
+
+    std::vector<std::pair<ElementIndex, ElementIndex>> springEndpoints;
+    std::vector<float> springStiffnesses;
+    springEndpoints.reserve(springs.GetElementCount());
+    springStiffnesses.reserve(springs.GetElementCount());
+
+    for (auto springIndex : springs)
+    {
+        springEndpoints.emplace_back(springs.GetEndpointAIndex(springIndex), springs.GetEndpointBIndex(springIndex));
+        springStiffnesses.push_back(springs.GetStiffness(springIndex));
+    }
+
+    return ShipProxyLattice::Build(
+        ShipProxyLattice::DefaultBlockSize,
+        pointRestPositions,
+        pointMasses,
+        pointWaterVolumeFills,
+        springEndpoints,
+        springStiffnesses);
+}
+
 ElectricalElements ShipBuilder::CreateElectricalElements(
     Physics::Points const & points,
     Physics::World & parentWorld,
@@ -1520,6 +1857,39 @@ float ShipBuilder::CalculateACMR(std::vector<SpringInfo> const & springInfos)
     return cacheMisses / static_cast<float>(springInfos.size());
 }
 
+float ShipBuilder::CalculateSpringACMR(
+    Physics::Springs const & springs,
+    std::vector<ElementIndex> const & springIndices)
+{
+    //
+    // Calculate the average cache miss ratio
+    //
+
+    if (springIndices.empty())
+    {
+        return 0.0f;
+    }
+
+    TestLRUVertexCache<VertexCacheSize> cache;
+
+    float cacheMisses = 0.0f;
+
+    for (auto springIndex : springIndices)
+    {
+        if (!cache.UseVertex(springs.GetEndpointAIndex(springIndex)))
+        {
+            cacheMisses += 1.0f;
+        }
+
+        if (!cache.UseVertex(springs.GetEndpointBIndex(springIndex)))
+        {
+            cacheMisses += 1.0f;
+        }
+    }
+
+    return cacheMisses / static_cast<float>(springIndices.size());
+}
+
 float ShipBuilder::CalculateACMR(std::vector<TriangleInfo> const & triangleInfos)
 {
     //
@@ -11,14 +11,17 @@
 #include "ShipDefinition.h"
 
 #include <GameCore/FixedSizeVector.h>
+#include <GameCore/GameException.h>
 #include <GameCore/ImageSize.h>
 
 #include <algorithm>
+#include <cassert>
 #include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 /*
@@ -28,16 +31,91 @@ class ShipBuilder
 {
 public:
 
+    /*
+     * Builds the ship, consuming the structural, ropes and electrical layers of its definition:
+     * each layer's pixels are released as soon as they have been visited for the last time,
+     * well before the bulk of the ship's elements get allocated. The sizes of the layers, the
+     * texture layer, and the metadata are left untouched.
+     */
     static std::unique_ptr<Physics::Ship> Create(
         ShipId shipId,
         Physics::World & parentWorld,
         std::shared_ptr<IGameEventHandler> gameEventHandler,
-        ShipDefinition const & shipDefinition,
+        ShipDefinition & shipDefinition,
         MaterialDatabase const & materialDatabase,
         GameParameters const & gameParameters);
 
+    /*
+     * Calculates the average cache miss ratio of visiting the endpoints of the specified springs,
+     * in the specified order.
+     */
+    static float CalculateSpringACMR(
+        Physics::Springs const & springs,
+        std::vector<ElementIndex> const & springIndices);
+
 private:
 
+    /*
+     * The indices of the points at each pixel of the structural layer, in a single
+     * row-major allocation with a one-cell border of no-points all around it, so that
+     * neighbors may be looked up without checking for boundaries.
+     *
+     * Coordinates include the border, i.e. pixel (0, 0) of the image is at (1, 1).
+     */
+    class PointIndexMatrix
+    {
+    public:
+
+        PointIndexMatrix(
+            int width,
+            int height)
+            : mPaddedWidth(width + 2)
+            , mPaddedHeight(height + 2)
+            , mIndices(static_cast<size_t>(mPaddedWidth) * static_cast<size_t>(mPaddedHeight), NoneElementIndex)
+        {
+        }
+
+        inline bool HasPoint(
+            int x,
+            int y) const
+        {
+            return mIndices[MakeIndex(x, y)] != NoneElementIndex;
+        }
+
+        inline ElementIndex Get(
+            int x,
+            int y) const
+        {
+            assert(HasPoint(x, y));
+            return mIndices[MakeIndex(x, y)];
+        }
+
+        inline void Set(
+            int x,
+            int y,
+            ElementIndex pointIndex)
+        {
+            assert(pointIndex != NoneElementIndex);
+            mIndices[MakeIndex(x, y)] = pointIndex;
+        }
+
+    private:
+
+        inline size_t MakeIndex(
+            int x,
+            int y) const
+        {
+            assert(x >= 0 && x < mPaddedWidth);
+            assert(y >= 0 && y < mPaddedHeight);
+
+            return static_cast<size_t>(x) + static_cast<size_t>(y) * static_cast<size_t>(mPaddedWidth);
+        }
+
+        int const mPaddedWidth;
+        int const mPaddedHeight;
+        std::vector<ElementIndex> mIndices;
+    };
+
     struct PointInfo
     {
         vec2f Position;
@@ -197,11 +275,23 @@ private:
             textureDy + static_cast<float>(y) / static_cast<float>(imageSize.Height));
     }
 
+    static void CheckElementCount(
+        size_t elementCount,
+        std::string const & elementName)
+    {
+        if (elementCount > MaxElementCount)
+        {
+            throw GameException(
+                "The ship has too many " + elementName + " (" + std::to_string(elementCount) + "); at most "
+                + std::to_string(MaxElementCount) + " are supported by this build");
+        }
+    }
+
     static void AppendRopeEndpoints(
         RgbImageData const & ropeLayerImage,
         std::map<MaterialDatabase::ColorKey, RopeSegment> & ropeSegments,
         std::vector<PointInfo> & pointInfos1,
-        std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> & pointIndexMatrix,
+        PointIndexMatrix & pointIndexMatrix,
         MaterialDatabase const & materialDatabase,
         vec2f const & shipOffset);
 
@@ -209,7 +299,7 @@ private:
         RgbImageData const & layerImage,
         std::vector<PointInfo> & pointInfos1,
         bool isDedicatedElectricalLayer,
-        std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> const & pointIndexMatrix,
+        PointIndexMatrix const & pointIndexMatrix,
         MaterialDatabase const & materialDatabase);
 
     static void AppendRopes(
@@ -220,17 +310,27 @@ private:
         std::vector<SpringInfo> & springInfos1);
 
     static void CreateShipElementInfos(
-        std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> const & pointIndexMatrix,
+        PointIndexMatrix const & pointIndexMatrix,
         ImageSize const & structureImageSize,
         std::vector<PointInfo> & pointInfos1,
         std::vector<SpringInfo> & springInfos1,
         std::vector<TriangleInfo> & triangleInfos1,
         size_t & leakingPointsCount);
 
+    static void CreateShipElementInfos(
+        PointIndexMatrix const & pointIndexMatrix,
+        ImageSize const & structureImageSize,
+        int startY,
+        int endY,
+        std::vector<PointInfo> & pointInfos1,
+        std::vector<SpringInfo> & springInfos1,
+        std::vector<TriangleInfo> & triangleInfos1,
+        size_t & leakingPointsCount);
+
     template <int BlockSize>
     static std::vector<SpringInfo> ReorderSpringsOptimally_Tiling(
         std::vector<SpringInfo> const & springInfos1,
-        std::unique_ptr<std::unique_ptr<std::optional<ElementIndex>[]>[]> const & pointIndexMatrix,
+        PointIndexMatrix const & pointIndexMatrix,
         ImageSize const & structureImageSize,
         std::vector<PointInfo> const & pointInfos1);
 
@@ -256,6 +356,7 @@ private:
         std::vector<SpringInfo> const & springInfos2);
 
     static void ConnectSpringsAndTriangles(
+        size_t pointCount,
         std::vector<SpringInfo> & springInfos2,
         std::vector<TriangleInfo> & triangleInfos2);
 
@@ -277,6 +378,10 @@ private:
         Physics::World & parentWorld,
         std::shared_ptr<IGameEventHandler> gameEventHandler);
 
+    static Physics::ShipProxyLattice CreateProxyLattice(
+        Physics::Points const & points,
+        Physics::Springs const & springs);
+
 private:
 
     /////////////////////////////////////////////////////////////////
@@ -8,13 +8,97 @@
 #include "ImageFileTools.h"
 #include "ShipDefinitionFile.h"
 
+#include <GameCore/BinaryFileTools.h>
+#include <GameCore/GameException.h>
+#include <GameCore/Log.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace /* anonymous */ {
+
+    // Bump whenever the layout of the file - or the way images are loaded - changes
+    static constexpr char CookedShipMagic[4] = { 'F', 'S', 'C', 'S' };
+    static constexpr std::uint32_t CookedShipVersion = 1;
+
+    // The number of cooked ships we keep around; the least recently cooked go first
+    static constexpr size_t MaxCookedShipCacheFiles = 16;
+
+    /*
+     * Hashes the content of all the files a ship is made of.
+     */
+    std::uint64_t HashShipSourceFiles(std::vector<std::filesystem::path> const & filePaths)
+    {
+        std::uint64_t hash = BinaryFileTools::HashSeed;
+
+        for (auto const & filePath : filePaths)
+        {
+            std::ifstream file(filePath.string(), std::ios::binary | std::ios::in);
+            if (!file.is_open())
+            {
+                throw GameException("Cannot open file \"" + filePath.string() + "\"");
+            }
+
+            std::vector<char> const content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            hash = BinaryFileTools::Hash(content.data(), content.size(), hash);
+
+            // Separator, so that moving bytes between files changes the hash
+            std::uint8_t const separator = 0xff;
+            hash = BinaryFileTools::Hash(&separator, 1, hash);
+        }
+
+        return hash;
+    }
+
+    void TrimCookedShipCache(std::filesystem::path const & folderPath)
+    {
+        std::error_code ec;
+
+        std::vector<std::filesystem::directory_entry> entries;
+        for (auto const & entry : std::filesystem::directory_iterator(folderPath, ec))
+        {
+            if (entry.is_regular_file(ec) && entry.path().extension() == ".bin")
+                entries.push_back(entry);
+        }
+
+        if (entries.size() < MaxCookedShipCacheFiles)
+            return;
+
+        std::sort(
+            entries.begin(),
+            entries.end(),
+            [&ec](auto const & l, auto const & r)
+            {
+                return l.last_write_time(ec) < r.last_write_time(ec);
+            });
+
+        // Make room for one more
+        for (size_t e = 0; e <= entries.size() - MaxCookedShipCacheFiles; ++e)
+        {
+            std::filesystem::remove(entries[e].path(), ec);
+        }
+    }
+}
+
+std::optional<std::filesystem::path> ShipDefinition::CookedShipCacheFolderPath;
+
+void ShipDefinition::SetCookedShipCacheFolderPath(std::filesystem::path const & folderPath)
+{
+    CookedShipCacheFolderPath = folderPath;
+}
 
 ShipDefinition ShipDefinition::Load(std::filesystem::path const & filepath)
 {
     std::filesystem::path absoluteStructuralLayerImageFilePath;
-    std::optional<RgbImageData> ropesLayerImage;
-    std::optional<RgbImageData> electricalLayerImage;
+    std::optional<std::filesystem::path> absoluteRopesLayerImageFilePath;
+    std::optional<std::filesystem::path> absoluteElectricalLayerImageFilePath;
     std::filesystem::path absoluteTextureLayerImageFilePath;
     ShipDefinition::TextureOriginType textureOrigin;
     std::optional<ShipMetadata> shipMetadata;
@@ -38,14 +122,12 @@ ShipDefinition ShipDefinition::Load(std::filesystem::path const & filepath)
 
         if (!!sdf.RopesLayerImageFilePath)
         {
-            ropesLayerImage.emplace(
-                ImageFileTools::LoadImageRgbUpperLeft(basePath / *sdf.RopesLayerImageFilePath));
+            absoluteRopesLayerImageFilePath = basePath / *sdf.RopesLayerImageFilePath;
         }
 
         if (!!sdf.ElectricalLayerImageFilePath)
         {
-            electricalLayerImage.emplace(
-                ImageFileTools::LoadImageRgbUpperLeft(basePath / *sdf.ElectricalLayerImageFilePath));
+            absoluteElectricalLayerImageFilePath = basePath / *sdf.ElectricalLayerImageFilePath;
         }
 
         if (!!sdf.TextureLayerImageFilePath)
@@ -87,6 +169,62 @@ ShipDefinition ShipDefinition::Load(std::filesystem::path const & filepath)
 
     assert(!!shipMetadata);
 
+    //
+    // Check whether we have cooked this very ship already
+    //
+
+    std::optional<std::filesystem::path> cookedShipFilePath;
+
+    if (!!CookedShipCacheFolderPath)
+    {
+        // The definition file, if any, also covers the metadata
+        std::vector<std::filesystem::path> sourceFilePaths;
+        sourceFilePaths.push_back(filepath);
+        sourceFilePaths.push_back(absoluteStructuralLayerImageFilePath);
+        if (!!absoluteRopesLayerImageFilePath)
+            sourceFilePaths.push_back(*absoluteRopesLayerImageFilePath);
+        if (!!absoluteElectricalLayerImageFilePath)
+            sourceFilePaths.push_back(*absoluteElectricalLayerImageFilePath);
+        sourceFilePaths.push_back(absoluteTextureLayerImageFilePath);
+
+        std::ostringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << HashShipSourceFiles(sourceFilePaths) << ".bin";
+        cookedShipFilePath = *CookedShipCacheFolderPath / ss.str();
+
+        if (std::filesystem::exists(*cookedShipFilePath))
+        {
+            try
+            {
+                return Deserialize(*cookedShipFilePath, *shipMetadata);
+            }
+            catch (GameException const & ex)
+            {
+                LogMessage("Discarding cooked ship \"", cookedShipFilePath->string(), "\": ", ex.what());
+
+                std::error_code ec;
+                std::filesystem::remove(*cookedShipFilePath, ec);
+            }
+        }
+    }
+
+    //
+    // Load ropes and electrical images
+    //
+
+    std::optional<RgbImageData> ropesLayerImage;
+    if (!!absoluteRopesLayerImageFilePath)
+    {
+        ropesLayerImage.emplace(
+            ImageFileTools::LoadImageRgbUpperLeft(*absoluteRopesLayerImageFilePath));
+    }
+
+    std::optional<RgbImageData> electricalLayerImage;
+    if (!!absoluteElectricalLayerImageFilePath)
+    {
+        electricalLayerImage.emplace(
+            ImageFileTools::LoadImageRgbUpperLeft(*absoluteElectricalLayerImageFilePath));
+    }
+
     //
     // Load structural image
     //
@@ -131,11 +269,167 @@ ShipDefinition ShipDefinition::Load(std::filesystem::path const & filepath)
 
     assert(!!textureImage);
 
-    return ShipDefinition(
+    ShipDefinition shipDefinition(
         std::move(structuralImage),
         std::move(ropesLayerImage),
         std::move(electricalLayerImage),
         std::move(*textureImage),
         textureOrigin,
         *shipMetadata);
-}
\ No newline at end of file
+
+    //
+    // Cook it for next time; failing at this is no reason to fail the load
+    //
+
+    if (!!cookedShipFilePath)
+    {
+        try
+        {
+            shipDefinition.Serialize(*cookedShipFilePath);
+        }
+        catch (GameException const & ex)
+        {
+            LogMessage("Cannot cook ship \"", cookedShipFilePath->string(), "\": ", ex.what());
+
+            std::error_code ec;
+            std::filesystem::remove(*cookedShipFilePath, ec);
+        }
+    }
+
+    return shipDefinition;
+}
+
+void ShipDefinition::Serialize(std::filesystem::path const & outputFilePath) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(outputFilePath.parent_path(), ec);
+
+    TrimCookedShipCache(outputFilePath.parent_path());
+
+    std::ofstream file(outputFilePath.string(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw GameException("Cannot open file \"" + outputFilePath.string() + "\" for writing");
+    }
+
+    //
+    // Header
+    //
+
+    file.write(CookedShipMagic, sizeof(CookedShipMagic));
+    BinaryFileTools::Write<std::uint32_t>(file, CookedShipVersion);
+
+    //
+    // Metadata
+    //
+
+    BinaryFileTools::WriteString(file, Metadata.ShipName);
+    BinaryFileTools::WriteOptionalString(file, Metadata.Author);
+    BinaryFileTools::WriteOptionalString(file, Metadata.YearBuilt);
+    BinaryFileTools::WriteOptionalString(file, Metadata.Description);
+    BinaryFileTools::Write<float>(file, Metadata.Offset.x);
+    BinaryFileTools::Write<float>(file, Metadata.Offset.y);
+
+    //
+    // Layers
+    //
+
+    BinaryFileTools::Write<std::uint8_t>(file, static_cast<std::uint8_t>(TextureOrigin));
+
+    BinaryFileTools::WriteImage(file, StructuralLayerImage);
+
+    BinaryFileTools::Write<std::uint8_t>(file, !!RopesLayerImage ? 1 : 0);
+    if (!!RopesLayerImage)
+        BinaryFileTools::WriteImage(file, *RopesLayerImage);
+
+    BinaryFileTools::Write<std::uint8_t>(file, !!ElectricalLayerImage ? 1 : 0);
+    if (!!ElectricalLayerImage)
+        BinaryFileTools::WriteImage(file, *ElectricalLayerImage);
+
+    BinaryFileTools::WriteImage(file, TextureLayerImage);
+
+    if (!file.good())
+    {
+        throw GameException("Error writing file \"" + outputFilePath.string() + "\"");
+    }
+}
+
+ShipDefinition ShipDefinition::Deserialize(
+    std::filesystem::path const & inputFilePath,
+    ShipMetadata const & sourceMetadata)
+{
+    std::ifstream file(inputFilePath.string(), std::ios::binary | std::ios::in);
+    if (!file.is_open())
+    {
+        throw GameException("Cannot open file \"" + inputFilePath.string() + "\"");
+    }
+
+    //
+    // Header
+    //
+
+    char magic[sizeof(CookedShipMagic)];
+    file.read(magic, sizeof(magic));
+    if (!file.good() || 0 != std::memcmp(magic, CookedShipMagic, sizeof(magic)))
+    {
+        throw GameException("File \"" + inputFilePath.string() + "\" is not a cooked ship file");
+    }
+
+    if (BinaryFileTools::Read<std::uint32_t>(file) != CookedShipVersion)
+    {
+        throw GameException("File \"" + inputFilePath.string() + "\" is a cooked ship file of an unsupported version");
+    }
+
+    //
+    // Metadata
+    //
+
+    std::string shipName = BinaryFileTools::ReadString(file);
+    std::optional<std::string> author = BinaryFileTools::ReadOptionalString(file);
+    std::optional<std::string> yearBuilt = BinaryFileTools::ReadOptionalString(file);
+    std::optional<std::string> description = BinaryFileTools::ReadOptionalString(file);
+    float const offsetX = BinaryFileTools::Read<float>(file);
+    float const offsetY = BinaryFileTools::Read<float>(file);
+
+    // The name of a bare image comes from its file name, which is not part of the key
+    if (shipName != sourceMetadata.ShipName)
+    {
+        throw GameException("Cooked ship file \"" + inputFilePath.string() + "\" is for a different ship");
+    }
+
+    //
+    // Layers
+    //
+
+    auto const textureOrigin = static_cast<TextureOriginType>(BinaryFileTools::Read<std::uint8_t>(file));
+
+    RgbImageData structuralLayerImage = BinaryFileTools::ReadImage<rgbColor>(file);
+
+    std::optional<RgbImageData> ropesLayerImage;
+    if (BinaryFileTools::Read<std::uint8_t>(file) != 0)
+        ropesLayerImage.emplace(BinaryFileTools::ReadImage<rgbColor>(file));
+
+    std::optional<RgbImageData> electricalLayerImage;
+    if (BinaryFileTools::Read<std::uint8_t>(file) != 0)
+        electricalLayerImage.emplace(BinaryFileTools::ReadImage<rgbColor>(file));
+
+    RgbaImageData textureLayerImage = BinaryFileTools::ReadImage<rgbaColor>(file);
+
+    if (!file.good())
+    {
+        throw GameException("Cooked ship file \"" + inputFilePath.string() + "\" is truncated");
+    }
+
+    return ShipDefinition(
+        std::move(structuralLayerImage),
+        std::move(ropesLayerImage),
+        std::move(electricalLayerImage),
+        std::move(textureLayerImage),
+        textureOrigin,
+        ShipMetadata(
+            std::move(shipName),
+            std::move(author),
+            std::move(yearBuilt),
+            std::move(description),
+            vec2f(offsetX, offsetY)));
+}
@@ -17,6 +17,9 @@
 
 /*
 * The complete definition of a ship.
+*
+* Building the ship consumes the structural, ropes and electrical layers - only their
+* sizes survive it.
 */
 struct ShipDefinition
 {
@@ -43,10 +46,28 @@ public:
 
     ShipMetadata const Metadata;
 
+    /*
+     * Loads the ship from the specified file, which may be either a ship definition file
+     * or a structural layer image.
+     *
+     * When a cooked ship cache folder has been set, the decoded layers are stored there -
+     * keyed by the content of all the files the ship is made of - and re-used as long as
+     * those files don't change, sparing image decoding and magnification on reloads.
+     */
     static ShipDefinition Load(std::filesystem::path const & filepath);
 
+    static void SetCookedShipCacheFolderPath(std::filesystem::path const & folderPath);
+
 private:
 
+    void Serialize(std::filesystem::path const & outputFilePath) const;
+
+    static ShipDefinition Deserialize(
+        std::filesystem::path const & inputFilePath,
+        ShipMetadata const & sourceMetadata);
+
+    static std::optional<std::filesystem::path> CookedShipCacheFolderPath;
+
     ShipDefinition(
         RgbImageData structuralLayerImage,
         std::optional<RgbImageData> ropesLayerImage,
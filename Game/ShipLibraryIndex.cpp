@@ -0,0 +1,464 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-07
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "ShipLibraryIndex.h"
+
+#include "ShipDefinitionFile.h"
+#include "ShipPreview.h"
+
+#include <GameCore/BinaryFileTools.h>
+#include <GameCore/FloatingPoint.h>
+#include <GameCore/Log.h>
+#include <GameCore/TraceLog.h>
+#include <GameCore/Utils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace /* anonymous */ {
+
+    // Bump whenever the layout of the file changes
+    static constexpr char LibraryIndexMagic[4] = { 'F', 'S', 'L', 'I' };
+    static constexpr std::uint32_t LibraryIndexVersion = 1;
+}
+
+std::optional<std::filesystem::path> ShipLibraryIndex::IndexFilePath;
+
+ShipLibraryIndex::Entry::Entry(
+    std::filesystem::path shipFilepath,
+    std::string shipName,
+    std::optional<std::string> author,
+    ImageSize const & structureSize,
+    ShipPreviewDirectoryCache::FileKey const & key)
+    : ShipFilepath(std::move(shipFilepath))
+    , ShipName(std::move(shipName))
+    , Author(std::move(author))
+    , StructureSize(structureSize)
+    , Key(key)
+    , SearchText()
+{
+    SearchText = Utils::ToLower(ShipName + '\n' + Author.value_or("") + '\n' + ShipFilepath.filename().string());
+}
+
+void ShipLibraryIndex::SetIndexFilePath(std::filesystem::path const & indexFilePath)
+{
+    IndexFilePath = indexFilePath;
+}
+
+bool ShipLibraryIndex::IsShipFile(std::filesystem::path const & filepath)
+{
+    return std::filesystem::is_regular_file(filepath)
+        && (filepath.extension().string() == ".png" || ShipDefinitionFile::IsShipDefinitionFile(filepath));
+}
+
+ShipLibraryIndex::ShipLibraryIndex(ImageSize const & maxPreviewSize)
+    : mMaxPreviewSize(maxPreviewSize)
+    , mDirectories()
+    , mIsDirty(false)
+    , mMutex()
+    , mRefreshThread()
+    , mIsRefreshStopRequested(false)
+{
+    Load();
+}
+
+ShipLibraryIndex::~ShipLibraryIndex()
+{
+    StopRefresh();
+}
+
+void ShipLibraryIndex::StartRefresh(
+    std::vector<std::filesystem::path> const & directoryPaths,
+    std::function<void()> onDirectoryRefreshed)
+{
+    StopRefresh();
+
+    mIsRefreshStopRequested = false;
+
+    mRefreshThread = std::thread(
+        &ShipLibraryIndex::RunRefresh,
+        this,
+        directoryPaths,
+        std::move(onDirectoryRefreshed));
+}
+
+void ShipLibraryIndex::StopRefresh()
+{
+    if (mRefreshThread.joinable())
+    {
+        mIsRefreshStopRequested = true;
+        mRefreshThread.join();
+    }
+}
+
+std::vector<ShipLibraryIndex::Entry> ShipLibraryIndex::Search(
+    std::string const & query,
+    size_t maxResults) const
+{
+    std::vector<std::string> words;
+    {
+        std::istringstream ss(Utils::ToLower(query));
+        std::string word;
+        while (ss >> word)
+            words.push_back(word);
+    }
+
+    std::vector<Entry> results;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (auto const & directory : mDirectories)
+        {
+            for (auto const & entry : directory.second)
+            {
+                bool const isMatch = std::all_of(
+                    words.cbegin(),
+                    words.cend(),
+                    [&entry](std::string const & word)
+                    {
+                        return entry.SearchText.find(word) != std::string::npos;
+                    });
+
+                if (isMatch)
+                    results.push_back(entry);
+            }
+        }
+    }
+
+    std::sort(
+        results.begin(),
+        results.end(),
+        [](Entry const & a, Entry const & b)
+        {
+            return a.SearchText < b.SearchText;
+        });
+
+    if (results.size() > maxResults)
+        results.erase(results.begin() + maxResults, results.end());
+
+    return results;
+}
+
+void ShipLibraryIndex::RunRefresh(
+    std::vector<std::filesystem::path> directoryPaths,
+    std::function<void()> onDirectoryRefreshed)
+{
+    LogMessage("ShipLibraryIndex::RunRefresh: ", directoryPaths.size(), " directories");
+
+    TraceLog::GetInstance().SetCurrentThreadName("Ship Library Index");
+
+    // Previews are built by the same code as ships are
+    InitializeSimulationThreadFloatingPoint();
+
+    //
+    // Forget the directories we're not asked for anymore
+    //
+
+    {
+        std::vector<std::string> directoryKeys;
+        for (auto const & directoryPath : directoryPaths)
+            directoryKeys.push_back(MakeDirectoryKey(directoryPath));
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (auto it = mDirectories.begin(); it != mDirectories.end(); )
+        {
+            if (std::find(directoryKeys.cbegin(), directoryKeys.cend(), it->first) == directoryKeys.cend())
+            {
+                it = mDirectories.erase(it);
+                mIsDirty = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    //
+    // Refresh the directories, one at a time
+    //
+
+    for (auto const & directoryPath : directoryPaths)
+    {
+        if (mIsRefreshStopRequested)
+            break;
+
+        try
+        {
+            if (RefreshDirectory(directoryPath))
+            {
+                onDirectoryRefreshed();
+            }
+        }
+        catch (std::exception const & ex)
+        {
+            LogMessage("Error indexing directory \"", directoryPath.string(), "\": ", ex.what());
+        }
+    }
+
+    // Remember what we've got so far, even if interrupted
+    Save();
+}
+
+bool ShipLibraryIndex::RefreshDirectory(std::filesystem::path const & directoryPath)
+{
+    std::string const directoryKey = MakeDirectoryKey(directoryPath);
+
+    //
+    // Get the ships we know of
+    //
+
+    std::unordered_map<std::string, Entry> oldEntries;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto const it = mDirectories.find(directoryKey);
+        if (it != mDirectories.end())
+        {
+            for (auto const & entry : it->second)
+                oldEntries.emplace(entry.ShipFilepath.filename().string(), entry);
+        }
+    }
+
+    //
+    // Visit the ships that are there now, only looking into those that have changed
+    //
+
+    std::vector<Entry> newEntries;
+    bool hasChanged = false;
+
+    // Only loaded when a ship has changed
+    std::optional<ShipPreviewDirectoryCache> previewCache;
+
+    std::error_code ec;
+    for (auto const & entryIt : std::filesystem::directory_iterator(directoryPath, ec))
+    {
+        if (mIsRefreshStopRequested)
+            break;
+
+        auto const shipFilepath = entryIt.path();
+
+        try
+        {
+            if (!IsShipFile(shipFilepath))
+                continue;
+
+            auto const key = ShipPreviewDirectoryCache::FileKey::Create(shipFilepath);
+            if (!key)
+                continue;
+
+            auto const oldEntryIt = oldEntries.find(shipFilepath.filename().string());
+            if (oldEntryIt != oldEntries.end() && oldEntryIt->second.Key == *key)
+            {
+                // Unchanged
+                newEntries.push_back(oldEntryIt->second);
+                continue;
+            }
+
+            if (!previewCache)
+                previewCache.emplace(ShipPreviewDirectoryCache::Load(directoryPath, mMaxPreviewSize));
+
+            auto shipPreview = previewCache->TryGet(shipFilepath);
+            if (!shipPreview)
+            {
+                shipPreview.emplace(ShipPreview::Load(shipFilepath, mMaxPreviewSize));
+                previewCache->Put(shipFilepath, *shipPreview);
+            }
+
+            newEntries.emplace_back(
+                shipFilepath,
+                shipPreview->Metadata.ShipName,
+                shipPreview->Metadata.Author,
+                shipPreview->OriginalSize,
+                *key);
+
+            hasChanged = true;
+        }
+        catch (std::exception const & ex)
+        {
+            // Ignore this ship
+            LogMessage("Cannot index ship \"", shipFilepath.string(), "\": ", ex.what());
+        }
+    }
+
+    if (!!previewCache)
+        previewCache->Save();
+
+    if (mIsRefreshStopRequested)
+    {
+        // Keep the directory as it was, rather than a part of it
+        return false;
+    }
+
+    hasChanged |= (newEntries.size() != oldEntries.size());
+    if (!hasChanged)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mDirectories[directoryKey] = std::move(newEntries);
+        mIsDirty = true;
+    }
+
+    return true;
+}
+
+std::string ShipLibraryIndex::MakeDirectoryKey(std::filesystem::path const & directoryPath)
+{
+    std::error_code ec;
+    std::filesystem::path absoluteDirectoryPath = std::filesystem::absolute(directoryPath, ec);
+    if (ec)
+        absoluteDirectoryPath = directoryPath;
+
+    return absoluteDirectoryPath.lexically_normal().string();
+}
+
+void ShipLibraryIndex::Load()
+{
+    if (!IndexFilePath)
+    {
+        // Persistence is disabled
+        return;
+    }
+
+    std::ifstream file(IndexFilePath->string(), std::ios::binary | std::ios::in);
+    if (!file.is_open())
+        return;
+
+    try
+    {
+        char magic[sizeof(LibraryIndexMagic)];
+        file.read(magic, sizeof(magic));
+        if (!file.good()
+            || 0 != std::memcmp(magic, LibraryIndexMagic, sizeof(magic))
+            || BinaryFileTools::Read<std::uint32_t>(file) != LibraryIndexVersion)
+        {
+            // Not for us, will be overwritten
+            return;
+        }
+
+        std::uint32_t const directoryCount = BinaryFileTools::Read<std::uint32_t>(file);
+        for (std::uint32_t d = 0; d < directoryCount && file.good(); ++d)
+        {
+            std::string directoryKey = BinaryFileTools::ReadString(file);
+            std::filesystem::path const directoryPath(directoryKey);
+
+            std::vector<Entry> entries;
+
+            std::uint32_t const entryCount = BinaryFileTools::Read<std::uint32_t>(file);
+            for (std::uint32_t e = 0; e < entryCount && file.good(); ++e)
+            {
+                std::string shipFilename = BinaryFileTools::ReadString(file);
+
+                ShipPreviewDirectoryCache::FileKey key;
+                key.FileSize = BinaryFileTools::Read<std::uint64_t>(file);
+                key.LastWriteTime = BinaryFileTools::Read<std::int64_t>(file);
+
+                std::string shipName = BinaryFileTools::ReadString(file);
+                std::optional<std::string> author = BinaryFileTools::ReadOptionalString(file);
+                int const structureWidth = BinaryFileTools::Read<std::int32_t>(file);
+                int const structureHeight = BinaryFileTools::Read<std::int32_t>(file);
+
+                if (!file.good())
+                    break;
+
+                entries.emplace_back(
+                    directoryPath / shipFilename,
+                    std::move(shipName),
+                    std::move(author),
+                    ImageSize(structureWidth, structureHeight),
+                    key);
+            }
+
+            if (!file.good())
+                break;
+
+            mDirectories.emplace(std::move(directoryKey), std::move(entries));
+        }
+    }
+    catch (std::exception const & ex)
+    {
+        LogMessage("Ignoring ship library index \"", IndexFilePath->string(), "\": ", ex.what());
+        mDirectories.clear();
+    }
+}
+
+void ShipLibraryIndex::Save()
+{
+    if (!IndexFilePath)
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (!mIsDirty)
+        return;
+
+    //
+    // Write to a temporary file first, so that we never leave a partial index behind
+    //
+
+    std::error_code ec;
+    std::filesystem::create_directories(IndexFilePath->parent_path(), ec);
+
+    std::filesystem::path tempFilePath = *IndexFilePath;
+    tempFilePath += ".tmp";
+
+    {
+        std::ofstream file(tempFilePath.string(), std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LogMessage("Cannot write ship library index \"", tempFilePath.string(), "\"");
+            return;
+        }
+
+        file.write(LibraryIndexMagic, sizeof(LibraryIndexMagic));
+        BinaryFileTools::Write<std::uint32_t>(file, LibraryIndexVersion);
+
+        BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(mDirectories.size()));
+        for (auto const & directory : mDirectories)
+        {
+            BinaryFileTools::WriteString(file, directory.first);
+
+            BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(directory.second.size()));
+            for (auto const & entry : directory.second)
+            {
+                BinaryFileTools::WriteString(file, entry.ShipFilepath.filename().string());
+
+                BinaryFileTools::Write<std::uint64_t>(file, entry.Key.FileSize);
+                BinaryFileTools::Write<std::int64_t>(file, entry.Key.LastWriteTime);
+
+                BinaryFileTools::WriteString(file, entry.ShipName);
+                BinaryFileTools::WriteOptionalString(file, entry.Author);
+                BinaryFileTools::Write<std::int32_t>(file, entry.StructureSize.Width);
+                BinaryFileTools::Write<std::int32_t>(file, entry.StructureSize.Height);
+            }
+        }
+
+        if (!file.good())
+        {
+            LogMessage("Error writing ship library index \"", tempFilePath.string(), "\"");
+            file.close();
+            std::filesystem::remove(tempFilePath, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempFilePath, *IndexFilePath, ec);
+    if (ec)
+    {
+        LogMessage("Cannot write ship library index \"", IndexFilePath->string(), "\": ", ec.message());
+        std::filesystem::remove(tempFilePath, ec);
+        return;
+    }
+
+    mIsDirty = false;
+}
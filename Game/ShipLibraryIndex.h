@@ -0,0 +1,116 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-07
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "ShipPreviewDirectoryCache.h"
+
+#include <GameCore/ImageSize.h>
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * An on-disk index of all the ships in a set of directories - typically the recent
+ * ship directories - which may be searched in memory at once.
+ *
+ * The index is refreshed in the background, one directory at a time: ships whose file
+ * hasn't changed since they were indexed are kept as they are, while the others are
+ * indexed from the previews in the directory's preview cache, making the previews
+ * when missing.
+ *
+ * Searches may be made while the index is being refreshed.
+ */
+class ShipLibraryIndex
+{
+public:
+
+    struct Entry
+    {
+        std::filesystem::path ShipFilepath;
+        std::string ShipName;
+        std::optional<std::string> Author;
+        ImageSize StructureSize;
+        ShipPreviewDirectoryCache::FileKey Key;
+
+        // The lowercase name, author, and file name, for searching
+        std::string SearchText;
+
+        Entry(
+            std::filesystem::path shipFilepath,
+            std::string shipName,
+            std::optional<std::string> author,
+            ImageSize const & structureSize,
+            ShipPreviewDirectoryCache::FileKey const & key);
+    };
+
+    static void SetIndexFilePath(std::filesystem::path const & indexFilePath);
+
+    static bool IsShipFile(std::filesystem::path const & filepath);
+
+    /*
+     * Loads the index, if any; previews made while refreshing have the specified maximum size.
+     */
+    explicit ShipLibraryIndex(ImageSize const & maxPreviewSize);
+
+    ~ShipLibraryIndex();
+
+    /*
+     * Starts refreshing the index with the ships in the specified directories, dropping
+     * all other directories; the callback is invoked - on the refresh thread - each time
+     * the ships of a directory have changed.
+     */
+    void StartRefresh(
+        std::vector<std::filesystem::path> const & directoryPaths,
+        std::function<void()> onDirectoryRefreshed);
+
+    /*
+     * Stops the refresh, if any, keeping what has been refreshed so far.
+     */
+    void StopRefresh();
+
+    /*
+     * Returns the ships whose name, author, or file name contain all the space-separated
+     * words of the query, regardless of case, sorted by name.
+     */
+    std::vector<Entry> Search(
+        std::string const & query,
+        size_t maxResults) const;
+
+private:
+
+    void RunRefresh(
+        std::vector<std::filesystem::path> directoryPaths,
+        std::function<void()> onDirectoryRefreshed);
+
+    bool RefreshDirectory(std::filesystem::path const & directoryPath);
+
+    static std::string MakeDirectoryKey(std::filesystem::path const & directoryPath);
+
+    void Load();
+    void Save();
+
+private:
+
+    static std::optional<std::filesystem::path> IndexFilePath;
+
+    ImageSize const mMaxPreviewSize;
+
+    // Normalized directory path -> ships in the directory
+    std::map<std::string, std::vector<Entry>> mDirectories;
+    bool mIsDirty;
+    mutable std::mutex mMutex;
+
+    std::thread mRefreshThread;
+    std::atomic<bool> mIsRefreshStopRequested;
+};
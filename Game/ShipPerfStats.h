@@ -0,0 +1,170 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-11
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameCore/TraceLog.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Physics
+{
+
+/*
+ * How long the phases of the ship updates took in total, since the ship was created.
+ *
+ * Only measured when building with ENABLE_PERF_STATS; otherwise all zeroes.
+ */
+struct ShipPerfStats
+{
+    enum class Phase : size_t
+    {
+        MechanicalDynamics = 0, // Includes the four below
+        PointForces,
+        SpringForces,
+        Integration, // Includes the point forces and sea floor collisions when fused
+        SeaFloorCollisions,
+        Strains,
+        WaterInflow,
+        WaterVelocities,
+        Electrical, // Includes the light
+        Light,
+        ConnectivityVisit,
+        EphemeralParticles,
+        Uploads,
+
+        _Last = Uploads
+    };
+
+    static constexpr size_t PhaseCount = static_cast<size_t>(Phase::_Last) + 1;
+
+    std::array<std::chrono::steady_clock::duration, PhaseCount> Durations;
+
+    // The number of ship updates the durations have been accumulated over
+    std::uint64_t UpdateCount;
+
+    ShipPerfStats()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        Durations.fill(std::chrono::steady_clock::duration::zero());
+        UpdateCount = 0;
+    }
+
+    std::chrono::steady_clock::duration & operator[](Phase phase)
+    {
+        return Durations[static_cast<size_t>(phase)];
+    }
+
+    std::chrono::steady_clock::duration const & operator[](Phase phase) const
+    {
+        return Durations[static_cast<size_t>(phase)];
+    }
+
+    float GetAverageMillis(Phase phase) const
+    {
+        return UpdateCount != 0
+            ? std::chrono::duration<float, std::milli>((*this)[phase]).count() / static_cast<float>(UpdateCount)
+            : 0.0f;
+    }
+
+    static char const * GetPhaseName(Phase phase)
+    {
+        static char const * const Names[PhaseCount] = {
+            "MechanicalDynamics",
+            "PointForces",
+            "SpringForces",
+            "Integration",
+            "SeaFloorCollisions",
+            "Strains",
+            "WaterInflow",
+            "WaterVelocities",
+            "Electrical",
+            "Light",
+            "ConnectivityVisit",
+            "EphemeralParticles",
+            "Uploads"
+        };
+
+        return Names[static_cast<size_t>(phase)];
+    }
+
+    ShipPerfStats & operator+=(ShipPerfStats const & other)
+    {
+        for (size_t p = 0; p < PhaseCount; ++p)
+            Durations[p] += other.Durations[p];
+
+        UpdateCount += other.UpdateCount;
+
+        return *this;
+    }
+
+    ShipPerfStats operator-(ShipPerfStats const & other) const
+    {
+        ShipPerfStats result;
+
+        for (size_t p = 0; p < PhaseCount; ++p)
+            result.Durations[p] = Durations[p] - other.Durations[p];
+
+        result.UpdateCount = UpdateCount - other.UpdateCount;
+
+        return result;
+    }
+};
+
+/*
+ * Adds the time spent in its scope to a phase - and to the trace, while tracing.
+ */
+class ScopedShipPerfTimer
+{
+public:
+
+    ScopedShipPerfTimer(
+        ShipPerfStats & perfStats,
+        ShipPerfStats::Phase phase)
+        : mDuration(perfStats[phase])
+        , mPhase(phase)
+        , mStartTime(std::chrono::steady_clock::now())
+    {}
+
+    ~ScopedShipPerfTimer()
+    {
+        auto const duration = std::chrono::steady_clock::now() - mStartTime;
+
+        mDuration += duration;
+
+        TraceLog::GetInstance().AddEvent(
+            ShipPerfStats::GetPhaseName(mPhase),
+            "ship",
+            mStartTime,
+            duration);
+    }
+
+    ScopedShipPerfTimer(ScopedShipPerfTimer const &) = delete;
+    ScopedShipPerfTimer & operator=(ScopedShipPerfTimer const &) = delete;
+
+private:
+
+    std::chrono::steady_clock::duration & mDuration;
+    ShipPerfStats::Phase const mPhase;
+    std::chrono::steady_clock::time_point const mStartTime;
+};
+
+}
+
+#ifdef ENABLE_PERF_STATS
+#define SHIP_PERF_SCOPE_CONCAT_INNER(a, b) a##b
+#define SHIP_PERF_SCOPE_CONCAT(a, b) SHIP_PERF_SCOPE_CONCAT_INNER(a, b)
+#define SHIP_PERF_SCOPE(perfStats, phase) \
+    ::Physics::ScopedShipPerfTimer const SHIP_PERF_SCOPE_CONCAT(_shipPerfTimer, __LINE__)((perfStats), ::Physics::ShipPerfStats::Phase::phase)
+#else
+#define SHIP_PERF_SCOPE(perfStats, phase)
+#endif
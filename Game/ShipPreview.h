@@ -39,6 +39,8 @@ public:
 
 private:
 
+    friend class ShipPreviewDirectoryCache;
+
     ShipPreview(
         RgbaImageData previewImage,
         ImageSize originalSize,
@@ -0,0 +1,329 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-02
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "ShipPreviewDirectoryCache.h"
+
+#include <GameCore/BinaryFileTools.h>
+#include <GameCore/Log.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace /* anonymous */ {
+
+    // Bump whenever the layout of the file - or the way previews are made - changes
+    static constexpr char PreviewCacheMagic[4] = { 'F', 'S', 'P', 'C' };
+    static constexpr std::uint32_t PreviewCacheVersion = 1;
+}
+
+std::optional<std::filesystem::path> ShipPreviewDirectoryCache::CacheFolderPath;
+
+void ShipPreviewDirectoryCache::SetCacheFolderPath(std::filesystem::path const & folderPath)
+{
+    CacheFolderPath = folderPath;
+}
+
+ShipPreviewDirectoryCache ShipPreviewDirectoryCache::Load(
+    std::filesystem::path const & directoryPath,
+    ImageSize const & maxPreviewSize)
+{
+    if (!CacheFolderPath)
+    {
+        // Caching is disabled
+        return ShipPreviewDirectoryCache(directoryPath, std::string(), std::nullopt, maxPreviewSize);
+    }
+
+    //
+    // The cache file is named after the directory
+    //
+
+    std::error_code ec;
+    std::filesystem::path absoluteDirectoryPath = std::filesystem::absolute(directoryPath, ec);
+    if (ec)
+        absoluteDirectoryPath = directoryPath;
+
+    std::string const directoryPathStr = absoluteDirectoryPath.lexically_normal().generic_string();
+
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0')
+        << BinaryFileTools::Hash(directoryPathStr.data(), directoryPathStr.size())
+        << ".bin";
+
+    ShipPreviewDirectoryCache cache(
+        directoryPath,
+        directoryPathStr,
+        *CacheFolderPath / ss.str(),
+        maxPreviewSize);
+
+    //
+    // Load the cache file, if any
+    //
+
+    std::ifstream file(cache.mCacheFilePath->string(), std::ios::binary | std::ios::in);
+    if (!file.is_open())
+        return cache;
+
+    try
+    {
+        char magic[sizeof(PreviewCacheMagic)];
+        file.read(magic, sizeof(magic));
+        if (!file.good()
+            || 0 != std::memcmp(magic, PreviewCacheMagic, sizeof(magic))
+            || BinaryFileTools::Read<std::uint32_t>(file) != PreviewCacheVersion
+            || BinaryFileTools::ReadString(file) != directoryPathStr
+            || BinaryFileTools::Read<std::int32_t>(file) != maxPreviewSize.Width
+            || BinaryFileTools::Read<std::int32_t>(file) != maxPreviewSize.Height)
+        {
+            // Not for us, will be overwritten
+            return cache;
+        }
+
+        std::uint32_t const entryCount = BinaryFileTools::Read<std::uint32_t>(file);
+        for (std::uint32_t e = 0; e < entryCount && file.good(); ++e)
+        {
+            std::string shipFilename = BinaryFileTools::ReadString(file);
+
+            FileKey key;
+            key.FileSize = BinaryFileTools::Read<std::uint64_t>(file);
+            key.LastWriteTime = BinaryFileTools::Read<std::int64_t>(file);
+
+            int const originalWidth = BinaryFileTools::Read<std::int32_t>(file);
+            int const originalHeight = BinaryFileTools::Read<std::int32_t>(file);
+
+            std::string shipName = BinaryFileTools::ReadString(file);
+            std::optional<std::string> author = BinaryFileTools::ReadOptionalString(file);
+            std::optional<std::string> yearBuilt = BinaryFileTools::ReadOptionalString(file);
+            std::optional<std::string> description = BinaryFileTools::ReadOptionalString(file);
+            float const offsetX = BinaryFileTools::Read<float>(file);
+            float const offsetY = BinaryFileTools::Read<float>(file);
+
+            RgbaImageData previewImage = BinaryFileTools::ReadImage<rgbaColor>(file);
+
+            if (!file.good())
+                break;
+
+            cache.mEntries.emplace(
+                std::move(shipFilename),
+                Entry(
+                    key,
+                    ShipPreview(
+                        std::move(previewImage),
+                        ImageSize(originalWidth, originalHeight),
+                        ShipMetadata(
+                            std::move(shipName),
+                            std::move(author),
+                            std::move(yearBuilt),
+                            std::move(description),
+                            vec2f(offsetX, offsetY)))));
+        }
+    }
+    catch (std::exception const & ex)
+    {
+        LogMessage("Ignoring preview cache \"", cache.mCacheFilePath->string(), "\": ", ex.what());
+        cache.mEntries.clear();
+    }
+
+    return cache;
+}
+
+std::optional<ShipPreview> ShipPreviewDirectoryCache::TryGet(std::filesystem::path const & shipFilepath)
+{
+    if (!mCacheFilePath)
+        return std::nullopt;
+
+    auto const key = FileKey::Create(shipFilepath);
+    if (!key)
+        return std::nullopt;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto const it = mEntries.find(shipFilepath.filename().string());
+    if (it == mEntries.end() || !(it->second.Key == *key))
+        return std::nullopt;
+
+    return ClonePreview(it->second.Preview);
+}
+
+void ShipPreviewDirectoryCache::Put(
+    std::filesystem::path const & shipFilepath,
+    ShipPreview const & shipPreview)
+{
+    if (!mCacheFilePath)
+        return;
+
+    auto const key = FileKey::Create(shipFilepath);
+    if (!key)
+        return;
+
+    auto preview = ClonePreview(shipPreview);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::string shipFilename = shipFilepath.filename().string();
+    mEntries.erase(shipFilename);
+    mEntries.emplace(
+        std::move(shipFilename),
+        Entry(*key, std::move(preview)));
+
+    mIsDirty = true;
+}
+
+void ShipPreviewDirectoryCache::Save()
+{
+    if (!mCacheFilePath)
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    //
+    // Drop ships that are gone
+    //
+
+    std::error_code ec;
+
+    for (auto it = mEntries.begin(); it != mEntries.end(); )
+    {
+        if (!std::filesystem::exists(mDirectoryPath / it->first, ec))
+        {
+            it = mEntries.erase(it);
+            mIsDirty = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (!mIsDirty)
+        return;
+
+    //
+    // Write to a temporary file first, so that concurrent readers
+    // never see a partial cache
+    //
+
+    std::filesystem::create_directories(mCacheFilePath->parent_path(), ec);
+
+    std::filesystem::path tempFilePath = *mCacheFilePath;
+    tempFilePath += ".tmp";
+
+    {
+        std::ofstream file(tempFilePath.string(), std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LogMessage("Cannot write preview cache \"", tempFilePath.string(), "\"");
+            return;
+        }
+
+        file.write(PreviewCacheMagic, sizeof(PreviewCacheMagic));
+        BinaryFileTools::Write<std::uint32_t>(file, PreviewCacheVersion);
+        BinaryFileTools::WriteString(file, mNormalizedDirectoryPath);
+        BinaryFileTools::Write<std::int32_t>(file, mMaxPreviewSize.Width);
+        BinaryFileTools::Write<std::int32_t>(file, mMaxPreviewSize.Height);
+
+        BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(mEntries.size()));
+        for (auto const & entry : mEntries)
+        {
+            BinaryFileTools::WriteString(file, entry.first);
+
+            BinaryFileTools::Write<std::uint64_t>(file, entry.second.Key.FileSize);
+            BinaryFileTools::Write<std::int64_t>(file, entry.second.Key.LastWriteTime);
+
+            ShipPreview const & preview = entry.second.Preview;
+
+            BinaryFileTools::Write<std::int32_t>(file, preview.OriginalSize.Width);
+            BinaryFileTools::Write<std::int32_t>(file, preview.OriginalSize.Height);
+
+            BinaryFileTools::WriteString(file, preview.Metadata.ShipName);
+            BinaryFileTools::WriteOptionalString(file, preview.Metadata.Author);
+            BinaryFileTools::WriteOptionalString(file, preview.Metadata.YearBuilt);
+            BinaryFileTools::WriteOptionalString(file, preview.Metadata.Description);
+            BinaryFileTools::Write<float>(file, preview.Metadata.Offset.x);
+            BinaryFileTools::Write<float>(file, preview.Metadata.Offset.y);
+
+            BinaryFileTools::WriteImage(file, preview.PreviewImage);
+        }
+
+        if (!file.good())
+        {
+            LogMessage("Error writing preview cache \"", tempFilePath.string(), "\"");
+            file.close();
+            std::filesystem::remove(tempFilePath, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempFilePath, *mCacheFilePath, ec);
+    if (ec)
+    {
+        LogMessage("Cannot write preview cache \"", mCacheFilePath->string(), "\": ", ec.message());
+        std::filesystem::remove(tempFilePath, ec);
+        return;
+    }
+
+    mIsDirty = false;
+}
+
+ShipPreviewDirectoryCache::ShipPreviewDirectoryCache(ShipPreviewDirectoryCache && other)
+    : mDirectoryPath(other.mDirectoryPath)
+    , mNormalizedDirectoryPath(other.mNormalizedDirectoryPath)
+    , mCacheFilePath(other.mCacheFilePath)
+    , mMaxPreviewSize(other.mMaxPreviewSize)
+    , mEntries(std::move(other.mEntries))
+    , mIsDirty(other.mIsDirty)
+    , mMutex()
+{
+}
+
+ShipPreviewDirectoryCache::ShipPreviewDirectoryCache(
+    std::filesystem::path directoryPath,
+    std::string normalizedDirectoryPath,
+    std::optional<std::filesystem::path> cacheFilePath,
+    ImageSize const & maxPreviewSize)
+    : mDirectoryPath(std::move(directoryPath))
+    , mNormalizedDirectoryPath(std::move(normalizedDirectoryPath))
+    , mCacheFilePath(std::move(cacheFilePath))
+    , mMaxPreviewSize(maxPreviewSize)
+    , mEntries()
+    , mIsDirty(false)
+    , mMutex()
+{
+}
+
+std::optional<ShipPreviewDirectoryCache::FileKey> ShipPreviewDirectoryCache::FileKey::Create(std::filesystem::path const & filepath)
+{
+    std::error_code ec;
+
+    auto const fileSize = std::filesystem::file_size(filepath, ec);
+    if (ec)
+        return std::nullopt;
+
+    auto const lastWriteTime = std::filesystem::last_write_time(filepath, ec);
+    if (ec)
+        return std::nullopt;
+
+    FileKey key;
+    key.FileSize = static_cast<std::uint64_t>(fileSize);
+    key.LastWriteTime = static_cast<std::int64_t>(lastWriteTime.time_since_epoch().count());
+
+    return key;
+}
+
+ShipPreview ShipPreviewDirectoryCache::ClonePreview(ShipPreview const & shipPreview)
+{
+    size_t const pixelCount = static_cast<size_t>(shipPreview.PreviewImage.Size.Width) * static_cast<size_t>(shipPreview.PreviewImage.Size.Height);
+    auto data = std::make_unique<rgbaColor[]>(pixelCount);
+    std::memcpy(
+        static_cast<void *>(data.get()),
+        shipPreview.PreviewImage.Data.get(),
+        pixelCount * sizeof(rgbaColor));
+
+    return ShipPreview(
+        RgbaImageData(shipPreview.PreviewImage.Size, std::move(data)),
+        shipPreview.OriginalSize,
+        shipPreview.Metadata);
+}
@@ -0,0 +1,108 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-02
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "ShipPreview.h"
+
+#include <GameCore/ImageData.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+/*
+ * An on-disk cache of the previews of all the ships in a directory, stored in
+ * one packed file per directory.
+ *
+ * Previews are keyed by the ship file's name, size, and last write time; note that
+ * for ship definition files this does not cover the images they refer to.
+ *
+ * Lookups and insertions may be made concurrently.
+ */
+class ShipPreviewDirectoryCache
+{
+public:
+
+    /*
+     * Tells whether a ship file has changed since it was last seen.
+     */
+    struct FileKey
+    {
+        std::uint64_t FileSize;
+        std::int64_t LastWriteTime;
+
+        bool operator==(FileKey const & other) const
+        {
+            return FileSize == other.FileSize
+                && LastWriteTime == other.LastWriteTime;
+        }
+
+        static std::optional<FileKey> Create(std::filesystem::path const & filepath);
+    };
+
+    static void SetCacheFolderPath(std::filesystem::path const & folderPath);
+
+    /*
+     * Loads the cache of the specified directory, for previews of the specified maximum
+     * size; the cache is empty if there's none yet, or if it can't be used.
+     */
+    static ShipPreviewDirectoryCache Load(
+        std::filesystem::path const & directoryPath,
+        ImageSize const & maxPreviewSize);
+
+    std::optional<ShipPreview> TryGet(std::filesystem::path const & shipFilepath);
+
+    void Put(
+        std::filesystem::path const & shipFilepath,
+        ShipPreview const & shipPreview);
+
+    /*
+     * Writes the cache back if it has changed, dropping the previews of ships that
+     * no longer exist. Failures are not fatal, as all we lose is the cache.
+     */
+    void Save();
+
+    ShipPreviewDirectoryCache(ShipPreviewDirectoryCache && other);
+
+private:
+
+    struct Entry
+    {
+        FileKey Key;
+        ShipPreview Preview;
+
+        Entry(
+            FileKey const & key,
+            ShipPreview && preview)
+            : Key(key)
+            , Preview(std::move(preview))
+        {}
+    };
+
+    ShipPreviewDirectoryCache(
+        std::filesystem::path directoryPath,
+        std::string normalizedDirectoryPath,
+        std::optional<std::filesystem::path> cacheFilePath,
+        ImageSize const & maxPreviewSize);
+
+    static ShipPreview ClonePreview(ShipPreview const & shipPreview);
+
+    static std::optional<std::filesystem::path> CacheFolderPath;
+
+    std::filesystem::path const mDirectoryPath;
+    std::string const mNormalizedDirectoryPath; // Stored in the file, guards against hash collisions
+    std::optional<std::filesystem::path> const mCacheFilePath;
+    ImageSize const mMaxPreviewSize;
+
+    // Ship file name -> entry
+    std::map<std::string, Entry> mEntries;
+    bool mIsDirty;
+
+    std::mutex mMutex;
+};
@@ -0,0 +1,235 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-05
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "ShipProxyLattice.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+namespace Physics {
+
+ShipProxyLattice ShipProxyLattice::Build(
+    float blockSize,
+    std::vector<vec2f> const & pointRestPositions,
+    std::vector<float> const & pointMasses,
+    std::vector<float> const & pointWaterVolumeFills,
+    std::vector<std::pair<ElementIndex, ElementIndex>> const & springEndpoints,
+    std::vector<float> const & springStiffnesses)
+{
+    assert(blockSize > 0.0f);
+    assert(pointMasses.size() == pointRestPositions.size());
+    assert(pointWaterVolumeFills.size() == pointRestPositions.size());
+    assert(springStiffnesses.size() == springEndpoints.size());
+
+    ShipProxyLattice lattice;
+    lattice.mBlockSize = blockSize;
+
+    size_t const pointCount = pointRestPositions.size();
+
+    //
+    // Bucket the points into blocks, making a proxy point for each non-empty block
+    //
+
+    vec2f minPosition(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    for (auto const & position : pointRestPositions)
+    {
+        minPosition.x = std::min(minPosition.x, position.x);
+        minPosition.y = std::min(minPosition.y, position.y);
+    }
+
+    std::unordered_map<std::uint64_t, ElementIndex> blockProxyPoints;
+
+    lattice.mPointProxyPoints.resize(pointCount);
+
+    for (size_t p = 0; p < pointCount; ++p)
+    {
+        vec2f const blockCoordinates = (pointRestPositions[p] - minPosition) / blockSize;
+        std::uint64_t const blockKey =
+            (static_cast<std::uint64_t>(blockCoordinates.x) << 32)
+            | static_cast<std::uint64_t>(blockCoordinates.y);
+
+        auto const [it, isNew] = blockProxyPoints.emplace(blockKey, static_cast<ElementIndex>(lattice.mProxyPoints.size()));
+        if (isNew)
+        {
+            lattice.mProxyPoints.push_back({ vec2f::zero(), 0.0f, 0.0f, 0 });
+        }
+
+        ProxyPoint & proxyPoint = lattice.mProxyPoints[it->second];
+
+        // Weigh positions by mass for now, and divide once the block is complete
+        proxyPoint.RestPosition += pointRestPositions[p] * pointMasses[p];
+        proxyPoint.Mass += pointMasses[p];
+        proxyPoint.WaterCapacity += pointWaterVolumeFills[p];
+        ++(proxyPoint.PointCount);
+
+        lattice.mPointProxyPoints[p] = it->second;
+    }
+
+    for (auto & proxyPoint : lattice.mProxyPoints)
+    {
+        assert(proxyPoint.Mass > 0.0f);
+        proxyPoint.RestPosition = proxyPoint.RestPosition / proxyPoint.Mass;
+    }
+
+    lattice.mPointRestOffsets.reserve(pointCount);
+    lattice.mPointMassFractions.reserve(pointCount);
+    for (size_t p = 0; p < pointCount; ++p)
+    {
+        ProxyPoint const & proxyPoint = lattice.mProxyPoints[lattice.mPointProxyPoints[p]];
+
+        lattice.mPointRestOffsets.push_back(pointRestPositions[p] - proxyPoint.RestPosition);
+        lattice.mPointMassFractions.push_back(pointMasses[p] / proxyPoint.Mass);
+    }
+
+    //
+    // Make a proxy spring for each pair of blocks connected by springs
+    //
+
+    std::unordered_map<std::uint64_t, ElementIndex> proxyPointPairProxySprings;
+
+    for (size_t s = 0; s < springEndpoints.size(); ++s)
+    {
+        ElementIndex proxyPointAIndex = lattice.mPointProxyPoints[springEndpoints[s].first];
+        ElementIndex proxyPointBIndex = lattice.mPointProxyPoints[springEndpoints[s].second];
+        if (proxyPointAIndex == proxyPointBIndex)
+        {
+            // Within the block
+            continue;
+        }
+
+        if (proxyPointAIndex > proxyPointBIndex)
+            std::swap(proxyPointAIndex, proxyPointBIndex);
+
+        std::uint64_t const pairKey =
+            (static_cast<std::uint64_t>(proxyPointAIndex) << 32)
+            | static_cast<std::uint64_t>(proxyPointBIndex);
+
+        auto const [it, isNew] = proxyPointPairProxySprings.emplace(pairKey, static_cast<ElementIndex>(lattice.mProxySprings.size()));
+        if (isNew)
+        {
+            lattice.mProxySprings.push_back({
+                proxyPointAIndex,
+                proxyPointBIndex,
+                (lattice.mProxyPoints[proxyPointBIndex].RestPosition - lattice.mProxyPoints[proxyPointAIndex].RestPosition).length(),
+                0.0f,
+                0 });
+        }
+
+        ProxySpring & proxySpring = lattice.mProxySprings[it->second];
+        proxySpring.Stiffness += springStiffnesses[s];
+        ++(proxySpring.SpringCount);
+    }
+
+    //
+    // Lay out the springs of each proxy point
+    //
+
+    lattice.mProxyPointSpringOffsets.assign(lattice.mProxyPoints.size() + 1, 0);
+    for (auto const & proxySpring : lattice.mProxySprings)
+    {
+        ++(lattice.mProxyPointSpringOffsets[proxySpring.ProxyPointAIndex + 1]);
+        ++(lattice.mProxyPointSpringOffsets[proxySpring.ProxyPointBIndex + 1]);
+    }
+
+    for (size_t pp = 1; pp < lattice.mProxyPointSpringOffsets.size(); ++pp)
+    {
+        lattice.mProxyPointSpringOffsets[pp] += lattice.mProxyPointSpringOffsets[pp - 1];
+    }
+
+    lattice.mProxyPointSprings.resize(lattice.mProxyPointSpringOffsets.back());
+
+    std::vector<ElementIndex> insertionOffsets(lattice.mProxyPointSpringOffsets.begin(), lattice.mProxyPointSpringOffsets.end() - 1);
+    for (ElementIndex ps = 0; ps < lattice.mProxySprings.size(); ++ps)
+    {
+        lattice.mProxyPointSprings[insertionOffsets[lattice.mProxySprings[ps].ProxyPointAIndex]++] = ps;
+        lattice.mProxyPointSprings[insertionOffsets[lattice.mProxySprings[ps].ProxyPointBIndex]++] = ps;
+    }
+
+    return lattice;
+}
+
+void ShipProxyLattice::CalculateProxyPositions(
+    vec2f const * pointPositions,
+    vec2f * proxyPositions) const
+{
+    std::fill(proxyPositions, proxyPositions + mProxyPoints.size(), vec2f::zero());
+
+    for (size_t p = 0; p < mPointProxyPoints.size(); ++p)
+    {
+        proxyPositions[mPointProxyPoints[p]] += pointPositions[p] * mPointMassFractions[p];
+    }
+}
+
+void ShipProxyLattice::ReconstructPointPositions(
+    vec2f const * proxyPositions,
+    vec2f * pointPositions) const
+{
+    //
+    // Calculate the rotation of each proxy point - as a unit vector - averaging the rotations
+    // of its springs; proxy points without springs do not rotate
+    //
+
+    std::vector<vec2f> proxyRotations(mProxyPoints.size(), vec2f(1.0f, 0.0f));
+
+    for (size_t pp = 0; pp < mProxyPoints.size(); ++pp)
+    {
+        vec2f rotationSum = vec2f::zero();
+
+        for (ElementIndex o = mProxyPointSpringOffsets[pp]; o < mProxyPointSpringOffsets[pp + 1]; ++o)
+        {
+            ProxySpring const & proxySpring = mProxySprings[mProxyPointSprings[o]];
+            ElementIndex const otherProxyPointIndex = (proxySpring.ProxyPointAIndex == pp)
+                ? proxySpring.ProxyPointBIndex
+                : proxySpring.ProxyPointAIndex;
+
+            vec2f const restDirection = (mProxyPoints[otherProxyPointIndex].RestPosition - mProxyPoints[pp].RestPosition).normalise();
+            vec2f const direction = (proxyPositions[otherProxyPointIndex] - proxyPositions[pp]).normalise();
+
+            // direction * conjugate(restDirection), as complex numbers
+            rotationSum += vec2f(
+                direction.x * restDirection.x + direction.y * restDirection.y,
+                direction.y * restDirection.x - direction.x * restDirection.y);
+        }
+
+        if (rotationSum.length() > 0.0f)
+        {
+            proxyRotations[pp] = rotationSum.normalise();
+        }
+    }
+
+    //
+    // Place the points
+    //
+
+    for (size_t p = 0; p < mPointProxyPoints.size(); ++p)
+    {
+        ElementIndex const proxyPointIndex = mPointProxyPoints[p];
+        vec2f const & rotation = proxyRotations[proxyPointIndex];
+        vec2f const & offset = mPointRestOffsets[p];
+
+        pointPositions[p] =
+            proxyPositions[proxyPointIndex]
+            + vec2f(
+                rotation.x * offset.x - rotation.y * offset.y,
+                rotation.y * offset.x + rotation.x * offset.y);
+    }
+}
+
+void ShipProxyLattice::ReportMemory(MemoryReport & report) const
+{
+    report.Add("ProxyPoints", mProxyPoints);
+    report.Add("ProxySprings", mProxySprings);
+    report.Add("PointProxyPoints", mPointProxyPoints);
+    report.Add("PointRestOffsets", mPointRestOffsets);
+    report.Add("PointMassFractions", mPointMassFractions);
+    report.Add("ProxyPointSpringOffsets", mProxyPointSpringOffsets);
+    report.Add("ProxyPointSprings", mProxyPointSprings);
+}
+
+}
@@ -0,0 +1,145 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-05
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/MemoryReport.h>
+#include <GameCore/Vectors.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Physics
+{
+
+/*
+ * A coarse stand-in for the structure of a ship: one proxy point for each square block of
+ * the ship's points, with the mass and the water capacity of all the points in the block,
+ * and one proxy spring between each two blocks connected by at least one spring, as stiff
+ * as all of those springs together.
+ *
+ * The lattice is meant to stand in for the ship when simulating it at full resolution is
+ * not worth it - ships far from the view, or too large for the budget - as the proxy
+ * points may be made from the ship's current positions, and the ship's positions may be
+ * reconstructed back from the proxy points: each point keeps its rest offset from its
+ * proxy point, rotated as the proxy point's springs are rotated.
+ */
+class ShipProxyLattice
+{
+public:
+
+    struct ProxyPoint
+    {
+        vec2f RestPosition; // The center of mass of the block's points, at rest
+        float Mass;
+        float WaterCapacity; // The sum of the water volume fills of the block's points
+        ElementCount PointCount;
+    };
+
+    struct ProxySpring
+    {
+        ElementIndex ProxyPointAIndex;
+        ElementIndex ProxyPointBIndex;
+        float RestLength;
+        float Stiffness; // The sum of the stiffnesses of the springs between the two blocks
+        ElementCount SpringCount;
+    };
+
+    /*
+     * The side - in ship units, i.e. pixels of the structural layer - of the blocks when
+     * none is specified.
+     */
+    static constexpr float DefaultBlockSize = 4.0f;
+
+    /*
+     * Makes the lattice for the specified points - at their rest positions - and springs,
+     * all indexed as the ship's points and springs.
+     */
+    static ShipProxyLattice Build(
+        float blockSize,
+        std::vector<vec2f> const & pointRestPositions,
+        std::vector<float> const & pointMasses,
+        std::vector<float> const & pointWaterVolumeFills,
+        std::vector<std::pair<ElementIndex, ElementIndex>> const & springEndpoints,
+        std::vector<float> const & springStiffnesses);
+
+    ShipProxyLattice()
+        : mBlockSize(DefaultBlockSize)
+        , mProxyPoints()
+        , mProxySprings()
+        , mPointProxyPoints()
+        , mPointRestOffsets()
+        , mPointMassFractions()
+        , mProxyPointSpringOffsets()
+        , mProxyPointSprings()
+    {}
+
+    ShipProxyLattice(ShipProxyLattice && other) = default;
+    ShipProxyLattice & operator=(ShipProxyLattice && other) = default;
+
+    float GetBlockSize() const
+    {
+        return mBlockSize;
+    }
+
+    std::vector<ProxyPoint> const & GetProxyPoints() const
+    {
+        return mProxyPoints;
+    }
+
+    std::vector<ProxySpring> const & GetProxySprings() const
+    {
+        return mProxySprings;
+    }
+
+    /*
+     * The proxy point standing in for each point, indexed by point.
+     */
+    std::vector<ElementIndex> const & GetPointProxyPoints() const
+    {
+        return mPointProxyPoints;
+    }
+
+    /*
+     * Calculates the positions of the proxy points as the centers of mass of the specified
+     * positions of their points.
+     */
+    void CalculateProxyPositions(
+        vec2f const * pointPositions,
+        vec2f * proxyPositions) const;
+
+    /*
+     * Calculates the positions of the points from the specified positions of the proxy points:
+     * each point sits at its rest offset from its proxy point, rotated by the average rotation
+     * of the proxy point's springs since rest.
+     */
+    void ReconstructPointPositions(
+        vec2f const * proxyPositions,
+        vec2f * pointPositions) const;
+
+    void ReportMemory(MemoryReport & report) const;
+
+private:
+
+    float mBlockSize;
+
+    std::vector<ProxyPoint> mProxyPoints;
+    std::vector<ProxySpring> mProxySprings;
+
+    // Indexed by point
+    std::vector<ElementIndex> mPointProxyPoints;
+    std::vector<vec2f> mPointRestOffsets;
+    std::vector<float> mPointMassFractions; // The share of its proxy point's mass
+
+    // The proxy springs of each proxy point, one proxy point after the other, and the
+    // offset of each proxy point's springs in there; the last extra element contains
+    // the total number of entries
+    std::vector<ElementIndex> mProxyPointSpringOffsets;
+    std::vector<ElementIndex> mProxyPointSprings;
+};
+
+}
@@ -11,6 +11,8 @@
 #include <GameCore/GameMath.h>
 #include <GameCore/Log.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 
 namespace Render {
@@ -19,9 +21,11 @@ ShipRenderContext::ShipRenderContext(
     ShipId shipId,
     size_t shipCount,
     size_t pointCount,
+    ImageSize shipStructureSize,
     RgbaImageData shipTexture,
     ShipDefinition::TextureOriginType /*textureOrigin*/,
     ShaderManager<ShaderManagerTraits> & shaderManager,
+    GameOpenGLBufferRecycler & bufferRecycler,
     GameOpenGLTexture & genericTextureAtlasOpenGLHandle,
     TextureAtlasMetadata const & genericTextureAtlasMetadata,
     RenderStatistics & renderStatistics,
@@ -38,31 +42,46 @@ ShipRenderContext::ShipRenderContext(
     , mShipCount(shipCount)
     , mPointCount(pointCount)
     , mMaxMaxPlaneId(0)
+    , mIsCulled(false)
+    , mIsLowDetail(false)
+    , mLayerOrthoMatrices()
     // Buffers
-    , mPointAttributeGroup1Buffer()
     , mPointAttributeGroup1VBO()
-    , mPointAttributeGroup2Buffer()
-    , mPointAttributeGroup2VBO()
+    , mPointLightVBO()
+    , mPointWaterVBO()
+    , mPointAttributeGroup3Buffer()
+    , mPointAttributeGroup3DirtyRange()
+    , mPointAttributeGroup3VBO()
+    , mPointColorBuffer()
     , mPointColorVBO()
     //
     , mStressedSpringElementBuffer()
     , mStressedSpringElementVBO()
+    , mStressedSpringElementVBOAllocatedCount(0)
     //
-    , mGenericTexturePlaneVertexBuffers()
+    , mGenericTexturePlaneInstanceBuffers()
     , mGenericTextureQuadCount(0)
-    , mGenericTextureVBO()
-    , mGenericTextureVBOAllocatedQuadCount()
-    //
-    , mVectorArrowVertexBuffer()
-    , mVectorArrowVBO()
+    , mGenericTextureInstanceVBO()
+    , mGenericTextureInstanceVBOAllocatedQuadCount(0)
+    , mGenericTextureQuadVBO()
+    //
+    , mVectorArrowInstanceVBO()
+    , mVectorArrowCount(0)
+    , mVectorArrowShapeVBO()
+    , mVectorArrowLengthAdjustment()
     , mVectorArrowColor()
+    , mLampBuffer()
+    , mLampCount(0)
     // Element (index) buffers
     , mPointElementBuffer()
     , mEphemeralPointElementBuffer()
     , mSpringElementBuffer()
     , mRopeElementBuffer()
     , mTriangleElementBuffer()
+    , mUploadedTriangleElementBuffer()
+    , mTriangleElementCount(0)
     , mElementVBO()
+    , mElementVBOAllocatedSize(0)
     , mPointElementVBOStartIndex(0)
     , mEphemeralPointElementVBOStartIndex(0)
     , mSpringElementVBOStartIndex(0)
@@ -74,11 +93,17 @@ ShipRenderContext::ShipRenderContext(
     , mVectorArrowVAO()
     // Textures
     , mShipTextureOpenGLHandle()
+    , mShipTextureBaseLevelByteSize(static_cast<size_t>(shipTexture.Size.Width) * static_cast<size_t>(shipTexture.Size.Height) * sizeof(rgbaColor))
+    , mShipTextureDeferredBaseLevel()
+    , mShipTextureDeferredBaseLevelMinCanvasToVisibleWorldRatio(0.0f)
+    , mShipTextureStreamer()
     , mStressedSpringTextureOpenGLHandle()
+    , mLampsTextureOpenGLHandle()
     , mGenericTextureAtlasOpenGLHandle(genericTextureAtlasOpenGLHandle)
     , mGenericTextureAtlasMetadata(genericTextureAtlasMetadata)
     // Managers
     , mShaderManager(shaderManager)
+    , mBufferRecycler(bufferRecycler)
     // Parameters
     , mViewModel(viewModel)
     , mAmbientLightIntensity(ambientLightIntensity)
@@ -102,32 +127,76 @@ ShipRenderContext::ShipRenderContext(
     // Initialize buffers
     //
 
-    GLuint vbos[6];
-    glGenBuffers(6, vbos);
-    CheckOpenGLError();
+    // The per-point VBOs are taken over from the ships of the previous world, when their
+    // sizes match, so that reloading a ship doesn't have the driver allocate storage again
 
-    mPointAttributeGroup1VBO = vbos[0];
-    glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup1VBO);
-    glBufferData(GL_ARRAY_BUFFER, pointCount * sizeof(vec4f), nullptr, GL_STREAM_DRAW);
-    mPointAttributeGroup1Buffer.reset(new vec4f[pointCount]);
-    std::memset(mPointAttributeGroup1Buffer.get(), 0, pointCount * sizeof(vec4f));
+    mPointAttributeGroup1VBO = mBufferRecycler.Acquire(GL_ARRAY_BUFFER, pointCount * sizeof(vec2f), GL_STREAM_DRAW);
 
-    mPointAttributeGroup2VBO = vbos[1];
-    glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup2VBO);
-    glBufferData(GL_ARRAY_BUFFER, pointCount * sizeof(vec4f), nullptr, GL_STREAM_DRAW);
-    mPointAttributeGroup2Buffer.reset(new vec4f[pointCount]);
-    std::memset(mPointAttributeGroup2Buffer.get(), 0, pointCount * sizeof(vec4f));
+    mPointLightVBO = mBufferRecycler.Acquire(GL_ARRAY_BUFFER, pointCount * sizeof(float), GL_STREAM_DRAW);
 
-    mPointColorVBO = vbos[2];
-    glBindBuffer(GL_ARRAY_BUFFER, *mPointColorVBO);
-    glBufferData(GL_ARRAY_BUFFER, pointCount * sizeof(vec4f), nullptr, GL_STATIC_DRAW);
+    mPointWaterVBO = mBufferRecycler.Acquire(GL_ARRAY_BUFFER, pointCount * sizeof(float), GL_STREAM_DRAW);
+
+    mPointAttributeGroup3VBO = mBufferRecycler.Acquire(GL_ARRAY_BUFFER, pointCount * sizeof(vec4f), GL_DYNAMIC_DRAW);
+    mPointAttributeGroup3Buffer.reset(new vec4f[pointCount]);
+    std::memset(mPointAttributeGroup3Buffer.get(), 0, pointCount * sizeof(vec4f));
+
+    mPointColorVBO = mBufferRecycler.Acquire(GL_ARRAY_BUFFER, pointCount * sizeof(rgbaColor), GL_STATIC_DRAW);
+    mPointColorBuffer.reset(new rgbaColor[pointCount]);
+
+    // One vector per point, drawn as an arrow instance from the point's position
+    mVectorArrowInstanceVBO = mBufferRecycler.Acquire(GL_ARRAY_BUFFER, pointCount * sizeof(vec2f), GL_STREAM_DRAW);
 
-    mStressedSpringElementVBO = vbos[3];
+    GLuint vbos[4];
+    glGenBuffers(4, vbos);
+    CheckOpenGLError();
+
+    mStressedSpringElementVBO = vbos[0];
     mStressedSpringElementBuffer.reserve(1000); // Arbitrary
 
-    mGenericTextureVBO = vbos[4];
+    mGenericTextureInstanceVBO = vbos[1];
 
-    mVectorArrowVBO = vbos[5];
+    // The quad shared by all generic texture instances never changes -
+    // two triangles, with corners in the unit square
+    mGenericTextureQuadVBO = vbos[2];
+    {
+        vec2f const quadCorners[6]{
+            { 0.0f, 1.0f },
+            { 0.0f, 0.0f },
+            { 1.0f, 1.0f },
+            { 0.0f, 0.0f },
+            { 1.0f, 1.0f },
+            { 1.0f, 0.0f }
+        };
+
+        glBindBuffer(GL_ARRAY_BUFFER, *mGenericTextureQuadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+        CheckOpenGLError();
+    }
+
+    // The shape shared by all vector arrow instances never changes - the stem and the
+    // two sides of the head, as lines; each vertex is the fraction of the (adjusted)
+    // vector it sits at, followed by its offset along and across the vector's direction
+    mVectorArrowShapeVBO = vbos[3];
+    {
+        float const headSideAlong = -VectorArrowHeadSideLength * std::cos(Pi<float> / 4.0f);
+        float const headSideAcross = VectorArrowHeadSideLength * std::sin(Pi<float> / 4.0f);
+
+        vec3f const arrowVertices[6]{
+            // Stem
+            { 0.0f, 0.0f, 0.0f },
+            { 1.0f, 0.0f, 0.0f },
+            // Left
+            { 1.0f, 0.0f, 0.0f },
+            { 1.0f, headSideAlong, -headSideAcross },
+            // Right
+            { 1.0f, 0.0f, 0.0f },
+            { 1.0f, headSideAlong, headSideAcross }
+        };
+
+        glBindBuffer(GL_ARRAY_BUFFER, *mVectorArrowShapeVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(arrowVertices), arrowVertices, GL_STATIC_DRAW);
+        CheckOpenGLError();
+    }
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -144,6 +213,7 @@ ShipRenderContext::ShipRenderContext(
     mSpringElementBuffer.reserve(pointCount * GameParameters::MaxSpringsPerPoint);
     mRopeElementBuffer.reserve(pointCount); // Arbitrary
     mTriangleElementBuffer.reserve(pointCount * GameParameters::MaxTrianglesPerPoint);
+    mUploadedTriangleElementBuffer.reserve(pointCount * GameParameters::MaxTrianglesPerPoint);
 
 
     //
@@ -163,17 +233,27 @@ ShipRenderContext::ShipRenderContext(
 
         glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup1VBO);
         glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::ShipPointAttributeGroup1));
-        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointAttributeGroup1), 4, GL_FLOAT, GL_FALSE, sizeof(vec4f), (void*)(0));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointAttributeGroup1), 2, GL_FLOAT, GL_FALSE, sizeof(vec2f), (void*)(0));
+        CheckOpenGLError();
+
+        glBindBuffer(GL_ARRAY_BUFFER, *mPointLightVBO);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::ShipPointLight));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointLight), 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(0));
+        CheckOpenGLError();
+
+        glBindBuffer(GL_ARRAY_BUFFER, *mPointWaterVBO);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::ShipPointWater));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointWater), 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(0));
         CheckOpenGLError();
 
-        glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup2VBO);
-        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::ShipPointAttributeGroup2));
-        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointAttributeGroup2), 4, GL_FLOAT, GL_FALSE, sizeof(vec4f), (void*)(0));
+        glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup3VBO);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::ShipPointAttributeGroup3));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointAttributeGroup3), 4, GL_FLOAT, GL_FALSE, sizeof(vec4f), (void*)(0));
         CheckOpenGLError();
 
         glBindBuffer(GL_ARRAY_BUFFER, *mPointColorVBO);
         glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::ShipPointColor));
-        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointColor), 4, GL_FLOAT, GL_FALSE, sizeof(vec4f), (void*)(0));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::ShipPointColor), 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rgbaColor), (void*)(0));
         CheckOpenGLError();
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -202,15 +282,27 @@ ShipRenderContext::ShipRenderContext(
         glBindVertexArray(*mGenericTextureVAO);
         CheckOpenGLError();
 
-        // Describe vertex attributes
-        glBindBuffer(GL_ARRAY_BUFFER, *mGenericTextureVBO);
-        static_assert(sizeof(GenericTextureVertex) == (4 + 4 + 3) * sizeof(float));
+        // Describe vertex attributes - the quad corner advances per vertex...
+        glBindBuffer(GL_ARRAY_BUFFER, *mGenericTextureQuadVBO);
         glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::GenericTexture1));
-        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture1), 4, GL_FLOAT, GL_FALSE, sizeof(GenericTextureVertex), (void*)0);
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture1), 2, GL_FLOAT, GL_FALSE, sizeof(vec2f), (void*)0);
+        CheckOpenGLError();
+
+        // ...while everything else advances per instance
+        glBindBuffer(GL_ARRAY_BUFFER, *mGenericTextureInstanceVBO);
+        static_assert(sizeof(GenericTextureInstance) == (4 + 4 + 4 + 3) * sizeof(float));
         glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::GenericTexture2));
-        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture2), 4, GL_FLOAT, GL_FALSE, sizeof(GenericTextureVertex), (void*)((4) * sizeof(float)));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture2), 4, GL_FLOAT, GL_FALSE, sizeof(GenericTextureInstance), (void*)0);
+        glVertexAttribDivisor(static_cast<GLuint>(VertexAttributeType::GenericTexture2), 1);
         glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::GenericTexture3));
-        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture3), 3, GL_FLOAT, GL_FALSE, sizeof(GenericTextureVertex), (void*)((4 + 4) * sizeof(float)));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture3), 4, GL_FLOAT, GL_FALSE, sizeof(GenericTextureInstance), (void*)((4) * sizeof(float)));
+        glVertexAttribDivisor(static_cast<GLuint>(VertexAttributeType::GenericTexture3), 1);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::GenericTexture4));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture4), 4, GL_FLOAT, GL_FALSE, sizeof(GenericTextureInstance), (void*)((4 + 4) * sizeof(float)));
+        glVertexAttribDivisor(static_cast<GLuint>(VertexAttributeType::GenericTexture4), 1);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::GenericTexture5));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::GenericTexture5), 3, GL_FLOAT, GL_FALSE, sizeof(GenericTextureInstance), (void*)((4 + 4 + 4) * sizeof(float)));
+        glVertexAttribDivisor(static_cast<GLuint>(VertexAttributeType::GenericTexture5), 1);
         CheckOpenGLError();
 
         glBindVertexArray(0);
@@ -228,10 +320,26 @@ ShipRenderContext::ShipRenderContext(
         glBindVertexArray(*mVectorArrowVAO);
         CheckOpenGLError();
 
-        // Describe vertex attributes
-        glBindBuffer(GL_ARRAY_BUFFER, *mVectorArrowVBO);
-        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::VectorArrow));
-        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::VectorArrow), 3, GL_FLOAT, GL_FALSE, sizeof(vec3f), (void*)(0));
+        // Describe vertex attributes - the arrow shape advances per vertex...
+        glBindBuffer(GL_ARRAY_BUFFER, *mVectorArrowShapeVBO);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::VectorArrow1));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::VectorArrow1), 3, GL_FLOAT, GL_FALSE, sizeof(vec3f), (void*)(0));
+        CheckOpenGLError();
+
+        // ...while the point's position, plane ID, and vector advance per instance;
+        // position and plane ID come straight from the point attribute buffers
+        glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup1VBO);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::VectorArrow2));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::VectorArrow2), 2, GL_FLOAT, GL_FALSE, sizeof(vec2f), (void*)(0));
+        glVertexAttribDivisor(static_cast<GLuint>(VertexAttributeType::VectorArrow2), 1);
+        glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup3VBO);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::VectorArrow3));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::VectorArrow3), 1, GL_FLOAT, GL_FALSE, sizeof(vec4f), (void*)(2 * sizeof(float)));
+        glVertexAttribDivisor(static_cast<GLuint>(VertexAttributeType::VectorArrow3), 1);
+        glBindBuffer(GL_ARRAY_BUFFER, *mVectorArrowInstanceVBO);
+        glEnableVertexAttribArray(static_cast<GLuint>(VertexAttributeType::VectorArrow4));
+        glVertexAttribPointer(static_cast<GLuint>(VertexAttributeType::VectorArrow4), 2, GL_FLOAT, GL_FALSE, sizeof(vec2f), (void*)(0));
+        glVertexAttribDivisor(static_cast<GLuint>(VertexAttributeType::VectorArrow4), 1);
         CheckOpenGLError();
 
         glBindVertexArray(0);
@@ -250,8 +358,21 @@ ShipRenderContext::ShipRenderContext(
     glBindTexture(GL_TEXTURE_2D, *mShipTextureOpenGLHandle);
     CheckOpenGLError();
 
-    // Upload texture
-    GameOpenGL::UploadMipmappedTexture(std::move(shipTexture));
+    // Start streaming the texture in; the base level of huge textures is then deferred
+    if (DoesDeferShipTextureBaseLevel())
+    {
+        // Canvas pixels per world unit at which level 1 starts being magnified;
+        // one world unit is one pixel of the structure
+        mShipTextureDeferredBaseLevelMinCanvasToVisibleWorldRatio =
+            static_cast<float>(std::max(1, shipTexture.Size.Width / 2))
+            / static_cast<float>(shipStructureSize.Width);
+
+        mShipTextureStreamer = std::make_unique<GameOpenGLTextureStreamer>(std::move(shipTexture), 1);
+    }
+    else
+    {
+        mShipTextureStreamer = std::make_unique<GameOpenGLTextureStreamer>(std::move(shipTexture), 0);
+    }
 
     // Set repeat mode
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -310,6 +431,47 @@ ShipRenderContext::ShipRenderContext(
     glBindTexture(GL_TEXTURE_2D, 0);
 
 
+    //
+    // Initialize Lamps texture
+    //
+
+    glGenTextures(1, &tmpGLuint);
+    mLampsTextureOpenGLHandle = tmpGLuint;
+
+    // Bind texture
+    mShaderManager.ActivateTexture<ProgramParameterType::ShipLampsTexture>();
+    glBindTexture(GL_TEXTURE_2D, *mLampsTextureOpenGLHandle);
+    CheckOpenGLError();
+
+    // Set clamp mode
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    CheckOpenGLError();
+
+    // Set filtering - texels are lamp records, and may not be blended
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    CheckOpenGLError();
+
+    // Set texture parameter in all the programs that light with lamps
+    mShaderManager.ActivateProgram<ProgramType::ShipPointsColor>();
+    mShaderManager.SetTextureParameters<ProgramType::ShipPointsColor>();
+    mShaderManager.ActivateProgram<ProgramType::ShipRopes>();
+    mShaderManager.SetTextureParameters<ProgramType::ShipRopes>();
+    mShaderManager.ActivateProgram<ProgramType::ShipSpringsColor>();
+    mShaderManager.SetTextureParameters<ProgramType::ShipSpringsColor>();
+    mShaderManager.ActivateProgram<ProgramType::ShipSpringsTexture>();
+    mShaderManager.SetTextureParameters<ProgramType::ShipSpringsTexture>();
+    mShaderManager.ActivateProgram<ProgramType::ShipTrianglesColor>();
+    mShaderManager.SetTextureParameters<ProgramType::ShipTrianglesColor>();
+    mShaderManager.ActivateProgram<ProgramType::ShipTrianglesTexture>();
+    mShaderManager.SetTextureParameters<ProgramType::ShipTrianglesTexture>();
+
+    // Unbind texture
+    glBindTexture(GL_TEXTURE_2D, 0);
+    mShaderManager.ActivateTexture<ProgramParameterType::SharedTexture>();
+
+
     //
     // Set parameters to initial values
     //
@@ -324,167 +486,116 @@ ShipRenderContext::ShipRenderContext(
 
 ShipRenderContext::~ShipRenderContext()
 {
+    // Give the per-point VBOs to the ships of the next world
+    mBufferRecycler.Release(std::move(mPointAttributeGroup1VBO), mPointCount * sizeof(vec2f), GL_STREAM_DRAW);
+    mBufferRecycler.Release(std::move(mPointLightVBO), mPointCount * sizeof(float), GL_STREAM_DRAW);
+    mBufferRecycler.Release(std::move(mPointWaterVBO), mPointCount * sizeof(float), GL_STREAM_DRAW);
+    mBufferRecycler.Release(std::move(mPointAttributeGroup3VBO), mPointCount * sizeof(vec4f), GL_DYNAMIC_DRAW);
+    mBufferRecycler.Release(std::move(mPointColorVBO), mPointCount * sizeof(rgbaColor), GL_STATIC_DRAW);
+    mBufferRecycler.Release(std::move(mVectorArrowInstanceVBO), mPointCount * sizeof(vec2f), GL_STREAM_DRAW);
 }
 
-void ShipRenderContext::UpdateOrthoMatrices()
+void ShipRenderContext::ReportMemory(MemoryReport & report) const
 {
-    //
-    // Each plane Z segment is divided into 7 layers, one for each type of rendering we do for a ship:
-    //      - 0: Ropes (always behind)
-    //      - 1: Springs
-    //      - 2: Triangles
-    //          - Triangles are always drawn temporally before ropes and springs though, to avoid anti-aliasing issues
-    //      - 3: Stressed springs
-    //      - 4: Points
-    //      - 5: Generic textures
-    //      - 6: Vectors
-    //
-
-    constexpr float ShipRegionZStart = 1.0f;
-    constexpr float ShipRegionZWidth = -2.0f;
-
-    constexpr int NLayers = 7;
-
-    ViewModel::ProjectionMatrix shipOrthoMatrix;
+    std::string const shipSectionName = "Ship " + std::to_string(mShipId);
 
     //
-    // Layer 0: Ropes
+    // CPU
     //
 
-    mViewModel.CalculateShipOrthoMatrix(
-        ShipRegionZStart,
-        ShipRegionZWidth,
-        static_cast<int>(mShipId),
-        static_cast<int>(mShipCount),
-        static_cast<int>(mMaxMaxPlaneId),
-        0,
-        NLayers,
-        shipOrthoMatrix);
-
-    mShaderManager.ActivateProgram<ProgramType::ShipRopes>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipRopes, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
+    report.PushSection("CPU");
+    report.PushSection(shipSectionName);
+    report.PushSection("Render");
 
+    report.Add("PointAttributeGroup3", mPointCount * sizeof(vec4f));
+    report.Add("PointColor", mPointCount * sizeof(rgbaColor));
+    report.Add("StressedSpringElements", mStressedSpringElementBuffer);
 
-    //
-    // Layer 1: Springs
-    //
+    size_t genericTextureInstancesByteSize = 0;
+    for (auto const & plane : mGenericTexturePlaneInstanceBuffers)
+        genericTextureInstancesByteSize += plane.instanceBuffer.capacity() * sizeof(GenericTextureInstance);
+    report.Add("GenericTextureInstances", genericTextureInstancesByteSize);
 
-    mViewModel.CalculateShipOrthoMatrix(
-        ShipRegionZStart,
-        ShipRegionZWidth,
-        static_cast<int>(mShipId),
-        static_cast<int>(mShipCount),
-        static_cast<int>(mMaxMaxPlaneId),
-        1,
-        NLayers,
-        shipOrthoMatrix);
+    report.Add("Lamps", mLampBuffer);
+    report.Add("PointElements", mPointElementBuffer);
+    report.Add("EphemeralPointElements", mEphemeralPointElementBuffer);
+    report.Add("SpringElements", mSpringElementBuffer);
+    report.Add("RopeElements", mRopeElementBuffer);
+    report.Add("TriangleElements", mTriangleElementBuffer);
+    report.Add("UploadedTriangleElements", mUploadedTriangleElementBuffer);
 
-    mShaderManager.ActivateProgram<ProgramType::ShipSpringsColor>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipSpringsColor, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
+    // Held until it's uploaded
+    report.Add("ShipTextureDeferredBaseLevel", !!mShipTextureDeferredBaseLevel ? mShipTextureBaseLevelByteSize : 0);
+    report.Add("ShipTextureStreaming", !!mShipTextureStreamer ? mShipTextureStreamer->GetByteSize() : 0);
 
-    mShaderManager.ActivateProgram<ProgramType::ShipSpringsTexture>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipSpringsTexture, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
+    report.PopSection();
+    report.PopSection();
+    report.PopSection();
 
     //
-    // Layer 2: Triangles
-    //
-
-    mViewModel.CalculateShipOrthoMatrix(
-        ShipRegionZStart,
-        ShipRegionZWidth,
-        static_cast<int>(mShipId),
-        static_cast<int>(mShipCount),
-        static_cast<int>(mMaxMaxPlaneId),
-        2,
-        NLayers,
-        shipOrthoMatrix);
-
-    mShaderManager.ActivateProgram<ProgramType::ShipTrianglesColor>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipTrianglesColor, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
-
-    mShaderManager.ActivateProgram<ProgramType::ShipTrianglesDecay>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipTrianglesDecay, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
-
-    mShaderManager.ActivateProgram<ProgramType::ShipTrianglesTexture>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipTrianglesTexture, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
-
+    // GPU
     //
-    // Layer 3: Stressed Springs
+    // Only as much as we've asked for - drivers may round up, and keep shadow copies
     //
 
-    mViewModel.CalculateShipOrthoMatrix(
-        ShipRegionZStart,
-        ShipRegionZWidth,
-        static_cast<int>(mShipId),
-        static_cast<int>(mShipCount),
-        static_cast<int>(mMaxMaxPlaneId),
-        3,
-        NLayers,
-        shipOrthoMatrix);
+    report.PushSection("GPU");
+    report.PushSection(shipSectionName);
 
-    mShaderManager.ActivateProgram<ProgramType::ShipStressedSprings>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipStressedSprings, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
+    report.Add("PointAttributeGroup1VBO", mPointCount * sizeof(vec2f));
+    report.Add("PointLightVBO", mPointCount * sizeof(float));
+    report.Add("PointWaterVBO", mPointCount * sizeof(float));
+    report.Add("PointAttributeGroup3VBO", mPointCount * sizeof(vec4f));
+    report.Add("PointColorVBO", mPointCount * sizeof(rgbaColor));
+    report.Add("StressedSpringElementVBO", mStressedSpringElementVBOAllocatedCount * sizeof(LineElement));
+    report.Add("GenericTextureInstanceVBO", mGenericTextureInstanceVBOAllocatedQuadCount * sizeof(GenericTextureInstance));
+    report.Add("VectorArrowInstanceVBO", mPointCount * sizeof(vec2f));
+    report.Add("ElementVBO", mElementVBOAllocatedSize);
 
-    //
-    // Layer 4: Points
-    //
+    // The mipmaps add up to one third of the base level; storage is defined before streaming
+    report.Add(
+        "ShipTexture",
+        (DoesDeferShipTextureBaseLevel() && (!!mShipTextureStreamer || !!mShipTextureDeferredBaseLevel))
+            ? mShipTextureBaseLevelByteSize / 3
+            : mShipTextureBaseLevelByteSize + mShipTextureBaseLevelByteSize / 3);
 
-    mViewModel.CalculateShipOrthoMatrix(
-        ShipRegionZStart,
-        ShipRegionZWidth,
-        static_cast<int>(mShipId),
-        static_cast<int>(mShipCount),
-        static_cast<int>(mMaxMaxPlaneId),
-        4,
-        NLayers,
-        shipOrthoMatrix);
+    report.Add("LampsTexture", mLampBuffer.size() * sizeof(vec4f));
 
-    mShaderManager.ActivateProgram<ProgramType::ShipPointsColor>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipPointsColor, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
+    report.PopSection();
+    report.PopSection();
+}
 
+void ShipRenderContext::UpdateOrthoMatrices()
+{
     //
-    // Layer 5: Generic Textures
-    //
-
-    mViewModel.CalculateShipOrthoMatrix(
-        ShipRegionZStart,
-        ShipRegionZWidth,
-        static_cast<int>(mShipId),
-        static_cast<int>(mShipCount),
-        static_cast<int>(mMaxMaxPlaneId),
-        5,
-        NLayers,
-        shipOrthoMatrix);
-
-    mShaderManager.ActivateProgram<ProgramType::ShipGenericTextures>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipGenericTextures, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
-
+    // Each plane Z segment is divided into 7 layers, one for each type of rendering we do for a ship:
+    //      - 0: Ropes (always behind)
+    //      - 1: Springs
+    //      - 2: Triangles
+    //          - Triangles are always drawn temporally before ropes and springs though, to avoid anti-aliasing issues
+    //      - 3: Stressed springs
+    //      - 4: Points
+    //      - 5: Generic textures
+    //      - 6: Vectors
     //
-    // Layer 6: Vectors
+    // The programs are shared among ships, hence we only calculate the matrices here, and each ship
+    // sets its own when it activates a program for drawing
     //
 
-    mViewModel.CalculateShipOrthoMatrix(
-        ShipRegionZStart,
-        ShipRegionZWidth,
-        static_cast<int>(mShipId),
-        static_cast<int>(mShipCount),
-        static_cast<int>(mMaxMaxPlaneId),
-        6,
-        NLayers,
-        shipOrthoMatrix);
+    constexpr float ShipRegionZStart = 1.0f;
+    constexpr float ShipRegionZWidth = -2.0f;
 
-    mShaderManager.ActivateProgram<ProgramType::ShipVectors>();
-    mShaderManager.SetProgramParameter<ProgramType::ShipVectors, ProgramParameterType::OrthoMatrix>(
-        shipOrthoMatrix);
+    for (size_t l = 0; l < LayerCount; ++l)
+    {
+        mViewModel.CalculateShipOrthoMatrix(
+            ShipRegionZStart,
+            ShipRegionZWidth,
+            static_cast<int>(mShipId),
+            static_cast<int>(mShipCount),
+            static_cast<int>(mMaxMaxPlaneId),
+            static_cast<int>(l),
+            static_cast<int>(LayerCount),
+            mLayerOrthoMatrices[l]);
+    }
 }
 
 void ShipRenderContext::OnAmbientLightIntensityUpdated()
@@ -628,14 +739,24 @@ void ShipRenderContext::OnWaterLevelOfDetailUpdated()
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void ShipRenderContext::RenderStart(PlaneId maxMaxPlaneId)
+bool ShipRenderContext::RenderStart(
+    PlaneId maxMaxPlaneId,
+    bool isLowDetail)
 {
+    mIsCulled = false;
+    mIsLowDetail = isLowDetail;
+
     //
     // Reset generic textures
     //
 
-    mGenericTexturePlaneVertexBuffers.clear();
-    mGenericTexturePlaneVertexBuffers.resize(maxMaxPlaneId + 1);
+    // Keep the planes' buffers, together with their capacity
+    for (auto & plane : mGenericTexturePlaneInstanceBuffers)
+    {
+        plane.instanceBuffer.clear();
+    }
+
+    mGenericTexturePlaneInstanceBuffers.resize(maxMaxPlaneId + 1);
     mGenericTextureQuadCount = 0;
 
 
@@ -648,22 +769,24 @@ void ShipRenderContext::RenderStart(PlaneId maxMaxPlaneId)
         // Update value
         mMaxMaxPlaneId = maxMaxPlaneId;
 
-        // Recalculate view model parameters
-        OnViewModelUpdated();
+        // View model parameters need to be recalculated
+        return true;
     }
+
+    return false;
 }
 
 void ShipRenderContext::UploadPointImmutableAttributes(vec2f const * textureCoordinates)
 {
-    // Interleave texture coordinates into AttributeGroup1 buffer;
-    // wait to upload it until we also get positions
-    vec4f * restrict pDst = mPointAttributeGroup1Buffer.get();
-    vec2f const * restrict pSrc = textureCoordinates;
+    // Interleave texture coordinates into AttributeGroup3 buffer
+    vec4f * restrict pDst = mPointAttributeGroup3Buffer.get();
     for (size_t i = 0; i < mPointCount; ++i)
     {
-        pDst[i].z = pSrc[i].x;
-        pDst[i].w = pSrc[i].y;
+        pDst[i].x = textureCoordinates[i].x;
+        pDst[i].y = textureCoordinates[i].y;
     }
+
+    mPointAttributeGroup3DirtyRange.Add(0, static_cast<ElementIndex>(mPointCount));
 }
 
 void ShipRenderContext::UploadPointMutableAttributesStart()
@@ -675,32 +798,77 @@ void ShipRenderContext::UploadPointMutableAttributes(
     float const * light,
     float const * water)
 {
-    // Interleave positions into AttributeGroup1 buffer
-    vec4f * restrict pDst1 = mPointAttributeGroup1Buffer.get();
-    vec2f const * restrict pSrc = position;
-    for (size_t i = 0; i < mPointCount; ++i)
+    //
+    // Positions, light, and water change at each frame; the points' buffers are
+    // uploaded as they are, each orphaning the previous contents of its VBO
+    //
+
+    glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup1VBO);
+    glBufferData(GL_ARRAY_BUFFER, mPointCount * sizeof(vec2f), position, GL_STREAM_DRAW);
+
+    UploadPointLightAndWater(light, water);
+}
+
+void ShipRenderContext::UploadPointMutableAttributes(
+    ShipPointPositionBuffer const & positionBuffer,
+    vec2f const * position,
+    float const * light,
+    float const * water)
+{
+    assert(nullptr != glCopyBufferSubData);
+    assert(positionBuffer.PointCount <= mPointCount);
+
+    //
+    // The positions of the first points never leave the GPU: we wait - on the GPU - for
+    // the context that wrote them, and copy them buffer-to-buffer; the remaining
+    // positions come from the CPU as usual
+    //
+
+    if (NULL != positionBuffer.WriteFence)
     {
-        pDst1[i].x = pSrc[i].x;
-        pDst1[i].y = pSrc[i].y;
+        assert(nullptr != glWaitSync);
+        glWaitSync(positionBuffer.WriteFence, 0, GL_TIMEOUT_IGNORED);
     }
 
-    // Upload AttributeGroup1 buffer
-    glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup1VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, mPointCount * sizeof(vec4f), mPointAttributeGroup1Buffer.get());
+    glBindBuffer(GL_COPY_READ_BUFFER, positionBuffer.Buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, *mPointAttributeGroup1VBO);
+
+    glCopyBufferSubData(
+        GL_COPY_READ_BUFFER,
+        GL_COPY_WRITE_BUFFER,
+        0,
+        0,
+        positionBuffer.PointCount * sizeof(vec2f));
     CheckOpenGLError();
 
-    // Interleave light and water into AttributeGroup2 buffer;
-    // wait to upload it until we know whether the other attributes
-    // have been uploaded (or not)
-    vec4f * restrict pDst2 = mPointAttributeGroup2Buffer.get();
-    float const * restrict pSrc1 = light;
-    float const * restrict pSrc2 = water;
-    for (size_t i = 0; i < mPointCount; ++i)
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup1VBO);
+
+    if (positionBuffer.PointCount < mPointCount)
     {
-        pDst2[i].x = pSrc1[i];
-        pDst2[i].y = pSrc2[i];
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            positionBuffer.PointCount * sizeof(vec2f),
+            (mPointCount - positionBuffer.PointCount) * sizeof(vec2f),
+            &(position[positionBuffer.PointCount]));
     }
 
+    UploadPointLightAndWater(light, water);
+}
+
+void ShipRenderContext::UploadPointLightAndWater(
+    float const * light,
+    float const * water)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, *mPointLightVBO);
+    glBufferData(GL_ARRAY_BUFFER, mPointCount * sizeof(float), light, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, *mPointWaterVBO);
+    glBufferData(GL_ARRAY_BUFFER, mPointCount * sizeof(float), water, GL_STREAM_DRAW);
+    CheckOpenGLError();
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
@@ -709,11 +877,13 @@ void ShipRenderContext::UploadPointMutableAttributesPlaneId(
     size_t startDst,
     size_t count)
 {
-    // Interleave plane ID into AttributeGroup2 buffer
-    vec4f * restrict pDst = &(mPointAttributeGroup2Buffer.get()[startDst]);
+    // Interleave plane ID into AttributeGroup3 buffer
+    vec4f * restrict pDst = &(mPointAttributeGroup3Buffer.get()[startDst]);
     float const * restrict pSrc = planeId;
     for (size_t i = 0; i < count; ++i)
         pDst[i].z = pSrc[i];
+
+    mPointAttributeGroup3DirtyRange.Add(static_cast<ElementIndex>(startDst), static_cast<ElementIndex>(startDst + count));
 }
 
 void ShipRenderContext::UploadPointMutableAttributesDecay(
@@ -721,21 +891,33 @@ void ShipRenderContext::UploadPointMutableAttributesDecay(
     size_t startDst,
     size_t count)
 {
-    // Interleave decay into AttributeGroup2 buffer
-    vec4f * restrict pDst = &(mPointAttributeGroup2Buffer.get()[startDst]);
+    // Interleave decay into AttributeGroup3 buffer
+    vec4f * restrict pDst = &(mPointAttributeGroup3Buffer.get()[startDst]);
     float const * restrict pSrc = decay;
     for (size_t i = 0; i < count; ++i)
         pDst[i].w = pSrc[i];
+
+    mPointAttributeGroup3DirtyRange.Add(static_cast<ElementIndex>(startDst), static_cast<ElementIndex>(startDst + count));
 }
 
 void ShipRenderContext::UploadPointMutableAttributesEnd()
 {
-    // Upload attribute group buffers
-    glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup2VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, mPointCount * sizeof(vec4f), mPointAttributeGroup2Buffer.get());
-    CheckOpenGLError();
+    // Upload the range of the AttributeGroup3 buffer that has changed, if any
+    if (!mPointAttributeGroup3DirtyRange.IsEmpty())
+    {
+        assert(mPointAttributeGroup3DirtyRange.GetEnd() <= mPointCount);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, *mPointAttributeGroup3VBO);
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            mPointAttributeGroup3DirtyRange.GetStart() * sizeof(vec4f),
+            mPointAttributeGroup3DirtyRange.GetCount() * sizeof(vec4f),
+            &(mPointAttributeGroup3Buffer.get()[mPointAttributeGroup3DirtyRange.GetStart()]));
+        CheckOpenGLError();
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        mPointAttributeGroup3DirtyRange.Clear();
+    }
 }
 
 void ShipRenderContext::UploadPointColors(
@@ -745,9 +927,14 @@ void ShipRenderContext::UploadPointColors(
 {
     assert(startDst + count <= mPointCount);
 
+    // Pack color range into RGBA8
+    rgbaColor * restrict pDst = &(mPointColorBuffer.get()[startDst]);
+    for (size_t i = 0; i < count; ++i)
+        pDst[i] = rgbaColor(color[i]);
+
     // Upload color range
     glBindBuffer(GL_ARRAY_BUFFER, *mPointColorVBO);
-    glBufferSubData(GL_ARRAY_BUFFER, startDst * sizeof(vec4f), count * sizeof(vec4f), color);
+    glBufferSubData(GL_ARRAY_BUFFER, startDst * sizeof(rgbaColor), count * sizeof(rgbaColor), pDst);
     CheckOpenGLError();
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -755,24 +942,29 @@ void ShipRenderContext::UploadPointColors(
 
 void ShipRenderContext::UploadElementsStart()
 {
-    // Empty all buffers - except triangles - as elements will be completely re-populated soon
-    // (with a yet-unknown quantity of elements);
+    // Empty all buffers - except triangles and stressed springs - as elements will be completely
+    // re-populated soon (with a yet-unknown quantity of elements);
     //
-    // if the client does not upload new triangles, it means we have to reuse the last known set
+    // if the client does not upload new triangles, it means we have to reuse the last known set;
+    // stressed springs are only uploaded when they change
 
     mPointElementBuffer.clear();
     mSpringElementBuffer.clear();
     mRopeElementBuffer.clear();
-    mStressedSpringElementBuffer.clear();
 }
 
-void ShipRenderContext::UploadElementTrianglesStart(size_t trianglesCount)
+void ShipRenderContext::UploadElementTrianglesStart(size_t triangleCount)
 {
-    // Client wants to upload a new set of triangles
-    //
-    // No need to clear, we'll repopulate everything
+    // Client wants to upload a new set of triangles; the ones that
+    // do not get uploaded stay degenerate
+
+    mTriangleElementBuffer.resize(triangleCount);
+    std::fill(
+        mTriangleElementBuffer.begin(),
+        mTriangleElementBuffer.end(),
+        TriangleElement{ 0, 0, 0 });
 
-    mTriangleElementBuffer.resize(trianglesCount);
+    mTriangleElementCount = 0;
 }
 
 void ShipRenderContext::UploadElementTrianglesEnd()
@@ -795,20 +987,61 @@ void ShipRenderContext::UploadElementsEnd(bool doFinalizeEphemeralPoints)
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mElementVBO);
 
-    // Allocate whole buffer, including room for all possible ephemeral points
-    glBufferData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        mEphemeralPointElementVBOStartIndex + GameParameters::MaxEphemeralParticles * sizeof(PointElement),
-        nullptr,
-        GL_STATIC_DRAW);
-    CheckOpenGLError();
+    // (Re-)allocate whole buffer only if it's too small, including room for all possible
+    // ephemeral points; this loses all of the triangles we've uploaded so far
+    size_t const requiredElementVBOSize =
+        mEphemeralPointElementVBOStartIndex + GameParameters::MaxEphemeralParticles * sizeof(PointElement);
+    if (requiredElementVBOSize > mElementVBOAllocatedSize)
+    {
+        mElementVBOAllocatedSize = CalculateGrownCapacity(requiredElementVBOSize, mElementVBOAllocatedSize);
 
-    // Upload triangles
-    glBufferSubData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        mTriangleElementVBOStartIndex,
-        mTriangleElementBuffer.size() * sizeof(TriangleElement),
-        mTriangleElementBuffer.data());
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            mElementVBOAllocatedSize,
+            nullptr,
+            GL_DYNAMIC_DRAW);
+        CheckOpenGLError();
+
+        mUploadedTriangleElementBuffer.clear();
+    }
+
+    // Upload triangles - only the chunks whose triangles differ from the uploaded ones
+    if (mUploadedTriangleElementBuffer.size() != mTriangleElementBuffer.size())
+    {
+        glBufferSubData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            mTriangleElementVBOStartIndex,
+            mTriangleElementBuffer.size() * sizeof(TriangleElement),
+            mTriangleElementBuffer.data());
+
+        mUploadedTriangleElementBuffer = mTriangleElementBuffer;
+    }
+    else
+    {
+        for (size_t chunkStart = 0; chunkStart < mTriangleElementBuffer.size(); chunkStart += TriangleUploadChunkSize)
+        {
+            size_t const chunkSize =
+                std::min(TriangleUploadChunkSize, mTriangleElementBuffer.size() - chunkStart)
+                * sizeof(TriangleElement);
+
+            if (0 != std::memcmp(
+                &(mTriangleElementBuffer[chunkStart]),
+                &(mUploadedTriangleElementBuffer[chunkStart]),
+                chunkSize))
+            {
+                glBufferSubData(
+                    GL_ELEMENT_ARRAY_BUFFER,
+                    mTriangleElementVBOStartIndex + chunkStart * sizeof(TriangleElement),
+                    chunkSize,
+                    &(mTriangleElementBuffer[chunkStart]));
+
+                std::memcpy(
+                    &(mUploadedTriangleElementBuffer[chunkStart]),
+                    &(mTriangleElementBuffer[chunkStart]),
+                    chunkSize);
+            }
+        }
+    }
 
     // Upload ropes
     glBufferSubData(
@@ -862,11 +1095,26 @@ void ShipRenderContext::UploadElementStressedSpringsEnd()
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mStressedSpringElementVBO);
 
+    // Grow the buffer if it's too small, otherwise orphan it, as we
+    // re-specify all of its contents anyway
+    if (mStressedSpringElementBuffer.size() > mStressedSpringElementVBOAllocatedCount)
+    {
+        mStressedSpringElementVBOAllocatedCount = CalculateGrownCapacity(
+            mStressedSpringElementBuffer.size(),
+            mStressedSpringElementVBOAllocatedCount);
+    }
+
     glBufferData(
         GL_ELEMENT_ARRAY_BUFFER,
-        mStressedSpringElementBuffer.size() * sizeof(LineElement),
-        mStressedSpringElementBuffer.data(),
+        mStressedSpringElementVBOAllocatedCount * sizeof(LineElement),
+        nullptr,
         GL_STREAM_DRAW);
+
+    glBufferSubData(
+        GL_ELEMENT_ARRAY_BUFFER,
+        0,
+        mStressedSpringElementBuffer.size() * sizeof(LineElement),
+        mStressedSpringElementBuffer.data());
     CheckOpenGLError();
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -896,57 +1144,66 @@ void ShipRenderContext::UploadElementEphemeralPointsEnd()
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void ShipRenderContext::UploadLampsStart(size_t lampCount)
+{
+    mLampBuffer.clear();
+    mLampBuffer.reserve(std::min(lampCount, MaxLamps) * 2);
+}
+
+void ShipRenderContext::UploadLampsEnd()
+{
+    size_t const lampCount = mLampBuffer.size() / 2;
+
+    if (lampCount > 0)
+    {
+        mShaderManager.ActivateTexture<ProgramParameterType::ShipLampsTexture>();
+        glBindTexture(GL_TEXTURE_2D, *mLampsTextureOpenGLHandle);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, static_cast<GLsizei>(mLampBuffer.size()), 1, 0, GL_RGBA, GL_FLOAT, mLampBuffer.data());
+        CheckOpenGLError();
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // Leave the shared unit active, as others expect
+        mShaderManager.ActivateTexture<ProgramParameterType::SharedTexture>();
+    }
+
+    mLampCount = lampCount;
+}
+
 void ShipRenderContext::UploadVectors(
     size_t count,
-    vec2f const * position,
-    float const * planeId,
     vec2f const * vector,
     float lengthAdjustment,
     vec4f const & color)
 {
-    static float const CosAlphaLeftRight = cos(-2.f * Pi<float> / 8.f);
-    static float const SinAlphaLeft = sin(-2.f * Pi<float> / 8.f);
-    static float const SinAlphaRight = -SinAlphaLeft;
-
-    static vec2f const XMatrixLeft = vec2f(CosAlphaLeftRight, SinAlphaLeft);
-    static vec2f const YMatrixLeft = vec2f(-SinAlphaLeft, CosAlphaLeftRight);
-    static vec2f const XMatrixRight = vec2f(CosAlphaLeftRight, SinAlphaRight);
-    static vec2f const YMatrixRight = vec2f(-SinAlphaRight, CosAlphaLeftRight);
+    assert(count <= mPointCount);
 
     //
-    // Create buffer with endpoint positions of each segment of each arrow
+    // Upload the vectors as they are; the arrows are made out of them
+    // by the shader
     //
 
-    mVectorArrowVertexBuffer.clear();
-    mVectorArrowVertexBuffer.reserve(count * 3 * 2);
+    glBindBuffer(GL_ARRAY_BUFFER, *mVectorArrowInstanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(vec2f), vector);
+    CheckOpenGLError();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    for (size_t i = 0; i < count; ++i)
-    {
-        // Stem
-        vec2f stemEndpoint = position[i] + vector[i] * lengthAdjustment;
-        mVectorArrowVertexBuffer.emplace_back(position[i], planeId[i]);
-        mVectorArrowVertexBuffer.emplace_back(stemEndpoint, planeId[i]);
-
-        // Left
-        vec2f leftDir = vec2f(-vector[i].dot(XMatrixLeft), -vector[i].dot(YMatrixLeft)).normalise();
-        mVectorArrowVertexBuffer.emplace_back(stemEndpoint, planeId[i]);
-        mVectorArrowVertexBuffer.emplace_back(stemEndpoint + leftDir * 0.2f, planeId[i]);
-
-        // Right
-        vec2f rightDir = vec2f(-vector[i].dot(XMatrixRight), -vector[i].dot(YMatrixRight)).normalise();
-        mVectorArrowVertexBuffer.emplace_back(stemEndpoint, planeId[i]);
-        mVectorArrowVertexBuffer.emplace_back(stemEndpoint + rightDir * 0.2f, planeId[i]);
-    }
+    mVectorArrowCount = count;
 
 
     //
-    // Upload buffer
+    // Manage length adjustment
     //
 
-    glBindBuffer(GL_ARRAY_BUFFER, *mVectorArrowVBO);
-    glBufferData(GL_ARRAY_BUFFER, mVectorArrowVertexBuffer.size() * sizeof(vec3f), mVectorArrowVertexBuffer.data(), GL_DYNAMIC_DRAW);
-    CheckOpenGLError();
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (mVectorArrowLengthAdjustment != lengthAdjustment)
+    {
+        mShaderManager.ActivateProgram<ProgramType::ShipVectors>();
+        mShaderManager.SetProgramParameter<ProgramType::ShipVectors, ProgramParameterType::VectorLengthAdjustment>(
+            lengthAdjustment);
+
+        mVectorArrowLengthAdjustment = lengthAdjustment;
+    }
 
 
     //
@@ -966,214 +1223,220 @@ void ShipRenderContext::UploadVectors(
     }
 }
 
-void ShipRenderContext::RenderEnd()
+void ShipRenderContext::RenderTriangles()
 {
+    if (mIsCulled)
+        return;
+
     //
-    // Draw ship elements
+    // Draw triangles
+    //
+    // Best to draw triangles (temporally) before springs and ropes, otherwise
+    // the latter, which use anti-aliasing, would end up being contoured with background
+    // when drawn Z-ally over triangles
+    //
+    // Also, edge springs might just contain transparent pixels (when textured), which
+    // would result in the same artifact
     //
 
-    glBindVertexArray(*mShipVAO);
-
+    if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe
+        || mDebugShipRenderMode == DebugShipRenderMode::Decay
+        || mDebugShipRenderMode == DebugShipRenderMode::None)
     {
-        //
-        // Bind element VBO
-        //
-        // NOTE: Intel drivers have a bug in the VAO ARB: they do not store the ELEMENT_ARRAY_BUFFER binding
-        // in the VAO
-        //
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mElementVBO);
-
+        BindShipElements();
 
-        //
-        // Bind ship texture
-        //
-
-        assert(!!mShipTextureOpenGLHandle);
-
-        mShaderManager.ActivateTexture<ProgramParameterType::SharedTexture>();
-        glBindTexture(GL_TEXTURE_2D, *mShipTextureOpenGLHandle);
-
-
-
-        //
-        // Draw triangles
-        //
-        // Best to draw triangles (temporally) before springs and ropes, otherwise
-        // the latter, which use anti-aliasing, would end up being contoured with background
-        // when drawn Z-ally over triangles
-        //
-        // Also, edge springs might just contain transparent pixels (when textured), which
-        // would result in the same artifact
-        //
-
-        if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe
-            || mDebugShipRenderMode == DebugShipRenderMode::Decay
-            || mDebugShipRenderMode == DebugShipRenderMode::None)
+        if (mDebugShipRenderMode == DebugShipRenderMode::Decay)
         {
-            if (mDebugShipRenderMode == DebugShipRenderMode::Decay)
+            // Use decay program
+            ActivateShipProgram<ProgramType::ShipTrianglesDecay>(TrianglesLayer);
+        }
+        else
+        {
+            if (GetEffectiveShipRenderMode() == ShipRenderMode::Texture)
             {
-                // Use decay program
-                mShaderManager.ActivateProgram<ProgramType::ShipTrianglesDecay>();
+                // Use texture program
+                ActivateShipProgram<ProgramType::ShipTrianglesTexture>(TrianglesLayer);
             }
             else
             {
-                if (mShipRenderMode == ShipRenderMode::Texture)
-                {
-                    // Use texture program
-                    mShaderManager.ActivateProgram<ProgramType::ShipTrianglesTexture>();
-                }
-                else
-                {
-                    // Use color program
-                    mShaderManager.ActivateProgram<ProgramType::ShipTrianglesColor>();
-                }
+                // Use color program
+                ActivateShipProgram<ProgramType::ShipTrianglesColor>(TrianglesLayer);
             }
+        }
 
-            if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
-                glLineWidth(0.1f);
-
-            glDrawElements(
-                GL_TRIANGLES,
-                static_cast<GLsizei>(3 * mTriangleElementBuffer.size()),
-                GL_UNSIGNED_INT,
-                (GLvoid *)mTriangleElementVBOStartIndex);
+        if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
+            glLineWidth(0.1f);
 
-            // Update stats
-            mRenderStatistics.LastRenderedShipTriangles += mTriangleElementBuffer.size();
-        }
+        glDrawElements(
+            GL_TRIANGLES,
+            static_cast<GLsizei>(3 * mTriangleElementBuffer.size()),
+            ElementIndexGLType,
+            (GLvoid *)mTriangleElementVBOStartIndex);
 
+        glBindVertexArray(0);
 
+        // Update stats
+        mRenderStatistics.LastRenderedShipTriangles += mTriangleElementCount;
+    }
+}
 
-        //
-        // Set line width, for ropes and springs
-        //
+void ShipRenderContext::RenderRopes()
+{
+    if (mIsCulled || mIsLowDetail || IsZoomedOutLevelOfDetail())
+        return;
 
-        glLineWidth(0.1f * 2.0f * mViewModel.GetCanvasToVisibleWorldHeightRatio());
+    //
+    // Draw ropes, unless it's a debug mode
+    //
+    // Note: when DebugRenderMode is springs|edgeSprings, ropes would all be uploaded
+    // as springs.
+    //
 
+    if (mDebugShipRenderMode == DebugShipRenderMode::None)
+    {
+        BindShipElements();
 
+        ActivateShipProgram<ProgramType::ShipRopes>(RopesLayer);
 
-        //
-        // Draw ropes, unless it's a debug mode
-        //
-        // Note: when DebugRenderMode is springs|edgeSprings, ropes would all be uploaded
-        // as springs.
-        //
+        glLineWidth(0.1f * 2.0f * mViewModel.GetCanvasToVisibleWorldHeightRatio());
 
-        if (mDebugShipRenderMode == DebugShipRenderMode::None)
-        {
-            mShaderManager.ActivateProgram<ProgramType::ShipRopes>();
+        glDrawElements(
+            GL_LINES,
+            static_cast<GLsizei>(2 * mRopeElementBuffer.size()),
+            ElementIndexGLType,
+            (GLvoid *)mRopeElementVBOStartIndex);
 
-            glDrawElements(
-                GL_LINES,
-                static_cast<GLsizei>(2 * mRopeElementBuffer.size()),
-                GL_UNSIGNED_INT,
-                (GLvoid *)mRopeElementVBOStartIndex);
+        glBindVertexArray(0);
 
-            // Update stats
-            mRenderStatistics.LastRenderedShipRopes += mRopeElementBuffer.size();
-        }
+        // Update stats
+        mRenderStatistics.LastRenderedShipRopes += mRopeElementBuffer.size();
+    }
+}
 
+void ShipRenderContext::RenderSprings()
+{
+    if (mIsCulled || mIsLowDetail || IsZoomedOutLevelOfDetail())
+        return;
 
+    //
+    // Draw springs
+    //
+    // We draw springs when:
+    // - DebugRenderMode is springs|edgeSprings, in which case we use colors - so to show
+    //   structural springs -, or
+    // - RenderMode is structure (so to draw 1D chains), in which case we use colors, or
+    // - RenderMode is texture (so to draw 1D chains), in which case we use texture iff it is present
+    //
+    // Note: when DebugRenderMode is springs|edgeSprings, ropes would all be here.
+    //
 
-        //
-        // Draw springs
-        //
-        // We draw springs when:
-        // - DebugRenderMode is springs|edgeSprings, in which case we use colors - so to show
-        //   structural springs -, or
-        // - RenderMode is structure (so to draw 1D chains), in which case we use colors, or
-        // - RenderMode is texture (so to draw 1D chains), in which case we use texture iff it is present
-        //
-        // Note: when DebugRenderMode is springs|edgeSprings, ropes would all be here.
-        //
+    if (mDebugShipRenderMode == DebugShipRenderMode::Springs
+        || mDebugShipRenderMode == DebugShipRenderMode::EdgeSprings
+        || (mDebugShipRenderMode == DebugShipRenderMode::None
+            && (mShipRenderMode == ShipRenderMode::Structure || mShipRenderMode == ShipRenderMode::Texture)))
+    {
+        BindShipElements();
 
-        if (mDebugShipRenderMode == DebugShipRenderMode::Springs
-            || mDebugShipRenderMode == DebugShipRenderMode::EdgeSprings
-            || (mDebugShipRenderMode == DebugShipRenderMode::None
-                && (mShipRenderMode == ShipRenderMode::Structure || mShipRenderMode == ShipRenderMode::Texture)))
+        if (mDebugShipRenderMode == DebugShipRenderMode::None && GetEffectiveShipRenderMode() == ShipRenderMode::Texture)
         {
-            if (mDebugShipRenderMode == DebugShipRenderMode::None && mShipRenderMode == ShipRenderMode::Texture)
-            {
-                // Use texture program
-                mShaderManager.ActivateProgram<ProgramType::ShipSpringsTexture>();
-            }
-            else
-            {
-                // Use color program
-                mShaderManager.ActivateProgram<ProgramType::ShipSpringsColor>();
-            }
+            // Use texture program
+            ActivateShipProgram<ProgramType::ShipSpringsTexture>(SpringsLayer);
+        }
+        else
+        {
+            // Use color program
+            ActivateShipProgram<ProgramType::ShipSpringsColor>(SpringsLayer);
+        }
 
-            glDrawElements(
-                GL_LINES,
-                static_cast<GLsizei>(2 * mSpringElementBuffer.size()),
-                GL_UNSIGNED_INT,
-                (GLvoid *)mSpringElementVBOStartIndex);
+        glLineWidth(0.1f * 2.0f * mViewModel.GetCanvasToVisibleWorldHeightRatio());
 
-            // Update stats
-            mRenderStatistics.LastRenderedShipSprings += mSpringElementBuffer.size();
-        }
+        glDrawElements(
+            GL_LINES,
+            static_cast<GLsizei>(2 * mSpringElementBuffer.size()),
+            ElementIndexGLType,
+            (GLvoid *)mSpringElementVBOStartIndex);
 
+        glBindVertexArray(0);
 
+        // Update stats
+        mRenderStatistics.LastRenderedShipSprings += mSpringElementBuffer.size();
+    }
+}
 
-        //
-        // Draw stressed springs
-        //
+void ShipRenderContext::RenderStressedSprings()
+{
+    if (mIsCulled || mIsLowDetail)
+        return;
 
-        if (mShowStressedSprings
-            && !mStressedSpringElementBuffer.empty())
-        {
-            mShaderManager.ActivateProgram<ProgramType::ShipStressedSprings>();
+    //
+    // Draw stressed springs
+    //
 
-            // Bind stressed spring texture
-            mShaderManager.ActivateTexture<ProgramParameterType::SharedTexture>();
-            glBindTexture(GL_TEXTURE_2D, *mStressedSpringTextureOpenGLHandle);
-            CheckOpenGLError();
+    if (mShowStressedSprings
+        && !mStressedSpringElementBuffer.empty())
+    {
+        glBindVertexArray(*mShipVAO);
 
-            // Bind stressed spring VBO
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mStressedSpringElementVBO);
+        ActivateShipProgram<ProgramType::ShipStressedSprings>(StressedSpringsLayer);
 
-            // Draw
-            glDrawElements(
-                GL_LINES,
-                static_cast<GLsizei>(2 * mStressedSpringElementBuffer.size()),
-                GL_UNSIGNED_INT,
-                (GLvoid *)0);
+        // Bind stressed spring texture
+        mShaderManager.ActivateTexture<ProgramParameterType::SharedTexture>();
+        glBindTexture(GL_TEXTURE_2D, *mStressedSpringTextureOpenGLHandle);
+        CheckOpenGLError();
 
-            // Bind again element VBO
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mElementVBO);
-        }
+        // Bind stressed spring VBO
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mStressedSpringElementVBO);
 
+        glLineWidth(0.1f * 2.0f * mViewModel.GetCanvasToVisibleWorldHeightRatio());
 
+        // Draw
+        glDrawElements(
+            GL_LINES,
+            static_cast<GLsizei>(2 * mStressedSpringElementBuffer.size()),
+            ElementIndexGLType,
+            (GLvoid *)0);
 
-        //
-        // Draw points (orphaned/all non-ephemerals, and ephemerals)
-        //
+        glBindVertexArray(0);
+    }
+}
 
-        if (mDebugShipRenderMode == DebugShipRenderMode::None
-            || mDebugShipRenderMode == DebugShipRenderMode::Points)
-        {
-            auto const totalPoints = mPointElementBuffer.size() + mEphemeralPointElementBuffer.size();
+void ShipRenderContext::RenderPoints()
+{
+    if (mIsCulled || mIsLowDetail || IsZoomedOutLevelOfDetail())
+        return;
+
+    //
+    // Draw points (orphaned/all non-ephemerals, and ephemerals)
+    //
 
-            mShaderManager.ActivateProgram<ProgramType::ShipPointsColor>();
+    if (mDebugShipRenderMode == DebugShipRenderMode::None
+        || mDebugShipRenderMode == DebugShipRenderMode::Points)
+    {
+        BindShipElements();
 
-            glPointSize(0.3f * mViewModel.GetCanvasToVisibleWorldHeightRatio());
+        auto const totalPoints = mPointElementBuffer.size() + mEphemeralPointElementBuffer.size();
 
-            glDrawElements(
-                GL_POINTS,
-                static_cast<GLsizei>(1 * totalPoints),
-                GL_UNSIGNED_INT,
-                (GLvoid *)mPointElementVBOStartIndex);
+        ActivateShipProgram<ProgramType::ShipPointsColor>(PointsLayer);
 
-            // Update stats
-            mRenderStatistics.LastRenderedShipPoints += totalPoints;
-        }
+        glPointSize(0.3f * mViewModel.GetCanvasToVisibleWorldHeightRatio());
+
+        glDrawElements(
+            GL_POINTS,
+            static_cast<GLsizei>(1 * totalPoints),
+            ElementIndexGLType,
+            (GLvoid *)mPointElementVBOStartIndex);
 
-        // We are done with the ship VAO
         glBindVertexArray(0);
-    }
 
+        // Update stats
+        mRenderStatistics.LastRenderedShipPoints += totalPoints;
+    }
+}
 
+void ShipRenderContext::RenderEnd()
+{
+    if (mIsCulled)
+        return;
 
     //
     // Render generic textures
@@ -1201,6 +1464,68 @@ void ShipRenderContext::RenderEnd()
     mRenderStatistics.LastRenderedShipPlanes += mMaxMaxPlaneId + 1;
 }
 
+bool ShipRenderContext::StreamShipTexture()
+{
+    if (!mShipTextureStreamer)
+        return false;
+
+    mShaderManager.ActivateTexture<ProgramParameterType::SharedTexture>();
+    glBindTexture(GL_TEXTURE_2D, *mShipTextureOpenGLHandle);
+
+    if (mShipTextureStreamer->UploadSlice(ShipTextureStreamingSliceByteSize))
+    {
+        if (DoesDeferShipTextureBaseLevel())
+        {
+            // The base level waits for the camera to zoom in
+            mShipTextureDeferredBaseLevel.emplace(mShipTextureStreamer->TakeBaseTexture());
+        }
+
+        mShipTextureStreamer.reset();
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return !!mShipTextureStreamer;
+}
+
+void ShipRenderContext::BindShipElements()
+{
+    glBindVertexArray(*mShipVAO);
+
+    //
+    // Bind element VBO
+    //
+    // NOTE: Intel drivers have a bug in the VAO ARB: they do not store the ELEMENT_ARRAY_BUFFER binding
+    // in the VAO
+    //
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *mElementVBO);
+
+    //
+    // Bind lamps texture - all ships share its unit
+    //
+
+    mShaderManager.ActivateTexture<ProgramParameterType::ShipLampsTexture>();
+    glBindTexture(GL_TEXTURE_2D, *mLampsTextureOpenGLHandle);
+
+    //
+    // Bind ship texture
+    //
+
+    assert(!!mShipTextureOpenGLHandle);
+
+    mShaderManager.ActivateTexture<ProgramParameterType::SharedTexture>();
+    glBindTexture(GL_TEXTURE_2D, *mShipTextureOpenGLHandle);
+
+    if (!!mShipTextureDeferredBaseLevel
+        && mViewModel.GetCanvasToVisibleWorldHeightRatio() > mShipTextureDeferredBaseLevelMinCanvasToVisibleWorldRatio)
+    {
+        // We're zoomed in enough to need the base level now
+        GameOpenGL::UploadDeferredTextureBaseLevel(std::move(*mShipTextureDeferredBaseLevel));
+        mShipTextureDeferredBaseLevel.reset();
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 void ShipRenderContext::RenderGenericTextures()
@@ -1209,53 +1534,55 @@ void ShipRenderContext::RenderGenericTextures()
     {
         glBindVertexArray(*mGenericTextureVAO);
 
-        mShaderManager.ActivateProgram<ProgramType::ShipGenericTextures>();
+        ActivateShipProgram<ProgramType::ShipGenericTextures>(GenericTexturesLayer);
 
         if (mDebugShipRenderMode == DebugShipRenderMode::Wireframe)
             glLineWidth(0.1f);
 
         // Bind VBO
-        glBindBuffer(GL_ARRAY_BUFFER, *mGenericTextureVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, *mGenericTextureInstanceVBO);
 
         //
-        // Upload vertex buffers
+        // Upload instances
         //
 
-        // (Re-)Allocate vertex buffer, if needed
-        if (mGenericTextureVBOAllocatedQuadCount != mGenericTextureQuadCount)
+        // Grow instance buffer, if needed; it never shrinks, so that in steady state
+        // we only ever re-specify its contents
+        if (mGenericTextureInstanceVBOAllocatedQuadCount < mGenericTextureQuadCount)
         {
-            glBufferData(GL_ARRAY_BUFFER, mGenericTextureQuadCount * 6 * sizeof(GenericTextureVertex), nullptr, GL_DYNAMIC_DRAW);
-            CheckOpenGLError();
+            mGenericTextureInstanceVBOAllocatedQuadCount = CalculateGrownCapacity(
+                mGenericTextureQuadCount,
+                mGenericTextureInstanceVBOAllocatedQuadCount);
 
-            mGenericTextureVBOAllocatedQuadCount = mGenericTextureQuadCount;
+            glBufferData(GL_ARRAY_BUFFER, mGenericTextureInstanceVBOAllocatedQuadCount * sizeof(GenericTextureInstance), nullptr, GL_STREAM_DRAW);
+            CheckOpenGLError();
         }
 
-        // Map vertex buffer
-        auto mappedBuffer = reinterpret_cast<uint8_t *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
-        CheckOpenGLError();
-
-        // Copy all buffers
-        for (auto const & plane : mGenericTexturePlaneVertexBuffers)
+        // Sub-allocate all planes, in order
+        size_t instanceOffset = 0;
+        for (auto const & plane : mGenericTexturePlaneInstanceBuffers)
         {
-            if (!plane.vertexBuffer.empty())
+            if (!plane.instanceBuffer.empty())
             {
-                size_t const byteCopySize = plane.vertexBuffer.size() * sizeof(GenericTextureVertex);
-                std::memcpy(mappedBuffer, plane.vertexBuffer.data(), byteCopySize);
-
-                // Advance
-                mappedBuffer += byteCopySize;
+                glBufferSubData(
+                    GL_ARRAY_BUFFER,
+                    instanceOffset * sizeof(GenericTextureInstance),
+                    plane.instanceBuffer.size() * sizeof(GenericTextureInstance),
+                    plane.instanceBuffer.data());
+                CheckOpenGLError();
+
+                instanceOffset += plane.instanceBuffer.size();
             }
         }
 
-        // Unmap vertex buffer
-        glUnmapBuffer(GL_ARRAY_BUFFER);
+        assert(instanceOffset == mGenericTextureQuadCount);
 
 
         //
         // Render
         //
 
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(mGenericTextureQuadCount * 6));
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(mGenericTextureQuadCount));
 
 
         //
@@ -1272,11 +1599,11 @@ void ShipRenderContext::RenderVectorArrows()
 {
     glBindVertexArray(*mVectorArrowVAO);
 
-    mShaderManager.ActivateProgram<ProgramType::ShipVectors>();
+    ActivateShipProgram<ProgramType::ShipVectors>(VectorsLayer);
 
     glLineWidth(0.5f);
 
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(mVectorArrowVertexBuffer.size()));
+    glDrawArraysInstanced(GL_LINES, 0, 6, static_cast<GLsizei>(mVectorArrowCount));
 
     glBindVertexArray(0);
 }
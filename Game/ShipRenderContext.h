@@ -11,19 +11,26 @@
 #include "ViewModel.h"
 
 #include <GameOpenGL/GameOpenGL.h>
+#include <GameOpenGL/GameOpenGLBufferRecycler.h>
+#include <GameOpenGL/GameOpenGLTextureStreamer.h>
 #include <GameOpenGL/ShaderManager.h>
 
 #include <GameCore/BoundedVector.h>
+#include <GameCore/Colors.h>
 #include <GameCore/GameTypes.h>
 #include <GameCore/ImageData.h>
+#include <GameCore/MemoryReport.h>
 #include <GameCore/SysSpecifics.h>
 #include <GameCore/Vectors.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace Render {
@@ -36,9 +43,11 @@ public:
         ShipId shipId,
         size_t shipCount,
         size_t pointCount,
+        ImageSize shipStructureSize,
         RgbaImageData shipTexture,
         ShipDefinition::TextureOriginType textureOrigin,
         ShaderManager<ShaderManagerTraits> & shaderManager,
+        GameOpenGLBufferRecycler & bufferRecycler,
         GameOpenGLTexture & genericTextureAtlasOpenGLHandle,
         TextureAtlasMetadata const & genericTextureAtlasMetadata,
         RenderStatistics & renderStatistics,
@@ -54,6 +63,18 @@ public:
 
     ~ShipRenderContext();
 
+    /*
+     * Adds the CPU-side buffers to the report under "CPU/Ship <id>/Render", and the
+     * (estimated) sizes of the GPU buffers and textures under "GPU/Ship <id>"; to be
+     * invoked at the root of the report.
+     */
+    void ReportMemory(MemoryReport & report) const;
+
+    size_t GetPointCount() const
+    {
+        return mPointCount;
+    }
+
 public:
 
     void OnViewModelUpdated()
@@ -124,7 +145,22 @@ public:
 
 public:
 
-    void RenderStart(PlaneId maxMaxPlaneId);
+    /*
+     * Doesn't touch OpenGL; returns true when the view model parameters have to be
+     * recalculated, via OnViewModelUpdated().
+     */
+    bool RenderStart(
+        PlaneId maxMaxPlaneId,
+        bool isLowDetail);
+
+    /*
+     * Invoked in lieu of RenderStart() when the ship is entirely out of view;
+     * nothing is uploaded for the ship and none of its elements is drawn in this frame.
+     */
+    void RenderCulled()
+    {
+        mIsCulled = true;
+    }
 
     //
     // Points
@@ -139,6 +175,17 @@ public:
         float const * light,
         float const * water);
 
+    /*
+     * As above, but the positions of the first points are copied from the specified
+     * buffer, on the GPU; only the positions of the remaining points are taken from
+     * the CPU.
+     */
+    void UploadPointMutableAttributes(
+        ShipPointPositionBuffer const & positionBuffer,
+        vec2f const * position,
+        float const * light,
+        float const * water);
+
     void UploadPointMutableAttributesPlaneId(
         float const * planeId,
         size_t startDst,
@@ -166,36 +213,72 @@ public:
      */
     void UploadElementsStart();
 
-    inline void UploadElementPoint(int pointIndex)
+    inline void UploadElementPoint(ElementIndex pointIndex)
     {
         mPointElementBuffer.emplace_back(pointIndex);
     }
 
+    inline void UploadElementPoints(
+        ElementIndex const * pointIndices,
+        size_t pointCount)
+    {
+        AppendElements(mPointElementBuffer, pointIndices, pointCount);
+    }
+
     inline void UploadElementSpring(
-        int pointIndex1,
-        int pointIndex2)
+        ElementIndex pointIndex1,
+        ElementIndex pointIndex2)
     {
         mSpringElementBuffer.emplace_back(
             pointIndex1,
             pointIndex2);
     }
 
+    /*
+     * Takes the two endpoints of each spring, one spring after the other.
+     */
+    inline void UploadElementSprings(
+        ElementIndex const * pointIndexPairs,
+        size_t springCount)
+    {
+        AppendElements(mSpringElementBuffer, pointIndexPairs, springCount);
+    }
+
     inline void UploadElementRope(
-        int pointIndex1,
-        int pointIndex2)
+        ElementIndex pointIndex1,
+        ElementIndex pointIndex2)
     {
         mRopeElementBuffer.emplace_back(
             pointIndex1,
             pointIndex2);
     }
 
-    void UploadElementTrianglesStart(size_t trianglesCount);
+    /*
+     * Takes the two endpoints of each rope, one rope after the other.
+     */
+    inline void UploadElementRopes(
+        ElementIndex const * pointIndexPairs,
+        size_t ropeCount)
+    {
+        AppendElements(mRopeElementBuffer, pointIndexPairs, ropeCount);
+    }
+
+    /*
+     * Signals that a new set of triangles will be uploaded, each at its own index - in any
+     * stable order - in [0, triangleCount); the indices that do not get uploaded are
+     * rendered as nothing.
+     *
+     * Triangles need not be grouped by plane, as the depth test takes care of planes; hence
+     * a change to one triangle never moves any other, and only the chunks of the element
+     * buffer whose triangles have changed get re-uploaded.
+     */
+    void UploadElementTrianglesStart(size_t triangleCount);
 
     inline void UploadElementTriangle(
         size_t triangleIndex,
-        int pointIndex1,
-        int pointIndex2,
-        int pointIndex3)
+        ElementIndex pointIndex1,
+        ElementIndex pointIndex2,
+        ElementIndex pointIndex3)
     {
         assert(triangleIndex < mTriangleElementBuffer.size());
 
@@ -204,6 +287,8 @@ public:
         triangleElement.pointIndex1 = pointIndex1;
         triangleElement.pointIndex2 = pointIndex2;
         triangleElement.pointIndex3 = pointIndex3;
+
+        ++mTriangleElementCount;
     }
 
     void UploadElementTrianglesEnd();
@@ -217,8 +302,8 @@ public:
     void UploadElementStressedSpringsStart();
 
     inline void UploadElementStressedSpring(
-        int pointIndex1,
-        int pointIndex2)
+        ElementIndex pointIndex1,
+        ElementIndex pointIndex2)
     {
         mStressedSpringElementBuffer.emplace_back(
             pointIndex1,
@@ -274,96 +359,27 @@ public:
         size_t const planeIndex = static_cast<size_t>(planeId);
 
         // Pre-sized
-        assert(planeIndex < mGenericTexturePlaneVertexBuffers.size());
-
-        // Get this plane's vertex buffer
-        auto & vertexBuffer = mGenericTexturePlaneVertexBuffers[planeIndex].vertexBuffer;
+        assert(planeIndex < mGenericTexturePlaneInstanceBuffers.size());
 
         //
-        // Populate the texture quad
+        // Store one instance of the texture quad; the vertex shader expands it
         //
 
         TextureAtlasFrameMetadata const & frame = mGenericTextureAtlasMetadata.GetFrameMetadata(textureFrameId);
 
-        float const leftX = -frame.FrameMetadata.AnchorWorldX;
-        float const rightX = frame.FrameMetadata.WorldWidth - frame.FrameMetadata.AnchorWorldX;
-        float const topY = frame.FrameMetadata.WorldHeight - frame.FrameMetadata.AnchorWorldY;
-        float const bottomY = -frame.FrameMetadata.AnchorWorldY;
-
-        float const lightSensitivity =
-            frame.FrameMetadata.HasOwnAmbientLight ? 0.0f : 1.0f;
-
-        // Append vertices - two triangles
-
-        // Triangle 1
-
-        // Top-left
-        vertexBuffer.emplace_back(
-            position,
-            vec2f(leftX, topY),
-            vec2f(frame.TextureCoordinatesBottomLeft.x, frame.TextureCoordinatesTopRight.y),
-            static_cast<float>(planeId),
-            scale,
-            angle,
-            alpha,
-            lightSensitivity);
-
-        // Top-Right
-        vertexBuffer.emplace_back(
+        mGenericTexturePlaneInstanceBuffers[planeIndex].instanceBuffer.emplace_back(
             position,
-            vec2f(rightX, topY),
-            frame.TextureCoordinatesTopRight,
             static_cast<float>(planeId),
             scale,
-            angle,
-            alpha,
-            lightSensitivity);
-
-        // Bottom-left
-        vertexBuffer.emplace_back(
-            position,
-            vec2f(leftX, bottomY),
+            -frame.FrameMetadata.AnchorWorldX, // Left
+            -frame.FrameMetadata.AnchorWorldY, // Bottom
+            frame.FrameMetadata.WorldWidth - frame.FrameMetadata.AnchorWorldX, // Right
+            frame.FrameMetadata.WorldHeight - frame.FrameMetadata.AnchorWorldY, // Top
             frame.TextureCoordinatesBottomLeft,
-            static_cast<float>(planeId),
-            scale,
-            angle,
-            alpha,
-            lightSensitivity);
-
-        // Triangle 2
-
-        // Top-Right
-        vertexBuffer.emplace_back(
-            position,
-            vec2f(rightX, topY),
             frame.TextureCoordinatesTopRight,
-            static_cast<float>(planeId),
-            scale,
             angle,
             alpha,
-            lightSensitivity);
-
-        // Bottom-left
-        vertexBuffer.emplace_back(
-            position,
-            vec2f(leftX, bottomY),
-            frame.TextureCoordinatesBottomLeft,
-            static_cast<float>(planeId),
-            scale,
-            angle,
-            alpha,
-            lightSensitivity);
-
-        // Bottom-right
-        vertexBuffer.emplace_back(
-            position,
-            vec2f(rightX, bottomY),
-            vec2f(frame.TextureCoordinatesTopRight.x, frame.TextureCoordinatesBottomLeft.y),
-            static_cast<float>(planeId),
-            scale,
-            angle,
-            alpha,
-            lightSensitivity);
+            frame.FrameMetadata.HasOwnAmbientLight ? 0.0f : 1.0f);
 
         // Update total count of quads
         ++mGenericTextureQuadCount;
@@ -376,7 +392,7 @@ public:
     void UploadElementEphemeralPointsStart();
 
     inline void UploadElementEphemeralPoint(
-        int pointIndex)
+        ElementIndex pointIndex)
     {
         mEphemeralPointElementBuffer.emplace_back(pointIndex);
     }
@@ -384,22 +400,106 @@ public:
     void UploadElementEphemeralPointsEnd();
 
 
+    //
+    // Lamps
+    //
+    // The lamps that the shaders light the ship with; at most MaxLamps,
+    // which must match MAX_SHIP_LAMPS in the shaders' static parameters
+    //
+
+    static constexpr size_t MaxLamps = 512;
+
+    void UploadLampsStart(size_t lampCount);
+
+    inline void UploadLamp(
+        vec2f const & position,
+        float light,
+        float lightExponent,
+        float planeId)
+    {
+        if (mLampBuffer.size() < MaxLamps * 2)
+        {
+            mLampBuffer.emplace_back(position.x, position.y, light, lightExponent);
+            mLampBuffer.emplace_back(planeId, 0.0f, 0.0f, 0.0f);
+        }
+    }
+
+    void UploadLampsEnd();
+
+
     //
     // Vectors
     //
 
+    /*
+     * Takes one vector for each of the first points; the vectors are drawn as arrows
+     * from the points' positions as last uploaded.
+     */
     void UploadVectors(
         size_t count,
-        vec2f const * position,
-        float const * planeId,
         vec2f const * vector,
         float lengthAdjustment,
         vec4f const & color);
 
+    //
+    // Ships are drawn one element type at a time, across all ships - all of the triangles first,
+    // then all of the ropes, and so on - so that each program is activated once per element
+    // type rather than once per ship
+    //
+
+    void RenderTriangles();
+    void RenderRopes();
+    void RenderSprings();
+    void RenderStressedSprings();
+    void RenderPoints();
+
     void RenderEnd();
 
+    /*
+     * Uploads the next slice of the ship's texture, if it's still being streamed in;
+     * returns true while it is.
+     */
+    bool StreamShipTexture();
+
+    bool IsStreamingShipTexture() const
+    {
+        return !!mShipTextureStreamer;
+    }
+
 private:
 
+    // Until the texture has been streamed in, texture mode falls back to structure mode
+    inline ShipRenderMode GetEffectiveShipRenderMode() const
+    {
+        return (mShipRenderMode == ShipRenderMode::Texture && !!mShipTextureStreamer)
+            ? ShipRenderMode::Structure
+            : mShipRenderMode;
+    }
+
+    // The Z layers of a plane, one for each type of rendering we do for a ship
+    static constexpr size_t RopesLayer = 0;
+    static constexpr size_t SpringsLayer = 1;
+    static constexpr size_t TrianglesLayer = 2;
+    static constexpr size_t StressedSpringsLayer = 3;
+    static constexpr size_t PointsLayer = 4;
+    static constexpr size_t GenericTexturesLayer = 5;
+    static constexpr size_t VectorsLayer = 6;
+    static constexpr size_t LayerCount = 7;
+
+    // The zoom (canvas pixels per world unit) under which ropes, springs and points - being
+    // a fraction of a pixel wide - are no longer drawn, and the ship is left to its triangles
+    static constexpr float ZoomedOutLevelOfDetailMaxCanvasToVisibleWorldRatio = 0.25f;
+
+    // The length of each side of the head of vector arrows, in world units
+    static constexpr float VectorArrowHeadSideLength = 0.2f;
+
+    inline bool IsZoomedOutLevelOfDetail() const
+    {
+        // Debug render modes are all about looking at those elements, hence we never thin them out
+        return mDebugShipRenderMode == DebugShipRenderMode::None
+            && mViewModel.GetCanvasToVisibleWorldHeightRatio() < ZoomedOutLevelOfDetailMaxCanvasToVisibleWorldRatio;
+    }
+
     void UpdateOrthoMatrices();
     void OnAmbientLightIntensityUpdated();
     void OnWaterColorUpdated();
@@ -409,6 +509,72 @@ private:
     void RenderGenericTextures();
     void RenderVectorArrows();
 
+    void BindShipElements();
+
+    void UploadPointLightAndWater(
+        float const * light,
+        float const * water);
+
+    /*
+     * Gets the capacity that a buffer has to grow to in order to fit the specified size;
+     * buffers grow geometrically and never shrink, so that while a ship grows or breaks
+     * apart they are seldom re-allocated, and in steady state never.
+     */
+    static inline size_t CalculateGrownCapacity(
+        size_t requiredSize,
+        size_t currentCapacity)
+    {
+        return std::max(
+            requiredSize,
+            currentCapacity + currentCapacity / 2);
+    }
+
+    /*
+     * Appends elements given as the point indices of each, one element after the other,
+     * which is how our elements are laid out - hence this is a plain copy.
+     */
+    template <typename TElement>
+    static inline void AppendElements(
+        std::vector<TElement> & elementBuffer,
+        ElementIndex const * pointIndices,
+        size_t elementCount)
+    {
+        static_assert(std::is_trivially_copyable_v<TElement>);
+        static_assert(sizeof(TElement) % sizeof(ElementIndex) == 0);
+
+        TElement const * const elements = reinterpret_cast<TElement const *>(pointIndices);
+
+        elementBuffer.insert(
+            elementBuffer.end(),
+            elements,
+            elements + elementCount);
+    }
+
+    /*
+     * Activates the specified program, setting into it the parameters that differ
+     * among ships.
+     */
+    template <ProgramType Program>
+    inline void ActivateShipProgram(size_t layer)
+    {
+        mShaderManager.ActivateProgram<Program>();
+
+        mShaderManager.SetProgramParameter<Program, ProgramParameterType::OrthoMatrix>(
+            mLayerOrthoMatrices[layer]);
+
+        if constexpr (
+            Program == ProgramType::ShipPointsColor
+            || Program == ProgramType::ShipRopes
+            || Program == ProgramType::ShipSpringsColor
+            || Program == ProgramType::ShipSpringsTexture
+            || Program == ProgramType::ShipTrianglesColor
+            || Program == ProgramType::ShipTrianglesTexture)
+        {
+            mShaderManager.SetProgramParameter<Program, ProgramParameterType::LampCount>(
+                static_cast<float>(mLampCount));
+        }
+    }
+
 private:
 
     ShipId const mShipId;
@@ -416,30 +582,41 @@ private:
     size_t const mPointCount;
     PlaneId mMaxMaxPlaneId;
 
+    // Whether the ship is out of view in the current frame, and whether it's
+    // so small on screen that only its triangles are worth drawing
+    bool mIsCulled;
+    bool mIsLowDetail;
+
+    // The ortho matrix of each layer of this ship
+    ViewModel::ProjectionMatrix mLayerOrthoMatrices[LayerCount];
+
 
     //
     // Types
     //
 
+    // The elements index points with the width of our element indices
+    static constexpr GLenum ElementIndexGLType = (sizeof(ElementIndex) == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
 #pragma pack(push)
 
     struct PointElement
     {
-        int pointIndex;
+        ElementIndex pointIndex;
 
-        PointElement(int _pointIndex)
+        PointElement(ElementIndex _pointIndex)
             : pointIndex(_pointIndex)
         {}
     };
 
     struct LineElement
     {
-        int pointIndex1;
-        int pointIndex2;
+        ElementIndex pointIndex1;
+        ElementIndex pointIndex2;
 
         LineElement(
-            int _pointIndex1,
-            int _pointIndex2)
+            ElementIndex _pointIndex1,
+            ElementIndex _pointIndex2)
             : pointIndex1(_pointIndex1)
             , pointIndex2(_pointIndex2)
         {}
@@ -447,38 +624,51 @@ private:
 
     struct TriangleElement
     {
-        int pointIndex1;
-        int pointIndex2;
-        int pointIndex3;
+        ElementIndex pointIndex1;
+        ElementIndex pointIndex2;
+        ElementIndex pointIndex3;
     };
 
-    struct GenericTextureVertex
+    struct GenericTextureInstance
     {
         vec2f centerPosition;
-        vec2f vertexOffset;
-        vec2f textureCoordinate;
-
         float planeId;
-
         float scale;
+
+        float frameLeftX;
+        float frameBottomY;
+        float frameRightX;
+        float frameTopY;
+
+        vec2f textureCoordinatesBottomLeft;
+        vec2f textureCoordinatesTopRight;
+
         float angle;
         float alpha;
         float ambientLightSensitivity;
 
-        GenericTextureVertex(
-            vec2f _centerPosition,
-            vec2f _vertexOffset,
-            vec2f _textureCoordinate,
+        GenericTextureInstance(
+            vec2f const & _centerPosition,
             float _planeId,
             float _scale,
+            float _frameLeftX,
+            float _frameBottomY,
+            float _frameRightX,
+            float _frameTopY,
+            vec2f const & _textureCoordinatesBottomLeft,
+            vec2f const & _textureCoordinatesTopRight,
             float _angle,
             float _alpha,
             float _ambientLightSensitivity)
             : centerPosition(_centerPosition)
-            , vertexOffset(_vertexOffset)
-            , textureCoordinate(_textureCoordinate)
             , planeId(_planeId)
             , scale(_scale)
+            , frameLeftX(_frameLeftX)
+            , frameBottomY(_frameBottomY)
+            , frameRightX(_frameRightX)
+            , frameTopY(_frameTopY)
+            , textureCoordinatesBottomLeft(_textureCoordinatesBottomLeft)
+            , textureCoordinatesTopRight(_textureCoordinatesTopRight)
             , angle(_angle)
             , alpha(_alpha)
             , ambientLightSensitivity(_ambientLightSensitivity)
@@ -489,33 +679,52 @@ private:
 
     struct GenericTexturePlaneData
     {
-        std::vector<GenericTextureVertex> vertexBuffer;
+        std::vector<GenericTextureInstance> instanceBuffer;
     };
 
     //
     // Buffers
     //
 
-    std::unique_ptr<vec4f> mPointAttributeGroup1Buffer; // Position, TextureCoordinates
-    GameOpenGLVBO mPointAttributeGroup1VBO;
+    //
+    // The per-frame point attributes have a VBO each, laid out as the points' own buffers,
+    // which are thus uploaded as they are; the attributes that seldom change live in a
+    // CPU-side buffer which is only uploaded when dirty
+    //
 
-    std::unique_ptr<vec4f> mPointAttributeGroup2Buffer; // Light, Water, PlaneId, Decay
-    GameOpenGLVBO mPointAttributeGroup2VBO;
+    GameOpenGLVBO mPointAttributeGroup1VBO; // Position
+    GameOpenGLVBO mPointLightVBO;
+    GameOpenGLVBO mPointWaterVBO;
 
+    std::unique_ptr<vec4f[]> mPointAttributeGroup3Buffer; // TextureCoordinates, PlaneId, Decay
+    DirtyElementRange mPointAttributeGroup3DirtyRange; // Since last upload
+    GameOpenGLVBO mPointAttributeGroup3VBO;
+
+    std::unique_ptr<rgbaColor[]> mPointColorBuffer;
     GameOpenGLVBO mPointColorVBO;
 
     std::vector<LineElement> mStressedSpringElementBuffer;
     GameOpenGLVBO mStressedSpringElementVBO;
+    size_t mStressedSpringElementVBOAllocatedCount;
 
-    std::vector<GenericTexturePlaneData> mGenericTexturePlaneVertexBuffers;
+    // Generic textures are drawn as instances of a single quad; the instance VBO only
+    // grows, and each frame's instances are sub-allocated from its start, plane after plane
+    std::vector<GenericTexturePlaneData> mGenericTexturePlaneInstanceBuffers;
     size_t mGenericTextureQuadCount;
-    GameOpenGLVBO mGenericTextureVBO;
-    size_t mGenericTextureVBOAllocatedQuadCount;
-
-    std::vector<vec3f> mVectorArrowVertexBuffer;
-    GameOpenGLVBO mVectorArrowVBO;
+    GameOpenGLVBO mGenericTextureInstanceVBO;
+    size_t mGenericTextureInstanceVBOAllocatedQuadCount;
+    GameOpenGLVBO mGenericTextureQuadVBO;
+
+    // Vectors are drawn as instances of a single arrow, made out of each vector by the shader
+    GameOpenGLVBO mVectorArrowInstanceVBO;
+    size_t mVectorArrowCount;
+    GameOpenGLVBO mVectorArrowShapeVBO;
+    std::optional<float> mVectorArrowLengthAdjustment;
     std::optional<vec4f> mVectorArrowColor;
 
+    std::vector<vec4f> mLampBuffer; // Two texels per lamp
+    size_t mLampCount;
+
     //
     // Element (index) buffers
     //
@@ -528,7 +737,16 @@ private:
     std::vector<LineElement> mRopeElementBuffer;
     std::vector<TriangleElement> mTriangleElementBuffer;
 
+    // The triangles as they are in the VBO - compared chunk by chunk with the
+    // triangles being uploaded - and the number of non-degenerate triangles
+    std::vector<TriangleElement> mUploadedTriangleElementBuffer;
+    size_t mTriangleElementCount;
+
+    // The number of triangles in each of the chunks we compare and re-upload
+    static constexpr size_t TriangleUploadChunkSize = 1024;
+
     GameOpenGLVBO mElementVBO;
+    size_t mElementVBOAllocatedSize;
 
     // Indices at which these elements begin in the VBO; populated
     // when we upload element indices to the VBO
@@ -553,7 +771,27 @@ private:
     //
 
     GameOpenGLTexture mShipTextureOpenGLHandle;
+    size_t const mShipTextureBaseLevelByteSize;
+
+    // The base level of huge ship textures is only uploaded once the camera zooms in
+    // far enough to magnify the level below it, i.e. when we'd start to notice it's missing
+    static constexpr size_t MinDeferredShipTextureBaseLevelPixelCount = 2048 * 2048;
+    std::optional<RgbaImageData> mShipTextureDeferredBaseLevel;
+    float mShipTextureDeferredBaseLevelMinCanvasToVisibleWorldRatio;
+
+    // The texture is streamed in over many frames after the ship appears, as uploading
+    // it at once would freeze the frame in which it's added
+    static constexpr size_t ShipTextureStreamingSliceByteSize = 4 * 1024 * 1024;
+    std::unique_ptr<GameOpenGLTextureStreamer> mShipTextureStreamer;
+
+    // Whether the base level of the texture waits for the camera to zoom in
+    inline bool DoesDeferShipTextureBaseLevel() const
+    {
+        return mShipTextureBaseLevelByteSize / sizeof(rgbaColor) >= MinDeferredShipTextureBaseLevelPixelCount;
+    }
+
     GameOpenGLTexture mStressedSpringTextureOpenGLHandle;
+    GameOpenGLTexture mLampsTextureOpenGLHandle;
 
     GameOpenGLTexture & mGenericTextureAtlasOpenGLHandle;
     TextureAtlasMetadata const & mGenericTextureAtlasMetadata;
@@ -565,6 +803,7 @@ private:
     //
 
     ShaderManager<ShaderManagerTraits> & mShaderManager;
+    GameOpenGLBufferRecycler & mBufferRecycler;
 
     //
     // Parameters
@@ -0,0 +1,77 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-21
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <cstddef>
+
+namespace Physics
+{
+
+/*
+ * Per-ship totals, accumulated while the water dynamics visit the points and thus
+ * as of the last run of the water dynamics.
+ */
+struct ShipStatistics
+{
+    // Total quantity of water in the ship
+    float TotalWater;
+
+    // Number of points whose water is above the wet threshold
+    size_t WetPointCount;
+
+    // Number of leaking points, and of those that are underwater
+    size_t LeakingPointCount;
+    size_t SubmergedLeakingPointCount;
+
+    //
+    // As of now, rather than of the last run of the water dynamics
+    //
+
+    size_t PointCount;
+    size_t SpringCount;
+    size_t EphemeralParticleCount; // Live ones
+    size_t SinkingShipCount;
+
+    ShipStatistics()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        TotalWater = 0.0f;
+        WetPointCount = 0;
+        LeakingPointCount = 0;
+        SubmergedLeakingPointCount = 0;
+        PointCount = 0;
+        SpringCount = 0;
+        EphemeralParticleCount = 0;
+        SinkingShipCount = 0;
+    }
+
+    float GetSubmergedLeakingPointFraction() const
+    {
+        return LeakingPointCount != 0
+            ? static_cast<float>(SubmergedLeakingPointCount) / static_cast<float>(LeakingPointCount)
+            : 0.0f;
+    }
+
+    ShipStatistics & operator+=(ShipStatistics const & other)
+    {
+        TotalWater += other.TotalWater;
+        WetPointCount += other.WetPointCount;
+        LeakingPointCount += other.LeakingPointCount;
+        SubmergedLeakingPointCount += other.SubmergedLeakingPointCount;
+        PointCount += other.PointCount;
+        SpringCount += other.SpringCount;
+        EphemeralParticleCount += other.EphemeralParticleCount;
+        SinkingShipCount += other.SinkingShipCount;
+
+        return *this;
+    }
+};
+
+}
@@ -0,0 +1,293 @@
+/***************************************************************************************
+ * Original Author:		Gabriele Giuseppini
+ * Created:				2019-03-09
+ * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#include "Physics.h"
+
+#include <GameCore/AABB.h>
+#include <GameCore/GameMath.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace Physics {
+
+// The side of the cells of the narrow phase's triangle grid, about twice the
+// side of a triangle...
+static constexpr float CollisionGridCellSize = 2.0f;
+
+// ...unless the region is so large that the grid would have more cells than this
+// along a side
+static constexpr size_t MaxCollisionGridSide = 128;
+
+// The fraction of the approaching velocity that bounces back after a collision
+static constexpr float CollisionRestitution = 0.2f;
+
+void Ship::UpdateCollisionComponentBuckets()
+{
+    if (mAreCollisionComponentBucketsCurrent)
+        return;
+
+    // A triangle belongs to the component of its points
+    BucketByConnectedComponent(
+        mTriangles,
+        [this](ElementIndex triangleIndex)
+        {
+            return mTriangles.IsDeleted(triangleIndex)
+                ? NoneConnectedComponentId
+                : mPoints.GetConnectedComponentId(mTriangles.GetPointAIndex(triangleIndex));
+        },
+        mConnectedComponentAABBs.size(),
+        mCollisionComponentTriangleOffsets,
+        mCollisionComponentTriangleIndices);
+
+    mAreCollisionComponentBucketsCurrent = true;
+}
+
+void Ship::CollideWith(
+    ConnectedComponentId connectedComponentId,
+    Ship & otherShip,
+    ConnectedComponentId otherConnectedComponentId,
+    Geometry::AABB const & region)
+{
+    assert(&otherShip != this || connectedComponentId != otherConnectedComponentId);
+
+    // Collisions move the points as they are on the CPU
+    CatchUpWithGPUMechanicalDynamics();
+    otherShip.CatchUpWithGPUMechanicalDynamics();
+
+    UpdateCollisionComponentBuckets();
+    otherShip.UpdateCollisionComponentBuckets();
+
+    Points & otherPoints = otherShip.mPoints;
+    Triangles const & otherTriangles = otherShip.mTriangles;
+
+    //
+    // 1. Bucket the other component's triangles that touch the region into a grid
+    //    over the region
+    //
+
+    float const cellSize = std::max(
+        CollisionGridCellSize,
+        std::max(region.GetWidth(), region.GetHeight()) / static_cast<float>(MaxCollisionGridSide));
+
+    size_t const gridWidth = static_cast<size_t>(region.GetWidth() / cellSize) + 1;
+    size_t const gridHeight = static_cast<size_t>(region.GetHeight() / cellSize) + 1;
+
+    // Visits the cells touched by the bounding box of the triangle, if it touches the region
+    auto const visitTriangleCells = [&](ElementIndex triangleIndex, auto const & visitor)
+    {
+        vec2f const & a = otherPoints.GetPosition(otherTriangles.GetPointAIndex(triangleIndex));
+        vec2f const & b = otherPoints.GetPosition(otherTriangles.GetPointBIndex(triangleIndex));
+        vec2f const & c = otherPoints.GetPosition(otherTriangles.GetPointCIndex(triangleIndex));
+
+        float const minX = std::min({ a.x, b.x, c.x });
+        float const maxX = std::max({ a.x, b.x, c.x });
+        float const minY = std::min({ a.y, b.y, c.y });
+        float const maxY = std::max({ a.y, b.y, c.y });
+
+        if (maxX < region.BottomLeft.x || minX > region.TopRight.x
+            || maxY < region.BottomLeft.y || minY > region.TopRight.y)
+        {
+            return;
+        }
+
+        size_t const cellX1 = static_cast<size_t>(std::max(minX - region.BottomLeft.x, 0.0f) / cellSize);
+        size_t const cellX2 = std::min(static_cast<size_t>((maxX - region.BottomLeft.x) / cellSize), gridWidth - 1);
+        size_t const cellY1 = static_cast<size_t>(std::max(minY - region.BottomLeft.y, 0.0f) / cellSize);
+        size_t const cellY2 = std::min(static_cast<size_t>((maxY - region.BottomLeft.y) / cellSize), gridHeight - 1);
+
+        for (size_t cellY = cellY1; cellY <= cellY2; ++cellY)
+        {
+            for (size_t cellX = cellX1; cellX <= cellX2; ++cellX)
+            {
+                visitor(cellY * gridWidth + cellX);
+            }
+        }
+    };
+
+    ElementIndex const * const otherTrianglesBegin =
+        otherShip.mCollisionComponentTriangleIndices.data()
+        + otherShip.mCollisionComponentTriangleOffsets[otherConnectedComponentId];
+    ElementIndex const * const otherTrianglesEnd =
+        otherShip.mCollisionComponentTriangleIndices.data()
+        + otherShip.mCollisionComponentTriangleOffsets[otherConnectedComponentId + 1];
+
+    mCollisionGridCellOffsets.assign(gridWidth * gridHeight + 1, 0);
+
+    for (auto t = otherTrianglesBegin; t != otherTrianglesEnd; ++t)
+    {
+        visitTriangleCells(
+            *t,
+            [this](size_t cellIndex)
+            {
+                ++mCollisionGridCellOffsets[cellIndex + 1];
+            });
+    }
+
+    for (size_t c = 1; c < mCollisionGridCellOffsets.size(); ++c)
+    {
+        mCollisionGridCellOffsets[c] += mCollisionGridCellOffsets[c - 1];
+    }
+
+    if (mCollisionGridCellOffsets.back() == 0)
+    {
+        // No triangles in the region
+        return;
+    }
+
+    mCollisionGridTriangleIndices.resize(mCollisionGridCellOffsets.back());
+
+    // Use the cells' start offsets as insertion cursors, and then shift them back
+    for (auto t = otherTrianglesBegin; t != otherTrianglesEnd; ++t)
+    {
+        visitTriangleCells(
+            *t,
+            [this, t](size_t cellIndex)
+            {
+                mCollisionGridTriangleIndices[mCollisionGridCellOffsets[cellIndex]++] = *t;
+            });
+    }
+
+    for (size_t c = mCollisionGridCellOffsets.size() - 1; c > 0; --c)
+    {
+        mCollisionGridCellOffsets[c] = mCollisionGridCellOffsets[c - 1];
+    }
+
+    mCollisionGridCellOffsets[0] = 0;
+
+    //
+    // 2. Test each of our component's points within the region against the
+    //    triangles of its cell, and push out of the first triangle it penetrates
+    //
+    // The point is pushed out through the triangle edge closest to it, and the
+    // edge's endpoints are pushed back; the share of each side is proportional
+    // to its inverse mass - for which we use the integration factor, as it's
+    // zero for frozen points - and so is the impulse that cancels their
+    // approaching velocity
+    //
+
+    bool hasCollided = false;
+
+    assert(connectedComponentId + 1 < mIslandPointOffsets.size());
+    for (ElementIndex p = mIslandPointOffsets[connectedComponentId]; p < mIslandPointOffsets[connectedComponentId + 1]; ++p)
+    {
+        ElementIndex const pointIndex = mIslandPointIndices[p];
+        vec2f & pointPosition = mPoints.GetPosition(pointIndex);
+
+        if (!region.Contains(pointPosition))
+            continue;
+
+        size_t const cellX = std::min(static_cast<size_t>((pointPosition.x - region.BottomLeft.x) / cellSize), gridWidth - 1);
+        size_t const cellY = std::min(static_cast<size_t>((pointPosition.y - region.BottomLeft.y) / cellSize), gridHeight - 1);
+        size_t const cellIndex = cellY * gridWidth + cellX;
+
+        for (ElementIndex i = mCollisionGridCellOffsets[cellIndex]; i < mCollisionGridCellOffsets[cellIndex + 1]; ++i)
+        {
+            ElementIndex const triangleIndex = mCollisionGridTriangleIndices[i];
+
+            ElementIndex const vertices[3] = {
+                otherTriangles.GetPointAIndex(triangleIndex),
+                otherTriangles.GetPointBIndex(triangleIndex),
+                otherTriangles.GetPointCIndex(triangleIndex) };
+
+            vec2f const & a = otherPoints.GetPosition(vertices[0]);
+            vec2f const & b = otherPoints.GetPosition(vertices[1]);
+            vec2f const & c = otherPoints.GetPosition(vertices[2]);
+
+            float const doubleArea = (b - a).cross(c - a);
+            if (std::abs(doubleArea) < 1e-6f)
+                continue;
+
+            float const orientation = doubleArea > 0.0f ? 1.0f : -1.0f;
+
+            // Find the signed distance from each edge - positive inside - and the closest edge
+            float minDistance = std::numeric_limits<float>::max();
+            size_t closestEdge = 0;
+            bool isInside = true;
+            for (size_t e = 0; e < 3; ++e)
+            {
+                vec2f const & edgeStart = otherPoints.GetPosition(vertices[e]);
+                vec2f const & edgeEnd = otherPoints.GetPosition(vertices[(e + 1) % 3]);
+                vec2f const edge = edgeEnd - edgeStart;
+
+                float const distance = orientation * edge.cross(pointPosition - edgeStart) / edge.length();
+                if (distance < 0.0f)
+                {
+                    isInside = false;
+                    break;
+                }
+
+                if (distance < minDistance)
+                {
+                    minDistance = distance;
+                    closestEdge = e;
+                }
+            }
+
+            if (!isInside)
+                continue;
+
+            //
+            // Resolve penetration
+            //
+
+            ElementIndex const edgePointIndex1 = vertices[closestEdge];
+            ElementIndex const edgePointIndex2 = vertices[(closestEdge + 1) % 3];
+
+            vec2f const edge = otherPoints.GetPosition(edgePointIndex2) - otherPoints.GetPosition(edgePointIndex1);
+
+            // Outward normal of the closest edge
+            vec2f const normal = vec2f(edge.y, -edge.x).normalise() * orientation;
+
+            float const pointInverseMass = mPoints.GetIntegrationFactor(pointIndex).x;
+            float const edgePointInverseMass1 = otherPoints.GetIntegrationFactor(edgePointIndex1).x;
+            float const edgePointInverseMass2 = otherPoints.GetIntegrationFactor(edgePointIndex2).x;
+
+            // The inverse of the sum of the masses of the two endpoints
+            float const edgeInverseMass = (edgePointInverseMass1 + edgePointInverseMass2) > 0.0f
+                ? edgePointInverseMass1 * edgePointInverseMass2 / (edgePointInverseMass1 + edgePointInverseMass2)
+                : 0.0f;
+
+            float const totalInverseMass = pointInverseMass + edgeInverseMass;
+            if (totalInverseMass == 0.0f)
+                break;
+
+            // Positions
+            pointPosition += normal * (minDistance * pointInverseMass / totalInverseMass);
+            vec2f const edgeDisplacement = normal * (minDistance * edgeInverseMass / totalInverseMass);
+            otherPoints.GetPosition(edgePointIndex1) -= edgeDisplacement;
+            otherPoints.GetPosition(edgePointIndex2) -= edgeDisplacement;
+
+            // Velocities
+            vec2f const edgeVelocity = (otherPoints.GetVelocity(edgePointIndex1) + otherPoints.GetVelocity(edgePointIndex2)) / 2.0f;
+            float const approachingVelocity = (mPoints.GetVelocity(pointIndex) - edgeVelocity).dot(normal);
+            if (approachingVelocity < 0.0f)
+            {
+                float const impulse = -(1.0f + CollisionRestitution) * approachingVelocity / totalInverseMass;
+
+                mPoints.SetVelocity(pointIndex, mPoints.GetVelocity(pointIndex) + normal * (impulse * pointInverseMass));
+                vec2f const edgeDeltaVelocity = normal * (impulse * edgeInverseMass);
+                otherPoints.SetVelocity(edgePointIndex1, otherPoints.GetVelocity(edgePointIndex1) - edgeDeltaVelocity);
+                otherPoints.SetVelocity(edgePointIndex2, otherPoints.GetVelocity(edgePointIndex2) - edgeDeltaVelocity);
+            }
+
+            hasCollided = true;
+
+            // One triangle per point per step
+            break;
+        }
+    }
+
+    if (hasCollided)
+    {
+        // Sleeping components wouldn't feel the collision
+        WakeUpAllIslands();
+        otherShip.WakeUpAllIslands();
+    }
+}
+
+}
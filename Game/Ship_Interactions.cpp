@@ -19,6 +19,197 @@
 
 namespace Physics {
 
+// The min side of the interaction grid's square cells, about the radius of most
+// tools; cells get larger when the ship spreads out, so that the grid never has
+// more cells than points
+static constexpr float MinInteractionGridCellSize = 2.0f;
+
+// How far the cursor, the ship's bounding box, and the points around the cursor may
+// move before the candidates of nearest-point queries are gathered anew; candidates
+// are gathered from beyond the query's radius by twice as much, so that a point that
+// was not a candidate has to move at least this much to come within the radius
+static constexpr float NearestPointCandidatesTolerance = 0.25f;
+
+void Ship::UpdateInteractionGrid() const
+{
+    if (mIsInteractionGridCurrent)
+        return;
+
+    //
+    // Size the grid on the points' bounding box
+    //
+
+    vec2f minPosition(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    vec2f maxPosition(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    size_t pointCount = 0;
+
+    auto const extendTo = [&](ElementIndex pointIndex)
+    {
+        vec2f const & position = mPoints.GetPosition(pointIndex);
+        minPosition.x = std::min(minPosition.x, position.x);
+        minPosition.y = std::min(minPosition.y, position.y);
+        maxPosition.x = std::max(maxPosition.x, position.x);
+        maxPosition.y = std::max(maxPosition.y, position.y);
+        ++pointCount;
+    };
+
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+        extendTo(pointIndex);
+
+    for (auto pointIndex : mPoints.LiveEphemeralPoints())
+        extendTo(pointIndex);
+
+    if (pointCount == 0)
+    {
+        mInteractionGridOrigin = vec2f::zero();
+        mInteractionGridCellSize = MinInteractionGridCellSize;
+        mInteractionGridWidth = 1;
+        mInteractionGridHeight = 1;
+        mInteractionGridCellOffsets.assign(2, 0);
+        mInteractionGridPointIndices.clear();
+        mIsInteractionGridCurrent = true;
+        return;
+    }
+
+    vec2f const extent = maxPosition - minPosition;
+
+    // About as many cells as points at most, also when the points are spread along a line
+    float const floatPointCount = static_cast<float>(pointCount);
+    mInteractionGridOrigin = minPosition;
+    mInteractionGridCellSize = std::max({
+        MinInteractionGridCellSize,
+        std::sqrt(extent.x * extent.y / floatPointCount),
+        std::max(extent.x, extent.y) / floatPointCount });
+    mInteractionGridWidth = static_cast<size_t>(extent.x / mInteractionGridCellSize) + 1;
+    mInteractionGridHeight = static_cast<size_t>(extent.y / mInteractionGridCellSize) + 1;
+
+    //
+    // Bucket the points - a counting sort, as for the light grid
+    //
+
+    auto const getCellIndex =
+        [this](ElementIndex pointIndex) -> size_t
+        {
+            vec2f const gridPosition = (mPoints.GetPosition(pointIndex) - mInteractionGridOrigin) / mInteractionGridCellSize;
+
+            size_t const cellX = std::min(static_cast<size_t>(gridPosition.x), mInteractionGridWidth - 1);
+            size_t const cellY = std::min(static_cast<size_t>(gridPosition.y), mInteractionGridHeight - 1);
+
+            return cellY * mInteractionGridWidth + cellX;
+        };
+
+    mInteractionGridCellOffsets.assign(mInteractionGridWidth * mInteractionGridHeight + 1, 0);
+
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+        ++mInteractionGridCellOffsets[getCellIndex(pointIndex) + 1];
+
+    for (auto pointIndex : mPoints.LiveEphemeralPoints())
+        ++mInteractionGridCellOffsets[getCellIndex(pointIndex) + 1];
+
+    for (size_t c = 1; c < mInteractionGridCellOffsets.size(); ++c)
+    {
+        mInteractionGridCellOffsets[c] += mInteractionGridCellOffsets[c - 1];
+    }
+
+    mInteractionGridPointIndices.resize(pointCount);
+
+    // Use the cells' start offsets as insertion cursors, and then shift them back
+    for (auto pointIndex : mPoints.NonEphemeralPoints())
+        mInteractionGridPointIndices[mInteractionGridCellOffsets[getCellIndex(pointIndex)]++] = pointIndex;
+
+    for (auto pointIndex : mPoints.LiveEphemeralPoints())
+        mInteractionGridPointIndices[mInteractionGridCellOffsets[getCellIndex(pointIndex)]++] = pointIndex;
+
+    for (size_t c = mInteractionGridCellOffsets.size() - 1; c > 0; --c)
+    {
+        mInteractionGridCellOffsets[c] = mInteractionGridCellOffsets[c - 1];
+    }
+
+    mInteractionGridCellOffsets[0] = 0;
+
+    mIsInteractionGridCurrent = true;
+
+    // The springs need to be bucketed anew into the new grid
+    mAreInteractionGridSpringsCurrent = false;
+}
+
+void Ship::UpdateInteractionGridSprings() const
+{
+    UpdateInteractionGrid();
+
+    if (mAreInteractionGridSpringsCurrent)
+        return;
+
+    //
+    // Bucket the springs into all the cells touched by their bounding box - a counting sort;
+    // the springs' endpoints are in the grid, hence so are their bounding boxes
+    //
+
+    auto const visitSpringCells = [this](ElementIndex springIndex, auto const & visitor)
+    {
+        vec2f const gridPositionA = (mSprings.GetEndpointAPosition(springIndex, mPoints) - mInteractionGridOrigin) / mInteractionGridCellSize;
+        vec2f const gridPositionB = (mSprings.GetEndpointBPosition(springIndex, mPoints) - mInteractionGridOrigin) / mInteractionGridCellSize;
+
+        size_t const cellX1 = std::min(static_cast<size_t>(std::max(std::min(gridPositionA.x, gridPositionB.x), 0.0f)), mInteractionGridWidth - 1);
+        size_t const cellX2 = std::min(static_cast<size_t>(std::max(std::max(gridPositionA.x, gridPositionB.x), 0.0f)), mInteractionGridWidth - 1);
+        size_t const cellY1 = std::min(static_cast<size_t>(std::max(std::min(gridPositionA.y, gridPositionB.y), 0.0f)), mInteractionGridHeight - 1);
+        size_t const cellY2 = std::min(static_cast<size_t>(std::max(std::max(gridPositionA.y, gridPositionB.y), 0.0f)), mInteractionGridHeight - 1);
+
+        for (size_t cellY = cellY1; cellY <= cellY2; ++cellY)
+        {
+            for (size_t cellX = cellX1; cellX <= cellX2; ++cellX)
+            {
+                visitor(cellY * mInteractionGridWidth + cellX);
+            }
+        }
+    };
+
+    mInteractionGridSpringCellOffsets.assign(mInteractionGridWidth * mInteractionGridHeight + 1, 0);
+
+    for (auto springIndex : mSprings)
+    {
+        if (!mSprings.IsDeleted(springIndex))
+        {
+            visitSpringCells(
+                springIndex,
+                [this](size_t cellIndex)
+                {
+                    ++mInteractionGridSpringCellOffsets[cellIndex + 1];
+                });
+        }
+    }
+
+    for (size_t c = 1; c < mInteractionGridSpringCellOffsets.size(); ++c)
+    {
+        mInteractionGridSpringCellOffsets[c] += mInteractionGridSpringCellOffsets[c - 1];
+    }
+
+    mInteractionGridSpringIndices.resize(mInteractionGridSpringCellOffsets.back());
+
+    // Use the cells' start offsets as insertion cursors, and then shift them back
+    for (auto springIndex : mSprings)
+    {
+        if (!mSprings.IsDeleted(springIndex))
+        {
+            visitSpringCells(
+                springIndex,
+                [this, springIndex](size_t cellIndex)
+                {
+                    mInteractionGridSpringIndices[mInteractionGridSpringCellOffsets[cellIndex]++] = springIndex;
+                });
+        }
+    }
+
+    for (size_t c = mInteractionGridSpringCellOffsets.size() - 1; c > 0; --c)
+    {
+        mInteractionGridSpringCellOffsets[c] = mInteractionGridSpringCellOffsets[c - 1];
+    }
+
+    mInteractionGridSpringCellOffsets[0] = 0;
+
+    mAreInteractionGridSpringsCurrent = true;
+}
+
 //   SSS    H     H  IIIIIII  PPPP
 // SS   SS  H     H     I     P   PP
 // S        H     H     I     P    PP
@@ -33,6 +224,11 @@ void Ship::MoveBy(
     vec2f const & offset,
     GameParameters const & gameParameters)
 {
+    WakeUpAllIslands();
+
+    // We're about to move the points as they are on the CPU
+    CatchUpWithGPUMechanicalDynamics();
+
     vec2f const velocity =
         offset
         * gameParameters.MoveToolInertia
@@ -47,6 +243,18 @@ void Ship::MoveBy(
         positionBuffer[p] += offset;
         velocityBuffer[p] = velocity;
     }
+
+    mIsInteractionGridCurrent = false;
+
+    // Keep bounds up-to-date for the interactions preceding the next update
+    for (auto & box : mConnectedComponentAABBs)
+    {
+        box.BottomLeft += offset;
+        box.TopRight += offset;
+    }
+
+    mAABB.BottomLeft += offset;
+    mAABB.TopRight += offset;
 }
 
 void Ship::RotateBy(
@@ -54,6 +262,11 @@ void Ship::RotateBy(
     vec2f const & center,
     GameParameters const & gameParameters)
 {
+    WakeUpAllIslands();
+
+    // We're about to move the points as they are on the CPU
+    CatchUpWithGPUMechanicalDynamics();
+
     float const inertia =
         gameParameters.MoveToolInertia
         * (gameParameters.IsUltraViolentMode ? 5.0f : 1.0f);
@@ -73,6 +286,41 @@ void Ship::RotateBy(
         velocityBuffer[p] = (pos - positionBuffer[p]) * inertia;
         positionBuffer[p] = pos;
     }
+
+    mIsInteractionGridCurrent = false;
+
+    // Keep bounds up-to-date for the interactions preceding the next update,
+    // with the bounds of the rotated boxes
+    mAABB = Geometry::AABB(
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::max());
+
+    for (auto & box : mConnectedComponentAABBs)
+    {
+        if (box.BottomLeft.x > box.TopRight.x)
+            continue;
+
+        vec2f const corners[4] = {
+            box.BottomLeft,
+            vec2f(box.TopRight.x, box.BottomLeft.y),
+            box.TopRight,
+            vec2f(box.BottomLeft.x, box.TopRight.y) };
+
+        box.BottomLeft = vec2f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        box.TopRight = vec2f(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+        for (auto const & corner : corners)
+        {
+            vec2f const pos = vec2f((corner - center).dot(rotX), (corner - center).dot(rotY)) + center;
+            box.BottomLeft.x = std::min(box.BottomLeft.x, pos.x);
+            box.BottomLeft.y = std::min(box.BottomLeft.y, pos.y);
+            box.TopRight.x = std::max(box.TopRight.x, pos.x);
+            box.TopRight.y = std::max(box.TopRight.y, pos.y);
+        }
+
+        mAABB.ExtendTo(box);
+    }
 }
 
 void Ship::DestroyAt(
@@ -81,6 +329,8 @@ void Ship::DestroyAt(
     float currentSimulationTime,
     GameParameters const & gameParameters)
 {
+    WakeUpAllIslands();
+
     float const radius =
         gameParameters.DestroyRadius
         * radiusMultiplier
@@ -89,39 +339,41 @@ void Ship::DestroyAt(
     float const squareRadius = radius * radius;
 
     // Detach/destroy all active, attached points within the radius
-    for (auto pointIndex : mPoints)
-    {
-        if (mPoints.IsActive(pointIndex)
-            && (mPoints.GetPosition(pointIndex) - targetPos).squareLength() < squareRadius)
+    VisitInteractionGridPointsIn(
+        Geometry::AABB(targetPos.x - radius, targetPos.x + radius, targetPos.y + radius, targetPos.y - radius),
+        [&](ElementIndex pointIndex)
         {
-            //
-            // - Air bubble ephemeral points: destroy
-            // - Non-ephemeral, attached points: detach
-            //
-
-            if (Points::EphemeralType::None == mPoints.GetEphemeralType(pointIndex)
-                && mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size() > 0)
-            {
-                // Choose a detach velocity - using the same distribution as Debris
-                vec2f detachVelocity = GameRandomEngine::GetInstance().GenerateRandomRadialVector(
-                    GameParameters::MinDebrisParticlesVelocity,
-                    GameParameters::MaxDebrisParticlesVelocity);
-
-                // Detach
-                mPoints.Detach(
-                    pointIndex,
-                    detachVelocity,
-                    Points::DetachOptions::GenerateDebris,
-                    currentSimulationTime,
-                    gameParameters);
-            }
-            else if (Points::EphemeralType::AirBubble == mPoints.GetEphemeralType(pointIndex))
+            if (mPoints.IsActive(pointIndex)
+                && (mPoints.GetPosition(pointIndex) - targetPos).squareLength() < squareRadius)
             {
-                // Destroy
-                mPoints.DestroyEphemeralParticle(pointIndex);
+                //
+                // - Air bubble ephemeral points: destroy
+                // - Non-ephemeral, attached points: detach
+                //
+
+                if (Points::EphemeralType::None == mPoints.GetEphemeralType(pointIndex)
+                    && mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size() > 0)
+                {
+                    // Choose a detach velocity - using the same distribution as Debris
+                    vec2f detachVelocity = GameRandomEngine::GetInstance().GenerateRandomRadialVector(
+                        GameParameters::MinDebrisParticlesVelocity,
+                        GameParameters::MaxDebrisParticlesVelocity);
+
+                    // Detach
+                    mPoints.Detach(
+                        pointIndex,
+                        detachVelocity,
+                        Points::DetachOptions::GenerateDebris,
+                        currentSimulationTime,
+                        gameParameters);
+                }
+                else if (Points::EphemeralType::AirBubble == mPoints.GetEphemeralType(pointIndex))
+                {
+                    // Destroy
+                    mPoints.DestroyEphemeralParticle(pointIndex);
+                }
             }
-        }
-    }
+        });
 }
 
 void Ship::RepairAt(
@@ -130,295 +382,306 @@ void Ship::RepairAt(
     float /*currentSimulationTime*/,
     GameParameters const & gameParameters)
 {
+    WakeUpAllIslands();
+
     float const searchRadius =
         gameParameters.RepairRadius
         * radiusMultiplier;
 
     float const squareSearchRadius = searchRadius * searchRadius;
 
-    // Visit all non-ephemeral points
-    for (auto pointIndex : mPoints.NonEphemeralPoints())
-    {
-        // Check if point is in radius and whether it's not orphaned
-        //
-        // If we were to attempt to restore also orphaned points, then two formerly-connected
-        // orphaned points within the search radius would interact with each other and nullify
-        // the effort put by the main structure's points
-        float const squareRadius = (mPoints.GetPosition(pointIndex) - targetPos).squareLength();
-        if (squareRadius <= squareSearchRadius
-            && mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size() > 0)
+    // Visit all non-ephemeral points nearby
+    VisitInteractionGridPointsIn(
+        Geometry::AABB(targetPos.x - searchRadius, targetPos.x + searchRadius, targetPos.y + searchRadius, targetPos.y - searchRadius),
+        [&](ElementIndex pointIndex)
         {
-            //
-            // 1) (Attempt to) restore this point's delete springs
-            //
-
-            // Calculate tool strength (1.0 at center and zero at border, fourth power)
-            float const toolStrength =
-                (1.0f - (squareRadius / squareSearchRadius) * (squareRadius / squareSearchRadius))
-                * (gameParameters.IsUltraViolentMode ? 10.0f : 1.0f);
+            // The grid also has the ephemeral particles
+            if (Points::EphemeralType::None != mPoints.GetEphemeralType(pointIndex))
+                return;
 
-            // Visit all the springs that were connected at factory time
-            for (auto const & fcs : mPoints.GetFactoryConnectedSprings(pointIndex).ConnectedSprings)
+            // Check if point is in radius and whether it's not orphaned
+            //
+            // If we were to attempt to restore also orphaned points, then two formerly-connected
+            // orphaned points within the search radius would interact with each other and nullify
+            // the effort put by the main structure's points
+            float const squareRadius = (mPoints.GetPosition(pointIndex) - targetPos).squareLength();
+            if (squareRadius <= squareSearchRadius
+                && mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size() > 0)
             {
-                // Check if this spring is deleted
-                if (mSprings.IsDeleted(fcs.SpringIndex))
-                {
-                    ////////////////////////////////////////////////////////
-                    //
-                    // Restore this spring or move the other endpoint nearer
-                    //
-                    ////////////////////////////////////////////////////////
-
-                    //
-                    // The target position of the endpoint is on the circle whose radius
-                    // is the spring's rest length, and the angle is interpolated between
-                    // the two non-deleted springs immediately CW and CCW of this spring
-                    //
-
-                    float targetWorldAngle; // In world coordinates, positive when CCW, 0 at E
+                //
+                // 1) (Attempt to) restore this point's delete springs
+                //
 
-                    // The angle of the spring wrt this point
-                    // 0 = E, 1 = SE, ..., 7 = NE
-                    int32_t const factoryPointSpringOctant = mSprings.GetFactoryEndpointOctant(
-                        fcs.SpringIndex,
-                        pointIndex);
+                // Calculate tool strength (1.0 at center and zero at border, fourth power)
+                float const toolStrength =
+                    (1.0f - (squareRadius / squareSearchRadius) * (squareRadius / squareSearchRadius))
+                    * (gameParameters.IsUltraViolentMode ? 10.0f : 1.0f);
 
-                    size_t const connectedSpringsCount = mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size();
-                    if (connectedSpringsCount == 0)
-                    {
-                        // No springs exist yet for this point...
-                        // ...arbitrarily, use its factory octant as if it were a world angle
-                        targetWorldAngle = Pi<float> / 4.0f * static_cast<float>(8.0f - factoryPointSpringOctant);
-                    }
-                    else
+                // Visit all the springs that were connected at factory time
+                for (auto const & fcs : mPoints.GetFactoryConnectedSprings(pointIndex).ConnectedSprings)
+                {
+                    // Check if this spring is deleted
+                    if (mSprings.IsDeleted(fcs.SpringIndex))
                     {
-                        // One or more springs...
-
+                        ////////////////////////////////////////////////////////
                         //
-                        // 1. Find nearest spring CW and closest spring CCW
-                        // (which might and up being the same spring in case there's only one spring)
+                        // Restore this spring or move the other endpoint nearer
                         //
+                        ////////////////////////////////////////////////////////
 
-                        int nearestCWSpringIndex = -1;
-                        int nearestCWSpringDeltaOctant = std::numeric_limits<int>::max();
-                        int nearestCCWSpringIndex = -1;
-                        int nearestCCWSpringDeltaOctant = std::numeric_limits<int>::max();
-                        for (auto const & cs : mPoints.GetConnectedSprings(pointIndex).ConnectedSprings)
-                        {
-                            //
-                            // CW
-                            //
+                        //
+                        // The target position of the endpoint is on the circle whose radius
+                        // is the spring's rest length, and the angle is interpolated between
+                        // the two non-deleted springs immediately CW and CCW of this spring
+                        //
 
-                            int cwDelta =
-                                mSprings.GetFactoryEndpointOctant(cs.SpringIndex, pointIndex)
-                                - factoryPointSpringOctant;
+                        float targetWorldAngle; // In world coordinates, positive when CCW, 0 at E
 
-                            if (cwDelta < 0)
-                                cwDelta += 8;
+                        // The angle of the spring wrt this point
+                        // 0 = E, 1 = SE, ..., 7 = NE
+                        int32_t const factoryPointSpringOctant = mSprings.GetFactoryEndpointOctant(
+                            fcs.SpringIndex,
+                            pointIndex);
 
-                            if (cwDelta < nearestCWSpringDeltaOctant)
-                            {
-                                nearestCWSpringIndex = cs.SpringIndex;
-                                nearestCWSpringDeltaOctant = cwDelta;
-                            }
+                        size_t const connectedSpringsCount = mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size();
+                        if (connectedSpringsCount == 0)
+                        {
+                            // No springs exist yet for this point...
+                            // ...arbitrarily, use its factory octant as if it were a world angle
+                            targetWorldAngle = Pi<float> / 4.0f * static_cast<float>(8.0f - factoryPointSpringOctant);
+                        }
+                        else
+                        {
+                            // One or more springs...
 
                             //
-                            // CCW
+                            // 1. Find nearest spring CW and closest spring CCW
+                            // (which might and up being the same spring in case there's only one spring)
                             //
 
-                            assert(cwDelta > 0 && cwDelta < 8);
-                            int ccwDelta = 8 - cwDelta;
-                            assert(ccwDelta > 0);
-
-                            if (ccwDelta < nearestCCWSpringDeltaOctant)
+                            int nearestCWSpringIndex = -1;
+                            int nearestCWSpringDeltaOctant = std::numeric_limits<int>::max();
+                            int nearestCCWSpringIndex = -1;
+                            int nearestCCWSpringDeltaOctant = std::numeric_limits<int>::max();
+                            for (auto const & cs : mPoints.GetConnectedSprings(pointIndex).ConnectedSprings)
                             {
-                                nearestCCWSpringIndex = cs.SpringIndex;
-                                nearestCCWSpringDeltaOctant = ccwDelta;
+                                //
+                                // CW
+                                //
+
+                                int cwDelta =
+                                    mSprings.GetFactoryEndpointOctant(cs.SpringIndex, pointIndex)
+                                    - factoryPointSpringOctant;
+
+                                if (cwDelta < 0)
+                                    cwDelta += 8;
+
+                                if (cwDelta < nearestCWSpringDeltaOctant)
+                                {
+                                    nearestCWSpringIndex = cs.SpringIndex;
+                                    nearestCWSpringDeltaOctant = cwDelta;
+                                }
+
+                                //
+                                // CCW
+                                //
+
+                                assert(cwDelta > 0 && cwDelta < 8);
+                                int ccwDelta = 8 - cwDelta;
+                                assert(ccwDelta > 0);
+
+                                if (ccwDelta < nearestCCWSpringDeltaOctant)
+                                {
+                                    nearestCCWSpringIndex = cs.SpringIndex;
+                                    nearestCCWSpringDeltaOctant = ccwDelta;
+                                }
                             }
-                        }
 
-                        assert(nearestCWSpringIndex >= 0);
-                        assert(nearestCWSpringDeltaOctant > 0);
-                        assert(nearestCCWSpringIndex >= 0);
-                        assert(nearestCCWSpringDeltaOctant > 0);
+                            assert(nearestCWSpringIndex >= 0);
+                            assert(nearestCWSpringDeltaOctant > 0);
+                            assert(nearestCCWSpringIndex >= 0);
+                            assert(nearestCCWSpringDeltaOctant > 0);
 
-                        //
-                        // 2. Calculate this spring's world angle by
-                        // interpolating among these two springs
-                        //
+                            //
+                            // 2. Calculate this spring's world angle by
+                            // interpolating among these two springs
+                            //
 
-                        ElementIndex const ccwSpringOtherEndpointIndex =
-                            mSprings.GetOtherEndpointIndex(nearestCCWSpringIndex, pointIndex);
+                            ElementIndex const ccwSpringOtherEndpointIndex =
+                                mSprings.GetOtherEndpointIndex(nearestCCWSpringIndex, pointIndex);
 
-                        ElementIndex const cwSpringOtherEndpointIndex =
-                            mSprings.GetOtherEndpointIndex(nearestCWSpringIndex, pointIndex);
+                            ElementIndex const cwSpringOtherEndpointIndex =
+                                mSprings.GetOtherEndpointIndex(nearestCWSpringIndex, pointIndex);
 
-                        // Angle between this two springs
-                        float neighborsAngle =
-                            (ccwSpringOtherEndpointIndex == cwSpringOtherEndpointIndex)
-                            ? 2.0f * Pi<float>
-                            : (mPoints.GetPosition(ccwSpringOtherEndpointIndex) - mPoints.GetPosition(pointIndex))
-                              .angle(mPoints.GetPosition(cwSpringOtherEndpointIndex) - mPoints.GetPosition(pointIndex));
+                            // Angle between this two springs
+                            float neighborsAngle =
+                                (ccwSpringOtherEndpointIndex == cwSpringOtherEndpointIndex)
+                                ? 2.0f * Pi<float>
+                                : (mPoints.GetPosition(ccwSpringOtherEndpointIndex) - mPoints.GetPosition(pointIndex))
+                                  .angle(mPoints.GetPosition(cwSpringOtherEndpointIndex) - mPoints.GetPosition(pointIndex));
 
-                        if (neighborsAngle < 0.0f)
-                            neighborsAngle += 2.0f * Pi<float>;
+                            if (neighborsAngle < 0.0f)
+                                neighborsAngle += 2.0f * Pi<float>;
 
-                        // Interpolated angle from CW spring
-                        float const interpolatedAngleFromCWSpring =
-                            neighborsAngle
-                            / static_cast<float>(nearestCWSpringDeltaOctant + nearestCCWSpringDeltaOctant)
-                            * static_cast<float>(nearestCWSpringDeltaOctant);
+                            // Interpolated angle from CW spring
+                            float const interpolatedAngleFromCWSpring =
+                                neighborsAngle
+                                / static_cast<float>(nearestCWSpringDeltaOctant + nearestCCWSpringDeltaOctant)
+                                * static_cast<float>(nearestCWSpringDeltaOctant);
 
-                        // And finally, the target world angle (world angle is 0 at E)
-                        targetWorldAngle =
-                            (mPoints.GetPosition(cwSpringOtherEndpointIndex) - mPoints.GetPosition(pointIndex)).angle(vec2f(1.0f, 0.0f))
-                            + interpolatedAngleFromCWSpring;
-                    }
+                            // And finally, the target world angle (world angle is 0 at E)
+                            targetWorldAngle =
+                                (mPoints.GetPosition(cwSpringOtherEndpointIndex) - mPoints.GetPosition(pointIndex)).angle(vec2f(1.0f, 0.0f))
+                                + interpolatedAngleFromCWSpring;
+                        }
 
-                    // Calculate target position
-                    vec2f const targetOtherEndpointPosition =
-                        mPoints.GetPosition(pointIndex)
-                        + vec2f::fromPolar(
-                            mSprings.GetRestLength(fcs.SpringIndex),
-                            targetWorldAngle);
+                        // Calculate target position
+                        vec2f const targetOtherEndpointPosition =
+                            mPoints.GetPosition(pointIndex)
+                            + vec2f::fromPolar(
+                                mSprings.GetRestLength(fcs.SpringIndex),
+                                targetWorldAngle);
 
 
-                    //
-                    // Check progress of other endpoint towards the target position
-                    //
+                        //
+                        // Check progress of other endpoint towards the target position
+                        //
 
-                    // Displacement vector (positive towards target point)
-                    vec2f const displacementVector = targetOtherEndpointPosition - mPoints.GetPosition(fcs.OtherEndpointIndex);
+                        // Displacement vector (positive towards target point)
+                        vec2f const displacementVector = targetOtherEndpointPosition - mPoints.GetPosition(fcs.OtherEndpointIndex);
 
-                    // Distance
-                    float displacementMagnitude = displacementVector.length();
+                        // Distance
+                        float displacementMagnitude = displacementVector.length();
 
-                    // Tolerance to distance
-                    //
-                    // Note: a higher tolerance here causes springs to...spring into life
-                    // already stretches or compressed, generating an undesirable force impuls
-                    float constexpr DisplacementTolerance = 0.025f;
-
-                    // Check whether we are still further away than our tolerance,
-                    // and whether this point is free to move
-                    if (displacementMagnitude > DisplacementTolerance
-                        && !mPoints.IsPinned(fcs.OtherEndpointIndex))
-                    {
-                        //
-                        // Endpoints are too far...
-                        // ...move them closer by moving the other endpoint towards its target position
+                        // Tolerance to distance
                         //
+                        // Note: a higher tolerance here causes springs to...spring into life
+                        // already stretches or compressed, generating an undesirable force impuls
+                        float constexpr DisplacementTolerance = 0.025f;
+
+                        // Check whether we are still further away than our tolerance,
+                        // and whether this point is free to move
+                        if (displacementMagnitude > DisplacementTolerance
+                            && !mPoints.IsPinned(fcs.OtherEndpointIndex))
+                        {
+                            //
+                            // Endpoints are too far...
+                            // ...move them closer by moving the other endpoint towards its target position
+                            //
 
-                        // Fraction of the movement that we want to do in this step
-                        // (which is once per SimulationStep)
-                        //
-                        // A higher value destroys the other point's springs too quickly;
-                        // a lower value makes the other point follow a moving point forever
-                        float constexpr MovementFraction =
-                            4.0f // We want a point to cover the whole distance in 1/4th of a simulated second
-                            * GameParameters::SimulationStepTimeDuration<float>;
+                            // Fraction of the movement that we want to do in this step
+                            // (which is once per SimulationStep)
+                            //
+                            // A higher value destroys the other point's springs too quickly;
+                            // a lower value makes the other point follow a moving point forever
+                            float constexpr MovementFraction =
+                                4.0f // We want a point to cover the whole distance in 1/4th of a simulated second
+                                * GameParameters::SimulationStepTimeDuration<float>;
 
-                        // Movement direction (positive towards this point)
-                        vec2f const movementDir = displacementVector.normalise(displacementMagnitude);
+                            // Movement direction (positive towards this point)
+                            vec2f const movementDir = displacementVector.normalise(displacementMagnitude);
 
-                        // Movement magnitude
-                        //
-                        // Note: here we calculate the movement based on the static positions
-                        // of the two endpoints; however, if the two endpoints have a non-zero
-                        // relative velocity, then this movement won't achieve the desired effect
-                        // (it will undershoot or overshoot). I do think the end result is cool
-                        // though, as you end up, for example, with points chasing a part of a ship
-                        // that's moving away!
-                        float const movementMagnitude =
-                            displacementMagnitude
-                            * MovementFraction
-                            * toolStrength;
-
-                        // Move point
-                        mPoints.GetPosition(fcs.OtherEndpointIndex) +=
-                            movementDir
-                            * movementMagnitude;
-
-                        // Adjust displacement
-                        assert(movementMagnitude < displacementMagnitude);
-                        displacementMagnitude -= movementMagnitude;
-
-                        // Impart some non-linear inertia (smaller at higher displacements),
-                        // just for better looks
-                        // (note: last one that pulls this point wins)
-                        mPoints.GetVelocity(fcs.OtherEndpointIndex) =
-                            movementDir
-                            * ((movementMagnitude < 0.0f) ? -1.0f : 1.0f)
-                            * sqrtf(abs(movementMagnitude))
-                            / GameParameters::GameParameters::SimulationStepTimeDuration<float>
-                            * 0.5f;
-                    }
+                            // Movement magnitude
+                            //
+                            // Note: here we calculate the movement based on the static positions
+                            // of the two endpoints; however, if the two endpoints have a non-zero
+                            // relative velocity, then this movement won't achieve the desired effect
+                            // (it will undershoot or overshoot). I do think the end result is cool
+                            // though, as you end up, for example, with points chasing a part of a ship
+                            // that's moving away!
+                            float const movementMagnitude =
+                                displacementMagnitude
+                                * MovementFraction
+                                * toolStrength;
+
+                            // Move point
+                            mPoints.GetPosition(fcs.OtherEndpointIndex) +=
+                                movementDir
+                                * movementMagnitude;
+
+                            // Adjust displacement
+                            assert(movementMagnitude < displacementMagnitude);
+                            displacementMagnitude -= movementMagnitude;
+
+                            // Impart some non-linear inertia (smaller at higher displacements),
+                            // just for better looks
+                            // (note: last one that pulls this point wins)
+                            mPoints.GetVelocity(fcs.OtherEndpointIndex) =
+                                movementDir
+                                * ((movementMagnitude < 0.0f) ? -1.0f : 1.0f)
+                                * sqrtf(abs(movementMagnitude))
+                                / GameParameters::GameParameters::SimulationStepTimeDuration<float>
+                                * 0.5f;
+                        }
 
-                    // Check whether we are now close enough
-                    if (displacementMagnitude <= DisplacementTolerance)
-                    {
-                        //
-                        // The other endpoint is close enough to its target, implying that
-                        // the spring length should be close to its rest length...
-                        // ...we can restore the spring
-                        //
+                        // Check whether we are now close enough
+                        if (displacementMagnitude <= DisplacementTolerance)
+                        {
+                            //
+                            // The other endpoint is close enough to its target, implying that
+                            // the spring length should be close to its rest length...
+                            // ...we can restore the spring
+                            //
 
-                        // Restore the spring
-                        mSprings.Restore(
-                            fcs.SpringIndex,
-                            gameParameters,
-                            mPoints);
+                            // Restore the spring
+                            mSprings.Restore(
+                                fcs.SpringIndex,
+                                gameParameters,
+                                mPoints);
 
-                        assert(!mSprings.IsDeleted(fcs.SpringIndex));
+                            assert(!mSprings.IsDeleted(fcs.SpringIndex));
 
-                        // Brake the other endpoint
-                        mPoints.SetVelocity(fcs.OtherEndpointIndex, vec2f::zero());
+                            // Brake the other endpoint
+                            mPoints.SetVelocity(fcs.OtherEndpointIndex, vec2f::zero());
+                        }
                     }
                 }
-            }
 
-            //
-            // 2) Restore deleted _eligible_ triangles that were connected to this point at factory time
-            //
-            // A triangle is eligible for being restored if all of its subsprings are not deleted.
-            //
-            // We do this at tool time as there are triangles that have been deleted
-			// without their edge-springs having been deleted, so the resurrection of triangles
-			// wouldn't be complete if we resurrected triangles only when restoring a spring
-            //
+                //
+                // 2) Restore deleted _eligible_ triangles that were connected to this point at factory time
+                //
+                // A triangle is eligible for being restored if all of its subsprings are not deleted.
+                //
+                // We do this at tool time as there are triangles that have been deleted
+    			// without their edge-springs having been deleted, so the resurrection of triangles
+    			// wouldn't be complete if we resurrected triangles only when restoring a spring
+                //
 
-            // Visit all the triangles that were connected at factory time
-            for (auto fct : mPoints.GetFactoryConnectedTriangles(pointIndex).ConnectedTriangles)
-            {
-                if (mTriangles.IsDeleted(fct))
+                // Visit all the triangles that were connected at factory time
+                for (auto fct : mPoints.GetFactoryConnectedTriangles(pointIndex).ConnectedTriangles)
                 {
-                    // Check if eligible
-                    bool hasDeletedSubsprings = false;
-                    for (auto fss : mTriangles.GetFactorySubSprings(fct))
-                        hasDeletedSubsprings |= mSprings.IsDeleted(fss);
-
-                    if (!hasDeletedSubsprings)
+                    if (mTriangles.IsDeleted(fct))
                     {
-                        // Restore it
-                        mTriangles.Restore(fct);
+                        // Check if eligible
+                        bool hasDeletedSubsprings = false;
+                        for (auto fss : mTriangles.GetFactorySubSprings(fct))
+                            hasDeletedSubsprings |= mSprings.IsDeleted(fss);
+
+                        if (!hasDeletedSubsprings)
+                        {
+                            // Restore it
+                            mTriangles.Restore(fct);
+                        }
                     }
                 }
-            }
 
 
-            //
-            // 3) Restore eligible endpoints' IsLeaking
-            //
-            // Eligible endpoints are those that now have all of their factory springs
-            //
+                //
+                // 3) Restore eligible endpoints' IsLeaking
+                //
+                // Eligible endpoints are those that now have all of their factory springs
+                //
 
-            if (mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size()
-                == mPoints.GetFactoryConnectedSprings(pointIndex).ConnectedSprings.size())
-            {
-                mPoints.RestoreFactoryIsLeaking(pointIndex);
+                if (mPoints.GetConnectedSprings(pointIndex).ConnectedSprings.size()
+                    == mPoints.GetFactoryConnectedSprings(pointIndex).ConnectedSprings.size())
+                {
+                    mPoints.RestoreFactoryIsLeaking(pointIndex);
+                }
             }
-        }
-    }
+        });
+
+    // We've moved points
+    mIsInteractionGridCurrent = false;
 }
 
 void Ship::SawThrough(
@@ -427,6 +690,8 @@ void Ship::SawThrough(
     float currentSimulationTime,
     GameParameters const & gameParameters)
 {
+    WakeUpAllIslands();
+
     //
     // Find all springs that intersect the saw segment
     //
@@ -434,43 +699,88 @@ void Ship::SawThrough(
     unsigned int metalsSawed = 0;
     unsigned int nonMetalsSawed = 0;
 
-    for (auto springIndex : mSprings)
+    //
+    // Only test the springs in the grid cells covering the segment's bounding box; a spring
+    // spanning more of these cells is only tested in the first of them - the bottom-left
+    // cell of the overlap between its cells and the segment's cells
+    //
+
+    UpdateInteractionGridSprings();
+
+    auto const getCellX = [this](float x)
     {
-        if (!mSprings.IsDeleted(springIndex))
+        return std::min(static_cast<size_t>(std::max((x - mInteractionGridOrigin.x) / mInteractionGridCellSize, 0.0f)), mInteractionGridWidth - 1);
+    };
+
+    auto const getCellY = [this](float y)
+    {
+        return std::min(static_cast<size_t>(std::max((y - mInteractionGridOrigin.y) / mInteractionGridCellSize, 0.0f)), mInteractionGridHeight - 1);
+    };
+
+    size_t const sawCellX1 = getCellX(std::min(startPos.x, endPos.x));
+    size_t const sawCellX2 = getCellX(std::max(startPos.x, endPos.x));
+    size_t const sawCellY1 = getCellY(std::min(startPos.y, endPos.y));
+    size_t const sawCellY2 = getCellY(std::max(startPos.y, endPos.y));
+
+    auto const sawSpringAt = [&](size_t cellX, size_t cellY, ElementIndex springIndex)
+    {
+        if (mSprings.IsDeleted(springIndex))
+            return;
+
+        vec2f const & endpointAPosition = mSprings.GetEndpointAPosition(springIndex, mPoints);
+        vec2f const & endpointBPosition = mSprings.GetEndpointBPosition(springIndex, mPoints);
+
+        if (cellX != std::max(getCellX(std::min(endpointAPosition.x, endpointBPosition.x)), sawCellX1)
+            || cellY != std::max(getCellY(std::min(endpointAPosition.y, endpointBPosition.y)), sawCellY1))
         {
-            if (Geometry::Segment::ProperIntersectionTest(
-                startPos,
-                endPos,
-                mSprings.GetEndpointAPosition(springIndex, mPoints),
-                mSprings.GetEndpointBPosition(springIndex, mPoints)))
+            // Tested at another cell
+            return;
+        }
+
+        if (Geometry::Segment::ProperIntersectionTest(
+            startPos,
+            endPos,
+            endpointAPosition,
+            endpointBPosition))
+        {
+            // Destroy spring
+            mSprings.Destroy(
+                springIndex,
+                Springs::DestroyOptions::FireBreakEvent
+                | Springs::DestroyOptions::DestroyOnlyConnectedTriangle,
+                gameParameters,
+                mPoints);
+
+            bool const isMetal =
+                mSprings.GetBaseStructuralMaterial(springIndex).MaterialSound == StructuralMaterial::MaterialSoundType::Metal;
+
+            if (isMetal)
             {
-                // Destroy spring
-                mSprings.Destroy(
+                // Emit sparkles
+                GenerateSparkles(
                     springIndex,
-                    Springs::DestroyOptions::FireBreakEvent
-                    | Springs::DestroyOptions::DestroyOnlyConnectedTriangle,
-                    gameParameters,
-                    mPoints);
-
-                bool const isMetal =
-                    mSprings.GetBaseStructuralMaterial(springIndex).MaterialSound == StructuralMaterial::MaterialSoundType::Metal;
+                    startPos,
+                    endPos,
+                    currentSimulationTime,
+                    gameParameters);
+            }
 
-                if (isMetal)
-                {
-                    // Emit sparkles
-                    GenerateSparkles(
-                        springIndex,
-                        startPos,
-                        endPos,
-                        currentSimulationTime,
-                        gameParameters);
-                }
+            // Remember we have sawed this material
+            if (isMetal)
+                metalsSawed++;
+            else
+                nonMetalsSawed++;
+        }
+    };
 
-                // Remember we have sawed this material
-                if (isMetal)
-                    metalsSawed++;
-                else
-                    nonMetalsSawed++;
+    for (size_t cellY = sawCellY1; cellY <= sawCellY2; ++cellY)
+    {
+        for (size_t cellX = sawCellX1; cellX <= sawCellX2; ++cellX)
+        {
+            size_t const cellIndex = cellY * mInteractionGridWidth + cellX;
+            for (ElementIndex i = mInteractionGridSpringCellOffsets[cellIndex]; i < mInteractionGridSpringCellOffsets[cellIndex + 1]; ++i)
+            {
+                sawSpringAt(cellX, cellY, mInteractionGridSpringIndices[i]);
             }
         }
     }
@@ -508,6 +818,8 @@ bool Ship::TogglePinAt(
     vec2f const & targetPos,
     GameParameters const & gameParameters)
 {
+    WakeUpAllIslands();
+
     return mPinnedPoints.ToggleAt(
         targetPos,
         gameParameters);
@@ -539,6 +851,8 @@ bool Ship::FloodAt(
     float waterQuantityMultiplier,
     GameParameters const & gameParameters)
 {
+    WakeUpAllIslands();
+
     float const searchRadius = gameParameters.FloodRadius;
 
     float const quantityOfWater =
@@ -553,22 +867,35 @@ bool Ship::FloodAt(
     float const searchSquareRadius = searchRadius * searchRadius;
 
     bool anyHasFlooded = false;
-    for (auto pointIndex : mPoints.NonEphemeralPoints())
-    {
-        if (!mPoints.IsHull(pointIndex))
+    VisitInteractionGridPointsIn(
+        Geometry::AABB(targetPos.x - searchRadius, targetPos.x + searchRadius, targetPos.y + searchRadius, targetPos.y - searchRadius),
+        [&](ElementIndex pointIndex)
         {
-            float squareDistance = (mPoints.GetPosition(pointIndex) - targetPos).squareLength();
-            if (squareDistance < searchSquareRadius)
+            // The grid also has the ephemeral particles
+            if (Points::EphemeralType::None != mPoints.GetEphemeralType(pointIndex))
+                return;
+
+            if (!mPoints.IsHull(pointIndex))
             {
-                if (quantityOfWater >= 0.0f)
-                    mPoints.GetWater(pointIndex) += quantityOfWater;
-                else
-                    mPoints.GetWater(pointIndex) -= std::min(-quantityOfWater, mPoints.GetWater(pointIndex));
+                float squareDistance = (mPoints.GetPosition(pointIndex) - targetPos).squareLength();
+                if (squareDistance < searchSquareRadius)
+                {
+                    if (quantityOfWater >= 0.0f)
+                    {
+                        mPoints.GetWater(pointIndex) += quantityOfWater;
 
-                anyHasFlooded = true;
+                        // Make sure the water diffusion visits this point
+                        ActivateWaterPoint(pointIndex);
+                    }
+                    else
+                    {
+                        mPoints.GetWater(pointIndex) -= std::min(-quantityOfWater, mPoints.GetWater(pointIndex));
+                    }
+
+                    anyHasFlooded = true;
+                }
             }
-        }
-    }
+        });
 
     return anyHasFlooded;
 }
@@ -643,54 +970,81 @@ bool Ship::ScrubThrough(
 
     // Visit all points (excluding ephemerals, we don't want to scrub air bubbles)
     bool hasScrubbed = false;
-    for (auto pointIndex : mPoints.NonEphemeralPoints())
-    {
-        auto const & pointPosition = mPoints.GetPosition(pointIndex);
-
-        // First check whether the point is in the bounding box
-        if (boundingBox.Contains(pointPosition))
+    VisitInteractionGridPointsIn(
+        boundingBox,
+        [&](ElementIndex pointIndex)
         {
-            // Distance = projection of (start->point) vector on segment normal
-            float const distance = abs((pointPosition - startPos).dot(segmentNormal));
+            // The grid also has the ephemeral particles
+            if (Points::EphemeralType::None != mPoints.GetEphemeralType(pointIndex))
+                return;
+
+            auto const & pointPosition = mPoints.GetPosition(pointIndex);
 
-            // Check whether this point is in the radius
-            if (distance <= scrubRadius)
+            // First check whether the point is in the bounding box
+            if (boundingBox.Contains(pointPosition))
             {
-                //
-                // Scrub this point, with magnitude dependent from distance
-                //
+                // Distance = projection of (start->point) vector on segment normal
+                float const distance = abs((pointPosition - startPos).dot(segmentNormal));
 
-                float newDecay =
-                    mPoints.GetDecay(pointIndex)
-                    + 0.5f * (1.0f - mPoints.GetDecay(pointIndex)) * (scrubRadius - distance) / scrubRadius;
+                // Check whether this point is in the radius
+                if (distance <= scrubRadius)
+                {
+                    //
+                    // Scrub this point, with magnitude dependent from distance
+                    //
 
-                mPoints.SetDecay(pointIndex, newDecay);
+                    float newDecay =
+                        mPoints.GetDecay(pointIndex)
+                        + 0.5f * (1.0f - mPoints.GetDecay(pointIndex)) * (scrubRadius - distance) / scrubRadius;
 
-                // Remember at least one point has been scrubbed
-                hasScrubbed |= true;
+                    mPoints.SetDecay(pointIndex, newDecay);
+
+                    // Remember at least one point has been scrubbed
+                    hasScrubbed |= true;
+                }
             }
-        }
-    }
+        });
+
+    return hasScrubbed;
+}
+
+ElementIndex Ship::GetNearestPointAt(
+    vec2f const & targetPos,
+    float radius) const
+{
+    return FindNearestPointAt(targetPos, radius);
+}
+
+bool Ship::QueryNearestPointAt(
+    vec2f const & targetPos,
+    float radius) const
+{
+    ElementIndex const bestPointIndex = FindNearestPointAt(targetPos, radius);
 
-    if (hasScrubbed)
+    if (NoneElementIndex != bestPointIndex)
     {
-        // Make sure the decay buffer gets uploaded again
-        mPoints.MarkDecayBufferAsDirty();
+        mPoints.Query(bestPointIndex);
+        return true;
     }
 
-    return hasScrubbed;
+    return false;
 }
 
-ElementIndex Ship::GetNearestPointAt(
+ElementIndex Ship::FindNearestPointAt(
     vec2f const & targetPos,
     float radius) const
 {
+    if (!AreNearestPointCandidatesCurrent(targetPos, radius))
+    {
+        GatherNearestPointCandidates(targetPos, radius);
+    }
+
     float const squareRadius = radius * radius;
 
     ElementIndex bestPointIndex = NoneElementIndex;
     float bestSquareDistance = std::numeric_limits<float>::max();
 
-    for (auto pointIndex : mPoints)
+    for (ElementIndex pointIndex : mNearestPointCandidates.PointIndices)
     {
         if (mPoints.IsActive(pointIndex))
         {
@@ -706,35 +1060,62 @@ ElementIndex Ship::GetNearestPointAt(
     return bestPointIndex;
 }
 
-bool Ship::QueryNearestPointAt(
+bool Ship::AreNearestPointCandidatesCurrent(
     vec2f const & targetPos,
     float radius) const
 {
-    float const squareRadius = radius * radius;
+    static constexpr float SquareTolerance = NearestPointCandidatesTolerance * NearestPointCandidatesTolerance;
 
-    ElementIndex bestPointIndex = NoneElementIndex;
-    float bestSquareDistance = std::numeric_limits<float>::max();
+    auto const & candidates = mNearestPointCandidates;
 
-    for (auto pointIndex : mPoints)
+    if (!candidates.IsValid
+        || candidates.Radius != radius
+        || (targetPos - candidates.TargetPosition).squareLength() > SquareTolerance
+        || (mAABB.BottomLeft - candidates.ShipAABB.BottomLeft).squareLength() > SquareTolerance
+        || (mAABB.TopRight - candidates.ShipAABB.TopRight).squareLength() > SquareTolerance)
     {
-        if (mPoints.IsActive(pointIndex))
-        {
-            float squareDistance = (mPoints.GetPosition(pointIndex) - targetPos).squareLength();
-            if (squareDistance < squareRadius && squareDistance < bestSquareDistance)
-            {
-                bestPointIndex = pointIndex;
-                bestSquareDistance = squareDistance;
-            }
-        }
+        return false;
     }
 
-    if (NoneElementIndex != bestPointIndex)
+    for (size_t c = 0; c < candidates.PointIndices.size(); ++c)
     {
-        mPoints.Query(bestPointIndex);
-        return true;
+        if ((mPoints.GetPosition(candidates.PointIndices[c]) - candidates.PointPositions[c]).squareLength() > SquareTolerance)
+        {
+            return false;
+        }
     }
 
-    return false;
+    return true;
+}
+
+void Ship::GatherNearestPointCandidates(
+    vec2f const & targetPos,
+    float radius) const
+{
+    float const candidateRadius = radius + 2.0f * NearestPointCandidatesTolerance;
+    float const squareCandidateRadius = candidateRadius * candidateRadius;
+
+    auto & candidates = mNearestPointCandidates;
+
+    candidates.PointIndices.clear();
+    candidates.PointPositions.clear();
+
+    VisitInteractionGridPointsIn(
+        Geometry::AABB(targetPos.x - candidateRadius, targetPos.x + candidateRadius, targetPos.y + candidateRadius, targetPos.y - candidateRadius),
+        [&](ElementIndex pointIndex)
+        {
+            if (mPoints.IsActive(pointIndex)
+                && (mPoints.GetPosition(pointIndex) - targetPos).squareLength() < squareCandidateRadius)
+            {
+                candidates.PointIndices.push_back(pointIndex);
+                candidates.PointPositions.push_back(mPoints.GetPosition(pointIndex));
+            }
+        });
+
+    candidates.TargetPosition = targetPos;
+    candidates.Radius = radius;
+    candidates.ShipAABB = mAABB;
+    candidates.IsValid = true;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,36 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-10
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+/*
+ * The little the simulation needs to know about the view: the region of the world
+ * being looked at, and whether the point forces are being shown.
+ *
+ * Taken once per step, so that the simulation does not depend on a render context -
+ * and may thus run without one.
+ */
+struct SimulationView
+{
+    float VisibleWorldLeft;
+    float VisibleWorldRight;
+    float VisibleWorldTop;
+    float VisibleWorldBottom;
+
+    bool DoCapturePointForces;
+
+    SimulationView(
+        float visibleWorldLeft,
+        float visibleWorldRight,
+        float visibleWorldTop,
+        float visibleWorldBottom,
+        bool doCapturePointForces)
+        : VisibleWorldLeft(visibleWorldLeft)
+        , VisibleWorldRight(visibleWorldRight)
+        , VisibleWorldTop(visibleWorldTop)
+        , VisibleWorldBottom(visibleWorldBottom)
+        , DoCapturePointForces(doCapturePointForces)
+    {}
+};
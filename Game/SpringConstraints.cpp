@@ -0,0 +1,222 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-24
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "SpringConstraints.h"
+
+#include <cassert>
+
+namespace Physics {
+
+namespace /* anonymous */ {
+
+inline void SolveSpringConstraint(
+    SpringConstraintsBuffers const & buffers,
+    float dt,
+    ElementIndex springIndex)
+{
+    auto const pointAIndex = buffers.SpringEndpoints[springIndex * 2];
+    auto const pointBIndex = buffers.SpringEndpoints[springIndex * 2 + 1];
+
+    vec2f const displacement = buffers.PointPositions[pointBIndex] - buffers.PointPositions[pointAIndex];
+    float const displacementLength = displacement.length();
+    vec2f const springDir = displacement.normalise(displacementLength);
+
+    if (buffers.SpringLengths != nullptr)
+        buffers.SpringLengths[springIndex] = displacementLength;
+
+    //
+    // With compliance alpha = 1/k, the XPBD multiplier update - starting from a zero
+    // multiplier, as each spring is solved once per substep - is:
+    //
+    //  dLambda = -(C + gamma * gradC.dx) / ((1 + gamma) * w + alpha/dt^2)
+    //
+    // ...with gamma = (alpha/dt^2) * c * dt; multiplying through by k * dt^2 keeps it
+    // finite for deleted springs, whose k and c are zero:
+    //
+    //  dLambda = -(k*dt^2 * C + c*dt * gradC.dx) / ((k*dt^2 + c*dt) * w + 1)
+    //
+
+    float const stiffnessTerm = buffers.SpringCoefficients[springIndex * 2] * dt * dt;
+    float const dampingTerm = buffers.SpringCoefficients[springIndex * 2 + 1] * dt;
+
+    float const inverseMassA = buffers.PointInverseMasses[pointAIndex];
+    float const inverseMassB = buffers.PointInverseMasses[pointBIndex];
+
+    float const constraint = displacementLength - buffers.SpringRestLengths[springIndex];
+
+    // How fast the endpoints have been getting apart during this step, along the spring
+    vec2f const relativeDeltaPosition =
+        (buffers.PointPositions[pointBIndex] - buffers.PointPreviousPositions[pointBIndex])
+        - (buffers.PointPositions[pointAIndex] - buffers.PointPreviousPositions[pointAIndex]);
+
+    float const deltaLambda =
+        -(stiffnessTerm * constraint + dampingTerm * relativeDeltaPosition.dot(springDir))
+        / ((stiffnessTerm + dampingTerm) * (inverseMassA + inverseMassB) + 1.0f);
+
+    // Move A down the gradient and B up, each by its share
+    buffers.PointPositions[pointAIndex] -= springDir * (inverseMassA * deltaLambda);
+    buffers.PointPositions[pointBIndex] += springDir * (inverseMassB * deltaLambda);
+}
+
+}
+
+void SolveIndexedSpringConstraints(
+    SpringConstraintsBuffers const & buffers,
+    float dt,
+    ElementIndex const * springIndices,
+    size_t springCount)
+{
+    assert(dt > 0.0f);
+
+    for (size_t i = 0; i < springCount; ++i)
+    {
+        SolveSpringConstraint(buffers, dt, springIndices[i]);
+    }
+}
+
+void SolveSpringConstraints(
+    SpringConstraintsBuffers const & buffers,
+    float dt,
+    ElementIndex startSpringIndex,
+    ElementIndex endSpringIndex)
+{
+    assert(dt > 0.0f);
+
+    for (ElementIndex s = startSpringIndex; s < endSpringIndex; ++s)
+    {
+        SolveSpringConstraint(buffers, dt, s);
+    }
+}
+
+void SolveSpringConstraintChain(
+    SpringConstraintsBuffers const & buffers,
+    float dt,
+    ElementIndex const * chainSpringIndices,
+    ElementIndex const * chainPointIndices,
+    size_t springCount,
+    float * workBuffer)
+{
+    assert(dt > 0.0f);
+
+    //
+    // With j-th spring connecting points j and j+1 along u(j), the rows of the system are
+    // those of SolveSpringConstraint() - multiplied through by s(j) = k(j)*dt^2 + c(j)*dt -
+    // with the couplings via the shared points:
+    //
+    //  s(j) * (w(j) + w(j+1)) * dL(j)
+    //      - s(j) * w(j) * u(j-1).u(j) * dL(j-1)
+    //      - s(j) * w(j+1) * u(j).u(j+1) * dL(j+1)
+    //      + dL(j)
+    //  = -(k(j)*dt^2 * C(j) + c(j)*dt * gradC(j).dx)
+    //
+    // ...which is strictly diagonally dominant, hence the Thomas algorithm is stable on it.
+    // Deleted springs have s = 0, and thus decouple the two sides of the chain.
+    //
+
+    if (springCount == 0)
+        return;
+
+    vec2f * const restrict springDirs = reinterpret_cast<vec2f *>(workBuffer); // u(j)
+    float * const restrict cPrimes = workBuffer + springCount * 2;
+    float * const restrict dPrimes = workBuffer + springCount * 3; // Then, the multipliers
+
+    auto const positions = buffers.PointPositions;
+    auto const previousPositions = buffers.PointPreviousPositions;
+    auto const inverseMasses = buffers.PointInverseMasses;
+
+    //
+    // Directions
+    //
+
+    for (size_t j = 0; j < springCount; ++j)
+    {
+        vec2f const displacement = positions[chainPointIndices[j + 1]] - positions[chainPointIndices[j]];
+        float const displacementLength = displacement.length();
+        springDirs[j] = displacement.normalise(displacementLength);
+
+        // Temporarily
+        dPrimes[j] = displacementLength;
+    }
+
+    //
+    // Forward elimination
+    //
+
+    float previousCPrime = 0.0f;
+    float previousDPrime = 0.0f;
+
+    for (size_t j = 0; j < springCount; ++j)
+    {
+        ElementIndex const springIndex = chainSpringIndices[j];
+        ElementIndex const pointIndex = chainPointIndices[j];
+        ElementIndex const nextPointIndex = chainPointIndices[j + 1];
+
+        float const displacementLength = dPrimes[j];
+
+        if (buffers.SpringLengths != nullptr)
+            buffers.SpringLengths[springIndex] = displacementLength;
+
+        float const stiffnessTerm = buffers.SpringCoefficients[springIndex * 2] * dt * dt;
+        float const dampingTerm = buffers.SpringCoefficients[springIndex * 2 + 1] * dt;
+        float const s = stiffnessTerm + dampingTerm;
+
+        float const constraint = displacementLength - buffers.SpringRestLengths[springIndex];
+
+        vec2f const relativeDeltaPosition =
+            (positions[nextPointIndex] - previousPositions[nextPointIndex])
+            - (positions[pointIndex] - previousPositions[pointIndex]);
+
+        float const rhs = -(stiffnessTerm * constraint + dampingTerm * relativeDeltaPosition.dot(springDirs[j]));
+
+        float const b = s * (inverseMasses[pointIndex] + inverseMasses[nextPointIndex]) + 1.0f;
+
+        float const a = (j > 0)
+            ? -s * inverseMasses[pointIndex] * springDirs[j - 1].dot(springDirs[j])
+            : 0.0f;
+
+        float const c = (j + 1 < springCount)
+            ? -s * inverseMasses[nextPointIndex] * springDirs[j].dot(springDirs[j + 1])
+            : 0.0f;
+
+        float const denominator = b - a * previousCPrime;
+
+        cPrimes[j] = c / denominator;
+        dPrimes[j] = (rhs - a * previousDPrime) / denominator;
+
+        previousCPrime = cPrimes[j];
+        previousDPrime = dPrimes[j];
+    }
+
+    //
+    // Back substitution, into the multipliers
+    //
+
+    for (size_t j = springCount - 1; j > 0; --j)
+    {
+        dPrimes[j - 1] -= cPrimes[j - 1] * dPrimes[j];
+    }
+
+    float const * const restrict deltaLambdas = dPrimes;
+
+    //
+    // Move points: the first point of a spring down its direction, the second up
+    //
+
+    for (size_t i = 0; i <= springCount; ++i)
+    {
+        vec2f correction = vec2f::zero();
+
+        if (i > 0)
+            correction += springDirs[i - 1] * deltaLambdas[i - 1];
+
+        if (i < springCount)
+            correction -= springDirs[i] * deltaLambdas[i];
+
+        ElementIndex const pointIndex = chainPointIndices[i];
+        positions[pointIndex] += correction * inverseMasses[pointIndex];
+    }
+}
+
+}
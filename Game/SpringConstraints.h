@@ -0,0 +1,92 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-24
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/Vectors.h>
+
+#include <cstddef>
+
+namespace Physics
+{
+
+/*
+ * The kernel that solves springs as XPBD distance constraints: rather than accumulating
+ * spring forces, each spring moves its endpoints - after they have been integrated
+ * without the springs - towards its rest length, as much as its compliance allows.
+ *
+ * The compliance of a spring is the inverse of its stiffness coefficient, and its damping
+ * coefficient damps the relative motion of its endpoints along the spring; deleted springs
+ * have zero coefficients, hence they don't move their endpoints.
+ *
+ * Springs are solved one after the other, each seeing the corrections of the springs
+ * before it (Gauss-Seidel); springs that share no endpoints may be solved concurrently.
+ * Chains of springs - i.e. ropes - may also be solved at once, which Gauss-Seidel would
+ * need as many passes as the chain is long for.
+ */
+
+/*
+ * The raw buffers the spring constraints kernel operates on.
+ */
+struct SpringConstraintsBuffers
+{
+    vec2f * PointPositions;
+
+    // As of before the points were integrated
+    vec2f const * PointPreviousPositions;
+
+    // Zero for points that may not be moved
+    float const * PointInverseMasses;
+
+    // Endpoint A and endpoint B indices, interleaved
+    ElementIndex const * SpringEndpoints;
+
+    float const * SpringRestLengths;
+
+    // Stiffness and damping coefficients, interleaved
+    float const * SpringCoefficients;
+
+    // When not null, receives the length of each spring before its correction
+    float * SpringLengths = nullptr;
+};
+
+/*
+ * Solves the springs in the specified list of spring indices, once, for a (sub)step
+ * of the specified duration.
+ */
+void SolveIndexedSpringConstraints(
+    SpringConstraintsBuffers const & buffers,
+    float dt,
+    ElementIndex const * springIndices,
+    size_t springCount);
+
+/*
+ * Solves the springs in [startSpringIndex, endSpringIndex), once, for a (sub)step
+ * of the specified duration.
+ */
+void SolveSpringConstraints(
+    SpringConstraintsBuffers const & buffers,
+    float dt,
+    ElementIndex startSpringIndex,
+    ElementIndex endSpringIndex);
+
+/*
+ * Solves a chain of springs at once, for a (sub)step of the specified duration: the
+ * (linearized) constraints of the chain make a tridiagonal system, which is solved
+ * directly. The i-th spring of the chain connects the i-th and the (i+1)-th point
+ * of the chain, in whatever order its endpoints are.
+ *
+ * The work buffer receives four floats for each spring of the chain.
+ */
+void SolveSpringConstraintChain(
+    SpringConstraintsBuffers const & buffers,
+    float dt,
+    ElementIndex const * chainSpringIndices,
+    ElementIndex const * chainPointIndices,
+    size_t springCount,
+    float * workBuffer);
+
+}
@@ -0,0 +1,501 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-07
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "SpringForces.h"
+
+#include <GameCore/Log.h>
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SPRING_FORCES_X86_64
+#endif
+
+#ifdef SPRING_FORCES_X86_64
+
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC allows AVX2 intrinsics in any function
+#define TARGET_AVX2
+#else
+#include <immintrin.h>
+// GCC and Clang only allow AVX2 intrinsics in functions targeting AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#endif
+
+namespace Physics {
+
+namespace /* anonymous */ {
+
+/*
+ * Indices of springs in a contiguous range.
+ */
+struct SpringIndexRange
+{
+    ElementIndex StartSpringIndex;
+
+    inline ElementIndex operator[](size_t i) const
+    {
+        return StartSpringIndex + static_cast<ElementIndex>(i);
+    }
+};
+
+/*
+ * Indices of springs in a list.
+ */
+struct SpringIndexList
+{
+    ElementIndex const * SpringIndices;
+
+    inline ElementIndex operator[](size_t i) const
+    {
+        return SpringIndices[i];
+    }
+};
+
+template<typename TSpringIndices>
+inline void CalculateSpringForcesScalar(
+    SpringForcesBuffers const & buffers,
+    TSpringIndices const & springIndices,
+    size_t start,
+    size_t end)
+{
+    for (size_t i = start; i < end; ++i)
+    {
+        ElementIndex const springIndex = springIndices[i];
+
+        auto const pointAIndex = buffers.SpringEndpoints[springIndex * 2];
+        auto const pointBIndex = buffers.SpringEndpoints[springIndex * 2 + 1];
+
+        // No need to check whether the spring is deleted, as a deleted spring
+        // has zero coefficients
+
+        vec2f const displacement = buffers.PointPositions[pointBIndex] - buffers.PointPositions[pointAIndex];
+        float const displacementLength = displacement.length();
+        vec2f const springDir = displacement.normalise(displacementLength);
+
+        if (buffers.SpringLengths != nullptr)
+            buffers.SpringLengths[springIndex] = displacementLength;
+
+        //
+        // 1. Hooke's law
+        //
+
+        // Calculate spring force on point A
+        vec2f const fSpringA =
+            springDir
+            * (displacementLength - buffers.SpringRestLengths[springIndex])
+            * buffers.SpringCoefficients[springIndex * 2];
+
+        //
+        // 2. Damper forces
+        //
+        // Damp the velocities of the two points, as if the points were also connected by a damper
+        // along the same direction as the spring
+        //
+
+        // Calculate damp force on point A
+        vec2f const relVelocity = buffers.PointVelocities[pointBIndex] - buffers.PointVelocities[pointAIndex];
+        vec2f const fDampA =
+            springDir
+            * relVelocity.dot(springDir)
+            * buffers.SpringCoefficients[springIndex * 2 + 1];
+
+        //
+        // Apply forces
+        //
+
+        buffers.PointForces[pointAIndex] += fSpringA + fDampA;
+        buffers.PointForces[pointBIndex] -= fSpringA + fDampA;
+    }
+}
+
+#ifdef SPRING_FORCES_X86_64
+
+/*
+ * Loads the vec2f's at the specified indices, returning their x's and y's.
+ */
+inline void LoadVec2fx4(
+    vec2f const * v,
+    ElementIndex i0,
+    ElementIndex i1,
+    ElementIndex i2,
+    ElementIndex i3,
+    __m128 & x,
+    __m128 & y)
+{
+    // x0 y0 x1 y1
+    __m128 const v01 = _mm_loadh_pi(
+        _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<__m64 const *>(v + i0)),
+        reinterpret_cast<__m64 const *>(v + i1));
+
+    // x2 y2 x3 y3
+    __m128 const v23 = _mm_loadh_pi(
+        _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<__m64 const *>(v + i2)),
+        reinterpret_cast<__m64 const *>(v + i3));
+
+    x = _mm_shuffle_ps(v01, v23, _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm_shuffle_ps(v01, v23, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+template<typename TSpringIndices>
+void CalculateSpringForcesSSE2(
+    SpringForcesBuffers const & buffers,
+    TSpringIndices const & springIndices,
+    size_t springCount)
+{
+    static constexpr size_t Width = 4;
+
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const one = _mm_set1_ps(1.0f);
+
+    alignas(16) float forceX[Width];
+    alignas(16) float forceY[Width];
+    alignas(16) float lengths[Width];
+
+    size_t i = 0;
+    for (; i + Width <= springCount; i += Width)
+    {
+        ElementIndex s[Width];
+        ElementIndex pointA[Width];
+        ElementIndex pointB[Width];
+        for (size_t l = 0; l < Width; ++l)
+        {
+            s[l] = springIndices[i + l];
+            pointA[l] = buffers.SpringEndpoints[s[l] * 2];
+            pointB[l] = buffers.SpringEndpoints[s[l] * 2 + 1];
+        }
+
+        __m128 const restLength = _mm_set_ps(
+            buffers.SpringRestLengths[s[3]],
+            buffers.SpringRestLengths[s[2]],
+            buffers.SpringRestLengths[s[1]],
+            buffers.SpringRestLengths[s[0]]);
+
+        __m128 const stiffness = _mm_set_ps(
+            buffers.SpringCoefficients[s[3] * 2],
+            buffers.SpringCoefficients[s[2] * 2],
+            buffers.SpringCoefficients[s[1] * 2],
+            buffers.SpringCoefficients[s[0] * 2]);
+
+        __m128 const damping = _mm_set_ps(
+            buffers.SpringCoefficients[s[3] * 2 + 1],
+            buffers.SpringCoefficients[s[2] * 2 + 1],
+            buffers.SpringCoefficients[s[1] * 2 + 1],
+            buffers.SpringCoefficients[s[0] * 2 + 1]);
+
+        __m128 posAX, posAY, posBX, posBY;
+        LoadVec2fx4(buffers.PointPositions, pointA[0], pointA[1], pointA[2], pointA[3], posAX, posAY);
+        LoadVec2fx4(buffers.PointPositions, pointB[0], pointB[1], pointB[2], pointB[3], posBX, posBY);
+
+        __m128 velAX, velAY, velBX, velBY;
+        LoadVec2fx4(buffers.PointVelocities, pointA[0], pointA[1], pointA[2], pointA[3], velAX, velAY);
+        LoadVec2fx4(buffers.PointVelocities, pointB[0], pointB[1], pointB[2], pointB[3], velBX, velBY);
+
+        __m128 const displacementX = _mm_sub_ps(posBX, posAX);
+        __m128 const displacementY = _mm_sub_ps(posBY, posAY);
+
+        __m128 const displacementLength = _mm_sqrt_ps(
+            _mm_add_ps(
+                _mm_mul_ps(displacementX, displacementX),
+                _mm_mul_ps(displacementY, displacementY)));
+
+        // Zero-length springs have a zero direction; as their displacement is zero,
+        // we just need to avoid dividing by zero
+        __m128 const validMask = _mm_cmpgt_ps(displacementLength, zero);
+        __m128 const safeDisplacementLength = _mm_or_ps(
+            _mm_and_ps(validMask, displacementLength),
+            _mm_andnot_ps(validMask, one));
+
+        __m128 const springDirX = _mm_div_ps(displacementX, safeDisplacementLength);
+        __m128 const springDirY = _mm_div_ps(displacementY, safeDisplacementLength);
+
+        // 1. Hooke's law
+        __m128 const hookeFactor = _mm_sub_ps(displacementLength, restLength);
+        __m128 const fSpringX = _mm_mul_ps(_mm_mul_ps(springDirX, hookeFactor), stiffness);
+        __m128 const fSpringY = _mm_mul_ps(_mm_mul_ps(springDirY, hookeFactor), stiffness);
+
+        // 2. Damper forces
+        __m128 const relVelocityDot = _mm_add_ps(
+            _mm_mul_ps(_mm_sub_ps(velBX, velAX), springDirX),
+            _mm_mul_ps(_mm_sub_ps(velBY, velAY), springDirY));
+        __m128 const fDampX = _mm_mul_ps(_mm_mul_ps(springDirX, relVelocityDot), damping);
+        __m128 const fDampY = _mm_mul_ps(_mm_mul_ps(springDirY, relVelocityDot), damping);
+
+        _mm_store_ps(forceX, _mm_add_ps(fSpringX, fDampX));
+        _mm_store_ps(forceY, _mm_add_ps(fSpringY, fDampY));
+
+        if (buffers.SpringLengths != nullptr)
+        {
+            _mm_store_ps(lengths, displacementLength);
+            for (size_t l = 0; l < Width; ++l)
+                buffers.SpringLengths[s[l]] = lengths[l];
+        }
+
+        // Apply forces; done one spring at a time, as springs in the same
+        // group may share endpoints
+        for (size_t l = 0; l < Width; ++l)
+        {
+            buffers.PointForces[pointA[l]] += vec2f(forceX[l], forceY[l]);
+            buffers.PointForces[pointB[l]] -= vec2f(forceX[l], forceY[l]);
+        }
+    }
+
+    // Remainder
+    CalculateSpringForcesScalar(buffers, springIndices, i, springCount);
+}
+
+/*
+ * Gathers the vec2f's at the specified indices, returning their x's and y's.
+ */
+TARGET_AVX2 inline void LoadVec2fx8(
+    vec2f const * v,
+    __m128i indices0123,
+    __m128i indices4567,
+    __m256 & x,
+    __m256 & y)
+{
+    // x0 y0 x1 y1 | x2 y2 x3 y3
+    __m256 const v0123 = _mm256_castpd_ps(
+        _mm256_i32gather_pd(reinterpret_cast<double const *>(v), indices0123, sizeof(vec2f)));
+
+    // x4 y4 x5 y5 | x6 y6 x7 y7
+    __m256 const v4567 = _mm256_castpd_ps(
+        _mm256_i32gather_pd(reinterpret_cast<double const *>(v), indices4567, sizeof(vec2f)));
+
+    // Shuffling works within 128-bit lanes, yielding 0 1 4 5 | 2 3 6 7; we then
+    // swap the middle pairs
+    x = _mm256_castpd_ps(
+        _mm256_permute4x64_pd(
+            _mm256_castps_pd(_mm256_shuffle_ps(v0123, v4567, _MM_SHUFFLE(2, 0, 2, 0))),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+
+    y = _mm256_castpd_ps(
+        _mm256_permute4x64_pd(
+            _mm256_castps_pd(_mm256_shuffle_ps(v0123, v4567, _MM_SHUFFLE(3, 1, 3, 1))),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+template<typename TSpringIndices>
+TARGET_AVX2 void CalculateSpringForcesAVX2(
+    SpringForcesBuffers const & buffers,
+    TSpringIndices const & springIndices,
+    size_t springCount)
+{
+    static constexpr size_t Width = 8;
+
+    __m256 const zero = _mm256_setzero_ps();
+    __m256 const one = _mm256_set1_ps(1.0f);
+
+    // Widened to the 32-bit indices of the gathers, whatever the width of our element indices
+    alignas(32) std::int32_t pointA[Width];
+    alignas(32) std::int32_t pointB[Width];
+    alignas(32) float restLengths[Width];
+    alignas(32) float stiffnesses[Width];
+    alignas(32) float dampings[Width];
+    alignas(32) float forceX[Width];
+    alignas(32) float forceY[Width];
+    alignas(32) float lengths[Width];
+
+    size_t i = 0;
+    for (; i + Width <= springCount; i += Width)
+    {
+        for (size_t l = 0; l < Width; ++l)
+        {
+            ElementIndex const s = springIndices[i + l];
+            pointA[l] = buffers.SpringEndpoints[s * 2];
+            pointB[l] = buffers.SpringEndpoints[s * 2 + 1];
+            restLengths[l] = buffers.SpringRestLengths[s];
+            stiffnesses[l] = buffers.SpringCoefficients[s * 2];
+            dampings[l] = buffers.SpringCoefficients[s * 2 + 1];
+        }
+
+        __m128i const pointA0123 = _mm_load_si128(reinterpret_cast<__m128i const *>(pointA));
+        __m128i const pointA4567 = _mm_load_si128(reinterpret_cast<__m128i const *>(pointA + 4));
+        __m128i const pointB0123 = _mm_load_si128(reinterpret_cast<__m128i const *>(pointB));
+        __m128i const pointB4567 = _mm_load_si128(reinterpret_cast<__m128i const *>(pointB + 4));
+
+        __m256 const restLength = _mm256_load_ps(restLengths);
+        __m256 const stiffness = _mm256_load_ps(stiffnesses);
+        __m256 const damping = _mm256_load_ps(dampings);
+
+        __m256 posAX, posAY, posBX, posBY;
+        LoadVec2fx8(buffers.PointPositions, pointA0123, pointA4567, posAX, posAY);
+        LoadVec2fx8(buffers.PointPositions, pointB0123, pointB4567, posBX, posBY);
+
+        __m256 velAX, velAY, velBX, velBY;
+        LoadVec2fx8(buffers.PointVelocities, pointA0123, pointA4567, velAX, velAY);
+        LoadVec2fx8(buffers.PointVelocities, pointB0123, pointB4567, velBX, velBY);
+
+        __m256 const displacementX = _mm256_sub_ps(posBX, posAX);
+        __m256 const displacementY = _mm256_sub_ps(posBY, posAY);
+
+        __m256 const displacementLength = _mm256_sqrt_ps(
+            _mm256_add_ps(
+                _mm256_mul_ps(displacementX, displacementX),
+                _mm256_mul_ps(displacementY, displacementY)));
+
+        // Zero-length springs have a zero direction; as their displacement is zero,
+        // we just need to avoid dividing by zero
+        __m256 const validMask = _mm256_cmp_ps(displacementLength, zero, _CMP_GT_OQ);
+        __m256 const safeDisplacementLength = _mm256_blendv_ps(one, displacementLength, validMask);
+
+        __m256 const springDirX = _mm256_div_ps(displacementX, safeDisplacementLength);
+        __m256 const springDirY = _mm256_div_ps(displacementY, safeDisplacementLength);
+
+        // 1. Hooke's law
+        __m256 const hookeFactor = _mm256_sub_ps(displacementLength, restLength);
+        __m256 const fSpringX = _mm256_mul_ps(_mm256_mul_ps(springDirX, hookeFactor), stiffness);
+        __m256 const fSpringY = _mm256_mul_ps(_mm256_mul_ps(springDirY, hookeFactor), stiffness);
+
+        // 2. Damper forces
+        __m256 const relVelocityDot = _mm256_add_ps(
+            _mm256_mul_ps(_mm256_sub_ps(velBX, velAX), springDirX),
+            _mm256_mul_ps(_mm256_sub_ps(velBY, velAY), springDirY));
+        __m256 const fDampX = _mm256_mul_ps(_mm256_mul_ps(springDirX, relVelocityDot), damping);
+        __m256 const fDampY = _mm256_mul_ps(_mm256_mul_ps(springDirY, relVelocityDot), damping);
+
+        _mm256_store_ps(forceX, _mm256_add_ps(fSpringX, fDampX));
+        _mm256_store_ps(forceY, _mm256_add_ps(fSpringY, fDampY));
+
+        if (buffers.SpringLengths != nullptr)
+        {
+            _mm256_store_ps(lengths, displacementLength);
+            for (size_t l = 0; l < Width; ++l)
+                buffers.SpringLengths[springIndices[i + l]] = lengths[l];
+        }
+
+        // Apply forces; done one spring at a time, as springs in the same
+        // group may share endpoints
+        for (size_t l = 0; l < Width; ++l)
+        {
+            buffers.PointForces[pointA[l]] += vec2f(forceX[l], forceY[l]);
+            buffers.PointForces[pointB[l]] -= vec2f(forceX[l], forceY[l]);
+        }
+    }
+
+    // Remainder
+    CalculateSpringForcesScalar(buffers, springIndices, i, springCount);
+}
+
+#endif
+
+SpringForcesImplementation DetectBestSpringForcesImplementation()
+{
+#ifdef SPRING_FORCES_X86_64
+
+    bool isAVX2Supported = false;
+
+#ifdef _MSC_VER
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 0);
+    if (cpuInfo[0] >= 7)
+    {
+        // The OS must also save the AVX registers
+        __cpuid(cpuInfo, 1);
+        bool const isOSXSaveSupported = (cpuInfo[2] & (1 << 27)) != 0;
+        if (isOSXSaveSupported && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(cpuInfo, 7, 0);
+            isAVX2Supported = (cpuInfo[1] & (1 << 5)) != 0;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    isAVX2Supported = __builtin_cpu_supports("avx2");
+#endif
+
+    if (isAVX2Supported)
+        return SpringForcesImplementation::AVX2;
+
+    // SSE2 is part of x86-64
+    return SpringForcesImplementation::SSE2;
+
+#else
+
+    return SpringForcesImplementation::Scalar;
+
+#endif
+}
+
+template<typename TSpringIndices>
+inline void DispatchSpringForces(
+    SpringForcesImplementation implementation,
+    SpringForcesBuffers const & buffers,
+    TSpringIndices const & springIndices,
+    size_t springCount)
+{
+    switch (implementation)
+    {
+#ifdef SPRING_FORCES_X86_64
+        case SpringForcesImplementation::AVX2:
+        {
+            CalculateSpringForcesAVX2(buffers, springIndices, springCount);
+            break;
+        }
+
+        case SpringForcesImplementation::SSE2:
+        {
+            CalculateSpringForcesSSE2(buffers, springIndices, springCount);
+            break;
+        }
+#endif
+
+        default:
+        {
+            CalculateSpringForcesScalar(buffers, springIndices, 0, springCount);
+            break;
+        }
+    }
+}
+
+}
+
+SpringForcesImplementation GetBestSpringForcesImplementation()
+{
+    static SpringForcesImplementation const BestImplementation = []()
+    {
+        auto const implementation = DetectBestSpringForcesImplementation();
+
+        LogMessage("SpringForces: using implementation ", static_cast<int>(implementation));
+
+        return implementation;
+    }();
+
+    return BestImplementation;
+}
+
+void CalculateSpringForces(
+    SpringForcesImplementation implementation,
+    SpringForcesBuffers const & buffers,
+    ElementIndex startSpringIndex,
+    ElementIndex endSpringIndex)
+{
+    assert(startSpringIndex <= endSpringIndex);
+
+    DispatchSpringForces(
+        implementation,
+        buffers,
+        SpringIndexRange{ startSpringIndex },
+        static_cast<size_t>(endSpringIndex - startSpringIndex));
+}
+
+void CalculateIndexedSpringForces(
+    SpringForcesImplementation implementation,
+    SpringForcesBuffers const & buffers,
+    ElementIndex const * springIndices,
+    size_t springCount)
+{
+    DispatchSpringForces(
+        implementation,
+        buffers,
+        SpringIndexList{ springIndices },
+        springCount);
+}
+
+}
@@ -0,0 +1,76 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-07
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/Vectors.h>
+
+#include <cstddef>
+
+namespace Physics
+{
+
+/*
+ * The kernels that calculate the spring forces - Hooke's law and damping - and accumulate
+ * them into the forces of the spring endpoints.
+ *
+ * All kernels produce the same results as the scalar kernel, modulo floating point
+ * rounding differences.
+ */
+
+enum class SpringForcesImplementation
+{
+    Scalar,
+    SSE2,   // 4 springs at a time
+    AVX2    // 8 springs at a time
+};
+
+/*
+ * The raw buffers the spring forces kernels operate on.
+ */
+struct SpringForcesBuffers
+{
+    vec2f const * PointPositions;
+    vec2f const * PointVelocities;
+    vec2f * PointForces;
+
+    // Endpoint A and endpoint B indices, interleaved
+    ElementIndex const * SpringEndpoints;
+
+    float const * SpringRestLengths;
+
+    // Stiffness and damping coefficients, interleaved
+    float const * SpringCoefficients;
+
+    // When not null, receives the current length of each spring
+    float * SpringLengths = nullptr;
+};
+
+/*
+ * Gets the fastest implementation supported by the CPU we're running on; detected
+ * once, at the first invocation.
+ */
+SpringForcesImplementation GetBestSpringForcesImplementation();
+
+/*
+ * Calculates the forces of the springs in [startSpringIndex, endSpringIndex).
+ */
+void CalculateSpringForces(
+    SpringForcesImplementation implementation,
+    SpringForcesBuffers const & buffers,
+    ElementIndex startSpringIndex,
+    ElementIndex endSpringIndex);
+
+/*
+ * Calculates the forces of the springs in the specified list of spring indices.
+ */
+void CalculateIndexedSpringForces(
+    SpringForcesImplementation implementation,
+    SpringForcesBuffers const & buffers,
+    ElementIndex const * springIndices,
+    size_t springCount);
+
+}
@@ -5,7 +5,11 @@
  ***************************************************************************************/
 #include "Physics.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 namespace Physics {
 
@@ -40,22 +44,19 @@ void Springs::Add(
         / 2.0f;
     mStiffnessBuffer.emplace_back(stiffness);
 
-    mRestLengthBuffer.emplace_back((points.GetPosition(pointAIndex) - points.GetPosition(pointBIndex)).length());
+    float const restLength = (points.GetPosition(pointAIndex) - points.GetPosition(pointBIndex)).length();
+    mRestLengthBuffer.emplace_back(restLength);
+    mLengthBuffer.emplace_back(restLength);
 
+    Coefficients const materialCoefficients = CalculateMaterialCoefficients(
+        pointAIndex,
+        pointBIndex,
+        stiffness,
+        points);
+    mMaterialCoefficientsBuffer.emplace_back(materialCoefficients);
     mCoefficientsBuffer.emplace_back(
-        CalculateStiffnessCoefficient(
-            pointAIndex,
-            pointBIndex,
-            stiffness,
-            mCurrentSpringStiffnessAdjustment,
-            mCurrentNumMechanicalDynamicsIterations,
-            points),
-        CalculateDampingCoefficient(
-            pointAIndex,
-            pointBIndex,
-            mCurrentSpringDampingAdjustment,
-            mCurrentNumMechanicalDynamicsIterations,
-            points));
+        materialCoefficients.StiffnessCoefficient * mStiffnessCoefficientFactor,
+        materialCoefficients.DampingCoefficient * mDampingCoefficientFactor);
 
     mCharacteristicsBuffer.emplace_back(characteristics);
 
@@ -73,8 +74,12 @@ void Springs::Add(
         : 1.0f);
 
     mIsStressedBuffer.emplace_back(false);
+    mStressedSpringSlotBuffer.emplace_back(NoneElementIndex);
 
     mIsBombAttachedBuffer.emplace_back(false);
+
+    mRenderElementSlotBuffer.emplace_back(NoneElementIndex);
+    UpdateRenderElement(static_cast<ElementIndex>(mIsDeletedBuffer.GetCurrentPopulatedSize() - 1));
 }
 
 void Springs::Destroy(
@@ -87,31 +92,41 @@ void Springs::Destroy(
     assert(!IsDeleted(springElementIndex));
 
     // Invoke destroy handler
-    if (!!mDestroyHandler)
+    if (nullptr != mShipHandler)
     {
-        mDestroyHandler(
+        mShipHandler->SpringDestroyHandler(
             springElementIndex,
             !!(destroyOptions & Springs::DestroyOptions::DestroyAllTriangles),
             gameParameters);
     }
 
-    // Fire spring break event, unless told otherwise
+    // Accumulate spring break event, unless told otherwise
     if (!!(destroyOptions & Springs::DestroyOptions::FireBreakEvent))
     {
-        mGameEventHandler->OnBreak(
+        AccumulateEvent(
+            mPendingBreakEvents,
             GetBaseStructuralMaterial(springElementIndex),
-            mParentWorld.IsUnderwater(GetEndpointAPosition(springElementIndex, points)), // Arbitrary
-            1);
+            mParentWorld.IsUnderwater(GetEndpointAPosition(springElementIndex, points))); // Arbitrary
     }
 
     // Zero out our coefficients, so that we can still calculate Hooke's
     // and damping forces for this spring without running the risk of
     // affecting non-deleted points
-    mCoefficientsBuffer[springElementIndex].StiffnessCoefficient = 0.0f;
-    mCoefficientsBuffer[springElementIndex].DampingCoefficient = 0.0f;
+    mCoefficientsBuffer[springElementIndex] = Coefficients(0.0f, 0.0f);
+    mMaterialCoefficientsBuffer[springElementIndex] = Coefficients(0.0f, 0.0f);
 
     // Flag ourselves as deleted
     mIsDeletedBuffer[springElementIndex] = true;
+
+    // Deleted springs are not rendered as stressed
+    if (mIsStressedBuffer[springElementIndex])
+        mIsStressedSpringSetDirty = true;
+
+    // Nor rendered at all
+    UpdateRenderElement(springElementIndex);
+
+    // Remember that we need to re-partition springs
+    mAreParallelForceBatchesDirty = true;
 }
 
 void Springs::Restore(
@@ -125,99 +140,179 @@ void Springs::Restore(
     // Clear the delete flag
     mIsDeletedBuffer[springElementIndex] = false;
 
-    // Recalculate coefficients
+    if (mIsStressedBuffer[springElementIndex])
+        mIsStressedSpringSetDirty = true;
 
-    mCoefficientsBuffer[springElementIndex].StiffnessCoefficient = CalculateStiffnessCoefficient(
-        GetEndpointAIndex(springElementIndex),
-        GetEndpointBIndex(springElementIndex),
-        GetStiffness(springElementIndex),
-        gameParameters.SpringStiffnessAdjustment,
-        gameParameters.NumMechanicalDynamicsIterations<float>(),
-        points);
+    UpdateRenderElement(springElementIndex);
 
-    mCoefficientsBuffer[springElementIndex].DampingCoefficient = CalculateDampingCoefficient(
-        GetEndpointAIndex(springElementIndex),
-        GetEndpointBIndex(springElementIndex),
-        gameParameters.SpringDampingAdjustment,
-        gameParameters.NumMechanicalDynamicsIterations<float>(),
-        points);
+    // Remember that we need to re-partition springs
+    mAreParallelForceBatchesDirty = true;
+
+    // Recalculate coefficients
+    UpdateCoefficients(springElementIndex, points);
 
     // Invoke restore handler
-    if (!!mRestoreHandler)
+    if (nullptr != mShipHandler)
     {
-        mRestoreHandler(
+        mShipHandler->SpringRestoreHandler(
             springElementIndex,
             gameParameters);
     }
 }
 
-void Springs::UpdateGameParameters(
-    GameParameters const & gameParameters,
-    Points const & points)
+void Springs::FlushEvents()
+{
+    for (auto const & pendingEvent : mPendingBreakEvents)
+    {
+        mGameEventHandler->OnBreak(
+            *(pendingEvent.Material),
+            pendingEvent.IsUnderwater,
+            pendingEvent.Size);
+    }
+
+    mPendingBreakEvents.clear();
+
+    for (auto const & pendingEvent : mPendingStressEvents)
+    {
+        mGameEventHandler->OnStress(
+            *(pendingEvent.Material),
+            pendingEvent.IsUnderwater,
+            pendingEvent.Size);
+    }
+
+    mPendingStressEvents.clear();
+}
+
+void Springs::UpdateGameParameters(GameParameters const & gameParameters)
 {
     float const numMechanicalDynamicsIterations = gameParameters.NumMechanicalDynamicsIterations<float>();
     if (numMechanicalDynamicsIterations != mCurrentNumMechanicalDynamicsIterations
         || gameParameters.SpringStiffnessAdjustment != mCurrentSpringStiffnessAdjustment
         || gameParameters.SpringDampingAdjustment != mCurrentSpringDampingAdjustment)
     {
-        // Recalc coefficients
-        for (ElementIndex i : *this)
-        {
-            if (!IsDeleted(i))
-            {
-                mCoefficientsBuffer[i].StiffnessCoefficient = CalculateStiffnessCoefficient(
-                    GetEndpointAIndex(i),
-                    GetEndpointBIndex(i),
-                    GetStiffness(i),
-                    gameParameters.SpringStiffnessAdjustment,
-                    numMechanicalDynamicsIterations,
-                    points);
-
-                mCoefficientsBuffer[i].DampingCoefficient = CalculateDampingCoefficient(
-                    GetEndpointAIndex(i),
-                    GetEndpointBIndex(i),
-                    gameParameters.SpringDampingAdjustment,
-                    numMechanicalDynamicsIterations,
-                    points);
-            }
-        }
-
         // Remember the new values
         mCurrentNumMechanicalDynamicsIterations = numMechanicalDynamicsIterations;
         mCurrentSpringStiffnessAdjustment = gameParameters.SpringStiffnessAdjustment;
         mCurrentSpringDampingAdjustment = gameParameters.SpringDampingAdjustment;
+
+        UpdateCoefficientFactors();
+
+        //
+        // Recalc coefficients: as the material coefficients are kept up-to-date with masses,
+        // this is just a scaling - which also keeps deleted springs' coefficients at zero -
+        // done over the whole buffer, pairs of coefficients at a time
+        //
+
+        float const * const restrict materialCoefficients = reinterpret_cast<float const *>(mMaterialCoefficientsBuffer.data());
+        float * const restrict coefficients = reinterpret_cast<float *>(mCoefficientsBuffer.data());
+
+        float const factors[2] = { mStiffnessCoefficientFactor, mDampingCoefficientFactor };
+
+        size_t const count = static_cast<size_t>(GetBufferElementCount()) * 2;
+        for (size_t i = 0; i < count; i += 2)
+        {
+            coefficients[i] = materialCoefficients[i] * factors[0];
+            coefficients[i + 1] = materialCoefficients[i + 1] * factors[1];
+        }
     }
 }
 
-void Springs::UploadElements(
-    ShipId shipId,
-    Render::RenderContext & renderContext) const
+void Springs::UpdateCoefficientFactors()
+{
+    float const dt = GameParameters::SimulationStepTimeDuration<float> / mCurrentNumMechanicalDynamicsIterations;
+
+    mStiffnessCoefficientFactor = mCurrentSpringStiffnessAdjustment / (dt * dt);
+    mDampingCoefficientFactor = mCurrentSpringDampingAdjustment / dt;
+}
+
+void Springs::UpdateParallelForceBatches(Points const & points)
 {
-    // Either upload all springs, or just the edge springs
-    bool const doUploadAllSprings = (DebugShipRenderMode::Springs == renderContext.GetDebugShipRenderMode());
+    //
+    // Greedy edge coloring: we visit springs in their (optimized) order, and assign
+    // each spring to the first batch that doesn't contain yet any of its endpoints.
+    //
+    // With at most MaxSpringsPerPoint springs per point, we need at most
+    // 2 * MaxSpringsPerPoint - 1 batches.
+    //
+    // Within each batch, springs maintain their relative order, so to retain as
+    // much data locality as we can.
+    //
+
+    static_assert(2 * GameParameters::MaxSpringsPerPoint - 1 <= 32, "Batch masks must fit in 32 bits");
 
-    // Ropes are uploaded as springs only if DebugRenderMode is springs or edge springs
-    bool const doUploadRopesAsSprings = (
-        DebugShipRenderMode::Springs == renderContext.GetDebugShipRenderMode()
-        || DebugShipRenderMode::EdgeSprings == renderContext.GetDebugShipRenderMode());
+    // The batches each point already participates in, as a bitmask
+    std::vector<uint32_t> pointBatchMasks(points.GetElementCount(), 0u);
 
-    for (ElementIndex i : *this)
+    // The batch of each spring; NoneBatch for deleted springs
+    static constexpr uint8_t NoneBatch = std::numeric_limits<uint8_t>::max();
+    std::vector<uint8_t> springBatches(mElementCount, NoneBatch);
+
+    std::vector<size_t> batchSizes;
+
+    for (ElementIndex s : *this)
     {
-        // Only upload non-deleted springs that are not covered by two super-triangles, unless
-        // we are in springs render mode
-        if (!mIsDeletedBuffer[i])
+        if (!mIsDeletedBuffer[s])
         {
-            if (IsRope(i) && !doUploadRopesAsSprings)
+            auto const pointAIndex = mEndpointsBuffer[s].PointAIndex;
+            auto const pointBIndex = mEndpointsBuffer[s].PointBIndex;
+
+            uint32_t const usedBatchesMask = pointBatchMasks[pointAIndex] | pointBatchMasks[pointBIndex];
+
+            uint8_t batch = 0;
+            while (0 != (usedBatchesMask & (1u << batch)))
             {
-                renderContext.UploadShipElementRope(
-                    shipId,
-                    GetEndpointAIndex(i),
-                    GetEndpointBIndex(i));
+                ++batch;
             }
-            else if (
-                mSuperTrianglesBuffer[i].size() < 2
-                || doUploadAllSprings
-                || IsRope(i))
+
+            assert(batch < 2 * GameParameters::MaxSpringsPerPoint - 1);
+
+            pointBatchMasks[pointAIndex] |= (1u << batch);
+            pointBatchMasks[pointBIndex] |= (1u << batch);
+
+            springBatches[s] = batch;
+
+            if (batch >= batchSizes.size())
+                batchSizes.resize(batch + 1, 0);
+
+            ++(batchSizes[batch]);
+        }
+    }
+
+    //
+    // Lay out batches one after the other
+    //
+
+    mParallelForceBatchStarts.clear();
+    mParallelForceBatchStarts.push_back(0);
+    for (size_t batchSize : batchSizes)
+    {
+        mParallelForceBatchStarts.push_back(mParallelForceBatchStarts.back() + batchSize);
+    }
+
+    mParallelForceBatchSprings.resize(mParallelForceBatchStarts.back());
+
+    std::vector<size_t> batchInsertionOffsets(mParallelForceBatchStarts.begin(), mParallelForceBatchStarts.end() - 1);
+    for (ElementIndex s : *this)
+    {
+        if (NoneBatch != springBatches[s])
+        {
+            mParallelForceBatchSprings[batchInsertionOffsets[springBatches[s]]++] = s;
+        }
+    }
+
+    mAreParallelForceBatchesDirty = false;
+}
+
+void Springs::UploadElements(
+    ShipId shipId,
+    Render::RenderContext & renderContext) const
+{
+    if (DebugShipRenderMode::Springs == renderContext.GetDebugShipRenderMode())
+    {
+        // Upload all non-deleted springs, ropes included, as springs
+        for (ElementIndex i : *this)
+        {
+            if (!mIsDeletedBuffer[i])
             {
                 renderContext.UploadShipElementSpring(
                     shipId,
@@ -226,25 +321,50 @@ void Springs::UploadElements(
             }
         }
     }
+    else
+    {
+        // Upload the springs that are not covered by two super-triangles, all at once
+        renderContext.UploadShipElementSprings(
+            shipId,
+            mRenderSpringElements.Endpoints.data(),
+            mRenderSpringElements.Springs.size());
+
+        // Ropes are uploaded as springs only if DebugRenderMode is edge springs
+        if (DebugShipRenderMode::EdgeSprings == renderContext.GetDebugShipRenderMode())
+        {
+            renderContext.UploadShipElementSprings(
+                shipId,
+                mRenderRopeElements.Endpoints.data(),
+                mRenderRopeElements.Springs.size());
+        }
+        else
+        {
+            renderContext.UploadShipElementRopes(
+                shipId,
+                mRenderRopeElements.Endpoints.data(),
+                mRenderRopeElements.Springs.size());
+        }
+    }
 }
 
 void Springs::UploadStressedSpringElements(
     ShipId shipId,
-    Render::RenderContext & renderContext) const
+    Render::RenderContext & renderContext)
 {
-    for (ElementIndex i : *this)
+    for (ElementIndex i : mStressedSprings)
     {
+        assert(mIsStressedBuffer[i]);
+
         if (!mIsDeletedBuffer[i])
         {
-            if (mIsStressedBuffer[i])
-            {
-                renderContext.UploadShipElementStressedSpring(
-                    shipId,
-                    GetEndpointAIndex(i),
-                    GetEndpointBIndex(i));
-            }
+            renderContext.UploadShipElementStressedSpring(
+                shipId,
+                GetEndpointAIndex(i),
+                GetEndpointBIndex(i));
         }
     }
+
+    mIsStressedSpringSetDirty = false;
 }
 
 bool Springs::UpdateStrains(
@@ -280,6 +400,9 @@ bool Springs::UpdateStrains(
     // Flag remembering whether at least one spring broke
     bool isAtLeastOneBroken = false;
 
+    // The highest strain/strength ratio seen
+    float maxStrainRatio = 0.0f;
+
     // Visit all springs
     for (ElementIndex s : *this)
     {
@@ -289,11 +412,16 @@ bool Springs::UpdateStrains(
             && !mIsBombAttachedBuffer[s])
         {
             // Calculate strain
-            float dx = GetLength(s, points);
+            float const dx = mLengthBuffer[s];
             float const strain = fabs(mRestLengthBuffer[s] - dx) / mRestLengthBuffer[s];
 
             // Check against strength
             float const effectiveStrength = effectiveStrengthAdjustment * mStrengthBuffer[s];
+            if (strain > maxStrainRatio * effectiveStrength)
+            {
+                maxStrainRatio = strain / effectiveStrength;
+            }
+
             if (strain > effectiveStrength)
             {
                 // It's broken!
@@ -316,7 +444,7 @@ bool Springs::UpdateStrains(
                 if (strain < StrainLowWatermark * effectiveStrength)
                 {
                     // It's not stressed anymore
-                    mIsStressedBuffer[s] = false;
+                    ClearStressed(s);
                 }
             }
             else
@@ -327,27 +455,116 @@ bool Springs::UpdateStrains(
                 if (strain > StrainHighWatermark * effectiveStrength)
                 {
                     // It's stressed!
-                    mIsStressedBuffer[s] = true;
+                    SetStressed(s);
 
                     // Notify stress
-                    mGameEventHandler->OnStress(
+                    AccumulateEvent(
+                        mPendingStressEvents,
                         GetBaseStructuralMaterial(s),
-                        mParentWorld.IsUnderwater(points.GetPosition(mEndpointsBuffer[s].PointAIndex)),
-                        1);
+                        mParentWorld.IsUnderwater(points.GetPosition(mEndpointsBuffer[s].PointAIndex)));
                 }
             }
         }
     }
 
+    mMaxStrainRatio = maxStrainRatio;
+
     return isAtLeastOneBroken;
 }
 
-float Springs::CalculateStiffnessCoefficient(
+inline void Springs::SetStressed(ElementIndex springElementIndex)
+{
+    assert(!mIsStressedBuffer[springElementIndex]);
+
+    mIsStressedBuffer[springElementIndex] = true;
+
+    mStressedSpringSlotBuffer[springElementIndex] = static_cast<ElementIndex>(mStressedSprings.size());
+    mStressedSprings.push_back(springElementIndex);
+
+    mIsStressedSpringSetDirty = true;
+}
+
+inline void Springs::ClearStressed(ElementIndex springElementIndex)
+{
+    assert(mIsStressedBuffer[springElementIndex]);
+
+    mIsStressedBuffer[springElementIndex] = false;
+
+    // Move the last stressed spring into this spring's slot
+    ElementIndex const slot = mStressedSpringSlotBuffer[springElementIndex];
+    ElementIndex const lastSpringElementIndex = mStressedSprings.back();
+    mStressedSprings[slot] = lastSpringElementIndex;
+    mStressedSpringSlotBuffer[lastSpringElementIndex] = slot;
+    mStressedSprings.pop_back();
+
+    mStressedSpringSlotBuffer[springElementIndex] = NoneElementIndex;
+
+    mIsStressedSpringSetDirty = true;
+}
+
+void Springs::UpdateRenderElement(ElementIndex springElementIndex)
+{
+    bool const isRendered =
+        !mIsDeletedBuffer[springElementIndex]
+        && (IsRope(springElementIndex) || mSuperTrianglesBuffer[springElementIndex].size() < 2);
+
+    ElementIndex const slot = mRenderElementSlotBuffer[springElementIndex];
+    if (isRendered == (NoneElementIndex != slot))
+    {
+        // Nothing changed
+        return;
+    }
+
+    RenderElements & renderElements = IsRope(springElementIndex) ? mRenderRopeElements : mRenderSpringElements;
+
+    if (isRendered)
+    {
+        mRenderElementSlotBuffer[springElementIndex] = static_cast<ElementIndex>(renderElements.Springs.size());
+        renderElements.Springs.push_back(springElementIndex);
+        renderElements.Endpoints.push_back(GetEndpointAIndex(springElementIndex));
+        renderElements.Endpoints.push_back(GetEndpointBIndex(springElementIndex));
+    }
+    else
+    {
+        // Move the last spring into this spring's slot
+        ElementIndex const lastSpringElementIndex = renderElements.Springs.back();
+        renderElements.Springs[slot] = lastSpringElementIndex;
+        renderElements.Endpoints[2 * slot] = renderElements.Endpoints[renderElements.Endpoints.size() - 2];
+        renderElements.Endpoints[2 * slot + 1] = renderElements.Endpoints[renderElements.Endpoints.size() - 1];
+        mRenderElementSlotBuffer[lastSpringElementIndex] = slot;
+        renderElements.Springs.pop_back();
+        renderElements.Endpoints.resize(renderElements.Endpoints.size() - 2);
+
+        mRenderElementSlotBuffer[springElementIndex] = NoneElementIndex;
+    }
+}
+
+void Springs::AccumulateEvent(
+    std::vector<PendingEvent> & pendingEvents,
+    StructuralMaterial const & material,
+    bool isUnderwater)
+{
+    auto it = std::find_if(
+        pendingEvents.begin(),
+        pendingEvents.end(),
+        [&material, isUnderwater](PendingEvent const & pendingEvent)
+        {
+            return pendingEvent.Material == &material
+                && pendingEvent.IsUnderwater == isUnderwater;
+        });
+
+    if (it == pendingEvents.end())
+    {
+        it = pendingEvents.emplace(pendingEvents.end(), &material, isUnderwater);
+    }
+
+    ++(it->Size);
+}
+
+Springs::Coefficients Springs::CalculateMaterialCoefficients(
     ElementIndex pointAIndex,
     ElementIndex pointBIndex,
     float springStiffness,
-    float stiffnessAdjustment,
-    float numMechanicalDynamicsIterations,
     Points const & points)
 {
     //
@@ -358,41 +575,54 @@ float Springs::CalculateStiffnessCoefficient(
     // change in position equal to a fraction SpringReductionFraction * adjustment of the spring displacement,
     // in the time interval of a single mechanical dynamics simulation.
     //
-    // The adjustment is both the material-specific adjustment and the global game adjustment.
+    // The adjustment is both the material-specific adjustment and the global game adjustment; the
+    // latter - together with the 1/dt^2 - is left to the stiffness coefficient factor.
+    //
+    // The damping coefficient is similarly left with the global game adjustment and 1/dt.
     //
 
     float const massFactor =
         (points.GetAugmentedStructuralMass(pointAIndex) * points.GetAugmentedStructuralMass(pointBIndex))
         / (points.GetAugmentedStructuralMass(pointAIndex) + points.GetAugmentedStructuralMass(pointBIndex));
 
-    float const dtSquared =
-        (GameParameters::SimulationStepTimeDuration<float> / numMechanicalDynamicsIterations)
-        * (GameParameters::SimulationStepTimeDuration<float> / numMechanicalDynamicsIterations);
-
-    return GameParameters::SpringReductionFraction
+    return Coefficients(
+        GameParameters::SpringReductionFraction
         * springStiffness
-        * stiffnessAdjustment
-        * massFactor
-        / dtSquared;
+        * massFactor,
+        GameParameters::SpringDampingCoefficient
+        * massFactor);
 }
 
-float Springs::CalculateDampingCoefficient(
-    ElementIndex pointAIndex,
-    ElementIndex pointBIndex,
-    float dampingAdjustment,
-    float numMechanicalDynamicsIterations,
-    Points const & points)
+void Springs::ReportMemory(MemoryReport & report) const
 {
-    float const massFactor =
-        (points.GetAugmentedStructuralMass(pointAIndex) * points.GetAugmentedStructuralMass(pointBIndex))
-        / (points.GetAugmentedStructuralMass(pointAIndex) + points.GetAugmentedStructuralMass(pointBIndex));
-
-    float const dt = GameParameters::SimulationStepTimeDuration<float> / numMechanicalDynamicsIterations;
-
-    return GameParameters::SpringDampingCoefficient
-        * dampingAdjustment
-        * massFactor
-        / dt;
+    report.Add("IsDeleted", mIsDeletedBuffer);
+    report.Add("Endpoints", mEndpointsBuffer);
+    report.Add("FactoryEndpointOctants", mFactoryEndpointOctantsBuffer);
+    report.Add("SuperTriangles", mSuperTrianglesBuffer);
+    report.Add("FactorySuperTriangles", mFactorySuperTrianglesBuffer);
+    report.Add("Strength", mStrengthBuffer);
+    report.Add("MaterialStrength", mMaterialStrengthBuffer);
+    report.Add("Stiffness", mStiffnessBuffer);
+    report.Add("RestLength", mRestLengthBuffer);
+    report.Add("Length", mLengthBuffer);
+    report.Add("Coefficients", mCoefficientsBuffer);
+    report.Add("MaterialCoefficients", mMaterialCoefficientsBuffer);
+    report.Add("Characteristics", mCharacteristicsBuffer);
+    report.Add("BaseStructuralMaterial", mBaseStructuralMaterialBuffer);
+    report.Add("WaterPermeability", mWaterPermeabilityBuffer);
+    report.Add("IsStressed", mIsStressedBuffer);
+    report.Add("StressedSpringSlot", mStressedSpringSlotBuffer);
+    report.Add("IsBombAttached", mIsBombAttachedBuffer);
+    report.Add("RenderElementSlot", mRenderElementSlotBuffer);
+    report.Add("ParallelForceBatchSprings", mParallelForceBatchSprings);
+    report.Add("ParallelForceBatchStarts", mParallelForceBatchStarts);
+    report.Add("StressedSprings", mStressedSprings);
+    report.Add("RenderSpringElements", mRenderSpringElements.Springs);
+    report.Add("RenderSpringElementEndpoints", mRenderSpringElements.Endpoints);
+    report.Add("RenderRopeElements", mRenderRopeElements.Springs);
+    report.Add("RenderRopeElementEndpoints", mRenderRopeElements.Endpoints);
+    report.Add("PendingBreakEvents", mPendingBreakEvents);
+    report.Add("PendingStressEvents", mPendingStressEvents);
 }
 
 }
\ No newline at end of file
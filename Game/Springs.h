@@ -11,14 +11,15 @@
 #include "RenderContext.h"
 
 #include <GameCore/Buffer.h>
-#include <GameCore/BufferAllocator.h>
 #include <GameCore/ElementContainer.h>
 #include <GameCore/EnumFlags.h>
 #include <GameCore/FixedSizeVector.h>
+#include <GameCore/MemoryReport.h>
 
 #include <cassert>
 #include <functional>
 #include <limits>
+#include <vector>
 
 namespace Physics
 {
@@ -43,15 +44,6 @@ public:
         Rope = 2     // Ropes are drawn differently
     };
 
-    using DestroyHandler = std::function<void(
-        ElementIndex,
-        bool /*destroyTriangles*/,
-        GameParameters const &)>;
-
-    using RestoreHandler = std::function<void(
-        ElementIndex,
-        GameParameters const &)>;
-
 private:
 
     /*
@@ -134,13 +126,18 @@ public:
         , mMaterialStrengthBuffer(mBufferElementCount, mElementCount, 0.0f)
         , mStiffnessBuffer(mBufferElementCount, mElementCount, 0.0f)
         , mRestLengthBuffer(mBufferElementCount, mElementCount, 1.0f)
+        , mLengthBuffer(mBufferElementCount, mElementCount, 1.0f)
         , mCoefficientsBuffer(mBufferElementCount, mElementCount, Coefficients(0.0f, 0.0f))
+        , mMaterialCoefficientsBuffer(mBufferElementCount, mElementCount, Coefficients(0.0f, 0.0f))
         , mCharacteristicsBuffer(mBufferElementCount, mElementCount, Characteristics::None)
         , mBaseStructuralMaterialBuffer(mBufferElementCount, mElementCount, nullptr)
         // Water
         , mWaterPermeabilityBuffer(mBufferElementCount, mElementCount, 0.0f)
         // Stress
         , mIsStressedBuffer(mBufferElementCount, mElementCount, false)
+        , mStressedSpringSlotBuffer(mBufferElementCount, mElementCount, NoneElementIndex)
+        // Render
+        , mRenderElementSlotBuffer(mBufferElementCount, mElementCount, NoneElementIndex)
         // Bombs
         , mIsBombAttachedBuffer(mBufferElementCount, mElementCount, false)
         //////////////////////////////////
@@ -148,52 +145,55 @@ public:
         //////////////////////////////////
         , mParentWorld(parentWorld)
         , mGameEventHandler(std::move(gameEventHandler))
-        , mDestroyHandler()
-        , mRestoreHandler()
+        , mShipHandler(nullptr)
         , mCurrentNumMechanicalDynamicsIterations(gameParameters.NumMechanicalDynamicsIterations<float>())
         , mCurrentSpringStiffnessAdjustment(gameParameters.SpringStiffnessAdjustment)
         , mCurrentSpringDampingAdjustment(gameParameters.SpringDampingAdjustment)
-        , mFloatBufferAllocator(mBufferElementCount)
-        , mVec2fBufferAllocator(mBufferElementCount)
-    {
+        , mStiffnessCoefficientFactor(0.0f)
+        , mDampingCoefficientFactor(0.0f)
+        , mParallelForceBatchSprings()
+        , mParallelForceBatchStarts()
+        , mAreParallelForceBatchesDirty(true)
+        , mMaxStrainRatio(0.0f)
+        , mStressedSprings()
+        , mIsStressedSpringSetDirty(true)
+        , mRenderSpringElements()
+        , mRenderRopeElements()
+        , mPendingBreakEvents()
+        , mPendingStressEvents()
+    {
+        UpdateCoefficientFactors();
     }
 
     Springs(Springs && other) = default;
 
     /*
-     * Sets a (single) handler that is invoked whenever a spring is destroyed.
-     *
-     * The handler is invoked right before the spring is marked as deleted. However,
-     * other elements connected to the soon-to-be-deleted spring might already have been
-     * deleted.
-     *
-     * The handler is not re-entrant: destroying other springs from it is not supported
-     * and leads to undefined behavior.
-     *
-     * Setting more than one handler is not supported and leads to undefined behavior.
+     * Adds the buffers of the springs to the report.
      */
-    void RegisterDestroyHandler(DestroyHandler destroyHandler)
-    {
-        assert(!mDestroyHandler);
-        mDestroyHandler = std::move(destroyHandler);
-    }
+    void ReportMemory(MemoryReport & report) const;
 
     /*
-     * Sets a (single) handler that is invoked whenever a spring is restored.
+     * Sets the (single) ship whose handlers are invoked whenever a spring is destroyed
+     * or restored; the handlers are invoked directly, rather than through type-erased
+     * callbacks, as they sit on the hot paths of cuts and explosions.
      *
-     * The handler is invoked right after the spring is unmarked as deleted. However,
-     * other elements connected to the soon-to-be-deleted spring might not yet have been
+     * The destroy handler is invoked right before the spring is marked as deleted. However,
+     * other elements connected to the soon-to-be-deleted spring might already have been
+     * deleted.
+     *
+     * The restore handler is invoked right after the spring is unmarked as deleted. However,
+     * other elements connected to the soon-to-be-restored spring might not yet have been
      * restored.
      *
-     * The handler is not re-entrant: restoring other springs from it is not supported
-     * and leads to undefined behavior.
+     * The handlers are not re-entrant: destroying or restoring other springs from them is
+     * not supported and leads to undefined behavior.
      *
-     * Setting more than one handler is not supported and leads to undefined behavior.
+     * Setting more than one ship is not supported and leads to undefined behavior.
      */
-    void RegisterRestoreHandler(RestoreHandler restoreHandler)
+    void RegisterShipHandler(Ship * shipHandler)
     {
-        assert(!mRestoreHandler);
-        mRestoreHandler = std::move(restoreHandler);
+        assert(nullptr == mShipHandler);
+        mShipHandler = shipHandler;
     }
 
     void Add(
@@ -216,9 +216,16 @@ public:
         GameParameters const & gameParameters,
         Points const & points);
 
-    void UpdateGameParameters(
-        GameParameters const & gameParameters,
-        Points const & points);
+    /*
+     * Fires the break and stress events accumulated since the last flush, one
+     * per material and underwater-ness, summing up the springs of each.
+     *
+     * Expected to be invoked once per simulation step, after all the springs
+     * that might break have had a chance to.
+     */
+    void FlushEvents();
+
+    void UpdateGameParameters(GameParameters const & gameParameters);
 
     void OnEndpointMassUpdated(
         ElementIndex springElementIndex,
@@ -226,26 +233,12 @@ public:
     {
         assert(springElementIndex < mElementCount);
 
-        mCoefficientsBuffer[springElementIndex].StiffnessCoefficient =
-            CalculateStiffnessCoefficient(
-                mEndpointsBuffer[springElementIndex].PointAIndex,
-                mEndpointsBuffer[springElementIndex].PointBIndex,
-                mStiffnessBuffer[springElementIndex],
-                mCurrentSpringStiffnessAdjustment,
-                mCurrentNumMechanicalDynamicsIterations,
-                points);
-
-        mCoefficientsBuffer[springElementIndex].DampingCoefficient =
-            CalculateDampingCoefficient(
-                mEndpointsBuffer[springElementIndex].PointAIndex,
-                mEndpointsBuffer[springElementIndex].PointBIndex,
-                mCurrentSpringDampingAdjustment,
-                mCurrentNumMechanicalDynamicsIterations,
-                points);
+        UpdateCoefficients(springElementIndex, points);
     }
 
     /*
-     * Calculates the current strain - due to tension or compression - and acts depending on it.
+     * Calculates the current strain - due to tension or compression - and acts depending on it;
+     * the strain comes from the lengths that the last spring forces calculation stored.
      *
      * Returns true if the spring got broken.
      */
@@ -253,6 +246,15 @@ public:
         GameParameters const & gameParameters,
         Points & points);
 
+    /*
+     * Returns the highest ratio between strain and effective strength seen among
+     * all the springs at the last UpdateStrains(); 1.0 and above means breaking.
+     */
+    float GetMaxStrainRatio() const
+    {
+        return mMaxStrainRatio;
+    }
+
     //
     // Render
     //
@@ -261,9 +263,18 @@ public:
         ShipId shipId,
         Render::RenderContext & renderContext) const;
 
+    /*
+     * Tells whether the stressed springs to render have changed since the last
+     * UploadStressedSpringElements().
+     */
+    bool IsStressedSpringSetDirty() const
+    {
+        return mIsStressedSpringSetDirty;
+    }
+
     void UploadStressedSpringElements(
         ShipId shipId,
-        Render::RenderContext & renderContext) const;
+        Render::RenderContext & renderContext);
 
 public:
 
@@ -290,6 +301,12 @@ public:
         return mEndpointsBuffer[springElementIndex].PointBIndex;
     }
 
+    // Endpoint A and endpoint B indices, interleaved
+    ElementIndex const * restrict GetEndpointsBufferAsElementIndex() const
+    {
+        return reinterpret_cast<ElementIndex const *>(mEndpointsBuffer.data());
+    }
+
     ElementIndex GetOtherEndpointIndex(
         ElementIndex springElementIndex,
         ElementIndex pointElementIndex) const
@@ -407,6 +424,8 @@ public:
             }));
 
         mSuperTrianglesBuffer[springElementIndex].push_back(superTriangleElementIndex);
+
+        UpdateRenderElement(springElementIndex);
     }
 
     inline void RemoveSuperTriangle(
@@ -417,11 +436,15 @@ public:
 
         assert(found);
         (void)found;
+
+        UpdateRenderElement(springElementIndex);
     }
 
     inline void ClearSuperTriangles(ElementIndex springElementIndex)
     {
         mSuperTrianglesBuffer[springElementIndex].clear();
+
+        UpdateRenderElement(springElementIndex);
     }
 
     auto const & GetFactorySuperTriangles(ElementIndex springElementIndex) const
@@ -437,6 +460,8 @@ public:
             mFactorySuperTrianglesBuffer[springElementIndex].begin(),
             mFactorySuperTrianglesBuffer[springElementIndex].end(),
             mSuperTrianglesBuffer[springElementIndex].begin());
+
+        UpdateRenderElement(springElementIndex);
     }
 
     //
@@ -489,6 +514,23 @@ public:
         return mCoefficientsBuffer[springElementIndex].DampingCoefficient;
     }
 
+    float const * restrict GetRestLengthBuffer() const
+    {
+        return mRestLengthBuffer.data();
+    }
+
+    // Written by the spring forces calculation of the last mechanical iteration
+    float * restrict GetLengthBuffer()
+    {
+        return mLengthBuffer.data();
+    }
+
+    // Stiffness and damping coefficients, interleaved
+    float const * restrict GetCoefficientsBufferAsFloat() const
+    {
+        return reinterpret_cast<float const *>(mCoefficientsBuffer.data());
+    }
+
     StructuralMaterial const & GetBaseStructuralMaterial(ElementIndex springElementIndex) const
     {
         // If this method is invoked, this is not a placeholder
@@ -562,35 +604,72 @@ public:
     }
 
     //
-    // Temporary buffer
+    // Parallel force batches
+    //
+    // Non-deleted springs are partitioned into batches such that no two springs in the
+    // same batch share an endpoint; the springs of a batch may then be visited concurrently,
+    // as there are no conflicting updates to their endpoints.
     //
+    // The batches are invalidated whenever springs are destroyed or restored.
+    //
+
+    bool AreParallelForceBatchesDirty() const
+    {
+        return mAreParallelForceBatchesDirty;
+    }
+
+    void UpdateParallelForceBatches(Points const & points);
+
+    size_t GetParallelForceBatchCount() const
+    {
+        assert(!mAreParallelForceBatchesDirty);
+        assert(!mParallelForceBatchStarts.empty());
+
+        return mParallelForceBatchStarts.size() - 1;
+    }
 
-    std::shared_ptr<Buffer<float>> AllocateWorkBufferFloat()
+    ElementIndex const * GetParallelForceBatchBegin(size_t batchIndex) const
     {
-        return mFloatBufferAllocator.Allocate();
+        assert(batchIndex + 1 < mParallelForceBatchStarts.size());
+        return mParallelForceBatchSprings.data() + mParallelForceBatchStarts[batchIndex];
     }
 
-    std::shared_ptr<Buffer<vec2f>> AllocateWorkBufferVec2f()
+    ElementIndex const * GetParallelForceBatchEnd(size_t batchIndex) const
     {
-        return mVec2fBufferAllocator.Allocate();
+        assert(batchIndex + 1 < mParallelForceBatchStarts.size());
+        return mParallelForceBatchSprings.data() + mParallelForceBatchStarts[batchIndex + 1];
     }
 
 private:
 
-    static float CalculateStiffnessCoefficient(
+    /*
+     * Calculates the terms of the coefficients that only depend on the spring and on its
+     * endpoints; the coefficients are these terms scaled by the factors that depend on the
+     * game parameters only.
+     */
+    static Coefficients CalculateMaterialCoefficients(
         ElementIndex pointAIndex,
         ElementIndex pointBIndex,
         float springStiffness,
-        float stiffnessAdjustment,
-        float numMechanicalDynamicsIterations,
         Points const & points);
 
-    static float CalculateDampingCoefficient(
-        ElementIndex pointAIndex,
-        ElementIndex pointBIndex,
-        float dampingAdjustment,
-        float numMechanicalDynamicsIterations,
-        Points const & points);
+    // Re-calculates the factors from the game parameter values that we are current with
+    void UpdateCoefficientFactors();
+
+    inline void UpdateCoefficients(
+        ElementIndex springElementIndex,
+        Points const & points)
+    {
+        mMaterialCoefficientsBuffer[springElementIndex] = CalculateMaterialCoefficients(
+            mEndpointsBuffer[springElementIndex].PointAIndex,
+            mEndpointsBuffer[springElementIndex].PointBIndex,
+            mStiffnessBuffer[springElementIndex],
+            points);
+
+        mCoefficientsBuffer[springElementIndex] = Coefficients(
+            mMaterialCoefficientsBuffer[springElementIndex].StiffnessCoefficient * mStiffnessCoefficientFactor,
+            mMaterialCoefficientsBuffer[springElementIndex].DampingCoefficient * mDampingCoefficientFactor);
+    }
 
 private:
 
@@ -623,7 +702,9 @@ private:
     Buffer<float> mMaterialStrengthBuffer; // Original strength
     Buffer<float> mStiffnessBuffer;
     Buffer<float> mRestLengthBuffer;
+    Buffer<float> mLengthBuffer; // As of the last spring forces calculation
     Buffer<Coefficients> mCoefficientsBuffer;
+    Buffer<Coefficients> mMaterialCoefficientsBuffer; // Zero for deleted springs
     Buffer<Characteristics> mCharacteristicsBuffer;
     Buffer<StructuralMaterial const *> mBaseStructuralMaterialBuffer;
 
@@ -642,6 +723,17 @@ private:
     // State variable that tracks when we enter and exit the stressed state
     Buffer<bool> mIsStressedBuffer;
 
+    // The position of each stressed spring in mStressedSprings
+    Buffer<ElementIndex> mStressedSpringSlotBuffer;
+
+    //
+    // Render
+    //
+
+    // The position of each spring in the render elements of its kind, if
+    // it's rendered in the default render mode
+    Buffer<ElementIndex> mRenderElementSlotBuffer;
+
     //
     // Bombs
     //
@@ -655,11 +747,8 @@ private:
     World & mParentWorld;
     std::shared_ptr<IGameEventHandler> const mGameEventHandler;
 
-    // The handler registered for spring deletions
-    DestroyHandler mDestroyHandler;
-
-    // The handler registered for spring restores
-    RestoreHandler mRestoreHandler;
+    // The ship registered for spring deletions and restores
+    Ship * mShipHandler;
 
     // The game parameter values that we are current with; changes
     // in the values of these parameters will trigger a re-calculation
@@ -668,9 +757,70 @@ private:
     float mCurrentSpringStiffnessAdjustment;
     float mCurrentSpringDampingAdjustment;
 
-    // Allocators for work buffers
-    BufferAllocator<float> mFloatBufferAllocator;
-    BufferAllocator<vec2f> mVec2fBufferAllocator;
+    // The factors of the coefficients that depend on the game parameters
+    float mStiffnessCoefficientFactor;
+    float mDampingCoefficientFactor;
+
+    // The parallel force batches: the indices of the springs of all batches,
+    // one batch after the other, and the starting offset of each batch in
+    // there; the last extra element contains the total number of springs
+    std::vector<ElementIndex> mParallelForceBatchSprings;
+    std::vector<size_t> mParallelForceBatchStarts;
+    bool mAreParallelForceBatchesDirty;
+
+    // The highest strain/strength ratio of the last strain update
+    float mMaxStrainRatio;
+
+    // The stressed springs, in no particular order - deleted ones included, as they
+    // are still stressed once restored; the set is dirty when the springs to render
+    // have changed since the last upload
+    std::vector<ElementIndex> mStressedSprings;
+    bool mIsStressedSpringSetDirty;
+
+    // The springs rendered in the default render mode - the non-deleted ones that are
+    // ropes or not covered by two super-triangles - in no particular order, together
+    // with their endpoints ready to be uploaded as they are, two per spring; kept
+    // up-to-date as springs are destroyed and restored, and as super-triangles change
+    struct RenderElements
+    {
+        std::vector<ElementIndex> Springs;
+        std::vector<ElementIndex> Endpoints;
+    };
+
+    RenderElements mRenderSpringElements;
+    RenderElements mRenderRopeElements;
+
+    // The events accumulated since the last flush; there are only a handful
+    // of distinct materials breaking at any given step, hence a linear search
+    // is cheaper than a map
+    struct PendingEvent
+    {
+        StructuralMaterial const * Material;
+        bool IsUnderwater;
+        unsigned int Size;
+
+        PendingEvent(
+            StructuralMaterial const * material,
+            bool isUnderwater)
+            : Material(material)
+            , IsUnderwater(isUnderwater)
+            , Size(0)
+        {}
+    };
+
+    inline void SetStressed(ElementIndex springElementIndex);
+
+    inline void ClearStressed(ElementIndex springElementIndex);
+
+    void UpdateRenderElement(ElementIndex springElementIndex);
+
+    static void AccumulateEvent(
+        std::vector<PendingEvent> & pendingEvents,
+        StructuralMaterial const & material,
+        bool isUnderwater);
+
+    std::vector<PendingEvent> mPendingBreakEvents;
+    std::vector<PendingEvent> mPendingStressEvents;
 };
 
 }
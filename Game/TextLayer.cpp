@@ -39,7 +39,9 @@ void TextLayer::SetStatusText(
     vec2f const & camera,
     float totalUpdateToRenderDurationRatio,
     float lastUpdateToRenderDurationRatio,
-    Render::RenderStatistics const & renderStatistics)
+    Render::RenderStatistics const & renderStatistics,
+    Physics::ShipStatistics const & shipStatistics,
+    Physics::ShipPerfStats const & lastShipPerfStats)
 {
     int elapsedSecondsGameInt = static_cast<int>(roundf(elapsedGameSeconds.count()));
     int minutesGame = elapsedSecondsGameInt / 60;
@@ -91,6 +93,48 @@ void TextLayer::SetStatusText(
             << " GENTEX:" << renderStatistics.LastRenderedShipGenericTextures;
 
         mStatusTextLines.emplace_back(ss.str());
+
+        ss.str("");
+
+        ss
+            << "WATER:" << shipStatistics.TotalWater
+            << " WET:" << shipStatistics.WetPointCount
+            << " LEAK:" << shipStatistics.LeakingPointCount
+            << " SUBM:" << (100.0f * shipStatistics.GetSubmergedLeakingPointFraction()) << "%";
+
+        mStatusTextLines.emplace_back(ss.str());
+
+#ifdef ENABLE_PERF_STATS
+        // Milliseconds per ship update, since the last publish
+        using Phase = Physics::ShipPerfStats::Phase;
+
+        ss.str("");
+
+        ss
+            << "MECH:" << lastShipPerfStats.GetAverageMillis(Phase::MechanicalDynamics)
+            << " (PF:" << lastShipPerfStats.GetAverageMillis(Phase::PointForces)
+            << " SF:" << lastShipPerfStats.GetAverageMillis(Phase::SpringForces)
+            << " INT:" << lastShipPerfStats.GetAverageMillis(Phase::Integration)
+            << " FLR:" << lastShipPerfStats.GetAverageMillis(Phase::SeaFloorCollisions) << ")"
+            << " STR:" << lastShipPerfStats.GetAverageMillis(Phase::Strains)
+            << " WIN:" << lastShipPerfStats.GetAverageMillis(Phase::WaterInflow)
+            << " WVEL:" << lastShipPerfStats.GetAverageMillis(Phase::WaterVelocities);
+
+        mStatusTextLines.emplace_back(ss.str());
+
+        ss.str("");
+
+        ss
+            << "ELEC:" << lastShipPerfStats.GetAverageMillis(Phase::Electrical)
+            << " (LGT:" << lastShipPerfStats.GetAverageMillis(Phase::Light) << ")"
+            << " CONN:" << lastShipPerfStats.GetAverageMillis(Phase::ConnectivityVisit)
+            << " EPH:" << lastShipPerfStats.GetAverageMillis(Phase::EphemeralParticles)
+            << " UPL:" << lastShipPerfStats.GetAverageMillis(Phase::Uploads);
+
+        mStatusTextLines.emplace_back(ss.str());
+#else
+        (void)lastShipPerfStats;
+#endif
     }
 
     mIsStatusTextDirty = true;
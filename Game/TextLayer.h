@@ -6,6 +6,8 @@
 #pragma once
 
 #include "RenderContext.h"
+#include "ShipPerfStats.h"
+#include "ShipStatistics.h"
 
 #include <GameCore/GameTypes.h>
 
@@ -34,12 +36,25 @@ public:
         vec2f const & camera,
         float totalUpdateToRenderDurationRatio,
         float lastUpdateToRenderDurationRatio,
-        Render::RenderStatistics const & renderStatistics);
+        Render::RenderStatistics const & renderStatistics,
+        Physics::ShipStatistics const & shipStatistics,
+        Physics::ShipPerfStats const & lastShipPerfStats);
 
     void Update();
 
     void Render(Render::RenderContext & renderContext);
 
+    /*
+     * Whether the next Render() would change the text being rendered.
+     */
+    bool IsDirty() const
+    {
+        if (mIsStatusTextEnabled || mIsExtendedStatusTextEnabled)
+            return mIsStatusTextDirty || NoneRenderedTextHandle == mStatusTextHandle;
+        else
+            return NoneRenderedTextHandle != mStatusTextHandle;
+    }
+
 private:
 
     //
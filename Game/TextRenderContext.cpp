@@ -5,6 +5,10 @@
 ***************************************************************************************/
 #include "TextRenderContext.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
 namespace Render {
 
 TextRenderContext::TextRenderContext(
@@ -134,6 +138,121 @@ void TextRenderContext::UpdateAmbientLightIntensity(float ambientLightIntensity)
         ambientLightIntensity);
 }
 
+void TextRenderContext::UpdateRenderedLines(
+    TextSlot & textSlot,
+    FontMetadata const & fontMetadata)
+{
+    //
+    // Calculate cursor position
+    //
+
+    float constexpr MarginScreen = 10.0f;
+    float constexpr MarginTopScreen = MarginScreen + 25.0f; // Consider menu bar
+    int constexpr MarginLine = 0; // Pixels
+
+    ImageSize textExtent = ImageSize::Zero();
+    int lineHeightIncrement = 0;
+    for (auto const & line : textSlot.TextLines)
+    {
+        auto const lineExtent = fontMetadata.CalculateTextExtent(
+            line.c_str(),
+            line.length());
+
+        textExtent = ImageSize(
+            std::max(textExtent.Width, lineExtent.Width),
+            (textExtent.Height != 0 ? MarginLine : 0)
+            + textExtent.Height + lineExtent.Height);
+
+        lineHeightIncrement = std::max(lineHeightIncrement, lineExtent.Height + MarginLine);
+    }
+
+    float const lineHeightIncrementNdc = lineHeightIncrement * mScreenToNdcY;
+
+    vec2f cursorPositionNdc; // Top-left
+    switch (textSlot.Position)
+    {
+        case TextPositionType::BottomLeft:
+        {
+            cursorPositionNdc = vec2f(
+                -1.f + MarginScreen * mScreenToNdcX,
+                -1.f + (MarginScreen + static_cast<float>(textExtent.Height)) * mScreenToNdcY);
+
+            break;
+        }
+
+        case TextPositionType::BottomRight:
+        {
+            cursorPositionNdc = vec2f(
+                1.f - (MarginScreen + static_cast<float>(textExtent.Width)) * mScreenToNdcX,
+                -1.f + (MarginScreen + static_cast<float>(textExtent.Height)) * mScreenToNdcY);
+
+            break;
+        }
+
+        case TextPositionType::TopLeft:
+        {
+            cursorPositionNdc = vec2f(
+                -1.f + MarginScreen * mScreenToNdcX,
+                1.f - MarginTopScreen * mScreenToNdcY);
+
+            break;
+        }
+
+        case TextPositionType::TopRight:
+        {
+            cursorPositionNdc = vec2f(
+                1.f - (MarginScreen + static_cast<float>(textExtent.Width)) * mScreenToNdcX,
+                1.f - MarginTopScreen * mScreenToNdcY);
+
+            break;
+        }
+    }
+
+    //
+    // Re-tessellate the lines whose text, position, or alpha has changed
+    //
+
+    textSlot.RenderedLines.resize(textSlot.TextLines.size());
+
+    float lineOffsetNdc = 0.0f;
+    for (size_t l = 0; l < textSlot.TextLines.size(); ++l)
+    {
+        std::string const & line = textSlot.TextLines[l];
+        RenderedTextLine & renderedLine = textSlot.RenderedLines[l];
+
+        vec2f const lineCursorPositionNdc(
+            cursorPositionNdc.x,
+            cursorPositionNdc.y - lineOffsetNdc);
+
+        if (!renderedLine.IsTessellated
+            || renderedLine.Text != line
+            || renderedLine.CursorPositionNdc != lineCursorPositionNdc
+            || renderedLine.Alpha != textSlot.Alpha)
+        {
+            renderedLine.Text = line;
+            renderedLine.CursorPositionNdc = lineCursorPositionNdc;
+            renderedLine.Alpha = textSlot.Alpha;
+
+            renderedLine.Vertices.clear();
+            fontMetadata.EmitQuadVertices(
+                line.c_str(),
+                line.size(),
+                lineCursorPositionNdc,
+                textSlot.Alpha,
+                mScreenToNdcX,
+                mScreenToNdcY,
+                renderedLine.Vertices);
+
+            renderedLine.IsTessellated = true;
+
+            // Force this line to be re-uploaded
+            renderedLine.VertexBufferOffset = std::numeric_limits<size_t>::max();
+        }
+
+        lineOffsetNdc += lineHeightIncrementNdc;
+    }
+}
+
 void TextRenderContext::RenderStart()
 {
 }
@@ -143,127 +262,113 @@ void TextRenderContext::RenderEnd()
     if (mAreTextSlotsDirty)
     {
         //
-        // Rebuild all vertices
+        // Re-tessellate the lines that have changed
         //
 
-        // Cleanup
-        for (auto & textRenderInfo : mFontRenderInfos)
-        {
-            textRenderInfo.GetVertexBuffer().clear();
-        }
-
-        // Process all slots
-        for (size_t slot = 0; slot < mTextSlots.size(); ++slot)
+        for (auto & textSlot : mTextSlots)
         {
-            if (mTextSlots[slot].Generation > 0)
+            if (textSlot.Generation > 0)
             {
-                //
-                // Create vertices for this text
-                //
+                FontMetadata const & fontMetadata = mFontRenderInfos[static_cast<size_t>(textSlot.Font)].GetFontMetadata();
 
-                FontRenderInfo & fontRenderInfo = mFontRenderInfos[static_cast<size_t>(mTextSlots[slot].Font)];
-                FontMetadata const & fontMetadata = fontRenderInfo.GetFontMetadata();
+                UpdateRenderedLines(textSlot, fontMetadata);
+            }
+        }
 
-                //
-                // Calculate cursor position
-                //
+        //
+        // Rebuild and re-upload the vertex buffer of each font, from the
+        // first vertex that has changed or moved onwards
+        //
 
-                float constexpr MarginScreen = 10.0f;
-                float constexpr MarginTopScreen = MarginScreen + 25.0f; // Consider menu bar
-                int constexpr MarginLine = 0; // Pixels
+        for (size_t f = 0; f < mFontRenderInfos.size(); ++f)
+        {
+            auto & fontRenderInfo = mFontRenderInfos[f];
+            auto & vertexBuffer = fontRenderInfo.GetVertexBuffer();
 
-                ImageSize textExtent = ImageSize::Zero();
-                int lineHeightIncrement = 0;
-                for (auto const & line : mTextSlots[slot].TextLines)
+            // Find first dirty vertex
+            size_t firstDirtyVertex = std::numeric_limits<size_t>::max();
+            size_t vertexCount = 0;
+            for (auto & textSlot : mTextSlots)
+            {
+                if (textSlot.Generation > 0 && static_cast<size_t>(textSlot.Font) == f)
                 {
-                    auto const lineExtent = fontMetadata.CalculateTextExtent(
-                        line.c_str(),
-                        line.length());
-
-                    textExtent = ImageSize(
-                        std::max(textExtent.Width, lineExtent.Width),
-                        (textExtent.Height != 0 ? MarginLine : 0)
-                        + textExtent.Height + lineExtent.Height);
+                    for (auto & renderedLine : textSlot.RenderedLines)
+                    {
+                        if (renderedLine.VertexBufferOffset != vertexCount)
+                        {
+                            firstDirtyVertex = std::min(firstDirtyVertex, vertexCount);
+                            renderedLine.VertexBufferOffset = vertexCount;
+                        }
 
-                    lineHeightIncrement = std::max(lineHeightIncrement, lineExtent.Height + MarginLine);
+                        vertexCount += renderedLine.Vertices.size();
+                    }
                 }
+            }
+
+            if (firstDirtyVertex == std::numeric_limits<size_t>::max())
+            {
+                // Nothing has moved, at most there are fewer lines now
+                assert(vertexCount <= vertexBuffer.size());
+                vertexBuffer.erase(vertexBuffer.begin() + vertexCount, vertexBuffer.end());
+                continue;
+            }
 
-                float const lineHeightIncrementNdc = lineHeightIncrement * mScreenToNdcY;
+            // Rebuild the tail
+            vertexBuffer.erase(
+                vertexBuffer.begin() + std::min(firstDirtyVertex, vertexBuffer.size()),
+                vertexBuffer.end());
 
-                vec2f cursorPositionNdc; // Top-left
-                switch (mTextSlots[slot].Position)
+            for (auto const & textSlot : mTextSlots)
+            {
+                if (textSlot.Generation > 0 && static_cast<size_t>(textSlot.Font) == f)
                 {
-                    case TextPositionType::BottomLeft:
+                    for (auto const & renderedLine : textSlot.RenderedLines)
                     {
-                        cursorPositionNdc = vec2f(
-                            -1.f + MarginScreen * mScreenToNdcX,
-                            -1.f + (MarginScreen + static_cast<float>(textExtent.Height)) * mScreenToNdcY);
-
-                        break;
+                        if (renderedLine.VertexBufferOffset >= firstDirtyVertex)
+                        {
+                            vertexBuffer.insert(
+                                vertexBuffer.end(),
+                                renderedLine.Vertices.cbegin(),
+                                renderedLine.Vertices.cend());
+                        }
                     }
+                }
+            }
 
-                    case TextPositionType::BottomRight:
-                    {
-                        cursorPositionNdc = vec2f(
-                            1.f - (MarginScreen + static_cast<float>(textExtent.Width)) * mScreenToNdcX,
-                            -1.f + (MarginScreen + static_cast<float>(textExtent.Height)) * mScreenToNdcY);
+            assert(vertexBuffer.size() == vertexCount);
 
-                        break;
-                    }
+            // Upload the tail
+            if (!vertexBuffer.empty())
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, fontRenderInfo.GetVerticesVBOHandle());
 
-                    case TextPositionType::TopLeft:
-                    {
-                        cursorPositionNdc = vec2f(
-                            -1.f + MarginScreen * mScreenToNdcX,
-                            1.f - MarginTopScreen * mScreenToNdcY);
+                if (vertexBuffer.size() > fontRenderInfo.GetVBOAllocatedVertexCount())
+                {
+                    // Grow, and re-upload everything
+                    size_t const newAllocatedVertexCount = std::max(
+                        vertexBuffer.size(),
+                        fontRenderInfo.GetVBOAllocatedVertexCount() * 2);
 
-                        break;
-                    }
+                    glBufferData(
+                        GL_ARRAY_BUFFER,
+                        newAllocatedVertexCount * sizeof(TextQuadVertex),
+                        nullptr,
+                        GL_DYNAMIC_DRAW);
 
-                    case TextPositionType::TopRight:
-                    {
-                        cursorPositionNdc = vec2f(
-                            1.f - (MarginScreen + static_cast<float>(textExtent.Width)) * mScreenToNdcX,
-                            1.f - MarginTopScreen * mScreenToNdcY);
+                    fontRenderInfo.SetVBOAllocatedVertexCount(newAllocatedVertexCount);
 
-                        break;
-                    }
+                    firstDirtyVertex = 0;
                 }
 
-                float lineOffsetNdc = 0.0f;
-                for (std::string const & line : mTextSlots[slot].TextLines)
+                if (firstDirtyVertex < vertexBuffer.size())
                 {
-                    fontMetadata.EmitQuadVertices(
-                        line.c_str(),
-                        line.size(),
-                        vec2f(
-                            cursorPositionNdc.x,
-                            cursorPositionNdc.y - lineOffsetNdc),
-                        mTextSlots[slot].Alpha,
-                        mScreenToNdcX,
-                        mScreenToNdcY,
-                        fontRenderInfo.GetVertexBuffer());
-
-                    lineOffsetNdc += lineHeightIncrementNdc;
+                    glBufferSubData(
+                        GL_ARRAY_BUFFER,
+                        firstDirtyVertex * sizeof(TextQuadVertex),
+                        (vertexBuffer.size() - firstDirtyVertex) * sizeof(TextQuadVertex),
+                        vertexBuffer.data() + firstDirtyVertex);
                 }
-            }
-        }
-
-        //
-        // Re-upload all vertices
-        //
 
-        for (auto const & fontRenderInfo : mFontRenderInfos)
-        {
-            auto const & vertexBuffer = fontRenderInfo.GetVertexBuffer();
-            if (!vertexBuffer.empty())
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, fontRenderInfo.GetVerticesVBOHandle());
-                glBufferData(
-                    GL_ARRAY_BUFFER,
-                    vertexBuffer.size() * sizeof(TextQuadVertex),
-                    vertexBuffer.data(),
-                    GL_DYNAMIC_DRAW);
                 glBindBuffer(GL_ARRAY_BUFFER, 0);
                 CheckOpenGLError();
             }
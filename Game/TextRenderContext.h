@@ -15,6 +15,7 @@
 #include <GameCore/ProgressCallback.h>
 
 #include <array>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,12 @@ public:
         mScreenToNdcX = 2.0f / static_cast<float>(width);
         mScreenToNdcY = 2.0f / static_cast<float>(height);
 
+        // All cached lines are now in the wrong place
+        for (auto & textSlot : mTextSlots)
+        {
+            textSlot.RenderedLines.clear();
+        }
+
         // Re-render text next time
         mAreTextSlotsDirty = true;
     }
@@ -70,6 +77,7 @@ public:
         mTextSlots[oldestSlotIndex].Alpha = alpha;
         mTextSlots[oldestSlotIndex].Font = font;
         mTextSlots[oldestSlotIndex].Generation = ++mCurrentTextSlotGeneration;
+        mTextSlots[oldestSlotIndex].RenderedLines.clear();
 
         // Remember we're dirty now
         mAreTextSlotsDirty = true;
@@ -84,6 +92,13 @@ public:
     {
         assert(textHandle < mTextSlots.size());
 
+        // Nothing to do if nothing has changed
+        if (mTextSlots[textHandle].TextLines == textLines
+            && mTextSlots[textHandle].Alpha == alpha)
+        {
+            return;
+        }
+
         mTextSlots[textHandle].TextLines = textLines;
         mTextSlots[textHandle].Alpha = alpha;
 
@@ -96,6 +111,7 @@ public:
         assert(textHandle < mTextSlots.size());
 
         mTextSlots[textHandle].Generation = 0;
+        mTextSlots[textHandle].RenderedLines.clear();
 
         // Remember we're dirty now
         mAreTextSlotsDirty = true;
@@ -117,6 +133,21 @@ private:
     // Text state slots
     //
 
+    // The vertices of a single line of text, cached until the line
+    // changes or moves
+    struct RenderedTextLine
+    {
+        std::string Text;
+        vec2f CursorPositionNdc;
+        float Alpha;
+
+        std::vector<TextQuadVertex> Vertices;
+        bool IsTessellated{ false };
+
+        // Where the vertices of this line were last stored in its font's vertex buffer
+        size_t VertexBufferOffset{ std::numeric_limits<size_t>::max() };
+    };
+
     struct TextSlot
     {
         uint64_t Generation;
@@ -125,8 +156,14 @@ private:
         TextPositionType Position;
         float Alpha;
         FontType Font;
+
+        std::vector<RenderedTextLine> RenderedLines;
     };
 
+    void UpdateRenderedLines(
+        TextSlot & textSlot,
+        FontMetadata const & fontMetadata);
+
     std::array<TextSlot, 8> mTextSlots;
     uint64_t mCurrentTextSlotGeneration;
     bool mAreTextSlotsDirty;
@@ -150,6 +187,8 @@ private:
             , mFontTextureHandle(fontTextureHandle)
             , mVertexBufferVBOHandle(vertexBufferVBOHandle)
             , mVAOHandle(vaoHandle)
+            , mVertexBuffer()
+            , mVBOAllocatedVertexCount(0)
         {}
 
         FontRenderInfo(FontRenderInfo && other)
@@ -157,6 +196,8 @@ private:
             , mFontTextureHandle(std::move(other.mFontTextureHandle))
             , mVertexBufferVBOHandle(std::move(other.mVertexBufferVBOHandle))
             , mVAOHandle(std::move(other.mVAOHandle))
+            , mVertexBuffer(std::move(other.mVertexBuffer))
+            , mVBOAllocatedVertexCount(other.mVBOAllocatedVertexCount)
         {}
 
         inline FontMetadata const & GetFontMetadata() const
@@ -189,6 +230,16 @@ private:
             return mVertexBuffer;
         }
 
+        inline size_t GetVBOAllocatedVertexCount() const
+        {
+            return mVBOAllocatedVertexCount;
+        }
+
+        inline void SetVBOAllocatedVertexCount(size_t vertexCount)
+        {
+            mVBOAllocatedVertexCount = vertexCount;
+        }
+
     private:
         FontMetadata mFontMetadata;
         GameOpenGLTexture mFontTextureHandle;
@@ -196,6 +247,9 @@ private:
         GameOpenGLVAO mVAOHandle;
 
         std::vector<TextQuadVertex> mVertexBuffer;
+
+        // The VBO only grows
+        size_t mVBOAllocatedVertexCount;
     };
 
     std::vector<FontRenderInfo> mFontRenderInfos;
@@ -7,14 +7,219 @@
 
 #include <GameCore/GameException.h>
 #include <GameCore/GameMath.h>
+#include <GameCore/ResourceArchive.h>
+#include <GameCore/TaskThreadPool.h>
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
 
 namespace Render {
 
+namespace /* anonymous */ {
+
+    // Bump whenever the layout of the file changes
+    static constexpr char BakedAtlasMagic[4] = { 'F', 'S', 'T', 'A' };
+    static constexpr std::uint32_t BakedAtlasVersion = 1;
+
+    template<typename T>
+    void WriteBinary(std::ofstream & file, T const & value)
+    {
+        file.write(reinterpret_cast<char const *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    T ReadBinary(std::istream & file)
+    {
+        T value;
+        file.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return value;
+    }
+}
+
+float TextureAtlas::CalculateFillRatio() const
+{
+    uint64_t const atlasArea =
+        static_cast<uint64_t>(AtlasData.Size.Width) * static_cast<uint64_t>(AtlasData.Size.Height);
+
+    if (atlasArea == 0)
+        return 0.0f;
+
+    uint64_t framesArea = 0;
+    for (auto const & frame : Metadata.GetFrameMetadata())
+    {
+        framesArea +=
+            static_cast<uint64_t>(frame.FrameMetadata.Size.Width) * static_cast<uint64_t>(frame.FrameMetadata.Size.Height);
+    }
+
+    return static_cast<float>(static_cast<double>(framesArea) / static_cast<double>(atlasArea));
+}
+
+void TextureAtlas::Serialize(std::filesystem::path const & outputFilePath) const
+{
+    std::ofstream file(outputFilePath.string(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw GameException("Cannot open file \"" + outputFilePath.string() + "\" for writing");
+    }
+
+    //
+    // Header
+    //
+
+    file.write(BakedAtlasMagic, sizeof(BakedAtlasMagic));
+    WriteBinary<std::uint32_t>(file, BakedAtlasVersion);
+    WriteBinary<std::int32_t>(file, AtlasData.Size.Width);
+    WriteBinary<std::int32_t>(file, AtlasData.Size.Height);
+    WriteBinary<std::uint32_t>(file, static_cast<std::uint32_t>(Metadata.GetFrameMetadata().size()));
+
+    //
+    // Frames
+    //
+
+    for (auto const & frame : Metadata.GetFrameMetadata())
+    {
+        WriteBinary<float>(file, frame.TextureCoordinatesBottomLeft.x);
+        WriteBinary<float>(file, frame.TextureCoordinatesBottomLeft.y);
+        WriteBinary<float>(file, frame.TextureCoordinatesTopRight.x);
+        WriteBinary<float>(file, frame.TextureCoordinatesTopRight.y);
+        WriteBinary<std::int32_t>(file, frame.FrameLeftX);
+        WriteBinary<std::int32_t>(file, frame.FrameBottomY);
+        WriteBinary<std::int32_t>(file, frame.FrameMetadata.Size.Width);
+        WriteBinary<std::int32_t>(file, frame.FrameMetadata.Size.Height);
+        WriteBinary<float>(file, frame.FrameMetadata.WorldWidth);
+        WriteBinary<float>(file, frame.FrameMetadata.WorldHeight);
+        WriteBinary<std::uint8_t>(file, frame.FrameMetadata.HasOwnAmbientLight ? 1 : 0);
+        WriteBinary<float>(file, frame.FrameMetadata.AnchorWorldX);
+        WriteBinary<float>(file, frame.FrameMetadata.AnchorWorldY);
+        WriteBinary<std::uint16_t>(file, static_cast<std::uint16_t>(frame.FrameMetadata.FrameId.Group));
+        WriteBinary<std::uint16_t>(file, frame.FrameMetadata.FrameId.FrameIndex);
+    }
+
+    //
+    // Image
+    //
+
+    file.write(
+        reinterpret_cast<char const *>(AtlasData.Data.get()),
+        static_cast<std::streamsize>(AtlasData.Size.Width) * AtlasData.Size.Height * sizeof(rgbaColor));
+
+    if (!file.good())
+    {
+        throw GameException("Error writing file \"" + outputFilePath.string() + "\"");
+    }
+}
+
+TextureAtlas TextureAtlas::Deserialize(std::filesystem::path const & inputFilePath)
+{
+    std::ifstream inputFile(inputFilePath.string(), std::ios::binary | std::ios::in);
+    std::istream file(inputFile.rdbuf());
+
+    // Not loose, maybe it's packed
+    std::unique_ptr<ResourceArchive::EntryStreamBuffer> archiveStreamBuffer;
+    if (!inputFile.is_open())
+    {
+        auto const archiveEntry = ResourceArchive::FindMounted(inputFilePath);
+        if (!archiveEntry)
+        {
+            throw GameException("Cannot open file \"" + inputFilePath.string() + "\"");
+        }
+
+        archiveStreamBuffer = std::make_unique<ResourceArchive::EntryStreamBuffer>(*archiveEntry);
+        file.rdbuf(archiveStreamBuffer.get());
+    }
+
+    //
+    // Header
+    //
+
+    char magic[sizeof(BakedAtlasMagic)];
+    file.read(magic, sizeof(magic));
+    if (!file.good() || 0 != std::memcmp(magic, BakedAtlasMagic, sizeof(magic)))
+    {
+        throw GameException("File \"" + inputFilePath.string() + "\" is not a texture atlas file");
+    }
+
+    if (ReadBinary<std::uint32_t>(file) != BakedAtlasVersion)
+    {
+        throw GameException("File \"" + inputFilePath.string() + "\" is a texture atlas file of an unsupported version");
+    }
+
+    int const width = ReadBinary<std::int32_t>(file);
+    int const height = ReadBinary<std::int32_t>(file);
+    std::uint32_t const frameCount = ReadBinary<std::uint32_t>(file);
+
+    //
+    // Frames
+    //
+
+    std::vector<TextureAtlasFrameMetadata> frames;
+    frames.reserve(frameCount);
+    for (std::uint32_t f = 0; f < frameCount && file.good(); ++f)
+    {
+        float const bottomLeftX = ReadBinary<float>(file);
+        float const bottomLeftY = ReadBinary<float>(file);
+        float const topRightX = ReadBinary<float>(file);
+        float const topRightY = ReadBinary<float>(file);
+        int const frameLeftX = ReadBinary<std::int32_t>(file);
+        int const frameBottomY = ReadBinary<std::int32_t>(file);
+        int const frameWidth = ReadBinary<std::int32_t>(file);
+        int const frameHeight = ReadBinary<std::int32_t>(file);
+        float const worldWidth = ReadBinary<float>(file);
+        float const worldHeight = ReadBinary<float>(file);
+        bool const hasOwnAmbientLight = (ReadBinary<std::uint8_t>(file) != 0);
+        float const anchorWorldX = ReadBinary<float>(file);
+        float const anchorWorldY = ReadBinary<float>(file);
+        auto const group = static_cast<TextureGroupType>(ReadBinary<std::uint16_t>(file));
+        auto const frameIndex = static_cast<TextureFrameIndex>(ReadBinary<std::uint16_t>(file));
+
+        frames.emplace_back(
+            vec2f(bottomLeftX, bottomLeftY),
+            vec2f(topRightX, topRightY),
+            frameLeftX,
+            frameBottomY,
+            TextureFrameMetadata(
+                ImageSize(frameWidth, frameHeight),
+                worldWidth,
+                worldHeight,
+                hasOwnAmbientLight,
+                anchorWorldX,
+                anchorWorldY,
+                TextureFrameId(group, frameIndex)));
+    }
+
+    //
+    // Image
+    //
+
+    size_t const pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    auto atlasImage = std::make_unique<rgbaColor[]>(pixelCount);
+    file.read(
+        reinterpret_cast<char *>(atlasImage.get()),
+        static_cast<std::streamsize>(pixelCount * sizeof(rgbaColor)));
+
+    if (!file.good())
+    {
+        throw GameException("Texture atlas file \"" + inputFilePath.string() + "\" is truncated");
+    }
+
+    return TextureAtlas(
+        TextureAtlasMetadata(std::move(frames)),
+        RgbaImageData(
+            ImageSize(width, height),
+            std::move(atlasImage)));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 TextureAtlas TextureAtlasBuilder::BuildAtlas(
     TextureGroup const & group,
+    AtlasOptions const & options,
     ProgressCallback const & progressCallback)
 {
     // Build TextureInfo's
@@ -22,7 +227,7 @@ TextureAtlas TextureAtlasBuilder::BuildAtlas(
     AddTextureInfos(group, textureInfos);
 
     // Build specification
-    AtlasSpecification specification = BuildAtlasSpecification(textureInfos);
+    AtlasSpecification specification = BuildBestAtlasSpecification(textureInfos, options);
 
     // Build atlas
     return BuildAtlas(
@@ -36,6 +241,7 @@ TextureAtlas TextureAtlasBuilder::BuildAtlas(
 
 TextureAtlas TextureAtlasBuilder::BuildAtlas(
     TextureDatabase const & database,
+    AtlasOptions const & options,
     ProgressCallback const & progressCallback)
 {
     // Build TextureInfo's
@@ -46,7 +252,7 @@ TextureAtlas TextureAtlasBuilder::BuildAtlas(
     }
 
     // Build specification
-    AtlasSpecification specification = BuildAtlasSpecification(textureInfos);
+    AtlasSpecification specification = BuildBestAtlasSpecification(textureInfos, options);
 
     // Build atlas
     return BuildAtlas(
@@ -58,7 +264,36 @@ TextureAtlas TextureAtlasBuilder::BuildAtlas(
         progressCallback);
 }
 
-TextureAtlas TextureAtlasBuilder::BuildAtlas(ProgressCallback const & progressCallback)
+TextureAtlas TextureAtlasBuilder::BuildGenericTextureAtlas(
+    TextureDatabase const & database,
+    AtlasOptions const & options,
+    ProgressCallback const & progressCallback)
+{
+    //
+    // Atlas-ize all textures EXCEPT the following:
+    // - Land, Ocean: we need these to be wrapping
+    // - Clouds: we keep these in a separate atlas, we have to rebind anyway
+    // - WorldBorder
+    //
+
+    TextureAtlasBuilder builder;
+    for (auto const & group : database.GetGroups())
+    {
+        if (TextureGroupType::Land != group.Group
+            && TextureGroupType::Ocean != group.Group
+            && TextureGroupType::Cloud != group.Group
+            && TextureGroupType::WorldBorder != group.Group)
+        {
+            builder.Add(group);
+        }
+    }
+
+    return builder.BuildAtlas(options, progressCallback);
+}
+
+TextureAtlas TextureAtlasBuilder::BuildAtlas(
+    AtlasOptions const & options,
+    ProgressCallback const & progressCallback)
 {
     // Build TextureInfo's
     std::vector<TextureInfo> textureInfos;
@@ -70,7 +305,7 @@ TextureAtlas TextureAtlasBuilder::BuildAtlas(ProgressCallback const & progressCa
     }
 
     // Build specification
-    AtlasSpecification specification = BuildAtlasSpecification(textureInfos);
+    AtlasSpecification specification = BuildBestAtlasSpecification(textureInfos, options);
 
     // Build atlas
     return BuildAtlas(
@@ -84,6 +319,29 @@ TextureAtlas TextureAtlasBuilder::BuildAtlas(ProgressCallback const & progressCa
 
 /////////////////////////////////////////////////////////////////////////////////////
 
+TextureAtlasBuilder::AtlasSpecification TextureAtlasBuilder::BuildBestAtlasSpecification(
+    std::vector<TextureInfo> const & inputTextureInfos,
+    AtlasOptions const & options)
+{
+    auto const getArea = [](AtlasSpecification const & specification)
+    {
+        return static_cast<uint64_t>(specification.AtlasSize.Width) * static_cast<uint64_t>(specification.AtlasSize.Height);
+    };
+
+    AtlasSpecification skylineSpecification = BuildSkylineAtlasSpecification(inputTextureInfos, options);
+
+    if (options.IsPowerOfTwoSize && options.FramePadding == 0)
+    {
+        AtlasSpecification shelfSpecification = BuildAtlasSpecification(inputTextureInfos);
+
+        // Prefer the shelf on ties, as it keeps frames aligned to their own size
+        if (getArea(shelfSpecification) <= getArea(skylineSpecification))
+            return shelfSpecification;
+    }
+
+    return skylineSpecification;
+}
+
 TextureAtlasBuilder::AtlasSpecification TextureAtlasBuilder::BuildAtlasSpecification(std::vector<TextureInfo> const & inputTextureInfos)
 {
     //
@@ -215,6 +473,233 @@ TextureAtlasBuilder::AtlasSpecification TextureAtlasBuilder::BuildAtlasSpecifica
         ImageSize(atlasWidth, atlasHeight));
 }
 
+TextureAtlasBuilder::AtlasSpecification TextureAtlasBuilder::BuildSkylineAtlasSpecification(
+    std::vector<TextureInfo> const & inputTextureInfos,
+    AtlasOptions const & options)
+{
+    //
+    // Sort input texture info's by height, from tallest to shortest, as the shelf does
+    //
+
+    std::vector<TextureInfo> sortedTextureInfos = inputTextureInfos;
+    std::sort(
+        sortedTextureInfos.begin(),
+        sortedTextureInfos.end(),
+        [](TextureInfo const & a, TextureInfo const & b)
+        {
+            return a.Size.Height > b.Size.Height
+                || (a.Size.Height == b.Size.Height && a.Size.Width > b.Size.Width);
+        });
+
+    int maxFrameWidth = 1;
+    int totalPaddedWidth = 0;
+    uint64_t totalPaddedArea = 0;
+    for (auto const & ti : sortedTextureInfos)
+    {
+        maxFrameWidth = std::max(maxFrameWidth, ti.Size.Width);
+        totalPaddedWidth += ti.Size.Width + options.FramePadding;
+        totalPaddedArea +=
+            static_cast<uint64_t>(ti.Size.Width + options.FramePadding)
+            * static_cast<uint64_t>(ti.Size.Height + options.FramePadding);
+    }
+
+    //
+    // Pack at a number of candidate widths, and keep the smallest atlas - the squarest among equals
+    //
+
+    std::optional<AtlasSpecification> bestSpecification;
+
+    auto const tryWidth = [&](int atlasWidth)
+    {
+        auto specification = PackSkyline(sortedTextureInfos, atlasWidth, options);
+        if (!specification)
+            return;
+
+        if (!bestSpecification)
+        {
+            bestSpecification = std::move(specification);
+            return;
+        }
+
+        uint64_t const area = static_cast<uint64_t>(specification->AtlasSize.Width) * static_cast<uint64_t>(specification->AtlasSize.Height);
+        uint64_t const bestArea = static_cast<uint64_t>(bestSpecification->AtlasSize.Width) * static_cast<uint64_t>(bestSpecification->AtlasSize.Height);
+        if (area < bestArea
+            || (area == bestArea
+                && std::max(specification->AtlasSize.Width, specification->AtlasSize.Height)
+                    < std::max(bestSpecification->AtlasSize.Width, bestSpecification->AtlasSize.Height)))
+        {
+            bestSpecification = std::move(specification);
+        }
+    };
+
+    if (options.IsPowerOfTwoSize)
+    {
+        for (int atlasWidth = CeilPowerOfTwo(maxFrameWidth); ; atlasWidth *= 2)
+        {
+            tryWidth(atlasWidth);
+
+            if (atlasWidth >= totalPaddedWidth)
+                break;
+        }
+    }
+    else
+    {
+        // Between the widest frame and twice the side of the square that would hold all frames
+        constexpr int NonPowerOfTwoCandidateWidths = 32;
+
+        int const maxAtlasWidth = std::max(
+            maxFrameWidth,
+            std::min(
+                totalPaddedWidth,
+                2 * static_cast<int>(std::ceil(std::sqrt(static_cast<double>(totalPaddedArea))))));
+
+        for (int c = 0; c < NonPowerOfTwoCandidateWidths; ++c)
+        {
+            tryWidth(maxFrameWidth + (maxAtlasWidth - maxFrameWidth) * c / (NonPowerOfTwoCandidateWidths - 1));
+        }
+    }
+
+    assert(!!bestSpecification);
+
+    return std::move(*bestSpecification);
+}
+
+std::optional<TextureAtlasBuilder::AtlasSpecification> TextureAtlasBuilder::PackSkyline(
+    std::vector<TextureInfo> const & sortedTextureInfos,
+    int atlasWidth,
+    AtlasOptions const & options)
+{
+    //
+    // The skyline is the top of the frames placed so far, as a list of contiguous
+    // horizontal segments covering the whole width of the atlas; each frame goes where
+    // it would sit lowest, leftmost among equals. Frames reserve their padding to the
+    // right and to the top, short of the atlas' right edge.
+    //
+
+    struct Segment
+    {
+        int X;
+        int Y;
+        int Width;
+
+        Segment(
+            int x,
+            int y,
+            int width)
+            : X(x)
+            , Y(y)
+            , Width(width)
+        {}
+    };
+
+    std::vector<Segment> skyline;
+    skyline.emplace_back(0, 0, atlasWidth);
+
+    std::vector<Segment> newSkyline;
+
+    std::vector<AtlasSpecification::TexturePosition> texturePositions;
+    texturePositions.reserve(sortedTextureInfos.size());
+
+    int usedWidth = 0;
+    int usedHeight = 0;
+
+    for (TextureInfo const & t : sortedTextureInfos)
+    {
+        if (t.Size.Width > atlasWidth)
+            return std::nullopt;
+
+        //
+        // Find lowest position
+        //
+
+        int bestX = 0;
+        int bestY = std::numeric_limits<int>::max();
+
+        for (size_t s = 0; s < skyline.size(); ++s)
+        {
+            int const x = skyline[s].X;
+            if (x + t.Size.Width > atlasWidth)
+                break;
+
+            int const spanRight = std::min(x + t.Size.Width + options.FramePadding, atlasWidth);
+
+            int y = 0;
+            for (size_t s2 = s; s2 < skyline.size() && skyline[s2].X < spanRight; ++s2)
+            {
+                y = std::max(y, skyline[s2].Y);
+            }
+
+            if (y < bestY)
+            {
+                bestX = x;
+                bestY = y;
+            }
+        }
+
+        assert(bestY != std::numeric_limits<int>::max());
+
+        texturePositions.emplace_back(
+            t.FrameId,
+            bestX,
+            bestY);
+
+        usedWidth = std::max(usedWidth, bestX + t.Size.Width);
+        usedHeight = std::max(usedHeight, bestY + t.Size.Height);
+
+        //
+        // Raise the skyline over the frame, merging segments at the same height
+        //
+
+        int const frameRight = std::min(bestX + t.Size.Width + options.FramePadding, atlasWidth);
+        int const frameTop = bestY + t.Size.Height + options.FramePadding;
+
+        auto const addSegment = [&newSkyline](int x, int y, int width)
+        {
+            if (width <= 0)
+                return;
+
+            if (!newSkyline.empty() && newSkyline.back().Y == y)
+                newSkyline.back().Width += width;
+            else
+                newSkyline.emplace_back(x, y, width);
+        };
+
+        newSkyline.clear();
+        bool isFrameSegmentAdded = false;
+        for (auto const & segment : skyline)
+        {
+            int const segmentRight = segment.X + segment.Width;
+
+            // Part left of the frame
+            addSegment(segment.X, segment.Y, std::min(segmentRight, bestX) - segment.X);
+
+            if (!isFrameSegmentAdded && segmentRight > bestX)
+            {
+                addSegment(bestX, frameTop, frameRight - bestX);
+                isFrameSegmentAdded = true;
+            }
+
+            // Part right of the frame
+            int const rightPartX = std::max(segment.X, frameRight);
+            addSegment(rightPartX, segment.Y, segmentRight - rightPartX);
+        }
+
+        std::swap(skyline, newSkyline);
+    }
+
+    //
+    // Round final size
+    //
+
+    ImageSize atlasSize = options.IsPowerOfTwoSize
+        ? ImageSize(CeilPowerOfTwo(usedWidth), CeilPowerOfTwo(usedHeight))
+        : ImageSize(std::max(usedWidth, 1), std::max(usedHeight, 1));
+
+    return AtlasSpecification(
+        std::move(texturePositions),
+        atlasSize);
+}
+
 TextureAtlas TextureAtlasBuilder::BuildAtlas(
     AtlasSpecification const & specification,
     std::function<TextureFrame(TextureFrameId const &)> frameLoader,
@@ -230,39 +715,73 @@ TextureAtlas TextureAtlasBuilder::BuildAtlas(
     // Fill image - transparent black
     std::fill_n(atlasImage.get(), imagePoints, rgbaColor::zero());
 
-    // Copy all textures into image, building metadata at the same time
-    std::vector<TextureAtlasFrameMetadata> metadata;
-    for (auto const & texturePosition : specification.TexturePositions)
+    //
+    // Load and copy all textures into image, in parallel - the frames' regions of the atlas
+    // are disjoint, and each frame's metadata goes into its own slot, hence the result does
+    // not depend on the number of threads.
+    //
+    // We proceed in batches so that progress may be reported from this thread.
+    //
+
+    size_t const frameCount = specification.TexturePositions.size();
+    std::vector<std::optional<TextureAtlasFrameMetadata>> frameMetadata(frameCount);
+
+    auto & threadPool = TaskThreadPool::GetInstance();
+    size_t const batchSize = std::max(threadPool.GetParallelism() * 4, size_t(1));
+
+    for (size_t batchStart = 0; batchStart < frameCount; batchStart += batchSize)
     {
         progressCallback(
-            static_cast<float>(metadata.size()) / static_cast<float>(specification.TexturePositions.size()),
+            static_cast<float>(batchStart) / static_cast<float>(frameCount),
             "Building texture atlas...");
 
-        // Load frame
-        TextureFrame textureFrame = frameLoader(texturePosition.FrameId);
-
-        // Copy frame
-        CopyImage(
-            std::move(textureFrame.TextureData.Data),
-            textureFrame.TextureData.Size,
-            atlasImage.get(),
-            specification.AtlasSize,
-            texturePosition.FrameLeftX,
-            texturePosition.FrameBottomY);
-
-        // Store texture coordinates
-        metadata.emplace_back(
-            // Bottom-left
-            vec2f(
-                dx + static_cast<float>(texturePosition.FrameLeftX) / static_cast<float>(specification.AtlasSize.Width),
-                dy + static_cast<float>(texturePosition.FrameBottomY) / static_cast<float>(specification.AtlasSize.Height)),
-            // Top-right
-            vec2f(
-                static_cast<float>(texturePosition.FrameLeftX + textureFrame.TextureData.Size.Width) / static_cast<float>(specification.AtlasSize.Width) - dx,
-                static_cast<float>(texturePosition.FrameBottomY + textureFrame.TextureData.Size.Height) / static_cast<float>(specification.AtlasSize.Height) - dy),
-            texturePosition.FrameLeftX,
-            texturePosition.FrameBottomY,
-            textureFrame.Metadata);
+        threadPool.ParallelFor(
+            batchStart,
+            std::min(batchStart + batchSize, frameCount),
+            1,
+            [&](size_t begin, size_t end)
+            {
+                for (size_t t = begin; t < end; ++t)
+                {
+                    auto const & texturePosition = specification.TexturePositions[t];
+
+                    // Load frame
+                    TextureFrame textureFrame = frameLoader(texturePosition.FrameId);
+
+                    ImageSize const frameSize = textureFrame.TextureData.Size;
+
+                    // Copy frame
+                    CopyImage(
+                        std::move(textureFrame.TextureData.Data),
+                        frameSize,
+                        atlasImage.get(),
+                        specification.AtlasSize,
+                        texturePosition.FrameLeftX,
+                        texturePosition.FrameBottomY);
+
+                    // Store texture coordinates
+                    frameMetadata[t].emplace(
+                        // Bottom-left
+                        vec2f(
+                            dx + static_cast<float>(texturePosition.FrameLeftX) / static_cast<float>(specification.AtlasSize.Width),
+                            dy + static_cast<float>(texturePosition.FrameBottomY) / static_cast<float>(specification.AtlasSize.Height)),
+                        // Top-right
+                        vec2f(
+                            static_cast<float>(texturePosition.FrameLeftX + frameSize.Width) / static_cast<float>(specification.AtlasSize.Width) - dx,
+                            static_cast<float>(texturePosition.FrameBottomY + frameSize.Height) / static_cast<float>(specification.AtlasSize.Height) - dy),
+                        texturePosition.FrameLeftX,
+                        texturePosition.FrameBottomY,
+                        textureFrame.Metadata);
+                }
+            });
+    }
+
+    std::vector<TextureAtlasFrameMetadata> metadata;
+    metadata.reserve(frameCount);
+    for (auto & fm : frameMetadata)
+    {
+        assert(!!fm);
+        metadata.emplace_back(std::move(*fm));
     }
 
     RgbaImageData atlasImageData(
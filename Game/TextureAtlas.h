@@ -13,8 +13,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -136,17 +138,53 @@ struct TextureAtlas
         : Metadata(metadata)
         , AtlasData(std::move(atlasData))
     {}
+
+    /*
+     * Returns the fraction of the atlas' area that is covered by frames.
+     */
+    float CalculateFillRatio() const;
+
+    /*
+     * Writes the metadata and the image of this atlas to a binary file, which
+     * may be loaded back without decoding nor packing any of its frames.
+     */
+    void Serialize(std::filesystem::path const & outputFilePath) const;
+
+    static TextureAtlas Deserialize(std::filesystem::path const & inputFilePath);
 };
 
 class TextureAtlasBuilder
 {
 public:
 
+    struct AtlasOptions
+    {
+        // When set, the atlas' dimensions are powers of two, as required by
+        // our mipmapped uploads
+        bool IsPowerOfTwoSize;
+
+        // The number of empty pixels kept between frames
+        int FramePadding;
+
+        AtlasOptions()
+            : IsPowerOfTwoSize(true)
+            , FramePadding(0)
+        {}
+
+        AtlasOptions(
+            bool isPowerOfTwoSize,
+            int framePadding)
+            : IsPowerOfTwoSize(isPowerOfTwoSize)
+            , FramePadding(framePadding)
+        {}
+    };
+
     /*
      * Builds an atlas with the specified group.
      */
     static TextureAtlas BuildAtlas(
         TextureGroup const & group,
+        AtlasOptions const & options,
         ProgressCallback const & progressCallback);
 
     /*
@@ -154,6 +192,16 @@ public:
      */
     static TextureAtlas BuildAtlas(
         TextureDatabase const & database,
+        AtlasOptions const & options,
+        ProgressCallback const & progressCallback);
+
+    /*
+     * Builds the atlas of the generic textures, i.e. of all textures in the specified
+     * database except those that need to be wrapping or that live in their own atlas.
+     */
+    static TextureAtlas BuildGenericTextureAtlas(
+        TextureDatabase const & database,
+        AtlasOptions const & options,
         ProgressCallback const & progressCallback);
 
 public:
@@ -179,7 +227,9 @@ public:
     /*
      * Builds an atlas for the groups added so far.
      */
-    TextureAtlas BuildAtlas(ProgressCallback const & progressCallback);
+    TextureAtlas BuildAtlas(
+        AtlasOptions const & options,
+        ProgressCallback const & progressCallback);
 
 private:
 
@@ -228,9 +278,28 @@ private:
         {}
     };
 
+    /*
+     * Packs with whichever of our packers yields the smallest atlas; the shelf packer
+     * only takes part when the options are those it is bound to, i.e. power-of-two
+     * atlases without padding.
+     */
+    static AtlasSpecification BuildBestAtlasSpecification(
+        std::vector<TextureInfo> const & inputTextureInfos,
+        AtlasOptions const & options);
+
     // Unit-tested
     static AtlasSpecification BuildAtlasSpecification(std::vector<TextureInfo> const & inputTextureInfos);
 
+    // Unit-tested
+    static AtlasSpecification BuildSkylineAtlasSpecification(
+        std::vector<TextureInfo> const & inputTextureInfos,
+        AtlasOptions const & options);
+
+    static std::optional<AtlasSpecification> PackSkyline(
+        std::vector<TextureInfo> const & sortedTextureInfos,
+        int atlasWidth,
+        AtlasOptions const & options);
+
     static TextureAtlas BuildAtlas(
         AtlasSpecification const & specification,
         std::function<TextureFrame(TextureFrameId const &)> frameLoader,
@@ -261,6 +330,10 @@ private:
     friend class TextureAtlasTests_OneTexture_Test;
     friend class TextureAtlasTests_Placement1_Test;
     friend class TextureAtlasTests_RoundsAtlasSize_Test;
+    friend class TextureAtlasTests_Skyline_DoesNotOverlap_Test;
+    friend class TextureAtlasTests_Skyline_NonPowerOfTwoSize_Test;
+    friend class TextureAtlasTests_Skyline_Padding_Test;
+    friend class TextureAtlasTests_Skyline_NoLargerThanShelf_Test;
 
 private:
 
@@ -8,6 +8,7 @@
 #include "ImageFileTools.h"
 
 #include <GameCore/GameException.h>
+#include <GameCore/ResourceArchive.h>
 #include <GameCore/Utils.h>
 
 #include <map>
@@ -49,15 +50,14 @@ TextureDatabase TextureDatabase::Load(
 
     std::vector<FileData> allTextureFiles;
 
-    for (auto const & entryIt : std::filesystem::directory_iterator(texturesRoot))
+    for (auto const & filepath : ResourceArchive::ListDirectory(texturesRoot))
     {
-        if (std::filesystem::is_regular_file(entryIt.path())
-            && entryIt.path().extension().string() != ".json")
+        if (filepath.extension().string() != ".json")
         {
-            std::string const stem = entryIt.path().filename().stem().string();
+            std::string const stem = filepath.filename().stem().string();
 
             allTextureFiles.emplace_back(
-                entryIt.path(),
+                filepath,
                 stem);
         }
     }
@@ -91,7 +91,7 @@ TextureDatabase TextureDatabase::Load(
             throw GameException("Texture database: found a non-object group in database");
         }
 
-        auto groupJson = groupValue.get<picojson::object>();
+        auto const & groupJson = groupValue.get<picojson::object>();
 
         std::string groupName = Utils::GetMandatoryJsonMember<std::string>(groupJson, "groupName");
         TextureGroupType groupType = StrToTextureGroupType(groupName);
@@ -118,7 +118,7 @@ TextureDatabase TextureDatabase::Load(
                 throw GameException("Texture database: found a non-object frame in database");
             }
 
-            auto frameJson = frameValue.get<picojson::object>();
+            auto const & frameJson = frameValue.get<picojson::object>();
 
             // Get frame properties
             std::optional<float> frameWorldScaling = Utils::GetOptionalJsonMember<float>(frameJson, "worldScaling");
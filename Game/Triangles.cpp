@@ -27,9 +27,9 @@ void Triangles::Destroy(ElementIndex triangleElementIndex)
     assert(!IsDeleted(triangleElementIndex));
 
     // Invoke destroy handler
-    if (!!mDestroyHandler)
+    if (nullptr != mShipHandler)
     {
-        mDestroyHandler(triangleElementIndex);
+        mShipHandler->TriangleDestroyHandler(triangleElementIndex);
     }
 
     // Flag ourselves as deleted
@@ -45,10 +45,18 @@ void Triangles::Restore(ElementIndex triangleElementIndex)
     mIsDeletedBuffer[triangleElementIndex] = false;
 
     // Invoke restore handler
-    if (!!mRestoreHandler)
+    if (nullptr != mShipHandler)
     {
-        mRestoreHandler(triangleElementIndex);
+        mShipHandler->TriangleRestoreHandler(triangleElementIndex);
     }
 }
 
+void Triangles::ReportMemory(MemoryReport & report) const
+{
+    report.Add("IsDeleted", mIsDeletedBuffer);
+    report.Add("Endpoints", mEndpointsBuffer);
+    report.Add("SubSprings", mSubSpringsBuffer);
+    report.Add("FactorySubSprings", mFactorySubSpringsBuffer);
+}
+
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include <GameCore/Buffer.h>
 #include <GameCore/ElementContainer.h>
 #include <GameCore/FixedSizeVector.h>
+#include <GameCore/MemoryReport.h>
 
 #include <algorithm>
 #include <cassert>
@@ -23,9 +24,6 @@ class Triangles : public ElementContainer
 {
 public:
 
-    using DestroyHandler = std::function<void(ElementIndex)>;
-    using RestoreHandler = std::function<void(ElementIndex)>;
-
 private:
 
     /*
@@ -65,47 +63,39 @@ public:
         //////////////////////////////////
         // Container
         //////////////////////////////////
-        , mDestroyHandler()
-        , mRestoreHandler()
+        , mShipHandler(nullptr)
     {
     }
 
     Triangles(Triangles && other) = default;
 
     /*
-     * Sets a (single) handler that is invoked whenever a triangle is destroyed.
-     *
-     * The handler is invoked right before the triangle is marked as deleted. However,
-     * other elements connected to the soon-to-be-deleted triangle might already have been
-     * deleted.
-     *
-     * The handler is not re-entrant: destroying other triangles from it is not supported
-     * and leads to undefined behavior.
-     *
-     * Setting more than one handler is not supported and leads to undefined behavior.
+     * Adds the buffers of the triangles to the report.
      */
-    void RegisterDestroyHandler(DestroyHandler destroyHandler)
-    {
-        assert(!mDestroyHandler);
-        mDestroyHandler = std::move(destroyHandler);
-    }
+    void ReportMemory(MemoryReport & report) const;
 
     /*
-     * Sets a (single) handler that is invoked whenever a triangle is restored.
+     * Sets the (single) ship whose handlers are invoked whenever a triangle is destroyed
+     * or restored; the handlers are invoked directly, rather than through type-erased
+     * callbacks, as they sit on the hot paths of cuts and explosions.
      *
-     * The handler is invoked right after the triangle is modified to be restored. However,
+     * The destroy handler is invoked right before the triangle is marked as deleted. However,
+     * other elements connected to the soon-to-be-deleted triangle might already have been
+     * deleted.
+     *
+     * The restore handler is invoked right after the triangle is modified to be restored. However,
      * other elements connected to the soon-to-be-restored triangle might not have been
      * restored yet.
      *
-     * The handler is not re-entrant: restoring other triangles from it is not supported
-     * and leads to undefined behavior.
+     * The handlers are not re-entrant: destroying or restoring other triangles from them is
+     * not supported and leads to undefined behavior.
      *
-     * Setting more than one handler is not supported and leads to undefined behavior.
+     * Setting more than one ship is not supported and leads to undefined behavior.
      */
-    void RegisterRestoreHandler(RestoreHandler restoreHandler)
+    void RegisterShipHandler(Ship * shipHandler)
     {
-        assert(!mRestoreHandler);
-        mRestoreHandler = std::move(restoreHandler);
+        assert(nullptr == mShipHandler);
+        mShipHandler = shipHandler;
     }
 
     void Add(
@@ -125,38 +115,32 @@ public:
     /*
      * Uploads triangle elements.
      *
-     * The planeIndices container contains, for each plane, the starting index of the triangles in that plane into a single
-     * buffer for all triangles. The last element contains the total number of (non-deleted) triangles.
-     *
-     * The content of the planeIndices container is modified by this method, for performance convenience only.
+     * Each triangle goes at its own element index, regardless of its plane - which is
+     * taken care of by the depth of its points; hence a triangle's deletion or a change
+     * of planes never moves any other triangle.
      */
-    template<typename TIndices>
     void UploadElements(
-        TIndices & planeIndices,
         ShipId shipId,
-        Points const & points,
         Render::RenderContext & renderContext) const
     {
+        renderContext.UploadShipElementTrianglesStart(
+            shipId,
+            GetElementCount());
+
         for (ElementIndex i : *this)
         {
             if (!mIsDeletedBuffer[i])
             {
-                // Get the plane of this triangle (== plane of point A)
-                PlaneId planeId = points.GetPlaneId(GetPointAIndex(i));
-
-                // Send triangle to its index
-                assert(planeId < planeIndices.size());
                 renderContext.UploadShipElementTriangle(
                     shipId,
-                    planeIndices[planeId],
+                    i,
                     GetPointAIndex(i),
                     GetPointBIndex(i),
                     GetPointCIndex(i));
-
-                // Remember that the next triangle for this plane goes to the next element
-                planeIndices[planeId]++;
             }
         }
+
+        renderContext.UploadShipElementTrianglesEnd(shipId);
     }
 
 public:
@@ -263,11 +247,8 @@ private:
     // Container
     //////////////////////////////////////////////////////////
 
-    // The handler registered for triangle deletions
-    DestroyHandler mDestroyHandler;
-
-    // The handler registered for triangle restoration
-    RestoreHandler mRestoreHandler;
+    // The ship registered for triangle deletions and restorations
+    Ship * mShipHandler;
 };
 
 }
@@ -5,6 +5,8 @@
 ***************************************************************************************/
 #include "Physics.h"
 
+#include <emmintrin.h>
+
 namespace Physics {
 
 // The number of slices we want to render the water surface as;
@@ -12,16 +14,51 @@ namespace Physics {
 template<typename T>
 static constexpr T RenderSlices = 500;
 
-WaterSurface::WaterSurface()
-    : mSamples(new Sample[SamplesCount + 1])
+// The speed at which interactive waves travel, in m/s; capped so that
+// the simulation is stable at the current resolution
+static constexpr float InteractiveWaveSpeed = 12.0f;
+
+// The fraction of the vertical velocity of the interactive waves that is lost each second
+static constexpr float InteractiveWaveDamping = 0.4f;
+
+// The interactive waves are at rest at samples whose height and velocity are below this
+static constexpr float InteractiveWaveRestThreshold = 0.001f;
+
+// The max height of the interactive waves, both up and down
+static constexpr float MaxInteractiveWaveHeight = 6.0f;
+
+WaterSurface::WaterSurface(GameParameters const & gameParameters)
+    : mWindIncisivenessRunningAverage()
+    , mSamplesCount(0)
+    , mDx(0.0f)
+    , mWaveTheta(0.0f)
+    , mWaveHeight(0.0f)
+    , mWindRipplesTheta(0.0f)
+    , mWindRipplesWaveHeight(0.0f)
+    , mEvaluatedFirstSample(0)
+    , mEvaluatedLastSample(-1)
+    , mSamples()
+    , mAreInteractiveWavesEnabled(false)
+    , mInteractiveHeights()
+    , mInteractiveVelocities()
+    , mInteractiveFirstSample(0)
+    , mInteractiveLastSample(-1)
 {
+    Resize(static_cast<int64_t>(gameParameters.WaterSurfaceSamplesCount));
 }
 
 void WaterSurface::Update(
     float currentSimulationTime,
     Wind const & wind,
+    float regionOfInterestLeft,
+    float regionOfInterestRight,
     GameParameters const & gameParameters)
 {
+    if (static_cast<int64_t>(gameParameters.WaterSurfaceSamplesCount) != mSamplesCount)
+    {
+        Resize(static_cast<int64_t>(gameParameters.WaterSurfaceSamplesCount));
+    }
+
     // Waves
 
     float const waveSpeed = gameParameters.WindSpeedBase / 6.0f; // Water moves slower than wind
@@ -44,46 +81,86 @@ void WaterSurface::Update(
     float const smoothedWindNormalizedIncisiveness = mWindIncisivenessRunningAverage.Update(rawWindNormalizedIncisiveness);
     float const windRipplesWaveHeight = 0.7f * smoothedWindNormalizedIncisiveness;
 
-    // Spatial frequencies of the wave components
+    // Remember the parameters, for the samples calculated on demand
+
+    mWaveTheta = waveTheta;
+    mWaveHeight = waveHeight;
+    mWindRipplesTheta = currentSimulationTime * windRipplesTimeFrequency;
+    mWindRipplesWaveHeight = windRipplesWaveHeight;
 
-    static constexpr float SpatialFrequency1 = 0.1f;
-    static constexpr float SpatialFrequency2 = 0.3f;
-    static constexpr float SpatialFrequency3 = 0.5f; // Wind component
+    // Move the interactive waves ahead
+    UpdateInteractiveWaves(gameParameters);
+
+    //
+    // Find the samples covering the region of interest
+    //
+
+    mEvaluatedFirstSample = std::clamp(
+        static_cast<int64_t>(floorf((regionOfInterestLeft + GameParameters::HalfMaxWorldWidth) / mDx)),
+        int64_t(0),
+        mSamplesCount);
+
+    mEvaluatedLastSample = std::clamp(
+        static_cast<int64_t>(ceilf((regionOfInterestRight + GameParameters::HalfMaxWorldWidth) / mDx)),
+        mEvaluatedFirstSample,
+        mSamplesCount);
+
+    // The last sample whose value we need, for the deltas; the extra sample is
+    // populated separately
+    int64_t const lastValueSample = std::min(mEvaluatedLastSample + 1, mSamplesCount - 1);
 
     //
     // Create samples
     //
 
-    // sample index = 0
-    float previousSampleValue;
+    int64_t const firstValueSample = std::min(mEvaluatedFirstSample, mSamplesCount - 1);
+
+    // Values, four at a time
     {
-        float const c1 = sinf(waveTheta) * 0.5f;
-        float const c2 = sinf(-waveTheta * 1.1f) * 0.3f;
-        float const c3 = sinf(-currentSimulationTime * windRipplesTimeFrequency);
-        previousSampleValue = (c1 + c2) * waveHeight + c3 * windRipplesWaveHeight;
-        mSamples[0].SampleValue = previousSampleValue;
+        __m128 const dx = _mm_set1_ps(mDx);
+
+        alignas(16) float sampleValues[4];
+
+        int64_t i = firstValueSample;
+        for (; i + 4 <= lastValueSample + 1; i += 4)
+        {
+            __m128 const sampleIndices = _mm_cvtepi32_ps(_mm_add_epi32(
+                _mm_set1_epi32(static_cast<int32_t>(i)),
+                _mm_set_epi32(3, 2, 1, 0)));
+
+            _mm_store_ps(
+                sampleValues,
+                _mm_add_ps(
+                    CalculateSampleValues4(_mm_mul_ps(sampleIndices, dx)),
+                    _mm_loadu_ps(&(mInteractiveHeights[i]))));
+
+            mSamples[i + 0].SampleValue = sampleValues[0];
+            mSamples[i + 1].SampleValue = sampleValues[1];
+            mSamples[i + 2].SampleValue = sampleValues[2];
+            mSamples[i + 3].SampleValue = sampleValues[3];
+        }
+
+        for (; i <= lastValueSample; ++i)
+        {
+            mSamples[i].SampleValue = CalculateSampleValue(i);
+        }
     }
 
-    // sample index = 1...SamplesCount - 1
-    float x = Dx;
-    for (int64_t i = 1; i < SamplesCount; i++, x += Dx)
+    // Deltas
+    for (int64_t i = firstValueSample; i < lastValueSample; ++i)
     {
-        float const c1 = sinf(x * SpatialFrequency1 + waveTheta) * 0.5f;
-        float const c2 = sinf(x * SpatialFrequency2 - waveTheta * 1.1f) * 0.3f;
-        float const c3 = sinf(x * SpatialFrequency3 - currentSimulationTime * windRipplesTimeFrequency);
-        float const sampleValue = (c1 + c2) * waveHeight + c3 * windRipplesWaveHeight;
-        mSamples[i].SampleValue = sampleValue;
-        mSamples[i - 1].SampleValuePlusOneMinusSampleValue = sampleValue - previousSampleValue;
-
-        previousSampleValue = sampleValue;
+        mSamples[i].SampleValuePlusOneMinusSampleValue = mSamples[i + 1].SampleValue - mSamples[i].SampleValue;
     }
 
-    // Populate last delta (extra sample has same value as this sample)
-    mSamples[SamplesCount - 1].SampleValuePlusOneMinusSampleValue = 0.0f;
+    if (lastValueSample == mSamplesCount - 1)
+    {
+        // Populate last delta (extra sample has same value as this sample)
+        mSamples[mSamplesCount - 1].SampleValuePlusOneMinusSampleValue = 0.0f;
 
-    // Populate extra sample - same value as last sample
-    mSamples[SamplesCount].SampleValue = mSamples[SamplesCount - 1].SampleValue;
-    mSamples[SamplesCount].SampleValuePlusOneMinusSampleValue = 0.0f; // Never used
+        // Populate extra sample - same value as last sample
+        mSamples[mSamplesCount].SampleValue = mSamples[mSamplesCount - 1].SampleValue;
+        mSamples[mSamplesCount].SampleValuePlusOneMinusSampleValue = 0.0f; // Never used
+    }
 }
 
 void WaterSurface::Upload(
@@ -95,13 +172,13 @@ void WaterSurface::Upload(
     //
 
     // Find index of leftmost sample, and its corresponding world X
-    auto sampleIndex = FastTruncateInt64((renderContext.GetVisibleWorldLeft() + GameParameters::HalfMaxWorldWidth) / Dx);
-    float sampleIndexX = -GameParameters::HalfMaxWorldWidth + (Dx * sampleIndex);
+    auto sampleIndex = FastTruncateInt64((renderContext.GetVisibleWorldLeft() + GameParameters::HalfMaxWorldWidth) / mDx);
+    float sampleIndexX = -GameParameters::HalfMaxWorldWidth + (mDx * sampleIndex);
 
     // Calculate number of samples required to cover screen from leftmost sample
     // up to the visible world right (included)
     float const coverageWidth = renderContext.GetVisibleWorldRight() - sampleIndexX;
-    auto const numberOfSamplesToRender = static_cast<int64_t>(ceil(coverageWidth / Dx));
+    auto const numberOfSamplesToRender = static_cast<int64_t>(ceil(coverageWidth / mDx));
 
     if (numberOfSamplesToRender >= RenderSlices<int64_t>)
     {
@@ -136,11 +213,11 @@ void WaterSurface::Upload(
 
         // We do one extra iteration as the number of slices is the number of quads, and the last vertical
         // quad side must be at the end of the width
-        for (std::int64_t s = 0; s <= numberOfSamplesToRender; ++s, sampleIndexX += Dx)
+        for (std::int64_t s = 0; s <= numberOfSamplesToRender; ++s, sampleIndexX += mDx)
         {
             renderContext.UploadOcean(
                 sampleIndexX,
-                mSamples[s + sampleIndex].SampleValue,
+                GetSampleValue(s + sampleIndex),
                 gameParameters.SeaDepth);
         }
     }
@@ -148,4 +225,267 @@ void WaterSurface::Upload(
     renderContext.UploadOceanEnd();
 }
 
+void WaterSurface::Resize(int64_t samplesCount)
+{
+    assert(samplesCount > 0);
+
+    mSamplesCount = samplesCount;
+    mDx = GameParameters::MaxWorldWidth / static_cast<float>(mSamplesCount);
+    mSamples.reset(new Sample[mSamplesCount + 1]);
+
+    // Nothing is evaluated yet
+    mEvaluatedFirstSample = 0;
+    mEvaluatedLastSample = -1;
+
+    // The interactive waves start at rest
+    mInteractiveHeights.reset(new float[mSamplesCount + 1]());
+    mInteractiveVelocities.reset(new float[mSamplesCount + 1]());
+    mInteractiveFirstSample = 0;
+    mInteractiveLastSample = -1;
+}
+
+void WaterSurface::DisplaceAt(
+    float x,
+    float displacement)
+{
+    if (!mAreInteractiveWavesEnabled)
+        return;
+
+    // Spread the displacement over a few samples, so that it doesn't make a spike;
+    // the first and last samples stay fixed at zero
+    static constexpr int64_t Radius = 2;
+
+    int64_t const centerSampleIndex = std::clamp(
+        static_cast<int64_t>(roundf((x + GameParameters::HalfMaxWorldWidth) / mDx)),
+        Radius + 1,
+        mSamplesCount - 2 - Radius);
+
+    for (int64_t d = -Radius; d <= Radius; ++d)
+    {
+        float const weight = 1.0f - static_cast<float>(std::abs(d)) / static_cast<float>(Radius + 1);
+
+        float & height = mInteractiveHeights[centerSampleIndex + d];
+        height = std::clamp(
+            height + displacement * weight,
+            -MaxInteractiveWaveHeight,
+            MaxInteractiveWaveHeight);
+    }
+
+    // Wake up the samples
+    if (mInteractiveFirstSample > mInteractiveLastSample)
+    {
+        mInteractiveFirstSample = centerSampleIndex - Radius;
+        mInteractiveLastSample = centerSampleIndex + Radius;
+    }
+    else
+    {
+        mInteractiveFirstSample = std::min(mInteractiveFirstSample, centerSampleIndex - Radius);
+        mInteractiveLastSample = std::max(mInteractiveLastSample, centerSampleIndex + Radius);
+    }
+}
+
+void WaterSurface::UpdateInteractiveWaves(GameParameters const & gameParameters)
+{
+    if (!gameParameters.DoSimulateInteractiveWaves)
+    {
+        if (mAreInteractiveWavesEnabled)
+        {
+            // Flatten whatever was moving
+            for (int64_t i = mInteractiveFirstSample; i <= mInteractiveLastSample; ++i)
+            {
+                mInteractiveHeights[i] = 0.0f;
+                mInteractiveVelocities[i] = 0.0f;
+            }
+
+            mInteractiveFirstSample = 0;
+            mInteractiveLastSample = -1;
+
+            mAreInteractiveWavesEnabled = false;
+        }
+
+        return;
+    }
+
+    mAreInteractiveWavesEnabled = true;
+
+    if (mInteractiveFirstSample > mInteractiveLastSample)
+    {
+        // All at rest
+        return;
+    }
+
+    float constexpr dt = GameParameters::SimulationStepTimeDuration<float>;
+
+    // Waves travel at most half a sample per step, hence the samples that
+    // may move now are at most one farther than those that moved before
+    float const waveSpeed = std::min(InteractiveWaveSpeed, 0.5f * mDx / dt);
+
+    int64_t const first = std::max(mInteractiveFirstSample - 1, int64_t(1));
+    int64_t const last = std::min(mInteractiveLastSample + 1, mSamplesCount - 2);
+
+    float * restrict const heights = mInteractiveHeights.get();
+    float * restrict const velocities = mInteractiveVelocities.get();
+
+    //
+    // 1. Velocities, from the curvature of the heights:
+    //  v' = c^2 * h'' - damping * v
+    // four samples at a time
+    //
+
+    float const curvatureCoefficient = waveSpeed * waveSpeed / (mDx * mDx) * dt;
+    float const dampingFactor = 1.0f - InteractiveWaveDamping * dt;
+
+    __m128 const curvatureCoefficient4 = _mm_set1_ps(curvatureCoefficient);
+    __m128 const dampingFactor4 = _mm_set1_ps(dampingFactor);
+    __m128 const two4 = _mm_set1_ps(2.0f);
+
+    int64_t i = first;
+    for (; i + 4 <= last + 1; i += 4)
+    {
+        __m128 const curvature = _mm_sub_ps(
+            _mm_add_ps(_mm_loadu_ps(heights + i - 1), _mm_loadu_ps(heights + i + 1)),
+            _mm_mul_ps(_mm_loadu_ps(heights + i), two4));
+
+        _mm_storeu_ps(
+            velocities + i,
+            _mm_mul_ps(
+                _mm_add_ps(_mm_loadu_ps(velocities + i), _mm_mul_ps(curvature, curvatureCoefficient4)),
+                dampingFactor4));
+    }
+
+    for (; i <= last; ++i)
+    {
+        float const curvature = heights[i - 1] + heights[i + 1] - 2.0f * heights[i];
+        velocities[i] = (velocities[i] + curvature * curvatureCoefficient) * dampingFactor;
+    }
+
+    //
+    // 2. Heights
+    //
+
+    __m128 const dt4 = _mm_set1_ps(dt);
+
+    i = first;
+    for (; i + 4 <= last + 1; i += 4)
+    {
+        _mm_storeu_ps(
+            heights + i,
+            _mm_add_ps(_mm_loadu_ps(heights + i), _mm_mul_ps(_mm_loadu_ps(velocities + i), dt4)));
+    }
+
+    for (; i <= last; ++i)
+    {
+        heights[i] += velocities[i] * dt;
+    }
+
+    //
+    // 3. Shrink the window to the samples that are not at rest
+    //
+
+    auto const isAtRest = [&](int64_t s)
+    {
+        return std::abs(heights[s]) < InteractiveWaveRestThreshold
+            && std::abs(velocities[s]) < InteractiveWaveRestThreshold;
+    };
+
+    mInteractiveFirstSample = first;
+    while (mInteractiveFirstSample <= last && isAtRest(mInteractiveFirstSample))
+    {
+        heights[mInteractiveFirstSample] = 0.0f;
+        velocities[mInteractiveFirstSample] = 0.0f;
+        ++mInteractiveFirstSample;
+    }
+
+    mInteractiveLastSample = last;
+    while (mInteractiveLastSample >= mInteractiveFirstSample && isAtRest(mInteractiveLastSample))
+    {
+        heights[mInteractiveLastSample] = 0.0f;
+        velocities[mInteractiveLastSample] = 0.0f;
+        --mInteractiveLastSample;
+    }
+
+    if (mInteractiveFirstSample > mInteractiveLastSample)
+    {
+        // All at rest
+        mInteractiveFirstSample = 0;
+        mInteractiveLastSample = -1;
+    }
+}
+
+
+void WaterSurface::GetWaterHeightsAt(
+    vec2f const * restrict positions,
+    float * restrict heights,
+    size_t count) const
+{
+    //
+    // Four points at a time: the sample indices and the interpolation
+    // are vectorized, while the samples are fetched one by one
+    //
+
+    __m128 const halfMaxWorldWidth = _mm_set1_ps(GameParameters::HalfMaxWorldWidth);
+    __m128 const dx = _mm_set1_ps(mDx);
+
+    alignas(16) int32_t sampleIndices[4];
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // x0 y0 x1 y1, x2 y2 x3 y3
+        __m128 const positions01 = _mm_loadu_ps(reinterpret_cast<float const *>(positions + i));
+        __m128 const positions23 = _mm_loadu_ps(reinterpret_cast<float const *>(positions + i + 2));
+        __m128 const x = _mm_shuffle_ps(positions01, positions23, _MM_SHUFFLE(2, 0, 2, 0));
+
+        // Fractional index in the sample array
+        __m128 const sampleIndexF = _mm_div_ps(_mm_add_ps(x, halfMaxWorldWidth), dx);
+
+        // Integral part
+        __m128i const sampleIndexI = _mm_cvttps_epi32(sampleIndexF);
+
+        // Fractional part within sample index and the next sample index
+        __m128 const sampleIndexDx = _mm_sub_ps(sampleIndexF, _mm_cvtepi32_ps(sampleIndexI));
+
+        _mm_store_si128(reinterpret_cast<__m128i *>(sampleIndices), sampleIndexI);
+
+        assert(sampleIndices[0] >= 0 && sampleIndices[0] <= mSamplesCount);
+        assert(sampleIndices[1] >= 0 && sampleIndices[1] <= mSamplesCount);
+        assert(sampleIndices[2] >= 0 && sampleIndices[2] <= mSamplesCount);
+        assert(sampleIndices[3] >= 0 && sampleIndices[3] <= mSamplesCount);
+
+        if (std::min({ sampleIndices[0], sampleIndices[1], sampleIndices[2], sampleIndices[3] }) < mEvaluatedFirstSample
+            || std::max({ sampleIndices[0], sampleIndices[1], sampleIndices[2], sampleIndices[3] }) > mEvaluatedLastSample)
+        {
+            // Some are outside of the region of interest
+            for (size_t j = i; j < i + 4; ++j)
+            {
+                heights[j] = GetWaterHeightAt(positions[j].x);
+            }
+
+            continue;
+        }
+
+        __m128 const sampleValue = _mm_set_ps(
+            mSamples[sampleIndices[3]].SampleValue,
+            mSamples[sampleIndices[2]].SampleValue,
+            mSamples[sampleIndices[1]].SampleValue,
+            mSamples[sampleIndices[0]].SampleValue);
+
+        __m128 const sampleValuePlusOneMinusSampleValue = _mm_set_ps(
+            mSamples[sampleIndices[3]].SampleValuePlusOneMinusSampleValue,
+            mSamples[sampleIndices[2]].SampleValuePlusOneMinusSampleValue,
+            mSamples[sampleIndices[1]].SampleValuePlusOneMinusSampleValue,
+            mSamples[sampleIndices[0]].SampleValuePlusOneMinusSampleValue);
+
+        _mm_storeu_ps(
+            heights + i,
+            _mm_add_ps(sampleValue, _mm_mul_ps(sampleValuePlusOneMinusSampleValue, sampleIndexDx)));
+    }
+
+    // Remainder
+    for (; i < count; ++i)
+    {
+        heights[i] = GetWaterHeightAt(positions[i].x);
+    }
+}
+
 }
\ No newline at end of file
@@ -9,7 +9,10 @@
 
 #include <GameCore/GameMath.h>
 #include <GameCore/RunningAverage.h>
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/Vectors.h>
 
+#include <algorithm>
 #include <memory>
 
 namespace Physics
@@ -19,17 +22,32 @@ class WaterSurface
 {
 public:
 
-    WaterSurface();
+    WaterSurface(GameParameters const & gameParameters);
 
+    /*
+     * Evaluates the surface between the specified world x's, which should cover
+     * whatever is going to query the surface until the next update; the surface
+     * outside of this region is calculated on demand.
+     */
     void Update(
         float currentSimulationTime,
         Wind const & wind,
+        float regionOfInterestLeft,
+        float regionOfInterestRight,
         GameParameters const & gameParameters);
 
     void Upload(
         GameParameters const & gameParameters,
         Render::RenderContext & renderContext) const;
 
+    /*
+     * Pushes the surface at the specified world x by the specified height (negative
+     * is down); only has an effect when interactive waves are enabled.
+     */
+    void DisplaceAt(
+        float x,
+        float displacement);
+
 public:
 
     float GetWaterHeightAt(float x) const
@@ -39,7 +57,7 @@ public:
         //
 
         // Fractional index in the sample array
-        float const sampleIndexF = (x + GameParameters::HalfMaxWorldWidth) / Dx;
+        float const sampleIndexF = (x + GameParameters::HalfMaxWorldWidth) / mDx;
 
         // Integral part
         int64_t sampleIndexI = FastTruncateInt64(sampleIndexF);
@@ -47,13 +65,77 @@ public:
         // Fractional part within sample index and the next sample index
         float sampleIndexDx = sampleIndexF - sampleIndexI;
 
-        assert(sampleIndexI >= 0 && sampleIndexI <= SamplesCount);
+        assert(sampleIndexI >= 0 && sampleIndexI <= mSamplesCount);
         assert(sampleIndexDx >= 0.0f && sampleIndexDx <= 1.0f);
 
-        return mSamples[sampleIndexI].SampleValue
-            + mSamples[sampleIndexI].SampleValuePlusOneMinusSampleValue * sampleIndexDx;
+        if (sampleIndexI >= mEvaluatedFirstSample && sampleIndexI <= mEvaluatedLastSample)
+        {
+            return mSamples[sampleIndexI].SampleValue
+                + mSamples[sampleIndexI].SampleValuePlusOneMinusSampleValue * sampleIndexDx;
+        }
+        else
+        {
+            // Outside of the region of interest
+            float const sampleValue = CalculateSampleValue(sampleIndexI);
+            return sampleValue
+                + (CalculateSampleValue(sampleIndexI + 1) - sampleValue) * sampleIndexDx;
+        }
     }
 
+    /*
+     * Batch version of GetWaterHeightAt(), sampling the water height at the x
+     * of each of the specified positions.
+     */
+    void GetWaterHeightsAt(
+        vec2f const * restrict positions,
+        float * restrict heights,
+        size_t count) const;
+
+private:
+
+    // Spatial frequencies of the wave components
+    static constexpr float SpatialFrequency1 = 0.1f;
+    static constexpr float SpatialFrequency2 = 0.3f;
+    static constexpr float SpatialFrequency3 = 0.5f; // Wind component
+
+    inline __m128 CalculateSampleValues4(__m128 x) const
+    {
+        __m128 const c1 = _mm_mul_ps(
+            FastSin4(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(SpatialFrequency1)), _mm_set1_ps(mWaveTheta))),
+            _mm_set1_ps(0.5f));
+        __m128 const c2 = _mm_mul_ps(
+            FastSin4(_mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(SpatialFrequency2)), _mm_set1_ps(mWaveTheta * 1.1f))),
+            _mm_set1_ps(0.3f));
+        __m128 const c3 = FastSin4(_mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(SpatialFrequency3)), _mm_set1_ps(mWindRipplesTheta)));
+
+        return _mm_add_ps(
+            _mm_mul_ps(_mm_add_ps(c1, c2), _mm_set1_ps(mWaveHeight)),
+            _mm_mul_ps(c3, _mm_set1_ps(mWindRipplesWaveHeight)));
+    }
+
+    inline float CalculateSampleValue(int64_t sampleIndex) const
+    {
+        // The extra sample has the same value as the last sample
+        int64_t const clampedSampleIndex = std::min(sampleIndex, mSamplesCount - 1);
+        float const x = static_cast<float>(clampedSampleIndex) * mDx;
+
+        // Same as the vectorized version, to the last bit
+        return _mm_cvtss_f32(CalculateSampleValues4(_mm_set_ss(x)))
+            + mInteractiveHeights[clampedSampleIndex];
+    }
+
+    inline float GetSampleValue(int64_t sampleIndex) const
+    {
+        if (sampleIndex >= mEvaluatedFirstSample && sampleIndex <= mEvaluatedLastSample)
+            return mSamples[sampleIndex].SampleValue;
+        else
+            return CalculateSampleValue(sampleIndex);
+    }
+
+    void Resize(int64_t samplesCount);
+
+    void UpdateInteractiveWaves(GameParameters const & gameParameters);
+
 private:
 
     // Smoothing of wind incisiveness
@@ -61,10 +143,20 @@ private:
 
     // The number of samples for the entire world width;
     // a higher value means more resolution at the expense of Update() and of cache misses
-    static constexpr int64_t SamplesCount = 8192;
+    int64_t mSamplesCount;
 
     // The x step of the samples
-    static constexpr float Dx = GameParameters::MaxWorldWidth / static_cast<float>(SamplesCount);
+    float mDx;
+
+    // The parameters of the wave components as of the last update
+    float mWaveTheta;
+    float mWaveHeight;
+    float mWindRipplesTheta;
+    float mWindRipplesWaveHeight;
+
+    // The samples that were evaluated at the last update, both included
+    int64_t mEvaluatedFirstSample;
+    int64_t mEvaluatedLastSample;
 
     // What we store for each sample
     struct Sample
@@ -75,6 +167,22 @@ private:
 
     // The samples (plus 1 to account for x==MaxWorldWidth)
     std::unique_ptr<Sample[]> mSamples;
+
+    //
+    // Interactive waves: a damped wave equation on a height field that sits on
+    // top of the procedural waves, simulated only where it's not at rest
+    //
+
+    bool mAreInteractiveWavesEnabled;
+
+    // The heights and vertical velocities of the height field, one per sample
+    std::unique_ptr<float[]> mInteractiveHeights;
+    std::unique_ptr<float[]> mInteractiveVelocities;
+
+    // The samples where the height field is not at rest, both included;
+    // empty when first > last
+    int64_t mInteractiveFirstSample;
+    int64_t mInteractiveLastSample;
 };
 
 }
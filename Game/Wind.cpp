@@ -7,6 +7,7 @@
 
 #include <GameCore/GameRandomEngine.h>
 
+#include <emmintrin.h>
 #include <limits.h>
 
 namespace Physics {
@@ -18,6 +19,11 @@ constexpr float PoissonSampleDeltaT = 1.0f / PoissonSampleRate;
 // The event rates for transitions, in 1/second
 constexpr float GustLambda = 1.0f / 1.0f;
 
+// The wavelengths of the two components of the gust fronts, and the period of their sum
+constexpr float GustFrontWavelength1 = 400.0f;
+constexpr float GustFrontWavelength2 = 160.0f;
+constexpr float GustFrontsPeriod = 800.0f;
+
 Wind::Wind(std::shared_ptr<IGameEventHandler> gameEventHandler)
     : mGameEventHandler(std::move(gameEventHandler))
     // Pre-calculated parameters
@@ -38,6 +44,10 @@ Wind::Wind(std::shared_ptr<IGameEventHandler> gameEventHandler)
     , mCurrentRawWindSpeedMagnitude(0.0f)
     , mCurrentWindSpeedMagnitudeRunningAverage()
     , mCurrentWindSpeed(vec2f::zero())
+    // Wind field
+    , mWindForceMultiplierField(new float[FieldSamplesCount + 4])
+    , mGustFrontsTravel(0.0f)
+    , mCurrentSpatialVariationParameter(0.0f)
 {
 }
 
@@ -284,6 +294,13 @@ void Wind::Update(GameParameters const & gameParameters)
         GameParameters::WindDirection
         * mCurrentWindSpeedMagnitudeRunningAverage.Update(mCurrentRawWindSpeedMagnitude);
 
+    // Update the field, if the wind varies along the world
+    mCurrentSpatialVariationParameter = gameParameters.WindSpatialVariation;
+    if (HasWindField())
+    {
+        UpdateWindField();
+    }
+
     // Publish interesting quantities for probes
     mGameEventHandler->OnWindSpeedUpdated(
         mZeroSpeedMagnitude,
@@ -293,6 +310,122 @@ void Wind::Update(GameParameters const & gameParameters)
         mCurrentWindSpeed);
 }
 
+void Wind::GetWindForceMultipliersAt(
+    vec2f const * restrict positions,
+    float * restrict multipliers,
+    size_t count) const
+{
+    assert(HasWindField());
+
+    //
+    // Four points at a time: the sample indices and the interpolation
+    // are vectorized, while the samples are fetched one by one
+    //
+
+    __m128 const halfMaxWorldWidth = _mm_set1_ps(GameParameters::HalfMaxWorldWidth);
+    __m128 const fieldDx = _mm_set1_ps(FieldDx);
+
+    alignas(16) int32_t sampleIndices[4];
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // x0 y0 x1 y1, x2 y2 x3 y3
+        __m128 const positions01 = _mm_loadu_ps(reinterpret_cast<float const *>(positions + i));
+        __m128 const positions23 = _mm_loadu_ps(reinterpret_cast<float const *>(positions + i + 2));
+        __m128 const x = _mm_shuffle_ps(positions01, positions23, _MM_SHUFFLE(2, 0, 2, 0));
+
+        // Fractional index in the field
+        __m128 const sampleIndexF = _mm_div_ps(_mm_add_ps(x, halfMaxWorldWidth), fieldDx);
+
+        // Integral part
+        __m128i const sampleIndexI = _mm_cvttps_epi32(sampleIndexF);
+
+        // Fractional part within sample index and the next sample index
+        __m128 const sampleIndexDx = _mm_sub_ps(sampleIndexF, _mm_cvtepi32_ps(sampleIndexI));
+
+        _mm_store_si128(reinterpret_cast<__m128i *>(sampleIndices), sampleIndexI);
+
+        assert(sampleIndices[0] >= 0 && sampleIndices[0] <= FieldSamplesCount);
+        assert(sampleIndices[1] >= 0 && sampleIndices[1] <= FieldSamplesCount);
+        assert(sampleIndices[2] >= 0 && sampleIndices[2] <= FieldSamplesCount);
+        assert(sampleIndices[3] >= 0 && sampleIndices[3] <= FieldSamplesCount);
+
+        __m128 const sampleValue = _mm_set_ps(
+            mWindForceMultiplierField[sampleIndices[3]],
+            mWindForceMultiplierField[sampleIndices[2]],
+            mWindForceMultiplierField[sampleIndices[1]],
+            mWindForceMultiplierField[sampleIndices[0]]);
+
+        __m128 const nextSampleValue = _mm_set_ps(
+            mWindForceMultiplierField[sampleIndices[3] + 1],
+            mWindForceMultiplierField[sampleIndices[2] + 1],
+            mWindForceMultiplierField[sampleIndices[1] + 1],
+            mWindForceMultiplierField[sampleIndices[0] + 1]);
+
+        _mm_storeu_ps(
+            multipliers + i,
+            _mm_add_ps(sampleValue, _mm_mul_ps(_mm_sub_ps(nextSampleValue, sampleValue), sampleIndexDx)));
+    }
+
+    // Remainder
+    for (; i < count; ++i)
+    {
+        multipliers[i] = GetWindForceMultiplierAt(positions[i].x);
+    }
+}
+
+void Wind::UpdateWindField()
+{
+    //
+    // The gust fronts travel downwind at the current wind speed
+    //
+
+    float constexpr KmhToMs = 1000.0f / 3600.0f;
+
+    mGustFrontsTravel = std::fmod(
+        mGustFrontsTravel + mCurrentWindSpeed.x * KmhToMs * GameParameters::SimulationStepTimeDuration<float>,
+        GustFrontsPeriod);
+
+    //
+    // Calculate the modulation at each sample, four samples at a time:
+    //
+    //  m(x) = 1 + V * (0.6 * cos(k1 * (x - travel)) + 0.4 * cos(k2 * (x - travel) + phase2))
+    //
+    // With V <= 1, m is never negative; we store m^2, as the wind force goes
+    // with the square of the wind speed
+    //
+
+    static_assert((FieldSamplesCount % 4) == 0);
+
+    __m128 const fieldDx = _mm_set1_ps(FieldDx);
+    __m128 const firstX = _mm_set1_ps(-GameParameters::HalfMaxWorldWidth - mGustFrontsTravel);
+    __m128 const k1 = _mm_set1_ps(2.0f * Pi<float> / GustFrontWavelength1);
+    __m128 const k2 = _mm_set1_ps(2.0f * Pi<float> / GustFrontWavelength2);
+    __m128 const phase2 = _mm_set1_ps(1.7f);
+    __m128 const amplitude1 = _mm_set1_ps(0.6f * mCurrentSpatialVariationParameter);
+    __m128 const amplitude2 = _mm_set1_ps(0.4f * mCurrentSpatialVariationParameter);
+    __m128 const one = _mm_set1_ps(1.0f);
+
+    // We also calculate the extra sample, hence the padding
+    for (int64_t i = 0; i <= FieldSamplesCount; i += 4)
+    {
+        __m128 const x = _mm_add_ps(
+            firstX,
+            _mm_mul_ps(
+                _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(static_cast<int32_t>(i)), _mm_set_epi32(3, 2, 1, 0))),
+                fieldDx));
+
+        __m128 const modulation = _mm_add_ps(
+            one,
+            _mm_add_ps(
+                _mm_mul_ps(amplitude1, FastCos4(_mm_mul_ps(k1, x))),
+                _mm_mul_ps(amplitude2, FastCos4(_mm_add_ps(_mm_mul_ps(k2, x), phase2)))));
+
+        _mm_storeu_ps(&(mWindForceMultiplierField[i]), _mm_mul_ps(modulation, modulation));
+    }
+}
+
 GameWallClock::duration Wind::ChooseDuration(float minSeconds, float maxSeconds)
 {
     float chosenSeconds = GameRandomEngine::GetInstance().GenerateRandomReal(minSeconds, maxSeconds);
@@ -13,6 +13,11 @@
 #include <GameCore/GameMath.h>
 #include <GameCore/GameWallClock.h>
 #include <GameCore/RunningAverage.h>
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/Vectors.h>
+
+#include <cassert>
+#include <memory>
 
 namespace Physics
 {
@@ -55,8 +60,49 @@ public:
         return mCurrentWindSpeed;
     }
 
+    /*
+     * Tells whether the wind varies along the world, in which case the wind force
+     * at each position is the force of the current wind speed times the field's
+     * multiplier at that position.
+     */
+    bool HasWindField() const
+    {
+        return mCurrentSpatialVariationParameter != 0.0f;
+    }
+
+    float GetWindForceMultiplierAt(float x) const
+    {
+        assert(HasWindField());
+
+        // Fractional index in the field
+        float const sampleIndexF = (x + GameParameters::HalfMaxWorldWidth) / FieldDx;
+
+        // Integral part
+        int64_t const sampleIndexI = FastTruncateInt64(sampleIndexF);
+
+        // Fractional part within sample index and the next sample index
+        float const sampleIndexDx = sampleIndexF - sampleIndexI;
+
+        assert(sampleIndexI >= 0 && sampleIndexI <= FieldSamplesCount);
+        assert(sampleIndexDx >= 0.0f && sampleIndexDx <= 1.0f);
+
+        return mWindForceMultiplierField[sampleIndexI]
+            + (mWindForceMultiplierField[sampleIndexI + 1] - mWindForceMultiplierField[sampleIndexI]) * sampleIndexDx;
+    }
+
+    /*
+     * Batch version of GetWindForceMultiplierAt(), sampling the field at the x
+     * of each of the specified positions.
+     */
+    void GetWindForceMultipliersAt(
+        vec2f const * restrict positions,
+        float * restrict multipliers,
+        size_t count) const;
+
 private:
 
+    void UpdateWindField();
+
     static GameWallClock::duration ChooseDuration(float minSeconds, float maxSeconds);
 
     void RecalculateParameters(GameParameters const & gameParameters);
@@ -133,6 +179,29 @@ private:
 
     // The current wind speed
     vec2f mCurrentWindSpeed;
+
+    //
+    // Wind field
+    //
+    // The wind speed along the world is the current speed modulated by the gust
+    // fronts, a pattern travelling downwind; the field stores the square of the
+    // modulation at each sample, i.e. the multiplier of the wind force
+    //
+
+    // The number of field samples for the entire world width, a multiple of 4
+    static constexpr int64_t FieldSamplesCount = 512;
+
+    // The x step of the field samples
+    static constexpr float FieldDx = GameParameters::MaxWorldWidth / static_cast<float>(FieldSamplesCount);
+
+    // The wind force multipliers (plus 1 to account for x==MaxWorldWidth, plus
+    // padding to calculate them four at a time)
+    std::unique_ptr<float[]> const mWindForceMultiplierField;
+
+    // How far the gust fronts have travelled, modulo their period
+    float mGustFrontsTravel;
+
+    float mCurrentSpatialVariationParameter;
 };
 
 }
@@ -7,10 +7,17 @@
 
 #include "ShipBuilder.h"
 
+#include <GameCore/BinaryFileTools.h>
+#include <GameCore/GameException.h>
 #include <GameCore/GameRandomEngine.h>
+#include <GameCore/TaskThreadPool.h>
+#include <GameCore/TraceLog.h>
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
 
 namespace Physics {
 
@@ -21,36 +28,50 @@ World::World(
     : mAllShips()
     , mStars()
     , mClouds()
-    , mWaterSurface()
+    , mWaterSurface(gameParameters)
     , mOceanFloor(resourceLoader)
     , mWind(gameEventHandler)
     , mCurrentSimulationTime(0.0f)
+    , mLastUpdateTimings()
     , mGameEventHandler(std::move(gameEventHandler))
+    , mShipGameEventHandlers()
+    , mShipRandomEngines()
+    , mShipCollisionCandidates()
+    , mActiveShipCollisionCandidates()
 {
     // Initialize world pieces
     mStars.Update(gameParameters);
     mWind.Update(gameParameters);
     mClouds.Update(mCurrentSimulationTime, gameParameters);
-    mWaterSurface.Update(mCurrentSimulationTime, mWind, gameParameters);
+    mWaterSurface.Update(
+        mCurrentSimulationTime,
+        mWind,
+        -GameParameters::HalfMaxWorldWidth,
+        GameParameters::HalfMaxWorldWidth,
+        gameParameters);
     mOceanFloor.Update(gameParameters);
 }
 
 ShipId World::AddShip(
-    ShipDefinition const & shipDefinition,
+    ShipDefinition & shipDefinition,
     MaterialDatabase const & materialDatabase,
     GameParameters const & gameParameters)
 {
     ShipId shipId = static_cast<ShipId>(mAllShips.size());
 
+    auto shipGameEventHandler = std::make_shared<BufferedGameEventHandler>(mGameEventHandler);
+
     auto ship = ShipBuilder::Create(
         shipId,
         *this,
-        mGameEventHandler,
+        shipGameEventHandler,
         shipDefinition,
         materialDatabase,
         gameParameters);
 
     mAllShips.push_back(std::move(ship));
+    mShipGameEventHandlers.push_back(std::move(shipGameEventHandler));
+    mShipRandomEngines.emplace_back(static_cast<unsigned int>(shipId));
 
     return shipId;
 }
@@ -67,6 +88,97 @@ size_t World::GetShipPointCount(ShipId shipId) const
     return mAllShips[shipId]->GetPointCount();
 }
 
+ShipStatistics World::GetShipStatistics() const
+{
+    ShipStatistics shipStatistics;
+
+    for (auto const & ship : mAllShips)
+    {
+        shipStatistics += ship->GetStatistics();
+    }
+
+    return shipStatistics;
+}
+
+ShipPerfStats World::GetShipPerfStats() const
+{
+    ShipPerfStats shipPerfStats;
+
+    for (auto const & ship : mAllShips)
+    {
+        shipPerfStats += ship->GetPerfStats();
+    }
+
+    return shipPerfStats;
+}
+
+void World::ReportMemory(MemoryReport & report) const
+{
+    for (auto const & ship : mAllShips)
+    {
+        ship->ReportMemory(report);
+    }
+}
+
+bool World::HasPendingMaintenance(GameParameters const & gameParameters) const
+{
+    for (auto const & ship : mAllShips)
+    {
+        if (ship->HasPendingMaintenance(gameParameters))
+            return true;
+    }
+
+    return false;
+}
+
+void World::RunMaintenance(GameParameters const & gameParameters)
+{
+    for (auto & ship : mAllShips)
+    {
+        if (ship->HasPendingMaintenance(gameParameters))
+        {
+            ship->RunMaintenance(gameParameters);
+            return;
+        }
+    }
+}
+
+void World::SaveState(std::ostream & stream) const
+{
+    static_assert(std::is_trivially_copyable_v<GameRandomEngine>);
+
+    BinaryFileTools::Write<float>(stream, mCurrentSimulationTime);
+
+    BinaryFileTools::WriteArray(stream, &(GameRandomEngine::GetInstance()), 1);
+
+    BinaryFileTools::Write<std::uint32_t>(stream, static_cast<std::uint32_t>(mAllShips.size()));
+    for (size_t s = 0; s < mAllShips.size(); ++s)
+    {
+        BinaryFileTools::WriteArray(stream, &(mShipRandomEngines[s]), 1);
+        mAllShips[s]->SaveState(stream);
+    }
+}
+
+void World::LoadState(
+    std::istream & stream,
+    GameParameters const & gameParameters)
+{
+    mCurrentSimulationTime = BinaryFileTools::Read<float>(stream);
+
+    BinaryFileTools::ReadArray(stream, &(GameRandomEngine::GetInstance()), 1);
+
+    if (BinaryFileTools::Read<std::uint32_t>(stream) != mAllShips.size())
+    {
+        throw GameException("The snapshot does not match the ships in the world");
+    }
+
+    for (size_t s = 0; s < mAllShips.size(); ++s)
+    {
+        BinaryFileTools::ReadArray(stream, &(mShipRandomEngines[s]), 1);
+        mAllShips[s]->LoadState(stream, gameParameters);
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Interactions
 //////////////////////////////////////////////////////////////////////////////
@@ -390,8 +502,11 @@ void World::QueryNearestPointAt(
 
 void World::Update(
     GameParameters const & gameParameters,
-    Render::RenderContext const & renderContext)
+    float averageUpdateDurationMillis,
+    SimulationView const & simulationView)
 {
+    auto const startTime = std::chrono::steady_clock::now();
+
     // Update current time
     mCurrentSimulationTime += GameParameters::SimulationStepTimeDuration<float>;
 
@@ -399,21 +514,65 @@ void World::Update(
     mStars.Update(gameParameters);
     mWind.Update(gameParameters);
     mClouds.Update(mCurrentSimulationTime, gameParameters);
-    mWaterSurface.Update(mCurrentSimulationTime, mWind, gameParameters);
+    UpdateWaterSurface(gameParameters, simulationView);
     mOceanFloor.Update(gameParameters);
 
-    // Update all ships
-    for (auto & ship : mAllShips)
+    auto const worldPartsEndTime = std::chrono::steady_clock::now();
+
+    // Update all ships; GPU calculators are bound to the thread that creates them,
+    // hence using them requires updating ships on the main thread
+    if (gameParameters.DoParallelizeShipUpdates
+        && !gameParameters.DoUseGPUWaterDiffusion
+        && !gameParameters.DoUseGPUMechanicalDynamics
+        && mAllShips.size() > 1)
     {
-        ship->Update(
-            mCurrentSimulationTime,
+        UpdateShipsParallel(
             gameParameters,
-            renderContext);
+            averageUpdateDurationMillis,
+            simulationView);
+    }
+    else
+    {
+        for (auto & ship : mAllShips)
+        {
+            ship->Update(
+                mCurrentSimulationTime,
+                gameParameters,
+                averageUpdateDurationMillis,
+                simulationView);
+        }
     }
+
+    // Now that no ship is running, let the ships push on the ocean surface
+    for (auto & ship : mAllShips)
+    {
+        ship->FlushOceanSurfaceDisplacements();
+    }
+
+    auto const shipsEndTime = std::chrono::steady_clock::now();
+
+    // Ships collide with each other only once they have all moved
+    if (gameParameters.DoHandleShipCollisions)
+    {
+        HandleShipCollisions();
+    }
+
+    auto const endTime = std::chrono::steady_clock::now();
+
+    mLastUpdateTimings.WorldParts = worldPartsEndTime - startTime;
+    mLastUpdateTimings.Ships = shipsEndTime - worldPartsEndTime;
+    mLastUpdateTimings.ShipCollisions = endTime - shipsEndTime;
+
+#ifdef ENABLE_PERF_STATS
+    TraceLog::GetInstance().AddEvent("WorldParts", "world", startTime, mLastUpdateTimings.WorldParts);
+    TraceLog::GetInstance().AddEvent("Ships", "world", worldPartsEndTime, mLastUpdateTimings.Ships);
+    TraceLog::GetInstance().AddEvent("ShipCollisions", "world", shipsEndTime, mLastUpdateTimings.ShipCollisions);
+#endif
 }
 
 void World::Render(
     GameParameters const & gameParameters,
+    float renderInterpolationFactor,
     Render::RenderContext & renderContext) const
 {
     //
@@ -460,12 +619,20 @@ void World::Render(
     {
         ship->Render(
             gameParameters,
+            renderInterpolationFactor,
             renderContext);
     }
 
     renderContext.RenderShipsEnd();
 
 
+    //
+    // Render the ephemeral particles simulated on the GPU
+    //
+
+    renderContext.RenderEphemeralParticles(mCurrentSimulationTime);
+
+
     //
     // Render the ocean now, if we want to see the ship *in* the ocean instead
     //
@@ -487,4 +654,221 @@ void World::Render(
 // Private Helpers
 ///////////////////////////////////////////////////////////////////////////////////
 
+void World::UpdateWaterSurface(
+    GameParameters const & gameParameters,
+    SimulationView const & simulationView)
+{
+    // Take some room for the points that move during this step; the surface
+    // is anyway calculated on demand where it's not been evaluated
+    static constexpr float RegionOfInterestMargin = 10.0f;
+
+    //
+    // The surface is queried by the ships and rendered for the visible world,
+    // hence we only need it over the union of the two
+    //
+
+    float regionOfInterestLeft = simulationView.VisibleWorldLeft;
+    float regionOfInterestRight = simulationView.VisibleWorldRight;
+
+    for (auto const & ship : mAllShips)
+    {
+        auto const shipAABB = ship->CalculateAABB();
+        regionOfInterestLeft = std::min(regionOfInterestLeft, shipAABB.BottomLeft.x);
+        regionOfInterestRight = std::max(regionOfInterestRight, shipAABB.TopRight.x);
+    }
+
+    mWaterSurface.Update(
+        mCurrentSimulationTime,
+        mWind,
+        regionOfInterestLeft - RegionOfInterestMargin,
+        regionOfInterestRight + RegionOfInterestMargin,
+        gameParameters);
+}
+
+void World::UpdateShipsParallel(
+    GameParameters const & gameParameters,
+    float averageUpdateDurationMillis,
+    SimulationView const & simulationView)
+{
+    //
+    // Ships only share the world parts, which they just read; the events they fire
+    // are buffered per-ship and then forwarded in ship ID order, so that the order
+    // in which they reach our handler does not depend on thread scheduling.
+    //
+    // Spring force tasks submitted by the ships while updating are run inline.
+    //
+
+    //
+    // Ships are batched into no more tasks than threads, balanced by their point
+    // counts: many small ships then share a task rather than paying for one each,
+    // and the largest ships are spread across threads first. Ships own their state,
+    // hence the batching does not change the outcome of their updates.
+    //
+
+    size_t const taskCount = std::min(
+        TaskThreadPool::GetInstance().GetParallelism(),
+        mAllShips.size());
+
+    std::vector<size_t> shipsBySize(mAllShips.size());
+    std::iota(shipsBySize.begin(), shipsBySize.end(), size_t(0));
+    std::stable_sort(
+        shipsBySize.begin(),
+        shipsBySize.end(),
+        [this](size_t a, size_t b)
+        {
+            return mAllShips[a]->GetPointCount() > mAllShips[b]->GetPointCount();
+        });
+
+    std::vector<std::vector<size_t>> taskShips(taskCount);
+    std::vector<size_t> taskPointCounts(taskCount, 0);
+    for (size_t s : shipsBySize)
+    {
+        size_t const t = std::distance(
+            taskPointCounts.cbegin(),
+            std::min_element(taskPointCounts.cbegin(), taskPointCounts.cend()));
+
+        taskShips[t].push_back(s);
+        taskPointCounts[t] += mAllShips[s]->GetPointCount();
+    }
+
+    for (auto & shipGameEventHandler : mShipGameEventHandlers)
+    {
+        shipGameEventHandler->BeginBuffering();
+    }
+
+    std::vector<TaskThreadPool::Task> tasks;
+    tasks.reserve(taskCount);
+
+    for (auto const & ships : taskShips)
+    {
+        tasks.emplace_back(
+            [this, &ships, &gameParameters, averageUpdateDurationMillis, &simulationView]()
+            {
+                for (size_t s : ships)
+                {
+                    // Draw from this ship's own random sequence
+                    GameRandomEngine::ThreadEngineScope randomEngineScope(mShipRandomEngines[s]);
+
+                    mAllShips[s]->Update(
+                        mCurrentSimulationTime,
+                        gameParameters,
+                        averageUpdateDurationMillis,
+                        simulationView);
+                }
+            });
+    }
+
+    try
+    {
+        TaskThreadPool::GetInstance().Run(tasks);
+    }
+    catch (...)
+    {
+        for (auto & shipGameEventHandler : mShipGameEventHandlers)
+        {
+            shipGameEventHandler->Flush();
+        }
+
+        throw;
+    }
+
+    // Forward the ships' events, in ship ID order
+    for (auto & shipGameEventHandler : mShipGameEventHandlers)
+    {
+        shipGameEventHandler->Flush();
+    }
+}
+
+void World::HandleShipCollisions()
+{
+    // The margin by which the bounding boxes of the connected components are grown, so
+    // that points about to penetrate a component are caught in the broad phase
+    static constexpr float ConnectedComponentAABBMargin = 0.5f;
+
+    //
+    // Broad phase: sweep-and-prune along x of the bounding boxes of the connected
+    // components of all ships; these move little between steps, hence the sort
+    // is nearly linear. Pieces of the same ship collide with each other too.
+    //
+
+    mShipCollisionCandidates.clear();
+    for (auto & ship : mAllShips)
+    {
+        auto const & componentAABBs = ship->GetConnectedComponentAABBs();
+        for (size_t c = 0; c < componentAABBs.size(); ++c)
+        {
+            // Skip components without points
+            if (componentAABBs[c].BottomLeft.x > componentAABBs[c].TopRight.x)
+                continue;
+
+            mShipCollisionCandidates.push_back({
+                ship.get(),
+                static_cast<ConnectedComponentId>(c),
+                Geometry::AABB(
+                    componentAABBs[c].TopRight + vec2f(ConnectedComponentAABBMargin, ConnectedComponentAABBMargin),
+                    componentAABBs[c].BottomLeft - vec2f(ConnectedComponentAABBMargin, ConnectedComponentAABBMargin)) });
+        }
+    }
+
+    if (mShipCollisionCandidates.size() < 2)
+        return;
+
+    std::sort(
+        mShipCollisionCandidates.begin(),
+        mShipCollisionCandidates.end(),
+        [](ShipCollisionCandidate const & a, ShipCollisionCandidate const & b)
+        {
+            return a.Box.BottomLeft.x < b.Box.BottomLeft.x;
+        });
+
+    mActiveShipCollisionCandidates.clear();
+    for (auto const & candidate : mShipCollisionCandidates)
+    {
+        Geometry::AABB const & box = candidate.Box;
+
+        // Retire the candidates that end before this one starts
+        mActiveShipCollisionCandidates.erase(
+            std::remove_if(
+                mActiveShipCollisionCandidates.begin(),
+                mActiveShipCollisionCandidates.end(),
+                [&box](ShipCollisionCandidate const * active)
+                {
+                    return active->Box.TopRight.x < box.BottomLeft.x;
+                }),
+            mActiveShipCollisionCandidates.end());
+
+        for (auto const * active : mActiveShipCollisionCandidates)
+        {
+            Geometry::AABB const & activeBox = active->Box;
+
+            if (activeBox.TopRight.y < box.BottomLeft.y || activeBox.BottomLeft.y > box.TopRight.y)
+                continue;
+
+            Geometry::AABB const overlap(
+                std::max(activeBox.BottomLeft.x, box.BottomLeft.x),
+                std::min(activeBox.TopRight.x, box.TopRight.x),
+                std::min(activeBox.TopRight.y, box.TopRight.y),
+                std::max(activeBox.BottomLeft.y, box.BottomLeft.y));
+
+            //
+            // Narrow phase: each side's points against the other side's triangles
+            //
+
+            active->ShipPtr->CollideWith(
+                active->ComponentId,
+                *(candidate.ShipPtr),
+                candidate.ComponentId,
+                overlap);
+
+            candidate.ShipPtr->CollideWith(
+                candidate.ComponentId,
+                *(active->ShipPtr),
+                active->ComponentId,
+                overlap);
+        }
+
+        mActiveShipCollisionCandidates.push_back(&candidate);
+    }
+}
+
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
  ***************************************************************************************/
 #pragma once
 
+#include "BufferedGameEventHandler.h"
 #include "GameParameters.h"
 #include "IGameEventHandler.h"
 #include "MaterialDatabase.h"
@@ -12,12 +13,20 @@
 #include "RenderContext.h"
 #include "ResourceLoader.h"
 #include "ShipDefinition.h"
+#include "ShipPerfStats.h"
+#include "ShipStatistics.h"
+#include "SimulationView.h"
 
 #include <GameCore/AABB.h>
+#include <GameCore/GameRandomEngine.h>
+#include <GameCore/MemoryReport.h>
 #include <GameCore/Vectors.h>
 
+#include <chrono>
 #include <cstdint>
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <set>
 #include <vector>
 
@@ -33,8 +42,11 @@ public:
         GameParameters const & gameParameters,
         ResourceLoader & resourceLoader);
 
+    /*
+     * Consumes the structural layers of the definition - see ShipBuilder::Create().
+     */
     ShipId AddShip(
-        ShipDefinition const & shipDefinition,
+        ShipDefinition & shipDefinition,
         MaterialDatabase const & materialDatabase,
         GameParameters const & gameParameters);
 
@@ -42,11 +54,51 @@ public:
 
     size_t GetShipPointCount(ShipId shipId) const;
 
+    /*
+     * Gets the statistics of all ships, summed up.
+     */
+    ShipStatistics GetShipStatistics() const;
+
+    ShipPerfStats GetShipPerfStats() const;
+
+    void ReportMemory(MemoryReport & report) const;
+
+    /*
+     * Whether any ship has maintenance pending - see Ship::HasPendingMaintenance().
+     */
+    bool HasPendingMaintenance(GameParameters const & gameParameters) const;
+
+    /*
+     * Runs one piece of the pending maintenance of one ship, if any.
+     */
+    void RunMaintenance(GameParameters const & gameParameters);
+
+    /*
+     * Writes the dynamic state of the world - simulation time, random engines, and ships -
+     * for snapshots; the state may only be loaded back into a world with the same ships,
+     * freshly built from the same definitions.
+     */
+    void SaveState(std::ostream & stream) const;
+    void LoadState(
+        std::istream & stream,
+        GameParameters const & gameParameters);
+
     inline float GetWaterHeightAt(float x) const
     {
         return mWaterSurface.GetWaterHeightAt(x);
     }
 
+    /*
+     * Pushes the ocean surface at the specified x; not to be invoked
+     * while ships are being updated, as the latter may run in parallel.
+     */
+    inline void DisplaceOceanSurfaceAt(
+        float x,
+        float displacement)
+    {
+        mWaterSurface.DisplaceAt(x, displacement);
+    }
+
     inline bool IsUnderwater(vec2f const & position) const
     {
         return position.y < GetWaterHeightAt(position.x);
@@ -57,11 +109,52 @@ public:
         return mOceanFloor.GetFloorHeightAt(x);
     }
 
+    inline void GetWaterHeightsAt(
+        vec2f const * restrict positions,
+        float * restrict heights,
+        size_t count) const
+    {
+        mWaterSurface.GetWaterHeightsAt(positions, heights, count);
+    }
+
+    inline void GetOceanFloorHeightsAt(
+        vec2f const * restrict positions,
+        float * restrict heights,
+        size_t count) const
+    {
+        mOceanFloor.GetFloorHeightsAt(positions, heights, count);
+    }
+
+    inline float GetMaxOceanFloorHeightIn(
+        float left,
+        float right) const
+    {
+        return mOceanFloor.GetMaxFloorHeightIn(left, right);
+    }
+
     inline vec2f const & GetCurrentWindSpeed() const
     {
         return mWind.GetCurrentWindSpeed();
     }
 
+    inline bool HasWindField() const
+    {
+        return mWind.HasWindField();
+    }
+
+    inline float GetWindForceMultiplierAt(float x) const
+    {
+        return mWind.GetWindForceMultiplierAt(x);
+    }
+
+    inline void GetWindForceMultipliersAt(
+        vec2f const * restrict positions,
+        float * restrict multipliers,
+        size_t count) const
+    {
+        mWind.GetWindForceMultipliersAt(positions, multipliers, count);
+    }
+
     void MoveBy(
         ShipId shipId,
         vec2f const & offset,
@@ -150,14 +243,55 @@ public:
         vec2f const & targetPos,
         float radius) const;
 
+    /*
+     * The average update duration is the one measured by the caller over the
+     * last updates, and is used by ships to choose their number of mechanical
+     * iterations when adaptive.
+     */
     void Update(
         GameParameters const & gameParameters,
-        Render::RenderContext const & renderContext);
+        float averageUpdateDurationMillis,
+        SimulationView const & simulationView);
+
+    /*
+     * How long the phases of the last update took.
+     */
+    struct UpdateTimings
+    {
+        std::chrono::steady_clock::duration WorldParts; // Sky, wind, water surface, ocean floor
+        std::chrono::steady_clock::duration Ships;
+        std::chrono::steady_clock::duration ShipCollisions;
+
+        UpdateTimings()
+            : WorldParts(0)
+            , Ships(0)
+            , ShipCollisions(0)
+        {}
+    };
+
+    UpdateTimings const & GetLastUpdateTimings() const
+    {
+        return mLastUpdateTimings;
+    }
 
     void Render(
         GameParameters const & gameParameters,
+        float renderInterpolationFactor,
         Render::RenderContext & renderContext) const;
 
+private:
+
+    void UpdateWaterSurface(
+        GameParameters const & gameParameters,
+        SimulationView const & simulationView);
+
+    void UpdateShipsParallel(
+        GameParameters const & gameParameters,
+        float averageUpdateDurationMillis,
+        SimulationView const & simulationView);
+
+    void HandleShipCollisions();
+
 private:
 
     // Repository
@@ -171,8 +305,31 @@ private:
     // The current simulation time
     float mCurrentSimulationTime;
 
+    UpdateTimings mLastUpdateTimings;
+
     // The game event handler
     std::shared_ptr<IGameEventHandler> mGameEventHandler;
+
+    // The game event handlers of the ships, in front of ours, so that ships
+    // updated concurrently may buffer their events; indexed by ship ID
+    std::vector<std::shared_ptr<BufferedGameEventHandler>> mShipGameEventHandlers;
+
+    // The random engines of the ships, installed while ships are updated
+    // concurrently; indexed by ship ID
+    std::vector<GameRandomEngine> mShipRandomEngines;
+
+    // The grown bounding boxes of the connected components of all ships, sorted
+    // by their left edge for the broad phase of ship collisions; kept here to
+    // avoid re-allocating them at each step
+    struct ShipCollisionCandidate
+    {
+        Ship * ShipPtr;
+        ConnectedComponentId ComponentId;
+        Geometry::AABB Box;
+    };
+
+    std::vector<ShipCollisionCandidate> mShipCollisionCandidates;
+    std::vector<ShipCollisionCandidate const *> mActiveShipCollisionCandidates;
 };
 
 }
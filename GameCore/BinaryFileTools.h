@@ -0,0 +1,130 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-02
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "GameException.h"
+#include "ImageData.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+
+/*
+ * Helpers for our own binary cache files. Values are stored in native byte order,
+ * as these files never leave the machine that wrote them.
+ */
+struct BinaryFileTools
+{
+    template<typename T>
+    static void Write(std::ostream & file, T const & value)
+    {
+        file.write(reinterpret_cast<char const *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static T Read(std::istream & file)
+    {
+        T value{};
+        file.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    static void WriteArray(std::ostream & file, T const * data, size_t count)
+    {
+        file.write(reinterpret_cast<char const *>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    }
+
+    template<typename T>
+    static void ReadArray(std::istream & file, T * data, size_t count)
+    {
+        file.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    }
+
+    static void WriteString(std::ostream & file, std::string const & value)
+    {
+        Write<std::uint32_t>(file, static_cast<std::uint32_t>(value.size()));
+        file.write(value.data(), value.size());
+    }
+
+    static std::string ReadString(std::istream & file)
+    {
+        std::uint32_t const size = Read<std::uint32_t>(file);
+        if (!file.good())
+            return std::string();
+
+        std::string value(size, '\0');
+        file.read(value.data(), size);
+        return value;
+    }
+
+    static void WriteOptionalString(std::ostream & file, std::optional<std::string> const & value)
+    {
+        Write<std::uint8_t>(file, !!value ? 1 : 0);
+        if (!!value)
+            WriteString(file, *value);
+    }
+
+    static std::optional<std::string> ReadOptionalString(std::istream & file)
+    {
+        if (Read<std::uint8_t>(file) == 0)
+            return std::nullopt;
+
+        return ReadString(file);
+    }
+
+    template<typename TColor>
+    static void WriteImage(std::ostream & file, ImageData<TColor> const & image)
+    {
+        Write<std::int32_t>(file, image.Size.Width);
+        Write<std::int32_t>(file, image.Size.Height);
+        file.write(
+            reinterpret_cast<char const *>(image.Data.get()),
+            static_cast<std::streamsize>(image.Size.Width) * image.Size.Height * sizeof(TColor));
+    }
+
+    template<typename TColor>
+    static ImageData<TColor> ReadImage(std::istream & file)
+    {
+        int const width = Read<std::int32_t>(file);
+        int const height = Read<std::int32_t>(file);
+        if (!file.good() || width < 0 || height < 0)
+        {
+            throw GameException("Invalid image in binary file");
+        }
+
+        size_t const pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+        auto data = std::make_unique<TColor[]>(pixelCount);
+        file.read(
+            reinterpret_cast<char *>(data.get()),
+            static_cast<std::streamsize>(pixelCount * sizeof(TColor)));
+
+        return ImageData<TColor>(width, height, std::move(data));
+    }
+
+    /*
+     * 64-bit FNV-1a; as opposed to std::hash, the same across builds.
+     */
+    static constexpr std::uint64_t HashSeed = 14695981039346656037ull;
+
+    static std::uint64_t Hash(
+        void const * data,
+        size_t size,
+        std::uint64_t hash = HashSeed)
+    {
+        auto const * bytes = static_cast<std::uint8_t const *>(data);
+        for (size_t b = 0; b < size; ++b)
+        {
+            hash ^= bytes[b];
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+};
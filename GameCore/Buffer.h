@@ -5,19 +5,24 @@
 ***************************************************************************************/
 #pragma once
 
+#include "BufferBlock.h"
+#include "BulkStorageRecycler.h"
 #include "GameMath.h"
 #include "SysSpecifics.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
 #include <stdexcept>
+#include <utility>
 
 /*
 * This class implements a simple buffer of "things". The buffer is fixed-size and cannot
 * grow more than the size that it is initially constructed with.
 *
-* The buffer is mem-aligned and takes care of deallocating itself at destruction time.
+* The buffer is aligned to at least the cache line and takes care of deallocating itself
+* at destruction time - unless its storage comes from a BufferBlock, which then owns it.
 * The number of elements is assumed to be rounded to a multiple of the word size.
 */
 template <typename TElement>
@@ -28,13 +33,26 @@ public:
     Buffer(size_t size)
         : mSize(size)
         , mCurrentPopulatedSize(0)
+        , mIsOwner(true)
     {
         assert(make_aligned_element_count(size) == size);
 
-        mBuffer = static_cast<TElement *>(aligned_alloc(CeilPowerOfTwo(sizeof(TElement)), size * sizeof(TElement)));
+        mBuffer = static_cast<TElement *>(BulkStorageRecycler::GetInstance().Acquire(alignof(TElement), size * sizeof(TElement)));
         assert(nullptr != mBuffer);
     }
 
+    Buffer(
+        size_t size,
+        BufferBlock & block)
+        : mSize(size)
+        , mCurrentPopulatedSize(0)
+        , mIsOwner(false)
+    {
+        assert(make_aligned_element_count(size) == size);
+
+        mBuffer = block.Allocate<TElement>(size);
+    }
+
     Buffer(
         size_t size,
         size_t fillStart,
@@ -44,26 +62,50 @@ public:
         assert(fillStart <= mSize);
 
         // Fill-in values
-        for (size_t i = fillStart; i < mSize; ++i)
-            mBuffer[i] = fillValue;
+        std::fill(mBuffer + fillStart, mBuffer + mSize, fillValue);
+    }
+
+    Buffer(
+        size_t size,
+        size_t fillStart,
+        TElement fillValue,
+        BufferBlock & block)
+        : Buffer(size, block)
+    {
+        assert(fillStart <= mSize);
+
+        // Fill-in values
+        std::fill(mBuffer + fillStart, mBuffer + mSize, fillValue);
     }
 
     Buffer(Buffer && other)
         : mBuffer(other.mBuffer)
         , mSize(other.mSize)
         , mCurrentPopulatedSize(other.mCurrentPopulatedSize)
+        , mIsOwner(other.mIsOwner)
     {
         other.mBuffer = nullptr;
     }
 
     ~Buffer()
     {
-        if (nullptr != mBuffer)
+        if (nullptr != mBuffer && mIsOwner)
         {
-            aligned_free(reinterpret_cast<void *>(mBuffer));
+            BulkStorageRecycler::GetInstance().Release(
+                reinterpret_cast<void *>(mBuffer),
+                alignof(TElement),
+                mSize * sizeof(TElement));
         }
     }
 
+    /*
+     * Gets the number of bytes the buffer holds on to.
+     */
+    size_t GetByteSize() const
+    {
+        return mSize * sizeof(TElement);
+    }
+
     /*
      * Gets the current number of elements populated in the buffer via emplace_back();
      * less than or equal the declared buffer size.
@@ -96,8 +138,21 @@ public:
      */
     void fill(TElement value)
     {
-        for (size_t i = 0; i < mSize; ++i)
-            mBuffer[i] = value;
+        std::fill(mBuffer, mBuffer + mSize, value);
+    }
+
+    /*
+     * Swaps the contents of this buffer with those of another buffer, without copying.
+     *
+     * The sizes of the buffers must match.
+     */
+    void swap(Buffer<TElement> & other) noexcept
+    {
+        assert(mSize == other.mSize);
+
+        std::swap(mBuffer, other.mBuffer);
+        std::swap(mCurrentPopulatedSize, other.mCurrentPopulatedSize);
+        std::swap(mIsOwner, other.mIsOwner);
     }
 
     /*
@@ -155,4 +210,5 @@ private:
     TElement * restrict mBuffer;
     size_t const mSize;
     size_t mCurrentPopulatedSize;
+    bool mIsOwner;
 };
\ No newline at end of file
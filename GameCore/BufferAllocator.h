@@ -43,6 +43,14 @@ public:
             });
     }
 
+    /*
+     * Gets the number of bytes held by the buffers that are currently not allocated.
+     */
+    size_t GetPooledByteSize() const
+    {
+        return mPool.size() * mBufferSize * sizeof(TElement);
+    }
+
 private:
 
     void Release(Buffer<TElement> * buffer)
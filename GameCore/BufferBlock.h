@@ -0,0 +1,99 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-14
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "BulkStorageRecycler.h"
+#include "SysSpecifics.h"
+
+#include <cassert>
+#include <cstddef>
+
+/*
+ * A single allocation which a few buffers are carved out of, one after the other.
+ *
+ * Meant for the buffers that are walked together by the same loops: they end up
+ * adjacent in memory, and each starts one cache line further into its page than the
+ * previous one, so that the streams of a loop don't evict each other by all landing
+ * on the same cache sets.
+ */
+class BufferBlock
+{
+public:
+
+    static constexpr size_t Alignment = CacheLineSize;
+
+    /*
+     * Gets the space taken in a block by a buffer of the specified number of elements.
+     */
+    template<typename TElement>
+    static constexpr size_t GetRequiredSize(size_t elementCount)
+    {
+        return AlignUp(elementCount * sizeof(TElement)) + Alignment;
+    }
+
+    BufferBlock(size_t size)
+        : mBlock(nullptr)
+        , mSize(AlignUp(size))
+        , mAllocatedSize(0)
+    {
+        mBlock = static_cast<unsigned char *>(BulkStorageRecycler::GetInstance().Acquire(Alignment, mSize));
+        assert(nullptr != mBlock);
+    }
+
+    BufferBlock(BufferBlock && other)
+        : mBlock(other.mBlock)
+        , mSize(other.mSize)
+        , mAllocatedSize(other.mAllocatedSize)
+    {
+        other.mBlock = nullptr;
+    }
+
+    ~BufferBlock()
+    {
+        if (nullptr != mBlock)
+        {
+            BulkStorageRecycler::GetInstance().Release(
+                reinterpret_cast<void *>(mBlock),
+                Alignment,
+                mSize);
+        }
+    }
+
+    BufferBlock(BufferBlock const &) = delete;
+    BufferBlock & operator=(BufferBlock const &) = delete;
+    BufferBlock & operator=(BufferBlock &&) = delete;
+
+    /*
+     * Carves the storage for a buffer out of the block; the storage lives as long
+     * as the block does.
+     */
+    template<typename TElement>
+    TElement * Allocate(size_t elementCount)
+    {
+        static_assert(alignof(TElement) <= Alignment);
+
+        // Skip one cache line after the previous buffer
+        size_t const start = (mAllocatedSize == 0) ? 0 : mAllocatedSize + Alignment;
+        size_t const byteSize = AlignUp(elementCount * sizeof(TElement));
+
+        assert(start + byteSize <= mSize);
+
+        mAllocatedSize = start + byteSize;
+
+        return reinterpret_cast<TElement *>(mBlock + start);
+    }
+
+private:
+
+    static constexpr size_t AlignUp(size_t byteSize)
+    {
+        return (byteSize + Alignment - 1) / Alignment * Alignment;
+    }
+
+    unsigned char * mBlock;
+    size_t const mSize;
+    size_t mAllocatedSize;
+};
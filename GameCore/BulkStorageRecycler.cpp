@@ -0,0 +1,159 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-09
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "BulkStorageRecycler.h"
+
+#include "SysSpecifics.h"
+
+#include <algorithm>
+#include <cassert>
+
+size_t BulkStorageRecycler::GetSizeClass(size_t size)
+{
+    // Storage is at least cache line-granular anyway
+    size_t const alignedSize = std::max(
+        (size + CacheLineSize - 1) / CacheLineSize * CacheLineSize,
+        CacheLineSize);
+
+    if (alignedSize <= MaxExactSizeClass)
+        return alignedSize;
+
+    // Round up to an eighth of the largest power of two not exceeding the size
+    size_t powerOfTwo = MaxExactSizeClass;
+    while (powerOfTwo <= alignedSize / 2)
+        powerOfTwo *= 2;
+
+    size_t const step = powerOfTwo / 8;
+
+    return (alignedSize + step - 1) / step * step;
+}
+
+void * BulkStorageRecycler::Acquire(
+    size_t alignment,
+    size_t size)
+{
+    Key const key = MakeKey(alignment, size);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto it = mRetainedStorage.find(key);
+        if (it != mRetainedStorage.end() && !it->second.empty())
+        {
+            void * const ptr = it->second.back().Ptr;
+            it->second.pop_back();
+
+            assert(mRetainedByteSize >= key.second);
+            mRetainedByteSize -= key.second;
+
+            return ptr;
+        }
+    }
+
+    return aligned_alloc_bulk(key.first, key.second);
+}
+
+void BulkStorageRecycler::Release(
+    void * ptr,
+    size_t alignment,
+    size_t size)
+{
+    assert(nullptr != ptr);
+
+    Key const key = MakeKey(alignment, size);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mCaptureDepth > 0
+            && mRetainedByteSize + key.second <= MaxRetainedByteSize)
+        {
+            mRetainedStorage[key].emplace_back(ptr, std::chrono::steady_clock::now());
+            mRetainedByteSize += key.second;
+
+            return;
+        }
+    }
+
+    aligned_free(ptr);
+}
+
+void BulkStorageRecycler::BeginCapture()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    ++mCaptureDepth;
+}
+
+void BulkStorageRecycler::EndCapture()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    assert(mCaptureDepth > 0);
+    --mCaptureDepth;
+}
+
+void BulkStorageRecycler::Trim()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    FreeRetained(std::chrono::steady_clock::now() - RetentionDuration);
+}
+
+void BulkStorageRecycler::Clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    FreeRetained(std::chrono::steady_clock::time_point::max());
+}
+
+size_t BulkStorageRecycler::GetRetainedByteSize() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    return mRetainedByteSize;
+}
+
+BulkStorageRecycler::Key BulkStorageRecycler::MakeKey(
+    size_t alignment,
+    size_t size)
+{
+    // As aligned_alloc_bulk() would align it
+    return Key(
+        std::max(alignment, CacheLineSize),
+        GetSizeClass(size));
+}
+
+void BulkStorageRecycler::FreeRetained(std::chrono::steady_clock::time_point minReleaseTimestamp)
+{
+    for (auto it = mRetainedStorage.begin(); it != mRetainedStorage.end(); )
+    {
+        auto & storages = it->second;
+
+        // Storage is appended as it's released, hence the oldest comes first
+        auto const firstKept = std::find_if(
+            storages.begin(),
+            storages.end(),
+            [minReleaseTimestamp](RetainedStorage const & storage)
+            {
+                return storage.ReleaseTimestamp >= minReleaseTimestamp;
+            });
+
+        for (auto s = storages.begin(); s != firstKept; ++s)
+        {
+            aligned_free(s->Ptr);
+
+            assert(mRetainedByteSize >= it->first.second);
+            mRetainedByteSize -= it->first.second;
+        }
+
+        storages.erase(storages.begin(), firstKept);
+
+        if (storages.empty())
+            it = mRetainedStorage.erase(it);
+        else
+            ++it;
+    }
+}
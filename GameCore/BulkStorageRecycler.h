@@ -0,0 +1,125 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-09
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*
+ * Keeps the bulk storage of the buffers of a world that is going away, so that the
+ * buffers of the next world - typically, the same ship being reloaded - may take it
+ * over instead of going back to the heap; in the steady state, reloads then don't
+ * allocate at all.
+ *
+ * Storage is only retained while capturing - i.e. while a world is being destroyed -
+ * up to a maximum size, and only for a while: storage that hasn't been taken over
+ * after the retention period is freed at the next trim.
+ *
+ * Storage is keyed by size class: small sizes are their own class, while large sizes
+ * are rounded up to an eighth of their power of two, so that ships that differ slightly
+ * may share each other's storage at the price of a little slack. Storage is always
+ * allocated with the size of its class.
+ *
+ * Singleton; thread-safe, as worlds are built on the ship loading threads.
+ */
+class BulkStorageRecycler
+{
+public:
+
+    // Sizes up to this one are their own class
+    static constexpr size_t MaxExactSizeClass = 64 * 1024;
+
+    // Beyond this, released storage is freed right away
+    static constexpr size_t MaxRetainedByteSize = 1024 * 1024 * 1024;
+
+    static constexpr std::chrono::seconds RetentionDuration = std::chrono::seconds(120);
+
+    static BulkStorageRecycler & GetInstance()
+    {
+        static BulkStorageRecycler * instance = new BulkStorageRecycler();
+
+        return *instance;
+    }
+
+    static size_t GetSizeClass(size_t size);
+
+    /*
+     * Returns storage - aligned as with aligned_alloc_bulk() - for at least the specified
+     * size, taking it over from the retained storage when possible.
+     */
+    void * Acquire(
+        size_t alignment,
+        size_t size);
+
+    /*
+     * Gives back storage obtained with Acquire() for the same alignment and size; the
+     * storage is retained when capturing, and freed otherwise.
+     */
+    void Release(
+        void * ptr,
+        size_t alignment,
+        size_t size);
+
+    /*
+     * Storage released between these calls is retained; captures may be nested.
+     */
+    void BeginCapture();
+    void EndCapture();
+
+    /*
+     * Frees the storage that has been retained for longer than the retention period.
+     */
+    void Trim();
+
+    /*
+     * Frees all the retained storage.
+     */
+    void Clear();
+
+    size_t GetRetainedByteSize() const;
+
+private:
+
+    BulkStorageRecycler()
+        : mRetainedStorage()
+        , mRetainedByteSize(0)
+        , mCaptureDepth(0)
+        , mMutex()
+    {}
+
+    using Key = std::pair<size_t, size_t>; // Alignment, size class
+
+    static Key MakeKey(
+        size_t alignment,
+        size_t size);
+
+    struct RetainedStorage
+    {
+        void * Ptr;
+        std::chrono::steady_clock::time_point ReleaseTimestamp;
+
+        RetainedStorage(
+            void * ptr,
+            std::chrono::steady_clock::time_point releaseTimestamp)
+            : Ptr(ptr)
+            , ReleaseTimestamp(releaseTimestamp)
+        {}
+    };
+
+    void FreeRetained(std::chrono::steady_clock::time_point minReleaseTimestamp);
+
+private:
+
+    std::map<Key, std::vector<RetainedStorage>> mRetainedStorage;
+    size_t mRetainedByteSize;
+    size_t mCaptureDepth;
+
+    mutable std::mutex mMutex;
+};
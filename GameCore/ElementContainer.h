@@ -94,6 +94,25 @@ public:
         return iterator(mElementCount);
     }
 
+    /*
+     * Visits the elements in blocks of BlockSize consecutive elements, invoking the visitor
+     * with the index of the first element of each block - always a multiple of BlockSize.
+     *
+     * The blocks cover all the elements of the buffers, padding included, hence kernels
+     * need no tail loop but must be harmless on the padding elements. With a fixed trip
+     * count, the loop over the elements of a block gets unrolled and vectorized.
+     */
+    template<size_t BlockSize, typename TVisitor>
+    inline void ForEachBlock(TVisitor && visitor) const
+    {
+        static_assert(BlockSize > 0 && (VectorizationWordSize % BlockSize) == 0, "Blocks must tile the buffers");
+
+        for (ElementIndex blockStart = 0; blockStart < mBufferElementCount; blockStart += BlockSize)
+        {
+            visitor(blockStart);
+        }
+    }
+
 protected:
 
     ElementContainer(ElementCount elementCount)
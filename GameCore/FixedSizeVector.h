@@ -265,6 +265,12 @@ public:
         }
     }
 
+    void pop_back()
+    {
+        assert(mCurrentSize > 0);
+        --mCurrentSize;
+    }
+
     void erase(size_t index)
     {
         assert(index < mCurrentSize);
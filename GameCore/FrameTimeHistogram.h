@@ -0,0 +1,139 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-26
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+/*
+ * The distribution of a duration - in milliseconds - over a window of frames.
+ */
+struct FrameTimePercentiles
+{
+    float P50;
+    float P95;
+    float P99;
+    float Max;
+
+    FrameTimePercentiles()
+        : P50(0.0f)
+        , P95(0.0f)
+        , P99(0.0f)
+        , Max(0.0f)
+    {}
+};
+
+/*
+ * The distributions of the phases of the frames, over the same window of frames;
+ * the input latency is over the window of the last frames that presented the effects
+ * of user input.
+ */
+struct FrameTimeStatistics
+{
+    FrameTimePercentiles Update;
+    FrameTimePercentiles Render;
+    FrameTimePercentiles Swap;
+    FrameTimePercentiles InputLatency;
+};
+
+/*
+ * This class keeps the last NumSamples durations of a per-frame phase, so that - as
+ * opposed to a running average - the hitches are not hidden by the many regular frames.
+ */
+template<size_t NumSamples>
+class FrameTimeHistogram
+{
+public:
+
+    FrameTimeHistogram()
+    {
+        Reset();
+    }
+
+    // Make sure we don't introduce unnecessary copies inadvertently
+    FrameTimeHistogram(FrameTimeHistogram const & other) = delete;
+    FrameTimeHistogram & operator=(FrameTimeHistogram const & other) = delete;
+
+    void RegisterSample(float millis)
+    {
+        mSamples[mCurrentSampleHead] = millis;
+
+        ++mCurrentSampleHead;
+        if (mCurrentSampleHead >= NumSamples)
+            mCurrentSampleHead = 0;
+
+        mSampleCount = std::min(mSampleCount + 1, NumSamples);
+    }
+
+    size_t GetSampleCount() const
+    {
+        return mSampleCount;
+    }
+
+    /*
+     * The most recent sample; zero when there are no samples.
+     */
+    float GetLastSample() const
+    {
+        if (mSampleCount == 0)
+            return 0.0f;
+
+        return mSamples[(mCurrentSampleHead + NumSamples - 1) % NumSamples];
+    }
+
+    /*
+     * Calculates the percentiles - by nearest rank - of the samples in the window;
+     * all zeroes when there are no samples.
+     */
+    FrameTimePercentiles GetPercentiles() const
+    {
+        FrameTimePercentiles percentiles;
+
+        if (mSampleCount == 0)
+            return percentiles;
+
+        // The samples are in the first mSampleCount slots until the window is full,
+        // and in all of them afterwards; their order does not matter here
+        std::array<float, NumSamples> sortedSamples;
+        std::copy(mSamples.cbegin(), mSamples.cbegin() + mSampleCount, sortedSamples.begin());
+        std::sort(sortedSamples.begin(), sortedSamples.begin() + mSampleCount);
+
+        percentiles.P50 = sortedSamples[GetRank(50, mSampleCount)];
+        percentiles.P95 = sortedSamples[GetRank(95, mSampleCount)];
+        percentiles.P99 = sortedSamples[GetRank(99, mSampleCount)];
+        percentiles.Max = sortedSamples[mSampleCount - 1];
+
+        return percentiles;
+    }
+
+    void Reset()
+    {
+        mSamples.fill(0.0f);
+        mCurrentSampleHead = 0;
+        mSampleCount = 0;
+    }
+
+private:
+
+    static size_t GetRank(
+        size_t percentile,
+        size_t sampleCount)
+    {
+        assert(sampleCount > 0);
+
+        // Smallest rank with at least percentile% of the samples at or below it
+        size_t const rank = (percentile * sampleCount + 99) / 100;
+        return std::max(rank, size_t(1)) - 1;
+    }
+
+private:
+
+    std::array<float, NumSamples> mSamples;
+    size_t mCurrentSampleHead; // Oldest, once the window is full
+    size_t mSampleCount;
+};
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <emmintrin.h>
 #include <intrin.h>
 #include <xmmintrin.h>
 
@@ -119,3 +120,77 @@ inline float FastPow(
 {
     return FastPow2(p * FastLog2(x));
 }
+
+/*
+ * Calculates x - n * Pi/2, subtracting n * Pi/2 in three parts, each exact for the n's we care about.
+ */
+inline __m128 FastReduceByHalfPi4(
+    __m128 x,
+    __m128 n) noexcept
+{
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(3.140625f / 2.0f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(9.677410125732422e-4f / 2.0f)));
+    return _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(-8.742277657347586e-8f / 2.0f)));
+}
+
+/*
+ * Approximates the sine of values in [-Pi/2, Pi/2] with its Taylor polynomial of 11th degree.
+ */
+inline __m128 FastSinReduced4(__m128 r) noexcept
+{
+    __m128 const r2 = _mm_mul_ps(r, r);
+    __m128 p = _mm_set1_ps(-1.0f / 39916800.0f);
+    p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(1.0f / 362880.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(-1.0f / 5040.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(1.0f / 120.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(-1.0f / 6.0f));
+    return _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r2), r), r);
+}
+
+/*
+ * Calculates the sine of four values at once.
+ *
+ * The absolute error is below 1e-6 for |x| < 100000; beyond that it grows
+ * with |x|, as the argument reduction loses precision.
+ */
+inline __m128 FastSin4(__m128 x) noexcept
+{
+    // x = k * Pi + r
+    __m128i const k = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.0f / Pi<float>)));
+    __m128 const r = FastReduceByHalfPi4(x, _mm_cvtepi32_ps(_mm_slli_epi32(k, 1)));
+
+    // sin(x) = (-1)^k * sin(r)
+    __m128i const signMask = _mm_slli_epi32(k, 31);
+    return _mm_xor_ps(FastSinReduced4(r), _mm_castsi128_ps(signMask));
+}
+
+/*
+ * Calculates the cosine of four values at once; see FastSin4().
+ */
+inline __m128 FastCos4(__m128 x) noexcept
+{
+    // x = (k + 1/2) * Pi + r
+    __m128i const k = _mm_cvtps_epi32(_mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(1.0f / Pi<float>)), _mm_set1_ps(0.5f)));
+    __m128i const n = _mm_add_epi32(_mm_slli_epi32(k, 1), _mm_set1_epi32(1));
+    __m128 const r = FastReduceByHalfPi4(x, _mm_cvtepi32_ps(n));
+
+    // cos(x) = -(-1)^k * sin(r)
+    __m128i const signMask = _mm_slli_epi32(_mm_xor_si128(k, _mm_set1_epi32(1)), 31);
+    return _mm_xor_ps(FastSinReduced4(r), _mm_castsi128_ps(signMask));
+}
+
+/*
+ * Scalar version of FastSin4(); yields the very same results as each of its lanes.
+ */
+inline float FastSin(float x) noexcept
+{
+    return _mm_cvtss_f32(FastSin4(_mm_set_ss(x)));
+}
+
+/*
+ * Scalar version of FastCos4(); yields the very same results as each of its lanes.
+ */
+inline float FastCos(float x) noexcept
+{
+    return _mm_cvtss_f32(FastCos4(_mm_set_ss(x)));
+}
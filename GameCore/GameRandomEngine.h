@@ -6,9 +6,14 @@
 #pragma once
 
 #include "GameMath.h"
+#include "SysSpecifics.h"
 #include "Vectors.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <type_traits>
 
 /*
  * The random engine for the entire game.
@@ -16,7 +21,14 @@
  * Not so random - always uses the same seed. On purpose! We want two instances
  * of the game to be identical to each other.
  *
- * Singleton.
+ * The engine is a xoshiro128+, which is a lot faster than the standard engines,
+ * and integers are drawn with Lemire's multiply-and-shift rather than with a
+ * std::uniform_int_distribution.
+ *
+ * Singleton; however, tasks that run concurrently may each install - on their
+ * threads - their own, separately-seeded engine, which is then what the singleton
+ * accessor returns on those threads. This keeps the sequence seen by each such task
+ * deterministic, regardless of which thread happens to run it.
  */
 class GameRandomEngine
 {
@@ -24,11 +36,60 @@ public:
 
     static GameRandomEngine & GetInstance()
     {
+        if (nullptr != mThreadEngine)
+            return *mThreadEngine;
+
         static GameRandomEngine * instance = new GameRandomEngine();
 
         return *instance;
     }
 
+    /*
+     * Makes GetInstance() return the specified engine on the current thread,
+     * for as long as this scope lives.
+     */
+    class ThreadEngineScope
+    {
+    public:
+
+        explicit ThreadEngineScope(GameRandomEngine & engine)
+            : mPreviousThreadEngine(mThreadEngine)
+        {
+            mThreadEngine = &engine;
+        }
+
+        ~ThreadEngineScope()
+        {
+            mThreadEngine = mPreviousThreadEngine;
+        }
+
+        ThreadEngineScope(ThreadEngineScope const &) = delete;
+        ThreadEngineScope & operator=(ThreadEngineScope const &) = delete;
+
+    private:
+
+        GameRandomEngine * const mPreviousThreadEngine;
+    };
+
+    /*
+     * Creates an engine - independent from the singleton - for use with a ThreadEngineScope.
+     */
+    explicit GameRandomEngine(unsigned int seed)
+        : mSeedState((static_cast<std::uint64_t>(seed) << 32) ^ DefaultSeed)
+        , mRandomEngine(mSeedState)
+        , mBatchEngine(mSeedState)
+    {
+    }
+
+    /*
+     * Restarts this engine's sequence from the specified seed - e.g. to replay a
+     * session exactly.
+     */
+    void Reseed(unsigned int seed)
+    {
+        *this = GameRandomEngine(seed);
+    }
+
     /*
      * Returns a value between 0 and count - 1, included.
      */
@@ -89,20 +150,84 @@ public:
         T minValue,
         T maxValue)
     {
-        std::uniform_int_distribution<T> dis(minValue, maxValue);
-        return dis(mRandomEngine);
+        static_assert(std::is_integral_v<T>);
+
+        using TUnsigned = std::make_unsigned_t<T>;
+
+        TUnsigned const span = static_cast<TUnsigned>(static_cast<TUnsigned>(maxValue) - static_cast<TUnsigned>(minValue));
+        if (span < std::numeric_limits<std::uint32_t>::max())
+        {
+            return static_cast<T>(static_cast<TUnsigned>(minValue) + static_cast<TUnsigned>(GenerateBoundedInteger(static_cast<std::uint32_t>(span) + 1u)));
+        }
+        else
+        {
+            // Ranges this wide are not in any hot path
+            std::uniform_int_distribution<T> dis(minValue, maxValue);
+            return dis(mRandomEngine);
+        }
     }
 
+    /*
+     * Returns a value in [0.0, 1.0).
+     */
     inline float GenerateRandomNormalizedReal()
     {
-        return mRandomUniformDistribution(mRandomEngine);
+        return ToNormalizedReal(mRandomEngine());
     }
 
     inline float GenerateRandomReal(
         float minValue,
         float maxValue)
     {
-        return minValue + mRandomUniformDistribution(mRandomEngine) * (maxValue - minValue);
+        return minValue + GenerateRandomNormalizedReal() * (maxValue - minValue);
+    }
+
+    /*
+     * Fills the specified buffer with values in [0.0, 1.0).
+     *
+     * Values come from BatchLanes independent generators stepped in lockstep,
+     * which the compiler turns into SIMD code; meant for filling the random
+     * inputs of whole batches of particles at once.
+     */
+    inline void GenerateRandomNormalizedReals(
+        float * restrict outValues,
+        size_t count)
+    {
+        size_t i = 0;
+
+        for (; i + BatchLanes <= count; i += BatchLanes)
+        {
+            BatchLaneValues values;
+            mBatchEngine.Next(values);
+
+            for (size_t l = 0; l < BatchLanes; ++l)
+                outValues[i + l] = ToNormalizedReal(values[l]);
+        }
+
+        if (i < count)
+        {
+            BatchLaneValues values;
+            mBatchEngine.Next(values);
+
+            for (size_t l = 0; i < count; ++i, ++l)
+                outValues[i] = ToNormalizedReal(values[l]);
+        }
+    }
+
+    /*
+     * Fills the specified buffer with values in [minValue, maxValue).
+     */
+    inline void GenerateRandomReals(
+        float * restrict outValues,
+        size_t count,
+        float minValue,
+        float maxValue)
+    {
+        GenerateRandomNormalizedReals(outValues, count);
+
+        float const width = maxValue - minValue;
+        for (size_t i = 0; i < count; ++i)
+            outValues[i] = minValue + outValues[i] * width;
     }
 
     inline vec2f GenerateRandomRadialVector(
@@ -121,15 +246,159 @@ public:
         return vec2f::fromPolar(magnitude, angle);
     }
 
+    static constexpr size_t BatchLanes = 4;
+
 private:
 
+    static constexpr std::uint64_t DefaultSeed = 0x0001'00f2'012d'0e70ull; // 1, 242, 19730528
+
+    static inline std::uint64_t SplitMix64(std::uint64_t & state)
+    {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    static inline float ToNormalizedReal(std::uint32_t value)
+    {
+        // The top 24 bits, which are also the best ones of a xoshiro128+
+        return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /*
+     * Returns a value in [0, range), unbiased.
+     */
+    inline std::uint32_t GenerateBoundedInteger(std::uint32_t range)
+    {
+        std::uint64_t product = static_cast<std::uint64_t>(mRandomEngine()) * range;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < range)
+        {
+            std::uint32_t const threshold = static_cast<std::uint32_t>(-range) % range;
+            while (low < threshold)
+            {
+                product = static_cast<std::uint64_t>(mRandomEngine()) * range;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    static inline std::uint32_t RotateLeft(std::uint32_t x, int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    /*
+     * xoshiro128+ (Blackman & Vigna); a UniformRandomBitGenerator.
+     */
+    class Xoshiro128Plus
+    {
+    public:
+
+        using result_type = std::uint32_t;
+
+        static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        explicit Xoshiro128Plus(std::uint64_t & seedState)
+        {
+            std::uint64_t const a = SplitMix64(seedState);
+            std::uint64_t const b = SplitMix64(seedState);
+            mState[0] = static_cast<std::uint32_t>(a);
+            mState[1] = static_cast<std::uint32_t>(a >> 32);
+            mState[2] = static_cast<std::uint32_t>(b);
+            mState[3] = static_cast<std::uint32_t>(b >> 32);
+        }
+
+        inline result_type operator()()
+        {
+            result_type const result = mState[0] + mState[3];
+
+            std::uint32_t const t = mState[1] << 9;
+
+            mState[2] ^= mState[0];
+            mState[3] ^= mState[1];
+            mState[1] ^= mState[2];
+            mState[0] ^= mState[3];
+
+            mState[2] ^= t;
+
+            mState[3] = RotateLeft(mState[3], 11);
+
+            return result;
+        }
+
+    private:
+
+        std::uint32_t mState[4];
+    };
+
+    using BatchLaneValues = std::uint32_t[BatchLanes];
+
+    /*
+     * BatchLanes xoshiro128+'s, with their state laid out by state word, so that
+     * each step is a handful of vector operations.
+     */
+    class BatchXoshiro128Plus
+    {
+    public:
+
+        explicit BatchXoshiro128Plus(std::uint64_t & seedState)
+        {
+            for (size_t l = 0; l < BatchLanes; ++l)
+            {
+                std::uint64_t const a = SplitMix64(seedState);
+                std::uint64_t const b = SplitMix64(seedState);
+                mS0[l] = static_cast<std::uint32_t>(a);
+                mS1[l] = static_cast<std::uint32_t>(a >> 32);
+                mS2[l] = static_cast<std::uint32_t>(b);
+                mS3[l] = static_cast<std::uint32_t>(b >> 32);
+            }
+        }
+
+        inline void Next(BatchLaneValues & values)
+        {
+            for (size_t l = 0; l < BatchLanes; ++l)
+            {
+                values[l] = mS0[l] + mS3[l];
+
+                std::uint32_t const t = mS1[l] << 9;
+
+                mS2[l] ^= mS0[l];
+                mS3[l] ^= mS1[l];
+                mS1[l] ^= mS2[l];
+                mS0[l] ^= mS3[l];
+
+                mS2[l] ^= t;
+
+                mS3[l] = RotateLeft(mS3[l], 11);
+            }
+        }
+
+    private:
+
+        alignas(16) std::uint32_t mS0[BatchLanes];
+        alignas(16) std::uint32_t mS1[BatchLanes];
+        alignas(16) std::uint32_t mS2[BatchLanes];
+        alignas(16) std::uint32_t mS3[BatchLanes];
+    };
+
     GameRandomEngine()
+        : mSeedState(DefaultSeed)
+        , mRandomEngine(mSeedState)
+        , mBatchEngine(mSeedState)
     {
-        std::seed_seq seed_seq({ 1, 242, 19730528 });
-        mRandomEngine = std::ranlux48_base(seed_seq);
-        mRandomUniformDistribution = std::uniform_real_distribution<float>(0.0f, 1.0f);
     }
 
-    std::ranlux48_base mRandomEngine;
-    std::uniform_real_distribution<float> mRandomUniformDistribution;
+    // Only used while constructing the engines
+    std::uint64_t mSeedState;
+
+    Xoshiro128Plus mRandomEngine;
+    BatchXoshiro128Plus mBatchEngine;
+
+    // The engine installed on the current thread, if any
+    static inline thread_local GameRandomEngine * mThreadEngine = nullptr;
 };
@@ -5,6 +5,9 @@
 ***************************************************************************************/
 #pragma once
 
+#include "SysSpecifics.h"
+
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <sstream>
@@ -20,9 +23,26 @@
  * resulting in even better data locality.
  */
 using ElementCount = std::uint32_t;
+
+/*
+ * When built with USE_16BIT_ELEMENT_INDICES, indices are 16-bit instead: this halves the
+ * bandwidth taken by the endpoints of springs and triangles - both in the spring forces
+ * gathers and in the element uploads to the GPU - at the cost of not being able to load
+ * ships of more than MaxElementCount points (ephemeral particles included).
+ */
+#ifdef USE_16BIT_ELEMENT_INDICES
+using ElementIndex = std::uint16_t;
+#else
 using ElementIndex = std::uint32_t;
+#endif
+
 static constexpr ElementIndex NoneElementIndex = std::numeric_limits<ElementIndex>::max();
 
+// The max number of elements of any one type; the buffers of element containers are padded
+// to a multiple of the vectorization word size, and indices into them may never reach NoneElementIndex
+static constexpr ElementCount MaxElementCount = static_cast<ElementCount>(
+    (NoneElementIndex / VectorizationWordSize) * VectorizationWordSize);
+
 /*
  * Ship identifiers.
  *
@@ -171,11 +191,86 @@ public:
         return step == (mValue % period);
     }
 
+    inline std::uint32_t GetStepOf(std::uint32_t period) const
+    {
+        return mValue % period;
+    }
+
 private:
 
     std::uint32_t mValue;
 };
 
+/*
+ * A contiguous range of element indices that have changed since they were last
+ * consumed - e.g. uploaded to the GPU. Grows to cover each element that is marked.
+ */
+struct DirtyElementRange
+{
+public:
+
+    inline constexpr DirtyElementRange()
+        : mStart(NoneElementIndex)
+        , mEnd(0)
+    {}
+
+    inline constexpr DirtyElementRange(
+        ElementIndex start,
+        ElementIndex end)
+        : mStart(start)
+        , mEnd(end)
+    {}
+
+    inline bool IsEmpty() const
+    {
+        return mStart >= mEnd;
+    }
+
+    inline ElementIndex GetStart() const
+    {
+        return mStart;
+    }
+
+    // Exclusive
+    inline ElementIndex GetEnd() const
+    {
+        return mEnd;
+    }
+
+    inline ElementCount GetCount() const
+    {
+        return IsEmpty() ? 0 : mEnd - mStart;
+    }
+
+    inline void Add(ElementIndex elementIndex)
+    {
+        mStart = std::min(mStart, elementIndex);
+        mEnd = std::max(mEnd, static_cast<ElementIndex>(elementIndex + 1));
+    }
+
+    inline void Add(
+        ElementIndex start,
+        ElementIndex end)
+    {
+        if (start < end)
+        {
+            mStart = std::min(mStart, start);
+            mEnd = std::max(mEnd, end);
+        }
+    }
+
+    inline void Clear()
+    {
+        mStart = NoneElementIndex;
+        mEnd = 0;
+    }
+
+private:
+
+    ElementIndex mStart;
+    ElementIndex mEnd;
+};
+
 /*
  * Types of bombs (duh).
  */
@@ -198,6 +293,26 @@ enum class DurationShortLongType
 
 DurationShortLongType StrToDurationShortLongType(std::string const & str);
 
+/*
+ * The different ways in which the elements of a ship may be laid out in memory
+ * when the ship is built.
+ */
+enum class ShipLayoutStrategy
+{
+    // Springs in 2x2 tiles of the structure, points in the order springs visit them
+    Tiling,
+
+    // Springs optimized with Tom Forsyth's algorithm, points in the order springs visit them
+    SpringsTomForsyth,
+
+    // As Tiling, with triangles also optimized with Tom Forsyth's algorithm; their natural order
+    // is lost, hence higher elements of the ship might not cover lower ones anymore
+    TrianglesTomForsyth,
+
+    // Springs and points in the order they are detected
+    Idempotent
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Rendering
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -224,6 +339,17 @@ enum class DebugShipRenderMode
     Decay
 };
 
+/*
+ * The phases whose optimized kernels may be checked, at each step, against
+ * their reference implementations.
+ */
+enum class KernelVerificationMode
+{
+    None,
+    SpringForces,   // The best implementation - possibly parallel - against the serial scalar one
+    LightDiffusion  // The light grid against visiting all points
+};
+
 /*
  * The different ways in which the ocean may be rendered.
  */
@@ -5,6 +5,7 @@
 ***************************************************************************************/
 #pragma once
 
+#include <cassert>
 #include <chrono>
 #include <optional>
 
@@ -33,7 +34,12 @@ public:
 
     inline time_point Now() const
     {
-        if (!!mLastResumeTime)
+        if (mIsManual)
+        {
+            // Only moves when told to
+            return mLastPauseTime;
+        }
+        else if (!!mLastResumeTime)
         {
             // We're running
             return mLastPauseTime + (std::chrono::steady_clock::now() - *mLastResumeTime);
@@ -69,15 +75,52 @@ public:
         }
     }
 
+    /*
+     * In manual mode the clock only moves forward via Advance() - e.g. by exactly one
+     * simulation step at each step - so that whatever is driven by it is reproducible.
+     */
+    void SetManual(bool isManual)
+    {
+        if (isManual == mIsManual)
+            return;
+
+        if (isManual)
+        {
+            mLastPauseTime = Now();
+            mIsManual = true;
+        }
+        else
+        {
+            mIsManual = false;
+
+            // Resume from where we've been left
+            if (!!mLastResumeTime)
+                mLastResumeTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    bool IsManual() const
+    {
+        return mIsManual;
+    }
+
+    void Advance(duration amount)
+    {
+        assert(mIsManual);
+        mLastPauseTime += amount;
+    }
+
 private:
 
     GameWallClock()
         : mLastPauseTime(std::chrono::steady_clock::now())
         , mLastResumeTime(mLastPauseTime)
+        , mIsManual(false)
     {
 
     }
 
     time_point mLastPauseTime;
     std::optional<time_point> mLastResumeTime;
+    bool mIsManual;
 };
@@ -5,132 +5,284 @@
 ***************************************************************************************/
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <deque>
 #include <functional>
 #include <iostream>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 
-namespace /* anonymous */ {
+/*
+ * The logger.
+ *
+ * Messages are formatted by the logging thread straight into fixed-size records of a
+ * ring buffer, claimed without locks; a background thread then stores them, publishes
+ * them to the listener, and outputs them. Logging thus doesn't allocate nor lock,
+ * which matters as we log from the simulation, the preview thread, and the GPU calculators.
+ *
+ * Only when the ring buffer is full does logging wait, for the background thread to
+ * catch up.
+ */
+class Logger
+{
+public:
 
-	template<typename T>
-	std::stringstream & _LogToStream(std::stringstream & ss, T&& t)
-	{
-		ss << std::forward<T>(t) << std::endl;
-		return ss;
-	}
+    Logger()
+        : mRecords()
+        , mNextWriteSequence(0)
+        , mNextReadSequence(0)
+        , mCurrentListener()
+        , mStoredMessages()
+        , mListenerMutex()
+        , mIsStopping(false)
+        , mFlushThread()
+    {
+        for (size_t r = 0; r < RecordCount; ++r)
+        {
+            mRecords[r].Sequence.store(r, std::memory_order_relaxed);
+        }
 
-	template<typename T, typename... TArgs>
-	std::stringstream & _LogToStream(std::stringstream & ss, T&& t, TArgs&&... args)
-	{
-		ss << std::forward<T>(t);
-		return _LogToStream(ss, std::forward<TArgs>(args)...);
-	}
+        mFlushThread = std::thread(&Logger::FlushThreadLoop, this);
+    }
 
-    template<typename T>
-    void _LogToNothing(T&& /*t*/)
+    ~Logger()
     {
+        mIsStopping.store(true, std::memory_order_release);
+        mFlushThread.join();
     }
 
-    template<typename T, typename... TArgs>
-    void _LogToNothing(T&& /*t*/, TArgs&&... args)
+    Logger(Logger const &) = delete;
+    Logger(Logger &&) = delete;
+    Logger & operator=(Logger const &) = delete;
+    Logger & operator=(Logger &&) = delete;
+
+    /*
+     * The listener is invoked on the logger's background thread.
+     */
+    void RegisterListener(
+        std::function<void(std::string const & message)> listener)
     {
-        _LogToNothing(std::forward<TArgs>(args)...);
+        std::scoped_lock lock(mListenerMutex);
+
+        assert(!mCurrentListener);
+        mCurrentListener = std::move(listener);
+
+        // Publish all the messages so far
+        for (std::string const & message : mStoredMessages)
+        {
+            mCurrentListener(message);
+        }
     }
 
-}
+    void UnregisterListener()
+    {
+        std::scoped_lock lock(mListenerMutex);
 
-class Logger
-{
-public:
+        assert(!!mCurrentListener);
+        mCurrentListener = {};
+    }
 
-	Logger()
-		: mCurrentListener()
-		, mStoredMessages()
-        , mStoredMessagesMutex()
-	{
-	}
-
-	Logger(Logger const &) = delete;
-	Logger(Logger &&) = delete;
-	Logger & operator=(Logger const &) = delete;
-	Logger & operator=(Logger &&) = delete;
-
-	void RegisterListener(
-		std::function<void(std::string const & message)> listener)
-	{
-		assert(!mCurrentListener);
-		mCurrentListener = std::move(listener);
-
-		// Publish all the messages so far
+    template<typename...TArgs>
+    void Log(TArgs&&... args)
+    {
+        //
+        // Claim a record
+        //
+
+        uint64_t sequence = mNextWriteSequence.load(std::memory_order_relaxed);
+        Record * record;
+        while (true)
         {
-            std::scoped_lock lock(mStoredMessagesMutex);
+            record = &(mRecords[sequence % RecordCount]);
 
-            for (std::string const & message : mStoredMessages)
+            uint64_t const recordSequence = record->Sequence.load(std::memory_order_acquire);
+            if (recordSequence == sequence)
             {
-                mCurrentListener(message);
+                // The record is free; try to claim it
+                if (mNextWriteSequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (recordSequence < sequence)
+            {
+                // The ring buffer is full; wait for the record to be flushed
+                std::this_thread::yield();
+                sequence = mNextWriteSequence.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                // Claimed by someone else in the meantime
+                sequence = mNextWriteSequence.load(std::memory_order_relaxed);
             }
         }
-	}
 
-	void UnregisterListener()
-	{
-		assert(!!mCurrentListener);
-		mCurrentListener = {};
-	}
+        //
+        // Format into the record and publish it
+        //
+
+        record->Length = 0;
+        (AppendToRecord(*record, std::forward<TArgs>(args)), ...);
+
+        record->Sequence.store(sequence + 1, std::memory_order_release);
+    }
+
+public:
 
-	template<typename...TArgs>
-	void Log(TArgs&&... args)
-	{
-		std::stringstream ss;
-		_LogToStream(ss, std::forward<TArgs>(args)...);
+    static Logger Instance;
 
-		std::string const & message = ss.str();
+private:
+
+    static constexpr size_t RecordCount = 1024;
+    static constexpr size_t MaxMessageLength = 500;
 
-		// Store
+    struct Record
+    {
+        std::atomic<uint64_t> Sequence; // == write sequence when free, == write sequence + 1 when ready
+        size_t Length;
+        char Text[MaxMessageLength];
+    };
+
+    static void AppendToRecord(Record & record, std::string_view str)
+    {
+        size_t const length = std::min(str.length(), MaxMessageLength - record.Length);
+        std::memcpy(record.Text + record.Length, str.data(), length);
+        record.Length += length;
+    }
+
+    template<typename T>
+    static void AppendToRecord(Record & record, T && value)
+    {
+        using TValue = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<TValue, std::string>
+            || std::is_same_v<TValue, char const *>
+            || std::is_same_v<TValue, char *>)
+        {
+            AppendToRecord(record, std::string_view(value));
+        }
+        else if constexpr (std::is_same_v<TValue, char>)
+        {
+            AppendToRecord(record, std::string_view(&value, 1));
+        }
+        else if constexpr (std::is_integral_v<TValue> && std::is_signed_v<TValue>)
         {
-            std::scoped_lock lock(mStoredMessagesMutex);
+            AppendFormattedToRecord(record, "%lld", static_cast<long long>(value));
+        }
+        else if constexpr (std::is_integral_v<TValue>)
+        {
+            AppendFormattedToRecord(record, "%llu", static_cast<unsigned long long>(value));
+        }
+        else if constexpr (std::is_floating_point_v<TValue>)
+        {
+            // As streams do by default
+            AppendFormattedToRecord(record, "%g", static_cast<double>(value));
+        }
+        else
+        {
+            // Anything else is streamed, through a stream that's reused by the thread
+            thread_local std::ostringstream ss;
+            ss.str(std::string());
+            ss.clear();
+            ss << std::forward<T>(value);
+            AppendToRecord(record, std::string_view(ss.str()));
+        }
+    }
+
+    template<typename TValue>
+    static void AppendFormattedToRecord(Record & record, char const * format, TValue value)
+    {
+        char buffer[32];
+        int const length = std::snprintf(buffer, sizeof(buffer), format, value);
+        if (length > 0)
+            AppendToRecord(record, std::string_view(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1)));
+    }
+
+    void FlushThreadLoop()
+    {
+        while (true)
+        {
+            bool const isStopping = mIsStopping.load(std::memory_order_acquire);
+
+            Flush();
+
+            if (isStopping)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void Flush()
+    {
+        while (true)
+        {
+            Record & record = mRecords[mNextReadSequence % RecordCount];
+            if (record.Sequence.load(std::memory_order_acquire) != mNextReadSequence + 1)
+                break;
+
+            std::string message(record.Text, record.Length);
 
+            // Give the record back
+            record.Sequence.store(mNextReadSequence + RecordCount, std::memory_order_release);
+            ++mNextReadSequence;
+
+            Publish(message + "\n");
+        }
+    }
+
+    void Publish(std::string const & message)
+    {
+        {
+            std::scoped_lock lock(mListenerMutex);
+
+            // Store
             mStoredMessages.push_back(message);
             if (mStoredMessages.size() > MaxStoredMessages)
             {
                 mStoredMessages.pop_front();
             }
-        }
 
-		// Publish
-		if (!!mCurrentListener)
-		{
-			mCurrentListener(message);
-		}
+            // Publish
+            if (!!mCurrentListener)
+            {
+                mCurrentListener(message);
+            }
+        }
 
         // Output
         std::cout << message << std::endl;
-	}
-
-    template<typename...TArgs>
-    void LogToNothing(TArgs&&... args)
-    {
-        _LogToNothing(std::forward<TArgs>(args)...);
     }
 
-public:
+private:
 
-	static Logger Instance;
+    // The records, and the sequence numbers of the next record to claim and
+    // of the next record to flush
+    std::array<Record, RecordCount> mRecords;
+    std::atomic<uint64_t> mNextWriteSequence;
+    uint64_t mNextReadSequence; // Only touched by the flush thread
 
-private:
+    // The current listener
+    std::function<void(std::string const & message)> mCurrentListener;
 
-	// The current listener
-	std::function<void(std::string const & message)> mCurrentListener;
+    // The messages stored so far
+    std::deque<std::string> mStoredMessages;
+    static constexpr size_t MaxStoredMessages = 10000;
 
-	// The messages stored so far
-	std::deque<std::string> mStoredMessages;
-	static constexpr size_t MaxStoredMessages = 10000;
+    // The mutex for the listener and the stored messages
+    std::mutex mListenerMutex;
 
-    // The mutex for the message queue
-    std::mutex mStoredMessagesMutex;
+    std::atomic<bool> mIsStopping;
+    std::thread mFlushThread;
 };
 
 //
@@ -140,16 +292,12 @@ private:
 template<typename... TArgs>
 void LogMessage(TArgs&&... args)
 {
-	Logger::Instance.Log(std::forward<TArgs>(args)...);
+    Logger::Instance.Log(std::forward<TArgs>(args)...);
 }
 
-template<typename... TArgs>
-void LogDebug(TArgs&&... args)
-{
+// Compiled out - arguments included - in release builds
 #ifdef _DEBUG
-	Logger::Instance.Log(std::forward<TArgs>(args)...);
+#define LogDebug(...) Logger::Instance.Log(__VA_ARGS__)
 #else
-    Logger::Instance.LogToNothing(std::forward<TArgs>(args)...);
+#define LogDebug(...) ((void)0)
 #endif
-}
-
@@ -0,0 +1,132 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-13
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "Buffer.h"
+#include "BufferAllocator.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * An account of how many bytes are held by each buffer of a set of objects.
+ *
+ * Objects add their buffers under nested sections - e.g. "Ship 1/Points/Position" -
+ * so that totals may be taken at any level of the hierarchy.
+ */
+class MemoryReport
+{
+public:
+
+    struct Entry
+    {
+        std::string Path;
+        size_t ByteSize;
+
+        Entry(
+            std::string path,
+            size_t byteSize)
+            : Path(std::move(path))
+            , ByteSize(byteSize)
+        {}
+    };
+
+    MemoryReport()
+        : mEntries()
+        , mCurrentSectionPath()
+        , mSectionPathLengths()
+    {}
+
+    /*
+     * Adds the entries that follow under the specified section, until PopSection().
+     */
+    void PushSection(std::string const & name)
+    {
+        mSectionPathLengths.push_back(mCurrentSectionPath.length());
+        mCurrentSectionPath += name + "/";
+    }
+
+    void PopSection()
+    {
+        assert(!mSectionPathLengths.empty());
+
+        mCurrentSectionPath.resize(mSectionPathLengths.back());
+        mSectionPathLengths.pop_back();
+    }
+
+    void Add(
+        std::string const & name,
+        size_t byteSize)
+    {
+        mEntries.emplace_back(mCurrentSectionPath + name, byteSize);
+    }
+
+    template<typename TElement>
+    void Add(
+        std::string const & name,
+        Buffer<TElement> const & buffer)
+    {
+        Add(name, buffer.GetByteSize());
+    }
+
+    template<typename TElement>
+    void Add(
+        std::string const & name,
+        BufferAllocator<TElement> const & bufferAllocator)
+    {
+        Add(name, bufferAllocator.GetPooledByteSize());
+    }
+
+    template<typename TElement>
+    void Add(
+        std::string const & name,
+        std::vector<TElement> const & vector)
+    {
+        // What has been allocated, not what is used
+        Add(name, vector.capacity() * sizeof(TElement));
+    }
+
+    void Add(
+        std::string const & name,
+        std::vector<bool> const & vector)
+    {
+        // Packed
+        Add(name, (vector.capacity() + 7) / 8);
+    }
+
+    std::vector<Entry> const & GetEntries() const
+    {
+        return mEntries;
+    }
+
+    /*
+     * Gets the total of the entries under the specified section path - e.g. "Ship 1/Points" -
+     * or of all the entries when the path is empty.
+     */
+    size_t GetTotalByteSize(std::string const & sectionPath = std::string()) const
+    {
+        std::string const prefix = sectionPath.empty() ? std::string() : sectionPath + "/";
+
+        size_t totalByteSize = 0;
+        for (auto const & entry : mEntries)
+        {
+            if (0 == entry.Path.compare(0, prefix.length(), prefix))
+                totalByteSize += entry.ByteSize;
+        }
+
+        return totalByteSize;
+    }
+
+private:
+
+    std::vector<Entry> mEntries;
+
+    std::string mCurrentSectionPath;
+    std::vector<size_t> mSectionPathLengths;
+};
@@ -0,0 +1,179 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-19
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "Colors.h"
+#include "SysSpecifics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/*
+ * Finds the entry of a palette whose color is nearest - in RGB space - to any given color,
+ * as a linear scan of the palette would, ties going to the earliest entry.
+ *
+ * The RGB cube is divided into cells of 8x8x8 colors, and each cell is given beforehand the
+ * few entries that may be nearest to any of its colors; a lookup only scans those, instead
+ * of the whole palette. An entry may be nearest to a color in the cell only if its distance
+ * from the cell is no greater than the distance from the farthest corner of the cell of the
+ * entry whose farthest corner is nearest.
+ */
+template<typename TValue>
+class NearestColorLookup
+{
+public:
+
+    NearestColorLookup(std::vector<std::pair<rgbColor, TValue>> const & palette)
+        : mPaletteR()
+        , mPaletteG()
+        , mPaletteB()
+        , mPaletteValues()
+        , mCellCandidatesStart(CellCount + 1, 0)
+        , mCandidates()
+    {
+        assert(!palette.empty());
+        assert(palette.size() <= std::numeric_limits<uint16_t>::max());
+
+        for (auto const & entry : palette)
+        {
+            mPaletteR.push_back(entry.first.r);
+            mPaletteG.push_back(entry.first.g);
+            mPaletteB.push_back(entry.first.b);
+            mPaletteValues.push_back(entry.second);
+        }
+
+        size_t const paletteSize = palette.size();
+
+        std::vector<int32_t> minSquareDistances(paletteSize);
+        std::vector<int32_t> maxSquareDistances(paletteSize);
+
+        for (size_t cell = 0; cell < CellCount; ++cell)
+        {
+            int32_t const loR = static_cast<int32_t>((cell >> (2 * CellBits)) << CellShift);
+            int32_t const loG = static_cast<int32_t>(((cell >> CellBits) & CellMask) << CellShift);
+            int32_t const loB = static_cast<int32_t>((cell & CellMask) << CellShift);
+
+            // Distances of all entries from the cell and from the cell's farthest corner;
+            // branch-free over structures of arrays, so that the compiler vectorizes it
+            CalculateCellSquareDistances(
+                loR,
+                mPaletteR.data(),
+                loG,
+                mPaletteG.data(),
+                loB,
+                mPaletteB.data(),
+                paletteSize,
+                minSquareDistances.data(),
+                maxSquareDistances.data());
+
+            int32_t const threshold = *std::min_element(maxSquareDistances.cbegin(), maxSquareDistances.cend());
+
+            // Candidates are kept in palette order, so that ties go where the linear scan takes them
+            for (size_t e = 0; e < paletteSize; ++e)
+            {
+                if (minSquareDistances[e] <= threshold)
+                    mCandidates.push_back(static_cast<uint16_t>(e));
+            }
+
+            mCellCandidatesStart[cell + 1] = static_cast<uint32_t>(mCandidates.size());
+        }
+    }
+
+    TValue const & Find(rgbColor const & color) const
+    {
+        size_t const cell =
+            (static_cast<size_t>(color.r >> CellShift) << (2 * CellBits))
+            | (static_cast<size_t>(color.g >> CellShift) << CellBits)
+            | static_cast<size_t>(color.b >> CellShift);
+
+        uint32_t const candidatesEnd = mCellCandidatesStart[cell + 1];
+
+        uint32_t c = mCellCandidatesStart[cell];
+        assert(c < candidatesEnd);
+
+        size_t bestEntry = mCandidates[c];
+        int32_t bestSquareDistance = CalculateSquareDistance(color, bestEntry);
+        for (++c; c < candidatesEnd; ++c)
+        {
+            size_t const entry = mCandidates[c];
+            int32_t const squareDistance = CalculateSquareDistance(color, entry);
+            if (squareDistance < bestSquareDistance)
+            {
+                bestEntry = entry;
+                bestSquareDistance = squareDistance;
+            }
+        }
+
+        return mPaletteValues[bestEntry];
+    }
+
+private:
+
+    static constexpr size_t CellBits = 5;
+    static constexpr size_t CellShift = 8 - CellBits;
+    static constexpr size_t CellMask = (1 << CellBits) - 1;
+    static constexpr size_t CellCount = 1 << (3 * CellBits);
+    static constexpr int32_t CellSide = 1 << CellShift;
+
+    static void CalculateCellSquareDistances(
+        int32_t loR,
+        int32_t const * restrict paletteR,
+        int32_t loG,
+        int32_t const * restrict paletteG,
+        int32_t loB,
+        int32_t const * restrict paletteB,
+        size_t paletteSize,
+        int32_t * restrict minSquareDistances,
+        int32_t * restrict maxSquareDistances)
+    {
+        int32_t const hiR = loR + CellSide - 1;
+        int32_t const hiG = loG + CellSide - 1;
+        int32_t const hiB = loB + CellSide - 1;
+
+        for (size_t e = 0; e < paletteSize; ++e)
+        {
+            // Distance from the cell, per channel: zero when the channel falls within the cell
+            int32_t const minDR = std::max(std::max(loR - paletteR[e], paletteR[e] - hiR), 0);
+            int32_t const minDG = std::max(std::max(loG - paletteG[e], paletteG[e] - hiG), 0);
+            int32_t const minDB = std::max(std::max(loB - paletteB[e], paletteB[e] - hiB), 0);
+
+            minSquareDistances[e] = minDR * minDR + minDG * minDG + minDB * minDB;
+
+            // Distance from the farthest corner, per channel
+            int32_t const maxDR = std::max(paletteR[e] - loR, hiR - paletteR[e]);
+            int32_t const maxDG = std::max(paletteG[e] - loG, hiG - paletteG[e]);
+            int32_t const maxDB = std::max(paletteB[e] - loB, hiB - paletteB[e]);
+
+            maxSquareDistances[e] = maxDR * maxDR + maxDG * maxDG + maxDB * maxDB;
+        }
+    }
+
+    int32_t CalculateSquareDistance(
+        rgbColor const & color,
+        size_t entry) const
+    {
+        int32_t const dR = static_cast<int32_t>(color.r) - mPaletteR[entry];
+        int32_t const dG = static_cast<int32_t>(color.g) - mPaletteG[entry];
+        int32_t const dB = static_cast<int32_t>(color.b) - mPaletteB[entry];
+
+        return dR * dR + dG * dG + dB * dB;
+    }
+
+    // The palette, as structures of arrays
+    std::vector<int32_t> mPaletteR;
+    std::vector<int32_t> mPaletteG;
+    std::vector<int32_t> mPaletteB;
+    std::vector<TValue> mPaletteValues;
+
+    // The candidates of each cell are at [mCellCandidatesStart[cell], mCellCandidatesStart[cell + 1])
+    std::vector<uint32_t> mCellCandidatesStart;
+    std::vector<uint16_t> mCandidates;
+};
@@ -0,0 +1,529 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-11
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "ResourceArchive.h"
+
+#include "BinaryFileTools.h"
+#include "GameException.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace /* anonymous */ {
+
+    static constexpr char ArchiveMagic[4] = { 'F', 'S', 'R', 'A' };
+    static constexpr std::uint32_t ArchiveVersion = 1;
+
+    // Magic, version, entry count, index byte size
+    static constexpr size_t HeaderSize = sizeof(ArchiveMagic) + 3 * sizeof(std::uint32_t);
+
+    // Offset, size, path length - followed by the path
+    static constexpr size_t IndexEntryFixedSize = 2 * sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+    std::uint64_t AlignEntryOffset(std::uint64_t offset)
+    {
+        return (offset + ResourceArchive::EntryAlignment - 1) / ResourceArchive::EntryAlignment * ResourceArchive::EntryAlignment;
+    }
+
+    template<typename T>
+    T ReadMapped(
+        std::uint8_t const * data,
+        size_t & offset)
+    {
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+}
+
+/*
+ * A file mapped read-only in its entirety.
+ */
+struct ResourceArchive::MappedFile
+{
+#ifdef _WIN32
+
+    MappedFile(std::filesystem::path const & filePath)
+    {
+        mFileHandle = CreateFileW(
+            filePath.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            NULL,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            NULL);
+
+        if (INVALID_HANDLE_VALUE == mFileHandle)
+        {
+            throw GameException("Cannot open file \"" + filePath.string() + "\": error " + std::to_string(GetLastError()));
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(mFileHandle, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(mFileHandle);
+            throw GameException("Cannot map file \"" + filePath.string() + "\": the file is empty");
+        }
+
+        mMappingHandle = CreateFileMappingW(mFileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (NULL == mMappingHandle)
+        {
+            CloseHandle(mFileHandle);
+            throw GameException("Cannot map file \"" + filePath.string() + "\": error " + std::to_string(GetLastError()));
+        }
+
+        Memory = static_cast<std::uint8_t const *>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (NULL == Memory)
+        {
+            CloseHandle(mMappingHandle);
+            CloseHandle(mFileHandle);
+            throw GameException("Cannot map file \"" + filePath.string() + "\": error " + std::to_string(GetLastError()));
+        }
+
+        Size = static_cast<size_t>(fileSize.QuadPart);
+    }
+
+    ~MappedFile()
+    {
+        UnmapViewOfFile(Memory);
+        CloseHandle(mMappingHandle);
+        CloseHandle(mFileHandle);
+    }
+
+    std::uint8_t const * Memory;
+    size_t Size;
+
+private:
+
+    HANDLE mFileHandle;
+    HANDLE mMappingHandle;
+
+#else
+
+    MappedFile(std::filesystem::path const & filePath)
+    {
+        int const fd = open(filePath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw GameException("Cannot open file \"" + filePath.string() + "\": error " + std::to_string(errno));
+        }
+
+        struct stat fileStat;
+        if (0 != fstat(fd, &fileStat) || fileStat.st_size == 0)
+        {
+            close(fd);
+            throw GameException("Cannot map file \"" + filePath.string() + "\": the file is empty");
+        }
+
+        Size = static_cast<size_t>(fileStat.st_size);
+
+        void * const memory = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // The mapping keeps the file alive
+        close(fd);
+
+        if (MAP_FAILED == memory)
+        {
+            throw GameException("Cannot map file \"" + filePath.string() + "\": error " + std::to_string(errno));
+        }
+
+        // We'll read most of it, and the index right away
+        posix_madvise(memory, Size, POSIX_MADV_WILLNEED);
+
+        Memory = static_cast<std::uint8_t const *>(memory);
+    }
+
+    ~MappedFile()
+    {
+        munmap(const_cast<std::uint8_t *>(Memory), Size);
+    }
+
+    std::uint8_t const * Memory;
+    size_t Size;
+
+#endif
+};
+
+ResourceArchive::ResourceArchive(
+    std::unique_ptr<MappedFile> mappedFile,
+    std::vector<IndexEntry> && index)
+    : mMappedFile(std::move(mappedFile))
+    , mIndex(std::move(index))
+{
+}
+
+ResourceArchive::~ResourceArchive()
+{
+}
+
+size_t ResourceArchive::Build(
+    std::filesystem::path const & rootDirectoryPath,
+    std::filesystem::path const & archiveFilePath)
+{
+    //
+    // Collect files
+    //
+
+    struct SourceFile
+    {
+        std::filesystem::path FilePath;
+        std::string RelativePath;
+        std::uint64_t Size;
+    };
+
+    std::vector<SourceFile> sourceFiles;
+
+    std::error_code ec;
+    auto const absoluteArchiveFilePath = std::filesystem::absolute(archiveFilePath, ec).lexically_normal();
+
+    for (auto const & entryIt : std::filesystem::recursive_directory_iterator(rootDirectoryPath))
+    {
+        if (!entryIt.is_regular_file())
+            continue;
+
+        // Don't pack ourselves
+        if (std::filesystem::absolute(entryIt.path(), ec).lexically_normal() == absoluteArchiveFilePath)
+            continue;
+
+        sourceFiles.push_back({
+            entryIt.path(),
+            entryIt.path().lexically_relative(rootDirectoryPath).generic_string(),
+            static_cast<std::uint64_t>(entryIt.file_size()) });
+    }
+
+    std::sort(
+        sourceFiles.begin(),
+        sourceFiles.end(),
+        [](SourceFile const & lhs, SourceFile const & rhs)
+        {
+            return lhs.RelativePath < rhs.RelativePath;
+        });
+
+    //
+    // Lay out entries
+    //
+
+    size_t indexByteSize = 0;
+    for (auto const & sourceFile : sourceFiles)
+    {
+        indexByteSize += IndexEntryFixedSize + sourceFile.RelativePath.size();
+    }
+
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(sourceFiles.size());
+
+    std::uint64_t offset = HeaderSize + indexByteSize;
+    for (auto const & sourceFile : sourceFiles)
+    {
+        offset = AlignEntryOffset(offset);
+        offsets.push_back(offset);
+        offset += sourceFile.Size;
+    }
+
+    //
+    // Write
+    //
+
+    std::ofstream file(archiveFilePath.string(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw GameException("Cannot open file \"" + archiveFilePath.string() + "\" for writing");
+    }
+
+    file.write(ArchiveMagic, sizeof(ArchiveMagic));
+    BinaryFileTools::Write<std::uint32_t>(file, ArchiveVersion);
+    BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(sourceFiles.size()));
+    BinaryFileTools::Write<std::uint32_t>(file, static_cast<std::uint32_t>(indexByteSize));
+
+    for (size_t f = 0; f < sourceFiles.size(); ++f)
+    {
+        BinaryFileTools::Write<std::uint64_t>(file, offsets[f]);
+        BinaryFileTools::Write<std::uint64_t>(file, sourceFiles[f].Size);
+        BinaryFileTools::WriteString(file, sourceFiles[f].RelativePath);
+    }
+
+    std::vector<char> fileContents;
+    for (size_t f = 0; f < sourceFiles.size(); ++f)
+    {
+        // Pad
+        std::uint64_t const currentOffset = static_cast<std::uint64_t>(file.tellp());
+        assert(currentOffset <= offsets[f]);
+        for (std::uint64_t p = currentOffset; p < offsets[f]; ++p)
+            file.put('\0');
+
+        std::ifstream sourceFile(sourceFiles[f].FilePath, std::ios::binary | std::ios::in);
+        fileContents.resize(static_cast<size_t>(sourceFiles[f].Size));
+        sourceFile.read(fileContents.data(), fileContents.size());
+        if (!sourceFile)
+        {
+            throw GameException("Cannot read file \"" + sourceFiles[f].FilePath.string() + "\"");
+        }
+
+        file.write(fileContents.data(), fileContents.size());
+    }
+
+    if (!file.good())
+    {
+        throw GameException("Error writing file \"" + archiveFilePath.string() + "\"");
+    }
+
+    return sourceFiles.size();
+}
+
+std::unique_ptr<ResourceArchive> ResourceArchive::Open(std::filesystem::path const & archiveFilePath)
+{
+    auto mappedFile = std::make_unique<MappedFile>(archiveFilePath);
+
+    std::uint8_t const * const data = mappedFile->Memory;
+    size_t const fileSize = mappedFile->Size;
+
+    //
+    // Header
+    //
+
+    if (fileSize < HeaderSize || 0 != std::memcmp(data, ArchiveMagic, sizeof(ArchiveMagic)))
+    {
+        throw GameException("File \"" + archiveFilePath.string() + "\" is not a resource archive");
+    }
+
+    size_t offset = sizeof(ArchiveMagic);
+
+    if (ReadMapped<std::uint32_t>(data, offset) != ArchiveVersion)
+    {
+        throw GameException("File \"" + archiveFilePath.string() + "\" is a resource archive of an unsupported version");
+    }
+
+    std::uint32_t const entryCount = ReadMapped<std::uint32_t>(data, offset);
+    std::uint32_t const indexByteSize = ReadMapped<std::uint32_t>(data, offset);
+
+    size_t const indexEnd = HeaderSize + static_cast<size_t>(indexByteSize);
+    if (indexEnd > fileSize)
+    {
+        throw GameException("Resource archive \"" + archiveFilePath.string() + "\" is truncated");
+    }
+
+    //
+    // Index
+    //
+
+    std::vector<IndexEntry> index;
+    index.reserve(entryCount);
+
+    for (std::uint32_t e = 0; e < entryCount; ++e)
+    {
+        if (offset + IndexEntryFixedSize > indexEnd)
+        {
+            throw GameException("Resource archive \"" + archiveFilePath.string() + "\" has a corrupted index");
+        }
+
+        std::uint64_t const entryOffset = ReadMapped<std::uint64_t>(data, offset);
+        std::uint64_t const entrySize = ReadMapped<std::uint64_t>(data, offset);
+        std::uint32_t const pathLength = ReadMapped<std::uint32_t>(data, offset);
+
+        if (offset + pathLength > indexEnd
+            || entryOffset > fileSize
+            || entrySize > fileSize - entryOffset)
+        {
+            throw GameException("Resource archive \"" + archiveFilePath.string() + "\" has a corrupted index");
+        }
+
+        index.emplace_back(
+            std::string(reinterpret_cast<char const *>(data + offset), pathLength),
+            entryOffset,
+            entrySize);
+
+        offset += pathLength;
+    }
+
+    if (!std::is_sorted(
+        index.cbegin(),
+        index.cend(),
+        [](IndexEntry const & lhs, IndexEntry const & rhs)
+        {
+            return lhs.Path < rhs.Path;
+        }))
+    {
+        throw GameException("Resource archive \"" + archiveFilePath.string() + "\" has a corrupted index");
+    }
+
+    return std::unique_ptr<ResourceArchive>(
+        new ResourceArchive(
+            std::move(mappedFile),
+            std::move(index)));
+}
+
+std::optional<ResourceArchive::Entry> ResourceArchive::Find(std::string const & relativePath) const
+{
+    auto const it = std::lower_bound(
+        mIndex.cbegin(),
+        mIndex.cend(),
+        relativePath,
+        [](IndexEntry const & indexEntry, std::string const & path)
+        {
+            return indexEntry.Path < path;
+        });
+
+    if (it == mIndex.cend() || it->Path != relativePath)
+        return std::nullopt;
+
+    return Entry(
+        mMappedFile->Memory + it->Offset,
+        static_cast<size_t>(it->Size));
+}
+
+std::vector<std::string> ResourceArchive::List(std::string const & relativeDirectoryPath) const
+{
+    std::string const prefix = relativeDirectoryPath.empty() || relativeDirectoryPath.back() == '/'
+        ? relativeDirectoryPath
+        : relativeDirectoryPath + '/';
+
+    std::vector<std::string> paths;
+
+    // Entries are sorted, hence the ones in the directory are contiguous
+    auto it = std::lower_bound(
+        mIndex.cbegin(),
+        mIndex.cend(),
+        prefix,
+        [](IndexEntry const & indexEntry, std::string const & path)
+        {
+            return indexEntry.Path < path;
+        });
+
+    for (; it != mIndex.cend() && 0 == it->Path.compare(0, prefix.size(), prefix); ++it)
+    {
+        // Only direct children
+        if (std::string::npos == it->Path.find('/', prefix.size()))
+        {
+            paths.push_back(it->Path);
+        }
+    }
+
+    return paths;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Mounting
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ResourceArchive::Mount(
+    std::unique_ptr<ResourceArchive> archive,
+    std::filesystem::path const & rootDirectoryPath)
+{
+    LogMessage("ResourceArchive: mounting ", archive->GetEntryCount(), " entries in place of \"", rootDirectoryPath.string(), "\"");
+
+    GetMountPoint().emplace(
+        std::move(archive),
+        std::filesystem::absolute(rootDirectoryPath).lexically_normal());
+}
+
+void ResourceArchive::Unmount()
+{
+    GetMountPoint().reset();
+}
+
+std::optional<ResourceArchive::Entry> ResourceArchive::FindMounted(std::filesystem::path const & filePath)
+{
+    auto const relativePath = MakeMountedRelativePath(filePath);
+    if (!relativePath)
+        return std::nullopt;
+
+    return GetMountPoint()->Archive->Find(*relativePath);
+}
+
+bool ResourceArchive::Exists(std::filesystem::path const & path)
+{
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec))
+        return true;
+
+    auto const relativePath = MakeMountedRelativePath(path);
+    if (!relativePath)
+        return false;
+
+    auto const & archive = *(GetMountPoint()->Archive);
+    return !!archive.Find(*relativePath) || !archive.List(*relativePath).empty();
+}
+
+std::vector<std::filesystem::path> ResourceArchive::ListDirectory(std::filesystem::path const & directoryPath)
+{
+    std::vector<std::filesystem::path> filePaths;
+
+    // Loose files first; the directory may well not exist when everything is in the archive
+    std::error_code ec;
+    for (auto const & entryIt : std::filesystem::directory_iterator(directoryPath, ec))
+    {
+        if (entryIt.is_regular_file(ec))
+        {
+            filePaths.push_back(entryIt.path());
+        }
+    }
+
+    auto const relativeDirectoryPath = MakeMountedRelativePath(directoryPath);
+    if (!!relativeDirectoryPath)
+    {
+        for (auto const & relativePath : GetMountPoint()->Archive->List(*relativeDirectoryPath))
+        {
+            std::filesystem::path const filename = std::filesystem::path(relativePath).filename();
+
+            bool const isOverridden = std::any_of(
+                filePaths.cbegin(),
+                filePaths.cend(),
+                [&filename](std::filesystem::path const & filePath)
+                {
+                    return filePath.filename() == filename;
+                });
+
+            if (!isOverridden)
+            {
+                filePaths.push_back(directoryPath / filename);
+            }
+        }
+    }
+
+    std::sort(filePaths.begin(), filePaths.end());
+
+    return filePaths;
+}
+
+std::optional<std::string> ResourceArchive::MakeMountedRelativePath(std::filesystem::path const & filePath)
+{
+    auto const & mountPoint = GetMountPoint();
+    if (!mountPoint)
+        return std::nullopt;
+
+    std::error_code ec;
+    auto const relativePath = std::filesystem::absolute(filePath, ec).lexically_normal().lexically_relative(mountPoint->RootDirectoryPath);
+    if (!!ec || relativePath.empty() || *relativePath.begin() == "..")
+        return std::nullopt;
+
+    std::string relativePathStr = relativePath.generic_string();
+    if (relativePathStr == ".")
+        relativePathStr.clear();
+
+    return relativePathStr;
+}
+
+std::optional<ResourceArchive::MountPoint> & ResourceArchive::GetMountPoint()
+{
+    static std::optional<MountPoint> * mountPoint = new std::optional<MountPoint>();
+
+    return *mountPoint;
+}
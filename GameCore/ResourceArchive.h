@@ -0,0 +1,173 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-11
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * A read-only archive packing all the files of a resource directory - e.g. Data - into
+ * a single file, so that a cold start reads one file sequentially instead of opening
+ * and reading hundreds of small ones.
+ *
+ * The archive starts with a directory index - sorted by path - followed by the contents
+ * of the files, each aligned so that it may be used in place: the archive is memory-mapped
+ * and its entries are views of the mapping, valid as long as the archive is.
+ *
+ * An archive is mounted in place of the directory it was built from; loose files in that
+ * directory take precedence over the archive, so that resources may still be edited
+ * during development without rebuilding the archive.
+ */
+class ResourceArchive
+{
+public:
+
+    static constexpr char const * FileExtension = ".fsra";
+
+    // Alignment of the contents of each entry
+    static constexpr size_t EntryAlignment = 64;
+
+    struct Entry
+    {
+        void const * Data;
+        size_t Size;
+
+        Entry(
+            void const * data,
+            size_t size)
+            : Data(data)
+            , Size(size)
+        {}
+    };
+
+    /*
+     * Lets the contents of an entry be read as a stream, in place.
+     */
+    class EntryStreamBuffer : public std::streambuf
+    {
+    public:
+
+        explicit EntryStreamBuffer(Entry const & entry)
+        {
+            char * const begin = const_cast<char *>(static_cast<char const *>(entry.Data));
+            setg(begin, begin, begin + entry.Size);
+        }
+    };
+
+    ~ResourceArchive();
+
+    /*
+     * Packs all the files under the specified directory - recursively - into a new archive,
+     * returning the number of files packed.
+     */
+    static size_t Build(
+        std::filesystem::path const & rootDirectoryPath,
+        std::filesystem::path const & archiveFilePath);
+
+    static std::unique_ptr<ResourceArchive> Open(std::filesystem::path const & archiveFilePath);
+
+    /*
+     * Paths are relative to the root directory of the archive, e.g. "Textures/textures.json".
+     */
+    std::optional<Entry> Find(std::string const & relativePath) const;
+
+    /*
+     * Returns the relative paths of the files directly in the specified directory.
+     */
+    std::vector<std::string> List(std::string const & relativeDirectoryPath) const;
+
+    size_t GetEntryCount() const
+    {
+        return mIndex.size();
+    }
+
+    //
+    // Mounting
+    //
+
+    /*
+     * Mounts the archive in place of the specified directory, replacing any archive
+     * mounted before; not thread-safe, meant to be invoked once at startup.
+     */
+    static void Mount(
+        std::unique_ptr<ResourceArchive> archive,
+        std::filesystem::path const & rootDirectoryPath);
+
+    static void Unmount();
+
+    /*
+     * Looks up a file in the mounted archive - if any - by its path on disk; callers
+     * are expected to try the loose file first.
+     */
+    static std::optional<Entry> FindMounted(std::filesystem::path const & filePath);
+
+    /*
+     * Whether the file - or the directory - exists, either loose or in the mounted archive.
+     */
+    static bool Exists(std::filesystem::path const & path);
+
+    /*
+     * Returns the paths of the regular files directly in the specified directory, both
+     * loose and in the mounted archive, with the loose files taking precedence.
+     */
+    static std::vector<std::filesystem::path> ListDirectory(std::filesystem::path const & directoryPath);
+
+private:
+
+    struct MappedFile;
+
+    struct IndexEntry
+    {
+        std::string Path;
+        std::uint64_t Offset;
+        std::uint64_t Size;
+
+        IndexEntry(
+            std::string path,
+            std::uint64_t offset,
+            std::uint64_t size)
+            : Path(std::move(path))
+            , Offset(offset)
+            , Size(size)
+        {}
+    };
+
+    ResourceArchive(
+        std::unique_ptr<MappedFile> mappedFile,
+        std::vector<IndexEntry> && index);
+
+    // Returns the path relative to the mounted root, or nothing if the path is outside of it
+    static std::optional<std::string> MakeMountedRelativePath(std::filesystem::path const & filePath);
+
+private:
+
+    std::unique_ptr<MappedFile> mMappedFile;
+
+    // Sorted by path
+    std::vector<IndexEntry> const mIndex;
+
+    struct MountPoint
+    {
+        std::unique_ptr<ResourceArchive> Archive;
+        std::filesystem::path RootDirectoryPath; // Absolute
+
+        MountPoint(
+            std::unique_ptr<ResourceArchive> archive,
+            std::filesystem::path rootDirectoryPath)
+            : Archive(std::move(archive))
+            , RootDirectoryPath(std::move(rootDirectoryPath))
+        {}
+    };
+
+    static std::optional<MountPoint> & GetMountPoint();
+};
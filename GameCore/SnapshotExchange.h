@@ -0,0 +1,124 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-28
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+/*
+ * Hands snapshots of a value from one writer thread over to one reader thread,
+ * without locks.
+ *
+ * The writer publishes copies of its staging value; the reader picks up the latest
+ * published copy whenever it wants to, and from then on reads it undisturbed - the
+ * writer never touches the snapshot that the reader is holding on to, nor the one
+ * it's writing into. Each published snapshot carries a generation number, increasing
+ * by one at each publish.
+ *
+ * Internally there are three slots - the writer's, the reader's, and the latest
+ * published one - and publishing and picking up merely swap slot indices.
+ */
+template<typename T>
+class SnapshotExchange
+{
+public:
+
+    explicit SnapshotExchange(T const & initialValue)
+        : mSlots{ initialValue, initialValue, initialValue }
+        , mGenerations{ 0, 0, 0 }
+        , mPublishedSlot(1)
+        , mWriterSlot(2)
+        , mWriterGeneration(0)
+        , mReaderSlot(0)
+    {
+    }
+
+    SnapshotExchange(SnapshotExchange const &) = delete;
+    SnapshotExchange & operator=(SnapshotExchange const &) = delete;
+
+    //
+    // Writer side
+    //
+
+    /*
+     * Publishes a snapshot of the specified value, replacing the previously-published
+     * one if the reader hasn't picked that up yet. Returns the snapshot's generation.
+     */
+    uint64_t Publish(T const & value)
+    {
+        mSlots[mWriterSlot] = value;
+        mGenerations[mWriterSlot] = ++mWriterGeneration;
+
+        uint8_t const previousPublishedSlot = mPublishedSlot.exchange(
+            mWriterSlot | NewSnapshotBit,
+            std::memory_order_acq_rel);
+
+        mWriterSlot = previousPublishedSlot & SlotMask;
+
+        return mWriterGeneration;
+    }
+
+    //
+    // Reader side
+    //
+
+    /*
+     * Makes the latest published snapshot the current one, if it's newer than the
+     * current one. Returns true if the current snapshot has changed.
+     */
+    bool PickUp()
+    {
+        if (0 == (mPublishedSlot.load(std::memory_order_relaxed) & NewSnapshotBit))
+            return false;
+
+        uint8_t const publishedSlot = mPublishedSlot.exchange(
+            mReaderSlot,
+            std::memory_order_acq_rel);
+
+        mReaderSlot = publishedSlot & SlotMask;
+
+        assert(mReaderSlot < mSlots.size());
+
+        return true;
+    }
+
+    /*
+     * The snapshot last picked up; stays untouched until the next PickUp().
+     */
+    T const & GetCurrent() const
+    {
+        return mSlots[mReaderSlot];
+    }
+
+    /*
+     * The generation of the snapshot last picked up; zero for the initial value.
+     */
+    uint64_t GetCurrentGeneration() const
+    {
+        return mGenerations[mReaderSlot];
+    }
+
+private:
+
+    static constexpr uint8_t SlotMask = 0x03;
+    static constexpr uint8_t NewSnapshotBit = 0x04;
+
+    std::array<T, 3> mSlots;
+    std::array<uint64_t, 3> mGenerations;
+
+    // The slot with the latest published snapshot, plus whether
+    // it has been published after the reader's last pick-up
+    std::atomic<uint8_t> mPublishedSlot;
+
+    // Only touched by the writer
+    uint8_t mWriterSlot;
+    uint64_t mWriterGeneration;
+
+    // Only touched by the reader
+    uint8_t mReaderSlot;
+};
@@ -27,11 +27,17 @@ inline void aligned_free(void * ptr)
 
 #include <cstdlib>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 inline void * aligned_alloc(
     size_t alignment,
     size_t size)
 {
-    return std::aligned_alloc(alignment, size);
+    // Not std::aligned_alloc(): this very function is the C library's aligned_alloc()
+    void * ptr = nullptr;
+    return 0 == posix_memalign(&ptr, alignment, size) ? ptr : nullptr;
 }
 
 inline void aligned_free(void * ptr)
@@ -43,6 +49,43 @@ inline void aligned_free(void * ptr)
 
 #endif
 
+// The size of a cache line, which is also at least the width of the widest vector registers
+static constexpr size_t CacheLineSize = 64;
+
+// The size of the huge pages that large buffers are carved out of, when the OS
+// backs memory with them transparently
+static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+/*
+ * Allocates storage for bulk data, aligned to at least the cache line, with the size
+ * rounded up to the alignment; the storage is freed with aligned_free().
+ *
+ * Storage of at least a huge page is aligned to huge pages and - on Linux - advised to be
+ * backed by them, so that walking the large buffers of large ships doesn't thrash the TLB.
+ */
+inline void * aligned_alloc_bulk(
+    size_t alignment,
+    size_t size)
+{
+    size_t const bulkAlignment = size >= HugePageSize
+        ? HugePageSize
+        : (alignment > CacheLineSize ? alignment : CacheLineSize);
+
+    size_t const bulkSize = (size + bulkAlignment - 1) / bulkAlignment * bulkAlignment;
+
+    void * const ptr = aligned_alloc(bulkAlignment, bulkSize);
+
+#ifdef __linux__
+    if (nullptr != ptr && bulkAlignment == HugePageSize)
+    {
+        // Just a hint; ignored when transparent huge pages are disabled
+        madvise(ptr, bulkSize, MADV_HUGEPAGE);
+    }
+#endif
+
+    return ptr;
+}
+
 // Targeting AVX-512
 static constexpr size_t VectorizationWordSize = 8; // Number of elements, not bytes
 
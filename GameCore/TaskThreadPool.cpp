@@ -0,0 +1,393 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-05
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "TaskThreadPool.h"
+
+#include "FloatingPoint.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cassert>
+
+// Whether the current thread is running a task of a batch
+static thread_local bool IsRunningTask = false;
+
+// The number of times an idle worker checks for a new batch before going to sleep;
+// the mechanical dynamics submit batches in bursts, and we don't want to pay for
+// a context switch between each batch of a burst
+static constexpr int IdleSpinCount = 2000;
+
+TaskThreadPool::TaskThreadPool(size_t parallelism)
+    : mThreads()
+    , mParallelism(1)
+    , mMutex()
+    , mBatchAvailableSignal()
+    , mBatchCompletedSignal()
+    , mCurrentBatchTasks(nullptr)
+    , mCurrentBatchSequenceNumber(0)
+    , mNextTaskIndex(0)
+    , mCompletedTaskCount(0)
+    , mActiveWorkerCount(0)
+    , mCurrentBatchException()
+    , mLatestBatchSequenceNumber(0)
+    , mIsStopping(false)
+    , mRunMutex()
+{
+    assert(parallelism >= 1);
+
+    StartThreads(parallelism);
+
+    LogMessage("TaskThreadPool: created with parallelism=", parallelism);
+}
+
+TaskThreadPool::~TaskThreadPool()
+{
+    StopThreads();
+}
+
+void TaskThreadPool::SetParallelism(size_t parallelism)
+{
+    // We'd wait for ourselves otherwise
+    assert(!IsRunningTask);
+
+    if (parallelism == 0)
+        parallelism = CalculateDefaultParallelism();
+
+    // Keep batches away while we swap the threads
+    std::lock_guard<std::mutex> runLock(mRunMutex);
+
+    if (parallelism == GetParallelism())
+        return;
+
+    StopThreads();
+    StartThreads(parallelism);
+
+    LogMessage("TaskThreadPool: parallelism changed to ", parallelism);
+}
+
+void TaskThreadPool::Run(std::vector<Task> const & tasks)
+{
+    if (tasks.empty())
+        return;
+
+    //
+    // Run inline when there's no point in waking up workers, when we're
+    // being invoked from within a task, or when another thread is already
+    // running a batch - or changing the parallelism
+    //
+
+    if (tasks.size() == 1 || GetParallelism() == 1 || IsRunningTask)
+    {
+        RunTasksInline(tasks);
+        return;
+    }
+
+    std::unique_lock<std::mutex> runLock(mRunMutex, std::try_to_lock);
+    if (!runLock.owns_lock()
+        || mThreads.empty()) // Threads are only swapped under the run lock
+    {
+        RunTasksInline(tasks);
+        return;
+    }
+
+    //
+    // Publish batch
+    //
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        assert(nullptr == mCurrentBatchTasks);
+        assert(0 == mActiveWorkerCount);
+
+        mCurrentBatchTasks = &tasks;
+        mNextTaskIndex = 0;
+        mCompletedTaskCount = 0;
+        mCurrentBatchException = nullptr;
+
+        ++mCurrentBatchSequenceNumber;
+        mLatestBatchSequenceNumber.store(mCurrentBatchSequenceNumber, std::memory_order_release);
+    }
+
+    mBatchAvailableSignal.notify_all();
+
+    //
+    // Run our share of the batch
+    //
+
+    RunTasks(tasks);
+
+    //
+    // Wait until all tasks have completed and all workers have left the batch
+    //
+
+    std::exception_ptr batchException;
+
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        mBatchCompletedSignal.wait(
+            lock,
+            [this, &tasks]()
+            {
+                return mCompletedTaskCount == tasks.size() && 0 == mActiveWorkerCount;
+            });
+
+        mCurrentBatchTasks = nullptr;
+
+        batchException = mCurrentBatchException;
+        mCurrentBatchException = nullptr;
+    }
+
+    if (!!batchException)
+    {
+        std::rethrow_exception(batchException);
+    }
+}
+
+void TaskThreadPool::ParallelFor(
+    size_t begin,
+    size_t end,
+    size_t grain,
+    RangeFunction const & function,
+    Partitioning partitioning)
+{
+    assert(begin <= end);
+
+    grain = std::max(grain, size_t(1));
+
+    size_t const chunkCount = (end - begin + grain - 1) / grain;
+    size_t const taskCount = std::min(GetParallelism(), chunkCount);
+
+    if (taskCount <= 1)
+    {
+        if (begin < end)
+        {
+            RunTasksInline({ [&]() { function(begin, end); } });
+        }
+
+        return;
+    }
+
+    std::vector<Task> tasks;
+    tasks.reserve(taskCount);
+
+    // Lives until all tasks have completed, as Run waits for them
+    std::atomic<size_t> nextChunk(0);
+
+    for (size_t t = 0; t < taskCount; ++t)
+    {
+        if (partitioning == Partitioning::Dynamic)
+        {
+            tasks.emplace_back(
+                [&]()
+                {
+                    for (size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                        chunk < chunkCount;
+                        chunk = nextChunk.fetch_add(1, std::memory_order_relaxed))
+                    {
+                        size_t const chunkBegin = begin + chunk * grain;
+                        function(chunkBegin, std::min(chunkBegin + grain, end));
+                    }
+                });
+        }
+        else
+        {
+            assert(partitioning == Partitioning::Static);
+
+            size_t const partBegin = begin + (chunkCount * t / taskCount) * grain;
+            size_t const partEnd = std::min(begin + (chunkCount * (t + 1) / taskCount) * grain, end);
+
+            tasks.emplace_back(
+                [&function, partBegin, partEnd]()
+                {
+                    function(partBegin, partEnd);
+                });
+        }
+    }
+
+    Run(tasks);
+}
+
+size_t TaskThreadPool::CalculateDefaultParallelism()
+{
+    return std::max(
+        static_cast<size_t>(std::thread::hardware_concurrency()),
+        size_t(1));
+}
+
+void TaskThreadPool::StartThreads(size_t parallelism)
+{
+    assert(mThreads.empty());
+
+    mIsStopping = false;
+
+    for (size_t t = 1; t < parallelism; ++t)
+    {
+        mThreads.emplace_back(&TaskThreadPool::ThreadLoop, this);
+    }
+
+    mParallelism.store(parallelism, std::memory_order_relaxed);
+}
+
+void TaskThreadPool::StopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mIsStopping = true;
+    }
+
+    mBatchAvailableSignal.notify_all();
+
+    for (auto & thread : mThreads)
+    {
+        thread.join();
+    }
+
+    mThreads.clear();
+}
+
+void TaskThreadPool::ThreadLoop()
+{
+    // Our tasks are simulation code
+    InitializeSimulationThreadFloatingPoint();
+
+    uint64_t lastSeenBatchSequenceNumber = 0;
+
+    while (true)
+    {
+        //
+        // Spin for a while, waiting for a new batch
+        //
+
+        for (int spin = 0;
+            spin < IdleSpinCount && mLatestBatchSequenceNumber.load(std::memory_order_acquire) == lastSeenBatchSequenceNumber;
+            ++spin)
+        {
+            std::this_thread::yield();
+        }
+
+        //
+        // Join the new batch, or wait for one
+        //
+
+        std::vector<Task> const * tasks;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+
+            mBatchAvailableSignal.wait(
+                lock,
+                [this, lastSeenBatchSequenceNumber]()
+                {
+                    return mIsStopping || mCurrentBatchSequenceNumber != lastSeenBatchSequenceNumber;
+                });
+
+            if (mIsStopping)
+                return;
+
+            lastSeenBatchSequenceNumber = mCurrentBatchSequenceNumber;
+
+            if (nullptr == mCurrentBatchTasks)
+            {
+                // The batch has been completed already without us
+                continue;
+            }
+
+            tasks = mCurrentBatchTasks;
+
+            ++mActiveWorkerCount;
+        }
+
+        RunTasks(*tasks);
+
+        //
+        // Leave the batch
+        //
+
+        bool isLastToLeave;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            assert(mActiveWorkerCount > 0);
+            --mActiveWorkerCount;
+
+            isLastToLeave = (0 == mActiveWorkerCount && mCompletedTaskCount == tasks->size());
+        }
+
+        if (isLastToLeave)
+        {
+            mBatchCompletedSignal.notify_one();
+        }
+    }
+}
+
+void TaskThreadPool::RunTasks(std::vector<Task> const & tasks)
+{
+    IsRunningTask = true;
+
+    while (true)
+    {
+        size_t const taskIndex = mNextTaskIndex.fetch_add(1);
+        if (taskIndex >= tasks.size())
+            break;
+
+        std::exception_ptr taskException;
+
+        try
+        {
+            tasks[taskIndex]();
+        }
+        catch (...)
+        {
+            taskException = std::current_exception();
+        }
+
+        bool isBatchCompleted;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            if (!!taskException && !mCurrentBatchException)
+            {
+                mCurrentBatchException = taskException;
+            }
+
+            ++mCompletedTaskCount;
+
+            isBatchCompleted = (mCompletedTaskCount == tasks.size() && 0 == mActiveWorkerCount);
+        }
+
+        if (isBatchCompleted)
+        {
+            mBatchCompletedSignal.notify_one();
+        }
+    }
+
+    IsRunningTask = false;
+}
+
+void TaskThreadPool::RunTasksInline(std::vector<Task> const & tasks)
+{
+    bool const wasRunningTask = IsRunningTask;
+    IsRunningTask = true;
+
+    try
+    {
+        for (auto const & task : tasks)
+        {
+            task();
+        }
+    }
+    catch (...)
+    {
+        IsRunningTask = wasRunningTask;
+        throw;
+    }
+
+    IsRunningTask = wasRunningTask;
+}
@@ -0,0 +1,201 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-01-05
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * A fixed-size pool of worker threads that runs batches of tasks in a fork-join fashion:
+ * the caller submits a batch of tasks and blocks until all of them have completed.
+ *
+ * The calling thread also takes part in running the tasks of its batch, hence a pool
+ * with a parallelism of N only spawns N-1 worker threads.
+ *
+ * Batches submitted from within a task - or while another thread is running a batch -
+ * are run inline, sequentially, on the submitting thread.
+ *
+ * The pool makes no guarantees on the order in which tasks are run, nor on the thread
+ * that runs each task; callers that need deterministic results must ensure that tasks
+ * within a batch do not depend on each other.
+ *
+ * On top of batches the pool offers ParallelFor, which splits a range of indices across
+ * the pool, and task groups, which collect tasks to be run together.
+ *
+ * Singleton; its parallelism may be changed at any time other than from within a task.
+ */
+class TaskThreadPool
+{
+public:
+
+    using Task = std::function<void()>;
+
+    // Invoked with a sub-range [begin, end) of a ParallelFor's range
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    enum class Partitioning
+    {
+        // The range is cut into chunks of grain indices, which threads claim as they go;
+        // balances uneven work
+        Dynamic,
+
+        // The range is cut up front into one contiguous part per thread, each a multiple
+        // of grain indices long; the parts only depend on the range, the grain, and the
+        // parallelism, hence for a given parallelism each index always ends up in the
+        // same part
+        Static
+    };
+
+    /*
+     * Collects tasks to be run together on a pool.
+     */
+    class TaskGroup
+    {
+    public:
+
+        explicit TaskGroup(TaskThreadPool & pool)
+            : mPool(pool)
+            , mTasks()
+        {}
+
+        ~TaskGroup()
+        {
+            // Tasks must have been waited for
+            assert(mTasks.empty());
+        }
+
+        TaskGroup(TaskGroup const &) = delete;
+        TaskGroup & operator=(TaskGroup const &) = delete;
+
+        void Add(Task task)
+        {
+            mTasks.emplace_back(std::move(task));
+        }
+
+        /*
+         * Runs all the tasks added so far, returning when all of them have completed;
+         * the group may then be reused.
+         */
+        void Wait()
+        {
+            std::vector<Task> tasks;
+            tasks.swap(mTasks);
+
+            mPool.Run(tasks);
+        }
+
+    private:
+
+        TaskThreadPool & mPool;
+        std::vector<Task> mTasks;
+    };
+
+public:
+
+    static TaskThreadPool & GetInstance()
+    {
+        static TaskThreadPool * instance = new TaskThreadPool(CalculateDefaultParallelism());
+
+        return *instance;
+    }
+
+    explicit TaskThreadPool(size_t parallelism);
+
+    ~TaskThreadPool();
+
+    TaskThreadPool(TaskThreadPool const &) = delete;
+    TaskThreadPool(TaskThreadPool &&) = delete;
+    TaskThreadPool & operator=(TaskThreadPool const &) = delete;
+    TaskThreadPool & operator=(TaskThreadPool &&) = delete;
+
+    /*
+     * The number of threads that may concurrently run the tasks of a batch,
+     * including the calling thread.
+     */
+    size_t GetParallelism() const
+    {
+        return mParallelism.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Changes the number of threads that run batches, waiting for the batch in progress - if
+     * any - to complete; zero stands for the default, i.e. one thread per core.
+     */
+    void SetParallelism(size_t parallelism);
+
+    static size_t CalculateDefaultParallelism();
+    /*
+     * Runs all the specified tasks and returns when all of them have completed.
+     *
+     * If any task throws, the first exception caught is re-thrown here after
+     * all the other tasks have completed.
+     */
+    void Run(std::vector<Task> const & tasks);
+
+    /*
+     * Invokes the function on sub-ranges that together cover [begin, end) exactly once,
+     * returning when all of them have completed; ranges of no more than grain indices
+     * are run inline.
+     *
+     * Exceptions are treated as with Run.
+     */
+    void ParallelFor(
+        size_t begin,
+        size_t end,
+        size_t grain,
+        RangeFunction const & function,
+        Partitioning partitioning = Partitioning::Dynamic);
+
+private:
+
+    void StartThreads(size_t parallelism);
+
+    void StopThreads();
+
+    void ThreadLoop();
+
+    void RunTasks(std::vector<Task> const & tasks);
+
+    static void RunTasksInline(std::vector<Task> const & tasks);
+
+private:
+
+    std::vector<std::thread> mThreads;
+    std::atomic<size_t> mParallelism;
+
+    // Protects all of the batch state below
+    std::mutex mMutex;
+
+    // Signalled when a new batch is available, or when we're stopping
+    std::condition_variable mBatchAvailableSignal;
+
+    // Signalled when the current batch has been completed
+    std::condition_variable mBatchCompletedSignal;
+
+    // The current batch; only valid while a Run is in progress
+    std::vector<Task> const * mCurrentBatchTasks;
+    uint64_t mCurrentBatchSequenceNumber;
+    std::atomic<size_t> mNextTaskIndex;
+    size_t mCompletedTaskCount;
+    size_t mActiveWorkerCount;
+    std::exception_ptr mCurrentBatchException;
+
+    // Mirrors mCurrentBatchSequenceNumber, so that idle workers may spin on it
+    // for a little while before going to sleep
+    std::atomic<uint64_t> mLatestBatchSequenceNumber;
+
+    bool mIsStopping;
+
+    // Serializes batches submitted concurrently by different threads
+    std::mutex mRunMutex;
+};
@@ -0,0 +1,226 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-02
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "TelemetryRing.h"
+
+#include "GameException.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/*
+ * A named region of memory shared with other processes, which goes away once
+ * nobody maps it anymore.
+ */
+struct TelemetryRing::SharedMemory
+{
+#ifdef _WIN32
+
+    SharedMemory(
+        std::string const & name,
+        size_t byteSize)
+    {
+        mMappingHandle = CreateFileMappingA(
+            INVALID_HANDLE_VALUE,
+            NULL,
+            PAGE_READWRITE,
+            0,
+            static_cast<DWORD>(byteSize),
+            name.c_str());
+
+        if (NULL == mMappingHandle)
+        {
+            throw GameException("Cannot create shared memory \"" + name + "\": error " + std::to_string(GetLastError()));
+        }
+
+        Memory = MapViewOfFile(mMappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, byteSize);
+        if (NULL == Memory)
+        {
+            CloseHandle(mMappingHandle);
+            throw GameException("Cannot map shared memory \"" + name + "\": error " + std::to_string(GetLastError()));
+        }
+    }
+
+    ~SharedMemory()
+    {
+        UnmapViewOfFile(Memory);
+        CloseHandle(mMappingHandle);
+    }
+
+    void * Memory;
+
+private:
+
+    HANDLE mMappingHandle;
+
+#else
+
+    SharedMemory(
+        std::string const & name,
+        size_t byteSize)
+        : mName("/" + name)
+        , mByteSize(byteSize)
+    {
+        int const fd = shm_open(mName.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0)
+        {
+            throw GameException("Cannot create shared memory \"" + name + "\": error " + std::to_string(errno));
+        }
+
+        if (0 != ftruncate(fd, static_cast<off_t>(byteSize)))
+        {
+            int const error = errno;
+            close(fd);
+            shm_unlink(mName.c_str());
+            throw GameException("Cannot size shared memory \"" + name + "\": error " + std::to_string(error));
+        }
+
+        Memory = mmap(nullptr, byteSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        // The mapping keeps the memory alive
+        close(fd);
+
+        if (MAP_FAILED == Memory)
+        {
+            int const error = errno;
+            shm_unlink(mName.c_str());
+            throw GameException("Cannot map shared memory \"" + name + "\": error " + std::to_string(error));
+        }
+    }
+
+    ~SharedMemory()
+    {
+        munmap(Memory, mByteSize);
+
+        // Readers that have it mapped keep it until they unmap it
+        shm_unlink(mName.c_str());
+    }
+
+    void * Memory;
+
+private:
+
+    std::string const mName;
+    size_t const mByteSize;
+
+#endif
+};
+
+std::unique_ptr<TelemetryRing> TelemetryRing::CreateShared(
+    std::string const & name,
+    size_t recordCount)
+{
+    auto sharedMemory = std::make_unique<SharedMemory>(
+        name,
+        CalculateByteSize(recordCount));
+
+    auto ring = std::make_unique<TelemetryRing>(
+        sharedMemory->Memory,
+        recordCount);
+
+    ring->mSharedMemory = std::move(sharedMemory);
+
+    return ring;
+}
+
+TelemetryRing::TelemetryRing(
+    void * memory,
+    size_t recordCount)
+    : mSharedMemory()
+    , mHeader(reinterpret_cast<Header *>(memory))
+    , mMemory(memory)
+    , mRecordCount(recordCount)
+{
+    assert(recordCount > 0);
+    assert(0 == reinterpret_cast<std::uintptr_t>(memory) % 64);
+
+    std::memset(memory, 0, CalculateByteSize(recordCount));
+
+    for (size_t s = 0; s < recordCount; ++s)
+    {
+        new (&(GetSlot(memory, s)->Sequence)) std::atomic<std::uint64_t>(0);
+    }
+
+    new (&(mHeader->WriteCount)) std::atomic<std::uint64_t>(0);
+    mHeader->RecordStride = static_cast<std::uint32_t>(RecordStride);
+    mHeader->RecordCount = static_cast<std::uint32_t>(recordCount);
+    mHeader->Version = Version;
+
+    // Readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    mHeader->Magic = Magic;
+}
+
+TelemetryRing::~TelemetryRing()
+{
+}
+
+void TelemetryRing::Write(TelemetryRecord const & record)
+{
+    // We're the only writer
+    std::uint64_t const n = mHeader->WriteCount.load(std::memory_order_relaxed);
+
+    Slot * const slot = GetSlot(mMemory, static_cast<size_t>(n % mRecordCount));
+
+    // Tell readers that the slot is being overwritten...
+    slot->Sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(&(slot->Record), &record, sizeof(TelemetryRecord));
+
+    // ...and that it's done
+    slot->Sequence.store(2 * (n + 1), std::memory_order_release);
+
+    mHeader->WriteCount.store(n + 1, std::memory_order_release);
+}
+
+bool TelemetryRing::ReadLatest(
+    void const * memory,
+    TelemetryRecord & record)
+{
+    Header const * const header = reinterpret_cast<Header const *>(memory);
+
+    if (header->Magic != Magic
+        || header->Version != Version
+        || header->RecordStride != RecordStride
+        || header->RecordCount == 0)
+    {
+        return false;
+    }
+
+    std::uint64_t const writeCount = header->WriteCount.load(std::memory_order_acquire);
+    if (writeCount == 0)
+    {
+        return false;
+    }
+
+    Slot const * const slot = GetSlot(
+        const_cast<void *>(memory),
+        static_cast<size_t>((writeCount - 1) % header->RecordCount));
+
+    std::uint64_t const sequenceBefore = slot->Sequence.load(std::memory_order_acquire);
+    if (sequenceBefore != 2 * writeCount)
+    {
+        // Being overwritten already
+        return false;
+    }
+
+    std::memcpy(&record, &(slot->Record), sizeof(TelemetryRecord));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return slot->Sequence.load(std::memory_order_relaxed) == sequenceBefore;
+}
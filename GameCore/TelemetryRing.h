@@ -0,0 +1,160 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-07-02
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+/*
+ * The stats of one frame, as published to external tools.
+ */
+struct TelemetryRecord
+{
+    static constexpr size_t MaxPhaseCount = 16;
+
+    std::uint64_t FrameIndex;
+    std::uint64_t TimestampMicros; // Since the telemetry started
+
+    // The durations of the phases of the frame
+    float UpdateMillis;
+    float RenderMillis;
+    float SwapMillis;
+
+    // The durations of the ship update phases during the frame, in the order of the
+    // phases of the ship perf stats; zero when the game is built without perf stats
+    std::uint32_t PhaseCount;
+    float PhaseMillis[MaxPhaseCount];
+
+    // Totals over all ships
+    std::uint32_t ShipCount;
+    std::uint32_t PointCount;
+    std::uint32_t SpringCount;
+    std::uint32_t EphemeralParticleCount;
+    std::uint32_t SinkingShipCount;
+    float TotalWater;
+
+    // As of the last memory report, which is taken about once per second
+    std::uint64_t CpuMemoryBytes;
+    std::uint64_t GpuMemoryBytes;
+};
+
+static_assert(std::is_trivially_copyable_v<TelemetryRecord>);
+static_assert(sizeof(TelemetryRecord) == 136, "The layout documented below");
+
+/*
+ * A ring of telemetry records in memory shared with other processes, which may read
+ * it without copies other than of the record they read, and without ever making us wait.
+ *
+ * Layout - native endianness, all offsets in bytes:
+ *
+ *   Header, at 0 (64 bytes):
+ *     0   uint32 Magic         0x4D545346 ("FSTM")
+ *     4   uint32 Version       1
+ *     8   uint32 RecordStride  The distance between two records, i.e. 192
+ *     12  uint32 RecordCount   The number of records in the ring
+ *     16  uint64 WriteCount    The number of records written so far; record #n is
+ *                              in slot n % RecordCount
+ *
+ *   Slot #i, at 64 + i * RecordStride:
+ *     0   uint64 Sequence      Odd while the record is being written; 2 * (n + 1)
+ *                              once record #n has been written in full
+ *     8   TelemetryRecord      The fields in declaration order, at their natural
+ *                              alignment (FrameIndex at 8, ..., GpuMemoryBytes at 136)
+ *
+ * To read the latest record, a reader takes WriteCount, reads the slot's Sequence, copies
+ * the record, and reads the Sequence again: the copy is good when the two are the same
+ * and equal 2 * WriteCount.
+ */
+class TelemetryRing
+{
+public:
+
+    static constexpr std::uint32_t Magic = 0x4D545346;
+    static constexpr std::uint32_t Version = 1;
+
+    static constexpr size_t HeaderSize = 64;
+    static constexpr size_t RecordStride = 192;
+
+    static size_t CalculateByteSize(size_t recordCount)
+    {
+        return HeaderSize + recordCount * RecordStride;
+    }
+
+    /*
+     * Creates a ring in shared memory with the specified name, which other processes
+     * open - e.g. with OpenFileMapping() on Windows, and shm_open() with a leading
+     * slash elsewhere - to read it.
+     */
+    static std::unique_ptr<TelemetryRing> CreateShared(
+        std::string const & name,
+        size_t recordCount);
+
+    /*
+     * Creates a ring in the specified memory, which must be at least CalculateByteSize()
+     * bytes, 64-byte aligned, and outlive the ring.
+     */
+    TelemetryRing(
+        void * memory,
+        size_t recordCount);
+
+    ~TelemetryRing();
+
+    TelemetryRing(TelemetryRing const &) = delete;
+    TelemetryRing & operator=(TelemetryRing const &) = delete;
+
+    void Write(TelemetryRecord const & record);
+
+    /*
+     * Copies the latest record of the ring in the specified memory, returning false when
+     * there's no record yet, the memory doesn't hold a ring, or the record is being
+     * overwritten while we copy it - in which case it's worth trying again.
+     */
+    static bool ReadLatest(
+        void const * memory,
+        TelemetryRecord & record);
+
+private:
+
+    struct Header
+    {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint32_t RecordStride;
+        std::uint32_t RecordCount;
+        std::atomic<std::uint64_t> WriteCount;
+    };
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> Sequence;
+        TelemetryRecord Record;
+    };
+
+    static_assert(sizeof(Header) <= HeaderSize);
+    static_assert(sizeof(Slot) <= RecordStride);
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared with other processes");
+
+    static Slot * GetSlot(
+        void * memory,
+        size_t index)
+    {
+        return reinterpret_cast<Slot *>(static_cast<std::uint8_t *>(memory) + HeaderSize + index * RecordStride);
+    }
+
+private:
+
+    // Set when we own the shared memory
+    struct SharedMemory;
+    std::unique_ptr<SharedMemory> mSharedMemory;
+
+    Header * const mHeader;
+    void * const mMemory;
+    size_t const mRecordCount;
+};
@@ -0,0 +1,160 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-12
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "TraceLog.h"
+
+#include "GameException.h"
+
+#include <cassert>
+#include <fstream>
+
+void TraceLog::Start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mThreadBuffersMutex);
+
+        for (auto & threadBuffer : mThreadBuffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(threadBuffer->Mutex);
+            threadBuffer->Events.clear();
+        }
+
+        mOriginTime = std::chrono::steady_clock::now();
+    }
+
+    mIsTracing = true;
+}
+
+void TraceLog::Stop(std::filesystem::path const & outputFilepath)
+{
+    mIsTracing = false;
+
+    std::ofstream outputFile(outputFilepath, std::ios::out | std::ios::trunc);
+    if (!outputFile.is_open())
+    {
+        throw GameException("Cannot open file \"" + outputFilepath.string() + "\" for writing");
+    }
+
+    outputFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+
+    bool isFirst = true;
+    auto const writeSeparator = [&]()
+    {
+        if (!isFirst)
+            outputFile << "," << std::endl;
+
+        isFirst = false;
+    };
+
+    std::lock_guard<std::mutex> lock(mThreadBuffersMutex);
+
+    for (auto & threadBuffer : mThreadBuffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(threadBuffer->Mutex);
+
+        if (!threadBuffer->Name.empty())
+        {
+            writeSeparator();
+            outputFile << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << threadBuffer->TrackId
+                << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << threadBuffer->Name << "\"}}";
+        }
+
+        for (auto const & event : threadBuffer->Events)
+        {
+            writeSeparator();
+            outputFile << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << threadBuffer->TrackId
+                << ",\"name\":\"" << event.Name << "\",\"cat\":\"" << event.Category << "\""
+                << ",\"ts\":" << event.StartMicros << ",\"dur\":" << event.DurationMicros << "}";
+        }
+
+        threadBuffer->Events.clear();
+    }
+
+    outputFile << std::endl << "]}" << std::endl;
+}
+
+void TraceLog::SetCurrentThreadName(std::string name)
+{
+    auto & threadBuffer = GetCurrentThreadBuffer();
+
+    std::lock_guard<std::mutex> bufferLock(threadBuffer.Mutex);
+    threadBuffer.Name = std::move(name);
+}
+
+void TraceLog::AddEvent(
+    char const * name,
+    char const * category,
+    std::chrono::steady_clock::time_point startTime,
+    std::chrono::steady_clock::duration duration)
+{
+    if (!IsTracing())
+        return;
+
+    AddEvent(
+        GetCurrentThreadBuffer(),
+        name,
+        category,
+        startTime,
+        duration);
+}
+
+void TraceLog::AddGPUEvent(
+    char const * name,
+    std::chrono::steady_clock::time_point startTime,
+    std::chrono::steady_clock::duration duration)
+{
+    if (!IsTracing())
+        return;
+
+    ThreadBuffer * gpuBuffer;
+    {
+        std::lock_guard<std::mutex> lock(mThreadBuffersMutex);
+
+        assert(mThreadBuffers[0]->TrackId == GPUTrackId);
+        gpuBuffer = mThreadBuffers[0].get();
+    }
+
+    AddEvent(
+        *gpuBuffer,
+        name,
+        "gpu",
+        startTime,
+        duration);
+}
+
+TraceLog::ThreadBuffer & TraceLog::GetCurrentThreadBuffer()
+{
+    // Buffers are never freed, hence the pointer stays valid for the lifetime of the thread
+    thread_local ThreadBuffer * currentThreadBuffer = nullptr;
+
+    if (nullptr == currentThreadBuffer)
+    {
+        std::lock_guard<std::mutex> lock(mThreadBuffersMutex);
+
+        // Track IDs start after the GPU's
+        static std::uint32_t nextTrackId = GPUTrackId + 1;
+
+        mThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>(nextTrackId++));
+        currentThreadBuffer = mThreadBuffers.back().get();
+    }
+
+    return *currentThreadBuffer;
+}
+
+void TraceLog::AddEvent(
+    ThreadBuffer & threadBuffer,
+    char const * name,
+    char const * category,
+    std::chrono::steady_clock::time_point startTime,
+    std::chrono::steady_clock::duration duration)
+{
+    std::lock_guard<std::mutex> bufferLock(threadBuffer.Mutex);
+
+    threadBuffer.Events.push_back({
+        name,
+        category,
+        std::chrono::duration_cast<std::chrono::microseconds>(startTime - mOriginTime).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count() });
+}
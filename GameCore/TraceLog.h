@@ -0,0 +1,170 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-12
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Collects timed events from any thread while tracing, and saves them as a Chrome
+ * trace_event JSON file - which may be opened with chrome://tracing or Perfetto.
+ *
+ * Event names and categories are not copied, hence they must be string literals.
+ */
+class TraceLog
+{
+public:
+
+    // The track on which we show the events that happened on the GPU
+    static constexpr std::uint32_t GPUTrackId = 0;
+
+    static TraceLog & GetInstance()
+    {
+        static TraceLog * instance = new TraceLog();
+
+        return *instance;
+    }
+
+    bool IsTracing() const
+    {
+        return mIsTracing.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Forgets the events collected so far, and starts collecting new ones.
+     */
+    void Start();
+
+    /*
+     * Stops collecting events, and saves the ones collected since Start().
+     */
+    void Stop(std::filesystem::path const & outputFilepath);
+
+    /*
+     * Names the current thread's track in the trace.
+     */
+    void SetCurrentThreadName(std::string name);
+
+    void AddEvent(
+        char const * name,
+        char const * category,
+        std::chrono::steady_clock::time_point startTime,
+        std::chrono::steady_clock::duration duration);
+
+    void AddGPUEvent(
+        char const * name,
+        std::chrono::steady_clock::time_point startTime,
+        std::chrono::steady_clock::duration duration);
+
+private:
+
+    TraceLog()
+        : mIsTracing(false)
+        , mOriginTime(std::chrono::steady_clock::now())
+        , mThreadBuffers()
+        , mThreadBuffersMutex()
+    {
+        // The first buffer is the GPU's
+        mThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>(GPUTrackId));
+        mThreadBuffers.back()->Name = "GPU";
+    }
+
+    struct Event
+    {
+        char const * Name;
+        char const * Category;
+        std::int64_t StartMicros;
+        std::int64_t DurationMicros;
+    };
+
+    // Each thread appends to its own buffer, hence the buffer's mutex is only
+    // contended while saving
+    struct ThreadBuffer
+    {
+        std::uint32_t TrackId;
+        std::string Name;
+        std::vector<Event> Events;
+        std::mutex Mutex;
+
+        ThreadBuffer(std::uint32_t trackId)
+            : TrackId(trackId)
+            , Name()
+            , Events()
+            , Mutex()
+        {}
+    };
+
+    ThreadBuffer & GetCurrentThreadBuffer();
+
+    void AddEvent(
+        ThreadBuffer & threadBuffer,
+        char const * name,
+        char const * category,
+        std::chrono::steady_clock::time_point startTime,
+        std::chrono::steady_clock::duration duration);
+
+private:
+
+    std::atomic<bool> mIsTracing;
+    std::chrono::steady_clock::time_point mOriginTime;
+
+    std::vector<std::unique_ptr<ThreadBuffer>> mThreadBuffers; // Never shrinks, as threads hold on to their buffers
+    std::mutex mThreadBuffersMutex;
+};
+
+/*
+ * Adds to the trace an event for its scope, if we were tracing when the scope began.
+ */
+class ScopedTrace
+{
+public:
+
+    ScopedTrace(
+        char const * name,
+        char const * category)
+        : mName(name)
+        , mCategory(category)
+        , mIsTracing(TraceLog::GetInstance().IsTracing())
+        , mStartTime(mIsTracing ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point())
+    {}
+
+    ~ScopedTrace()
+    {
+        if (mIsTracing)
+        {
+            TraceLog::GetInstance().AddEvent(
+                mName,
+                mCategory,
+                mStartTime,
+                std::chrono::steady_clock::now() - mStartTime);
+        }
+    }
+
+    ScopedTrace(ScopedTrace const &) = delete;
+    ScopedTrace & operator=(ScopedTrace const &) = delete;
+
+private:
+
+    char const * const mName;
+    char const * const mCategory;
+    bool const mIsTracing;
+    std::chrono::steady_clock::time_point const mStartTime;
+};
+
+#ifdef ENABLE_PERF_STATS
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) \
+    ScopedTrace const TRACE_SCOPE_CONCAT(_scopedTrace, __LINE__)((name), (category))
+#else
+#define TRACE_SCOPE(name, category)
+#endif
@@ -9,36 +9,47 @@
 
 #include <cassert>
 #include <memory>
-#include <regex>
 
 namespace /* anonymous */ {
 
-    std::string RemoveJSONComments(std::string const & source)
+    /*
+     * Blanks out "//" comments in place, in a single pass; comment markers inside
+     * string literals (e.g. URLs) are left alone.
+     */
+    void RemoveJSONComments(std::string & source)
     {
-        static std::regex CommentRegex(R"!(^(.*?)(//.*)$)!");
-
-        std::stringstream sSource(source);
-        std::stringstream sSubstitutedSource;
-        std::string line;
-        std::smatch match;
-        while (std::getline(sSource, line))
+        bool isInString = false;
+        for (size_t i = 0; i < source.size(); ++i)
         {
-            if (std::regex_match(line, match, CommentRegex))
+            char const c = source[i];
+
+            if (isInString)
+            {
+                if (c == '\\')
+                    ++i; // Skip escaped char
+                else if (c == '"')
+                    isInString = false;
+            }
+            else if (c == '"')
             {
-                assert(3 == match.size());
-                sSubstitutedSource << std::string(match[1].first, match[1].second);
+                isInString = true;
+            }
+            else if (c == '/' && i + 1 < source.size() && source[i + 1] == '/')
+            {
+                // Blank until end of line
+                for (; i < source.size() && source[i] != '\n'; ++i)
+                {
+                    source[i] = ' ';
+                }
             }
-            else
-                sSubstitutedSource << line;
         }
-
-        return sSubstitutedSource.str();
     }
 }
 
 picojson::value Utils::ParseJSONFile(std::filesystem::path const & filepath)
 {
-	std::string fileContents = RemoveJSONComments(Utils::LoadTextFile(filepath));
+	std::string fileContents = Utils::LoadTextFile(filepath);
+	RemoveJSONComments(fileContents);
 
 	picojson::value jsonContent;
 	std::string parseError = picojson::parse(jsonContent, fileContents);
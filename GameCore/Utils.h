@@ -7,6 +7,7 @@
 
 #include "Colors.h"
 #include "GameException.h"
+#include "ResourceArchive.h"
 #include "Vectors.h"
 
 #include <picojson.h>
@@ -114,7 +115,7 @@ public:
         return memberIt->second.get<T>();
     }
 
-    static picojson::object GetMandatoryJsonObject(
+    static picojson::object const & GetMandatoryJsonObject(
         picojson::object const & obj,
         std::string const & memberName)
     {
@@ -132,7 +133,7 @@ public:
         return memberIt->second.get<picojson::object>();
     }
 
-    static picojson::array GetMandatoryJsonArray(
+    static picojson::array const & GetMandatoryJsonArray(
         picojson::object const & obj,
         std::string const & memberName)
     {
@@ -251,6 +252,13 @@ public:
         std::ifstream file(filepath.string(), std::ios::in);
         if (!file.is_open())
         {
+            // Not loose, maybe it's packed
+            auto const archiveEntry = ResourceArchive::FindMounted(filepath);
+            if (!!archiveEntry)
+            {
+                return std::string(static_cast<char const *>(archiveEntry->Data), archiveEntry->Size);
+            }
+
             throw GameException("Cannot open file \"" + filepath.string() + "\"");
         }
 
@@ -5,6 +5,7 @@
  ***************************************************************************************/
 #include "Vectors.h"
 
+#include <cfloat>
 #include <iomanip>
 #include <sstream>
 
@@ -27,4 +28,676 @@ std::string vec4f::toString() const
     std::stringstream ss;
     ss << std::setprecision(12) << "(" << x << ", " << y << ", " << z << ", " << w << ")";
     return ss.str();
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Batch math
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define VECTORS_X86_64
+#endif
+
+#ifdef VECTORS_X86_64
+
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC allows AVX2 intrinsics in any function
+#define TARGET_AVX2
+#else
+#include <immintrin.h>
+// GCC and Clang only allow AVX2 intrinsics in functions targeting AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#endif
+
+namespace /* anonymous */ {
+
+//
+// The layouts of the vectors; each kernel is instantiated for both
+//
+
+struct AoSVectors
+{
+    vec2f const * Vectors;
+
+    inline vec2f Get(size_t i) const
+    {
+        return Vectors[i];
+    }
+
+#ifdef VECTORS_X86_64
+
+    inline void Load(size_t i, __m128 & x, __m128 & y) const
+    {
+        __m128 const v01 = _mm_loadu_ps(reinterpret_cast<float const *>(Vectors + i)); // x0 y0 x1 y1
+        __m128 const v23 = _mm_loadu_ps(reinterpret_cast<float const *>(Vectors + i + 2)); // x2 y2 x3 y3
+
+        x = _mm_shuffle_ps(v01, v23, _MM_SHUFFLE(2, 0, 2, 0));
+        y = _mm_shuffle_ps(v01, v23, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    TARGET_AVX2 inline void Load(size_t i, __m256 & x, __m256 & y) const
+    {
+        __m256 const v0123 = _mm256_loadu_ps(reinterpret_cast<float const *>(Vectors + i)); // x0 y0 x1 y1 | x2 y2 x3 y3
+        __m256 const v4567 = _mm256_loadu_ps(reinterpret_cast<float const *>(Vectors + i + 4)); // x4 y4 x5 y5 | x6 y6 x7 y7
+
+        // Shuffles work within 128-bit lanes: x0 x1 x4 x5 | x2 x3 x6 x7, then reordered
+        x = _mm256_castpd_ps(_mm256_permute4x64_pd(
+            _mm256_castps_pd(_mm256_shuffle_ps(v0123, v4567, _MM_SHUFFLE(2, 0, 2, 0))),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+        y = _mm256_castpd_ps(_mm256_permute4x64_pd(
+            _mm256_castps_pd(_mm256_shuffle_ps(v0123, v4567, _MM_SHUFFLE(3, 1, 3, 1))),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+#endif
+};
+
+struct AoSOutputVectors
+{
+    vec2f * Vectors;
+
+    inline void Set(size_t i, vec2f const & v) const
+    {
+        Vectors[i] = v;
+    }
+
+#ifdef VECTORS_X86_64
+
+    inline void Store(size_t i, __m128 x, __m128 y) const
+    {
+        _mm_storeu_ps(reinterpret_cast<float *>(Vectors + i), _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(reinterpret_cast<float *>(Vectors + i + 2), _mm_unpackhi_ps(x, y));
+    }
+
+    TARGET_AVX2 inline void Store(size_t i, __m256 x, __m256 y) const
+    {
+        // The inverse of the load: x0 x1 x4 x5 | x2 x3 x6 x7, then unpacked within lanes
+        __m256 const xs = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(x), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 const ys = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(y), _MM_SHUFFLE(3, 1, 2, 0)));
+
+        _mm256_storeu_ps(reinterpret_cast<float *>(Vectors + i), _mm256_unpacklo_ps(xs, ys));
+        _mm256_storeu_ps(reinterpret_cast<float *>(Vectors + i + 4), _mm256_unpackhi_ps(xs, ys));
+    }
+
+#endif
+};
+
+struct SoAVectors
+{
+    float const * Xs;
+    float const * Ys;
+
+    inline vec2f Get(size_t i) const
+    {
+        return vec2f(Xs[i], Ys[i]);
+    }
+
+#ifdef VECTORS_X86_64
+
+    inline void Load(size_t i, __m128 & x, __m128 & y) const
+    {
+        x = _mm_loadu_ps(Xs + i);
+        y = _mm_loadu_ps(Ys + i);
+    }
+
+    TARGET_AVX2 inline void Load(size_t i, __m256 & x, __m256 & y) const
+    {
+        x = _mm256_loadu_ps(Xs + i);
+        y = _mm256_loadu_ps(Ys + i);
+    }
+
+#endif
+};
+
+struct SoAOutputVectors
+{
+    float * Xs;
+    float * Ys;
+
+    inline void Set(size_t i, vec2f const & v) const
+    {
+        Xs[i] = v.x;
+        Ys[i] = v.y;
+    }
+
+#ifdef VECTORS_X86_64
+
+    inline void Store(size_t i, __m128 x, __m128 y) const
+    {
+        _mm_storeu_ps(Xs + i, x);
+        _mm_storeu_ps(Ys + i, y);
+    }
+
+    TARGET_AVX2 inline void Store(size_t i, __m256 x, __m256 y) const
+    {
+        _mm256_storeu_ps(Xs + i, x);
+        _mm256_storeu_ps(Ys + i, y);
+    }
+
+#endif
+};
+
+//
+// Scalar
+//
+
+template<typename TVectors>
+void BatchLengthScalar(
+    TVectors const & vectors,
+    float * lengths,
+    size_t start,
+    size_t count)
+{
+    for (size_t i = start; i < count; ++i)
+    {
+        lengths[i] = vectors.Get(i).length();
+    }
+}
+
+template<typename TVectors, typename TOutputVectors>
+void BatchNormalizeScalar(
+    TVectors const & vectors,
+    TOutputVectors const & normals,
+    float * lengths,
+    size_t start,
+    size_t count)
+{
+    for (size_t i = start; i < count; ++i)
+    {
+        vec2f const v = vectors.Get(i);
+        float const length = v.length();
+        normals.Set(i, v.normalise(length));
+
+        if (lengths != nullptr)
+            lengths[i] = length;
+    }
+}
+
+template<typename TVectors>
+void BatchDotScalar(
+    TVectors const & as,
+    TVectors const & bs,
+    float * dots,
+    size_t start,
+    size_t count)
+{
+    for (size_t i = start; i < count; ++i)
+    {
+        dots[i] = as.Get(i).dot(bs.Get(i));
+    }
+}
+
+#ifdef VECTORS_X86_64
+
+//
+// SSE2
+//
+
+/*
+ * Calculates the lengths of the vectors, and what to normalize them by - multiplying
+ * with it when fast, dividing by it when exact; the mask selects the vectors that are
+ * not to be normalized to zero.
+ */
+template<bool IsFast>
+inline void CalculateLengthSSE2(
+    __m128 x,
+    __m128 y,
+    __m128 & length,
+    __m128 & normalizer,
+    __m128 & validMask)
+{
+    __m128 const squareLength = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+
+    if constexpr (IsFast)
+    {
+        // One Newton-Raphson step: r = r0 * (3 - sl * r0^2) / 2
+        __m128 const r0 = _mm_rsqrt_ps(squareLength);
+        __m128 const r = _mm_mul_ps(
+            _mm_mul_ps(_mm_set1_ps(0.5f), r0),
+            _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_mul_ps(squareLength, r0), r0)));
+
+        validMask = _mm_cmpge_ps(squareLength, _mm_set1_ps(FLT_MIN));
+        normalizer = _mm_and_ps(validMask, r);
+        length = _mm_mul_ps(squareLength, normalizer);
+    }
+    else
+    {
+        length = _mm_sqrt_ps(squareLength);
+
+        // Divide by one rather than by zero, the result being masked out anyway
+        validMask = _mm_cmpgt_ps(length, _mm_setzero_ps());
+        __m128 const safeLength = _mm_or_ps(
+            _mm_and_ps(validMask, length),
+            _mm_andnot_ps(validMask, _mm_set1_ps(1.0f)));
+
+        normalizer = safeLength;
+    }
+}
+
+template<bool IsFast, typename TVectors>
+void BatchLengthSSE2(
+    TVectors const & vectors,
+    float * lengths,
+    size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y;
+        vectors.Load(i, x, y);
+
+        __m128 length, normalizer, validMask;
+        CalculateLengthSSE2<IsFast>(x, y, length, normalizer, validMask);
+
+        _mm_storeu_ps(lengths + i, length);
+    }
+
+    // Remainder
+    BatchLengthScalar(vectors, lengths, i, count);
+}
+
+template<bool IsFast, typename TVectors, typename TOutputVectors>
+void BatchNormalizeSSE2(
+    TVectors const & vectors,
+    TOutputVectors const & normals,
+    float * lengths,
+    size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y;
+        vectors.Load(i, x, y);
+
+        __m128 length, normalizer, validMask;
+        CalculateLengthSSE2<IsFast>(x, y, length, normalizer, validMask);
+
+        if constexpr (IsFast)
+        {
+            // Already zero for invalid vectors
+            normals.Store(i, _mm_mul_ps(x, normalizer), _mm_mul_ps(y, normalizer));
+        }
+        else
+        {
+            normals.Store(
+                i,
+                _mm_and_ps(validMask, _mm_div_ps(x, normalizer)),
+                _mm_and_ps(validMask, _mm_div_ps(y, normalizer)));
+        }
+
+        if (lengths != nullptr)
+            _mm_storeu_ps(lengths + i, length);
+    }
+
+    // Remainder
+    BatchNormalizeScalar(vectors, normals, lengths, i, count);
+}
+
+template<typename TVectors>
+void BatchDotSSE2(
+    TVectors const & as,
+    TVectors const & bs,
+    float * dots,
+    size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 aX, aY, bX, bY;
+        as.Load(i, aX, aY);
+        bs.Load(i, bX, bY);
+
+        _mm_storeu_ps(dots + i, _mm_add_ps(_mm_mul_ps(aX, bX), _mm_mul_ps(aY, bY)));
+    }
+
+    // Remainder
+    BatchDotScalar(as, bs, dots, i, count);
+}
+
+//
+// AVX2
+//
+
+template<bool IsFast>
+TARGET_AVX2 inline void CalculateLengthAVX2(
+    __m256 x,
+    __m256 y,
+    __m256 & length,
+    __m256 & normalizer,
+    __m256 & validMask)
+{
+    // No FMA, to stay bit-exact with the scalar methods
+    __m256 const squareLength = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+
+    if constexpr (IsFast)
+    {
+        __m256 const r0 = _mm256_rsqrt_ps(squareLength);
+        __m256 const r = _mm256_mul_ps(
+            _mm256_mul_ps(_mm256_set1_ps(0.5f), r0),
+            _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_mul_ps(squareLength, r0), r0)));
+
+        validMask = _mm256_cmp_ps(squareLength, _mm256_set1_ps(FLT_MIN), _CMP_GE_OQ);
+        normalizer = _mm256_and_ps(validMask, r);
+        length = _mm256_mul_ps(squareLength, normalizer);
+    }
+    else
+    {
+        length = _mm256_sqrt_ps(squareLength);
+
+        validMask = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_GT_OQ);
+        __m256 const safeLength = _mm256_blendv_ps(_mm256_set1_ps(1.0f), length, validMask);
+
+        normalizer = safeLength;
+    }
+}
+
+template<bool IsFast, typename TVectors>
+TARGET_AVX2 void BatchLengthAVX2(
+    TVectors const & vectors,
+    float * lengths,
+    size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x, y;
+        vectors.Load(i, x, y);
+
+        __m256 length, normalizer, validMask;
+        CalculateLengthAVX2<IsFast>(x, y, length, normalizer, validMask);
+
+        _mm256_storeu_ps(lengths + i, length);
+    }
+
+    // Remainder
+    BatchLengthScalar(vectors, lengths, i, count);
+}
+
+template<bool IsFast, typename TVectors, typename TOutputVectors>
+TARGET_AVX2 void BatchNormalizeAVX2(
+    TVectors const & vectors,
+    TOutputVectors const & normals,
+    float * lengths,
+    size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x, y;
+        vectors.Load(i, x, y);
+
+        __m256 length, normalizer, validMask;
+        CalculateLengthAVX2<IsFast>(x, y, length, normalizer, validMask);
+
+        if constexpr (IsFast)
+        {
+            normals.Store(i, _mm256_mul_ps(x, normalizer), _mm256_mul_ps(y, normalizer));
+        }
+        else
+        {
+            normals.Store(
+                i,
+                _mm256_and_ps(validMask, _mm256_div_ps(x, normalizer)),
+                _mm256_and_ps(validMask, _mm256_div_ps(y, normalizer)));
+        }
+
+        if (lengths != nullptr)
+            _mm256_storeu_ps(lengths + i, length);
+    }
+
+    // Remainder
+    BatchNormalizeScalar(vectors, normals, lengths, i, count);
+}
+
+template<typename TVectors>
+TARGET_AVX2 void BatchDotAVX2(
+    TVectors const & as,
+    TVectors const & bs,
+    float * dots,
+    size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 aX, aY, bX, bY;
+        as.Load(i, aX, aY);
+        bs.Load(i, bX, bY);
+
+        _mm256_storeu_ps(dots + i, _mm256_add_ps(_mm256_mul_ps(aX, bX), _mm256_mul_ps(aY, bY)));
+    }
+
+    // Remainder
+    BatchDotScalar(as, bs, dots, i, count);
+}
+
+#endif
+
+VectorBatchImplementation DetectBestVectorBatchImplementation()
+{
+#ifdef VECTORS_X86_64
+
+    bool isAVX2Supported = false;
+
+#ifdef _MSC_VER
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 0);
+    if (cpuInfo[0] >= 7)
+    {
+        // The OS must also save the AVX registers
+        __cpuid(cpuInfo, 1);
+        bool const isOSXSaveSupported = (cpuInfo[2] & (1 << 27)) != 0;
+        if (isOSXSaveSupported && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(cpuInfo, 7, 0);
+            isAVX2Supported = (cpuInfo[1] & (1 << 5)) != 0;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    isAVX2Supported = __builtin_cpu_supports("avx2");
+#endif
+
+    if (isAVX2Supported)
+        return VectorBatchImplementation::AVX2;
+
+    // SSE2 is part of x86-64
+    return VectorBatchImplementation::SSE2;
+
+#else
+
+    return VectorBatchImplementation::Scalar;
+
+#endif
+}
+
+template<typename TVectors>
+void DispatchBatchLength(
+    TVectors const & vectors,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision,
+    VectorBatchImplementation implementation)
+{
+    bool const isFast = (precision == VectorBatchPrecision::Fast);
+
+    switch (implementation)
+    {
+#ifdef VECTORS_X86_64
+        case VectorBatchImplementation::AVX2:
+        {
+            if (isFast)
+                BatchLengthAVX2<true>(vectors, lengths, count);
+            else
+                BatchLengthAVX2<false>(vectors, lengths, count);
+            break;
+        }
+
+        case VectorBatchImplementation::SSE2:
+        {
+            if (isFast)
+                BatchLengthSSE2<true>(vectors, lengths, count);
+            else
+                BatchLengthSSE2<false>(vectors, lengths, count);
+            break;
+        }
+#endif
+
+        default:
+        {
+            BatchLengthScalar(vectors, lengths, 0, count);
+            break;
+        }
+    }
+}
+
+template<typename TVectors, typename TOutputVectors>
+void DispatchBatchNormalize(
+    TVectors const & vectors,
+    TOutputVectors const & normals,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision,
+    VectorBatchImplementation implementation)
+{
+    bool const isFast = (precision == VectorBatchPrecision::Fast);
+
+    switch (implementation)
+    {
+#ifdef VECTORS_X86_64
+        case VectorBatchImplementation::AVX2:
+        {
+            if (isFast)
+                BatchNormalizeAVX2<true>(vectors, normals, lengths, count);
+            else
+                BatchNormalizeAVX2<false>(vectors, normals, lengths, count);
+            break;
+        }
+
+        case VectorBatchImplementation::SSE2:
+        {
+            if (isFast)
+                BatchNormalizeSSE2<true>(vectors, normals, lengths, count);
+            else
+                BatchNormalizeSSE2<false>(vectors, normals, lengths, count);
+            break;
+        }
+#endif
+
+        default:
+        {
+            BatchNormalizeScalar(vectors, normals, lengths, 0, count);
+            break;
+        }
+    }
+}
+
+template<typename TVectors>
+void DispatchBatchDot(
+    TVectors const & as,
+    TVectors const & bs,
+    float * dots,
+    size_t count,
+    VectorBatchImplementation implementation)
+{
+    switch (implementation)
+    {
+#ifdef VECTORS_X86_64
+        case VectorBatchImplementation::AVX2:
+        {
+            BatchDotAVX2(as, bs, dots, count);
+            break;
+        }
+
+        case VectorBatchImplementation::SSE2:
+        {
+            BatchDotSSE2(as, bs, dots, count);
+            break;
+        }
+#endif
+
+        default:
+        {
+            BatchDotScalar(as, bs, dots, 0, count);
+            break;
+        }
+    }
+}
+
+}
+
+VectorBatchImplementation GetBestVectorBatchImplementation()
+{
+    static VectorBatchImplementation const BestImplementation = DetectBestVectorBatchImplementation();
+
+    return BestImplementation;
+}
+
+void BatchLength(
+    vec2f const * vectors,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision,
+    VectorBatchImplementation implementation)
+{
+    DispatchBatchLength(AoSVectors{ vectors }, lengths, count, precision, implementation);
+}
+
+void BatchLength(
+    float const * xs,
+    float const * ys,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision,
+    VectorBatchImplementation implementation)
+{
+    DispatchBatchLength(SoAVectors{ xs, ys }, lengths, count, precision, implementation);
+}
+
+void BatchNormalize(
+    vec2f const * vectors,
+    vec2f * normals,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision,
+    VectorBatchImplementation implementation)
+{
+    DispatchBatchNormalize(AoSVectors{ vectors }, AoSOutputVectors{ normals }, lengths, count, precision, implementation);
+}
+
+void BatchNormalize(
+    float const * xs,
+    float const * ys,
+    float * normalXs,
+    float * normalYs,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision,
+    VectorBatchImplementation implementation)
+{
+    DispatchBatchNormalize(SoAVectors{ xs, ys }, SoAOutputVectors{ normalXs, normalYs }, lengths, count, precision, implementation);
+}
+
+void BatchDot(
+    vec2f const * as,
+    vec2f const * bs,
+    float * dots,
+    size_t count,
+    VectorBatchImplementation implementation)
+{
+    DispatchBatchDot(AoSVectors{ as }, AoSVectors{ bs }, dots, count, implementation);
+}
+
+void BatchDot(
+    float const * aXs,
+    float const * aYs,
+    float const * bXs,
+    float const * bYs,
+    float * dots,
+    size_t count,
+    VectorBatchImplementation implementation)
+{
+    DispatchBatchDot(SoAVectors{ aXs, aYs }, SoAVectors{ bXs, bYs }, dots, count, implementation);
+}
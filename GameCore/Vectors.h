@@ -524,3 +524,88 @@ inline std::basic_ostream<char> & operator<<(std::basic_ostream<char>& os, vec4f
     os << v.toString();
     return os;
 }
+
+/*
+ * Batch math over arrays of vec2f's - either as vec2f's (AoS), or as separate arrays
+ * of x's and y's (SoA).
+ *
+ * The Exact precision produces the same results as the scalar vec2f methods, bit for
+ * bit: length(), normalise(length()), and dot(). The Fast precision uses the CPU's
+ * reciprocal square root approximation refined by one Newton-Raphson step, with a relative
+ * error below 1e-6; with it, vectors whose square length is a denormal - i.e. shorter
+ * than 1e-19 - are treated as zero vectors. The Scalar implementation is always Exact.
+ *
+ * Outputs may be the same buffers as inputs; other than that, buffers may not overlap.
+ */
+
+enum class VectorBatchImplementation
+{
+    Scalar,
+    SSE2,   // 4 vectors at a time
+    AVX2    // 8 vectors at a time
+};
+
+enum class VectorBatchPrecision
+{
+    Exact,
+    Fast
+};
+
+/*
+ * Gets the fastest implementation supported by the CPU we're running on; detected
+ * once, at the first invocation.
+ */
+VectorBatchImplementation GetBestVectorBatchImplementation();
+
+void BatchLength(
+    vec2f const * vectors,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision = VectorBatchPrecision::Exact,
+    VectorBatchImplementation implementation = GetBestVectorBatchImplementation());
+
+void BatchLength(
+    float const * xs,
+    float const * ys,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision = VectorBatchPrecision::Exact,
+    VectorBatchImplementation implementation = GetBestVectorBatchImplementation());
+
+/*
+ * Normalizes the vectors, optionally - when lengths is not null - storing their lengths.
+ * Zero-length vectors are normalized to zero.
+ */
+void BatchNormalize(
+    vec2f const * vectors,
+    vec2f * normals,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision = VectorBatchPrecision::Exact,
+    VectorBatchImplementation implementation = GetBestVectorBatchImplementation());
+
+void BatchNormalize(
+    float const * xs,
+    float const * ys,
+    float * normalXs,
+    float * normalYs,
+    float * lengths,
+    size_t count,
+    VectorBatchPrecision precision = VectorBatchPrecision::Exact,
+    VectorBatchImplementation implementation = GetBestVectorBatchImplementation());
+
+void BatchDot(
+    vec2f const * as,
+    vec2f const * bs,
+    float * dots,
+    size_t count,
+    VectorBatchImplementation implementation = GetBestVectorBatchImplementation());
+
+void BatchDot(
+    float const * aXs,
+    float const * aYs,
+    float const * bXs,
+    float const * bYs,
+    float * dots,
+    size_t count,
+    VectorBatchImplementation implementation = GetBestVectorBatchImplementation());
@@ -0,0 +1,146 @@
+/***************************************************************************************
+* Original Author:      Gabriele Giuseppini
+* Created:              2019-06-14
+* Copyright:            Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "SysSpecifics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/*
+ * Hands out the transient buffers of a simulation step, bumping a pointer into a
+ * single allocation; everything handed out is given back at once by Reset().
+ *
+ * The allocation grows - during the first steps - to the most that a step has ever
+ * needed, after which steps cost no heap traffic at all. Not thread-safe.
+ */
+class WorkBufferArena
+{
+public:
+
+    static constexpr size_t Alignment = CacheLineSize;
+
+    WorkBufferArena()
+        : mBlock(nullptr)
+        , mBlockSize(0)
+        , mAllocatedSize(0)
+        , mOverflowBlocks()
+        , mOverflowSize(0)
+    {}
+
+    WorkBufferArena(WorkBufferArena && other)
+        : mBlock(other.mBlock)
+        , mBlockSize(other.mBlockSize)
+        , mAllocatedSize(other.mAllocatedSize)
+        , mOverflowBlocks(std::move(other.mOverflowBlocks))
+        , mOverflowSize(other.mOverflowSize)
+    {
+        other.mBlock = nullptr;
+        other.mOverflowBlocks.clear();
+    }
+
+    ~WorkBufferArena()
+    {
+        FreeOverflowBlocks();
+
+        if (nullptr != mBlock)
+        {
+            aligned_free(mBlock);
+        }
+    }
+
+    WorkBufferArena(WorkBufferArena const &) = delete;
+    WorkBufferArena & operator=(WorkBufferArena const &) = delete;
+    WorkBufferArena & operator=(WorkBufferArena &&) = delete;
+
+    /*
+     * Gets uninitialized storage for the specified number of elements, valid until
+     * the next Reset().
+     */
+    template<typename TElement>
+    TElement * Allocate(size_t elementCount)
+    {
+        static_assert(alignof(TElement) <= Alignment);
+
+        size_t const byteSize = AlignUp(elementCount * sizeof(TElement));
+
+        if (mAllocatedSize + byteSize <= mBlockSize)
+        {
+            void * const buffer = static_cast<unsigned char *>(mBlock) + mAllocatedSize;
+            mAllocatedSize += byteSize;
+            return static_cast<TElement *>(buffer);
+        }
+
+        // Doesn't fit this time; make room for it at the next Reset()
+        void * const buffer = aligned_alloc(Alignment, byteSize);
+        assert(nullptr != buffer);
+        mOverflowBlocks.push_back(buffer);
+        mOverflowSize += byteSize;
+
+        return static_cast<TElement *>(buffer);
+    }
+
+    /*
+     * Gives back all the buffers handed out since the last reset.
+     */
+    void Reset()
+    {
+        if (!mOverflowBlocks.empty())
+        {
+            // Grow to fit everything that was asked for since the last reset
+            size_t const newBlockSize = std::max(mBlockSize, mAllocatedSize + mOverflowSize);
+
+            FreeOverflowBlocks();
+
+            if (nullptr != mBlock)
+            {
+                aligned_free(mBlock);
+            }
+
+            mBlock = aligned_alloc_bulk(Alignment, newBlockSize);
+            assert(nullptr != mBlock);
+            mBlockSize = newBlockSize;
+        }
+
+        mAllocatedSize = 0;
+    }
+
+    /*
+     * Gets the number of bytes the arena holds on to.
+     */
+    size_t GetByteSize() const
+    {
+        return mBlockSize + mOverflowSize;
+    }
+
+private:
+
+    static constexpr size_t AlignUp(size_t byteSize)
+    {
+        return (byteSize + Alignment - 1) / Alignment * Alignment;
+    }
+
+    void FreeOverflowBlocks()
+    {
+        for (void * block : mOverflowBlocks)
+        {
+            aligned_free(block);
+        }
+
+        mOverflowBlocks.clear();
+        mOverflowSize = 0;
+    }
+
+    void * mBlock;
+    size_t mBlockSize;
+    size_t mAllocatedSize;
+
+    // The allocations that didn't fit in the block since the last reset
+    std::vector<void *> mOverflowBlocks;
+    size_t mOverflowSize;
+};
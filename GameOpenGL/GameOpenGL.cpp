@@ -6,16 +6,27 @@
 #include "GameOpenGL.h"
 
 #include <GameCore/GameMath.h>
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/TaskThreadPool.h>
+
+#include <emmintrin.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
 #include <memory>
 #include <numeric>
+#include <sstream>
+#include <vector>
 
 int GameOpenGL::MaxVertexAttributes = 0;
 int GameOpenGL::MaxViewportWidth = 0;
 int GameOpenGL::MaxViewportHeight = 0;
 int GameOpenGL::MaxTextureSize = 0;
 int GameOpenGL::MaxRenderbufferSize = 0;
+std::optional<std::filesystem::path> GameOpenGL::ProgramBinaryCacheFolderPath;
 
 void GameOpenGL::InitOpenGL()
 {
@@ -119,6 +130,12 @@ void GameOpenGL::LinkShaderProgram(
     GameOpenGLShaderProgram const & shaderProgram,
     std::string const & programName)
 {
+    if (IsProgramBinaryCacheEnabled())
+    {
+        // Tell the driver we'll want the binary back
+        glProgramParameteri(*shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     glLinkProgram(*shaderProgram);
 
     // Check
@@ -132,6 +149,135 @@ void GameOpenGL::LinkShaderProgram(
     }
 }
 
+void GameOpenGL::SetProgramBinaryCacheFolderPath(std::filesystem::path const & folderPath)
+{
+    ProgramBinaryCacheFolderPath = folderPath;
+}
+
+bool GameOpenGL::LoadCachedProgramBinary(
+    GameOpenGLShaderProgram const & shaderProgram,
+    std::string const & programName,
+    std::string const & programSource)
+{
+    if (!IsProgramBinaryCacheEnabled())
+        return false;
+
+    std::filesystem::path const filePath = MakeCachedProgramBinaryFilePath(programName, programSource);
+
+    std::ifstream file(filePath.string(), std::ios::binary | std::ios::in);
+    if (!file.is_open())
+        return false;
+
+    std::uint32_t binaryFormat;
+    file.read(reinterpret_cast<char *>(&binaryFormat), sizeof(binaryFormat));
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!file.eof() || binary.empty())
+        return false;
+
+    glProgramBinary(*shaderProgram, static_cast<GLenum>(binaryFormat), binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // The driver rejects binaries it can't use anymore, e.g. after an update
+    int success;
+    glGetProgramiv(*shaderProgram, GL_LINK_STATUS, &success);
+    if (GL_NO_ERROR != glGetError() || !success)
+    {
+        LogMessage("Cached binary of ", programName, " shader program is not valid anymore, rebuilding it");
+
+        std::error_code ec;
+        std::filesystem::remove(filePath, ec);
+
+        return false;
+    }
+
+    return true;
+}
+
+void GameOpenGL::StoreCachedProgramBinary(
+    GameOpenGLShaderProgram const & shaderProgram,
+    std::string const & programName,
+    std::string const & programSource)
+{
+    if (!IsProgramBinaryCacheEnabled())
+        return;
+
+    GLint binaryLength = 0;
+    glGetProgramiv(*shaderProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (GL_NO_ERROR != glGetError() || binaryLength <= 0)
+        return;
+
+    std::vector<char> binary(static_cast<size_t>(binaryLength));
+    GLenum binaryFormat;
+    glGetProgramBinary(*shaderProgram, binaryLength, nullptr, &binaryFormat, binary.data());
+    if (GL_NO_ERROR != glGetError())
+        return;
+
+    // The cache is a mere optimization, hence we swallow all errors
+    std::error_code ec;
+    std::filesystem::create_directories(*ProgramBinaryCacheFolderPath, ec);
+
+    std::ofstream file(
+        MakeCachedProgramBinaryFilePath(programName, programSource).string(),
+        std::ios::binary | std::ios::out | std::ios::trunc);
+    if (file.is_open())
+    {
+        std::uint32_t const binaryFormat32 = static_cast<std::uint32_t>(binaryFormat);
+        file.write(reinterpret_cast<char const *>(&binaryFormat32), sizeof(binaryFormat32));
+        file.write(binary.data(), binary.size());
+    }
+}
+
+bool GameOpenGL::IsProgramBinaryCacheEnabled()
+{
+    if (!ProgramBinaryCacheFolderPath
+        || glGetProgramBinary == NULL
+        || glProgramBinary == NULL
+        || glProgramParameteri == NULL)
+    {
+        return false;
+    }
+
+    // Some drivers expose the functionality without any binary format
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+    return GL_NO_ERROR == glGetError() && formatCount > 0;
+}
+
+std::filesystem::path GameOpenGL::MakeCachedProgramBinaryFilePath(
+    std::string const & programName,
+    std::string const & programSource)
+{
+    //
+    // Key by driver and by source, with a 64-bit FNV-1a hash - as opposed to std::hash,
+    // the same across builds
+    //
+
+    std::uint64_t hash = 14695981039346656037ull;
+
+    auto const hashString = [&hash](char const * str)
+    {
+        for (; str != nullptr && *str != '\0'; ++str)
+        {
+            hash ^= static_cast<std::uint8_t>(*str);
+            hash *= 1099511628211ull;
+        }
+
+        // Separator
+        hash ^= 0xff;
+        hash *= 1099511628211ull;
+    };
+
+    hashString(reinterpret_cast<char const *>(glGetString(GL_VENDOR)));
+    hashString(reinterpret_cast<char const *>(glGetString(GL_RENDERER)));
+    hashString(reinterpret_cast<char const *>(glGetString(GL_VERSION)));
+    hashString(programSource.c_str());
+
+    std::ostringstream ss;
+    ss << programName << "_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+
+    return *ProgramBinaryCacheFolderPath / ss.str();
+}
+
 GLint GameOpenGL::GetParameterLocation(
     GameOpenGLShaderProgram const & shaderProgram,
     std::string const & parameterName)
@@ -188,76 +334,29 @@ void GameOpenGL::UploadMipmappedTexture(RgbaImageData baseTexture)
         throw GameException("Error uploading texture onto GPU: " + std::to_string(glError));
     }
 
-
     //
-    // Create minified textures
+    // Create and upload minified textures
     //
 
-    ImageSize readImageSize(baseTexture.Size);
+    ImageSize const baseTextureSize = baseTexture.Size;
 
-    std::unique_ptr<rgbaColor const []> readBuffer(std::move(baseTexture.Data));
-    std::unique_ptr<rgbaColor[]> writeBuffer;
+    UploadMinifiedTextures(
+        std::move(baseTexture.Data),
+        baseTextureSize,
+        std::numeric_limits<int>::max());
+}
 
-    for (GLint textureLevel = 1; ; ++textureLevel)
+void GameOpenGL::UploadDeferredTextureBaseLevel(RgbaImageData baseTexture)
+{
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, baseTexture.Size.Width, baseTexture.Size.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, baseTexture.Data.get());
+    GLenum glError = glGetError();
+    if (GL_NO_ERROR != glError)
     {
-        if (readImageSize.Width == 1 && readImageSize.Height == 1)
-        {
-            // We're done!
-            break;
-        }
-
-        // Calculate dimensions of new write buffer
-        int width = std::max(1, readImageSize.Width / 2);
-        int height = std::max(1, readImageSize.Height / 2);
-
-        // Allocate new write buffer
-        writeBuffer.reset(new rgbaColor[width * height]);
-
-        // Create new buffer
-        rgbaColor const * rp = readBuffer.get();
-        rgbaColor * wp = writeBuffer.get();
-        for (int h = 0; h < height; ++h)
-        {
-            for (int w = 0; w < width; ++w)
-            {
-                //
-                // Apply box filter
-                //
-
-                int wIndex = ((h * width) + w);
-
-                int rIndex = (((h * 2) * readImageSize.Width) + (w * 2));
-                int rIndexNextLine = ((((h * 2) + 1) * readImageSize.Width) + (w * 2));
-
-                rgbaColorAccumulation sum(rp[rIndex]);
-
-                if (readImageSize.Width > 1)
-                    sum += rp[rIndex + 1];
-
-                if (readImageSize.Height > 1)
-                {
-                    sum += rp[rIndexNextLine];
-
-                    if (readImageSize.Width > 1)
-                        sum += rp[rIndexNextLine + 1];
-                }
-
-                wp[wIndex] = sum.toRgbaColor();
-            }
-        }
-
-        // Upload write buffer
-        glTexImage2D(GL_TEXTURE_2D, textureLevel, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, writeBuffer.get());
-        glError = glGetError();
-        if (GL_NO_ERROR != glError)
-        {
-            throw GameException("Error uploading minified texture onto GPU: " + std::to_string(glError));
-        }
-
-        // Swap buffer
-        readImageSize = ImageSize(width, height);
-        readBuffer = std::move(writeBuffer);
+        throw GameException("Error uploading texture onto GPU: " + std::to_string(glError));
     }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    CheckOpenGLError();
 }
 
 void GameOpenGL::UploadMipmappedPowerOfTwoTexture(
@@ -287,59 +386,176 @@ void GameOpenGL::UploadMipmappedPowerOfTwoTexture(
 
 
     //
-    // Create minified textures
+    // Create and upload minified textures
     //
 
-    std::unique_ptr<rgbaColor const[]> readBuffer(std::move(baseTexture.Data));
-    std::unique_ptr<rgbaColor[]> writeBuffer;
+    ImageSize const baseTextureSize = baseTexture.Size;
+
+    GLint const lastUploadedTextureLevel = UploadMinifiedTextures(
+        std::move(baseTexture.Data),
+        baseTextureSize,
+        maxDimension);
+
+    // Set max mipmap level
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastUploadedTextureLevel);
+    CheckOpenGLError();
+}
 
-    GLint lastUploadedTextureLevel = 0;
-    for (int divisor = 2; maxDimension / divisor >= 1; divisor *= 2)
+void GameOpenGL::DownsampleTextureRows(
+    rgbaColor const * restrict readBuffer,
+    ImageSize readSize,
+    rgbaColor * restrict writeBuffer,
+    ImageSize writeSize,
+    int startRow,
+    int endRow)
+{
+    assert(writeSize.Width == std::max(1, readSize.Width / 2));
+    assert(writeSize.Height == std::max(1, readSize.Height / 2));
+    assert(startRow >= 0 && startRow <= endRow && endRow <= writeSize.Height);
+
+    //
+    // Apply a box filter to each 2x2 block of the read buffer - or to each 1x2/2x1 block,
+    // when a dimension has already shrunk to 1
+    //
+
+    for (int h = startRow; h < endRow; ++h)
     {
-        // Calculate dimensions of new write buffer
-        int newWidth = std::max(1, baseTexture.Size.Width / divisor);
-        int newHeight = std::max(1, baseTexture.Size.Height / divisor);
+        rgbaColor const * const rp = readBuffer + (h * 2) * readSize.Width;
+        rgbaColor const * const rpNextLine = (readSize.Height > 1) ? rp + readSize.Width : nullptr;
+        rgbaColor * const wp = writeBuffer + h * writeSize.Width;
 
-        // Allocate new write buffer
-        writeBuffer.reset(new rgbaColor[newWidth * newHeight]);
+        int w = 0;
 
-        // Populate write buffer
-        rgbaColor const * rp = readBuffer.get();
-        rgbaColor * wp = writeBuffer.get();
-        for (int h = 0; h < newHeight; ++h)
+        if (readSize.Width > 1 && readSize.Height > 1)
         {
-            size_t frameIndexInReadBuffer = (h * 2) * (newWidth * 2);
-            size_t frameIndexInWriteBuffer = (h) * (newWidth);
+            //
+            // Two output pixels at a time, accumulating channels in 16 bits; the result
+            // is the same truncated average as rgbaColorAccumulation's
+            //
 
-            for (int w = 0; w < newWidth; ++w)
+            __m128i const zero = _mm_setzero_si128();
+
+            for (; w + 2 <= writeSize.Width; w += 2)
             {
-                //
-                // Calculate and store average of the four neighboring pixels whose bottom-left corner is at (w*2, h*2)
-                //
+                __m128i const line1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rp + w * 2));
+                __m128i const line2 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rpNextLine + w * 2));
+
+                // Pixels 0,1 and 2,3 of both lines, vertically summed
+                __m128i const sum01 = _mm_add_epi16(_mm_unpacklo_epi8(line1, zero), _mm_unpacklo_epi8(line2, zero));
+                __m128i const sum23 = _mm_add_epi16(_mm_unpacklo_epi8(_mm_srli_si128(line1, 8), zero), _mm_unpacklo_epi8(_mm_srli_si128(line2, 8), zero));
 
-                rgbaColorAccumulation sum;
+                // Horizontally summed
+                __m128i const sum = _mm_unpacklo_epi64(
+                    _mm_add_epi16(sum01, _mm_srli_si128(sum01, 8)),
+                    _mm_add_epi16(sum23, _mm_srli_si128(sum23, 8)));
 
-                sum += rp[frameIndexInReadBuffer + w * 2];
-                sum += rp[frameIndexInReadBuffer + w * 2 + 1];
-                sum += rp[frameIndexInReadBuffer + newWidth * 2 + w * 2];
-                sum += rp[frameIndexInReadBuffer + newWidth * 2 + w * 2 + 1];
+                _mm_storel_epi64(
+                    reinterpret_cast<__m128i *>(wp + w),
+                    _mm_packus_epi16(_mm_srli_epi16(sum, 2), zero));
+            }
+        }
+
+        for (; w < writeSize.Width; ++w)
+        {
+            rgbaColorAccumulation sum(rp[w * 2]);
+
+            if (readSize.Width > 1)
+                sum += rp[w * 2 + 1];
 
-                wp[frameIndexInWriteBuffer + w] = sum.toRgbaColor();
+            if (rpNextLine != nullptr)
+            {
+                sum += rpNextLine[w * 2];
+
+                if (readSize.Width > 1)
+                    sum += rpNextLine[w * 2 + 1];
             }
+
+            wp[w] = sum.toRgbaColor();
+        }
+    }
+}
+
+void GameOpenGL::DownsampleTexture(
+    rgbaColor const * restrict readBuffer,
+    ImageSize readSize,
+    rgbaColor * restrict writeBuffer,
+    ImageSize writeSize)
+{
+    assert(writeSize.Width == std::max(1, readSize.Width / 2));
+    assert(writeSize.Height == std::max(1, readSize.Height / 2));
+
+    //
+    // Split large levels across the thread pool, in bands of rows
+    //
+
+    static constexpr size_t MinParallelPixelCount = 256 * 256;
+
+    size_t const minParallelRowCount = std::max(
+        MinParallelPixelCount / static_cast<size_t>(std::max(writeSize.Width, 1)),
+        size_t(1));
+
+    TaskThreadPool::GetInstance().ParallelFor(
+        0,
+        static_cast<size_t>(writeSize.Height),
+        minParallelRowCount,
+        [=](size_t startRow, size_t endRow)
+        {
+            DownsampleTextureRows(readBuffer, readSize, writeBuffer, writeSize, static_cast<int>(startRow), static_cast<int>(endRow));
+        },
+        TaskThreadPool::Partitioning::Static);
+}
+
+GLint GameOpenGL::UploadMinifiedTextures(
+    std::unique_ptr<rgbaColor[]> readBuffer,
+    ImageSize readSize,
+    int maxDimension,
+    GLint readTextureLevel)
+{
+    //
+    // We ping-pong between the buffer of the level we've just uploaded and a single
+    // scratch buffer, which is as large as the first minified level; each level
+    // fits into either buffer, as it's at most a quarter of the previous one
+    //
+
+    std::unique_ptr<rgbaColor[]> writeBuffer;
+
+    GLint lastUploadedTextureLevel = readTextureLevel;
+    for (int divisor = 2; ; divisor *= 2)
+    {
+        if ((readSize.Width == 1 && readSize.Height == 1)
+            || maxDimension / divisor < 1)
+        {
+            // We're done!
+            break;
+        }
+
+        // Calculate dimensions of new level
+        ImageSize const writeSize(
+            std::max(1, readSize.Width / 2),
+            std::max(1, readSize.Height / 2));
+
+        if (!writeBuffer)
+        {
+            writeBuffer = std::make_unique<rgbaColor[]>(static_cast<size_t>(writeSize.Width) * static_cast<size_t>(writeSize.Height));
         }
 
+        DownsampleTexture(readBuffer.get(), readSize, writeBuffer.get(), writeSize);
+
         // Upload write buffer
         ++lastUploadedTextureLevel;
-        glTexImage2D(GL_TEXTURE_2D, lastUploadedTextureLevel, GL_RGBA, newWidth, newHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, writeBuffer.get());
-        CheckOpenGLError();
+        glTexImage2D(GL_TEXTURE_2D, lastUploadedTextureLevel, GL_RGBA, writeSize.Width, writeSize.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, writeBuffer.get());
+        GLenum const glError = glGetError();
+        if (GL_NO_ERROR != glError)
+        {
+            throw GameException("Error uploading minified texture onto GPU: " + std::to_string(glError));
+        }
 
-        // Swap buffer
-        readBuffer = std::move(writeBuffer);
+        // Swap buffers
+        readSize = writeSize;
+        std::swap(readBuffer, writeBuffer);
     }
 
-    // Set max mipmap level
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastUploadedTextureLevel);
-    CheckOpenGLError();
+    return lastUploadedTextureLevel;
 }
 
 void GameOpenGL::Flush()
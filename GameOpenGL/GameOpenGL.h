@@ -13,6 +13,8 @@
 
 #include <cassert>
 #include <cstdio>
+#include <filesystem>
+#include <optional>
 #include <string>
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -185,6 +187,26 @@ public:
 
     static void InitOpenGL();
 
+    /*
+     * Enables caching of linked program binaries in the specified folder; without
+     * a folder - or without driver support - programs are always built from source.
+     */
+    static void SetProgramBinaryCacheFolderPath(std::filesystem::path const & folderPath);
+
+    /*
+     * Attempts to populate the specified program with the binary cached for the specified
+     * source; returns false - leaving the program unlinked - when there's no valid binary.
+     */
+    static bool LoadCachedProgramBinary(
+        GameOpenGLShaderProgram const & shaderProgram,
+        std::string const & programName,
+        std::string const & programSource);
+
+    static void StoreCachedProgramBinary(
+        GameOpenGLShaderProgram const & shaderProgram,
+        std::string const & programName,
+        std::string const & programSource);
+
     static void CompileShader(
         std::string const & shaderSource,
         GLenum shaderType,
@@ -208,11 +230,55 @@ public:
 
     static void UploadMipmappedTexture(RgbaImageData baseTexture);
 
+    /*
+     * Uploads the base level of a texture whose other levels have been uploaded with a
+     * GameOpenGLTextureStreamer starting at level 1, and makes the texture sample from it.
+     */
+    static void UploadDeferredTextureBaseLevel(RgbaImageData baseTexture);
+
     static void UploadMipmappedPowerOfTwoTexture(
         RgbaImageData baseTexture,
         int maxDimension);
 
+    /*
+     * Makes the specified rows of the next mipmap level of a texture; each row depends
+     * only on two rows of the read buffer, hence levels may be made a band at a time.
+     */
+    static void DownsampleTextureRows(
+        rgbaColor const * readBuffer,
+        ImageSize readSize,
+        rgbaColor * writeBuffer,
+        ImageSize writeSize,
+        int startRow,
+        int endRow);
+
     static void Flush();
+
+private:
+
+    static bool IsProgramBinaryCacheEnabled();
+
+    static std::filesystem::path MakeCachedProgramBinaryFilePath(
+        std::string const & programName,
+        std::string const & programSource);
+
+    static std::optional<std::filesystem::path> ProgramBinaryCacheFolderPath;
+
+    static void DownsampleTexture(
+        rgbaColor const * readBuffer,
+        ImageSize readSize,
+        rgbaColor * writeBuffer,
+        ImageSize writeSize);
+
+    /*
+     * Creates and uploads all levels below the specified one, returning the last
+     * level uploaded.
+     */
+    static GLint UploadMinifiedTextures(
+        std::unique_ptr<rgbaColor[]> readBuffer,
+        ImageSize readSize,
+        int maxDimension,
+        GLint readTextureLevel = 0);
 };
 
 inline void _CheckOpenGLError(char const * file, int line)
@@ -258,4 +324,19 @@ inline void _CheckOpenGLError(char const * file, int line)
     }
 }
 
+/*
+ * glGetError() makes some drivers wait for the pipeline, hence in release builds - unless
+ * explicitly asked for - we don't check for errors after each call, but only once per frame.
+ */
+#if !defined(NDEBUG) && !defined(CHECK_OPENGL_ERRORS)
+#define CHECK_OPENGL_ERRORS
+#endif
+
+#ifdef CHECK_OPENGL_ERRORS
 #define CheckOpenGLError() _CheckOpenGLError(__FILE__, __LINE__)
+#else
+#define CheckOpenGLError() ((void)0)
+#endif
+
+// Checked in all builds, for the errors of a whole frame
+#define CheckOpenGLFrameError() _CheckOpenGLError(__FILE__, __LINE__)
@@ -0,0 +1,99 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-09
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "GameOpenGL.h"
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+/*
+ * Keeps VBOs - together with their storage - that are no longer needed, so that the
+ * VBOs of the same size and usage that are made later may take them over instead of
+ * having the driver allocate new storage; only the storage is recycled, not its contents.
+ *
+ * Must be used on the thread that owns the OpenGL context.
+ */
+class GameOpenGLBufferRecycler
+{
+public:
+
+    GameOpenGLBufferRecycler()
+        : mRetainedVBOs()
+        , mRetainedByteSize(0)
+    {}
+
+    /*
+     * Returns a VBO - bound to the specified target - whose storage has the specified
+     * size and usage.
+     */
+    GameOpenGLVBO Acquire(
+        GLenum target,
+        size_t byteSize,
+        GLenum usage)
+    {
+        auto it = mRetainedVBOs.find(Key(byteSize, usage));
+        if (it != mRetainedVBOs.end() && !it->second.empty())
+        {
+            GameOpenGLVBO vbo = std::move(it->second.back());
+            it->second.pop_back();
+
+            mRetainedByteSize -= byteSize;
+
+            glBindBuffer(target, *vbo);
+
+            return vbo;
+        }
+
+        GLuint tmpGLuint;
+        glGenBuffers(1, &tmpGLuint);
+        GameOpenGLVBO vbo(tmpGLuint);
+
+        glBindBuffer(target, *vbo);
+        glBufferData(target, byteSize, nullptr, usage);
+        CheckOpenGLError();
+
+        return vbo;
+    }
+
+    /*
+     * Takes back a VBO obtained with Acquire() for the same size and usage.
+     */
+    void Release(
+        GameOpenGLVBO && vbo,
+        size_t byteSize,
+        GLenum usage)
+    {
+        if (!vbo)
+            return;
+
+        mRetainedVBOs[Key(byteSize, usage)].emplace_back(std::move(vbo));
+        mRetainedByteSize += byteSize;
+    }
+
+    /*
+     * Deletes all the retained VBOs.
+     */
+    void Clear()
+    {
+        mRetainedVBOs.clear();
+        mRetainedByteSize = 0;
+    }
+
+    size_t GetRetainedByteSize() const
+    {
+        return mRetainedByteSize;
+    }
+
+private:
+
+    using Key = std::pair<size_t, GLenum>; // Byte size, usage
+
+    std::map<Key, std::vector<GameOpenGLVBO>> mRetainedVBOs;
+    size_t mRetainedByteSize;
+};
@@ -9,9 +9,14 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <memory>
 
 /*
  * This class is an OpenGL mapped buffer hidden behind a vector-like facade.
+ *
+ * When the OpenGL buffer may only be touched by another thread, the buffer may be
+ * "mapped" onto CPU staging memory instead, and the staged elements are then
+ * uploaded - on that thread - with upload_staged().
  */
 template<typename TElement, GLenum TTarget>
 class GameOpenGLMappedBuffer
@@ -22,6 +27,9 @@ public:
         : mMappedBuffer(nullptr)
         , mSize(0u)
         , mAllocatedSize(0u)
+        , mStagingBuffer()
+        , mStagingBufferSize(0u)
+        , mIsStaged(false)
     {
     }
 
@@ -42,13 +50,52 @@ public:
 
         mSize = 0u;
         mAllocatedSize = size;
+        mIsStaged = false;
+    }
+
+    /*
+     * Maps the buffer onto CPU staging memory; doesn't touch OpenGL.
+     */
+    void map_staged(size_t size)
+    {
+        assert(nullptr == mMappedBuffer);
+
+        if (size > mStagingBufferSize)
+        {
+            mStagingBuffer.reset(new TElement[size]);
+            mStagingBufferSize = size;
+        }
+
+        mMappedBuffer = mStagingBuffer.get();
+
+        mSize = 0u;
+        mAllocatedSize = size;
+        mIsStaged = true;
+    }
+
+    /*
+     * Maps the buffer after orphaning its storage, so that the driver may hand out
+     * fresh storage rather than wait for the GPU to be done with the current one.
+     */
+    void map_orphaned(
+        size_t size,
+        GLenum usage)
+    {
+        glBufferData(TTarget, size * sizeof(TElement), nullptr, usage);
+        CheckOpenGLError();
+
+        map(size);
     }
 
     void unmap()
     {
         assert(nullptr != mMappedBuffer);
 
-        glUnmapBuffer(TTarget);
+        if (!mIsStaged)
+        {
+            glUnmapBuffer(TTarget);
+        }
+
         mMappedBuffer = nullptr;
 
         // Leave size and allocated size as they are, as this
@@ -56,6 +103,23 @@ public:
         // of whether or not its data has been uploaded)
     }
 
+    bool is_staged() const
+    {
+        return mIsStaged;
+    }
+
+    /*
+     * Uploads the elements staged at the last map_staged() into the bound buffer; the
+     * staging memory is not touched again until the next map_staged().
+     */
+    void upload_staged() const
+    {
+        assert(mIsStaged && nullptr == mMappedBuffer);
+
+        glBufferSubData(TTarget, 0, mSize * sizeof(TElement), mStagingBuffer.get());
+        CheckOpenGLError();
+    }
+
     template<typename... TArgs>
     inline TElement & emplace_back(TArgs&&... args)
     {
@@ -82,4 +146,8 @@ private:
     void * mMappedBuffer;
     size_t mSize;
     size_t mAllocatedSize;
+
+    std::unique_ptr<TElement[]> mStagingBuffer;
+    size_t mStagingBufferSize;
+    bool mIsStaged;
 };
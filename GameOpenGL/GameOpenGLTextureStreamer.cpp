@@ -0,0 +1,204 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-04
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#include "GameOpenGLTextureStreamer.h"
+
+#include <GameCore/GameException.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+
+namespace /* anonymous */ {
+
+ImageSize MakeNextLevelSize(ImageSize const & size)
+{
+    return ImageSize(
+        std::max(1, size.Width / 2),
+        std::max(1, size.Height / 2));
+}
+
+std::unique_ptr<rgbaColor[]> MakeLevelBuffer(ImageSize const & size)
+{
+    return std::make_unique<rgbaColor[]>(static_cast<size_t>(size.Width) * static_cast<size_t>(size.Height));
+}
+
+}
+
+GameOpenGLTextureStreamer::GameOpenGLTextureStreamer(
+    RgbaImageData baseTexture,
+    GLint firstLevel)
+    : mPixelBuffer()
+    , mFirstLevel(firstLevel)
+    , mBaseTextureSize(baseTexture.Size)
+    , mBaseTextureBuffer()
+    , mCurrentLevel(firstLevel)
+    , mCurrentLevelSize(baseTexture.Size)
+    , mCurrentLevelBuffer()
+    , mPreviousLevelSize(0, 0)
+    , mPreviousLevelBuffer()
+    , mNextRow(0)
+{
+    assert(firstLevel == 0 || firstLevel == 1);
+
+    if (firstLevel == 0)
+    {
+        mCurrentLevelBuffer = std::move(baseTexture.Data);
+    }
+    else
+    {
+        mPreviousLevelSize = baseTexture.Size;
+        mPreviousLevelBuffer = std::move(baseTexture.Data);
+        mCurrentLevelSize = MakeNextLevelSize(mPreviousLevelSize);
+        mCurrentLevelBuffer = MakeLevelBuffer(mCurrentLevelSize);
+    }
+
+    //
+    // Define the storage of all levels - no pixel buffer may be bound here,
+    // or the null data would be taken as an offset into it
+    //
+
+    ImageSize levelSize = mCurrentLevelSize;
+    for (GLint level = firstLevel; ; ++level)
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, levelSize.Width, levelSize.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        GLenum const glError = glGetError();
+        if (GL_NO_ERROR != glError)
+        {
+            throw GameException("Error allocating texture on GPU: " + std::to_string(glError));
+        }
+
+        if (levelSize.Width == 1 && levelSize.Height == 1)
+            break;
+
+        levelSize = MakeNextLevelSize(levelSize);
+    }
+
+    if (firstLevel > 0)
+    {
+        // The base level is undefined, hence sample from the next level
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, firstLevel);
+        CheckOpenGLError();
+    }
+
+    GLuint tmpGLuint;
+    glGenBuffers(1, &tmpGLuint);
+    mPixelBuffer = tmpGLuint;
+}
+
+bool GameOpenGLTextureStreamer::UploadSlice(size_t maxByteCount)
+{
+    size_t uploadedByteCount = 0;
+
+    while (!IsDone() && uploadedByteCount < maxByteCount)
+    {
+        size_t const rowByteCount = static_cast<size_t>(mCurrentLevelSize.Width) * sizeof(rgbaColor);
+
+        int const rowCount = std::clamp(
+            static_cast<int>(std::min((maxByteCount - uploadedByteCount) / rowByteCount, static_cast<size_t>(mCurrentLevelSize.Height))),
+            1,
+            mCurrentLevelSize.Height - mNextRow);
+
+        rgbaColor * const rows = mCurrentLevelBuffer.get() + static_cast<size_t>(mNextRow) * static_cast<size_t>(mCurrentLevelSize.Width);
+
+        if (!!mPreviousLevelBuffer)
+        {
+            // Make the rows from the previous level
+            GameOpenGL::DownsampleTextureRows(
+                mPreviousLevelBuffer.get(),
+                mPreviousLevelSize,
+                mCurrentLevelBuffer.get(),
+                mCurrentLevelSize,
+                mNextRow,
+                mNextRow + rowCount);
+        }
+
+        size_t const byteCount = rowByteCount * static_cast<size_t>(rowCount);
+
+        //
+        // Stage the rows in the pixel buffer - orphaning its storage, so that we don't wait
+        // for the previous slice's transfer - and upload from there
+        //
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, *mPixelBuffer);
+
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, byteCount, nullptr, GL_STREAM_DRAW);
+        void * const mappedBuffer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        if (nullptr == mappedBuffer)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            throw GameException("Error mapping texture pixel buffer");
+        }
+
+        std::memcpy(mappedBuffer, rows, byteCount);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        glTexSubImage2D(GL_TEXTURE_2D, mCurrentLevel, 0, mNextRow, mCurrentLevelSize.Width, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        CheckOpenGLError();
+
+        uploadedByteCount += byteCount;
+
+        mNextRow += rowCount;
+        if (mNextRow == mCurrentLevelSize.Height)
+        {
+            AdvanceLevel();
+        }
+    }
+
+    return IsDone();
+}
+
+RgbaImageData GameOpenGLTextureStreamer::TakeBaseTexture()
+{
+    assert(IsDone());
+    assert(!!mBaseTextureBuffer);
+
+    return RgbaImageData(
+        mBaseTextureSize,
+        std::move(mBaseTextureBuffer));
+}
+
+size_t GameOpenGLTextureStreamer::GetByteSize() const
+{
+    auto const getBufferByteSize = [](std::unique_ptr<rgbaColor[]> const & buffer, ImageSize const & size)
+    {
+        return !!buffer
+            ? static_cast<size_t>(size.Width) * static_cast<size_t>(size.Height) * sizeof(rgbaColor)
+            : size_t(0);
+    };
+
+    return getBufferByteSize(mBaseTextureBuffer, mBaseTextureSize)
+        + getBufferByteSize(mCurrentLevelBuffer, mCurrentLevelSize)
+        + getBufferByteSize(mPreviousLevelBuffer, mPreviousLevelSize);
+}
+
+void GameOpenGLTextureStreamer::AdvanceLevel()
+{
+    if (mCurrentLevel == 1 && mFirstLevel == 1)
+    {
+        // The previous level is the base level, which goes back to the caller
+        mBaseTextureBuffer = std::move(mPreviousLevelBuffer);
+    }
+
+    if (mCurrentLevelSize.Width == 1 && mCurrentLevelSize.Height == 1)
+    {
+        // That was the last level
+        mCurrentLevelBuffer.reset();
+        mPreviousLevelBuffer.reset();
+        return;
+    }
+
+    mPreviousLevelSize = mCurrentLevelSize;
+    mPreviousLevelBuffer = std::move(mCurrentLevelBuffer);
+
+    ++mCurrentLevel;
+    mCurrentLevelSize = MakeNextLevelSize(mPreviousLevelSize);
+    mCurrentLevelBuffer = MakeLevelBuffer(mCurrentLevelSize);
+
+    mNextRow = 0;
+}
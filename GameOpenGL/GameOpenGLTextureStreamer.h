@@ -0,0 +1,83 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-07-04
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "GameOpenGL.h"
+
+#include <GameCore/ImageData.h>
+#include <GameCore/ImageSize.h>
+
+#include <cstddef>
+#include <memory>
+
+/*
+ * Uploads a mipmapped texture a slice at a time, so that the upload of a large texture
+ * may be spread over many frames.
+ *
+ * Each slice is a band of rows of one mipmap level, which - for all levels but the
+ * first - is minified from the previous level right before it is uploaded; the rows
+ * go through a pixel buffer object, so that uploading them doesn't stall on the
+ * transfer to the GPU.
+ *
+ * The sampled contents of the texture are undefined until the last slice has been
+ * uploaded.
+ */
+class GameOpenGLTextureStreamer
+{
+public:
+
+    /*
+     * Defines the storage of all the mipmap levels of the texture bound to GL_TEXTURE_2D,
+     * from the specified level onwards. When that is level 1, the base level is only used
+     * to make level 1, and it is given back once done.
+     */
+    GameOpenGLTextureStreamer(
+        RgbaImageData baseTexture,
+        GLint firstLevel);
+
+    /*
+     * Uploads - into the texture bound to GL_TEXTURE_2D - at most the specified number of
+     * bytes, and at least one row; returns true when the whole texture has been uploaded.
+     */
+    bool UploadSlice(size_t maxByteCount);
+
+    bool IsDone() const
+    {
+        return !mCurrentLevelBuffer;
+    }
+
+    /*
+     * Gives back the base level, once done, when the first level was level 1.
+     */
+    RgbaImageData TakeBaseTexture();
+
+    /*
+     * The CPU memory held for the levels being made.
+     */
+    size_t GetByteSize() const;
+
+private:
+
+    void AdvanceLevel();
+
+private:
+
+    GameOpenGLVBO mPixelBuffer;
+
+    GLint const mFirstLevel;
+
+    ImageSize const mBaseTextureSize;
+    std::unique_ptr<rgbaColor[]> mBaseTextureBuffer; // Held when the first level is level 1
+
+    // The level we're making and uploading, and the one it's made from
+    GLint mCurrentLevel;
+    ImageSize mCurrentLevelSize;
+    std::unique_ptr<rgbaColor[]> mCurrentLevelBuffer;
+    ImageSize mPreviousLevelSize;
+    std::unique_ptr<rgbaColor[]> mPreviousLevelBuffer;
+
+    int mNextRow;
+};
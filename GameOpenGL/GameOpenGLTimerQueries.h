@@ -0,0 +1,344 @@
+/***************************************************************************************
+* Original Author:		Gabriele Giuseppini
+* Created:				2019-06-12
+* Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+***************************************************************************************/
+#pragma once
+
+#include "GameOpenGL.h"
+
+#include <GameCore/TraceLog.h>
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+/*
+ * Measures how long the GPU spends on named scopes of render commands, by means
+ * of timestamp queries, and adds the results to the trace log as GPU events.
+ *
+ * Results are collected a few frames later, once the GPU has produced them, so
+ * that we never stall the pipeline. Does nothing when we're not tracing, or when
+ * the driver does not support timer queries.
+ */
+class GameOpenGLTimerQueries
+{
+public:
+
+    GameOpenGLTimerQueries()
+        : mPendingScopes()
+        , mOpenScopeIndices()
+        , mFreeQueries()
+        , mGPUOriginTimestamp(0)
+        , mCPUOriginTime()
+        , mIsCalibrated(false)
+        , mIsFrameTraced(false)
+    {}
+
+    ~GameOpenGLTimerQueries()
+    {
+        for (auto const & pendingScope : mPendingScopes)
+        {
+            mFreeQueries.push_back(pendingScope.StartQuery);
+            mFreeQueries.push_back(pendingScope.EndQuery);
+        }
+
+        if (!mFreeQueries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(mFreeQueries.size()), mFreeQueries.data());
+        }
+    }
+
+    GameOpenGLTimerQueries(GameOpenGLTimerQueries const &) = delete;
+    GameOpenGLTimerQueries & operator=(GameOpenGLTimerQueries const &) = delete;
+
+    static bool IsSupported()
+    {
+        return nullptr != glQueryCounter
+            && nullptr != glGetQueryObjectui64v
+            && nullptr != glGetInteger64v;
+    }
+
+    /*
+     * Adds to the trace the scopes whose results have become available.
+     *
+     * Invoked once per frame, before any scope is begun; whether or not the frame's
+     * scopes are measured is decided here, so that they are consistent throughout.
+     */
+    void CollectResults()
+    {
+        assert(mOpenScopeIndices.empty());
+
+        mIsFrameTraced = IsSupported() && TraceLog::GetInstance().IsTracing();
+
+        if (!IsSupported())
+            return;
+
+        if (!mIsFrameTraced)
+        {
+            // Results of scopes begun while tracing are of no use anymore
+            RecycleAllPendingScopes();
+
+            // Re-calibrate at the next trace, as the clocks drift apart
+            mIsCalibrated = false;
+
+            return;
+        }
+
+        if (!mIsCalibrated)
+        {
+            Calibrate();
+        }
+
+        size_t collectedCount = 0;
+        for (auto const & pendingScope : mPendingScopes)
+        {
+            GLuint isAvailable = GL_FALSE;
+            glGetQueryObjectuiv(pendingScope.EndQuery, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+            if (GL_FALSE == isAvailable)
+            {
+                // Queries complete in order, hence later ones won't be available either
+                break;
+            }
+
+            GLuint64 startTimestamp;
+            glGetQueryObjectui64v(pendingScope.StartQuery, GL_QUERY_RESULT, &startTimestamp);
+            GLuint64 endTimestamp;
+            glGetQueryObjectui64v(pendingScope.EndQuery, GL_QUERY_RESULT, &endTimestamp);
+
+            TraceLog::GetInstance().AddGPUEvent(
+                pendingScope.Name,
+                ToCPUTime(startTimestamp),
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::nanoseconds(endTimestamp - startTimestamp)));
+
+            mFreeQueries.push_back(pendingScope.StartQuery);
+            mFreeQueries.push_back(pendingScope.EndQuery);
+
+            ++collectedCount;
+        }
+
+        mPendingScopes.erase(mPendingScopes.begin(), mPendingScopes.begin() + collectedCount);
+    }
+
+    void BeginScope(char const * name)
+    {
+        if (!mIsFrameTraced)
+            return;
+
+        mOpenScopeIndices.push_back(mPendingScopes.size());
+        mPendingScopes.push_back({ name, AllocateQuery(), 0 });
+
+        glQueryCounter(mPendingScopes.back().StartQuery, GL_TIMESTAMP);
+    }
+
+    void EndScope()
+    {
+        if (!mIsFrameTraced)
+            return;
+
+        assert(!mOpenScopeIndices.empty());
+
+        auto & pendingScope = mPendingScopes[mOpenScopeIndices.back()];
+        mOpenScopeIndices.pop_back();
+
+        pendingScope.EndQuery = AllocateQuery();
+        glQueryCounter(pendingScope.EndQuery, GL_TIMESTAMP);
+    }
+
+private:
+
+    GLuint AllocateQuery()
+    {
+        if (mFreeQueries.empty())
+        {
+            GLuint query;
+            glGenQueries(1, &query);
+            return query;
+        }
+
+        GLuint const query = mFreeQueries.back();
+        mFreeQueries.pop_back();
+        return query;
+    }
+
+    void RecycleAllPendingScopes()
+    {
+        for (auto const & pendingScope : mPendingScopes)
+        {
+            mFreeQueries.push_back(pendingScope.StartQuery);
+            mFreeQueries.push_back(pendingScope.EndQuery);
+        }
+
+        mPendingScopes.clear();
+    }
+
+    void Calibrate()
+    {
+        // Synchronous, but only once per trace
+        GLint64 gpuTimestamp;
+        glGetInteger64v(GL_TIMESTAMP, &gpuTimestamp);
+
+        mGPUOriginTimestamp = gpuTimestamp;
+        mCPUOriginTime = std::chrono::steady_clock::now();
+        mIsCalibrated = true;
+    }
+
+    std::chrono::steady_clock::time_point ToCPUTime(GLuint64 gpuTimestamp) const
+    {
+        return mCPUOriginTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(static_cast<GLint64>(gpuTimestamp) - mGPUOriginTimestamp));
+    }
+
+private:
+
+    struct PendingScope
+    {
+        char const * Name;
+        GLuint StartQuery;
+        GLuint EndQuery;
+    };
+
+    // In the order in which they were begun
+    std::vector<PendingScope> mPendingScopes;
+
+    // Indices into the pending scopes, for nesting
+    std::vector<size_t> mOpenScopeIndices;
+
+    std::vector<GLuint> mFreeQueries;
+
+    GLint64 mGPUOriginTimestamp;
+    std::chrono::steady_clock::time_point mCPUOriginTime;
+    bool mIsCalibrated;
+
+    bool mIsFrameTraced;
+};
+
+/*
+ * Measures a scope of render commands on the GPU.
+ */
+class ScopedGPUTimer
+{
+public:
+
+    ScopedGPUTimer(
+        GameOpenGLTimerQueries & timerQueries,
+        char const * name)
+        : mTimerQueries(timerQueries)
+    {
+        mTimerQueries.BeginScope(name);
+    }
+
+    ~ScopedGPUTimer()
+    {
+        mTimerQueries.EndScope();
+    }
+
+    ScopedGPUTimer(ScopedGPUTimer const &) = delete;
+    ScopedGPUTimer & operator=(ScopedGPUTimer const &) = delete;
+
+private:
+
+    GameOpenGLTimerQueries & mTimerQueries;
+};
+
+/*
+ * Measures how long the GPU spends on one scope per frame - whether or not we're
+ * tracing - by means of elapsed-time queries.
+ *
+ * Results are collected a few frames later, once the GPU has produced them, so
+ * that we never stall the pipeline.
+ */
+class GameOpenGLElapsedTimer
+{
+public:
+
+    GameOpenGLElapsedTimer()
+        : mQueries()
+        , mNextQuery(0)
+        , mPendingQueryCount(0)
+    {}
+
+    ~GameOpenGLElapsedTimer()
+    {
+        if (mQueries[0] != 0)
+        {
+            glDeleteQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+        }
+    }
+
+    GameOpenGLElapsedTimer(GameOpenGLElapsedTimer const &) = delete;
+    GameOpenGLElapsedTimer & operator=(GameOpenGLElapsedTimer const &) = delete;
+
+    static bool IsSupported()
+    {
+        return GameOpenGLTimerQueries::IsSupported();
+    }
+
+    void Begin()
+    {
+        if (!IsSupported())
+            return;
+
+        if (mQueries[0] == 0)
+        {
+            glGenQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+        }
+
+        // Re-using the oldest pending query discards its result
+        if (mPendingQueryCount == mQueries.size())
+            --mPendingQueryCount;
+
+        glBeginQuery(GL_TIME_ELAPSED, mQueries[mNextQuery]);
+    }
+
+    void End()
+    {
+        if (!IsSupported())
+            return;
+
+        glEndQuery(GL_TIME_ELAPSED);
+
+        mNextQuery = (mNextQuery + 1) % mQueries.size();
+        ++mPendingQueryCount;
+    }
+
+    /*
+     * Returns the most recent of the results that have become available since the
+     * last invocation, if any.
+     */
+    std::optional<float> CollectLatestMillis()
+    {
+        std::optional<float> latestMillis;
+
+        while (mPendingQueryCount > 0)
+        {
+            GLuint const query = mQueries[(mNextQuery + mQueries.size() - mPendingQueryCount) % mQueries.size()];
+
+            GLuint isAvailable = GL_FALSE;
+            glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+            if (GL_FALSE == isAvailable)
+            {
+                // Queries complete in order, hence later ones won't be available either
+                break;
+            }
+
+            GLuint64 elapsedNanoseconds;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNanoseconds);
+
+            latestMillis = static_cast<float>(elapsedNanoseconds) / 1000000.0f;
+
+            --mPendingQueryCount;
+        }
+
+        return latestMillis;
+    }
+
+private:
+
+    std::array<GLuint, 4> mQueries;
+    size_t mNextQuery;
+    size_t mPendingQueryCount;
+};
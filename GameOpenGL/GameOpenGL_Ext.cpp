@@ -133,6 +133,31 @@ void InitOpenGLExt_DrawInstanced(GLADloadproc load)
     }
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Instanced Arrays
+//////////////////////////////////////////////////////////////////////////
+
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = NULL;
+
+void InitOpenGLExt_InstancedArrays(GLADloadproc load)
+{
+    if (GLVersion.major > 3 // Core in 3.3
+        || (GLVersion.major == 3 && GLVersion.minor >= 3))
+    {
+        // Core
+
+        LoadAndVerify("glVertexAttribDivisor", glVertexAttribDivisor, load);
+    }
+    else if (HasExt("GL_ARB_instanced_arrays"))
+    {
+        LoadAndVerify("glVertexAttribDivisorARB", glVertexAttribDivisor, load);
+    }
+    else
+    {
+        throw GameException("Instanced Arrays functionality is not supported");
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 // VAO
 //////////////////////////////////////////////////////////////////////////
@@ -177,6 +202,184 @@ void InitOpenGLExt_TextureFloat(GLADloadproc /*load*/)
     }
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Program Binary
+//////////////////////////////////////////////////////////////////////////
+
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = NULL;
+
+void InitOpenGLExt_ProgramBinary(GLADloadproc load)
+{
+    if ((GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1)) // Core in 4.1
+        || HasExt("GL_ARB_get_program_binary"))
+    {
+        // Core or ARB - same names
+
+        try
+        {
+            LoadAndVerify("glGetProgramBinary", glGetProgramBinary, load);
+            LoadAndVerify("glProgramBinary", glProgramBinary, load);
+            LoadAndVerify("glProgramParameteri", glProgramParameteri, load);
+        }
+        catch (GameException const &)
+        {
+            // Not required, hence treat as unsupported
+            glGetProgramBinary = NULL;
+            glProgramBinary = NULL;
+            glProgramParameteri = NULL;
+        }
+    }
+    else
+    {
+        // Not required - we just compile programs from source every time
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Timer Query
+//////////////////////////////////////////////////////////////////////////
+
+PFNGLQUERYCOUNTERPROC glQueryCounter = NULL;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = NULL;
+PFNGLGETINTEGER64VPROC glGetInteger64v = NULL;
+
+void InitOpenGLExt_TimerQuery(GLADloadproc load)
+{
+    if (GLVersion.major > 3 // Core in 3.3
+        || (GLVersion.major == 3 && GLVersion.minor >= 3)
+        || HasExt("GL_ARB_timer_query"))
+    {
+        // Core or ARB - same names
+
+        try
+        {
+            LoadAndVerify("glQueryCounter", glQueryCounter, load);
+            LoadAndVerify("glGetQueryObjectui64v", glGetQueryObjectui64v, load);
+            LoadAndVerify("glGetInteger64v", glGetInteger64v, load);
+        }
+        catch (GameException const &)
+        {
+            // Not required, hence treat as unsupported
+            glQueryCounter = NULL;
+            glGetQueryObjectui64v = NULL;
+            glGetInteger64v = NULL;
+        }
+    }
+    else
+    {
+        // Not required - we just don't trace the GPU
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Sync
+//////////////////////////////////////////////////////////////////////////
+
+PFNGLFENCESYNCPROC glFenceSync = NULL;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync = NULL;
+PFNGLDELETESYNCPROC glDeleteSync = NULL;
+PFNGLWAITSYNCPROC glWaitSync = NULL;
+
+void InitOpenGLExt_Sync(GLADloadproc load)
+{
+    if (GLVersion.major > 3 // Core in 3.2
+        || (GLVersion.major == 3 && GLVersion.minor >= 2)
+        || HasExt("GL_ARB_sync"))
+    {
+        // Core or ARB - same names
+
+        try
+        {
+            LoadAndVerify("glFenceSync", glFenceSync, load);
+            LoadAndVerify("glClientWaitSync", glClientWaitSync, load);
+            LoadAndVerify("glDeleteSync", glDeleteSync, load);
+            LoadAndVerify("glWaitSync", glWaitSync, load);
+        }
+        catch (GameException const &)
+        {
+            // Not required, hence treat as unsupported
+            glFenceSync = NULL;
+            glClientWaitSync = NULL;
+            glDeleteSync = NULL;
+            glWaitSync = NULL;
+        }
+    }
+    else
+    {
+        // Not required - we just let the driver block when mapping results
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Copy Buffer
+//////////////////////////////////////////////////////////////////////////
+
+PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData = NULL;
+
+void InitOpenGLExt_CopyBuffer(GLADloadproc load)
+{
+    if (GLVersion.major > 3 // Core in 3.1
+        || (GLVersion.major == 3 && GLVersion.minor >= 1)
+        || HasExt("GL_ARB_copy_buffer"))
+    {
+        // Core or ARB - same names
+
+        try
+        {
+            LoadAndVerify("glCopyBufferSubData", glCopyBufferSubData, load);
+        }
+        catch (GameException const &)
+        {
+            // Not required, hence treat as unsupported
+            glCopyBufferSubData = NULL;
+        }
+    }
+    else
+    {
+        // Not required - GPU results then go through the CPU
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Framebuffer Blit
+//////////////////////////////////////////////////////////////////////////
+
+PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer = NULL;
+
+void InitOpenGLExt_FramebufferBlit(GLADloadproc load)
+{
+    if (GLVersion.major >= 3) // Core in 3.0
+    {
+        try
+        {
+            LoadAndVerify("glBlitFramebuffer", glBlitFramebuffer, load);
+        }
+        catch (GameException const &)
+        {
+            // Not required, hence treat as unsupported
+            glBlitFramebuffer = NULL;
+        }
+    }
+    else if (HasExt("GL_EXT_framebuffer_blit") && HasExt("GL_EXT_packed_depth_stencil"))
+    {
+        try
+        {
+            LoadAndVerify("glBlitFramebufferEXT", glBlitFramebuffer, load);
+        }
+        catch (GameException const &)
+        {
+            // Not required, hence treat as unsupported
+            glBlitFramebuffer = NULL;
+        }
+    }
+    else
+    {
+        // Not required - we just always render at the resolution of the canvas
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Init
 //////////////////////////////////////////////////////////////////////////
@@ -193,10 +396,22 @@ void InitOpenGLExt()
 
                 InitOpenGLExt_DrawInstanced(&get_proc);
 
+                InitOpenGLExt_InstancedArrays(&get_proc);
+
                 InitOpenGLExt_VertexArray(&get_proc);
 
                 InitOpenGLExt_TextureFloat(&get_proc);
 
+                InitOpenGLExt_ProgramBinary(&get_proc);
+
+                InitOpenGLExt_TimerQuery(&get_proc);
+
+                InitOpenGLExt_Sync(&get_proc);
+
+                InitOpenGLExt_CopyBuffer(&get_proc);
+
+                InitOpenGLExt_FramebufferBlit(&get_proc);
+
                 free_exts();
             }
 
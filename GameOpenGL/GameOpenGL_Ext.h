@@ -146,6 +146,18 @@ typedef void (APIENTRYP PFNGLDRAWELEMENTSINSTANCEDPROC)(GLenum mode, GLsizei cou
 GLAPI PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
 
 
+//////////////////////////////////////////////////////////////////////////
+// Instanced Arrays
+//////////////////////////////////////////////////////////////////////////
+
+//
+// Functions
+//
+
+typedef void (APIENTRYP PFNGLVERTEXATTRIBDIVISORPROC)(GLuint index, GLuint divisor);
+GLAPI PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
+
+
 //////////////////////////////////////////////////////////////////////////
 // VAO
 //////////////////////////////////////////////////////////////////////////
@@ -184,6 +196,147 @@ GLAPI PFNGLISVERTEXARRAYPROC glIsVertexArray;
 #define GL_RGB32F 0x8815
 #define GL_RGBA16F 0x881a
 #define GL_RGB16F 0x881b
+#define GL_RG 0x8227
+
+//////////////////////////////////////////////////////////////////////////
+// Pixel Buffer Object
+//////////////////////////////////////////////////////////////////////////
+
+//
+// Enumerants
+//
+
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+
+//////////////////////////////////////////////////////////////////////////
+// Program Binary
+//
+// Optional: the functions are NULL when not supported
+//////////////////////////////////////////////////////////////////////////
+
+//
+// Functions
+//
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+GLAPI PFNGLGETPROGRAMBINARYPROC glGetProgramBinary;
+
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+GLAPI PFNGLPROGRAMBINARYPROC glProgramBinary;
+
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+GLAPI PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
+
+//
+// Enumerants
+//
+
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+//////////////////////////////////////////////////////////////////////////
+// Timer Query
+//
+// Optional: the functions are NULL when not supported
+//////////////////////////////////////////////////////////////////////////
+
+//
+// Functions
+//
+
+typedef void (APIENTRYP PFNGLQUERYCOUNTERPROC)(GLuint id, GLenum target);
+GLAPI PFNGLQUERYCOUNTERPROC glQueryCounter;
+
+typedef void (APIENTRYP PFNGLGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname, GLuint64 *params);
+GLAPI PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
+
+typedef void (APIENTRYP PFNGLGETINTEGER64VPROC)(GLenum pname, GLint64 *data);
+GLAPI PFNGLGETINTEGER64VPROC glGetInteger64v;
+
+//
+// Enumerants
+//
+
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_TIMESTAMP 0x8E28
+
+//////////////////////////////////////////////////////////////////////////
+// Sync
+//
+// Optional: the functions are NULL when not supported
+//////////////////////////////////////////////////////////////////////////
+
+//
+// Functions
+//
+
+typedef GLsync (APIENTRYP PFNGLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
+GLAPI PFNGLFENCESYNCPROC glFenceSync;
+
+typedef GLenum (APIENTRYP PFNGLCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+GLAPI PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+
+typedef void (APIENTRYP PFNGLDELETESYNCPROC)(GLsync sync);
+GLAPI PFNGLDELETESYNCPROC glDeleteSync;
+
+typedef void (APIENTRYP PFNGLWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+GLAPI PFNGLWAITSYNCPROC glWaitSync;
+
+//
+// Enumerants
+//
+
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+
+//////////////////////////////////////////////////////////////////////////
+// Copy Buffer
+//
+// Optional: the functions are NULL when not supported
+//////////////////////////////////////////////////////////////////////////
+
+//
+// Functions
+//
+
+typedef void (APIENTRYP PFNGLCOPYBUFFERSUBDATAPROC)(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size);
+GLAPI PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData;
+
+//
+// Enumerants
+//
+
+#define GL_COPY_READ_BUFFER 0x8F36
+#define GL_COPY_WRITE_BUFFER 0x8F37
+
+//////////////////////////////////////////////////////////////////////////
+// Framebuffer Blit
+//
+// Optional: the functions are NULL when not supported
+//////////////////////////////////////////////////////////////////////////
+
+//
+// Functions
+//
+
+typedef void (APIENTRYP PFNGLBLITFRAMEBUFFERPROC)(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+GLAPI PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
+
+//
+// Enumerants
+//
+
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_DEPTH_STENCIL_ATTACHMENT 0x821A
+#define GL_DEPTH24_STENCIL8 0x88F0
 
 #ifdef __cplusplus
 }
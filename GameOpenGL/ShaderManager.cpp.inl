@@ -6,6 +6,7 @@
 #include "ShaderManager.h"
 
 #include <GameCore/GameException.h>
+#include <GameCore/ResourceArchive.h>
 #include <GameCore/Utils.h>
 
 #include <regex>
@@ -17,8 +18,11 @@ static const std::string StaticParametersFilenameStem = "static_parameters";
 template<typename Traits>
 ShaderManager<Traits>::ShaderManager(
     std::filesystem::path const & shadersRoot)
+    : mPrograms()
+    , mActiveProgramIndex(std::numeric_limits<uint32_t>::max()) // None yet
+    , mActiveTextureUnit(std::numeric_limits<GLenum>::max()) // None yet
 {
-    if (!std::filesystem::exists(shadersRoot))
+    if (!ResourceArchive::Exists(shadersRoot))
         throw GameException("Shaders root path \"" + shadersRoot.string() + "\" does not exist");
 
     //
@@ -29,7 +33,7 @@ ShaderManager<Traits>::ShaderManager(
 
     // 1) From file
     std::filesystem::path localStaticParametersFilepath = shadersRoot / (StaticParametersFilenameStem + ".glslinc");
-    if (std::filesystem::exists(localStaticParametersFilepath))
+    if (ResourceArchive::Exists(localStaticParametersFilepath))
     {
         std::string localStaticParametersSource = Utils::LoadTextFile(localStaticParametersFilepath);
         ParseLocalStaticParameters(localStaticParametersSource, staticParameters);
@@ -42,19 +46,18 @@ ShaderManager<Traits>::ShaderManager(
     // Filename -> (isShader, source)
     std::unordered_map<std::string, std::pair<bool, std::string>> shaderSources;
 
-    for (auto const & entryIt : std::filesystem::directory_iterator(shadersRoot))
+    for (auto const & shaderFilepath : ResourceArchive::ListDirectory(shadersRoot))
     {
-        if (std::filesystem::is_regular_file(entryIt.path())
-            && (entryIt.path().extension() == ".glsl" || entryIt.path().extension() == ".glslinc")
-            && entryIt.path().stem() != StaticParametersFilenameStem)
+        if ((shaderFilepath.extension() == ".glsl" || shaderFilepath.extension() == ".glslinc")
+            && shaderFilepath.stem() != StaticParametersFilenameStem)
         {
-            std::string shaderFilename = entryIt.path().filename().string();
+            std::string shaderFilename = shaderFilepath.filename().string();
 
             assert(shaderSources.count(shaderFilename) == 0); // Guaranteed by file system
 
             shaderSources[shaderFilename] = std::make_pair<bool, std::string>(
-                entryIt.path().extension() == ".glsl",
-                Utils::LoadTextFile(entryIt.path()));
+                shaderFilepath.extension() == ".glsl",
+                Utils::LoadTextFile(shaderFilepath));
         }
     }
 
@@ -125,55 +128,61 @@ void ShaderManager<Traits>::CompileShader(
         mPrograms[programIndex].OpenGLHandle = glCreateProgram();
         CheckOpenGLError();
 
+        vertexShaderSource = SubstituteStaticParameters(vertexShaderSource, staticParameters);
+        fragmentShaderSource = SubstituteStaticParameters(fragmentShaderSource, staticParameters);
 
-        //
-        // Compile vertex shader
-        //
+        // The attribute bindings are a function of the sources, hence these are all we need to key the cache on
+        std::string const programSource = vertexShaderSource + fragmentShaderSource;
 
-        vertexShaderSource = SubstituteStaticParameters(vertexShaderSource, staticParameters);
+        if (!GameOpenGL::LoadCachedProgramBinary(mPrograms[programIndex].OpenGLHandle, programName, programSource))
+        {
+            //
+            // Compile vertex shader
+            //
 
-        GameOpenGL::CompileShader(
-            vertexShaderSource,
-            GL_VERTEX_SHADER,
-            mPrograms[programIndex].OpenGLHandle,
-            programName);
+            GameOpenGL::CompileShader(
+                vertexShaderSource,
+                GL_VERTEX_SHADER,
+                mPrograms[programIndex].OpenGLHandle,
+                programName);
 
 
-        //
-        // Compile fragment shader
-        //
+            //
+            // Compile fragment shader
+            //
 
-        fragmentShaderSource = SubstituteStaticParameters(fragmentShaderSource, staticParameters);
+            GameOpenGL::CompileShader(
+                fragmentShaderSource,
+                GL_FRAGMENT_SHADER,
+                mPrograms[programIndex].OpenGLHandle,
+                programName);
 
-        GameOpenGL::CompileShader(
-            fragmentShaderSource,
-            GL_FRAGMENT_SHADER,
-            mPrograms[programIndex].OpenGLHandle,
-            programName);
 
+            //
+            // Extract attribute names from vertex shader and bind them
+            //
 
-        //
-        // Extract attribute names from vertex shader and bind them
-        //
+            std::set<std::string> vertexAttributeNames = ExtractVertexAttributeNames(vertexShaderSource);
 
-        std::set<std::string> vertexAttributeNames = ExtractVertexAttributeNames(vertexShaderSource);
+            for (auto const & vertexAttributeName : vertexAttributeNames)
+            {
+                auto vertexAttribute = Traits::StrToVertexAttributeType(vertexAttributeName);
 
-        for (auto const & vertexAttributeName : vertexAttributeNames)
-        {
-            auto vertexAttribute = Traits::StrToVertexAttributeType(vertexAttributeName);
+                GameOpenGL::BindAttributeLocation(
+                    mPrograms[programIndex].OpenGLHandle,
+                    static_cast<GLuint>(vertexAttribute),
+                    "in" + vertexAttributeName);
+            }
 
-            GameOpenGL::BindAttributeLocation(
-                mPrograms[programIndex].OpenGLHandle,
-                static_cast<GLuint>(vertexAttribute),
-                "in" + vertexAttributeName);
-        }
 
+            //
+            // Link
+            //
 
-        //
-        // Link
-        //
+            GameOpenGL::LinkShaderProgram(mPrograms[programIndex].OpenGLHandle, programName);
 
-        GameOpenGL::LinkShaderProgram(mPrograms[programIndex].OpenGLHandle, programName);
+            GameOpenGL::StoreCachedProgramBinary(mPrograms[programIndex].OpenGLHandle, programName, programSource);
+        }
 
 
         //
@@ -193,6 +202,7 @@ void ShaderManager<Traits>::CompileShader(
             while (mPrograms[programIndex].UniformLocations.size() <= programParameterIndex)
             {
                 mPrograms[programIndex].UniformLocations.push_back(-1);
+                mPrograms[programIndex].UniformValues.emplace_back();
             }
 
             // Get and store
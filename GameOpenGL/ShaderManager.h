@@ -9,10 +9,12 @@
 
 #include <GameCore/Vectors.h>
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <filesystem>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -80,6 +82,9 @@ public:
         constexpr uint32_t programIndex = static_cast<uint32_t>(Program);
         constexpr uint32_t parameterIndex = static_cast<uint32_t>(Parameter);
 
+        if (!mPrograms[programIndex].UniformValues[parameterIndex].Update(value, 0.0f, 0.0f, 0.0f))
+            return;
+
         glUniform1f(
             mPrograms[programIndex].UniformLocations[parameterIndex],
             value);
@@ -93,6 +98,9 @@ public:
         constexpr uint32_t programIndex = static_cast<uint32_t>(Program);
         constexpr uint32_t parameterIndex = static_cast<uint32_t>(Parameter);
 
+        if (!mPrograms[programIndex].UniformValues[parameterIndex].Update(val1, val2, 0.0f, 0.0f))
+            return;
+
         glUniform2f(
             mPrograms[programIndex].UniformLocations[parameterIndex],
             val1,
@@ -107,6 +115,9 @@ public:
         constexpr uint32_t programIndex = static_cast<uint32_t>(Program);
         constexpr uint32_t parameterIndex = static_cast<uint32_t>(Parameter);
 
+        if (!mPrograms[programIndex].UniformValues[parameterIndex].Update(val1, val2, val3, 0.0f))
+            return;
+
         glUniform3f(
             mPrograms[programIndex].UniformLocations[parameterIndex],
             val1,
@@ -122,6 +133,9 @@ public:
         constexpr uint32_t programIndex = static_cast<uint32_t>(Program);
         constexpr uint32_t parameterIndex = static_cast<uint32_t>(Parameter);
 
+        if (!mPrograms[programIndex].UniformValues[parameterIndex].Update(val1, val2, val3, val4))
+            return;
+
         glUniform4f(
             mPrograms[programIndex].UniformLocations[parameterIndex],
             val1,
@@ -147,24 +161,37 @@ public:
         CheckUniformError<Program, Parameter>();
     }
 
-    // At any given moment, only one program may be active
+    // At any given moment, only one program may be active; activating the program
+    // that is already active is free
     template <typename Traits::ProgramType Program>
     inline void ActivateProgram()
     {
         uint32_t const programIndex = static_cast<uint32_t>(Program);
 
-        glUseProgram(*(mPrograms[programIndex].OpenGLHandle));
+        if (programIndex != mActiveProgramIndex)
+        {
+            glUseProgram(*(mPrograms[programIndex].OpenGLHandle));
+
+            CheckOpenGLError();
 
-        CheckOpenGLError();
+            mActiveProgramIndex = programIndex;
+        }
     }
 
-    // At any given moment, only one texture (unit) may be active
+    // At any given moment, only one texture (unit) may be active; activating the unit
+    // that is already active is free
     template <typename Traits::ProgramParameterType Parameter>
     inline void ActivateTexture()
     {
         GLenum const textureUnit = static_cast<GLenum>(Parameter) - static_cast<GLenum>(Traits::ProgramParameterType::_FirstTexture);
-        glActiveTexture(GL_TEXTURE0 + textureUnit);
-        CheckOpenGLError();
+
+        if (textureUnit != mActiveTextureUnit)
+        {
+            glActiveTexture(GL_TEXTURE0 + textureUnit);
+            CheckOpenGLError();
+
+            mActiveTextureUnit = textureUnit;
+        }
     }
 
 private:
@@ -172,22 +199,29 @@ private:
     template <typename Traits::ProgramType Program, typename Traits::ProgramParameterType Parameter>
     static void CheckUniformError()
     {
+#ifdef CHECK_OPENGL_ERRORS
         GLenum glError = glGetError();
         if (GL_NO_ERROR != glError)
         {
             throw GameException("Error setting uniform for parameter \"" + Traits::ProgramParameterTypeToStr(Parameter) + "\" on program \"" + Traits::ProgramTypeToStr(Program) + "\"");
         }
+#endif
     }
 
     static void CheckUniformError(
         typename Traits::ProgramType program,
         typename Traits::ProgramParameterType parameter)
     {
+#ifdef CHECK_OPENGL_ERRORS
         GLenum glError = glGetError();
         if (GL_NO_ERROR != glError)
         {
             throw GameException("Error setting uniform for parameter \"" + Traits::ProgramParameterTypeToStr(parameter) + "\" on program \"" + Traits::ProgramTypeToStr(program) + "\"");
         }
+#else
+        (void)program;
+        (void)parameter;
+#endif
     }
 
 private:
@@ -221,6 +255,38 @@ private:
 
 private:
 
+    /*
+     * The value we've last set a float uniform to.
+     */
+    struct UniformValue
+    {
+        bool IsSet;
+        std::array<float, 4> Values;
+
+        UniformValue()
+            : IsSet(false)
+            , Values()
+        {}
+
+        // Returns true when the value has changed, i.e. when it has to be set
+        bool Update(float val1, float val2, float val3, float val4)
+        {
+            if (IsSet
+                && Values[0] == val1
+                && Values[1] == val2
+                && Values[2] == val3
+                && Values[3] == val4)
+            {
+                return false;
+            }
+
+            IsSet = true;
+            Values = { val1, val2, val3, val4 };
+
+            return true;
+        }
+    };
+
     struct ProgramInfo
     {
         // The OpenGL handle to the program
@@ -228,11 +294,21 @@ private:
 
         // The uniform locations, indexed by shader parameter type
         std::vector<GLint> UniformLocations;
+
+        // The values of the float uniforms, indexed by shader parameter type; as uniforms
+        // are per-program state, setting one to the value it already has is free
+        std::vector<UniformValue> UniformValues;
     };
 
     // All programs, indexed by program type
     std::vector<ProgramInfo> mPrograms;
 
+    // The index of the program we've last activated
+    uint32_t mActiveProgramIndex;
+
+    // The index of the texture unit we've last activated
+    GLenum mActiveTextureUnit;
+
 private:
 
     friend class ShaderManagerTests_ProcessesIncludes_OneLevel_Test;
@@ -0,0 +1,256 @@
+/***************************************************************************************
+ * Original Author:		Gabriele Giuseppini
+ * Created:				2019-06-18
+ * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#include "BatchRunner.h"
+
+#include <GameCore/TaskThreadPool.h>
+#include <GameCore/Utils.h>
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+std::vector<std::filesystem::path> BatchRunner::FindInputFiles(std::string const & inputSpec)
+{
+    std::filesystem::path const inputPath(inputSpec);
+
+    std::filesystem::path directory;
+    std::string fileNamePattern;
+    if (std::filesystem::is_directory(inputPath))
+    {
+        directory = inputPath;
+        fileNamePattern = "*.png";
+    }
+    else
+    {
+        directory = inputPath.has_parent_path() ? inputPath.parent_path() : std::filesystem::path(".");
+        fileNamePattern = inputPath.filename().string();
+
+        if (!std::filesystem::is_directory(directory))
+        {
+            throw std::runtime_error("Directory '" + directory.string() + "' does not exist");
+        }
+    }
+
+    std::vector<std::filesystem::path> inputFiles;
+    for (auto const & entry : std::filesystem::directory_iterator(directory))
+    {
+        if (entry.is_regular_file()
+            && IsWildcardMatch(
+                Utils::ToLower(entry.path().filename().string()),
+                Utils::ToLower(fileNamePattern)))
+        {
+            inputFiles.push_back(entry.path());
+        }
+    }
+
+    // Make reports comparable across runs
+    std::sort(inputFiles.begin(), inputFiles.end());
+
+    return inputFiles;
+}
+
+size_t BatchRunner::Run(
+    std::vector<std::filesystem::path> const & inputFiles,
+    std::vector<Column> const & columns,
+    FileProcessor const & fileProcessor,
+    size_t parallelism,
+    std::optional<std::filesystem::path> const & reportFile)
+{
+    //
+    // Process all files, each on a task of its own; each task only writes its own result
+    //
+
+    std::vector<FileResult> results(inputFiles.size());
+
+    std::vector<TaskThreadPool::Task> tasks;
+    tasks.reserve(inputFiles.size());
+    for (size_t f = 0; f < inputFiles.size(); ++f)
+    {
+        tasks.emplace_back(
+            [&, f]()
+            {
+                FileResult & result = results[f];
+                result.InputFile = inputFiles[f];
+
+                try
+                {
+                    result.Values = fileProcessor(inputFiles[f]);
+                    assert(result.Values.size() == columns.size());
+                }
+                catch (std::exception const & ex)
+                {
+                    result.Values = std::vector<std::string>(columns.size());
+                    result.Error = ex.what();
+                }
+            });
+    }
+
+    TaskThreadPool threadPool(std::max(parallelism, size_t(1)));
+    threadPool.Run(tasks);
+
+    //
+    // Report
+    //
+
+    bool const isJson =
+        !!reportFile
+        && Utils::ToLower(reportFile->extension().string()) == ".json";
+
+    std::string const report = isJson
+        ? MakeJsonReport(columns, results)
+        : MakeCsvReport(columns, results);
+
+    if (!!reportFile)
+    {
+        std::ofstream reportStream(*reportFile, std::ios_base::out | std::ios_base::trunc);
+        if (!reportStream.is_open())
+        {
+            throw std::runtime_error("Cannot open report file '" + reportFile->string() + "'");
+        }
+
+        reportStream << report;
+    }
+    else
+    {
+        std::cout << report;
+    }
+
+    return static_cast<size_t>(std::count_if(
+        results.cbegin(),
+        results.cend(),
+        [](FileResult const & result)
+        {
+            return !!result.Error;
+        }));
+}
+
+bool BatchRunner::IsWildcardMatch(
+    std::string const & str,
+    std::string const & pattern)
+{
+    // Greedy matching with a single backtrack point at the last '*'
+    size_t s = 0;
+    size_t p = 0;
+    size_t starP = std::string::npos;
+    size_t starS = 0;
+    while (s < str.length())
+    {
+        if (p < pattern.length() && (pattern[p] == '?' || pattern[p] == str[s]))
+        {
+            ++s;
+            ++p;
+        }
+        else if (p < pattern.length() && pattern[p] == '*')
+        {
+            starP = p++;
+            starS = s;
+        }
+        else if (starP != std::string::npos)
+        {
+            p = starP + 1;
+            s = ++starS;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (p < pattern.length() && pattern[p] == '*')
+        ++p;
+
+    return p == pattern.length();
+}
+
+namespace /* anonymous */ {
+
+    std::string ToCsvField(std::string const & value)
+    {
+        if (value.find_first_of(",\"\n") == std::string::npos)
+            return value;
+
+        std::string field = "\"";
+        for (char c : value)
+        {
+            if (c == '"')
+                field += '"';
+            field += c;
+        }
+        field += '"';
+
+        return field;
+    }
+}
+
+std::string BatchRunner::MakeCsvReport(
+    std::vector<Column> const & columns,
+    std::vector<FileResult> const & results)
+{
+    std::stringstream ss;
+
+    ss << "file,status,error";
+    for (auto const & column : columns)
+        ss << "," << ToCsvField(column.Name);
+    ss << std::endl;
+
+    for (auto const & result : results)
+    {
+        ss << ToCsvField(result.InputFile.string())
+            << "," << (!!result.Error ? "error" : "ok")
+            << "," << ToCsvField(result.Error.value_or(""));
+
+        for (auto const & value : result.Values)
+            ss << "," << ToCsvField(value);
+
+        ss << std::endl;
+    }
+
+    return ss.str();
+}
+
+std::string BatchRunner::MakeJsonReport(
+    std::vector<Column> const & columns,
+    std::vector<FileResult> const & results)
+{
+    picojson::array files;
+    size_t failedCount = 0;
+
+    for (auto const & result : results)
+    {
+        picojson::object file;
+        file["file"] = picojson::value(result.InputFile.string());
+
+        if (!!result.Error)
+        {
+            file["status"] = picojson::value(std::string("error"));
+            file["error"] = picojson::value(*result.Error);
+            ++failedCount;
+        }
+        else
+        {
+            file["status"] = picojson::value(std::string("ok"));
+
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                file[columns[c].Name] = columns[c].IsNumeric
+                    ? picojson::value(std::stod(result.Values[c]))
+                    : picojson::value(result.Values[c]);
+            }
+        }
+
+        files.push_back(picojson::value(file));
+    }
+
+    picojson::object report;
+    report["file_count"] = picojson::value(static_cast<double>(results.size()));
+    report["failed_count"] = picojson::value(static_cast<double>(failedCount));
+    report["files"] = picojson::value(files);
+
+    return picojson::value(report).serialize(true);
+}
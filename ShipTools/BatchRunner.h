@@ -0,0 +1,86 @@
+/***************************************************************************************
+ * Original Author:		Gabriele Giuseppini
+ * Created:				2019-06-18
+ * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+/*
+ * Runs one of the tools on many files at once, in parallel, and aggregates the outcome
+ * of each file into a report.
+ *
+ * The report has one row per input file, with the file, whether it succeeded, the
+ * error if it didn't, and the tool's own columns. It's written as JSON when the report
+ * file has a .json extension, and as CSV otherwise - to the console when there's no
+ * report file.
+ */
+class BatchRunner
+{
+public:
+
+    struct Column
+    {
+        std::string Name;
+        bool IsNumeric;
+
+        Column(
+            std::string name,
+            bool isNumeric)
+            : Name(std::move(name))
+            , IsNumeric(isNumeric)
+        {}
+    };
+
+    // Processes one file, returning the values of the tool's columns; throws on failure.
+    // Invoked concurrently, hence must not touch shared state other than what's read-only.
+    using FileProcessor = std::function<std::vector<std::string>(std::filesystem::path const & inputFile)>;
+
+    /*
+     * The input files named by the specified directory - all of its .png files - or by
+     * the specified file path whose file name may contain the * and ? wildcards; sorted.
+     */
+    static std::vector<std::filesystem::path> FindInputFiles(std::string const & inputSpec);
+
+    /*
+     * Returns the number of files that failed.
+     */
+    static size_t Run(
+        std::vector<std::filesystem::path> const & inputFiles,
+        std::vector<Column> const & columns,
+        FileProcessor const & fileProcessor,
+        size_t parallelism,
+        std::optional<std::filesystem::path> const & reportFile);
+
+private:
+
+    struct FileResult
+    {
+        std::filesystem::path InputFile;
+        std::vector<std::string> Values;
+        std::optional<std::string> Error;
+
+        FileResult()
+            : InputFile()
+            , Values()
+            , Error()
+        {}
+    };
+
+    static bool IsWildcardMatch(
+        std::string const & str,
+        std::string const & pattern);
+
+    static std::string MakeCsvReport(
+        std::vector<Column> const & columns,
+        std::vector<FileResult> const & results);
+
+    static std::string MakeJsonReport(
+        std::vector<Column> const & columns,
+        std::vector<FileResult> const & results);
+};
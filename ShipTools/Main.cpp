@@ -4,25 +4,42 @@
  * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
  ***************************************************************************************/
 
+#include "BatchRunner.h"
 #include "Quantizer.h"
 #include "Resizer.h"
 #include "ShipAnalyzer.h"
 
+#include <Game/ResourceLoader.h>
+#include <Game/TextureAtlas.h>
+#include <Game/TextureDatabase.h>
+
+#include <GameCore/ResourceArchive.h>
 #include <GameCore/Utils.h>
 
 #include <IL/il.h>
 #include <IL/ilu.h>
 
+#include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 #define SEPARATOR "------------------------------------------------------"
 
 int DoQuantize(int argc, char ** argv);
 int DoResize(int argc, char ** argv);
 int DoAnalyzeShip(int argc, char ** argv);
+int DoEstimateShipCost(int argc, char ** argv);
+int DoBakeAtlas(int argc, char ** argv);
+int DoAtlasStats(int argc, char ** argv);
+int DoPackResources(int argc, char ** argv);
+int DoBatchQuantize(int argc, char ** argv);
+int DoBatchResize(int argc, char ** argv);
+int DoBatchAnalyzeShip(int argc, char ** argv);
 
 void PrintUsage();
 
@@ -53,6 +70,34 @@ int main(int argc, char ** argv)
         {
             return DoAnalyzeShip(argc, argv);
         }
+        else if (verb == "estimate_cost")
+        {
+            return DoEstimateShipCost(argc, argv);
+        }
+        else if (verb == "bake_atlas")
+        {
+            return DoBakeAtlas(argc, argv);
+        }
+        else if (verb == "atlas_stats")
+        {
+            return DoAtlasStats(argc, argv);
+        }
+        else if (verb == "pack_resources")
+        {
+            return DoPackResources(argc, argv);
+        }
+        else if (verb == "batch_quantize")
+        {
+            return DoBatchQuantize(argc, argv);
+        }
+        else if (verb == "batch_resize")
+        {
+            return DoBatchResize(argc, argv);
+        }
+        else if (verb == "batch_analyze")
+        {
+            return DoBatchAnalyzeShip(argc, argv);
+        }
         else
         {
             throw std::runtime_error("Unrecognized verb '" + verb + "'");
@@ -144,13 +189,28 @@ int DoResize(int argc, char ** argv)
     std::string outputFile(argv[3]);
     int width = std::stoi(argv[4]);
 
+    Resizer::ResizeMode mode = Resizer::ResizeMode::Structure;
+    for (int i = 5; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "-t" || option == "--texture")
+        {
+            mode = Resizer::ResizeMode::Texture;
+        }
+        else
+        {
+            throw std::runtime_error("Unrecognized option '" + option + "'");
+        }
+    }
+
     std::cout << SEPARATOR << std::endl;
     std::cout << "Running resize:" << std::endl;
     std::cout << "  input file : " << inputFile << std::endl;
     std::cout << "  output file: " << outputFile << std::endl;
     std::cout << "  width      : " << width << std::endl;
+    std::cout << "  mode       : " << (mode == Resizer::ResizeMode::Texture ? "texture" : "structure") << std::endl;
 
-    Resizer::Resize(inputFile, outputFile, width);
+    Resizer::Resize(inputFile, outputFile, width, mode);
 
     std::cout << "Resize completed." << std::endl;
 
@@ -180,12 +240,472 @@ int DoAnalyzeShip(int argc, char ** argv)
     return 0;
 }
 
+int DoEstimateShipCost(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    std::filesystem::path inputFile(argv[2]);
+
+    size_t stepCount = 300;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "-s" || option == "--steps")
+        {
+            ++i;
+            if (i == argc)
+            {
+                throw std::runtime_error("-s option specified without a number of steps");
+            }
+
+            int const steps = std::stoi(argv[i]);
+            if (steps < 1)
+            {
+                throw std::runtime_error("The number of steps must be at least 1");
+            }
+
+            stepCount = static_cast<size_t>(steps);
+        }
+        else
+        {
+            throw std::runtime_error("Unrecognized option '" + option + "'");
+        }
+    }
+
+    ResourceLoader resourceLoader;
+
+    std::cout << SEPARATOR << std::endl;
+    std::cout << "Running estimate_cost:" << std::endl;
+    std::cout << "  input file : " << inputFile.string() << std::endl;
+    std::cout << "  steps      : " << stepCount << std::endl;
+
+    auto const costInfo = ShipAnalyzer::EstimateCost(inputFile, resourceLoader, stepCount);
+
+    std::cout << std::fixed;
+
+    std::cout << "  Points              : " << costInfo.PointCount << std::endl;
+    std::cout << "  Springs             : " << costInfo.SpringCount << std::endl;
+    std::cout << "  Triangles           : " << costInfo.TriangleCount << std::endl;
+    std::cout << "  Electrical elements : " << costInfo.ElectricalElementCount << std::endl;
+    std::cout << "  Spring ACMR         : " << costInfo.SpringACMR << std::endl;
+    std::cout << "  Step cost (avg)     : " << costInfo.AverageMillisPerStep << "ms" << std::endl;
+    std::cout << "  Step cost (max)     : " << costInfo.MaxMillisPerStep << "ms" << std::endl;
+    std::cout << "  Memory              : " << costInfo.Memory.GetTotalByteSize() << " bytes" << std::endl;
+
+    // Largest buffers first
+    auto memoryEntries = costInfo.Memory.GetEntries();
+    std::stable_sort(
+        memoryEntries.begin(),
+        memoryEntries.end(),
+        [](auto const & lhs, auto const & rhs)
+        {
+            return lhs.ByteSize > rhs.ByteSize;
+        });
+
+    for (auto const & entry : memoryEntries)
+    {
+        std::cout << "    " << entry.Path << ": " << entry.ByteSize << std::endl;
+    }
+
+    return 0;
+}
+
+int DoBakeAtlas(int argc, char ** argv)
+{
+    ResourceLoader resourceLoader;
+
+    std::string outputFile = (argc >= 3)
+        ? std::string(argv[2])
+        : resourceLoader.GetBakedGenericTextureAtlasFilePath().string();
+
+    std::cout << SEPARATOR << std::endl;
+    std::cout << "Running bake_atlas:" << std::endl;
+    std::cout << "  textures dir: " << resourceLoader.GetTexturesFilePath().string() << std::endl;
+    std::cout << "  output file : " << outputFile << std::endl;
+
+    auto const textureDatabase = Render::TextureDatabase::Load(
+        resourceLoader,
+        [](float, std::string const &) {});
+
+    auto const atlas = Render::TextureAtlasBuilder::BuildGenericTextureAtlas(
+        textureDatabase,
+        Render::TextureAtlasBuilder::AtlasOptions(),
+        [](float, std::string const &) {});
+
+    atlas.Serialize(outputFile);
+
+    std::cout << "  atlas size  : " << atlas.AtlasData.Size.Width << "x" << atlas.AtlasData.Size.Height << std::endl;
+    std::cout << "  frames      : " << atlas.Metadata.GetFrameMetadata().size() << std::endl;
+    std::cout << "  fill ratio  : " << atlas.CalculateFillRatio() << std::endl;
+
+    std::cout << "Bake completed." << std::endl;
+
+    return 0;
+}
+
+int DoAtlasStats(int argc, char ** argv)
+{
+    int framePadding = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "-p" || option == "--padding")
+        {
+            ++i;
+            if (i == argc)
+            {
+                throw std::runtime_error("-p option specified without a number of pixels");
+            }
+
+            framePadding = std::stoi(argv[i]);
+            if (framePadding < 0)
+            {
+                throw std::runtime_error("The padding must not be negative");
+            }
+        }
+        else
+        {
+            throw std::runtime_error("Unrecognized option '" + option + "'");
+        }
+    }
+
+    ResourceLoader resourceLoader;
+
+    std::cout << SEPARATOR << std::endl;
+    std::cout << "Running atlas_stats:" << std::endl;
+    std::cout << "  textures dir: " << resourceLoader.GetTexturesFilePath().string() << std::endl;
+    std::cout << "  padding     : " << framePadding << std::endl;
+
+    auto const textureDatabase = Render::TextureDatabase::Load(
+        resourceLoader,
+        [](float, std::string const &) {});
+
+    for (bool isPowerOfTwoSize : { true, false })
+    {
+        auto const atlas = Render::TextureAtlasBuilder::BuildGenericTextureAtlas(
+            textureDatabase,
+            Render::TextureAtlasBuilder::AtlasOptions(isPowerOfTwoSize, framePadding),
+            [](float, std::string const &) {});
+
+        std::cout << (isPowerOfTwoSize ? "  power-of-two    : " : "  non-power-of-two: ")
+            << atlas.AtlasData.Size.Width << "x" << atlas.AtlasData.Size.Height
+            << ", fill ratio " << atlas.CalculateFillRatio() << std::endl;
+    }
+
+    return 0;
+}
+
+int DoPackResources(int argc, char ** argv)
+{
+    std::filesystem::path const dataDirectory = ResourceLoader::GetDataRootPath();
+
+    std::filesystem::path const outputFile = (argc >= 3)
+        ? std::filesystem::path(argv[2])
+        : ResourceLoader::GetResourceArchiveFilePath();
+
+    std::cout << SEPARATOR << std::endl;
+    std::cout << "Running pack_resources:" << std::endl;
+    std::cout << "  data dir   : " << dataDirectory.string() << std::endl;
+    std::cout << "  output file: " << outputFile.string() << std::endl;
+
+    size_t const fileCount = ResourceArchive::Build(dataDirectory, outputFile);
+
+    std::cout << "  files      : " << fileCount << std::endl;
+    std::cout << "  size       : " << std::filesystem::file_size(outputFile) << " bytes" << std::endl;
+
+    std::cout << "Pack completed." << std::endl;
+
+    return 0;
+}
+
+struct BatchOptions
+{
+    std::optional<std::filesystem::path> ReportFile;
+    size_t Parallelism;
+
+    BatchOptions()
+        : ReportFile()
+        , Parallelism(std::max(std::thread::hardware_concurrency(), 1u))
+    {}
+
+    // Returns true if the option at i is a batch option, which is then consumed
+    bool TryParse(
+        int & i,
+        int argc,
+        char ** argv)
+    {
+        std::string option(argv[i]);
+        if (option == "-o" || option == "--report")
+        {
+            ++i;
+            if (i == argc)
+            {
+                throw std::runtime_error("-o option specified without a report file");
+            }
+
+            ReportFile = std::filesystem::path(argv[i]);
+            return true;
+        }
+        else if (option == "-j" || option == "--threads")
+        {
+            ++i;
+            if (i == argc)
+            {
+                throw std::runtime_error("-j option specified without a number of threads");
+            }
+
+            int const parallelism = std::stoi(argv[i]);
+            if (parallelism < 1)
+            {
+                throw std::runtime_error("The number of threads must be at least 1");
+            }
+
+            Parallelism = static_cast<size_t>(parallelism);
+            return true;
+        }
+
+        return false;
+    }
+
+    void Print(size_t fileCount) const
+    {
+        std::cout << "  files         : " << fileCount << std::endl;
+        std::cout << "  threads       : " << Parallelism << std::endl;
+        std::cout << "  report file   : " << (!!ReportFile ? ReportFile->string() : "<console>") << std::endl;
+    }
+};
+
+int CompleteBatch(
+    size_t fileCount,
+    size_t failedFileCount)
+{
+    std::cout << "Batch completed: " << (fileCount - failedFileCount) << " of " << fileCount << " files succeeded." << std::endl;
+
+    return failedFileCount == 0 ? 0 : -1;
+}
+
+std::filesystem::path MakeBatchOutputFile(
+    std::filesystem::path const & inputFile,
+    std::filesystem::path const & outputDirectory)
+{
+    return outputDirectory / inputFile.filename().replace_extension(".png");
+}
+
+int DoBatchQuantize(int argc, char ** argv)
+{
+    if (argc < 5)
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    std::string materialsDirectory(argv[2]);
+    std::string inputSpec(argv[3]);
+    std::filesystem::path outputDirectory(argv[4]);
+
+    bool doKeepRopes = false;
+    bool doKeepGlass = false;
+    std::optional<rgbColor> targetFixedColor;
+    BatchOptions batchOptions;
+    for (int i = 5; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "-r" || option == "--keep_ropes")
+        {
+            doKeepRopes = true;
+        }
+        else if (option == "-g" || option == "--keep_glass")
+        {
+            doKeepGlass = true;
+        }
+        else if (option == "-c")
+        {
+            ++i;
+            if (i == argc)
+            {
+                throw std::runtime_error("-c option specified without a color");
+            }
+
+            targetFixedColor = Utils::Hex2RgbColor(argv[i]);
+        }
+        else if (!batchOptions.TryParse(i, argc, argv))
+        {
+            throw std::runtime_error("Unrecognized option '" + option + "'");
+        }
+    }
+
+    auto const inputFiles = BatchRunner::FindInputFiles(inputSpec);
+
+    std::filesystem::create_directories(outputDirectory);
+
+    std::cout << SEPARATOR << std::endl;
+    std::cout << "Running batch_quantize:" << std::endl;
+    std::cout << "  input         : " << inputSpec << std::endl;
+    std::cout << "  output dir    : " << outputDirectory.string() << std::endl;
+    std::cout << "  materials dir : " << materialsDirectory << std::endl;
+    batchOptions.Print(inputFiles.size());
+
+    // Loaded once for all files
+    auto const materials = MaterialDatabase::Load(materialsDirectory);
+
+    size_t const failedFileCount = BatchRunner::Run(
+        inputFiles,
+        { { "output_file", false } },
+        [&](std::filesystem::path const & inputFile)
+        {
+            auto const outputFile = MakeBatchOutputFile(inputFile, outputDirectory);
+
+            Quantizer::Quantize(
+                inputFile.string(),
+                outputFile.string(),
+                materials,
+                doKeepRopes,
+                doKeepGlass,
+                targetFixedColor);
+
+            return std::vector<std::string>{ outputFile.string() };
+        },
+        batchOptions.Parallelism,
+        batchOptions.ReportFile);
+
+    return CompleteBatch(inputFiles.size(), failedFileCount);
+}
+
+int DoBatchResize(int argc, char ** argv)
+{
+    if (argc < 5)
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    std::string inputSpec(argv[2]);
+    std::filesystem::path outputDirectory(argv[3]);
+    int width = std::stoi(argv[4]);
+
+    Resizer::ResizeMode mode = Resizer::ResizeMode::Structure;
+
+    BatchOptions batchOptions;
+    for (int i = 5; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "-t" || option == "--texture")
+        {
+            mode = Resizer::ResizeMode::Texture;
+        }
+        else if (!batchOptions.TryParse(i, argc, argv))
+        {
+            throw std::runtime_error("Unrecognized option '" + option + "'");
+        }
+    }
+
+    auto const inputFiles = BatchRunner::FindInputFiles(inputSpec);
+
+    std::filesystem::create_directories(outputDirectory);
+
+    std::cout << SEPARATOR << std::endl;
+    std::cout << "Running batch_resize:" << std::endl;
+    std::cout << "  input         : " << inputSpec << std::endl;
+    std::cout << "  output dir    : " << outputDirectory.string() << std::endl;
+    std::cout << "  width         : " << width << std::endl;
+    std::cout << "  mode          : " << (mode == Resizer::ResizeMode::Texture ? "texture" : "structure") << std::endl;
+    batchOptions.Print(inputFiles.size());
+
+    size_t const failedFileCount = BatchRunner::Run(
+        inputFiles,
+        { { "output_file", false } },
+        [&](std::filesystem::path const & inputFile)
+        {
+            auto const outputFile = MakeBatchOutputFile(inputFile, outputDirectory);
+
+            Resizer::Resize(inputFile.string(), outputFile.string(), width, mode);
+
+            return std::vector<std::string>{ outputFile.string() };
+        },
+        batchOptions.Parallelism,
+        batchOptions.ReportFile);
+
+    return CompleteBatch(inputFiles.size(), failedFileCount);
+}
+
+int DoBatchAnalyzeShip(int argc, char ** argv)
+{
+    if (argc < 4)
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    std::string materialsDirectory(argv[2]);
+    std::string inputSpec(argv[3]);
+
+    BatchOptions batchOptions;
+    for (int i = 4; i < argc; ++i)
+    {
+        if (!batchOptions.TryParse(i, argc, argv))
+        {
+            throw std::runtime_error("Unrecognized option '" + std::string(argv[i]) + "'");
+        }
+    }
+
+    auto const inputFiles = BatchRunner::FindInputFiles(inputSpec);
+
+    std::cout << SEPARATOR << std::endl;
+    std::cout << "Running batch_analyze:" << std::endl;
+    std::cout << "  input         : " << inputSpec << std::endl;
+    std::cout << "  materials dir : " << materialsDirectory << std::endl;
+    batchOptions.Print(inputFiles.size());
+
+    // Loaded once for all files
+    auto const materials = MaterialDatabase::Load(materialsDirectory);
+
+    size_t const failedFileCount = BatchRunner::Run(
+        inputFiles,
+        {
+            { "total_mass", true },
+            { "mass_per_point", true },
+            { "buoyant_mass_per_point", true },
+            { "center_of_mass_x", true },
+            { "center_of_mass_y", true }
+        },
+        [&](std::filesystem::path const & inputFile)
+        {
+            auto const analysisInfo = ShipAnalyzer::Analyze(inputFile.string(), materials);
+
+            return std::vector<std::string>{
+                std::to_string(analysisInfo.TotalMass),
+                std::to_string(analysisInfo.MassPerPoint),
+                std::to_string(analysisInfo.BuoyantMassPerPoint),
+                std::to_string(analysisInfo.BaricentricX),
+                std::to_string(analysisInfo.BaricentricY) };
+        },
+        batchOptions.Parallelism,
+        batchOptions.ReportFile);
+
+    return CompleteBatch(inputFiles.size(), failedFileCount);
+}
+
 void PrintUsage()
 {
     std::cout << std::endl;
     std::cout << "Usage:" << std::endl;
     std::cout << " quantize <materials_dir> <in_file> <out_png> [-c <target_fixed_color>]" << std::endl;
     std::cout << "          -r, --keep_ropes] [-g, --keep_glass]" << std::endl;
-    std::cout << " resize <in_file> <out_png> <width>" << std::endl;
+    std::cout << " resize <in_file> <out_png> <width> [-t, --texture]" << std::endl;
     std::cout << " analyze <materials_dir> <in_file>" << std::endl;
+    std::cout << " estimate_cost <in_file> [-s, --steps <count>]" << std::endl;
+    std::cout << " bake_atlas [<out_file>]" << std::endl;
+    std::cout << " atlas_stats [-p, --padding <pixels>]" << std::endl;
+    std::cout << " pack_resources [<out_file>]" << std::endl;
+    std::cout << " batch_quantize <materials_dir> <in_dir_or_glob> <out_dir> [-c <target_fixed_color>]" << std::endl;
+    std::cout << "          [-r, --keep_ropes] [-g, --keep_glass] <batch_options>" << std::endl;
+    std::cout << " batch_resize <in_dir_or_glob> <out_dir> <width> [-t, --texture] <batch_options>" << std::endl;
+    std::cout << " batch_analyze <materials_dir> <in_dir_or_glob> <batch_options>" << std::endl;
+    std::cout << std::endl;
+    std::cout << " batch_options: [-o, --report <report.csv|report.json>] [-j, --threads <count>]" << std::endl;
+    std::cout << " in_dir_or_glob: a directory - for all of its .png files - or a path whose file name has * or ? wildcards" << std::endl;
 }
\ No newline at end of file
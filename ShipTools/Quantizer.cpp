@@ -5,14 +5,10 @@
  ***************************************************************************************/
 #include "Quantizer.h"
 
-#include <Game/MaterialDatabase.h>
+#include <Game/ImageFileTools.h>
 
-#include <GameCore/Vectors.h>
+#include <GameCore/NearestColorLookup.h>
 
-#include <IL/il.h>
-#include <IL/ilu.h>
-
-#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -24,125 +20,89 @@ void Quantizer::Quantize(
     bool doKeepGlass,
     std::optional<rgbColor> targetFixedColor)
 {
-    //
-    // Load image
-    //
+    auto const materials = MaterialDatabase::Load(materialsDir);
 
-    ILuint image;
-    ilGenImages(1, &image);
-    ilBindImage(image);
-
-    if (!ilLoadImage(inputFile.c_str()))
-    {
-        ILint devilError = ilGetError();
-        std::string devilErrorMessage(iluErrorString(devilError));
-        throw std::runtime_error("Could not load image '" + inputFile + "': " + devilErrorMessage);
-    }
+    Quantize(
+        inputFile,
+        outputFile,
+        materials,
+        doKeepRopes,
+        doKeepGlass,
+        targetFixedColor);
+}
 
-    // Convert format
-    if (ilGetInteger(IL_IMAGE_FORMAT) != IL_RGBA
-        || ilGetInteger(IL_IMAGE_TYPE) != IL_UNSIGNED_BYTE)
-    {
-        if (!ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE))
-        {
-            ILint devilError = ilGetError();
-            std::string devilErrorMessage(iluErrorString(devilError));
-            throw std::runtime_error("Could not convert image '" + inputFile + "': " + devilErrorMessage);
-        }
-    }
+void Quantizer::Quantize(
+    std::string const & inputFile,
+    std::string const & outputFile,
+    MaterialDatabase const & materials,
+    bool doKeepRopes,
+    bool doKeepGlass,
+    std::optional<rgbColor> targetFixedColor)
+{
+    //
+    // Load image; we only ever touch DevIL through the image file tools,
+    // which serialize its calls for concurrent quantizations
+    //
 
-    ILubyte * imageData = ilGetData();
-    int const width = ilGetInteger(IL_IMAGE_WIDTH);
-    int const height = ilGetInteger(IL_IMAGE_HEIGHT);
+    auto image = ImageFileTools::LoadImageRgbaLowerLeft(std::filesystem::path(inputFile));
 
     //
     // Create set of colors to quantize to
     //
 
-    auto materials = MaterialDatabase::Load(materialsDir);
-
-    std::vector<std::pair<vec3f, rgbColor>> gameColors;
+    std::vector<std::pair<rgbColor, rgbColor>> gameColors;
 
     for (auto const & entry : materials.GetStructuralMaterials())
     {
         if ( (!entry.second.IsUniqueType(StructuralMaterial::MaterialUniqueType::Rope) || doKeepRopes)
             && (entry.second.Name != "Glass" || doKeepGlass))
         {
-            gameColors.emplace_back(
-                std::make_pair(
-                    entry.first.toVec3f(),
-                    entry.first));
+            gameColors.emplace_back(entry.first, entry.first);
         }
     }
 
     // Add pure white
     static rgbColor PureWhite = { 255, 255, 255 };
-    gameColors.emplace_back(
-        std::make_pair(
-            vec3f(1.0f, 1.0f, 1.0f),
-            PureWhite));
+    gameColors.emplace_back(PureWhite, PureWhite);
+
+    // Spares us from scanning all the colors for each pixel
+    NearestColorLookup<rgbColor> const gameColorLookup(gameColors);
 
 
     //
     // Quantize image
     //
 
-    for (int r = 0; r < height; ++r)
-    {
-        size_t index = r * width * 4;
+    size_t const pixelCount = static_cast<size_t>(image.Size.Width) * static_cast<size_t>(image.Size.Height);
 
-        for (int c = 0; c < width; ++c, index += 4)
-        {
-            vec3f imgColor = vec3f(
-                static_cast<float>(imageData[index]) / 255.0f,
-                static_cast<float>(imageData[index + 1]) / 255.0f,
-                static_cast<float>(imageData[index + 2]) / 255.0f);
+    for (size_t index = 0; index < pixelCount; ++index)
+    {
+        rgbaColor & pixel = image.Data[index];
 
-            std::optional<rgbColor> bestColor;
+        std::optional<rgbColor> bestColor;
 
-            if (!targetFixedColor)
-            {
-                // Find closest color
-                std::optional<size_t> bestGameColorIndex;
-                float bestColorSquareDistance = std::numeric_limits<float>::max();
-                for (size_t gameColor = 0; gameColor < gameColors.size(); ++gameColor)
-                {
-                    float colorSquareDistance = (imgColor - gameColors[gameColor].first).squareLength();
-                    if (colorSquareDistance < bestColorSquareDistance)
-                    {
-                        bestGameColorIndex = gameColor;
-                        bestColorSquareDistance = colorSquareDistance;
-                    }
-                }
-
-                // Store color
-                assert(!!bestGameColorIndex);
-                bestColor = gameColors[*bestGameColorIndex].second;
-            }
-            else
+        if (!targetFixedColor)
+        {
+            // Find closest color
+            bestColor = gameColorLookup.Find(rgbColor(pixel.r, pixel.g, pixel.b));
+        }
+        else
+        {
+            // Assign a color only if not transparent
+            if (pixel.a != 0)
             {
-                // Assign a color only if not transparent
-                if (imageData[index + 3] != 0)
-                {
-                    bestColor = *targetFixedColor;
-                }
+                bestColor = *targetFixedColor;
             }
+        }
 
-            if (!!bestColor)
-            {
-                imageData[index] = bestColor->r;
-                imageData[index + 1] = bestColor->g;
-                imageData[index + 2] = bestColor->b;
-                imageData[index + 3] = 255;
-            }
-            else
-            {
-                // Full white
-                imageData[index] = PureWhite.r;
-                imageData[index + 1] = PureWhite.g;
-                imageData[index + 2] = PureWhite.b;
-                imageData[index + 3] = 255;
-            }
+        if (!!bestColor)
+        {
+            pixel = rgbaColor(bestColor->r, bestColor->g, bestColor->b, 255);
+        }
+        else
+        {
+            // Full white
+            pixel = rgbaColor(PureWhite.r, PureWhite.g, PureWhite.b, 255);
         }
     }
 
@@ -151,11 +111,5 @@ void Quantizer::Quantize(
     // Save image
     //
 
-    ilEnable(IL_FILE_OVERWRITE);
-    if (!ilSave(IL_PNG, outputFile.c_str()))
-    {
-        ILint devilError = ilGetError();
-        std::string devilErrorMessage(iluErrorString(devilError));
-        throw std::runtime_error("Could not save image '" + outputFile + "': " + devilErrorMessage);
-    }
+    ImageFileTools::SaveImage(std::filesystem::path(outputFile), image);
 }
\ No newline at end of file
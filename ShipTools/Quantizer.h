@@ -4,6 +4,8 @@
  * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
  ***************************************************************************************/
 
+#include <Game/MaterialDatabase.h>
+
 #include <GameCore/Colors.h>
 
 #include <optional>
@@ -20,4 +22,16 @@ public:
         bool doKeepRopes,
         bool doKeepGlass,
         std::optional<rgbColor> targetFixedColor);
+
+    /*
+     * As above, with materials that have been loaded already; may be invoked
+     * concurrently.
+     */
+    static void Quantize(
+        std::string const & inputFile,
+        std::string const & outputFile,
+        MaterialDatabase const & materials,
+        bool doKeepRopes,
+        bool doKeepGlass,
+        std::optional<rgbColor> targetFixedColor);
 };
@@ -5,10 +5,306 @@
 ***************************************************************************************/
 #include "Resizer.h"
 
+#include <Game/ImageFileTools.h>
+
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/TaskThreadPool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+namespace /* anonymous */ {
+
+// The number of output rows in each band
+static constexpr size_t BandRowCount = 16;
+
+/*
+ * The pixels of the original image covered by each pixel of the resized image,
+ * along one of the axes.
+ */
+struct Footprint
+{
+    int Start;
+    int End; // Excluded
+};
+
+std::vector<Footprint> MakeFootprints(
+    int size,
+    int newSize)
+{
+    std::vector<Footprint> footprints;
+    footprints.reserve(newSize);
+
+    double const scale = static_cast<double>(size) / static_cast<double>(newSize);
+
+    for (int i = 0; i < newSize; ++i)
+    {
+        int const start = std::min(static_cast<int>(std::floor(i * scale)), size - 1);
+        int const end = std::clamp(static_cast<int>(std::ceil((i + 1) * scale)), start + 1, size);
+        footprints.push_back({ start, end });
+    }
+
+    return footprints;
+}
+
+/*
+ * The weights of the pixels of each footprint - the fraction of the footprint
+ * covered by each pixel - one footprint after the other.
+ */
+std::vector<float> MakeFootprintWeights(
+    std::vector<Footprint> const & footprints,
+    int size,
+    int newSize)
+{
+    std::vector<float> weights;
+
+    double const scale = static_cast<double>(size) / static_cast<double>(newSize);
+
+    for (size_t i = 0; i < footprints.size(); ++i)
+    {
+        double const start = i * scale;
+        double const end = (i + 1) * scale;
+
+        for (int p = footprints[i].Start; p < footprints[i].End; ++p)
+        {
+            double const coverage = std::min(end, static_cast<double>(p + 1)) - std::max(start, static_cast<double>(p));
+            weights.push_back(static_cast<float>(std::max(coverage, 0.0) / scale));
+        }
+    }
+
+    return weights;
+}
+
+bool IsEmptyStructure(rgbaColor const & color)
+{
+    return color.a == 0
+        || (color.r == 255 && color.g == 255 && color.b == 255);
+}
+
+ImageSize CalculateNewSize(
+    ImageSize const & size,
+    int width)
+{
+    if (width <= 0)
+    {
+        throw std::runtime_error("The width must be positive");
+    }
+
+    int const height = std::max(
+        static_cast<int>(std::lround(static_cast<double>(size.Height) * width / size.Width)),
+        1);
+
+    return ImageSize(width, height);
+}
+
+}
+
 void Resizer::Resize(
     std::string const & inputFile,
     std::string const & outputFile,
-    int width)
+    int width,
+    ResizeMode mode)
+{
+    // The image file tools serialize their DevIL calls, hence we may be invoked concurrently
+    auto const image = ImageFileTools::LoadImageRgbaLowerLeft(std::filesystem::path(inputFile));
+
+    ImageSize const newSize = CalculateNewSize(image.Size, width);
+
+    auto const resizedImage = (mode == ResizeMode::Structure)
+        ? ResizeStructure(image, newSize)
+        : ResizeTexture(image, newSize);
+
+    ImageFileTools::SaveImage(
+        std::filesystem::path(outputFile),
+        resizedImage);
+}
+
+RgbaImageData Resizer::ResizeStructure(
+    RgbaImageData const & image,
+    ImageSize const & newSize)
 {
+    auto const xFootprints = MakeFootprints(image.Size.Width, newSize.Width);
+    auto const yFootprints = MakeFootprints(image.Size.Height, newSize.Height);
+
+    auto newData = std::make_unique<rgbaColor[]>(static_cast<size_t>(newSize.Width) * static_cast<size_t>(newSize.Height));
+
+    TaskThreadPool::GetInstance().ParallelFor(
+        0,
+        static_cast<size_t>(newSize.Height),
+        BandRowCount,
+        [&](size_t startY, size_t endY)
+        {
+            struct ColorCount
+            {
+                rgbaColor Color;
+                int Count;
+            };
+
+            std::vector<ColorCount> structureColorCounts;
+            std::vector<ColorCount> emptyColorCounts;
+
+            auto const count = [](std::vector<ColorCount> & colorCounts, rgbaColor const & color)
+            {
+                // Footprints only have a handful of colors
+                auto it = std::find_if(
+                    colorCounts.begin(),
+                    colorCounts.end(),
+                    [&color](ColorCount const & cc)
+                    {
+                        return cc.Color == color;
+                    });
+
+                if (it != colorCounts.end())
+                    ++(it->Count);
+                else
+                    colorCounts.push_back({ color, 1 });
+            };
+
+            auto const findMostFrequent = [](std::vector<ColorCount> const & colorCounts)
+            {
+                // Ties go to the first color found, i.e. the lowest and leftmost
+                assert(!colorCounts.empty());
+                return std::max_element(
+                    colorCounts.begin(),
+                    colorCounts.end(),
+                    [](ColorCount const & cc1, ColorCount const & cc2)
+                    {
+                        return cc1.Count < cc2.Count;
+                    })->Color;
+            };
+
+            for (size_t y = startY; y < endY; ++y)
+            {
+                Footprint const & yFootprint = yFootprints[y];
+
+                for (int x = 0; x < newSize.Width; ++x)
+                {
+                    Footprint const & xFootprint = xFootprints[x];
+
+                    structureColorCounts.clear();
+                    emptyColorCounts.clear();
+
+                    for (int sy = yFootprint.Start; sy < yFootprint.End; ++sy)
+                    {
+                        rgbaColor const * const row = image.Data.get() + static_cast<size_t>(sy) * image.Size.Width;
+
+                        for (int sx = xFootprint.Start; sx < xFootprint.End; ++sx)
+                        {
+                            count(IsEmptyStructure(row[sx]) ? emptyColorCounts : structureColorCounts, row[sx]);
+                        }
+                    }
+
+                    int structureCount = 0;
+                    for (auto const & cc : structureColorCounts)
+                        structureCount += cc.Count;
+
+                    int const footprintCount = (yFootprint.End - yFootprint.Start) * (xFootprint.End - xFootprint.Start);
+
+                    // Thin structures - e.g. a one-pixel hull - must survive shrinking
+                    newData[y * newSize.Width + x] = (structureCount * 4 >= footprintCount)
+                        ? findMostFrequent(structureColorCounts)
+                        : findMostFrequent(emptyColorCounts);
+                }
+            }
+        });
+
+    return RgbaImageData(newSize, std::move(newData));
+}
+
+RgbaImageData Resizer::ResizeTexture(
+    RgbaImageData const & image,
+    ImageSize const & newSize)
+{
+    auto const xFootprints = MakeFootprints(image.Size.Width, newSize.Width);
+    auto const xWeights = MakeFootprintWeights(xFootprints, image.Size.Width, newSize.Width);
+    auto const yFootprints = MakeFootprints(image.Size.Height, newSize.Height);
+    auto const yWeights = MakeFootprintWeights(yFootprints, image.Size.Height, newSize.Height);
+
+    std::vector<size_t> yWeightOffsets;
+    yWeightOffsets.reserve(yFootprints.size());
+    size_t yWeightOffset = 0;
+    for (auto const & yFootprint : yFootprints)
+    {
+        yWeightOffsets.push_back(yWeightOffset);
+        yWeightOffset += yFootprint.End - yFootprint.Start;
+    }
+
+    auto newData = std::make_unique<rgbaColor[]>(static_cast<size_t>(newSize.Width) * static_cast<size_t>(newSize.Height));
+
+    TaskThreadPool::GetInstance().ParallelFor(
+        0,
+        static_cast<size_t>(newSize.Height),
+        BandRowCount,
+        [&](size_t startY, size_t endY)
+        {
+            // One row of alpha-premultiplied channels, filtered vertically
+            std::vector<float> columnSums(static_cast<size_t>(image.Size.Width) * 4);
+
+            for (size_t y = startY; y < endY; ++y)
+            {
+                //
+                // 1. Filter vertically, into a row as wide as the original image; the loops
+                //    run over contiguous floats, so that they are vectorized
+                //
+
+                std::fill(columnSums.begin(), columnSums.end(), 0.0f);
+
+                float * const restrict sums = columnSums.data();
+
+                Footprint const & yFootprint = yFootprints[y];
+                for (int sy = yFootprint.Start; sy < yFootprint.End; ++sy)
+                {
+                    float const weight = yWeights[yWeightOffsets[y] + (sy - yFootprint.Start)];
+
+                    unsigned char const * const restrict row = reinterpret_cast<unsigned char const *>(
+                        image.Data.get() + static_cast<size_t>(sy) * image.Size.Width);
+
+                    size_t const channelCount = static_cast<size_t>(image.Size.Width) * 4;
+                    for (size_t c = 0; c < channelCount; c += 4)
+                    {
+                        float const alphaWeight = static_cast<float>(row[c + 3]) * weight;
+
+                        sums[c + 0] += static_cast<float>(row[c + 0]) * alphaWeight;
+                        sums[c + 1] += static_cast<float>(row[c + 1]) * alphaWeight;
+                        sums[c + 2] += static_cast<float>(row[c + 2]) * alphaWeight;
+                        sums[c + 3] += alphaWeight;
+                    }
+                }
+
+                //
+                // 2. Filter horizontally, straight into the resized image
+                //
+
+                size_t xWeightIndex = 0;
+                for (int x = 0; x < newSize.Width; ++x)
+                {
+                    float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+
+                    for (int sx = xFootprints[x].Start; sx < xFootprints[x].End; ++sx)
+                    {
+                        float const weight = xWeights[xWeightIndex++];
+
+                        r += sums[sx * 4 + 0] * weight;
+                        g += sums[sx * 4 + 1] * weight;
+                        b += sums[sx * 4 + 2] * weight;
+                        a += sums[sx * 4 + 3] * weight;
+                    }
+
+                    auto const toByte = [](float value)
+                    {
+                        return static_cast<uint8_t>(std::clamp(std::lround(value), 0l, 255l));
+                    };
+
+                    newData[y * newSize.Width + x] = (a > 0.0f)
+                        ? rgbaColor(toByte(r / a), toByte(g / a), toByte(b / a), toByte(a))
+                        : rgbaColor::zero();
+                }
+            }
+        });
 
-}
\ No newline at end of file
+    return RgbaImageData(newSize, std::move(newData));
+}
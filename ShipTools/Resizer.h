@@ -3,15 +3,54 @@
 * Created:				2018-06-25
 * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
 ***************************************************************************************/
+#pragma once
+
+#include <GameCore/ImageData.h>
+#include <GameCore/ImageSize.h>
 
 #include <string>
 
+/*
+ * Resizes ship images to the specified width, keeping their aspect ratio.
+ *
+ * Both kinds of resizing run over bands of rows on the task thread pool; when invoked
+ * from within a batch - whose files already run on a pool - the bands run inline.
+ */
 class Resizer
 {
 public:
 
+    enum class ResizeMode
+    {
+        // Every pixel takes the color of a pixel of its footprint in the original image,
+        // so that structural layers keep exactly the colors of their materials
+        Structure,
+
+        // Pixels are the area-weighted average of their footprint in the original image,
+        // for texture layers
+        Texture
+    };
+
     static void Resize(
         std::string const & inputFile,
         std::string const & outputFile,
-        int width);
+        int width,
+        ResizeMode mode);
+
+    /*
+     * Each pixel takes the most frequent structural - i.e. neither transparent nor pure
+     * white - color of its footprint, unless less than a quarter of the footprint is
+     * structure, in which case it takes the footprint's most frequent empty color.
+     */
+    static RgbaImageData ResizeStructure(
+        RgbaImageData const & image,
+        ImageSize const & newSize);
+
+    /*
+     * Each pixel is the average of its footprint, weighted by the area each pixel of the
+     * footprint covers and by alpha, so that transparent pixels don't bleed their color.
+     */
+    static RgbaImageData ResizeTexture(
+        RgbaImageData const & image,
+        ImageSize const & newSize);
 };
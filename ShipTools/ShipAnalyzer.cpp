@@ -6,31 +6,50 @@
 #include "ShipAnalyzer.h"
 
 #include <Game/GameParameters.h>
+#include <Game/IGameEventHandler.h>
 #include <Game/ImageFileTools.h>
 #include <Game/MaterialDatabase.h>
+#include <Game/Physics.h>
+#include <Game/ShipBuilder.h>
+#include <Game/ShipDefinition.h>
+#include <Game/SimulationView.h>
+#include <Game/ViewModel.h>
 
 #include <GameCore/Colors.h>
+#include <GameCore/GameRandomEngine.h>
+#include <GameCore/RunningAverage.h>
 #include <GameCore/Vectors.h>
 
 #include <IL/il.h>
 #include <IL/ilu.h>
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <vector>
 
 ShipAnalyzer::AnalysisInfo ShipAnalyzer::Analyze(
     std::string const & inputFile,
     std::string const & materialsDir)
+{
+    // Load materials
+    auto const materials = MaterialDatabase::Load(materialsDir);
+
+    return Analyze(inputFile, materials);
+}
+
+ShipAnalyzer::AnalysisInfo ShipAnalyzer::Analyze(
+    std::string const & inputFile,
+    MaterialDatabase const & materials)
 {
     // Load image
     auto image = ImageFileTools::LoadImageRgbUpperLeft(std::filesystem::path(inputFile));
 
     float const halfWidth = static_cast<float>(image.Size.Width) / 2.0f;
 
-    // Load materials
-    auto materials = MaterialDatabase::Load(materialsDir);
-
     // Visit all points
     ShipAnalyzer::AnalysisInfo analysisInfo;
     float totalMass = 0.0f;
@@ -80,4 +99,97 @@ ShipAnalyzer::AnalysisInfo ShipAnalyzer::Analyze(
     }
 
     return analysisInfo;
+}
+
+ShipAnalyzer::CostInfo ShipAnalyzer::EstimateCost(
+    std::filesystem::path const & shipFile,
+    ResourceLoader & resourceLoader,
+    size_t stepCount)
+{
+    auto const materials = MaterialDatabase::Load(resourceLoader);
+
+    GameParameters gameParameters;
+
+    // GPU calculators need an OpenGL context
+    gameParameters.DoUseGPUWaterDiffusion = false;
+    gameParameters.DoUseGPUMechanicalDynamics = false;
+
+    Physics::World world(
+        std::make_shared<IGameEventHandler>(),
+        gameParameters,
+        resourceLoader);
+
+    // The initial view of the game, at 1024x768
+    Render::ViewModel const viewModel(1.0f, vec2f::zero(), 1024, 768);
+    SimulationView const simulationView(
+        viewModel.GetVisibleWorldTopLeft().x,
+        viewModel.GetVisibleWorldBottomRight().x,
+        viewModel.GetVisibleWorldTopLeft().y,
+        viewModel.GetVisibleWorldBottomRight().y,
+        false);
+
+    //
+    // Build
+    //
+
+    // Same as the game at startup
+    GameRandomEngine::GetInstance().Reseed(0);
+
+    auto shipDefinition = ShipDefinition::Load(shipFile);
+
+    auto ship = ShipBuilder::Create(
+        0,
+        world,
+        std::make_shared<IGameEventHandler>(),
+        shipDefinition,
+        materials,
+        gameParameters);
+
+    CostInfo costInfo;
+
+    costInfo.PointCount = ship->GetPoints().GetShipPointCount();
+    costInfo.SpringCount = ship->GetSprings().GetElementCount();
+    costInfo.TriangleCount = ship->GetTriangles().GetElementCount();
+    costInfo.ElectricalElementCount = ship->GetElectricalElements().GetElementCount();
+
+    ship->ReportMemory(costInfo.Memory);
+
+    std::vector<ElementIndex> springIndices(costInfo.SpringCount);
+    std::iota(springIndices.begin(), springIndices.end(), ElementIndex(0));
+    costInfo.SpringACMR = ShipBuilder::CalculateSpringACMR(ship->GetSprings(), springIndices);
+
+    //
+    // Run
+    //
+
+    // Fed back to the ship as the game does, so that the number of mechanical
+    // iterations - when adaptive - is the one the game would pick on this machine
+    RunningAverage<16> updateDurationMillisRunningAverage;
+
+    float currentSimulationTime = 0.0f;
+    float totalMillis = 0.0f;
+    for (size_t s = 0; s < stepCount; ++s)
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+
+        ship->Update(
+            currentSimulationTime,
+            gameParameters,
+            updateDurationMillisRunningAverage.GetCurrentAverage(),
+            simulationView);
+
+        float const millis = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+        updateDurationMillisRunningAverage.Update(millis);
+        totalMillis += millis;
+        costInfo.MaxMillisPerStep = std::max(costInfo.MaxMillisPerStep, millis);
+
+        currentSimulationTime += GameParameters::SimulationStepTimeDuration<float>;
+    }
+
+    costInfo.StepCount = stepCount;
+    if (stepCount > 0)
+        costInfo.AverageMillisPerStep = totalMillis / static_cast<float>(stepCount);
+
+    return costInfo;
 }
\ No newline at end of file
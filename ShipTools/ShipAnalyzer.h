@@ -4,6 +4,13 @@
  * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
  ***************************************************************************************/
 
+#include <Game/MaterialDatabase.h>
+#include <Game/ResourceLoader.h>
+
+#include <GameCore/MemoryReport.h>
+
+#include <cstddef>
+#include <filesystem>
 #include <string>
 
 class ShipAnalyzer
@@ -32,4 +39,52 @@ public:
     static AnalysisInfo Analyze(
         std::string const & inputFile,
         std::string const & materialsDir);
+
+    /*
+     * As above, with materials that have been loaded already; may be invoked
+     * concurrently.
+     */
+    static AnalysisInfo Analyze(
+        std::string const & inputFile,
+        MaterialDatabase const & materials);
+
+    struct CostInfo
+    {
+        size_t PointCount;
+        size_t SpringCount;
+        size_t TriangleCount;
+        size_t ElectricalElementCount;
+
+        // The buffers of the ship, under "Ship 0/..."
+        MemoryReport Memory;
+
+        // Of visiting the spring endpoints in the order the ship has been laid out in
+        float SpringACMR;
+
+        size_t StepCount;
+        float AverageMillisPerStep;
+        float MaxMillisPerStep;
+
+        CostInfo()
+            : PointCount(0)
+            , SpringCount(0)
+            , TriangleCount(0)
+            , ElectricalElementCount(0)
+            , Memory()
+            , SpringACMR(0.0f)
+            , StepCount(0)
+            , AverageMillisPerStep(0.0f)
+            , MaxMillisPerStep(0.0f)
+        {}
+    };
+
+    /*
+     * Builds the ship as the game does, and runs the specified number of simulation
+     * steps on it - on the CPU, with no rendering - to estimate what the ship costs
+     * per frame.
+     */
+    static CostInfo EstimateCost(
+        std::filesystem::path const & shipFile,
+        ResourceLoader & resourceLoader,
+        size_t stepCount);
 };
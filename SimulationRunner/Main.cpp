@@ -0,0 +1,389 @@
+/***************************************************************************************
+ * Original Author:		Gabriele Giuseppini
+ * Created:				2019-06-10
+ * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+
+#include "ParameterSweep.h"
+
+#include <Game/GameParameters.h>
+#include <Game/IGameEventHandler.h>
+#include <Game/MaterialDatabase.h>
+#include <Game/Physics.h>
+#include <Game/ResourceLoader.h>
+#include <Game/ShipDefinition.h>
+#include <Game/ShipDefinitionFile.h>
+#include <Game/SimulationView.h>
+#include <Game/ViewModel.h>
+
+#include <GameCore/GameRandomEngine.h>
+#include <GameCore/GameWallClock.h>
+#include <GameCore/Utils.h>
+
+#include <picojson.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Runs the simulation of ships without any rendering, and reports how long it took
+ * as JSON - e.g. to track performance regressions across builds.
+ *
+ * Each ship is loaded alone into a new world, with the same random seed, and with the
+ * game wall clock advancing by exactly one simulation step per step.
+ *
+ * With --sweep, runs ships over a grid of game parameter values instead - see
+ * ParameterSweep.
+ */
+
+static constexpr unsigned int RandomSeed = 42;
+
+// Used as the average update duration fed back to the ships, so that their number of
+// mechanical iterations - when adaptive - doesn't depend on the machine
+static constexpr float NominalUpdateDurationMillis = 10.0f;
+
+struct ShipRunResult
+{
+    std::string ShipName;
+    size_t PointCount;
+    std::chrono::steady_clock::duration LoadDuration;
+    std::chrono::steady_clock::duration TotalUpdateDuration;
+    std::chrono::steady_clock::duration MinStepDuration;
+    std::chrono::steady_clock::duration MaxStepDuration;
+    Physics::World::UpdateTimings TotalPhaseTimings;
+    Physics::ShipPerfStats ShipPerfStats;
+    size_t BrokenSpringCount;
+    std::optional<size_t> SinkingStep;
+};
+
+/*
+ * Tracks the events that tell how stable a ship is.
+ */
+class RunEventHandler final : public IGameEventHandler
+{
+public:
+
+    size_t CurrentStep = 0;
+    size_t BrokenSpringCount = 0;
+    std::optional<size_t> SinkingStep;
+
+    void OnBreak(
+        StructuralMaterial const & /*structuralMaterial*/,
+        bool /*isUnderwater*/,
+        unsigned int size) override
+    {
+        BrokenSpringCount += size;
+    }
+
+    void OnSinkingBegin(ShipId /*shipId*/) override
+    {
+        if (!SinkingStep)
+            SinkingStep = CurrentStep;
+    }
+};
+
+ShipRunResult RunShip(
+    std::filesystem::path const & shipDefinitionFilepath,
+    size_t stepCount,
+    GameParameters const & gameParameters,
+    MaterialDatabase const & materialDatabase,
+    ResourceLoader & resourceLoader);
+
+std::vector<std::filesystem::path> FindShipDefinitionFiles(std::filesystem::path const & path);
+
+picojson::value ToJson(
+    ShipRunResult const & result,
+    size_t stepCount);
+
+int RunSweep(
+    std::filesystem::path const & runnerExecutableFilepath,
+    std::filesystem::path const & specificationFilepath,
+    std::filesystem::path const & outputCsvFilepath,
+    size_t workerCount);
+
+void PrintUsage();
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    if (std::string(argv[1]) == "--sweep")
+    {
+        if (argc < 4)
+        {
+            PrintUsage();
+            return 0;
+        }
+
+        // Workers are further instances of ourselves
+        std::filesystem::path const runnerExecutableFilepath = std::filesystem::absolute(argv[0]);
+
+        return RunSweep(
+            runnerExecutableFilepath,
+            argv[2],
+            argv[3],
+            (argc >= 5) ? static_cast<size_t>(std::stoul(argv[4])) : std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    std::filesystem::path const inputPath(argv[1]);
+    size_t const stepCount = (argc >= 3) ? static_cast<size_t>(std::stoul(argv[2])) : 1000;
+    std::filesystem::path const outputFilepath = (argc >= 4) ? std::filesystem::path(argv[3]) : std::filesystem::path();
+
+    try
+    {
+        ResourceLoader resourceLoader;
+        MaterialDatabase materialDatabase = MaterialDatabase::Load(resourceLoader);
+
+        GameParameters gameParameters;
+
+        // GPU calculators need an OpenGL context
+        gameParameters.DoUseGPUWaterDiffusion = false;
+        gameParameters.DoUseGPUMechanicalDynamics = false;
+
+        for (int a = 4; a < argc; ++a)
+        {
+            ParameterSweep::ApplyParameterAssignment(argv[a], gameParameters);
+        }
+
+        GameWallClock::GetInstance().SetManual(true);
+
+        picojson::array shipsJson;
+        for (auto const & shipDefinitionFilepath : FindShipDefinitionFiles(inputPath))
+        {
+            std::cerr << "Running " << shipDefinitionFilepath.filename().string() << "..." << std::endl;
+
+            auto const result = RunShip(
+                shipDefinitionFilepath,
+                stepCount,
+                gameParameters,
+                materialDatabase,
+                resourceLoader);
+
+            shipsJson.emplace_back(ToJson(result, stepCount));
+        }
+
+        picojson::object rootJson;
+        rootJson["steps"] = picojson::value(static_cast<double>(stepCount));
+        rootJson["ships"] = picojson::value(shipsJson);
+
+        std::string const json = picojson::value(rootJson).serialize(true);
+        if (outputFilepath.empty())
+        {
+            std::cout << json;
+        }
+        else
+        {
+            std::ofstream outputFile(outputFilepath, std::ios::out | std::ios::trunc);
+            outputFile << json;
+        }
+    }
+    catch (std::exception & ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+ShipRunResult RunShip(
+    std::filesystem::path const & shipDefinitionFilepath,
+    size_t stepCount,
+    GameParameters const & gameParameters,
+    MaterialDatabase const & materialDatabase,
+    ResourceLoader & resourceLoader)
+{
+    auto const stepDuration = std::chrono::duration_cast<GameWallClock::duration>(
+        std::chrono::duration<float>(GameParameters::SimulationStepTimeDuration<float>));
+
+    // The view the simulation is run with: the initial view of the game, at 1024x768
+    Render::ViewModel const viewModel(1.0f, vec2f::zero(), 1024, 768);
+    SimulationView const simulationView(
+        viewModel.GetVisibleWorldTopLeft().x,
+        viewModel.GetVisibleWorldBottomRight().x,
+        viewModel.GetVisibleWorldTopLeft().y,
+        viewModel.GetVisibleWorldBottomRight().y,
+        false);
+
+    // Every ship starts from the same state
+    GameRandomEngine::GetInstance().Reseed(RandomSeed);
+
+    auto const loadStartTime = std::chrono::steady_clock::now();
+
+    auto eventHandler = std::make_shared<RunEventHandler>();
+
+    Physics::World world(
+        eventHandler,
+        gameParameters,
+        resourceLoader);
+
+    auto shipDefinition = ShipDefinition::Load(shipDefinitionFilepath);
+
+    ShipId const shipId = world.AddShip(
+        shipDefinition,
+        materialDatabase,
+        gameParameters);
+
+    ShipRunResult result;
+    result.ShipName = shipDefinition.Metadata.ShipName;
+    result.PointCount = world.GetShipPointCount(shipId);
+    result.LoadDuration = std::chrono::steady_clock::now() - loadStartTime;
+    result.TotalUpdateDuration = std::chrono::steady_clock::duration::zero();
+    result.MinStepDuration = std::chrono::steady_clock::duration::max();
+    result.MaxStepDuration = std::chrono::steady_clock::duration::zero();
+
+    for (size_t step = 0; step < stepCount; ++step)
+    {
+        eventHandler->CurrentStep = step;
+
+        auto const startTime = std::chrono::steady_clock::now();
+
+        world.Update(
+            gameParameters,
+            NominalUpdateDurationMillis,
+            simulationView);
+
+        auto const stepUpdateDuration = std::chrono::steady_clock::now() - startTime;
+
+        result.TotalUpdateDuration += stepUpdateDuration;
+        result.MinStepDuration = std::min(result.MinStepDuration, stepUpdateDuration);
+        result.MaxStepDuration = std::max(result.MaxStepDuration, stepUpdateDuration);
+
+        auto const & phaseTimings = world.GetLastUpdateTimings();
+        result.TotalPhaseTimings.WorldParts += phaseTimings.WorldParts;
+        result.TotalPhaseTimings.Ships += phaseTimings.Ships;
+        result.TotalPhaseTimings.ShipCollisions += phaseTimings.ShipCollisions;
+
+        GameWallClock::GetInstance().Advance(stepDuration);
+    }
+
+    result.ShipPerfStats = world.GetShipPerfStats();
+    result.BrokenSpringCount = eventHandler->BrokenSpringCount;
+    result.SinkingStep = eventHandler->SinkingStep;
+
+    return result;
+}
+
+std::vector<std::filesystem::path> FindShipDefinitionFiles(std::filesystem::path const & path)
+{
+    if (!std::filesystem::is_directory(path))
+    {
+        if (!std::filesystem::exists(path))
+        {
+            throw std::runtime_error("Cannot find '" + path.string() + "'");
+        }
+
+        return { path };
+    }
+
+    std::vector<std::filesystem::path> shipDefinitionFilepaths;
+    for (auto const & entry : std::filesystem::directory_iterator(path))
+    {
+        if (entry.is_regular_file()
+            && (Utils::ToLower(entry.path().extension().string()) == ".png"
+                || ShipDefinitionFile::IsShipDefinitionFile(entry.path())))
+        {
+            shipDefinitionFilepaths.push_back(entry.path());
+        }
+    }
+
+    // Run in a stable order, so that reports may be compared line by line
+    std::sort(shipDefinitionFilepaths.begin(), shipDefinitionFilepaths.end());
+
+    return shipDefinitionFilepaths;
+}
+
+picojson::value ToJson(
+    ShipRunResult const & result,
+    size_t stepCount)
+{
+    auto const toMillis = [](std::chrono::steady_clock::duration duration)
+    {
+        return picojson::value(static_cast<double>(std::chrono::duration<double, std::milli>(duration).count()));
+    };
+
+    picojson::object phasesJson;
+    phasesJson["world_parts_ms"] = toMillis(result.TotalPhaseTimings.WorldParts);
+    phasesJson["ships_ms"] = toMillis(result.TotalPhaseTimings.Ships);
+    phasesJson["ship_collisions_ms"] = toMillis(result.TotalPhaseTimings.ShipCollisions);
+
+    // Only measured when built with ENABLE_PERF_STATS
+    picojson::object shipPhasesJson;
+    for (size_t p = 0; p < Physics::ShipPerfStats::PhaseCount; ++p)
+    {
+        auto const phase = static_cast<Physics::ShipPerfStats::Phase>(p);
+        shipPhasesJson[Physics::ShipPerfStats::GetPhaseName(phase)] = toMillis(result.ShipPerfStats[phase]);
+    }
+
+    picojson::object shipJson;
+    shipJson["name"] = picojson::value(result.ShipName);
+    shipJson["points"] = picojson::value(static_cast<double>(result.PointCount));
+    shipJson["load_ms"] = toMillis(result.LoadDuration);
+    shipJson["total_update_ms"] = toMillis(result.TotalUpdateDuration);
+    shipJson["avg_step_ms"] = toMillis(stepCount > 0 ? result.TotalUpdateDuration / static_cast<std::chrono::steady_clock::duration::rep>(stepCount) : std::chrono::steady_clock::duration::zero());
+    shipJson["min_step_ms"] = toMillis(stepCount > 0 ? result.MinStepDuration : std::chrono::steady_clock::duration::zero());
+    shipJson["max_step_ms"] = toMillis(result.MaxStepDuration);
+    shipJson["steps_per_s"] = picojson::value(result.TotalUpdateDuration.count() > 0 ? static_cast<double>(stepCount) / std::chrono::duration<double>(result.TotalUpdateDuration).count() : 0.0);
+    shipJson["broken_springs"] = picojson::value(static_cast<double>(result.BrokenSpringCount));
+    shipJson["sinking_time_s"] = !!result.SinkingStep
+        ? picojson::value(static_cast<double>(*result.SinkingStep) * GameParameters::SimulationStepTimeDuration<double>)
+        : picojson::value();
+    shipJson["phases"] = picojson::value(phasesJson);
+    shipJson["ship_phases"] = picojson::value(shipPhasesJson);
+
+    return picojson::value(shipJson);
+}
+
+int RunSweep(
+    std::filesystem::path const & runnerExecutableFilepath,
+    std::filesystem::path const & specificationFilepath,
+    std::filesystem::path const & outputCsvFilepath,
+    size_t workerCount)
+{
+    try
+    {
+        auto const specification = ParameterSweep::Specification::Load(specificationFilepath);
+
+        std::vector<std::filesystem::path> shipDefinitionFilepaths;
+        for (auto const & shipPath : specification.ShipPaths)
+        {
+            auto const filepaths = FindShipDefinitionFiles(shipPath);
+            shipDefinitionFilepaths.insert(shipDefinitionFilepaths.end(), filepaths.begin(), filepaths.end());
+        }
+
+        ParameterSweep::Run(
+            shipDefinitionFilepaths,
+            specification,
+            runnerExecutableFilepath,
+            outputCsvFilepath,
+            workerCount);
+    }
+    catch (std::exception & ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+void PrintUsage()
+{
+    std::cout << std::endl;
+    std::cout << "Usage:" << std::endl;
+    std::cout << " SimulationRunner <ship_file_or_dir> [<steps>] [<out_json>] [<parameter>=<value> ...]" << std::endl;
+    std::cout << " SimulationRunner --sweep <sweep_json> <out_csv> [<worker_count>]" << std::endl;
+}
@@ -0,0 +1,369 @@
+/***************************************************************************************
+ * Original Author:		Gabriele Giuseppini
+ * Created:				2019-07-03
+ * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#include "ParameterSweep.h"
+
+#include <GameCore/Utils.h>
+
+#include <picojson.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace /* anonymous */ {
+
+struct SweptParameter
+{
+    char const * Name;
+    float GameParameters::* Member;
+    float MinValue;
+    float MaxValue;
+};
+
+#define SWEPT_PARAMETER(name) { #name, &GameParameters::name, GameParameters::Min##name, GameParameters::Max##name }
+
+SweptParameter const SweptParameters[] = {
+    SWEPT_PARAMETER(NumMechanicalDynamicsIterationsAdjustment),
+    SWEPT_PARAMETER(SpringStiffnessAdjustment),
+    SWEPT_PARAMETER(SpringDampingAdjustment),
+    SWEPT_PARAMETER(SpringStrengthAdjustment),
+    SWEPT_PARAMETER(RotAcceler8r),
+    SWEPT_PARAMETER(WaterDensityAdjustment),
+    SWEPT_PARAMETER(WaterDragAdjustment),
+    SWEPT_PARAMETER(WaterIntakeAdjustment),
+    SWEPT_PARAMETER(WaterDiffusionSpeedAdjustment),
+    SWEPT_PARAMETER(WaterCrazyness)
+};
+
+#undef SWEPT_PARAMETER
+
+SweptParameter const & FindSweptParameter(std::string const & name)
+{
+    auto const it = std::find_if(
+        std::begin(SweptParameters),
+        std::end(SweptParameters),
+        [&name](SweptParameter const & p)
+        {
+            return name == p.Name;
+        });
+
+    if (it == std::end(SweptParameters))
+    {
+        std::string names;
+        for (auto const & p : SweptParameters)
+            names += std::string(names.empty() ? "" : ", ") + p.Name;
+
+        throw std::runtime_error("Parameter '" + name + "' cannot be swept; it must be one of: " + names);
+    }
+
+    return *it;
+}
+
+struct Job
+{
+    std::filesystem::path ShipDefinitionFilepath;
+    std::vector<float> ParameterValues; // One per swept parameter
+};
+
+std::string Quote(std::string const & str)
+{
+    return "\"" + str + "\"";
+}
+
+std::string ToCsvField(std::string const & str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos)
+        return str;
+
+    std::string field = "\"";
+    for (char c : str)
+    {
+        if (c == '"')
+            field += "\"\"";
+        else
+            field += c;
+    }
+
+    return field + "\"";
+}
+
+std::string ToCsvField(picojson::object const & resultJson, std::string const & memberName)
+{
+    auto const it = resultJson.find(memberName);
+    if (it == resultJson.end() || it->second.is<picojson::null>())
+        return "";
+
+    return ToCsvField(it->second.to_str());
+}
+
+}
+
+ParameterSweep::Specification ParameterSweep::Specification::Load(std::filesystem::path const & specificationFilepath)
+{
+    auto const specificationJson = Utils::ParseJSONFile(specificationFilepath);
+    if (!specificationJson.is<picojson::object>())
+    {
+        throw std::runtime_error("The sweep specification must be a JSON object");
+    }
+
+    auto const & rootObject = specificationJson.get<picojson::object>();
+
+    Specification specification;
+
+    auto const baseDirectory = specificationFilepath.parent_path();
+    for (auto const & shipPathJson : Utils::GetMandatoryJsonArray(rootObject, "ships"))
+    {
+        if (!shipPathJson.is<std::string>())
+        {
+            throw std::runtime_error("The ships of the sweep specification must be paths");
+        }
+
+        std::filesystem::path const shipPath(shipPathJson.get<std::string>());
+        specification.ShipPaths.push_back(shipPath.is_absolute() ? shipPath : baseDirectory / shipPath);
+    }
+
+    specification.StepCount = static_cast<size_t>(Utils::GetOptionalJsonMember<std::int64_t>(rootObject, "steps", 1000));
+
+    for (auto const & parameterIt : Utils::GetMandatoryJsonObject(rootObject, "parameters"))
+    {
+        // Check it now rather than in each worker
+        auto const & sweptParameter = FindSweptParameter(parameterIt.first);
+
+        if (!parameterIt.second.is<picojson::array>())
+        {
+            throw std::runtime_error("The values of parameter '" + parameterIt.first + "' must be an array");
+        }
+
+        std::vector<float> values;
+        for (auto const & valueJson : parameterIt.second.get<picojson::array>())
+        {
+            if (!valueJson.is<double>())
+            {
+                throw std::runtime_error("The values of parameter '" + parameterIt.first + "' must be numbers");
+            }
+
+            float const value = static_cast<float>(valueJson.get<double>());
+            if (value < sweptParameter.MinValue || value > sweptParameter.MaxValue)
+            {
+                throw std::runtime_error(
+                    "Value " + std::to_string(value) + " of parameter '" + parameterIt.first + "' is outside of its range, "
+                    + std::to_string(sweptParameter.MinValue) + " to " + std::to_string(sweptParameter.MaxValue));
+            }
+
+            values.push_back(value);
+        }
+
+        if (values.empty())
+        {
+            throw std::runtime_error("Parameter '" + parameterIt.first + "' has no values");
+        }
+
+        specification.Parameters.emplace_back(parameterIt.first, std::move(values));
+    }
+
+    return specification;
+}
+
+void ParameterSweep::ApplyParameterAssignment(
+    std::string const & assignment,
+    GameParameters & gameParameters)
+{
+    auto const equalsPos = assignment.find('=');
+    if (equalsPos == std::string::npos)
+    {
+        throw std::runtime_error("'" + assignment + "' is not a <parameter>=<value> assignment");
+    }
+
+    auto const & sweptParameter = FindSweptParameter(assignment.substr(0, equalsPos));
+
+    float const value = std::stof(assignment.substr(equalsPos + 1));
+    if (value < sweptParameter.MinValue || value > sweptParameter.MaxValue)
+    {
+        throw std::runtime_error("Value of '" + assignment + "' is outside of the parameter's range");
+    }
+
+    gameParameters.*(sweptParameter.Member) = value;
+}
+
+void ParameterSweep::Run(
+    std::vector<std::filesystem::path> const & shipDefinitionFilepaths,
+    Specification const & specification,
+    std::filesystem::path const & runnerExecutableFilepath,
+    std::filesystem::path const & outputCsvFilepath,
+    size_t workerCount)
+{
+    //
+    // Make the jobs - all ships times the cartesian product of the parameter values
+    //
+
+    std::vector<Job> jobs;
+
+    for (auto const & shipDefinitionFilepath : shipDefinitionFilepaths)
+    {
+        std::vector<size_t> valueIndices(specification.Parameters.size(), 0);
+
+        while (true)
+        {
+            Job job{ shipDefinitionFilepath, {} };
+            for (size_t p = 0; p < specification.Parameters.size(); ++p)
+                job.ParameterValues.push_back(specification.Parameters[p].second[valueIndices[p]]);
+
+            jobs.push_back(std::move(job));
+
+            // Advance the odometer
+            size_t p = 0;
+            for (; p < valueIndices.size(); ++p)
+            {
+                if (++valueIndices[p] < specification.Parameters[p].second.size())
+                    break;
+
+                valueIndices[p] = 0;
+            }
+
+            if (p == valueIndices.size())
+                break;
+        }
+    }
+
+    //
+    // Run them
+    //
+
+    // Each worker writes its result as JSON in a file of its own
+    auto const resultDirectory = std::filesystem::temp_directory_path()
+        / ("SimulationRunner-sweep-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+    std::filesystem::create_directories(resultDirectory);
+
+    std::vector<std::optional<picojson::object>> results(jobs.size());
+
+    std::atomic<size_t> nextJobIndex(0);
+    size_t completedJobCount = 0;
+    std::mutex progressMutex;
+
+    auto const workerLoop = [&]()
+    {
+        for (size_t j = nextJobIndex++; j < jobs.size(); j = nextJobIndex++)
+        {
+            auto const resultFilepath = resultDirectory / (std::to_string(j) + ".json");
+
+            std::string command =
+                Quote(runnerExecutableFilepath.string())
+                + " " + Quote(jobs[j].ShipDefinitionFilepath.string())
+                + " " + std::to_string(specification.StepCount)
+                + " " + Quote(resultFilepath.string());
+
+            std::string parametersDescription;
+            for (size_t p = 0; p < specification.Parameters.size(); ++p)
+            {
+                std::ostringstream ss;
+                ss << specification.Parameters[p].first << "=" << jobs[j].ParameterValues[p];
+
+                command += " " + ss.str();
+                parametersDescription += " " + ss.str();
+            }
+
+#ifdef _WIN32
+            // cmd strips the outer quotes
+            command = Quote(command);
+#endif
+
+            int const exitCode = std::system(command.c_str());
+
+            if (0 == exitCode && std::filesystem::exists(resultFilepath))
+            {
+                auto const resultJson = Utils::ParseJSONFile(resultFilepath);
+                auto const & shipsJson = Utils::GetMandatoryJsonArray(resultJson.get<picojson::object>(), "ships");
+                if (shipsJson.size() == 1 && shipsJson[0].is<picojson::object>())
+                {
+                    results[j] = shipsJson[0].get<picojson::object>();
+                }
+            }
+
+            std::filesystem::remove(resultFilepath);
+
+            {
+                std::lock_guard<std::mutex> lock(progressMutex);
+
+                ++completedJobCount;
+
+                std::cerr << "[" << completedJobCount << "/" << jobs.size() << "] "
+                    << jobs[j].ShipDefinitionFilepath.filename().string() << parametersDescription
+                    << (!!results[j] ? "" : (": FAILED with exit code " + std::to_string(exitCode)))
+                    << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < std::max(workerCount, size_t(1)); ++w)
+        workers.emplace_back(workerLoop);
+
+    for (auto & worker : workers)
+        worker.join();
+
+    std::filesystem::remove_all(resultDirectory);
+
+    //
+    // Collect the results
+    //
+
+    std::ofstream outputFile(outputCsvFilepath, std::ios::out | std::ios::trunc);
+    if (!outputFile)
+    {
+        throw std::runtime_error("Cannot write '" + outputCsvFilepath.string() + "'");
+    }
+
+    outputFile << "ship_file,ship_name,points";
+    for (auto const & parameter : specification.Parameters)
+        outputFile << "," << parameter.first;
+    outputFile << ",steps,status,steps_per_s,avg_step_ms,max_step_ms,broken_springs,sinking_time_s" << std::endl;
+
+    for (size_t j = 0; j < jobs.size(); ++j)
+    {
+        outputFile << ToCsvField(jobs[j].ShipDefinitionFilepath.filename().string());
+
+        if (!!results[j])
+        {
+            outputFile << "," << ToCsvField(*results[j], "name") << "," << ToCsvField(*results[j], "points");
+        }
+        else
+        {
+            outputFile << ",,";
+        }
+
+        for (float value : jobs[j].ParameterValues)
+            outputFile << "," << value;
+
+        outputFile << "," << specification.StepCount;
+
+        if (!!results[j])
+        {
+            outputFile
+                << ",ok"
+                << "," << ToCsvField(*results[j], "steps_per_s")
+                << "," << ToCsvField(*results[j], "avg_step_ms")
+                << "," << ToCsvField(*results[j], "max_step_ms")
+                << "," << ToCsvField(*results[j], "broken_springs")
+                << "," << ToCsvField(*results[j], "sinking_time_s");
+        }
+        else
+        {
+            // A run that crashed or threw is as much a result as one that sank
+            outputFile << ",failed,,,,,";
+        }
+
+        outputFile << std::endl;
+    }
+}
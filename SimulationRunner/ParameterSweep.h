@@ -0,0 +1,64 @@
+/***************************************************************************************
+ * Original Author:		Gabriele Giuseppini
+ * Created:				2019-07-03
+ * Copyright:			Gabriele Giuseppini  (https://github.com/GabrieleGiuseppini)
+ ***************************************************************************************/
+#pragma once
+
+#include <Game/GameParameters.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Runs ships over a grid of game parameter values, each run in its own process - as
+ * the simulation relies on process-wide singletons, e.g. the random engine and the
+ * wall clock - and collects their results into one CSV file.
+ *
+ * A sweep is specified in JSON:
+ *
+ *   {
+ *     "ships": [ "Ships/Titanic.shp", "Test Ships" ],   // Files or directories
+ *     "steps": 3000,
+ *     "parameters": {
+ *       "SpringStiffnessAdjustment": [ 0.5, 1.0, 1.5 ],
+ *       "WaterCrazyness": [ 0.0, 1.0 ]
+ *     }
+ *   }
+ *
+ * Relative paths are relative to the specification file.
+ */
+class ParameterSweep
+{
+public:
+
+    struct Specification
+    {
+        std::vector<std::filesystem::path> ShipPaths;
+        size_t StepCount;
+        std::vector<std::pair<std::string, std::vector<float>>> Parameters;
+
+        static Specification Load(std::filesystem::path const & specificationFilepath);
+    };
+
+    /*
+     * Applies a "<parameter>=<value>" assignment to the game parameters, throwing when
+     * the parameter is not one that may be swept, or the value is out of its range.
+     */
+    static void ApplyParameterAssignment(
+        std::string const & assignment,
+        GameParameters & gameParameters);
+
+    /*
+     * Runs each ship with each combination of the parameter values, over the specified
+     * number of worker processes - each an instance of the runner executable.
+     */
+    static void Run(
+        std::vector<std::filesystem::path> const & shipDefinitionFilepaths,
+        Specification const & specification,
+        std::filesystem::path const & runnerExecutableFilepath,
+        std::filesystem::path const & outputCsvFilepath,
+        size_t workerCount);
+};
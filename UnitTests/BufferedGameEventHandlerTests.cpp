@@ -0,0 +1,79 @@
+#include <Game/BufferedGameEventHandler.h>
+
+#include "gmock/gmock.h"
+
+class _MockHandler : public IGameEventHandler
+{
+public:
+
+    MOCK_METHOD2(OnPinToggled, void(bool isPinned, bool isUnderwater));
+    MOCK_METHOD1(OnSinkingBegin, void(ShipId shipId));
+};
+
+using namespace ::testing;
+
+using MockHandler = StrictMock<_MockHandler>;
+
+/////////////////////////////////////////////////////////////////
+
+TEST(BufferedGameEventHandlerTests, ForwardsWhenNotBuffering)
+{
+    auto handler = std::make_shared<MockHandler>();
+
+    BufferedGameEventHandler bufferedHandler(handler);
+
+    EXPECT_CALL(*handler, OnSinkingBegin(4)).Times(1);
+
+    bufferedHandler.OnSinkingBegin(4);
+
+    Mock::VerifyAndClear(handler.get());
+}
+
+TEST(BufferedGameEventHandlerTests, BuffersUntilFlush_InOriginalOrder)
+{
+    auto handler = std::make_shared<MockHandler>();
+
+    BufferedGameEventHandler bufferedHandler(handler);
+
+    bufferedHandler.BeginBuffering();
+
+    EXPECT_CALL(*handler, OnSinkingBegin(_)).Times(0);
+    EXPECT_CALL(*handler, OnPinToggled(_, _)).Times(0);
+
+    bufferedHandler.OnSinkingBegin(2);
+    bufferedHandler.OnPinToggled(true, false);
+    bufferedHandler.OnSinkingBegin(1);
+
+    Mock::VerifyAndClear(handler.get());
+
+    {
+        InSequence s;
+
+        EXPECT_CALL(*handler, OnSinkingBegin(2)).Times(1);
+        EXPECT_CALL(*handler, OnPinToggled(true, false)).Times(1);
+        EXPECT_CALL(*handler, OnSinkingBegin(1)).Times(1);
+    }
+
+    bufferedHandler.Flush();
+
+    Mock::VerifyAndClear(handler.get());
+}
+
+TEST(BufferedGameEventHandlerTests, ForwardsAfterFlush)
+{
+    auto handler = std::make_shared<MockHandler>();
+
+    BufferedGameEventHandler bufferedHandler(handler);
+
+    bufferedHandler.BeginBuffering();
+    bufferedHandler.Flush();
+
+    EXPECT_CALL(*handler, OnSinkingBegin(7)).Times(1);
+
+    bufferedHandler.OnSinkingBegin(7);
+
+    Mock::VerifyAndClear(handler.get());
+
+    // Nothing left to forward
+    bufferedHandler.Flush();
+}
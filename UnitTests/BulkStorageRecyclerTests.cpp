@@ -0,0 +1,101 @@
+#include <GameCore/BulkStorageRecycler.h>
+#include <GameCore/Buffer.h>
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+TEST(BulkStorageRecyclerTests, SizeClass_SmallSizesAreExact)
+{
+    EXPECT_EQ(64u, BulkStorageRecycler::GetSizeClass(1));
+    EXPECT_EQ(64u, BulkStorageRecycler::GetSizeClass(64));
+    EXPECT_EQ(128u, BulkStorageRecycler::GetSizeClass(65));
+    EXPECT_EQ(BulkStorageRecycler::MaxExactSizeClass, BulkStorageRecycler::GetSizeClass(BulkStorageRecycler::MaxExactSizeClass));
+}
+
+TEST(BulkStorageRecyclerTests, SizeClass_LargeSizesAreRoundedToAnEighth)
+{
+    EXPECT_EQ(1024u * 1024u, BulkStorageRecycler::GetSizeClass(1024 * 1024));
+    EXPECT_EQ(1024u * 1024u + 128u * 1024u, BulkStorageRecycler::GetSizeClass(1024 * 1024 + 1));
+    EXPECT_EQ(2u * 1024u * 1024u - 128u * 1024u, BulkStorageRecycler::GetSizeClass(2 * 1024 * 1024 - 200 * 1024));
+
+    // At most one eighth of slack
+    for (size_t size = BulkStorageRecycler::MaxExactSizeClass; size < 64 * 1024 * 1024; size = size * 3 / 2 + 1)
+    {
+        size_t const sizeClass = BulkStorageRecycler::GetSizeClass(size);
+        EXPECT_GE(sizeClass, size);
+        EXPECT_LE(sizeClass - size, size / 8 + 64);
+    }
+}
+
+TEST(BulkStorageRecyclerTests, ReleasedStorageIsOnlyRetainedWhenCapturing)
+{
+    auto & recycler = BulkStorageRecycler::GetInstance();
+    recycler.Clear();
+
+    void * ptr = recycler.Acquire(16, 1000);
+    ASSERT_NE(nullptr, ptr);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(ptr) % CacheLineSize);
+
+    recycler.Release(ptr, 16, 1000);
+    EXPECT_EQ(0u, recycler.GetRetainedByteSize());
+
+    ptr = recycler.Acquire(16, 1000);
+
+    recycler.BeginCapture();
+    recycler.Release(ptr, 16, 1000);
+    recycler.EndCapture();
+
+    EXPECT_EQ(BulkStorageRecycler::GetSizeClass(1000), recycler.GetRetainedByteSize());
+
+    // Same class
+    void * const ptr2 = recycler.Acquire(4, 990);
+    EXPECT_EQ(ptr, ptr2);
+    EXPECT_EQ(0u, recycler.GetRetainedByteSize());
+
+    recycler.Release(ptr2, 4, 990);
+}
+
+TEST(BulkStorageRecyclerTests, BuffersTakeOverStorageOfCapturedBuffers)
+{
+    auto & recycler = BulkStorageRecycler::GetInstance();
+    recycler.Clear();
+
+    float const * oldStorage;
+
+    recycler.BeginCapture();
+    {
+        Buffer<float> oldBuffer(256 * 1024, 0, 1.0f);
+        oldStorage = oldBuffer.data();
+    }
+    recycler.EndCapture();
+
+    EXPECT_GT(recycler.GetRetainedByteSize(), 0u);
+
+    // A slightly different size falls in the same class
+    Buffer<float> newBuffer(256 * 1024 - 8);
+    EXPECT_EQ(oldStorage, newBuffer.data());
+    EXPECT_EQ(0u, recycler.GetRetainedByteSize());
+}
+
+TEST(BulkStorageRecyclerTests, ClearFreesAllRetainedStorage)
+{
+    auto & recycler = BulkStorageRecycler::GetInstance();
+    recycler.Clear();
+
+    recycler.BeginCapture();
+    recycler.Release(recycler.Acquire(64, 4096), 64, 4096);
+    recycler.Release(recycler.Acquire(64, 200 * 1024), 64, 200 * 1024);
+    recycler.EndCapture();
+
+    EXPECT_EQ(
+        BulkStorageRecycler::GetSizeClass(4096) + BulkStorageRecycler::GetSizeClass(200 * 1024),
+        recycler.GetRetainedByteSize());
+
+    // Not old enough yet
+    recycler.Trim();
+    EXPECT_GT(recycler.GetRetainedByteSize(), 0u);
+
+    recycler.Clear();
+    EXPECT_EQ(0u, recycler.GetRetainedByteSize());
+}
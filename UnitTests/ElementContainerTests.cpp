@@ -0,0 +1,56 @@
+#include <GameCore/ElementContainer.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+    class TestElementContainer : public ElementContainer
+    {
+    public:
+
+        TestElementContainer(ElementCount elementCount)
+            : ElementContainer(elementCount)
+        {}
+    };
+}
+
+TEST(ElementContainerTests, ForEachBlockCoversBuffer)
+{
+    TestElementContainer container(13);
+
+    ASSERT_EQ(16u, container.GetBufferElementCount());
+
+    std::vector<ElementIndex> blockStarts;
+    container.ForEachBlock<4>(
+        [&blockStarts](ElementIndex blockStart)
+        {
+            blockStarts.push_back(blockStart);
+        });
+
+    EXPECT_EQ(std::vector<ElementIndex>({ 0, 4, 8, 12 }), blockStarts);
+
+    blockStarts.clear();
+    container.ForEachBlock<VectorizationWordSize>(
+        [&blockStarts](ElementIndex blockStart)
+        {
+            blockStarts.push_back(blockStart);
+        });
+
+    EXPECT_EQ(std::vector<ElementIndex>({ 0, 8 }), blockStarts);
+}
+
+TEST(ElementContainerTests, ForEachBlockOnEmptyContainer)
+{
+    TestElementContainer container(0);
+
+    int blockCount = 0;
+    container.ForEachBlock<VectorizationWordSize>(
+        [&blockCount](ElementIndex)
+        {
+            ++blockCount;
+        });
+
+    EXPECT_EQ(0, blockCount);
+}
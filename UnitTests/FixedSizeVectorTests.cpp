@@ -296,6 +296,26 @@ TEST(FixedSizeVectorTests, ThrowsExceptionOnMaxSize)
         std::runtime_error);
 }
 
+TEST(FixedSizeVectorTests, PopBack)
+{
+    FixedSizeVector<int, 6> vec;
+
+    vec.push_back(1);
+    vec.push_back(2);
+    vec.push_back(3);
+
+    vec.pop_back();
+
+    ASSERT_EQ(2u, vec.size());
+    EXPECT_EQ(1, vec[0]);
+    EXPECT_EQ(2, vec[1]);
+
+    vec.pop_back();
+    vec.pop_back();
+
+    EXPECT_TRUE(vec.empty());
+}
+
 TEST(FixedSizeVectorTests, Erase_BecomesEmpty)
 {
     FixedSizeVector<int, 6> vec;
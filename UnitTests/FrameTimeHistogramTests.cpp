@@ -0,0 +1,98 @@
+#include <GameCore/FrameTimeHistogram.h>
+
+#include "gtest/gtest.h"
+
+TEST(FrameTimeHistogramTests, Empty)
+{
+    FrameTimeHistogram<10> histogram;
+
+    EXPECT_EQ(0u, histogram.GetSampleCount());
+
+    auto const percentiles = histogram.GetPercentiles();
+
+    EXPECT_EQ(0.0f, percentiles.P50);
+    EXPECT_EQ(0.0f, percentiles.P95);
+    EXPECT_EQ(0.0f, percentiles.P99);
+    EXPECT_EQ(0.0f, percentiles.Max);
+}
+
+TEST(FrameTimeHistogramTests, Percentiles)
+{
+    FrameTimeHistogram<100> histogram;
+
+    // 100, 99, ..., 1
+    for (int i = 100; i >= 1; --i)
+        histogram.RegisterSample(static_cast<float>(i));
+
+    EXPECT_EQ(100u, histogram.GetSampleCount());
+
+    auto const percentiles = histogram.GetPercentiles();
+
+    EXPECT_EQ(50.0f, percentiles.P50);
+    EXPECT_EQ(95.0f, percentiles.P95);
+    EXPECT_EQ(99.0f, percentiles.P99);
+    EXPECT_EQ(100.0f, percentiles.Max);
+}
+
+TEST(FrameTimeHistogramTests, Percentiles_PartialWindow)
+{
+    FrameTimeHistogram<100> histogram;
+
+    histogram.RegisterSample(3.0f);
+    histogram.RegisterSample(1.0f);
+    histogram.RegisterSample(2.0f);
+
+    EXPECT_EQ(3u, histogram.GetSampleCount());
+
+    auto const percentiles = histogram.GetPercentiles();
+
+    EXPECT_EQ(2.0f, percentiles.P50);
+    EXPECT_EQ(3.0f, percentiles.P95);
+    EXPECT_EQ(3.0f, percentiles.P99);
+    EXPECT_EQ(3.0f, percentiles.Max);
+}
+
+TEST(FrameTimeHistogramTests, OldestSamplesLeaveTheWindow)
+{
+    FrameTimeHistogram<4> histogram;
+
+    histogram.RegisterSample(100.0f);
+    histogram.RegisterSample(1.0f);
+    histogram.RegisterSample(1.0f);
+    histogram.RegisterSample(1.0f);
+
+    EXPECT_EQ(100.0f, histogram.GetPercentiles().Max);
+
+    histogram.RegisterSample(2.0f);
+
+    EXPECT_EQ(4u, histogram.GetSampleCount());
+    EXPECT_EQ(2.0f, histogram.GetPercentiles().Max);
+}
+
+TEST(FrameTimeHistogramTests, LastSample)
+{
+    FrameTimeHistogram<2> histogram;
+
+    EXPECT_EQ(0.0f, histogram.GetLastSample());
+
+    histogram.RegisterSample(1.0f);
+    EXPECT_EQ(1.0f, histogram.GetLastSample());
+
+    histogram.RegisterSample(2.0f);
+    EXPECT_EQ(2.0f, histogram.GetLastSample());
+
+    // Wrapped around
+    histogram.RegisterSample(3.0f);
+    EXPECT_EQ(3.0f, histogram.GetLastSample());
+}
+
+TEST(FrameTimeHistogramTests, Reset)
+{
+    FrameTimeHistogram<4> histogram;
+
+    histogram.RegisterSample(5.0f);
+    histogram.Reset();
+
+    EXPECT_EQ(0u, histogram.GetSampleCount());
+    EXPECT_EQ(0.0f, histogram.GetPercentiles().Max);
+}
@@ -0,0 +1,163 @@
+#include <Game/GameEventChannel.h>
+
+#include "gmock/gmock.h"
+
+#include <thread>
+
+class _MockHandler : public IGameEventHandler
+{
+public:
+
+    MOCK_METHOD2(OnPinToggled, void(bool isPinned, bool isUnderwater));
+    MOCK_METHOD1(OnSinkingBegin, void(ShipId shipId));
+    MOCK_METHOD2(OnCustomProbe, void(std::string const & name, float value));
+    MOCK_METHOD3(OnBombRemoved, void(ObjectId bombId, BombType bombType, std::optional<bool> isUnderwater));
+};
+
+using namespace ::testing;
+
+using MockHandler = StrictMock<_MockHandler>;
+
+/////////////////////////////////////////////////////////////////
+
+TEST(GameEventChannelTests, ForwardsOnlyAtDrain_InOriginalOrder)
+{
+    auto handler = std::make_shared<MockHandler>();
+
+    GameEventChannel channel(handler);
+
+    EXPECT_CALL(*handler, OnSinkingBegin(_)).Times(0);
+    EXPECT_CALL(*handler, OnPinToggled(_, _)).Times(0);
+
+    channel.OnSinkingBegin(2);
+    channel.OnPinToggled(true, false);
+    channel.OnSinkingBegin(1);
+
+    Mock::VerifyAndClear(handler.get());
+
+    {
+        InSequence s;
+
+        EXPECT_CALL(*handler, OnSinkingBegin(2)).Times(1);
+        EXPECT_CALL(*handler, OnPinToggled(true, false)).Times(1);
+        EXPECT_CALL(*handler, OnSinkingBegin(1)).Times(1);
+    }
+
+    channel.Drain();
+
+    Mock::VerifyAndClear(handler.get());
+
+    // Nothing left to forward
+    channel.Drain();
+}
+
+TEST(GameEventChannelTests, CarriesArguments)
+{
+    auto handler = std::make_shared<MockHandler>();
+
+    GameEventChannel channel(handler);
+
+    channel.OnCustomProbe("Foo", 4.5f);
+    channel.OnBombRemoved(ObjectId(3, 7), BombType::TimerBomb, std::nullopt);
+    channel.OnBombRemoved(ObjectId(1, 2), BombType::RCBomb, false);
+    channel.OnCustomProbe("Bar", -1.0f);
+
+    {
+        InSequence s;
+
+        EXPECT_CALL(*handler, OnCustomProbe(std::string("Foo"), 4.5f)).Times(1);
+        EXPECT_CALL(*handler, OnBombRemoved(ObjectId(3, 7), BombType::TimerBomb, std::optional<bool>())).Times(1);
+        EXPECT_CALL(*handler, OnBombRemoved(ObjectId(1, 2), BombType::RCBomb, std::optional<bool>(false))).Times(1);
+        EXPECT_CALL(*handler, OnCustomProbe(std::string("Bar"), -1.0f)).Times(1);
+    }
+
+    channel.Drain();
+
+    Mock::VerifyAndClear(handler.get());
+}
+
+TEST(GameEventChannelTests, Overflow_KeepsAllEventsInOrder)
+{
+    auto handler = std::make_shared<MockHandler>();
+
+    GameEventChannel channel(handler);
+
+    ShipId const eventCount = static_cast<ShipId>(GameEventChannel::Capacity + 10);
+
+    for (ShipId i = 0; i < eventCount; ++i)
+        channel.OnSinkingBegin(i);
+
+    {
+        InSequence s;
+
+        for (ShipId i = 0; i < GameEventChannel::Capacity; ++i)
+            EXPECT_CALL(*handler, OnSinkingBegin(i)).Times(1);
+    }
+
+    channel.Drain();
+
+    Mock::VerifyAndClear(handler.get());
+
+    // The overflown ones make it at the next flush
+    channel.FlushOverflow();
+
+    {
+        InSequence s;
+
+        for (ShipId i = GameEventChannel::Capacity; i < eventCount; ++i)
+            EXPECT_CALL(*handler, OnSinkingBegin(i)).Times(1);
+    }
+
+    channel.Drain();
+
+    Mock::VerifyAndClear(handler.get());
+}
+
+TEST(GameEventChannelTests, Concurrent_ProducerAndConsumer)
+{
+    class CountingHandler : public IGameEventHandler
+    {
+    public:
+
+        virtual void OnSinkingBegin(ShipId shipId) override
+        {
+            EXPECT_EQ(NextShipId, shipId);
+            ++NextShipId;
+        }
+
+        ShipId NextShipId = 0;
+    };
+
+    auto handler = std::make_shared<CountingHandler>();
+
+    GameEventChannel channel(handler);
+
+    static constexpr ShipId EventCount = 100000;
+
+    std::thread producer(
+        [&channel]()
+        {
+            for (ShipId i = 0; i < EventCount; ++i)
+            {
+                channel.OnSinkingBegin(i);
+
+                if ((i % 256) == 0)
+                    channel.FlushOverflow();
+            }
+
+            // Keep flushing until the consumer has made room for everything
+            while (!channel.FlushOverflow())
+            {
+                std::this_thread::yield();
+            }
+        });
+
+    while (handler->NextShipId < EventCount)
+    {
+        channel.Drain();
+    }
+
+    producer.join();
+
+    EXPECT_EQ(EventCount, handler->NextShipId);
+}
@@ -23,7 +23,7 @@ TEST(GameEventDispatcherTests, Aggregates_OnStress)
 {
     MockHandler handler;
 
-    GameEventDispatcher dispatcher;
+    GameEventDispatcher dispatcher(2);
     dispatcher.RegisterSink(&handler);
 
     StructuralMaterial sm(
@@ -38,8 +38,10 @@ TEST(GameEventDispatcherTests, Aggregates_OnStress)
         1.0f,
         1.0f,
         1.0f,
+        1.0f,
+        std::nullopt,
         std::nullopt,
-        std::nullopt);
+        0);
 
     EXPECT_CALL(handler, OnStress(_, _, _)).Times(0);
 
@@ -59,7 +61,7 @@ TEST(GameEventDispatcherTests, Aggregates_OnStress_MultipleKeys)
 {
     MockHandler handler;
 
-    GameEventDispatcher dispatcher;
+    GameEventDispatcher dispatcher(2);
     dispatcher.RegisterSink(&handler);
 
     StructuralMaterial sm1(
@@ -74,8 +76,10 @@ TEST(GameEventDispatcherTests, Aggregates_OnStress_MultipleKeys)
         1.0f,
         1.0f,
         1.0f,
+        1.0f,
+        std::nullopt,
         std::nullopt,
-        std::nullopt);
+        0);
 
     StructuralMaterial sm2(
         "Foo2",
@@ -89,8 +93,10 @@ TEST(GameEventDispatcherTests, Aggregates_OnStress_MultipleKeys)
         1.0f,
         1.0f,
         1.0f,
+        1.0f,
+        std::nullopt,
         std::nullopt,
-        std::nullopt);
+        1);
 
     EXPECT_CALL(handler, OnStress(_, _, _)).Times(0);
 
@@ -117,7 +123,7 @@ TEST(GameEventDispatcherTests, Aggregates_OnSinkingBegin)
 {
     MockHandler handler;
 
-    GameEventDispatcher dispatcher;
+    GameEventDispatcher dispatcher(2);
     dispatcher.RegisterSink(&handler);
 
     EXPECT_CALL(handler, OnSinkingBegin(_)).Times(0);
@@ -138,7 +144,7 @@ TEST(GameEventDispatcherTests, Aggregates_OnSinkingBegin_MultipleShips)
 {
     MockHandler handler;
 
-    GameEventDispatcher dispatcher;
+    GameEventDispatcher dispatcher(2);
     dispatcher.RegisterSink(&handler);
 
     EXPECT_CALL(handler, OnSinkingBegin(_)).Times(0);
@@ -160,7 +166,7 @@ TEST(GameEventDispatcherTests, ClearsStateAtUpdate)
 {
     MockHandler handler;
 
-    GameEventDispatcher dispatcher;
+    GameEventDispatcher dispatcher(2);
     dispatcher.RegisterSink(&handler);
 
     StructuralMaterial sm(
@@ -175,8 +181,10 @@ TEST(GameEventDispatcherTests, ClearsStateAtUpdate)
         1.0f,
         1.0f,
         1.0f,
+        1.0f,
+        std::nullopt,
         std::nullopt,
-        std::nullopt);
+        0);
 
     EXPECT_CALL(handler, OnStress(_, _, _)).Times(0);
 
@@ -134,6 +134,63 @@ TEST_P(FastExpTest, FastExpTest)
 }
 
 
+class FastSinTest : public testing::TestWithParam<std::tuple<float, float>>
+{
+public:
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestCases,
+    FastSinTest,
+    ::testing::Values(
+        std::make_tuple(-1.0f, 1.0f),
+        std::make_tuple(-10.0f, 10.0f),
+        std::make_tuple(-1000.0f, 1000.0f),
+        std::make_tuple(-100000.0f, -99000.0f),
+        std::make_tuple(99000.0f, 100000.0f)
+    ));
+
+TEST_P(FastSinTest, FastSinTest)
+{
+    float const start = std::get<0>(GetParam());
+    float const end = std::get<1>(GetParam());
+    float const step = (end - start) / 10007.0f;
+
+    for (float x = start; x < end; x += 4.0f * step)
+    {
+        alignas(16) float sines[4];
+        alignas(16) float cosines[4];
+        __m128 const x4 = _mm_set_ps(x + 3.0f * step, x + 2.0f * step, x + step, x);
+        _mm_store_ps(sines, FastSin4(x4));
+        _mm_store_ps(cosines, FastCos4(x4));
+
+        alignas(16) float xs[4];
+        _mm_store_ps(xs, x4);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_TRUE(ApproxEquals(sines[i], static_cast<float>(sin(static_cast<double>(xs[i]))), 0.000001f));
+            EXPECT_TRUE(ApproxEquals(cosines[i], static_cast<float>(cos(static_cast<double>(xs[i]))), 0.000001f));
+
+            // The scalar versions yield the very same results as the lanes
+            EXPECT_EQ(FastSin(xs[i]), sines[i]);
+            EXPECT_EQ(FastCos(xs[i]), cosines[i]);
+        }
+    }
+}
+
+TEST(FastSin, Landmarks)
+{
+    EXPECT_EQ(FastSin(0.0f), 0.0f);
+    EXPECT_TRUE(ApproxEquals(FastSin(Pi<float> / 2.0f), 1.0f, 0.000001f));
+    EXPECT_TRUE(ApproxEquals(FastSin(-Pi<float> / 2.0f), -1.0f, 0.000001f));
+    EXPECT_TRUE(ApproxEquals(FastSin(Pi<float>), 0.0f, 0.000001f));
+    EXPECT_TRUE(ApproxEquals(FastCos(0.0f), 1.0f, 0.000001f));
+    EXPECT_TRUE(ApproxEquals(FastCos(Pi<float>), -1.0f, 0.000001f));
+}
+
 // TODOTEST
 #include <cmath>
 
@@ -0,0 +1,110 @@
+#include <GameCore/GameRandomEngine.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(GameRandomEngineTests, GenerateRandomInteger_IsInRange)
+{
+    GameRandomEngine randomEngine(0);
+
+    std::array<int, 7> counts{ 0 };
+    for (int i = 0; i < 70000; ++i)
+    {
+        int const value = randomEngine.GenerateRandomInteger(-3, 3);
+        ASSERT_GE(value, -3);
+        ASSERT_LE(value, 3);
+
+        ++counts[value + 3];
+    }
+
+    // Every value shows up
+    for (int count : counts)
+    {
+        EXPECT_GT(count, 0);
+    }
+}
+
+TEST(GameRandomEngineTests, GenerateRandomInteger_SingleValueRange)
+{
+    GameRandomEngine randomEngine(0);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(7u, randomEngine.GenerateRandomInteger<size_t>(7, 7));
+    }
+}
+
+TEST(GameRandomEngineTests, GenerateRandomInteger_FullRange)
+{
+    GameRandomEngine randomEngine(0);
+
+    // Just checking that these don't trip over the span computation
+    randomEngine.GenerateRandomInteger<std::uint32_t>(0, std::numeric_limits<std::uint32_t>::max());
+    randomEngine.GenerateRandomInteger<std::int64_t>(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max());
+}
+
+TEST(GameRandomEngineTests, GenerateRandomNormalizedReal_IsInRange)
+{
+    GameRandomEngine randomEngine(0);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        float const value = randomEngine.GenerateRandomNormalizedReal();
+        ASSERT_GE(value, 0.0f);
+        ASSERT_LT(value, 1.0f);
+    }
+}
+
+TEST(GameRandomEngineTests, GenerateRandomReals_IsInRange)
+{
+    GameRandomEngine randomEngine(0);
+
+    // Not a multiple of the lanes
+    std::vector<float> values(GameRandomEngine::BatchLanes * 10 + 1, -1.0f);
+    randomEngine.GenerateRandomReals(values.data(), values.size(), 2.0f, 5.0f);
+
+    for (float value : values)
+    {
+        EXPECT_GE(value, 2.0f);
+        EXPECT_LT(value, 5.0f);
+    }
+}
+
+TEST(GameRandomEngineTests, SameSeed_SameSequence)
+{
+    GameRandomEngine randomEngine1(42);
+    GameRandomEngine randomEngine2(42);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(randomEngine1.Choose(1000000), randomEngine2.Choose(1000000));
+    }
+
+    float values1[11];
+    float values2[11];
+    randomEngine1.GenerateRandomNormalizedReals(values1, 11);
+    randomEngine2.GenerateRandomNormalizedReals(values2, 11);
+
+    for (int i = 0; i < 11; ++i)
+    {
+        EXPECT_EQ(values1[i], values2[i]);
+    }
+}
+
+TEST(GameRandomEngineTests, DifferentSeeds_DifferentSequences)
+{
+    GameRandomEngine randomEngine1(42);
+    GameRandomEngine randomEngine2(43);
+
+    int sameCount = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        if (randomEngine1.Choose(1000000) == randomEngine2.Choose(1000000))
+            ++sameCount;
+    }
+
+    EXPECT_LT(sameCount, 5);
+}
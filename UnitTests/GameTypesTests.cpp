@@ -0,0 +1,70 @@
+#include <GameCore/GameTypes.h>
+#include <GameCore/SysSpecifics.h>
+
+#include "gtest/gtest.h"
+
+TEST(GameTypesTests, DirtyElementRange_StartsEmpty)
+{
+    DirtyElementRange range;
+
+    EXPECT_TRUE(range.IsEmpty());
+    EXPECT_EQ(0u, range.GetCount());
+}
+
+TEST(GameTypesTests, DirtyElementRange_AddsElements)
+{
+    DirtyElementRange range;
+
+    range.Add(7);
+
+    EXPECT_FALSE(range.IsEmpty());
+    EXPECT_EQ(7u, range.GetStart());
+    EXPECT_EQ(8u, range.GetEnd());
+    EXPECT_EQ(1u, range.GetCount());
+
+    range.Add(3);
+    range.Add(5);
+
+    EXPECT_EQ(3u, range.GetStart());
+    EXPECT_EQ(8u, range.GetEnd());
+    EXPECT_EQ(5u, range.GetCount());
+}
+
+TEST(GameTypesTests, DirtyElementRange_AddsRanges)
+{
+    DirtyElementRange range;
+
+    range.Add(10, 20);
+
+    EXPECT_EQ(10u, range.GetStart());
+    EXPECT_EQ(20u, range.GetEnd());
+
+    range.Add(5, 5);
+
+    EXPECT_EQ(10u, range.GetStart());
+    EXPECT_EQ(20u, range.GetEnd());
+
+    range.Add(15, 30);
+
+    EXPECT_EQ(10u, range.GetStart());
+    EXPECT_EQ(30u, range.GetEnd());
+    EXPECT_EQ(20u, range.GetCount());
+}
+
+TEST(GameTypesTests, DirtyElementRange_Clears)
+{
+    DirtyElementRange range(0, 100);
+
+    EXPECT_EQ(100u, range.GetCount());
+
+    range.Clear();
+
+    EXPECT_TRUE(range.IsEmpty());
+    EXPECT_EQ(0u, range.GetCount());
+}
+
+TEST(GameTypesTests, MaxElementCount_PaddedBuffersStayBelowNoneElementIndex)
+{
+    EXPECT_LT(make_aligned_element_count(MaxElementCount), static_cast<size_t>(NoneElementIndex));
+    EXPECT_EQ(MaxElementCount, make_aligned_element_count(MaxElementCount));
+}
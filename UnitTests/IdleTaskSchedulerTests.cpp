@@ -0,0 +1,93 @@
+#include <Game/IdleTaskScheduler.h>
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(IdleTaskSchedulerTests, RunsTasksInOrder)
+{
+    IdleTaskScheduler scheduler;
+
+    std::vector<int> runs;
+
+    scheduler.Post("A", [&runs]() { runs.push_back(1); }, 10s);
+    scheduler.Post("B", [&runs]() { runs.push_back(2); }, 10s);
+
+    EXPECT_TRUE(scheduler.IsPosted("A"));
+    EXPECT_TRUE(scheduler.IsPosted("B"));
+    EXPECT_FALSE(scheduler.IsPosted("C"));
+
+    scheduler.RunPendingTasks(IdleTaskScheduler::clock::now() + 1s);
+
+    ASSERT_EQ(2u, runs.size());
+    EXPECT_EQ(1, runs[0]);
+    EXPECT_EQ(2, runs[1]);
+
+    EXPECT_EQ(0u, scheduler.GetPendingTaskCount());
+    EXPECT_EQ(2u, scheduler.GetRunTaskCount());
+    EXPECT_EQ(0u, scheduler.GetOverdueTaskCount());
+}
+
+TEST(IdleTaskSchedulerTests, SkipsTasksThatDoNotFit)
+{
+    IdleTaskScheduler scheduler;
+
+    // Learn how long the slow task takes
+    scheduler.Post("Slow", []() { std::this_thread::sleep_for(20ms); }, 10s);
+    scheduler.RunPendingTasks(IdleTaskScheduler::clock::now() + 1s);
+
+    int fastRunCount = 0;
+
+    scheduler.Post("Slow", []() { std::this_thread::sleep_for(20ms); }, 10s);
+    scheduler.Post("Fast", [&fastRunCount]() { ++fastRunCount; }, 10s);
+
+    scheduler.RunPendingTasks(IdleTaskScheduler::clock::now() + 5ms);
+
+    EXPECT_EQ(1, fastRunCount);
+    EXPECT_TRUE(scheduler.IsPosted("Slow"));
+    EXPECT_EQ(1u, scheduler.GetPendingTaskCount());
+}
+
+TEST(IdleTaskSchedulerTests, RunsOverdueTasksRegardlessOfBudget)
+{
+    IdleTaskScheduler scheduler;
+
+    int runCount = 0;
+
+    scheduler.Post("Task", [&runCount]() { ++runCount; }, 0ms);
+
+    // No time left at all
+    scheduler.RunPendingTasks(IdleTaskScheduler::clock::now() - 1s);
+
+    EXPECT_EQ(1, runCount);
+    EXPECT_EQ(1u, scheduler.GetOverdueTaskCount());
+}
+
+TEST(IdleTaskSchedulerTests, TasksPostedByTasksWaitForTheNextRun)
+{
+    IdleTaskScheduler scheduler;
+
+    int runCount = 0;
+
+    scheduler.Post(
+        "Outer",
+        [&]()
+        {
+            ++runCount;
+            scheduler.Post("Inner", [&runCount]() { ++runCount; }, 10s);
+        },
+        10s);
+
+    scheduler.RunPendingTasks(IdleTaskScheduler::clock::now() + 1s);
+
+    EXPECT_EQ(1, runCount);
+    EXPECT_TRUE(scheduler.IsPosted("Inner"));
+
+    scheduler.RunPendingTasks(IdleTaskScheduler::clock::now() + 1s);
+
+    EXPECT_EQ(2, runCount);
+}
@@ -0,0 +1,79 @@
+#include <GameCore/MemoryReport.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(MemoryReportTests, Empty)
+{
+    MemoryReport report;
+
+    EXPECT_TRUE(report.GetEntries().empty());
+    EXPECT_EQ(0u, report.GetTotalByteSize());
+}
+
+TEST(MemoryReportTests, AddsUnderSections)
+{
+    MemoryReport report;
+
+    report.Add("A", 1);
+
+    report.PushSection("S1");
+    report.Add("B", 10);
+
+    report.PushSection("S2");
+    report.Add("C", 100);
+    report.PopSection();
+
+    report.Add("D", 1000);
+    report.PopSection();
+
+    report.Add("E", 10000);
+
+    ASSERT_EQ(5u, report.GetEntries().size());
+    EXPECT_EQ("A", report.GetEntries()[0].Path);
+    EXPECT_EQ("S1/B", report.GetEntries()[1].Path);
+    EXPECT_EQ("S1/S2/C", report.GetEntries()[2].Path);
+    EXPECT_EQ(100u, report.GetEntries()[2].ByteSize);
+    EXPECT_EQ("S1/D", report.GetEntries()[3].Path);
+    EXPECT_EQ("E", report.GetEntries()[4].Path);
+}
+
+TEST(MemoryReportTests, TotalsBySection)
+{
+    MemoryReport report;
+
+    report.PushSection("S1");
+    report.Add("A", 1);
+    report.PushSection("S2");
+    report.Add("B", 10);
+    report.PopSection();
+    report.PopSection();
+
+    report.PushSection("S10");
+    report.Add("C", 100);
+    report.PopSection();
+
+    EXPECT_EQ(111u, report.GetTotalByteSize());
+    EXPECT_EQ(11u, report.GetTotalByteSize("S1"));
+    EXPECT_EQ(10u, report.GetTotalByteSize("S1/S2"));
+    EXPECT_EQ(100u, report.GetTotalByteSize("S10"));
+    EXPECT_EQ(0u, report.GetTotalByteSize("S3"));
+}
+
+TEST(MemoryReportTests, AddsVectors)
+{
+    MemoryReport report;
+
+    std::vector<double> vector;
+    vector.reserve(4);
+    report.Add("Vector", vector);
+
+    std::vector<bool> boolVector;
+    boolVector.reserve(64);
+    report.Add("BoolVector", boolVector);
+
+    ASSERT_EQ(2u, report.GetEntries().size());
+    EXPECT_EQ(vector.capacity() * sizeof(double), report.GetEntries()[0].ByteSize);
+    EXPECT_EQ((boolVector.capacity() + 7) / 8, report.GetEntries()[1].ByteSize);
+}
@@ -0,0 +1,97 @@
+#include <GameCore/NearestColorLookup.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+    size_t FindNearestByLinearScan(
+        std::vector<std::pair<rgbColor, size_t>> const & palette,
+        rgbColor const & color)
+    {
+        size_t bestEntry = 0;
+        int bestSquareDistance = std::numeric_limits<int>::max();
+        for (size_t e = 0; e < palette.size(); ++e)
+        {
+            int const dR = int(color.r) - int(palette[e].first.r);
+            int const dG = int(color.g) - int(palette[e].first.g);
+            int const dB = int(color.b) - int(palette[e].first.b);
+            int const squareDistance = dR * dR + dG * dG + dB * dB;
+            if (squareDistance < bestSquareDistance)
+            {
+                bestEntry = e;
+                bestSquareDistance = squareDistance;
+            }
+        }
+
+        return palette[bestEntry].second;
+    }
+}
+
+TEST(NearestColorLookupTests, SingleEntry)
+{
+    NearestColorLookup<int> lookup({ { rgbColor(10, 20, 30), 42 } });
+
+    EXPECT_EQ(42, lookup.Find(rgbColor(10, 20, 30)));
+    EXPECT_EQ(42, lookup.Find(rgbColor(0, 0, 0)));
+    EXPECT_EQ(42, lookup.Find(rgbColor(255, 255, 255)));
+}
+
+TEST(NearestColorLookupTests, ExactColors)
+{
+    NearestColorLookup<int> lookup({
+        { rgbColor(0, 0, 0), 1 },
+        { rgbColor(255, 255, 255), 2 },
+        { rgbColor(128, 64, 32), 3 },
+        { rgbColor(129, 64, 32), 4 } });
+
+    EXPECT_EQ(1, lookup.Find(rgbColor(0, 0, 0)));
+    EXPECT_EQ(2, lookup.Find(rgbColor(255, 255, 255)));
+    EXPECT_EQ(3, lookup.Find(rgbColor(128, 64, 32)));
+    EXPECT_EQ(4, lookup.Find(rgbColor(129, 64, 32)));
+}
+
+TEST(NearestColorLookupTests, TiesGoToEarliestEntry)
+{
+    NearestColorLookup<int> lookup({
+        { rgbColor(100, 0, 0), 1 },
+        { rgbColor(0, 100, 0), 2 },
+        { rgbColor(102, 0, 0), 3 } });
+
+    // Equidistant from 1 and 3
+    EXPECT_EQ(1, lookup.Find(rgbColor(101, 0, 0)));
+
+    // Equidistant from 1 and 2
+    EXPECT_EQ(1, lookup.Find(rgbColor(50, 50, 0)));
+}
+
+TEST(NearestColorLookupTests, MatchesLinearScan)
+{
+    std::mt19937 randomEngine(1234);
+    std::uniform_int_distribution<int> channelDistribution(0, 255);
+
+    std::vector<std::pair<rgbColor, size_t>> palette;
+    for (size_t e = 0; e < 250; ++e)
+    {
+        palette.emplace_back(
+            rgbColor(
+                static_cast<uint8_t>(channelDistribution(randomEngine)),
+                static_cast<uint8_t>(channelDistribution(randomEngine)),
+                static_cast<uint8_t>(channelDistribution(randomEngine))),
+            e);
+    }
+
+    NearestColorLookup<size_t> lookup(palette);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        rgbColor const color(
+            static_cast<uint8_t>(channelDistribution(randomEngine)),
+            static_cast<uint8_t>(channelDistribution(randomEngine)),
+            static_cast<uint8_t>(channelDistribution(randomEngine)));
+
+        ASSERT_EQ(FindNearestByLinearScan(palette, color), lookup.Find(color));
+    }
+}
@@ -0,0 +1,64 @@
+#include <Game/PerformanceAutotuner.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+    AutotuneMeasurement MakeMeasurement(
+        size_t threadCount,
+        float stepsPerSecond,
+        bool isStable)
+    {
+        return AutotuneMeasurement(
+            AutotuneConfiguration(threadCount, false, false, false, 1.0f),
+            stepsPerSecond,
+            isStable);
+    }
+}
+
+TEST(PerformanceAutotunerTests, PickFastestStable_NoMeasurements)
+{
+    std::vector<AutotuneMeasurement> const measurements;
+
+    EXPECT_FALSE(PerformanceAutotuner::PickFastestStable(measurements, 0.05f).has_value());
+}
+
+TEST(PerformanceAutotunerTests, PickFastestStable_SkipsUnstable)
+{
+    std::vector<AutotuneMeasurement> const measurements{
+        MakeMeasurement(1, 50.0f, true),
+        MakeMeasurement(2, 200.0f, false),
+        MakeMeasurement(4, 80.0f, true) };
+
+    auto const best = PerformanceAutotuner::PickFastestStable(measurements, 0.05f);
+    ASSERT_TRUE(best.has_value());
+    EXPECT_EQ(2u, *best);
+}
+
+TEST(PerformanceAutotunerTests, PickFastestStable_NoneStable)
+{
+    std::vector<AutotuneMeasurement> const measurements{
+        MakeMeasurement(1, 50.0f, false),
+        MakeMeasurement(2, 60.0f, false) };
+
+    EXPECT_FALSE(PerformanceAutotuner::PickFastestStable(measurements, 0.05f).has_value());
+}
+
+TEST(PerformanceAutotunerTests, PickFastestStable_PrefersEarlierWithinGain)
+{
+    // More threads are not worth it for a 2% gain
+    std::vector<AutotuneMeasurement> const measurements{
+        MakeMeasurement(1, 100.0f, true),
+        MakeMeasurement(2, 102.0f, true),
+        MakeMeasurement(4, 110.0f, true) };
+
+    auto const best = PerformanceAutotuner::PickFastestStable(measurements, 0.05f);
+    ASSERT_TRUE(best.has_value());
+    EXPECT_EQ(2u, *best);
+
+    auto const bestWithLargeGain = PerformanceAutotuner::PickFastestStable(measurements, 0.2f);
+    ASSERT_TRUE(bestWithLargeGain.has_value());
+    EXPECT_EQ(0u, *bestWithLargeGain);
+}
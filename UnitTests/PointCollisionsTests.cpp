@@ -0,0 +1,161 @@
+#include <Game/PointCollisions.h>
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/Vectors.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Physics;
+
+namespace {
+
+    WorldBounds const Bounds{ -100.0f, 100.0f, -50.0f, 50.0f, 20.0f };
+
+    // Not a multiple of any vectorization width, so to exercise the remainders
+    static constexpr size_t PointCount = 1003;
+
+    void MakePoints(
+        std::vector<vec2f> & positions,
+        std::vector<vec2f> & velocities)
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> positionDistribution(-150.0f, 150.0f);
+        std::uniform_real_distribution<float> velocityDistribution(-40.0f, 40.0f);
+
+        for (size_t p = 0; p < PointCount; ++p)
+        {
+            positions.emplace_back(positionDistribution(random), positionDistribution(random));
+            velocities.emplace_back(velocityDistribution(random), velocityDistribution(random));
+        }
+
+        // Exactly on the bounds
+        positions[10] = vec2f(Bounds.Left, Bounds.Top);
+        positions[11] = vec2f(Bounds.Right, Bounds.Bottom);
+
+        // NaNs
+        positions[12] = vec2f(std::numeric_limits<float>::quiet_NaN(), 200.0f);
+        velocities[13] = vec2f(std::numeric_limits<float>::quiet_NaN(), 3.0f);
+        positions[13] = vec2f(-200.0f, 0.0f);
+    }
+
+    bool AreBitwiseEqual(
+        std::vector<vec2f> const & a,
+        std::vector<vec2f> const & b)
+    {
+        return a.size() == b.size()
+            && 0 == std::memcmp(a.data(), b.data(), a.size() * sizeof(vec2f));
+    }
+}
+
+TEST(PointCollisionsTests, TrimPointsForWorldBounds_Scalar)
+{
+    std::vector<vec2f> positions{ { -120.0f, 0.0f }, { 120.0f, 60.0f }, { 10.0f, -80.0f }, { 10.0f, 10.0f } };
+    std::vector<vec2f> velocities{ { -10.0f, 1.0f }, { 30.0f, 5.0f }, { 2.0f, -70.0f }, { 3.0f, 4.0f } };
+
+    TrimPointsForWorldBounds(
+        PointCollisionsImplementation::Scalar,
+        positions.data(),
+        velocities.data(),
+        positions.size(),
+        Bounds);
+
+    EXPECT_EQ(vec2f(-100.0f, 0.0f), positions[0]);
+    EXPECT_EQ(vec2f(10.0f, 1.0f), velocities[0]);
+
+    EXPECT_EQ(vec2f(100.0f, 50.0f), positions[1]);
+    EXPECT_EQ(vec2f(-20.0f, -5.0f), velocities[1]);
+
+    EXPECT_EQ(vec2f(10.0f, -50.0f), positions[2]);
+    EXPECT_EQ(vec2f(2.0f, 20.0f), velocities[2]);
+
+    EXPECT_EQ(vec2f(10.0f, 10.0f), positions[3]);
+    EXPECT_EQ(vec2f(3.0f, 4.0f), velocities[3]);
+}
+
+TEST(PointCollisionsTests, TrimPointsForWorldBounds_SSE2MatchesScalar)
+{
+    std::vector<vec2f> expectedPositions;
+    std::vector<vec2f> expectedVelocities;
+    MakePoints(expectedPositions, expectedVelocities);
+
+    std::vector<vec2f> positions = expectedPositions;
+    std::vector<vec2f> velocities = expectedVelocities;
+
+    TrimPointsForWorldBounds(
+        PointCollisionsImplementation::Scalar,
+        expectedPositions.data(),
+        expectedVelocities.data(),
+        PointCount,
+        Bounds);
+
+    TrimPointsForWorldBounds(
+        PointCollisionsImplementation::SSE2,
+        positions.data(),
+        velocities.data(),
+        PointCount,
+        Bounds);
+
+    EXPECT_TRUE(AreBitwiseEqual(expectedPositions, positions));
+    EXPECT_TRUE(AreBitwiseEqual(expectedVelocities, velocities));
+}
+
+TEST(PointCollisionsTests, FindPointsBelowSeaFloor_SSE2MatchesScalar)
+{
+    std::vector<vec2f> positions;
+    std::vector<vec2f> velocities;
+    MakePoints(positions, velocities);
+
+    std::mt19937 random(43);
+    std::uniform_real_distribution<float> floorDistribution(-150.0f, -100.0f);
+
+    std::vector<float> oceanFloorHeights;
+    for (size_t p = 0; p < PointCount; ++p)
+    {
+        oceanFloorHeights.push_back(floorDistribution(random));
+    }
+
+    // A shuffled subset of the points
+    std::vector<ElementIndex> pointIndices;
+    for (ElementIndex p = 0; p < PointCount; p += 2)
+    {
+        pointIndices.push_back(p);
+    }
+
+    std::shuffle(pointIndices.begin(), pointIndices.end(), random);
+
+    std::vector<size_t> expectedOrdinals(pointIndices.size());
+    size_t const expectedCount = FindPointsBelowSeaFloor(
+        PointCollisionsImplementation::Scalar,
+        positions.data(),
+        oceanFloorHeights.data(),
+        pointIndices.data(),
+        pointIndices.size(),
+        expectedOrdinals.data());
+
+    std::vector<size_t> ordinals(pointIndices.size());
+    size_t const count = FindPointsBelowSeaFloor(
+        PointCollisionsImplementation::SSE2,
+        positions.data(),
+        oceanFloorHeights.data(),
+        pointIndices.data(),
+        pointIndices.size(),
+        ordinals.data());
+
+    ASSERT_GT(expectedCount, 0u);
+    ASSERT_EQ(expectedCount, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(expectedOrdinals[i], ordinals[i]);
+
+        ElementIndex const pointIndex = pointIndices[ordinals[i]];
+        EXPECT_LT(positions[pointIndex].y, oceanFloorHeights[pointIndex]);
+    }
+}
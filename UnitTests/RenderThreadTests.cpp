@@ -0,0 +1,135 @@
+#include <Game/RenderThread.h>
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Render;
+
+TEST(RenderThreadTests, CommandList_ReplaysInOrder)
+{
+    RenderCommandList commandList;
+    std::vector<int> replayed;
+
+    commandList.Record([&]() { replayed.push_back(1); });
+    commandList.Record([&]() { replayed.push_back(2); });
+    commandList.Record([&]() { replayed.push_back(3); });
+
+    EXPECT_FALSE(commandList.IsEmpty());
+
+    commandList.Replay();
+
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), replayed);
+
+    commandList.Clear();
+
+    EXPECT_TRUE(commandList.IsEmpty());
+}
+
+TEST(RenderThreadTests, CommandList_CopyBlock_IsIndependentOfSource)
+{
+    RenderCommandList commandList;
+
+    std::vector<float> source{ 1.0f, 2.0f, 3.0f };
+    float const * block = commandList.CopyBlock(source.data(), source.size());
+
+    source[1] = 20.0f;
+
+    EXPECT_EQ(1.0f, block[0]);
+    EXPECT_EQ(2.0f, block[1]);
+    EXPECT_EQ(3.0f, block[2]);
+}
+
+TEST(RenderThreadTests, ReplaysOnRenderThread_WithContext)
+{
+    std::thread::id contextThreadId = std::this_thread::get_id();
+    std::thread::id const recordingThreadId = std::this_thread::get_id();
+
+    std::thread::id commandThreadId;
+    bool wasContextCurrentOnCommandThread = false;
+
+    {
+        RenderThread renderThread(
+            [&]() { contextThreadId = std::this_thread::get_id(); },
+            [&]() { contextThreadId = std::thread::id(); });
+
+        renderThread.RunSync(
+            [&]()
+            {
+                commandThreadId = std::this_thread::get_id();
+                wasContextCurrentOnCommandThread = (contextThreadId == commandThreadId);
+            });
+
+        EXPECT_NE(recordingThreadId, commandThreadId);
+        EXPECT_TRUE(wasContextCurrentOnCommandThread);
+    }
+
+    // The context is back
+    EXPECT_EQ(recordingThreadId, contextThreadId);
+}
+
+TEST(RenderThreadTests, FlushedFrames_AreReplayedInOrder)
+{
+    std::vector<int> replayed;
+
+    RenderThread renderThread([]() {}, []() {});
+
+    for (int f = 0; f < 100; ++f)
+    {
+        // Only touch shared state once the render thread is idle
+        renderThread.WaitForIdle();
+
+        std::vector<int> frameData{ f, f + 1000 };
+        int const * block = renderThread.GetRecordingCommandList().CopyBlock(frameData.data(), frameData.size());
+
+        renderThread.GetRecordingCommandList().Record(
+            [&replayed, block]()
+            {
+                replayed.push_back(block[0]);
+                replayed.push_back(block[1]);
+            });
+
+        // Scribble on the source; the block must be unaffected
+        frameData[0] = -1;
+
+        renderThread.Flush();
+    }
+
+    renderThread.WaitForIdle();
+
+    ASSERT_EQ(200u, replayed.size());
+    for (int f = 0; f < 100; ++f)
+    {
+        EXPECT_EQ(f, replayed[2 * f]);
+        EXPECT_EQ(f + 1000, replayed[2 * f + 1]);
+    }
+}
+
+TEST(RenderThreadTests, Destruction_ReplaysWhatIsRecorded)
+{
+    bool hasReplayed = false;
+
+    {
+        RenderThread renderThread([]() {}, []() {});
+
+        renderThread.GetRecordingCommandList().Record([&]() { hasReplayed = true; });
+    }
+
+    EXPECT_TRUE(hasReplayed);
+}
+
+TEST(RenderThreadTests, ReplayExceptions_AreRethrownOnRecordingThread)
+{
+    RenderThread renderThread([]() {}, []() {});
+
+    EXPECT_THROW(
+        renderThread.RunSync([]() { throw std::runtime_error("Test"); }),
+        std::runtime_error);
+
+    // The thread is still alive
+    bool hasReplayed = false;
+    renderThread.RunSync([&]() { hasReplayed = true; });
+    EXPECT_TRUE(hasReplayed);
+}
@@ -0,0 +1,125 @@
+#include <GameCore/ResourceArchive.h>
+#include <GameCore/Utils.h>
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+class ResourceArchiveTests : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        mTestDirectoryPath = std::filesystem::temp_directory_path() / "ResourceArchiveTests";
+        std::filesystem::remove_all(mTestDirectoryPath);
+
+        mDataDirectoryPath = mTestDirectoryPath / "Data";
+        std::filesystem::create_directories(mDataDirectoryPath / "Fonts");
+        std::filesystem::create_directories(mDataDirectoryPath / "Textures" / "Nested");
+
+        WriteFile(mDataDirectoryPath / "Fonts" / "font1.bff", "Font 1");
+        WriteFile(mDataDirectoryPath / "Fonts" / "font2.bff", "Font 2!");
+        WriteFile(mDataDirectoryPath / "Textures" / "textures.json", "{ \"a\": 1 }");
+        WriteFile(mDataDirectoryPath / "Textures" / "Nested" / "deep.png", "Deep");
+
+        mArchiveFilePath = mTestDirectoryPath / "Data.fsra";
+    }
+
+    void TearDown() override
+    {
+        ResourceArchive::Unmount();
+
+        std::filesystem::remove_all(mTestDirectoryPath);
+    }
+
+    static void WriteFile(
+        std::filesystem::path const & filePath,
+        std::string const & content)
+    {
+        std::ofstream file(filePath, std::ios::binary | std::ios::out);
+        file << content;
+    }
+
+    static std::string ToString(ResourceArchive::Entry const & entry)
+    {
+        return std::string(static_cast<char const *>(entry.Data), entry.Size);
+    }
+
+    std::filesystem::path mTestDirectoryPath;
+    std::filesystem::path mDataDirectoryPath;
+    std::filesystem::path mArchiveFilePath;
+};
+
+TEST_F(ResourceArchiveTests, FindsPackedFiles)
+{
+    EXPECT_EQ(4u, ResourceArchive::Build(mDataDirectoryPath, mArchiveFilePath));
+
+    auto const archive = ResourceArchive::Open(mArchiveFilePath);
+    EXPECT_EQ(4u, archive->GetEntryCount());
+
+    auto const entry = archive->Find("Fonts/font2.bff");
+    ASSERT_TRUE(!!entry);
+    EXPECT_EQ("Font 2!", ToString(*entry));
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(entry->Data) % ResourceArchive::EntryAlignment);
+
+    auto const nestedEntry = archive->Find("Textures/Nested/deep.png");
+    ASSERT_TRUE(!!nestedEntry);
+    EXPECT_EQ("Deep", ToString(*nestedEntry));
+
+    EXPECT_FALSE(!!archive->Find("Fonts/font3.bff"));
+    EXPECT_FALSE(!!archive->Find("Fonts"));
+}
+
+TEST_F(ResourceArchiveTests, ListsDirectChildrenOnly)
+{
+    ResourceArchive::Build(mDataDirectoryPath, mArchiveFilePath);
+    auto const archive = ResourceArchive::Open(mArchiveFilePath);
+
+    auto const textures = archive->List("Textures");
+    ASSERT_EQ(1u, textures.size());
+    EXPECT_EQ("Textures/textures.json", textures[0]);
+
+    EXPECT_EQ(2u, archive->List("Fonts").size());
+    EXPECT_EQ(0u, archive->List("").size());
+}
+
+TEST_F(ResourceArchiveTests, RejectsFilesThatAreNotArchives)
+{
+    WriteFile(mArchiveFilePath, "Not an archive at all");
+
+    EXPECT_THROW(ResourceArchive::Open(mArchiveFilePath), GameException);
+}
+
+TEST_F(ResourceArchiveTests, MountedArchiveStandsInForMissingLooseFiles)
+{
+    ResourceArchive::Build(mDataDirectoryPath, mArchiveFilePath);
+    ResourceArchive::Mount(ResourceArchive::Open(mArchiveFilePath), mDataDirectoryPath);
+
+    // Loose files take precedence
+    WriteFile(mDataDirectoryPath / "Fonts" / "font1.bff", "Font 1 edited");
+    EXPECT_EQ("Font 1 edited", Utils::LoadTextFile(mDataDirectoryPath / "Fonts" / "font1.bff"));
+
+    // Packed files stand in for the missing ones
+    std::filesystem::remove_all(mDataDirectoryPath / "Textures");
+    EXPECT_EQ("{ \"a\": 1 }", Utils::LoadTextFile(mDataDirectoryPath / "Textures" / "textures.json"));
+    EXPECT_TRUE(ResourceArchive::Exists(mDataDirectoryPath / "Textures"));
+    EXPECT_FALSE(ResourceArchive::Exists(mDataDirectoryPath / "Sounds"));
+
+    // Listings merge both
+    std::filesystem::remove(mDataDirectoryPath / "Fonts" / "font2.bff");
+    WriteFile(mDataDirectoryPath / "Fonts" / "font3.bff", "Font 3");
+
+    auto const fonts = ResourceArchive::ListDirectory(mDataDirectoryPath / "Fonts");
+    ASSERT_EQ(3u, fonts.size());
+    EXPECT_EQ("font1.bff", fonts[0].filename().string());
+    EXPECT_EQ("font2.bff", fonts[1].filename().string());
+    EXPECT_EQ("font3.bff", fonts[2].filename().string());
+
+    // Outside of the mount point
+    EXPECT_FALSE(!!ResourceArchive::FindMounted(mTestDirectoryPath / "Fonts" / "font2.bff"));
+}
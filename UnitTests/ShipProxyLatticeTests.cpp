@@ -0,0 +1,147 @@
+#include <Game/ShipProxyLattice.h>
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/Vectors.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Physics;
+
+namespace {
+
+    // An 8x8 grid of points, one unit apart, each connected to its right and top neighbors
+    struct Grid
+    {
+        std::vector<vec2f> PointPositions;
+        std::vector<float> PointMasses;
+        std::vector<float> PointWaterVolumeFills;
+        std::vector<std::pair<ElementIndex, ElementIndex>> SpringEndpoints;
+        std::vector<float> SpringStiffnesses;
+
+        Grid()
+        {
+            for (int x = 0; x < 8; ++x)
+            {
+                for (int y = 0; y < 8; ++y)
+                {
+                    PointPositions.emplace_back(static_cast<float>(x) - 4.0f, static_cast<float>(y));
+                    PointMasses.push_back(x < 4 ? 1.0f : 3.0f);
+                    PointWaterVolumeFills.push_back(0.5f);
+                }
+            }
+
+            for (int x = 0; x < 8; ++x)
+            {
+                for (int y = 0; y < 8; ++y)
+                {
+                    ElementIndex const pointIndex = static_cast<ElementIndex>(x * 8 + y);
+
+                    if (x < 7)
+                    {
+                        SpringEndpoints.emplace_back(pointIndex, pointIndex + 8);
+                        SpringStiffnesses.push_back(1.0f);
+                    }
+
+                    if (y < 7)
+                    {
+                        SpringEndpoints.emplace_back(pointIndex, pointIndex + 1);
+                        SpringStiffnesses.push_back(1.0f);
+                    }
+                }
+            }
+        }
+
+        ShipProxyLattice Build() const
+        {
+            return ShipProxyLattice::Build(
+                4.0f,
+                PointPositions,
+                PointMasses,
+                PointWaterVolumeFills,
+                SpringEndpoints,
+                SpringStiffnesses);
+        }
+    };
+}
+
+TEST(ShipProxyLatticeTests, AggregatesBlocks)
+{
+    Grid const grid;
+    auto const lattice = grid.Build();
+
+    ASSERT_EQ(4u, lattice.GetProxyPoints().size());
+
+    float totalMass = 0.0f;
+    for (auto const & proxyPoint : lattice.GetProxyPoints())
+    {
+        EXPECT_EQ(16u, proxyPoint.PointCount);
+        EXPECT_FLOAT_EQ(8.0f, proxyPoint.WaterCapacity);
+
+        totalMass += proxyPoint.Mass;
+    }
+
+    EXPECT_FLOAT_EQ(16.0f * 1.0f * 2.0f + 16.0f * 3.0f * 2.0f, totalMass);
+
+    // Within a block all points are equally heavy, hence the proxy point sits at the block's center
+    vec2f const & proxyPoint0Position = lattice.GetProxyPoints()[lattice.GetPointProxyPoints()[0]].RestPosition;
+    EXPECT_FLOAT_EQ(-4.0f + 1.5f, proxyPoint0Position.x);
+    EXPECT_FLOAT_EQ(1.5f, proxyPoint0Position.y);
+
+    // Two horizontal and two vertical block boundaries, each crossed by four springs
+    ASSERT_EQ(4u, lattice.GetProxySprings().size());
+    for (auto const & proxySpring : lattice.GetProxySprings())
+    {
+        EXPECT_EQ(4u, proxySpring.SpringCount);
+        EXPECT_FLOAT_EQ(4.0f, proxySpring.Stiffness);
+        EXPECT_FLOAT_EQ(4.0f, proxySpring.RestLength);
+    }
+}
+
+TEST(ShipProxyLatticeTests, ProxyPositionsAtRest)
+{
+    Grid const grid;
+    auto const lattice = grid.Build();
+
+    std::vector<vec2f> proxyPositions(lattice.GetProxyPoints().size());
+    lattice.CalculateProxyPositions(grid.PointPositions.data(), proxyPositions.data());
+
+    for (size_t pp = 0; pp < proxyPositions.size(); ++pp)
+    {
+        EXPECT_NEAR(lattice.GetProxyPoints()[pp].RestPosition.x, proxyPositions[pp].x, 0.0001f);
+        EXPECT_NEAR(lattice.GetProxyPoints()[pp].RestPosition.y, proxyPositions[pp].y, 0.0001f);
+    }
+}
+
+TEST(ShipProxyLatticeTests, ReconstructsRigidMotion)
+{
+    Grid const grid;
+    auto const lattice = grid.Build();
+
+    // Rotate and move the whole grid
+    float const angle = 0.5f;
+    vec2f const translation(10.0f, -3.0f);
+
+    std::vector<vec2f> movedPositions;
+    for (auto const & position : grid.PointPositions)
+    {
+        movedPositions.emplace_back(
+            position.x * std::cos(angle) - position.y * std::sin(angle) + translation.x,
+            position.x * std::sin(angle) + position.y * std::cos(angle) + translation.y);
+    }
+
+    std::vector<vec2f> proxyPositions(lattice.GetProxyPoints().size());
+    lattice.CalculateProxyPositions(movedPositions.data(), proxyPositions.data());
+
+    std::vector<vec2f> reconstructedPositions(movedPositions.size());
+    lattice.ReconstructPointPositions(proxyPositions.data(), reconstructedPositions.data());
+
+    for (size_t p = 0; p < movedPositions.size(); ++p)
+    {
+        EXPECT_NEAR(movedPositions[p].x, reconstructedPositions[p].x, 0.001f);
+        EXPECT_NEAR(movedPositions[p].y, reconstructedPositions[p].y, 0.001f);
+    }
+}
@@ -0,0 +1,105 @@
+#include <GameCore/SnapshotExchange.h>
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+TEST(SnapshotExchangeTests, InitialValue)
+{
+    SnapshotExchange<int> se(42);
+
+    EXPECT_EQ(42, se.GetCurrent());
+    EXPECT_EQ(0u, se.GetCurrentGeneration());
+
+    EXPECT_FALSE(se.PickUp());
+
+    EXPECT_EQ(42, se.GetCurrent());
+    EXPECT_EQ(0u, se.GetCurrentGeneration());
+}
+
+TEST(SnapshotExchangeTests, PickUp_Published)
+{
+    SnapshotExchange<int> se(0);
+
+    EXPECT_EQ(1u, se.Publish(5));
+
+    // Not visible until picked up
+    EXPECT_EQ(0, se.GetCurrent());
+
+    EXPECT_TRUE(se.PickUp());
+    EXPECT_EQ(5, se.GetCurrent());
+    EXPECT_EQ(1u, se.GetCurrentGeneration());
+
+    // Nothing new
+    EXPECT_FALSE(se.PickUp());
+    EXPECT_EQ(5, se.GetCurrent());
+    EXPECT_EQ(1u, se.GetCurrentGeneration());
+}
+
+TEST(SnapshotExchangeTests, PickUp_LatestOfMany)
+{
+    SnapshotExchange<int> se(0);
+
+    se.Publish(1);
+    se.Publish(2);
+    EXPECT_EQ(3u, se.Publish(3));
+
+    EXPECT_TRUE(se.PickUp());
+    EXPECT_EQ(3, se.GetCurrent());
+    EXPECT_EQ(3u, se.GetCurrentGeneration());
+}
+
+TEST(SnapshotExchangeTests, Publish_DoesNotTouchCurrent)
+{
+    SnapshotExchange<int> se(0);
+
+    se.Publish(1);
+    EXPECT_TRUE(se.PickUp());
+
+    for (int i = 2; i < 10; ++i)
+    {
+        se.Publish(i);
+        EXPECT_EQ(1, se.GetCurrent());
+    }
+
+    EXPECT_TRUE(se.PickUp());
+    EXPECT_EQ(9, se.GetCurrent());
+    EXPECT_EQ(9u, se.GetCurrentGeneration());
+}
+
+TEST(SnapshotExchangeTests, Concurrent_SnapshotsAreConsistent)
+{
+    struct Value
+    {
+        int A;
+        int B;
+    };
+
+    SnapshotExchange<Value> se(Value{ 0, 0 });
+
+    static constexpr int NumPublishes = 100000;
+
+    std::thread writer(
+        [&se]()
+        {
+            for (int i = 1; i <= NumPublishes; ++i)
+            {
+                se.Publish(Value{ i, -i });
+            }
+        });
+
+    uint64_t lastGeneration = 0;
+    while (lastGeneration < NumPublishes)
+    {
+        se.PickUp();
+
+        Value const & value = se.GetCurrent();
+        ASSERT_EQ(-value.A, value.B);
+        ASSERT_EQ(static_cast<uint64_t>(value.A), se.GetCurrentGeneration());
+        ASSERT_GE(se.GetCurrentGeneration(), lastGeneration);
+
+        lastGeneration = se.GetCurrentGeneration();
+    }
+
+    writer.join();
+}
@@ -0,0 +1,232 @@
+#include <Game/SpringConstraints.h>
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/Vectors.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Physics;
+
+class SpringConstraintsTests : public testing::Test
+{
+protected:
+
+    static constexpr float Dt = 0.005f;
+
+    // A single spring along x
+    void SetUp() override
+    {
+        mPositions = { vec2f(0.0f, 0.0f), vec2f(2.0f, 0.0f) };
+        mPreviousPositions = mPositions;
+        mInverseMasses = { 1.0f, 1.0f };
+        mEndpoints = { 0, 1 };
+        mRestLengths = { 1.0f };
+        mCoefficients = { 10000.0f, 0.0f };
+        mLengths = { 0.0f };
+    }
+
+    SpringConstraintsBuffers MakeBuffers()
+    {
+        return SpringConstraintsBuffers{
+            mPositions.data(),
+            mPreviousPositions.data(),
+            mInverseMasses.data(),
+            mEndpoints.data(),
+            mRestLengths.data(),
+            mCoefficients.data(),
+            mLengths.data() };
+    }
+
+    std::vector<vec2f> mPositions;
+    std::vector<vec2f> mPreviousPositions;
+    std::vector<float> mInverseMasses;
+    std::vector<ElementIndex> mEndpoints;
+    std::vector<float> mRestLengths;
+    std::vector<float> mCoefficients;
+    std::vector<float> mLengths;
+};
+
+TEST_F(SpringConstraintsTests, StretchedSpringPullsEndpointsTogetherSymmetrically)
+{
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+
+    // Length before the correction
+    EXPECT_FLOAT_EQ(2.0f, mLengths[0]);
+
+    // k*dt^2 = 0.25, w = 2 => dLambda = -0.25 / 1.5, and each endpoint moves by 1/6
+    EXPECT_NEAR(1.0f / 6.0f, mPositions[0].x, 0.0001f);
+    EXPECT_NEAR(2.0f - 1.0f / 6.0f, mPositions[1].x, 0.0001f);
+    EXPECT_FLOAT_EQ(0.0f, mPositions[0].y);
+    EXPECT_FLOAT_EQ(0.0f, mPositions[1].y);
+}
+
+TEST_F(SpringConstraintsTests, CompressedSpringPushesEndpointsApart)
+{
+    mPositions[1] = vec2f(0.5f, 0.0f);
+
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+
+    EXPECT_LT(mPositions[0].x, 0.0f);
+    EXPECT_GT(mPositions[1].x, 0.5f);
+}
+
+TEST_F(SpringConstraintsTests, StiffSpringReachesRestLength)
+{
+    mCoefficients[0] = 1.0e12f;
+
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+
+    EXPECT_NEAR(1.0f, (mPositions[1] - mPositions[0]).length(), 0.0001f);
+}
+
+TEST_F(SpringConstraintsTests, DeletedSpringDoesNotMoveEndpoints)
+{
+    mCoefficients = { 0.0f, 0.0f };
+
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+
+    EXPECT_EQ(vec2f(0.0f, 0.0f), mPositions[0]);
+    EXPECT_EQ(vec2f(2.0f, 0.0f), mPositions[1]);
+}
+
+TEST_F(SpringConstraintsTests, EndpointWithZeroInverseMassDoesNotMove)
+{
+    mInverseMasses[0] = 0.0f;
+    mCoefficients[0] = 1.0e12f;
+
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+
+    EXPECT_EQ(vec2f(0.0f, 0.0f), mPositions[0]);
+    EXPECT_NEAR(1.0f, mPositions[1].x, 0.0001f);
+}
+
+TEST_F(SpringConstraintsTests, DampingResistsRelativeMotion)
+{
+    // At rest length, but with B having moved away from A during the step
+    mPositions[1] = vec2f(1.0f, 0.0f);
+    mPreviousPositions[1] = vec2f(0.9f, 0.0f);
+    mCoefficients = { 0.0f, 100.0f };
+
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+
+    EXPECT_GT(mPositions[0].x, 0.0f);
+    EXPECT_LT(mPositions[1].x, 1.0f);
+}
+
+TEST_F(SpringConstraintsTests, IndexedMatchesRange)
+{
+    std::vector<vec2f> const initialPositions = mPositions;
+
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+    std::vector<vec2f> const rangePositions = mPositions;
+
+    mPositions = initialPositions;
+    ElementIndex const springIndices[] = { 0 };
+    SolveIndexedSpringConstraints(MakeBuffers(), Dt, springIndices, 1);
+
+    EXPECT_EQ(rangePositions[0], mPositions[0]);
+    EXPECT_EQ(rangePositions[1], mPositions[1]);
+}
+
+TEST_F(SpringConstraintsTests, SingleSpringChainMatchesSpring)
+{
+    std::vector<vec2f> const initialPositions = mPositions;
+
+    SolveSpringConstraints(MakeBuffers(), Dt, 0, 1);
+    std::vector<vec2f> const springPositions = mPositions;
+
+    mPositions = initialPositions;
+    ElementIndex const chainSpringIndices[] = { 0 };
+    ElementIndex const chainPointIndices[] = { 0, 1 };
+    float workBuffer[4];
+    SolveSpringConstraintChain(MakeBuffers(), Dt, chainSpringIndices, chainPointIndices, 1, workBuffer);
+
+    EXPECT_NEAR(springPositions[0].x, mPositions[0].x, 0.00001f);
+    EXPECT_NEAR(springPositions[1].x, mPositions[1].x, 0.00001f);
+    EXPECT_FLOAT_EQ(2.0f, mLengths[0]);
+}
+
+TEST_F(SpringConstraintsTests, StiffStretchedChainReachesRestLengthsAtOnce)
+{
+    // Ten springs along x, each stretched to twice its rest length, alternating
+    // the order of their endpoints; the first point is pinned
+    static constexpr size_t SpringCount = 10;
+
+    mPositions.clear();
+    mInverseMasses.clear();
+    for (size_t p = 0; p <= SpringCount; ++p)
+    {
+        mPositions.emplace_back(static_cast<float>(p) * 2.0f, 0.0f);
+        mInverseMasses.push_back(p == 0 ? 0.0f : 1.0f);
+    }
+
+    mPreviousPositions = mPositions;
+
+    mEndpoints.clear();
+    mRestLengths.clear();
+    mCoefficients.clear();
+    mLengths.clear();
+
+    std::vector<ElementIndex> chainSpringIndices;
+    std::vector<ElementIndex> chainPointIndices;
+    for (size_t s = 0; s < SpringCount; ++s)
+    {
+        if (s % 2 == 0)
+        {
+            mEndpoints.push_back(static_cast<ElementIndex>(s));
+            mEndpoints.push_back(static_cast<ElementIndex>(s + 1));
+        }
+        else
+        {
+            mEndpoints.push_back(static_cast<ElementIndex>(s + 1));
+            mEndpoints.push_back(static_cast<ElementIndex>(s));
+        }
+
+        mRestLengths.push_back(1.0f);
+        mCoefficients.push_back(1.0e12f);
+        mCoefficients.push_back(0.0f);
+        mLengths.push_back(0.0f);
+
+        chainSpringIndices.push_back(static_cast<ElementIndex>(s));
+    }
+
+    for (size_t p = 0; p <= SpringCount; ++p)
+    {
+        chainPointIndices.push_back(static_cast<ElementIndex>(p));
+    }
+
+    std::vector<float> workBuffer(SpringCount * 4);
+    SolveSpringConstraintChain(MakeBuffers(), Dt, chainSpringIndices.data(), chainPointIndices.data(), SpringCount, workBuffer.data());
+
+    EXPECT_EQ(vec2f(0.0f, 0.0f), mPositions[0]);
+    for (size_t p = 1; p <= SpringCount; ++p)
+    {
+        EXPECT_NEAR(static_cast<float>(p), mPositions[p].x, 0.001f);
+        EXPECT_FLOAT_EQ(0.0f, mPositions[p].y);
+    }
+
+    EXPECT_FLOAT_EQ(2.0f, mLengths[SpringCount - 1]);
+}
+
+TEST_F(SpringConstraintsTests, DeletedSpringDecouplesChain)
+{
+    // Three points, the second spring deleted
+    mPositions = { vec2f(0.0f, 0.0f), vec2f(2.0f, 0.0f), vec2f(4.0f, 0.0f) };
+    mPreviousPositions = mPositions;
+    mInverseMasses = { 1.0f, 1.0f, 1.0f };
+    mEndpoints = { 0, 1, 1, 2 };
+    mRestLengths = { 1.0f, 1.0f };
+    mCoefficients = { 10000.0f, 0.0f, 0.0f, 0.0f };
+    mLengths = { 0.0f, 0.0f };
+
+    ElementIndex const chainSpringIndices[] = { 0, 1 };
+    ElementIndex const chainPointIndices[] = { 0, 1, 2 };
+    float workBuffer[8];
+    SolveSpringConstraintChain(MakeBuffers(), Dt, chainSpringIndices, chainPointIndices, 2, workBuffer);
+
+    EXPECT_NEAR(1.0f / 6.0f, mPositions[0].x, 0.0001f);
+    EXPECT_NEAR(2.0f - 1.0f / 6.0f, mPositions[1].x, 0.0001f);
+    EXPECT_EQ(vec2f(4.0f, 0.0f), mPositions[2]);
+}
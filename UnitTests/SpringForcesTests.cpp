@@ -0,0 +1,231 @@
+#include <Game/SpringForces.h>
+
+#include <GameCore/GameTypes.h>
+#include <GameCore/Vectors.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Physics;
+
+class SpringForcesTests : public testing::TestWithParam<SpringForcesImplementation>
+{
+protected:
+
+    static constexpr size_t PointCount = 100;
+
+    // Not a multiple of any vectorization width, so to exercise the remainders
+    static constexpr size_t SpringCount = 1003;
+
+    void SetUp() override
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> positionDistribution(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> velocityDistribution(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> coefficientDistribution(0.0f, 2.0f);
+        std::uniform_int_distribution<ElementIndex> pointDistribution(0, PointCount - 1);
+
+        for (size_t p = 0; p < PointCount; ++p)
+        {
+            mPositions.emplace_back(positionDistribution(random), positionDistribution(random));
+            mVelocities.emplace_back(velocityDistribution(random), velocityDistribution(random));
+        }
+
+        for (size_t s = 0; s < SpringCount; ++s)
+        {
+            ElementIndex const pointAIndex = pointDistribution(random);
+            ElementIndex pointBIndex = pointDistribution(random);
+            if (s % 97 == 0)
+            {
+                // Zero-length spring
+                pointBIndex = pointAIndex;
+            }
+
+            mEndpoints.push_back(pointAIndex);
+            mEndpoints.push_back(pointBIndex);
+
+            mRestLengths.push_back(coefficientDistribution(random));
+
+            if (s % 31 == 0)
+            {
+                // Deleted spring
+                mCoefficients.push_back(0.0f);
+                mCoefficients.push_back(0.0f);
+            }
+            else
+            {
+                mCoefficients.push_back(coefficientDistribution(random));
+                mCoefficients.push_back(coefficientDistribution(random));
+            }
+        }
+    }
+
+    SpringForcesBuffers MakeBuffers(std::vector<vec2f> & forces) const
+    {
+        return SpringForcesBuffers{
+            mPositions.data(),
+            mVelocities.data(),
+            forces.data(),
+            mEndpoints.data(),
+            mRestLengths.data(),
+            mCoefficients.data() };
+    }
+
+    static void ExpectForcesNear(
+        std::vector<vec2f> const & expected,
+        std::vector<vec2f> const & actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+
+        for (size_t p = 0; p < expected.size(); ++p)
+        {
+            float const tolerance = 1e-4f * std::max(1.0f, expected[p].length());
+
+            EXPECT_NEAR(expected[p].x, actual[p].x, tolerance) << "point " << p;
+            EXPECT_NEAR(expected[p].y, actual[p].y, tolerance) << "point " << p;
+        }
+    }
+
+    std::vector<vec2f> mPositions;
+    std::vector<vec2f> mVelocities;
+    std::vector<ElementIndex> mEndpoints;
+    std::vector<float> mRestLengths;
+    std::vector<float> mCoefficients;
+};
+
+TEST_P(SpringForcesTests, Range_MatchesScalar)
+{
+    std::vector<vec2f> expectedForces(PointCount, vec2f::zero());
+    CalculateSpringForces(
+        SpringForcesImplementation::Scalar,
+        MakeBuffers(expectedForces),
+        0,
+        static_cast<ElementIndex>(SpringCount));
+
+    std::vector<vec2f> actualForces(PointCount, vec2f::zero());
+    CalculateSpringForces(
+        GetParam(),
+        MakeBuffers(actualForces),
+        0,
+        static_cast<ElementIndex>(SpringCount));
+
+    ExpectForcesNear(expectedForces, actualForces);
+}
+
+TEST_P(SpringForcesTests, SubRange_MatchesScalar)
+{
+    std::vector<vec2f> expectedForces(PointCount, vec2f::zero());
+    CalculateSpringForces(
+        SpringForcesImplementation::Scalar,
+        MakeBuffers(expectedForces),
+        5,
+        18);
+
+    std::vector<vec2f> actualForces(PointCount, vec2f::zero());
+    CalculateSpringForces(
+        GetParam(),
+        MakeBuffers(actualForces),
+        5,
+        18);
+
+    ExpectForcesNear(expectedForces, actualForces);
+}
+
+TEST_P(SpringForcesTests, List_MatchesScalar)
+{
+    std::vector<ElementIndex> springIndices;
+    for (ElementIndex s = 0; s < SpringCount; s += 3)
+        springIndices.push_back(s);
+
+    std::vector<vec2f> expectedForces(PointCount, vec2f::zero());
+    CalculateIndexedSpringForces(
+        SpringForcesImplementation::Scalar,
+        MakeBuffers(expectedForces),
+        springIndices.data(),
+        springIndices.size());
+
+    std::vector<vec2f> actualForces(PointCount, vec2f::zero());
+    CalculateIndexedSpringForces(
+        GetParam(),
+        MakeBuffers(actualForces),
+        springIndices.data(),
+        springIndices.size());
+
+    ExpectForcesNear(expectedForces, actualForces);
+}
+
+TEST_P(SpringForcesTests, StoresSpringLengths)
+{
+    std::vector<ElementIndex> springIndices;
+    for (ElementIndex s = 0; s < SpringCount; s += 2)
+        springIndices.push_back(s);
+
+    std::vector<vec2f> forces(PointCount, vec2f::zero());
+    std::vector<float> lengths(SpringCount, -1.0f);
+
+    SpringForcesBuffers buffers = MakeBuffers(forces);
+    buffers.SpringLengths = lengths.data();
+
+    CalculateIndexedSpringForces(
+        GetParam(),
+        buffers,
+        springIndices.data(),
+        springIndices.size());
+
+    for (ElementIndex s = 0; s < SpringCount; ++s)
+    {
+        if (s % 2 == 0)
+        {
+            float const expectedLength = (mPositions[mEndpoints[s * 2 + 1]] - mPositions[mEndpoints[s * 2]]).length();
+            EXPECT_NEAR(expectedLength, lengths[s], 1e-4f) << "spring " << s;
+        }
+        else
+        {
+            // Not visited
+            EXPECT_EQ(-1.0f, lengths[s]) << "spring " << s;
+        }
+    }
+}
+
+TEST_P(SpringForcesTests, SingleSpring)
+{
+    // Spring along x, stretched by 1 and moving apart at 2
+    std::vector<vec2f> positions{ vec2f(0.0f, 0.0f), vec2f(3.0f, 0.0f) };
+    std::vector<vec2f> velocities{ vec2f(0.0f, 0.0f), vec2f(2.0f, 0.0f) };
+    std::vector<ElementIndex> endpoints{ 0, 1 };
+    std::vector<float> restLengths{ 2.0f };
+    std::vector<float> coefficients{ 10.0f, 0.5f };
+    std::vector<vec2f> forces(2, vec2f::zero());
+
+    CalculateSpringForces(
+        GetParam(),
+        SpringForcesBuffers{ positions.data(), velocities.data(), forces.data(), endpoints.data(), restLengths.data(), coefficients.data() },
+        0,
+        1);
+
+    EXPECT_FLOAT_EQ(11.0f, forces[0].x);
+    EXPECT_FLOAT_EQ(0.0f, forces[0].y);
+    EXPECT_FLOAT_EQ(-11.0f, forces[1].x);
+    EXPECT_FLOAT_EQ(0.0f, forces[1].y);
+}
+
+static std::vector<SpringForcesImplementation> GetSupportedImplementations()
+{
+    std::vector<SpringForcesImplementation> implementations{ SpringForcesImplementation::Scalar };
+
+    auto const best = GetBestSpringForcesImplementation();
+    if (best == SpringForcesImplementation::SSE2 || best == SpringForcesImplementation::AVX2)
+        implementations.push_back(SpringForcesImplementation::SSE2);
+    if (best == SpringForcesImplementation::AVX2)
+        implementations.push_back(SpringForcesImplementation::AVX2);
+
+    return implementations;
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SpringForcesTests,
+    SpringForcesTests,
+    ::testing::ValuesIn(GetSupportedImplementations()));
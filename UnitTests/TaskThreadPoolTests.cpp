@@ -0,0 +1,356 @@
+#include <GameCore/TaskThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TaskThreadPoolTests, RunsAllTasks)
+{
+    TaskThreadPool pool(4);
+
+    EXPECT_EQ(4u, pool.GetParallelism());
+
+    std::vector<int> results(100, 0);
+
+    std::vector<TaskThreadPool::Task> tasks;
+    for (size_t t = 0; t < results.size(); ++t)
+    {
+        tasks.emplace_back(
+            [&results, t]()
+            {
+                results[t] = static_cast<int>(t) * 2;
+            });
+    }
+
+    pool.Run(tasks);
+
+    for (size_t t = 0; t < results.size(); ++t)
+    {
+        EXPECT_EQ(static_cast<int>(t) * 2, results[t]);
+    }
+}
+
+TEST(TaskThreadPoolTests, RunsConsecutiveBatches)
+{
+    TaskThreadPool pool(3);
+
+    std::atomic<int> counter(0);
+
+    std::vector<TaskThreadPool::Task> tasks;
+    for (int t = 0; t < 7; ++t)
+    {
+        tasks.emplace_back(
+            [&counter]()
+            {
+                ++counter;
+            });
+    }
+
+    for (int b = 0; b < 500; ++b)
+    {
+        pool.Run(tasks);
+
+        EXPECT_EQ((b + 1) * 7, counter.load());
+    }
+}
+
+TEST(TaskThreadPoolTests, SingleThreadedPool)
+{
+    TaskThreadPool pool(1);
+
+    EXPECT_EQ(1u, pool.GetParallelism());
+
+    int counter = 0;
+
+    std::vector<TaskThreadPool::Task> tasks;
+    for (int t = 0; t < 5; ++t)
+    {
+        tasks.emplace_back(
+            [&counter]()
+            {
+                ++counter;
+            });
+    }
+
+    pool.Run(tasks);
+
+    EXPECT_EQ(5, counter);
+}
+
+TEST(TaskThreadPoolTests, NestedBatchesRunInline)
+{
+    TaskThreadPool pool(4);
+
+    std::atomic<int> counter(0);
+
+    std::vector<TaskThreadPool::Task> innerTasks;
+    for (int t = 0; t < 3; ++t)
+    {
+        innerTasks.emplace_back(
+            [&counter]()
+            {
+                ++counter;
+            });
+    }
+
+    std::vector<TaskThreadPool::Task> outerTasks;
+    for (int t = 0; t < 4; ++t)
+    {
+        outerTasks.emplace_back(
+            [&pool, &innerTasks]()
+            {
+                pool.Run(innerTasks);
+            });
+    }
+
+    pool.Run(outerTasks);
+
+    EXPECT_EQ(12, counter.load());
+}
+
+TEST(TaskThreadPoolTests, PropagatesExceptions)
+{
+    TaskThreadPool pool(4);
+
+    std::atomic<int> counter(0);
+
+    std::vector<TaskThreadPool::Task> tasks;
+    for (int t = 0; t < 8; ++t)
+    {
+        tasks.emplace_back(
+            [&counter, t]()
+            {
+                ++counter;
+
+                if (t == 3)
+                    throw std::runtime_error("Test");
+            });
+    }
+
+    EXPECT_THROW(pool.Run(tasks), std::runtime_error);
+
+    // All tasks ran nonetheless
+    EXPECT_EQ(8, counter.load());
+
+    // The pool is still usable
+    tasks.clear();
+    for (int t = 0; t < 8; ++t)
+    {
+        tasks.emplace_back(
+            [&counter]()
+            {
+                ++counter;
+            });
+    }
+
+    pool.Run(tasks);
+    EXPECT_EQ(16, counter.load());
+}
+
+TEST(TaskThreadPoolTests, ParallelForCoversRangeOnce_Dynamic)
+{
+    TaskThreadPool pool(4);
+
+    std::vector<std::atomic<int>> visits(1003);
+    for (auto & v : visits)
+        v = 0;
+
+    pool.ParallelFor(
+        2,
+        visits.size(),
+        10,
+        [&visits](size_t begin, size_t end)
+        {
+            EXPECT_LE(end - begin, 10u);
+
+            for (size_t i = begin; i < end; ++i)
+                ++visits[i];
+        });
+
+    EXPECT_EQ(0, visits[0].load());
+    EXPECT_EQ(0, visits[1].load());
+    for (size_t i = 2; i < visits.size(); ++i)
+    {
+        EXPECT_EQ(1, visits[i].load());
+    }
+}
+
+TEST(TaskThreadPoolTests, ParallelForCoversRangeOnce_Static)
+{
+    TaskThreadPool pool(4);
+
+    std::vector<std::atomic<int>> visits(1003);
+    for (auto & v : visits)
+        v = 0;
+
+    std::atomic<int> callCount(0);
+
+    pool.ParallelFor(
+        0,
+        visits.size(),
+        10,
+        [&](size_t begin, size_t end)
+        {
+            ++callCount;
+
+            // Parts start at multiples of the grain
+            EXPECT_EQ(0u, begin % 10);
+
+            for (size_t i = begin; i < end; ++i)
+                ++visits[i];
+        },
+        TaskThreadPool::Partitioning::Static);
+
+    // One part per thread
+    EXPECT_EQ(4, callCount.load());
+
+    for (auto const & v : visits)
+    {
+        EXPECT_EQ(1, v.load());
+    }
+}
+
+TEST(TaskThreadPoolTests, ParallelForStaticPartsAreDeterministic)
+{
+    TaskThreadPool pool(3);
+
+    auto const getParts = [&pool]()
+    {
+        std::mutex partsMutex;
+        std::vector<std::pair<size_t, size_t>> parts;
+
+        pool.ParallelFor(
+            5,
+            777,
+            16,
+            [&](size_t begin, size_t end)
+            {
+                std::lock_guard<std::mutex> lock(partsMutex);
+                parts.emplace_back(begin, end);
+            },
+            TaskThreadPool::Partitioning::Static);
+
+        std::sort(parts.begin(), parts.end());
+        return parts;
+    };
+
+    auto const parts = getParts();
+
+    ASSERT_EQ(3u, parts.size());
+    EXPECT_EQ(5u, parts.front().first);
+    EXPECT_EQ(777u, parts.back().second);
+
+    for (int r = 0; r < 50; ++r)
+    {
+        EXPECT_EQ(parts, getParts());
+    }
+}
+
+TEST(TaskThreadPoolTests, ParallelForSmallRangesRunInline)
+{
+    TaskThreadPool pool(4);
+
+    std::vector<std::pair<size_t, size_t>> parts;
+
+    pool.ParallelFor(
+        3,
+        10,
+        100,
+        [&parts](size_t begin, size_t end)
+        {
+            parts.emplace_back(begin, end);
+        });
+
+    ASSERT_EQ(1u, parts.size());
+    EXPECT_EQ(3u, parts[0].first);
+    EXPECT_EQ(10u, parts[0].second);
+
+    // Empty range
+    pool.ParallelFor(
+        10,
+        10,
+        1,
+        [&parts](size_t begin, size_t end)
+        {
+            parts.emplace_back(begin, end);
+        });
+
+    EXPECT_EQ(1u, parts.size());
+}
+
+TEST(TaskThreadPoolTests, TaskGroupRunsAllTasks)
+{
+    TaskThreadPool pool(4);
+
+    std::atomic<int> counter(0);
+
+    TaskThreadPool::TaskGroup group(pool);
+
+    for (int t = 0; t < 10; ++t)
+    {
+        group.Add(
+            [&counter]()
+            {
+                ++counter;
+            });
+    }
+
+    group.Wait();
+
+    EXPECT_EQ(10, counter.load());
+
+    // Reusable
+    group.Add(
+        [&counter]()
+        {
+            counter += 100;
+        });
+
+    group.Wait();
+
+    EXPECT_EQ(110, counter.load());
+}
+
+TEST(TaskThreadPoolTests, ChangesParallelism)
+{
+    TaskThreadPool pool(2);
+
+    std::atomic<int> counter(0);
+
+    std::vector<TaskThreadPool::Task> tasks;
+    for (int t = 0; t < 16; ++t)
+    {
+        tasks.emplace_back(
+            [&counter]()
+            {
+                ++counter;
+            });
+    }
+
+    pool.Run(tasks);
+    EXPECT_EQ(16, counter.load());
+
+    pool.SetParallelism(5);
+    EXPECT_EQ(5u, pool.GetParallelism());
+
+    pool.Run(tasks);
+    EXPECT_EQ(32, counter.load());
+
+    pool.SetParallelism(1);
+    EXPECT_EQ(1u, pool.GetParallelism());
+
+    pool.Run(tasks);
+    EXPECT_EQ(48, counter.load());
+
+    // Zero is the default
+    pool.SetParallelism(0);
+    EXPECT_EQ(TaskThreadPool::CalculateDefaultParallelism(), pool.GetParallelism());
+
+    pool.Run(tasks);
+    EXPECT_EQ(64, counter.load());
+}
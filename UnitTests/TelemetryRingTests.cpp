@@ -0,0 +1,128 @@
+#include <GameCore/SysSpecifics.h>
+#include <GameCore/TelemetryRing.h>
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+struct AlignedMemory
+{
+    explicit AlignedMemory(size_t byteSize)
+        : Memory(aligned_alloc(64, byteSize))
+    {}
+
+    ~AlignedMemory()
+    {
+        aligned_free(Memory);
+    }
+
+    void * const Memory;
+};
+
+TelemetryRecord MakeRecord(std::uint64_t frameIndex)
+{
+    TelemetryRecord record;
+    std::memset(&record, 0, sizeof(record));
+
+    record.FrameIndex = frameIndex;
+    record.UpdateMillis = static_cast<float>(frameIndex) * 0.5f;
+    record.PointCount = static_cast<std::uint32_t>(frameIndex * 10);
+    record.CpuMemoryBytes = frameIndex * 1000;
+
+    return record;
+}
+
+}
+
+TEST(TelemetryRingTests, Layout)
+{
+    // Offsets within the record, which is at 8 in its slot
+    EXPECT_EQ(0u, offsetof(TelemetryRecord, FrameIndex));
+    EXPECT_EQ(32u, offsetof(TelemetryRecord, PhaseMillis));
+    EXPECT_EQ(128u, offsetof(TelemetryRecord, GpuMemoryBytes));
+
+    AlignedMemory memory(TelemetryRing::CalculateByteSize(4));
+    TelemetryRing ring(memory.Memory, 4);
+
+    std::uint32_t header[4];
+    std::memcpy(header, memory.Memory, sizeof(header));
+
+    EXPECT_EQ(0x4D545346u, header[0]);
+    EXPECT_EQ(1u, header[1]);
+    EXPECT_EQ(192u, header[2]);
+    EXPECT_EQ(4u, header[3]);
+}
+
+TEST(TelemetryRingTests, ReadLatest_NoneYet)
+{
+    AlignedMemory memory(TelemetryRing::CalculateByteSize(4));
+    TelemetryRing ring(memory.Memory, 4);
+
+    TelemetryRecord record;
+    EXPECT_FALSE(TelemetryRing::ReadLatest(memory.Memory, record));
+}
+
+TEST(TelemetryRingTests, ReadLatest_ReturnsLastWritten)
+{
+    AlignedMemory memory(TelemetryRing::CalculateByteSize(4));
+    TelemetryRing ring(memory.Memory, 4);
+
+    TelemetryRecord record;
+
+    ring.Write(MakeRecord(0));
+    ASSERT_TRUE(TelemetryRing::ReadLatest(memory.Memory, record));
+    EXPECT_EQ(0u, record.FrameIndex);
+
+    // Wrap around a few times
+    for (std::uint64_t f = 1; f <= 10; ++f)
+    {
+        ring.Write(MakeRecord(f));
+    }
+
+    ASSERT_TRUE(TelemetryRing::ReadLatest(memory.Memory, record));
+    EXPECT_EQ(10u, record.FrameIndex);
+    EXPECT_EQ(5.0f, record.UpdateMillis);
+    EXPECT_EQ(100u, record.PointCount);
+    EXPECT_EQ(10000u, record.CpuMemoryBytes);
+}
+
+TEST(TelemetryRingTests, ReadLatest_RejectsRecordBeingWritten)
+{
+    AlignedMemory memory(TelemetryRing::CalculateByteSize(4));
+    TelemetryRing ring(memory.Memory, 4);
+
+    ring.Write(MakeRecord(0));
+    ring.Write(MakeRecord(1));
+
+    // Pretend the writer has started overwriting slot 1 with record #5
+    std::uint64_t const sequence = 2 * 5 + 1;
+    std::memcpy(
+        static_cast<std::uint8_t *>(memory.Memory) + TelemetryRing::HeaderSize + 1 * TelemetryRing::RecordStride,
+        &sequence,
+        sizeof(sequence));
+
+    TelemetryRecord record;
+    EXPECT_FALSE(TelemetryRing::ReadLatest(memory.Memory, record));
+}
+
+TEST(TelemetryRingTests, ReadLatest_RejectsOtherMemory)
+{
+    AlignedMemory memory(TelemetryRing::CalculateByteSize(4));
+    std::memset(memory.Memory, 0xab, TelemetryRing::CalculateByteSize(4));
+
+    TelemetryRecord record;
+    EXPECT_FALSE(TelemetryRing::ReadLatest(memory.Memory, record));
+}
+
+TEST(TelemetryRingTests, Shared)
+{
+    auto ring = TelemetryRing::CreateShared("FloatingSandboxTelemetryTest", 8);
+
+    ring->Write(MakeRecord(42));
+
+    // Not much we can do from here, as the shared memory is only readable by name
+    SUCCEED();
+}
@@ -87,4 +87,190 @@ TEST(TextureAtlasTests, RoundsAtlasSize)
     EXPECT_EQ(512, atlasSpecification.AtlasSize.Width);
     EXPECT_EQ(256, atlasSpecification.AtlasSize.Height);
 }
+
+TEST(TextureAtlasTests, SerializeRoundTrip)
+{
+    std::vector<TextureAtlasFrameMetadata> frames{
+        {
+            vec2f(0.0f, 0.0f),
+            vec2f(0.5f, 1.0f),
+            0,
+            0,
+            TextureFrameMetadata(ImageSize(2, 2), 4.0f, 4.0f, false, 2.0f, 1.0f, TextureFrameId(TextureGroupType::RcBomb, 0))
+        },
+        {
+            vec2f(0.5f, 0.0f),
+            vec2f(1.0f, 1.0f),
+            2,
+            0,
+            TextureFrameMetadata(ImageSize(2, 2), 1.5f, 3.0f, true, 0.75f, 0.5f, TextureFrameId(TextureGroupType::RcBomb, 1))
+        }
+    };
+
+    auto atlasImage = std::make_unique<rgbaColor[]>(4 * 2);
+    for (int i = 0; i < 4 * 2; ++i)
+        atlasImage[i] = rgbaColor(static_cast<uint8_t>(i), static_cast<uint8_t>(i * 2), static_cast<uint8_t>(i * 3), 255);
+
+    TextureAtlas atlas(
+        TextureAtlasMetadata(frames),
+        RgbaImageData(ImageSize(4, 2), std::move(atlasImage)));
+
+    auto const filePath = std::filesystem::temp_directory_path() / "TextureAtlasTests_SerializeRoundTrip.bin";
+    atlas.Serialize(filePath);
+    TextureAtlas const loadedAtlas = TextureAtlas::Deserialize(filePath);
+    std::filesystem::remove(filePath);
+
+    EXPECT_EQ(ImageSize(4, 2), loadedAtlas.AtlasData.Size);
+    for (int i = 0; i < 4 * 2; ++i)
+        EXPECT_EQ(atlas.AtlasData.Data[i], loadedAtlas.AtlasData.Data[i]);
+
+    ASSERT_EQ(2, loadedAtlas.Metadata.GetFrameMetadata().size());
+
+    auto const & frame1 = loadedAtlas.Metadata.GetFrameMetadata(TextureGroupType::RcBomb, 1);
+    EXPECT_EQ(vec2f(0.5f, 0.0f), frame1.TextureCoordinatesBottomLeft);
+    EXPECT_EQ(vec2f(1.0f, 1.0f), frame1.TextureCoordinatesTopRight);
+    EXPECT_EQ(2, frame1.FrameLeftX);
+    EXPECT_EQ(0, frame1.FrameBottomY);
+    EXPECT_EQ(ImageSize(2, 2), frame1.FrameMetadata.Size);
+    EXPECT_EQ(1.5f, frame1.FrameMetadata.WorldWidth);
+    EXPECT_EQ(3.0f, frame1.FrameMetadata.WorldHeight);
+    EXPECT_TRUE(frame1.FrameMetadata.HasOwnAmbientLight);
+    EXPECT_EQ(0.75f, frame1.FrameMetadata.AnchorWorldX);
+    EXPECT_EQ(0.5f, frame1.FrameMetadata.AnchorWorldY);
+    EXPECT_EQ(TextureFrameId(TextureGroupType::RcBomb, 1), frame1.FrameMetadata.FrameId);
+}
+
+TEST(TextureAtlasTests, Skyline_DoesNotOverlap)
+{
+    std::vector<TextureAtlasBuilder::TextureInfo> textureInfos{
+        { {TextureGroupType::Cloud, 0}, {100, 30} },
+        { {TextureGroupType::Cloud, 1}, {17, 90} },
+        { {TextureGroupType::Cloud, 2}, {64, 64} },
+        { {TextureGroupType::Cloud, 3}, {33, 12} },
+        { {TextureGroupType::Cloud, 4}, {200, 8} },
+        { {TextureGroupType::Cloud, 5}, {50, 50} },
+        { {TextureGroupType::Cloud, 6}, {5, 70} },
+        { {TextureGroupType::Cloud, 7}, {41, 41} }
+    };
+
+    auto atlasSpecification = TextureAtlasBuilder::BuildSkylineAtlasSpecification(
+        textureInfos,
+        TextureAtlasBuilder::AtlasOptions(false, 0));
+
+    ASSERT_EQ(textureInfos.size(), atlasSpecification.TexturePositions.size());
+
+    auto const getSize = [&textureInfos](TextureFrameId const & frameId)
+    {
+        return std::find_if(
+            textureInfos.cbegin(),
+            textureInfos.cend(),
+            [&frameId](auto const & ti) { return ti.FrameId == frameId; })->Size;
+    };
+
+    for (size_t i = 0; i < atlasSpecification.TexturePositions.size(); ++i)
+    {
+        auto const & a = atlasSpecification.TexturePositions[i];
+        auto const aSize = getSize(a.FrameId);
+
+        EXPECT_GE(a.FrameLeftX, 0);
+        EXPECT_GE(a.FrameBottomY, 0);
+        EXPECT_LE(a.FrameLeftX + aSize.Width, atlasSpecification.AtlasSize.Width);
+        EXPECT_LE(a.FrameBottomY + aSize.Height, atlasSpecification.AtlasSize.Height);
+
+        for (size_t j = i + 1; j < atlasSpecification.TexturePositions.size(); ++j)
+        {
+            auto const & b = atlasSpecification.TexturePositions[j];
+            auto const bSize = getSize(b.FrameId);
+
+            EXPECT_TRUE(
+                a.FrameLeftX + aSize.Width <= b.FrameLeftX
+                || b.FrameLeftX + bSize.Width <= a.FrameLeftX
+                || a.FrameBottomY + aSize.Height <= b.FrameBottomY
+                || b.FrameBottomY + bSize.Height <= a.FrameBottomY);
+        }
+    }
+}
+
+TEST(TextureAtlasTests, Skyline_NonPowerOfTwoSize)
+{
+    std::vector<TextureAtlasBuilder::TextureInfo> textureInfos{
+        { {TextureGroupType::Cloud, 0}, {100, 100} },
+        { {TextureGroupType::Cloud, 1}, {100, 100} },
+        { {TextureGroupType::Cloud, 2}, {100, 100} }
+    };
+
+    auto atlasSpecification = TextureAtlasBuilder::BuildSkylineAtlasSpecification(
+        textureInfos,
+        TextureAtlasBuilder::AtlasOptions(false, 0));
+
+    // No waste at all
+    EXPECT_EQ(3 * 100 * 100, atlasSpecification.AtlasSize.Width * atlasSpecification.AtlasSize.Height);
+}
+
+TEST(TextureAtlasTests, Skyline_Padding)
+{
+    std::vector<TextureAtlasBuilder::TextureInfo> textureInfos{
+        { {TextureGroupType::Cloud, 0}, {64, 64} },
+        { {TextureGroupType::Cloud, 1}, {64, 64} }
+    };
+
+    auto atlasSpecification = TextureAtlasBuilder::BuildSkylineAtlasSpecification(
+        textureInfos,
+        TextureAtlasBuilder::AtlasOptions(false, 2));
+
+    EXPECT_EQ(64, atlasSpecification.AtlasSize.Width);
+    EXPECT_EQ(64 + 2 + 64, atlasSpecification.AtlasSize.Height);
+
+    ASSERT_EQ(2, atlasSpecification.TexturePositions.size());
+    EXPECT_EQ(0, atlasSpecification.TexturePositions[0].FrameBottomY);
+    EXPECT_EQ(0, atlasSpecification.TexturePositions[1].FrameLeftX);
+    EXPECT_EQ(64 + 2, atlasSpecification.TexturePositions[1].FrameBottomY);
+}
+
+TEST(TextureAtlasTests, Skyline_NoLargerThanShelf)
+{
+    std::vector<TextureAtlasBuilder::TextureInfo> textureInfos{
+        { {TextureGroupType::Cloud, 0}, {16, 128} },
+        { {TextureGroupType::Cloud, 1}, {64, 32} },
+        { {TextureGroupType::Cloud, 2}, {64, 64} }
+    };
+
+    auto shelfSpecification = TextureAtlasBuilder::BuildAtlasSpecification(textureInfos);
+
+    EXPECT_EQ(256, shelfSpecification.AtlasSize.Width);
+    EXPECT_EQ(128, shelfSpecification.AtlasSize.Height);
+
+    auto bestSpecification = TextureAtlasBuilder::BuildBestAtlasSpecification(
+        textureInfos,
+        TextureAtlasBuilder::AtlasOptions());
+
+    EXPECT_EQ(128, bestSpecification.AtlasSize.Width);
+    EXPECT_EQ(128, bestSpecification.AtlasSize.Height);
+}
+
+TEST(TextureAtlasTests, FillRatio)
+{
+    std::vector<TextureAtlasFrameMetadata> frames{
+        {
+            vec2f(0.0f, 0.0f),
+            vec2f(0.5f, 0.5f),
+            0,
+            0,
+            TextureFrameMetadata(ImageSize(2, 2), 1.0f, 1.0f, false, 0.5f, 0.5f, TextureFrameId(TextureGroupType::RcBomb, 0))
+        },
+        {
+            vec2f(0.5f, 0.0f),
+            vec2f(1.0f, 0.5f),
+            2,
+            0,
+            TextureFrameMetadata(ImageSize(2, 2), 1.0f, 1.0f, false, 0.5f, 0.5f, TextureFrameId(TextureGroupType::RcBomb, 1))
+        }
+    };
+
+    TextureAtlas atlas(
+        TextureAtlasMetadata(frames),
+        RgbaImageData(ImageSize(4, 4), std::make_unique<rgbaColor[]>(4 * 4)));
+
+    EXPECT_FLOAT_EQ(0.5f, atlas.CalculateFillRatio());
+}
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include <GameCore/Vectors.h>
 
+#include <cmath>
+#include <random>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 TEST(VectorsTests, Sum_2f)
@@ -22,4 +26,203 @@ TEST(VectorsTests, Sum_4f)
     EXPECT_EQ(c.y, 9.0f);
     EXPECT_EQ(c.z, 60.0f);
     EXPECT_EQ(c.w, 300.4f);
-}
\ No newline at end of file
+}
+
+class VectorBatchTests : public testing::TestWithParam<VectorBatchImplementation>
+{
+protected:
+
+    // Not a multiple of any vectorization width, so to exercise the remainders
+    static constexpr size_t VectorCount = 1003;
+
+    void SetUp() override
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> componentDistribution(-100.0f, 100.0f);
+
+        for (size_t v = 0; v < VectorCount; ++v)
+        {
+            if (v % 97 == 0)
+            {
+                // Zero vector
+                mVectors.emplace_back(0.0f, 0.0f);
+            }
+            else if (v % 89 == 0)
+            {
+                // Tiny vector
+                mVectors.emplace_back(componentDistribution(random) * 1e-15f, componentDistribution(random) * 1e-15f);
+            }
+            else
+            {
+                mVectors.emplace_back(componentDistribution(random), componentDistribution(random));
+            }
+
+            mOtherVectors.emplace_back(componentDistribution(random), componentDistribution(random));
+        }
+
+        for (auto const & v : mVectors)
+        {
+            mXs.push_back(v.x);
+            mYs.push_back(v.y);
+        }
+
+        for (auto const & v : mOtherVectors)
+        {
+            mOtherXs.push_back(v.x);
+            mOtherYs.push_back(v.y);
+        }
+    }
+
+    static void ExpectNear(
+        float expected,
+        float actual,
+        float relativeTolerance,
+        size_t v)
+    {
+        EXPECT_NEAR(expected, actual, relativeTolerance * std::abs(expected)) << "vector " << v;
+    }
+
+    std::vector<vec2f> mVectors;
+    std::vector<vec2f> mOtherVectors;
+
+    std::vector<float> mXs;
+    std::vector<float> mYs;
+    std::vector<float> mOtherXs;
+    std::vector<float> mOtherYs;
+};
+
+TEST_P(VectorBatchTests, Length_Exact_MatchesScalar)
+{
+    std::vector<float> aosLengths(VectorCount);
+    BatchLength(mVectors.data(), aosLengths.data(), VectorCount, VectorBatchPrecision::Exact, GetParam());
+
+    std::vector<float> soaLengths(VectorCount);
+    BatchLength(mXs.data(), mYs.data(), soaLengths.data(), VectorCount, VectorBatchPrecision::Exact, GetParam());
+
+    for (size_t v = 0; v < VectorCount; ++v)
+    {
+        EXPECT_EQ(mVectors[v].length(), aosLengths[v]) << "vector " << v;
+        EXPECT_EQ(mVectors[v].length(), soaLengths[v]) << "vector " << v;
+    }
+}
+
+TEST_P(VectorBatchTests, Length_Fast_IsAccurate)
+{
+    std::vector<float> aosLengths(VectorCount);
+    BatchLength(mVectors.data(), aosLengths.data(), VectorCount, VectorBatchPrecision::Fast, GetParam());
+
+    std::vector<float> soaLengths(VectorCount);
+    BatchLength(mXs.data(), mYs.data(), soaLengths.data(), VectorCount, VectorBatchPrecision::Fast, GetParam());
+
+    for (size_t v = 0; v < VectorCount; ++v)
+    {
+        ExpectNear(mVectors[v].length(), aosLengths[v], 1e-6f, v);
+        ExpectNear(mVectors[v].length(), soaLengths[v], 1e-6f, v);
+    }
+}
+
+TEST_P(VectorBatchTests, Normalize_Exact_MatchesScalar)
+{
+    std::vector<vec2f> aosNormals(VectorCount);
+    std::vector<float> aosLengths(VectorCount);
+    BatchNormalize(mVectors.data(), aosNormals.data(), aosLengths.data(), VectorCount, VectorBatchPrecision::Exact, GetParam());
+
+    std::vector<float> soaNormalXs(VectorCount);
+    std::vector<float> soaNormalYs(VectorCount);
+    BatchNormalize(mXs.data(), mYs.data(), soaNormalXs.data(), soaNormalYs.data(), nullptr, VectorCount, VectorBatchPrecision::Exact, GetParam());
+
+    for (size_t v = 0; v < VectorCount; ++v)
+    {
+        vec2f const expectedNormal = mVectors[v].normalise();
+
+        EXPECT_EQ(expectedNormal, aosNormals[v]) << "vector " << v;
+        EXPECT_EQ(mVectors[v].length(), aosLengths[v]) << "vector " << v;
+
+        EXPECT_EQ(expectedNormal, vec2f(soaNormalXs[v], soaNormalYs[v])) << "vector " << v;
+    }
+}
+
+TEST_P(VectorBatchTests, Normalize_Fast_IsAccurate)
+{
+    std::vector<vec2f> aosNormals(VectorCount);
+    std::vector<float> aosLengths(VectorCount);
+    BatchNormalize(mVectors.data(), aosNormals.data(), aosLengths.data(), VectorCount, VectorBatchPrecision::Fast, GetParam());
+
+    std::vector<float> soaNormalXs(VectorCount);
+    std::vector<float> soaNormalYs(VectorCount);
+    BatchNormalize(mXs.data(), mYs.data(), soaNormalXs.data(), soaNormalYs.data(), nullptr, VectorCount, VectorBatchPrecision::Fast, GetParam());
+
+    for (size_t v = 0; v < VectorCount; ++v)
+    {
+        vec2f const expectedNormal = mVectors[v].normalise();
+
+        EXPECT_NEAR(expectedNormal.x, aosNormals[v].x, 1e-6f) << "vector " << v;
+        EXPECT_NEAR(expectedNormal.y, aosNormals[v].y, 1e-6f) << "vector " << v;
+        ExpectNear(mVectors[v].length(), aosLengths[v], 1e-6f, v);
+
+        EXPECT_NEAR(expectedNormal.x, soaNormalXs[v], 1e-6f) << "vector " << v;
+        EXPECT_NEAR(expectedNormal.y, soaNormalYs[v], 1e-6f) << "vector " << v;
+    }
+}
+
+TEST_P(VectorBatchTests, Normalize_InPlace)
+{
+    std::vector<vec2f> normals = mVectors;
+    BatchNormalize(normals.data(), normals.data(), nullptr, VectorCount, VectorBatchPrecision::Exact, GetParam());
+
+    for (size_t v = 0; v < VectorCount; ++v)
+    {
+        EXPECT_EQ(mVectors[v].normalise(), normals[v]) << "vector " << v;
+    }
+}
+
+TEST_P(VectorBatchTests, Normalize_ZeroVectorIsZero)
+{
+    for (auto const precision : { VectorBatchPrecision::Exact, VectorBatchPrecision::Fast })
+    {
+        std::vector<vec2f> const vectors(16, vec2f::zero());
+
+        std::vector<vec2f> normals(16, vec2f(1.0f, 1.0f));
+        std::vector<float> lengths(16, 1.0f);
+        BatchNormalize(vectors.data(), normals.data(), lengths.data(), 16, precision, GetParam());
+
+        for (size_t v = 0; v < 16; ++v)
+        {
+            EXPECT_EQ(vec2f::zero(), normals[v]);
+            EXPECT_EQ(0.0f, lengths[v]);
+        }
+    }
+}
+
+TEST_P(VectorBatchTests, Dot_MatchesScalar)
+{
+    std::vector<float> aosDots(VectorCount);
+    BatchDot(mVectors.data(), mOtherVectors.data(), aosDots.data(), VectorCount, GetParam());
+
+    std::vector<float> soaDots(VectorCount);
+    BatchDot(mXs.data(), mYs.data(), mOtherXs.data(), mOtherYs.data(), soaDots.data(), VectorCount, GetParam());
+
+    for (size_t v = 0; v < VectorCount; ++v)
+    {
+        EXPECT_EQ(mVectors[v].dot(mOtherVectors[v]), aosDots[v]) << "vector " << v;
+        EXPECT_EQ(mVectors[v].dot(mOtherVectors[v]), soaDots[v]) << "vector " << v;
+    }
+}
+
+static std::vector<VectorBatchImplementation> GetSupportedImplementations()
+{
+    std::vector<VectorBatchImplementation> implementations{ VectorBatchImplementation::Scalar };
+
+    auto const best = GetBestVectorBatchImplementation();
+    if (best == VectorBatchImplementation::SSE2 || best == VectorBatchImplementation::AVX2)
+        implementations.push_back(VectorBatchImplementation::SSE2);
+    if (best == VectorBatchImplementation::AVX2)
+        implementations.push_back(VectorBatchImplementation::AVX2);
+
+    return implementations;
+}
+
+INSTANTIATE_TEST_CASE_P(
+    VectorBatchTests,
+    VectorBatchTests,
+    ::testing::ValuesIn(GetSupportedImplementations()));